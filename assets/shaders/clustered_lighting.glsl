@@ -0,0 +1,131 @@
+// 分簇光照的片段着色器接口：#include "clustered_lighting.glsl"（需要 GL_GOOGLE_include_directive，glslc 默认启用）。
+// 包含前可以定义 CLUSTERED_LIGHTING_SET 指定描述符集位置（默认 1）。
+// 绑定与结构布局需与 src/Render/Renderer/public/ClusteredLighting.hpp 及 cluster_lights.comp 保持一致。
+
+#ifndef CLUSTERED_LIGHTING_GLSL
+#define CLUSTERED_LIGHTING_GLSL
+
+#ifndef CLUSTERED_LIGHTING_SET
+#define CLUSTERED_LIGHTING_SET 1
+#endif
+
+const float LIGHT_DIRECTIONAL = 0.0;
+const float LIGHT_POINT = 1.0;
+const float LIGHT_SPOT = 2.0;
+
+layout(std140, set = CLUSTERED_LIGHTING_SET, binding = 0) uniform ClusterParams
+{
+    mat4 view;
+    mat4 inverseProjection;
+    uvec4 gridSize; // w：每簇最大光源数
+    vec2 screenSize;
+    float zNear;
+    float zFar;
+    uint directionalCount;
+    uint localCount;
+    uint lightCapacity;
+    uint padding;
+} clusterParams;
+
+// SoA：[positionRange][colorType][directionSpot][attenuation]，每段 lightCapacity 个
+layout(std430, set = CLUSTERED_LIGHTING_SET, binding = 1) readonly buffer ClusterLightData
+{
+    vec4 lightData[];
+};
+
+layout(std430, set = CLUSTERED_LIGHTING_SET, binding = 2) readonly buffer ClusterCounts
+{
+    uint clusterCounts[];
+};
+
+layout(std430, set = CLUSTERED_LIGHTING_SET, binding = 3) readonly buffer ClusterLightIndices
+{
+    uint clusterLights[];
+};
+
+/**
+ * 片段所在的簇（fragCoord 为 gl_FragCoord.xy，viewDepth 为视图空间下到摄像机平面的正距离）
+ */
+uint clusterIndexOf(vec2 fragCoord, float viewDepth)
+{
+    uvec2 tile = min(uvec2(fragCoord / clusterParams.screenSize * vec2(clusterParams.gridSize.xy)),
+                     clusterParams.gridSize.xy - 1u);
+    float slice = log(max(viewDepth, clusterParams.zNear) / clusterParams.zNear) /
+                  log(clusterParams.zFar / clusterParams.zNear) * float(clusterParams.gridSize.z);
+    uint z = min(uint(slice), clusterParams.gridSize.z - 1u);
+    return tile.x + tile.y * clusterParams.gridSize.x + z * clusterParams.gridSize.x * clusterParams.gridSize.y;
+}
+
+/**
+ * 在影响范围边缘平滑衰减到 0 的窗口函数，避免分簇半径处的亮度突变
+ */
+float rangeWindow(float distance, float range)
+{
+    float ratio = distance / max(range, 1e-4);
+    float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+    return window * window;
+}
+
+vec3 shadeLight(vec3 lightDirection, vec3 radiance, vec3 normal, vec3 viewDirection, vec3 albedo, float shininess)
+{
+    float diffuse = max(dot(normal, lightDirection), 0.0);
+    vec3 halfVector = normalize(lightDirection + viewDirection);
+    float specular = diffuse > 0.0 ? pow(max(dot(normal, halfVector), 0.0), shininess) : 0.0;
+    return radiance * (albedo * diffuse + vec3(specular));
+}
+
+vec3 evaluateLocalLight(uint lightIndex, vec3 worldPosition, vec3 normal, vec3 viewDirection, vec3 albedo,
+                        float shininess)
+{
+    uint capacity = clusterParams.lightCapacity;
+    vec4 positionRange = lightData[lightIndex];
+    vec4 colorType = lightData[capacity + lightIndex];
+    vec4 attenuation = lightData[capacity * 3u + lightIndex];
+
+    vec3 toLight = positionRange.xyz - worldPosition;
+    float distance = length(toLight);
+    vec3 lightDirection = toLight / max(distance, 1e-4);
+    float falloff = rangeWindow(distance, positionRange.w) /
+                    (attenuation.x + attenuation.y * distance + attenuation.z * distance * distance);
+
+    if (colorType.w == LIGHT_SPOT)
+    {
+        vec4 directionSpot = lightData[capacity * 2u + lightIndex];
+        float cosTheta = dot(-lightDirection, directionSpot.xyz);
+        falloff *= clamp((cosTheta - directionSpot.w) / max(attenuation.w - directionSpot.w, 1e-4), 0.0, 1.0);
+    }
+    return shadeLight(lightDirection, colorType.rgb * falloff, normal, viewDirection, albedo, shininess);
+}
+
+/**
+ * 累加平行光与片段所在簇的全部光源（Blinn-Phong）
+ * @param worldPosition 世界空间位置
+ * @param normal 世界空间单位法线
+ * @param viewDirection 指向摄像机的单位向量
+ * @param fragCoord gl_FragCoord.xy
+ */
+vec3 evaluateClusteredLighting(vec3 worldPosition, vec3 normal, vec3 viewDirection, vec3 albedo, float shininess,
+                               vec2 fragCoord)
+{
+    uint capacity = clusterParams.lightCapacity;
+    vec3 color = vec3(0.0);
+
+    for (uint i = 0u; i < clusterParams.directionalCount; ++i)
+    {
+        vec3 radiance = lightData[capacity + i].rgb;
+        vec3 direction = lightData[capacity * 2u + i].xyz;
+        color += shadeLight(-direction, radiance, normal, viewDirection, albedo, shininess);
+    }
+
+    float viewDepth = -(clusterParams.view * vec4(worldPosition, 1.0)).z;
+    uint cluster = clusterIndexOf(fragCoord, viewDepth);
+    uint count = clusterCounts[cluster];
+    uint base = cluster * clusterParams.gridSize.w;
+    for (uint i = 0u; i < count; ++i)
+    {
+        color += evaluateLocalLight(clusterLights[base + i], worldPosition, normal, viewDirection, albedo, shininess);
+    }
+    return color;
+}
+
+#endif
@@ -0,0 +1,12 @@
+#version 450
+
+// 全屏三角形：不需要顶点缓冲，vkCmdDraw(3, 1, 0, 0) 覆盖整个视口，输出 [0, 1] 的纹理坐标。
+// 编译：glslc fullscreen.vert -o spv/fullscreen.vert.spv
+
+layout(location = 0) out vec2 outUV;
+
+void main()
+{
+    outUV = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(outUV * 2.0 - 1.0, 0.0, 1.0);
+}
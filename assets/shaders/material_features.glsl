@@ -0,0 +1,26 @@
+// 材质排列的着色器接口：#include "material_features.glsl"（需要 GL_GOOGLE_include_directive，glslc 默认启用）。
+// 位定义需与 src/Render/RenderCore/Resource/public/ResourceType.hpp 中的 rendercore::MaterialFeature 保持一致；
+// 取值由 renderer::applyMaterialPermutation() 以特化常量传入，驱动编译时折叠常量，
+// 未启用的纹理采样与分支不会出现在最终代码中。未特化时默认全部启用（与旧的通用着色器行为相同）。
+
+#ifndef MATERIAL_FEATURES_GLSL
+#define MATERIAL_FEATURES_GLSL
+
+layout(constant_id = 0) const uint MATERIAL_FEATURES = 0xFFFFFFFFu;
+
+const uint MATERIAL_BASE_COLOR_TEXTURE = 1u << 0;
+const uint MATERIAL_METALLIC_TEXTURE = 1u << 1;
+const uint MATERIAL_ROUGHNESS_TEXTURE = 1u << 2;
+const uint MATERIAL_NORMAL_TEXTURE = 1u << 3;
+const uint MATERIAL_OCCLUSION_TEXTURE = 1u << 4;
+const uint MATERIAL_EMISSIVE_TEXTURE = 1u << 5;
+const uint MATERIAL_ALPHA_MASK = 1u << 6;
+const uint MATERIAL_DOUBLE_SIDED = 1u << 7;
+
+// 用法：if (materialHas(MATERIAL_NORMAL_TEXTURE)) { ... }
+bool materialHas(uint feature)
+{
+    return (MATERIAL_FEATURES & feature) != 0u;
+}
+
+#endif // MATERIAL_FEATURES_GLSL
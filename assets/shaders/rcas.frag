@@ -0,0 +1,44 @@
+#version 450
+
+// 对比度自适应锐化（RCAS 风格）：输入与输出同尺寸，十字形 5 点邻域。
+// 锐化负瓣的强度按邻域最小/最大值限制，保证结果不越出邻域范围（不产生光晕），
+// 再乘以 push.sharpness。平坦区域与高对比边缘上锐化都会自动减弱。
+// 绑定与推送常量需与 src/Render/Renderer/public/Upscaler.hpp 保持一致。
+// 编译：glslc rcas.frag -o spv/rcas.frag.spv
+
+layout(set = 0, binding = 0) uniform sampler2D inputColor;
+
+layout(push_constant) uniform UpscalePush
+{
+    vec2 inputSize;  // 输入纹理尺寸（与输出相同）
+    vec2 outputSize; // 输出尺寸
+    float sharpness; // 锐化强度 [0, 1]
+} push;
+
+layout(location = 0) out vec4 outColor;
+
+// 负瓣下限：-(1/4 - 1/16)，与 FSR1 的 RCAS 相同
+const float RCAS_LIMIT = 0.1875;
+
+void main()
+{
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    ivec2 maxP = ivec2(push.inputSize) - 1;
+    vec4 e = texelFetch(inputColor, p, 0);
+    vec3 b = texelFetch(inputColor, clamp(p + ivec2(0, -1), ivec2(0), maxP), 0).rgb;
+    vec3 d = texelFetch(inputColor, clamp(p + ivec2(-1, 0), ivec2(0), maxP), 0).rgb;
+    vec3 f = texelFetch(inputColor, clamp(p + ivec2(1, 0), ivec2(0), maxP), 0).rgb;
+    vec3 h = texelFetch(inputColor, clamp(p + ivec2(0, 1), ivec2(0), maxP), 0).rgb;
+
+    vec3 mn = min(min(b, d), min(f, h));
+    vec3 mx = max(max(b, d), max(f, h));
+
+    // 使 (lobe * 邻域和 + e) / (4 * lobe + 1) 不低于 0、不高于 1 的最大负瓣
+    vec3 hitMin = min(mn, e.rgb) / (4.0 * mx + 1e-5);
+    vec3 hitMax = (1.0 - max(mx, e.rgb)) / (4.0 * mn - 4.0 - 1e-5);
+    vec3 lobeRGB = max(-hitMin, hitMax);
+    float lobe = max(-RCAS_LIMIT, min(max(lobeRGB.r, max(lobeRGB.g, lobeRGB.b)), 0.0)) * push.sharpness;
+
+    vec3 color = (lobe * (b + d + f + h) + e.rgb) / (4.0 * lobe + 1.0);
+    outColor = vec4(color, e.a);
+}
@@ -0,0 +1,157 @@
+// 阴影图集的片段着色器接口：#include "shadow_atlas.glsl"（需要 GL_GOOGLE_include_directive，glslc 默认启用）。
+// 包含前可以定义 SHADOW_ATLAS_SET 指定描述符集位置（默认 2）。
+// 绑定与结构布局需与 src/Render/Renderer/public/ShadowAtlas.hpp 保持一致；
+// 光源的阴影索引由 ShadowAtlas::getShadowIndex() 给出，没有阴影时为 -1。
+
+#ifndef SHADOW_ATLAS_GLSL
+#define SHADOW_ATLAS_GLSL
+
+#ifndef SHADOW_ATLAS_SET
+#define SHADOW_ATLAS_SET 2
+#endif
+
+const uint SHADOW_DIRECTIONAL = 0u;
+const uint SHADOW_POINT = 1u;
+const uint SHADOW_SPOT = 2u;
+
+struct ShadowView
+{
+    mat4 viewProjection;
+    vec4 atlasRect; // xy：图块在图集中的 UV 偏移，zw：UV 尺寸
+    vec4 params;    // x：内容有效，y：纹素世界尺寸（透视时为单位距离处），z：是否透视，w：法线偏移纹素数
+};
+
+struct ShadowLight
+{
+    uint firstView;
+    uint viewCount;
+    uint type;
+    uint padding;
+    vec4 position;
+};
+
+layout(set = SHADOW_ATLAS_SET, binding = 0) uniform sampler2DShadow shadowAtlas;
+
+layout(std430, set = SHADOW_ATLAS_SET, binding = 1) readonly buffer ShadowViews
+{
+    ShadowView shadowViews[];
+};
+
+layout(std430, set = SHADOW_ATLAS_SET, binding = 2) readonly buffer ShadowLights
+{
+    ShadowLight shadowLights[];
+};
+
+/**
+ * 投影到图块的 UV 与深度；xy 越出图块 [0, 1] 范围时 valid 为 false
+ */
+vec3 projectShadow(ShadowView view, vec3 worldPos, out bool valid)
+{
+    vec4 clip = view.viewProjection * vec4(worldPos, 1.0);
+    vec3 ndc = clip.xyz / clip.w;
+    vec2 local = ndc.xy * 0.5 + 0.5;
+    valid = clip.w > 0.0 && all(greaterThanEqual(local, vec2(0.0))) && all(lessThanEqual(local, vec2(1.0))) &&
+            ndc.z <= 1.0;
+    return vec3(local, ndc.z);
+}
+
+/**
+ * 3x3 硬件 PCF，采样坐标夹取在图块内（内缩 1.5 纹素，双线性足迹不会读到相邻图块）
+ */
+float filterShadow(ShadowView view, vec3 coord)
+{
+    vec2 texel = 1.0 / vec2(textureSize(shadowAtlas, 0));
+    vec2 minUV = view.atlasRect.xy + texel * 1.5;
+    vec2 maxUV = view.atlasRect.xy + view.atlasRect.zw - texel * 1.5;
+    vec2 uv = view.atlasRect.xy + coord.xy * view.atlasRect.zw;
+
+    float sum = 0.0;
+    for (int y = -1; y <= 1; ++y)
+    {
+        for (int x = -1; x <= 1; ++x)
+        {
+            vec2 sampleUV = clamp(uv + vec2(x, y) * texel, minUV, maxUV);
+            sum += texture(shadowAtlas, vec3(sampleUV, coord.z));
+        }
+    }
+    return sum / 9.0;
+}
+
+/**
+ * 沿法线偏移采样位置：偏移量与纹素的世界尺寸成比例，透视投影时随距离增大
+ */
+vec3 offsetPosition(ShadowView view, vec3 worldPos, vec3 normal, float distance)
+{
+    float texelSize = view.params.y * (view.params.z > 0.5 ? distance : 1.0);
+    return worldPos + normal * (texelSize * view.params.w);
+}
+
+/**
+ * 光源对片段的可见度（1 为完全照亮）
+ * @param shadowIndex ShadowAtlas::getShadowIndex() 给出的索引
+ * @param worldPos 世界空间位置
+ * @param normal 世界空间单位法线
+ */
+float sampleShadow(int shadowIndex, vec3 worldPos, vec3 normal)
+{
+    if (shadowIndex < 0)
+    {
+        return 1.0;
+    }
+    ShadowLight light = shadowLights[shadowIndex];
+    if (light.viewCount == 0u)
+    {
+        return 1.0;
+    }
+
+    if (light.type == SHADOW_DIRECTIONAL)
+    {
+        // 级联由近到远排列，取第一个包含该点的级联
+        for (uint i = 0u; i < light.viewCount; ++i)
+        {
+            ShadowView view = shadowViews[light.firstView + i];
+            if (view.params.x < 0.5)
+            {
+                continue;
+            }
+            bool valid;
+            vec3 coord = projectShadow(view, offsetPosition(view, worldPos, normal, 1.0), valid);
+            if (valid)
+            {
+                return filterShadow(view, coord);
+            }
+        }
+        return 1.0;
+    }
+
+    vec3 toFragment = worldPos - light.position.xyz;
+    uint viewIndex = 0u;
+    if (light.type == SHADOW_POINT)
+    {
+        // 立方体面顺序：+X -X +Y -Y +Z -Z，按主轴选择
+        vec3 axis = abs(toFragment);
+        if (axis.x >= axis.y && axis.x >= axis.z)
+        {
+            viewIndex = toFragment.x >= 0.0 ? 0u : 1u;
+        }
+        else if (axis.y >= axis.z)
+        {
+            viewIndex = toFragment.y >= 0.0 ? 2u : 3u;
+        }
+        else
+        {
+            viewIndex = toFragment.z >= 0.0 ? 4u : 5u;
+        }
+    }
+
+    ShadowView view = shadowViews[light.firstView + min(viewIndex, light.viewCount - 1u)];
+    if (view.params.x < 0.5)
+    {
+        return 1.0;
+    }
+    bool valid;
+    vec3 coord = projectShadow(view, offsetPosition(view, worldPos, normal, length(toFragment)), valid);
+    return valid ? filterShadow(view, coord) : 1.0;
+}
+
+#endif
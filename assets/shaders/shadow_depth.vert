@@ -0,0 +1,17 @@
+#version 450
+
+// 阴影图集深度 Pass：只变换位置，不写颜色。所有 VertexFormat 的位置都是 location 0 的 float3。
+// 推送常量需与 src/Render/Renderer/private/ShadowAtlas.cpp 保持一致。
+// 编译：glslc shadow_depth.vert -o spv/shadow_depth.vert.spv
+
+layout(push_constant) uniform ShadowPush
+{
+    mat4 mvp; // 图块视图-投影 × 世界矩阵
+} push;
+
+layout(location = 0) in vec3 inPosition;
+
+void main()
+{
+    gl_Position = push.mvp * vec4(inPosition, 1.0);
+}
@@ -0,0 +1,35 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// 示例网格的片段着色：平行光的 Lambert 漫反射乘以阴影图集给出的可见度，再加上环境光。
+// 推送常量需与 shadowed_mesh.vert 及 src/main.cpp 中的 MeshPushConstants 保持一致，阴影图集位于 set 2。
+// 编译：glslc shadowed_mesh.frag -o spv/shadowed_mesh.frag.spv
+
+#include "shadow_atlas.glsl"
+
+layout(set = 0, binding = 0) uniform sampler2D albedoTexture;
+
+layout(push_constant) uniform MeshPush
+{
+    mat4 model;
+    vec4 lightDirection;
+    vec4 lightColor;
+    int shadowIndex;
+} push;
+
+layout(location = 0) in vec3 inWorldPos;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inTexCoord;
+layout(location = 3) in vec4 inColor;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    vec3 normal = normalize(inNormal);
+    float lambert = max(dot(normal, push.lightDirection.xyz), 0.0);
+    float visibility = lambert > 0.0 ? sampleShadow(push.shadowIndex, inWorldPos, normal) : 0.0;
+
+    vec3 albedo = texture(albedoTexture, inTexCoord).rgb * inColor.rgb;
+    outColor = vec4(albedo * push.lightColor.rgb * (push.lightColor.a + lambert * visibility), 1.0);
+}
@@ -0,0 +1,44 @@
+#version 450
+
+// 示例网格的顶点着色：世界矩阵与光源参数来自推送常量，视图与投影来自 set 1 的视口常量（dynamic UBO）。
+// 顶点为 Standard 格式（位置 0、法线 1、纹理坐标 2、颜色 3）。
+// 视口常量与推送常量需与 src/main.cpp 中的 ViewConstants / MeshPushConstants 保持一致。
+// 编译：glslc shadowed_mesh.vert -o spv/shadowed_mesh.vert.spv
+
+layout(set = 1, binding = 0) uniform ViewConstants
+{
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosition;
+    vec2 viewportSize;
+    uint frameNumber;
+    uint viewId;
+} viewConstants;
+
+layout(push_constant) uniform MeshPush
+{
+    mat4 model;          // 世界矩阵（只含旋转与平移）
+    vec4 lightDirection; // xyz：指向光源的世界空间单位向量
+    vec4 lightColor;     // rgb：颜色 × 强度，a：环境光比例
+    int shadowIndex;     // ShadowAtlas::getShadowIndex()，没有阴影时为 -1
+} push;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inTexCoord;
+layout(location = 3) in vec4 inColor;
+
+layout(location = 0) out vec3 outWorldPos;
+layout(location = 1) out vec3 outNormal;
+layout(location = 2) out vec2 outTexCoord;
+layout(location = 3) out vec4 outColor;
+
+void main()
+{
+    vec4 worldPos = push.model * vec4(inPosition, 1.0);
+    outWorldPos = worldPos.xyz;
+    outNormal = mat3(push.model) * inNormal;
+    outTexCoord = inTexCoord;
+    outColor = inColor;
+    gl_Position = viewConstants.projection * viewConstants.view * worldPos;
+}
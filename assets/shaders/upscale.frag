@@ -0,0 +1,108 @@
+#version 450
+
+// 动态分辨率放大：UPSCALE_MODE 为 0 时双线性，为 1 时做边缘自适应的 12 点 Lanczos2（EASU 风格）。
+// 边缘自适应：由最近 2x2 纹素的亮度梯度估计边缘方向，核沿边缘拉伸、跨边缘收窄，
+// 结果钳制到这 2x2 纹素的范围以抑制 Lanczos 负瓣带来的振铃。
+// 绑定、推送常量与特化常量需与 src/Render/Renderer/public/Upscaler.hpp 保持一致。
+// 编译：glslc upscale.frag -o spv/upscale.frag.spv
+
+layout(constant_id = 0) const uint UPSCALE_MODE = 0u;
+
+layout(set = 0, binding = 0) uniform sampler2D inputColor;
+
+layout(push_constant) uniform UpscalePush
+{
+    vec2 inputSize;  // 输入纹理尺寸
+    vec2 outputSize; // 输出尺寸
+    float sharpness; // 仅 rcas.frag 使用
+} push;
+
+layout(location = 0) in vec2 inUV;
+layout(location = 0) out vec4 outColor;
+
+float luma(vec3 c)
+{
+    return dot(c, vec3(0.299, 0.587, 0.114));
+}
+
+float lanczos2(float x)
+{
+    x = abs(x);
+    if (x >= 2.0)
+    {
+        return 0.0;
+    }
+    if (x < 1e-5)
+    {
+        return 1.0;
+    }
+    float px = 3.14159265 * x;
+    return 2.0 * sin(px) * sin(px * 0.5) / (px * px);
+}
+
+vec4 fetchClamped(ivec2 p)
+{
+    return texelFetch(inputColor, clamp(p, ivec2(0), ivec2(push.inputSize) - 1), 0);
+}
+
+vec4 edgeAdaptive(vec2 uv)
+{
+    // 输出像素中心在输入纹素空间的位置，base 为其左上方最近的纹素
+    vec2 p = uv * push.inputSize - 0.5;
+    ivec2 base = ivec2(floor(p));
+    vec2 f = p - vec2(base);
+
+    vec4 c00 = fetchClamped(base);
+    vec4 c10 = fetchClamped(base + ivec2(1, 0));
+    vec4 c01 = fetchClamped(base + ivec2(0, 1));
+    vec4 c11 = fetchClamped(base + ivec2(1, 1));
+
+    // 亮度梯度：方向垂直于边缘，长度按局部对比度归一化
+    float l00 = luma(c00.rgb);
+    float l10 = luma(c10.rgb);
+    float l01 = luma(c01.rgb);
+    float l11 = luma(c11.rgb);
+    vec2 gradient = vec2(l10 + l11 - l00 - l01, l01 + l11 - l00 - l10) * 0.5;
+    float range = max(max(l00, l10), max(l01, l11)) - min(min(l00, l10), min(l01, l11));
+    float edge = clamp(length(gradient) / max(range, 1e-4), 0.0, 1.0);
+    vec2 across = length(gradient) > 1e-6 ? normalize(gradient) : vec2(1.0, 0.0);
+    vec2 along = vec2(-across.y, across.x);
+    float acrossScale = 1.0 + 0.5 * edge; // 跨边缘收窄：保持边缘锐利
+    float alongScale = 1.0 / (1.0 + edge); // 沿边缘拉伸：平滑锯齿
+
+    vec4 sum = vec4(0.0);
+    float weightSum = 0.0;
+    for (int y = -1; y <= 2; ++y)
+    {
+        for (int x = -1; x <= 2; ++x)
+        {
+            // 去掉 4x4 的四个角，共 12 个采样点
+            if ((x == -1 || x == 2) && (y == -1 || y == 2))
+            {
+                continue;
+            }
+            vec2 offset = vec2(x, y) - f;
+            vec2 d = vec2(dot(offset, across) * acrossScale, dot(offset, along) * alongScale);
+            float w = lanczos2(length(d));
+            sum += fetchClamped(base + ivec2(x, y)) * w;
+            weightSum += w;
+        }
+    }
+    vec4 color = sum / max(weightSum, 1e-5);
+
+    vec4 lo = min(min(c00, c10), min(c01, c11));
+    vec4 hi = max(max(c00, c10), max(c01, c11));
+    return clamp(color, lo, hi);
+}
+
+void main()
+{
+    if (UPSCALE_MODE == 1u)
+    {
+        outColor = edgeAdaptive(inUV);
+    }
+    else
+    {
+        outColor = texture(inputColor, inUV);
+    }
+}
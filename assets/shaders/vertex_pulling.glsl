@@ -0,0 +1,93 @@
+// 顶点拉取的着色器接口：#include "vertex_pulling.glsl"（需要 GL_GOOGLE_include_directive，glslc 默认启用）。
+// 管线不设置顶点输入，顶点与实例数据经推送常量中的设备地址读取（GL_EXT_buffer_reference，设备需启用 bufferDeviceAddress）。
+// 推送常量需与 src/Render/Renderer/public/RenderQueue.hpp 中的 renderer::VertexPullingConstants 保持一致
+// （offset 0 为 BindlessRegistry 的材质 ID），顶点编码需与 src/Render/RenderCore/Resource/public/VertexLayout.hpp 保持一致。
+// 顶点格式随推送常量传入，同一着色器覆盖所有 VertexFormat，不再为每种格式各编译一条管线。
+//
+// 用法：
+//     PulledVertex v = pullVertex(uint(gl_VertexIndex)); // gl_VertexIndex 已包含 drawIndexed 的 vertexOffset
+//     mat4 world = pullWorld(uint(gl_InstanceIndex));    // gl_InstanceIndex 已包含批次的 firstInstance
+
+#ifndef VERTEX_PULLING_GLSL
+#define VERTEX_PULLING_GLSL
+
+#extension GL_EXT_buffer_reference : require
+
+const uint VERTEX_FORMAT_STANDARD = 0u;
+const uint VERTEX_FORMAT_COMPACT = 1u;
+const uint VERTEX_FORMAT_COMPACT_NO_COLOR = 2u;
+
+// 以 uint 读取顶点，避免 vec3 在 std430 下的对齐与交错布局不一致
+layout(buffer_reference, std430, buffer_reference_align = 4) readonly buffer PulledVertexWords
+{
+    uint words[];
+};
+
+// renderer::RenderInstanceData 数组
+layout(buffer_reference, std430, buffer_reference_align = 16) readonly buffer PulledInstances
+{
+    mat4 world[];
+};
+
+layout(push_constant) uniform VertexPullingConstants
+{
+    uint materialIndex;                            // BindlessRegistry::getMaterialPushConstantRange()
+    layout(offset = 8) PulledVertexWords vertices; // 网格所在几何池 Arena 的顶点缓冲
+    PulledInstances instances;                     // 本帧的实例缓冲
+    uint vertexFormat;                             // rendercore::VertexFormat
+} pulling;
+
+struct PulledVertex
+{
+    vec3 position;
+    vec3 normal;
+    vec2 texCoord;
+    vec4 color;
+};
+
+vec3 pullOctDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+    {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
+float pullFloat(uint word)
+{
+    return uintBitsToFloat(pulling.vertices.words[word]);
+}
+
+PulledVertex pullVertex(uint vertexIndex)
+{
+    PulledVertex v;
+    if (pulling.vertexFormat == VERTEX_FORMAT_STANDARD)
+    {
+        // color(4) position(3) normal(3) texCoord(2)
+        uint base = vertexIndex * 12u;
+        v.color = vec4(pullFloat(base + 0u), pullFloat(base + 1u), pullFloat(base + 2u), pullFloat(base + 3u));
+        v.position = vec3(pullFloat(base + 4u), pullFloat(base + 5u), pullFloat(base + 6u));
+        v.normal = vec3(pullFloat(base + 7u), pullFloat(base + 8u), pullFloat(base + 9u));
+        v.texCoord = vec2(pullFloat(base + 10u), pullFloat(base + 11u));
+        return v;
+    }
+
+    // position(3) normal(oct snorm16x2) texCoord(half2) [color(unorm8x4)]
+    uint stride = pulling.vertexFormat == VERTEX_FORMAT_COMPACT ? 6u : 5u;
+    uint base = vertexIndex * stride;
+    v.position = vec3(pullFloat(base + 0u), pullFloat(base + 1u), pullFloat(base + 2u));
+    v.normal = pullOctDecode(unpackSnorm2x16(pulling.vertices.words[base + 3u]));
+    v.texCoord = unpackHalf2x16(pulling.vertices.words[base + 4u]);
+    v.color = pulling.vertexFormat == VERTEX_FORMAT_COMPACT ? unpackUnorm4x8(pulling.vertices.words[base + 5u])
+                                                            : vec4(1.0);
+    return v;
+}
+
+mat4 pullWorld(uint instanceIndex)
+{
+    return pulling.instances.world[instanceIndex];
+}
+
+#endif // VERTEX_PULLING_GLSL
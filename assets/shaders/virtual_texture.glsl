@@ -0,0 +1,91 @@
+// 稀疏虚拟纹理的着色器接口：#include "virtual_texture.glsl"（需要 GL_GOOGLE_include_directive，glslc 默认启用）。
+// 包含前可以定义 VIRTUAL_TEXTURE_SET 指定描述符集位置（默认 3）。
+// 绑定、参数布局与页 ID / 页表条目的打包方式需与 src/Render/Renderer/public/VirtualTexture.hpp 保持一致。
+// 虚拟纹理的 UV 在 [0, 1) 内覆盖整个纹理，越界时按重复处理。
+
+#ifndef VIRTUAL_TEXTURE_GLSL
+#define VIRTUAL_TEXTURE_GLSL
+
+#ifndef VIRTUAL_TEXTURE_SET
+#define VIRTUAL_TEXTURE_SET 3
+#endif
+
+const uint VT_INVALID = 0xFFFFFFFFu;
+
+layout(set = VIRTUAL_TEXTURE_SET, binding = 0) uniform usampler2D vtPageTable;
+layout(set = VIRTUAL_TEXTURE_SET, binding = 1) uniform sampler2D vtAtlas;
+
+layout(std140, set = VIRTUAL_TEXTURE_SET, binding = 2) uniform VirtualTextureParams
+{
+    uvec2 pageCount;       // mip 0 的页数
+    vec2 atlasTexel;       // 图集纹素尺寸的倒数
+    uint pageSize;         // 页边长（含边框）
+    uint pageBorder;       // 页边框宽度
+    uint maxMip;           // 最粗一级页的 mip
+    float feedbackLodBias; // 反馈 Pass 的 LOD 偏移
+} vtParams;
+
+/**
+ * 以 mip 0 纹素（不含边框）为单位的 LOD
+ */
+float vtComputeLod(vec2 uv, float bias)
+{
+    float payload = float(vtParams.pageSize - 2u * vtParams.pageBorder);
+    vec2 texels = uv * vec2(vtParams.pageCount) * payload;
+    vec2 dx = dFdx(texels);
+    vec2 dy = dFdy(texels);
+    return 0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1e-8)) + bias;
+}
+
+/**
+ * 期望的页 mip（夹取到 [0, maxMip]）
+ */
+uint vtRequestMip(vec2 uv, float bias)
+{
+    return uint(clamp(floor(vtComputeLod(uv, bias)), 0.0, float(vtParams.maxMip)));
+}
+
+/**
+ * 某一级的页数（与 VirtualTexture::pagesat() 相同，至少为 1）
+ */
+uvec2 vtPagesAt(uint mip)
+{
+    return max(vtParams.pageCount >> mip, uvec2(1u));
+}
+
+/**
+ * 反馈 Pass 输出的页 ID：x | y << 14 | mip << 28
+ */
+uint vtFeedback(vec2 uv)
+{
+    uint mip = vtRequestMip(uv, vtParams.feedbackLodBias);
+    uvec2 pages = vtPagesAt(mip);
+    uvec2 page = min(uvec2(fract(uv) * vec2(pages)), pages - 1u);
+    return page.x | (page.y << 14) | (mip << 28);
+}
+
+/**
+ * 采样虚拟纹理：页未驻留时页表指向最精细的已驻留祖先，没有任何祖先驻留时返回 0
+ */
+vec4 vtSample(vec2 uv)
+{
+    vec2 wrapped = fract(uv);
+    uint mip = vtRequestMip(uv, 0.0);
+    uvec2 pages = vtPagesAt(mip);
+    uvec2 page = min(uvec2(wrapped * vec2(pages)), pages - 1u);
+    uint entry = texelFetch(vtPageTable, ivec2(page), int(mip)).r;
+    if (entry == VT_INVALID)
+    {
+        return vec4(0.0);
+    }
+
+    // 条目：槽位 x | 槽位 y << 12 | 驻留页的 mip << 24
+    uvec2 slot = uvec2(entry & 0xFFFu, (entry >> 12) & 0xFFFu);
+    uint residentMip = entry >> 24;
+    vec2 inPage = fract(wrapped * vec2(vtPagesAt(residentMip)));
+    float payload = float(vtParams.pageSize - 2u * vtParams.pageBorder);
+    vec2 texel = vec2(slot * vtParams.pageSize + vtParams.pageBorder) + inPage * payload;
+    return textureLod(vtAtlas, texel * vtParams.atlasTexel, 0.0);
+}
+
+#endif
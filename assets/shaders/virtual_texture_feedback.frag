@@ -0,0 +1,18 @@
+#version 450
+
+// 虚拟纹理反馈：每个像素输出所需页的 ID（颜色附件为 R32_UINT，清除值 0xFFFFFFFF 表示没有请求）。
+// 以 1/feedbackScale 分辨率绘制，LOD 偏移 feedbackLodBias 补偿较大的屏幕导数。
+// 描述符集 0 为 VirtualTexture::getDescriptorSet()；顶点着色器在 location 0 输出虚拟纹理 UV。
+// 编译：glslc virtual_texture_feedback.frag -o spv/virtual_texture_feedback.frag.spv
+
+#define VIRTUAL_TEXTURE_SET 0
+#include "virtual_texture.glsl"
+
+layout(location = 0) in vec2 inUV;
+
+layout(location = 0) out uint outPage;
+
+void main()
+{
+    outPage = vtFeedback(inUV);
+}
@@ -0,0 +1,290 @@
+/**
+ * @file BenchGpu.cpp
+ * @brief GpuContext 与程序化渲染图实现
+ */
+
+#include "BenchGpu.hpp"
+#include <array>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace bench
+{
+
+namespace
+{
+
+std::unique_ptr<GpuContext> g_context;
+std::string g_error; ///< 创建失败的原因（不再重试）
+
+/**
+ * @struct StressOutput
+ * @brief 程序化渲染图中一个 Pass 的输出（纹理或缓冲区之一有效）
+ */
+struct StressOutput
+{
+    rendercore::RDGTextureHandle texture = rendercore::kInvalidTextureHandle;
+    rendercore::RDGBufferHandle buffer = rendercore::kInvalidBufferHandle;
+};
+
+void readOutput(rendercore::RDGPass &pass, const StressOutput &output, vk::PipelineStageFlags stage)
+{
+    if (output.buffer.isValid())
+    {
+        pass.readBuffer(output.buffer, stage, vk::AccessFlagBits::eShaderRead);
+    }
+    else
+    {
+        pass.readTexture(output.texture, stage, vk::AccessFlagBits::eShaderRead);
+    }
+}
+
+/**
+ * @brief 读取前一个输出与最多两个更早的随机输出（同一 Pass 内不重复）
+ */
+void readRandomOutputs(rendercore::RDGPass &pass, const std::vector<StressOutput> &outputs,
+                       vk::PipelineStageFlags stage, std::mt19937 &rng)
+{
+    if (outputs.empty())
+    {
+        return;
+    }
+    readOutput(pass, outputs.back(), stage);
+
+    std::array<size_t, 2> picked{outputs.size(), outputs.size()};
+    std::uniform_int_distribution<size_t> pick(0, outputs.size() - 1);
+    const uint32_t extraReads = rng() % 3;
+    for (uint32_t i = 0; i < extraReads; ++i)
+    {
+        const size_t index = pick(rng);
+        if (index + 1 == outputs.size() || index == picked[0])
+        {
+            continue;
+        }
+        picked[i] = index;
+        readOutput(pass, outputs[index], stage);
+    }
+}
+
+} // namespace
+
+// ==================== GpuContext ====================
+
+GpuContext &GpuContext::get()
+{
+    if (!g_context)
+    {
+        if (!g_error.empty())
+        {
+            throw std::runtime_error(g_error);
+        }
+        try
+        {
+            g_context.reset(new GpuContext());
+        }
+        catch (const std::exception &e)
+        {
+            g_error = std::string("GPU 不可用: ") + e.what();
+            throw std::runtime_error(g_error);
+        }
+    }
+    return *g_context;
+}
+
+void GpuContext::shutdown()
+{
+    g_context.reset();
+}
+
+GpuContext::GpuContext()
+{
+    const vk::ApplicationInfo appInfo("qtrender_bench", 1, "QTRender", 1, VK_API_VERSION_1_3);
+    m_instance = vk::createInstance(vk::InstanceCreateInfo({}, &appInfo));
+
+    // 与示例程序相同的必需特性；计时相关的特性可选（不支持时 GPU 计时用例跳过）
+    vkcore::Device::Config config;
+    config.vulkan1_3_features = {"dynamicRendering", "synchronization2"};
+    config.vulkan1_2_features = {"timelineSemaphore"};
+    config.optional_features = {"samplerAnisotropy", "pipelineStatisticsQuery"};
+    config.optional_vulkan1_2_features = {"hostQueryReset"};
+    try
+    {
+        m_device = std::make_unique<vkcore::Device>(m_instance, config);
+    }
+    catch (...)
+    {
+        m_instance.destroy();
+        throw;
+    }
+
+    VmaAllocatorCreateInfo allocatorInfo = {};
+    allocatorInfo.instance = static_cast<VkInstance>(m_instance);
+    allocatorInfo.physicalDevice = static_cast<VkPhysicalDevice>(m_device->getPhysicalDevice());
+    allocatorInfo.device = static_cast<VkDevice>(m_device->get());
+    allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_3;
+    if (vmaCreateAllocator(&allocatorInfo, &m_allocator) != VK_SUCCESS)
+    {
+        m_device.reset();
+        m_instance.destroy();
+        throw std::runtime_error("创建 VMA 分配器失败");
+    }
+
+    const uint32_t graphicsFamily = m_device->getGraphicsQueueFamilyIndices();
+    m_timeline = std::make_unique<vkcore::FrameTimeline>(m_device->get(), kFramesInFlight);
+    m_frameCommands = std::make_unique<vkcore::CommandPoolManager>(*m_device, graphicsFamily, *m_timeline);
+    m_uploadCommands = std::make_unique<vkcore::CommandPoolManager>(*m_device, graphicsFamily);
+    m_deletionQueue = std::make_unique<vkcore::DeferredDeletionQueue>(*m_timeline);
+    m_workers = std::make_unique<vkcore::WorkerPool>();
+    m_shaderManager = std::make_unique<vkcore::ShaderManager>(*m_device);
+    m_layoutCache = std::make_unique<vkcore::DescriptorLayoutCache>(*m_device);
+    m_descriptorAllocator = std::make_unique<vkcore::DescriptorAllocator>(*m_device);
+    m_samplerCache = std::make_unique<vkcore::SamplerCache>(*m_device);
+
+    // 生成的资源文件与烘焙缓存放在独立的临时目录，不与示例程序的缓存混用
+    m_tempDirectory = std::filesystem::temp_directory_path() / "qtrender_bench";
+    std::filesystem::remove_all(m_tempDirectory);
+    std::filesystem::create_directories(m_tempDirectory);
+
+    m_resourceManager = std::make_unique<rendercore::ResourceManager>();
+    m_resourceManager->initialize(*m_device, m_allocator, *m_uploadCommands, *m_shaderManager,
+                                  *m_descriptorAllocator, *m_layoutCache, *m_samplerCache, 0, m_workers.get());
+    m_resourceManager->setMeshCacheDirectory({}); // 加载用例按需启用烘焙缓存
+
+    vkcore::ImageDesc outputDesc;
+    outputDesc.format = vk::Format::eR8G8B8A8Unorm;
+    outputDesc.extent = vk::Extent3D(kOutputSize, kOutputSize, 1);
+    outputDesc.usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled;
+    m_graphOutput = std::make_unique<vkcore::Image>("BenchGraphOutput", *m_device, m_allocator, outputDesc);
+}
+
+GpuContext::~GpuContext()
+{
+    m_timeline->waitIdle();
+    m_device->get().waitIdle();
+
+    // 按依赖的相反顺序销毁：资源先于分配器与命令池，帧环命令池与延迟销毁队列先于帧时间线
+    m_graphOutput.reset();
+    m_resourceManager.reset();
+    m_deletionQueue.reset();
+    m_samplerCache.reset();
+    m_descriptorAllocator.reset();
+    m_layoutCache.reset();
+    m_shaderManager->cleanup();
+    m_shaderManager.reset();
+    m_workers.reset();
+    m_frameCommands.reset();
+    m_uploadCommands.reset();
+    m_timeline.reset();
+
+    vmaDestroyAllocator(m_allocator);
+    m_device.reset();
+    m_instance.destroy();
+
+    std::error_code ec;
+    std::filesystem::remove_all(m_tempDirectory, ec);
+}
+
+void GpuContext::appendFrameSignal(rendercore::RDGSyncInfo &syncInfo) const
+{
+    const vk::SemaphoreSubmitInfo signal = m_timeline->getSignalInfo(0);
+    syncInfo.addTimelineSignal(signal.semaphore, signal.value);
+}
+
+// ==================== 程序化渲染图 ====================
+
+void buildStressGraph(rendercore::RDGBuilder &builder, uint32_t passCount, uint32_t seed,
+                      rendercore::RDGTextureHandle output)
+{
+    constexpr std::array<uint32_t, 3> kTextureSizes = {64, 128, 256};
+    constexpr vk::DeviceSize kBufferBlock = 64 * 1024;
+    const vk::ClearColorValue clear(std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f});
+
+    std::mt19937 rng(seed);
+    std::vector<StressOutput> outputs;
+    outputs.reserve(passCount);
+    for (uint32_t i = 0; i < passCount; ++i)
+    {
+        const std::string index = std::to_string(i);
+        StressOutput written;
+        if (i % 3 != 2)
+        {
+            // 图形 Pass：片段阶段采样之前的输出，写一个新的颜色附件
+            rendercore::RDGPass &pass = builder.addPass("StressDraw" + index, [](vk::CommandBuffer) {});
+            readRandomOutputs(pass, outputs, vk::PipelineStageFlagBits::eFragmentShader, rng);
+
+            const uint32_t size = kTextureSizes[rng() % kTextureSizes.size()];
+            written.texture = builder.createTexture(
+                rendercore::RDGTextureDesc("StressColor" + index, vk::Format::eR8G8B8A8Unorm, size, size,
+                                           vk::ImageUsageFlagBits::eColorAttachment |
+                                               vk::ImageUsageFlagBits::eSampled));
+            pass.writeColorAttachment(written.texture, vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore,
+                                      clear);
+        }
+        else
+        {
+            // 计算 Pass：交替写存储纹理与存储缓冲
+            rendercore::RDGPass &pass = builder.addPass("StressCompute" + index, [](vk::CommandBuffer) {});
+            readRandomOutputs(pass, outputs, vk::PipelineStageFlagBits::eComputeShader, rng);
+
+            if ((i / 3) % 2 == 0)
+            {
+                const uint32_t size = kTextureSizes[rng() % kTextureSizes.size()];
+                written.texture = builder.createTexture(
+                    rendercore::RDGTextureDesc("StressStorage" + index, vk::Format::eR8G8B8A8Unorm, size, size,
+                                               vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled));
+                pass.writeStorageTexture(written.texture, vk::PipelineStageFlagBits::eComputeShader,
+                                         vk::AccessFlagBits::eShaderWrite);
+            }
+            else
+            {
+                written.buffer = builder.createBuffer(rendercore::RDGBufferDesc(
+                    "StressBuffer" + index, kBufferBlock * (1 + rng() % 4), vk::BufferUsageFlagBits::eStorageBuffer));
+                pass.writeStorageBuffer(written.buffer, vk::PipelineStageFlagBits::eComputeShader,
+                                        vk::AccessFlagBits::eShaderWrite);
+            }
+        }
+        outputs.push_back(written);
+    }
+
+    // 根：写入外部纹理，整条依赖链因此都不会被剔除
+    rendercore::RDGPass &resolve = builder.addPass("StressResolve", [](vk::CommandBuffer) {});
+    readRandomOutputs(resolve, outputs, vk::PipelineStageFlagBits::eFragmentShader, rng);
+    resolve.writeColorAttachment(output, vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore, clear);
+}
+
+void writeTestTga(const std::filesystem::path &path, uint32_t side, uint32_t seed)
+{
+    if (side == 0 || side > 0xFFFF)
+    {
+        throw std::invalid_argument("writeTestTga: side must be in [1, 65535]");
+    }
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("writeTestTga: cannot open " + path.string());
+    }
+
+    // 18 字节文件头：未压缩真彩色，32 位 BGRA，原点在左上（描述符 0x28：8 位 alpha + 自上而下）
+    const uint8_t header[18] = {0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                static_cast<uint8_t>(side & 0xFF), static_cast<uint8_t>(side >> 8),
+                                static_cast<uint8_t>(side & 0xFF), static_cast<uint8_t>(side >> 8), 32, 0x28};
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+
+    std::vector<uint8_t> row(static_cast<size_t>(side) * 4);
+    for (uint32_t y = 0; y < side; ++y)
+    {
+        for (uint32_t x = 0; x < side; ++x)
+        {
+            uint8_t *pixel = &row[static_cast<size_t>(x) * 4];
+            pixel[0] = static_cast<uint8_t>(x * 255 / side);
+            pixel[1] = static_cast<uint8_t>(y * 255 / side);
+            pixel[2] = static_cast<uint8_t>((x ^ y ^ seed) & 0xFF);
+            pixel[3] = 255;
+        }
+        file.write(reinterpret_cast<const char *>(row.data()), static_cast<std::streamsize>(row.size()));
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,166 @@
+/**
+ * @file BenchGpu.hpp
+ * @brief GPU 用例共用的 headless 设备与程序化渲染图
+ * @details 第一个 GPU 用例运行时创建无表面的实例与设备（不需要窗口或显示），之后所有用例共用，
+ *          main() 退出前由 GpuContext::shutdown() 按依赖顺序销毁。没有可用的 Vulkan 设备时
+ *          GpuContext::get() 抛出异常，BenchRunner 打印错误并跳过该用例，CPU 用例照常运行。
+ *          渲染图生成器与场景生成器一样以固定种子驱动，同一参数每次生成完全相同的拓扑（编译缓存可以命中）。
+ */
+
+#pragma once
+
+#include "RenderGraph/public/RDGBuilder.hpp"
+#include "Resource/public/ResourceManager.hpp"
+#include "VulkanCore/public/CommandPoolManager.hpp"
+#include "VulkanCore/public/DeferredDeletionQueue.hpp"
+#include "VulkanCore/public/Descriptor.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include "VulkanCore/public/FrameTimeline.hpp"
+#include "VulkanCore/public/SamplerCache.hpp"
+#include "VulkanCore/public/ShaderManager.hpp"
+#include "VulkanCore/public/VKResource.hpp"
+#include "VulkanCore/public/WorkerPool.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace bench
+{
+
+/**
+ * @class GpuContext
+ * @brief headless 设备、VMA 分配器、帧时间线与 ResourceManager（进程内单例）
+ * @details 帧时间线驱动帧环命令池与延迟销毁队列：渲染图用例每次迭代 beginFrame()、以 appendFrameSignal()
+ *          触发时间线后执行，与示例程序的帧节奏相同，命令缓冲区与瞬态资源按帧回收而不会累积。
+ */
+class GpuContext
+{
+  public:
+    static constexpr uint32_t kFramesInFlight = 2;
+    static constexpr uint32_t kOutputSize = 256; ///< getGraphOutput() 的边长
+
+    /**
+     * @brief 获取（第一次调用时创建）共享的 GPU 上下文
+     * @throws std::runtime_error 如果没有可用的 Vulkan 设备（之后的调用直接抛出同一错误）
+     */
+    static GpuContext &get();
+
+    /**
+     * @brief 等待设备空闲并销毁共享的上下文（没有创建过时什么也不做）
+     */
+    static void shutdown();
+
+    ~GpuContext();
+
+    /** 禁用拷贝与移动 */
+    GpuContext(const GpuContext &) = delete;
+    GpuContext &operator=(const GpuContext &) = delete;
+
+    vkcore::Device &getDevice()
+    {
+        return *m_device;
+    }
+
+    VmaAllocator getAllocator() const
+    {
+        return m_allocator;
+    }
+
+    vkcore::FrameTimeline &getTimeline()
+    {
+        return *m_timeline;
+    }
+
+    /**
+     * @brief 获取帧环模式的命令池（随帧时间线按槽位整体回收）
+     */
+    vkcore::CommandPoolManager &getFrameCommands()
+    {
+        return *m_frameCommands;
+    }
+
+    vkcore::DeferredDeletionQueue &getDeletionQueue()
+    {
+        return *m_deletionQueue;
+    }
+
+    vkcore::SamplerCache &getSamplerCache()
+    {
+        return *m_samplerCache;
+    }
+
+    vkcore::WorkerPool &getWorkers()
+    {
+        return *m_workers;
+    }
+
+    rendercore::ResourceManager &getResourceManager()
+    {
+        return *m_resourceManager;
+    }
+
+    /**
+     * @brief 获取程序化渲染图的输出纹理（RGBA8，kOutputSize 见方，颜色附件 + 采样用途）
+     * @note 每次以 eUndefined 导入：最后一个 Pass 清除后写入，不保留上一帧内容
+     */
+    vkcore::Image &getGraphOutput()
+    {
+        return *m_graphOutput;
+    }
+
+    /**
+     * @brief 获取基准用例的临时目录（生成的 OBJ/纹理与烘焙缓存，shutdown() 时删除）
+     */
+    const std::filesystem::path &getTempDirectory() const
+    {
+        return m_tempDirectory;
+    }
+
+    /**
+     * @brief 把当前帧在帧时间线上的触发加入同步信息（下一次复用该槽位前 beginFrame() 据此等待）
+     */
+    void appendFrameSignal(rendercore::RDGSyncInfo &syncInfo) const;
+
+  private:
+    GpuContext();
+
+  private:
+    vk::Instance m_instance;
+    std::unique_ptr<vkcore::Device> m_device;
+    VmaAllocator m_allocator = VK_NULL_HANDLE;
+    std::unique_ptr<vkcore::FrameTimeline> m_timeline;
+    std::unique_ptr<vkcore::CommandPoolManager> m_frameCommands;
+    std::unique_ptr<vkcore::CommandPoolManager> m_uploadCommands; ///< ResourceManager 的一次性上传命令
+    std::unique_ptr<vkcore::DeferredDeletionQueue> m_deletionQueue;
+    std::unique_ptr<vkcore::WorkerPool> m_workers;
+    std::unique_ptr<vkcore::ShaderManager> m_shaderManager;
+    std::unique_ptr<vkcore::DescriptorLayoutCache> m_layoutCache;
+    std::unique_ptr<vkcore::DescriptorAllocator> m_descriptorAllocator;
+    std::unique_ptr<vkcore::SamplerCache> m_samplerCache;
+    std::unique_ptr<rendercore::ResourceManager> m_resourceManager;
+    std::unique_ptr<vkcore::Image> m_graphOutput;
+    std::filesystem::path m_tempDirectory;
+};
+
+/**
+ * @brief 向构建器添加 passCount 个 Pass 的程序化渲染图
+ * @details 每三个 Pass 中两个为图形 Pass（写颜色附件），一个为计算 Pass（写存储纹理与存储缓冲）；
+ *          每个 Pass 读取前一个 Pass 的输出以及最多两个更早的随机输出，最后一个 Pass 把结果写入 output，
+ *          因此没有 Pass 被剔除，而较早的输出生命周期长短不一（瞬态内存可以部分别名）。
+ *          执行回调为空，测得的是渲染图自身的编译、屏障、分配与录制开销。
+ * @param builder 目标构建器
+ * @param passCount Pass 数量（不含写入 output 的最后一个 Pass）
+ * @param seed 随机种子
+ * @param output 导入的外部颜色纹理（eColorAttachment 用途），作为整张图的根
+ */
+void buildStressGraph(rendercore::RDGBuilder &builder, uint32_t passCount, uint32_t seed,
+                      rendercore::RDGTextureHandle output);
+
+/**
+ * @brief 写出 side x side 的未压缩 32 位 TGA（确定性的渐变图案），供纹理加载用例读取
+ * @throws std::runtime_error 如果文件无法写入
+ */
+void writeTestTga(const std::filesystem::path &path, uint32_t side, uint32_t seed);
+
+} // namespace bench
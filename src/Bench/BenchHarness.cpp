@@ -0,0 +1,274 @@
+/**
+ * @file BenchHarness.cpp
+ * @brief BenchState 与 BenchRunner 实现
+ */
+
+#include "BenchHarness.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+namespace bench
+{
+
+namespace
+{
+
+double percentile(const std::vector<double> &sorted, double fraction)
+{
+    // 最近秩法：样本较少时不插值，结果总是某次实际测得的耗时
+    const size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+std::string escapeJson(const std::string &text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped.push_back('\\');
+        }
+        escaped.push_back(c);
+    }
+    return escaped;
+}
+
+} // namespace
+
+// ==================== BenchState ====================
+
+BenchState::BenchState(const BenchOptions &options) : m_options(options), m_warmupLeft(options.warmupIterations)
+{
+}
+
+bool BenchState::keepRunning()
+{
+    const Clock::time_point now = Clock::now();
+    if (m_running)
+    {
+        if (!m_paused)
+        {
+            m_elapsed += now - m_start;
+        }
+        if (m_manualMs >= 0.0)
+        {
+            const std::chrono::duration<double, std::milli> manual(m_manualMs);
+            m_elapsed = std::chrono::duration_cast<Clock::duration>(manual);
+        }
+        if (m_warmupLeft > 0)
+        {
+            --m_warmupLeft;
+        }
+        else
+        {
+            m_samples.push_back(std::chrono::duration<double, std::milli>(m_elapsed).count());
+            m_total += m_elapsed;
+        }
+    }
+
+    const double totalMs = std::chrono::duration<double, std::milli>(m_total).count();
+    const size_t count = m_samples.size();
+    m_running = m_warmupLeft > 0 || count < m_options.minIterations ||
+                (totalMs < m_options.minTimeMs && count < m_options.maxIterations);
+    m_paused = false;
+    m_manualMs = -1.0;
+    m_elapsed = Clock::duration{0};
+    m_start = Clock::now();
+    return m_running;
+}
+
+void BenchState::pauseTiming()
+{
+    if (!m_paused)
+    {
+        m_elapsed += Clock::now() - m_start;
+        m_paused = true;
+    }
+}
+
+void BenchState::resumeTiming()
+{
+    if (m_paused)
+    {
+        m_start = Clock::now();
+        m_paused = false;
+    }
+}
+
+void BenchState::addGpuSample(const std::string &series, double ms)
+{
+    if (m_warmupLeft > 0)
+    {
+        return;
+    }
+    auto it = std::find_if(m_gpuSamples.begin(), m_gpuSamples.end(),
+                           [&series](const auto &entry) { return entry.first == series; });
+    if (it == m_gpuSamples.end())
+    {
+        it = m_gpuSamples.emplace(m_gpuSamples.end(), series, std::vector<double>());
+    }
+    it->second.push_back(ms);
+}
+
+uint32_t BenchState::scaled(uint32_t count) const
+{
+    return std::max(1u, static_cast<uint32_t>(std::lround(count * m_options.sceneScale)));
+}
+
+// ==================== BenchRunner ====================
+
+BenchRunner::BenchRunner(BenchOptions options) : m_options(std::move(options))
+{
+    if (m_options.minIterations == 0 || m_options.maxIterations < m_options.minIterations)
+    {
+        throw std::invalid_argument("BenchRunner: iteration limits must satisfy 0 < min <= max");
+    }
+    if (!(m_options.sceneScale > 0.0f))
+    {
+        throw std::invalid_argument("BenchRunner: sceneScale must be greater than 0");
+    }
+}
+
+void BenchRunner::add(std::string name, BenchFunction function)
+{
+    m_cases.push_back({std::move(name), std::move(function)});
+}
+
+std::vector<BenchResult> BenchRunner::run()
+{
+    std::vector<BenchResult> results;
+    for (const BenchCase &benchCase : m_cases)
+    {
+        if (!m_options.filter.empty() && benchCase.name.find(m_options.filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        try
+        {
+            BenchState state(m_options);
+            benchCase.function(state);
+            if (state.getSamples().empty())
+            {
+                std::cerr << "[bench] " << benchCase.name << ": 用例没有执行计时循环" << std::endl;
+                continue;
+            }
+            results.push_back(summarize(benchCase.name, "cpu", m_options.label, state.getItemsPerIteration(),
+                                        state.getSamples()));
+            print(results.back());
+            for (const auto &[series, samples] : state.getGpuSamples())
+            {
+                results.push_back(summarize(benchCase.name + "/" + series, "gpu", m_options.label, 0, samples));
+                print(results.back());
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "[bench] " << benchCase.name << " 失败: " << e.what() << std::endl;
+        }
+    }
+    return results;
+}
+
+void BenchRunner::list() const
+{
+    for (const BenchCase &benchCase : m_cases)
+    {
+        if (m_options.filter.empty() || benchCase.name.find(m_options.filter) != std::string::npos)
+        {
+            std::cout << benchCase.name << '\n';
+        }
+    }
+}
+
+BenchResult BenchRunner::summarize(const std::string &name, const std::string &domain, const std::string &label,
+                                   uint64_t itemsPerIteration, std::vector<double> samples)
+{
+    if (samples.empty())
+    {
+        throw std::invalid_argument("BenchRunner::summarize: no samples");
+    }
+    std::sort(samples.begin(), samples.end());
+
+    BenchResult result{};
+    result.name = name;
+    result.domain = domain;
+    result.label = label;
+    result.itemsPerIteration = itemsPerIteration;
+    result.iterations = static_cast<uint32_t>(samples.size());
+    result.minMs = samples.front();
+    result.maxMs = samples.back();
+    result.medianMs = percentile(samples, 0.5);
+    result.p95Ms = percentile(samples, 0.95);
+    result.meanMs = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    return result;
+}
+
+void BenchRunner::print(const BenchResult &result)
+{
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-48s %-3s median %10.4f ms  p95 %10.4f ms  min %10.4f ms  x%u",
+                  result.name.c_str(), result.domain.c_str(), result.medianMs, result.p95Ms, result.minMs,
+                  result.iterations);
+    std::cout << line;
+    if (result.itemsPerIteration > 0 && result.medianMs > 0.0)
+    {
+        // 吞吐量以中位数换算：百万元素每秒
+        std::snprintf(line, sizeof(line), "  %9.2f M/s",
+                      static_cast<double>(result.itemsPerIteration) / (result.medianMs * 1000.0));
+        std::cout << line;
+    }
+    std::cout << std::endl;
+}
+
+void BenchRunner::writeCsv(const std::filesystem::path &path, const std::vector<BenchResult> &results)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("BenchRunner::writeCsv: cannot open " + path.string());
+    }
+
+    file << "label,name,domain,items,iterations,min_ms,median_ms,mean_ms,p95_ms,max_ms\n";
+    char numbers[256];
+    for (const BenchResult &result : results)
+    {
+        std::snprintf(numbers, sizeof(numbers), "%llu,%u,%.6f,%.6f,%.6f,%.6f,%.6f",
+                      static_cast<unsigned long long>(result.itemsPerIteration), result.iterations, result.minMs,
+                      result.medianMs, result.meanMs, result.p95Ms, result.maxMs);
+        file << result.label << ',' << result.name << ',' << result.domain << ',' << numbers << '\n';
+    }
+}
+
+void BenchRunner::writeJson(const std::filesystem::path &path, const std::vector<BenchResult> &results)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("BenchRunner::writeJson: cannot open " + path.string());
+    }
+
+    file << "{\n  \"results\": [";
+    char numbers[256];
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchResult &result = results[i];
+        std::snprintf(numbers, sizeof(numbers),
+                      "\"items\": %llu, \"iterations\": %u, \"min_ms\": %.6f, \"median_ms\": %.6f, "
+                      "\"mean_ms\": %.6f, \"p95_ms\": %.6f, \"max_ms\": %.6f",
+                      static_cast<unsigned long long>(result.itemsPerIteration), result.iterations, result.minMs,
+                      result.medianMs, result.meanMs, result.p95Ms, result.maxMs);
+        file << (i == 0 ? "\n" : ",\n") << "    {\"label\": \"" << escapeJson(result.label) << "\", \"name\": \""
+             << escapeJson(result.name) << "\", \"domain\": \"" << result.domain << "\", " << numbers << '}';
+    }
+    file << "\n  ]\n}\n";
+}
+
+} // namespace bench
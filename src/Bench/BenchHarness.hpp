@@ -0,0 +1,242 @@
+/**
+ * @file BenchHarness.hpp
+ * @brief qtrender_bench 的计时框架与结果输出
+ * @details 每个基准用例是一个函数，先做准备工作，再以 `while (state.keepRunning())` 循环执行被测代码：
+ *          - 先跑 warmupIterations 次预热（不计入结果），之后至少 minIterations 次且累计至少 minTimeMs；
+ *          - 每次迭代单独计时，报告最小值、中位数、平均值、P95 与最大值（回归比较以中位数为准）；
+ *          - 每次迭代需要重置的状态放在 pauseTiming()/resumeTiming() 之间，不计入耗时；
+ *          - 被测阶段无法单独包围时（例如渲染图的编译嵌在 execute() 内），以 setIterationTime() 报告自测的耗时；
+ *          - GPU 耗时（RDGProfiler 读回的帧与 Pass 计时）以 addGpuSample() 按序列记录，每个序列另成一条 "gpu" 结果。
+ *          结果可写成 CSV（一行一个用例）或 JSON，label 字段区分同一台机器上改动前后的两次运行。
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+
+/**
+ * @struct BenchOptions
+ * @brief 运行参数（由命令行解析）
+ */
+struct BenchOptions
+{
+    std::string filter;             ///< 只运行名称包含该子串的用例（为空时全部运行）
+    std::string label;              ///< 写入每条结果的标签（例如提交号或 "before"/"after"）
+    double minTimeMs = 250.0;       ///< 每个用例至少累计的计时时长
+    uint32_t minIterations = 5;     ///< 每个用例至少的计时迭代次数
+    uint32_t maxIterations = 10000; ///< 每个用例最多的计时迭代次数
+    uint32_t warmupIterations = 2;  ///< 预热迭代次数
+    float sceneScale = 1.0f;        ///< 场景规模系数（CI 上可用 0.1 快速冒烟）
+};
+
+/**
+ * @struct BenchResult
+ * @brief 单个用例的统计结果（时间单位均为毫秒）
+ */
+struct BenchResult
+{
+    std::string name;            ///< 用例名（"分组/用例/规模"）
+    std::string domain;          ///< "cpu" 或 "gpu"
+    std::string label;           ///< BenchOptions::label
+    uint64_t itemsPerIteration;  ///< 每次迭代处理的元素数（节点、顶点、Pass 等，0 表示未设置）
+    uint32_t iterations;         ///< 计时迭代次数
+    double minMs;                ///< 最小值
+    double medianMs;             ///< 中位数
+    double meanMs;               ///< 平均值
+    double p95Ms;                ///< 第 95 百分位
+    double maxMs;                ///< 最大值
+};
+
+/**
+ * @class BenchState
+ * @brief 用例函数与计时框架之间的接口
+ *
+ * @example
+ * @code
+ * runner.add("scene/sync/10000", [](bench::BenchState &state) {
+ *     rendercore::Scene scene;
+ *     auto nodes = bench::buildInstancedScene(scene, 10000, 1);
+ *     state.setItemsPerIteration(nodes.size());
+ *     while (state.keepRunning())
+ *     {
+ *         state.pauseTiming();
+ *         nodes[0]->translate(glm::vec3(0.01f));
+ *         state.resumeTiming();
+ *         scene.getRenderObjects();
+ *     }
+ * });
+ * @endcode
+ */
+class BenchState
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit BenchState(const BenchOptions &options);
+
+    /**
+     * @brief 结束上一次迭代的计时并决定是否继续
+     * @return 需要继续时返回 true 并开始本次迭代的计时
+     */
+    bool keepRunning();
+
+    /**
+     * @brief 暂停当前迭代的计时（与 resumeTiming() 成对使用）
+     */
+    void pauseTiming();
+
+    /**
+     * @brief 恢复当前迭代的计时
+     */
+    void resumeTiming();
+
+    /**
+     * @brief 以手动测得的耗时代替本次迭代的计时（例如 RDGGraphStats::compileMs）
+     * @param ms 本次迭代的耗时（毫秒），只对当前迭代有效
+     */
+    void setIterationTime(double ms)
+    {
+        m_manualMs = ms;
+    }
+
+    /**
+     * @brief 记录一个 GPU 耗时样本（预热期间忽略）
+     * @param series 序列名（结果名为 "用例名/序列名"，domain 为 "gpu"）
+     * @param ms GPU 耗时（毫秒）
+     */
+    void addGpuSample(const std::string &series, double ms);
+
+    /**
+     * @brief 设置每次迭代处理的元素数（用于换算吞吐量）
+     */
+    void setItemsPerIteration(uint64_t items)
+    {
+        m_items = items;
+    }
+
+    /**
+     * @brief 获取场景规模系数
+     */
+    float getSceneScale() const
+    {
+        return m_options.sceneScale;
+    }
+
+    /**
+     * @brief 按场景规模系数缩放元素数（至少为 1）
+     */
+    uint32_t scaled(uint32_t count) const;
+
+    uint64_t getItemsPerIteration() const
+    {
+        return m_items;
+    }
+
+    /**
+     * @brief 获取已记录的迭代耗时（毫秒，不含预热）
+     */
+    const std::vector<double> &getSamples() const
+    {
+        return m_samples;
+    }
+
+    /**
+     * @brief 获取 GPU 样本（按第一次记录的顺序排列的 (序列名, 耗时) 对）
+     */
+    const std::vector<std::pair<std::string, std::vector<double>>> &getGpuSamples() const
+    {
+        return m_gpuSamples;
+    }
+
+  private:
+    const BenchOptions &m_options;
+    std::vector<double> m_samples;
+    std::vector<std::pair<std::string, std::vector<double>>> m_gpuSamples;
+    uint64_t m_items{0};
+    uint32_t m_warmupLeft;
+    bool m_running{false};
+    bool m_paused{false};
+    double m_manualMs{-1.0}; ///< setIterationTime() 设置的耗时（小于 0 表示使用计时结果）
+    Clock::time_point m_start;
+    Clock::duration m_elapsed{0};
+    Clock::duration m_total{0};
+};
+
+/**
+ * @class BenchRunner
+ * @brief 用例注册、运行与结果输出
+ */
+class BenchRunner
+{
+  public:
+    using BenchFunction = std::function<void(BenchState &)>;
+
+    explicit BenchRunner(BenchOptions options);
+
+    /**
+     * @brief 注册一个用例（计时循环为 "cpu" 结果，addGpuSample() 的每个序列另成 "gpu" 结果）
+     * @param name 用例名（"分组/用例/规模"，过滤按子串匹配）
+     * @param function 用例函数
+     */
+    void add(std::string name, BenchFunction function);
+
+    /**
+     * @brief 依次运行所有匹配过滤条件的用例，并把每个结果打印到标准输出
+     * @return 所有结果（用例抛出异常时打印错误并跳过）
+     */
+    std::vector<BenchResult> run();
+
+    /**
+     * @brief 打印所有匹配过滤条件的用例名（不运行）
+     */
+    void list() const;
+
+    const BenchOptions &getOptions() const
+    {
+        return m_options;
+    }
+
+    /**
+     * @brief 由迭代耗时计算统计结果
+     */
+    static BenchResult summarize(const std::string &name, const std::string &domain, const std::string &label,
+                                 uint64_t itemsPerIteration, std::vector<double> samples);
+
+    /**
+     * @brief 打印一条结果
+     */
+    static void print(const BenchResult &result);
+
+    /**
+     * @brief 写出 CSV（带表头，一行一个用例）
+     * @throws std::runtime_error 如果文件无法写入
+     */
+    static void writeCsv(const std::filesystem::path &path, const std::vector<BenchResult> &results);
+
+    /**
+     * @brief 写出 JSON（{"results": [...]}，字段与 CSV 列相同）
+     * @throws std::runtime_error 如果文件无法写入
+     */
+    static void writeJson(const std::filesystem::path &path, const std::vector<BenchResult> &results);
+
+  private:
+    struct BenchCase
+    {
+        std::string name;
+        BenchFunction function;
+    };
+
+    BenchOptions m_options;
+    std::vector<BenchCase> m_cases;
+};
+
+} // namespace bench
@@ -0,0 +1,754 @@
+/**
+ * @file BenchMain.cpp
+ * @brief qtrender_bench 入口：注册基准用例并解析命令行
+ * @details 用法：qtrender_bench [--filter=子串] [--label=标签] [--csv=文件] [--json=文件]
+ *                               [--min-time=毫秒] [--min-iterations=N] [--max-iterations=N]
+ *                               [--warmup=N] [--scale=系数] [--trace=文件] [--list]
+ *          用例名为 "分组/用例/规模"，规模是缩放前的元素数；--scale 只改变实际生成的数据量，
+ *          同一 --scale 下两次运行的结果才可直接比较。
+ *          --trace 记录被测代码中的 QTR_PROFILE_* 区段并写出 Chrome trace（记录本身会略微增加耗时）。
+ *          rdg/ 与 load/ 分组在 headless 设备上运行（见 BenchGpu.hpp），没有可用的 Vulkan 设备时这些用例报错跳过；
+ *          rdg/offscreen_frame 以 OffscreenSwapChain 为后台缓冲区，另外输出 RDGProfiler 读回的整帧与逐类 Pass GPU 耗时。
+ */
+
+#include "BenchGpu.hpp"
+#include "BenchHarness.hpp"
+#include "BenchScenes.hpp"
+#include "Resource/public/HdrConverter.hpp"
+#include "Resource/public/MeshOptimizer.hpp"
+#include "Resource/public/ObjParser.hpp"
+#include "VulkanCore/public/OffscreenSwapChain.hpp"
+#include "VulkanCore/public/Profiler.hpp"
+#include "VulkanCore/public/WorkerPool.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+constexpr uint32_t kSeed = 20240601; ///< 所有场景共用的固定种子
+
+/**
+ * @brief 防止编译器把被测结果当作无用代码消除
+ */
+template <typename T> void keepAlive(const T &value)
+{
+    if constexpr (std::is_arithmetic_v<T>)
+    {
+        static volatile T sink;
+        sink = value;
+    }
+    else
+    {
+        static volatile const void *sink;
+        sink = &value;
+    }
+}
+
+// ==================== 场景用例 ====================
+
+void registerSceneBenchmarks(bench::BenchRunner &runner)
+{
+    for (const uint32_t count : {1000u, 10000u, 100000u})
+    {
+        const std::string size = std::to_string(count);
+
+        // 建图并首次同步：节点创建、挂接与稠密存储的完整重建
+        runner.add("scene/build/" + size, [count](bench::BenchState &state) {
+            const bench::BenchAssets assets = bench::BenchAssets::create();
+            const uint32_t n = state.scaled(count);
+            state.setItemsPerIteration(n);
+            while (state.keepRunning())
+            {
+                rendercore::Scene scene;
+                bench::buildInstancedScene(scene, assets, n, kSeed);
+                keepAlive(scene.getRenderObjects());
+                state.pauseTiming(); // 析构不计入
+            }
+        });
+
+        // 静态场景的逐帧同步：没有任何变化时 getRenderObjects 的固定开销
+        runner.add("scene/sync_static/" + size, [count](bench::BenchState &state) {
+            const bench::BenchAssets assets = bench::BenchAssets::create();
+            rendercore::Scene scene;
+            const auto nodes = bench::buildInstancedScene(scene, assets, state.scaled(count), kSeed);
+            scene.getRenderObjects();
+            state.setItemsPerIteration(nodes.size());
+            while (state.keepRunning())
+            {
+                keepAlive(scene.getRenderObjects());
+            }
+        });
+
+        // 每帧移动 1% 的节点：增量同步路径
+        runner.add("scene/sync_partial/" + size, [count](bench::BenchState &state) {
+            const bench::BenchAssets assets = bench::BenchAssets::create();
+            rendercore::Scene scene;
+            const auto nodes = bench::buildInstancedScene(scene, assets, state.scaled(count), kSeed);
+            scene.getRenderObjects();
+            const size_t moved = std::max<size_t>(1, nodes.size() / 100);
+            state.setItemsPerIteration(nodes.size());
+            size_t cursor = 0;
+            while (state.keepRunning())
+            {
+                state.pauseTiming();
+                for (size_t i = 0; i < moved; ++i)
+                {
+                    nodes[cursor]->translate(glm::vec3(0.0f, 0.001f, 0.0f));
+                    cursor = (cursor + 1) % nodes.size();
+                }
+                state.resumeTiming();
+                keepAlive(scene.getRenderObjects());
+            }
+        });
+
+        // 每帧移动全部节点：最坏情况的同步
+        runner.add("scene/sync_all/" + size, [count](bench::BenchState &state) {
+            const bench::BenchAssets assets = bench::BenchAssets::create();
+            rendercore::Scene scene;
+            const auto nodes = bench::buildInstancedScene(scene, assets, state.scaled(count), kSeed);
+            scene.getRenderObjects();
+            state.setItemsPerIteration(nodes.size());
+            while (state.keepRunning())
+            {
+                state.pauseTiming();
+                for (const auto &node : nodes)
+                {
+                    node->translate(glm::vec3(0.0f, 0.001f, 0.0f));
+                }
+                state.resumeTiming();
+                keepAlive(scene.getRenderObjects());
+            }
+        });
+
+        // 同上，世界矩阵与包围盒按子树分发到任务调度器
+        runner.add("scene/sync_all_parallel/" + size, [count](bench::BenchState &state) {
+            const bench::BenchAssets assets = bench::BenchAssets::create();
+            vkcore::WorkerPool workers;
+            rendercore::Scene scene;
+            scene.setWorkerPool(&workers);
+            const auto nodes = bench::buildInstancedScene(scene, assets, state.scaled(count), kSeed);
+            scene.getRenderObjects();
+            state.setItemsPerIteration(nodes.size());
+            while (state.keepRunning())
+            {
+                state.pauseTiming();
+                for (const auto &node : nodes)
+                {
+                    node->translate(glm::vec3(0.0f, 0.001f, 0.0f));
+                }
+                state.resumeTiming();
+                keepAlive(scene.getRenderObjects());
+            }
+        });
+
+        // 视锥剔除与 LOD 选择（场景静止，相机每帧微转，剔除结果不能跨帧复用）
+        runner.add("scene/cull/" + size, [count](bench::BenchState &state) {
+            const bench::BenchAssets assets = bench::BenchAssets::create();
+            rendercore::Scene scene;
+            const uint32_t n = state.scaled(count);
+            bench::buildInstancedScene(scene, assets, n, kSeed);
+            const std::shared_ptr<rendercore::Camera> camera =
+                bench::createOverviewCamera(bench::instancedSceneExtent(n));
+            scene.setCamera(camera);
+            scene.getRenderObjects();
+            state.setItemsPerIteration(n);
+            float yaw = -90.0f;
+            while (state.keepRunning())
+            {
+                state.pauseTiming();
+                yaw = yaw > -80.0f ? -100.0f : yaw + 0.5f;
+                camera->setRotation(yaw, -25.0f);
+                state.resumeTiming();
+                keepAlive(scene.getVisibleRenderObjects());
+            }
+        });
+    }
+
+    for (const uint32_t depth : {64u, 1024u})
+    {
+        const std::string size = std::to_string(depth);
+
+        // 深层级：移动第一层后整条链与所有叶子的世界矩阵都要重算
+        runner.add("scene/hierarchy_sync/" + size, [depth](bench::BenchState &state) {
+            const bench::BenchAssets assets = bench::BenchAssets::create();
+            rendercore::Scene scene;
+            const auto chain = bench::buildDeepHierarchy(scene, assets, state.scaled(depth), 8, kSeed);
+            scene.getWorldMatrices();
+            state.setItemsPerIteration(chain.size() * 9);
+            while (state.keepRunning())
+            {
+                state.pauseTiming();
+                chain.front()->translate(glm::vec3(0.001f, 0.0f, 0.0f));
+                state.resumeTiming();
+                keepAlive(scene.getWorldMatrices());
+            }
+        });
+
+        // 同样的层级走 SceneNode::getWorldMatrix 的惰性递归路径（从最深一层向上）
+        runner.add("scene/hierarchy_lazy/" + size, [depth](bench::BenchState &state) {
+            const bench::BenchAssets assets = bench::BenchAssets::create();
+            rendercore::Scene scene;
+            const auto chain = bench::buildDeepHierarchy(scene, assets, state.scaled(depth), 0, kSeed);
+            state.setItemsPerIteration(chain.size());
+            while (state.keepRunning())
+            {
+                state.pauseTiming();
+                chain.front()->translate(glm::vec3(0.001f, 0.0f, 0.0f));
+                state.resumeTiming();
+                keepAlive(chain.back()->getWorldMatrix());
+            }
+        });
+    }
+
+    // 大量光源：渲染端每帧的光照版本检查与按类型收集
+    for (const uint32_t count : {256u, 4096u})
+    {
+        runner.add("scene/lights/" + std::to_string(count), [count](bench::BenchState &state) {
+            rendercore::Scene scene;
+            bench::addRandomLights(scene, state.scaled(count), kSeed);
+            state.setItemsPerIteration(scene.getLights().size());
+            while (state.keepRunning())
+            {
+                uint64_t version = scene.getLightsVersion();
+                for (const auto &[id, light] : scene.getLights())
+                {
+                    version += light->getVersion() + id;
+                }
+                keepAlive(version);
+                keepAlive(scene.getActiveLightCount());
+                keepAlive(scene.getLightsByType(rendercore::LightType::Point));
+            }
+        });
+    }
+}
+
+// ==================== 资源用例 ====================
+
+void registerResourceBenchmarks(bench::BenchRunner &runner)
+{
+    for (const uint32_t grid : {256u, 1024u})
+    {
+        const std::string size = std::to_string(grid);
+
+        // OBJ 解析：单线程与分块并行（阈值设为 0 强制分块）
+        runner.add("resource/obj_parse/" + size, [grid](bench::BenchState &state) {
+            const uint32_t n = state.scaled(grid);
+            const std::string obj = bench::generateGridObj(n, kSeed);
+            state.setItemsPerIteration(static_cast<uint64_t>(n) * n);
+            while (state.keepRunning())
+            {
+                const auto meshes = rendercore::ObjParser::parse(obj.data(), obj.size(), "bench.obj");
+                keepAlive(meshes);
+                state.pauseTiming(); // 释放不计入
+            }
+        });
+
+        runner.add("resource/obj_parse_parallel/" + size, [grid](bench::BenchState &state) {
+            const uint32_t n = state.scaled(grid);
+            const std::string obj = bench::generateGridObj(n, kSeed);
+            vkcore::WorkerPool workers;
+            rendercore::ObjParser::Options options;
+            options.workers = &workers;
+            options.parallelThreshold = 0;
+            state.setItemsPerIteration(static_cast<uint64_t>(n) * n);
+            while (state.keepRunning())
+            {
+                const auto meshes = rendercore::ObjParser::parse(obj.data(), obj.size(), "bench.obj", options);
+                keepAlive(meshes);
+                state.pauseTiming();
+            }
+        });
+
+        // 导入处理：焊接、顶点缓存 / 过度绘制 / 取顶点顺序优化
+        runner.add("resource/mesh_optimize/" + size, [grid](bench::BenchState &state) {
+            const uint32_t n = state.scaled(grid);
+            const rendercore::MeshData source = bench::generateGridMesh(n, kSeed);
+            state.setItemsPerIteration(source.indices.size() / 3);
+            while (state.keepRunning())
+            {
+                state.pauseTiming();
+                rendercore::MeshData mesh = source;
+                state.resumeTiming();
+                rendercore::MeshOptimizer::weldVertices(mesh);
+                rendercore::MeshOptimizer::optimize(mesh);
+                keepAlive(mesh);
+                state.pauseTiming();
+            }
+        });
+    }
+
+    // HDR 转换：浮点 RGBA 到 half 与 B10G11R11（规模为像素数，4096 x 4096 约为 8K 等距柱状图的一半）
+    for (const uint32_t side : {1024u, 4096u})
+    {
+        const std::string size = std::to_string(side * side);
+        for (const vk::Format format : {vk::Format::eR16G16B16A16Sfloat, vk::Format::eB10G11R11UfloatPack32})
+        {
+            const std::string name = format == vk::Format::eR16G16B16A16Sfloat ? "half" : "b10g11r11";
+            runner.add("resource/hdr_to_" + name + "/" + size, [side, format](bench::BenchState &state) {
+                const size_t pixelCount = state.scaled(side * side);
+                std::vector<float> source(pixelCount * 4);
+                for (size_t i = 0; i < source.size(); ++i)
+                {
+                    source[i] = static_cast<float>(i % 4099) * 0.37f; // 覆盖 0 ~ 1500 的动态范围
+                }
+                std::vector<uint32_t> converted(pixelCount * 2);
+                state.setItemsPerIteration(pixelCount);
+                while (state.keepRunning())
+                {
+                    rendercore::HdrConverter::convert(source.data(), pixelCount, format, converted.data());
+                    keepAlive(converted);
+                }
+            });
+        }
+    }
+
+    // 材质加载：ResourceManager::loadMaterial 的 CPU 部分（同一文件的三次 JSON 解析）
+    runner.add("resource/material_json/1", [](bench::BenchState &state) {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "qtrender_bench_material.json";
+        {
+            std::ofstream file(path);
+            file << R"({"name": "BenchMaterial", "shader": "pbr",
+                        "factors": {"baseColor": [0.8, 0.7, 0.6, 1.0], "metallic": 0.2, "roughness": 0.6,
+                                    "emissive": [0.0, 0.0, 0.0]},
+                        "textures": {"baseColor": "albedo.png", "normal": "normal.png",
+                                     "metallicRoughness": "orm.png"}})";
+        }
+        state.setItemsPerIteration(1);
+        while (state.keepRunning())
+        {
+            keepAlive(rendercore::MaterialLoader::loadMaterialData(path));
+            keepAlive(rendercore::MaterialLoader::getTexturePaths(path));
+            keepAlive(rendercore::MaterialLoader::getShaderName(path));
+        }
+        std::filesystem::remove(path);
+    });
+}
+
+// ==================== 渲染图用例 ====================
+
+/**
+ * @brief 在共享的 GPU 上下文上声明并执行一帧程序化渲染图（调用前已 beginFrame()）
+ * @return 本帧的编译/执行统计
+ */
+rendercore::RDGGraphStats executeStressGraph(bench::GpuContext &gpu, uint32_t passCount,
+                                             rendercore::RDGCompileCache *compileCache,
+                                             rendercore::RDGTransientAllocator *transientAllocator)
+{
+    rendercore::RDGBuilder builder(gpu.getDevice(), gpu.getFrameCommands(), gpu.getAllocator(), compileCache,
+                                   transientAllocator, &gpu.getSamplerCache());
+    builder.setDeletionQueue(&gpu.getDeletionQueue());
+    bench::buildStressGraph(builder, passCount, kSeed,
+                            builder.registerExternalTexture(&gpu.getGraphOutput(), "BenchOutput"));
+
+    rendercore::RDGSyncInfo syncInfo;
+    gpu.appendFrameSignal(syncInfo);
+    builder.execute(&syncInfo);
+    return builder.getStats();
+}
+
+/**
+ * @brief 把 RDGProfiler 新读回的一帧记为 GPU 样本
+ * @details "frame" 为整帧跨度；逐 Pass 耗时按种类（名称去掉末尾序号，例如 StressDraw）相加成一个序列，
+ *          几百个 Pass 不会各自成为一条结果
+ * @param lastFrame 上一次记录的帧序号（读回滞后 framesInFlight 帧，同一帧不重复记录）
+ */
+void recordGpuFrame(bench::BenchState &state, const rendercore::RDGProfiler &profiler, uint64_t &lastFrame)
+{
+    const rendercore::RDGFrameTiming &frame = profiler.getLatestFrame();
+    if (frame.passes.empty() || frame.frameIndex == lastFrame)
+    {
+        return;
+    }
+    lastFrame = frame.frameIndex;
+    state.addGpuSample("frame", frame.gpuMs);
+
+    std::vector<std::pair<std::string, double>> kinds;
+    for (const rendercore::RDGPassTiming &pass : frame.passes)
+    {
+        const std::string kind = pass.name.substr(0, pass.name.find_last_not_of("0123456789") + 1);
+        auto it = std::find_if(kinds.begin(), kinds.end(), [&kind](const auto &entry) { return entry.first == kind; });
+        if (it == kinds.end())
+        {
+            it = kinds.emplace(kinds.end(), kind, 0.0);
+        }
+        it->second += pass.gpuMs;
+    }
+    for (const auto &[kind, ms] : kinds)
+    {
+        state.addGpuSample(kind, ms);
+    }
+}
+
+void registerRenderGraphBenchmarks(bench::BenchRunner &runner)
+{
+    for (const uint32_t count : {128u, 512u})
+    {
+        const std::string size = std::to_string(count);
+
+        // 完整编译（没有编译缓存）：依赖图、剔除、生命周期、屏障与批次；报告 RDGGraphStats::compileMs
+        runner.add("rdg/compile_cold/" + size, [count](bench::BenchState &state) {
+            bench::GpuContext &gpu = bench::GpuContext::get();
+            const uint32_t n = state.scaled(count);
+            state.setItemsPerIteration(n);
+            while (state.keepRunning())
+            {
+                gpu.getTimeline().beginFrame();
+                state.setIterationTime(executeStressGraph(gpu, n, nullptr, nullptr).compileMs);
+            }
+            gpu.getTimeline().waitIdle();
+        });
+
+        // 拓扑不变时命中编译缓存：只计算拓扑哈希并恢复屏障与批次
+        runner.add("rdg/compile_cached/" + size, [count](bench::BenchState &state) {
+            bench::GpuContext &gpu = bench::GpuContext::get();
+            const uint32_t n = state.scaled(count);
+            rendercore::RDGCompileCache compileCache;
+            gpu.getTimeline().beginFrame();
+            executeStressGraph(gpu, n, &compileCache, nullptr);
+            state.setItemsPerIteration(n);
+            while (state.keepRunning())
+            {
+                gpu.getTimeline().beginFrame();
+                const rendercore::RDGGraphStats stats = executeStressGraph(gpu, n, &compileCache, nullptr);
+                if (!stats.compileCacheHit)
+                {
+                    throw std::runtime_error("相同拓扑的渲染图没有命中编译缓存");
+                }
+                state.setIterationTime(stats.compileMs);
+            }
+            gpu.getTimeline().waitIdle();
+        });
+
+        // 稳态的一帧：声明 + 编译（命中缓存）+ 瞬态资源分配（跨帧复用）+ 录制 + 提交的 CPU 耗时
+        runner.add("rdg/execute/" + size, [count](bench::BenchState &state) {
+            bench::GpuContext &gpu = bench::GpuContext::get();
+            const uint32_t n = state.scaled(count);
+            rendercore::RDGCompileCache compileCache;
+            rendercore::RDGTransientAllocator transientAllocator(gpu.getDevice(), gpu.getAllocator(),
+                                                                 bench::GpuContext::kFramesInFlight);
+            state.setItemsPerIteration(n);
+            while (state.keepRunning())
+            {
+                state.pauseTiming(); // 等待复用槽位的那一帧完成不计入
+                gpu.getTimeline().beginFrame();
+                state.resumeTiming();
+                keepAlive(executeStressGraph(gpu, n, &compileCache, &transientAllocator));
+            }
+            gpu.getTimeline().waitIdle();
+        });
+
+        // 同上，但每帧完整编译并新建瞬态资源（第一帧或拓扑每帧变化时的代价）
+        runner.add("rdg/execute_cold/" + size, [count](bench::BenchState &state) {
+            bench::GpuContext &gpu = bench::GpuContext::get();
+            const uint32_t n = state.scaled(count);
+            state.setItemsPerIteration(n);
+            while (state.keepRunning())
+            {
+                state.pauseTiming();
+                gpu.getTimeline().beginFrame();
+                state.resumeTiming();
+                keepAlive(executeStressGraph(gpu, n, nullptr, nullptr));
+            }
+            gpu.getTimeline().waitIdle();
+        });
+
+        // headless 的完整一帧：获取离屏图像、执行渲染图（末尾转换到呈现布局）、回读到主机并前进到下一帧；
+        // CPU 耗时为稳态每帧的吞吐，GPU 耗时由 RDGProfiler 读回
+        runner.add("rdg/offscreen_frame/" + size, [count](bench::BenchState &state) {
+            bench::GpuContext &gpu = bench::GpuContext::get();
+            vkcore::Device &device = gpu.getDevice();
+            const uint32_t n = state.scaled(count);
+
+            vkcore::OffscreenSwapChain::Config targetConfig;
+            targetConfig.extent = vk::Extent2D(bench::GpuContext::kOutputSize, bench::GpuContext::kOutputSize);
+            targetConfig.framesInFlight = bench::GpuContext::kFramesInFlight;
+            vkcore::OffscreenSwapChain target(device, gpu.getAllocator(), targetConfig);
+            target.setReadbackCallback([](const vkcore::ReadbackFrame &frame) { keepAlive(frame.size); });
+
+            // 帧环命令池与延迟销毁队列跟随离屏交换链自己的帧时间线
+            vkcore::CommandPoolManager commands(device, device.getGraphicsQueueFamilyIndices(),
+                                                target.getFrameTimeline());
+            vkcore::DeferredDeletionQueue deletionQueue(target.getFrameTimeline());
+            rendercore::RDGCompileCache compileCache;
+            rendercore::RDGTransientAllocator transientAllocator(device, gpu.getAllocator(),
+                                                                 bench::GpuContext::kFramesInFlight);
+            rendercore::RDGProfiler::Config profilerConfig;
+            profilerConfig.maxPasses = n + 1;
+            rendercore::RDGProfiler profiler(device, bench::GpuContext::kFramesInFlight, profilerConfig);
+
+            uint64_t lastFrame = UINT64_MAX;
+            state.setItemsPerIteration(n);
+            while (state.keepRunning())
+            {
+                uint32_t imageIndex = 0;
+                target.acquireNextImage(imageIndex);
+                {
+                    rendercore::RDGBuilder builder(device, commands, gpu.getAllocator(), &compileCache,
+                                                   &transientAllocator, &gpu.getSamplerCache());
+                    builder.setDeletionQueue(&deletionQueue);
+                    builder.setProfiler(&profiler);
+                    bench::buildStressGraph(builder, n, kSeed, builder.getOffscreenAttachment(target, imageIndex));
+
+                    rendercore::RDGSyncInfo syncInfo;
+                    syncInfo.addWaitSemaphore(target.getImageAvailableSemaphore(target.getCurrentFrameIndex()));
+                    syncInfo.addSignalSemaphore(target.getRenderFinishedSemaphore(imageIndex));
+                    const vk::SemaphoreSubmitInfo frameSignal = target.getFrameSignalInfo();
+                    syncInfo.addTimelineSignal(frameSignal.semaphore, frameSignal.value);
+                    builder.execute(&syncInfo);
+                }
+                target.present(target.getRenderFinishedSemaphore(imageIndex), imageIndex);
+                target.advanceToNextFrame();
+                recordGpuFrame(state, profiler, lastFrame);
+            }
+            target.getFrameTimeline().waitIdle();
+            target.waitReadbacks();
+        });
+    }
+}
+
+// ==================== 加载用例 ====================
+
+void registerLoadBenchmarks(bench::BenchRunner &runner)
+{
+    for (const uint32_t grid : {64u, 256u})
+    {
+        const std::string size = std::to_string(grid);
+
+        // loadMesh 的完整路径：读取、解析、焊接与优化、上传并等待完成（烘焙缓存关闭）
+        runner.add("load/mesh/" + size, [grid](bench::BenchState &state) {
+            bench::GpuContext &gpu = bench::GpuContext::get();
+            rendercore::ResourceManager &resources = gpu.getResourceManager();
+            const uint32_t n = state.scaled(grid);
+            const std::filesystem::path path = gpu.getTempDirectory() / ("grid_" + std::to_string(n) + ".obj");
+            std::ofstream(path) << bench::generateGridObj(n, kSeed);
+            state.setItemsPerIteration(static_cast<uint64_t>(n) * n);
+            while (state.keepRunning())
+            {
+                std::shared_ptr<rendercore::Mesh> mesh = resources.loadMesh(path);
+                resources.waitForUploads();
+                keepAlive(mesh);
+                state.pauseTiming(); // 卸载不计入
+                mesh.reset();
+                resources.unloadMesh(path.string());
+            }
+        });
+
+        // 同一网格第二次起映射烘焙缓存：跳过解析与优化，直接拷入暂存区
+        runner.add("load/mesh_baked/" + size, [grid](bench::BenchState &state) {
+            bench::GpuContext &gpu = bench::GpuContext::get();
+            rendercore::ResourceManager &resources = gpu.getResourceManager();
+            const uint32_t n = state.scaled(grid);
+            const std::filesystem::path path = gpu.getTempDirectory() / ("grid_" + std::to_string(n) + ".obj");
+            std::ofstream(path) << bench::generateGridObj(n, kSeed);
+            resources.setMeshCacheDirectory(gpu.getTempDirectory() / "MeshCache");
+            resources.loadMesh(path);
+            resources.waitForUploads();
+            resources.unloadMesh(path.string());
+            state.setItemsPerIteration(static_cast<uint64_t>(n) * n);
+            while (state.keepRunning())
+            {
+                std::shared_ptr<rendercore::Mesh> mesh = resources.loadMesh(path);
+                resources.waitForUploads();
+                keepAlive(mesh);
+                state.pauseTiming();
+                mesh.reset();
+                resources.unloadMesh(path.string());
+            }
+            resources.setMeshCacheDirectory({});
+        });
+    }
+
+    // loadTexture：解码 TGA、上传并在 GPU 上生成 mip 链（规模为像素数）
+    for (const uint32_t side : {256u, 2048u})
+    {
+        runner.add("load/texture/" + std::to_string(side * side), [side](bench::BenchState &state) {
+            bench::GpuContext &gpu = bench::GpuContext::get();
+            rendercore::ResourceManager &resources = gpu.getResourceManager();
+            const uint32_t n = state.scaled(side);
+            const std::filesystem::path path = gpu.getTempDirectory() / ("texture_" + std::to_string(n) + ".tga");
+            bench::writeTestTga(path, n, kSeed);
+            state.setItemsPerIteration(static_cast<uint64_t>(n) * n);
+            while (state.keepRunning())
+            {
+                std::shared_ptr<rendercore::Texture> texture = resources.loadTexture(path);
+                resources.waitForUploads();
+                keepAlive(texture);
+                state.pauseTiming();
+                texture.reset();
+                resources.unloadTexture(path.string() + "_linear");
+            }
+        });
+    }
+
+    // 异步请求：一次发起 count 个网格与 count 个纹理，I/O、解析与解码在线程池上重叠，最后一次提交上传
+    for (const uint32_t count : {16u, 64u})
+    {
+        runner.add("load/async/" + std::to_string(count), [count](bench::BenchState &state) {
+            bench::GpuContext &gpu = bench::GpuContext::get();
+            rendercore::ResourceManager &resources = gpu.getResourceManager();
+            const uint32_t n = state.scaled(count);
+            std::vector<std::filesystem::path> meshPaths;
+            std::vector<std::filesystem::path> texturePaths;
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                const std::string index = std::to_string(i);
+                meshPaths.push_back(gpu.getTempDirectory() / ("async_" + index + ".obj"));
+                std::ofstream(meshPaths.back()) << bench::generateGridObj(32, kSeed + i);
+                texturePaths.push_back(gpu.getTempDirectory() / ("async_" + index + ".tga"));
+                bench::writeTestTga(texturePaths.back(), 256, kSeed + i);
+            }
+
+            std::vector<std::shared_future<std::shared_ptr<rendercore::Mesh>>> meshes;
+            std::vector<std::shared_future<std::shared_ptr<rendercore::Texture>>> textures;
+            state.setItemsPerIteration(static_cast<uint64_t>(n) * 2);
+            while (state.keepRunning())
+            {
+                for (uint32_t i = 0; i < n; ++i)
+                {
+                    meshes.push_back(resources.loadMeshAsync(meshPaths[i]));
+                    textures.push_back(resources.loadTextureAsync(texturePaths[i]));
+                }
+                for (uint32_t i = 0; i < n; ++i)
+                {
+                    keepAlive(meshes[i].get());
+                    keepAlive(textures[i].get());
+                }
+                resources.waitForUploads();
+
+                state.pauseTiming();
+                meshes.clear();
+                textures.clear();
+                for (uint32_t i = 0; i < n; ++i)
+                {
+                    resources.unloadMesh(meshPaths[i].string());
+                    resources.unloadTexture(texturePaths[i].string() + "_linear");
+                }
+            }
+        });
+    }
+}
+
+// ==================== 命令行 ====================
+
+bool parseValue(std::string_view arg, std::string_view key, std::string &value)
+{
+    if (arg.size() <= key.size() || arg.substr(0, key.size()) != key)
+    {
+        return false;
+    }
+    value = std::string(arg.substr(key.size()));
+    return true;
+}
+
+void printUsage()
+{
+    std::cout << "usage: qtrender_bench [--filter=SUBSTRING] [--label=LABEL] [--csv=FILE] [--json=FILE]\n"
+                 "                      [--min-time=MS] [--min-iterations=N] [--max-iterations=N]\n"
+                 "                      [--warmup=N] [--scale=FACTOR] [--trace=FILE] [--list]\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bench::BenchOptions options;
+    std::string csvPath;
+    std::string jsonPath;
+    std::string tracePath;
+    bool listOnly = false;
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            std::string value;
+            if (arg == "--help" || arg == "-h")
+            {
+                printUsage();
+                return 0;
+            }
+            else if (arg == "--list")
+            {
+                listOnly = true;
+            }
+            else if (parseValue(arg, "--filter=", options.filter) || parseValue(arg, "--label=", options.label) ||
+                     parseValue(arg, "--csv=", csvPath) || parseValue(arg, "--json=", jsonPath) ||
+                     parseValue(arg, "--trace=", tracePath))
+            {
+                continue; // 字符串参数已直接写入
+            }
+            else if (parseValue(arg, "--min-time=", value))
+            {
+                options.minTimeMs = std::stod(value);
+            }
+            else if (parseValue(arg, "--min-iterations=", value))
+            {
+                options.minIterations = static_cast<uint32_t>(std::stoul(value));
+            }
+            else if (parseValue(arg, "--max-iterations=", value))
+            {
+                options.maxIterations = static_cast<uint32_t>(std::stoul(value));
+            }
+            else if (parseValue(arg, "--warmup=", value))
+            {
+                options.warmupIterations = static_cast<uint32_t>(std::stoul(value));
+            }
+            else if (parseValue(arg, "--scale=", value))
+            {
+                options.sceneScale = std::stof(value);
+            }
+            else
+            {
+                std::cerr << "未知参数: " << arg << std::endl;
+                printUsage();
+                return 2;
+            }
+        }
+
+        bench::BenchRunner runner(options);
+        registerSceneBenchmarks(runner);
+        registerResourceBenchmarks(runner);
+        registerRenderGraphBenchmarks(runner);
+        registerLoadBenchmarks(runner);
+        if (listOnly)
+        {
+            runner.list();
+            return 0;
+        }
+
+        vkcore::Profiler::setEnabled(!tracePath.empty());
+        const std::vector<bench::BenchResult> results = runner.run();
+        bench::GpuContext::shutdown();
+        if (!csvPath.empty())
+        {
+            bench::BenchRunner::writeCsv(csvPath, results);
+        }
+        if (!jsonPath.empty())
+        {
+            bench::BenchRunner::writeJson(jsonPath, results);
+        }
+        if (!tracePath.empty())
+        {
+            vkcore::Profiler::writeChromeTrace(tracePath);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        bench::GpuContext::shutdown();
+        std::cerr << "qtrender_bench 失败: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,251 @@
+/**
+ * @file BenchScenes.cpp
+ * @brief 程序化基准场景实现
+ */
+
+#include "BenchScenes.hpp"
+#include <cmath>
+#include <cstdio>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <random>
+
+namespace bench
+{
+
+namespace
+{
+
+constexpr float kInstanceSpacing = 2.0f; ///< 平铺场景中每个节点平均占据的边长
+
+glm::quat randomRotation(std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> angle(0.0f, glm::two_pi<float>());
+    return glm::angleAxis(angle(rng), glm::normalize(glm::vec3(0.3f, 1.0f, 0.2f)));
+}
+
+rendercore::Renderable makeRenderable(const BenchAssets &assets)
+{
+    rendercore::Renderable renderable;
+    renderable.mesh = assets.mesh;
+    renderable.material = assets.material;
+    return renderable;
+}
+
+// 网格高度场：确定性的起伏，法线由解析导数得到
+float gridHeight(float x, float z, float phase)
+{
+    return 0.1f * std::sin(x * 7.0f + phase) * std::cos(z * 5.0f - phase);
+}
+
+glm::vec3 gridNormal(float x, float z, float phase)
+{
+    const float dx = 0.7f * std::cos(x * 7.0f + phase) * std::cos(z * 5.0f - phase);
+    const float dz = -0.5f * std::sin(x * 7.0f + phase) * std::sin(z * 5.0f - phase);
+    return glm::normalize(glm::vec3(-dx, 1.0f, -dz));
+}
+
+float gridPhase(uint32_t seed)
+{
+    return static_cast<float>(seed % 628) * 0.01f;
+}
+
+} // namespace
+
+BenchAssets BenchAssets::create()
+{
+    BenchAssets assets;
+    assets.mesh = std::make_shared<rendercore::Mesh>();
+    assets.mesh->name = "BenchCube";
+    assets.mesh->bounds.min = glm::vec3(-0.5f);
+    assets.mesh->bounds.max = glm::vec3(0.5f);
+    assets.material = std::make_shared<rendercore::Material>();
+    assets.material->name = "BenchMaterial";
+    return assets;
+}
+
+float instancedSceneExtent(uint32_t count)
+{
+    return 0.5f * kInstanceSpacing * std::sqrt(static_cast<float>(count));
+}
+
+std::vector<std::shared_ptr<rendercore::SceneNode>> buildInstancedScene(rendercore::Scene &scene,
+                                                                        const BenchAssets &assets, uint32_t count,
+                                                                        uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    const float extent = instancedSceneExtent(count);
+    std::uniform_real_distribution<float> position(-extent, extent);
+    std::uniform_real_distribution<float> height(0.0f, 4.0f);
+    std::uniform_real_distribution<float> scale(0.5f, 1.5f);
+
+    std::vector<std::shared_ptr<rendercore::SceneNode>> nodes;
+    nodes.reserve(count);
+    const std::shared_ptr<rendercore::SceneNode> root = scene.getRootNode();
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        auto node = std::make_shared<rendercore::SceneNode>("Instance");
+        node->setPosition(glm::vec3(position(rng), height(rng), position(rng)));
+        node->setRotation(randomRotation(rng));
+        node->setScale(glm::vec3(scale(rng)));
+        node->setRenderable(makeRenderable(assets));
+        root->addChild(node);
+        nodes.push_back(std::move(node));
+    }
+    return nodes;
+}
+
+std::vector<std::shared_ptr<rendercore::SceneNode>> buildDeepHierarchy(rendercore::Scene &scene,
+                                                                       const BenchAssets &assets, uint32_t depth,
+                                                                       uint32_t leavesPerLevel, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+
+    std::vector<std::shared_ptr<rendercore::SceneNode>> chain;
+    chain.reserve(depth);
+    std::shared_ptr<rendercore::SceneNode> parent = scene.getRootNode();
+    for (uint32_t level = 0; level < depth; ++level)
+    {
+        auto node = std::make_shared<rendercore::SceneNode>("Level");
+        // 每层小幅平移与旋转：深处节点的世界矩阵依赖整条父链
+        node->setPosition(glm::vec3(offset(rng), 0.5f, offset(rng)));
+        node->setRotation(randomRotation(rng));
+        node->setRenderable(makeRenderable(assets));
+        for (uint32_t leaf = 0; leaf < leavesPerLevel; ++leaf)
+        {
+            auto child = std::make_shared<rendercore::SceneNode>("Leaf");
+            child->setPosition(glm::vec3(offset(rng) * 3.0f, 0.0f, offset(rng) * 3.0f));
+            child->setRenderable(makeRenderable(assets));
+            node->addChild(std::move(child));
+        }
+        parent->addChild(node);
+        parent = node;
+        chain.push_back(std::move(node));
+    }
+    return chain;
+}
+
+void addRandomLights(rendercore::Scene &scene, uint32_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const glm::vec3 color(unit(rng), unit(rng), unit(rng));
+        const glm::vec3 where(position(rng), unit(rng) * 20.0f, position(rng));
+        const float pick = unit(rng);
+
+        std::shared_ptr<rendercore::Light> light;
+        if (pick < 0.02f)
+        {
+            light = rendercore::LightFactory::createSunLight(glm::vec3(unit(rng) - 0.5f, -1.0f, unit(rng) - 0.5f));
+        }
+        else if (pick < 0.7f)
+        {
+            light = rendercore::LightFactory::createPointLight(where, color, 1.0f + unit(rng) * 4.0f,
+                                                                 5.0f + unit(rng) * 20.0f);
+        }
+        else
+        {
+            light = rendercore::LightFactory::createSpotLight(where, glm::vec3(0.0f, -1.0f, 0.0f), 25.0f, 35.0f, color);
+        }
+        light->setEnabled(unit(rng) > 0.1f);
+        scene.addLight(std::move(light));
+    }
+}
+
+std::shared_ptr<rendercore::Camera> createOverviewCamera(float extent)
+{
+    // 从场景一侧斜向下俯视：视锥覆盖大约一半的节点，剔除两侧都有工作量
+    auto camera = std::make_shared<rendercore::Camera>(glm::vec3(0.0f, extent * 0.5f, extent),
+                                                       glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, -25.0f);
+    camera->setPerspective(60.0f, 16.0f / 9.0f, 0.1f, extent * 4.0f);
+    return camera;
+}
+
+std::string generateGridObj(uint32_t gridSize, uint32_t seed)
+{
+    const float phase = gridPhase(seed);
+    const uint32_t side = gridSize + 1;
+    std::string obj;
+    obj.reserve(static_cast<size_t>(side) * side * 110 + static_cast<size_t>(gridSize) * gridSize * 40);
+
+    char line[128];
+    for (uint32_t z = 0; z < side; ++z)
+    {
+        for (uint32_t x = 0; x < side; ++x)
+        {
+            const float u = static_cast<float>(x) / gridSize;
+            const float v = static_cast<float>(z) / gridSize;
+            const glm::vec3 n = gridNormal(u, v, phase);
+            std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn %.6f %.6f %.6f\n", u,
+                          gridHeight(u, v, phase), v, u, v, n.x, n.y, n.z);
+            obj += line;
+        }
+    }
+
+    // 按行分成四个分组：解析器为每个 g 生成一个 MeshData
+    const uint32_t rowsPerGroup = (gridSize + 3) / 4;
+    for (uint32_t z = 0; z < gridSize; ++z)
+    {
+        if (z % rowsPerGroup == 0)
+        {
+            std::snprintf(line, sizeof(line), "g Group%u\n", z / rowsPerGroup);
+            obj += line;
+        }
+        for (uint32_t x = 0; x < gridSize; ++x)
+        {
+            // OBJ 索引从 1 开始；v/vt/vn 共用同一个索引
+            const uint32_t a = z * side + x + 1;
+            const uint32_t b = a + 1;
+            const uint32_t c = a + side + 1;
+            const uint32_t d = a + side;
+            std::snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, d, d, d, c, c, c, b,
+                          b, b);
+            obj += line;
+        }
+    }
+    return obj;
+}
+
+rendercore::MeshData generateGridMesh(uint32_t gridSize, uint32_t seed)
+{
+    const float phase = gridPhase(seed);
+    rendercore::MeshData mesh;
+    mesh.name = "BenchGrid";
+    mesh.vertices.reserve(static_cast<size_t>(gridSize) * gridSize * 6);
+    mesh.indices.reserve(static_cast<size_t>(gridSize) * gridSize * 6);
+
+    const auto makeVertex = [&](uint32_t x, uint32_t z) {
+        const float u = static_cast<float>(x) / gridSize;
+        const float v = static_cast<float>(z) / gridSize;
+        rendercore::Vertex vertex{};
+        vertex.color = glm::vec4(1.0f);
+        vertex.position = glm::vec3(u, gridHeight(u, v, phase), v);
+        vertex.normal = gridNormal(u, v, phase);
+        vertex.texCoord = glm::vec2(u, v);
+        return vertex;
+    };
+
+    for (uint32_t z = 0; z < gridSize; ++z)
+    {
+        for (uint32_t x = 0; x < gridSize; ++x)
+        {
+            // 与 OBJ 面相同的两个三角形，每个角点一个顶点（导入时的焊接与优化有实际工作可做）
+            const rendercore::Vertex corners[6] = {makeVertex(x, z),     makeVertex(x, z + 1),
+                                                   makeVertex(x + 1, z + 1), makeVertex(x, z),
+                                                   makeVertex(x + 1, z + 1), makeVertex(x + 1, z)};
+            for (const rendercore::Vertex &vertex : corners)
+            {
+                mesh.indices.push_back(static_cast<uint32_t>(mesh.vertices.size()));
+                mesh.vertices.push_back(vertex);
+            }
+        }
+    }
+    return mesh;
+}
+
+} // namespace bench
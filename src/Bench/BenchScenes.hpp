@@ -0,0 +1,80 @@
+/**
+ * @file BenchScenes.hpp
+ * @brief 基准测试用的程序化场景与几何
+ * @details 所有生成器以固定种子的 std::mt19937 驱动，同一参数每次生成完全相同的数据，
+ *          改动前后的两次运行测量的是同一份输入。网格与材质只在 CPU 端构造（没有 GPU 缓冲），
+ *          场景同步、剔除与 LOD 选择只读取包围盒与 LOD 表。
+ */
+
+#pragma once
+
+#include "Resource/public/ResourceManagerUtils.hpp"
+#include "Resource/public/ResourceType.hpp"
+#include "Scene/public/Scene.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+
+/**
+ * @struct BenchAssets
+ * @brief 场景节点共享的网格与材质（CPU 端占位，包围盒为单位立方体）
+ */
+struct BenchAssets
+{
+    std::shared_ptr<rendercore::Mesh> mesh;
+    std::shared_ptr<rendercore::Material> material;
+
+    static BenchAssets create();
+};
+
+/**
+ * @brief 在根节点下平铺 count 个带渲染组件的节点（位置、旋转、缩放随机）
+ * @param scene 目标场景
+ * @param assets 共享的网格与材质
+ * @param count 节点数
+ * @param seed 随机种子
+ * @return 新建的节点（按创建顺序）
+ */
+std::vector<std::shared_ptr<rendercore::SceneNode>> buildInstancedScene(rendercore::Scene &scene,
+                                                                        const BenchAssets &assets, uint32_t count,
+                                                                        uint32_t seed);
+
+/**
+ * @brief 构建一条深度为 depth 的节点链，每一层再挂 leavesPerLevel 个叶子，所有节点都带渲染组件
+ * @return 链上的节点（[0] 为挂在根节点下的第一层，back() 为最深一层）
+ */
+std::vector<std::shared_ptr<rendercore::SceneNode>> buildDeepHierarchy(rendercore::Scene &scene,
+                                                                       const BenchAssets &assets, uint32_t depth,
+                                                                       uint32_t leavesPerLevel, uint32_t seed);
+
+/**
+ * @brief 向场景添加 count 个光源（点光源、聚光灯与少量平行光混合，约十分之一禁用）
+ */
+void addRandomLights(rendercore::Scene &scene, uint32_t count, uint32_t seed);
+
+/**
+ * @brief 创建观察整个平铺场景的相机
+ * @param extent 场景的半边长（与 buildInstancedScene 的分布范围一致）
+ */
+std::shared_ptr<rendercore::Camera> createOverviewCamera(float extent);
+
+/**
+ * @brief buildInstancedScene 中 count 个节点的分布半边长
+ */
+float instancedSceneExtent(uint32_t count);
+
+/**
+ * @brief 生成 gridSize x gridSize 个四边形的起伏网格 OBJ 文本（v/vt/vn 与四边形面，分四个 g 分组）
+ */
+std::string generateGridObj(uint32_t gridSize, uint32_t seed);
+
+/**
+ * @brief 生成与 generateGridObj 相同拓扑的 MeshData（每个角点独立的顶点，未去重、未优化）
+ */
+rendercore::MeshData generateGridMesh(uint32_t gridSize, uint32_t seed);
+
+} // namespace bench
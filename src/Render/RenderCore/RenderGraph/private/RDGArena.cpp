@@ -0,0 +1,145 @@
+/**
+ * @file RDGArena.cpp
+ * @brief RDGLinearArena类的实现
+ */
+
+#include "RDGArena.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace rendercore
+{
+
+namespace
+{
+
+/// 进程级缓存的默认大小空闲块数量上限（约 2 MB）
+constexpr size_t kMaxCachedBlocks = 32;
+
+/**
+ * @struct BlockCache
+ * @brief 跨 RenderGraph 复用的空闲块（每帧新建的渲染图从这里取块，避免逐帧申请与释放）
+ */
+struct BlockCache
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<std::byte[]>> blocks;
+};
+
+BlockCache &blockCache()
+{
+    static BlockCache cache;
+    return cache;
+}
+
+/**
+ * @brief 计算 offset 之后第一个满足对齐的偏移
+ */
+size_t alignedOffset(const std::byte *base, size_t offset, size_t alignment)
+{
+    const uintptr_t address = reinterpret_cast<uintptr_t>(base) + offset;
+    const uintptr_t aligned = (address + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    return offset + static_cast<size_t>(aligned - address);
+}
+
+} // namespace
+
+// ==================== 构造函数和析构函数 ====================
+
+RDGLinearArena::RDGLinearArena(size_t blockSize) : m_blockSize(std::max<size_t>(blockSize, 256))
+{
+}
+
+RDGLinearArena::~RDGLinearArena()
+{
+    destroyobjects();
+
+    BlockCache &cache = blockCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    for (auto &block : m_blocks)
+    {
+        if (block.size == kDefaultBlockSize && cache.blocks.size() < kMaxCachedBlocks)
+        {
+            cache.blocks.push_back(std::move(block.data));
+        }
+    }
+}
+
+// ==================== 分配 ====================
+
+void *RDGLinearArena::allocate(size_t size, size_t alignment)
+{
+    if (m_blocks.empty() ||
+        alignedOffset(m_blocks[m_blockIndex].data.get(), m_offset, alignment) + size > m_blocks[m_blockIndex].size)
+    {
+        advanceblock(size, alignment);
+    }
+
+    Block &block = m_blocks[m_blockIndex];
+    const size_t begin = alignedOffset(block.data.get(), m_offset, alignment);
+    m_bytesAllocated += begin + size - m_offset;
+    m_offset = begin + size;
+    return block.data.get() + begin;
+}
+
+void RDGLinearArena::reset()
+{
+    destroyobjects();
+    m_blockIndex = 0;
+    m_offset = 0;
+    m_bytesAllocated = 0;
+}
+
+// ==================== 内部实现 ====================
+
+void RDGLinearArena::advanceblock(size_t size, size_t alignment)
+{
+    // 块起始地址按 max_align_t 对齐，更大的对齐要求预留填充
+    const size_t required = size + (alignment > alignof(std::max_align_t) ? alignment : 0);
+
+    // reset() 之后优先复用已有的块
+    size_t next = m_blocks.empty() ? 0 : m_blockIndex + 1;
+    while (next < m_blocks.size() && m_blocks[next].size < required)
+    {
+        ++next;
+    }
+
+    if (next == m_blocks.size())
+    {
+        Block block;
+        block.size = std::max(required, m_blockSize);
+
+        if (block.size == kDefaultBlockSize)
+        {
+            BlockCache &cache = blockCache();
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            if (!cache.blocks.empty())
+            {
+                block.data = std::move(cache.blocks.back());
+                cache.blocks.pop_back();
+            }
+        }
+        if (!block.data)
+        {
+            block.data.reset(new std::byte[block.size]); // 不需要零初始化
+        }
+
+        m_blocks.push_back(std::move(block));
+    }
+
+    m_blockIndex = next;
+    m_offset = 0;
+}
+
+void RDGLinearArena::destroyobjects()
+{
+    // 链表头是最后构造的对象，按构造的逆序析构
+    while (m_destructors)
+    {
+        DestructorRecord *record = m_destructors;
+        m_destructors = record->next;
+        record->destroy(record->object);
+    }
+}
+
+} // namespace rendercore
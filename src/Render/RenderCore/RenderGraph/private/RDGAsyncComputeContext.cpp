@@ -0,0 +1,70 @@
+/**
+ * @file RDGAsyncComputeContext.cpp
+ * @brief RDGAsyncComputeContext类的实现
+ */
+
+#include "RDGAsyncComputeContext.hpp"
+#include "VulkanCore/public/CommandPoolManager.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include <stdexcept>
+
+namespace rendercore
+{
+
+RDGAsyncComputeContext::RDGAsyncComputeContext(vkcore::Device &device, uint32_t framesInFlight)
+    : m_device(device), m_framesInFlight(framesInFlight)
+{
+    if (framesInFlight == 0)
+    {
+        throw std::invalid_argument("RDGAsyncComputeContext: framesInFlight must be > 0");
+    }
+
+    m_commandManager = std::make_unique<vkcore::CommandPoolManager>(device, device.getComputeQueueFamilyIndices());
+    m_slots.resize(framesInFlight);
+}
+
+RDGAsyncComputeContext::~RDGAsyncComputeContext()
+{
+    for (auto &slot : m_slots)
+    {
+        for (vk::Semaphore semaphore : slot.semaphores)
+        {
+            m_device.get().destroySemaphore(semaphore);
+        }
+        slot.semaphores.clear();
+    }
+
+    m_commandManager.reset();
+}
+
+bool RDGAsyncComputeContext::isAvailable() const
+{
+    return m_device.hasDedicatedComputeQueue();
+}
+
+size_t RDGAsyncComputeContext::getSemaphoreCount() const
+{
+    return m_slots[m_frameIndex % m_framesInFlight].semaphores.size();
+}
+
+vk::Semaphore RDGAsyncComputeContext::acquireSemaphore()
+{
+    FrameSlot &slot = m_slots[m_frameIndex % m_framesInFlight];
+
+    if (slot.usedCount == slot.semaphores.size())
+    {
+        slot.semaphores.push_back(m_device.get().createSemaphore(vk::SemaphoreCreateInfo{}));
+    }
+
+    return slot.semaphores[slot.usedCount++];
+}
+
+void RDGAsyncComputeContext::advanceFrame()
+{
+    ++m_frameIndex;
+
+    // 新槽位上一次使用是 framesInFlight 帧之前，其等待操作已随帧 Fence 完成，信号量回到未触发状态
+    m_slots[m_frameIndex % m_framesInFlight].usedCount = 0;
+}
+
+} // namespace rendercore
@@ -5,7 +5,13 @@
 
 #include "RDGBuilder.hpp"
 #include "RenderGraph.hpp"
+#include "VulkanCore/public/Profiler.hpp"
+#include "VulkanCore/public/OffscreenSwapChain.hpp"
 #include "VulkanCore/public/SwapChain.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
 #include <stdexcept>
 
 
@@ -14,9 +20,14 @@ namespace rendercore
 
 // ==================== 构造函数和析构函数 ====================
 
-RDGBuilder::RDGBuilder(vkcore::Device &device, vkcore::CommandPoolManager &cmdManager, VmaAllocator allocator)
+RDGBuilder::RDGBuilder(vkcore::Device &device, vkcore::CommandPoolManager &cmdManager, VmaAllocator allocator,
+                       RDGCompileCache *compileCache, RDGTransientAllocator *transientAllocator,
+                       vkcore::SamplerCache *samplerCache)
     : m_pimpl(std::make_unique<RenderGraph>(device, cmdManager, allocator)), m_executed(false)
 {
+    m_pimpl->setCompileCache(compileCache);
+    m_pimpl->setTransientAllocator(transientAllocator);
+    m_pimpl->setSamplerCache(samplerCache);
 }
 
 RDGBuilder::~RDGBuilder()
@@ -50,6 +61,17 @@ RDGPass &RDGBuilder::addPass(std::string name, RDGPass::ExecuteCallbackEx &&call
     return m_pimpl->addPassEx(std::move(name), std::move(callback));
 }
 
+RDGPass &RDGBuilder::addPass(std::string name, uint32_t chunkCount, RDGPass::ParallelExecuteCallback &&callback)
+{
+    validateState();
+    return m_pimpl->addParallelPass(std::move(name), chunkCount, std::move(callback));
+}
+
+bool RDGBuilder::isLocalReadSupported() const
+{
+    return m_pimpl->isLocalReadEnabled();
+}
+
 // ==================== 瞬态资源创建 ====================
 
 RDGTextureHandle RDGBuilder::createTexture(const RDGTextureDesc &desc)
@@ -79,7 +101,7 @@ RDGBufferHandle RDGBuilder::createBuffer(const RDGBufferDesc &desc)
 // ==================== 外部资源导入 ====================
 
 RDGTextureHandle RDGBuilder::registerExternalTexture(vkcore::Image *image, const std::string &name,
-                                                     vk::ImageLayout currentLayout)
+                                                     vk::ImageLayout currentLayout, vk::PipelineStageFlags lastStages)
 {
     validateState();
 
@@ -88,7 +110,9 @@ RDGTextureHandle RDGBuilder::registerExternalTexture(vkcore::Image *image, const
         throw std::invalid_argument("RDGBuilder::registerExternalTexture: Image cannot be null");
     }
 
-    return m_pimpl->registerExternalTexture(image, name, currentLayout);
+    // 传统阶段掩码与 Synchronization2 掩码的低32位定义一致
+    return m_pimpl->registerExternalTexture(image, name, currentLayout,
+                                            vk::PipelineStageFlags2(static_cast<VkPipelineStageFlags>(lastStages)));
 }
 
 RDGBufferHandle RDGBuilder::registerExternalBuffer(vkcore::Buffer *buffer, const std::string &name)
@@ -111,6 +135,12 @@ RDGTextureHandle RDGBuilder::getSwapChainAttachment(vkcore::SwapChain &swapChain
     return m_pimpl->importSwapChainImage(swapChain, imageIndex);
 }
 
+RDGTextureHandle RDGBuilder::getOffscreenAttachment(vkcore::OffscreenSwapChain &swapChain, uint32_t imageIndex)
+{
+    validateState();
+    return m_pimpl->importOffscreenImage(swapChain, imageIndex);
+}
+
 RDGTextureHandle RDGBuilder::createTexture2D(const std::string &name, vk::Format format, uint32_t width,
                                              uint32_t height, vk::ImageUsageFlags usage)
 {
@@ -146,6 +176,7 @@ RDGTextureHandle RDGBuilder::createColorBuffer(const std::string &name, uint32_t
 
 void RDGBuilder::execute(RDGSyncInfo *syncInfo)
 {
+    QTR_PROFILE_SCOPE("RDGBuilder::execute");
     if (m_executed)
     {
         throw std::runtime_error("RDGBuilder::execute: Already executed");
@@ -162,6 +193,15 @@ void RDGBuilder::execute(RDGSyncInfo *syncInfo)
 
 // ==================== 查询接口 ====================
 
+vk::ImageLayout RDGBuilder::getFinalLayout(RDGTextureHandle handle) const
+{
+    if (!m_executed)
+    {
+        throw std::runtime_error("RDGBuilder::getFinalLayout: Graph has not been executed");
+    }
+    return m_pimpl->getTextureLayout(handle);
+}
+
 size_t RDGBuilder::getPassCount() const
 {
     return m_pimpl->getPassCount();
@@ -177,6 +217,94 @@ void RDGBuilder::setDebugName(const std::string &name)
     m_pimpl->setDebugName(name);
 }
 
+const RDGGraphStats &RDGBuilder::getStats() const
+{
+    if (!m_executed)
+    {
+        throw std::runtime_error("RDGBuilder::getStats: Graph has not been executed");
+    }
+    return m_pimpl->getStats();
+}
+
+void RDGBuilder::dumpGraphviz(const std::filesystem::path &path) const
+{
+    if (!m_executed)
+    {
+        throw std::runtime_error("RDGBuilder::dumpGraphviz: Graph has not been executed");
+    }
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("RDGBuilder::dumpGraphviz: cannot open " + path.string());
+    }
+    m_pimpl->writeGraphviz(file);
+}
+
+void RDGBuilder::dumpJson(const std::filesystem::path &path) const
+{
+    if (!m_executed)
+    {
+        throw std::runtime_error("RDGBuilder::dumpJson: Graph has not been executed");
+    }
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("RDGBuilder::dumpJson: cannot open " + path.string());
+    }
+    m_pimpl->writeJson(file);
+}
+
+void RDGBuilder::setWorkerPool(vkcore::WorkerPool *workerPool)
+{
+    validateState();
+    m_pimpl->setWorkerPool(workerPool);
+}
+
+void RDGBuilder::setAsyncCompute(RDGAsyncComputeContext *context)
+{
+    validateState();
+    m_pimpl->setAsyncComputeContext(context);
+}
+
+void RDGBuilder::setEventPool(RDGEventPool *eventPool)
+{
+    validateState();
+    m_pimpl->setEventPool(eventPool);
+}
+
+void RDGBuilder::setProfiler(RDGProfiler *profiler)
+{
+    validateState();
+    m_pimpl->setProfiler(profiler);
+}
+
+void RDGBuilder::setDeletionQueue(vkcore::DeferredDeletionQueue *queue)
+{
+    validateState();
+    m_pimpl->setDeletionQueue(queue);
+}
+
+// ==================== 动态分辨率 ====================
+
+void RDGBuilder::setRenderScale(float scale)
+{
+    validateState();
+    m_pimpl->setRenderScale(std::clamp(scale, std::numeric_limits<float>::min(), 1.0f));
+}
+
+float RDGBuilder::getRenderScale() const
+{
+    return m_pimpl->getRenderScale();
+}
+
+vk::Extent2D RDGBuilder::scaleExtent(vk::Extent2D extent, float scale)
+{
+    const auto scaleaxis = [scale](uint32_t size) {
+        return std::max(1u, static_cast<uint32_t>(std::ceil(static_cast<double>(size) * scale)));
+    };
+    return vk::Extent2D{scaleaxis(extent.width), scaleaxis(extent.height)};
+}
+
 // ==================== 私有方法 ====================
 
 void RDGBuilder::validateState() const
@@ -0,0 +1,84 @@
+/**
+ * @file RDGCompileCache.cpp
+ * @brief RDGCompileCache 实现
+ */
+
+#include "RDGCompileCache.hpp"
+#include "RenderGraph.hpp"
+#include <stdexcept>
+#include <utility>
+
+namespace rendercore
+{
+
+// ==================== 构造函数和析构函数 ====================
+
+RDGCompileCache::RDGCompileCache(size_t maxEntries) : m_maxEntries(maxEntries)
+{
+    if (maxEntries == 0)
+    {
+        throw std::invalid_argument("RDGCompileCache: maxEntries must be > 0");
+    }
+}
+
+RDGCompileCache::~RDGCompileCache() = default;
+
+// ==================== 公共接口 ====================
+
+void RDGCompileCache::clear()
+{
+    m_entries.clear();
+}
+
+void RDGCompileCache::advanceFrame()
+{
+    ++m_frameIndex;
+}
+
+// ==================== 私有函数 ====================
+
+RDGCachedGraph *RDGCompileCache::find(uint64_t topologyHash, const std::vector<uint64_t> &topologyKey)
+{
+    auto [begin, end] = m_entries.equal_range(topologyHash);
+    for (auto it = begin; it != end; ++it)
+    {
+        if (it->second->topologyKey == topologyKey)
+        {
+            ++m_hitCount;
+            it->second->lastUsedFrame = m_frameIndex;
+            return it->second.get();
+        }
+    }
+    return nullptr;
+}
+
+RDGCachedGraph &RDGCompileCache::insert(uint64_t topologyHash, std::vector<uint64_t> topologyKey)
+{
+    ++m_missCount;
+    evictstale();
+
+    auto entry = std::make_unique<RDGCachedGraph>();
+    entry->topologyKey = std::move(topologyKey);
+    entry->lastUsedFrame = m_frameIndex;
+    return *m_entries.emplace(topologyHash, std::move(entry))->second;
+}
+
+void RDGCompileCache::evictstale()
+{
+    while (!m_entries.empty() && m_entries.size() >= m_maxEntries)
+    {
+        // 查找最久未使用的条目
+        auto oldest = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            if (it->second->lastUsedFrame < oldest->second->lastUsedFrame)
+            {
+                oldest = it;
+            }
+        }
+
+        m_entries.erase(oldest);
+    }
+}
+
+} // namespace rendercore
@@ -0,0 +1,64 @@
+/**
+ * @file RDGEventPool.cpp
+ * @brief RDGEventPool类的实现
+ */
+
+#include "RDGEventPool.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include <stdexcept>
+
+namespace rendercore
+{
+
+RDGEventPool::RDGEventPool(vkcore::Device &device, uint32_t framesInFlight)
+    : m_device(device), m_framesInFlight(framesInFlight)
+{
+    if (framesInFlight == 0)
+    {
+        throw std::invalid_argument("RDGEventPool: framesInFlight must be > 0");
+    }
+
+    m_slots.resize(framesInFlight);
+}
+
+RDGEventPool::~RDGEventPool()
+{
+    for (auto &slot : m_slots)
+    {
+        for (vk::Event event : slot.events)
+        {
+            m_device.get().destroyEvent(event);
+        }
+        slot.events.clear();
+    }
+}
+
+size_t RDGEventPool::getEventCount() const
+{
+    return m_slots[m_frameIndex % m_framesInFlight].events.size();
+}
+
+vk::Event RDGEventPool::acquireEvent()
+{
+    FrameSlot &slot = m_slots[m_frameIndex % m_framesInFlight];
+
+    if (slot.usedCount == slot.events.size())
+    {
+        // 事件只在GPU上触发与等待，声明为仅设备端使用可以让驱动省去主机可见性
+        vk::EventCreateInfo createInfo{};
+        createInfo.flags = vk::EventCreateFlagBits::eDeviceOnly;
+        slot.events.push_back(m_device.get().createEvent(createInfo));
+    }
+
+    return slot.events[slot.usedCount++];
+}
+
+void RDGEventPool::advanceFrame()
+{
+    ++m_frameIndex;
+
+    // 新槽位上一次使用是 framesInFlight 帧之前，事件在等待之后已在GPU上重置
+    m_slots[m_frameIndex % m_framesInFlight].usedCount = 0;
+}
+
+} // namespace rendercore
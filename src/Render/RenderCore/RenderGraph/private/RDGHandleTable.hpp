@@ -0,0 +1,129 @@
+/**
+ * @file RDGHandleTable.hpp
+ * @brief 以资源句柄为下标的稠密表
+ * @details 句柄由 RenderGraph 从 1 开始连续生成，纹理与缓冲区共用同一个计数器，
+ *          因此每种资源的数据都可以直接放在以句柄为下标的连续数组中（另一种资源的句柄处为空值），
+ *          查找是一次数组访问，遍历按句柄（即声明）顺序进行
+ */
+
+#pragma once
+
+#include "RDGHandle.hpp"
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rendercore
+{
+
+/**
+ * @class RDGHandleTable
+ * @brief 句柄 -> T 的稠密映射（T 的值初始化结果表示“不存在”，例如空指针）
+ *
+ * @example
+ * @code
+ * RDGHandleTable<RDGTextureResource *> textures;
+ * textures[handle] = texture;
+ * if (RDGTextureResource *resource = textures.find(handle)) { ... }
+ * for (const auto &[handle, resource] : textures) { ... } // 跳过空值
+ * @endcode
+ */
+template <typename T> class RDGHandleTable
+{
+  public:
+    /**
+     * @class Iterator
+     * @brief 只遍历非空项，解引用得到 (句柄, 值) 对
+     */
+    class Iterator
+    {
+      public:
+        Iterator(const std::vector<T> &values, size_t index) : m_values(&values), m_index(index)
+        {
+            skipEmpty();
+        }
+
+        std::pair<RDGResourceHandle, T> operator*() const
+        {
+            return {static_cast<RDGResourceHandle>(m_index), (*m_values)[m_index]};
+        }
+
+        Iterator &operator++()
+        {
+            ++m_index;
+            skipEmpty();
+            return *this;
+        }
+
+        bool operator!=(const Iterator &other) const
+        {
+            return m_index != other.m_index;
+        }
+
+      private:
+        const std::vector<T> *m_values;
+        size_t m_index;
+
+        void skipEmpty()
+        {
+            while (m_index < m_values->size() && (*m_values)[m_index] == T{})
+            {
+                ++m_index;
+            }
+        }
+    };
+
+    /**
+     * @brief 获取项的引用（必要时扩展表）
+     */
+    T &operator[](RDGResourceHandle handle)
+    {
+        if (handle >= m_values.size())
+        {
+            m_values.resize(static_cast<size_t>(handle) + 1, T{});
+        }
+        return m_values[handle];
+    }
+
+    /**
+     * @brief 查找项，不存在时返回空值
+     */
+    T find(RDGResourceHandle handle) const
+    {
+        return handle < m_values.size() ? m_values[handle] : T{};
+    }
+
+    /**
+     * @brief 查找项，不存在时抛出异常
+     * @throws std::out_of_range 如果句柄处为空值
+     */
+    T at(RDGResourceHandle handle) const
+    {
+        if (handle >= m_values.size() || m_values[handle] == T{})
+        {
+            throw std::out_of_range("RDGHandleTable::at: Unknown handle " + std::to_string(handle));
+        }
+        return m_values[handle];
+    }
+
+    void clear()
+    {
+        m_values.clear();
+    }
+
+    Iterator begin() const
+    {
+        return Iterator(m_values, 0);
+    }
+
+    Iterator end() const
+    {
+        return Iterator(m_values, m_values.size());
+    }
+
+  private:
+    std::vector<T> m_values; ///< 下标 0 对应 kInvalidHandle，始终为空值
+};
+
+} // namespace rendercore
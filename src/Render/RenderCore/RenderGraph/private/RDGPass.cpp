@@ -11,9 +11,13 @@ namespace rendercore
 
 // ==================== 构造函数 ====================
 
-RDGPass::RDGPass(std::string name, ExecuteCallback &&callback)
-    : m_name(std::move(name)), m_executeCallback(std::move(callback)),
-      m_useExtendedCallback(false), m_depthAttachment{kInvalidTextureHandle} // 初始化为无效句柄
+RDGPass::RDGPass(RDGLinearArena &arena, std::string name, ExecuteCallback &&callback)
+    : m_name(std::move(name)), m_executeCallback(std::move(callback)), m_useExtendedCallback(false),
+      m_textureReads(TextureAccessList::allocator_type(arena)), m_bufferReads(BufferAccessList::allocator_type(arena)),
+      m_colorAttachments(ColorAttachmentList::allocator_type(arena)),
+      m_depthAttachment{kInvalidTextureHandle}, // 初始化为无效句柄
+      m_textureWrites(TextureAccessList::allocator_type(arena)),
+      m_bufferWrites(BufferAccessList::allocator_type(arena))
 {
     if (!m_executeCallback)
     {
@@ -21,9 +25,13 @@ RDGPass::RDGPass(std::string name, ExecuteCallback &&callback)
     }
 }
 
-RDGPass::RDGPass(std::string name, ExecuteCallbackEx &&callback)
-    : m_name(std::move(name)), m_executeCallbackEx(std::move(callback)),
-      m_useExtendedCallback(true), m_depthAttachment{kInvalidTextureHandle} // 初始化为无效句柄
+RDGPass::RDGPass(RDGLinearArena &arena, std::string name, ExecuteCallbackEx &&callback)
+    : m_name(std::move(name)), m_executeCallbackEx(std::move(callback)), m_useExtendedCallback(true),
+      m_textureReads(TextureAccessList::allocator_type(arena)), m_bufferReads(BufferAccessList::allocator_type(arena)),
+      m_colorAttachments(ColorAttachmentList::allocator_type(arena)),
+      m_depthAttachment{kInvalidTextureHandle}, // 初始化为无效句柄
+      m_textureWrites(TextureAccessList::allocator_type(arena)),
+      m_bufferWrites(BufferAccessList::allocator_type(arena))
 {
     if (!m_executeCallbackEx)
     {
@@ -31,6 +39,25 @@ RDGPass::RDGPass(std::string name, ExecuteCallbackEx &&callback)
     }
 }
 
+RDGPass::RDGPass(RDGLinearArena &arena, std::string name, uint32_t chunkCount, ParallelExecuteCallback &&callback)
+    : m_name(std::move(name)), m_parallelCallback(std::move(callback)), m_useExtendedCallback(true),
+      m_chunkCount(chunkCount), m_textureReads(TextureAccessList::allocator_type(arena)),
+      m_bufferReads(BufferAccessList::allocator_type(arena)),
+      m_colorAttachments(ColorAttachmentList::allocator_type(arena)),
+      m_depthAttachment{kInvalidTextureHandle}, // 初始化为无效句柄
+      m_textureWrites(TextureAccessList::allocator_type(arena)),
+      m_bufferWrites(BufferAccessList::allocator_type(arena))
+{
+    if (!m_parallelCallback)
+    {
+        throw std::invalid_argument("RDGPass: ParallelExecuteCallback cannot be null");
+    }
+    if (chunkCount == 0)
+    {
+        throw std::invalid_argument("RDGPass: chunkCount must be > 0");
+    }
+}
+
 // ==================== 资源读依赖 ====================
 
 RDGPass &RDGPass::readTexture(RDGTextureHandle handle, vk::PipelineStageFlags stages, vk::AccessFlags access)
@@ -63,6 +90,23 @@ RDGPass &RDGPass::readTexture(RDGTextureHandle handle, vk::PipelineStageFlags st
     return *this;
 }
 
+RDGPass &RDGPass::readInputAttachment(RDGTextureHandle handle)
+{
+    if (!handle.isValid())
+    {
+        throw std::invalid_argument("RDGPass::readInputAttachment: Invalid texture handle");
+    }
+
+    TextureAccess textureAccess{};
+    textureAccess.handle = handle;
+    textureAccess.stages = vk::PipelineStageFlagBits::eFragmentShader;
+    textureAccess.access = vk::AccessFlagBits::eInputAttachmentRead;
+    textureAccess.layout = vk::ImageLayout::eRenderingLocalReadKHR;
+
+    m_textureReads.push_back(textureAccess);
+    return *this;
+}
+
 RDGPass &RDGPass::readBuffer(RDGBufferHandle handle, vk::PipelineStageFlags stages, vk::AccessFlags access)
 {
     if (!handle.isValid())
@@ -124,6 +168,34 @@ RDGPass &RDGPass::writeDepthStencilAttachment(RDGTextureHandle handle, vk::Attac
     return *this;
 }
 
+RDGPass &RDGPass::setShadingRateAttachment(RDGTextureHandle handle, vk::Extent2D texelSize)
+{
+    if (!handle.isValid())
+    {
+        throw std::invalid_argument("RDGPass::setShadingRateAttachment: Invalid texture handle");
+    }
+    if (texelSize.width == 0 || texelSize.height == 0)
+    {
+        throw std::invalid_argument("RDGPass::setShadingRateAttachment: Texel size must be non-zero");
+    }
+    if (m_shadingRateAttachment.handle.isValid())
+    {
+        throw std::runtime_error("RDGPass::setShadingRateAttachment: Shading rate attachment already set");
+    }
+
+    m_shadingRateAttachment.handle = handle;
+    m_shadingRateAttachment.texelSize = texelSize;
+
+    // 作为普通读取参与依赖分析与屏障计算，布局固定为着色速率附件布局
+    TextureAccess textureAccess{};
+    textureAccess.handle = handle;
+    textureAccess.stages = vk::PipelineStageFlagBits::eFragmentShadingRateAttachmentKHR;
+    textureAccess.access = vk::AccessFlagBits::eFragmentShadingRateAttachmentReadKHR;
+    textureAccess.layout = vk::ImageLayout::eFragmentShadingRateAttachmentOptimalKHR;
+    m_textureReads.push_back(textureAccess);
+    return *this;
+}
+
 // ==================== 计算/存储资源依赖 ====================
 
 RDGPass &RDGPass::writeStorageTexture(RDGTextureHandle handle, vk::PipelineStageFlags stages, vk::AccessFlags access)
@@ -159,4 +231,12 @@ RDGPass &RDGPass::writeStorageBuffer(RDGBufferHandle handle, vk::PipelineStageFl
     return *this;
 }
 
+// ==================== 队列调度 ====================
+
+RDGPass &RDGPass::setAsyncCompute(bool enable)
+{
+    m_asyncCompute = enable;
+    return *this;
+}
+
 } // namespace rendercore
@@ -0,0 +1,254 @@
+/**
+ * @file RDGProfiler.cpp
+ * @brief RDGProfiler类的实现
+ */
+
+#include "RDGProfiler.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+namespace rendercore
+{
+
+namespace
+{
+
+constexpr vk::QueryPipelineStatisticFlags kStatisticFlags =
+    vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices |
+    vk::QueryPipelineStatisticFlagBits::eInputAssemblyPrimitives |
+    vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+    vk::QueryPipelineStatisticFlagBits::eClippingPrimitives |
+    vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations |
+    vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+
+/// 结果按标志位从低到高排列，与 RDGPassStatistics 的成员顺序一致
+constexpr uint32_t kStatisticCount = 6;
+
+} // namespace
+
+RDGProfiler::RDGProfiler(vkcore::Device &device, uint32_t framesInFlight)
+    : RDGProfiler(device, framesInFlight, Config{})
+{
+}
+
+RDGProfiler::RDGProfiler(vkcore::Device &device, uint32_t framesInFlight, const Config &config)
+    : m_device(device), m_framesInFlight(framesInFlight), m_maxPasses(config.maxPasses),
+      m_historyLength(std::max<size_t>(config.historyLength, 1))
+{
+    if (framesInFlight == 0 || config.maxPasses == 0)
+    {
+        throw std::invalid_argument("RDGProfiler: framesInFlight and maxPasses must be > 0");
+    }
+    if (!device.isFeatureEnabled("hostQueryReset"))
+    {
+        throw std::runtime_error("RDGProfiler: hostQueryReset is not enabled");
+    }
+
+    vk::PhysicalDevice physicalDevice = device.getPhysicalDevice();
+    m_timestampPeriod = physicalDevice.getProperties().limits.timestampPeriod;
+    for (const auto &family : physicalDevice.getQueueFamilyProperties())
+    {
+        m_timestampValidBits.push_back(family.timestampValidBits);
+    }
+    if (m_timestampValidBits[device.getGraphicsQueueFamilyIndices()] == 0)
+    {
+        throw std::runtime_error("RDGProfiler: graphics queue does not support timestamps");
+    }
+
+    const bool statistics = config.pipelineStatistics && device.isFeatureEnabled("pipelineStatisticsQuery");
+
+    m_slots.resize(framesInFlight);
+    for (auto &slot : m_slots)
+    {
+        vk::QueryPoolCreateInfo timestampInfo{};
+        timestampInfo.queryType = vk::QueryType::eTimestamp;
+        timestampInfo.queryCount = m_maxPasses * 2;
+        slot.timestampPool = device.get().createQueryPool(timestampInfo);
+        device.get().resetQueryPool(slot.timestampPool, 0, timestampInfo.queryCount);
+
+        if (statistics)
+        {
+            vk::QueryPoolCreateInfo statisticsInfo{};
+            statisticsInfo.queryType = vk::QueryType::ePipelineStatistics;
+            statisticsInfo.queryCount = m_maxPasses;
+            statisticsInfo.pipelineStatistics = kStatisticFlags;
+            slot.statisticsPool = device.get().createQueryPool(statisticsInfo);
+            device.get().resetQueryPool(slot.statisticsPool, 0, statisticsInfo.queryCount);
+        }
+    }
+}
+
+RDGProfiler::~RDGProfiler()
+{
+    for (auto &slot : m_slots)
+    {
+        m_device.get().destroyQueryPool(slot.timestampPool);
+        if (slot.statisticsPool)
+        {
+            m_device.get().destroyQueryPool(slot.statisticsPool);
+        }
+    }
+}
+
+double RDGProfiler::getAverageTime(const std::string &passName) const
+{
+    double total = 0.0;
+    size_t frames = 0;
+    for (const auto &frame : m_history)
+    {
+        bool found = false;
+        for (const auto &pass : frame.passes)
+        {
+            if (pass.name == passName)
+            {
+                total += pass.gpuMs;
+                found = true;
+            }
+        }
+        frames += found ? 1 : 0;
+    }
+    return frames > 0 ? total / static_cast<double>(frames) : 0.0;
+}
+
+void RDGProfiler::beginFrame()
+{
+    FrameSlot &slot = m_slots[m_frameIndex % m_framesInFlight];
+    if (slot.passes.empty())
+    {
+        return;
+    }
+
+    // 槽位上一次使用是 framesInFlight 帧之前，其 GPU 工作已完成，结果应当已就绪
+    if (!resolve(slot))
+    {
+        ++m_droppedFrames;
+    }
+
+    // 读回后在主机端重置，本帧无需在命令缓冲区中录制 vkCmdResetQueryPool
+    const uint32_t passCount = static_cast<uint32_t>(slot.passes.size());
+    m_device.get().resetQueryPool(slot.timestampPool, 0, passCount * 2);
+    if (slot.statisticsPool)
+    {
+        m_device.get().resetQueryPool(slot.statisticsPool, 0, passCount);
+    }
+    slot.passes.clear();
+}
+
+uint32_t RDGProfiler::registerPass(const std::string &name, RDGQueueType queue, uint32_t queueFamily,
+                                   bool statistics)
+{
+    FrameSlot &slot = m_slots[m_frameIndex % m_framesInFlight];
+    if (slot.passes.size() >= m_maxPasses || queueFamily >= m_timestampValidBits.size() ||
+        m_timestampValidBits[queueFamily] == 0)
+    {
+        return UINT32_MAX;
+    }
+
+    // 管线统计中包含图形阶段，只能在图形队列上录制
+    const bool recordStatistics = statistics && slot.statisticsPool && queue == RDGQueueType::Graphics;
+    slot.frameIndex = m_frameIndex;
+    slot.passes.push_back({name, queue, recordStatistics});
+    return static_cast<uint32_t>(slot.passes.size() - 1);
+}
+
+void RDGProfiler::writeBegin(vk::CommandBuffer cmd, uint32_t queryIndex) const
+{
+    const FrameSlot &slot = m_slots[m_frameIndex % m_framesInFlight];
+    cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eTopOfPipe, slot.timestampPool, queryIndex * 2);
+    if (slot.passes[queryIndex].statistics)
+    {
+        cmd.beginQuery(slot.statisticsPool, queryIndex, {});
+    }
+}
+
+void RDGProfiler::writeEnd(vk::CommandBuffer cmd, uint32_t queryIndex) const
+{
+    const FrameSlot &slot = m_slots[m_frameIndex % m_framesInFlight];
+    if (slot.passes[queryIndex].statistics)
+    {
+        cmd.endQuery(slot.statisticsPool, queryIndex);
+    }
+    cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eBottomOfPipe, slot.timestampPool, queryIndex * 2 + 1);
+}
+
+void RDGProfiler::advanceFrame()
+{
+    ++m_frameIndex;
+}
+
+bool RDGProfiler::resolve(FrameSlot &slot)
+{
+    const uint32_t passCount = static_cast<uint32_t>(slot.passes.size());
+
+    // 不带 eWait：结果未就绪时返回 eNotReady，丢弃该帧而不是阻塞
+    std::vector<uint64_t> timestamps(passCount * 2);
+    vk::Result result = m_device.get().getQueryPoolResults(
+        slot.timestampPool, 0, passCount * 2, timestamps.size() * sizeof(uint64_t), timestamps.data(),
+        sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+    if (result != vk::Result::eSuccess)
+    {
+        return false;
+    }
+
+    RDGFrameTiming frame;
+    frame.frameIndex = slot.frameIndex;
+    frame.passes.reserve(passCount);
+
+    const uint32_t graphicsFamily = m_device.getGraphicsQueueFamilyIndices();
+    const uint32_t computeFamily = m_device.getComputeQueueFamilyIndices();
+    uint64_t frameBegin = std::numeric_limits<uint64_t>::max();
+    uint64_t frameEnd = 0;
+    for (uint32_t i = 0; i < passCount; ++i)
+    {
+        const PassRecord &record = slot.passes[i];
+        const uint32_t family = record.queue == RDGQueueType::Graphics ? graphicsFamily : computeFamily;
+        const uint32_t validBits = m_timestampValidBits[family];
+        const uint64_t mask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+        const uint64_t begin = timestamps[i * 2] & mask;
+        const uint64_t end = timestamps[i * 2 + 1] & mask;
+        frameBegin = std::min(frameBegin, begin);
+        frameEnd = std::max(frameEnd, end);
+
+        RDGPassTiming timing;
+        timing.name = record.name;
+        timing.queue = record.queue;
+        timing.gpuMs = static_cast<double>((end - begin) & mask) * m_timestampPeriod * 1e-6;
+
+        if (record.statistics)
+        {
+            std::array<uint64_t, kStatisticCount> values{};
+            if (m_device.get().getQueryPoolResults(slot.statisticsPool, i, 1, sizeof(values), values.data(),
+                                                   sizeof(values), vk::QueryResultFlagBits::e64) ==
+                vk::Result::eSuccess)
+            {
+                timing.hasStatistics = true;
+                timing.statistics.inputAssemblyVertices = values[0];
+                timing.statistics.inputAssemblyPrimitives = values[1];
+                timing.statistics.vertexShaderInvocations = values[2];
+                timing.statistics.clippingPrimitives = values[3];
+                timing.statistics.fragmentShaderInvocations = values[4];
+                timing.statistics.computeShaderInvocations = values[5];
+            }
+        }
+
+        frame.passes.push_back(std::move(timing));
+    }
+    if (frameEnd > frameBegin)
+    {
+        frame.gpuMs = static_cast<double>(frameEnd - frameBegin) * m_timestampPeriod * 1e-6;
+    }
+
+    m_latest = frame;
+    m_history.push_back(std::move(frame));
+    while (m_history.size() > m_historyLength)
+    {
+        m_history.pop_front();
+    }
+    return true;
+}
+
+} // namespace rendercore
@@ -151,6 +151,10 @@ class RDGTextureResource
     {
         m_lifetime.updateUsage(passIndex);
     }
+    void setLifetime(const RDGResourceLifetime &lifetime)
+    {
+        m_lifetime = lifetime;
+    }
     bool isUsed() const
     {
         return m_lifetime.isUsed;
@@ -262,6 +266,10 @@ class RDGBufferResource
     {
         m_lifetime.updateUsage(passIndex);
     }
+    void setLifetime(const RDGResourceLifetime &lifetime)
+    {
+        m_lifetime = lifetime;
+    }
     bool isUsed() const
     {
         return m_lifetime.isUsed;
@@ -309,6 +317,7 @@ template <typename ResourceType> class RDGResourcePool
     ResourceType *tryAcquire(const DescType &requiredDesc, const RDGResourceLifetime &lifetime)
     {
         (void)lifetime; // 当前简化实现中未使用，保留用于未来的生命周期重叠检查
+        ++m_requestCount;
 
         // 查找一个规格匹配的可用资源
         for (auto it = m_availableResources.begin(); it != m_availableResources.end(); ++it)
@@ -318,10 +327,11 @@ template <typename ResourceType> class RDGResourcePool
             // 检查资源规格是否匹配
             if (isCompatible(resource, requiredDesc))
             {
-                // 找到匹配的资源，从池中移除并返回
-                ResourceType *result = resource;
+                // 找到匹配的资源，移出可用列表（仍由池持有，直到 clear()）
+                m_acquiredResources.push_back(std::move(*it));
                 m_availableResources.erase(it);
-                return result;
+                ++m_hitCount;
+                return resource;
             }
         }
 
@@ -345,6 +355,7 @@ template <typename ResourceType> class RDGResourcePool
     void clear()
     {
         m_availableResources.clear();
+        m_acquiredResources.clear();
     }
 
     /**
@@ -355,6 +366,23 @@ template <typename ResourceType> class RDGResourcePool
         return m_availableResources.size();
     }
 
+    /**
+     * @brief 获取 tryAcquire() 调用次数与命中次数（自构造或上次 resetStats() 起）
+     */
+    uint32_t getRequestCount() const
+    {
+        return m_requestCount;
+    }
+    uint32_t getHitCount() const
+    {
+        return m_hitCount;
+    }
+    void resetStats()
+    {
+        m_requestCount = 0;
+        m_hitCount = 0;
+    }
+
   private:
     /**
      * @brief 检查vkcore::Image是否与RDGTextureDesc兼容
@@ -377,6 +405,9 @@ template <typename ResourceType> class RDGResourcePool
     }
 
     std::vector<std::unique_ptr<ResourceType>> m_availableResources;
+    std::vector<std::unique_ptr<ResourceType>> m_acquiredResources; ///< 已借出的资源（保持存活）
+    uint32_t m_requestCount = 0;
+    uint32_t m_hitCount = 0;
 };
 
 using RDGTexturePool = RDGResourcePool<vkcore::Image>;
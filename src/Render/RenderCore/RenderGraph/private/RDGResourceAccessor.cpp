@@ -63,14 +63,12 @@ vkcore::Buffer *RDGResourceAccessor::getBufferObject(RDGBufferHandle handle) con
 vk::DeviceAddress RDGResourceAccessor::getBufferDeviceAddress(RDGBufferHandle handle) const
 {
     vkcore::Buffer *buffer = getBufferObject(handle);
-    if (!buffer)
+    if (!buffer || !(buffer->getUsage() & vk::BufferUsageFlagBits::eShaderDeviceAddress))
     {
         return 0;
     }
 
-    // 注意：需要在 vkcore::Buffer 中添加 getDeviceAddress() 方法
-    // 暂时返回 0，未来可以实现
-    return 0;
+    return buffer->getDeviceAddress();
 }
 
 // ==================== 采样器访问 ====================
@@ -9,144 +9,89 @@
 namespace rendercore
 {
 
-// ==================== RDGFrameSyncManager 实现 ====================
-
-RDGFrameSyncManager::RDGFrameSyncManager(vk::Device device, size_t maxFramesInFlight)
-    : m_device(device), m_maxFramesInFlight(maxFramesInFlight)
+namespace
 {
-    if (maxFramesInFlight == 0)
-    {
-        throw std::invalid_argument("RDGFrameSyncManager: maxFramesInFlight must be > 0");
-    }
 
-    // 预分配容器
-    m_frameSyncInfos.resize(maxFramesInFlight);
-    m_inFlightFences.reserve(maxFramesInFlight);
-    m_imageAvailableSemaphores.reserve(maxFramesInFlight);
-    m_renderFinishedSemaphores.reserve(maxFramesInFlight);
+constexpr uint32_t kGraphicsTimeline = 0;
+constexpr uint32_t kComputeTimeline = 1;
+constexpr uint32_t kTimelineCount = 2;
 
-    // 创建同步原语
-    vk::FenceCreateInfo fenceInfo{};
-    fenceInfo.flags = vk::FenceCreateFlagBits::eSignaled; // 初始状态为已触发，避免第一帧等待
+} // namespace
 
-    vk::SemaphoreCreateInfo semaphoreInfo{};
+// ==================== RDGFrameSyncManager 实现 ====================
 
-    try
-    {
-        for (size_t i = 0; i < maxFramesInFlight; ++i)
-        {
-            // 创建 Fence
-            vk::Fence fence = m_device.createFence(fenceInfo);
-            m_inFlightFences.push_back(fence);
-
-            // 创建信号量
-            vk::Semaphore imageAvailable = m_device.createSemaphore(semaphoreInfo);
-            vk::Semaphore renderFinished = m_device.createSemaphore(semaphoreInfo);
-            m_imageAvailableSemaphores.push_back(imageAvailable);
-            m_renderFinishedSemaphores.push_back(renderFinished);
-
-            // 设置帧同步信息
-            m_frameSyncInfos[i].executionFence = fence;
-        }
-    }
-    catch (const vk::SystemError &e)
-    {
-        // 清理已创建的资源
-        for (auto fence : m_inFlightFences)
-        {
-            m_device.destroyFence(fence);
-        }
-        for (auto sem : m_imageAvailableSemaphores)
-        {
-            m_device.destroySemaphore(sem);
-        }
-        for (auto sem : m_renderFinishedSemaphores)
-        {
-            m_device.destroySemaphore(sem);
-        }
-        throw std::runtime_error("RDGFrameSyncManager: Failed to create sync primitives: " + std::string(e.what()));
-    }
+RDGFrameSyncManager::RDGFrameSyncManager(vk::Device device, size_t maxFramesInFlight)
+    : m_device(device), m_timeline(device, static_cast<uint32_t>(maxFramesInFlight), kTimelineCount)
+{
+    createframesemaphores(maxFramesInFlight);
+
+    // 第 1 帧无需等待
+    m_timeline.beginFrame();
+    resetcurrentsync();
 }
 
 RDGFrameSyncManager::~RDGFrameSyncManager()
 {
-    // 等待所有操作完成
+    // 当前帧可能尚未提交，只等待设备上已提交的工作
     try
     {
-        waitAll();
+        m_device.waitIdle();
     }
     catch (...)
     {
         // 析构函数中不抛出异常
     }
 
-    // 销毁同步原语
-    for (auto fence : m_inFlightFences)
-    {
-        m_device.destroyFence(fence);
-    }
-    for (auto sem : m_imageAvailableSemaphores)
-    {
-        m_device.destroySemaphore(sem);
-    }
-    for (auto sem : m_renderFinishedSemaphores)
-    {
-        m_device.destroySemaphore(sem);
-    }
+    destroyframesemaphores();
 }
 
 RDGSyncInfo &RDGFrameSyncManager::getCurrentFrameSync()
 {
-    return m_frameSyncInfos[m_currentFrame];
+    return m_frameSyncInfos[getCurrentFrameIndex()];
 }
 
 void RDGFrameSyncManager::advanceFrame()
 {
-    // 移动到下一帧
-    m_currentFrame = (m_currentFrame + 1) % m_maxFramesInFlight;
-
-    // 等待下一帧的 Fence（确保资源可以安全复用）
-    vk::Fence nextFence = m_inFlightFences[m_currentFrame];
-    vk::Result result = m_device.waitForFences(nextFence, VK_TRUE, UINT64_MAX);
-
-    if (result != vk::Result::eSuccess)
-    {
-        throw std::runtime_error("RDGFrameSyncManager::advanceFrame: Failed to wait for fence");
-    }
-
-    // 重置 Fence 以便下次使用
-    m_device.resetFences(nextFence);
+    // 移动到下一帧并等待复用同一索引的那一帧在两条时间线上完成
+    m_timeline.beginFrame();
 
-    // 清除旧的等待/信号信息（Fence 保留）
-    auto &syncInfo = m_frameSyncInfos[m_currentFrame];
-    vk::Fence fence = syncInfo.executionFence.value();
-    syncInfo.clear();
-    syncInfo.executionFence = fence;
+    // 清除旧的等待/信号信息，写入本帧的时间线触发
+    resetcurrentsync();
 }
 
 void RDGFrameSyncManager::waitAll()
 {
-    if (m_inFlightFences.empty())
+    m_timeline.waitIdle();
+}
+
+void RDGFrameSyncManager::setMaxFramesInFlight(size_t maxFramesInFlight)
+{
+    if (maxFramesInFlight == 0)
+    {
+        throw std::invalid_argument("RDGFrameSyncManager: maxFramesInFlight must be > 0");
+    }
+    if (maxFramesInFlight == getMaxFramesInFlight())
     {
         return;
     }
 
-    vk::Result result = m_device.waitForFences(m_inFlightFences, VK_TRUE, UINT64_MAX);
+    // 每帧信号量可能仍被在途的帧引用
+    m_device.waitIdle();
+    destroyframesemaphores();
 
-    if (result != vk::Result::eSuccess)
-    {
-        throw std::runtime_error("RDGFrameSyncManager::waitAll: Failed to wait for fences");
-    }
+    m_timeline.setFramesInFlight(static_cast<uint32_t>(maxFramesInFlight));
+    createframesemaphores(maxFramesInFlight);
+    resetcurrentsync();
 }
 
-vk::Fence RDGFrameSyncManager::getCurrentFence() const
+vk::Semaphore RDGFrameSyncManager::getTimelineSemaphore(RDGQueueType queue) const
 {
-    return m_inFlightFences[m_currentFrame];
+    return m_timeline.getSemaphore(queue == RDGQueueType::AsyncCompute ? kComputeTimeline : kGraphicsTimeline);
 }
 
 std::pair<vk::Semaphore, vk::Semaphore> RDGFrameSyncManager::getSwapChainSemaphores(size_t frameIndex)
 {
-    if (frameIndex >= m_maxFramesInFlight)
+    if (frameIndex >= getMaxFramesInFlight())
     {
         throw std::out_of_range("RDGFrameSyncManager::getSwapChainSemaphores: Invalid frame index");
     }
@@ -154,4 +99,55 @@ std::pair<vk::Semaphore, vk::Semaphore> RDGFrameSyncManager::getSwapChainSemapho
     return {m_imageAvailableSemaphores[frameIndex], m_renderFinishedSemaphores[frameIndex]};
 }
 
+// ==================== 私有辅助函数 ====================
+
+void RDGFrameSyncManager::createframesemaphores(size_t count)
+{
+    m_frameSyncInfos.assign(count, RDGSyncInfo{});
+    m_imageAvailableSemaphores.reserve(count);
+    m_renderFinishedSemaphores.reserve(count);
+
+    vk::SemaphoreCreateInfo semaphoreInfo{};
+
+    try
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_imageAvailableSemaphores.push_back(m_device.createSemaphore(semaphoreInfo));
+            m_renderFinishedSemaphores.push_back(m_device.createSemaphore(semaphoreInfo));
+        }
+    }
+    catch (const vk::SystemError &e)
+    {
+        // 清理已创建的资源
+        destroyframesemaphores();
+        throw std::runtime_error("RDGFrameSyncManager: Failed to create sync primitives: " + std::string(e.what()));
+    }
+}
+
+void RDGFrameSyncManager::destroyframesemaphores()
+{
+    for (auto sem : m_imageAvailableSemaphores)
+    {
+        m_device.destroySemaphore(sem);
+    }
+    for (auto sem : m_renderFinishedSemaphores)
+    {
+        m_device.destroySemaphore(sem);
+    }
+    m_imageAvailableSemaphores.clear();
+    m_renderFinishedSemaphores.clear();
+}
+
+void RDGFrameSyncManager::resetcurrentsync()
+{
+    // 没有异步计算批次的帧由最后一个图形批次触发计算时间线，保证每帧两条时间线都前进
+    auto &syncInfo = getCurrentFrameSync();
+    syncInfo.clear();
+    syncInfo.addTimelineSignal(m_timeline.getSemaphore(kGraphicsTimeline), m_timeline.getFrameNumber(),
+                               RDGQueueType::Graphics);
+    syncInfo.addTimelineSignal(m_timeline.getSemaphore(kComputeTimeline), m_timeline.getFrameNumber(),
+                               RDGQueueType::AsyncCompute);
+}
+
 } // namespace rendercore
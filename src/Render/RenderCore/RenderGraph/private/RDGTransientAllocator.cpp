@@ -0,0 +1,556 @@
+/**
+ * @file RDGTransientAllocator.cpp
+ * @brief RDGTransientAllocator 实现
+ */
+
+#include "RDGTransientAllocator.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include "VulkanCore/public/Log.hpp"
+#include "VulkanCore/public/MemoryMonitor.hpp"
+#include "VulkanCore/public/Profiler.hpp"
+#include "VulkanCore/public/VKResource.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace rendercore
+{
+
+namespace
+{
+
+inline void hashCombine(uint64_t &seed, uint64_t value)
+{
+    seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+inline vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment)
+{
+    return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+
+uint64_t hashTextureDesc(const RDGTextureDesc &desc)
+{
+    uint64_t hash = static_cast<uint64_t>(RDGHandleType::Texture);
+    hashCombine(hash, static_cast<uint64_t>(desc.format));
+    hashCombine(hash, desc.extent.width);
+    hashCombine(hash, desc.extent.height);
+    hashCombine(hash, desc.extent.depth);
+    hashCombine(hash, static_cast<VkImageUsageFlags>(desc.usage));
+    hashCombine(hash, desc.mipLevels);
+    hashCombine(hash, desc.arrayLayers);
+    hashCombine(hash, static_cast<uint64_t>(desc.samples));
+    hashCombine(hash, static_cast<uint64_t>(desc.tiling));
+    return hash;
+}
+
+uint64_t hashBufferDesc(const RDGBufferDesc &desc)
+{
+    uint64_t hash = static_cast<uint64_t>(RDGHandleType::Buffer);
+    hashCombine(hash, desc.size);
+    hashCombine(hash, static_cast<VkBufferUsageFlags>(desc.usage));
+    return hash;
+}
+
+vkcore::ImageDesc toImageDesc(const RDGTextureDesc &desc)
+{
+    vkcore::ImageDesc imageDesc{};
+    imageDesc.format = desc.format;
+    imageDesc.extent = desc.extent;
+    imageDesc.usage = desc.usage;
+    imageDesc.mipLevels = desc.mipLevels;
+    imageDesc.arrayLayers = desc.arrayLayers;
+    imageDesc.samples = desc.samples;
+    imageDesc.tiling = desc.tiling;
+    imageDesc.category = vkcore::MemoryCategory::RDGTransient;
+    return imageDesc;
+}
+
+vkcore::BufferDesc toBufferDesc(const RDGBufferDesc &desc)
+{
+    vkcore::BufferDesc bufferDesc{};
+    bufferDesc.size = desc.size;
+    bufferDesc.usageFlags = desc.usage;
+    bufferDesc.category = vkcore::MemoryCategory::RDGTransient;
+    return bufferDesc;
+}
+
+} // namespace
+
+// ==================== 构造函数和析构函数 ====================
+
+RDGTransientAllocator::RDGTransientAllocator(vkcore::Device &device, VmaAllocator allocator, uint32_t framesInFlight,
+                                             uint32_t evictAfterFrames)
+    : m_device(device), m_allocator(allocator), m_framesInFlight(framesInFlight), m_evictAfterFrames(evictAfterFrames)
+{
+    if (framesInFlight == 0)
+    {
+        throw std::invalid_argument("RDGTransientAllocator: framesInFlight must be > 0");
+    }
+
+    m_slots.resize(framesInFlight);
+
+    // 惰性分配的内存类型只在 Tile 架构（移动端）GPU 上存在
+    VmaAllocationCreateInfo lazyInfo{};
+    lazyInfo.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+    uint32_t lazyMemoryType = 0;
+    m_lazyMemorySupported = vmaFindMemoryTypeIndex(m_allocator, UINT32_MAX, &lazyInfo, &lazyMemoryType) == VK_SUCCESS;
+}
+
+RDGTransientAllocator::~RDGTransientAllocator()
+{
+    clear();
+}
+
+// ==================== 公共接口 ====================
+
+void RDGTransientAllocator::clear()
+{
+    for (auto &slot : m_slots)
+    {
+        // 先销毁别名资源，再释放其所在的堆
+        slot.placements.clear();
+
+        for (std::vector<Heap> *heaps : {&slot.imageHeaps, &slot.bufferHeaps})
+        {
+            for (auto &heap : *heaps)
+            {
+                if (heap.allocation)
+                {
+                    vmaFreeMemory(m_allocator, heap.allocation);
+                    vkcore::MemoryMonitor::trackFree(vkcore::MemoryCategory::RDGTransient, heap.size);
+                }
+            }
+        }
+
+        slot.imageHeaps.clear();
+        slot.bufferHeaps.clear();
+    }
+
+    m_requirementsCache.clear();
+}
+
+// ==================== 私有函数 ====================
+
+void RDGTransientAllocator::allocate(const std::vector<Request> &textures, const std::vector<Request> &buffers,
+                                     uint32_t passCount, Result &result)
+{
+    QTR_PROFILE_SCOPE("RDGTransientAllocator::allocate");
+    FrameSlot &slot = m_slots[m_frameIndex % m_framesInFlight];
+
+    // 槽位轮到本帧时，其上一次使用（framesInFlight 帧之前）的GPU工作已由帧Fence保证完成
+    evictstale(slot);
+
+    for (auto &placement : slot.placements)
+    {
+        placement.inUse = false;
+    }
+
+    m_stats = RDGTransientStats{};
+    m_stats.textureCount = static_cast<uint32_t>(textures.size());
+    m_stats.bufferCount = static_cast<uint32_t>(buffers.size());
+
+    result.textures.clear();
+    result.buffers.clear();
+    result.aliasingBarrierPasses.assign(passCount, 0);
+
+    // 惰性分配的纹理各自独立创建，不参与别名；其余（或创建失败的）纹理进入别名堆
+    std::vector<Request> aliasedTextures;
+    aliasedTextures.reserve(textures.size());
+    for (const Request &request : textures)
+    {
+        if (!(request.lazilyAllocated && m_lazyMemorySupported && placelazy(slot, request, result)))
+        {
+            aliasedTextures.push_back(request);
+        }
+    }
+
+    placerequests(slot, aliasedTextures, true, passCount, result);
+    placerequests(slot, buffers, false, passCount, result);
+
+    QTR_LOG_DEBUG("RDG", "瞬态内存: 请求 " << m_stats.requestedBytes / 1024 << " KB, 别名后 " << m_stats.aliasedBytes / 1024
+                         << " KB (" << m_stats.heapCount << " 个堆, 惰性分配纹理 " << m_stats.lazyTextureCount << ", 新建资源 "
+                         << m_stats.createdResources << ")");
+}
+
+void RDGTransientAllocator::trim()
+{
+    // 每个槽位在下一次被使用时（其GPU工作已完成）淘汰上一轮没有用到的资源与堆
+    m_trimUntilFrame = m_frameIndex + m_framesInFlight;
+}
+
+void RDGTransientAllocator::advanceFrame()
+{
+    ++m_frameIndex;
+}
+
+void RDGTransientAllocator::placerequests(FrameSlot &slot, const std::vector<Request> &requests, bool forImages,
+                                          uint32_t passCount, Result &result)
+{
+    if (requests.empty())
+    {
+        return;
+    }
+
+    struct PlanItem
+    {
+        const Request *request = nullptr;
+        uint64_t key = 0;
+        vk::MemoryRequirements requirements;
+        size_t heap = 0;
+        vk::DeviceSize offset = 0;
+    };
+
+    struct PlanHeap
+    {
+        uint32_t memoryTypeBits = ~0u;
+        vk::DeviceSize size = 0;
+        vk::DeviceSize alignment = 1;
+        std::vector<size_t> items;
+    };
+
+    std::vector<PlanItem> items(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        items[i].request = &requests[i];
+        items[i].key = forImages ? hashTextureDesc(*requests[i].textureDesc) : hashBufferDesc(*requests[i].bufferDesc);
+        items[i].requirements = getrequirements(requests[i], items[i].key);
+        m_stats.requestedBytes += items[i].requirements.size;
+    }
+
+    // 按大小降序放置，大资源先占位，小资源填入空隙（经典的离线区间着色启发式）
+    std::vector<size_t> order(items.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&items](size_t a, size_t b) {
+        if (items[a].requirements.size != items[b].requirements.size)
+        {
+            return items[a].requirements.size > items[b].requirements.size;
+        }
+        return items[a].request->firstPass < items[b].request->firstPass;
+    });
+
+    std::vector<PlanHeap> heaps;
+    std::vector<std::pair<vk::DeviceSize, vk::DeviceSize>> occupied;
+
+    for (size_t itemIndex : order)
+    {
+        PlanItem &item = items[itemIndex];
+        const vk::DeviceSize size = item.requirements.size;
+        const vk::DeviceSize alignment = item.requirements.alignment;
+
+        size_t chosenHeap = heaps.size();
+        vk::DeviceSize chosenOffset = 0;
+
+        for (size_t heapIndex = 0; heapIndex < heaps.size(); ++heapIndex)
+        {
+            PlanHeap &heap = heaps[heapIndex];
+            if ((heap.memoryTypeBits & item.requirements.memoryTypeBits) == 0)
+            {
+                continue;
+            }
+
+            // 收集生命周期重叠的已放置资源所占用的内存区间
+            occupied.clear();
+            for (size_t placedIndex : heap.items)
+            {
+                const PlanItem &placed = items[placedIndex];
+                const bool overlaps = !(placed.request->lastPass < item.request->firstPass ||
+                                        item.request->lastPass < placed.request->firstPass);
+                if (overlaps)
+                {
+                    occupied.emplace_back(placed.offset, placed.offset + placed.requirements.size);
+                }
+            }
+            std::sort(occupied.begin(), occupied.end());
+
+            // 首次适配：在重叠区间之间寻找足够大的空隙
+            vk::DeviceSize candidate = 0;
+            for (const auto &[begin, end] : occupied)
+            {
+                if (candidate + size <= begin)
+                {
+                    break;
+                }
+                candidate = std::max(candidate, alignUp(end, alignment));
+            }
+
+            chosenHeap = heapIndex;
+            chosenOffset = candidate;
+            break;
+        }
+
+        if (chosenHeap == heaps.size())
+        {
+            heaps.emplace_back();
+        }
+
+        PlanHeap &heap = heaps[chosenHeap];
+        heap.memoryTypeBits &= item.requirements.memoryTypeBits;
+        heap.size = std::max(heap.size, chosenOffset + size);
+        heap.alignment = std::max(heap.alignment, alignment);
+        heap.items.push_back(itemIndex);
+
+        item.heap = chosenHeap;
+        item.offset = chosenOffset;
+    }
+
+    // 内存区间重叠的资源之间需要别名屏障：后使用者在其首个Pass之前等待前一使用者完成
+    for (const auto &heap : heaps)
+    {
+        for (size_t a = 0; a < heap.items.size(); ++a)
+        {
+            for (size_t b = a + 1; b < heap.items.size(); ++b)
+            {
+                const PlanItem &first = items[heap.items[a]];
+                const PlanItem &second = items[heap.items[b]];
+                const bool memoryOverlaps = first.offset < second.offset + second.requirements.size &&
+                                            second.offset < first.offset + first.requirements.size;
+                if (!memoryOverlaps)
+                {
+                    continue;
+                }
+
+                uint32_t laterFirstPass = std::max(first.request->firstPass, second.request->firstPass);
+                if (laterFirstPass < passCount)
+                {
+                    result.aliasingBarrierPasses[laterFirstPass] = 1;
+                }
+            }
+        }
+    }
+
+    // 将着色结果实化为物理堆与别名资源
+    for (size_t heapIndex = 0; heapIndex < heaps.size(); ++heapIndex)
+    {
+        const PlanHeap &planHeap = heaps[heapIndex];
+        Heap &heap = acquireheap(slot, heapIndex, forImages, planHeap.size, planHeap.alignment,
+                                 planHeap.memoryTypeBits);
+
+        m_stats.aliasedBytes += planHeap.size;
+        ++m_stats.heapCount;
+
+        for (size_t itemIndex : planHeap.items)
+        {
+            const PlanItem &item = items[itemIndex];
+
+            // 优先复用绑定在相同位置、描述相同的缓存资源
+            Placement *placement = nullptr;
+            for (auto &candidate : slot.placements)
+            {
+                if (!candidate.inUse && candidate.key == item.key && candidate.heapId == heap.id &&
+                    candidate.offset == item.offset)
+                {
+                    placement = &candidate;
+                    break;
+                }
+            }
+
+            if (!placement)
+            {
+                Placement created;
+                created.key = item.key;
+                created.heapId = heap.id;
+                created.offset = item.offset;
+
+                if (forImages)
+                {
+                    const RDGTextureDesc &desc = *item.request->textureDesc;
+                    created.image = std::make_unique<vkcore::Image>(desc.name, m_device, m_allocator,
+                                                                    toImageDesc(desc), heap.allocation, item.offset);
+                    ++m_stats.createdTextures;
+                }
+                else
+                {
+                    const RDGBufferDesc &desc = *item.request->bufferDesc;
+                    created.buffer = std::make_unique<vkcore::Buffer>(desc.name, m_device, m_allocator,
+                                                                      toBufferDesc(desc), heap.allocation, item.offset);
+                }
+
+                slot.placements.push_back(std::move(created));
+                placement = &slot.placements.back();
+                ++m_stats.createdResources;
+            }
+
+            placement->inUse = true;
+            placement->lastUsedFrame = m_frameIndex;
+
+            if (forImages)
+            {
+                result.textures[item.request->handle] = placement->image.get();
+            }
+            else
+            {
+                result.buffers[item.request->handle] = placement->buffer.get();
+            }
+        }
+    }
+}
+
+bool RDGTransientAllocator::placelazy(FrameSlot &slot, const Request &request, Result &result)
+{
+    const RDGTextureDesc &desc = *request.textureDesc;
+
+    uint64_t key = hashTextureDesc(desc);
+    hashCombine(key, static_cast<uint64_t>(VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED));
+
+    Placement *placement = nullptr;
+    for (auto &candidate : slot.placements)
+    {
+        if (!candidate.inUse && candidate.key == key && candidate.heapId == 0)
+        {
+            placement = &candidate;
+            break;
+        }
+    }
+
+    if (!placement)
+    {
+        // 瞬态附件只能带附件类用途：图中没有任何着色器或传输访问，声明时多余的用途可以去掉
+        vkcore::ImageDesc imageDesc = toImageDesc(desc);
+        imageDesc.usage = (desc.usage & (vk::ImageUsageFlagBits::eColorAttachment |
+                                         vk::ImageUsageFlagBits::eDepthStencilAttachment |
+                                         vk::ImageUsageFlagBits::eInputAttachment)) |
+                          vk::ImageUsageFlagBits::eTransientAttachment;
+        imageDesc.memoryUsage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+
+        Placement created;
+        created.key = key;
+        try
+        {
+            created.image = std::make_unique<vkcore::Image>(desc.name, m_device, m_allocator, imageDesc);
+        }
+        catch (const std::runtime_error &e)
+        {
+            QTR_LOG_WARN("RDG", "纹理 '" << desc.name << "' 无法使用惰性分配内存，退回别名堆: " << e.what());
+            return false;
+        }
+
+        slot.placements.push_back(std::move(created));
+        placement = &slot.placements.back();
+        ++m_stats.createdResources;
+        ++m_stats.createdTextures;
+    }
+
+    placement->inUse = true;
+    placement->lastUsedFrame = m_frameIndex;
+    result.textures[request.handle] = placement->image.get();
+    ++m_stats.lazyTextureCount;
+    return true;
+}
+
+RDGTransientAllocator::Heap &RDGTransientAllocator::acquireheap(FrameSlot &slot, size_t ordinal, bool forImages,
+                                                                vk::DeviceSize size, vk::DeviceSize alignment,
+                                                                uint32_t memoryTypeBits)
+{
+    std::vector<Heap> &heaps = forImages ? slot.imageHeaps : slot.bufferHeaps;
+
+    if (ordinal < heaps.size())
+    {
+        Heap &existing = heaps[ordinal];
+        if (existing.size >= size && (memoryTypeBits & (1u << existing.memoryTypeIndex)) != 0)
+        {
+            existing.lastUsedFrame = m_frameIndex;
+            return existing;
+        }
+
+        // 现有堆容量或内存类型不满足要求：销毁后在原位重新分配
+        destroyheap(slot, existing);
+    }
+    else
+    {
+        heaps.resize(ordinal + 1);
+    }
+
+    VkMemoryRequirements requirements{};
+    requirements.size = size;
+    requirements.alignment = alignment;
+    requirements.memoryTypeBits = memoryTypeBits;
+
+    VmaAllocationCreateInfo createInfo{};
+    createInfo.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    createInfo.memoryTypeBits = memoryTypeBits;
+
+    VmaAllocation allocation = nullptr;
+    VmaAllocationInfo allocationInfo{};
+    VkResult vkResult = vmaAllocateMemory(m_allocator, &requirements, &createInfo, &allocation, &allocationInfo);
+    if (vkResult != VK_SUCCESS)
+    {
+        throw std::runtime_error("RDGTransientAllocator: Failed to allocate transient heap: " +
+                                 std::to_string(vkResult));
+    }
+
+    Heap &heap = heaps[ordinal];
+    heap.id = m_nextHeapId++;
+    heap.allocation = allocation;
+    heap.size = size;
+    heap.memoryTypeIndex = allocationInfo.memoryType;
+    heap.lastUsedFrame = m_frameIndex;
+    vkcore::MemoryMonitor::trackAllocation(vkcore::MemoryCategory::RDGTransient, heap.size);
+
+    ++m_stats.createdHeaps;
+    return heap;
+}
+
+void RDGTransientAllocator::destroyheap(FrameSlot &slot, Heap &heap)
+{
+    // 先销毁绑定在该堆上的资源（ID 为 0 的空堆上没有资源，惰性分配图像的 heapId 同样为 0）
+    if (heap.id != 0)
+    {
+        slot.placements.erase(
+            std::remove_if(slot.placements.begin(), slot.placements.end(),
+                           [&heap](const Placement &placement) { return placement.heapId == heap.id; }),
+            slot.placements.end());
+    }
+
+    if (heap.allocation)
+    {
+        vmaFreeMemory(m_allocator, heap.allocation);
+        vkcore::MemoryMonitor::trackFree(vkcore::MemoryCategory::RDGTransient, heap.size);
+    }
+    heap = Heap{};
+}
+
+void RDGTransientAllocator::evictstale(FrameSlot &slot)
+{
+    // 内存压力下（trim() 之后的一轮）只保留槽位上一次使用时用到的资源
+    const uint64_t evictAfterFrames = m_frameIndex < m_trimUntilFrame ? m_framesInFlight : m_evictAfterFrames;
+    auto isStale = [this, evictAfterFrames](uint64_t lastUsedFrame) {
+        return lastUsedFrame + evictAfterFrames < m_frameIndex;
+    };
+
+    slot.placements.erase(std::remove_if(slot.placements.begin(), slot.placements.end(),
+                                         [&isStale](const Placement &placement) {
+                                             return isStale(placement.lastUsedFrame);
+                                         }),
+                          slot.placements.end());
+
+    // 堆按着色序号索引，只从尾部淘汰以保持序号稳定
+    for (std::vector<Heap> *heaps : {&slot.imageHeaps, &slot.bufferHeaps})
+    {
+        while (!heaps->empty() && isStale(heaps->back().lastUsedFrame))
+        {
+            destroyheap(slot, heaps->back());
+            heaps->pop_back();
+        }
+    }
+}
+
+vk::MemoryRequirements RDGTransientAllocator::getrequirements(const Request &request, uint64_t key)
+{
+    auto it = m_requirementsCache.find(key);
+    if (it != m_requirementsCache.end())
+    {
+        return it->second;
+    }
+
+    vk::MemoryRequirements requirements =
+        request.textureDesc ? vkcore::Image::getMemoryRequirements(m_device, toImageDesc(*request.textureDesc))
+                            : vkcore::Buffer::getMemoryRequirements(m_device, toBufferDesc(*request.bufferDesc));
+
+    m_requirementsCache.emplace(key, requirements);
+    return requirements;
+}
+
+} // namespace rendercore
@@ -4,17 +4,51 @@
  */
 
 #include "RenderGraph.hpp"
+#include "RDGBuilder.hpp"
 #include "VulkanCore/public/CommandPoolManager.hpp"
 #include "VulkanCore/public/Device.hpp"
+#include "VulkanCore/public/Log.hpp"
+#include "VulkanCore/public/Profiler.hpp"
+#include "VulkanCore/public/OffscreenSwapChain.hpp"
 #include "VulkanCore/public/SwapChain.hpp"
 #include "VulkanCore/public/VKResource.hpp"
+#include "VulkanCore/public/WorkerPool.hpp"
 #include <algorithm>
-#include <iostream>
 #include <stdexcept>
+#include <string>
 
 namespace rendercore
 {
 
+namespace
+{
+
+/**
+ * @brief RDGPass 声明的传统阶段掩码转换为 Synchronization2 掩码（两者低32位定义一致）
+ */
+inline vk::PipelineStageFlags2 toStages2(vk::PipelineStageFlags stages)
+{
+    return vk::PipelineStageFlags2(static_cast<VkPipelineStageFlags>(stages));
+}
+
+/**
+ * @brief RDGPass 声明的传统访问掩码转换为 Synchronization2 掩码（两者低32位定义一致）
+ */
+inline vk::AccessFlags2 toAccess2(vk::AccessFlags access)
+{
+    return vk::AccessFlags2(static_cast<VkAccessFlags>(access));
+}
+
+/**
+ * @brief 从 Profiler::now() 的时间戳到现在经过的毫秒数
+ */
+inline double elapsedMs(uint64_t beginNs)
+{
+    return static_cast<double>(vkcore::Profiler::now() - beginNs) / 1e6;
+}
+
+} // namespace
+
 // ==================== RDGResource实现 ====================
 
 // RDGTextureResource构造函数
@@ -90,7 +124,8 @@ bool RDGBufferResource::canAliasWith(const RDGBufferResource &other) const
 // ==================== RenderGraph构造函数和析构函数 ====================
 
 RenderGraph::RenderGraph(vkcore::Device &device, vkcore::CommandPoolManager &cmdManager, VmaAllocator allocator)
-    : m_device(device), m_commandManager(cmdManager), m_allocator(allocator)
+    : m_device(device), m_commandManager(cmdManager), m_allocator(allocator),
+      m_localReadEnabled(device.isExtensionEnabled(VK_KHR_DYNAMIC_RENDERING_LOCAL_READ_EXTENSION_NAME))
 {
 }
 
@@ -99,9 +134,8 @@ RenderGraph::~RenderGraph()
     // 销毁采样器
     destroySamplers();
 
-    // 清理所有资源
-    m_frameTextures.clear();
-    m_frameBuffers.clear();
+    // 清理所有资源（本帧提交的命令可能仍在引用瞬态资源）
+    releaseFrameResources();
     m_texturePool.clear();
     m_bufferPool.clear();
 }
@@ -111,10 +145,19 @@ RenderGraph::~RenderGraph()
 RDGTextureHandle RenderGraph::createTransientTexture(const RDGTextureDesc &desc)
 {
     RDGResourceHandle handle = generateNextHandle();
-    auto resource = std::make_unique<RDGTextureResource>(handle, desc, RDGResourceType::Transient);
+
+    // 缩放尺寸在创建时解析为实际尺寸，之后的渲染区域、屏障与瞬态分配都只看实际尺寸
+    RDGTextureDesc resolved = desc;
+    if (desc.extentClass == RDGExtentClass::Scaled)
+    {
+        const vk::Extent2D extent = RDGBuilder::scaleExtent(vk::Extent2D{desc.extent.width, desc.extent.height},
+                                                            m_renderScale);
+        resolved.extent.width = extent.width;
+        resolved.extent.height = extent.height;
+    }
+    m_textureResources[handle] = m_arena.create<RDGTextureResource>(handle, resolved, RDGResourceType::Transient);
 
     RDGTextureHandle textureHandle{handle};
-    m_textureResources[handle] = std::move(resource);
 
     return textureHandle;
 }
@@ -122,25 +165,24 @@ RDGTextureHandle RenderGraph::createTransientTexture(const RDGTextureDesc &desc)
 RDGBufferHandle RenderGraph::createTransientBuffer(const RDGBufferDesc &desc)
 {
     RDGResourceHandle handle = generateNextHandle();
-    auto resource = std::make_unique<RDGBufferResource>(handle, desc, RDGResourceType::Transient);
+    m_bufferResources[handle] = m_arena.create<RDGBufferResource>(handle, desc, RDGResourceType::Transient);
 
     RDGBufferHandle bufferHandle{handle};
-    m_bufferResources[handle] = std::move(resource);
 
     return bufferHandle;
 }
 
 RDGTextureHandle RenderGraph::registerExternalTexture(vkcore::Image *image, const std::string &name,
-                                                      vk::ImageLayout currentLayout)
+                                                      vk::ImageLayout currentLayout, vk::PipelineStageFlags2 lastStages)
 {
     RDGResourceHandle handle = generateNextHandle();
-    auto resource = std::make_unique<RDGTextureResource>(handle, image, name, currentLayout);
+    m_textureResources[handle] = m_arena.create<RDGTextureResource>(handle, image, name, currentLayout);
 
     RDGTextureHandle textureHandle{handle};
-    m_textureResources[handle] = std::move(resource);
 
-    // 记录当前布局
+    // 记录当前布局与导入前的访问阶段
     m_textureLayouts[handle] = currentLayout;
+    m_importStages[handle] = lastStages;
 
     return textureHandle;
 }
@@ -148,10 +190,9 @@ RDGTextureHandle RenderGraph::registerExternalTexture(vkcore::Image *image, cons
 RDGBufferHandle RenderGraph::registerExternalBuffer(vkcore::Buffer *buffer, const std::string &name)
 {
     RDGResourceHandle handle = generateNextHandle();
-    auto resource = std::make_unique<RDGBufferResource>(handle, buffer, name);
+    m_bufferResources[handle] = m_arena.create<RDGBufferResource>(handle, buffer, name);
 
     RDGBufferHandle bufferHandle{handle};
-    m_bufferResources[handle] = std::move(resource);
 
     return bufferHandle;
 }
@@ -175,17 +216,18 @@ RDGTextureHandle RenderGraph::importSwapChainImage(vkcore::SwapChain &swapChain,
 
     // 创建一个特殊的RDGTextureResource来表示SwapChain图像
     RDGResourceHandle handle = generateNextHandle();
-    auto resource = std::make_unique<RDGTextureResource>(handle, desc, RDGResourceType::External);
+    auto *resource = m_arena.create<RDGTextureResource>(handle, desc, RDGResourceType::External);
 
     // 设置资源状态和特殊标记
     resource->setState(RDGResourceState::Allocated);
     resource->setSwapChainImageIndex(imageIndex); // 记住这是哪个SwapChain图像
 
     RDGTextureHandle textureHandle{handle};
-    m_textureResources[handle] = std::move(resource);
+    m_textureResources[handle] = resource;
 
     // 存储SwapChain引用以供后续使用
     m_swapChainMapping[handle] = &swapChain;
+    m_presentLayouts[handle] = vk::ImageLayout::ePresentSrcKHR;
 
     // 记录当前布局（交换链图像通常开始时是undefined）
     m_textureLayouts[handle] = vk::ImageLayout::eUndefined;
@@ -193,24 +235,41 @@ RDGTextureHandle RenderGraph::importSwapChainImage(vkcore::SwapChain &swapChain,
     return textureHandle;
 }
 
+RDGTextureHandle RenderGraph::importOffscreenImage(vkcore::OffscreenSwapChain &swapChain, uint32_t imageIndex)
+{
+    // 离屏图像是普通的 vkcore::Image，按外部纹理导入；内容每帧重写，不保留上一次的布局
+    RDGTextureHandle textureHandle = registerExternalTexture(
+        &swapChain.getImageResource(imageIndex), "OffscreenImage_" + std::to_string(imageIndex),
+        vk::ImageLayout::eUndefined);
+    m_presentLayouts[textureHandle.handle] = vkcore::OffscreenSwapChain::kPresentLayout;
+    return textureHandle;
+}
+
 // ==================== Pass管理接口 ====================
 
 RDGPass &RenderGraph::addPass(std::string name, RDGPass::ExecuteCallback &&callback)
 {
-    auto pass = std::make_unique<RDGPass>(std::move(name), std::move(callback));
-    RDGPass &passRef = *pass;
-    m_passes.push_back(std::move(pass));
+    RDGPass *pass = m_arena.create<RDGPass>(m_arena, std::move(name), std::move(callback));
+    m_passes.push_back(pass);
 
-    return passRef;
+    return *pass;
 }
 
 RDGPass &RenderGraph::addPassEx(std::string name, RDGPass::ExecuteCallbackEx &&callback)
 {
-    auto pass = std::make_unique<RDGPass>(std::move(name), std::move(callback));
-    RDGPass &passRef = *pass;
-    m_passes.push_back(std::move(pass));
+    RDGPass *pass = m_arena.create<RDGPass>(m_arena, std::move(name), std::move(callback));
+    m_passes.push_back(pass);
+
+    return *pass;
+}
+
+RDGPass &RenderGraph::addParallelPass(std::string name, uint32_t chunkCount,
+                                      RDGPass::ParallelExecuteCallback &&callback)
+{
+    RDGPass *pass = m_arena.create<RDGPass>(m_arena, std::move(name), chunkCount, std::move(callback));
+    m_passes.push_back(pass);
 
-    return passRef;
+    return *pass;
 }
 
 // ==================== 查询接口 ====================
@@ -242,17 +301,42 @@ size_t RenderGraph::getTransientResourceCount() const
 
 void RenderGraph::compile()
 {
+    QTR_PROFILE_SCOPE("RenderGraph::compile");
     if (m_compiled)
     {
         throw std::runtime_error("RenderGraph::compile: Already compiled");
     }
 
-    std::cout << "\n=== RenderGraph编译开始 ===" << std::endl;
-    std::cout << "Pass数量: " << m_passes.size() << std::endl;
-    std::cout << "瞬态资源数量: " << getTransientResourceCount() << std::endl;
+    QTR_LOG_TRACE("RenderGraph", "=== RenderGraph编译开始 ===");
+    QTR_LOG_TRACE("RenderGraph", "Pass数量: " << m_passes.size());
+    QTR_LOG_TRACE("RenderGraph", "瞬态资源数量: " << getTransientResourceCount());
+    const uint64_t compileBegin = vkcore::Profiler::now();
 
     try
     {
+        // 编译缓存：拓扑不变时直接复用上一次的编译结果
+        // 哈希只用于查找桶，命中要求完整键相同（哈希冲突时不会复用另一张图的编译结果）
+        std::vector<uint64_t> topologyKey;
+        uint64_t topologyHash = 0;
+        if (m_compileCache && m_compileCache->isEnabled())
+        {
+            topologyKey = computeTopologyKey();
+            topologyHash = hashTopologyKey(topologyKey);
+            m_cachedGraph = m_compileCache->find(topologyHash, topologyKey);
+            if (m_cachedGraph)
+            {
+                restoreFromCache(*m_cachedGraph);
+                m_compileCacheHit = true;
+                m_compiled = true;
+                collectCompileStats();
+                m_stats.compileMs = elapsedMs(compileBegin);
+
+                QTR_LOG_TRACE("RenderGraph", "命中编译缓存 (hash: 0x" << std::hex << topologyHash << std::dec << ")");
+                QTR_LOG_TRACE("RenderGraph", "=== RenderGraph编译完成 ===");
+                return;
+            }
+        }
+
         // 编译阶段1：构建依赖图
         buildDependencyGraph();
 
@@ -265,33 +349,48 @@ void RenderGraph::compile()
         // 编译阶段4：验证资源状态
         validateResourceStates();
 
-        // 编译阶段5：计算屏障
+        // 编译阶段5：队列调度
+        scheduleQueues();
+
+        // 编译阶段6：计算屏障
         computeBarriers();
+        placeSplitBarriers();
+
+        // 编译阶段7：划分提交批次
+        buildSubmitBatches();
+
+        // 编译阶段8：合并渲染Pass
+        mergeRenderPasses();
 
         m_compiled = true;
 
-        // 输出编译统计
-        size_t activePasses = 0;
-        for (const auto &pass : m_compiledPasses)
+        // 写入编译缓存
+        if (m_compileCache && m_compileCache->isEnabled())
         {
-            if (pass->isActive())
-            {
-                activePasses++;
-            }
+            m_cachedGraph = &m_compileCache->insert(topologyHash, std::move(topologyKey));
+            storeToCache(*m_cachedGraph);
         }
 
-        std::cout << "活跃Pass数量: " << activePasses << std::endl;
-        std::cout << "=== RenderGraph编译完成 ===" << std::endl;
+        // 输出编译统计
+        collectCompileStats();
+        m_stats.compileMs = elapsedMs(compileBegin);
+
+        QTR_LOG_DEBUG("RenderGraph", "活跃Pass数量: " << m_stats.activePasses << " / " << m_stats.declaredPasses
+                                     << " (合并 " << m_stats.mergedPasses << ", 批次 " << m_stats.submitBatches
+                                     << ", 屏障 " << m_stats.barriers.getTotal() << ", " << m_stats.compileMs
+                                     << " ms)");
+        QTR_LOG_DEBUG("RenderGraph", "=== RenderGraph编译完成 ===");
     }
     catch (const std::exception &e)
     {
-        std::cerr << "RenderGraph编译失败: " << e.what() << std::endl;
+        QTR_LOG_ERROR("RenderGraph", "RenderGraph编译失败: " << e.what());
         throw;
     }
 }
 
 void RenderGraph::execute(RDGSyncInfo *syncInfo)
 {
+    QTR_PROFILE_SCOPE("RenderGraph::execute");
     if (!m_compiled)
     {
         throw std::runtime_error("RenderGraph::execute: Must compile before execute");
@@ -302,137 +401,78 @@ void RenderGraph::execute(RDGSyncInfo *syncInfo)
         throw std::runtime_error("RenderGraph::execute: Already executed");
     }
 
-    std::cout << "\n=== RenderGraph执行开始 ===" << std::endl;
+    QTR_LOG_TRACE("RenderGraph", "=== RenderGraph执行开始 ===");
 
     try
     {
         // 执行阶段1：分配物理资源
+        uint64_t phaseBegin = vkcore::Profiler::now();
         allocateResources();
+        m_stats.allocateMs = elapsedMs(phaseBegin);
 
-        // 执行阶段2：获取命令缓冲区并录制
-        std::cout << "执行渲染图Pass..." << std::endl;
-
-        // 获取命令缓冲区（使用CommandPoolManager）
-        auto cmdBufferHandle = m_commandManager.allocate(vk::CommandBufferLevel::ePrimary);
-        vk::CommandBuffer cmdBuffer = *cmdBufferHandle;
-
-        // 开始录制命令缓冲区
-        vk::CommandBufferBeginInfo beginInfo{};
-        beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
-        cmdBuffer.begin(beginInfo);
-
-        // 执行所有活跃的Pass
-        for (size_t passIndex = 0; passIndex < m_compiledPasses.size(); ++passIndex)
+        // 拆分屏障的事件按帧从事件池取用（编译缓存只保存屏障本身）
+        m_splitEvents.clear();
+        for (size_t i = 0; i < m_splitBarriers.size(); ++i)
         {
-            const auto &compiledPass = m_compiledPasses[passIndex];
-            if (!compiledPass->isActive())
-            {
-                continue;
-            }
-
-            const RDGPass *originalPass = compiledPass->getOriginalPass();
-            std::cout << "  执行Pass: " << originalPass->getName() << std::endl;
-
-            // 执行屏障（在Pass开始前）
-            const auto &barriers = compiledPass->getBarriers();
-            if (!barriers.empty())
-            {
-                std::cout << "    执行 " << barriers.size() << " 个屏障" << std::endl;
-                executeBarriers(cmdBuffer, barriers);
-            }
-
-            // 如果是图形Pass，设置渲染状态
-            if (compiledPass->isGraphicsPass())
+            if (!m_eventPool)
             {
-                beginGraphicsPass(cmdBuffer, *originalPass);
+                throw std::runtime_error("RenderGraph::execute: Split barriers without event pool");
             }
+            m_splitEvents.push_back(m_eventPool->acquireEvent());
+        }
 
-            // 执行Pass的回调函数
-            try
+        // 计时查询按执行顺序在调用线程上分配，录制时（可能在工作线程上）只读
+        m_profileQueries.assign(m_compiledPasses.size(), UINT32_MAX);
+        if (m_profiler)
+        {
+            m_profiler->beginFrame();
+            for (const RDGSubmitBatch &batch : m_submitBatches)
             {
-                if (originalPass->m_useExtendedCallback)
-                {
-                    // 使用扩展回调（带资源访问器）
-                    if (originalPass->m_executeCallbackEx)
-                    {
-                        RDGResourceAccessor resourceAccessor(this);
-                        originalPass->m_executeCallbackEx(cmdBuffer, resourceAccessor);
-                    }
-                }
-                else
+                for (uint32_t passIndex : batch.passIndices)
                 {
-                    // 使用简单回调
-                    if (originalPass->m_executeCallback)
+                    const auto &compiledPass = m_compiledPasses[passIndex];
+                    const RDGPass *originalPass = compiledPass->getOriginalPass();
+
+                    // 合并的渲染实例整体计时一次（查询不能在渲染实例内开始并跨越其结束）
+                    if (!compiledPass->beginsRendering())
                     {
-                        originalPass->m_executeCallback(cmdBuffer);
+                        continue;
                     }
-                }
-            }
-            catch (const std::exception &e)
-            {
-                std::cerr << "    Pass执行失败: " << e.what() << std::endl;
-                // 继续执行其他Pass
-            }
 
-            // 如果是图形Pass，结束渲染
-            if (compiledPass->isGraphicsPass())
-            {
-                endGraphicsPass(cmdBuffer);
+                    // 管线统计查询不能跨越次级命令缓冲区（未启用 inheritedQueries），也不能跨越主命令缓冲区
+                    // （并行录制时合并块的每个Pass各自一个主命令缓冲区）
+                    bool statistics = !(m_workerPool && (originalPass->isParallel() || !compiledPass->endsRendering()));
+                    m_profileQueries[passIndex] =
+                        m_profiler->registerPass(originalPass->getName(), compiledPass->getQueue(),
+                                                 getQueueFamily(compiledPass->getQueue()), statistics);
+                }
             }
         }
 
-        // 结束命令缓冲区录制
-        cmdBuffer.end();
+        // 执行阶段2：录制命令缓冲区
+        QTR_LOG_TRACE("RenderGraph", "执行渲染图Pass...");
 
-        // 准备提交信息
-        vk::SubmitInfo submitInfo{};
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &cmdBuffer;
-
-        // 设置等待信号量（如果提供）
-        std::vector<vk::Semaphore> waitSemaphores;
-        std::vector<vk::PipelineStageFlags> waitStages;
-        if (syncInfo && !syncInfo->waitSemaphores.empty())
+        // 次级命令缓冲区不直接提交，但在提交前必须保持存活
+        std::vector<std::vector<vkcore::CommandBufferHandle>> batchBufferHandles;
+        std::vector<vkcore::CommandBufferHandle> secondaryBufferHandles;
+        phaseBegin = vkcore::Profiler::now();
+        if (m_workerPool)
         {
-            std::cout << "  等待 " << syncInfo->waitSemaphores.size() << " 个信号量" << std::endl;
-            for (const auto &waitInfo : syncInfo->waitSemaphores)
-            {
-                waitSemaphores.push_back(waitInfo.semaphore);
-                waitStages.push_back(waitInfo.waitStage);
-            }
-            submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
-            submitInfo.pWaitSemaphores = waitSemaphores.data();
-            submitInfo.pWaitDstStageMask = waitStages.data();
+            recordPassesParallel(batchBufferHandles, secondaryBufferHandles);
         }
-
-        // 设置触发信号量（如果提供）
-        if (syncInfo && !syncInfo->signalSemaphores.empty())
+        else
         {
-            std::cout << "  触发 " << syncInfo->signalSemaphores.size() << " 个信号量" << std::endl;
-            submitInfo.signalSemaphoreCount = static_cast<uint32_t>(syncInfo->signalSemaphores.size());
-            submitInfo.pSignalSemaphores = syncInfo->signalSemaphores.data();
+            recordPassesSerial(batchBufferHandles);
         }
+        m_stats.recordMs = elapsedMs(phaseBegin);
 
-        // 获取 Fence（如果提供）
-        vk::Fence fence = (syncInfo && syncInfo->executionFence) ? syncInfo->executionFence.value() : vk::Fence{};
-
-        // 提交命令缓冲区到GPU（使用图形队列）
-        vk::Queue graphicsQueue = m_device.getGraphicsQueue();
+        // 交换链图像在图末尾转换到呈现布局（追加到最后一个批次，随其触发的信号量交给呈现）
+        recordPresentTransitions(batchBufferHandles);
 
-        try
-        {
-            graphicsQueue.submit(submitInfo, fence);
-            std::cout << "  命令缓冲区已提交到GPU" << std::endl;
-
-            if (fence)
-            {
-                std::cout << "  已设置执行 Fence 用于同步" << std::endl;
-            }
-        }
-        catch (const vk::SystemError &e)
-        {
-            throw std::runtime_error("Failed to submit command buffer: " + std::string(e.what()));
-        }
+        // 执行阶段3：按批次提交到各队列
+        phaseBegin = vkcore::Profiler::now();
+        submitBatches(batchBufferHandles, syncInfo);
+        m_stats.submitMs = elapsedMs(phaseBegin);
 
         // 注意：不再调用 waitIdle()！
         // 如果用户需要同步等待，应该通过 syncInfo 的 Fence 来实现
@@ -440,11 +480,33 @@ void RenderGraph::execute(RDGSyncInfo *syncInfo)
 
         m_executed = true;
 
-        std::cout << "=== RenderGraph执行完成（异步）===" << std::endl;
+        // 推进跨帧对象的帧序号
+        if (m_compileCache)
+        {
+            m_compileCache->advanceFrame();
+        }
+        if (m_transientAllocator)
+        {
+            m_transientAllocator->advanceFrame();
+        }
+        if (m_asyncCompute)
+        {
+            m_asyncCompute->advanceFrame();
+        }
+        if (m_eventPool)
+        {
+            m_eventPool->advanceFrame();
+        }
+        if (m_profiler)
+        {
+            m_profiler->advanceFrame();
+        }
+
+        QTR_LOG_TRACE("RenderGraph", "=== RenderGraph执行完成（异步）===");
     }
     catch (const std::exception &e)
     {
-        std::cerr << "RenderGraph执行失败: " << e.what() << std::endl;
+        QTR_LOG_ERROR("RenderGraph", "RenderGraph执行失败: " << e.what());
         throw;
     }
 }
@@ -453,7 +515,8 @@ void RenderGraph::execute(RDGSyncInfo *syncInfo)
 
 void RenderGraph::buildDependencyGraph()
 {
-    std::cout << "构建依赖图..." << std::endl;
+    QTR_PROFILE_SCOPE("RenderGraph::buildDependencyGraph");
+    QTR_LOG_DEBUG("RenderGraph", "构建依赖图...");
 
     // 创建编译后的Pass对象
     m_compiledPasses.clear();
@@ -461,18 +524,108 @@ void RenderGraph::buildDependencyGraph()
 
     for (size_t i = 0; i < m_passes.size(); ++i)
     {
-        auto compiledPass = std::make_unique<RDGCompiledPass>(*m_passes[i], static_cast<uint32_t>(i));
-        m_compiledPasses.push_back(std::move(compiledPass));
+        m_compiledPasses.push_back(m_arena.create<RDGCompiledPass>(*m_passes[i], static_cast<uint32_t>(i)));
+    }
+
+    // 以句柄为下标的最后写者表与当前版本的读者链表（节点存放在一个连续数组中）
+    constexpr uint32_t kNoReader = UINT32_MAX;
+    struct ReaderNode
+    {
+        uint32_t pass;
+        uint32_t next;
+    };
+
+    const size_t handleCount = static_cast<size_t>(m_nextHandle) + 1;
+    std::vector<uint32_t> lastWriter(handleCount, kInvalidPassIndex);
+    std::vector<uint32_t> firstReader(handleCount, kNoReader);
+    std::vector<ReaderNode> readerNodes;
+
+    m_passEdges.clear();
+    m_passEdgeOffsets.clear();
+    m_passEdgeOffsets.reserve(m_passes.size() + 1);
+
+    auto readResource = [&](RDGResourceHandle handle, uint32_t passIndex) {
+        if (handle == kInvalidHandle || handle >= handleCount)
+        {
+            return;
+        }
+        if (lastWriter[handle] != kInvalidPassIndex && lastWriter[handle] != passIndex)
+        {
+            m_passEdges.push_back({RDGPassEdge::ReadAfterWrite, lastWriter[handle], passIndex, handle});
+        }
+        readerNodes.push_back({passIndex, firstReader[handle]});
+        firstReader[handle] = static_cast<uint32_t>(readerNodes.size() - 1);
+    };
+
+    // preserve：写入是否保留旧内容（附件 eLoad、可能只写部分区域的存储写入）
+    auto writeResource = [&](RDGResourceHandle handle, uint32_t passIndex, bool preserve) {
+        if (handle == kInvalidHandle || handle >= handleCount)
+        {
+            return;
+        }
+        for (uint32_t node = firstReader[handle]; node != kNoReader; node = readerNodes[node].next)
+        {
+            if (readerNodes[node].pass != passIndex)
+            {
+                m_passEdges.push_back({RDGPassEdge::WriteAfterRead, readerNodes[node].pass, passIndex, handle});
+            }
+        }
+        firstReader[handle] = kNoReader;
+
+        if (preserve && lastWriter[handle] != kInvalidPassIndex && lastWriter[handle] != passIndex)
+        {
+            m_passEdges.push_back({RDGPassEdge::WriteAfterWrite, lastWriter[handle], passIndex, handle});
+        }
+        lastWriter[handle] = passIndex;
+    };
+
+    // 按声明顺序处理：同一Pass内先读后写，读取看到的是之前的版本
+    for (size_t i = 0; i < m_passes.size(); ++i)
+    {
+        const RDGPass &pass = *m_passes[i];
+        const uint32_t passIndex = static_cast<uint32_t>(i);
+        m_passEdgeOffsets.push_back(static_cast<uint32_t>(m_passEdges.size()));
+
+        for (const auto &textureRead : pass.m_textureReads)
+        {
+            readResource(textureRead.handle.handle, passIndex);
+        }
+        for (const auto &bufferRead : pass.m_bufferReads)
+        {
+            readResource(bufferRead.handle.handle, passIndex);
+        }
+
+        for (const auto &colorAttachment : pass.m_colorAttachments)
+        {
+            writeResource(colorAttachment.handle.handle, passIndex,
+                          colorAttachment.loadOp == vk::AttachmentLoadOp::eLoad);
+        }
+        if (pass.m_depthAttachment.handle.isValid())
+        {
+            writeResource(pass.m_depthAttachment.handle.handle, passIndex,
+                          pass.m_depthAttachment.loadOp == vk::AttachmentLoadOp::eLoad ||
+                              pass.m_depthAttachment.stencilLoadOp == vk::AttachmentLoadOp::eLoad);
+        }
+        for (const auto &textureWrite : pass.m_textureWrites)
+        {
+            writeResource(textureWrite.handle.handle, passIndex, true);
+        }
+        for (const auto &bufferWrite : pass.m_bufferWrites)
+        {
+            writeResource(bufferWrite.handle.handle, passIndex, true);
+        }
     }
+    m_passEdgeOffsets.push_back(static_cast<uint32_t>(m_passEdges.size()));
 
-    std::cout << "依赖图构建完成" << std::endl;
+    QTR_LOG_DEBUG("RenderGraph", "依赖图构建完成 (" << m_passEdges.size() << " 条边)");
 }
 
 void RenderGraph::cullUnusedPasses()
 {
-    std::cout << "剔除未使用的Pass..." << std::endl;
+    QTR_PROFILE_SCOPE("RenderGraph::cullUnusedPasses");
+    QTR_LOG_DEBUG("RenderGraph", "剔除未使用的Pass...");
 
-    // 实现反向依赖分析：从写入外部资源的Pass开始反向遍历
+    // 实现反向依赖分析：从写入外部资源的Pass开始，沿依赖边反向遍历
     std::vector<bool> reachable(m_compiledPasses.size(), false);
     std::vector<size_t> workList;
 
@@ -485,8 +638,8 @@ void RenderGraph::cullUnusedPasses()
         // 检查颜色附件
         for (const auto &colorAttachment : pass->m_colorAttachments)
         {
-            auto it = m_textureResources.find(colorAttachment.handle.handle);
-            if (it != m_textureResources.end() && it->second->isExternal())
+            RDGTextureResource *textureResource = m_textureResources.find(colorAttachment.handle.handle);
+            if (textureResource && textureResource->isExternal())
             {
                 writesExternalResource = true;
                 break;
@@ -496,8 +649,8 @@ void RenderGraph::cullUnusedPasses()
         // 检查深度附件
         if (!writesExternalResource && pass->m_depthAttachment.handle.isValid())
         {
-            auto it = m_textureResources.find(pass->m_depthAttachment.handle.handle);
-            if (it != m_textureResources.end() && it->second->isExternal())
+            RDGTextureResource *textureResource = m_textureResources.find(pass->m_depthAttachment.handle.handle);
+            if (textureResource && textureResource->isExternal())
             {
                 writesExternalResource = true;
             }
@@ -508,8 +661,8 @@ void RenderGraph::cullUnusedPasses()
         {
             for (const auto &textureWrite : pass->m_textureWrites)
             {
-                auto it = m_textureResources.find(textureWrite.handle.handle);
-                if (it != m_textureResources.end() && it->second->isExternal())
+                RDGTextureResource *textureResource = m_textureResources.find(textureWrite.handle.handle);
+                if (textureResource && textureResource->isExternal())
                 {
                     writesExternalResource = true;
                     break;
@@ -522,8 +675,8 @@ void RenderGraph::cullUnusedPasses()
         {
             for (const auto &bufferWrite : pass->m_bufferWrites)
             {
-                auto it = m_bufferResources.find(bufferWrite.handle.handle);
-                if (it != m_bufferResources.end() && it->second->isExternal())
+                RDGBufferResource *bufferResource = m_bufferResources.find(bufferWrite.handle.handle);
+                if (bufferResource && bufferResource->isExternal())
                 {
                     writesExternalResource = true;
                     break;
@@ -535,99 +688,28 @@ void RenderGraph::cullUnusedPasses()
         {
             reachable[i] = true;
             workList.push_back(i);
-            std::cout << "  根节点Pass: " << pass->getName() << std::endl;
+            QTR_LOG_DEBUG("RenderGraph", "根节点Pass: " << pass->getName());
         }
     }
 
-    // 第二步：反向标记所有被根节点依赖的Pass
+    // 第二步：反向标记所有被根节点依赖的Pass（每条边只访问一次）
     while (!workList.empty())
     {
-        size_t currentPassIndex = workList.back();
+        const size_t currentPassIndex = workList.back();
         workList.pop_back();
 
-        const RDGPass *currentPass = m_compiledPasses[currentPassIndex]->getOriginalPass();
-
-        // 收集当前Pass读取的所有资源
-        std::vector<RDGResourceHandle> readResources;
-
-        for (const auto &textureRead : currentPass->m_textureReads)
-        {
-            readResources.push_back(textureRead.handle.handle);
-        }
-
-        for (const auto &bufferRead : currentPass->m_bufferReads)
-        {
-            readResources.push_back(bufferRead.handle.handle);
-        }
-
-        // 查找写入这些资源的Pass
-        for (size_t i = 0; i < currentPassIndex; ++i)
+        for (uint32_t e = m_passEdgeOffsets[currentPassIndex]; e < m_passEdgeOffsets[currentPassIndex + 1]; ++e)
         {
-            if (reachable[i])
-            {
-                continue; // 已经标记为可达
-            }
-
-            const RDGPass *pass = m_compiledPasses[i]->getOriginalPass();
-            bool writesRequiredResource = false;
-
-            // 检查是否写入了当前Pass需要读取的资源
-            for (RDGResourceHandle requiredResource : readResources)
+            const RDGPassEdge &edge = m_passEdges[e];
+            if (edge.type == RDGPassEdge::WriteAfterRead || reachable[edge.producerPass])
             {
-                // 检查颜色附件
-                for (const auto &colorAttachment : pass->m_colorAttachments)
-                {
-                    if (colorAttachment.handle.handle == requiredResource)
-                    {
-                        writesRequiredResource = true;
-                        break;
-                    }
-                }
-
-                // 检查深度附件
-                if (!writesRequiredResource && pass->m_depthAttachment.handle.handle == requiredResource)
-                {
-                    writesRequiredResource = true;
-                }
-
-                // 检查存储纹理写入
-                if (!writesRequiredResource)
-                {
-                    for (const auto &textureWrite : pass->m_textureWrites)
-                    {
-                        if (textureWrite.handle.handle == requiredResource)
-                        {
-                            writesRequiredResource = true;
-                            break;
-                        }
-                    }
-                }
-
-                // 检查存储缓冲区写入
-                if (!writesRequiredResource)
-                {
-                    for (const auto &bufferWrite : pass->m_bufferWrites)
-                    {
-                        if (bufferWrite.handle.handle == requiredResource)
-                        {
-                            writesRequiredResource = true;
-                            break;
-                        }
-                    }
-                }
-
-                if (writesRequiredResource)
-                {
-                    break;
-                }
+                continue; // 读后写只约束顺序；已经标记为可达
             }
 
-            if (writesRequiredResource)
-            {
-                reachable[i] = true;
-                workList.push_back(i);
-                std::cout << "  依赖Pass: " << pass->getName() << std::endl;
-            }
+            reachable[edge.producerPass] = true;
+            workList.push_back(edge.producerPass);
+            QTR_LOG_DEBUG("RenderGraph", "依赖Pass: "
+                                         << m_compiledPasses[edge.producerPass]->getOriginalPass()->getName());
         }
     }
 
@@ -645,17 +727,18 @@ void RenderGraph::cullUnusedPasses()
         else
         {
             culledPasses++;
-            std::cout << "  剔除Pass: " << m_compiledPasses[i]->getOriginalPass()->getName() << std::endl;
+            QTR_LOG_DEBUG("RenderGraph", "剔除Pass: " << m_compiledPasses[i]->getOriginalPass()->getName());
         }
     }
 
-    std::cout << "Pass剔除完成，活跃Pass: " << activePasses << "/" << m_compiledPasses.size()
-              << "，剔除Pass: " << culledPasses << std::endl;
+    QTR_LOG_DEBUG("RenderGraph", "Pass剔除完成，活跃Pass: " << activePasses << "/" << m_compiledPasses.size() << "，剔除Pass: "
+                                 << culledPasses);
 }
 
 void RenderGraph::analyzeResourceLifetime()
 {
-    std::cout << "分析资源生命周期..." << std::endl;
+    QTR_PROFILE_SCOPE("RenderGraph::analyzeResourceLifetime");
+    QTR_LOG_DEBUG("RenderGraph", "分析资源生命周期...");
 
     // 遍历所有活跃Pass，记录资源使用
     for (size_t passIndex = 0; passIndex < m_compiledPasses.size(); ++passIndex)
@@ -671,77 +754,174 @@ void RenderGraph::analyzeResourceLifetime()
         // 记录纹理读取
         for (const auto &textureRead : pass->m_textureReads)
         {
-            auto it = m_textureResources.find(textureRead.handle.handle);
-            if (it != m_textureResources.end())
+            RDGTextureResource *textureResource = m_textureResources.find(textureRead.handle.handle);
+            if (textureResource)
             {
-                it->second->updateLifetime(static_cast<uint32_t>(passIndex));
+                textureResource->updateLifetime(static_cast<uint32_t>(passIndex));
             }
         }
 
         // 记录纹理写入
         for (const auto &textureWrite : pass->m_textureWrites)
         {
-            auto it = m_textureResources.find(textureWrite.handle.handle);
-            if (it != m_textureResources.end())
+            RDGTextureResource *textureResource = m_textureResources.find(textureWrite.handle.handle);
+            if (textureResource)
             {
-                it->second->updateLifetime(static_cast<uint32_t>(passIndex));
+                textureResource->updateLifetime(static_cast<uint32_t>(passIndex));
             }
         }
 
         // 记录颜色附件
         for (const auto &colorAttachment : pass->m_colorAttachments)
         {
-            auto it = m_textureResources.find(colorAttachment.handle.handle);
-            if (it != m_textureResources.end())
+            RDGTextureResource *textureResource = m_textureResources.find(colorAttachment.handle.handle);
+            if (textureResource)
             {
-                it->second->updateLifetime(static_cast<uint32_t>(passIndex));
+                textureResource->updateLifetime(static_cast<uint32_t>(passIndex));
             }
         }
 
         // 记录深度附件
         if (pass->m_depthAttachment.handle.isValid())
         {
-            auto it = m_textureResources.find(pass->m_depthAttachment.handle.handle);
-            if (it != m_textureResources.end())
+            RDGTextureResource *textureResource = m_textureResources.find(pass->m_depthAttachment.handle.handle);
+            if (textureResource)
             {
-                it->second->updateLifetime(static_cast<uint32_t>(passIndex));
+                textureResource->updateLifetime(static_cast<uint32_t>(passIndex));
             }
         }
 
         // 记录缓冲区读取
         for (const auto &bufferRead : pass->m_bufferReads)
         {
-            auto it = m_bufferResources.find(bufferRead.handle.handle);
-            if (it != m_bufferResources.end())
+            RDGBufferResource *bufferResource = m_bufferResources.find(bufferRead.handle.handle);
+            if (bufferResource)
             {
-                it->second->updateLifetime(static_cast<uint32_t>(passIndex));
+                bufferResource->updateLifetime(static_cast<uint32_t>(passIndex));
             }
         }
 
         // 记录缓冲区写入
         for (const auto &bufferWrite : pass->m_bufferWrites)
         {
-            auto it = m_bufferResources.find(bufferWrite.handle.handle);
-            if (it != m_bufferResources.end())
+            RDGBufferResource *bufferResource = m_bufferResources.find(bufferWrite.handle.handle);
+            if (bufferResource)
             {
-                it->second->updateLifetime(static_cast<uint32_t>(passIndex));
+                bufferResource->updateLifetime(static_cast<uint32_t>(passIndex));
             }
         }
     }
 
-    std::cout << "资源生命周期分析完成" << std::endl;
+    QTR_LOG_DEBUG("RenderGraph", "资源生命周期分析完成");
 }
 
 void RenderGraph::allocateResources()
 {
-    std::cout << "分配物理资源..." << std::endl;
+    QTR_PROFILE_SCOPE("RenderGraph::allocateResources");
+    QTR_LOG_DEBUG("RenderGraph", "分配物理资源...");
 
     // 清理上一帧的资源
-    m_frameTextures.clear();
-    m_frameBuffers.clear();
+    releaseFrameResources();
+
+    // 跨帧瞬态分配器：按生命周期做内存别名，堆与资源跨帧复用
+    if (m_transientAllocator)
+    {
+        std::vector<RDGTransientAllocator::Request> textureRequests;
+        std::vector<RDGTransientAllocator::Request> bufferRequests;
+
+        // Pass索引区间只描述单条队列上的先后顺序：生命周期内含异步计算Pass的资源可能与
+        // 图形队列上"之后"的Pass并发执行，因此把它的区间扩展到整帧，不与任何资源别名
+        const uint32_t lastPassIndex = m_passes.empty() ? 0 : static_cast<uint32_t>(m_passes.size() - 1);
+        auto widenForAsyncCompute = [&](RDGTransientAllocator::Request &request) {
+            for (uint32_t passIndex = request.firstPass;
+                 passIndex <= request.lastPass && passIndex < m_compiledPasses.size(); ++passIndex)
+            {
+                if (m_compiledPasses[passIndex]->getQueue() == RDGQueueType::AsyncCompute)
+                {
+                    request.firstPass = 0;
+                    request.lastPass = lastPassIndex;
+                    return;
+                }
+            }
+        };
+
+        const RDGHandleTable<uint8_t> tileLocalTextures = findTileLocalTextures();
+        for (const auto &[handle, resource] : m_textureResources)
+        {
+            if (resource->isTransient() && resource->isUsed())
+            {
+                RDGTransientAllocator::Request request{};
+                request.handle = handle;
+                request.textureDesc = &resource->getDesc();
+                request.firstPass = resource->getLifetime().firstPassIndex;
+                request.lastPass = resource->getLifetime().lastPassIndex;
+                request.lazilyAllocated = tileLocalTextures.find(handle) != 0;
+                widenForAsyncCompute(request);
+                textureRequests.push_back(request);
+            }
+        }
+
+        for (const auto &[handle, resource] : m_bufferResources)
+        {
+            if (resource->isTransient() && resource->isUsed())
+            {
+                RDGTransientAllocator::Request request{};
+                request.handle = handle;
+                request.bufferDesc = &resource->getDesc();
+                request.firstPass = resource->getLifetime().firstPassIndex;
+                request.lastPass = resource->getLifetime().lastPassIndex;
+                widenForAsyncCompute(request);
+                bufferRequests.push_back(request);
+            }
+        }
+
+        // 句柄表按句柄顺序遍历，请求天然有序，着色结果与缓存的放置位置逐帧稳定
+
+        RDGTransientAllocator::Result result;
+        m_transientAllocator->allocate(textureRequests, bufferRequests, static_cast<uint32_t>(m_passes.size()), result);
+
+        for (const auto &[handle, image] : result.textures)
+        {
+            m_textureResources.at(handle)->setPhysicalImage(image);
+        }
+        for (const auto &[handle, buffer] : result.buffers)
+        {
+            m_bufferResources.at(handle)->setPhysicalBuffer(buffer);
+        }
+
+        m_aliasingBarrierPasses = std::move(result.aliasingBarrierPasses);
+
+        // 别名屏障按渲染实例录制一次（见 recordPass）
+        std::vector<uint8_t> aliasedInstances(m_compiledPasses.size(), 0);
+        for (size_t passIndex = 0; passIndex < m_aliasingBarrierPasses.size(); ++passIndex)
+        {
+            const RDGCompiledPass &compiledPass = *m_compiledPasses[passIndex];
+            if (m_aliasingBarrierPasses[passIndex] && compiledPass.isActive() &&
+                !std::exchange(aliasedInstances[compiledPass.getMergeHead()], 1))
+            {
+                ++m_stats.barriers.aliasingBarriers;
+            }
+        }
+
+        const RDGTransientStats &transientStats = m_transientAllocator->getStats();
+        m_stats.transientRequestedBytes = transientStats.requestedBytes;
+        m_stats.transientAllocatedBytes = transientStats.aliasedBytes;
+        m_stats.lazyTextures = transientStats.lazyTextureCount;
+        m_stats.textureRequests = transientStats.textureCount;
+        m_stats.textureHits = transientStats.textureCount - transientStats.createdTextures;
+        m_stats.bufferRequests = transientStats.bufferCount;
+        m_stats.bufferHits =
+            transientStats.bufferCount - (transientStats.createdResources - transientStats.createdTextures);
+
+        QTR_LOG_DEBUG("RenderGraph", "物理资源分配完成");
+        return;
+    }
+
+    m_texturePool.resetStats();
+    m_bufferPool.resetStats();
 
     // 分配瞬态纹理
-    for (auto &[handle, resource] : m_textureResources)
+    for (const auto &[handle, resource] : m_textureResources)
     {
         if (resource->isTransient() && resource->isUsed())
         {
@@ -751,7 +931,7 @@ void RenderGraph::allocateResources()
     }
 
     // 分配瞬态缓冲区
-    for (auto &[handle, resource] : m_bufferResources)
+    for (const auto &[handle, resource] : m_bufferResources)
     {
         if (resource->isTransient() && resource->isUsed())
         {
@@ -760,419 +940,1269 @@ void RenderGraph::allocateResources()
         }
     }
 
-    std::cout << "物理资源分配完成" << std::endl;
+    m_stats.textureRequests = m_texturePool.getRequestCount();
+    m_stats.textureHits = m_texturePool.getHitCount();
+    m_stats.bufferRequests = m_bufferPool.getRequestCount();
+    m_stats.bufferHits = m_bufferPool.getHitCount();
+
+    QTR_LOG_DEBUG("RenderGraph", "物理资源分配完成");
 }
 
-void RenderGraph::computeBarriers()
+RDGHandleTable<uint8_t> RenderGraph::findTileLocalTextures() const
 {
-    std::cout << "计算屏障..." << std::endl;
-
-    // 跟踪每个资源的最后一次访问信息
-    struct ResourceAccessInfo
-    {
-        vk::PipelineStageFlags lastStages = vk::PipelineStageFlagBits::eTopOfPipe;
-        vk::AccessFlags lastAccess = vk::AccessFlagBits::eNone;
-        bool wasWrite = false;
+    // 每个纹理作为附件时所在渲染实例的第一个Pass + 1（0 表示尚未见到）；一旦有着色器/传输访问，
+    // 或出现在两个渲染实例中（内容需要写回显存再读回），就标记为 kNotTileLocal
+    constexpr uint32_t kNotTileLocal = UINT32_MAX;
+    RDGHandleTable<uint32_t> renderingInstance;
+
+    auto markAttachment = [&renderingInstance](RDGResourceHandle handle, uint32_t mergeHead) {
+        uint32_t &instance = renderingInstance[handle];
+        instance = (instance == 0 || instance == mergeHead + 1) ? mergeHead + 1 : kNotTileLocal;
     };
 
-    std::unordered_map<RDGResourceHandle, ResourceAccessInfo> textureAccessInfo;
-    std::unordered_map<RDGResourceHandle, ResourceAccessInfo> bufferAccessInfo;
-
-    // 遍历所有活跃Pass，计算所需的屏障
-    for (size_t passIndex = 0; passIndex < m_compiledPasses.size(); ++passIndex)
+    for (const auto &compiledPass : m_compiledPasses)
     {
-        auto &compiledPass = m_compiledPasses[passIndex];
         if (!compiledPass->isActive())
         {
             continue;
         }
 
         const RDGPass *pass = compiledPass->getOriginalPass();
-
-        // 处理纹理读取屏障
+        for (const auto &colorAttachment : pass->m_colorAttachments)
+        {
+            markAttachment(colorAttachment.handle.handle, compiledPass->getMergeHead());
+        }
+        if (pass->m_depthAttachment.handle.isValid())
+        {
+            markAttachment(pass->m_depthAttachment.handle.handle, compiledPass->getMergeHead());
+        }
         for (const auto &textureRead : pass->m_textureReads)
         {
-            auto it = m_textureResources.find(textureRead.handle.handle);
-            if (it == m_textureResources.end())
-                continue;
-
-            vk::ImageLayout requiredLayout = textureRead.layout;
-            vk::ImageLayout currentLayout = m_textureLayouts[textureRead.handle.handle];
+            renderingInstance[textureRead.handle.handle] = kNotTileLocal;
+        }
+        for (const auto &textureWrite : pass->m_textureWrites)
+        {
+            renderingInstance[textureWrite.handle.handle] = kNotTileLocal;
+        }
+    }
 
-            auto &accessInfo = textureAccessInfo[textureRead.handle.handle];
+    RDGHandleTable<uint8_t> tileLocal;
+    for (const auto &[handle, instance] : renderingInstance)
+    {
+        RDGTextureResource *textureResource = m_textureResources.find(handle);
+        if (instance != kNotTileLocal && textureResource && textureResource->isTransient())
+        {
+            tileLocal[handle] = 1;
+        }
+    }
+    return tileLocal;
+}
 
-            // 如果上一次是写入操作，需要WAR（Write-After-Read）屏障
-            if (accessInfo.wasWrite)
-            {
-                addImageBarrier(*compiledPass, textureRead.handle, currentLayout, requiredLayout, accessInfo.lastAccess,
-                                textureRead.access, accessInfo.lastStages, textureRead.stages);
+void RenderGraph::scheduleQueues()
+{
+    QTR_PROFILE_SCOPE("RenderGraph::scheduleQueues");
+    QTR_LOG_DEBUG("RenderGraph", "调度队列...");
 
-                m_textureLayouts[textureRead.handle.handle] = requiredLayout;
-            }
-            else if (currentLayout != requiredLayout)
-            {
-                // 仅布局转换
-                addImageBarrier(*compiledPass, textureRead.handle, currentLayout, requiredLayout,
-                                vk::AccessFlagBits::eNone, textureRead.access, vk::PipelineStageFlagBits::eTopOfPipe,
-                                textureRead.stages);
+    bool asyncAvailable = m_asyncCompute && m_asyncCompute->isAvailable();
+    size_t asyncPassCount = 0;
 
-                m_textureLayouts[textureRead.handle.handle] = requiredLayout;
-            }
+    for (auto &compiledPass : m_compiledPasses)
+    {
+        compiledPass->setQueue(RDGQueueType::Graphics);
 
-            // 更新访问信息
-            accessInfo.lastStages = textureRead.stages;
-            accessInfo.lastAccess = textureRead.access;
-            accessInfo.wasWrite = false;
+        const RDGPass *pass = compiledPass->getOriginalPass();
+        if (!compiledPass->isActive() || !pass->isAsyncCompute())
+        {
+            continue;
         }
 
-        // 处理颜色附件屏障（写入操作）
-        for (const auto &colorAttachment : pass->m_colorAttachments)
+        if (compiledPass->isGraphicsPass())
         {
-            auto it = m_textureResources.find(colorAttachment.handle.handle);
-            if (it == m_textureResources.end())
-                continue;
+            throw std::runtime_error("RenderGraph::scheduleQueues: Pass '" + pass->getName() +
+                                     "' 带有附件，不能调度到异步计算队列");
+        }
 
-            vk::ImageLayout requiredLayout = vk::ImageLayout::eColorAttachmentOptimal;
-            vk::ImageLayout currentLayout = m_textureLayouts[colorAttachment.handle.handle];
-
-            auto &accessInfo = textureAccessInfo[colorAttachment.handle.handle];
+        if (!asyncAvailable)
+        {
+            continue;
+        }
 
-            vk::AccessFlags dstAccess = vk::AccessFlagBits::eColorAttachmentWrite;
-            if (colorAttachment.loadOp == vk::AttachmentLoadOp::eLoad)
-            {
-                dstAccess |= vk::AccessFlagBits::eColorAttachmentRead;
-            }
+        // 导入资源在帧外由图形队列持有，帧内没有可用于释放所有权的生产者Pass，保守地留在图形队列
+        bool touchesImported = false;
+        for (const auto &access : pass->m_textureReads)
+        {
+            const auto &resource = m_textureResources.at(access.handle.handle);
+            touchesImported |= resource->isExternal() || resource->isSwapChainImage();
+        }
+        for (const auto &access : pass->m_textureWrites)
+        {
+            const auto &resource = m_textureResources.at(access.handle.handle);
+            touchesImported |= resource->isExternal() || resource->isSwapChainImage();
+        }
+        for (const auto &access : pass->m_bufferReads)
+        {
+            touchesImported |= m_bufferResources.at(access.handle.handle)->isExternal();
+        }
+        for (const auto &access : pass->m_bufferWrites)
+        {
+            touchesImported |= m_bufferResources.at(access.handle.handle)->isExternal();
+        }
 
-            // 需要屏障（WAW 或 RAW）
-            if (accessInfo.lastAccess != vk::AccessFlagBits::eNone || currentLayout != requiredLayout)
-            {
-                addImageBarrier(*compiledPass, colorAttachment.handle, currentLayout, requiredLayout,
-                                accessInfo.lastAccess, dstAccess, accessInfo.lastStages,
-                                vk::PipelineStageFlagBits::eColorAttachmentOutput);
+        if (touchesImported)
+        {
+            QTR_LOG_DEBUG("RenderGraph", "Pass '" << pass->getName() << "' 访问导入资源，回退到图形队列");
+            continue;
+        }
 
-                m_textureLayouts[colorAttachment.handle.handle] = requiredLayout;
-            }
+        compiledPass->setQueue(RDGQueueType::AsyncCompute);
+        asyncPassCount++;
+    }
 
-            // 更新访问信息
-            accessInfo.lastStages = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-            accessInfo.lastAccess = dstAccess;
-            accessInfo.wasWrite = true;
-        }
+    QTR_LOG_DEBUG("RenderGraph", "队列调度完成 (异步计算Pass: " << asyncPassCount << ")");
+}
 
-        // 处理深度附件屏障（写入操作）
-        if (pass->m_depthAttachment.handle.isValid())
-        {
-            auto it = m_textureResources.find(pass->m_depthAttachment.handle.handle);
-            if (it != m_textureResources.end())
-            {
-                vk::ImageLayout requiredLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
-                vk::ImageLayout currentLayout = m_textureLayouts[pass->m_depthAttachment.handle.handle];
+void RenderGraph::computeBarriers()
+{
+    QTR_PROFILE_SCOPE("RenderGraph::computeBarriers");
+    QTR_LOG_DEBUG("RenderGraph", "计算屏障...");
 
-                auto &accessInfo = textureAccessInfo[pass->m_depthAttachment.handle.handle];
+    m_queueDependencies.clear();
+    for (auto &compiledPass : m_compiledPasses)
+    {
+        compiledPass->setBarriers({});
+        compiledPass->setReleaseBarriers({});
+        compiledPass->setLocalReadBarriers({});
+    }
 
-                vk::AccessFlags dstAccess = vk::AccessFlagBits::eDepthStencilAttachmentWrite;
-                if (pass->m_depthAttachment.loadOp == vk::AttachmentLoadOp::eLoad)
-                {
-                    dstAccess |= vk::AccessFlagBits::eDepthStencilAttachmentRead;
-                }
+    collectLocalReadTextures();
 
-                // 需要屏障
-                if (accessInfo.lastAccess != vk::AccessFlagBits::eNone || currentLayout != requiredLayout)
-                {
-                    addImageBarrier(*compiledPass, pass->m_depthAttachment.handle, currentLayout, requiredLayout,
-                                    accessInfo.lastAccess, dstAccess, accessInfo.lastStages,
-                                    vk::PipelineStageFlagBits::eEarlyFragmentTests |
-                                        vk::PipelineStageFlagBits::eLateFragmentTests);
+    // 以句柄为下标（句柄连续生成）
+    std::vector<ResourceSyncTracker> textureTrackers(static_cast<size_t>(m_nextHandle) + 1);
+    std::vector<ResourceSyncTracker> bufferTrackers(static_cast<size_t>(m_nextHandle) + 1);
 
-                    m_textureLayouts[pass->m_depthAttachment.handle.handle] = requiredLayout;
-                }
+    // 导入前的访问当作已可见的读取：图内首次写入或布局转换与之建立执行依赖（WAR），读取无需屏障
+    for (const auto &[handle, stages] : m_importStages)
+    {
+        textureTrackers[handle].state.readStages = stages;
+    }
 
-                // 更新访问信息
-                accessInfo.lastStages =
-                    vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests;
-                accessInfo.lastAccess = dstAccess;
-                accessInfo.wasWrite = true;
-            }
+    // 遍历所有活跃Pass，计算所需的屏障
+    for (size_t passIndex = 0; passIndex < m_compiledPasses.size(); ++passIndex)
+    {
+        auto &compiledPass = m_compiledPasses[passIndex];
+        if (!compiledPass->isActive())
+        {
+            continue;
         }
 
-        // 处理存储纹理写入
-        for (const auto &textureWrite : pass->m_textureWrites)
+        const RDGPass *pass = compiledPass->getOriginalPass();
+
+        // 处理纹理读取
+        for (const auto &textureRead : pass->m_textureReads)
         {
-            auto it = m_textureResources.find(textureWrite.handle.handle);
-            if (it == m_textureResources.end())
+            if (!m_textureResources.find(textureRead.handle.handle))
                 continue;
 
-            vk::ImageLayout requiredLayout = vk::ImageLayout::eGeneral;
-            vk::ImageLayout currentLayout = m_textureLayouts[textureWrite.handle.handle];
+            syncResourceAccess(*compiledPass, textureTrackers[textureRead.handle.handle], RDGBarrier::Image,
+                               textureRead.handle.handle, toStages2(textureRead.stages), toAccess2(textureRead.access),
+                               textureRead.layout, false);
+        }
 
-            auto &accessInfo = textureAccessInfo[textureWrite.handle.handle];
+        // 处理颜色附件（写入操作）
+        for (const auto &colorAttachment : pass->m_colorAttachments)
+        {
+            if (!m_textureResources.find(colorAttachment.handle.handle))
+                continue;
 
-            // 需要屏障
-            if (accessInfo.lastAccess != vk::AccessFlagBits::eNone || currentLayout != requiredLayout)
+            vk::AccessFlags2 dstAccess = vk::AccessFlagBits2::eColorAttachmentWrite;
+            if (colorAttachment.loadOp == vk::AttachmentLoadOp::eLoad)
             {
-                addImageBarrier(*compiledPass, textureWrite.handle, currentLayout, requiredLayout,
-                                accessInfo.lastAccess, textureWrite.access, accessInfo.lastStages, textureWrite.stages);
+                dstAccess |= vk::AccessFlagBits2::eColorAttachmentRead;
+            }
+
+            syncResourceAccess(*compiledPass, textureTrackers[colorAttachment.handle.handle], RDGBarrier::Image,
+                               colorAttachment.handle.handle, vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                               dstAccess, getColorAttachmentLayout(colorAttachment.handle.handle), true);
+        }
 
-                m_textureLayouts[textureWrite.handle.handle] = requiredLayout;
+        // 处理深度附件（写入操作）
+        if (pass->m_depthAttachment.handle.isValid() &&
+            m_textureResources.find(pass->m_depthAttachment.handle.handle))
+        {
+            vk::AccessFlags2 dstAccess = vk::AccessFlagBits2::eDepthStencilAttachmentWrite;
+            if (pass->m_depthAttachment.loadOp == vk::AttachmentLoadOp::eLoad)
+            {
+                dstAccess |= vk::AccessFlagBits2::eDepthStencilAttachmentRead;
             }
 
-            // 更新访问信息
-            accessInfo.lastStages = textureWrite.stages;
-            accessInfo.lastAccess = textureWrite.access;
-            accessInfo.wasWrite = true;
+            syncResourceAccess(*compiledPass, textureTrackers[pass->m_depthAttachment.handle.handle],
+                               RDGBarrier::Image, pass->m_depthAttachment.handle.handle,
+                               vk::PipelineStageFlagBits2::eEarlyFragmentTests |
+                                   vk::PipelineStageFlagBits2::eLateFragmentTests,
+                               dstAccess, vk::ImageLayout::eDepthStencilAttachmentOptimal, true);
         }
 
-        // 处理缓冲区读取
-        for (const auto &bufferRead : pass->m_bufferReads)
+        // 处理存储纹理写入
+        for (const auto &textureWrite : pass->m_textureWrites)
         {
-            auto it = m_bufferResources.find(bufferRead.handle.handle);
-            if (it == m_bufferResources.end())
+            if (!m_textureResources.find(textureWrite.handle.handle))
                 continue;
 
-            auto &accessInfo = bufferAccessInfo[bufferRead.handle.handle];
+            syncResourceAccess(*compiledPass, textureTrackers[textureWrite.handle.handle], RDGBarrier::Image,
+                               textureWrite.handle.handle, toStages2(textureWrite.stages),
+                               toAccess2(textureWrite.access), vk::ImageLayout::eGeneral, true);
+        }
 
-            // 如果上一次是写入操作，需要屏障
-            if (accessInfo.wasWrite)
-            {
-                addBufferBarrier(*compiledPass, bufferRead.handle, accessInfo.lastAccess, bufferRead.access,
-                                 accessInfo.lastStages, bufferRead.stages);
-            }
+        // 处理缓冲区读取
+        for (const auto &bufferRead : pass->m_bufferReads)
+        {
+            if (!m_bufferResources.find(bufferRead.handle.handle))
+                continue;
 
-            // 更新访问信息
-            accessInfo.lastStages = bufferRead.stages;
-            accessInfo.lastAccess = bufferRead.access;
-            accessInfo.wasWrite = false;
+            syncResourceAccess(*compiledPass, bufferTrackers[bufferRead.handle.handle], RDGBarrier::Buffer,
+                               bufferRead.handle.handle, toStages2(bufferRead.stages), toAccess2(bufferRead.access),
+                               vk::ImageLayout::eUndefined, false);
         }
 
         // 处理缓冲区写入
         for (const auto &bufferWrite : pass->m_bufferWrites)
         {
-            auto it = m_bufferResources.find(bufferWrite.handle.handle);
-            if (it == m_bufferResources.end())
+            if (!m_bufferResources.find(bufferWrite.handle.handle))
                 continue;
 
-            auto &accessInfo = bufferAccessInfo[bufferWrite.handle.handle];
-
-            // 需要屏障（WAW 或 RAW）
-            if (accessInfo.lastAccess != vk::AccessFlagBits::eNone)
-            {
-                addBufferBarrier(*compiledPass, bufferWrite.handle, accessInfo.lastAccess, bufferWrite.access,
-                                 accessInfo.lastStages, bufferWrite.stages);
-            }
-
-            // 更新访问信息
-            accessInfo.lastStages = bufferWrite.stages;
-            accessInfo.lastAccess = bufferWrite.access;
-            accessInfo.wasWrite = true;
+            syncResourceAccess(*compiledPass, bufferTrackers[bufferWrite.handle.handle], RDGBarrier::Buffer,
+                               bufferWrite.handle.handle, toStages2(bufferWrite.stages), toAccess2(bufferWrite.access),
+                               vk::ImageLayout::eUndefined, true);
         }
     }
 
-    std::cout << "屏障计算完成" << std::endl;
+    size_t barrierCount = 0;
+    for (const auto &compiledPass : m_compiledPasses)
+    {
+        barrierCount += compiledPass->getBarriers().size() + compiledPass->getReleaseBarriers().size();
+    }
+    QTR_LOG_DEBUG("RenderGraph", "屏障计算完成 (" << barrierCount << " 个)");
 }
 
-// ==================== 验证辅助函数 ====================
-
-void RenderGraph::validateResourceStates() const
+void RenderGraph::syncResourceAccess(RDGCompiledPass &pass, ResourceSyncTracker &tracker, RDGBarrier::Type type,
+                                     RDGResourceHandle handle, vk::PipelineStageFlags2 stages, vk::AccessFlags2 access,
+                                     vk::ImageLayout layout, bool isWrite)
 {
-    std::cout << "验证资源状态..." << std::endl;
+    const bool isImage = type == RDGBarrier::Image;
+    const uint32_t currentPass = pass.getIndex();
 
-    // 跟踪每个资源是否已被写入
-    std::unordered_map<RDGResourceHandle, bool> textureWritten;
-    std::unordered_map<RDGResourceHandle, bool> bufferWritten;
+    // 缓冲区没有布局，用一个局部占位避免把缓冲区句柄写入纹理布局表
+    vk::ImageLayout bufferLayout = vk::ImageLayout::eUndefined;
+    vk::ImageLayout &currentLayout = isImage ? m_textureLayouts[handle] : bufferLayout;
+    if (!isImage)
+    {
+        layout = vk::ImageLayout::eUndefined;
+    }
 
-    // 遍历所有活跃Pass
-    for (size_t passIndex = 0; passIndex < m_compiledPasses.size(); ++passIndex)
+    if (tracker.state.lastPass == currentPass)
     {
-        const auto &compiledPass = m_compiledPasses[passIndex];
-        if (!compiledPass->isActive())
+        // 同一Pass再次访问：撤销本Pass已生成的屏障，回到进入Pass前的状态，按合并后的访问重新计算。
+        // 两次访问要求的布局不同时只能使用 General
+        stages |= tracker.passStages;
+        access |= tracker.passAccess;
+        isWrite = isWrite || tracker.passWrite;
+        if (isImage && layout != tracker.passLayout)
         {
-            continue;
+            layout = vk::ImageLayout::eGeneral;
         }
 
-        const RDGPass *pass = compiledPass->getOriginalPass();
-
-        // 验证读取的纹理资源
-        for (const auto &textureRead : pass->m_textureReads)
+        pass.removeBarrier(type, handle);
+        if (tracker.entryState.lastPass != kInvalidPassIndex)
         {
-            auto it = m_textureResources.find(textureRead.handle.handle);
-            if (it == m_textureResources.end())
-            {
-                throw std::runtime_error("RenderGraph::validateResourceStates: Pass '" + pass->getName() +
-                                         "' 尝试读取不存在的纹理资源");
-            }
-
-            const auto &resource = it->second;
-
-            // 外部资源不需要验证写入状态
-            if (resource->isExternal())
-            {
-                continue;
-            }
-
-            // 瞬态资源必须在读取前被写入
-            if (textureWritten.find(textureRead.handle.handle) == textureWritten.end())
-            {
-                std::cerr << "警告: Pass '" << pass->getName() << "' 读取了未被写入的纹理资源 '" << resource->getName()
-                          << "'" << std::endl;
-            }
+            m_compiledPasses[tracker.entryState.lastPass]->removeReleaseBarrier(type, handle);
         }
 
-        // 验证读取的缓冲区资源
-        for (const auto &bufferRead : pass->m_bufferReads)
-        {
-            auto it = m_bufferResources.find(bufferRead.handle.handle);
-            if (it == m_bufferResources.end())
-            {
-                throw std::runtime_error("RenderGraph::validateResourceStates: Pass '" + pass->getName() +
-                                         "' 尝试读取不存在的缓冲区资源");
-            }
+        tracker.state = tracker.entryState;
+        currentLayout = tracker.entryLayout;
+    }
+    else
+    {
+        tracker.entryState = tracker.state;
+        tracker.entryLayout = currentLayout;
+    }
 
-            const auto &resource = it->second;
+    ResourceSyncState &state = tracker.state;
+    const bool crossQueue = state.lastPass != kInvalidPassIndex && state.lastQueue != pass.getQueue();
+    const bool layoutChange = isImage && currentLayout != layout;
 
-            // 外部资源不需要验证写入状态
-            if (resource->isExternal())
-            {
-                continue;
-            }
+    bool needBarrier = false;
+    vk::PipelineStageFlags2 srcStages{};
+    vk::AccessFlags2 srcAccess{};
 
-            // 瞬态资源必须在读取前被写入
-            if (bufferWritten.find(bufferRead.handle.handle) == bufferWritten.end())
-            {
-                std::cerr << "警告: Pass '" << pass->getName() << "' 读取了未被写入的缓冲区资源 '"
-                          << resource->getName() << "'" << std::endl;
-            }
+    if (isWrite || layoutChange || crossQueue)
+    {
+        // 写入与布局转换必须排在之前的全部访问之后：之前的读取只需执行依赖（WAR），
+        // 尚未可用的写入还需要内存依赖（WAW）
+        srcStages = state.writeStages | state.readStages;
+        srcAccess = state.writeAccess;
+
+        // 交换链图像的首次访问与获取信号量的等待阶段（ColorAttachmentOutput）链接，布局转换才不会早于图像可用
+        if (isImage && state.lastPass == kInvalidPassIndex &&
+            m_presentLayouts.find(handle) != vk::ImageLayout::eUndefined)
+        {
+            srcStages |= vk::PipelineStageFlagBits2::eColorAttachmentOutput;
         }
-
-        // 标记写入的纹理资源
-        for (const auto &colorAttachment : pass->m_colorAttachments)
+        needBarrier = layoutChange || crossQueue || srcStages != vk::PipelineStageFlags2{};
+    }
+    else if (state.writeStages != vk::PipelineStageFlags2{})
+    {
+        // 写后读：已有读取使写入对这些阶段/访问可见时不再重复插入屏障
+        bool visible = (stages & ~state.readStages) == vk::PipelineStageFlags2{} &&
+                       (access & ~state.readAccess) == vk::AccessFlags2{};
+        if (!visible)
         {
-            textureWritten[colorAttachment.handle.handle] = true;
+            srcStages = state.writeStages;
+            srcAccess = state.writeAccess;
+            needBarrier = true;
         }
+    }
 
-        if (pass->m_depthAttachment.handle.isValid())
+    if (needBarrier)
+    {
+        if (isImage)
+        {
+            addImageBarrier(pass, RDGTextureHandle{handle}, currentLayout, layout, srcAccess, access, srcStages, stages,
+                            state.lastPass);
+        }
+        else
         {
-            textureWritten[pass->m_depthAttachment.handle.handle] = true;
+            addBufferBarrier(pass, RDGBufferHandle{handle}, srcAccess, access, srcStages, stages, state.lastPass);
         }
+    }
 
-        for (const auto &textureWrite : pass->m_textureWrites)
+    // 更新同步状态
+    if (isWrite)
+    {
+        state.writeStages = stages;
+        state.writeAccess = access;
+        state.readStages = vk::PipelineStageFlags2{};
+        state.readAccess = vk::AccessFlags2{};
+    }
+    else
+    {
+        if (crossQueue)
         {
-            textureWritten[textureWrite.handle.handle] = true;
+            // 获取屏障已使写入对本次访问可见；之后同队列上的其他读取以本次访问的阶段为源
+            state.writeStages = stages;
+            state.writeAccess = vk::AccessFlags2{};
         }
 
-        // 标记写入的缓冲区资源
-        for (const auto &bufferWrite : pass->m_bufferWrites)
+        if (layoutChange || crossQueue)
         {
-            bufferWritten[bufferWrite.handle.handle] = true;
+            state.readStages = stages;
+            state.readAccess = access;
+        }
+        else
+        {
+            state.readStages |= stages;
+            state.readAccess |= access;
         }
     }
 
-    std::cout << "资源状态验证完成" << std::endl;
-}
+    currentLayout = layout;
+    state.lastPass = currentPass;
+    state.lastQueue = pass.getQueue();
 
-// ==================== 资源分配辅助函数 ====================
+    tracker.passStages = stages;
+    tracker.passAccess = access;
+    tracker.passLayout = layout;
+    tracker.passWrite = isWrite;
+}
 
-vkcore::Image *RenderGraph::allocateTransientTexture(RDGTextureResource &resource)
+void RenderGraph::placeSplitBarriers()
 {
-    const auto &desc = resource.getDesc();
+    QTR_PROFILE_SCOPE("RenderGraph::placeSplitBarriers");
+    m_splitBarriers.clear();
+    if (!m_eventPool)
+    {
+        return;
+    }
 
-    // 尝试从池中复用资源（现在会自动检查规格匹配）
-    vkcore::Image *reusedImage = m_texturePool.tryAcquire(desc, resource.getLifetime());
+    QTR_LOG_DEBUG("RenderGraph", "放置拆分屏障...");
 
-    if (reusedImage)
+    // 每个活跃Pass在其队列上的序号：生产者与消费者序号相差大于1说明中间还有其他Pass可以重叠执行
+    const size_t passCount = m_compiledPasses.size();
+    std::vector<uint32_t> queueOrdinal(passCount, 0);
+    std::array<uint32_t, 2> queueCounters = {0, 0};
+    for (size_t passIndex = 0; passIndex < passCount; ++passIndex)
     {
-        std::cout << "  复用纹理资源: " << desc.name << " (格式: " << vk::to_string(desc.format)
-                  << ", 尺寸: " << desc.extent.width << "x" << desc.extent.height << ")" << std::endl;
-        return reusedImage;
+        const auto &compiledPass = m_compiledPasses[passIndex];
+        if (compiledPass->isActive())
+        {
+            queueOrdinal[passIndex] = queueCounters[static_cast<size_t>(compiledPass->getQueue())]++;
+        }
     }
 
-    // 创建ImageDesc
-    vkcore::ImageDesc imageDesc{};
-    imageDesc.format = desc.format;
-    imageDesc.extent = desc.extent;
-    imageDesc.usage = desc.usage;
-    imageDesc.mipLevels = desc.mipLevels;
-    imageDesc.arrayLayers = desc.arrayLayers;
-    imageDesc.samples = desc.samples;
-    imageDesc.tiling = desc.tiling;
+    for (size_t passIndex = 0; passIndex < passCount; ++passIndex)
+    {
+        RDGCompiledPass &consumer = *m_compiledPasses[passIndex];
+        if (!consumer.isActive() || consumer.getBarriers().empty())
+        {
+            continue;
+        }
 
-    // 创建新的Image对象
-    auto image = std::make_unique<vkcore::Image>(desc.name, m_device, m_allocator, imageDesc);
-    std::cout << "  创建新纹理资源: " << desc.name << " (格式: " << vk::to_string(desc.format)
-              << ", 尺寸: " << desc.extent.width << "x" << desc.extent.height << ")" << std::endl;
+        std::vector<RDGBarrier> immediateBarriers;
+        for (const RDGBarrier &barrier : consumer.getBarriers())
+        {
+            uint32_t producerPass = barrier.producerPass;
+            bool canSplit = producerPass != kInvalidPassIndex && barrier.srcQueueFamily == VK_QUEUE_FAMILY_IGNORED &&
+                            m_compiledPasses[producerPass]->getQueue() == consumer.getQueue() &&
+                            queueOrdinal[passIndex] - queueOrdinal[producerPass] > 1;
+            if (!canSplit)
+            {
+                immediateBarriers.push_back(barrier);
+                continue;
+            }
 
-    vkcore::Image *imagePtr = image.get();
-    m_frameTextures.push_back(std::move(image));
+            // 同一对生产者/消费者之间的屏障共用一个事件
+            auto it = std::find_if(m_splitBarriers.begin(), m_splitBarriers.end(), [&](const RDGSplitBarrier &split) {
+                return split.producerPass == producerPass && split.consumerPass == passIndex;
+            });
+            if (it == m_splitBarriers.end())
+            {
+                m_splitBarriers.push_back({producerPass, static_cast<uint32_t>(passIndex), {}});
+                it = m_splitBarriers.end() - 1;
+            }
+            it->barriers.push_back(barrier);
+        }
 
-    return imagePtr;
+        consumer.setBarriers(immediateBarriers);
+    }
+
+    for (size_t splitIndex = 0; splitIndex < m_splitBarriers.size(); ++splitIndex)
+    {
+        const RDGSplitBarrier &split = m_splitBarriers[splitIndex];
+        m_compiledPasses[split.producerPass]->addSplitSignal(static_cast<uint32_t>(splitIndex));
+        m_compiledPasses[split.consumerPass]->addSplitWait(static_cast<uint32_t>(splitIndex));
+    }
+
+    QTR_LOG_DEBUG("RenderGraph", "拆分屏障: " << m_splitBarriers.size());
 }
 
-vkcore::Buffer *RenderGraph::allocateTransientBuffer(RDGBufferResource &resource)
+void RenderGraph::buildSubmitBatches()
 {
-    const auto &desc = resource.getDesc();
+    QTR_PROFILE_SCOPE("RenderGraph::buildSubmitBatches");
+    QTR_LOG_DEBUG("RenderGraph", "划分提交批次...");
 
-    // 尝试从池中复用资源（现在会自动检查规格匹配）
-    vkcore::Buffer *reusedBuffer = m_bufferPool.tryAcquire(desc, resource.getLifetime());
+    m_submitBatches.clear();
 
-    if (reusedBuffer)
+    const size_t passCount = m_compiledPasses.size();
+    std::vector<uint8_t> hasIncoming(passCount, 0);
+    std::vector<uint8_t> hasOutgoing(passCount, 0);
+    for (const auto &dependency : m_queueDependencies)
     {
-        std::cout << "  复用缓冲区资源: " << desc.name << " (大小: " << desc.size << " 字节)" << std::endl;
-        return reusedBuffer;
+        hasOutgoing[dependency.producerPass] = 1;
+        hasIncoming[dependency.consumerPass] = 1;
     }
 
-    // 创建BufferDesc
-    vkcore::BufferDesc bufferDesc{};
-    bufferDesc.size = desc.size;
-    bufferDesc.usageFlags = desc.usage;
-
-    // 创建新的Buffer对象
-    auto buffer = std::make_unique<vkcore::Buffer>(desc.name, m_device, m_allocator, bufferDesc);
-    std::cout << "  创建新缓冲区资源: " << desc.name << " (大小: " << desc.size << " 字节)" << std::endl;
-
-    vkcore::Buffer *bufferPtr = buffer.get();
-    m_frameBuffers.push_back(std::move(buffer));
+    // 每条队列上仍可追加Pass的最新批次：一旦批次中的Pass有跨队列输出就关闭，
+    // 保证生产者完成后立即触发信号量，而不是等到后续无关Pass结束
+    std::vector<uint32_t> passBatch(passCount, kInvalidPassIndex);
+    std::array<uint32_t, 2> openBatch = {kInvalidPassIndex, kInvalidPassIndex};
 
-    return bufferPtr;
-}
+    for (size_t passIndex = 0; passIndex < passCount; ++passIndex)
+    {
+        const auto &compiledPass = m_compiledPasses[passIndex];
+        if (!compiledPass->isActive())
+        {
+            continue;
+        }
 
-// ==================== 屏障计算辅助函数 ====================
+        size_t queueSlot = static_cast<size_t>(compiledPass->getQueue());
+        if (hasIncoming[passIndex] || openBatch[queueSlot] == kInvalidPassIndex)
+        {
+            RDGSubmitBatch batch{};
+            batch.queue = compiledPass->getQueue();
+            m_submitBatches.push_back(std::move(batch));
+            openBatch[queueSlot] = static_cast<uint32_t>(m_submitBatches.size() - 1);
+        }
 
-vk::ImageLayout RenderGraph::computeImageLayout(RDGTextureHandle handle, const RDGPass::TextureAccess &access) const
-{
-    // 禁用未使用参数警告 - handle保留用于未来扩展
-    (void)handle;
+        uint32_t batchIndex = openBatch[queueSlot];
+        m_submitBatches[batchIndex].passIndices.push_back(static_cast<uint32_t>(passIndex));
+        passBatch[passIndex] = batchIndex;
 
-    // 根据访问类型推断图像布局
-    if (access.access & vk::AccessFlagBits::eColorAttachmentWrite)
-    {
-        return vk::ImageLayout::eColorAttachmentOptimal;
-    }
-    else if (access.access & vk::AccessFlagBits::eDepthStencilAttachmentWrite)
-    {
-        return vk::ImageLayout::eDepthStencilAttachmentOptimal;
+        if (hasOutgoing[passIndex])
+        {
+            openBatch[queueSlot] = kInvalidPassIndex;
+        }
     }
-    else if (access.access & vk::AccessFlagBits::eShaderRead)
+
+    // 跨队列等待：同一对批次之间只需要一个信号量
+    for (const auto &dependency : m_queueDependencies)
     {
-        return vk::ImageLayout::eShaderReadOnlyOptimal;
+        uint32_t producerBatch = passBatch[dependency.producerPass];
+        RDGSubmitBatch &consumer = m_submitBatches[passBatch[dependency.consumerPass]];
+
+        auto it = std::find(consumer.waitBatches.begin(), consumer.waitBatches.end(), producerBatch);
+        if (it == consumer.waitBatches.end())
+        {
+            consumer.waitBatches.push_back(producerBatch);
+            consumer.waitStages.push_back(dependency.waitStages);
+        }
+        else
+        {
+            consumer.waitStages[it - consumer.waitBatches.begin()] |= dependency.waitStages;
+        }
     }
-    else if (access.access & vk::AccessFlagBits::eShaderWrite)
+
+    // 汇合：最后一个计算批次若没有被后续图形批次等待，则追加一个空的图形批次等待它，
+    // 使帧 Fence 与触发信号量覆盖全部队列上的工作（没有任何批次时同样需要一个图形批次承载同步信息）
+    uint32_t lastComputeBatch = kInvalidPassIndex;
+    for (size_t batchIndex = 0; batchIndex < m_submitBatches.size(); ++batchIndex)
     {
-        return vk::ImageLayout::eGeneral;
+        if (m_submitBatches[batchIndex].queue == RDGQueueType::AsyncCompute)
+        {
+            lastComputeBatch = static_cast<uint32_t>(batchIndex);
+        }
     }
-    else if (access.access & vk::AccessFlagBits::eTransferRead)
+
+    bool computeJoined = lastComputeBatch == kInvalidPassIndex;
+    for (size_t batchIndex = lastComputeBatch + 1; !computeJoined && batchIndex < m_submitBatches.size(); ++batchIndex)
     {
-        return vk::ImageLayout::eTransferSrcOptimal;
+        const auto &waits = m_submitBatches[batchIndex].waitBatches;
+        computeJoined = std::find(waits.begin(), waits.end(), lastComputeBatch) != waits.end();
     }
-    else if (access.access & vk::AccessFlagBits::eTransferWrite)
+
+    if (!computeJoined || m_submitBatches.empty())
     {
-        return vk::ImageLayout::eTransferDstOptimal;
+        RDGSubmitBatch joinBatch{};
+        joinBatch.queue = RDGQueueType::Graphics;
+        if (!computeJoined)
+        {
+            joinBatch.waitBatches.push_back(lastComputeBatch);
+            joinBatch.waitStages.push_back(vk::PipelineStageFlagBits2::eAllCommands);
+        }
+        m_submitBatches.push_back(std::move(joinBatch));
     }
 
-    return vk::ImageLayout::eGeneral;
+    QTR_LOG_DEBUG("RenderGraph", "提交批次: " << m_submitBatches.size() << " (跨队列依赖: " << m_queueDependencies.size()
+                                 << ")");
+}
+
+void RenderGraph::mergeRenderPasses()
+{
+    QTR_PROFILE_SCOPE("RenderGraph::mergeRenderPasses");
+    QTR_LOG_DEBUG("RenderGraph", "合并渲染Pass...");
+
+    size_t mergedPasses = 0;
+    for (const RDGSubmitBatch &batch : m_submitBatches)
+    {
+        // 批次内的Pass按录制顺序排列，块是其中能够依次合并的最长连续区间
+        size_t blockBegin = 0;
+        while (blockBegin < batch.passIndices.size())
+        {
+            size_t blockEnd = blockBegin + 1;
+            while (blockEnd < batch.passIndices.size() &&
+                   canMergeRenderPasses(*m_compiledPasses[batch.passIndices[blockEnd - 1]],
+                                        *m_compiledPasses[batch.passIndices[blockEnd]]))
+            {
+                ++blockEnd;
+            }
+
+            const uint32_t head = batch.passIndices[blockBegin];
+            const uint32_t tail = batch.passIndices[blockEnd - 1];
+            for (size_t member = blockBegin; member < blockEnd; ++member)
+            {
+                RDGCompiledPass &compiledPass = *m_compiledPasses[batch.passIndices[member]];
+                compiledPass.setMergeRange(head, tail);
+                if (member != blockBegin)
+                {
+                    // 输入附件读取仍需让前一个Pass的写入在同一像素上可见，改为渲染实例内的逐区域屏障
+                    std::vector<RDGBarrier> localReadBarriers;
+                    for (const RDGBarrier &barrier : compiledPass.getBarriers())
+                    {
+                        if (barrier.dstAccess & vk::AccessFlagBits2::eInputAttachmentRead)
+                        {
+                            localReadBarriers.push_back(barrier);
+                        }
+                    }
+                    compiledPass.setLocalReadBarriers(localReadBarriers);
+                    compiledPass.setBarriers({});
+                    ++mergedPasses;
+                }
+            }
+
+            blockBegin = blockEnd;
+        }
+    }
+
+    QTR_LOG_DEBUG("RenderGraph", "合并的渲染Pass: " << mergedPasses);
+}
+
+bool RenderGraph::canMergeRenderPasses(const RDGCompiledPass &previous, const RDGCompiledPass &current) const
+{
+    if (!previous.isGraphicsPass() || !current.isGraphicsPass())
+    {
+        return false;
+    }
+
+    const RDGPass &previousPass = *previous.getOriginalPass();
+    const RDGPass &currentPass = *current.getOriginalPass();
+
+    // 并行Pass可能录制到次级命令缓冲区，渲染标志与普通Pass不同，挂起/恢复的各段无法保持一致
+    if (previousPass.isParallel() || currentPass.isParallel())
+    {
+        return false;
+    }
+
+    // 队列所有权转移与拆分屏障的事件操作都不能出现在渲染实例内
+    if (!previous.getReleaseBarriers().empty() || !previous.getSplitSignals().empty() ||
+        !current.getSplitWaits().empty())
+    {
+        return false;
+    }
+
+    // 附件集合（包括颜色附件顺序）必须相同，且后一个Pass加载前一个Pass的结果
+    const auto &previousColors = previousPass.m_colorAttachments;
+    const auto &currentColors = currentPass.m_colorAttachments;
+    const RDGTextureHandle depthHandle = currentPass.m_depthAttachment.handle;
+    if (previousColors.size() != currentColors.size() || !(previousPass.m_depthAttachment.handle == depthHandle) ||
+        (currentColors.empty() && !depthHandle.isValid()))
+    {
+        return false;
+    }
+
+    for (size_t attachmentIndex = 0; attachmentIndex < currentColors.size(); ++attachmentIndex)
+    {
+        if (!(previousColors[attachmentIndex].handle == currentColors[attachmentIndex].handle) ||
+            currentColors[attachmentIndex].loadOp != vk::AttachmentLoadOp::eLoad)
+        {
+            return false;
+        }
+    }
+
+    if (depthHandle.isValid() && currentPass.m_depthAttachment.loadOp != vk::AttachmentLoadOp::eLoad)
+    {
+        return false;
+    }
+
+    // 着色速率附件是 RenderingInfo 的一部分，挂起/恢复的各段必须一致
+    const RDGPass::ShadingRateAttachment &previousRate = previousPass.m_shadingRateAttachment;
+    const RDGPass::ShadingRateAttachment &currentRate = currentPass.m_shadingRateAttachment;
+    if (!(previousRate.handle == currentRate.handle) || previousRate.texelSize != currentRate.texelSize)
+    {
+        return false;
+    }
+
+    // 剩下的屏障只能是同一附件上布局不变的写后写依赖，渲染实例内由光栅化顺序保证
+    for (const RDGBarrier &barrier : current.getBarriers())
+    {
+        if (barrier.type != RDGBarrier::Image || barrier.oldLayout != barrier.newLayout ||
+            barrier.srcQueueFamily != barrier.dstQueueFamily)
+        {
+            return false;
+        }
+
+        bool isAttachment = depthHandle.isValid() && barrier.handle == depthHandle.handle;
+        for (const auto &colorAttachment : currentColors)
+        {
+            isAttachment = isAttachment || barrier.handle == colorAttachment.handle.handle;
+        }
+        if (!isAttachment)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void RenderGraph::collectCompileStats()
+{
+    m_stats = RDGGraphStats{};
+    m_stats.declaredPasses = static_cast<uint32_t>(m_passes.size());
+    m_stats.submitBatches = static_cast<uint32_t>(m_submitBatches.size());
+    m_stats.dependencyEdges = static_cast<uint32_t>(m_passEdges.size());
+    m_stats.compileCacheHit = m_compileCacheHit;
+    for (const RDGSubmitBatch &batch : m_submitBatches)
+    {
+        m_stats.queueWaits += static_cast<uint32_t>(batch.waitBatches.size());
+    }
+
+    RDGBarrierStats &barrierStats = m_stats.barriers;
+    auto countBarriers = [&barrierStats](const std::vector<RDGBarrier> &barriers) {
+        for (const RDGBarrier &barrier : barriers)
+        {
+            if (barrier.type == RDGBarrier::Image)
+            {
+                ++barrierStats.imageBarriers;
+                barrierStats.layoutTransitions += barrier.oldLayout != barrier.newLayout ? 1 : 0;
+            }
+            else
+            {
+                ++barrierStats.bufferBarriers;
+            }
+        }
+    };
+
+    for (const RDGCompiledPass *compiledPass : m_compiledPasses)
+    {
+        if (!compiledPass->isActive())
+        {
+            ++m_stats.culledPasses;
+            continue;
+        }
+
+        ++m_stats.activePasses;
+        if (compiledPass->getQueue() == RDGQueueType::AsyncCompute)
+        {
+            ++m_stats.asyncComputePasses;
+        }
+        if (compiledPass->isGraphicsPass())
+        {
+            ++(compiledPass->beginsRendering() ? m_stats.renderingInstances : m_stats.mergedPasses);
+        }
+
+        countBarriers(compiledPass->getBarriers());
+        countBarriers(compiledPass->getReleaseBarriers());
+        barrierStats.queueReleases += static_cast<uint32_t>(compiledPass->getReleaseBarriers().size());
+        for (const RDGBarrier &barrier : compiledPass->getBarriers())
+        {
+            barrierStats.queueAcquires += barrier.srcQueueFamily != barrier.dstQueueFamily ? 1 : 0;
+        }
+    }
+
+    for (const RDGSplitBarrier &split : m_splitBarriers)
+    {
+        countBarriers(split.barriers);
+        barrierStats.splitBarriers += static_cast<uint32_t>(split.barriers.size());
+    }
+    barrierStats.splitEvents = static_cast<uint32_t>(m_splitBarriers.size());
+
+    for (const auto &[handle, resource] : m_textureResources)
+    {
+        m_stats.transientTextures += resource->isTransient() && resource->isUsed() ? 1 : 0;
+        m_stats.externalTextures += resource->isExternal() ? 1 : 0;
+    }
+    for (const auto &[handle, resource] : m_bufferResources)
+    {
+        m_stats.transientBuffers += resource->isTransient() && resource->isUsed() ? 1 : 0;
+        m_stats.externalBuffers += resource->isExternal() ? 1 : 0;
+    }
+}
+
+// ==================== 编译缓存辅助函数 ====================
+
+namespace
+{
+
+/**
+ * @brief 64位哈希组合（与 DescriptorLayoutCache 相同的黄金比例混合方式）
+ */
+inline void hashCombine(uint64_t &seed, uint64_t value)
+{
+    seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+} // namespace
+
+std::vector<uint64_t> RenderGraph::computeTopologyKey() const
+{
+    QTR_PROFILE_SCOPE("RenderGraph::computeTopologyKey");
+    std::vector<uint64_t> key;
+    // 键长与资源数、Pass数成正比：预留一次，避免逐帧反复扩容
+    key.reserve(16 + static_cast<size_t>(m_nextHandle) * 16 + m_passes.size() * 32);
+    auto append = [&key](uint64_t value) { key.push_back(value); };
+
+    append(m_passes.size());
+    append(m_nextHandle);
+
+    // 异步计算是否可用决定队列调度结果
+    append((m_asyncCompute && m_asyncCompute->isAvailable()) ? 1u : 0u);
+
+    // 是否放置拆分屏障
+    append(m_eventPool ? 1u : 0u);
+
+    // 局部读取决定输入附件纹理的布局与渲染实例内的屏障
+    append(m_localReadEnabled ? 1u : 0u);
+
+    // 按句柄顺序收集资源描述（句柄按声明顺序生成，顺序即拓扑的一部分）
+    for (RDGResourceHandle handle = kInvalidHandle + 1; handle <= m_nextHandle; ++handle)
+    {
+        RDGTextureResource *textureResource = m_textureResources.find(handle);
+        if (textureResource)
+        {
+            const RDGTextureResource &resource = *textureResource;
+            const RDGTextureDesc &desc = resource.getDesc();
+
+            append(static_cast<uint64_t>(RDGHandleType::Texture));
+            append(static_cast<uint64_t>(resource.getType()));
+            append(resource.isSwapChainImage() ? 1u : 0u);
+            append(static_cast<uint64_t>(desc.format));
+            append(desc.extent.width);
+            append(desc.extent.height);
+            append(desc.extent.depth);
+            append(static_cast<VkImageUsageFlags>(desc.usage));
+            append(desc.mipLevels);
+            append(desc.arrayLayers);
+            append(static_cast<uint64_t>(desc.samples));
+            append(static_cast<uint64_t>(desc.tiling));
+
+            // 外部资源的初始布局与导入前的访问阶段会影响屏障
+            append(static_cast<uint64_t>(m_textureLayouts.find(handle)));
+            append(static_cast<VkPipelineStageFlags2>(m_importStages.find(handle)));
+
+            // 呈现布局决定首次访问的源阶段与帧末的呈现转换
+            append(static_cast<uint64_t>(m_presentLayouts.find(handle)));
+            continue;
+        }
+
+        RDGBufferResource *bufferResource = m_bufferResources.find(handle);
+        if (bufferResource)
+        {
+            const RDGBufferResource &resource = *bufferResource;
+            const RDGBufferDesc &desc = resource.getDesc();
+
+            append(static_cast<uint64_t>(RDGHandleType::Buffer));
+            append(static_cast<uint64_t>(resource.getType()));
+            append(desc.size);
+            append(static_cast<VkBufferUsageFlags>(desc.usage));
+        }
+    }
+
+    // 收集每个Pass的访问列表
+    for (const auto &pass : m_passes)
+    {
+        append(pass->isAsyncCompute() ? 1u : 0u);
+        // 并行录制影响统计的放置与渲染实例的合并
+        append(pass->isParallel() ? 1u : 0u);
+
+        append(pass->getTextureReads().size());
+        for (const auto &access : pass->getTextureReads())
+        {
+            append(access.handle.handle);
+            append(static_cast<VkPipelineStageFlags>(access.stages));
+            append(static_cast<VkAccessFlags>(access.access));
+            append(static_cast<uint64_t>(access.layout));
+        }
+
+        append(pass->getBufferReads().size());
+        for (const auto &access : pass->getBufferReads())
+        {
+            append(access.handle.handle);
+            append(static_cast<VkPipelineStageFlags>(access.stages));
+            append(static_cast<VkAccessFlags>(access.access));
+        }
+
+        append(pass->getColorAttachments().size());
+        for (const auto &attachment : pass->getColorAttachments())
+        {
+            append(attachment.handle.handle);
+            append(static_cast<uint64_t>(attachment.loadOp));
+            append(static_cast<uint64_t>(attachment.storeOp));
+        }
+
+        append(pass->getDepthAttachment().handle.handle);
+        append(static_cast<uint64_t>(pass->getDepthAttachment().loadOp));
+        append(static_cast<uint64_t>(pass->getDepthAttachment().storeOp));
+        append(pass->getShadingRateAttachment().handle.handle);
+        append(pass->getShadingRateAttachment().texelSize.width);
+        append(pass->getShadingRateAttachment().texelSize.height);
+
+        append(pass->getTextureWrites().size());
+        for (const auto &access : pass->getTextureWrites())
+        {
+            append(access.handle.handle);
+            append(static_cast<VkPipelineStageFlags>(access.stages));
+            append(static_cast<VkAccessFlags>(access.access));
+        }
+
+        append(pass->getBufferWrites().size());
+        for (const auto &access : pass->getBufferWrites())
+        {
+            append(access.handle.handle);
+            append(static_cast<VkPipelineStageFlags>(access.stages));
+            append(static_cast<VkAccessFlags>(access.access));
+        }
+    }
+
+    return key;
+}
+
+uint64_t RenderGraph::hashTopologyKey(const std::vector<uint64_t> &key)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (uint64_t value : key)
+    {
+        hashCombine(hash, value);
+    }
+    return hash;
+}
+
+void RenderGraph::restoreFromCache(const RDGCachedGraph &cached)
+{
+    // 重建编译Pass列表（指向本帧的RDGPass对象，回调与外部资源均为本帧数据）
+    m_compiledPasses.clear();
+    m_compiledPasses.reserve(m_passes.size());
+
+    for (size_t i = 0; i < m_passes.size(); ++i)
+    {
+        RDGCompiledPass *compiledPass = m_arena.create<RDGCompiledPass>(*m_passes[i], static_cast<uint32_t>(i));
+        compiledPass->setActive(cached.passActive[i] != 0);
+        compiledPass->setBarriers(cached.passBarriers[i]);
+        compiledPass->setReleaseBarriers(cached.passReleaseBarriers[i]);
+        compiledPass->setLocalReadBarriers(cached.passLocalReadBarriers[i]);
+        compiledPass->setQueue(cached.passQueues[i]);
+        compiledPass->setMergeRange(cached.passMergeHeads[i], cached.passMergeTails[i]);
+        m_compiledPasses.push_back(compiledPass);
+    }
+
+    m_submitBatches = cached.submitBatches;
+
+    m_splitBarriers = cached.splitBarriers;
+    for (size_t splitIndex = 0; splitIndex < m_splitBarriers.size(); ++splitIndex)
+    {
+        const RDGSplitBarrier &split = m_splitBarriers[splitIndex];
+        m_compiledPasses[split.producerPass]->addSplitSignal(static_cast<uint32_t>(splitIndex));
+        m_compiledPasses[split.consumerPass]->addSplitWait(static_cast<uint32_t>(splitIndex));
+    }
+
+    // 恢复生命周期
+    for (const auto &[handle, lifetime] : cached.textureLifetimes)
+    {
+        RDGTextureResource *textureResource = m_textureResources.find(handle);
+        if (textureResource)
+        {
+            textureResource->setLifetime(lifetime);
+        }
+    }
+
+    for (const auto &[handle, lifetime] : cached.bufferLifetimes)
+    {
+        RDGBufferResource *bufferResource = m_bufferResources.find(handle);
+        if (bufferResource)
+        {
+            bufferResource->setLifetime(lifetime);
+        }
+    }
+
+    // 恢复屏障计算之后的布局
+    m_textureLayouts = cached.finalLayouts;
+    m_localReadTextures = cached.localReadTextures;
+}
+
+void RenderGraph::storeToCache(RDGCachedGraph &cached) const
+{
+    cached.passActive.resize(m_compiledPasses.size());
+    cached.passBarriers.resize(m_compiledPasses.size());
+    cached.passReleaseBarriers.resize(m_compiledPasses.size());
+    cached.passLocalReadBarriers.resize(m_compiledPasses.size());
+    cached.passQueues.resize(m_compiledPasses.size());
+    cached.passMergeHeads.resize(m_compiledPasses.size());
+    cached.passMergeTails.resize(m_compiledPasses.size());
+
+    for (size_t i = 0; i < m_compiledPasses.size(); ++i)
+    {
+        cached.passActive[i] = m_compiledPasses[i]->isActive() ? 1 : 0;
+        cached.passBarriers[i] = m_compiledPasses[i]->getBarriers();
+        cached.passReleaseBarriers[i] = m_compiledPasses[i]->getReleaseBarriers();
+        cached.passLocalReadBarriers[i] = m_compiledPasses[i]->getLocalReadBarriers();
+        cached.passQueues[i] = m_compiledPasses[i]->getQueue();
+        cached.passMergeHeads[i] = m_compiledPasses[i]->getMergeHead();
+        cached.passMergeTails[i] = m_compiledPasses[i]->getMergeTail();
+    }
+
+    cached.submitBatches = m_submitBatches;
+    cached.splitBarriers = m_splitBarriers;
+
+    cached.textureLifetimes.clear();
+    for (const auto &[handle, resource] : m_textureResources)
+    {
+        cached.textureLifetimes[handle] = resource->getLifetime();
+    }
+
+    cached.bufferLifetimes.clear();
+    for (const auto &[handle, resource] : m_bufferResources)
+    {
+        cached.bufferLifetimes[handle] = resource->getLifetime();
+    }
+
+    cached.finalLayouts = m_textureLayouts;
+    cached.localReadTextures = m_localReadTextures;
+}
+
+// ==================== 验证辅助函数 ====================
+
+void RenderGraph::validateResourceStates() const
+{
+    QTR_PROFILE_SCOPE("RenderGraph::validateResourceStates");
+    QTR_LOG_DEBUG("RenderGraph", "验证资源状态...");
+
+    // 跟踪每个资源是否已被写入
+    RDGHandleTable<uint8_t> textureWritten;
+    RDGHandleTable<uint8_t> bufferWritten;
+
+    // 遍历所有活跃Pass
+    for (size_t passIndex = 0; passIndex < m_compiledPasses.size(); ++passIndex)
+    {
+        const auto &compiledPass = m_compiledPasses[passIndex];
+        if (!compiledPass->isActive())
+        {
+            continue;
+        }
+
+        const RDGPass *pass = compiledPass->getOriginalPass();
+
+        // 验证读取的纹理资源
+        for (const auto &textureRead : pass->m_textureReads)
+        {
+            RDGTextureResource *resource = m_textureResources.find(textureRead.handle.handle);
+            if (!resource)
+            {
+                throw std::runtime_error("RenderGraph::validateResourceStates: Pass '" + pass->getName() +
+                                         "' 尝试读取不存在的纹理资源");
+            }
+
+            // 外部资源不需要验证写入状态
+            if (resource->isExternal())
+            {
+                continue;
+            }
+
+            // 瞬态资源必须在读取前被写入
+            if (!textureWritten.find(textureRead.handle.handle))
+            {
+                QTR_LOG_WARN("RenderGraph", "Pass '" << pass->getName() << "' 读取了未被写入的纹理资源 '" << resource->getName()
+                                            << "'");
+            }
+        }
+
+        // 验证读取的缓冲区资源
+        for (const auto &bufferRead : pass->m_bufferReads)
+        {
+            RDGBufferResource *resource = m_bufferResources.find(bufferRead.handle.handle);
+            if (!resource)
+            {
+                throw std::runtime_error("RenderGraph::validateResourceStates: Pass '" + pass->getName() +
+                                         "' 尝试读取不存在的缓冲区资源");
+            }
+
+            // 外部资源不需要验证写入状态
+            if (resource->isExternal())
+            {
+                continue;
+            }
+
+            // 瞬态资源必须在读取前被写入
+            if (!bufferWritten.find(bufferRead.handle.handle))
+            {
+                QTR_LOG_WARN("RenderGraph", "Pass '" << pass->getName() << "' 读取了未被写入的缓冲区资源 '" << resource->getName()
+                                            << "'");
+            }
+        }
+
+        // 标记写入的纹理资源
+        for (const auto &colorAttachment : pass->m_colorAttachments)
+        {
+            textureWritten[colorAttachment.handle.handle] = 1;
+        }
+
+        if (pass->m_depthAttachment.handle.isValid())
+        {
+            textureWritten[pass->m_depthAttachment.handle.handle] = 1;
+        }
+
+        for (const auto &textureWrite : pass->m_textureWrites)
+        {
+            textureWritten[textureWrite.handle.handle] = 1;
+        }
+
+        // 标记写入的缓冲区资源
+        for (const auto &bufferWrite : pass->m_bufferWrites)
+        {
+            bufferWritten[bufferWrite.handle.handle] = 1;
+        }
+    }
+
+    QTR_LOG_DEBUG("RenderGraph", "资源状态验证完成");
+}
+
+// ==================== 资源分配辅助函数 ====================
+
+vkcore::Image *RenderGraph::allocateTransientTexture(RDGTextureResource &resource)
+{
+    const auto &desc = resource.getDesc();
+
+    // 创建ImageDesc
+    vkcore::ImageDesc imageDesc{};
+    imageDesc.format = desc.format;
+    imageDesc.extent = desc.extent;
+    imageDesc.usage = desc.usage;
+    imageDesc.mipLevels = desc.mipLevels;
+    imageDesc.arrayLayers = desc.arrayLayers;
+    imageDesc.samples = desc.samples;
+    imageDesc.tiling = desc.tiling;
+    imageDesc.category = vkcore::MemoryCategory::RDGTransient;
+
+    const vk::DeviceSize imageBytes = vkcore::Image::getMemoryRequirements(m_device, imageDesc).size;
+    m_stats.transientRequestedBytes += imageBytes;
+
+    // 尝试从池中复用资源（现在会自动检查规格匹配）
+    vkcore::Image *reusedImage = m_texturePool.tryAcquire(desc, resource.getLifetime());
+
+    if (reusedImage)
+    {
+        QTR_LOG_TRACE("RenderGraph", "复用纹理资源: " << desc.name << " (格式: " << vk::to_string(desc.format) << ", 尺寸: "
+                                     << desc.extent.width << "x" << desc.extent.height << ")");
+        return reusedImage;
+    }
+    m_stats.transientAllocatedBytes += imageBytes;
+
+    // 创建新的Image对象
+    auto image = std::make_unique<vkcore::Image>(desc.name, m_device, m_allocator, imageDesc);
+    QTR_LOG_DEBUG("RenderGraph", "创建新纹理资源: " << desc.name << " (格式: " << vk::to_string(desc.format) << ", 尺寸: "
+                                 << desc.extent.width << "x" << desc.extent.height << ")");
+
+    vkcore::Image *imagePtr = image.get();
+    m_frameTextures.push_back(std::move(image));
+
+    return imagePtr;
+}
+
+vkcore::Buffer *RenderGraph::allocateTransientBuffer(RDGBufferResource &resource)
+{
+    const auto &desc = resource.getDesc();
+
+    // 创建BufferDesc
+    vkcore::BufferDesc bufferDesc{};
+    bufferDesc.size = desc.size;
+    bufferDesc.usageFlags = desc.usage;
+    bufferDesc.category = vkcore::MemoryCategory::RDGTransient;
+
+    const vk::DeviceSize bufferBytes = vkcore::Buffer::getMemoryRequirements(m_device, bufferDesc).size;
+    m_stats.transientRequestedBytes += bufferBytes;
+
+    // 尝试从池中复用资源（现在会自动检查规格匹配）
+    vkcore::Buffer *reusedBuffer = m_bufferPool.tryAcquire(desc, resource.getLifetime());
+
+    if (reusedBuffer)
+    {
+        QTR_LOG_TRACE("RenderGraph", "复用缓冲区资源: " << desc.name << " (大小: " << desc.size << " 字节)");
+        return reusedBuffer;
+    }
+    m_stats.transientAllocatedBytes += bufferBytes;
+
+    // 创建新的Buffer对象
+    auto buffer = std::make_unique<vkcore::Buffer>(desc.name, m_device, m_allocator, bufferDesc);
+    QTR_LOG_DEBUG("RenderGraph", "创建新缓冲区资源: " << desc.name << " (大小: " << desc.size << " 字节)");
+
+    vkcore::Buffer *bufferPtr = buffer.get();
+    m_frameBuffers.push_back(std::move(buffer));
+
+    return bufferPtr;
+}
+
+void RenderGraph::releaseFrameResources()
+{
+    QTR_PROFILE_SCOPE("RenderGraph::releaseFrameResources");
+    // 有延迟销毁队列时在当前帧退休后销毁，否则立即销毁（调用者需自行保证GPU已用完）
+    if (m_deletionQueue)
+    {
+        for (auto &image : m_frameTextures)
+        {
+            m_deletionQueue->destroy(std::move(image));
+        }
+        for (auto &buffer : m_frameBuffers)
+        {
+            m_deletionQueue->destroy(std::move(buffer));
+        }
+    }
+    m_frameTextures.clear();
+    m_frameBuffers.clear();
+}
+
+// ==================== 屏障计算辅助函数 ====================
+
+void RenderGraph::collectLocalReadTextures()
+{
+    m_localReadTextures = RDGHandleTable<uint8_t>{};
+    for (const auto &compiledPass : m_compiledPasses)
+    {
+        if (!compiledPass->isActive())
+        {
+            continue;
+        }
+
+        const RDGPass *pass = compiledPass->getOriginalPass();
+        for (const auto &textureRead : pass->m_textureReads)
+        {
+            if (textureRead.layout != vk::ImageLayout::eRenderingLocalReadKHR)
+            {
+                continue;
+            }
+            if (!m_localReadEnabled)
+            {
+                throw std::runtime_error("RenderGraph: Pass '" + pass->getName() +
+                                         "' reads an input attachment but VK_KHR_dynamic_rendering_local_read "
+                                         "is not enabled");
+            }
+
+            // 局部读取只能读渲染实例中绑定的颜色附件
+            bool isColorAttachment = false;
+            for (const auto &colorAttachment : pass->m_colorAttachments)
+            {
+                isColorAttachment = isColorAttachment || colorAttachment.handle == textureRead.handle;
+            }
+            if (!isColorAttachment)
+            {
+                throw std::runtime_error("RenderGraph: Pass '" + pass->getName() +
+                                         "' reads an input attachment that is not one of its color attachments");
+            }
+
+            m_localReadTextures[textureRead.handle.handle] = 1;
+        }
+    }
+}
+
+vk::ImageLayout RenderGraph::getColorAttachmentLayout(RDGResourceHandle handle) const
+{
+    return m_localReadTextures.find(handle) != 0 ? vk::ImageLayout::eRenderingLocalReadKHR
+                                                 : vk::ImageLayout::eColorAttachmentOptimal;
+}
+
+vk::ImageLayout RenderGraph::computeImageLayout(RDGTextureHandle handle, const RDGPass::TextureAccess &access) const
+{
+    // 禁用未使用参数警告 - handle保留用于未来扩展
+    (void)handle;
+
+    // 根据访问类型推断图像布局
+    if (access.access & vk::AccessFlagBits::eColorAttachmentWrite)
+    {
+        return vk::ImageLayout::eColorAttachmentOptimal;
+    }
+    else if (access.access & vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+    {
+        return vk::ImageLayout::eDepthStencilAttachmentOptimal;
+    }
+    else if (access.access & vk::AccessFlagBits::eShaderRead)
+    {
+        return vk::ImageLayout::eShaderReadOnlyOptimal;
+    }
+    else if (access.access & vk::AccessFlagBits::eShaderWrite)
+    {
+        return vk::ImageLayout::eGeneral;
+    }
+    else if (access.access & vk::AccessFlagBits::eTransferRead)
+    {
+        return vk::ImageLayout::eTransferSrcOptimal;
+    }
+    else if (access.access & vk::AccessFlagBits::eTransferWrite)
+    {
+        return vk::ImageLayout::eTransferDstOptimal;
+    }
+
+    return vk::ImageLayout::eGeneral;
 }
 
 void RenderGraph::addImageBarrier(RDGCompiledPass &pass, RDGTextureHandle handle, vk::ImageLayout oldLayout,
-                                  vk::ImageLayout newLayout, vk::AccessFlags srcAccess, vk::AccessFlags dstAccess,
-                                  vk::PipelineStageFlags srcStages, vk::PipelineStageFlags dstStages)
+                                  vk::ImageLayout newLayout, vk::AccessFlags2 srcAccess, vk::AccessFlags2 dstAccess,
+                                  vk::PipelineStageFlags2 srcStages, vk::PipelineStageFlags2 dstStages,
+                                  uint32_t producerPass)
 {
     RDGBarrier barrier{};
     barrier.type = RDGBarrier::Image;
@@ -1192,10 +2222,10 @@ void RenderGraph::addImageBarrier(RDGCompiledPass &pass, RDGTextureHandle handle
     barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
 
     // 处理深度格式
-    auto it = m_textureResources.find(handle.handle);
-    if (it != m_textureResources.end())
+    RDGTextureResource *textureResource = m_textureResources.find(handle.handle);
+    if (textureResource)
     {
-        vk::Format format = it->second->getDesc().format;
+        vk::Format format = textureResource->getDesc().format;
         if (format == vk::Format::eD16Unorm || format == vk::Format::eD32Sfloat ||
             format == vk::Format::eD16UnormS8Uint || format == vk::Format::eD24UnormS8Uint ||
             format == vk::Format::eD32SfloatS8Uint)
@@ -1209,12 +2239,12 @@ void RenderGraph::addImageBarrier(RDGCompiledPass &pass, RDGTextureHandle handle
         }
     }
 
-    pass.addBarrier(barrier);
+    pushBarrier(pass, barrier, producerPass);
 }
 
-void RenderGraph::addBufferBarrier(RDGCompiledPass &pass, RDGBufferHandle handle, vk::AccessFlags srcAccess,
-                                   vk::AccessFlags dstAccess, vk::PipelineStageFlags srcStages,
-                                   vk::PipelineStageFlags dstStages)
+void RenderGraph::addBufferBarrier(RDGCompiledPass &pass, RDGBufferHandle handle, vk::AccessFlags2 srcAccess,
+                                   vk::AccessFlags2 dstAccess, vk::PipelineStageFlags2 srcStages,
+                                   vk::PipelineStageFlags2 dstStages, uint32_t producerPass)
 {
     RDGBarrier barrier{};
     barrier.type = RDGBarrier::Buffer;
@@ -1224,121 +2254,750 @@ void RenderGraph::addBufferBarrier(RDGCompiledPass &pass, RDGBufferHandle handle
     barrier.srcAccess = srcAccess;
     barrier.dstAccess = dstAccess;
 
-    pass.addBarrier(barrier);
+    pushBarrier(pass, barrier, producerPass);
+}
+
+void RenderGraph::pushBarrier(RDGCompiledPass &pass, RDGBarrier barrier, uint32_t producerPass)
+{
+    barrier.producerPass = producerPass;
+
+    if (producerPass == kInvalidPassIndex || m_compiledPasses[producerPass]->getQueue() == pass.getQueue())
+    {
+        pass.addBarrier(barrier);
+        return;
+    }
+
+    RDGCompiledPass &producer = *m_compiledPasses[producerPass];
+    barrier.srcQueueFamily = getQueueFamily(producer.getQueue());
+    barrier.dstQueueFamily = getQueueFamily(pass.getQueue());
+
+    // 释放：录制在生产者所在队列上，只包含源作用域
+    RDGBarrier release = barrier;
+    release.dstStages = vk::PipelineStageFlagBits2::eNone;
+    release.dstAccess = vk::AccessFlagBits2::eNone;
+    producer.addReleaseBarrier(release);
+
+    // 获取：录制在消费者所在队列上，只包含目标作用域（执行依赖由跨队列信号量保证）
+    RDGBarrier acquire = barrier;
+    acquire.srcStages = vk::PipelineStageFlagBits2::eNone;
+    acquire.srcAccess = vk::AccessFlagBits2::eNone;
+    pass.addBarrier(acquire);
+
+    m_queueDependencies.push_back({producerPass, pass.getIndex(), barrier.dstStages});
+}
+
+uint32_t RenderGraph::getQueueFamily(RDGQueueType queue) const
+{
+    return queue == RDGQueueType::AsyncCompute ? m_device.getComputeQueueFamilyIndices()
+                                               : m_device.getGraphicsQueueFamilyIndices();
+}
+
+// ==================== 执行辅助函数 ====================
+
+void RenderGraph::executeBarriers(vk::CommandBuffer cmd, const std::vector<RDGBarrier> &barriers) const
+{
+    if (barriers.empty())
+    {
+        return;
+    }
+
+    std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+    std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+    vk::DependencyInfo dependencyInfo{};
+
+    // 所有资源的屏障合并为一次调用，每个资源保留各自的源/目标阶段
+    if (buildDependencyInfo(barriers, imageBarriers, bufferBarriers, dependencyInfo))
+    {
+        cmd.pipelineBarrier2(dependencyInfo);
+    }
+}
+
+bool RenderGraph::buildDependencyInfo(const std::vector<RDGBarrier> &barriers,
+                                      std::vector<vk::ImageMemoryBarrier2> &imageBarriers,
+                                      std::vector<vk::BufferMemoryBarrier2> &bufferBarriers,
+                                      vk::DependencyInfo &dependencyInfo) const
+{
+    imageBarriers.clear();
+    bufferBarriers.clear();
+
+    // 收集所有屏障
+    for (const auto &barrier : barriers)
+    {
+        if (barrier.type == RDGBarrier::Image)
+        {
+            RDGTextureResource *textureResource = m_textureResources.find(barrier.handle);
+            if (textureResource)
+            {
+                // 交换链图像没有 vkcore::Image，句柄由交换链给出
+                vk::Image image = getTextureImage(barrier.handle);
+                if (image)
+                {
+                    vk::ImageMemoryBarrier2 imageBarrier{};
+                    imageBarrier.srcStageMask = barrier.srcStages;
+                    imageBarrier.srcAccessMask = barrier.srcAccess;
+                    imageBarrier.dstStageMask = barrier.dstStages;
+                    imageBarrier.dstAccessMask = barrier.dstAccess;
+                    imageBarrier.oldLayout = barrier.oldLayout;
+                    imageBarrier.newLayout = barrier.newLayout;
+                    imageBarrier.srcQueueFamilyIndex = barrier.srcQueueFamily;
+                    imageBarrier.dstQueueFamilyIndex = barrier.dstQueueFamily;
+                    imageBarrier.image = image;
+                    imageBarrier.subresourceRange = barrier.subresourceRange;
+
+                    imageBarriers.push_back(imageBarrier);
+                }
+            }
+        }
+        else if (barrier.type == RDGBarrier::Buffer)
+        {
+            RDGBufferResource *bufferResource = m_bufferResources.find(barrier.handle);
+            if (bufferResource)
+            {
+                vkcore::Buffer *buffer = bufferResource->getPhysicalBuffer();
+                if (buffer)
+                {
+                    vk::BufferMemoryBarrier2 bufferBarrier{};
+                    bufferBarrier.srcStageMask = barrier.srcStages;
+                    bufferBarrier.srcAccessMask = barrier.srcAccess;
+                    bufferBarrier.dstStageMask = barrier.dstStages;
+                    bufferBarrier.dstAccessMask = barrier.dstAccess;
+                    bufferBarrier.srcQueueFamilyIndex = barrier.srcQueueFamily;
+                    bufferBarrier.dstQueueFamilyIndex = barrier.dstQueueFamily;
+                    bufferBarrier.buffer = buffer->get();
+                    bufferBarrier.offset = 0;
+                    bufferBarrier.size = VK_WHOLE_SIZE;
+
+                    bufferBarriers.push_back(bufferBarrier);
+                }
+            }
+        }
+    }
+
+    dependencyInfo = vk::DependencyInfo{};
+    dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size());
+    dependencyInfo.pImageMemoryBarriers = imageBarriers.data();
+    dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferBarriers.size());
+    dependencyInfo.pBufferMemoryBarriers = bufferBarriers.data();
+
+    return !imageBarriers.empty() || !bufferBarriers.empty();
+}
+
+void RenderGraph::recordPassesSerial(std::vector<std::vector<vkcore::CommandBufferHandle>> &batchBuffers)
+{
+    QTR_PROFILE_SCOPE("RenderGraph::recordPassesSerial");
+    batchBuffers.resize(m_submitBatches.size());
+
+    for (size_t batchIndex = 0; batchIndex < m_submitBatches.size(); ++batchIndex)
+    {
+        const RDGSubmitBatch &batch = m_submitBatches[batchIndex];
+        if (batch.passIndices.empty())
+        {
+            continue;
+        }
+
+        // 获取命令缓冲区（命令池必须属于批次所在的队列族）
+        batchBuffers[batchIndex].push_back(getCommandManager(batch.queue).allocate(vk::CommandBufferLevel::ePrimary));
+        vk::CommandBuffer cmdBuffer = *batchBuffers[batchIndex].back();
+
+        // 开始录制命令缓冲区
+        vk::CommandBufferBeginInfo beginInfo{};
+        beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+        cmdBuffer.begin(beginInfo);
+
+        // 执行批次内的Pass（并行Pass的各块在同一命令缓冲区内依次录制）
+        for (uint32_t passIndex : batch.passIndices)
+        {
+            recordPass(cmdBuffer, passIndex, {}, false);
+        }
+
+        // 结束命令缓冲区录制
+        cmdBuffer.end();
+    }
+}
+
+void RenderGraph::recordPassesParallel(std::vector<std::vector<vkcore::CommandBufferHandle>> &batchBuffers,
+                                       std::vector<vkcore::CommandBufferHandle> &secondaryBuffers)
+{
+    QTR_PROFILE_SCOPE("RenderGraph::recordPassesParallel");
+    // 采样器是惰性创建的，必须在分发到工作线程之前创建好
+    if (!m_samplersCreated)
+    {
+        createSamplers();
+    }
+
+    // 收集活跃Pass以及需要拆分到次级命令缓冲区的块
+    struct ChunkJob
+    {
+        size_t passIndex;
+        uint32_t chunkIndex;
+    };
+
+    std::vector<size_t> activePasses; ///< 按批次顺序排列
+    std::vector<size_t> passBatches;  ///< 与 activePasses 对应的批次索引
+    std::vector<ChunkJob> chunkJobs;
+    std::unordered_map<size_t, size_t> firstChunkJob; ///< Pass索引 -> 首个块任务索引
+
+    for (size_t batchIndex = 0; batchIndex < m_submitBatches.size(); ++batchIndex)
+    {
+        for (uint32_t passIndex : m_submitBatches[batchIndex].passIndices)
+        {
+            activePasses.push_back(passIndex);
+            passBatches.push_back(batchIndex);
+        }
+    }
+
+    for (size_t passIndex : activePasses)
+    {
+        const auto &compiledPass = m_compiledPasses[passIndex];
+        const RDGPass *pass = compiledPass->getOriginalPass();
+        if (pass->isParallel() && pass->getChunkCount() > 1 && compiledPass->isGraphicsPass())
+        {
+            firstChunkJob[passIndex] = chunkJobs.size();
+            for (uint32_t chunk = 0; chunk < pass->getChunkCount(); ++chunk)
+            {
+                chunkJobs.push_back({passIndex, chunk});
+            }
+        }
+    }
+
+    // 阶段1：并行录制所有块的次级命令缓冲区（必须先于引用它们的主命令缓冲区完成）
+    std::vector<vkcore::CommandBufferHandle> secondaryHandles(chunkJobs.size());
+    m_workerPool->parallelFor(static_cast<uint32_t>(chunkJobs.size()), [&](uint32_t jobIndex) {
+        const ChunkJob &job = chunkJobs[jobIndex];
+        const RDGPass &pass = *m_compiledPasses[job.passIndex]->getOriginalPass();
+
+        // 在当前线程的命令池中分配
+        secondaryHandles[jobIndex] = m_commandManager.allocate(vk::CommandBufferLevel::eSecondary);
+        vk::CommandBuffer secondary = *secondaryHandles[jobIndex];
+
+        std::vector<vk::Format> colorFormats;
+        vk::Format depthFormat = vk::Format::eUndefined;
+        vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+        collectAttachmentFormats(pass, colorFormats, depthFormat, samples);
+
+        vk::CommandBufferInheritanceRenderingInfo renderingInheritance{};
+        renderingInheritance.colorAttachmentCount = static_cast<uint32_t>(colorFormats.size());
+        renderingInheritance.pColorAttachmentFormats = colorFormats.data();
+        renderingInheritance.depthAttachmentFormat = depthFormat;
+        renderingInheritance.rasterizationSamples = samples;
+
+        vk::CommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.pNext = &renderingInheritance;
+
+        vk::CommandBufferBeginInfo beginInfo{};
+        beginInfo.flags =
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        secondary.begin(beginInfo);
+        invokePassCallback(secondary, pass, job.chunkIndex, pass.getChunkCount());
+        secondary.end();
+    });
+
+    // 阶段2：每个活跃Pass并行录制到各自的主命令缓冲区，提交时按Pass顺序拼接
+    std::vector<vkcore::CommandBufferHandle> primaryHandles(activePasses.size());
+    m_workerPool->parallelFor(static_cast<uint32_t>(activePasses.size()), [&](uint32_t slot) {
+        size_t passIndex = activePasses[slot];
+
+        RDGQueueType queue = m_compiledPasses[passIndex]->getQueue();
+        primaryHandles[slot] = getCommandManager(queue).allocate(vk::CommandBufferLevel::ePrimary);
+        vk::CommandBuffer primary = *primaryHandles[slot];
+
+        std::vector<vk::CommandBuffer> secondaries;
+        auto chunkIt = firstChunkJob.find(passIndex);
+        if (chunkIt != firstChunkJob.end())
+        {
+            uint32_t chunkCount = m_compiledPasses[passIndex]->getOriginalPass()->getChunkCount();
+            for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                secondaries.push_back(*secondaryHandles[chunkIt->second + chunk]);
+            }
+        }
+
+        vk::CommandBufferBeginInfo beginInfo{};
+        beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+
+        primary.begin(beginInfo);
+        recordPass(primary, passIndex, secondaries, true);
+        primary.end();
+    });
+
+    // 按批次归组（activePasses 已按批次顺序排列，批次内保持Pass顺序）
+    batchBuffers.resize(m_submitBatches.size());
+    for (size_t slot = 0; slot < primaryHandles.size(); ++slot)
+    {
+        batchBuffers[passBatches[slot]].push_back(std::move(primaryHandles[slot]));
+    }
+    secondaryBuffers = std::move(secondaryHandles);
+}
+
+void RenderGraph::recordPresentTransitions(std::vector<std::vector<vkcore::CommandBufferHandle>> &batchBuffers)
+{
+    std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+    for (const auto &[handle, presentLayout] : m_presentLayouts)
+    {
+        // 本帧没有被任何Pass写入（布局仍未定义）的交换链图像保持原样
+        const vk::ImageLayout layout = m_textureLayouts.find(handle);
+        if (layout == vk::ImageLayout::eUndefined || layout == presentLayout)
+        {
+            continue;
+        }
+
+        // 呈现由最后一个批次触发的信号量排序，目标阶段为空
+        vk::ImageMemoryBarrier2 imageBarrier{};
+        imageBarrier.srcStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+        imageBarrier.srcAccessMask = vk::AccessFlagBits2::eMemoryWrite;
+        imageBarrier.dstStageMask = vk::PipelineStageFlagBits2::eNone;
+        imageBarrier.dstAccessMask = vk::AccessFlagBits2::eNone;
+        imageBarrier.oldLayout = layout;
+        imageBarrier.newLayout = presentLayout;
+        imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.image = getTextureImage(handle);
+        imageBarrier.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+        imageBarriers.push_back(imageBarrier);
+
+        m_textureLayouts[handle] = presentLayout;
+    }
+
+    if (imageBarriers.empty() || batchBuffers.empty())
+    {
+        return;
+    }
+
+    // 最后一个批次总是图形批次；单独一个主命令缓冲区，串行与并行录制路径相同
+    batchBuffers.back().push_back(m_commandManager.allocate(vk::CommandBufferLevel::ePrimary));
+    vk::CommandBuffer cmd = *batchBuffers.back().back();
+
+    vk::CommandBufferBeginInfo beginInfo{};
+    beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+    cmd.begin(beginInfo);
+
+    vk::DependencyInfo dependencyInfo{};
+    dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size());
+    dependencyInfo.pImageMemoryBarriers = imageBarriers.data();
+    cmd.pipelineBarrier2(dependencyInfo);
+
+    cmd.end();
+}
+
+void RenderGraph::submitBatches(const std::vector<std::vector<vkcore::CommandBufferHandle>> &batchBuffers,
+                                RDGSyncInfo *syncInfo)
+{
+    QTR_PROFILE_SCOPE("RenderGraph::submitBatches");
+    const size_t batchCount = m_submitBatches.size();
+
+    // 为每条跨队列等待取一个二进制信号量：生产者批次触发，消费者批次等待
+    std::vector<std::vector<vk::SemaphoreSubmitInfo>> signalSemaphores(batchCount);
+    std::vector<std::vector<vk::SemaphoreSubmitInfo>> waitSemaphores(batchCount);
+
+    for (size_t batchIndex = 0; batchIndex < batchCount; ++batchIndex)
+    {
+        const RDGSubmitBatch &batch = m_submitBatches[batchIndex];
+        for (size_t i = 0; i < batch.waitBatches.size(); ++i)
+        {
+            if (!m_asyncCompute)
+            {
+                throw std::runtime_error("RenderGraph::submitBatches: Cross-queue dependency without async context");
+            }
+
+            vk::Semaphore semaphore = m_asyncCompute->acquireSemaphore();
+
+            // 生产者批次在其全部命令完成后触发，消费者只阻塞真正依赖的阶段
+            vk::SemaphoreSubmitInfo signalInfo{};
+            signalInfo.semaphore = semaphore;
+            signalInfo.stageMask = vk::PipelineStageFlagBits2::eAllCommands;
+            signalSemaphores[batch.waitBatches[i]].push_back(signalInfo);
+
+            vk::SemaphoreSubmitInfo waitInfo{};
+            waitInfo.semaphore = semaphore;
+            waitInfo.stageMask = batch.waitStages[i];
+            waitSemaphores[batchIndex].push_back(waitInfo);
+        }
+    }
+
+    // 外部同步：等待加在第一个图形批次上，触发与Fence加在最后一个批次上（总是图形批次）
+    size_t firstGraphicsBatch = batchCount - 1;
+    for (size_t batchIndex = 0; batchIndex < batchCount; ++batchIndex)
+    {
+        if (m_submitBatches[batchIndex].queue == RDGQueueType::Graphics)
+        {
+            firstGraphicsBatch = batchIndex;
+            break;
+        }
+    }
+
+    if (syncInfo && !syncInfo->waitSemaphores.empty())
+    {
+        QTR_LOG_TRACE("RenderGraph", "等待 " << syncInfo->waitSemaphores.size() << " 个信号量");
+        for (const auto &waitInfo : syncInfo->waitSemaphores)
+        {
+            vk::SemaphoreSubmitInfo submitWait{};
+            submitWait.semaphore = waitInfo.semaphore;
+            submitWait.stageMask = toStages2(waitInfo.waitStage);
+            submitWait.value = waitInfo.value;
+            waitSemaphores[firstGraphicsBatch].push_back(submitWait);
+        }
+    }
+
+    if (syncInfo && !syncInfo->signalSemaphores.empty())
+    {
+        // 指定异步计算队列的触发加在最后一个计算批次上（例如计算队列的帧时间线）
+        size_t lastComputeBatch = batchCount - 1;
+        for (size_t batchIndex = 0; batchIndex < batchCount; ++batchIndex)
+        {
+            if (m_submitBatches[batchIndex].queue == RDGQueueType::AsyncCompute)
+            {
+                lastComputeBatch = batchIndex;
+            }
+        }
+
+        QTR_LOG_TRACE("RenderGraph", "触发 " << syncInfo->signalSemaphores.size() << " 个信号量");
+        for (const auto &signalInfo : syncInfo->signalSemaphores)
+        {
+            vk::SemaphoreSubmitInfo submitSignal{};
+            submitSignal.semaphore = signalInfo.semaphore;
+            submitSignal.stageMask = vk::PipelineStageFlagBits2::eAllCommands;
+            submitSignal.value = signalInfo.value;
+
+            size_t batchIndex = signalInfo.queue == RDGQueueType::AsyncCompute ? lastComputeBatch : batchCount - 1;
+            signalSemaphores[batchIndex].push_back(submitSignal);
+        }
+    }
+
+    // 获取 Fence（如果提供）
+    vk::Fence fence = (syncInfo && syncInfo->executionFence) ? syncInfo->executionFence.value() : vk::Fence{};
+
+    // 按批次顺序提交：生产者批次总是先于等待它的消费者批次提交
+    for (size_t batchIndex = 0; batchIndex < batchCount; ++batchIndex)
+    {
+        const RDGSubmitBatch &batch = m_submitBatches[batchIndex];
+
+        std::vector<vk::CommandBufferSubmitInfo> commandBuffers;
+        commandBuffers.reserve(batchBuffers[batchIndex].size());
+        for (const auto &handle : batchBuffers[batchIndex])
+        {
+            vk::CommandBufferSubmitInfo commandBufferInfo{};
+            commandBufferInfo.commandBuffer = *handle;
+            commandBuffers.push_back(commandBufferInfo);
+        }
+
+        vk::SubmitInfo2 submitInfo{};
+        submitInfo.commandBufferInfoCount = static_cast<uint32_t>(commandBuffers.size());
+        submitInfo.pCommandBufferInfos = commandBuffers.data();
+        submitInfo.waitSemaphoreInfoCount = static_cast<uint32_t>(waitSemaphores[batchIndex].size());
+        submitInfo.pWaitSemaphoreInfos = waitSemaphores[batchIndex].data();
+        submitInfo.signalSemaphoreInfoCount = static_cast<uint32_t>(signalSemaphores[batchIndex].size());
+        submitInfo.pSignalSemaphoreInfos = signalSemaphores[batchIndex].data();
+
+        bool isLast = batchIndex + 1 == batchCount;
+        vk::Queue queue =
+            batch.queue == RDGQueueType::AsyncCompute ? m_device.getComputeQueue() : m_device.getGraphicsQueue();
+
+        try
+        {
+            std::lock_guard<std::mutex> queueLock(m_device.getQueueMutex(queue));
+            queue.submit2(submitInfo, isLast ? fence : vk::Fence{});
+        }
+        catch (const vk::SystemError &e)
+        {
+            throw std::runtime_error("Failed to submit command buffer: " + std::string(e.what()));
+        }
+    }
+
+    QTR_LOG_TRACE("RenderGraph", "命令缓冲区已提交到GPU (" << batchCount << " 个批次)");
+    if (fence)
+    {
+        QTR_LOG_TRACE("RenderGraph", "已设置执行 Fence 用于同步");
+    }
+}
+
+vkcore::CommandPoolManager &RenderGraph::getCommandManager(RDGQueueType queue) const
+{
+    if (queue == RDGQueueType::AsyncCompute && m_asyncCompute)
+    {
+        return m_asyncCompute->getCommandManager();
+    }
+    return m_commandManager;
 }
 
-// ==================== 执行辅助函数 ====================
+void RenderGraph::recordPass(vk::CommandBuffer cmd, size_t passIndex, const std::vector<vk::CommandBuffer> &secondaries,
+                             bool ownCommandBuffer)
+{
+    QTR_PROFILE_SCOPE("RenderGraph::recordPass");
+    const auto &compiledPass = m_compiledPasses[passIndex];
+    const RDGPass *originalPass = compiledPass->getOriginalPass();
+    QTR_LOG_TRACE("RenderGraph", "执行Pass: " << originalPass->getName());
+
+    // 别名屏障：本Pass首次使用的瞬态资源与之前的资源共享内存。
+    // 渲染实例内不能插入屏障，合并块中各Pass需要的别名屏障统一在块开始前执行
+    bool aliasingBarrier = false;
+    if (compiledPass->beginsRendering())
+    {
+        for (size_t blockPass = passIndex; blockPass <= compiledPass->getMergeTail(); ++blockPass)
+        {
+            aliasingBarrier |= blockPass < m_aliasingBarrierPasses.size() && m_aliasingBarrierPasses[blockPass] &&
+                               m_compiledPasses[blockPass]->getMergeHead() == passIndex;
+        }
+    }
+    if (aliasingBarrier)
+    {
+        vk::MemoryBarrier2 aliasingBarrier{};
+        aliasingBarrier.srcStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+        aliasingBarrier.srcAccessMask = vk::AccessFlagBits2::eMemoryWrite;
+        aliasingBarrier.dstStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+        aliasingBarrier.dstAccessMask = vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite;
+
+        vk::DependencyInfo dependencyInfo{};
+        dependencyInfo.memoryBarrierCount = 1;
+        dependencyInfo.pMemoryBarriers = &aliasingBarrier;
+        cmd.pipelineBarrier2(dependencyInfo);
+    }
+
+    // 拆分屏障的等待端：事件在生产者Pass之后触发，等待后立即重置以便下一次复用
+    for (uint32_t splitIndex : compiledPass->getSplitWaits())
+    {
+        std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+        std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+        vk::DependencyInfo dependencyInfo{};
+        buildDependencyInfo(m_splitBarriers[splitIndex].barriers, imageBarriers, bufferBarriers, dependencyInfo);
+
+        vk::PipelineStageFlags2 waitStages{};
+        for (const auto &barrier : m_splitBarriers[splitIndex].barriers)
+        {
+            waitStages |= barrier.dstStages;
+        }
+
+        cmd.waitEvents2(m_splitEvents[splitIndex], dependencyInfo);
+        cmd.resetEvent2(m_splitEvents[splitIndex], waitStages);
+    }
+
+    // 执行屏障（在Pass开始前）
+    const auto &barriers = compiledPass->getBarriers();
+    if (!barriers.empty())
+    {
+        QTR_LOG_TRACE("RenderGraph", "执行 " << barriers.size() << " 个屏障");
+        executeBarriers(cmd, barriers);
+    }
+
+    // 合并块只在第一个Pass处开始计时、在最后一个Pass处结束计时
+    const uint32_t mergeHead = compiledPass->getMergeHead();
+    const uint32_t profileQuery = mergeHead < m_profileQueries.size() ? m_profileQueries[mergeHead] : UINT32_MAX;
+    if (profileQuery != UINT32_MAX && compiledPass->beginsRendering())
+    {
+        m_profiler->writeBegin(cmd, profileQuery);
+    }
+
+    // 如果是图形Pass，设置渲染状态。合并块在同一命令缓冲区内只开始一次渲染；
+    // 每个Pass独占命令缓冲区时改为挂起/恢复同一个渲染实例
+    bool renderingBegun = false;
+    if (compiledPass->isGraphicsPass())
+    {
+        vk::RenderingFlags renderingFlags{};
+        if (!secondaries.empty())
+        {
+            renderingFlags = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+        }
+        if (ownCommandBuffer && !compiledPass->beginsRendering())
+        {
+            renderingFlags |= vk::RenderingFlagBits::eResuming;
+        }
+        if (ownCommandBuffer && !compiledPass->endsRendering())
+        {
+            renderingFlags |= vk::RenderingFlagBits::eSuspending;
+        }
+
+        if (ownCommandBuffer || compiledPass->beginsRendering())
+        {
+            renderingBegun = beginGraphicsPass(cmd, *compiledPass, renderingFlags);
+        }
+        else
+        {
+            renderingBegun = true; // 延续前一个Pass开始的渲染实例
+        }
+
+        // 合并块内的局部读取：屏障两侧布局不变、只含帧缓冲空间阶段，必须是逐区域依赖
+        const auto &localReadBarriers = compiledPass->getLocalReadBarriers();
+        if (renderingBegun && !localReadBarriers.empty())
+        {
+            std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+            std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+            vk::DependencyInfo dependencyInfo{};
+            if (buildDependencyInfo(localReadBarriers, imageBarriers, bufferBarriers, dependencyInfo))
+            {
+                dependencyInfo.dependencyFlags = vk::DependencyFlagBits::eByRegion;
+                cmd.pipelineBarrier2(dependencyInfo);
+            }
+        }
+    }
+
+    if (!secondaries.empty())
+    {
+        // 块已在工作线程上录制完毕
+        if (renderingBegun)
+        {
+            cmd.executeCommands(secondaries);
+        }
+    }
+    else if (originalPass->isParallel())
+    {
+        // 未启用并行录制（或非图形Pass）：在当前命令缓冲区内依次录制所有块
+        for (uint32_t chunk = 0; chunk < originalPass->getChunkCount(); ++chunk)
+        {
+            invokePassCallback(cmd, *originalPass, chunk, originalPass->getChunkCount());
+        }
+    }
+    else
+    {
+        invokePassCallback(cmd, *originalPass, 0, 1);
+    }
 
-void RenderGraph::executeBarriers(vk::CommandBuffer cmd, const std::vector<RDGBarrier> &barriers)
-{
-    if (barriers.empty())
+    // 如果是图形Pass，结束（或挂起）渲染
+    if (renderingBegun && (ownCommandBuffer || compiledPass->endsRendering()))
     {
-        return;
+        endGraphicsPass(cmd);
     }
 
-    std::vector<vk::ImageMemoryBarrier> imageBarriers;
-    std::vector<vk::BufferMemoryBarrier> bufferBarriers;
+    if (profileQuery != UINT32_MAX && compiledPass->endsRendering())
+    {
+        m_profiler->writeEnd(cmd, profileQuery);
+    }
 
-    vk::PipelineStageFlags srcStages = vk::PipelineStageFlagBits::eNone;
-    vk::PipelineStageFlags dstStages = vk::PipelineStageFlagBits::eNone;
+    // 队列所有权释放（资源的下一次访问在另一条队列上）
+    executeBarriers(cmd, compiledPass->getReleaseBarriers());
 
-    // 收集所有屏障
-    for (const auto &barrier : barriers)
+    // 拆分屏障的触发端：setEvent2 与对应的 waitEvents2 必须使用相同的 DependencyInfo
+    for (uint32_t splitIndex : compiledPass->getSplitSignals())
     {
-        srcStages |= barrier.srcStages;
-        dstStages |= barrier.dstStages;
+        std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+        std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+        vk::DependencyInfo dependencyInfo{};
+        buildDependencyInfo(m_splitBarriers[splitIndex].barriers, imageBarriers, bufferBarriers, dependencyInfo);
 
-        if (barrier.type == RDGBarrier::Image)
+        cmd.setEvent2(m_splitEvents[splitIndex], dependencyInfo);
+    }
+}
+
+void RenderGraph::invokePassCallback(vk::CommandBuffer cmd, const RDGPass &pass, uint32_t chunkIndex,
+                                     uint32_t chunkCount)
+{
+    // 执行Pass的回调函数
+    try
+    {
+        if (pass.m_parallelCallback)
+        {
+            RDGResourceAccessor resourceAccessor(this);
+            pass.m_parallelCallback(cmd, resourceAccessor, chunkIndex, chunkCount);
+        }
+        else if (pass.m_useExtendedCallback)
         {
-            auto it = m_textureResources.find(barrier.handle);
-            if (it != m_textureResources.end())
+            // 使用扩展回调（带资源访问器）
+            if (pass.m_executeCallbackEx)
             {
-                vkcore::Image *image = it->second->getPhysicalImage();
-                if (image)
-                {
-                    vk::ImageMemoryBarrier imageBarrier{};
-                    imageBarrier.srcAccessMask = barrier.srcAccess;
-                    imageBarrier.dstAccessMask = barrier.dstAccess;
-                    imageBarrier.oldLayout = barrier.oldLayout;
-                    imageBarrier.newLayout = barrier.newLayout;
-                    imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-                    imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-                    imageBarrier.image = image->get();
-                    imageBarrier.subresourceRange = barrier.subresourceRange;
-
-                    imageBarriers.push_back(imageBarrier);
-                }
+                RDGResourceAccessor resourceAccessor(this);
+                pass.m_executeCallbackEx(cmd, resourceAccessor);
             }
         }
-        else if (barrier.type == RDGBarrier::Buffer)
+        else
         {
-            auto it = m_bufferResources.find(barrier.handle);
-            if (it != m_bufferResources.end())
+            // 使用简单回调
+            if (pass.m_executeCallback)
             {
-                vkcore::Buffer *buffer = it->second->getPhysicalBuffer();
-                if (buffer)
-                {
-                    vk::BufferMemoryBarrier bufferBarrier{};
-                    bufferBarrier.srcAccessMask = barrier.srcAccess;
-                    bufferBarrier.dstAccessMask = barrier.dstAccess;
-                    bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-                    bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-                    bufferBarrier.buffer = buffer->get();
-                    bufferBarrier.offset = 0;
-                    bufferBarrier.size = VK_WHOLE_SIZE;
-
-                    bufferBarriers.push_back(bufferBarrier);
-                }
+                pass.m_executeCallback(cmd);
             }
         }
     }
-
-    // 执行屏障
-    if (!imageBarriers.empty() || !bufferBarriers.empty())
+    catch (const std::exception &e)
     {
-        cmd.pipelineBarrier(srcStages, dstStages, vk::DependencyFlags{}, nullptr, bufferBarriers, imageBarriers);
+        QTR_LOG_ERROR("RenderGraph", "Pass执行失败: " << e.what());
+        // 继续执行其他Pass
     }
 }
 
-void RenderGraph::beginGraphicsPass(vk::CommandBuffer cmd, const RDGPass &pass)
+void RenderGraph::collectAttachmentFormats(const RDGPass &pass, std::vector<vk::Format> &colorFormats,
+                                           vk::Format &depthFormat, vk::SampleCountFlagBits &samples) const
 {
-    if (m_insideGraphicsPass)
+    for (const auto &colorAttachment : pass.m_colorAttachments)
+    {
+        RDGTextureResource *resource = m_textureResources.find(colorAttachment.handle.handle);
+        if (!resource)
+        {
+            continue;
+        }
+
+        if (resource->isSwapChainImage())
+        {
+            vkcore::SwapChain *swapChain = m_swapChainMapping.find(colorAttachment.handle.handle);
+            if (swapChain)
+            {
+                colorFormats.push_back(swapChain->getSwapchainFormat());
+            }
+            continue;
+        }
+
+        colorFormats.push_back(resource->getDesc().format);
+        samples = resource->getDesc().samples;
+    }
+
+    if (pass.m_depthAttachment.handle.isValid())
     {
-        throw std::runtime_error("RenderGraph::beginGraphicsPass: Already inside graphics pass");
+        RDGTextureResource *textureResource = m_textureResources.find(pass.m_depthAttachment.handle.handle);
+        if (textureResource)
+        {
+            depthFormat = textureResource->getDesc().format;
+            samples = textureResource->getDesc().samples;
+        }
     }
+}
+
+bool RenderGraph::beginGraphicsPass(vk::CommandBuffer cmd, const RDGCompiledPass &compiledPass,
+                                    vk::RenderingFlags flags) const
+{
+    // 合并块中的Pass附件集合相同：加载操作与清除值取自第一个Pass，存储操作取自最后一个Pass，
+    // 挂起/恢复的各段因此使用完全相同的 RenderingInfo
+    const uint32_t mergeHead = compiledPass.getMergeHead();
+    const uint32_t mergeTail = compiledPass.getMergeTail();
+    const RDGPass &pass = *compiledPass.getOriginalPass();
+    const RDGPass &loadPass = *m_compiledPasses[mergeHead]->getOriginalPass();
+    const RDGPass &storePass = *m_compiledPasses[mergeTail]->getOriginalPass();
 
     // 收集颜色附件
     std::vector<vk::RenderingAttachmentInfo> colorAttachments;
     colorAttachments.reserve(pass.m_colorAttachments.size());
 
-    for (const auto &colorAttachment : pass.m_colorAttachments)
+    for (size_t attachmentIndex = 0; attachmentIndex < pass.m_colorAttachments.size(); ++attachmentIndex)
     {
-        auto it = m_textureResources.find(colorAttachment.handle.handle);
-        if (it != m_textureResources.end())
+        const auto &colorAttachment = pass.m_colorAttachments[attachmentIndex];
+        const RDGResourceHandle handle = colorAttachment.handle.handle;
+        const vk::AttachmentLoadOp loadOp =
+            resolveLoadOp(handle, loadPass.m_colorAttachments[attachmentIndex].loadOp, mergeHead);
+        const vk::AttachmentStoreOp storeOp =
+            resolveStoreOp(handle, storePass.m_colorAttachments[attachmentIndex].storeOp, mergeTail);
+        const vk::ClearColorValue &clearValue = loadPass.m_colorAttachments[attachmentIndex].clearValue;
+
+        RDGTextureResource *resource = m_textureResources.find(handle);
+        if (resource)
         {
-            const auto &resource = it->second;
-
             // 检查是否是SwapChain图像
             if (resource->isSwapChainImage())
             {
-                auto swapChainIt = m_swapChainMapping.find(colorAttachment.handle.handle);
-                if (swapChainIt != m_swapChainMapping.end())
+                vkcore::SwapChain *swapChain = m_swapChainMapping.find(handle);
+                if (swapChain)
                 {
-                    vkcore::SwapChain *swapChain = swapChainIt->second;
                     uint32_t imageIndex = resource->getSwapChainImageIndex();
 
                     vk::RenderingAttachmentInfo attachmentInfo{};
                     attachmentInfo.imageView = swapChain->getImageView(imageIndex);
-                    attachmentInfo.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
-                    attachmentInfo.loadOp = colorAttachment.loadOp;
-                    attachmentInfo.storeOp = colorAttachment.storeOp;
-                    attachmentInfo.clearValue.color = colorAttachment.clearValue;
+                    attachmentInfo.imageLayout = getColorAttachmentLayout(handle);
+                    attachmentInfo.loadOp = loadOp;
+                    attachmentInfo.storeOp = storeOp;
+                    attachmentInfo.clearValue.color = clearValue;
 
                     colorAttachments.push_back(attachmentInfo);
                 }
                 else
                 {
-                    std::cerr << "警告: SwapChain图像缺少映射信息" << std::endl;
+                    QTR_LOG_WARN("RenderGraph", "SwapChain图像缺少映射信息");
                 }
                 continue;
             }
@@ -1349,10 +3008,10 @@ void RenderGraph::beginGraphicsPass(vk::CommandBuffer cmd, const RDGPass &pass)
             {
                 vk::RenderingAttachmentInfo attachmentInfo{};
                 attachmentInfo.imageView = image->getView();
-                attachmentInfo.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
-                attachmentInfo.loadOp = colorAttachment.loadOp;
-                attachmentInfo.storeOp = colorAttachment.storeOp;
-                attachmentInfo.clearValue.color = colorAttachment.clearValue;
+                attachmentInfo.imageLayout = getColorAttachmentLayout(handle);
+                attachmentInfo.loadOp = loadOp;
+                attachmentInfo.storeOp = storeOp;
+                attachmentInfo.clearValue.color = clearValue;
 
                 colorAttachments.push_back(attachmentInfo);
             }
@@ -1365,17 +3024,18 @@ void RenderGraph::beginGraphicsPass(vk::CommandBuffer cmd, const RDGPass &pass)
 
     if (pass.m_depthAttachment.handle.isValid())
     {
-        auto it = m_textureResources.find(pass.m_depthAttachment.handle.handle);
-        if (it != m_textureResources.end())
+        RDGTextureResource *textureResource = m_textureResources.find(pass.m_depthAttachment.handle.handle);
+        if (textureResource)
         {
-            vkcore::Image *image = it->second->getPhysicalImage();
+            vkcore::Image *image = textureResource->getPhysicalImage();
             if (image)
             {
                 depthAttachment.imageView = image->getView();
                 depthAttachment.imageLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
-                depthAttachment.loadOp = pass.m_depthAttachment.loadOp;
-                depthAttachment.storeOp = pass.m_depthAttachment.storeOp;
-                depthAttachment.clearValue.depthStencil = pass.m_depthAttachment.clearValue;
+                const RDGResourceHandle handle = pass.m_depthAttachment.handle.handle;
+                depthAttachment.loadOp = resolveLoadOp(handle, loadPass.m_depthAttachment.loadOp, mergeHead);
+                depthAttachment.storeOp = resolveStoreOp(handle, storePass.m_depthAttachment.storeOp, mergeTail);
+                depthAttachment.clearValue.depthStencil = loadPass.m_depthAttachment.clearValue;
                 hasDepthAttachment = true;
             }
         }
@@ -1386,18 +3046,16 @@ void RenderGraph::beginGraphicsPass(vk::CommandBuffer cmd, const RDGPass &pass)
 
     if (!pass.m_colorAttachments.empty())
     {
-        auto it = m_textureResources.find(pass.m_colorAttachments[0].handle.handle);
-        if (it != m_textureResources.end())
+        RDGTextureResource *resource = m_textureResources.find(pass.m_colorAttachments[0].handle.handle);
+        if (resource)
         {
-            const auto &resource = it->second;
-
             // 如果是SwapChain图像，从SwapChain获取尺寸
             if (resource->isSwapChainImage())
             {
-                auto swapChainIt = m_swapChainMapping.find(pass.m_colorAttachments[0].handle.handle);
-                if (swapChainIt != m_swapChainMapping.end())
+                vkcore::SwapChain *swapChain = m_swapChainMapping.find(pass.m_colorAttachments[0].handle.handle);
+                if (swapChain)
                 {
-                    renderArea = swapChainIt->second->getSwapchainExtent();
+                    renderArea = swapChain->getSwapchainExtent();
                 }
             }
             else
@@ -1409,10 +3067,10 @@ void RenderGraph::beginGraphicsPass(vk::CommandBuffer cmd, const RDGPass &pass)
     }
     else if (hasDepthAttachment)
     {
-        auto it = m_textureResources.find(pass.m_depthAttachment.handle.handle);
-        if (it != m_textureResources.end())
+        RDGTextureResource *textureResource = m_textureResources.find(pass.m_depthAttachment.handle.handle);
+        if (textureResource)
         {
-            const auto &extent = it->second->getDesc().extent;
+            const auto &extent = textureResource->getDesc().extent;
             renderArea = vk::Extent2D{extent.width, extent.height};
         }
     }
@@ -1421,6 +3079,7 @@ void RenderGraph::beginGraphicsPass(vk::CommandBuffer cmd, const RDGPass &pass)
     if (renderArea.width > 0 && renderArea.height > 0)
     {
         vk::RenderingInfo renderingInfo{};
+        renderingInfo.flags = flags;
         renderingInfo.renderArea = vk::Rect2D{{0, 0}, renderArea};
         renderingInfo.layerCount = 1;
         renderingInfo.colorAttachmentCount = static_cast<uint32_t>(colorAttachments.size());
@@ -1431,18 +3090,422 @@ void RenderGraph::beginGraphicsPass(vk::CommandBuffer cmd, const RDGPass &pass)
             renderingInfo.pDepthAttachment = &depthAttachment;
         }
 
+        // 着色速率附件（读取屏障已在 computeBarriers 中按纹理读取处理）
+        vk::RenderingFragmentShadingRateAttachmentInfoKHR shadingRateInfo{};
+        if (pass.m_shadingRateAttachment.handle.isValid())
+        {
+            RDGTextureResource *textureResource = m_textureResources.find(pass.m_shadingRateAttachment.handle.handle);
+            vkcore::Image *image = textureResource ? textureResource->getPhysicalImage() : nullptr;
+            if (image)
+            {
+                shadingRateInfo.imageView = image->getView();
+                shadingRateInfo.imageLayout = vk::ImageLayout::eFragmentShadingRateAttachmentOptimalKHR;
+                shadingRateInfo.shadingRateAttachmentTexelSize = pass.m_shadingRateAttachment.texelSize;
+                renderingInfo.pNext = &shadingRateInfo;
+            }
+        }
+
         cmd.beginRendering(renderingInfo);
-        m_insideGraphicsPass = true;
+        return true;
+    }
+
+    return false;
+}
+
+void RenderGraph::endGraphicsPass(vk::CommandBuffer cmd) const
+{
+    cmd.endRendering();
+}
+
+vk::AttachmentLoadOp RenderGraph::resolveLoadOp(RDGResourceHandle handle, vk::AttachmentLoadOp loadOp,
+                                                uint32_t firstPass) const
+{
+    // 渲染实例之前没有任何Pass使用过的瞬态附件内容未定义，加载它没有意义
+    RDGTextureResource *resource = m_textureResources.find(handle);
+    if (loadOp == vk::AttachmentLoadOp::eLoad && resource && resource->isTransient() &&
+        resource->getLifetime().firstPassIndex >= firstPass)
+    {
+        return vk::AttachmentLoadOp::eDontCare;
+    }
+    return loadOp;
+}
+
+vk::AttachmentStoreOp RenderGraph::resolveStoreOp(RDGResourceHandle handle, vk::AttachmentStoreOp storeOp,
+                                                  uint32_t lastPass) const
+{
+    // 渲染实例之后不再有Pass使用的瞬态附件：结果只在片上内存中存在，省去写回显存的带宽
+    RDGTextureResource *resource = m_textureResources.find(handle);
+    if (storeOp == vk::AttachmentStoreOp::eStore && resource && resource->isTransient() &&
+        resource->getLifetime().lastPassIndex <= lastPass)
+    {
+        return vk::AttachmentStoreOp::eDontCare;
+    }
+    return storeOp;
+}
+
+// ==================== 调试输出实现 ====================
+
+namespace
+{
+
+/**
+ * @brief 转义 JSON / dot 字符串中的引号与反斜杠
+ */
+std::string escapeString(const std::string &text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped.push_back('\\');
+        }
+        escaped.push_back(c);
+    }
+    return escaped;
+}
+
+const char *queueName(RDGQueueType queue)
+{
+    return queue == RDGQueueType::AsyncCompute ? "async_compute" : "graphics";
+}
+
+const char *edgeTypeName(RDGPassEdge::Type type)
+{
+    switch (type)
+    {
+    case RDGPassEdge::ReadAfterWrite:
+        return "RAW";
+    case RDGPassEdge::WriteAfterWrite:
+        return "WAW";
+    default:
+        return "WAR";
+    }
+}
+
+/**
+ * @brief 按声明顺序遍历Pass的资源访问（附件视为写入）
+ * @param callback (handle, isWrite)
+ */
+template <typename Callback> void forEachPassAccess(const RDGPass &pass, Callback &&callback)
+{
+    for (const auto &access : pass.getTextureReads())
+    {
+        callback(access.handle.handle, false);
+    }
+    for (const auto &access : pass.getBufferReads())
+    {
+        callback(access.handle.handle, false);
     }
+    for (const auto &access : pass.getTextureWrites())
+    {
+        callback(access.handle.handle, true);
+    }
+    for (const auto &access : pass.getBufferWrites())
+    {
+        callback(access.handle.handle, true);
+    }
+    for (const auto &attachment : pass.getColorAttachments())
+    {
+        callback(attachment.handle.handle, true);
+    }
+    if (pass.getDepthAttachment().handle.isValid())
+    {
+        callback(pass.getDepthAttachment().handle.handle, true);
+    }
+}
+
+} // namespace
+
+void RenderGraph::writeGraphviz(std::ostream &stream) const
+{
+    if (!m_compiled)
+    {
+        throw std::runtime_error("RenderGraph::writeGraphviz: Must compile before dumping");
+    }
+
+    std::vector<uint32_t> passBatches(m_compiledPasses.size(), UINT32_MAX);
+    for (size_t batchIndex = 0; batchIndex < m_submitBatches.size(); ++batchIndex)
+    {
+        for (uint32_t passIndex : m_submitBatches[batchIndex].passIndices)
+        {
+            passBatches[passIndex] = static_cast<uint32_t>(batchIndex);
+        }
+    }
+
+    stream << "digraph \"" << escapeString(m_debugName) << "\" {\n";
+    stream << "    rankdir=LR;\n";
+    stream << "    node [fontname=\"Helvetica\", fontsize=10];\n";
+
+    // Pass 节点：合并的渲染实例放进同一个子图
+    auto writePassNode = [&](const RDGCompiledPass &compiledPass, const char *indent) {
+        const uint32_t passIndex = compiledPass.getIndex();
+        size_t splitBarriers = 0;
+        for (uint32_t splitIndex : compiledPass.getSplitWaits())
+        {
+            splitBarriers += m_splitBarriers[splitIndex].barriers.size();
+        }
+
+        stream << indent << 'p' << passIndex << " [shape=box, label=\"#" << passIndex << ' '
+               << escapeString(compiledPass.getOriginalPass()->getName());
+        if (compiledPass.isActive())
+        {
+            stream << "\\nbatch " << passBatches[passIndex] << ", barriers " << compiledPass.getBarriers().size();
+            if (splitBarriers > 0)
+            {
+                stream << " + split " << splitBarriers;
+            }
+            if (!compiledPass.getReleaseBarriers().empty())
+            {
+                stream << ", release " << compiledPass.getReleaseBarriers().size();
+            }
+            const bool asyncCompute = compiledPass.getQueue() == RDGQueueType::AsyncCompute;
+            stream << "\", style=\"rounded,filled\", fillcolor=\"" << (asyncCompute ? "#fde2c4" : "#cfe2ff")
+                   << "\"];\n";
+        }
+        else
+        {
+            stream << "\\nculled\", style=\"rounded,dashed\", fontcolor=\"#888888\"];\n";
+        }
+    };
+
+    for (const RDGCompiledPass *compiledPass : m_compiledPasses)
+    {
+        const bool merged = compiledPass->isActive() && compiledPass->isGraphicsPass() &&
+                            compiledPass->getMergeHead() != compiledPass->getMergeTail();
+        if (!merged)
+        {
+            writePassNode(*compiledPass, "    ");
+        }
+        else if (compiledPass->beginsRendering())
+        {
+            stream << "    subgraph cluster_rendering_" << compiledPass->getIndex()
+                   << " {\n        label=\"merged rendering\";\n        style=dashed;\n";
+            for (uint32_t passIndex = compiledPass->getMergeHead(); passIndex <= compiledPass->getMergeTail();
+                 ++passIndex)
+            {
+                if (m_compiledPasses[passIndex]->getMergeHead() == compiledPass->getIndex())
+                {
+                    writePassNode(*m_compiledPasses[passIndex], "        ");
+                }
+            }
+            stream << "    }\n";
+        }
+    }
+
+    // 资源节点：标注规格与生命周期区间
+    for (const auto &[handle, resource] : m_textureResources)
+    {
+        const RDGTextureDesc &desc = resource->getDesc();
+        const RDGResourceLifetime &lifetime = resource->getLifetime();
+        stream << "    r" << handle << " [shape=ellipse, style=filled, fillcolor=\""
+               << (resource->isTransient() ? "#d9f2d0" : "#e8e8e8") << "\", label=\"" << escapeString(desc.name)
+               << "\\n" << vk::to_string(desc.format) << ' ' << desc.extent.width << 'x' << desc.extent.height;
+        if (lifetime.isUsed)
+        {
+            stream << "\\npasses " << lifetime.firstPassIndex << '-' << lifetime.lastPassIndex;
+        }
+        stream << "\"];\n";
+    }
+    for (const auto &[handle, resource] : m_bufferResources)
+    {
+        const RDGBufferDesc &desc = resource->getDesc();
+        const RDGResourceLifetime &lifetime = resource->getLifetime();
+        stream << "    r" << handle << " [shape=note, style=filled, fillcolor=\""
+               << (resource->isTransient() ? "#d9f2d0" : "#e8e8e8") << "\", label=\"" << escapeString(desc.name)
+               << "\\n" << desc.size << " B";
+        if (lifetime.isUsed)
+        {
+            stream << "\\npasses " << lifetime.firstPassIndex << '-' << lifetime.lastPassIndex;
+        }
+        stream << "\"];\n";
+    }
+
+    // 访问边：写入为 Pass -> 资源，读取为 资源 -> Pass
+    for (const RDGCompiledPass *compiledPass : m_compiledPasses)
+    {
+        const uint32_t passIndex = compiledPass->getIndex();
+        const char *style = compiledPass->isActive() ? "" : " [style=dashed, color=\"#aaaaaa\"]";
+        forEachPassAccess(*compiledPass->getOriginalPass(), [&](RDGResourceHandle handle, bool isWrite) {
+            if (isWrite)
+            {
+                stream << "    p" << passIndex << " -> r" << handle << style << ";\n";
+            }
+            else
+            {
+                stream << "    r" << handle << " -> p" << passIndex << style << ";\n";
+            }
+        });
+    }
+
+    // 跨队列等待：生产者批次的最后一个Pass -> 消费者批次的第一个Pass
+    for (const RDGSubmitBatch &batch : m_submitBatches)
+    {
+        for (uint32_t waitBatch : batch.waitBatches)
+        {
+            const RDGSubmitBatch &producer = m_submitBatches[waitBatch];
+            if (!producer.passIndices.empty() && !batch.passIndices.empty())
+            {
+                stream << "    p" << producer.passIndices.back() << " -> p" << batch.passIndices.front()
+                       << " [color=\"#d04040\", penwidth=2, label=\"semaphore\", fontsize=8];\n";
+            }
+        }
+    }
+
+    stream << "}\n";
 }
 
-void RenderGraph::endGraphicsPass(vk::CommandBuffer cmd)
+void RenderGraph::writeJson(std::ostream &stream) const
 {
-    if (m_insideGraphicsPass)
+    if (!m_compiled)
+    {
+        throw std::runtime_error("RenderGraph::writeJson: Must compile before dumping");
+    }
+
+    const RDGBarrierStats &barriers = m_stats.barriers;
+    stream << "{\n  \"name\": \"" << escapeString(m_debugName) << "\",\n";
+    stream << "  \"stats\": {\"declaredPasses\": " << m_stats.declaredPasses
+           << ", \"activePasses\": " << m_stats.activePasses << ", \"culledPasses\": " << m_stats.culledPasses
+           << ", \"mergedPasses\": " << m_stats.mergedPasses << ", \"renderingInstances\": "
+           << m_stats.renderingInstances << ", \"asyncComputePasses\": " << m_stats.asyncComputePasses
+           << ", \"submitBatches\": " << m_stats.submitBatches << ", \"queueWaits\": " << m_stats.queueWaits
+           << ", \"dependencyEdges\": " << m_stats.dependencyEdges << ",\n";
+    stream << "    \"barriers\": {\"image\": " << barriers.imageBarriers << ", \"buffer\": " << barriers.bufferBarriers
+           << ", \"layoutTransitions\": " << barriers.layoutTransitions << ", \"queueReleases\": "
+           << barriers.queueReleases << ", \"queueAcquires\": " << barriers.queueAcquires
+           << ", \"split\": " << barriers.splitBarriers << ", \"splitEvents\": " << barriers.splitEvents
+           << ", \"aliasing\": " << barriers.aliasingBarriers << "},\n";
+    stream << "    \"transientTextures\": " << m_stats.transientTextures
+           << ", \"transientBuffers\": " << m_stats.transientBuffers
+           << ", \"externalTextures\": " << m_stats.externalTextures
+           << ", \"externalBuffers\": " << m_stats.externalBuffers
+           << ", \"transientRequestedBytes\": " << m_stats.transientRequestedBytes
+           << ", \"transientAllocatedBytes\": " << m_stats.transientAllocatedBytes
+           << ", \"lazyTextures\": " << m_stats.lazyTextures << ",\n";
+    stream << "    \"textureRequests\": " << m_stats.textureRequests << ", \"textureHits\": " << m_stats.textureHits
+           << ", \"bufferRequests\": " << m_stats.bufferRequests << ", \"bufferHits\": " << m_stats.bufferHits
+           << ", \"compileCacheHit\": " << (m_stats.compileCacheHit ? "true" : "false")
+           << ", \"compileMs\": " << m_stats.compileMs << ", \"allocateMs\": " << m_stats.allocateMs
+           << ", \"recordMs\": " << m_stats.recordMs << ", \"submitMs\": " << m_stats.submitMs << "},\n";
+
+    std::vector<uint32_t> passBatches(m_compiledPasses.size(), UINT32_MAX);
+    for (size_t batchIndex = 0; batchIndex < m_submitBatches.size(); ++batchIndex)
+    {
+        for (uint32_t passIndex : m_submitBatches[batchIndex].passIndices)
+        {
+            passBatches[passIndex] = static_cast<uint32_t>(batchIndex);
+        }
+    }
+
+    stream << "  \"passes\": [";
+    for (size_t passIndex = 0; passIndex < m_compiledPasses.size(); ++passIndex)
+    {
+        const RDGCompiledPass &compiledPass = *m_compiledPasses[passIndex];
+        stream << (passIndex == 0 ? "\n" : ",\n") << "    {\"index\": " << passIndex << ", \"name\": \""
+               << escapeString(compiledPass.getOriginalPass()->getName())
+               << "\", \"active\": " << (compiledPass.isActive() ? "true" : "false") << ", \"queue\": \""
+               << queueName(compiledPass.getQueue()) << "\", \"batch\": "
+               << (passBatches[passIndex] == UINT32_MAX ? -1 : static_cast<int64_t>(passBatches[passIndex]))
+               << ", \"mergeHead\": " << compiledPass.getMergeHead() << ", \"mergeTail\": "
+               << compiledPass.getMergeTail() << ", \"barriers\": " << compiledPass.getBarriers().size()
+               << ", \"releaseBarriers\": " << compiledPass.getReleaseBarriers().size()
+               << ", \"splitWaits\": " << compiledPass.getSplitWaits().size()
+               << ", \"splitSignals\": " << compiledPass.getSplitSignals().size();
+
+        std::vector<RDGResourceHandle> reads;
+        std::vector<RDGResourceHandle> writes;
+        forEachPassAccess(*compiledPass.getOriginalPass(), [&](RDGResourceHandle handle, bool isWrite) {
+            (isWrite ? writes : reads).push_back(handle);
+        });
+        auto writeHandles = [&stream](const char *key, const std::vector<RDGResourceHandle> &handles) {
+            stream << ", \"" << key << "\": [";
+            for (size_t i = 0; i < handles.size(); ++i)
+            {
+                stream << (i == 0 ? "" : ", ") << handles[i];
+            }
+            stream << ']';
+        };
+        writeHandles("reads", reads);
+        writeHandles("writes", writes);
+        stream << '}';
+    }
+    stream << "\n  ],\n";
+
+    // 资源：生命周期为 [firstPass, lastPass]（Pass索引），未使用的资源为 null
+    stream << "  \"resources\": [";
+    bool first = true;
+    auto writeLifetime = [&stream](const RDGResourceLifetime &lifetime) {
+        if (lifetime.isUsed)
+        {
+            stream << ", \"firstPass\": " << lifetime.firstPassIndex << ", \"lastPass\": " << lifetime.lastPassIndex;
+        }
+        else
+        {
+            stream << ", \"firstPass\": null, \"lastPass\": null";
+        }
+    };
+    for (const auto &[handle, resource] : m_textureResources)
+    {
+        const RDGTextureDesc &desc = resource->getDesc();
+        stream << (first ? "\n" : ",\n") << "    {\"handle\": " << handle << ", \"kind\": \"texture\", \"name\": \""
+               << escapeString(desc.name) << "\", \"transient\": " << (resource->isTransient() ? "true" : "false")
+               << ", \"format\": \"" << vk::to_string(desc.format) << "\", \"width\": " << desc.extent.width
+               << ", \"height\": " << desc.extent.height << ", \"depth\": " << desc.extent.depth
+               << ", \"mipLevels\": " << desc.mipLevels << ", \"arrayLayers\": " << desc.arrayLayers;
+        writeLifetime(resource->getLifetime());
+        stream << '}';
+        first = false;
+    }
+    for (const auto &[handle, resource] : m_bufferResources)
+    {
+        const RDGBufferDesc &desc = resource->getDesc();
+        stream << (first ? "\n" : ",\n") << "    {\"handle\": " << handle << ", \"kind\": \"buffer\", \"name\": \""
+               << escapeString(desc.name) << "\", \"transient\": " << (resource->isTransient() ? "true" : "false")
+               << ", \"size\": " << desc.size;
+        writeLifetime(resource->getLifetime());
+        stream << '}';
+        first = false;
+    }
+    stream << "\n  ],\n";
+
+    stream << "  \"batches\": [";
+    for (size_t batchIndex = 0; batchIndex < m_submitBatches.size(); ++batchIndex)
+    {
+        const RDGSubmitBatch &batch = m_submitBatches[batchIndex];
+        stream << (batchIndex == 0 ? "\n" : ",\n") << "    {\"queue\": \"" << queueName(batch.queue)
+               << "\", \"passes\": [";
+        for (size_t i = 0; i < batch.passIndices.size(); ++i)
+        {
+            stream << (i == 0 ? "" : ", ") << batch.passIndices[i];
+        }
+        stream << "], \"waits\": [";
+        for (size_t i = 0; i < batch.waitBatches.size(); ++i)
+        {
+            stream << (i == 0 ? "" : ", ") << batch.waitBatches[i];
+        }
+        stream << "]}";
+    }
+    stream << "\n  ],\n";
+
+    stream << "  \"splitBarriers\": [";
+    for (size_t splitIndex = 0; splitIndex < m_splitBarriers.size(); ++splitIndex)
     {
-        cmd.endRendering();
-        m_insideGraphicsPass = false;
+        const RDGSplitBarrier &split = m_splitBarriers[splitIndex];
+        stream << (splitIndex == 0 ? "\n" : ",\n") << "    {\"producer\": " << split.producerPass
+               << ", \"consumer\": " << split.consumerPass << ", \"barriers\": " << split.barriers.size() << '}';
     }
+    stream << "\n  ],\n";
+
+    stream << "  \"edges\": [";
+    for (size_t edgeIndex = 0; edgeIndex < m_passEdges.size(); ++edgeIndex)
+    {
+        const RDGPassEdge &edge = m_passEdges[edgeIndex];
+        stream << (edgeIndex == 0 ? "\n" : ",\n") << "    {\"producer\": " << edge.producerPass
+               << ", \"consumer\": " << edge.consumerPass << ", \"resource\": " << edge.resource << ", \"type\": \""
+               << edgeTypeName(edge.type) << "\"}";
+    }
+    stream << "\n  ]\n}\n";
 }
 
 // ==================== 资源访问接口实现 ====================
@@ -1454,13 +3517,31 @@ vkcore::Image *RenderGraph::getPhysicalTexture(RDGTextureHandle handle) const
         return nullptr;
     }
 
-    auto it = m_textureResources.find(handle.handle);
-    if (it == m_textureResources.end())
+    RDGTextureResource *textureResource = m_textureResources.find(handle.handle);
+    if (!textureResource)
+    {
+        return nullptr;
+    }
+
+    return textureResource->getPhysicalImage();
+}
+
+vk::Image RenderGraph::getTextureImage(RDGResourceHandle handle) const
+{
+    RDGTextureResource *textureResource = m_textureResources.find(handle);
+    if (!textureResource)
     {
         return nullptr;
     }
 
-    return it->second->getPhysicalImage();
+    if (textureResource->isSwapChainImage())
+    {
+        vkcore::SwapChain *swapChain = m_swapChainMapping.find(handle);
+        return swapChain ? swapChain->getImage(textureResource->getSwapChainImageIndex()) : vk::Image{};
+    }
+
+    vkcore::Image *image = textureResource->getPhysicalImage();
+    return image ? image->get() : vk::Image{};
 }
 
 vkcore::Buffer *RenderGraph::getPhysicalBuffer(RDGBufferHandle handle) const
@@ -1470,13 +3551,13 @@ vkcore::Buffer *RenderGraph::getPhysicalBuffer(RDGBufferHandle handle) const
         return nullptr;
     }
 
-    auto it = m_bufferResources.find(handle.handle);
-    if (it == m_bufferResources.end())
+    RDGBufferResource *bufferResource = m_bufferResources.find(handle.handle);
+    if (!bufferResource)
     {
         return nullptr;
     }
 
-    return it->second->getPhysicalBuffer();
+    return bufferResource->getPhysicalBuffer();
 }
 
 vk::ImageLayout RenderGraph::getTextureLayout(RDGTextureHandle handle) const
@@ -1486,13 +3567,7 @@ vk::ImageLayout RenderGraph::getTextureLayout(RDGTextureHandle handle) const
         return vk::ImageLayout::eUndefined;
     }
 
-    auto it = m_textureLayouts.find(handle.handle);
-    if (it == m_textureLayouts.end())
-    {
-        return vk::ImageLayout::eUndefined;
-    }
-
-    return it->second;
+    return m_textureLayouts.find(handle.handle);
 }
 
 vk::Sampler RenderGraph::getSampler(RDGSamplerType type) const
@@ -1523,6 +3598,12 @@ void RenderGraph::createSamplers()
 
     vk::Device device = m_device.get();
 
+    // 共享采样器缓存时只查询（句柄归缓存所有，每帧的渲染图与 ResourceManager 得到相同的句柄），否则自行创建
+    m_ownsSamplers = m_samplerCache == nullptr;
+    auto create = [&](const vk::SamplerCreateInfo &info) {
+        return m_samplerCache ? m_samplerCache->getOrCreate(info) : device.createSampler(info);
+    };
+
     // 基础采样器信息
     vk::SamplerCreateInfo samplerInfo{};
     samplerInfo.magFilter = vk::Filter::eLinear;
@@ -1550,13 +3631,13 @@ void RenderGraph::createSamplers()
         samplerInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
         samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
         samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
-        m_samplers[static_cast<size_t>(RDGSamplerType::NearestClamp)] = device.createSampler(samplerInfo);
+        m_samplers[static_cast<size_t>(RDGSamplerType::NearestClamp)] = create(samplerInfo);
 
         // NearestRepeat
         samplerInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
         samplerInfo.addressModeV = vk::SamplerAddressMode::eRepeat;
         samplerInfo.addressModeW = vk::SamplerAddressMode::eRepeat;
-        m_samplers[static_cast<size_t>(RDGSamplerType::NearestRepeat)] = device.createSampler(samplerInfo);
+        m_samplers[static_cast<size_t>(RDGSamplerType::NearestRepeat)] = create(samplerInfo);
 
         // LinearClamp
         samplerInfo.magFilter = vk::Filter::eLinear;
@@ -1564,13 +3645,13 @@ void RenderGraph::createSamplers()
         samplerInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
         samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
         samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
-        m_samplers[static_cast<size_t>(RDGSamplerType::LinearClamp)] = device.createSampler(samplerInfo);
+        m_samplers[static_cast<size_t>(RDGSamplerType::LinearClamp)] = create(samplerInfo);
 
         // LinearRepeat
         samplerInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
         samplerInfo.addressModeV = vk::SamplerAddressMode::eRepeat;
         samplerInfo.addressModeW = vk::SamplerAddressMode::eRepeat;
-        m_samplers[static_cast<size_t>(RDGSamplerType::LinearRepeat)] = device.createSampler(samplerInfo);
+        m_samplers[static_cast<size_t>(RDGSamplerType::LinearRepeat)] = create(samplerInfo);
 
         // AnisotropicClamp
         samplerInfo.anisotropyEnable = VK_TRUE;
@@ -1578,13 +3659,13 @@ void RenderGraph::createSamplers()
         samplerInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
         samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
         samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
-        m_samplers[static_cast<size_t>(RDGSamplerType::AnisotropicClamp)] = device.createSampler(samplerInfo);
+        m_samplers[static_cast<size_t>(RDGSamplerType::AnisotropicClamp)] = create(samplerInfo);
 
         // AnisotropicRepeat
         samplerInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
         samplerInfo.addressModeV = vk::SamplerAddressMode::eRepeat;
         samplerInfo.addressModeW = vk::SamplerAddressMode::eRepeat;
-        m_samplers[static_cast<size_t>(RDGSamplerType::AnisotropicRepeat)] = device.createSampler(samplerInfo);
+        m_samplers[static_cast<size_t>(RDGSamplerType::AnisotropicRepeat)] = create(samplerInfo);
 
         // ShadowPCF
         samplerInfo.anisotropyEnable = VK_FALSE;
@@ -1595,13 +3676,13 @@ void RenderGraph::createSamplers()
         samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToBorder;
         samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToBorder;
         samplerInfo.borderColor = vk::BorderColor::eFloatOpaqueWhite;
-        m_samplers[static_cast<size_t>(RDGSamplerType::ShadowPCF)] = device.createSampler(samplerInfo);
+        m_samplers[static_cast<size_t>(RDGSamplerType::ShadowPCF)] = create(samplerInfo);
 
         m_samplersCreated = true;
     }
-    catch (const vk::SystemError &e)
+    catch (const std::exception &e)
     {
-        std::cerr << "Failed to create samplers: " << e.what() << std::endl;
+        QTR_LOG_ERROR("RenderGraph", "Failed to create samplers: " << e.what());
         destroySamplers();
         throw;
     }
@@ -1618,7 +3699,7 @@ void RenderGraph::destroySamplers()
 
     for (auto sampler : m_samplers)
     {
-        if (sampler)
+        if (sampler && m_ownsSamplers)
         {
             device.destroySampler(sampler);
         }
@@ -6,14 +6,28 @@
 
 #pragma once
 
+#include "RDGArena.hpp"
+#include "RDGAsyncComputeContext.hpp"
+#include "RDGCompileCache.hpp"
+#include "RDGEventPool.hpp"
 #include "RDGHandle.hpp"
+#include "RDGHandleTable.hpp"
 #include "RDGPass.hpp"
+#include "RDGProfiler.hpp"
 #include "RDGResource.hpp"
 #include "RDGResourceAccessor.hpp"
+#include "RDGStats.hpp"
 #include "RDGSyncInfo.hpp"
+#include "RDGTransientAllocator.hpp"
+#include "VulkanCore/public/CommandPoolManager.hpp"
+#include "VulkanCore/public/DeferredDeletionQueue.hpp"
+#include "VulkanCore/public/SamplerCache.hpp"
+#include <algorithm>
 #include <array>
 #include <memory>
+#include <ostream>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 // 前向声明
@@ -22,8 +36,10 @@ namespace vkcore
 class Device;
 class CommandPoolManager;
 class SwapChain;
+class OffscreenSwapChain;
 class Image;
 class Buffer;
+class WorkerPool;
 } // namespace vkcore
 
 typedef struct VmaAllocator_T *VmaAllocator;
@@ -33,7 +49,7 @@ namespace rendercore
 
 /**
  * @struct RDGBarrier
- * @brief 屏障信息
+ * @brief 屏障信息（Synchronization2：每个资源携带各自的阶段掩码）
  */
 struct RDGBarrier
 {
@@ -43,15 +59,54 @@ struct RDGBarrier
         Buffer
     } type;
     RDGResourceHandle handle;
-    vk::PipelineStageFlags srcStages;
-    vk::PipelineStageFlags dstStages;
-    vk::AccessFlags srcAccess;
-    vk::AccessFlags dstAccess;
+    vk::PipelineStageFlags2 srcStages;
+    vk::PipelineStageFlags2 dstStages;
+    vk::AccessFlags2 srcAccess;
+    vk::AccessFlags2 dstAccess;
 
     // 仅对图像有效
     vk::ImageLayout oldLayout = vk::ImageLayout::eUndefined;
     vk::ImageLayout newLayout = vk::ImageLayout::eUndefined;
     vk::ImageSubresourceRange subresourceRange;
+
+    // 队列族所有权转移（释放/获取屏障成对出现，同队列内的屏障保持 IGNORED）
+    uint32_t srcQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+    uint32_t dstQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+
+    uint32_t producerPass = UINT32_MAX; ///< 源作用域中最后访问该资源的Pass（用于拆分屏障）
+};
+
+/**
+ * @struct RDGSplitBarrier
+ * @brief 拆分屏障：生产者Pass之后 setEvent2，消费者Pass之前 waitEvents2
+ * @details 同一队列上生产者与消费者之间还有其他Pass时，GPU 可以在等待之前继续执行这些Pass，
+ *          而不是在消费者处才从生产者的阶段开始排空流水线
+ */
+struct RDGSplitBarrier
+{
+    uint32_t producerPass;
+    uint32_t consumerPass;
+    std::vector<RDGBarrier> barriers; ///< 同一对Pass之间的所有屏障共用一个事件
+};
+
+/**
+ * @struct RDGPassEdge
+ * @brief 编译期建立的Pass依赖边（生产者 -> 消费者）
+ * @details 按声明顺序遍历一次访问列表，用每个资源的最后写者表得到：每次写入产生资源的新版本，
+ *          读取依赖当前版本的写者。剔除只沿写后读边和保留旧内容的写后写边反向遍历；
+ *          读后写边只约束执行顺序，供调度（Pass重排、异步计算划分）使用
+ */
+struct RDGPassEdge
+{
+    enum Type : uint8_t
+    {
+        ReadAfterWrite,  ///< 消费者读取生产者写入的版本
+        WriteAfterWrite, ///< 消费者在生产者的结果上继续写入（附件 eLoad 或存储写入）
+        WriteAfterRead   ///< 消费者覆盖生产者读取过的版本（仅排序约束）
+    } type;
+    uint32_t producerPass;
+    uint32_t consumerPass;
+    RDGResourceHandle resource;
 };
 
 /**
@@ -61,7 +116,8 @@ struct RDGBarrier
 class RDGCompiledPass
 {
   public:
-    RDGCompiledPass(const RDGPass &pass, uint32_t index) : m_originalPass(&pass), m_index(index), m_active(true)
+    RDGCompiledPass(const RDGPass &pass, uint32_t index)
+        : m_originalPass(&pass), m_index(index), m_active(true), m_mergeHead(index), m_mergeTail(index)
     {
     }
 
@@ -90,6 +146,67 @@ class RDGCompiledPass
     {
         m_barriers.push_back(barrier);
     }
+    void setBarriers(const std::vector<RDGBarrier> &barriers)
+    {
+        m_barriers = barriers;
+    }
+    void removeBarrier(RDGBarrier::Type type, RDGResourceHandle handle)
+    {
+        eraseBarrier(m_barriers, type, handle);
+    }
+
+    const std::vector<RDGBarrier> &getReleaseBarriers() const
+    {
+        return m_releaseBarriers;
+    }
+    void addReleaseBarrier(const RDGBarrier &barrier)
+    {
+        m_releaseBarriers.push_back(barrier);
+    }
+    void setReleaseBarriers(const std::vector<RDGBarrier> &barriers)
+    {
+        m_releaseBarriers = barriers;
+    }
+    void removeReleaseBarrier(RDGBarrier::Type type, RDGResourceHandle handle)
+    {
+        eraseBarrier(m_releaseBarriers, type, handle);
+    }
+
+    // 合并块内输入附件读取的逐区域屏障，在渲染实例内、Pass回调之前执行
+    const std::vector<RDGBarrier> &getLocalReadBarriers() const
+    {
+        return m_localReadBarriers;
+    }
+    void setLocalReadBarriers(const std::vector<RDGBarrier> &barriers)
+    {
+        m_localReadBarriers = barriers;
+    }
+
+    const std::vector<uint32_t> &getSplitSignals() const
+    {
+        return m_splitSignals;
+    }
+    void addSplitSignal(uint32_t splitIndex)
+    {
+        m_splitSignals.push_back(splitIndex);
+    }
+    const std::vector<uint32_t> &getSplitWaits() const
+    {
+        return m_splitWaits;
+    }
+    void addSplitWait(uint32_t splitIndex)
+    {
+        m_splitWaits.push_back(splitIndex);
+    }
+
+    RDGQueueType getQueue() const
+    {
+        return m_queue;
+    }
+    void setQueue(RDGQueueType queue)
+    {
+        m_queue = queue;
+    }
 
     bool isGraphicsPass() const
     {
@@ -100,11 +217,93 @@ class RDGCompiledPass
         return m_originalPass->isComputePass();
     }
 
+    // 渲染Pass合并：mergeHead 与 mergeTail 之间（按提交顺序）的Pass共用一个动态渲染实例
+    uint32_t getMergeHead() const
+    {
+        return m_mergeHead;
+    }
+    uint32_t getMergeTail() const
+    {
+        return m_mergeTail;
+    }
+    void setMergeRange(uint32_t head, uint32_t tail)
+    {
+        m_mergeHead = head;
+        m_mergeTail = tail;
+    }
+    bool beginsRendering() const
+    {
+        return m_mergeHead == m_index;
+    }
+    bool endsRendering() const
+    {
+        return m_mergeTail == m_index;
+    }
+
+  private:
+    static void eraseBarrier(std::vector<RDGBarrier> &barriers, RDGBarrier::Type type, RDGResourceHandle handle)
+    {
+        barriers.erase(std::remove_if(barriers.begin(), barriers.end(),
+                                      [&](const RDGBarrier &barrier) {
+                                          return barrier.type == type && barrier.handle == handle;
+                                      }),
+                       barriers.end());
+    }
+
   private:
     const RDGPass *m_originalPass;
     uint32_t m_index;
     bool m_active;
-    std::vector<RDGBarrier> m_barriers; ///< 此Pass执行前需要的屏障
+    RDGQueueType m_queue = RDGQueueType::Graphics; ///< 调度到的队列
+    std::vector<RDGBarrier> m_barriers;            ///< 此Pass执行前需要的屏障
+    std::vector<RDGBarrier> m_releaseBarriers;     ///< 此Pass执行后的队列所有权释放屏障
+    std::vector<RDGBarrier> m_localReadBarriers;   ///< 渲染实例内的局部读取屏障（仅合并块的后续Pass）
+    std::vector<uint32_t> m_splitSignals;          ///< 此Pass执行后触发的拆分屏障索引
+    std::vector<uint32_t> m_splitWaits;            ///< 此Pass执行前等待的拆分屏障索引
+    uint32_t m_mergeHead;                          ///< 所在渲染实例的第一个Pass（未合并时为自身）
+    uint32_t m_mergeTail;                          ///< 所在渲染实例的最后一个Pass（未合并时为自身）
+};
+
+/**
+ * @struct RDGSubmitBatch
+ * @brief 一次队列提交（同一队列上连续的若干活跃Pass）
+ * @details 批次在跨队列依赖处切分：有跨队列输入的Pass开启新批次，有跨队列输出的Pass结束当前批次，
+ *          使消费者只等待真正依赖的工作，而生产者完成后立即触发信号量
+ */
+struct RDGSubmitBatch
+{
+    RDGQueueType queue = RDGQueueType::Graphics;
+    std::vector<uint32_t> passIndices;              ///< 按顺序录制的Pass索引（可为空，用于汇合）
+    std::vector<uint32_t> waitBatches;               ///< 需要等待的前序批次（每个对应一个信号量）
+    std::vector<vk::PipelineStageFlags2> waitStages; ///< 与 waitBatches 一一对应的等待阶段
+};
+
+/**
+ * @struct RDGCachedGraph
+ * @brief 一个拓扑键对应的缓存编译结果
+ * @details 由 RDGCompileCache 持有，跨帧存活。句柄按声明顺序生成，
+ *          拓扑相同即句柄序列相同，因此可以直接按句柄复用
+ * @note 只缓存CPU侧编译结果，物理资源由 RDGTransientAllocator 跨帧持有
+ */
+struct RDGCachedGraph
+{
+    std::vector<uint8_t> passActive;                   ///< 每个Pass的剔除结果
+    std::vector<std::vector<RDGBarrier>> passBarriers; ///< 每个Pass执行前的屏障
+    std::vector<std::vector<RDGBarrier>> passReleaseBarriers; ///< 每个Pass执行后的所有权释放屏障
+    std::vector<std::vector<RDGBarrier>> passLocalReadBarriers; ///< 每个Pass渲染实例内的局部读取屏障
+    std::vector<RDGQueueType> passQueues;                     ///< 每个Pass调度到的队列
+    std::vector<uint32_t> passMergeHeads;                     ///< 每个Pass所在渲染实例的第一个Pass
+    std::vector<uint32_t> passMergeTails;                     ///< 每个Pass所在渲染实例的最后一个Pass
+    std::vector<RDGSubmitBatch> submitBatches;                ///< 按提交顺序排列的队列批次
+    std::vector<RDGSplitBarrier> splitBarriers;               ///< 拆分屏障（启用事件池时）
+
+    std::unordered_map<RDGResourceHandle, RDGResourceLifetime> textureLifetimes;
+    std::unordered_map<RDGResourceHandle, RDGResourceLifetime> bufferLifetimes;
+    RDGHandleTable<vk::ImageLayout> finalLayouts; ///< computeBarriers 之后的布局
+    RDGHandleTable<uint8_t> localReadTextures;    ///< 以输入附件读取的纹理
+
+    std::vector<uint64_t> topologyKey; ///< 完整拓扑键（哈希冲突时逐项比较）
+    uint64_t lastUsedFrame = 0;        ///< 用于LRU淘汰
 };
 
 /**
@@ -143,9 +342,11 @@ class RenderGraph
 
     /**
      * @brief 注册外部纹理资源
+     * @param lastStages 导入前（之前的帧或图外命令）最后访问该纹理的阶段，图内首次写入或布局转换等待它们
      */
     RDGTextureHandle registerExternalTexture(vkcore::Image *image, const std::string &name,
-                                             vk::ImageLayout currentLayout);
+                                             vk::ImageLayout currentLayout,
+                                             vk::PipelineStageFlags2 lastStages = vk::PipelineStageFlags2{});
 
     /**
      * @brief 注册外部缓冲区资源
@@ -157,6 +358,11 @@ class RenderGraph
      */
     RDGTextureHandle importSwapChainImage(vkcore::SwapChain &swapChain, uint32_t imageIndex);
 
+    /**
+     * @brief 导入离屏交换链图像（作为外部纹理，图末尾转换到 OffscreenSwapChain::kPresentLayout）
+     */
+    RDGTextureHandle importOffscreenImage(vkcore::OffscreenSwapChain &swapChain, uint32_t imageIndex);
+
     // ==================== Pass管理接口 ====================
 
     /**
@@ -169,6 +375,11 @@ class RenderGraph
      */
     RDGPass &addPassEx(std::string name, RDGPass::ExecuteCallbackEx &&callback);
 
+    /**
+     * @brief 添加分块并行录制的渲染Pass
+     */
+    RDGPass &addParallelPass(std::string name, uint32_t chunkCount, RDGPass::ParallelExecuteCallback &&callback);
+
     // ==================== 编译和执行接口 ====================
 
     /**
@@ -208,16 +419,155 @@ class RenderGraph
         m_debugName = name;
     }
 
+    /**
+     * @brief 设置跨帧编译缓存（可为空，表示每帧完整编译）
+     */
+    void setCompileCache(RDGCompileCache *cache)
+    {
+        m_compileCache = cache;
+    }
+
+    /**
+     * @brief 设置共享采样器缓存（可为空，表示渲染图自行创建并销毁采样器）
+     * @note 必须在首次 getSampler() 之前设置
+     */
+    void setSamplerCache(vkcore::SamplerCache *cache)
+    {
+        m_samplerCache = cache;
+    }
+
+    /**
+     * @brief 设置渲染缩放（RDGExtentClass::Scaled 纹理的宽高乘以该值）
+     */
+    void setRenderScale(float scale)
+    {
+        m_renderScale = scale;
+    }
+
+    /**
+     * @brief 获取渲染缩放
+     */
+    float getRenderScale() const
+    {
+        return m_renderScale;
+    }
+
+    /**
+     * @brief 设备是否启用了 VK_KHR_dynamic_rendering_local_read（RDGPass::readInputAttachment 可用）
+     */
+    bool isLocalReadEnabled() const
+    {
+        return m_localReadEnabled;
+    }
+
+    /**
+     * @brief 设置跨帧瞬态资源分配器（可为空，表示每帧独立创建瞬态资源）
+     */
+    void setTransientAllocator(RDGTransientAllocator *allocator)
+    {
+        m_transientAllocator = allocator;
+    }
+
+    /**
+     * @brief 设置异步计算上下文（为空时所有Pass都在图形队列上执行）
+     */
+    void setAsyncComputeContext(RDGAsyncComputeContext *context)
+    {
+        m_asyncCompute = context;
+    }
+
+    /**
+     * @brief 设置拆分屏障使用的事件池（为空时所有屏障都在消费者Pass前一次性执行）
+     */
+    void setEventPool(RDGEventPool *eventPool)
+    {
+        m_eventPool = eventPool;
+    }
+
+    /**
+     * @brief 设置并行录制使用的工作线程池（为空时在调用线程上串行录制）
+     */
+    void setWorkerPool(vkcore::WorkerPool *workerPool)
+    {
+        m_workerPool = workerPool;
+    }
+
+    /**
+     * @brief 设置逐Pass GPU 计时使用的查询池（为空时不录制查询）
+     */
+    void setProfiler(RDGProfiler *profiler)
+    {
+        m_profiler = profiler;
+    }
+
+    /**
+     * @brief 设置本帧新建的瞬态资源使用的延迟销毁队列（为空时随渲染图析构立即销毁）
+     */
+    void setDeletionQueue(vkcore::DeferredDeletionQueue *queue)
+    {
+        m_deletionQueue = queue;
+    }
+
+    /**
+     * @brief 本帧是否命中编译缓存
+     */
+    bool isCompileCacheHit() const
+    {
+        return m_compileCacheHit;
+    }
+
     // ==================== 调试接口 ====================
 
     /**
      * @brief 获取编译后的Pass信息（用于调试）
      */
-    const std::vector<std::unique_ptr<RDGCompiledPass>> &getCompiledPasses() const
+    const std::vector<RDGCompiledPass *> &getCompiledPasses() const
     {
         return m_compiledPasses;
     }
 
+    /**
+     * @brief 获取Pass依赖边（按消费者Pass升序分组；命中编译缓存时不重建，为空）
+     */
+    const std::vector<RDGPassEdge> &getPassEdges() const
+    {
+        return m_passEdges;
+    }
+
+    /**
+     * @brief 获取指向某个Pass的依赖边在 getPassEdges() 中的下标范围 [first, second)
+     */
+    std::pair<size_t, size_t> getPassEdgeRange(uint32_t passIndex) const
+    {
+        if (passIndex + 1 >= m_passEdgeOffsets.size())
+        {
+            return {0, 0};
+        }
+        return {m_passEdgeOffsets[passIndex], m_passEdgeOffsets[passIndex + 1]};
+    }
+
+    /**
+     * @brief 获取本帧统计（Pass/屏障/批次在 compile() 之后有效，内存、复用与录制耗时在 execute() 之后有效）
+     */
+    const RDGGraphStats &getStats() const
+    {
+        return m_stats;
+    }
+
+    /**
+     * @brief 以 GraphViz dot 格式输出编译后的调度
+     * @details Pass 按队列着色（剔除的Pass为虚线），合并的渲染实例画为子图，资源节点标注生命周期区间，
+     *          边为 Pass 对资源的写入（Pass -> 资源）与读取（资源 -> Pass）
+     * @note 必须在 compile() 之后调用
+     */
+    void writeGraphviz(std::ostream &stream) const;
+
+    /**
+     * @brief 以 JSON 格式输出编译后的调度（统计、Pass、资源生命周期、提交批次与依赖边）
+     * @note 必须在 compile() 之后调用
+     */
+    void writeJson(std::ostream &stream) const;
+
     // ==================== 资源访问接口（供 RDGResourceAccessor 使用）====================
 
     /**
@@ -226,6 +576,12 @@ class RenderGraph
      */
     vkcore::Image *getPhysicalTexture(RDGTextureHandle handle) const;
 
+    /**
+     * @brief 获取纹理的图像句柄（交换链图像取自交换链，其他纹理取物理资源）
+     * @return vk::Image 句柄，未分配时为空
+     */
+    vk::Image getTextureImage(RDGResourceHandle handle) const;
+
     /**
      * @brief 获取缓冲区的物理资源
      * @note 仅在 Pass 执行期间有效
@@ -246,7 +602,7 @@ class RenderGraph
     // ==================== 内部编译阶段 ====================
 
     /**
-     * @brief 阶段1：构建依赖图
+     * @brief 阶段1：构建依赖图（编译Pass与依赖边，O(Pass数 + 访问数)）
      */
     void buildDependencyGraph();
 
@@ -266,10 +622,83 @@ class RenderGraph
     void allocateResources();
 
     /**
-     * @brief 阶段5：计算屏障
+     * @brief 找出只在单个渲染实例内作为附件使用的瞬态纹理（其内容从不离开片上内存，可使用惰性分配的内存）
+     * @return 以句柄为下标，满足条件的纹理为 1
+     */
+    RDGHandleTable<uint8_t> findTileLocalTextures() const;
+
+    /**
+     * @brief 阶段5：为每个活跃Pass选择队列（图形/异步计算）
+     */
+    void scheduleQueues();
+
+    /**
+     * @brief 阶段6：计算屏障（包括跨队列的所有权释放/获取屏障）
      */
     void computeBarriers();
 
+    /**
+     * @brief 收集以输入附件读取的纹理（computeBarriers 的第一步），并检查读取Pass把它们绑定为颜色附件
+     * @throws std::runtime_error 设备未启用局部读取，或读取的纹理不是该Pass的颜色附件
+     */
+    void collectLocalReadTextures();
+
+    /**
+     * @brief 颜色附件的布局：以输入附件读取的纹理为 eRenderingLocalReadKHR，其余为 eColorAttachmentOptimal
+     */
+    vk::ImageLayout getColorAttachmentLayout(RDGResourceHandle handle) const;
+
+    /**
+     * @brief 阶段6.5：把生产者与消费者之间隔有其他Pass的同队列屏障转为拆分屏障（需要事件池）
+     */
+    void placeSplitBarriers();
+
+    /**
+     * @brief 阶段7：根据队列分配与跨队列依赖把活跃Pass划分为提交批次
+     */
+    void buildSubmitBatches();
+
+    /**
+     * @brief 阶段8：合并同一提交批次中连续、附件集合相同的图形Pass
+     * @details 合并后的Pass共用一次 beginRendering/endRendering，中间结果留在片上（Tile）内存而不写回再读回；
+     *          块内后续Pass上同一附件的同布局屏障由光栅化顺序保证，被移除。输入附件读取的屏障改为
+     *          渲染实例内的逐区域屏障（VK_KHR_dynamic_rendering_local_read）
+     */
+    void mergeRenderPasses();
+
+    /**
+     * @brief 判断 current 能否接在 previous 所在的渲染实例之后
+     */
+    bool canMergeRenderPasses(const RDGCompiledPass &previous, const RDGCompiledPass &current) const;
+
+    /**
+     * @brief 由编译结果统计Pass、屏障、批次与资源数量（完整编译与命中编译缓存共用）
+     */
+    void collectCompileStats();
+
+    // ==================== 编译缓存辅助函数 ====================
+
+    /**
+     * @brief 收集图拓扑键（Pass声明、资源描述、访问列表，以及影响编译结果的图级设置）
+     * @details 不包含外部资源的物理指针与交换链图像索引，这些在命中后按句柄修补
+     */
+    std::vector<uint64_t> computeTopologyKey() const;
+
+    /**
+     * @brief 计算拓扑键的哈希（编译缓存的查找桶）
+     */
+    static uint64_t hashTopologyKey(const std::vector<uint64_t> &key);
+
+    /**
+     * @brief 从缓存条目恢复编译结果
+     */
+    void restoreFromCache(const RDGCachedGraph &cached);
+
+    /**
+     * @brief 将本次编译结果写入缓存条目
+     */
+    void storeToCache(RDGCachedGraph &cached) const;
+
     // ==================== 资源分配辅助函数 ====================
 
     /**
@@ -282,6 +711,11 @@ class RenderGraph
      */
     vkcore::Buffer *allocateTransientBuffer(RDGBufferResource &resource);
 
+    /**
+     * @brief 释放本帧新建的瞬态资源（交给延迟销毁队列或立即销毁）
+     */
+    void releaseFrameResources();
+
     /**
      * @brief 尝试复用已有资源
      */
@@ -297,34 +731,164 @@ class RenderGraph
 
     /**
      * @brief 添加图像内存屏障
+     * @param producerPass 资源上一次被访问的Pass，与本Pass不在同一队列时拆分为所有权释放/获取屏障
      */
     void addImageBarrier(RDGCompiledPass &pass, RDGTextureHandle handle, vk::ImageLayout oldLayout,
-                         vk::ImageLayout newLayout, vk::AccessFlags srcAccess, vk::AccessFlags dstAccess,
-                         vk::PipelineStageFlags srcStages, vk::PipelineStageFlags dstStages);
+                         vk::ImageLayout newLayout, vk::AccessFlags2 srcAccess, vk::AccessFlags2 dstAccess,
+                         vk::PipelineStageFlags2 srcStages, vk::PipelineStageFlags2 dstStages,
+                         uint32_t producerPass = kInvalidPassIndex);
 
     /**
      * @brief 添加缓冲区内存屏障
+     * @param producerPass 资源上一次被访问的Pass，与本Pass不在同一队列时拆分为所有权释放/获取屏障
+     */
+    void addBufferBarrier(RDGCompiledPass &pass, RDGBufferHandle handle, vk::AccessFlags2 srcAccess,
+                          vk::AccessFlags2 dstAccess, vk::PipelineStageFlags2 srcStages,
+                          vk::PipelineStageFlags2 dstStages, uint32_t producerPass = kInvalidPassIndex);
+
+    /**
+     * @brief 把屏障加入Pass；跨队列时拆分为生产者端的释放屏障和消费者端的获取屏障，并记录跨队列依赖
      */
-    void addBufferBarrier(RDGCompiledPass &pass, RDGBufferHandle handle, vk::AccessFlags srcAccess,
-                          vk::AccessFlags dstAccess, vk::PipelineStageFlags srcStages,
-                          vk::PipelineStageFlags dstStages);
+    void pushBarrier(RDGCompiledPass &pass, RDGBarrier barrier, uint32_t producerPass);
+
+    /**
+     * @brief 获取队列对应的队列族索引
+     */
+    uint32_t getQueueFamily(RDGQueueType queue) const;
+
+    /**
+     * @struct ResourceSyncState
+     * @brief 屏障计算中单个资源的同步状态
+     * @details 记录最近一次写入，以及该写入之后已经可见的读取阶段/访问。读取只有在
+     *          尚未可见时才需要屏障，写入只需要等待之前的读取（WAR 为纯执行依赖）
+     */
+    struct ResourceSyncState
+    {
+        vk::PipelineStageFlags2 writeStages; ///< 最近一次写入的阶段（跨队列获取后为获取方的阶段）
+        vk::AccessFlags2 writeAccess;        ///< 最近一次写入的访问（尚需使其可用）
+        vk::PipelineStageFlags2 readStages;  ///< 写入之后已可见的读取阶段
+        vk::AccessFlags2 readAccess;         ///< 写入之后已可见的读取访问
+        uint32_t lastPass = kInvalidPassIndex;
+        RDGQueueType lastQueue = RDGQueueType::Graphics;
+    };
+
+    /**
+     * @struct ResourceSyncTracker
+     * @brief 资源同步状态，以及当前Pass内对该资源的合并访问
+     * @details 同一Pass多次访问同一资源时回退到进入该Pass前的状态，按合并后的访问重新生成一个屏障
+     */
+    struct ResourceSyncTracker
+    {
+        ResourceSyncState state;
+        ResourceSyncState entryState; ///< 进入当前Pass之前的状态
+        vk::ImageLayout entryLayout = vk::ImageLayout::eUndefined;
+        vk::PipelineStageFlags2 passStages; ///< 当前Pass内的合并访问阶段
+        vk::AccessFlags2 passAccess;        ///< 当前Pass内的合并访问
+        vk::ImageLayout passLayout = vk::ImageLayout::eUndefined;
+        bool passWrite = false;
+    };
+
+    /**
+     * @brief 记录一次资源访问，并在需要时生成屏障
+     * @param layout 图像需要的布局（缓冲区忽略）
+     */
+    void syncResourceAccess(RDGCompiledPass &pass, ResourceSyncTracker &tracker, RDGBarrier::Type type,
+                            RDGResourceHandle handle, vk::PipelineStageFlags2 stages, vk::AccessFlags2 access,
+                            vk::ImageLayout layout, bool isWrite);
 
     // ==================== 执行辅助函数 ====================
 
     /**
-     * @brief 执行屏障
+     * @brief 在调用线程上录制：每个提交批次一个主命令缓冲区
+     * @param batchBuffers 输出按批次排列的主命令缓冲区
+     */
+    void recordPassesSerial(std::vector<std::vector<vkcore::CommandBufferHandle>> &batchBuffers);
+
+    /**
+     * @brief 在工作线程上并行录制：每个活跃Pass一个主命令缓冲区，并行Pass的每块一个次级命令缓冲区
+     * @param batchBuffers 输出按批次排列、批次内按Pass顺序排列的主命令缓冲区
+     * @param secondaryBuffers 输出次级命令缓冲区（仅用于保持存活，不直接提交）
+     */
+    void recordPassesParallel(std::vector<std::vector<vkcore::CommandBufferHandle>> &batchBuffers,
+                              std::vector<vkcore::CommandBufferHandle> &secondaryBuffers);
+
+    /**
+     * @brief 把本帧写入过的交换链图像转换到呈现布局（窗口为 ePresentSrcKHR，离屏为 kPresentLayout）
+     * @details 屏障录制在追加到最后一个批次的命令缓冲区中，getFinalLayout() 随之返回呈现布局
      */
-    void executeBarriers(vk::CommandBuffer cmd, const std::vector<RDGBarrier> &barriers);
+    void recordPresentTransitions(std::vector<std::vector<vkcore::CommandBufferHandle>> &batchBuffers);
+
+    /**
+     * @brief 按批次顺序提交到各自队列，批次之间用信号量连接
+     * @details syncInfo 的等待信号量加在第一个图形批次上，触发信号量与Fence加在最后一个图形批次上
+     */
+    void submitBatches(const std::vector<std::vector<vkcore::CommandBufferHandle>> &batchBuffers,
+                       RDGSyncInfo *syncInfo);
+
+    /**
+     * @brief 获取队列对应的命令池管理器
+     */
+    vkcore::CommandPoolManager &getCommandManager(RDGQueueType queue) const;
+
+    /**
+     * @brief 录制单个Pass（屏障、渲染状态、回调或次级命令缓冲区）
+     * @param secondaries 已录制好的块次级命令缓冲区，为空时直接调用回调
+     * @param ownCommandBuffer 是否独占命令缓冲区（并行录制）：合并的渲染实例改用挂起/恢复跨命令缓冲区延续
+     * @note 可在工作线程上并发调用，只读访问图状态
+     */
+    void recordPass(vk::CommandBuffer cmd, size_t passIndex, const std::vector<vk::CommandBuffer> &secondaries,
+                    bool ownCommandBuffer);
+
+    /**
+     * @brief 调用Pass回调（捕获并记录回调异常）
+     */
+    void invokePassCallback(vk::CommandBuffer cmd, const RDGPass &pass, uint32_t chunkIndex, uint32_t chunkCount);
+
+    /**
+     * @brief 收集Pass附件格式（用于次级命令缓冲区的动态渲染继承信息）
+     */
+    void collectAttachmentFormats(const RDGPass &pass, std::vector<vk::Format> &colorFormats, vk::Format &depthFormat,
+                                  vk::SampleCountFlagBits &samples) const;
+
+    /**
+     * @brief 执行屏障（一次 pipelineBarrier2，每个资源使用各自的阶段掩码）
+     */
+    void executeBarriers(vk::CommandBuffer cmd, const std::vector<RDGBarrier> &barriers) const;
+
+    /**
+     * @brief 把屏障列表转换为 DependencyInfo（供 pipelineBarrier2 / setEvent2 / waitEvents2 共用）
+     * @return 是否有实际的屏障（物理资源为空的屏障会被跳过）
+     */
+    bool buildDependencyInfo(const std::vector<RDGBarrier> &barriers,
+                             std::vector<vk::ImageMemoryBarrier2> &imageBarriers,
+                             std::vector<vk::BufferMemoryBarrier2> &bufferBarriers,
+                             vk::DependencyInfo &dependencyInfo) const;
 
     /**
      * @brief 开始图形Pass（设置渲染状态）
+     * @details 合并块中的每个Pass使用相同的 RenderingInfo：加载操作取自第一个Pass，存储操作取自最后一个Pass
+     * @param flags 动态渲染标志（次级命令缓冲区录制内容时为 eContentsSecondaryCommandBuffers）
+     * @return 是否实际开始了动态渲染
+     */
+    bool beginGraphicsPass(vk::CommandBuffer cmd, const RDGCompiledPass &compiledPass,
+                           vk::RenderingFlags flags = {}) const;
+
+    /**
+     * @brief 瞬态附件在渲染实例之前没有内容时，把 eLoad 降级为 eDontCare
      */
-    void beginGraphicsPass(vk::CommandBuffer cmd, const RDGPass &pass);
+    vk::AttachmentLoadOp resolveLoadOp(RDGResourceHandle handle, vk::AttachmentLoadOp loadOp,
+                                       uint32_t firstPass) const;
+
+    /**
+     * @brief 瞬态附件的生命周期在渲染实例内结束时，把 eStore 降级为 eDontCare（内容不再写回显存）
+     */
+    vk::AttachmentStoreOp resolveStoreOp(RDGResourceHandle handle, vk::AttachmentStoreOp storeOp,
+                                         uint32_t lastPass) const;
 
     /**
      * @brief 结束图形Pass
      */
-    void endGraphicsPass(vk::CommandBuffer cmd);
+    void endGraphicsPass(vk::CommandBuffer cmd) const;
 
     // ==================== 验证辅助函数 ====================
 
@@ -335,6 +899,8 @@ class RenderGraph
 
     // ==================== 句柄生成 ====================
 
+    static constexpr uint32_t kInvalidPassIndex = UINT32_MAX;
+
     /**
      * @brief 生成下一个资源句柄
      */
@@ -353,13 +919,16 @@ class RenderGraph
     // 句柄生成
     RDGResourceHandle m_nextHandle = 0;
 
-    // Pass存储
-    std::vector<std::unique_ptr<RDGPass>> m_passes;
-    std::vector<std::unique_ptr<RDGCompiledPass>> m_compiledPasses;
+    // 帧内分配器：Pass、资源对象与访问列表都分配在这里，随渲染图一起析构（必须先于下列容器声明）
+    RDGLinearArena m_arena;
 
-    // 资源存储
-    std::unordered_map<RDGResourceHandle, std::unique_ptr<RDGTextureResource>> m_textureResources;
-    std::unordered_map<RDGResourceHandle, std::unique_ptr<RDGBufferResource>> m_bufferResources;
+    // Pass存储（对象位于 m_arena）
+    std::vector<RDGPass *> m_passes;
+    std::vector<RDGCompiledPass *> m_compiledPasses;
+
+    // 资源存储（以句柄为下标，对象位于 m_arena）
+    RDGHandleTable<RDGTextureResource *> m_textureResources;
+    RDGHandleTable<RDGBufferResource *> m_bufferResources;
 
     // 资源池（用于内存复用）
     RDGTexturePool m_texturePool;
@@ -368,16 +937,33 @@ class RenderGraph
     // 当前帧分配的资源（执行完毕后释放）
     std::vector<std::unique_ptr<vkcore::Image>> m_frameTextures;
     std::vector<std::unique_ptr<vkcore::Buffer>> m_frameBuffers;
+    vkcore::DeferredDeletionQueue *m_deletionQueue = nullptr; ///< 可选，由外部持有
+    float m_renderScale = 1.0f;                               ///< Scaled 纹理的尺寸缩放
 
     // 采样器池（用于临时纹理采样）
     std::array<vk::Sampler, static_cast<size_t>(RDGSamplerType::Count)> m_samplers;
     bool m_samplersCreated = false;
+    bool m_ownsSamplers = true;                     ///< 采样器由本对象创建（否则归 m_samplerCache 所有）
+    vkcore::SamplerCache *m_samplerCache = nullptr; ///< 可选，由外部持有
 
     // 资源布局跟踪（用于屏障计算）
-    std::unordered_map<RDGResourceHandle, vk::ImageLayout> m_textureLayouts;
+    RDGHandleTable<vk::ImageLayout> m_textureLayouts;
+    RDGHandleTable<vk::PipelineStageFlags2> m_importStages; ///< 导入纹理在图之前最后一次访问的阶段
+    RDGHandleTable<uint8_t> m_localReadTextures; ///< 以输入附件读取的纹理（颜色附件使用局部读取布局）
+    bool m_localReadEnabled = false;             ///< 设备启用了 VK_KHR_dynamic_rendering_local_read
 
     // SwapChain跟踪（用于处理SwapChain图像）
-    std::unordered_map<RDGResourceHandle, vkcore::SwapChain *> m_swapChainMapping;
+    RDGHandleTable<vkcore::SwapChain *> m_swapChainMapping;
+    RDGHandleTable<vk::ImageLayout> m_presentLayouts; ///< 交换链与离屏交换链图像 -> 图末尾的呈现布局
+
+    // 跨帧编译缓存（可选，由外部持有）
+    RDGCompileCache *m_compileCache = nullptr;
+    RDGCachedGraph *m_cachedGraph = nullptr;
+    bool m_compileCacheHit = false;
+
+    // 跨帧瞬态资源分配器（可选，由外部持有）
+    RDGTransientAllocator *m_transientAllocator = nullptr;
+    std::vector<uint8_t> m_aliasingBarrierPasses; ///< 按Pass索引：是否需要在Pass前插入别名屏障
 
     // 编译状态
     bool m_compiled = false;
@@ -385,9 +971,39 @@ class RenderGraph
 
     // 调试信息
     std::string m_debugName = "RenderGraph";
+    RDGGraphStats m_stats;
+
+    // 并行录制（可选，由外部持有）
+    vkcore::WorkerPool *m_workerPool = nullptr;
 
-    // 当前渲染状态
-    bool m_insideGraphicsPass = false;
+    // 异步计算（可选，由外部持有）
+    RDGAsyncComputeContext *m_asyncCompute = nullptr;
+
+    /**
+     * @struct QueueDependency
+     * @brief 编译期记录的跨队列依赖（生产者Pass -> 消费者Pass）
+     */
+    struct QueueDependency
+    {
+        uint32_t producerPass;
+        uint32_t consumerPass;
+        vk::PipelineStageFlags2 waitStages; ///< 消费者端需要等待的阶段
+    };
+    std::vector<QueueDependency> m_queueDependencies;
+    std::vector<RDGSubmitBatch> m_submitBatches;
+
+    // 依赖图（buildDependencyGraph 生成，边按消费者分组）
+    std::vector<RDGPassEdge> m_passEdges;
+    std::vector<uint32_t> m_passEdgeOffsets; ///< 按Pass索引：该Pass的边在 m_passEdges 中的起点（末尾多一项）
+
+    // 拆分屏障（可选，事件池由外部持有）
+    RDGEventPool *m_eventPool = nullptr;
+    std::vector<RDGSplitBarrier> m_splitBarriers;
+    std::vector<vk::Event> m_splitEvents; ///< 本帧为每个拆分屏障取得的事件
+
+    // GPU 计时（可选，查询池由外部持有）
+    RDGProfiler *m_profiler = nullptr;
+    std::vector<uint32_t> m_profileQueries; ///< 按Pass索引：本帧的查询索引（UINT32_MAX 表示不计时）
 
     // ==================== 辅助方法 ====================
 
@@ -1,10 +1,18 @@
 #pragma once
 
+#include "RDGArena.hpp"
+#include "RDGAsyncComputeContext.hpp"
 #include "RDGBuilder.hpp"
+#include "RDGCompileCache.hpp"
+#include "RDGEventPool.hpp"
 #include "RDGHandle.hpp"
+#include "RDGInlineFunction.hpp"
 #include "RDGPass.hpp"
+#include "RDGProfiler.hpp"
 #include "RDGResourceAccessor.hpp"
+#include "RDGStats.hpp"
 #include "RDGSyncInfo.hpp"
+#include "RDGTransientAllocator.hpp"
 
 namespace rendercore
 {
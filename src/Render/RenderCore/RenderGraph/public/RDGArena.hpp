@@ -0,0 +1,190 @@
+/**
+ * @file RDGArena.hpp
+ * @brief RenderGraph 帧内线性分配器
+ * @details 一帧的 RDGPass、资源对象、编译Pass与访问列表都从同一个线性分配器中分配，
+ *          RenderGraph 销毁时整体释放。内存块通过进程级的空闲块缓存跨帧复用，
+ *          稳定状态下构建一帧渲染图不再产生堆分配
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rendercore
+{
+
+/**
+ * @class RDGLinearArena
+ * @brief 按块增长的线性（bump）分配器
+ *
+ * @example
+ * @code
+ * RDGLinearArena arena;
+ * auto *pass = arena.create<RDGPass>(arena, "GBuffer", std::move(callback)); // 析构函数在 reset() 时调用
+ * RDGArenaVector<uint32_t> indices{RDGArenaAllocator<uint32_t>(arena)};     // deallocate 为空操作
+ * @endcode
+ *
+ * @note 不是线程安全的；只在构建渲染图的线程上使用
+ */
+class RDGLinearArena
+{
+  public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024; ///< 默认块大小（跨帧复用的块都是这个大小）
+
+    explicit RDGLinearArena(size_t blockSize = kDefaultBlockSize);
+
+    /**
+     * @brief 析构函数，调用所有 create() 对象的析构函数并归还内存块
+     */
+    ~RDGLinearArena();
+
+    // 禁用拷贝和移动（分配出的指针指向内部块）
+    RDGLinearArena(const RDGLinearArena &) = delete;
+    RDGLinearArena &operator=(const RDGLinearArena &) = delete;
+
+    /**
+     * @brief 分配未初始化的内存
+     * @param size 字节数
+     * @param alignment 对齐（2 的幂）
+     */
+    void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief 在分配器中构造对象（非平凡析构的对象在 reset() 或析构时按构造的逆序析构）
+     */
+    template <typename T, typename... Args> T *create(Args &&...args)
+    {
+        void *memory = allocate(sizeof(T), alignof(T));
+        T *object = ::new (memory) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            void *recordMemory = allocate(sizeof(DestructorRecord), alignof(DestructorRecord));
+            auto *record = static_cast<DestructorRecord *>(recordMemory);
+            record->destroy = [](void *ptr) { static_cast<T *>(ptr)->~T(); };
+            record->object = object;
+            record->next = m_destructors;
+            m_destructors = record;
+        }
+        return object;
+    }
+
+    /**
+     * @brief 析构所有对象并回到第一个块的起点（保留已分配的块）
+     */
+    void reset();
+
+    /**
+     * @brief 获取已分配的字节数（含对齐填充）
+     */
+    size_t getBytesAllocated() const
+    {
+        return m_bytesAllocated;
+    }
+
+    /**
+     * @brief 获取持有的内存块数量
+     */
+    size_t getBlockCount() const
+    {
+        return m_blocks.size();
+    }
+
+  private:
+    /**
+     * @struct DestructorRecord
+     * @brief 待调用的析构函数（记录本身也从分配器中分配，构成逆序链表）
+     */
+    struct DestructorRecord
+    {
+        void (*destroy)(void *);
+        void *object;
+        DestructorRecord *next;
+    };
+
+    /**
+     * @struct Block
+     * @brief 一个连续内存块
+     */
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> data;
+        size_t size = 0;
+    };
+
+    size_t m_blockSize;
+    std::vector<Block> m_blocks;
+    size_t m_blockIndex = 0; ///< 当前分配所在的块
+    size_t m_offset = 0;     ///< 当前块中已使用的字节数
+    size_t m_bytesAllocated = 0;
+    DestructorRecord *m_destructors = nullptr;
+
+    /**
+     * @brief 切换到能容纳 size 字节的下一个块（必要时申请新块）
+     */
+    void advanceblock(size_t size, size_t alignment);
+
+    /**
+     * @brief 调用所有已记录的析构函数
+     */
+    void destroyobjects();
+};
+
+/**
+ * @class RDGArenaAllocator
+ * @brief 从 RDGLinearArena 分配的标准库分配器（deallocate 为空操作，内存随分配器整体释放）
+ */
+template <typename T> class RDGArenaAllocator
+{
+  public:
+    using value_type = T;
+
+    explicit RDGArenaAllocator(RDGLinearArena &arena) noexcept : m_arena(&arena)
+    {
+    }
+
+    template <typename U> RDGArenaAllocator(const RDGArenaAllocator<U> &other) noexcept : m_arena(other.getArena())
+    {
+    }
+
+    T *allocate(size_t count)
+    {
+        return static_cast<T *>(m_arena->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, size_t) noexcept
+    {
+    }
+
+    RDGLinearArena *getArena() const noexcept
+    {
+        return m_arena;
+    }
+
+    template <typename U> bool operator==(const RDGArenaAllocator<U> &other) const noexcept
+    {
+        return m_arena == other.getArena();
+    }
+
+    template <typename U> bool operator!=(const RDGArenaAllocator<U> &other) const noexcept
+    {
+        return m_arena != other.getArena();
+    }
+
+  private:
+    RDGLinearArena *m_arena;
+};
+
+/**
+ * @typedef RDGArenaVector
+ * @brief 元素存放在 RDGLinearArena 中的连续数组
+ * @note 扩容时旧的存储不会归还，需要时先 reserve
+ */
+template <typename T> using RDGArenaVector = std::vector<T, RDGArenaAllocator<T>>;
+
+} // namespace rendercore
@@ -0,0 +1,131 @@
+/**
+ * @file RDGAsyncComputeContext.hpp
+ * @brief 跨帧持久的异步计算上下文
+ * @details 渲染图把标记为异步计算的Pass调度到专用计算队列。跨队列依赖需要：
+ *          - 计算队列族上的命令池（命令缓冲区只能提交到其命令池所属族的队列）
+ *          - 在生产者批次与消费者批次之间传递的二进制信号量
+ *          二者都需要跨帧存活，因此由本对象持有；信号量按 frames-in-flight 分槽，
+ *          槽位只在其上一帧 GPU 工作完成后复用
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+// 前向声明
+namespace vkcore
+{
+class Device;
+class CommandPoolManager;
+} // namespace vkcore
+
+namespace rendercore
+{
+
+// 前向声明内部实现
+class RenderGraph;
+
+/**
+ * @class RDGAsyncComputeContext
+ * @brief 异步计算上下文（跨帧持久）
+ *
+ * @example
+ * @code
+ * // 初始化时创建一次
+ * rendercore::RDGAsyncComputeContext asyncCompute(device, vkcore::SwapChain::MAX_FRAMES_IN_FLIGHT);
+ *
+ * // 每帧
+ * rendercore::RDGBuilder builder(device, cmdManager, allocator, &compileCache, &transientAllocator);
+ * builder.setAsyncCompute(&asyncCompute);
+ * builder.addPass("LightCulling", [](vk::CommandBuffer cmd) { ... })
+ *     .readBuffer(lights, vk::PipelineStageFlagBits::eComputeShader, vk::AccessFlagBits::eShaderRead)
+ *     .writeStorageBuffer(lightGrid, vk::PipelineStageFlagBits::eComputeShader, vk::AccessFlagBits::eShaderWrite)
+ *     .setAsyncCompute();
+ * builder.execute(&syncInfo);
+ * @endcode
+ *
+ * @note 调用者必须保证复用某个槽位之前（即 framesInFlight 帧之后）该帧的 GPU 工作
+ *       已完成（等待帧 Fence），这与 SwapChain 的帧同步模型一致
+ */
+class RDGAsyncComputeContext
+{
+  public:
+    /**
+     * @brief 构造函数
+     * @param device Vulkan设备
+     * @param framesInFlight 同时在途的帧数（决定信号量槽位数）
+     */
+    explicit RDGAsyncComputeContext(vkcore::Device &device, uint32_t framesInFlight = 2);
+
+    /**
+     * @brief 析构函数
+     * @warning 会销毁所有信号量与计算命令池，调用前需确保GPU已空闲
+     */
+    ~RDGAsyncComputeContext();
+
+    // 禁用拷贝和移动
+    RDGAsyncComputeContext(const RDGAsyncComputeContext &) = delete;
+    RDGAsyncComputeContext &operator=(const RDGAsyncComputeContext &) = delete;
+
+    /**
+     * @brief 设备是否有独立的计算队列族（否则异步计算Pass回退到图形队列）
+     */
+    bool isAvailable() const;
+
+    /**
+     * @brief 获取计算队列族上的命令池管理器
+     */
+    vkcore::CommandPoolManager &getCommandManager()
+    {
+        return *m_commandManager;
+    }
+
+    /**
+     * @brief 获取当前帧序号（单调递增）
+     */
+    uint64_t getFrameIndex() const
+    {
+        return m_frameIndex;
+    }
+
+    /**
+     * @brief 获取当前槽位已创建的信号量数量（调试用）
+     */
+    size_t getSemaphoreCount() const;
+
+  private:
+    friend class RenderGraph;
+
+    /**
+     * @struct FrameSlot
+     * @brief 一个 frame-in-flight 槽位持有的信号量
+     */
+    struct FrameSlot
+    {
+        std::vector<vk::Semaphore> semaphores;
+        size_t usedCount = 0; ///< 本帧已取用的信号量数量
+    };
+
+    /**
+     * @brief (私有) 从当前槽位取一个未使用的二进制信号量（不足时创建）
+     */
+    vk::Semaphore acquireSemaphore();
+
+    /**
+     * @brief (私有) 推进到下一帧（由 RenderGraph 在提交后调用）
+     */
+    void advanceFrame();
+
+  private:
+    vkcore::Device &m_device;
+    std::unique_ptr<vkcore::CommandPoolManager> m_commandManager;
+    uint32_t m_framesInFlight;
+
+    uint64_t m_frameIndex = 0;
+    std::vector<FrameSlot> m_slots;
+};
+
+} // namespace rendercore
@@ -6,9 +6,16 @@
 
 #pragma once
 
+#include "RDGAsyncComputeContext.hpp"
+#include "RDGCompileCache.hpp"
+#include "RDGEventPool.hpp"
 #include "RDGHandle.hpp"
 #include "RDGPass.hpp"
+#include "RDGProfiler.hpp"
+#include "RDGStats.hpp"
 #include "RDGSyncInfo.hpp"
+#include "RDGTransientAllocator.hpp"
+#include <filesystem>
 #include <memory>
 
 // 前向声明
@@ -17,8 +24,12 @@ namespace vkcore
 class Device;
 class CommandPoolManager;
 class SwapChain;
+class OffscreenSwapChain;
 class Image;
 class Buffer;
+class WorkerPool;
+class DeferredDeletionQueue;
+class SamplerCache;
 } // namespace vkcore
 
 typedef struct VmaAllocator_T *VmaAllocator;
@@ -42,8 +53,13 @@ class RDGBuilder
      * @param device Vulkan设备
      * @param cmdManager 命令池管理器
      * @param allocator VMA分配器
+     * @param compileCache 跨帧编译缓存（可选，为空时每帧完整编译）
+     * @param transientAllocator 跨帧瞬态资源分配器（可选，为空时每帧独立创建瞬态资源）
+     * @param samplerCache 共享采样器缓存（可选，为空时每帧自行创建 RDGSamplerType 对应的采样器）
      */
-    RDGBuilder(vkcore::Device &device, vkcore::CommandPoolManager &cmdManager, VmaAllocator allocator);
+    RDGBuilder(vkcore::Device &device, vkcore::CommandPoolManager &cmdManager, VmaAllocator allocator,
+               RDGCompileCache *compileCache = nullptr, RDGTransientAllocator *transientAllocator = nullptr,
+               vkcore::SamplerCache *samplerCache = nullptr);
 
     /**
      * @brief 析构函数
@@ -104,7 +120,7 @@ class RDGBuilder
      * builder.addPass("BlendPass", [externalTex](vk::CommandBuffer cmd, RDGResourceAccessor& res) {
      *     // 外部纹理：使用它自己的 Sampler
      *     vk::ImageView albedoView = res.getTextureView(albedoHandle);
-     *     vk::Sampler albedoSampler = externalTex->sampler.get();
+     *     vk::Sampler albedoSampler = externalTex->sampler;
      *
      *     // 临时纹理：使用通用 Sampler
      *     vk::ImageView tempView = res.getTextureView(tempTarget);
@@ -117,6 +133,35 @@ class RDGBuilder
      */
     RDGPass &addPass(std::string name, RDGPass::ExecuteCallbackEx &&callback);
 
+    /**
+     * @brief 添加一个分块并行录制的渲染通道（用于包含大量绘制调用的Pass）
+     * @param name 通道的调试名称
+     * @param chunkCount 拆分的块数，每块录制到独立的次级命令缓冲区
+     * @param callback 录制第 chunkIndex 块命令的Lambda函数（可能在工作线程上并发调用）
+     * @return RDGPass& 通道对象的引用，用于链式声明依赖
+     * @note 只有设置了工作线程池（setWorkerPool）时才会并行录制，否则各块在主命令缓冲区中依次录制
+     *
+     * @example
+     * @code
+     * builder.addPass("GBufferPass", 8,
+     *                 [&draws](vk::CommandBuffer cmd, const RDGResourceAccessor &res, uint32_t chunk, uint32_t count) {
+     *                     size_t begin = draws.size() * chunk / count;
+     *                     size_t end = draws.size() * (chunk + 1) / count;
+     *                     // 设置视口/裁剪、绑定管线（次级命令缓冲区不继承动态状态）并录制 [begin, end) ...
+     *                 })
+     *     .writeColorAttachment(gbuffer)
+     *     .writeDepthAttachment(depth);
+     * @endcode
+     */
+    RDGPass &addPass(std::string name, uint32_t chunkCount, RDGPass::ParallelExecuteCallback &&callback);
+
+    /**
+     * @brief 设备是否启用了 VK_KHR_dynamic_rendering_local_read
+     * @details 启用时 RDGPass::readInputAttachment 可用，读取前一个Pass颜色附件的Pass与之合并为一个渲染实例；
+     *          否则应改用 readTexture 采样前一个Pass的输出（两个Pass照常各自开始渲染）
+     */
+    bool isLocalReadSupported() const;
+
     // ==================== 瞬态资源创建 ====================
 
     /**
@@ -142,12 +187,15 @@ class RDGBuilder
      * @param image 指向由ResourceManager或SwapChain管理的vkcore::Image
      * @param name 调试名称
      * @param currentLayout 当前图像布局
+     * @param lastStages 之前的帧（或图外命令）最后访问该纹理的阶段。在途帧仍可能读取时必须给出：
+     *                   图内首次写入或布局转换会等待这些阶段，否则首次访问的屏障没有源阶段
      * @return RDGTextureHandle 虚拟句柄
      *
      * @details 外部资源不会被自动释放，需要外部管理生命周期
      */
     RDGTextureHandle registerExternalTexture(vkcore::Image *image, const std::string &name = "ExternalTexture",
-                                             vk::ImageLayout currentLayout = vk::ImageLayout::eUndefined);
+                                             vk::ImageLayout currentLayout = vk::ImageLayout::eUndefined,
+                                             vk::PipelineStageFlags lastStages = vk::PipelineStageFlags());
 
     /**
      * @brief 导入一个外部（持久化）缓冲区到图中
@@ -164,9 +212,21 @@ class RDGBuilder
      * @param swapChain 交换链
      * @param imageIndex 当前图像索引
      * @return RDGTextureHandle 虚拟句柄
+     * @details 首次访问从未定义布局转换，源阶段包含 ColorAttachmentOutput（与获取信号量的等待阶段链接）；
+     *          本帧写入过的图像在图末尾转换到 ePresentSrcKHR，execute() 之后可直接呈现
      */
     RDGTextureHandle getSwapChainAttachment(vkcore::SwapChain &swapChain, uint32_t imageIndex);
 
+    /**
+     * @brief 辅助函数：导入离屏交换链（headless 渲染）的当前图像
+     * @param swapChain 离屏交换链
+     * @param imageIndex acquireNextImage() 返回的图像索引
+     * @return RDGTextureHandle 虚拟句柄
+     * @details 与 getSwapChainAttachment() 相同的约定：首次访问从未定义布局转换并与图像可用信号量的等待阶段链接，
+     *          本帧写入过的图像在图末尾转换到 OffscreenSwapChain::kPresentLayout，execute() 之后可直接 present()
+     */
+    RDGTextureHandle getOffscreenAttachment(vkcore::OffscreenSwapChain &swapChain, uint32_t imageIndex);
+
     /**
      * @brief 创建2D纹理的便利函数
      * @param name 纹理名称
@@ -234,6 +294,13 @@ class RDGBuilder
         return m_executed;
     }
 
+    /**
+     * @brief 获取纹理在整张图末尾的布局（execute() 之后有效）
+     * @details RDG 不会把外部纹理恢复到导入时的布局；跨帧持久的外部纹理以此作为下一帧导入时的 currentLayout
+     * @throws std::runtime_error 如果尚未执行
+     */
+    vk::ImageLayout getFinalLayout(RDGTextureHandle handle) const;
+
     // ==================== 调试和统计 ====================
 
     /**
@@ -251,6 +318,94 @@ class RDGBuilder
      */
     void setDebugName(const std::string &name);
 
+    /**
+     * @brief 获取本帧的编译与执行统计（Pass剔除/合并、各类屏障数量、瞬态内存别名、资源复用与耗时）
+     * @throws std::runtime_error 如果尚未执行
+     */
+    const RDGGraphStats &getStats() const;
+
+    /**
+     * @brief 把编译后的调度以 GraphViz dot 格式写入文件（dot -Tsvg 查看）
+     * @details 包含Pass（按队列着色，剔除的Pass为虚线，合并的渲染实例为子图）、资源生命周期与跨队列等待
+     * @throws std::runtime_error 如果尚未执行或文件无法写入
+     */
+    void dumpGraphviz(const std::filesystem::path &path) const;
+
+    /**
+     * @brief 把统计与编译后的调度（Pass、资源生命周期、提交批次、拆分屏障、依赖边）以 JSON 格式写入文件
+     * @throws std::runtime_error 如果尚未执行或文件无法写入
+     */
+    void dumpJson(const std::filesystem::path &path) const;
+
+    /**
+     * @brief 启用多线程命令录制
+     * @param workerPool 工作线程池（由调用者持有，为空时恢复单线程录制）
+     * @details 启用后每个活跃Pass录制到独立的主命令缓冲区，分块Pass的每块录制到独立的
+     *          次级命令缓冲区，全部在工作线程上并行完成，并按Pass顺序一次性提交
+     * @warning 启用后Pass回调可能在工作线程上执行，回调内不得访问非线程安全的外部状态
+     */
+    void setWorkerPool(vkcore::WorkerPool *workerPool);
+
+    /**
+     * @brief 启用异步计算队列调度
+     * @param context 异步计算上下文（由调用者持有，为空时所有Pass都在图形队列上执行）
+     * @details 标记为 setAsyncCompute() 的Pass被调度到专用计算队列，编译器按跨队列依赖切分提交批次，
+     *          自动插入队列族所有权释放/获取屏障和跨队列信号量，使其与图形队列上无依赖的工作重叠执行
+     *          （例如光源剔除、后处理与阴影光栅化并行）
+     */
+    void setAsyncCompute(RDGAsyncComputeContext *context);
+
+    /**
+     * @brief 启用拆分屏障
+     * @param eventPool 事件池（由调用者持有，为空时所有屏障都在消费者Pass前执行）
+     * @details 同一队列上生产者与消费者之间还有其他Pass时，屏障被拆分为生产者之后的 setEvent2
+     *          和消费者之前的 waitEvents2，中间的Pass不再被该屏障阻塞
+     */
+    void setEventPool(RDGEventPool *eventPool);
+
+    /**
+     * @brief 启用逐Pass GPU 计时
+     * @param profiler 计时查询池（由调用者持有，为空时不录制查询）
+     * @details 每个活跃Pass前后写入时间戳（可选地录制管线统计），结果在 framesInFlight 帧之后
+     *          以不等待的方式读回，通过 RDGProfiler::getLatestFrame()/getHistory() 查询
+     */
+    void setProfiler(RDGProfiler *profiler);
+
+    /**
+     * @brief 启用瞬态资源的延迟销毁
+     * @param queue 延迟销毁队列（由调用者持有并关联帧时间线，为空时随构建器析构立即销毁）
+     * @details 未使用跨帧瞬态分配器时，渲染图为本帧新建的纹理/缓冲区在构建器析构时交给该队列，
+     *          在当前帧退休后才销毁，无需在析构前等待 GPU
+     */
+    void setDeletionQueue(vkcore::DeferredDeletionQueue *queue);
+
+    // ==================== 动态分辨率 ====================
+
+    /**
+     * @brief 设置渲染缩放
+     * @param scale 缩放比例（钳制到 (0, 1]），之后创建的 RDGExtentClass::Scaled 纹理按此缩放宽高
+     * @note 应在创建任何缩放纹理之前调用，同一张图中的缩放纹理尺寸一致
+     */
+    void setRenderScale(float scale);
+
+    /**
+     * @brief 获取渲染缩放
+     */
+    float getRenderScale() const;
+
+    /**
+     * @brief 由输出分辨率计算本图中缩放纹理的实际尺寸（用于设置视口与裁剪）
+     */
+    vk::Extent2D getScaledExtent(vk::Extent2D outputExtent) const
+    {
+        return scaleExtent(outputExtent, getRenderScale());
+    }
+
+    /**
+     * @brief 按缩放比例计算尺寸（向上取整，各轴至少为 1）
+     */
+    static vk::Extent2D scaleExtent(vk::Extent2D extent, float scale);
+
   private:
     // ==================== 内部实现 ====================
 
@@ -0,0 +1,141 @@
+/**
+ * @file RDGCompileCache.hpp
+ * @brief 跨帧持久的渲染图编译缓存
+ * @details RDGBuilder 每帧重新构造，但帧图的拓扑结构通常逐帧不变。
+ *          RDGCompileCache 由调用者持有并在多帧之间复用，按"拓扑键"
+ *          （Pass声明、资源描述、访问列表）缓存编译结果，键的哈希只用于分桶：
+ *          - Pass 剔除结果与每个 Pass 的屏障列表
+ *          - 资源生命周期与最终布局
+ *          完整键命中时跳过全部编译阶段，仅修补外部资源与交换链句柄。
+ *          瞬态资源的物理内存由 RDGTransientAllocator 跨帧持有。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace rendercore
+{
+
+// 前向声明内部实现
+class RenderGraph;
+struct RDGCachedGraph;
+
+/**
+ * @class RDGCompileCache
+ * @brief 渲染图编译缓存（跨帧持久）
+ *
+ * @example
+ * @code
+ * // 初始化时创建一次
+ * rendercore::RDGCompileCache compileCache;
+ *
+ * // 每帧
+ * rendercore::RDGBuilder builder(device, cmdManager, allocator, &compileCache);
+ * // ... 声明 Pass ...
+ * builder.execute(&syncInfo);
+ * @endcode
+ */
+class RDGCompileCache
+{
+  public:
+    /**
+     * @brief 构造函数
+     * @param maxEntries 最多保留的拓扑条目数（超出后淘汰最久未使用的条目）
+     */
+    explicit RDGCompileCache(size_t maxEntries = 8);
+
+    /**
+     * @brief 析构函数
+     */
+    ~RDGCompileCache();
+
+    // 禁用拷贝和移动
+    RDGCompileCache(const RDGCompileCache &) = delete;
+    RDGCompileCache &operator=(const RDGCompileCache &) = delete;
+
+    /**
+     * @brief 清空所有缓存条目
+     */
+    void clear();
+
+    /**
+     * @brief 启用或禁用缓存（禁用时每帧完整编译）
+     */
+    void setEnabled(bool enabled)
+    {
+        m_enabled = enabled;
+    }
+
+    /**
+     * @brief 检查缓存是否启用
+     */
+    bool isEnabled() const
+    {
+        return m_enabled;
+    }
+
+    /**
+     * @brief 推进到下一帧（由 RenderGraph 在提交后自动调用）
+     */
+    void advanceFrame();
+
+    /**
+     * @brief 获取当前帧序号（单调递增）
+     */
+    uint64_t getFrameIndex() const
+    {
+        return m_frameIndex;
+    }
+
+    // ==================== 统计 ====================
+
+    size_t getEntryCount() const
+    {
+        return m_entries.size();
+    }
+    uint64_t getHitCount() const
+    {
+        return m_hitCount;
+    }
+    uint64_t getMissCount() const
+    {
+        return m_missCount;
+    }
+
+  private:
+    friend class RenderGraph;
+
+    /**
+     * @brief (私有) 查找拓扑键对应的条目，命中时刷新其使用时间
+     * @param topologyHash 拓扑键的哈希（查找桶）
+     * @param topologyKey 完整拓扑键（桶内逐项比较）
+     */
+    RDGCachedGraph *find(uint64_t topologyHash, const std::vector<uint64_t> &topologyKey);
+
+    /**
+     * @brief (私有) 插入新条目（必要时淘汰过期条目）
+     */
+    RDGCachedGraph &insert(uint64_t topologyHash, std::vector<uint64_t> topologyKey);
+
+    /**
+     * @brief (私有) 淘汰最久未使用的条目，直到可以再插入一个条目
+     */
+    void evictstale();
+
+  private:
+    size_t m_maxEntries;
+    bool m_enabled = true;
+
+    uint64_t m_frameIndex = 0;
+    uint64_t m_hitCount = 0;
+    uint64_t m_missCount = 0;
+
+    std::unordered_multimap<uint64_t, std::unique_ptr<RDGCachedGraph>> m_entries; ///< 按拓扑哈希分桶
+};
+
+} // namespace rendercore
@@ -0,0 +1,110 @@
+/**
+ * @file RDGEventPool.hpp
+ * @brief 跨帧持久的拆分屏障事件池
+ * @details 拆分屏障在生产者Pass之后 setEvent2、在消费者Pass之前 waitEvents2，
+ *          使两者之间的其他Pass不被屏障阻塞。事件需要跨帧存活，因此由本对象持有；
+ *          事件按 frames-in-flight 分槽，每次等待后立即在GPU上重置，槽位只在其上一帧
+ *          GPU 工作完成后复用
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+// 前向声明
+namespace vkcore
+{
+class Device;
+} // namespace vkcore
+
+namespace rendercore
+{
+
+// 前向声明内部实现
+class RenderGraph;
+
+/**
+ * @class RDGEventPool
+ * @brief 拆分屏障事件池（跨帧持久）
+ *
+ * @example
+ * @code
+ * // 初始化时创建一次
+ * rendercore::RDGEventPool eventPool(device, vkcore::SwapChain::MAX_FRAMES_IN_FLIGHT);
+ *
+ * // 每帧
+ * rendercore::RDGBuilder builder(device, cmdManager, allocator, &compileCache, &transientAllocator);
+ * builder.setEventPool(&eventPool);
+ * builder.execute(&syncInfo);
+ * @endcode
+ *
+ * @note 调用者必须保证复用某个槽位之前（即 framesInFlight 帧之后）该帧的 GPU 工作
+ *       已完成（等待帧 Fence），这与 SwapChain 的帧同步模型一致
+ */
+class RDGEventPool
+{
+  public:
+    /**
+     * @brief 构造函数
+     * @param device Vulkan设备（需要启用 synchronization2）
+     * @param framesInFlight 同时在途的帧数（决定事件槽位数）
+     */
+    explicit RDGEventPool(vkcore::Device &device, uint32_t framesInFlight = 2);
+
+    /**
+     * @brief 析构函数
+     * @warning 会销毁所有事件，调用前需确保GPU已空闲
+     */
+    ~RDGEventPool();
+
+    // 禁用拷贝和移动
+    RDGEventPool(const RDGEventPool &) = delete;
+    RDGEventPool &operator=(const RDGEventPool &) = delete;
+
+    /**
+     * @brief 获取当前帧序号（单调递增）
+     */
+    uint64_t getFrameIndex() const
+    {
+        return m_frameIndex;
+    }
+
+    /**
+     * @brief 获取当前槽位已创建的事件数量（调试用）
+     */
+    size_t getEventCount() const;
+
+  private:
+    friend class RenderGraph;
+
+    /**
+     * @struct FrameSlot
+     * @brief 一个 frame-in-flight 槽位持有的事件
+     */
+    struct FrameSlot
+    {
+        std::vector<vk::Event> events;
+        size_t usedCount = 0; ///< 本帧已取用的事件数量
+    };
+
+    /**
+     * @brief (私有) 从当前槽位取一个未触发的事件（不足时创建）
+     */
+    vk::Event acquireEvent();
+
+    /**
+     * @brief (私有) 推进到下一帧（由 RenderGraph 在提交后调用）
+     */
+    void advanceFrame();
+
+  private:
+    vkcore::Device &m_device;
+    uint32_t m_framesInFlight;
+
+    uint64_t m_frameIndex = 0;
+    std::vector<FrameSlot> m_slots;
+};
+
+} // namespace rendercore
@@ -84,6 +84,16 @@ struct RDGBufferHandle
 
 // ==================== 资源描述符 ====================
 
+/**
+ * @enum RDGExtentClass
+ * @brief 瞬态纹理尺寸的解释方式
+ */
+enum class RDGExtentClass : uint8_t
+{
+    Absolute, ///< extent 即实际尺寸
+    Scaled,   ///< extent 为输出分辨率，创建时乘以渲染图的渲染缩放（RDGBuilder::setRenderScale）
+};
+
 /**
  * @struct RDGTextureDesc
  * @brief 瞬态纹理资源的描述（用于创建）
@@ -99,6 +109,7 @@ struct RDGTextureDesc
     uint32_t arrayLayers = 1;                                      ///< 数组层数
     vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1; ///< 多重采样
     vk::ImageTiling tiling = vk::ImageTiling::eOptimal;            ///< 内存排列方式
+    RDGExtentClass extentClass = RDGExtentClass::Absolute;         ///< 尺寸类别（Scaled 时只缩放宽高）
 
     /**
      * @brief 构造函数，快速创建2D纹理描述
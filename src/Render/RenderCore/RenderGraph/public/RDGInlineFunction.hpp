@@ -0,0 +1,187 @@
+/**
+ * @file RDGInlineFunction.hpp
+ * @brief 小缓冲区优化的只移动回调类型
+ * @details 替代 std::function 保存Pass回调：捕获不超过 Capacity 字节的 Lambda 直接存放在对象内部，
+ *          不产生堆分配（std::function 通常只内联两个指针大小的捕获）；更大的捕获退回到堆上。
+ *          回调只会被移动进Pass、在录制时调用，因此不支持拷贝
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace rendercore
+{
+
+template <typename Signature, size_t Capacity = 8 * sizeof(void *)> class RDGInlineFunction;
+
+/**
+ * @class RDGInlineFunction
+ * @brief 内联存储可调用对象的函数包装器
+ *
+ * @example
+ * @code
+ * RDGInlineFunction<void(vk::CommandBuffer)> callback = [pipeline](vk::CommandBuffer cmd) {
+ *     cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+ * };
+ * callback(cmd);
+ * @endcode
+ */
+template <typename R, typename... Args, size_t Capacity> class RDGInlineFunction<R(Args...), Capacity>
+{
+  public:
+    RDGInlineFunction() noexcept = default;
+
+    RDGInlineFunction(std::nullptr_t) noexcept
+    {
+    }
+
+    /**
+     * @brief 从可调用对象构造（只接受能以 Args... 调用并返回 R 的对象，保证重载决议与 std::function 一致）
+     */
+    template <typename F, typename Fn = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<Fn, RDGInlineFunction> &&
+                                          std::is_invocable_r_v<R, Fn &, Args...>>>
+    RDGInlineFunction(F &&callable)
+    {
+        if constexpr (std::is_pointer_v<Fn> || std::is_member_pointer_v<Fn>)
+        {
+            if (callable == nullptr)
+            {
+                return;
+            }
+        }
+
+        if constexpr (isInline<Fn>())
+        {
+            ::new (static_cast<void *>(m_storage)) Fn(std::forward<F>(callable));
+            m_ops = &kInlineOps<Fn>;
+        }
+        else
+        {
+            ::new (static_cast<void *>(m_storage)) Fn *(new Fn(std::forward<F>(callable)));
+            m_ops = &kHeapOps<Fn>;
+        }
+    }
+
+    RDGInlineFunction(RDGInlineFunction &&other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    RDGInlineFunction &operator=(RDGInlineFunction &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    RDGInlineFunction &operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    RDGInlineFunction(const RDGInlineFunction &) = delete;
+    RDGInlineFunction &operator=(const RDGInlineFunction &) = delete;
+
+    ~RDGInlineFunction()
+    {
+        reset();
+    }
+
+    R operator()(Args... args) const
+    {
+        if (!m_ops)
+        {
+            throw std::bad_function_call();
+        }
+        return m_ops->invoke(const_cast<std::byte *>(m_storage), std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_ops != nullptr;
+    }
+
+    /**
+     * @brief 可调用对象是否存放在内部缓冲区中（用于统计与测试）
+     */
+    bool isInlineStorage() const noexcept
+    {
+        return m_ops && m_ops->isInline;
+    }
+
+  private:
+    /**
+     * @struct Ops
+     * @brief 按可调用对象类型生成的操作表
+     */
+    struct Ops
+    {
+        R (*invoke)(void *storage, Args &&...args);
+        void (*move)(void *dst, void *src) noexcept; ///< 移动构造到 dst 并析构 src
+        void (*destroy)(void *storage) noexcept;
+        bool isInline;
+    };
+
+    template <typename Fn> static constexpr bool isInline()
+    {
+        return sizeof(Fn) <= Capacity && alignof(Fn) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<Fn>;
+    }
+
+    template <typename Fn>
+    static constexpr Ops kInlineOps = {
+        [](void *storage, Args &&...args) -> R {
+            return std::invoke(*static_cast<Fn *>(storage), std::forward<Args>(args)...);
+        },
+        [](void *dst, void *src) noexcept {
+            ::new (dst) Fn(std::move(*static_cast<Fn *>(src)));
+            static_cast<Fn *>(src)->~Fn();
+        },
+        [](void *storage) noexcept { static_cast<Fn *>(storage)->~Fn(); },
+        true,
+    };
+
+    template <typename Fn>
+    static constexpr Ops kHeapOps = {
+        [](void *storage, Args &&...args) -> R {
+            return std::invoke(**static_cast<Fn **>(storage), std::forward<Args>(args)...);
+        },
+        [](void *dst, void *src) noexcept { ::new (dst) Fn *(*static_cast<Fn **>(src)); },
+        [](void *storage) noexcept { delete *static_cast<Fn **>(storage); },
+        false,
+    };
+
+    alignas(std::max_align_t) std::byte m_storage[Capacity];
+    const Ops *m_ops = nullptr;
+
+    void moveFrom(RDGInlineFunction &other) noexcept
+    {
+        if (other.m_ops)
+        {
+            other.m_ops->move(m_storage, other.m_storage);
+            m_ops = other.m_ops;
+            other.m_ops = nullptr;
+        }
+    }
+
+    void reset() noexcept
+    {
+        if (m_ops)
+        {
+            m_ops->destroy(m_storage);
+            m_ops = nullptr;
+        }
+    }
+};
+
+} // namespace rendercore
@@ -5,15 +5,25 @@
 
 #pragma once
 
+#include "RDGArena.hpp"
 #include "RDGHandle.hpp"
-#include <functional>
+#include "RDGInlineFunction.hpp"
 #include <string>
-#include <vector>
 #include <vulkan/vulkan.hpp>
 
 namespace rendercore
 {
 
+/**
+ * @enum RDGQueueType
+ * @brief Pass 被调度到的硬件队列
+ */
+enum class RDGQueueType : uint8_t
+{
+    Graphics,    ///< 图形队列（默认）
+    AsyncCompute ///< 专用计算队列，可与图形队列上的工作重叠执行
+};
+
 /**
  * @class RDGPass
  * @brief 渲染图中的一个Pass
@@ -21,9 +31,17 @@ namespace rendercore
 class RDGPass
 {
   public:
-    // 回调函数类型
-    using ExecuteCallback = std::function<void(vk::CommandBuffer)>;
-    using ExecuteCallbackEx = std::function<void(vk::CommandBuffer, const class RDGResourceAccessor &)>;
+    // 回调函数类型（捕获不超过 64 字节时不产生堆分配）
+    using ExecuteCallback = RDGInlineFunction<void(vk::CommandBuffer)>;
+    using ExecuteCallbackEx = RDGInlineFunction<void(vk::CommandBuffer, const class RDGResourceAccessor &)>;
+
+    /**
+     * @brief 分块并行录制回调
+     * @details 同一Pass被拆分为 chunkCount 块，每块可能在不同线程上录制到各自的次级命令缓冲区，
+     *          回调内只应录制第 chunkIndex 块对应的绘制命令（例如 draws[chunkIndex * n, ...)）
+     */
+    using ParallelExecuteCallback = RDGInlineFunction<void(vk::CommandBuffer, const class RDGResourceAccessor &,
+                                                           uint32_t chunkIndex, uint32_t chunkCount)>;
 
     // 纹理访问信息
     struct TextureAccess
@@ -62,14 +80,42 @@ class RDGPass
         vk::ClearDepthStencilValue clearValue;
     };
 
+    // 着色速率附件信息（VK_KHR_fragment_shading_rate）
+    struct ShadingRateAttachment
+    {
+        RDGTextureHandle handle;
+        vk::Extent2D texelSize; ///< 每个附件纹素覆盖的像素数
+    };
+
+    // 访问列表（存放在渲染图的帧内分配器中）
+    using TextureAccessList = RDGArenaVector<TextureAccess>;
+    using BufferAccessList = RDGArenaVector<BufferAccess>;
+    using ColorAttachmentList = RDGArenaVector<ColorAttachment>;
+
   public:
-    RDGPass(std::string name, ExecuteCallback &&callback);
-    RDGPass(std::string name, ExecuteCallbackEx &&callback);
+    /**
+     * @brief 构造函数（由 RenderGraph 在其帧内分配器中构造）
+     * @param arena 访问列表使用的分配器，必须比Pass活得久
+     */
+    RDGPass(RDGLinearArena &arena, std::string name, ExecuteCallback &&callback);
+    RDGPass(RDGLinearArena &arena, std::string name, ExecuteCallbackEx &&callback);
+    RDGPass(RDGLinearArena &arena, std::string name, uint32_t chunkCount, ParallelExecuteCallback &&callback);
 
     // 资源读依赖
     RDGPass &readTexture(RDGTextureHandle handle, vk::PipelineStageFlags stages, vk::AccessFlags access);
     RDGPass &readBuffer(RDGBufferHandle handle, vk::PipelineStageFlags stages, vk::AccessFlags access);
 
+    /**
+     * @brief 以输入附件读取本Pass颜色附件在当前像素上的内容（VK_KHR_dynamic_rendering_local_read）
+     * @details 纹理必须同时是本Pass的颜色附件（通常以 eLoad 接续前一个Pass的结果，usage 含 eInputAttachment），着色器中
+     *          input_attachment_index 等于它在颜色附件列表中的位置。图中凡是以此方式读取的纹理，
+     *          作为颜色附件时都使用 eRenderingLocalReadKHR 布局，前后Pass因此可以合并为一个渲染实例，
+     *          块内的依赖改为渲染实例内的逐区域屏障，中间结果不写回内存
+     * @note 需要设备启用 VK_KHR_dynamic_rendering_local_read（RDGBuilder::isLocalReadSupported()），
+     *       否则编译时抛出异常；不支持时改用 readTexture 采样前一个Pass的输出
+     */
+    RDGPass &readInputAttachment(RDGTextureHandle handle);
+
     // 渲染目标依赖
     RDGPass &writeColorAttachment(RDGTextureHandle handle, vk::AttachmentLoadOp loadOp = vk::AttachmentLoadOp::eClear,
                                   vk::AttachmentStoreOp storeOp = vk::AttachmentStoreOp::eStore,
@@ -86,24 +132,46 @@ class RDGPass
                                          vk::AttachmentStoreOp stencilStoreOp = vk::AttachmentStoreOp::eStore,
                                          vk::ClearDepthStencilValue clearValue = {1.0f, 0});
 
+    /**
+     * @brief 以着色速率附件决定本Pass的片段着色速率
+     * @details 附件按 eFragmentShadingRateAttachmentOptimalKHR 布局读取（同时登记为纹理读取，照常参与依赖与屏障），
+     *          开始渲染时链接到 RenderingInfo。每个纹素为 R8_UINT，值为 (log2(宽) << 2) | log2(高)。
+     *          附件尺寸须覆盖渲染区域：ceil(渲染区域 / texelSize)。只有以
+     *          PipelineBuilder::setFragmentShadingRate() 创建的管线可以在本Pass中绘制
+     * @param handle 着色速率图像（usage 含 eFragmentShadingRateAttachmentKHR）
+     * @param texelSize 纹素尺寸（介于设备的 min/maxFragmentShadingRateAttachmentTexelSize 之间）
+     * @note 需要设备启用 VK_KHR_fragment_shading_rate
+     */
+    RDGPass &setShadingRateAttachment(RDGTextureHandle handle, vk::Extent2D texelSize);
+
     // 资源写依赖（计算/存储）
     RDGPass &writeStorageTexture(RDGTextureHandle handle, vk::PipelineStageFlags stages, vk::AccessFlags access);
     RDGPass &writeStorageBuffer(RDGBufferHandle handle, vk::PipelineStageFlags stages, vk::AccessFlags access);
     RDGPass &writeTexture(RDGTextureHandle handle, vk::PipelineStageFlags stages, vk::AccessFlags access);
-    RDGPass &writeBuffer(RDGBufferHandle handle, vk::PipelineStageFlags stages, vk::AccessFlags access); // Getter 方法
+    RDGPass &writeBuffer(RDGBufferHandle handle, vk::PipelineStageFlags stages, vk::AccessFlags access);
+
+    /**
+     * @brief 将Pass标记为异步计算（调度到专用计算队列）
+     * @details 编译器会把Pass划分为按队列的提交批次，并自动插入队列族所有权转移屏障和跨队列信号量。
+     *          设备没有专用计算族、未设置 RDGAsyncComputeContext 或Pass访问导入资源时回退到图形队列
+     * @note 只有不包含附件的Pass可以标记为异步计算，否则编译时抛出异常
+     */
+    RDGPass &setAsyncCompute(bool enable = true);
+
+    // Getter 方法
     const std::string &getName() const
     {
         return m_name;
     }
-    const std::vector<TextureAccess> &getTextureReads() const
+    const TextureAccessList &getTextureReads() const
     {
         return m_textureReads;
     }
-    const std::vector<BufferAccess> &getBufferReads() const
+    const BufferAccessList &getBufferReads() const
     {
         return m_bufferReads;
     }
-    const std::vector<ColorAttachment> &getColorAttachments() const
+    const ColorAttachmentList &getColorAttachments() const
     {
         return m_colorAttachments;
     }
@@ -111,11 +179,15 @@ class RDGPass
     {
         return m_depthAttachment;
     }
-    const std::vector<TextureAccess> &getTextureWrites() const
+    const ShadingRateAttachment &getShadingRateAttachment() const
+    {
+        return m_shadingRateAttachment;
+    }
+    const TextureAccessList &getTextureWrites() const
     {
         return m_textureWrites;
     }
-    const std::vector<BufferAccess> &getBufferWrites() const
+    const BufferAccessList &getBufferWrites() const
     {
         return m_bufferWrites;
     }
@@ -132,6 +204,18 @@ class RDGPass
     {
         return m_executeCallbackEx;
     }
+    bool isParallel() const
+    {
+        return static_cast<bool>(m_parallelCallback);
+    }
+    uint32_t getChunkCount() const
+    {
+        return m_chunkCount;
+    }
+    bool isAsyncCompute() const
+    {
+        return m_asyncCompute;
+    }
 
     // Pass 类型判断
     bool isGraphicsPass() const
@@ -150,14 +234,18 @@ class RDGPass
     std::string m_name;
     ExecuteCallback m_executeCallback;
     ExecuteCallbackEx m_executeCallbackEx;
+    ParallelExecuteCallback m_parallelCallback;
     bool m_useExtendedCallback;
+    uint32_t m_chunkCount = 1;   ///< 分块录制的块数（仅并行Pass有效）
+    bool m_asyncCompute = false; ///< 是否请求调度到异步计算队列
 
-    std::vector<TextureAccess> m_textureReads;
-    std::vector<BufferAccess> m_bufferReads;
-    std::vector<ColorAttachment> m_colorAttachments;
+    TextureAccessList m_textureReads;
+    BufferAccessList m_bufferReads;
+    ColorAttachmentList m_colorAttachments;
     DepthAttachment m_depthAttachment;
-    std::vector<TextureAccess> m_textureWrites;
-    std::vector<BufferAccess> m_bufferWrites;
+    ShadingRateAttachment m_shadingRateAttachment{kInvalidTextureHandle, {}};
+    TextureAccessList m_textureWrites;
+    BufferAccessList m_bufferWrites;
 };
 
 } // namespace rendercore
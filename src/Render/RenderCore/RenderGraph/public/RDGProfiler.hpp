@@ -0,0 +1,244 @@
+/**
+ * @file RDGProfiler.hpp
+ * @brief 跨帧持久的逐Pass GPU 计时与管线统计
+ * @details RenderGraph 在每个活跃Pass前后写入 vkCmdWriteTimestamp2 查询（可选地用管线统计查询包住图形Pass），
+ *          查询池按 frames-in-flight 分槽。某个槽位在 framesInFlight 帧之后被复用时，
+ *          先以不等待的方式读回上一次的结果，再在主机端重置（hostQueryReset），因此读回从不阻塞 CPU 或 GPU
+ */
+
+#pragma once
+
+#include "RDGPass.hpp"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+// 前向声明
+namespace vkcore
+{
+class Device;
+} // namespace vkcore
+
+namespace rendercore
+{
+
+// 前向声明内部实现
+class RenderGraph;
+
+/**
+ * @struct RDGPassStatistics
+ * @brief 一个图形Pass的管线统计
+ */
+struct RDGPassStatistics
+{
+    uint64_t inputAssemblyVertices{0};
+    uint64_t inputAssemblyPrimitives{0};
+    uint64_t vertexShaderInvocations{0};
+    uint64_t clippingPrimitives{0};
+    uint64_t fragmentShaderInvocations{0};
+    uint64_t computeShaderInvocations{0};
+};
+
+/**
+ * @struct RDGPassTiming
+ * @brief 一个Pass在某一帧中的 GPU 耗时
+ */
+struct RDGPassTiming
+{
+    std::string name;
+    RDGQueueType queue{RDGQueueType::Graphics};
+    double gpuMs{0.0};            ///< 起止时间戳之差（毫秒）
+    bool hasStatistics{false};    ///< statistics 是否有效
+    RDGPassStatistics statistics; ///< 管线统计（仅图形队列上、未使用次级命令缓冲区的Pass）
+};
+
+/**
+ * @struct RDGFrameTiming
+ * @brief 一帧的逐Pass计时
+ */
+struct RDGFrameTiming
+{
+    uint64_t frameIndex{0};            ///< 录制时的帧序号（RDGProfiler::getFrameIndex()）
+    double gpuMs{0.0};                 ///< 最早开始到最晚结束的跨度（含异步计算重叠）
+    std::vector<RDGPassTiming> passes; ///< 按执行顺序排列
+};
+
+/**
+ * @class RDGProfiler
+ * @brief GPU 计时查询池（跨帧持久）
+ *
+ * @example
+ * @code
+ * // 初始化时创建一次
+ * rendercore::RDGProfiler profiler(device, vkcore::SwapChain::MAX_FRAMES_IN_FLIGHT);
+ *
+ * // 每帧
+ * builder.setProfiler(&profiler);
+ * builder.execute(&syncInfo);
+ *
+ * // 任意时刻（结果滞后 framesInFlight 帧）
+ * for (const auto &pass : profiler.getLatestFrame().passes)
+ *     std::cout << pass.name << ": " << pass.gpuMs << " ms\n";
+ * double shadowMs = profiler.getAverageTime("ShadowPass");
+ * @endcode
+ *
+ * @note 需要启用 hostQueryReset；与 RDGEventPool 相同，调用者必须保证复用槽位之前该帧的 GPU 工作已完成
+ */
+class RDGProfiler
+{
+  public:
+    /**
+     * @struct Config
+     * @brief 查询容量与历史长度
+     */
+    struct Config
+    {
+        uint32_t maxPasses = 256;        ///< 每帧最多计时的Pass数量（超出的Pass不计时）
+        bool pipelineStatistics = false; ///< 是否收集管线统计（需要 pipelineStatisticsQuery 特性）
+        size_t historyLength = 120;      ///< 保留的帧数
+    };
+
+    /**
+     * @brief 构造函数
+     * @param device Vulkan设备（需要启用 hostQueryReset，且图形队列族支持时间戳）
+     * @param framesInFlight 同时在途的帧数（决定查询池槽位数）
+     * @param config 查询配置（省略时使用默认 Config）
+     * @throws std::runtime_error 如果设备不支持时间戳查询或未启用 hostQueryReset
+     */
+    explicit RDGProfiler(vkcore::Device &device, uint32_t framesInFlight = 2);
+    RDGProfiler(vkcore::Device &device, uint32_t framesInFlight, const Config &config);
+
+    /**
+     * @brief 析构函数
+     * @warning 会销毁所有查询池，调用前需确保GPU已空闲
+     */
+    ~RDGProfiler();
+
+    // 禁用拷贝和移动
+    RDGProfiler(const RDGProfiler &) = delete;
+    RDGProfiler &operator=(const RDGProfiler &) = delete;
+
+    /**
+     * @brief 获取当前帧序号（单调递增）
+     */
+    uint64_t getFrameIndex() const
+    {
+        return m_frameIndex;
+    }
+
+    /**
+     * @brief 是否收集管线统计（配置请求且设备启用了 pipelineStatisticsQuery）
+     */
+    bool hasPipelineStatistics() const
+    {
+        return !m_slots.empty() && m_slots.front().statisticsPool;
+    }
+
+    /**
+     * @brief 获取最近一次读回的帧（尚无结果时 passes 为空）
+     */
+    const RDGFrameTiming &getLatestFrame() const
+    {
+        return m_latest;
+    }
+
+    /**
+     * @brief 获取滚动历史（旧帧在前，最多 Config::historyLength 帧）
+     */
+    const std::deque<RDGFrameTiming> &getHistory() const
+    {
+        return m_history;
+    }
+
+    /**
+     * @brief 按名称取Pass在历史中的平均耗时（毫秒，同一帧内同名Pass相加；没有记录时返回 0）
+     */
+    double getAverageTime(const std::string &passName) const;
+
+    /**
+     * @brief 获取读回时结果尚未就绪而被丢弃的帧数（非零说明调用者没有等待帧 Fence）
+     */
+    uint64_t getDroppedFrameCount() const
+    {
+        return m_droppedFrames;
+    }
+
+  private:
+    friend class RenderGraph;
+
+    /**
+     * @struct PassRecord
+     * @brief 本帧一个被计时的Pass
+     */
+    struct PassRecord
+    {
+        std::string name;
+        RDGQueueType queue;
+        bool statistics; ///< 是否录制了管线统计查询
+    };
+
+    /**
+     * @struct FrameSlot
+     * @brief 一个 frame-in-flight 槽位持有的查询池
+     */
+    struct FrameSlot
+    {
+        vk::QueryPool timestampPool;    ///< 每个Pass两个时间戳（开始/结束）
+        vk::QueryPool statisticsPool;   ///< 每个Pass一个管线统计查询（未启用时为空）
+        std::vector<PassRecord> passes; ///< 本槽位录制的Pass（读回后清空）
+        uint64_t frameIndex = 0;        ///< 录制时的帧序号
+    };
+
+    /**
+     * @brief (私有) 读回当前槽位上一次的结果并在主机端重置查询池（由 RenderGraph 在录制前调用）
+     */
+    void beginFrame();
+
+    /**
+     * @brief (私有) 为Pass分配查询（录制前在调用线程上按执行顺序调用）
+     * @param statistics 是否同时录制管线统计查询（仅在启用管线统计时生效）
+     * @return uint32_t 查询索引，超出容量或队列不支持时间戳时返回 UINT32_MAX
+     */
+    uint32_t registerPass(const std::string &name, RDGQueueType queue, uint32_t queueFamily, bool statistics);
+
+    /**
+     * @brief (私有) Pass开始：写入开始时间戳（并开始管线统计查询）
+     * @note 只访问命令缓冲区与不可变的查询池句柄，可在工作线程上并发调用
+     */
+    void writeBegin(vk::CommandBuffer cmd, uint32_t queryIndex) const;
+
+    /**
+     * @brief (私有) Pass结束：结束管线统计查询并写入结束时间戳
+     */
+    void writeEnd(vk::CommandBuffer cmd, uint32_t queryIndex) const;
+
+    /**
+     * @brief (私有) 推进到下一帧（由 RenderGraph 在提交后调用）
+     */
+    void advanceFrame();
+
+    /**
+     * @brief (私有) 读回槽位结果写入历史
+     * @return 结果是否就绪
+     */
+    bool resolve(FrameSlot &slot);
+
+  private:
+    vkcore::Device &m_device;
+    uint32_t m_framesInFlight;
+    uint32_t m_maxPasses;
+    size_t m_historyLength;
+    double m_timestampPeriod = 1.0;             ///< 每个时间戳刻度的纳秒数
+    std::vector<uint32_t> m_timestampValidBits; ///< 按队列族：时间戳有效位数（0 表示不支持）
+
+    uint64_t m_frameIndex = 0;
+    std::vector<FrameSlot> m_slots;
+
+    RDGFrameTiming m_latest;
+    std::deque<RDGFrameTiming> m_history;
+    uint64_t m_droppedFrames = 0;
+};
+
+} // namespace rendercore
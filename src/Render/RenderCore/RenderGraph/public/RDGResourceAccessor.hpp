@@ -45,7 +45,7 @@
  * // 使用纹理
  * builder.addPass("RenderPass", [externalTexture](vk::CommandBuffer cmd, RDGResourceAccessor& res) {
  *     vk::ImageView view = res.getTextureView(textureHandle);
- *     vk::Sampler sampler = externalTexture->sampler.get(); // 使用 Texture 自己的 Sampler
+ *     vk::Sampler sampler = externalTexture->sampler; // 使用 Texture 的 Sampler（来自 SamplerCache）
  *     // 创建描述符集，绑定 view + sampler
  * }).readTexture(textureHandle);
  * @endcode
@@ -143,9 +143,9 @@ class RDGResourceAccessor
     vkcore::Buffer *getBufferObject(RDGBufferHandle handle) const;
 
     /**
-     * @brief 获取缓冲区的设备地址（用于光线追踪等）
+     * @brief 获取缓冲区的设备地址（用于顶点拉取、光线追踪等）
      * @param handle 缓冲区句柄
-     * @return vk::DeviceAddress 设备地址
+     * @return vk::DeviceAddress 设备地址，如果资源无效或 RDGBufferDesc::usage 不含 eShaderDeviceAddress 则返回 0
      */
     vk::DeviceAddress getBufferDeviceAddress(RDGBufferHandle handle) const;
 
@@ -177,7 +177,7 @@ class RDGResourceAccessor
      *
      * builder.addPass("RenderPass", [externalTex](vk::CommandBuffer cmd, RDGResourceAccessor& res) {
      *     vk::ImageView view = res.getTextureView(handle);
-     *     vk::Sampler sampler = externalTex->sampler.get(); // 使用 Texture 的 Sampler
+     *     vk::Sampler sampler = externalTex->sampler; // 使用 Texture 的 Sampler
      *     // 创建描述符集并绑定...
      * }).readTexture(handle);
      * @endcode
@@ -0,0 +1,107 @@
+/**
+ * @file RDGStats.hpp
+ * @brief 渲染图的逐帧编译/执行统计
+ * @details 用于定位内存与屏障的去向：编译阶段填写Pass、屏障与批次统计（命中编译缓存时由恢复的结果重新统计），
+ *          执行阶段填写瞬态内存与资源复用统计。通过 RDGBuilder::getStats() 在 execute() 之后读取
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vulkan/vulkan.hpp>
+
+namespace rendercore
+{
+
+/**
+ * @struct RDGBarrierStats
+ * @brief 一帧中录制的屏障数量（按类型）
+ * @note 一个屏障即一个 ImageMemoryBarrier2/BufferMemoryBarrier2，同一次 pipelineBarrier2 中的多个屏障分别计数
+ */
+struct RDGBarrierStats
+{
+    uint32_t imageBarriers = 0;     ///< 图像屏障（含拆分屏障与所有权释放屏障中的图像屏障）
+    uint32_t bufferBarriers = 0;    ///< 缓冲区屏障（含拆分屏障与所有权释放屏障中的缓冲区屏障）
+    uint32_t layoutTransitions = 0; ///< 其中改变图像布局的屏障
+    uint32_t queueReleases = 0;     ///< 队列族所有权释放屏障（生产者端）
+    uint32_t queueAcquires = 0;     ///< 队列族所有权获取屏障（消费者端）
+    uint32_t splitBarriers = 0;     ///< 转为 setEvent2/waitEvents2 的屏障
+    uint32_t splitEvents = 0;       ///< 拆分屏障使用的事件数（每对生产者/消费者一个）
+    uint32_t aliasingBarriers = 0;  ///< 瞬态内存别名导致的 Pass 前额外屏障
+
+    uint32_t getTotal() const
+    {
+        return imageBarriers + bufferBarriers + aliasingBarriers;
+    }
+};
+
+/**
+ * @struct RDGGraphStats
+ * @brief 一张渲染图的统计信息
+ */
+struct RDGGraphStats
+{
+    // ==================== Pass ====================
+
+    uint32_t declaredPasses = 0;     ///< 声明的Pass数量
+    uint32_t activePasses = 0;       ///< 剔除后仍执行的Pass数量
+    uint32_t culledPasses = 0;       ///< 被剔除的Pass数量
+    uint32_t mergedPasses = 0;       ///< 并入前一个Pass渲染实例的Pass数量（省去的 beginRendering 次数）
+    uint32_t renderingInstances = 0; ///< 合并后的动态渲染实例数量
+    uint32_t asyncComputePasses = 0; ///< 调度到异步计算队列的Pass数量
+    uint32_t submitBatches = 0;      ///< 队列提交批次数量
+    uint32_t queueWaits = 0;         ///< 批次之间的跨队列信号量等待数量
+    uint32_t dependencyEdges = 0;    ///< Pass依赖边数量（命中编译缓存时不重建，为 0）
+
+    // ==================== 屏障 ====================
+
+    RDGBarrierStats barriers;
+
+    // ==================== 资源与内存 ====================
+
+    uint32_t transientTextures = 0; ///< 本帧使用的瞬态纹理数量
+    uint32_t transientBuffers = 0;  ///< 本帧使用的瞬态缓冲区数量
+    uint32_t externalTextures = 0;  ///< 导入的外部纹理数量（含交换链图像）
+    uint32_t externalBuffers = 0;   ///< 导入的外部缓冲区数量
+
+    vk::DeviceSize transientRequestedBytes = 0; ///< 每个瞬态资源各自分配时所需的内存总量
+    vk::DeviceSize transientAllocatedBytes = 0; ///< 别名后实际占用的内存（无瞬态分配器时为本帧新建资源的内存）
+    uint32_t lazyTextures = 0;                  ///< 使用惰性分配内存的瞬态纹理（不计入两项字节数）
+
+    // 资源复用：使用跨帧瞬态分配器时为其资源缓存，否则为 RDGTexturePool/RDGBufferPool
+    uint32_t textureRequests = 0; ///< 瞬态纹理请求数
+    uint32_t textureHits = 0;     ///< 其中复用已有物理纹理的数量
+    uint32_t bufferRequests = 0;  ///< 瞬态缓冲区请求数
+    uint32_t bufferHits = 0;      ///< 其中复用已有物理缓冲区的数量
+
+    // ==================== 时间 ====================
+
+    bool compileCacheHit = false; ///< 是否命中编译缓存
+    double compileMs = 0.0;       ///< compile() 的CPU耗时
+    double allocateMs = 0.0;      ///< 物理资源分配的CPU耗时
+    double recordMs = 0.0;        ///< 命令录制的CPU耗时（并行录制时为整体墙钟时间）
+    double submitMs = 0.0;        ///< 队列提交的CPU耗时
+
+    /**
+     * @brief 资源复用命中率（没有请求时为 1）
+     */
+    float getHitRate() const
+    {
+        const uint32_t requests = textureRequests + bufferRequests;
+        return requests == 0 ? 1.0f : static_cast<float>(textureHits + bufferHits) / static_cast<float>(requests);
+    }
+
+    /**
+     * @brief 别名节省的内存比例（0 表示没有节省）
+     */
+    float getAliasingSavings() const
+    {
+        if (transientRequestedBytes == 0 || transientAllocatedBytes >= transientRequestedBytes)
+        {
+            return 0.0f;
+        }
+        return 1.0f - static_cast<float>(transientAllocatedBytes) / static_cast<float>(transientRequestedBytes);
+    }
+};
+
+} // namespace rendercore
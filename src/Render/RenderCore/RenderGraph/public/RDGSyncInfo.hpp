@@ -6,7 +6,11 @@
 
 #pragma once
 
+#include "RDGPass.hpp"
+#include "VulkanCore/public/FrameTimeline.hpp"
+#include <cstdint>
 #include <optional>
+#include <utility>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
@@ -21,9 +25,28 @@ struct RDGWaitInfo
 {
     vk::Semaphore semaphore;                                                  ///< 要等待的信号量
     vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eTopOfPipe; ///< 等待的管线阶段
+    uint64_t value = 0; ///< 时间线信号量的等待值（二值信号量忽略）
 
     RDGWaitInfo() = default;
-    RDGWaitInfo(vk::Semaphore sem, vk::PipelineStageFlags stage) : semaphore(sem), waitStage(stage)
+    RDGWaitInfo(vk::Semaphore sem, vk::PipelineStageFlags stage, uint64_t waitValue = 0)
+        : semaphore(sem), waitStage(stage), value(waitValue)
+    {
+    }
+};
+
+/**
+ * @struct RDGSignalInfo
+ * @brief 触发信息，执行完成后触发某个信号量
+ */
+struct RDGSignalInfo
+{
+    vk::Semaphore semaphore;                     ///< 要触发的信号量
+    uint64_t value = 0;                          ///< 时间线信号量的触发值（二值信号量忽略）
+    RDGQueueType queue = RDGQueueType::Graphics; ///< 在该队列的最后一个批次上触发（没有时在最后一个批次上）
+
+    RDGSignalInfo() = default;
+    RDGSignalInfo(vk::Semaphore sem, uint64_t signalValue = 0, RDGQueueType signalQueue = RDGQueueType::Graphics)
+        : semaphore(sem), value(signalValue), queue(signalQueue)
     {
     }
 };
@@ -49,7 +72,7 @@ struct RDGSyncInfo
      * @brief 执行完成后要触发的信号量列表（例如 SwapChain 的 renderFinished）
      * @details 渲染图执行完成后会触发这些信号量
      */
-    std::vector<vk::Semaphore> signalSemaphores;
+    std::vector<RDGSignalInfo> signalSemaphores;
 
     /**
      * @brief 执行完成后要触发的 Fence（可选）
@@ -70,13 +93,36 @@ struct RDGSyncInfo
         waitSemaphores.emplace_back(semaphore, stage);
     }
 
+    /**
+     * @brief 添加时间线信号量等待（例如 UploadQueue 的上传票据）
+     * @param semaphore 时间线信号量
+     * @param value 需要达到的值
+     * @param stage 等待阶段
+     */
+    void addTimelineWait(vk::Semaphore semaphore, uint64_t value,
+                         vk::PipelineStageFlags stage = vk::PipelineStageFlagBits::eVertexInput)
+    {
+        waitSemaphores.emplace_back(semaphore, stage, value);
+    }
+
     /**
      * @brief 添加信号信号量
      * @param semaphore 信号量
      */
     void addSignalSemaphore(vk::Semaphore semaphore)
     {
-        signalSemaphores.push_back(semaphore);
+        signalSemaphores.emplace_back(semaphore);
+    }
+
+    /**
+     * @brief 添加时间线信号量触发（例如 RDGFrameSyncManager 的帧时间线）
+     * @param semaphore 时间线信号量
+     * @param value 触发值
+     * @param queue 在哪条队列的最后一个批次上触发
+     */
+    void addTimelineSignal(vk::Semaphore semaphore, uint64_t value, RDGQueueType queue = RDGQueueType::Graphics)
+    {
+        signalSemaphores.emplace_back(semaphore, value, queue);
     }
 
     /**
@@ -110,14 +156,38 @@ struct RDGSyncInfo
 /**
  * @class RDGFrameSyncManager
  * @brief 帧同步管理器 - 管理多帧并行（Frames in Flight）
- * @details 创建和管理用于多帧并行渲染的同步原语
+ * @details 图形队列与异步计算队列各有一条帧时间线（vkcore::FrameTimeline），第 N 帧的同步信息在
+ *          两条时间线上触发值 N；开始新的一帧时 CPU 等待时间线值而不是等待/重置栅栏。
+ *          在途帧数可在运行时调整，帧退休回调供上传、延迟销毁、查询读回等系统按帧回收资源
+ *
+ * @example
+ * @code
+ * rendercore::RDGFrameSyncManager frameSync(device.get(), 3);
+ * frameSync.addRetireCallback([&](uint64_t frame) { deletionQueue.retire(frame); });
+ *
+ * // 每帧
+ * auto [imageAvailable, renderFinished] = frameSync.getSwapChainSemaphores(frameSync.getCurrentFrameIndex());
+ * RDGSyncInfo &syncInfo = frameSync.getCurrentFrameSync(); // 已包含两条时间线的触发
+ * syncInfo.addWaitSemaphore(imageAvailable);
+ * syncInfo.addSignalSemaphore(renderFinished);
+ * builder.execute(&syncInfo);
+ * frameSync.advanceFrame(); // 等待 framesInFlight 帧之前的帧退休
+ * @endcode
+ *
+ * @warning 每一帧的同步信息都必须被提交（时间线值只能由该帧的提交触发），否则之后的等待不会返回
  */
 class RDGFrameSyncManager
 {
   public:
+    /**
+     * @typedef RetireCallback
+     * @brief 帧退休回调，参数为最新退休的帧号
+     */
+    using RetireCallback = vkcore::FrameTimeline::RetireCallback;
+
     /**
      * @brief 构造函数
-     * @param device Vulkan 设备
+     * @param device Vulkan 设备（需要启用 timelineSemaphore）
      * @param maxFramesInFlight 最大并行帧数（通常为 2 或 3）
      */
     RDGFrameSyncManager(vk::Device device, size_t maxFramesInFlight = 2);
@@ -133,13 +203,13 @@ class RDGFrameSyncManager
 
     /**
      * @brief 获取当前帧的同步信息
-     * @return 当前帧的 RDGSyncInfo 引用
+     * @return 当前帧的 RDGSyncInfo 引用（已包含帧时间线的触发）
      */
     RDGSyncInfo &getCurrentFrameSync();
 
     /**
      * @brief 前进到下一帧
-     * @details 会等待下一帧的 Fence，确保资源可以安全复用
+     * @details 等待复用同一帧索引的那一帧在所有时间线上完成，确保资源可以安全复用
      */
     void advanceFrame();
 
@@ -154,7 +224,7 @@ class RDGFrameSyncManager
      */
     size_t getCurrentFrameIndex() const
     {
-        return m_currentFrame;
+        return m_timeline.getFrameSlot();
     }
 
     /**
@@ -162,13 +232,54 @@ class RDGFrameSyncManager
      */
     size_t getMaxFramesInFlight() const
     {
-        return m_maxFramesInFlight;
+        return m_timeline.getFramesInFlight();
     }
 
     /**
-     * @brief 获取当前帧的 Fence
+     * @brief 调整最大并行帧数
+     * @details 等待设备空闲后按新的数量重建每帧信号量，并重新生成当前帧的同步信息
+     * @note 必须在 advanceFrame() 之后、填充本帧同步信息之前调用
+     * @throws std::invalid_argument 如果 maxFramesInFlight 为 0
      */
-    vk::Fence getCurrentFence() const;
+    void setMaxFramesInFlight(size_t maxFramesInFlight);
+
+    /**
+     * @brief 获取当前帧号（单调递增，从 1 开始，等于本帧触发的时间线值）
+     */
+    uint64_t getCurrentFrameNumber() const
+    {
+        return m_timeline.getFrameNumber();
+    }
+
+    /**
+     * @brief 非阻塞地查询最新退休的帧号（并派发退休回调）
+     */
+    uint64_t pollRetiredFrame()
+    {
+        return m_timeline.poll();
+    }
+
+    /**
+     * @brief 获取队列的帧时间线信号量（跨队列或外部系统等待某一帧时使用）
+     */
+    vk::Semaphore getTimelineSemaphore(RDGQueueType queue) const;
+
+    /**
+     * @brief 注册帧退休回调
+     * @return uint32_t 回调 ID
+     */
+    uint32_t addRetireCallback(RetireCallback callback)
+    {
+        return m_timeline.addRetireCallback(std::move(callback));
+    }
+
+    /**
+     * @brief 注销帧退休回调
+     */
+    void removeRetireCallback(uint32_t id)
+    {
+        m_timeline.removeRetireCallback(id);
+    }
 
     /**
      * @brief 为 SwapChain 集成创建信号量对
@@ -179,14 +290,27 @@ class RDGFrameSyncManager
 
   private:
     vk::Device m_device;
-    size_t m_maxFramesInFlight;
-    size_t m_currentFrame = 0;
+    vkcore::FrameTimeline m_timeline; ///< 图形与异步计算两条时间线
 
     // 每帧的同步原语
     std::vector<RDGSyncInfo> m_frameSyncInfos;
-    std::vector<vk::Fence> m_inFlightFences;
     std::vector<vk::Semaphore> m_imageAvailableSemaphores;
     std::vector<vk::Semaphore> m_renderFinishedSemaphores;
+
+    /**
+     * @brief 创建每帧的二值信号量
+     */
+    void createframesemaphores(size_t count);
+
+    /**
+     * @brief 销毁每帧的二值信号量
+     */
+    void destroyframesemaphores();
+
+    /**
+     * @brief 重置当前帧的同步信息，只保留帧时间线的触发
+     */
+    void resetcurrentsync();
 };
 
 } // namespace rendercore
@@ -0,0 +1,275 @@
+/**
+ * @file RDGTransientAllocator.hpp
+ * @brief 跨帧持久的瞬态资源分配器（基于生命周期的内存别名）
+ * @details 渲染图中的瞬态纹理/缓冲区只在若干连续 Pass 内存活。RDGTransientAllocator
+ *          按 Pass 索引区间对它们做区间图着色：生命周期不重叠的资源放入同一块
+ *          VMA 分配（"堆"）的重叠区间，从而共享物理内存。
+ *          - 堆与别名资源跨帧缓存，拓扑稳定时每帧零 VMA 分配
+ *          - 按 frames-in-flight 分槽，槽位只在其上一帧 GPU 工作完成后复用
+ *          - 连续 K 帧未使用的资源与堆会被淘汰
+ *          - 图像与缓冲区使用不同的堆，避免 bufferImageGranularity 冲突
+ *          - 只在单个渲染实例内作为附件使用的纹理改用惰性分配（LAZILY_ALLOCATED）内存，
+ *            在 Tile 架构 GPU 上不占用物理显存；设备不支持时退回别名堆
+ */
+
+#pragma once
+
+#include "RDGHandle.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// 前向声明
+namespace vkcore
+{
+class Device;
+class Image;
+class Buffer;
+} // namespace vkcore
+
+typedef struct VmaAllocator_T *VmaAllocator;
+typedef struct VmaAllocation_T *VmaAllocation;
+
+namespace rendercore
+{
+
+// 前向声明内部实现
+class RenderGraph;
+
+/**
+ * @struct RDGTransientStats
+ * @brief 瞬态分配器统计信息（最近一帧）
+ */
+struct RDGTransientStats
+{
+    vk::DeviceSize requestedBytes = 0; ///< 不做别名时所需的内存总量
+    vk::DeviceSize aliasedBytes = 0;   ///< 别名后实际占用的堆大小总和
+    uint32_t heapCount = 0;            ///< 本帧使用的堆数量
+    uint32_t textureCount = 0;         ///< 本帧分配的瞬态纹理数量
+    uint32_t bufferCount = 0;          ///< 本帧分配的瞬态缓冲区数量
+    uint32_t createdResources = 0;     ///< 本帧新创建的 vkcore 资源数量（缓存未命中）
+    uint32_t createdTextures = 0;      ///< 其中的纹理数量
+    uint32_t createdHeaps = 0;         ///< 本帧新分配的堆数量
+    uint32_t lazyTextureCount = 0;     ///< 本帧使用惰性分配内存的瞬态纹理数量（不计入堆）
+};
+
+/**
+ * @class RDGTransientAllocator
+ * @brief 瞬态资源分配器（跨帧持久）
+ *
+ * @example
+ * @code
+ * // 初始化时创建一次
+ * rendercore::RDGTransientAllocator transientAllocator(device, allocator, vkcore::SwapChain::MAX_FRAMES_IN_FLIGHT);
+ *
+ * // 每帧
+ * rendercore::RDGBuilder builder(device, cmdManager, allocator, &compileCache, &transientAllocator);
+ * // ... 声明 Pass ...
+ * builder.execute(&syncInfo);
+ * @endcode
+ *
+ * @note 调用者必须保证复用某个槽位之前（即 framesInFlight 帧之后）该帧的 GPU 工作
+ *       已完成（等待帧 Fence），这与 SwapChain 的帧同步模型一致
+ */
+class RDGTransientAllocator
+{
+  public:
+    /**
+     * @brief 构造函数
+     * @param device Vulkan设备
+     * @param allocator VMA分配器
+     * @param framesInFlight 同时在途的帧数（决定槽位数）
+     * @param evictAfterFrames 资源/堆连续未使用多少帧后被淘汰
+     */
+    RDGTransientAllocator(vkcore::Device &device, VmaAllocator allocator, uint32_t framesInFlight = 2,
+                          uint32_t evictAfterFrames = 120);
+
+    /**
+     * @brief 析构函数
+     * @warning 会销毁所有堆与别名资源，调用前需确保GPU已空闲
+     */
+    ~RDGTransientAllocator();
+
+    // 禁用拷贝和移动
+    RDGTransientAllocator(const RDGTransientAllocator &) = delete;
+    RDGTransientAllocator &operator=(const RDGTransientAllocator &) = delete;
+
+    /**
+     * @brief 释放所有堆与资源（例如分辨率变化后）
+     * @warning 调用前需确保GPU已空闲
+     */
+    void clear();
+
+    /**
+     * @brief 在内存压力下尽快释放缓存（例如由 vkcore::MemoryMonitor 的压力回调调用）
+     * @details 接下来的 framesInFlight 帧里，每个槽位在复用时淘汰其上一次使用中没有用到的资源与堆，
+     *          而不是等待 evictAfterFrames 帧；正在使用的资源不受影响，因此可以在任何时候调用
+     */
+    void trim();
+
+    /**
+     * @brief 获取当前帧序号（单调递增）
+     */
+    uint64_t getFrameIndex() const
+    {
+        return m_frameIndex;
+    }
+
+    /**
+     * @brief 获取 frames-in-flight 数量
+     */
+    uint32_t getFramesInFlight() const
+    {
+        return m_framesInFlight;
+    }
+
+    /**
+     * @brief 获取最近一帧的统计信息
+     */
+    const RDGTransientStats &getStats() const
+    {
+        return m_stats;
+    }
+
+    /**
+     * @brief 设备是否提供惰性分配的内存类型（桌面 GPU 通常没有）
+     */
+    bool isLazyMemorySupported() const
+    {
+        return m_lazyMemorySupported;
+    }
+
+  private:
+    friend class RenderGraph;
+
+    /**
+     * @struct Request
+     * @brief 单个瞬态资源的分配请求（由 RenderGraph 填写）
+     */
+    struct Request
+    {
+        RDGResourceHandle handle = kInvalidHandle;
+        const RDGTextureDesc *textureDesc = nullptr; ///< 纹理请求时有效
+        const RDGBufferDesc *bufferDesc = nullptr;   ///< 缓冲区请求时有效
+        uint32_t firstPass = 0;                      ///< 生命周期起点（Pass索引，含）
+        uint32_t lastPass = 0;                       ///< 生命周期终点（Pass索引，含）
+        bool lazilyAllocated = false;                ///< 只在单个渲染实例内作为附件使用（可用惰性分配内存）
+    };
+
+    /**
+     * @struct Result
+     * @brief 一帧的分配结果
+     */
+    struct Result
+    {
+        std::unordered_map<RDGResourceHandle, vkcore::Image *> textures;
+        std::unordered_map<RDGResourceHandle, vkcore::Buffer *> buffers;
+        std::vector<uint8_t> aliasingBarrierPasses; ///< 按Pass索引：是否需要在Pass前插入别名屏障
+    };
+
+    /**
+     * @struct Heap
+     * @brief 一块承载多个别名资源的 VMA 分配
+     */
+    struct Heap
+    {
+        uint64_t id = 0;
+        VmaAllocation allocation = nullptr;
+        vk::DeviceSize size = 0;
+        uint32_t memoryTypeIndex = 0;
+        uint64_t lastUsedFrame = 0;
+    };
+
+    /**
+     * @struct Placement
+     * @brief 缓存的别名资源（绑定在某个堆的某个偏移）
+     */
+    struct Placement
+    {
+        uint64_t key = 0; ///< 资源描述哈希
+        uint64_t heapId = 0;
+        vk::DeviceSize offset = 0;
+        std::unique_ptr<vkcore::Image> image;
+        std::unique_ptr<vkcore::Buffer> buffer;
+        uint64_t lastUsedFrame = 0;
+        bool inUse = false;
+    };
+
+    /**
+     * @struct FrameSlot
+     * @brief 一个 frame-in-flight 槽位持有的堆与资源
+     */
+    struct FrameSlot
+    {
+        std::vector<Heap> imageHeaps;  ///< 图像堆（按着色序号索引）
+        std::vector<Heap> bufferHeaps; ///< 缓冲区堆（按着色序号索引）
+        std::vector<Placement> placements;
+    };
+
+    /**
+     * @brief (私有) 为一帧的瞬态资源分配物理内存
+     * @param textures 纹理请求
+     * @param buffers 缓冲区请求
+     * @param passCount Pass 总数（用于别名屏障表）
+     * @param result 输出分配结果
+     */
+    void allocate(const std::vector<Request> &textures, const std::vector<Request> &buffers, uint32_t passCount,
+                  Result &result);
+
+    /**
+     * @brief (私有) 推进到下一帧（由 RenderGraph 在提交后调用）
+     */
+    void advanceFrame();
+
+    /**
+     * @brief (私有) 对一类资源做区间图着色并绑定到当前槽位的堆
+     */
+    void placerequests(FrameSlot &slot, const std::vector<Request> &requests, bool forImages, uint32_t passCount,
+                       Result &result);
+
+    /**
+     * @brief (私有) 为纹理创建（或复用）独立的惰性分配图像
+     * @return 是否成功（图像格式不支持惰性内存时返回 false，由调用者退回别名堆）
+     */
+    bool placelazy(FrameSlot &slot, const Request &request, Result &result);
+
+    /**
+     * @brief (私有) 获取（或重新分配）满足需求的堆
+     */
+    Heap &acquireheap(FrameSlot &slot, size_t ordinal, bool forImages, vk::DeviceSize size, vk::DeviceSize alignment,
+                      uint32_t memoryTypeBits);
+
+    /**
+     * @brief (私有) 销毁堆及绑定在其上的所有资源
+     */
+    void destroyheap(FrameSlot &slot, Heap &heap);
+
+    /**
+     * @brief (私有) 淘汰当前槽位中长时间未使用的资源与堆
+     */
+    void evictstale(FrameSlot &slot);
+
+    /**
+     * @brief (私有) 查询（并缓存）资源的内存需求
+     */
+    vk::MemoryRequirements getrequirements(const Request &request, uint64_t key);
+
+  private:
+    vkcore::Device &m_device;
+    VmaAllocator m_allocator;
+    uint32_t m_framesInFlight;
+    uint32_t m_evictAfterFrames;
+
+    uint64_t m_frameIndex = 0;
+    uint64_t m_nextHeapId = 1;     ///< 堆 ID 从 1 开始，0 表示不属于任何堆的惰性分配图像
+    uint64_t m_trimUntilFrame = 0; ///< 此帧之前按 framesInFlight 淘汰（trim() 设置）
+    bool m_lazyMemorySupported = false;
+
+    std::vector<FrameSlot> m_slots;
+    std::unordered_map<uint64_t, vk::MemoryRequirements> m_requirementsCache;
+    RDGTransientStats m_stats;
+};
+
+} // namespace rendercore
@@ -0,0 +1,283 @@
+#include "BindlessRegistry.hpp"
+#include "VulkanCore/public/Descriptor.hpp"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace rendercore
+{
+
+namespace
+{
+
+constexpr vk::ShaderStageFlags kBindlessStages = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+
+constexpr vk::DescriptorBindingFlags kTextureBindingFlags = vk::DescriptorBindingFlagBits::ePartiallyBound |
+                                                           vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+                                                           vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending |
+                                                           vk::DescriptorBindingFlagBits::eVariableDescriptorCount;
+
+uint32_t textureindex(const std::shared_ptr<Texture> &texture)
+{
+    return texture ? texture->bindless.index : BindlessSlot::kInvalidIndex;
+}
+
+} // namespace
+
+BindlessSlot::~BindlessSlot()
+{
+    if (auto registry = this->registry.lock(); registry && isValid())
+    {
+        registry->release(type, index);
+    }
+}
+
+// ==================== 特性查询 ====================
+
+std::vector<std::string> BindlessRegistry::getRequiredFeatures()
+{
+    return {"runtimeDescriptorArray",
+            "descriptorBindingPartiallyBound",
+            "descriptorBindingVariableDescriptorCount",
+            "descriptorBindingSampledImageUpdateAfterBind",
+            "descriptorBindingUpdateUnusedWhilePending",
+            "shaderSampledImageArrayNonUniformIndexing"};
+}
+
+bool BindlessRegistry::isSupported(const vkcore::Device &device)
+{
+    const auto features = getRequiredFeatures();
+    return std::all_of(features.begin(), features.end(),
+                       [&device](const std::string &feature) { return device.isFeatureEnabled(feature); });
+}
+
+vk::PushConstantRange BindlessRegistry::getMaterialPushConstantRange()
+{
+    return vk::PushConstantRange(kBindlessStages, 0, sizeof(uint32_t));
+}
+
+// ==================== 构造与析构 ====================
+
+BindlessRegistry::BindlessRegistry(vkcore::Device &device, VmaAllocator allocator)
+    : BindlessRegistry(device, allocator, Config{})
+{
+}
+
+BindlessRegistry::BindlessRegistry(vkcore::Device &device, VmaAllocator allocator, const Config &config)
+    : m_device(device), m_allocator(allocator), m_framesInFlight(std::max(config.framesInFlight, 1u))
+{
+    if (!isSupported(device))
+    {
+        throw std::runtime_error("BindlessRegistry: device does not enable descriptor indexing features");
+    }
+    if (config.maxTextures == 0 || config.maxMaterials == 0)
+    {
+        throw std::runtime_error("BindlessRegistry: capacities must be non-zero");
+    }
+
+    // 纹理数组长度受 UPDATE_AFTER_BIND 描述符上限约束
+    const auto properties = device.getPhysicalDevice()
+                                .getProperties2<vk::PhysicalDeviceProperties2,
+                                                vk::PhysicalDeviceDescriptorIndexingProperties>()
+                                .get<vk::PhysicalDeviceDescriptorIndexingProperties>();
+    m_textures.capacity = std::min({config.maxTextures, properties.maxDescriptorSetUpdateAfterBindSamplers,
+                                    properties.maxDescriptorSetUpdateAfterBindSampledImages,
+                                    properties.maxPerStageDescriptorUpdateAfterBindSamplers,
+                                    properties.maxPerStageDescriptorUpdateAfterBindSampledImages});
+    m_materials.capacity = config.maxMaterials;
+
+    // 布局：可变数量的纹理数组必须是编号最大的绑定
+    std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {
+        vk::DescriptorSetLayoutBinding(kMaterialBinding, vk::DescriptorType::eStorageBuffer, 1, kBindlessStages),
+        vk::DescriptorSetLayoutBinding(kTextureBinding, vk::DescriptorType::eCombinedImageSampler,
+                                       m_textures.capacity, vk::ShaderStageFlagBits::eFragment)};
+    std::array<vk::DescriptorBindingFlags, 2> bindingFlags = {vk::DescriptorBindingFlags{}, kTextureBindingFlags};
+
+    vk::DescriptorSetLayoutBindingFlagsCreateInfo flagsInfo(bindingFlags);
+    vk::DescriptorSetLayoutCreateInfo layoutInfo(vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+                                                 bindings, &flagsInfo);
+    m_setLayout = device.get().createDescriptorSetLayout(layoutInfo);
+
+    // 独立的 UPDATE_AFTER_BIND 池，只分配这一个全局集
+    std::array<vk::DescriptorPoolSize, 2> poolSizes = {
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 1),
+        vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, m_textures.capacity)};
+    m_pool = device.get().createDescriptorPool(
+        vk::DescriptorPoolCreateInfo(vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind, 1, poolSizes));
+
+    vk::DescriptorSetVariableDescriptorCountAllocateInfo countInfo(1, &m_textures.capacity);
+    vk::DescriptorSetAllocateInfo allocInfo(m_pool, 1, &m_setLayout, &countInfo);
+    m_set = device.get().allocateDescriptorSets(allocInfo).front();
+
+    // 材质参数 SSBO：持久映射（优先放在主机可见的显存中），写入后按项刷新
+    vkcore::BufferDesc desc{};
+    desc.size = static_cast<vk::DeviceSize>(m_materials.capacity) * sizeof(BindlessMaterialData);
+    desc.usageFlags = vk::BufferUsageFlagBits::eStorageBuffer;
+    desc.mapping = vkcore::BufferMapping::DeviceLocal;
+    desc.category = vkcore::MemoryCategory::Uniform;
+    m_materialBuffer = std::make_unique<vkcore::Buffer>("BindlessMaterials", device, allocator, desc);
+    m_materialData = static_cast<BindlessMaterialData *>(m_materialBuffer->getMappedData());
+    if (!m_materialData)
+    {
+        throw std::runtime_error("BindlessRegistry: failed to map material buffer");
+    }
+
+    vk::DescriptorBufferInfo materialsInfo(m_materialBuffer->get(), 0, VK_WHOLE_SIZE);
+    vkcore::DescriptorUpdater::begin(device, m_set)
+        .writeBuffer(kMaterialBinding, vk::DescriptorType::eStorageBuffer, materialsInfo)
+        .update();
+}
+
+BindlessRegistry::~BindlessRegistry()
+{
+    m_materialBuffer.reset();
+
+    // 销毁池会一并释放全局集
+    m_device.get().destroyDescriptorPool(m_pool);
+    m_device.get().destroyDescriptorSetLayout(m_setLayout);
+}
+
+// ==================== 槽位分配 ====================
+
+void BindlessRegistry::registerTexture(const std::shared_ptr<BindlessRegistry> &registry, Texture &texture)
+{
+    if (!registry)
+    {
+        throw std::invalid_argument("BindlessRegistry::registerTexture: registry is null");
+    }
+    if (!texture.image || !texture.sampler)
+    {
+        throw std::invalid_argument("BindlessRegistry::registerTexture: texture has no image or sampler");
+    }
+
+    std::lock_guard<std::mutex> lock(registry->m_mtx);
+    if (!texture.bindless.isValid())
+    {
+        texture.bindless.index = allocateslot(registry->m_textures);
+        texture.bindless.type = BindlessSlotType::Texture;
+        texture.bindless.registry = registry;
+    }
+    registry->writetexture(texture.bindless.index, texture);
+}
+
+void BindlessRegistry::registerMaterial(const std::shared_ptr<BindlessRegistry> &registry, Material &material)
+{
+    if (!registry)
+    {
+        throw std::invalid_argument("BindlessRegistry::registerMaterial: registry is null");
+    }
+
+    std::lock_guard<std::mutex> lock(registry->m_mtx);
+    if (!material.bindless.isValid())
+    {
+        material.bindless.index = allocateslot(registry->m_materials);
+        material.bindless.type = BindlessSlotType::Material;
+        material.bindless.registry = registry;
+    }
+    registry->writematerial(material.bindless.index, material);
+    material.descriptorSet = registry->m_set;
+}
+
+void BindlessRegistry::updateMaterial(const Material &material)
+{
+    if (!material.bindless.isValid())
+    {
+        throw std::invalid_argument("BindlessRegistry::updateMaterial: material is not registered");
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    writematerial(material.bindless.index, material);
+}
+
+void BindlessRegistry::release(BindlessSlotType type, uint32_t index)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_pendingFrees.push_back({type, index, m_frame});
+}
+
+void BindlessRegistry::advanceFrame()
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    ++m_frame;
+
+    // 归还时录制的帧都已完成后，槽位才回到空闲表
+    auto retired = std::stable_partition(m_pendingFrees.begin(), m_pendingFrees.end(),
+                                         [this](const PendingFree &pending) {
+                                             return m_frame < pending.frame + m_framesInFlight;
+                                         });
+    for (auto it = retired; it != m_pendingFrees.end(); ++it)
+    {
+        SlotList &slots = it->type == BindlessSlotType::Texture ? m_textures : m_materials;
+        slots.free.push_back(it->index);
+        --slots.used;
+    }
+    m_pendingFrees.erase(retired, m_pendingFrees.end());
+}
+
+BindlessRegistry::Stats BindlessRegistry::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    Stats stats;
+    stats.textureCount = m_textures.used;
+    stats.textureCapacity = m_textures.capacity;
+    stats.materialCount = m_materials.used;
+    stats.materialCapacity = m_materials.capacity;
+    stats.pendingFrees = static_cast<uint32_t>(m_pendingFrees.size());
+    return stats;
+}
+
+// ==================== 私有辅助函数 ====================
+
+uint32_t BindlessRegistry::allocateslot(SlotList &slots)
+{
+    uint32_t index = 0;
+    if (!slots.free.empty())
+    {
+        index = slots.free.back();
+        slots.free.pop_back();
+    }
+    else if (slots.next < slots.capacity)
+    {
+        index = slots.next++;
+    }
+    else
+    {
+        throw std::runtime_error("BindlessRegistry: out of bindless slots (capacity " +
+                                 std::to_string(slots.capacity) + ")");
+    }
+
+    ++slots.used;
+    return index;
+}
+
+void BindlessRegistry::writetexture(uint32_t index, const Texture &texture)
+{
+    vk::DescriptorImageInfo imageInfo(texture.sampler, texture.image->getView(),
+                                      vk::ImageLayout::eShaderReadOnlyOptimal);
+    vk::WriteDescriptorSet write(m_set, kTextureBinding, index, 1, vk::DescriptorType::eCombinedImageSampler,
+                                 &imageInfo);
+    m_device.get().updateDescriptorSets(write, {});
+}
+
+void BindlessRegistry::writematerial(uint32_t index, const Material &material)
+{
+    BindlessMaterialData data = {};
+    data.baseColorFactor = material.baseColorFactor;
+    data.emissiveFactor = material.emissiveFactor;
+    data.metallicFactor = material.metallicFactor;
+    data.roughnessFactor = material.roughnessFactor;
+    data.normalScale = material.normalScale;
+    data.alphaCutoff = material.alphaCutoff;
+    data.baseColorTexture = textureindex(material.baseColorTexture);
+    data.metallicTexture = textureindex(material.metallicTexture);
+    data.roughnessTexture = textureindex(material.roughnessTexture);
+    data.normalTexture = textureindex(material.normalTexture);
+    data.occlusionTexture = textureindex(material.occlusionTexture);
+    data.emissiveTexture = textureindex(material.emissiveTexture);
+
+    m_materialData[index] = data;
+    m_materialBuffer->flush(sizeof(BindlessMaterialData), index * sizeof(BindlessMaterialData));
+}
+
+} // namespace rendercore
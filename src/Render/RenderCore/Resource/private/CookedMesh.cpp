@@ -0,0 +1,286 @@
+#include "CookedMesh.hpp"
+#include "ResourceManagerUtils.hpp"
+#include "VulkanCore/public/MappedFile.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @file CookedMesh.cpp
+ * @brief CookedMesh 的实现文件
+ */
+
+namespace rendercore
+{
+
+namespace
+{
+
+constexpr char kMagic[4] = {'Q', 'T', 'M', 'C'};
+constexpr uint64_t kSectionAlignment = 16; ///< 各数据段的对齐（满足 Vertex 的对齐并便于 SIMD 读取）
+
+static_assert(std::is_trivially_copyable_v<Vertex>, "Vertex must be trivially copyable to be cooked");
+static_assert(std::is_trivially_copyable_v<CookedMeshHeader> && sizeof(CookedMeshHeader) % kSectionAlignment == 0,
+              "CookedMeshHeader must keep the vertex section aligned");
+static_assert(sizeof(CookedSubmesh) == 64, "CookedSubmesh layout is part of the file format");
+static_assert(sizeof(CookedLod) == 16, "CookedLod layout is part of the file format");
+
+uint64_t alignup(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief FNV-1a 64 位哈希
+ */
+uint64_t hashstring(const std::string &text)
+{
+    uint64_t hash = 1469598103934665603ull;
+    for (unsigned char c : text)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief 源文件的绝对、规范化路径哈希（同一文件无论以何种相对路径引用都得到相同的键）
+ */
+uint64_t hashsourcepath(const std::filesystem::path &sourcePath)
+{
+    std::error_code ec;
+    std::filesystem::path absolutePath = std::filesystem::absolute(sourcePath, ec);
+    return hashstring((ec ? sourcePath : absolutePath).lexically_normal().generic_string());
+}
+
+/**
+ * @brief 读取源文件的大小与修改时间
+ */
+bool statsource(const std::filesystem::path &sourcePath, uint64_t &size, int64_t &mtime)
+{
+    std::error_code ec;
+    size = std::filesystem::file_size(sourcePath, ec);
+    if (ec)
+    {
+        return false;
+    }
+    auto writeTime = std::filesystem::last_write_time(sourcePath, ec);
+    if (ec)
+    {
+        return false;
+    }
+    mtime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+/**
+ * @brief 段 [offset, offset + count * stride) 是否完整地落在文件内且已对齐
+ */
+bool sectionfits(uint64_t offset, uint64_t count, uint64_t stride, uint64_t fileSize)
+{
+    if (offset % kSectionAlignment != 0 || offset > fileSize)
+    {
+        return false;
+    }
+    return count <= (fileSize - offset) / stride;
+}
+
+void writepadding(std::ofstream &out, uint64_t &position, uint64_t alignment)
+{
+    static const char zeros[kSectionAlignment] = {};
+    uint64_t aligned = alignup(position, alignment);
+    out.write(zeros, static_cast<std::streamsize>(aligned - position));
+    position = aligned;
+}
+
+} // namespace
+
+std::filesystem::path CookedMesh::getCookedPath(const std::filesystem::path &cacheDirectory,
+                                                const std::filesystem::path &sourcePath)
+{
+    char hashText[17];
+    std::snprintf(hashText, sizeof(hashText), "%016llx",
+                  static_cast<unsigned long long>(hashsourcepath(sourcePath)));
+
+    return cacheDirectory / (sourcePath.stem().string() + "_" + hashText + ".qtmesh");
+}
+
+std::optional<CookedMesh::View> CookedMesh::open(const vkcore::MappedFile &file, const std::filesystem::path &sourcePath,
+                                                 uint32_t lodSettingsHash)
+{
+    const uint64_t fileSize = file.size();
+    if (fileSize < sizeof(CookedMeshHeader))
+    {
+        return std::nullopt;
+    }
+
+    CookedMeshHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    // 格式与顶点布局
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.vertexStride != sizeof(Vertex) || header.lodSettingsHash != lodSettingsHash)
+    {
+        return std::nullopt;
+    }
+
+    // 源文件是否仍是烘焙时的那一份
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (header.sourceHash != hashsourcepath(sourcePath) || !statsource(sourcePath, sourceSize, sourceMtime) ||
+        header.sourceSize != sourceSize || header.sourceMtime != sourceMtime)
+    {
+        return std::nullopt;
+    }
+
+    // 各段边界（防止截断或损坏的文件越界读取）
+    if (!sectionfits(header.vertexOffset, header.vertexCount, sizeof(Vertex), fileSize) ||
+        !sectionfits(header.indexOffset, header.indexCount, sizeof(uint32_t), fileSize) ||
+        !sectionfits(header.submeshOffset, header.submeshCount, sizeof(CookedSubmesh), fileSize) ||
+        !sectionfits(header.lodOffset, header.lodCount, sizeof(CookedLod), fileSize))
+    {
+        return std::nullopt;
+    }
+
+    View view;
+    view.vertices = reinterpret_cast<const Vertex *>(file.data() + header.vertexOffset);
+    view.vertexCount = header.vertexCount;
+    view.indices = reinterpret_cast<const uint32_t *>(file.data() + header.indexOffset);
+    view.indexCount = header.indexCount;
+
+    // 子网格表很小，拷贝出来即可
+    view.submeshes.reserve(header.submeshCount);
+    for (uint32_t i = 0; i < header.submeshCount; ++i)
+    {
+        CookedSubmesh cooked;
+        std::memcpy(&cooked, file.data() + header.submeshOffset + i * sizeof(CookedSubmesh), sizeof(cooked));
+
+        if (static_cast<uint64_t>(cooked.firstIndex) + cooked.indexCount > header.indexCount ||
+            static_cast<uint64_t>(cooked.firstVertex) + cooked.vertexCount > header.vertexCount)
+        {
+            return std::nullopt;
+        }
+
+        Submesh submesh;
+        submesh.name.assign(cooked.name, strnlen(cooked.name, sizeof(cooked.name)));
+        submesh.firstIndex = cooked.firstIndex;
+        submesh.indexCount = cooked.indexCount;
+        submesh.firstVertex = cooked.firstVertex;
+        submesh.vertexCount = cooked.vertexCount;
+        view.submeshes.push_back(std::move(submesh));
+    }
+
+    view.lods.reserve(header.lodCount);
+    for (uint32_t i = 0; i < header.lodCount; ++i)
+    {
+        CookedLod cooked;
+        std::memcpy(&cooked, file.data() + header.lodOffset + i * sizeof(CookedLod), sizeof(cooked));
+
+        if (static_cast<uint64_t>(cooked.firstIndex) + cooked.indexCount > header.indexCount)
+        {
+            return std::nullopt;
+        }
+        view.lods.push_back({cooked.firstIndex, cooked.indexCount, cooked.error});
+    }
+
+    return view;
+}
+
+bool CookedMesh::write(const std::filesystem::path &cookedPath, const std::filesystem::path &sourcePath,
+                       const MeshData &meshData, const std::vector<Submesh> &submeshes,
+                       const std::vector<MeshLod> &lods, uint32_t lodSettingsHash)
+{
+    CookedMeshHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.vertexStride = sizeof(Vertex);
+    header.submeshCount = static_cast<uint32_t>(submeshes.size());
+    header.sourceHash = hashsourcepath(sourcePath);
+    if (!statsource(sourcePath, header.sourceSize, header.sourceMtime))
+    {
+        return false;
+    }
+    header.vertexCount = meshData.vertices.size();
+    header.indexCount = meshData.indices.size();
+    header.vertexOffset = alignup(sizeof(CookedMeshHeader), kSectionAlignment);
+    header.indexOffset = alignup(header.vertexOffset + meshData.getVertexDataSize(), kSectionAlignment);
+    header.submeshOffset = alignup(header.indexOffset + meshData.getIndexDataSize(), kSectionAlignment);
+    header.lodCount = static_cast<uint32_t>(lods.size());
+    header.lodSettingsHash = lodSettingsHash;
+    header.lodOffset = alignup(header.submeshOffset + submeshes.size() * sizeof(CookedSubmesh), kSectionAlignment);
+
+    std::error_code ec;
+    std::filesystem::create_directories(cookedPath.parent_path(), ec);
+
+    // 临时文件名带线程标识，并发烘焙时互不覆盖
+    std::filesystem::path tempPath = cookedPath;
+    tempPath += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+
+        uint64_t position = 0;
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        position += sizeof(header);
+
+        writepadding(out, position, kSectionAlignment);
+        out.write(reinterpret_cast<const char *>(meshData.vertices.data()),
+                  static_cast<std::streamsize>(meshData.getVertexDataSize()));
+        position += meshData.getVertexDataSize();
+
+        writepadding(out, position, kSectionAlignment);
+        out.write(reinterpret_cast<const char *>(meshData.indices.data()),
+                  static_cast<std::streamsize>(meshData.getIndexDataSize()));
+        position += meshData.getIndexDataSize();
+
+        writepadding(out, position, kSectionAlignment);
+        for (const Submesh &submesh : submeshes)
+        {
+            CookedSubmesh cooked{};
+            cooked.firstIndex = submesh.firstIndex;
+            cooked.indexCount = submesh.indexCount;
+            cooked.firstVertex = submesh.firstVertex;
+            cooked.vertexCount = submesh.vertexCount;
+            std::memcpy(cooked.name, submesh.name.data(), std::min(submesh.name.size(), sizeof(cooked.name) - 1));
+            out.write(reinterpret_cast<const char *>(&cooked), sizeof(cooked));
+        }
+        position += submeshes.size() * sizeof(CookedSubmesh);
+
+        writepadding(out, position, kSectionAlignment);
+        for (const MeshLod &lod : lods)
+        {
+            CookedLod cooked{};
+            cooked.firstIndex = lod.firstIndex;
+            cooked.indexCount = lod.indexCount;
+            cooked.error = lod.error;
+            out.write(reinterpret_cast<const char *>(&cooked), sizeof(cooked));
+        }
+
+        if (!out)
+        {
+            out.close();
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    // 重命名是原子的：读者要么看到旧文件，要么看到完整的新文件
+    std::filesystem::rename(tempPath, cookedPath, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace rendercore
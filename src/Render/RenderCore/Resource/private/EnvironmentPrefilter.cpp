@@ -0,0 +1,646 @@
+#include "EnvironmentPrefilter.hpp"
+#include "VulkanCore/public/CommandPoolManager.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include "VulkanCore/public/MappedFile.hpp"
+#include "VulkanCore/public/SamplerCache.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @file EnvironmentPrefilter.cpp
+ * @brief EnvironmentPrefilter 的实现文件
+ */
+
+namespace rendercore
+{
+
+namespace
+{
+
+constexpr char kMagic[4] = {'Q', 'T', 'E', 'V'};
+constexpr uint64_t kSectionAlignment = 16;
+constexpr uint32_t kFaceCount = 6;
+
+// 描述符绑定与模式，需与 environment_prefilter.comp 一致
+constexpr uint32_t kEquirectBinding = 0;
+constexpr uint32_t kEnvironmentBinding = 1;
+constexpr uint32_t kTargetBinding = 2;
+
+constexpr uint32_t kModeEquirect = 0;
+constexpr uint32_t kModeIrradiance = 1;
+constexpr uint32_t kModeSpecular = 2;
+
+static_assert(std::is_trivially_copyable_v<EnvironmentCacheHeader> &&
+                  sizeof(EnvironmentCacheHeader) % kSectionAlignment == 0,
+              "EnvironmentCacheHeader must keep the specular section aligned");
+
+/**
+ * @struct PrefilterPush
+ * @brief 推送常量（布局需与 environment_prefilter.comp 的 PrefilterPush 一致）
+ */
+struct PrefilterPush
+{
+    uint32_t mode;
+    uint32_t faceSize;
+    uint32_t sampleCount;
+    float roughness;
+    float sourceSize;
+    float sourceMips;
+};
+
+uint64_t alignup(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief FNV-1a 64 位哈希
+ */
+uint64_t hashstring(const std::string &text)
+{
+    uint64_t hash = 1469598103934665603ull;
+    for (unsigned char c : text)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief 源文件的绝对、规范化路径哈希（同一文件无论以何种相对路径引用都得到相同的键）
+ */
+uint64_t hashsourcepath(const std::filesystem::path &sourcePath)
+{
+    std::error_code ec;
+    std::filesystem::path absolutePath = std::filesystem::absolute(sourcePath, ec);
+    return hashstring((ec ? sourcePath : absolutePath).lexically_normal().generic_string());
+}
+
+/**
+ * @brief 读取源文件的大小与修改时间
+ */
+bool statsource(const std::filesystem::path &sourcePath, uint64_t &size, int64_t &mtime)
+{
+    std::error_code ec;
+    size = std::filesystem::file_size(sourcePath, ec);
+    if (ec)
+    {
+        return false;
+    }
+    auto writeTime = std::filesystem::last_write_time(sourcePath, ec);
+    if (ec)
+    {
+        return false;
+    }
+    mtime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+/**
+ * @brief 段 [offset, offset + bytes) 是否完整地落在文件内且已对齐
+ */
+bool sectionfits(uint64_t offset, uint64_t bytes, uint64_t fileSize)
+{
+    if (offset % kSectionAlignment != 0 || offset > fileSize)
+    {
+        return false;
+    }
+    return bytes <= fileSize - offset;
+}
+
+void writepadding(std::ofstream &out, uint64_t &position, uint64_t alignment)
+{
+    static const char zeros[kSectionAlignment] = {};
+    uint64_t aligned = alignup(position, alignment);
+    out.write(zeros, static_cast<std::streamsize>(aligned - position));
+    position = aligned;
+}
+
+vk::ImageSubresourceRange colorrange(uint32_t baseLevel, uint32_t levelCount)
+{
+    return vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, baseLevel, levelCount, 0, kFaceCount);
+}
+
+vk::ImageMemoryBarrier2 makebarrier(const vkcore::Image &image, const vk::ImageSubresourceRange &range,
+                                    vk::PipelineStageFlags2 srcStage, vk::AccessFlags2 srcAccess,
+                                    vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess,
+                                    vk::ImageLayout oldLayout, vk::ImageLayout newLayout)
+{
+    vk::ImageMemoryBarrier2 barrier{};
+    barrier.srcStageMask = srcStage;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstStageMask = dstStage;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image.get();
+    barrier.subresourceRange = range;
+    return barrier;
+}
+
+void recordbarriers(vk::CommandBuffer cmd, const std::vector<vk::ImageMemoryBarrier2> &barriers)
+{
+    vk::DependencyInfo dependencyInfo{};
+    dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
+    dependencyInfo.pImageMemoryBarriers = barriers.data();
+    cmd.pipelineBarrier2(dependencyInfo);
+}
+
+/**
+ * @brief 从 mip 0 逐级 blit 生成中间立方体的其余 mip，结束时全部 mip 处于计算着色器可读的布局
+ * @details 进入时 mip 0 刚由计算着色器写入，全部 mip 处于 eGeneral
+ */
+void recordsourcemips(vk::CommandBuffer cmd, const vkcore::Image &source)
+{
+    constexpr auto kCompute = vk::PipelineStageFlagBits2::eComputeShader;
+    constexpr auto kBlit = vk::PipelineStageFlagBits2::eBlit;
+    const uint32_t mipLevels = source.getMipLevels();
+
+    std::vector<vk::ImageMemoryBarrier2> barriers;
+    barriers.push_back(makebarrier(source, colorrange(0, 1), kCompute, vk::AccessFlagBits2::eShaderStorageWrite,
+                                   kBlit, vk::AccessFlagBits2::eTransferRead, vk::ImageLayout::eGeneral,
+                                   vk::ImageLayout::eTransferSrcOptimal));
+    if (mipLevels > 1)
+    {
+        // 其余 mip 尚未写入，只需布局转换
+        barriers.push_back(makebarrier(source, colorrange(1, mipLevels - 1), kCompute, vk::AccessFlagBits2::eNone,
+                                       kBlit, vk::AccessFlagBits2::eTransferWrite, vk::ImageLayout::eGeneral,
+                                       vk::ImageLayout::eTransferDstOptimal));
+    }
+    recordbarriers(cmd, barriers);
+
+    int32_t mipSize = static_cast<int32_t>(source.getExtent().width);
+    for (uint32_t level = 1; level < mipLevels; ++level)
+    {
+        const int32_t nextSize = std::max(mipSize / 2, 1);
+
+        vk::ImageBlit blit{};
+        blit.srcSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level - 1, 0, kFaceCount);
+        blit.srcOffsets[1] = vk::Offset3D{mipSize, mipSize, 1};
+        blit.dstSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level, 0, kFaceCount);
+        blit.dstOffsets[1] = vk::Offset3D{nextSize, nextSize, 1};
+        cmd.blitImage(source.get(), vk::ImageLayout::eTransferSrcOptimal, source.get(),
+                      vk::ImageLayout::eTransferDstOptimal, blit, vk::Filter::eLinear);
+
+        recordbarriers(cmd, {makebarrier(source, colorrange(level, 1), kBlit, vk::AccessFlagBits2::eTransferWrite,
+                                         kBlit, vk::AccessFlagBits2::eTransferRead,
+                                         vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eTransferSrcOptimal)});
+        mipSize = nextSize;
+    }
+
+    recordbarriers(cmd, {makebarrier(source, colorrange(0, mipLevels), kBlit, vk::AccessFlagBits2::eTransferWrite,
+                                     kCompute, vk::AccessFlagBits2::eShaderSampledRead,
+                                     vk::ImageLayout::eTransferSrcOptimal, vk::ImageLayout::eShaderReadOnlyOptimal)});
+}
+
+void dispatchfaces(vk::CommandBuffer cmd, const vkcore::Pipeline &pipeline, vk::DescriptorSet set,
+                   const PrefilterPush &push)
+{
+    const uint32_t groups = (push.faceSize + EnvironmentPrefilter::kWorkgroupSize - 1) /
+                            EnvironmentPrefilter::kWorkgroupSize;
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipeline.getLayout(), 0, set, nullptr);
+    cmd.pushConstants(pipeline.getLayout(), vk::ShaderStageFlagBits::eCompute, 0, sizeof(push), &push);
+    cmd.dispatch(groups, groups, kFaceCount);
+}
+
+} // namespace
+
+EnvironmentPrefilter::EnvironmentPrefilter(vkcore::Device &device, VmaAllocator allocator,
+                                           vkcore::DescriptorLayoutCache &layoutCache,
+                                           vkcore::SamplerCache &samplerCache,
+                                           std::shared_ptr<vkcore::ShaderModule> shader)
+    : m_device(device), m_allocator(allocator), m_samplerCache(samplerCache)
+{
+    if (!shader)
+    {
+        throw std::invalid_argument("EnvironmentPrefilter: shader must not be null");
+    }
+
+    const vk::FormatFeatureFlags required =
+        vk::FormatFeatureFlagBits::eStorageImage | vk::FormatFeatureFlagBits::eSampledImage |
+        vk::FormatFeatureFlagBits::eSampledImageFilterLinear | vk::FormatFeatureFlagBits::eBlitSrc |
+        vk::FormatFeatureFlagBits::eBlitDst;
+    if ((device.getPhysicalDevice().getFormatProperties(kFormat).optimalTilingFeatures & required) != required)
+    {
+        throw std::runtime_error("EnvironmentPrefilter: R16G16B16A16_SFLOAT storage images or blits unsupported");
+    }
+
+    constexpr vk::ShaderStageFlags kComputeStage = vk::ShaderStageFlagBits::eCompute;
+    m_setLayout = vkcore::DescriptorLayoutBuilder::begin(&layoutCache)
+                      .addBinding(kEquirectBinding, vk::DescriptorType::eCombinedImageSampler, kComputeStage)
+                      .addBinding(kEnvironmentBinding, vk::DescriptorType::eCombinedImageSampler, kComputeStage)
+                      .addBinding(kTargetBinding, vk::DescriptorType::eStorageImage, kComputeStage)
+                      .build();
+
+    m_pipeline = vkcore::ComputePipelineBuilder(device)
+                     .setShaderModule(std::move(shader))
+                     .addDescriptorSetLayout(m_setLayout)
+                     .addPushConstant(vk::PushConstantRange(kComputeStage, 0, sizeof(PrefilterPush)))
+                     .build();
+
+    m_descriptorAllocator = std::make_unique<vkcore::DescriptorAllocator>(device, &layoutCache);
+}
+
+EnvironmentPrefilter::~EnvironmentPrefilter() = default;
+
+// ==================== 尺寸 ====================
+
+void EnvironmentPrefilter::validate(const Settings &settings)
+{
+    if (!std::has_single_bit(settings.specularSize) || !std::has_single_bit(settings.irradianceSize))
+    {
+        throw std::invalid_argument("EnvironmentPrefilter: cubemap sizes must be powers of two");
+    }
+    if (settings.specularMipCount == 0 ||
+        settings.specularMipCount > static_cast<uint32_t>(std::bit_width(settings.specularSize)))
+    {
+        throw std::invalid_argument("EnvironmentPrefilter: specularMipCount out of range");
+    }
+    if (settings.sampleCount == 0)
+    {
+        throw std::invalid_argument("EnvironmentPrefilter: sampleCount must be greater than 0");
+    }
+}
+
+size_t EnvironmentPrefilter::getCubemapBytes(uint32_t size, uint32_t mipCount)
+{
+    size_t bytes = 0;
+    for (uint32_t level = 0; level < mipCount; ++level)
+    {
+        const size_t side = std::max(size >> level, 1u);
+        bytes += side * side * kPixelBytes * kFaceCount;
+    }
+    return bytes;
+}
+
+std::vector<vk::BufferImageCopy> EnvironmentPrefilter::getCopyRegions(uint32_t size, uint32_t mipCount,
+                                                                      vk::DeviceSize offset)
+{
+    std::vector<vk::BufferImageCopy> regions;
+    regions.reserve(mipCount);
+    for (uint32_t level = 0; level < mipCount; ++level)
+    {
+        const uint32_t side = std::max(size >> level, 1u);
+
+        vk::BufferImageCopy region{};
+        region.bufferOffset = offset;
+        region.imageSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level, 0, kFaceCount);
+        region.imageExtent = vk::Extent3D{side, side, 1};
+        regions.push_back(region);
+
+        offset += static_cast<vk::DeviceSize>(side) * side * kPixelBytes * kFaceCount;
+    }
+    return regions;
+}
+
+std::shared_ptr<vkcore::Image> EnvironmentPrefilter::createCubemap(const std::string &name, vkcore::Device &device,
+                                                                   VmaAllocator allocator, uint32_t size,
+                                                                   uint32_t mipCount)
+{
+    vkcore::ImageDesc desc{};
+    desc.format = kFormat;
+    desc.extent = vk::Extent3D{size, size, 1};
+    desc.mipLevels = mipCount;
+    desc.arrayLayers = kFaceCount;
+    desc.cubeCompatible = true;
+    desc.usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eStorage |
+                 vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst;
+    desc.category = vkcore::MemoryCategory::Texture;
+    return std::make_shared<vkcore::Image>(name, device, allocator, desc);
+}
+
+// ==================== 预过滤 ====================
+
+vk::DescriptorSet EnvironmentPrefilter::writeset(const vkcore::Image &target, uint32_t level,
+                                                 vk::DescriptorImageInfo equirectInfo,
+                                                 vk::DescriptorImageInfo environmentInfo,
+                                                 std::vector<vk::ImageView> &views)
+{
+    // 存储图像按 2D 数组视图写入：一次分发覆盖 6 个面（gl_GlobalInvocationID.z 为面索引）
+    vk::ImageViewCreateInfo viewInfo{};
+    viewInfo.image = target.get();
+    viewInfo.viewType = vk::ImageViewType::e2DArray;
+    viewInfo.format = kFormat;
+    viewInfo.subresourceRange = colorrange(level, 1);
+    views.push_back(m_device.get().createImageView(viewInfo));
+
+    const vk::DescriptorImageInfo targetInfo(nullptr, views.back(), vk::ImageLayout::eGeneral);
+    const vk::DescriptorSet set = m_descriptorAllocator->allocate(m_setLayout);
+    vkcore::DescriptorUpdater::begin(m_device, set)
+        .writeImage(kEquirectBinding, vk::DescriptorType::eCombinedImageSampler, equirectInfo)
+        .writeImage(kEnvironmentBinding, vk::DescriptorType::eCombinedImageSampler, environmentInfo)
+        .writeImage(kTargetBinding, vk::DescriptorType::eStorageImage, targetInfo)
+        .update();
+    return set;
+}
+
+EnvironmentPrefilter::Result EnvironmentPrefilter::run(vkcore::CommandPoolManager &commands,
+                                                       const vkcore::Image &equirect, vk::Sampler equirectSampler,
+                                                       const Settings &settings, std::vector<std::byte> *cacheData)
+{
+    validate(settings);
+
+    // 中间立方体与镜面同尺寸，带完整 mip 链供滤波重要性采样按样本立体角选取
+    const uint32_t sourceMips = static_cast<uint32_t>(std::bit_width(settings.specularSize));
+    std::shared_ptr<vkcore::Image> source =
+        createCubemap("EnvironmentSource", m_device, m_allocator, settings.specularSize, sourceMips);
+
+    Result result;
+    result.specular = createCubemap("EnvironmentSpecular", m_device, m_allocator, settings.specularSize,
+                                    settings.specularMipCount);
+    result.irradiance = createCubemap("EnvironmentIrradiance", m_device, m_allocator, settings.irradianceSize, 1);
+
+    const vk::Sampler cubeSampler = m_samplerCache.getOrCreate(
+        vkcore::SamplerCache::makeInfo(vk::Filter::eLinear, vk::SamplerAddressMode::eClampToEdge));
+    const vk::DescriptorImageInfo equirectInfo(equirectSampler, equirect.getView(),
+                                               vk::ImageLayout::eShaderReadOnlyOptimal);
+
+    // 描述符集在录制前全部写好：重采样时中间立方体整体处于 eGeneral，之后两次卷积时处于只读布局
+    std::vector<vk::ImageView> views;
+    const vk::DescriptorSet equirectSet =
+        writeset(*source, 0, equirectInfo, vk::DescriptorImageInfo(cubeSampler, source->getView(),
+                                                                   vk::ImageLayout::eGeneral),
+                 views);
+    const vk::DescriptorImageInfo environmentInfo(cubeSampler, source->getView(),
+                                                  vk::ImageLayout::eShaderReadOnlyOptimal);
+    std::vector<vk::DescriptorSet> specularSets;
+    for (uint32_t level = 0; level < settings.specularMipCount; ++level)
+    {
+        specularSets.push_back(writeset(*result.specular, level, equirectInfo, environmentInfo, views));
+    }
+    const vk::DescriptorSet irradianceSet = writeset(*result.irradiance, 0, equirectInfo, environmentInfo, views);
+
+    // 回读缓冲：镜面段后接辐照度段，与缓存文件的两个段逐字节相同
+    const size_t specularBytes = getCubemapBytes(settings.specularSize, settings.specularMipCount);
+    const size_t irradianceBytes = getCubemapBytes(settings.irradianceSize, 1);
+    std::unique_ptr<vkcore::Buffer> readback;
+    if (cacheData)
+    {
+        vkcore::BufferDesc bufferDesc{};
+        bufferDesc.size = specularBytes + irradianceBytes;
+        bufferDesc.usageFlags = vk::BufferUsageFlagBits::eTransferDst;
+        bufferDesc.allocationCreateFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+        bufferDesc.category = vkcore::MemoryCategory::Staging;
+        bufferDesc.mapping = vkcore::BufferMapping::Persistent;
+        readback = std::make_unique<vkcore::Buffer>("EnvironmentReadback", m_device, m_allocator, bufferDesc);
+    }
+
+    const vk::ImageLayout finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    commands.executeOnetime(m_device.getGraphicsQueue(), [&](vk::CommandBuffer cmd) {
+        constexpr auto kCompute = vk::PipelineStageFlagBits2::eComputeShader;
+        constexpr auto kCopy = vk::PipelineStageFlagBits2::eCopy;
+        constexpr auto kWrite = vk::AccessFlagBits2::eShaderStorageWrite;
+
+        recordbarriers(cmd, {makebarrier(*source, colorrange(0, sourceMips), vk::PipelineStageFlagBits2::eNone,
+                                         vk::AccessFlagBits2::eNone, kCompute, kWrite, vk::ImageLayout::eUndefined,
+                                         vk::ImageLayout::eGeneral),
+                             makebarrier(*result.specular, colorrange(0, settings.specularMipCount),
+                                         vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone, kCompute,
+                                         kWrite, vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral),
+                             makebarrier(*result.irradiance, colorrange(0, 1), vk::PipelineStageFlagBits2::eNone,
+                                         vk::AccessFlagBits2::eNone, kCompute, kWrite, vk::ImageLayout::eUndefined,
+                                         vk::ImageLayout::eGeneral)});
+
+        m_pipeline->bind(cmd);
+
+        PrefilterPush push{};
+        push.mode = kModeEquirect;
+        push.faceSize = settings.specularSize;
+        push.sourceSize = static_cast<float>(equirect.getExtent().width);
+        push.sourceMips = static_cast<float>(equirect.getMipLevels());
+        dispatchfaces(cmd, *m_pipeline, equirectSet, push);
+
+        recordsourcemips(cmd, *source);
+
+        push.sampleCount = settings.sampleCount;
+        push.sourceSize = static_cast<float>(settings.specularSize);
+        push.sourceMips = static_cast<float>(sourceMips);
+        push.mode = kModeSpecular;
+        for (uint32_t level = 0; level < settings.specularMipCount; ++level)
+        {
+            push.faceSize = std::max(settings.specularSize >> level, 1u);
+            push.roughness = settings.specularMipCount > 1
+                                 ? static_cast<float>(level) / static_cast<float>(settings.specularMipCount - 1)
+                                 : 0.0f;
+            dispatchfaces(cmd, *m_pipeline, specularSets[level], push);
+        }
+        push.mode = kModeIrradiance;
+        push.faceSize = settings.irradianceSize;
+        push.roughness = 0.0f;
+        dispatchfaces(cmd, *m_pipeline, irradianceSet, push);
+
+        if (!readback)
+        {
+            constexpr auto kAllCommands = vk::PipelineStageFlagBits2::eAllCommands;
+            recordbarriers(cmd, {makebarrier(*result.specular, colorrange(0, settings.specularMipCount), kCompute,
+                                             kWrite, kAllCommands, vk::AccessFlagBits2::eShaderSampledRead,
+                                             vk::ImageLayout::eGeneral, finalLayout),
+                                 makebarrier(*result.irradiance, colorrange(0, 1), kCompute, kWrite, kAllCommands,
+                                             vk::AccessFlagBits2::eShaderSampledRead, vk::ImageLayout::eGeneral,
+                                             finalLayout)});
+            return;
+        }
+
+        recordbarriers(cmd, {makebarrier(*result.specular, colorrange(0, settings.specularMipCount), kCompute, kWrite,
+                                         kCopy, vk::AccessFlagBits2::eTransferRead, vk::ImageLayout::eGeneral,
+                                         vk::ImageLayout::eTransferSrcOptimal),
+                             makebarrier(*result.irradiance, colorrange(0, 1), kCompute, kWrite, kCopy,
+                                         vk::AccessFlagBits2::eTransferRead, vk::ImageLayout::eGeneral,
+                                         vk::ImageLayout::eTransferSrcOptimal)});
+
+        const auto specularRegions = getCopyRegions(settings.specularSize, settings.specularMipCount);
+        const auto irradianceRegions = getCopyRegions(settings.irradianceSize, 1, specularBytes);
+        cmd.copyImageToBuffer(result.specular->get(), vk::ImageLayout::eTransferSrcOptimal, readback->get(),
+                              specularRegions);
+        cmd.copyImageToBuffer(result.irradiance->get(), vk::ImageLayout::eTransferSrcOptimal, readback->get(),
+                              irradianceRegions);
+
+        // 读之后的布局转换只需执行依赖；缓冲写入对主机可见
+        vk::BufferMemoryBarrier2 hostBarrier{};
+        hostBarrier.srcStageMask = kCopy;
+        hostBarrier.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+        hostBarrier.dstStageMask = vk::PipelineStageFlagBits2::eHost;
+        hostBarrier.dstAccessMask = vk::AccessFlagBits2::eHostRead;
+        hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        hostBarrier.buffer = readback->get();
+        hostBarrier.size = VK_WHOLE_SIZE;
+
+        const std::array<vk::ImageMemoryBarrier2, 2> toFinal = {
+            makebarrier(*result.specular, colorrange(0, settings.specularMipCount), kCopy, vk::AccessFlagBits2::eNone,
+                        vk::PipelineStageFlagBits2::eAllCommands, vk::AccessFlagBits2::eNone,
+                        vk::ImageLayout::eTransferSrcOptimal, finalLayout),
+            makebarrier(*result.irradiance, colorrange(0, 1), kCopy, vk::AccessFlagBits2::eNone,
+                        vk::PipelineStageFlagBits2::eAllCommands, vk::AccessFlagBits2::eNone,
+                        vk::ImageLayout::eTransferSrcOptimal, finalLayout)};
+
+        vk::DependencyInfo dependencyInfo{};
+        dependencyInfo.bufferMemoryBarrierCount = 1;
+        dependencyInfo.pBufferMemoryBarriers = &hostBarrier;
+        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(toFinal.size());
+        dependencyInfo.pImageMemoryBarriers = toFinal.data();
+        cmd.pipelineBarrier2(dependencyInfo);
+    });
+
+    // executeOnetime 返回时提交已完成：视图、描述符集与中间立方体可以立即释放
+    for (vk::ImageView view : views)
+    {
+        m_device.get().destroyImageView(view);
+    }
+    m_descriptorAllocator->resetPools();
+    source.reset();
+
+    result.specular->setCurrentLayout(finalLayout);
+    result.irradiance->setCurrentLayout(finalLayout);
+
+    if (readback)
+    {
+        readback->invalidate();
+        const auto *mapped = static_cast<const std::byte *>(readback->getMappedData());
+        cacheData->assign(mapped, mapped + specularBytes + irradianceBytes);
+    }
+    return result;
+}
+
+// ==================== 磁盘缓存 ====================
+
+std::filesystem::path EnvironmentPrefilter::getCachePath(const std::filesystem::path &cacheDirectory,
+                                                         const std::filesystem::path &sourcePath)
+{
+    char hashText[17];
+    std::snprintf(hashText, sizeof(hashText), "%016llx",
+                  static_cast<unsigned long long>(hashsourcepath(sourcePath)));
+
+    return cacheDirectory / (sourcePath.stem().string() + "_" + hashText + ".qtenv");
+}
+
+std::optional<EnvironmentPrefilter::CacheView> EnvironmentPrefilter::openCache(const vkcore::MappedFile &file,
+                                                                               const std::filesystem::path &sourcePath,
+                                                                               const Settings &settings)
+{
+    const uint64_t fileSize = file.size();
+    if (fileSize < sizeof(EnvironmentCacheHeader))
+    {
+        return std::nullopt;
+    }
+
+    EnvironmentCacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    // 格式与设置
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.specularSize != settings.specularSize || header.specularMipCount != settings.specularMipCount ||
+        header.irradianceSize != settings.irradianceSize || header.sampleCount != settings.sampleCount)
+    {
+        return std::nullopt;
+    }
+
+    // 源文件是否仍是预过滤时的那一份
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (header.sourceHash != hashsourcepath(sourcePath) || !statsource(sourcePath, sourceSize, sourceMtime) ||
+        header.sourceSize != sourceSize || header.sourceMtime != sourceMtime)
+    {
+        return std::nullopt;
+    }
+
+    // 各段大小由设置决定，与文件头不符即为损坏
+    if (header.specularBytes != getCubemapBytes(settings.specularSize, settings.specularMipCount) ||
+        header.irradianceBytes != getCubemapBytes(settings.irradianceSize, 1) ||
+        !sectionfits(header.specularOffset, header.specularBytes, fileSize) ||
+        !sectionfits(header.irradianceOffset, header.irradianceBytes, fileSize))
+    {
+        return std::nullopt;
+    }
+
+    CacheView view;
+    view.specular = reinterpret_cast<const std::byte *>(file.data() + header.specularOffset);
+    view.specularBytes = header.specularBytes;
+    view.irradiance = reinterpret_cast<const std::byte *>(file.data() + header.irradianceOffset);
+    view.irradianceBytes = header.irradianceBytes;
+    return view;
+}
+
+bool EnvironmentPrefilter::writeCache(const std::filesystem::path &cachePath, const std::filesystem::path &sourcePath,
+                                      const Settings &settings, const std::vector<std::byte> &data)
+{
+    const size_t specularBytes = getCubemapBytes(settings.specularSize, settings.specularMipCount);
+    const size_t irradianceBytes = getCubemapBytes(settings.irradianceSize, 1);
+    if (data.size() != specularBytes + irradianceBytes)
+    {
+        return false;
+    }
+
+    EnvironmentCacheHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.specularSize = settings.specularSize;
+    header.specularMipCount = settings.specularMipCount;
+    header.irradianceSize = settings.irradianceSize;
+    header.sampleCount = settings.sampleCount;
+    header.sourceHash = hashsourcepath(sourcePath);
+    if (!statsource(sourcePath, header.sourceSize, header.sourceMtime))
+    {
+        return false;
+    }
+    header.specularOffset = alignup(sizeof(EnvironmentCacheHeader), kSectionAlignment);
+    header.specularBytes = specularBytes;
+    header.irradianceOffset = alignup(header.specularOffset + specularBytes, kSectionAlignment);
+    header.irradianceBytes = irradianceBytes;
+
+    std::error_code ec;
+    std::filesystem::create_directories(cachePath.parent_path(), ec);
+
+    // 临时文件名带线程标识，并发写入时互不覆盖
+    std::filesystem::path tempPath = cachePath;
+    tempPath += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+
+        uint64_t position = 0;
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        position += sizeof(header);
+
+        writepadding(out, position, kSectionAlignment);
+        out.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(specularBytes));
+        position += specularBytes;
+
+        writepadding(out, position, kSectionAlignment);
+        out.write(reinterpret_cast<const char *>(data.data() + specularBytes),
+                  static_cast<std::streamsize>(irradianceBytes));
+
+        if (!out)
+        {
+            out.close();
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    // 重命名是原子的：读者要么看到旧文件，要么看到完整的新文件
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace rendercore
@@ -0,0 +1,338 @@
+#include "GeometryPool.hpp"
+#include "ResourceType.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace rendercore
+{
+
+namespace
+{
+
+// 顶点池同时作为存储缓冲，供计算着色器 / 网格着色器直接读取；设备支持时另加 eShaderDeviceAddress（顶点拉取）
+constexpr vk::BufferUsageFlags kVertexArenaUsage = vk::BufferUsageFlagBits::eVertexBuffer |
+                                                   vk::BufferUsageFlagBits::eStorageBuffer |
+                                                   vk::BufferUsageFlagBits::eTransferDst |
+                                                   vk::BufferUsageFlagBits::eTransferSrc;
+constexpr vk::BufferUsageFlags kIndexArenaUsage = vk::BufferUsageFlagBits::eIndexBuffer |
+                                                  vk::BufferUsageFlagBits::eStorageBuffer |
+                                                  vk::BufferUsageFlagBits::eTransferDst |
+                                                  vk::BufferUsageFlagBits::eTransferSrc;
+
+} // namespace
+
+Mesh::~Mesh()
+{
+    if (auto pool = geometryPool.lock())
+    {
+        pool->release(geometryHandle);
+    }
+}
+
+GeometryPool::GeometryPool(vkcore::Device &device, VmaAllocator allocator)
+    : GeometryPool(device, allocator, Config{})
+{
+}
+
+GeometryPool::GeometryPool(vkcore::Device &device, VmaAllocator allocator, const Config &config)
+    : m_device(device), m_allocator(allocator)
+{
+    m_vertexArenaSize = std::max<vk::DeviceSize>(config.vertexArenaSize, StandardVertexLayout::kStride);
+    m_indexArenaSize = std::max<vk::DeviceSize>(config.indexArenaSize, sizeof(uint32_t));
+    m_deviceAddress = device.isFeatureEnabled("bufferDeviceAddress");
+}
+
+GeometryPool::~GeometryPool() = default;
+
+// ==================== 分配与释放 ====================
+
+void GeometryPool::allocate(const std::shared_ptr<GeometryPool> &pool, Mesh &mesh, uint32_t vertexCount,
+                            uint32_t indexCount, vk::IndexType indexType, VertexFormat vertexFormat)
+{
+    if (!pool)
+    {
+        throw std::invalid_argument("GeometryPool::allocate: pool is null");
+    }
+    if (indexType != vk::IndexType::eUint16 && indexType != vk::IndexType::eUint32)
+    {
+        throw std::invalid_argument("GeometryPool::allocate: indexType must be eUint16 or eUint32");
+    }
+    const uint32_t vertexStride = VertexLayouts::getInfo(vertexFormat).stride;
+
+    GeometryPool &self = *pool;
+    std::lock_guard<std::mutex> lock(self.m_mtx);
+
+    Entry entry;
+    entry.mesh = &mesh;
+
+    // 依次尝试已有的 Arena（通常只有一两个），都放不下时新建
+    bool placed = false;
+    for (uint32_t i = 0; i < self.m_arenas.size() && !placed; ++i)
+    {
+        Arena &arena = *self.m_arenas[i];
+        if (arena.indexType != indexType || arena.vertexFormat != vertexFormat)
+        {
+            continue;
+        }
+        vkcore::TLSFAllocator::Allocation vertices;
+        vkcore::TLSFAllocator::Allocation indices;
+        if (vertexCount > 0)
+        {
+            vertices = arena.vertices.allocate(vertexCount);
+            if (!vertices.isValid())
+            {
+                continue;
+            }
+        }
+        if (indexCount > 0)
+        {
+            indices = arena.indices.allocate(indexCount);
+            if (!indices.isValid())
+            {
+                if (vertices.isValid())
+                {
+                    arena.vertices.free(vertices);
+                }
+                continue;
+            }
+        }
+        entry.arena = i;
+        entry.vertices = vertices;
+        entry.indices = indices;
+        placed = true;
+    }
+
+    if (!placed)
+    {
+        // 超过默认大小的网格独占一个按需大小的 Arena
+        uint32_t arenaIndex = static_cast<uint32_t>(self.m_arenas.size());
+        const auto vertexArenaCapacity = static_cast<uint32_t>(
+            std::clamp<vk::DeviceSize>(self.m_vertexArenaSize / vertexStride, 1, UINT32_MAX));
+        const auto indexArenaCapacity = static_cast<uint32_t>(
+            std::clamp<vk::DeviceSize>(self.m_indexArenaSize / indexsize(indexType), 1, UINT32_MAX));
+        self.m_arenas.push_back(self.createarena(std::max(vertexArenaCapacity, vertexCount),
+                                                 std::max(indexArenaCapacity, indexCount), arenaIndex, indexType,
+                                                 vertexFormat));
+        Arena &arena = *self.m_arenas.back();
+        entry.arena = arenaIndex;
+        if (vertexCount > 0)
+        {
+            entry.vertices = arena.vertices.allocate(vertexCount);
+        }
+        if (indexCount > 0)
+        {
+            entry.indices = arena.indices.allocate(indexCount);
+        }
+    }
+
+    uint32_t handle = 0;
+    if (!self.m_freeEntries.empty())
+    {
+        handle = self.m_freeEntries.back();
+        self.m_freeEntries.pop_back();
+        self.m_entries[handle] = entry;
+    }
+    else
+    {
+        handle = static_cast<uint32_t>(self.m_entries.size());
+        self.m_entries.push_back(entry);
+    }
+
+    mesh.geometryPool = pool;
+    mesh.geometryHandle = handle;
+    bindmesh(mesh, *self.m_arenas[entry.arena], entry);
+}
+
+void GeometryPool::release(uint32_t handle)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (handle >= m_entries.size() || !m_entries[handle].mesh)
+    {
+        return;
+    }
+
+    Entry &entry = m_entries[handle];
+    Arena &arena = *m_arenas[entry.arena];
+    if (entry.vertices.isValid())
+    {
+        arena.vertices.free(entry.vertices);
+    }
+    if (entry.indices.isValid())
+    {
+        arena.indices.free(entry.indices);
+    }
+
+    entry = Entry{};
+    m_freeEntries.push_back(handle);
+}
+
+// ==================== 碎片整理 ====================
+
+std::vector<std::shared_ptr<vkcore::Buffer>> GeometryPool::defragment(vk::CommandBuffer cmd, float threshold)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    std::vector<std::shared_ptr<vkcore::Buffer>> retired;
+
+    for (uint32_t arenaIndex = 0; arenaIndex < m_arenas.size(); ++arenaIndex)
+    {
+        Arena &oldArena = *m_arenas[arenaIndex];
+        if (fragmentation(oldArena.vertices) <= threshold && fragmentation(oldArena.indices) <= threshold)
+        {
+            continue;
+        }
+
+        // 按原偏移顺序重新分配，新 Arena 中的区间首尾相接
+        std::vector<uint32_t> handles;
+        for (uint32_t handle = 0; handle < m_entries.size(); ++handle)
+        {
+            if (m_entries[handle].mesh && m_entries[handle].arena == arenaIndex)
+            {
+                handles.push_back(handle);
+            }
+        }
+        std::sort(handles.begin(), handles.end(), [this](uint32_t a, uint32_t b) {
+            return m_entries[a].vertices.offset < m_entries[b].vertices.offset;
+        });
+
+        std::unique_ptr<Arena> newArena = createarena(oldArena.vertices.getCapacity(), oldArena.indices.getCapacity(),
+                                                      arenaIndex, oldArena.indexType, oldArena.vertexFormat);
+        const vk::DeviceSize vertexStride = oldArena.vertexStride;
+        const vk::DeviceSize indexStride = indexsize(oldArena.indexType);
+        std::vector<vk::BufferCopy> vertexCopies;
+        std::vector<vk::BufferCopy> indexCopies;
+        for (uint32_t handle : handles)
+        {
+            Entry &entry = m_entries[handle];
+            if (entry.vertices.isValid())
+            {
+                vkcore::TLSFAllocator::Allocation moved = newArena->vertices.allocate(entry.vertices.size);
+                vertexCopies.emplace_back(vk::DeviceSize(entry.vertices.offset) * vertexStride,
+                                          vk::DeviceSize(moved.offset) * vertexStride,
+                                          vk::DeviceSize(entry.vertices.size) * vertexStride);
+                entry.vertices = moved;
+            }
+            if (entry.indices.isValid())
+            {
+                vkcore::TLSFAllocator::Allocation moved = newArena->indices.allocate(entry.indices.size);
+                indexCopies.emplace_back(vk::DeviceSize(entry.indices.offset) * indexStride,
+                                         vk::DeviceSize(moved.offset) * indexStride,
+                                         vk::DeviceSize(entry.indices.size) * indexStride);
+                entry.indices = moved;
+            }
+            bindmesh(*entry.mesh, *newArena, entry);
+        }
+
+        if (!vertexCopies.empty())
+        {
+            cmd.copyBuffer(oldArena.vertexBuffer->get(), newArena->vertexBuffer->get(), vertexCopies);
+        }
+        if (!indexCopies.empty())
+        {
+            cmd.copyBuffer(oldArena.indexBuffer->get(), newArena->indexBuffer->get(), indexCopies);
+        }
+
+        retired.push_back(oldArena.vertexBuffer);
+        retired.push_back(oldArena.indexBuffer);
+        m_arenas[arenaIndex] = std::move(newArena);
+    }
+
+    if (!retired.empty())
+    {
+        vk::MemoryBarrier2 barrier{};
+        barrier.srcStageMask = vk::PipelineStageFlagBits2::eCopy;
+        barrier.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+        barrier.dstStageMask = vk::PipelineStageFlagBits2::eVertexInput | vk::PipelineStageFlagBits2::eVertexShader |
+                               vk::PipelineStageFlagBits2::eComputeShader;
+        barrier.dstAccessMask = vk::AccessFlagBits2::eVertexAttributeRead | vk::AccessFlagBits2::eIndexRead |
+                                vk::AccessFlagBits2::eShaderStorageRead;
+
+        vk::DependencyInfo dependency{};
+        dependency.memoryBarrierCount = 1;
+        dependency.pMemoryBarriers = &barrier;
+        cmd.pipelineBarrier2(dependency);
+    }
+
+    return retired;
+}
+
+// ==================== 统计 ====================
+
+GeometryPool::Stats GeometryPool::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    Stats stats;
+    stats.arenaCount = static_cast<uint32_t>(m_arenas.size());
+    stats.meshCount = static_cast<uint32_t>(m_entries.size() - m_freeEntries.size());
+    for (const auto &arena : m_arenas)
+    {
+        stats.vertexCapacity += vk::DeviceSize(arena->vertices.getCapacity()) * arena->vertexStride;
+        stats.vertexUsed += vk::DeviceSize(arena->vertices.getUsedSize()) * arena->vertexStride;
+        stats.indexCapacity += vk::DeviceSize(arena->indices.getCapacity()) * indexsize(arena->indexType);
+        stats.indexUsed += vk::DeviceSize(arena->indices.getUsedSize()) * indexsize(arena->indexType);
+    }
+    return stats;
+}
+
+// ==================== 内部实现 ====================
+
+std::unique_ptr<GeometryPool::Arena> GeometryPool::createarena(uint32_t vertexCapacity, uint32_t indexCapacity,
+                                                               uint32_t arenaIndex, vk::IndexType indexType,
+                                                               VertexFormat vertexFormat)
+{
+    auto arena = std::make_unique<Arena>(vertexCapacity, indexCapacity, indexType, vertexFormat);
+
+    vkcore::BufferDesc vertexDesc{};
+    vertexDesc.size = vk::DeviceSize(vertexCapacity) * arena->vertexStride;
+    vertexDesc.usageFlags = kVertexArenaUsage;
+    if (m_deviceAddress)
+    {
+        vertexDesc.usageFlags |= vk::BufferUsageFlagBits::eShaderDeviceAddress;
+    }
+    vertexDesc.memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+    vertexDesc.category = vkcore::MemoryCategory::Mesh;
+    arena->vertexBuffer = std::make_shared<vkcore::Buffer>("GeometryPoolVertices" + std::to_string(arenaIndex),
+                                                           m_device, m_allocator, vertexDesc);
+
+    vkcore::BufferDesc indexDesc{};
+    indexDesc.size = vk::DeviceSize(indexCapacity) * indexsize(indexType);
+    indexDesc.usageFlags = kIndexArenaUsage;
+    if (m_deviceAddress)
+    {
+        indexDesc.usageFlags |= vk::BufferUsageFlagBits::eShaderDeviceAddress;
+    }
+    indexDesc.memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+    indexDesc.category = vkcore::MemoryCategory::Mesh;
+    arena->indexBuffer = std::make_shared<vkcore::Buffer>("GeometryPoolIndices" + std::to_string(arenaIndex),
+                                                          m_device, m_allocator, indexDesc);
+
+    return arena;
+}
+
+uint32_t GeometryPool::indexsize(vk::IndexType indexType)
+{
+    return indexType == vk::IndexType::eUint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+float GeometryPool::fragmentation(const vkcore::TLSFAllocator &allocator)
+{
+    uint32_t freeSize = allocator.getFreeSize();
+    if (freeSize == 0 || allocator.getAllocationCount() == 0)
+    {
+        return 0.0f;
+    }
+    return 1.0f - static_cast<float>(allocator.getLargestFreeBlock()) / static_cast<float>(freeSize);
+}
+
+void GeometryPool::bindmesh(Mesh &mesh, const Arena &arena, const Entry &entry)
+{
+    mesh.vertexBuffer = entry.vertices.isValid() ? arena.vertexBuffer : nullptr;
+    mesh.indexBuffer = entry.indices.isValid() ? arena.indexBuffer : nullptr;
+    mesh.indexType = arena.indexType;
+    mesh.vertexFormat = arena.vertexFormat;
+    mesh.vertexOffset = static_cast<int32_t>(entry.vertices.offset);
+    mesh.firstIndex = entry.indices.offset;
+}
+
+} // namespace rendercore
@@ -0,0 +1,204 @@
+#include "HdrConverter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#include <immintrin.h>
+#define QTRENDER_HALF_F16C 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define QTRENDER_HALF_SSE 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define QTRENDER_HALF_NEON 1
+#endif
+
+/**
+ * @file HdrConverter.cpp
+ * @brief HdrConverter 的实现文件
+ */
+
+namespace rendercore
+{
+
+namespace
+{
+
+constexpr float kMaxHalf = 65504.0f;                                          ///< half 的最大有限值
+constexpr uint32_t kHalfMinNormalBits = 113u << 23;                           ///< 2^-14（half 最小规格化数）的 float 位模式
+constexpr uint32_t kDenormMagicBits = ((127 - 15) + (23 - 10) + 1) << 23;     ///< 加上后尾数低位即为 half 非规格化尾数
+constexpr uint32_t kRebias = static_cast<uint32_t>((15 - 127) << 23) + 0xfff; ///< 指数换偏置，并加上舍入的一半减一
+
+uint32_t asuint(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float asfloat(uint32_t bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief 标量 float -> half（先钳制再就近舍入到偶数；NaN 与 SIMD 路径的 min/max 一致，变为 +65504）
+ */
+uint16_t halfscalar(float value)
+{
+    value = std::isnan(value) ? kMaxHalf : std::clamp(value, -kMaxHalf, kMaxHalf);
+
+    uint32_t bits = asuint(value);
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    bits &= 0x7fffffffu;
+
+    uint32_t result;
+    if (bits < kHalfMinNormalBits)
+    {
+        // 非规格化：借浮点加法完成舍入，尾数低位即为结果
+        result = asuint(asfloat(bits) + asfloat(kDenormMagicBits)) - kDenormMagicBits;
+    }
+    else
+    {
+        const uint32_t mantissaOdd = (bits >> 13) & 1u;
+        result = (bits + kRebias + mantissaOdd) >> 13;
+    }
+    return static_cast<uint16_t>(result | sign);
+}
+
+/**
+ * @brief 编码 5 位指数、mantissaBits 位尾数的无符号小浮点（B10G11R11 的分量）
+ */
+uint32_t packufloat(float value, uint32_t mantissaBits)
+{
+    // 负值、零与 NaN 都写为 0
+    if (!(value > 0.0f))
+    {
+        return 0;
+    }
+
+    const uint32_t maxEncoded = (30u << mantissaBits) | ((1u << mantissaBits) - 1);
+    const uint32_t bits = asuint(value);
+    const int32_t exponent = static_cast<int32_t>(bits >> 23) - 127 + 15;
+    if (exponent <= 0)
+    {
+        // 非规格化：以 2^-14 / 2^mantissaBits 为单位取整（进位到 1 << mantissaBits 恰好是最小规格化数）
+        return static_cast<uint32_t>(std::lrint(std::ldexp(value, 14 + static_cast<int>(mantissaBits))));
+    }
+    if (exponent > 30)
+    {
+        return maxEncoded;
+    }
+
+    const uint32_t shift = 23 - mantissaBits;
+    const uint32_t mantissa = bits & 0x7fffffu;
+    const uint32_t rounded = (mantissa + (1u << (shift - 1)) - 1 + ((mantissa >> shift) & 1u)) >> shift;
+    return std::min((static_cast<uint32_t>(exponent) << mantissaBits) + rounded, maxEncoded);
+}
+
+} // namespace
+
+bool HdrConverter::isSupportedFormat(vk::Format format)
+{
+    return format == vk::Format::eR16G16B16A16Sfloat || format == vk::Format::eB10G11R11UfloatPack32 ||
+           format == vk::Format::eR32G32B32A32Sfloat;
+}
+
+void HdrConverter::convert(const float *rgba, size_t pixelCount, vk::Format format, void *out)
+{
+    switch (format)
+    {
+    case vk::Format::eR16G16B16A16Sfloat:
+        floatToHalf(rgba, pixelCount * 4, static_cast<uint16_t *>(out));
+        break;
+    case vk::Format::eB10G11R11UfloatPack32:
+        packB10G11R11(rgba, pixelCount, static_cast<uint32_t *>(out));
+        break;
+    case vk::Format::eR32G32B32A32Sfloat:
+        std::memcpy(out, rgba, pixelCount * 4 * sizeof(float));
+        break;
+    default:
+        throw std::invalid_argument("HdrConverter: Unsupported HDR texture format " + vk::to_string(format));
+    }
+}
+
+void HdrConverter::floatToHalf(const float *values, size_t count, uint16_t *out)
+{
+    size_t i = 0;
+#if defined(QTRENDER_HALF_F16C)
+    const __m256 maxHalf = _mm256_set1_ps(kMaxHalf);
+    const __m256 minHalf = _mm256_set1_ps(-kMaxHalf);
+    for (; i + 8 <= count; i += 8)
+    {
+        // min 在任一操作数为 NaN 时返回第二个操作数，NaN 因此变为 +65504
+        __m256 v = _mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(values + i), maxHalf), minHalf);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+    }
+#elif defined(QTRENDER_HALF_SSE)
+    const __m128 maxHalf = _mm_set1_ps(kMaxHalf);
+    const __m128 minHalf = _mm_set1_ps(-kMaxHalf);
+    const __m128i signMask = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    const __m128i minNormal = _mm_set1_epi32(static_cast<int>(kHalfMinNormalBits));
+    const __m128i denormMagic = _mm_set1_epi32(static_cast<int>(kDenormMagicBits));
+    const __m128i rebias = _mm_set1_epi32(static_cast<int>(kRebias));
+    const __m128i one = _mm_set1_epi32(1);
+    for (; i + 4 <= count; i += 4)
+    {
+        // 与 halfscalar 相同的算法，两条分支都算出后按掩码选择
+        __m128 v = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(values + i), maxHalf), minHalf);
+        __m128i bits = _mm_castps_si128(v);
+        const __m128i sign = _mm_and_si128(bits, signMask);
+        bits = _mm_xor_si128(bits, sign);
+
+        const __m128i denorm = _mm_sub_epi32(
+            _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(bits), _mm_castsi128_ps(denormMagic))), denormMagic);
+        const __m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(bits, 13), one);
+        const __m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bits, rebias), mantissaOdd), 13);
+        const __m128i isDenorm = _mm_cmplt_epi32(bits, minNormal);
+
+        __m128i result = _mm_or_si128(_mm_and_si128(isDenorm, denorm), _mm_andnot_si128(isDenorm, normal));
+        result = _mm_or_si128(result, _mm_srli_epi32(sign, 16));
+        // 符号扩展后用有符号饱和打包，16 位结果保持不变（SSE2 没有无符号的 32 -> 16 打包）
+        result = _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + i), _mm_packs_epi32(result, result));
+    }
+#elif defined(QTRENDER_HALF_NEON)
+    const float32x4_t maxHalf = vdupq_n_f32(kMaxHalf);
+    const float32x4_t minHalf = vdupq_n_f32(-kMaxHalf);
+    for (; i + 4 <= count; i += 4)
+    {
+        // minnm 在一个操作数为 NaN 时返回另一个，NaN 因此变为 +65504
+        float32x4_t v = vmaxnmq_f32(vminnmq_f32(vld1q_f32(values + i), maxHalf), minHalf);
+        vst1_u16(out + i, vreinterpret_u16_f16(vcvt_f16_f32(v)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        out[i] = halfscalar(values[i]);
+    }
+}
+
+uint16_t HdrConverter::floatToHalf(float value)
+{
+    return halfscalar(value);
+}
+
+void HdrConverter::packB10G11R11(const float *rgba, size_t pixelCount, uint32_t *out)
+{
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        out[i] = packB10G11R11(rgba[i * 4 + 0], rgba[i * 4 + 1], rgba[i * 4 + 2]);
+    }
+}
+
+uint32_t HdrConverter::packB10G11R11(float r, float g, float b)
+{
+    return packufloat(r, 6) | (packufloat(g, 6) << 11) | (packufloat(b, 5) << 22);
+}
+
+} // namespace rendercore
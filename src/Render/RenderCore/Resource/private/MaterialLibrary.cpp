@@ -0,0 +1,368 @@
+#include "MaterialLibrary.hpp"
+#include "VulkanCore/public/MappedFile.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+
+/**
+ * @file MaterialLibrary.cpp
+ * @brief MaterialLibrary 的实现文件
+ */
+
+namespace rendercore
+{
+
+namespace
+{
+
+constexpr char kMagic[4] = {'Q', 'T', 'M', 'L'};
+constexpr uint64_t kSectionAlignment = 16; ///< 各数据段的对齐
+constexpr uint32_t kTextureSlotCount = 6;  ///< 记录中的纹理槽位数
+
+static_assert(std::is_trivially_copyable_v<MaterialLibraryHeader> && sizeof(MaterialLibraryHeader) == 64,
+              "MaterialLibraryHeader layout is part of the file format");
+static_assert(std::is_trivially_copyable_v<MaterialLibraryRecord> && sizeof(MaterialLibraryRecord) == 96,
+              "MaterialLibraryRecord layout is part of the file format");
+
+uint64_t alignup(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief FNV-1a 64 位哈希（可以分段累积）
+ */
+uint64_t hashbytes(const void *data, size_t size, uint64_t hash = 1469598103934665603ull)
+{
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief 材质目录的绝对、规范化路径哈希
+ */
+uint64_t hashdirectory(const std::filesystem::path &materialDirectory)
+{
+    std::error_code ec;
+    std::filesystem::path absolutePath = std::filesystem::absolute(materialDirectory, ec);
+    const std::string text = (ec ? materialDirectory : absolutePath).lexically_normal().generic_string();
+    return hashbytes(text.data(), text.size());
+}
+
+/**
+ * @brief 源文件集合的指纹：相对路径、大小与修改时间依次累积（任何文件增删改都会改变结果）
+ * @return 有源文件无法读取属性时返回 false
+ */
+bool stampsources(const std::filesystem::path &materialDirectory, const std::vector<std::filesystem::path> &sources,
+                  uint64_t &stamp)
+{
+    stamp = hashbytes(nullptr, 0);
+    for (const auto &source : sources)
+    {
+        std::error_code ec;
+        const std::string relative = source.lexically_relative(materialDirectory).generic_string();
+        const uint64_t size = std::filesystem::file_size(source, ec);
+        if (ec)
+        {
+            return false;
+        }
+        const auto writeTime = std::filesystem::last_write_time(source, ec);
+        if (ec)
+        {
+            return false;
+        }
+        const int64_t mtime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+
+        stamp = hashbytes(relative.data(), relative.size() + 1, stamp); // 含 '\0'，避免路径拼接产生歧义
+        stamp = hashbytes(&size, sizeof(size), stamp);
+        stamp = hashbytes(&mtime, sizeof(mtime), stamp);
+    }
+    return true;
+}
+
+/**
+ * @class StringTable
+ * @brief 写入时的字符串表（相同字符串只存一份，纹理路径在材质间大量重复）
+ */
+class StringTable
+{
+  public:
+    uint32_t add(const std::string &text)
+    {
+        auto it = m_offsets.find(text);
+        if (it != m_offsets.end())
+        {
+            return it->second;
+        }
+        const uint32_t offset = static_cast<uint32_t>(m_data.size());
+        m_data.insert(m_data.end(), text.begin(), text.end());
+        m_data.push_back('\0');
+        m_offsets.emplace(text, offset);
+        return offset;
+    }
+
+    const std::vector<char> &data() const
+    {
+        return m_data;
+    }
+
+  private:
+    std::vector<char> m_data;
+    std::unordered_map<std::string, uint32_t> m_offsets;
+};
+
+} // namespace
+
+// ==================== View ====================
+
+std::string_view MaterialLibrary::View::getString(uint32_t offset) const
+{
+    return std::string_view(strings + offset);
+}
+
+std::string_view MaterialLibrary::View::getSource(uint32_t index) const
+{
+    return getString(records[index].source);
+}
+
+MaterialData MaterialLibrary::View::getMaterialData(uint32_t index) const
+{
+    MaterialLibraryRecord record;
+    std::memcpy(&record, &records[index], sizeof(record));
+
+    MaterialData data;
+    Material &material = data.material;
+    material.name = getString(record.name);
+    material.baseColorFactor = glm::vec4(record.baseColorFactor[0], record.baseColorFactor[1],
+                                         record.baseColorFactor[2], record.baseColorFactor[3]);
+    material.emissiveFactor = glm::vec3(record.emissiveFactor[0], record.emissiveFactor[1], record.emissiveFactor[2]);
+    material.metallicFactor = record.metallicFactor;
+    material.roughnessFactor = record.roughnessFactor;
+    material.alphaCutoff = record.alphaCutoff;
+    material.normalScale = record.normalScale;
+    material.refractionIndex = record.refractionIndex;
+    material.alphaMode = static_cast<AlphaMode>(record.alphaMode);
+    material.doubleSided = record.doubleSided != 0;
+
+    data.shaderName = getString(record.shader);
+    data.texturePaths.baseColor = getString(record.textures[0]);
+    data.texturePaths.metallic = getString(record.textures[1]);
+    data.texturePaths.roughness = getString(record.textures[2]);
+    data.texturePaths.normal = getString(record.textures[3]);
+    data.texturePaths.occlusion = getString(record.textures[4]);
+    data.texturePaths.emissive = getString(record.textures[5]);
+    return data;
+}
+
+// ==================== 公共接口 ====================
+
+std::vector<std::filesystem::path> MaterialLibrary::listSources(const std::filesystem::path &materialDirectory)
+{
+    std::vector<std::filesystem::path> sources;
+    std::error_code ec;
+    for (std::filesystem::recursive_directory_iterator it(materialDirectory, ec), end; !ec && it != end;
+         it.increment(ec))
+    {
+        std::string ext = it->path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if (ext == ".json" && it->is_regular_file(ec))
+        {
+            sources.push_back(it->path());
+        }
+    }
+    std::sort(sources.begin(), sources.end());
+    return sources;
+}
+
+std::filesystem::path MaterialLibrary::getLibraryPath(const std::filesystem::path &cacheDirectory,
+                                                      const std::filesystem::path &materialDirectory)
+{
+    char hashText[17];
+    std::snprintf(hashText, sizeof(hashText), "%016llx",
+                  static_cast<unsigned long long>(hashdirectory(materialDirectory)));
+
+    // "assets/materials/" 的 filename() 为空，取最后一级目录名
+    std::filesystem::path directory = materialDirectory.lexically_normal();
+    if (!directory.has_filename())
+    {
+        directory = directory.parent_path();
+    }
+    return cacheDirectory / (directory.filename().string() + "_" + hashText + ".qtmatlib");
+}
+
+std::optional<MaterialLibrary::View> MaterialLibrary::open(const vkcore::MappedFile &file,
+                                                           const std::filesystem::path &materialDirectory,
+                                                           const std::vector<std::filesystem::path> &sources)
+{
+    const uint64_t fileSize = file.size();
+    if (fileSize < sizeof(MaterialLibraryHeader))
+    {
+        return std::nullopt;
+    }
+
+    MaterialLibraryHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.recordStride != sizeof(MaterialLibraryRecord) || header.materialCount != sources.size())
+    {
+        return std::nullopt;
+    }
+
+    // 源文件集合是否仍是编译时的那一份
+    uint64_t stamp = 0;
+    if (header.sourceHash != hashdirectory(materialDirectory) || !stampsources(materialDirectory, sources, stamp) ||
+        header.sourceStamp != stamp)
+    {
+        return std::nullopt;
+    }
+
+    // 段边界与字符串表结尾（之后按偏移取字符串不会越界）
+    if (header.recordOffset % kSectionAlignment != 0 || header.recordOffset > fileSize ||
+        header.materialCount > (fileSize - header.recordOffset) / sizeof(MaterialLibraryRecord) ||
+        header.stringOffset > fileSize || header.stringSize > fileSize - header.stringOffset ||
+        header.stringSize == 0 || header.stringSize > UINT32_MAX)
+    {
+        return std::nullopt;
+    }
+
+    View view;
+    view.records = reinterpret_cast<const MaterialLibraryRecord *>(file.data() + header.recordOffset);
+    view.count = header.materialCount;
+    view.strings = file.data() + header.stringOffset;
+    view.stringSize = header.stringSize;
+    if (view.strings[view.stringSize - 1] != '\0')
+    {
+        return std::nullopt;
+    }
+
+    for (uint32_t i = 0; i < view.count; ++i)
+    {
+        const MaterialLibraryRecord &record = view.records[i];
+        bool valid = record.alphaMode <= static_cast<uint32_t>(AlphaMode::Blend) && record.source < view.stringSize &&
+                     record.name < view.stringSize && record.shader < view.stringSize;
+        for (uint32_t slot = 0; slot < kTextureSlotCount; ++slot)
+        {
+            valid = valid && record.textures[slot] < view.stringSize;
+        }
+        if (!valid)
+        {
+            return std::nullopt;
+        }
+    }
+
+    return view;
+}
+
+bool MaterialLibrary::write(const std::filesystem::path &libraryPath, const std::filesystem::path &materialDirectory,
+                            const std::vector<std::filesystem::path> &sources,
+                            const std::vector<MaterialData> &materials)
+{
+    if (sources.size() != materials.size())
+    {
+        return false;
+    }
+
+    MaterialLibraryHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.recordStride = sizeof(MaterialLibraryRecord);
+    header.materialCount = static_cast<uint32_t>(materials.size());
+    header.sourceHash = hashdirectory(materialDirectory);
+    if (!stampsources(materialDirectory, sources, header.sourceStamp))
+    {
+        return false;
+    }
+
+    // 空字符串固定在偏移 0
+    StringTable strings;
+    strings.add(std::string());
+
+    std::vector<MaterialLibraryRecord> records(materials.size());
+    for (size_t i = 0; i < materials.size(); ++i)
+    {
+        const Material &material = materials[i].material;
+        const TexturePaths &paths = materials[i].texturePaths;
+        MaterialLibraryRecord &record = records[i];
+        for (int c = 0; c < 4; ++c)
+        {
+            record.baseColorFactor[c] = material.baseColorFactor[c];
+        }
+        for (int c = 0; c < 3; ++c)
+        {
+            record.emissiveFactor[c] = material.emissiveFactor[c];
+        }
+        record.metallicFactor = material.metallicFactor;
+        record.roughnessFactor = material.roughnessFactor;
+        record.alphaCutoff = material.alphaCutoff;
+        record.normalScale = material.normalScale;
+        record.refractionIndex = material.refractionIndex;
+        record.alphaMode = static_cast<uint32_t>(material.alphaMode);
+        record.doubleSided = material.doubleSided ? 1u : 0u;
+        record.source = strings.add(sources[i].lexically_relative(materialDirectory).generic_string());
+        record.name = strings.add(material.name);
+        record.shader = strings.add(materials[i].shaderName);
+        record.textures[0] = strings.add(paths.baseColor);
+        record.textures[1] = strings.add(paths.metallic);
+        record.textures[2] = strings.add(paths.roughness);
+        record.textures[3] = strings.add(paths.normal);
+        record.textures[4] = strings.add(paths.occlusion);
+        record.textures[5] = strings.add(paths.emissive);
+    }
+
+    header.recordOffset = alignup(sizeof(MaterialLibraryHeader), kSectionAlignment);
+    header.stringOffset = alignup(header.recordOffset + records.size() * sizeof(MaterialLibraryRecord),
+                                  kSectionAlignment);
+    header.stringSize = strings.data().size();
+
+    std::error_code ec;
+    std::filesystem::create_directories(libraryPath.parent_path(), ec);
+
+    // 临时文件名带线程标识，并发编译时互不覆盖
+    std::filesystem::path tempPath = libraryPath;
+    tempPath += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+
+        // 记录表紧跟在 64 字节的文件头之后，两段都已对齐，无需填充
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(records.data()),
+                  static_cast<std::streamsize>(records.size() * sizeof(MaterialLibraryRecord)));
+        out.write(strings.data().data(), static_cast<std::streamsize>(strings.data().size()));
+
+        if (!out)
+        {
+            out.close();
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    // 重命名是原子的：读者要么看到旧文件，要么看到完整的新文件
+    std::filesystem::rename(tempPath, libraryPath, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace rendercore
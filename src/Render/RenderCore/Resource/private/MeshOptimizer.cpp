@@ -0,0 +1,416 @@
+#include "MeshOptimizer.hpp"
+#include "VulkanCore/public/Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace rendercore
+{
+
+namespace
+{
+
+constexpr uint32_t kNoVertex = UINT32_MAX;
+
+/**
+ * @struct WeldKey
+ * @brief 焊接时比较的顶点属性（除法线外的全部分量，按位比较）
+ */
+struct WeldKey
+{
+    uint32_t bits[9];
+
+    bool operator==(const WeldKey &other) const
+    {
+        return std::memcmp(bits, other.bits, sizeof(bits)) == 0;
+    }
+};
+
+struct WeldKeyHash
+{
+    size_t operator()(const WeldKey &key) const
+    {
+        // FNV-1a
+        size_t hash = 2166136261u;
+        for (uint32_t word : key.bits)
+        {
+            hash = (hash ^ word) * 16777619u;
+        }
+        return hash;
+    }
+};
+
+WeldKey makeweldkey(const Vertex &vertex)
+{
+    // +0.0 与 -0.0 视为相同
+    const float values[9] = {vertex.position.x + 0.0f, vertex.position.y + 0.0f, vertex.position.z + 0.0f,
+                             vertex.texCoord.x + 0.0f, vertex.texCoord.y + 0.0f, vertex.color.x + 0.0f,
+                             vertex.color.y + 0.0f,    vertex.color.z + 0.0f,    vertex.color.w + 0.0f};
+    WeldKey key;
+    std::memcpy(key.bits, values, sizeof(key.bits));
+    return key;
+}
+
+/**
+ * @brief 顶点 -> 相邻三角形的 CSR 表
+ */
+void buildadjacency(const uint32_t *indices, size_t indexCount, size_t vertexCount, std::vector<uint32_t> &offsets,
+                    std::vector<uint32_t> &triangles)
+{
+    offsets.assign(vertexCount + 1, 0);
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        ++offsets[indices[i] + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    triangles.resize(indexCount);
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+}
+
+} // namespace
+
+// ==================== 完整流程 ====================
+
+void MeshOptimizer::optimize(MeshData &meshData)
+{
+    QTR_PROFILE_SCOPE("MeshOptimizer::optimize");
+    if (meshData.indices.size() < 3 || meshData.vertices.empty())
+    {
+        return;
+    }
+
+    std::vector<uint32_t> clusters =
+        optimizeVertexCache(meshData.indices.data(), meshData.indices.size(), meshData.vertices.size());
+    optimizeOverdraw(meshData.indices.data(), meshData.indices.size(), meshData.vertices.data(), clusters);
+    optimizeVertexFetch(meshData);
+}
+
+// ==================== 顶点焊接 ====================
+
+void MeshOptimizer::weldVertices(MeshData &meshData, float creaseAngle)
+{
+    std::vector<Vertex> &vertices = meshData.vertices;
+    if (vertices.empty())
+    {
+        return;
+    }
+
+    // 每个焊接组内按法线再分成若干簇：簇以第一个角点的法线为准，夹角不超过折痕角的角点并入
+    const float minCos = std::cos(std::clamp(creaseAngle, 0.0f, 3.14159265f));
+    std::unordered_map<WeldKey, uint32_t, WeldKeyHash> groups; ///< 组内第一个簇
+    groups.reserve(vertices.size());
+    std::vector<uint32_t> nextCluster;  ///< 同组中的下一个簇（kNoVertex 结尾）
+    std::vector<glm::vec3> baseNormals; ///< 簇的参考法线（单位化）
+    std::vector<glm::vec3> normalSums;  ///< 簇内角点法线之和
+    std::vector<Vertex> welded;
+    welded.reserve(vertices.size() / 2);
+
+    std::vector<uint32_t> remap(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        const Vertex &vertex = vertices[i];
+        const float normalLength = glm::length(vertex.normal);
+        const glm::vec3 unitNormal = normalLength > 0.0f ? vertex.normal * (1.0f / normalLength) : vertex.normal;
+
+        auto [it, inserted] = groups.try_emplace(makeweldkey(vertex), kNoVertex);
+        uint32_t cluster = it->second;
+        uint32_t last = kNoVertex;
+        while (cluster != kNoVertex)
+        {
+            const bool matches = creaseAngle > 0.0f ? glm::dot(baseNormals[cluster], unitNormal) >= minCos
+                                                    : std::memcmp(&welded[cluster].normal, &vertex.normal,
+                                                                  sizeof(glm::vec3)) == 0;
+            if (matches)
+            {
+                break;
+            }
+            last = cluster;
+            cluster = nextCluster[cluster];
+        }
+
+        if (cluster == kNoVertex)
+        {
+            cluster = static_cast<uint32_t>(welded.size());
+            welded.push_back(vertex);
+            nextCluster.push_back(kNoVertex);
+            baseNormals.push_back(unitNormal);
+            normalSums.push_back(glm::vec3(0.0f));
+            if (last == kNoVertex)
+            {
+                it->second = cluster;
+            }
+            else
+            {
+                nextCluster[last] = cluster;
+            }
+        }
+        normalSums[cluster] = normalSums[cluster] + vertex.normal;
+        remap[i] = cluster;
+    }
+
+    if (creaseAngle > 0.0f)
+    {
+        for (size_t cluster = 0; cluster < welded.size(); ++cluster)
+        {
+            const float length = glm::length(normalSums[cluster]);
+            welded[cluster].normal = length > 0.0f ? normalSums[cluster] * (1.0f / length) : baseNormals[cluster];
+        }
+    }
+
+    for (uint32_t &index : meshData.indices)
+    {
+        index = remap[index];
+    }
+    vertices = std::move(welded);
+}
+
+// ==================== 三角形排序 ====================
+
+std::vector<uint32_t> MeshOptimizer::optimizeVertexCache(uint32_t *indices, size_t indexCount, size_t vertexCount,
+                                                         uint32_t cacheSize)
+{
+    std::vector<uint32_t> clusters;
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || vertexCount == 0)
+    {
+        return clusters;
+    }
+
+    std::vector<uint32_t> adjacencyOffsets;
+    std::vector<uint32_t> adjacency;
+    buildadjacency(indices, triangleCount * 3, vertexCount, adjacencyOffsets, adjacency);
+
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        liveTriangles[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+    }
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnd;    ///< 最近发出的顶点（扇形走入死胡同时回退的候选）
+    std::vector<uint32_t> candidates; ///< 本轮扇形触及的顶点
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+
+    uint32_t timestamp = cacheSize + 1;
+    size_t scanCursor = 0;
+    uint32_t fan = 0;
+    while (liveTriangles[fan] == 0 && fan + 1 < vertexCount)
+    {
+        ++fan;
+    }
+    clusters.push_back(0);
+
+    while (fan != kNoVertex)
+    {
+        // 发出以 fan 为中心的全部未发出三角形
+        candidates.clear();
+        for (uint32_t a = adjacencyOffsets[fan]; a < adjacencyOffsets[fan + 1]; ++a)
+        {
+            const uint32_t triangle = adjacency[a];
+            if (emitted[triangle])
+            {
+                continue;
+            }
+            emitted[triangle] = true;
+            for (int k = 0; k < 3; ++k)
+            {
+                const uint32_t vertex = indices[triangle * 3 + k];
+                output.push_back(vertex);
+                deadEnd.push_back(vertex);
+                candidates.push_back(vertex);
+                --liveTriangles[vertex];
+                if (timestamp - cacheTime[vertex] > cacheSize)
+                {
+                    cacheTime[vertex] = timestamp++;
+                }
+            }
+        }
+
+        // 下一个中心：仍在缓存中、且扇形发出后基本不会被挤出缓存的候选中最早进入缓存的一个
+        uint32_t next = kNoVertex;
+        int64_t bestPriority = -1;
+        for (uint32_t vertex : candidates)
+        {
+            if (liveTriangles[vertex] == 0)
+            {
+                continue;
+            }
+            int64_t priority = 0;
+            const int64_t age = static_cast<int64_t>(timestamp) - cacheTime[vertex];
+            if (age + 2 * static_cast<int64_t>(liveTriangles[vertex]) <= cacheSize)
+            {
+                priority = age;
+            }
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                next = vertex;
+            }
+        }
+
+        if (next == kNoVertex)
+        {
+            // 死胡同：先回退到最近发出的顶点，再按顺序扫描；这是非局部跳转，开始一个新簇
+            while (!deadEnd.empty() && next == kNoVertex)
+            {
+                const uint32_t vertex = deadEnd.back();
+                deadEnd.pop_back();
+                if (liveTriangles[vertex] > 0)
+                {
+                    next = vertex;
+                }
+            }
+            while (next == kNoVertex && scanCursor < vertexCount)
+            {
+                if (liveTriangles[scanCursor] > 0)
+                {
+                    next = static_cast<uint32_t>(scanCursor);
+                }
+                ++scanCursor;
+            }
+            if (next != kNoVertex && output.size() / 3 > clusters.back())
+            {
+                clusters.push_back(static_cast<uint32_t>(output.size() / 3));
+            }
+        }
+        fan = next;
+    }
+
+    // 退化三角形（同一顶点出现多次）也会被发出，输出三角形数与输入相同
+    std::copy(output.begin(), output.end(), indices);
+    return clusters;
+}
+
+void MeshOptimizer::optimizeOverdraw(uint32_t *indices, size_t indexCount, const Vertex *vertices,
+                                     const std::vector<uint32_t> &clusters)
+{
+    const size_t triangleCount = indexCount / 3;
+    if (clusters.size() < 2 || triangleCount == 0)
+    {
+        return;
+    }
+
+    // 网格质心（按面积加权）
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        const glm::vec3 &p0 = vertices[indices[t * 3 + 0]].position;
+        const glm::vec3 &p1 = vertices[indices[t * 3 + 1]].position;
+        const glm::vec3 &p2 = vertices[indices[t * 3 + 2]].position;
+        const float area = glm::length(glm::cross(p1 - p0, p2 - p0));
+        meshCentroid = meshCentroid + (p0 + p1 + p2) * (area / 3.0f);
+        meshArea += area;
+    }
+    if (meshArea <= 0.0f)
+    {
+        return;
+    }
+    meshCentroid = meshCentroid * (1.0f / meshArea);
+
+    struct Cluster
+    {
+        uint32_t firstTriangle;
+        uint32_t triangleCount;
+        float sortKey;
+    };
+    std::vector<Cluster> sorted(clusters.size());
+    for (size_t c = 0; c < clusters.size(); ++c)
+    {
+        const uint32_t begin = clusters[c];
+        const uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : static_cast<uint32_t>(triangleCount);
+
+        glm::vec3 centroid(0.0f);
+        glm::vec3 normal(0.0f);
+        float area = 0.0f;
+        for (uint32_t t = begin; t < end; ++t)
+        {
+            const glm::vec3 &p0 = vertices[indices[t * 3 + 0]].position;
+            const glm::vec3 &p1 = vertices[indices[t * 3 + 1]].position;
+            const glm::vec3 &p2 = vertices[indices[t * 3 + 2]].position;
+            const glm::vec3 cross = glm::cross(p1 - p0, p2 - p0);
+            const float triangleArea = glm::length(cross);
+            centroid = centroid + (p0 + p1 + p2) * (triangleArea / 3.0f);
+            normal = normal + cross;
+            area += triangleArea;
+        }
+
+        float sortKey = 0.0f;
+        const float normalLength = glm::length(normal);
+        if (area > 0.0f && normalLength > 0.0f)
+        {
+            sortKey = glm::dot(centroid * (1.0f / area) - meshCentroid, normal * (1.0f / normalLength));
+        }
+        sorted[c] = {begin, end - begin, sortKey};
+    }
+
+    // 朝外的簇更可能遮挡其他簇，先绘制；键相同时保持 Tipsify 的顺序
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const Cluster &a, const Cluster &b) { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> reordered;
+    reordered.reserve(triangleCount * 3);
+    for (const Cluster &cluster : sorted)
+    {
+        reordered.insert(reordered.end(), indices + cluster.firstTriangle * 3,
+                         indices + (cluster.firstTriangle + cluster.triangleCount) * 3);
+    }
+    std::copy(reordered.begin(), reordered.end(), indices);
+}
+
+// ==================== 顶点拉取 ====================
+
+void MeshOptimizer::optimizeVertexFetch(MeshData &meshData)
+{
+    std::vector<uint32_t> remap(meshData.vertices.size(), kNoVertex);
+    std::vector<Vertex> reordered;
+    reordered.reserve(meshData.vertices.size());
+
+    for (uint32_t &index : meshData.indices)
+    {
+        if (remap[index] == kNoVertex)
+        {
+            remap[index] = static_cast<uint32_t>(reordered.size());
+            reordered.push_back(meshData.vertices[index]);
+        }
+        index = remap[index];
+    }
+    meshData.vertices = std::move(reordered);
+}
+
+// ==================== 分析 ====================
+
+float MeshOptimizer::computeACMR(const uint32_t *indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+{
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+    {
+        return 0.0f;
+    }
+
+    // FIFO：顶点进入缓存的序号距当前不超过 cacheSize 即命中
+    std::vector<uint64_t> insertedAt(vertexCount, 0);
+    uint64_t counter = cacheSize + 1;
+    size_t misses = 0;
+    for (size_t i = 0; i < triangleCount * 3; ++i)
+    {
+        const uint32_t vertex = indices[i];
+        if (counter - insertedAt[vertex] > cacheSize)
+        {
+            insertedAt[vertex] = counter++;
+            ++misses;
+        }
+    }
+    return static_cast<float>(misses) / static_cast<float>(triangleCount);
+}
+
+} // namespace rendercore
@@ -0,0 +1,506 @@
+#include "MeshSimplifier.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+namespace rendercore
+{
+
+namespace
+{
+
+constexpr double kBorderWeight = 10.0;         ///< 边界约束平面的权重（防止开放边界向内收缩）
+constexpr double kMinFlipDot = 0.2;            ///< 折叠后三角形法线与原法线夹角余弦的下限
+constexpr double kMinProgress = 0.95;          ///< 一级简化后索引数仍高于上一级的该比例时视为无法继续简化
+constexpr uint32_t kNotCollapsed = UINT32_MAX; ///< collapsedInto 中表示顶点仍然存在
+
+/**
+ * @struct Quadric
+ * @brief 对称 4x4 二次型（平面 ax + by + cz + d = 0 的平方距离之和）
+ */
+struct Quadric
+{
+    double a2{0}, ab{0}, ac{0}, ad{0};
+    double b2{0}, bc{0}, bd{0};
+    double c2{0}, cd{0};
+    double d2{0};
+
+    void addplane(const glm::dvec3 &n, double d, double weight)
+    {
+        a2 += weight * n.x * n.x;
+        ab += weight * n.x * n.y;
+        ac += weight * n.x * n.z;
+        ad += weight * n.x * d;
+        b2 += weight * n.y * n.y;
+        bc += weight * n.y * n.z;
+        bd += weight * n.y * d;
+        c2 += weight * n.z * n.z;
+        cd += weight * n.z * d;
+        d2 += weight * d * d;
+    }
+
+    void add(const Quadric &other)
+    {
+        a2 += other.a2;
+        ab += other.ab;
+        ac += other.ac;
+        ad += other.ad;
+        b2 += other.b2;
+        bc += other.bc;
+        bd += other.bd;
+        c2 += other.c2;
+        cd += other.cd;
+        d2 += other.d2;
+    }
+
+    double evaluate(const glm::dvec3 &p) const
+    {
+        double value = a2 * p.x * p.x + 2.0 * ab * p.x * p.y + 2.0 * ac * p.x * p.z + 2.0 * ad * p.x +
+                       b2 * p.y * p.y + 2.0 * bc * p.y * p.z + 2.0 * bd * p.y + c2 * p.z * p.z + 2.0 * cd * p.z + d2;
+        return std::max(value, 0.0);
+    }
+};
+
+/**
+ * @struct Collapse
+ * @brief 候选边折叠（from 合并到 to），版本号用于惰性丢弃过期项
+ */
+struct Collapse
+{
+    double cost;
+    uint32_t from;
+    uint32_t to;
+    uint32_t fromVersion;
+    uint32_t toVersion;
+
+    bool operator>(const Collapse &other) const
+    {
+        return cost > other.cost;
+    }
+};
+
+struct PositionKey
+{
+    uint32_t bits[3];
+
+    bool operator==(const PositionKey &other) const
+    {
+        return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+    }
+};
+
+struct PositionKeyHash
+{
+    size_t operator()(const PositionKey &key) const
+    {
+        return (static_cast<size_t>(key.bits[0]) * 73856093u) ^ (static_cast<size_t>(key.bits[1]) * 19349663u) ^
+               (static_cast<size_t>(key.bits[2]) * 83492791u);
+    }
+};
+
+PositionKey makekey(const glm::vec3 &position)
+{
+    // +0.0 与 -0.0 视为同一位置
+    glm::vec3 p = position + glm::vec3(0.0f);
+    PositionKey key;
+    std::memcpy(key.bits, &p.x, sizeof(key.bits));
+    return key;
+}
+
+uint64_t edgekey(uint32_t a, uint32_t b)
+{
+    return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+}
+
+glm::dvec3 trianglenormal(const glm::dvec3 &p0, const glm::dvec3 &p1, const glm::dvec3 &p2)
+{
+    return glm::cross(p1 - p0, p2 - p0);
+}
+
+} // namespace
+
+// ==================== 简化 ====================
+
+std::vector<uint32_t> MeshSimplifier::simplify(const Vertex *vertices, size_t vertexCount, const uint32_t *indices,
+                                               size_t indexCount, size_t targetIndexCount, float targetError,
+                                               float *resultError)
+{
+    if (resultError)
+    {
+        *resultError = 0.0f;
+    }
+    std::vector<uint32_t> result(indices, indices + indexCount);
+    if (vertexCount == 0 || indexCount < 3 || indexCount <= targetIndexCount)
+    {
+        return result;
+    }
+
+    // 按位置焊接：纹理坐标/法线接缝两侧的顶点在拓扑上是同一个点
+    std::vector<uint32_t> weldOf(vertexCount);
+    std::vector<glm::vec3> weldedPositions;
+    {
+        std::unordered_map<PositionKey, uint32_t, PositionKeyHash> welds;
+        welds.reserve(vertexCount);
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            auto [it, inserted] =
+                welds.try_emplace(makekey(vertices[i].position), static_cast<uint32_t>(weldedPositions.size()));
+            if (inserted)
+            {
+                weldedPositions.push_back(vertices[i].position);
+            }
+            weldOf[i] = it->second;
+        }
+    }
+    const auto weldedCount = static_cast<uint32_t>(weldedPositions.size());
+
+    // 位置归一化到单位尺度，误差与模型大小无关
+    glm::vec3 boundsMin = weldedPositions[0];
+    glm::vec3 boundsMax = weldedPositions[0];
+    for (const glm::vec3 &position : weldedPositions)
+    {
+        boundsMin = glm::min(boundsMin, position);
+        boundsMax = glm::max(boundsMax, position);
+    }
+    const float halfDiagonal = 0.5f * glm::length(boundsMax - boundsMin);
+    if (halfDiagonal <= 0.0f)
+    {
+        return result;
+    }
+    const glm::dvec3 center = glm::dvec3(boundsMin + boundsMax) * 0.5;
+    const double scale = 1.0 / halfDiagonal;
+
+    std::vector<glm::dvec3> positions(weldedCount);
+    for (uint32_t w = 0; w < weldedCount; ++w)
+    {
+        positions[w] = (glm::dvec3(weldedPositions[w]) - center) * scale;
+    }
+
+    // 三角形（焊接编号），跳过退化三角形
+    const size_t triangleCount = indexCount / 3;
+    std::vector<std::array<uint32_t, 3>> triangles(triangleCount);
+    std::vector<bool> triangleAlive(triangleCount, false);
+    size_t aliveCount = 0;
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            triangles[t][k] = weldOf[indices[t * 3 + k]];
+        }
+        const auto &tri = triangles[t];
+        if (tri[0] != tri[1] && tri[1] != tri[2] && tri[0] != tri[2])
+        {
+            triangleAlive[t] = true;
+            ++aliveCount;
+        }
+    }
+
+    // 平面二次型与边界约束
+    std::vector<Quadric> quadrics(weldedCount);
+    std::unordered_map<uint64_t, uint32_t> edgeUse;
+    edgeUse.reserve(aliveCount * 3);
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        if (!triangleAlive[t])
+        {
+            continue;
+        }
+        const auto &tri = triangles[t];
+        glm::dvec3 normal = trianglenormal(positions[tri[0]], positions[tri[1]], positions[tri[2]]);
+        const double length = glm::length(normal);
+        if (length > 0.0)
+        {
+            normal /= length;
+            const double d = -glm::dot(normal, positions[tri[0]]);
+            for (int k = 0; k < 3; ++k)
+            {
+                quadrics[tri[k]].addplane(normal, d, 1.0);
+            }
+        }
+        for (int k = 0; k < 3; ++k)
+        {
+            ++edgeUse[edgekey(tri[k], tri[(k + 1) % 3])];
+        }
+    }
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        if (!triangleAlive[t])
+        {
+            continue;
+        }
+        const auto &tri = triangles[t];
+        const glm::dvec3 normal = trianglenormal(positions[tri[0]], positions[tri[1]], positions[tri[2]]);
+        for (int k = 0; k < 3; ++k)
+        {
+            const uint32_t a = tri[k];
+            const uint32_t b = tri[(k + 1) % 3];
+            if (edgeUse[edgekey(a, b)] != 1)
+            {
+                continue;
+            }
+            glm::dvec3 borderNormal = glm::cross(positions[b] - positions[a], normal);
+            const double length = glm::length(borderNormal);
+            if (length <= 0.0)
+            {
+                continue;
+            }
+            borderNormal /= length;
+            const double d = -glm::dot(borderNormal, positions[a]);
+            quadrics[a].addplane(borderNormal, d, kBorderWeight);
+            quadrics[b].addplane(borderNormal, d, kBorderWeight);
+        }
+    }
+
+    // 顶点 -> 相邻三角形（折叠后追加，使用时过滤失效项）
+    std::vector<std::vector<uint32_t>> adjacency(weldedCount);
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        if (triangleAlive[t])
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                adjacency[triangles[t][k]].push_back(static_cast<uint32_t>(t));
+            }
+        }
+    }
+
+    std::vector<uint32_t> versions(weldedCount, 0);
+    std::vector<uint32_t> collapsedInto(weldedCount, kNotCollapsed);
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+
+    auto pushedges = [&](uint32_t vertex) {
+        for (uint32_t t : adjacency[vertex])
+        {
+            if (!triangleAlive[t])
+            {
+                continue;
+            }
+            for (uint32_t other : triangles[t])
+            {
+                if (other == vertex)
+                {
+                    continue;
+                }
+                Quadric combined = quadrics[vertex];
+                combined.add(quadrics[other]);
+                heap.push({combined.evaluate(positions[other]), vertex, other, versions[vertex], versions[other]});
+                heap.push({combined.evaluate(positions[vertex]), other, vertex, versions[other], versions[vertex]});
+            }
+        }
+    };
+    for (uint32_t w = 0; w < weldedCount; ++w)
+    {
+        pushedges(w);
+    }
+
+    // 折叠后 from 的相邻三角形是否翻转或退化
+    auto flips = [&](uint32_t from, uint32_t to) {
+        for (uint32_t t : adjacency[from])
+        {
+            const auto &tri = triangles[t];
+            if (!triangleAlive[t] || std::find(tri.begin(), tri.end(), to) != tri.end())
+            {
+                continue;
+            }
+            glm::dvec3 before = trianglenormal(positions[tri[0]], positions[tri[1]], positions[tri[2]]);
+            glm::dvec3 p[3];
+            for (int k = 0; k < 3; ++k)
+            {
+                p[k] = positions[tri[k] == from ? to : tri[k]];
+            }
+            glm::dvec3 after = trianglenormal(p[0], p[1], p[2]);
+            const double beforeLength = glm::length(before);
+            const double afterLength = glm::length(after);
+            if (afterLength <= 1e-12 || glm::dot(before, after) < kMinFlipDot * beforeLength * afterLength)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    const double maxCost = static_cast<double>(targetError) * targetError;
+    double worstCost = 0.0;
+    while (aliveCount * 3 > targetIndexCount && !heap.empty())
+    {
+        const Collapse collapse = heap.top();
+        heap.pop();
+        if (collapsedInto[collapse.from] != kNotCollapsed || collapsedInto[collapse.to] != kNotCollapsed ||
+            versions[collapse.from] != collapse.fromVersion || versions[collapse.to] != collapse.toVersion)
+        {
+            continue;
+        }
+        // 最小堆：之后的候选误差只会更大
+        if (collapse.cost > maxCost)
+        {
+            break;
+        }
+        if (flips(collapse.from, collapse.to))
+        {
+            continue;
+        }
+
+        const uint32_t from = collapse.from;
+        const uint32_t to = collapse.to;
+        for (uint32_t t : adjacency[from])
+        {
+            if (!triangleAlive[t])
+            {
+                continue;
+            }
+            auto &tri = triangles[t];
+            if (std::find(tri.begin(), tri.end(), to) != tri.end())
+            {
+                triangleAlive[t] = false;
+                --aliveCount;
+                continue;
+            }
+            std::replace(tri.begin(), tri.end(), from, to);
+            adjacency[to].push_back(t);
+        }
+        adjacency[from].clear();
+        collapsedInto[from] = to;
+        quadrics[to].add(quadrics[from]);
+        ++versions[to];
+        worstCost = std::max(worstCost, collapse.cost);
+        pushedges(to);
+    }
+
+    // 焊接点 -> 原始顶点列表（输出时为每个角挑选法线最接近的原始顶点，保留接缝）
+    std::vector<uint32_t> groupStart(weldedCount + 1, 0);
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        ++groupStart[weldOf[i] + 1];
+    }
+    for (uint32_t w = 0; w < weldedCount; ++w)
+    {
+        groupStart[w + 1] += groupStart[w];
+    }
+    std::vector<uint32_t> groupVertices(vertexCount);
+    {
+        std::vector<uint32_t> cursor(groupStart.begin(), groupStart.end() - 1);
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            groupVertices[cursor[weldOf[i]]++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    result.clear();
+    result.reserve(aliveCount * 3);
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        if (!triangleAlive[t])
+        {
+            continue;
+        }
+        for (int k = 0; k < 3; ++k)
+        {
+            const uint32_t original = indices[t * 3 + k];
+            const uint32_t welded = triangles[t][k];
+            if (weldOf[original] == welded)
+            {
+                result.push_back(original);
+                continue;
+            }
+            uint32_t best = groupVertices[groupStart[welded]];
+            float bestDot = -2.0f;
+            for (uint32_t g = groupStart[welded]; g < groupStart[welded + 1]; ++g)
+            {
+                const float dot = glm::dot(vertices[groupVertices[g]].normal, vertices[original].normal);
+                if (dot > bestDot)
+                {
+                    bestDot = dot;
+                    best = groupVertices[g];
+                }
+            }
+            result.push_back(best);
+        }
+    }
+
+    if (resultError)
+    {
+        *resultError = static_cast<float>(std::sqrt(worstCost));
+    }
+    return result;
+}
+
+// ==================== LOD 链 ====================
+
+std::vector<MeshLod> MeshSimplifier::buildLodChain(const std::vector<Vertex> &vertices, std::vector<uint32_t> &indices,
+                                                   const MeshLodSettings &settings)
+{
+    std::vector<MeshLod> lods;
+    if (!settings.enabled || settings.maxLodCount < 2 || indices.size() < 3 || !(settings.reduction > 0.0f) ||
+        !(settings.reduction < 1.0f))
+    {
+        return lods;
+    }
+
+    lods.push_back({0, static_cast<uint32_t>(indices.size()), 0.0f});
+    std::vector<uint32_t> source(indices.begin(), indices.end());
+    float accumulatedError = 0.0f;
+
+    while (lods.size() < settings.maxLodCount && accumulatedError < settings.maxError)
+    {
+        const size_t targetIndexCount = static_cast<size_t>(source.size() * settings.reduction) / 3 * 3;
+        if (targetIndexCount / 3 < settings.minTriangleCount)
+        {
+            break;
+        }
+
+        float levelError = 0.0f;
+        std::vector<uint32_t> simplified =
+            simplify(vertices.data(), vertices.size(), source.data(), source.size(), targetIndexCount,
+                     settings.maxError - accumulatedError, &levelError);
+        if (simplified.empty() || simplified.size() > source.size() * kMinProgress)
+        {
+            break;
+        }
+
+        accumulatedError += levelError;
+        MeshLod lod;
+        lod.firstIndex = static_cast<uint32_t>(indices.size());
+        lod.indexCount = static_cast<uint32_t>(simplified.size());
+        lod.error = accumulatedError;
+        indices.insert(indices.end(), simplified.begin(), simplified.end());
+        lods.push_back(lod);
+        source = std::move(simplified);
+    }
+
+    // 一级都没有简化出来时不记录 LOD 表
+    if (lods.size() < 2)
+    {
+        lods.clear();
+    }
+    return lods;
+}
+
+uint32_t MeshSimplifier::hashSettings(const MeshLodSettings &settings)
+{
+    if (!settings.enabled)
+    {
+        return 0;
+    }
+
+    uint32_t words[4] = {settings.maxLodCount, 0, 0, settings.minTriangleCount};
+    std::memcpy(&words[1], &settings.reduction, sizeof(float));
+    std::memcpy(&words[2], &settings.maxError, sizeof(float));
+
+    // FNV-1a 32 位
+    uint32_t hash = 2166136261u;
+    for (uint32_t word : words)
+    {
+        for (int byte = 0; byte < 4; ++byte)
+        {
+            hash ^= (word >> (byte * 8)) & 0xFFu;
+            hash *= 16777619u;
+        }
+    }
+    return hash != 0 ? hash : 1;
+}
+
+} // namespace rendercore
@@ -0,0 +1,284 @@
+#include "MeshletBuilder.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+namespace rendercore
+{
+
+namespace
+{
+
+constexpr uint8_t kNotInMeshlet = 0xFF;
+
+// 候选评分中法线偏离的权重：新增顶点数相同时优先选择与簇平均法线一致的三角形，使法线锥更窄
+constexpr float kConeWeight = 0.5f;
+
+// 法线锥过宽（最小夹角余弦低于该值）时不做背面锥剔除
+constexpr float kMinConeDot = 0.1f;
+
+/**
+ * @struct MeshletBuilderState
+ * @brief 正在生长的 meshlet
+ */
+struct MeshletBuilderState
+{
+    std::vector<uint32_t> vertices;  ///< 网格顶点索引
+    std::vector<uint8_t> triangles;  ///< 局部索引
+    std::vector<uint32_t> candidates; ///< 与已有顶点相邻的三角形（可能已被使用，选择时跳过）
+    glm::vec3 normalSum{0.0f};
+};
+
+/**
+ * @brief 顶点 -> 相邻三角形的 CSR 表
+ */
+void buildadjacency(const uint32_t *indices, size_t indexCount, size_t vertexCount, std::vector<uint32_t> &offsets,
+                    std::vector<uint32_t> &triangles)
+{
+    offsets.assign(vertexCount + 1, 0);
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        ++offsets[indices[i] + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    triangles.resize(indexCount);
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+}
+
+glm::vec3 trianglenormal(const Vertex *vertices, const uint32_t *triangle)
+{
+    const glm::vec3 normal = glm::cross(vertices[triangle[1]].position - vertices[triangle[0]].position,
+                                        vertices[triangle[2]].position - vertices[triangle[0]].position);
+    const float length = glm::length(normal);
+    return length > 0.0f ? normal * (1.0f / length) : glm::vec3(0.0f);
+}
+
+/**
+ * @brief 计算 meshlet 的包围球与法线锥
+ */
+void computebounds(const Vertex *vertices, const MeshletData &data, GPUMeshlet &meshlet)
+{
+    const uint32_t *meshletVertices = data.vertices.data() + meshlet.vertexOffset;
+    const uint8_t *meshletTriangles = data.triangles.data() + meshlet.triangleOffset;
+
+    glm::vec3 minPosition = vertices[meshletVertices[0]].position;
+    glm::vec3 maxPosition = minPosition;
+    for (uint32_t i = 1; i < meshlet.vertexCount; ++i)
+    {
+        minPosition = glm::min(minPosition, vertices[meshletVertices[i]].position);
+        maxPosition = glm::max(maxPosition, vertices[meshletVertices[i]].position);
+    }
+    const glm::vec3 center = (minPosition + maxPosition) * 0.5f;
+    float radiusSquared = 0.0f;
+    for (uint32_t i = 0; i < meshlet.vertexCount; ++i)
+    {
+        const glm::vec3 offset = vertices[meshletVertices[i]].position - center;
+        radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+    }
+    meshlet.sphere = glm::vec4(center, std::sqrt(radiusSquared));
+
+    // 锥轴取三角形单位法线的平均，截断值 sqrt(1 - minDot²) 为锥半角的正弦
+    std::vector<glm::vec3> normals(meshlet.triangleCount);
+    glm::vec3 axis(0.0f);
+    for (uint32_t t = 0; t < meshlet.triangleCount; ++t)
+    {
+        const uint32_t triangle[3] = {meshletVertices[meshletTriangles[t * 3 + 0]],
+                                      meshletVertices[meshletTriangles[t * 3 + 1]],
+                                      meshletVertices[meshletTriangles[t * 3 + 2]]};
+        normals[t] = trianglenormal(vertices, triangle);
+        axis = axis + normals[t];
+    }
+    const float axisLength = glm::length(axis);
+    if (axisLength <= 0.0f)
+    {
+        meshlet.cone = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+        return;
+    }
+    axis = axis * (1.0f / axisLength);
+
+    float minDot = 1.0f;
+    for (const glm::vec3 &normal : normals)
+    {
+        // 退化三角形不可见，不影响锥
+        if (glm::dot(normal, normal) > 0.0f)
+        {
+            minDot = std::min(minDot, glm::dot(normal, axis));
+        }
+    }
+    const float cutoff = minDot < kMinConeDot ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+    meshlet.cone = glm::vec4(axis, cutoff);
+}
+
+/**
+ * @brief 结束当前 meshlet：写入描述与局部三角形（起点按 4 字节对齐），重置局部索引表
+ */
+void flushmeshlet(MeshletBuilderState &state, std::vector<uint8_t> &localIndex, MeshletData &data)
+{
+    if (state.triangles.empty())
+    {
+        return;
+    }
+
+    GPUMeshlet meshlet{};
+    meshlet.vertexOffset = static_cast<uint32_t>(data.vertices.size());
+    meshlet.triangleOffset = static_cast<uint32_t>(data.triangles.size());
+    meshlet.vertexCount = static_cast<uint32_t>(state.vertices.size());
+    meshlet.triangleCount = static_cast<uint32_t>(state.triangles.size() / 3);
+    data.meshlets.push_back(meshlet);
+
+    data.vertices.insert(data.vertices.end(), state.vertices.begin(), state.vertices.end());
+    data.triangles.insert(data.triangles.end(), state.triangles.begin(), state.triangles.end());
+    data.triangles.resize((data.triangles.size() + 3) & ~size_t(3), 0);
+
+    for (uint32_t vertex : state.vertices)
+    {
+        localIndex[vertex] = kNotInMeshlet;
+    }
+    state.vertices.clear();
+    state.triangles.clear();
+    state.candidates.clear();
+    state.normalSum = glm::vec3(0.0f);
+}
+
+} // namespace
+
+MeshletData MeshletBuilder::build(const Vertex *vertices, size_t vertexCount, const uint32_t *indices,
+                                  size_t indexCount, uint32_t maxVertices, uint32_t maxTriangles)
+{
+    if (maxVertices < 3 || maxVertices >= kNotInMeshlet || maxTriangles < 1 || maxTriangles > 255)
+    {
+        throw std::invalid_argument("MeshletBuilder::build: maxVertices must be in [3, 254] and maxTriangles in "
+                                    "[1, 255]");
+    }
+
+    MeshletData data;
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || vertexCount == 0)
+    {
+        return data;
+    }
+    data.meshlets.reserve(triangleCount / maxTriangles + 1);
+    data.vertices.reserve(triangleCount);
+    data.triangles.reserve(indexCount + triangleCount / maxTriangles * 4);
+
+    std::vector<uint32_t> adjacencyOffsets;
+    std::vector<uint32_t> adjacency;
+    buildadjacency(indices, triangleCount * 3, vertexCount, adjacencyOffsets, adjacency);
+
+    std::vector<glm::vec3> normals(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        normals[t] = trianglenormal(vertices, indices + t * 3);
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint8_t> localIndex(vertexCount, kNotInMeshlet);
+    MeshletBuilderState state;
+    state.vertices.reserve(maxVertices);
+    state.triangles.reserve(maxTriangles * 3);
+
+    auto newvertexcount = [&](uint32_t triangle) {
+        const uint32_t *corners = indices + size_t(triangle) * 3;
+        return uint32_t(localIndex[corners[0]] == kNotInMeshlet) + uint32_t(localIndex[corners[1]] == kNotInMeshlet) +
+               uint32_t(localIndex[corners[2]] == kNotInMeshlet);
+    };
+
+    auto append = [&](uint32_t triangle) {
+        const uint32_t *corners = indices + size_t(triangle) * 3;
+        for (int c = 0; c < 3; ++c)
+        {
+            const uint32_t vertex = corners[c];
+            if (localIndex[vertex] == kNotInMeshlet)
+            {
+                localIndex[vertex] = static_cast<uint8_t>(state.vertices.size());
+                state.vertices.push_back(vertex);
+                for (uint32_t a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1]; ++a)
+                {
+                    if (!emitted[adjacency[a]])
+                    {
+                        state.candidates.push_back(adjacency[a]);
+                    }
+                }
+            }
+            state.triangles.push_back(localIndex[vertex]);
+        }
+        state.normalSum = state.normalSum + normals[triangle];
+        emitted[triangle] = true;
+    };
+
+    size_t seedCursor = 0;
+    size_t remaining = triangleCount;
+    while (remaining > 0)
+    {
+        // 在相邻候选中选择新增顶点最少、法线最一致的三角形（顺带压缩掉已使用的候选）
+        uint32_t best = UINT32_MAX;
+        float bestScore = 0.0f;
+        const float normalLength = glm::length(state.normalSum);
+        const glm::vec3 averageNormal = normalLength > 0.0f ? state.normalSum * (1.0f / normalLength) : glm::vec3(0.0f);
+        size_t kept = 0;
+        for (uint32_t candidate : state.candidates)
+        {
+            if (emitted[candidate])
+            {
+                continue;
+            }
+            state.candidates[kept++] = candidate;
+            const float score = static_cast<float>(newvertexcount(candidate)) +
+                                kConeWeight * (1.0f - glm::dot(normals[candidate], averageNormal));
+            if (best == UINT32_MAX || score < bestScore)
+            {
+                best = candidate;
+                bestScore = score;
+            }
+        }
+        state.candidates.resize(kept);
+
+        // 没有相邻候选时按索引顺序取下一个未使用的三角形作为种子
+        if (best == UINT32_MAX)
+        {
+            while (emitted[seedCursor])
+            {
+                ++seedCursor;
+            }
+            best = static_cast<uint32_t>(seedCursor);
+        }
+
+        if (state.vertices.size() + newvertexcount(best) > maxVertices || state.triangles.size() / 3 >= maxTriangles)
+        {
+            flushmeshlet(state, localIndex, data);
+            continue;
+        }
+        append(best);
+        --remaining;
+    }
+    flushmeshlet(state, localIndex, data);
+
+    for (GPUMeshlet &meshlet : data.meshlets)
+    {
+        computebounds(vertices, data, meshlet);
+    }
+    return data;
+}
+
+std::vector<uint32_t> MeshletBuilder::pack(const MeshletData &data, uint32_t &vertexWordOffset,
+                                           uint32_t &triangleWordOffset)
+{
+    constexpr size_t kMeshletWords = sizeof(GPUMeshlet) / sizeof(uint32_t);
+    vertexWordOffset = static_cast<uint32_t>(data.meshlets.size() * kMeshletWords);
+    triangleWordOffset = static_cast<uint32_t>(vertexWordOffset + data.vertices.size());
+
+    std::vector<uint32_t> words(triangleWordOffset + (data.triangles.size() + 3) / 4, 0);
+    std::memcpy(words.data(), data.meshlets.data(), data.meshlets.size() * sizeof(GPUMeshlet));
+    std::copy(data.vertices.begin(), data.vertices.end(), words.begin() + vertexWordOffset);
+    std::memcpy(words.data() + triangleWordOffset, data.triangles.data(), data.triangles.size());
+    return words;
+}
+
+} // namespace rendercore
@@ -0,0 +1,551 @@
+// RenderCore/Resource/private/ObjParser.cpp
+#include "ObjParser.hpp"
+#include "VulkanCore/public/Profiler.hpp"
+#include "VulkanCore/public/WorkerPool.hpp"
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+namespace rendercore
+{
+
+namespace
+{
+
+// ============================================================================
+// 中间数据
+// ============================================================================
+
+/**
+ * @struct ObjCorner
+ * @brief 面的一个角点（已转换为 0 基索引）
+ * @details 负索引相对于当前已出现的元素数量；分块解析时块不知道之前的块有多少元素，
+ *          因此负索引先记为块内相对值，合并时再加上前面所有块的数量
+ */
+struct ObjCorner
+{
+    int32_t v = 0;
+    int32_t vt = 0;
+    int32_t vn = 0;
+    uint8_t relative = 0; ///< 位 0/1/2：v/vt/vn 为块内相对索引
+};
+
+constexpr int32_t kMissingIndex = INT32_MIN; ///< 角点未给出 vt/vn
+constexpr uint8_t kRelativeV = 1 << 0;
+constexpr uint8_t kRelativeVT = 1 << 1;
+constexpr uint8_t kRelativeVN = 1 << 2;
+
+/**
+ * @struct ObjGroup
+ * @brief g/o 分组起点（按块内三角形序号）
+ */
+struct ObjGroup
+{
+    size_t firstTriangle = 0;
+    std::string name;
+};
+
+/**
+ * @struct ObjChunk
+ * @brief 一个块的解析结果
+ */
+struct ObjChunk
+{
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> texCoords;
+    std::vector<ObjCorner> corners; ///< 三角化后的角点，每 3 个一个三角形
+    std::vector<ObjGroup> groups;
+};
+
+// ============================================================================
+// 扫描辅助函数
+// ============================================================================
+
+inline bool isblankchar(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool isdigitchar(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline const char *skipblanks(const char *p, const char *end)
+{
+    while (p < end && isblankchar(*p))
+    {
+        ++p;
+    }
+    return p;
+}
+
+inline const char *skipline(const char *p, const char *end)
+{
+    const void *newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return newline ? static_cast<const char *>(newline) + 1 : end;
+}
+
+inline const char *parsefloat(const char *p, const char *end, float &value)
+{
+    p = skipblanks(p, end);
+    if (p < end && *p == '+')
+    {
+        ++p;
+    }
+
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc())
+    {
+        // 缺失或无法解析的分量按 0 处理（与旧的流解析行为一致）
+        value = 0.0f;
+        return p;
+    }
+    return result.ptr;
+}
+
+inline bool parseint(const char *&p, const char *end, int32_t &value)
+{
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        ++p;
+    }
+    if (p >= end || !isdigitchar(*p))
+    {
+        return false;
+    }
+
+    int64_t result = 0;
+    while (p < end && isdigitchar(*p))
+    {
+        result = std::min<int64_t>(result * 10 + (*p - '0'), INT32_MAX);
+        ++p;
+    }
+
+    value = static_cast<int32_t>(negative ? -result : result);
+    return true;
+}
+
+/**
+ * @brief 把 OBJ 的 1 基/负索引转换为 0 基（负索引记为块内相对值）
+ */
+inline int32_t toindex(int32_t raw, size_t localCount, uint8_t relativeBit, uint8_t &relative,
+                       const std::string &sourceName)
+{
+    if (raw > 0)
+    {
+        return raw - 1;
+    }
+    if (raw < 0)
+    {
+        relative |= relativeBit;
+        return static_cast<int32_t>(static_cast<int64_t>(localCount) + raw);
+    }
+    throw std::runtime_error("Invalid OBJ index 0 in: " + sourceName);
+}
+
+/**
+ * @brief 解析一个面顶点，格式：v、v/vt、v//vn、v/vt/vn
+ */
+bool parsecorner(const char *&p, const char *end, const ObjChunk &chunk, ObjCorner &corner,
+                 const std::string &sourceName)
+{
+    int32_t v = 0;
+    int32_t vt = 0;
+    int32_t vn = 0;
+    if (!parseint(p, end, v))
+    {
+        return false;
+    }
+
+    if (p < end && *p == '/')
+    {
+        ++p;
+        if (p < end && *p != '/')
+        {
+            parseint(p, end, vt);
+        }
+        if (p < end && *p == '/')
+        {
+            ++p;
+            parseint(p, end, vn);
+        }
+    }
+
+    corner.relative = 0;
+    corner.v = toindex(v, chunk.positions.size(), kRelativeV, corner.relative, sourceName);
+    corner.vt = vt != 0 ? toindex(vt, chunk.texCoords.size(), kRelativeVT, corner.relative, sourceName)
+                        : kMissingIndex;
+    corner.vn = vn != 0 ? toindex(vn, chunk.normals.size(), kRelativeVN, corner.relative, sourceName)
+                        : kMissingIndex;
+    return true;
+}
+
+/**
+ * @brief 解析 [begin, end) 范围内的完整行
+ */
+void parsechunk(const char *begin, const char *end, bool flipUVs, const std::string &sourceName, ObjChunk &chunk)
+{
+    std::vector<ObjCorner> face;
+    face.reserve(8);
+
+    const char *p = begin;
+    while (p < end)
+    {
+        p = skipblanks(p, end);
+        if (p >= end)
+        {
+            break;
+        }
+
+        const char c = *p;
+        const char next = (p + 1 < end) ? p[1] : '\n';
+
+        if (c == 'v' && isblankchar(next))
+        {
+            // 顶点位置
+            glm::vec3 pos;
+            p = parsefloat(p + 1, end, pos.x);
+            p = parsefloat(p, end, pos.y);
+            p = parsefloat(p, end, pos.z);
+            chunk.positions.push_back(pos);
+        }
+        else if (c == 'v' && next == 'n')
+        {
+            // 顶点法线
+            glm::vec3 normal;
+            p = parsefloat(p + 2, end, normal.x);
+            p = parsefloat(p, end, normal.y);
+            p = parsefloat(p, end, normal.z);
+            chunk.normals.push_back(normal);
+        }
+        else if (c == 'v' && next == 't')
+        {
+            // 纹理坐标
+            glm::vec2 uv;
+            p = parsefloat(p + 2, end, uv.x);
+            p = parsefloat(p, end, uv.y);
+            if (flipUVs)
+                uv.y = 1.0f - uv.y;
+            chunk.texCoords.push_back(uv);
+        }
+        else if (c == 'f' && isblankchar(next))
+        {
+            // 面：读取所有角点后按扇形三角化
+            face.clear();
+            p += 1;
+            while (true)
+            {
+                p = skipblanks(p, end);
+                ObjCorner corner;
+                if (p >= end || !parsecorner(p, end, chunk, corner, sourceName))
+                {
+                    break;
+                }
+                face.push_back(corner);
+            }
+
+            for (size_t i = 2; i < face.size(); ++i)
+            {
+                chunk.corners.push_back(face[0]);
+                chunk.corners.push_back(face[i - 1]);
+                chunk.corners.push_back(face[i]);
+            }
+        }
+        else if ((c == 'g' || c == 'o') && (isblankchar(next) || next == '\n'))
+        {
+            // 组或对象名（开始新的网格），取第一个名字
+            const char *nameBegin = skipblanks(p + 1, end);
+            const char *nameEnd = nameBegin;
+            while (nameEnd < end && !isblankchar(*nameEnd) && *nameEnd != '\n')
+            {
+                ++nameEnd;
+            }
+
+            ObjGroup group;
+            group.firstTriangle = chunk.corners.size() / 3;
+            group.name = nameEnd > nameBegin ? std::string(nameBegin, nameEnd) : std::string("default");
+            chunk.groups.push_back(std::move(group));
+            p = nameEnd;
+        }
+
+        // 注释、mtllib/usemtl/s 等不支持的语句以及行尾剩余内容
+        p = skipline(p, end);
+    }
+}
+
+// ============================================================================
+// 角点去重哈希表
+// ============================================================================
+
+/**
+ * @class cornertable
+ * @brief (v, vt, vn) -> 顶点索引的开放寻址哈希表（线性探测，扁平数组，无逐节点分配）
+ */
+class cornertable
+{
+  public:
+    void reset()
+    {
+        m_entries.assign(kInitialCapacity, Entry{});
+        m_mask = kInitialCapacity - 1;
+        m_count = 0;
+    }
+
+    /**
+     * @brief 查找角点；不存在时以 newIndex 插入
+     * @return 角点对应的顶点索引
+     */
+    uint32_t findorinsert(uint32_t v, uint32_t vt, uint32_t vn, uint32_t newIndex, bool &inserted)
+    {
+        // 负载因子保持在 1/2 以下
+        if ((m_count + 1) * 2 > m_entries.size())
+        {
+            grow();
+        }
+
+        size_t slot = hash(v, vt, vn) & m_mask;
+        while (true)
+        {
+            Entry &entry = m_entries[slot];
+            if (entry.index == kEmpty)
+            {
+                entry = Entry{v, vt, vn, newIndex};
+                ++m_count;
+                inserted = true;
+                return newIndex;
+            }
+            if (entry.v == v && entry.vt == vt && entry.vn == vn)
+            {
+                inserted = false;
+                return entry.index;
+            }
+            slot = (slot + 1) & m_mask;
+        }
+    }
+
+  private:
+    static constexpr uint32_t kEmpty = UINT32_MAX;
+    static constexpr size_t kInitialCapacity = 1024;
+
+    struct Entry
+    {
+        uint32_t v = 0;
+        uint32_t vt = 0;
+        uint32_t vn = 0;
+        uint32_t index = kEmpty;
+    };
+
+    static size_t hash(uint32_t v, uint32_t vt, uint32_t vn)
+    {
+        uint64_t h = v * 0x9E3779B97F4A7C15ull;
+        h ^= (vt + 0x632BE59BD9B4E019ull + (h << 6) + (h >> 2)) * 0xC2B2AE3D27D4EB4Full;
+        h ^= (vn + 0x165667B19E3779F9ull + (h << 6) + (h >> 2)) * 0x94D049BB133111EBull;
+        h ^= h >> 31;
+        return static_cast<size_t>(h);
+    }
+
+    void grow()
+    {
+        std::vector<Entry> old = std::move(m_entries);
+        m_entries.assign(old.size() * 2, Entry{});
+        m_mask = m_entries.size() - 1;
+
+        for (const Entry &entry : old)
+        {
+            if (entry.index == kEmpty)
+            {
+                continue;
+            }
+            size_t slot = hash(entry.v, entry.vt, entry.vn) & m_mask;
+            while (m_entries[slot].index != kEmpty)
+            {
+                slot = (slot + 1) & m_mask;
+            }
+            m_entries[slot] = entry;
+        }
+    }
+
+  private:
+    std::vector<Entry> m_entries;
+    size_t m_mask = 0;
+    size_t m_count = 0;
+};
+
+/**
+ * @brief 把块内索引转换为全局索引并检查范围
+ * @return 全局索引（缺失时返回 UINT32_MAX）
+ */
+inline uint32_t resolveindex(int32_t index, bool relative, size_t prefix, size_t count, const std::string &sourceName)
+{
+    if (index == kMissingIndex)
+    {
+        return UINT32_MAX;
+    }
+
+    int64_t global = relative ? static_cast<int64_t>(prefix) + index : index;
+    if (global < 0 || global >= static_cast<int64_t>(count))
+    {
+        throw std::runtime_error("OBJ index out of range in: " + sourceName);
+    }
+    return static_cast<uint32_t>(global);
+}
+
+} // namespace
+
+// ============================================================================
+// ObjParser 实现
+// ============================================================================
+
+std::vector<MeshData> ObjParser::parse(const char *data, size_t size, const std::string &sourceName,
+                                       const Options &options)
+{
+    QTR_PROFILE_SCOPE("ObjParser::parse");
+    // 1. 按行边界切块
+    size_t chunkCount = 1;
+    if (options.workers && size >= options.parallelThreshold)
+    {
+        chunkCount = options.workers->getThreadCount() + 1;
+    }
+
+    std::vector<const char *> bounds;
+    bounds.reserve(chunkCount + 1);
+    bounds.push_back(data);
+    for (size_t i = 1; i < chunkCount; ++i)
+    {
+        const char *split = std::max(data + size * i / chunkCount, bounds.back());
+        bounds.push_back(split < data + size ? skipline(split, data + size) : data + size);
+    }
+    bounds.push_back(data + size);
+
+    // 2. 各块独立扫描（顶点属性与三角化后的角点）
+    std::vector<ObjChunk> chunks(chunkCount);
+    auto parseOne = [&](uint32_t chunkIndex) {
+        parsechunk(bounds[chunkIndex], bounds[chunkIndex + 1], options.flipUVs, sourceName, chunks[chunkIndex]);
+    };
+
+    if (chunkCount > 1)
+    {
+        options.workers->parallelFor(static_cast<uint32_t>(chunkCount), parseOne);
+    }
+    else
+    {
+        parseOne(0);
+    }
+
+    // 3. 按原顺序合并顶点属性，记录每块的前缀数量
+    std::vector<size_t> positionPrefix(chunkCount);
+    std::vector<size_t> normalPrefix(chunkCount);
+    std::vector<size_t> texCoordPrefix(chunkCount);
+    size_t totalPositions = 0;
+    size_t totalNormals = 0;
+    size_t totalTexCoords = 0;
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        positionPrefix[i] = totalPositions;
+        normalPrefix[i] = totalNormals;
+        texCoordPrefix[i] = totalTexCoords;
+        totalPositions += chunks[i].positions.size();
+        totalNormals += chunks[i].normals.size();
+        totalTexCoords += chunks[i].texCoords.size();
+    }
+
+    std::vector<glm::vec3> positions = std::move(chunks[0].positions);
+    std::vector<glm::vec3> normals = std::move(chunks[0].normals);
+    std::vector<glm::vec2> texCoords = std::move(chunks[0].texCoords);
+    positions.reserve(totalPositions);
+    normals.reserve(totalNormals);
+    texCoords.reserve(totalTexCoords);
+    for (size_t i = 1; i < chunkCount; ++i)
+    {
+        positions.insert(positions.end(), chunks[i].positions.begin(), chunks[i].positions.end());
+        normals.insert(normals.end(), chunks[i].normals.begin(), chunks[i].normals.end());
+        texCoords.insert(texCoords.end(), chunks[i].texCoords.begin(), chunks[i].texCoords.end());
+        chunks[i].positions = {};
+        chunks[i].normals = {};
+        chunks[i].texCoords = {};
+    }
+
+    // 4. 解析角点、去重并按分组生成网格
+    std::vector<MeshData> meshes;
+    MeshData current;
+    current.name = "default";
+
+    cornertable table;
+    table.reset();
+
+    auto beginGroup = [&](const std::string &name) {
+        if (!current.vertices.empty())
+        {
+            meshes.push_back(std::move(current));
+            current = MeshData{};
+            table.reset();
+        }
+        current.name = name;
+    };
+
+    for (size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+    {
+        const ObjChunk &chunk = chunks[chunkIndex];
+        const size_t triangleCount = chunk.corners.size() / 3;
+        size_t groupIndex = 0;
+
+        for (size_t triangle = 0; triangle <= triangleCount; ++triangle)
+        {
+            while (groupIndex < chunk.groups.size() && chunk.groups[groupIndex].firstTriangle == triangle)
+            {
+                beginGroup(chunk.groups[groupIndex].name);
+                ++groupIndex;
+            }
+            if (triangle == triangleCount)
+            {
+                break;
+            }
+
+            for (size_t cornerIndex = triangle * 3; cornerIndex < triangle * 3 + 3; ++cornerIndex)
+            {
+                const ObjCorner &corner = chunk.corners[cornerIndex];
+                uint32_t v = resolveindex(corner.v, corner.relative & kRelativeV, positionPrefix[chunkIndex],
+                                          totalPositions, sourceName);
+                uint32_t vt = resolveindex(corner.vt, corner.relative & kRelativeVT, texCoordPrefix[chunkIndex],
+                                           totalTexCoords, sourceName);
+                uint32_t vn = resolveindex(corner.vn, corner.relative & kRelativeVN, normalPrefix[chunkIndex],
+                                           totalNormals, sourceName);
+
+                bool inserted = false;
+                uint32_t index =
+                    table.findorinsert(v, vt, vn, static_cast<uint32_t>(current.vertices.size()), inserted);
+                if (inserted)
+                {
+                    Vertex vertex;
+                    vertex.position = positions[v];
+                    vertex.normal = vn != UINT32_MAX ? normals[vn] : glm::vec3(0, 1, 0);
+                    vertex.texCoord = vt != UINT32_MAX ? texCoords[vt] : glm::vec2(0, 0);
+                    vertex.color = glm::vec4(1.0f); // 默认白色
+                    current.vertices.push_back(vertex);
+                }
+                current.indices.push_back(index);
+            }
+        }
+    }
+
+    // 保存最后一个网格
+    if (!current.vertices.empty())
+    {
+        meshes.push_back(std::move(current));
+    }
+
+    if (meshes.empty())
+    {
+        throw std::runtime_error("No geometry found in OBJ file: " + sourceName);
+    }
+
+    return meshes;
+}
+
+} // namespace rendercore
@@ -1,15 +1,93 @@
 #include "ResourceManager.hpp"
+#include "BindlessRegistry.hpp"
+#include "HdrConverter.hpp"
+#include "MaterialLibrary.hpp"
+#include "MeshOptimizer.hpp"
+#include "TextureContainer.hpp"
 #include "VulkanCore/public/CommandPoolManager.hpp"
 #include "VulkanCore/public/Descriptor.hpp"
+#include "VulkanCore/public/Log.hpp"
+#include "VulkanCore/public/MappedFile.hpp"
+#include "VulkanCore/public/Profiler.hpp"
 #include "VulkanCore/public/ShaderManager.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <functional>
-#include <iostream>
 #include <stb_image.h>
 #include <stdexcept>
 
 namespace rendercore
 {
 
+namespace
+{
+
+constexpr uint32_t kIoThreadCount = 2;                   ///< 加载流水线 I/O 阶段的线程数
+constexpr size_t kMaxShortIndexVertexCount = UINT16_MAX; ///< 不超过该顶点数的网格使用 16 位索引
+constexpr uint32_t kHdrConvertPixels = 1u << 16;         ///< 并行转换 HDR 像素时每块的像素数
+constexpr uint32_t kMaterialParseGrain = 8;              ///< 并行解析材质 JSON 时每块的文件数
+
+/**
+ * @struct MaterialUniform
+ * @brief 非 bindless 模式下材质参数的 Uniform Buffer 布局（匹配着色器中的结构）
+ */
+struct MaterialUniform
+{
+    glm::vec4 baseColorFactor;
+    glm::vec3 emissiveFactor;
+    float metallicFactor;
+    float roughnessFactor;
+    float normalScale;
+    float alphaCutoff;
+    float padding; // 对齐到16字节边界
+};
+
+MaterialUniform makematerialuniform(const Material &material)
+{
+    MaterialUniform uniformData = {};
+    uniformData.baseColorFactor = material.baseColorFactor;
+    uniformData.emissiveFactor = material.emissiveFactor;
+    uniformData.metallicFactor = material.metallicFactor;
+    uniformData.roughnessFactor = material.roughnessFactor;
+    uniformData.normalScale = material.normalScale;
+    uniformData.alphaCutoff = material.alphaCutoff;
+    return uniformData;
+}
+
+/**
+ * @brief 计算网格的模型空间包围盒与包围球
+ * @details 球心取包围盒中心，半径为到最远顶点的距离（两次线性扫描，比 Ritter 算法略松但稳定）
+ */
+void computemeshbounds(const Vertex *vertices, size_t vertexCount, BoundingBox &bounds, BoundingSphere &sphere)
+{
+    if (vertexCount == 0)
+    {
+        bounds = BoundingBox{};
+        sphere = BoundingSphere{};
+        return;
+    }
+
+    bounds.min = vertices[0].position;
+    bounds.max = vertices[0].position;
+    for (size_t i = 1; i < vertexCount; ++i)
+    {
+        bounds.min = glm::min(bounds.min, vertices[i].position);
+        bounds.max = glm::max(bounds.max, vertices[i].position);
+    }
+
+    sphere.center = bounds.getCenter();
+    float maxDistanceSquared = 0.0f;
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        glm::vec3 offset = vertices[i].position - sphere.center;
+        maxDistanceSquared = std::max(maxDistanceSquared, glm::dot(offset, offset));
+    }
+    sphere.radius = std::sqrt(maxDistanceSquared);
+}
+
+} // namespace
+
 ResourceManager::~ResourceManager()
 {
     cleanup();
@@ -17,7 +95,8 @@ ResourceManager::~ResourceManager()
 
 void ResourceManager::initialize(vkcore::Device &device, VmaAllocator allocator, vkcore::CommandPoolManager &cmdManager,
                                  vkcore::ShaderManager &shaderManager, vkcore::DescriptorAllocator &descAllocator,
-                                 vkcore::DescriptorLayoutCache &layoutCache)
+                                 vkcore::DescriptorLayoutCache &layoutCache, vkcore::SamplerCache &samplerCache,
+                                 uint32_t loaderThreads, vkcore::WorkerPool *workers)
 {
     std::lock_guard<std::mutex> lock(m_mtx);
 
@@ -27,6 +106,38 @@ void ResourceManager::initialize(vkcore::Device &device, VmaAllocator allocator,
     m_shaderManager = &shaderManager;
     m_descAllocator = &descAllocator;
     m_layoutCache = &layoutCache;
+    m_samplerCache = &samplerCache;
+
+    // 解码线程上的上传只记录进批次，不按大小自动提交：批次由调用 flushUploads() 的线程（渲染线程）提交
+    //（暂存环已满时的提交持有 Device::getQueueMutex()，与渲染线程的提交互斥）
+    m_uploadQueue = std::make_unique<vkcore::UploadQueue>(device, allocator, 64ull * 1024 * 1024, 0);
+    m_geometryPool = std::make_shared<GeometryPool>(device, allocator);
+
+    // 设备启用了描述符索引特性时改用全局 bindless 集（须在默认纹理之前创建，使其获得槽位）
+    if (BindlessRegistry::isSupported(device))
+    {
+        m_bindless = std::make_shared<BindlessRegistry>(device, allocator);
+
+        // 流送替换图像后要为纹理换用新槽位，只在 bindless 模式下启用
+        m_textureStreamer =
+            std::make_unique<TextureStreamer>(device, allocator, *m_uploadQueue, m_bindless, TextureStreamer::Config{});
+    }
+
+    // I/O 线程大多阻塞在磁盘上，少量即可；解析/解码是 CPU 密集任务，按核心数分配
+    // 共用引擎调度器时解码任务与其他并行工作一起被窃取调度，大文件的分块解析在解码任务内部嵌套执行
+    m_ioWorkers = std::make_unique<vkcore::WorkerPool>(kIoThreadCount);
+    if (!workers)
+    {
+        m_decodeWorkers = std::make_unique<vkcore::WorkerPool>(loaderThreads);
+    }
+    m_decodePool = workers ? workers : m_decodeWorkers.get();
+    m_decodeTasks = std::make_unique<vkcore::WorkerPool::TaskGroup>(*m_decodePool);
+
+    // 默认把烘焙缓存放在临时目录，无法获取时禁用
+    std::error_code ec;
+    std::filesystem::path tempDirectory = std::filesystem::temp_directory_path(ec);
+    m_meshCacheDirectory = ec ? std::filesystem::path() : tempDirectory / "QTRender" / "MeshCache";
+    m_environmentCacheDirectory = ec ? std::filesystem::path() : tempDirectory / "QTRender" / "EnvironmentCache";
 
     buildmateriallayout();
     createdefaulttextures();
@@ -36,29 +147,50 @@ void ResourceManager::initialize(vkcore::Device &device, VmaAllocator allocator,
 
 void ResourceManager::cleanup()
 {
+    // 先排空加载流水线（任务在发布结果时需要获取 m_mtx，因此不能持锁等待）
+    // I/O 线程池先析构：它的任务会继续投递解码任务；外部调度器不归本对象所有，只等待自己的任务组
+    m_ioWorkers.reset();
+    m_decodeTasks.reset();
+    m_decodeWorkers.reset();
+    m_decodePool = nullptr;
+
+    // 预过滤管线只在 m_environmentMtx 下使用（锁顺序为先 m_environmentMtx 后 m_mtx）
+    {
+        std::lock_guard<std::mutex> environmentLock(m_environmentMtx);
+        m_environmentPrefilter.reset();
+    }
+
     std::lock_guard<std::mutex> lock(m_mtx);
 
     if (!m_initialized)
         return;
 
+    // 等待在途上传结束，上传队列持有目标资源的引用
+    if (m_uploadQueue)
+    {
+        m_uploadQueue->waitIdle();
+        m_textureStreamer.reset(); // 流送器引用上传队列
+        m_uploadQueue.reset();
+    }
+
     // 清理缓存的资源
     m_meshCache.clear();
     m_textureCache.clear();
     m_materialCache.clear();
+    m_environmentCache.clear();
+    m_pendingMeshes.clear();
+    m_pendingTextures.clear();
 
-    // 清理采样器缓存
-    for (auto &pair : m_samplerCache)
-    {
-        m_device->get().destroySampler(pair.second);
-    }
-    m_samplerCache.clear();
+    // 网格全部释放后再销毁几何池（仍被外部持有的网格析构时不再归还区间）
+    m_geometryPool.reset();
 
-    // 清理描述符集布局
-    if (m_materialLayout)
-    {
-        m_device->get().destroyDescriptorSetLayout(m_materialLayout);
-        m_materialLayout = nullptr;
-    }
+    // bindless 槽位同理：默认纹理随后释放时注册表已不存在，不再归还
+    m_bindless.reset();
+
+    // 材质布局归 DescriptorLayoutCache 所有，这里只放弃引用
+    m_materialLayout = nullptr;
+    m_materialUniformPage.reset();
+    m_materialUniformsUsed = 0;
 
     // 清理默认资源
     m_defaultWhiteTexture.reset();
@@ -71,91 +203,168 @@ void ResourceManager::cleanup()
 
 std::shared_ptr<Mesh> ResourceManager::loadMesh(const std::filesystem::path &filepath)
 {
-    std::lock_guard<std::mutex> lock(m_mtx);
+    // 同步加载在调用线程上执行各阶段；同一路径已在加载时等待那次加载
+    return requestmesh(filepath, false).get();
+}
 
-    if (!m_initialized)
-    {
-        throw std::runtime_error("ResourceManager not initialized");
-    }
+std::shared_ptr<Texture> ResourceManager::loadTexture(const std::filesystem::path &filepath, bool srgb)
+{
+    return requesttexture(filepath, srgb, false).get();
+}
 
+std::shared_ptr<Material> ResourceManager::loadMaterial(const std::filesystem::path &filepath)
+{
     std::string key = filepath.string();
 
-    // 检查缓存
-    auto it = m_meshCache.find(key);
-    if (it != m_meshCache.end())
     {
-        return it->second;
+        std::lock_guard<std::mutex> lock(m_mtx);
+
+        if (!m_initialized)
+        {
+            throw std::runtime_error("ResourceManager not initialized");
+        }
+
+        // 检查缓存
+        auto it = m_materialCache.find(key);
+        if (it != m_materialCache.end())
+        {
+            return it->second;
+        }
     }
 
-    // 加载并缓存
-    auto mesh = loadanduploadmesh(filepath);
-    m_meshCache[key] = mesh;
-    return mesh;
-}
+    // 从JSON加载材质数据
+    MaterialData materialData = MaterialLoader::loadMaterialData(filepath);
 
-std::shared_ptr<Texture> ResourceManager::loadTexture(const std::filesystem::path &filepath, bool srgb)
-{
+    // 构建材质（不持有缓存锁）
+    auto material = buildmaterial(key, materialData.material, materialData.texturePaths, materialData.shaderName);
+
+    // 并发构建同一材质时保留先插入的那个
     std::lock_guard<std::mutex> lock(m_mtx);
+    return m_materialCache.emplace(key, material).first->second;
+}
 
-    if (!m_initialized)
+std::vector<std::shared_ptr<Material>> ResourceManager::loadMaterialLibrary(const std::filesystem::path &directory)
+{
+    QTR_PROFILE_SCOPE("ResourceManager::loadMaterialLibrary");
+    std::filesystem::path libraryPath;
     {
-        throw std::runtime_error("ResourceManager not initialized");
+        std::lock_guard<std::mutex> lock(m_mtx);
+
+        if (!m_initialized)
+        {
+            throw std::runtime_error("ResourceManager not initialized");
+        }
+
+        if (!m_meshCacheDirectory.empty())
+        {
+            libraryPath = MaterialLibrary::getLibraryPath(m_meshCacheDirectory, directory);
+        }
     }
 
-    std::string key = filepath.string() + (srgb ? "_srgb" : "_linear");
+    const std::vector<std::filesystem::path> sources = MaterialLibrary::listSources(directory);
+    if (sources.empty())
+    {
+        return {};
+    }
 
-    // 检查缓存
-    auto it = m_textureCache.find(key);
-    if (it != m_textureCache.end())
+    // 材质库命中：逐条解码定长记录；未命中（首次加载、文件增删改或缓存损坏）：并行解析 JSON 后重写材质库
+    std::vector<MaterialData> materials;
+    if (!libraryPath.empty() && std::filesystem::exists(libraryPath))
     {
-        return it->second;
+        try
+        {
+            vkcore::MappedFile file(libraryPath);
+            if (auto view = MaterialLibrary::open(file, directory, sources))
+            {
+                materials.reserve(view->count);
+                for (uint32_t i = 0; i < view->count; ++i)
+                {
+                    materials.push_back(view->getMaterialData(i));
+                }
+            }
+        }
+        catch (const std::exception &e)
+        {
+            QTR_LOG_WARN("ResourceManager",
+                         "Failed to map material library " << libraryPath.string() << ": " << e.what());
+        }
     }
 
-    // 加载并缓存
-    auto texture = loadanduploadtexture(filepath, srgb);
-    m_textureCache[key] = texture;
-    return texture;
-}
+    if (materials.empty())
+    {
+        materials.resize(sources.size());
+        auto parse = [&](uint32_t first, uint32_t last) {
+            for (uint32_t i = first; i < last; ++i)
+            {
+                materials[i] = MaterialLoader::loadMaterialData(sources[i]);
+            }
+        };
+        const uint32_t count = static_cast<uint32_t>(sources.size());
+        if (m_decodePool)
+        {
+            m_decodePool->parallelFor(count, kMaterialParseGrain, parse);
+        }
+        else
+        {
+            parse(0, count);
+        }
 
-std::shared_ptr<Material> ResourceManager::loadMaterial(const std::filesystem::path &filepath)
-{
-    std::lock_guard<std::mutex> lock(m_mtx);
+        if (!libraryPath.empty() && !MaterialLibrary::write(libraryPath, directory, sources, materials))
+        {
+            QTR_LOG_WARN("ResourceManager", "Failed to write material library: " << libraryPath.string());
+        }
+    }
 
-    if (!m_initialized)
+    // 缓存键与 loadMaterial 一致；已缓存的材质不重复构建
+    std::vector<std::string> keys(sources.size());
+    std::vector<std::shared_ptr<Material>> result(sources.size());
+    std::vector<std::string> buildKeys;
+    std::vector<MaterialData> buildMaterials;
+    std::vector<size_t> buildIndices;
     {
-        throw std::runtime_error("ResourceManager not initialized");
+        std::lock_guard<std::mutex> lock(m_mtx);
+        for (size_t i = 0; i < sources.size(); ++i)
+        {
+            keys[i] = (directory / sources[i].lexically_relative(directory)).string();
+            auto it = m_materialCache.find(keys[i]);
+            if (it != m_materialCache.end())
+            {
+                result[i] = it->second;
+                continue;
+            }
+            buildKeys.push_back(keys[i]);
+            buildMaterials.push_back(std::move(materials[i]));
+            buildIndices.push_back(i);
+        }
     }
 
-    std::string key = filepath.string();
-
-    // 检查缓存
-    auto it = m_materialCache.find(key);
-    if (it != m_materialCache.end())
+    if (buildKeys.empty())
     {
-        return it->second;
+        return result;
     }
 
-    // 从JSON加载材质数据
-    MaterialData materialData = MaterialLoader::loadMaterialData(filepath);
-
-    // 构建材质
-    auto material = buildmaterial(key, materialData.material, materialData.texturePaths, materialData.shaderName);
+    std::vector<std::shared_ptr<Material>> built = buildmaterials(buildKeys, buildMaterials);
 
-    m_materialCache[key] = material;
-    return material;
+    // 并发构建同一材质时保留先插入的那个
+    std::lock_guard<std::mutex> lock(m_mtx);
+    for (size_t i = 0; i < built.size(); ++i)
+    {
+        result[buildIndices[i]] = m_materialCache.emplace(buildKeys[i], built[i]).first->second;
+    }
+    return result;
 }
 
 // ==================== 异步加载接口 ====================
 
-std::future<std::shared_ptr<Mesh>> ResourceManager::loadMeshAsync(const std::filesystem::path &filepath)
+std::shared_future<std::shared_ptr<Mesh>> ResourceManager::loadMeshAsync(const std::filesystem::path &filepath)
 {
-    return std::async(std::launch::async, [this, filepath]() { return loadMesh(filepath); });
+    return requestmesh(filepath, true);
 }
 
-std::future<std::shared_ptr<Texture>> ResourceManager::loadTextureAsync(const std::filesystem::path &filepath,
-                                                                        bool srgb)
+std::shared_future<std::shared_ptr<Texture>> ResourceManager::loadTextureAsync(const std::filesystem::path &filepath,
+                                                                               bool srgb)
 {
-    return std::async(std::launch::async, [this, filepath, srgb]() { return loadTexture(filepath, srgb); });
+    return requesttexture(filepath, srgb, true);
 }
 
 // ==================== 资源注册接口 ====================
@@ -163,110 +372,77 @@ std::future<std::shared_ptr<Texture>> ResourceManager::loadTextureAsync(const st
 std::shared_ptr<Mesh> ResourceManager::registerMesh(const std::string &name, const std::vector<Vertex> &vertices,
                                                     const std::vector<uint32_t> &indices)
 {
-    std::lock_guard<std::mutex> lock(m_mtx);
-
-    if (!m_initialized)
-    {
-        throw std::runtime_error("ResourceManager not initialized");
-    }
-
-    // 检查是否已存在
-    auto it = m_meshCache.find(name);
-    if (it != m_meshCache.end())
     {
-        return it->second;
-    }
+        std::lock_guard<std::mutex> lock(m_mtx);
 
-    // 创建网格
-    auto mesh = std::make_shared<Mesh>();
-    mesh->name = name;
-    mesh->vertexCount = static_cast<uint32_t>(vertices.size());
-    mesh->indexCount = static_cast<uint32_t>(indices.size());
+        if (!m_initialized)
+        {
+            throw std::runtime_error("ResourceManager not initialized");
+        }
 
-    // 创建顶点缓冲区
-    if (!vertices.empty())
-    {
-        mesh->vertexBuffer = createbufferfromdata(vertices.data(), vertices.size() * sizeof(Vertex),
-                                                  vk::BufferUsageFlagBits::eVertexBuffer);
+        // 检查是否已存在
+        auto it = m_meshCache.find(name);
+        if (it != m_meshCache.end())
+        {
+            return it->second;
+        }
     }
 
-    // 创建索引缓冲区
-    if (!indices.empty())
-    {
-        mesh->indexBuffer = createbufferfromdata(indices.data(), indices.size() * sizeof(uint32_t),
-                                                 vk::BufferUsageFlagBits::eIndexBuffer);
-    }
+    auto mesh = createmesh(name, vertices.data(), vertices.size(), indices.data(), indices.size());
 
-    m_meshCache[name] = mesh;
-    return mesh;
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_meshCache.emplace(name, mesh).first->second;
 }
 
 std::shared_ptr<Texture> ResourceManager::registerTexture(const std::string &name, const void *pixels, int width,
                                                           int height, vk::Format format)
 {
-    std::lock_guard<std::mutex> lock(m_mtx);
-
-    if (!m_initialized)
-    {
-        throw std::runtime_error("ResourceManager not initialized");
-    }
-
-    // 检查是否已存在
-    auto it = m_textureCache.find(name);
-    if (it != m_textureCache.end())
     {
-        return it->second;
-    }
+        std::lock_guard<std::mutex> lock(m_mtx);
 
-    // 创建纹理
-    auto texture = std::make_shared<Texture>();
-    texture->name = name;
-
-    // 创建图像
-    texture->image = createimagefromdata(pixels, width, height, format);
+        if (!m_initialized)
+        {
+            throw std::runtime_error("ResourceManager not initialized");
+        }
 
-    // 创建采样器
-    vk::SamplerCreateInfo samplerInfo = {};
-    samplerInfo.magFilter = vk::Filter::eLinear;
-    samplerInfo.minFilter = vk::Filter::eLinear;
-    samplerInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
-    samplerInfo.addressModeV = vk::SamplerAddressMode::eRepeat;
-    samplerInfo.addressModeW = vk::SamplerAddressMode::eRepeat;
-    samplerInfo.anisotropyEnable = VK_TRUE;
-    samplerInfo.maxAnisotropy = 16.0f;
-    samplerInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
-    samplerInfo.unnormalizedCoordinates = VK_FALSE;
-    samplerInfo.compareEnable = VK_FALSE;
-    samplerInfo.compareOp = vk::CompareOp::eAlways;
-    samplerInfo.mipmapMode = vk::SamplerMipmapMode::eLinear;
+        // 检查是否已存在
+        auto it = m_textureCache.find(name);
+        if (it != m_textureCache.end())
+        {
+            return it->second;
+        }
+    }
 
-    texture->sampler = m_device->get().createSamplerUnique(samplerInfo);
+    auto texture = createtexture(name, pixels, width, height, format);
 
-    m_textureCache[name] = texture;
-    return texture;
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_textureCache.emplace(name, texture).first->second;
 }
 
 std::shared_ptr<Material> ResourceManager::registerMaterial(const std::string &name, const Material &materialInfo,
                                                             const TexturePaths &textureNames,
                                                             const std::string &shaderName)
 {
-    std::lock_guard<std::mutex> lock(m_mtx);
-
-    if (!m_initialized)
     {
-        throw std::runtime_error("ResourceManager not initialized");
-    }
+        std::lock_guard<std::mutex> lock(m_mtx);
 
-    // 检查是否已存在
-    auto it = m_materialCache.find(name);
-    if (it != m_materialCache.end())
-    {
-        return it->second;
+        if (!m_initialized)
+        {
+            throw std::runtime_error("ResourceManager not initialized");
+        }
+
+        // 检查是否已存在
+        auto it = m_materialCache.find(name);
+        if (it != m_materialCache.end())
+        {
+            return it->second;
+        }
     }
 
     auto material = buildmaterial(name, materialInfo, textureNames, shaderName);
-    m_materialCache[name] = material;
-    return material;
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_materialCache.emplace(name, material).first->second;
 }
 
 // ==================== 资源访问与管理 ====================
@@ -312,6 +488,10 @@ bool ResourceManager::unloadMesh(const std::string &name)
     auto it = m_meshCache.find(name);
     if (it != m_meshCache.end())
     {
+        if (m_deletionQueue)
+        {
+            m_deletionQueue->destroy(std::move(it->second));
+        }
         m_meshCache.erase(it);
         return true;
     }
@@ -325,6 +505,10 @@ bool ResourceManager::unloadTexture(const std::string &name)
     auto it = m_textureCache.find(name);
     if (it != m_textureCache.end())
     {
+        if (m_deletionQueue)
+        {
+            m_deletionQueue->destroy(std::move(it->second));
+        }
         m_textureCache.erase(it);
         return true;
     }
@@ -389,443 +573,1461 @@ std::vector<std::string> ResourceManager::getMaterialNames() const
     return names;
 }
 
-// ==================== 描述符布局访问接口 ====================
+// ==================== 上传同步接口 ====================
 
-vk::DescriptorSetLayout ResourceManager::getMaterialLayout() const
+vkcore::UploadTicket ResourceManager::flushUploads()
 {
+    QTR_PROFILE_SCOPE("ResourceManager::flushUploads");
+    std::lock_guard<std::mutex> lock(m_mtx);
 
     if (!m_initialized)
     {
         throw std::runtime_error("ResourceManager not initialized");
     }
 
-    return m_materialLayout;
+    return m_uploadQueue->flush();
 }
 
-bool ResourceManager::isInitialized() const
+void ResourceManager::waitForUploads()
 {
-    std::lock_guard<std::mutex> lock(m_mtx);
-    return m_initialized;
+    QTR_PROFILE_SCOPE("ResourceManager::waitForUploads");
+    vkcore::UploadQueue *uploadQueue = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+
+        if (!m_initialized)
+        {
+            throw std::runtime_error("ResourceManager not initialized");
+        }
+        uploadQueue = m_uploadQueue.get();
+    }
+
+    // 等待期间不持有缓存锁，加载线程可以继续发布结果
+    uploadQueue->waitIdle();
 }
 
-// ==================== 私有辅助函数 ====================
+std::vector<std::shared_ptr<vkcore::Buffer>> ResourceManager::defragmentGeometry(vk::CommandBuffer cmd,
+                                                                                 float threshold)
+{
+    // 拷贝读取的是旧缓冲中的已上传数据，整理前必须等待所有在途上传完成
+    waitForUploads();
 
-void ResourceManager::buildmateriallayout()
+    GeometryPool *geometryPool = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        geometryPool = m_geometryPool.get();
+    }
+    return geometryPool->defragment(cmd, threshold);
+}
+
+void ResourceManager::updateTextureStreaming()
 {
-    // 创建材质描述符集布局
-    std::vector<vk::DescriptorSetLayoutBinding> bindings = {
-        // 绑定 0: 材质参数统一缓冲区
-        {0, vk::DescriptorType::eUniformBuffer, 1,
-         vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment},
-        // 绑定 1-6: 纹理采样器
-        {1, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment}, // Base Color
-        {2, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment}, // Metallic
-        {3, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment}, // Roughness
-        {4, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment}, // Normal
-        {5, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment}, // Occlusion
-        {6, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment}  // Emissive
+    QTR_PROFILE_SCOPE("ResourceManager::updateTextureStreaming");
+    TextureStreamer *textureStreamer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        textureStreamer = m_textureStreamer.get();
+    }
+    if (!textureStreamer)
+    {
+        return;
+    }
+
+    std::vector<std::shared_ptr<Texture>> swapped = textureStreamer->update();
+    if (swapped.empty())
+    {
+        return;
+    }
+
+    // 替换后的纹理换用了新的 bindless 槽位，引用它们的材质参数中的纹理索引随之改写
+    auto references = [&swapped](const std::shared_ptr<Texture> &texture) {
+        return texture && std::find(swapped.begin(), swapped.end(), texture) != swapped.end();
     };
 
-    vk::DescriptorSetLayoutCreateInfo layoutInfo = {};
-    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-    layoutInfo.pBindings = bindings.data();
+    std::lock_guard<std::mutex> lock(m_mtx);
+    for (const auto &[name, material] : m_materialCache)
+    {
+        if (material->bindless.isValid() &&
+            (references(material->baseColorTexture) || references(material->metallicTexture) ||
+             references(material->roughnessTexture) || references(material->normalTexture) ||
+             references(material->occlusionTexture) || references(material->emissiveTexture)))
+        {
+            m_bindless->updateMaterial(*material);
+        }
+    }
+}
 
-    m_materialLayout = m_device->get().createDescriptorSetLayout(layoutInfo);
+bool ResourceManager::isResident(const Mesh &mesh) const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return !m_uploadQueue || m_uploadQueue->isComplete(mesh.uploadTicket);
 }
 
-std::shared_ptr<vkcore::Buffer> ResourceManager::createbufferfromdata(const void *data, vk::DeviceSize size,
-                                                                      vk::BufferUsageFlags usage)
+bool ResourceManager::isResident(const Texture &texture) const
 {
-    // 创建暂存缓冲区
-    vkcore::BufferDesc stagingDesc = {};
-    stagingDesc.size = size;
-    stagingDesc.usageFlags = vk::BufferUsageFlagBits::eTransferSrc;
-    stagingDesc.memoryUsage = VMA_MEMORY_USAGE_CPU_ONLY;
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return !m_uploadQueue || m_uploadQueue->isComplete(texture.uploadTicket);
+}
 
-    auto stagingBuffer = std::make_shared<vkcore::Buffer>("staging", *m_device, m_allocator, stagingDesc);
+// ==================== 烘焙缓存接口 ====================
 
-    // 复制数据到暂存缓冲区
-    stagingBuffer->write(data, size);
+void ResourceManager::setMeshCacheDirectory(const std::filesystem::path &directory)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_meshCacheDirectory = directory;
+}
 
-    // 创建目标缓冲区
-    vkcore::BufferDesc targetDesc = {};
-    targetDesc.size = size;
-    targetDesc.usageFlags = usage | vk::BufferUsageFlagBits::eTransferDst;
-    targetDesc.memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+std::filesystem::path ResourceManager::getMeshCacheDirectory() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_meshCacheDirectory;
+}
 
-    auto targetBuffer = std::make_shared<vkcore::Buffer>("target", *m_device, m_allocator, targetDesc);
+// ==================== 网格 LOD 接口 ====================
 
-    // 使用executeOnetime复制数据
-    m_cmdManager->executeOnetime(m_device->getGraphicsQueue(), [&](vk::CommandBuffer cmd) {
-        VkBufferCopy copyRegion = {};
-        copyRegion.size = size;
-        vkCmdCopyBuffer(cmd, stagingBuffer->get(), targetBuffer->get(), 1, &copyRegion);
-    });
+void ResourceManager::setMeshLodSettings(const MeshLodSettings &settings)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_meshLodSettings = settings;
+}
 
-    return targetBuffer;
+MeshLodSettings ResourceManager::getMeshLodSettings() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_meshLodSettings;
 }
 
-std::shared_ptr<vkcore::Image> ResourceManager::createimagefromdata(const void *data, int width, int height,
-                                                                    vk::Format format)
-{
-    // 根据格式计算每像素字节数
-    uint32_t formatSize = 4; // 默认RGBA
-    switch (format)
-    {
-    case vk::Format::eR8Unorm:
-        formatSize = 1;
-        break;
-    case vk::Format::eR8G8Unorm:
-        formatSize = 2;
-        break;
-    case vk::Format::eR8G8B8Unorm:
-        formatSize = 3;
-        break;
-    case vk::Format::eR8G8B8A8Unorm:
-    case vk::Format::eR8G8B8A8Srgb:
-        formatSize = 4;
-        break;
-    default:
-        formatSize = 4; // 安全默认值
-        break;
-    }
-
-    vk::DeviceSize imageSize = width * height * formatSize;
-
-    // 创建暂存缓冲区
-    vkcore::BufferDesc stagingDesc = {};
-    stagingDesc.size = imageSize;
-    stagingDesc.usageFlags = vk::BufferUsageFlagBits::eTransferSrc;
-    stagingDesc.memoryUsage = VMA_MEMORY_USAGE_CPU_ONLY;
-
-    auto stagingBuffer = std::make_shared<vkcore::Buffer>("staging", *m_device, m_allocator, stagingDesc);
-
-    // 复制数据到暂存缓冲区
-    stagingBuffer->write(data, imageSize);
+// ==================== 顶点格式接口 ====================
 
-    // 创建图像
-    vkcore::ImageDesc imageDesc = {};
-    imageDesc.imageType = vk::ImageType::e2D;
-    imageDesc.format = format;
-    imageDesc.extent = vk::Extent3D{static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1};
-    imageDesc.mipLevels = 1;
-    imageDesc.arrayLayers = 1;
+void ResourceManager::setCompactVertexFormats(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_compactVertexFormats = enabled;
+}
+
+bool ResourceManager::getCompactVertexFormats() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_compactVertexFormats;
+}
+
+// ==================== 网格 meshlet 接口 ====================
+
+void ResourceManager::setMeshletGeneration(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_meshletGeneration = enabled;
+}
+
+bool ResourceManager::getMeshletGeneration() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_meshletGeneration;
+}
+
+// ==================== HDR 纹理接口 ====================
+
+void ResourceManager::setHdrTextureFormat(vk::Format format)
+{
+    if (!HdrConverter::isSupportedFormat(format))
+    {
+        throw std::invalid_argument("ResourceManager: Unsupported HDR texture format " + vk::to_string(format));
+    }
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_hdrTextureFormat = format;
+}
+
+vk::Format ResourceManager::getHdrTextureFormat() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_hdrTextureFormat;
+}
+
+// ==================== 环境贴图接口 ====================
+
+std::shared_ptr<EnvironmentMap> ResourceManager::loadEnvironmentMap(const std::filesystem::path &filepath)
+{
+    QTR_PROFILE_SCOPE("ResourceManager::loadEnvironmentMap");
+    const std::string key = filepath.string();
+    EnvironmentPrefilter::Settings settings;
+    std::filesystem::path cachePath;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+
+        if (!m_initialized)
+        {
+            throw std::runtime_error("ResourceManager not initialized");
+        }
+
+        auto it = m_environmentCache.find(key);
+        if (it != m_environmentCache.end())
+        {
+            return it->second;
+        }
+        settings = m_environmentSettings;
+        if (!m_environmentCacheDirectory.empty())
+        {
+            cachePath = EnvironmentPrefilter::getCachePath(m_environmentCacheDirectory, filepath);
+        }
+    }
+
+    // 预过滤串行执行；等待期间同一路径可能已由另一个线程加载完成
+    std::lock_guard<std::mutex> environmentLock(m_environmentMtx);
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        auto it = m_environmentCache.find(key);
+        if (it != m_environmentCache.end())
+        {
+            return it->second;
+        }
+    }
+
+    std::shared_ptr<EnvironmentMap> environment;
+    if (!cachePath.empty())
+    {
+        environment = loadcachedenvironment(filepath, cachePath, settings);
+    }
+    if (!environment)
+    {
+        environment = prefilterenvironment(filepath, cachePath, settings);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_environmentCache.emplace(key, std::move(environment)).first->second;
+}
+
+bool ResourceManager::unloadEnvironmentMap(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    auto it = m_environmentCache.find(name);
+    if (it != m_environmentCache.end())
+    {
+        if (m_deletionQueue)
+        {
+            m_deletionQueue->destroy(std::move(it->second));
+        }
+        m_environmentCache.erase(it);
+        return true;
+    }
+    return false;
+}
+
+void ResourceManager::setEnvironmentPrefilterSettings(const EnvironmentPrefilter::Settings &settings)
+{
+    EnvironmentPrefilter::validate(settings);
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_environmentSettings = settings;
+}
+
+EnvironmentPrefilter::Settings ResourceManager::getEnvironmentPrefilterSettings() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_environmentSettings;
+}
+
+void ResourceManager::setEnvironmentCacheDirectory(const std::filesystem::path &directory)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_environmentCacheDirectory = directory;
+}
+
+std::filesystem::path ResourceManager::getEnvironmentCacheDirectory() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_environmentCacheDirectory;
+}
+
+// ==================== 描述符布局访问接口 ====================
+
+vk::DescriptorSetLayout ResourceManager::getMaterialLayout() const
+{
+
+    if (!m_initialized)
+    {
+        throw std::runtime_error("ResourceManager not initialized");
+    }
+
+    return m_bindless ? m_bindless->getSetLayout() : m_materialLayout;
+}
+
+bool ResourceManager::isInitialized() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_initialized;
+}
+
+// ==================== 私有辅助函数 ====================
+
+void ResourceManager::buildmateriallayout()
+{
+    // 创建材质描述符集布局
+    std::vector<vk::DescriptorSetLayoutBinding> bindings = {
+        // 绑定 0: 材质参数统一缓冲区
+        {0, vk::DescriptorType::eUniformBuffer, 1,
+         vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment},
+        // 绑定 1-6: 纹理采样器
+        {1, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment}, // Base Color
+        {2, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment}, // Metallic
+        {3, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment}, // Roughness
+        {4, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment}, // Normal
+        {5, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment}, // Occlusion
+        {6, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment}  // Emissive
+    };
+
+    // 经布局缓存创建：着色器反射推导出的同构布局（PipelineBuilder::deriveLayout）得到同一个句柄
+    m_materialLayout = m_layoutCache->createDescriptorLayout(bindings);
+}
+
+std::shared_ptr<vkcore::Buffer> ResourceManager::createbufferfromdata(const void *data, vk::DeviceSize size,
+                                                                      vk::BufferUsageFlags usage,
+                                                                      vkcore::UploadTicket *ticket)
+{
+    // 创建目标缓冲区
+    vkcore::BufferDesc targetDesc = {};
+    targetDesc.size = size;
+    targetDesc.usageFlags = usage | vk::BufferUsageFlagBits::eTransferDst;
+    targetDesc.memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+    if (usage & (vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer))
+    {
+        targetDesc.category = vkcore::MemoryCategory::Mesh;
+    }
+    else if (usage & vk::BufferUsageFlagBits::eUniformBuffer)
+    {
+        targetDesc.category = vkcore::MemoryCategory::Uniform;
+    }
+
+    auto targetBuffer = std::make_shared<vkcore::Buffer>("target", *m_device, m_allocator, targetDesc);
+
+    // 数据写入暂存环形缓冲区，拷贝随批次在传输队列上执行
+    vkcore::UploadTicket uploadTicket = m_uploadQueue->uploadBuffer(targetBuffer, data, size);
+    if (ticket)
+    {
+        *ticket = std::max(*ticket, uploadTicket);
+    }
+
+    return targetBuffer;
+}
+
+std::shared_ptr<vkcore::Image> ResourceManager::createimagefromdata(const void *data, int width, int height,
+                                                                    vk::Format format, vkcore::UploadTicket *ticket,
+                                                                    bool generateMips)
+{
+    // 根据格式计算数据大小（块压缩格式请走容器路径）
+    FormatBlockInfo blockInfo = TextureContainer::getFormatBlockInfo(format);
+    vk::DeviceSize imageSize =
+        blockInfo.getLevelSize(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+
+    // 只上传 mip 0，其余 mip 在图形队列上逐级 blit 生成
+    uint32_t mipLevels = 1;
+    if (generateMips && !blockInfo.isCompressed() && supportsmipgeneration(format))
+    {
+        mipLevels = TextureContainer::getFullMipCount(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+    }
+
+    // 创建图像
+    vkcore::ImageDesc imageDesc = {};
+    imageDesc.imageType = vk::ImageType::e2D;
+    imageDesc.format = format;
+    imageDesc.extent = vk::Extent3D{static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1};
+    imageDesc.mipLevels = mipLevels;
+    imageDesc.arrayLayers = 1;
+    imageDesc.samples = vk::SampleCountFlagBits::e1;
+    imageDesc.tiling = vk::ImageTiling::eOptimal;
+    imageDesc.usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
+    if (mipLevels > 1)
+    {
+        imageDesc.usage |= vk::ImageUsageFlagBits::eTransferSrc;
+    }
+    imageDesc.memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+    imageDesc.category = vkcore::MemoryCategory::Texture;
+
+    auto image = std::make_shared<vkcore::Image>("texture", *m_device, m_allocator, imageDesc);
+
+    // 从暂存区复制到图像（布局转换和图像布局跟踪由上传队列处理）
+    vk::BufferImageCopy region = {};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = vk::Offset3D{0, 0, 0};
+    region.imageExtent = vk::Extent3D{static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1};
+
+    vkcore::UploadTicket uploadTicket =
+        m_uploadQueue->uploadImage(image, data, imageSize, {region}, blockInfo.blockBytes,
+                                   vk::ImageLayout::eShaderReadOnlyOptimal, mipLevels > 1);
+    if (ticket)
+    {
+        *ticket = std::max(*ticket, uploadTicket);
+    }
+
+    return image;
+}
+
+std::shared_ptr<vkcore::Image> ResourceManager::createimagefromcontainer(const TextureContainerData &container,
+                                                                         vk::Format format,
+                                                                         vkcore::UploadTicket *ticket)
+{
+    // 压缩格式没有 CPU 解码回退：设备不支持时（如桌面 GPU 上的 ASTC）直接报错
+    vk::FormatFeatureFlags features = m_device->getPhysicalDevice().getFormatProperties(format).optimalTilingFeatures;
+    if (!(features & vk::FormatFeatureFlagBits::eSampledImage))
+    {
+        throw std::runtime_error("Texture format " + vk::to_string(format) + " is not supported by the device");
+    }
+
+    FormatBlockInfo blockInfo = TextureContainer::getFormatBlockInfo(format);
+    uint32_t storedLevels = static_cast<uint32_t>(container.levels.size());
+
+    // 文件只含 mip 0 且要求生成时，非压缩格式在GPU上补全 mip 链（压缩格式不能作为 blit 目标）
+    uint32_t mipLevels = storedLevels;
+    bool generateMips = false;
+    if (container.requestsMipGeneration && !blockInfo.isCompressed() && supportsmipgeneration(format))
+    {
+        mipLevels = TextureContainer::getFullMipCount(container.width, container.height);
+        generateMips = mipLevels > storedLevels;
+    }
+
+    vkcore::ImageDesc imageDesc = {};
+    imageDesc.imageType = vk::ImageType::e2D;
+    imageDesc.format = format;
+    imageDesc.extent = vk::Extent3D{container.width, container.height, 1};
+    imageDesc.mipLevels = mipLevels;
+    imageDesc.arrayLayers = 1;
     imageDesc.samples = vk::SampleCountFlagBits::e1;
     imageDesc.tiling = vk::ImageTiling::eOptimal;
     imageDesc.usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
+    if (generateMips)
+    {
+        imageDesc.usage |= vk::ImageUsageFlagBits::eTransferSrc;
+    }
     imageDesc.memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+    imageDesc.category = vkcore::MemoryCategory::Texture;
+
+    auto image = std::make_shared<vkcore::Image>("texture", *m_device, m_allocator, imageDesc);
+
+    // 所有 mip 作为一段连续数据写入暂存区（KTX2 中 mip 按从小到大存放，取整体范围）
+    size_t spanBegin = container.levels.front().offset;
+    size_t spanEnd = 0;
+    for (const auto &level : container.levels)
+    {
+        spanBegin = std::min(spanBegin, level.offset);
+        spanEnd = std::max(spanEnd, level.offset + level.size);
+    }
+
+    std::vector<vk::BufferImageCopy> regions;
+    regions.reserve(storedLevels);
+    for (uint32_t mip = 0; mip < storedLevels; ++mip)
+    {
+        const auto &level = container.levels[mip];
+        if ((level.offset - spanBegin) % blockInfo.blockBytes != 0)
+        {
+            throw std::runtime_error("Texture container mip level is not aligned to its block size");
+        }
+
+        vk::BufferImageCopy region = {};
+        region.bufferOffset = level.offset - spanBegin;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+        region.imageSubresource.mipLevel = mip;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = vk::Offset3D{0, 0, 0};
+        region.imageExtent = vk::Extent3D{level.width, level.height, 1};
+        regions.push_back(region);
+    }
+
+    vkcore::UploadTicket uploadTicket =
+        m_uploadQueue->uploadImage(image, container.data + spanBegin, spanEnd - spanBegin, regions,
+                                   blockInfo.blockBytes, vk::ImageLayout::eShaderReadOnlyOptimal, generateMips);
+    if (ticket)
+    {
+        *ticket = std::max(*ticket, uploadTicket);
+    }
+
+    return image;
+}
+
+bool ResourceManager::supportsmipgeneration(vk::Format format) const
+{
+    const vk::FormatFeatureFlags required = vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst |
+                                            vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+    vk::FormatFeatureFlags features = m_device->getPhysicalDevice().getFormatProperties(format).optimalTilingFeatures;
+    return (features & required) == required;
+}
+
+vk::Sampler ResourceManager::gettexturesampler()
+{
+    return getorsampler(vk::Filter::eLinear, vk::SamplerAddressMode::eRepeat);
+}
+
+void ResourceManager::createdefaulttextures()
+{
+    // 创建1x1白色纹理（不需要锁，因为已经在 initialize 中获取了锁）
+    unsigned char whitePixel[4] = {255, 255, 255, 255};
+
+    // 直接创建图像而不通过 registerTexture（避免双重加锁）
+    vkcore::UploadTicket whiteTicket = 0;
+    auto whiteImage = createimagefromdata(whitePixel, 1, 1, vk::Format::eR8G8B8A8Unorm, &whiteTicket);
+    vk::Sampler whiteSampler = gettexturesampler();
+
+    m_defaultWhiteTexture = std::make_shared<Texture>();
+    m_defaultWhiteTexture->name = "__default_white__";
+    m_defaultWhiteTexture->image = whiteImage;
+    m_defaultWhiteTexture->uploadTicket = whiteTicket;
+    m_defaultWhiteTexture->sampler = whiteSampler;
+    if (m_bindless)
+    {
+        BindlessRegistry::registerTexture(m_bindless, *m_defaultWhiteTexture);
+    }
+
+    // 添加到缓存
+    m_textureCache["__default_white__"] = m_defaultWhiteTexture;
+
+    // 创建1x1法线贴图 (128, 128, 255, 255) - 法线向量 (0, 0, 1)
+    unsigned char normalPixel[4] = {128, 128, 255, 255};
+
+    vkcore::UploadTicket normalTicket = 0;
+    auto normalImage = createimagefromdata(normalPixel, 1, 1, vk::Format::eR8G8B8A8Unorm, &normalTicket);
+    vk::Sampler normalSampler = gettexturesampler();
+
+    m_defaultNormalTexture = std::make_shared<Texture>();
+    m_defaultNormalTexture->name = "__default_normal__";
+    m_defaultNormalTexture->image = normalImage;
+    m_defaultNormalTexture->uploadTicket = normalTicket;
+    m_defaultNormalTexture->sampler = normalSampler;
+    if (m_bindless)
+    {
+        BindlessRegistry::registerTexture(m_bindless, *m_defaultNormalTexture);
+    }
+
+    // 添加到缓存
+    m_textureCache["__default_normal__"] = m_defaultNormalTexture;
+}
+
+void ResourceManager::createMaterialUniformBuffer(std::shared_ptr<Material> material)
+{
+    const MaterialUniform uniformData = makematerialuniform(*material);
+
+    // 材质参数很小，逐个创建缓冲会浪费分配与暂存拷贝；从共享页中取一个槽位直接经映射写入
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (!m_materialUniformPage || m_materialUniformsUsed == kMaterialUniformsPerPage)
+    {
+        const vk::DeviceSize alignment = std::max<vk::DeviceSize>(
+            m_device->getPhysicalDevice().getProperties().limits.minUniformBufferOffsetAlignment, 1);
+        m_materialUniformStride = (sizeof(MaterialUniform) + alignment - 1) / alignment * alignment;
+
+        vkcore::BufferDesc desc{};
+        desc.size = m_materialUniformStride * kMaterialUniformsPerPage;
+        desc.usageFlags = vk::BufferUsageFlagBits::eUniformBuffer;
+        desc.mapping = vkcore::BufferMapping::DeviceLocal;
+        desc.category = vkcore::MemoryCategory::Uniform;
+        m_materialUniformPage = std::make_shared<vkcore::Buffer>("MaterialUniformPage", *m_device, m_allocator, desc);
+        m_materialUniformsUsed = 0;
+    }
+
+    const vk::DeviceSize offset = m_materialUniformsUsed * m_materialUniformStride;
+    std::memcpy(static_cast<char *>(m_materialUniformPage->getMappedData()) + offset, &uniformData,
+                sizeof(uniformData));
+    m_materialUniformPage->flush(sizeof(uniformData), offset);
+    ++m_materialUniformsUsed;
+
+    material->uniformBuffer = m_materialUniformPage;
+    material->uniformOffset = offset;
+}
+
+vk::Sampler ResourceManager::getorsampler(vk::Filter filter, vk::SamplerAddressMode addressMode)
+{
+    // 以完整的创建参数去重：与渲染图等其他使用者的相同配置共享同一个采样器
+    vk::SamplerCreateInfo samplerInfo = vkcore::SamplerCache::makeInfo(filter, addressMode);
+    samplerInfo.anisotropyEnable = VK_TRUE;
+    samplerInfo.maxAnisotropy = 16.0f;
+    samplerInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
+    return m_samplerCache->getOrCreate(samplerInfo);
+}
+
+void ResourceManager::updateMaterialDescriptorSet(std::shared_ptr<Material> material)
+{
+    vk::DescriptorBufferInfo bufferInfo;
+    std::array<vk::DescriptorImageInfo, 6> imageInfos;
+    std::vector<vk::WriteDescriptorSet> writes;
+    appendmaterialwrites(*material, bufferInfo, imageInfos, writes);
+    m_device->get().updateDescriptorSets(writes, {});
+}
+
+void ResourceManager::appendmaterialwrites(const Material &material, vk::DescriptorBufferInfo &bufferInfo,
+                                           std::array<vk::DescriptorImageInfo, 6> &imageInfos,
+                                           std::vector<vk::WriteDescriptorSet> &writes) const
+{
+    // 1. Uniform Buffer（binding 0），共享缓冲时只绑定本材质的那一段
+    bufferInfo.buffer = material.uniformBuffer->get();
+    bufferInfo.offset = material.uniformOffset;
+    bufferInfo.range = sizeof(MaterialUniform);
+
+    // 2. 纹理（binding 1-6）：baseColor、metallic、roughness、normal、occlusion、emissive
+    const Texture *textures[6] = {material.baseColorTexture.get(), material.metallicTexture.get(),
+                                  material.roughnessTexture.get(), material.normalTexture.get(),
+                                  material.occlusionTexture.get(), material.emissiveTexture.get()};
+    for (size_t i = 0; i < imageInfos.size(); ++i)
+    {
+        imageInfos[i].imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+        imageInfos[i].imageView = textures[i]->image->getView();
+        imageInfos[i].sampler = textures[i]->sampler;
+    }
+
+    writes.push_back(vk::WriteDescriptorSet(material.descriptorSet, 0, 0, 1, vk::DescriptorType::eUniformBuffer,
+                                            nullptr, &bufferInfo));
+    for (uint32_t i = 0; i < imageInfos.size(); ++i)
+    {
+        writes.push_back(vk::WriteDescriptorSet(material.descriptorSet, i + 1, 0, 1,
+                                                vk::DescriptorType::eCombinedImageSampler, &imageInfos[i]));
+    }
+}
+
+std::array<std::shared_future<std::shared_ptr<Texture>>, 6> ResourceManager::requestmaterialtextures(
+    const TexturePaths &paths)
+{
+    auto request = [this](const std::string &path) {
+        return path.empty() ? std::shared_future<std::shared_ptr<Texture>>() : requesttexture(path, false, true);
+    };
+    return {request(paths.baseColor), request(paths.metallic),  request(paths.roughness),
+            request(paths.normal),    request(paths.occlusion), request(paths.emissive)};
+}
+
+void ResourceManager::resolvematerial(Material &material,
+                                      const std::array<std::shared_future<std::shared_ptr<Texture>>, 6> &textures)
+{
+    auto resolve = [](const std::shared_future<std::shared_ptr<Texture>> &future,
+                      const std::shared_ptr<Texture> &fallback) { return future.valid() ? future.get() : fallback; };
+
+    material.baseColorTexture = resolve(textures[0], m_defaultWhiteTexture);
+    material.metallicTexture = resolve(textures[1], m_defaultWhiteTexture);
+    material.roughnessTexture = resolve(textures[2], m_defaultWhiteTexture);
+    material.normalTexture = resolve(textures[3], m_defaultNormalTexture);
+    material.occlusionTexture = resolve(textures[4], m_defaultWhiteTexture);
+    material.emissiveTexture = resolve(textures[5], m_defaultWhiteTexture);
+
+    // 特性位只记录真正的纹理：默认纹理只为填满描述符槽位，特化后的着色器不再采样它们
+    auto has = [this](const std::shared_ptr<Texture> &texture, uint32_t feature) {
+        return texture && texture != m_defaultWhiteTexture && texture != m_defaultNormalTexture ? feature : 0u;
+    };
+    material.features = has(material.baseColorTexture, MaterialFeatureBaseColorTexture) |
+                        has(material.metallicTexture, MaterialFeatureMetallicTexture) |
+                        has(material.roughnessTexture, MaterialFeatureRoughnessTexture) |
+                        has(material.normalTexture, MaterialFeatureNormalTexture) |
+                        has(material.occlusionTexture, MaterialFeatureOcclusionTexture) |
+                        has(material.emissiveTexture, MaterialFeatureEmissiveTexture);
+    material.features |= material.alphaMode == AlphaMode::Mask ? MaterialFeatureAlphaMask : 0u;
+    material.features |= material.doubleSided ? MaterialFeatureDoubleSided : 0u;
+}
+
+std::shared_ptr<Material> ResourceManager::buildmaterial(const std::string &name, const Material &materialInfo,
+                                                         const TexturePaths &textureNames,
+                                                         const std::string &shaderName)
+{
+    QTR_PROFILE_SCOPE("ResourceManager::buildmaterial");
+    auto material = std::make_shared<Material>(materialInfo);
+    material->name = name;
+
+    // 先为所有非空路径发起异步加载，使多张纹理的 I/O 与解码并行，再依次取结果
+    resolvematerial(*material, requestmaterialtextures(textureNames));
+
+    {
+        // 着色器缓存与描述符分配器不是线程安全的，仍由缓存锁串行化
+        std::lock_guard<std::mutex> lock(m_mtx);
+
+        // 加载着色器
+        if (!shaderName.empty())
+        {
+            material->vertexShader = m_shaderManager->getShaderModule(shaderName + ".vert");
+            material->fragmentShader = m_shaderManager->getShaderModule(shaderName + ".frag");
+        }
+
+        // bindless 模式下不需要逐材质的描述符集
+        if (!m_bindless)
+        {
+            material->descriptorSet = m_descAllocator->allocate(m_materialLayout);
+        }
+    }
+
+    // bindless：参数写入全局 SSBO 的槽位，纹理以数组下标引用，descriptorSet 指向全局集
+    if (m_bindless)
+    {
+        BindlessRegistry::registerMaterial(m_bindless, *material);
+        return material;
+    }
+
+    // 创建材质参数Uniform Buffer
+    createMaterialUniformBuffer(material);
+
+    // 更新描述符集 - 绑定纹理和采样器
+    updateMaterialDescriptorSet(material);
+
+    return material;
+}
+
+std::vector<std::shared_ptr<Material>> ResourceManager::buildmaterials(const std::vector<std::string> &names,
+                                                                      const std::vector<MaterialData> &materials)
+{
+    QTR_PROFILE_SCOPE("ResourceManager::buildmaterials");
+    const size_t count = materials.size();
+
+    // 所有材质的纹理先一次性发起，整个目录的纹理 I/O 与解码并行进行，再统一取结果
+    std::vector<std::array<std::shared_future<std::shared_ptr<Texture>>, 6>> textures(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        textures[i] = requestmaterialtextures(materials[i].texturePaths);
+    }
+
+    std::vector<std::shared_ptr<Material>> result(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        result[i] = std::make_shared<Material>(materials[i].material);
+        result[i]->name = names[i];
+        resolvematerial(*result[i], textures[i]);
+    }
+
+    {
+        // 着色器缓存与描述符分配器不是线程安全的，仍由缓存锁串行化
+        std::lock_guard<std::mutex> lock(m_mtx);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const std::string &shaderName = materials[i].shaderName;
+            if (!shaderName.empty())
+            {
+                result[i]->vertexShader = m_shaderManager->getShaderModule(shaderName + ".vert");
+                result[i]->fragmentShader = m_shaderManager->getShaderModule(shaderName + ".frag");
+            }
+        }
+
+        // 一次分配全部描述符集
+        if (!m_bindless)
+        {
+            std::vector<vk::DescriptorSet> sets = m_descAllocator->allocate(static_cast<uint32_t>(count),
+                                                                            m_materialLayout);
+            for (size_t i = 0; i < count; ++i)
+            {
+                result[i]->descriptorSet = sets[i];
+            }
+        }
+    }
+
+    // bindless：参数本来就在同一个 SSBO 中，逐个登记槽位即可
+    if (m_bindless)
+    {
+        for (const auto &material : result)
+        {
+            BindlessRegistry::registerMaterial(m_bindless, *material);
+        }
+        return result;
+    }
 
-    auto image = std::make_shared<vkcore::Image>("texture", *m_device, m_allocator, imageDesc);
+    // 所有材质参数打包进一个 Uniform Buffer，步长满足 minUniformBufferOffsetAlignment
+    const vk::DeviceSize minAlignment =
+        m_device->getPhysicalDevice().getProperties().limits.minUniformBufferOffsetAlignment;
+    const vk::DeviceSize alignment = std::max<vk::DeviceSize>(minAlignment, 1);
+    const vk::DeviceSize stride = (sizeof(MaterialUniform) + alignment - 1) / alignment * alignment;
+    std::vector<char> uniformData(static_cast<size_t>(stride * count));
+    for (size_t i = 0; i < count; ++i)
+    {
+        const MaterialUniform uniform = makematerialuniform(*result[i]);
+        std::memcpy(uniformData.data() + i * stride, &uniform, sizeof(uniform));
+    }
+    std::shared_ptr<vkcore::Buffer> uniformBuffer =
+        createbufferfromdata(uniformData.data(), uniformData.size(), vk::BufferUsageFlagBits::eUniformBuffer);
+
+    // 一次 updateDescriptorSets 写完所有材质（写入引用的描述信息在提交前必须保持地址不变）
+    std::vector<vk::DescriptorBufferInfo> bufferInfos(count);
+    std::vector<std::array<vk::DescriptorImageInfo, 6>> imageInfos(count);
+    std::vector<vk::WriteDescriptorSet> writes;
+    writes.reserve(count * 7);
+    for (size_t i = 0; i < count; ++i)
+    {
+        result[i]->uniformBuffer = uniformBuffer;
+        result[i]->uniformOffset = i * stride;
+        appendmaterialwrites(*result[i], bufferInfos[i], imageInfos[i], writes);
+    }
+    m_device->get().updateDescriptorSets(writes, {});
 
-    // 使用executeOnetime复制数据
-    m_cmdManager->executeOnetime(m_device->getGraphicsQueue(), [&](vk::CommandBuffer cmd) {
-        // 转换图像布局到传输目标
-        vk::ImageMemoryBarrier barrier = {};
-        barrier.oldLayout = vk::ImageLayout::eUndefined;
-        barrier.newLayout = vk::ImageLayout::eTransferDstOptimal;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = image->get();
-        barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
-        barrier.srcAccessMask = vk::AccessFlagBits{};
-        barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
-
-        cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
-                            vk::DependencyFlags{}, {}, {}, barrier);
-
-        // 从缓冲区复制到图像
-        VkBufferImageCopy region = {};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
-        region.imageOffset = {0, 0, 0};
-        region.imageExtent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1};
+    return result;
+}
 
-        vkCmdCopyBufferToImage(cmd, stagingBuffer->get(), image->get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
-                               &region);
+// ==================== 加载流水线 ====================
 
-        // 转换布局到着色器只读
-        barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
-        barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-        barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-        barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+std::shared_future<std::shared_ptr<Mesh>> ResourceManager::requestmesh(const std::filesystem::path &filepath,
+                                                                       bool async)
+{
+    std::string key = filepath.string();
+    auto promise = std::make_shared<MeshPromise>();
+    std::shared_future<std::shared_ptr<Mesh>> future;
+    std::filesystem::path cookedPath;
+    MeshLodSettings lodSettings;
 
-        cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,
-                            vk::DependencyFlags{}, {}, {}, barrier);
-    });
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
 
-    // 更新图像布局跟踪
-    image->setCurrentLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+        if (!m_initialized)
+        {
+            throw std::runtime_error("ResourceManager not initialized");
+        }
 
-    return image;
-}
+        // 检查缓存
+        auto it = m_meshCache.find(key);
+        if (it != m_meshCache.end())
+        {
+            promise->set_value(it->second);
+            return promise->get_future().share();
+        }
 
-void ResourceManager::createdefaulttextures()
-{
-    // 创建1x1白色纹理（不需要锁，因为已经在 initialize 中获取了锁）
-    unsigned char whitePixel[4] = {255, 255, 255, 255};
+        // 同一路径正在加载：共享那次加载的结果
+        auto pendingIt = m_pendingMeshes.find(key);
+        if (pendingIt != m_pendingMeshes.end())
+        {
+            return pendingIt->second;
+        }
 
-    // 直接创建图像而不通过 registerTexture（避免双重加锁）
-    auto whiteImage = createimagefromdata(whitePixel, 1, 1, vk::Format::eR8G8B8A8Unorm);
-    auto whiteSampler = getorsampler(vk::Filter::eLinear, vk::SamplerAddressMode::eRepeat);
+        future = promise->get_future().share();
+        m_pendingMeshes.emplace(key, future);
 
-    m_defaultWhiteTexture = std::make_shared<Texture>();
-    m_defaultWhiteTexture->name = "__default_white__";
-    m_defaultWhiteTexture->image = whiteImage;
-    m_defaultWhiteTexture->sampler = vk::UniqueSampler(whiteSampler, m_device->get());
+        if (!m_meshCacheDirectory.empty())
+        {
+            cookedPath = CookedMesh::getCookedPath(m_meshCacheDirectory, filepath);
+        }
+        lodSettings = m_meshLodSettings;
+    }
 
-    // 添加到缓存
-    m_textureCache["__default_white__"] = m_defaultWhiteTexture;
+    // 阶段 1：映射文件并预读；阶段 2/3：解析与上传（异步时分别投递到 I/O 与解码线程池）
+    // 烘焙缓存命中时没有解析阶段，映射后直接在 I/O 线程上拷入暂存区
+    auto readStage = [this, key, filepath, cookedPath, lodSettings, promise, async]() {
+        if (!cookedPath.empty() && loadcookedmesh(key, filepath, cookedPath, lodSettings, *promise))
+        {
+            return;
+        }
 
-    // 创建1x1法线贴图 (128, 128, 255, 255) - 法线向量 (0, 0, 1)
-    unsigned char normalPixel[4] = {128, 128, 255, 255};
+        std::shared_ptr<vkcore::MappedFile> file;
+        try
+        {
+            file = std::make_shared<vkcore::MappedFile>(filepath);
+            file->prefault();
+        }
+        catch (...)
+        {
+            failmeshload(key, *promise, std::current_exception());
+            return;
+        }
 
-    auto normalImage = createimagefromdata(normalPixel, 1, 1, vk::Format::eR8G8B8A8Unorm);
-    auto normalSampler = getorsampler(vk::Filter::eLinear, vk::SamplerAddressMode::eRepeat);
+        if (async)
+        {
+            // 解码任务内部可以向同一调度器嵌套 parallelFor，大文件的分块解析由空闲线程窃取
+            m_decodeTasks->run([this, key, filepath, cookedPath, lodSettings, promise, file]() {
+                decodeanduploadmesh(key, filepath, *file, m_decodePool, cookedPath, lodSettings, *promise);
+            });
+        }
+        else
+        {
+            // 同步加载在调用线程上执行，大文件可借用解码线程池分块解析
+            decodeanduploadmesh(key, filepath, *file, m_decodePool, cookedPath, lodSettings, *promise);
+        }
+    };
 
-    m_defaultNormalTexture = std::make_shared<Texture>();
-    m_defaultNormalTexture->name = "__default_normal__";
-    m_defaultNormalTexture->image = normalImage;
-    m_defaultNormalTexture->sampler = vk::UniqueSampler(normalSampler, m_device->get());
+    if (async)
+    {
+        m_ioWorkers->enqueue(std::move(readStage));
+    }
+    else
+    {
+        readStage();
+    }
 
-    // 添加到缓存
-    m_textureCache["__default_normal__"] = m_defaultNormalTexture;
+    return future;
 }
 
-void ResourceManager::createMaterialUniformBuffer(std::shared_ptr<Material> material)
+std::shared_future<std::shared_ptr<Texture>> ResourceManager::requesttexture(const std::filesystem::path &filepath,
+                                                                             bool srgb, bool async)
 {
-    // 定义材质Uniform Buffer结构（匹配着色器中的结构）
-    struct MaterialUniform
+    std::string key = filepath.string() + (srgb ? "_srgb" : "_linear");
+    auto promise = std::make_shared<TexturePromise>();
+    std::shared_future<std::shared_ptr<Texture>> future;
+
     {
-        glm::vec4 baseColorFactor;
-        glm::vec3 emissiveFactor;
-        float metallicFactor;
-        float roughnessFactor;
-        float normalScale;
-        float alphaCutoff;
-        float padding; // 对齐到16字节边界
+        std::lock_guard<std::mutex> lock(m_mtx);
+
+        if (!m_initialized)
+        {
+            throw std::runtime_error("ResourceManager not initialized");
+        }
+
+        // 检查缓存
+        auto it = m_textureCache.find(key);
+        if (it != m_textureCache.end())
+        {
+            promise->set_value(it->second);
+            return promise->get_future().share();
+        }
+
+        // 同一路径正在加载：共享那次加载的结果
+        auto pendingIt = m_pendingTextures.find(key);
+        if (pendingIt != m_pendingTextures.end())
+        {
+            return pendingIt->second;
+        }
+
+        future = promise->get_future().share();
+        m_pendingTextures.emplace(key, future);
+    }
+
+    auto readStage = [this, key, filepath, srgb, promise, async]() {
+        std::shared_ptr<vkcore::MappedFile> file;
+        try
+        {
+            file = std::make_shared<vkcore::MappedFile>(filepath);
+            file->prefault();
+        }
+        catch (...)
+        {
+            failtextureload(key, *promise, std::current_exception());
+            return;
+        }
+
+        if (async)
+        {
+            m_decodeTasks->run([this, key, filepath, srgb, promise, file]() {
+                decodeanduploadtexture(key, filepath, srgb, file, *promise);
+            });
+        }
+        else
+        {
+            decodeanduploadtexture(key, filepath, srgb, file, *promise);
+        }
     };
 
-    MaterialUniform uniformData = {};
-    uniformData.baseColorFactor = material->baseColorFactor;
-    uniformData.emissiveFactor = material->emissiveFactor;
-    uniformData.metallicFactor = material->metallicFactor;
-    uniformData.roughnessFactor = material->roughnessFactor;
-    uniformData.normalScale = material->normalScale;
-    uniformData.alphaCutoff = material->alphaCutoff;
+    if (async)
+    {
+        m_ioWorkers->enqueue(std::move(readStage));
+    }
+    else
+    {
+        readStage();
+    }
 
-    // 创建Uniform Buffer
-    material->uniformBuffer =
-        createbufferfromdata(&uniformData, sizeof(MaterialUniform), vk::BufferUsageFlagBits::eUniformBuffer);
+    return future;
 }
 
-vk::Sampler ResourceManager::getorsampler(vk::Filter filter, vk::SamplerAddressMode addressMode)
+bool ResourceManager::loadcookedmesh(const std::string &key, const std::filesystem::path &filepath,
+                                     const std::filesystem::path &cookedPath, const MeshLodSettings &lodSettings,
+                                     MeshPromise &promise)
 {
-    // 创建采样器配置哈希
-    uint64_t hash = std::hash<uint32_t>{}(static_cast<uint32_t>(filter)) ^
-                    (std::hash<uint32_t>{}(static_cast<uint32_t>(addressMode)) << 1);
+    QTR_PROFILE_SCOPE("ResourceManager::loadcookedmesh");
+    std::error_code ec;
+    if (!std::filesystem::exists(cookedPath, ec))
+    {
+        return false;
+    }
 
-    auto it = m_samplerCache.find(hash);
-    if (it != m_samplerCache.end())
+    std::unique_ptr<vkcore::MappedFile> file;
+    std::optional<CookedMesh::View> view;
+    try
+    {
+        file = std::make_unique<vkcore::MappedFile>(cookedPath);
+        view = CookedMesh::open(*file, filepath, MeshSimplifier::hashSettings(lodSettings));
+    }
+    catch (...)
     {
-        return it->second;
+        // 缓存文件不可读：当作未命中，重新解析源文件并覆盖它
+        return false;
     }
 
-    // 创建新的采样器
-    vk::SamplerCreateInfo samplerInfo = {};
-    samplerInfo.magFilter = filter;
-    samplerInfo.minFilter = filter;
-    samplerInfo.addressModeU = addressMode;
-    samplerInfo.addressModeV = addressMode;
-    samplerInfo.addressModeW = addressMode;
-    samplerInfo.anisotropyEnable = VK_TRUE;
-    samplerInfo.maxAnisotropy = 16.0f;
-    samplerInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
-    samplerInfo.unnormalizedCoordinates = VK_FALSE;
-    samplerInfo.compareEnable = VK_FALSE;
-    samplerInfo.compareOp = vk::CompareOp::eAlways;
-    samplerInfo.mipmapMode = vk::SamplerMipmapMode::eLinear;
+    if (!view)
+    {
+        return false;
+    }
 
-    vk::Sampler sampler = m_device->get().createSampler(samplerInfo);
-    m_samplerCache[hash] = sampler;
+    std::shared_ptr<Mesh> mesh;
+    try
+    {
+        // 顶点与索引从映射内存直接拷入暂存区，没有逐顶点的处理
+        file->prefault();
+        mesh = createmesh(key, view->vertices, view->vertexCount, view->indices, view->indexCount,
+                          std::move(view->lods));
+        mesh->submeshes = std::move(view->submeshes);
+    }
+    catch (...)
+    {
+        failmeshload(key, promise, std::current_exception());
+        return true;
+    }
 
-    return sampler;
+    publishmesh(key, mesh, promise);
+    return true;
 }
 
-void ResourceManager::updateMaterialDescriptorSet(std::shared_ptr<Material> material)
+void ResourceManager::decodeanduploadmesh(const std::string &key, const std::filesystem::path &filepath,
+                                          const vkcore::MappedFile &file, vkcore::WorkerPool *parseWorkers,
+                                          const std::filesystem::path &cookedPath,
+                                          const MeshLodSettings &lodSettings, MeshPromise &promise)
 {
-    // 1. 准备Uniform Buffer描述符信息
-    vk::DescriptorBufferInfo bufferInfo = {};
-    bufferInfo.buffer = material->uniformBuffer->get();
-    bufferInfo.offset = 0;
-    bufferInfo.range = VK_WHOLE_SIZE;
+    QTR_PROFILE_SCOPE("ResourceManager::decodeanduploadmesh");
+    std::shared_ptr<Mesh> mesh;
+    try
+    {
+        // 解析阶段：纯 CPU，不访问任何共享状态
+        std::vector<MeshData> meshDataList = ModelLoader::loadModelFromMemory(
+            file.data(), file.size(), ModelLoader::detectFormat(filepath), filepath.string(), parseWorkers);
 
-    // 2. 准备所有纹理的描述符信息
-    std::vector<vk::DescriptorImageInfo> imageInfos(6);
+        if (meshDataList.empty())
+        {
+            throw std::runtime_error("No meshes found in file: " + filepath.string());
+        }
 
-    // Base Color Texture (binding 1)
-    imageInfos[0].imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-    imageInfos[0].imageView = material->baseColorTexture->image->getView();
-    imageInfos[0].sampler = *material->baseColorTexture->sampler;
+        // 导入优化：逐子网格重排三角形与顶点（子网格的顶点区间互不重叠，合并后范围仍然有效）
+        for (MeshData &meshData : meshDataList)
+        {
+            MeshOptimizer::optimize(meshData);
+        }
 
-    // Metallic Texture (binding 2)
-    imageInfos[1].imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-    imageInfos[1].imageView = material->metallicTexture->image->getView();
-    imageInfos[1].sampler = *material->metallicTexture->sampler;
+        // 合并所有网格为单一网格（优化方案）
+        std::vector<Submesh> submeshes;
+        MeshData mergedMeshData = mergeMeshData(meshDataList, filepath.stem().string(), &submeshes);
 
-    // Roughness Texture (binding 3)
-    imageInfos[2].imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-    imageInfos[2].imageView = material->roughnessTexture->image->getView();
-    imageInfos[2].sampler = *material->roughnessTexture->sampler;
+        if (!mergedMeshData.isValid())
+        {
+            throw std::runtime_error("Invalid mesh data loaded from file: " + filepath.string());
+        }
 
-    // Normal Texture (binding 4)
-    imageInfos[3].imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-    imageInfos[3].imageView = material->normalTexture->image->getView();
-    imageInfos[3].sampler = *material->normalTexture->sampler;
+        // 简化出的各级 LOD 复用完整网格的顶点，索引追加在完整网格之后
+        std::vector<MeshLod> lods =
+            MeshSimplifier::buildLodChain(mergedMeshData.vertices, mergedMeshData.indices, lodSettings);
+        for (size_t level = 1; level < lods.size(); ++level)
+        {
+            uint32_t *lodIndices = mergedMeshData.indices.data() + lods[level].firstIndex;
+            std::vector<uint32_t> clusters =
+                MeshOptimizer::optimizeVertexCache(lodIndices, lods[level].indexCount, mergedMeshData.vertices.size());
+            MeshOptimizer::optimizeOverdraw(lodIndices, lods[level].indexCount, mergedMeshData.vertices.data(),
+                                            clusters);
+        }
 
-    // Occlusion Texture (binding 5)
-    imageInfos[4].imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-    imageInfos[4].imageView = material->occlusionTexture->image->getView();
-    imageInfos[4].sampler = *material->occlusionTexture->sampler;
+        // 写出烘焙缓存，下次加载跳过解析与简化（失败只影响下次加载速度）
+        if (!cookedPath.empty() && !CookedMesh::write(cookedPath, filepath, mergedMeshData, submeshes, lods,
+                                                      MeshSimplifier::hashSettings(lodSettings)))
+        {
+            QTR_LOG_WARN("ResourceManager", "Failed to write cooked mesh cache: " << cookedPath.string());
+        }
 
-    // Emissive Texture (binding 6)
-    imageInfos[5].imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-    imageInfos[5].imageView = material->emissiveTexture->image->getView();
-    imageInfos[5].sampler = *material->emissiveTexture->sampler;
+        // 上传阶段：数据写入上传队列的暂存区（上传队列与 VMA 自身是线程安全的）
+        mesh = createmesh(key, mergedMeshData.vertices.data(), mergedMeshData.vertices.size(),
+                          mergedMeshData.indices.data(), mergedMeshData.indices.size(), std::move(lods));
+        mesh->submeshes = std::move(submeshes);
+    }
+    catch (...)
+    {
+        failmeshload(key, promise, std::current_exception());
+        return;
+    }
 
-    // 使用 DescriptorUpdater 批量更新所有绑定
-    auto updater = vkcore::DescriptorUpdater::begin(*m_device, material->descriptorSet);
+    publishmesh(key, mesh, promise);
+}
 
-    // 绑定 Uniform Buffer 到 binding 0
-    updater.writeBuffer(0, vk::DescriptorType::eUniformBuffer, bufferInfo);
+void ResourceManager::decodeanduploadtexture(const std::string &key, const std::filesystem::path &filepath,
+                                             bool srgb, const std::shared_ptr<vkcore::MappedFile> &file,
+                                             TexturePromise &promise)
+{
+    QTR_PROFILE_SCOPE("ResourceManager::decodeanduploadtexture");
+    std::shared_ptr<Texture> texture;
+    try
+    {
+        const auto *bytes = reinterpret_cast<const unsigned char *>(file->data());
 
-    // 绑定所有纹理到对应的binding点
-    for (int i = 0; i < 6; ++i)
+        // GPU 压缩容器：只解析头部，块数据与 mip 链从映射内存直接拷入暂存区（可流送时映射交给流送器保留）
+        if (TextureContainer::isContainer(bytes, file->size()))
+        {
+            TextureContainerData container = TextureContainer::parse(bytes, file->size(), filepath.string());
+            texture = createcontainertexture(filepath.string(), container, srgb, file);
+        }
+        else if (TextureLoader::isHDR(bytes, file->size()))
+        {
+            // Radiance HDR：保留动态范围，颜色空间固定为线性
+            texture = createhdrtexture(filepath.string(), bytes, file->size());
+        }
+        else
+        {
+            // 解码阶段：统一解码为 RGBA8，与上传使用的 R8G8B8A8 格式一致
+            TextureData textureData = TextureLoader::loadFromMemory(bytes, file->size(), 4);
+
+            vk::Format format = srgb ? vk::Format::eR8G8B8A8Srgb : vk::Format::eR8G8B8A8Unorm;
+            try
+            {
+                texture = createtexture(filepath.string(), textureData.pixels, textureData.width,
+                                        textureData.height, format, true);
+            }
+            catch (...)
+            {
+                textureData.free();
+                throw;
+            }
+
+            // 像素已拷贝进暂存区，释放CPU内存
+            textureData.free();
+        }
+    }
+    catch (...)
     {
-        updater.writeImage(i + 1, vk::DescriptorType::eCombinedImageSampler, imageInfos[i]);
+        failtextureload(key, promise, std::current_exception());
+        return;
     }
 
-    // 提交更新
-    updater.update();
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_textureCache[key] = texture;
+        m_pendingTextures.erase(key);
+    }
+    promise.set_value(texture);
 }
 
-std::shared_ptr<Material> ResourceManager::buildmaterial(const std::string &name, const Material &materialInfo,
-                                                         const TexturePaths &textureNames,
-                                                         const std::string &shaderName)
+void ResourceManager::publishmesh(const std::string &key, const std::shared_ptr<Mesh> &mesh, MeshPromise &promise)
 {
-    auto material = std::make_shared<Material>(materialInfo);
-    material->name = name;
+    // 发布：只在插入缓存时持有锁
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_meshCache[key] = mesh;
+        m_pendingMeshes.erase(key);
+    }
+    promise.set_value(mesh);
+}
 
-    // 加载纹理 (如果路径不为空) - 使用内部无锁版本避免死锁
-    if (!textureNames.baseColor.empty())
+void ResourceManager::failmeshload(const std::string &key, MeshPromise &promise, std::exception_ptr error)
+{
     {
-        material->baseColorTexture = loadanduploadtexture(textureNames.baseColor, false);
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_pendingMeshes.erase(key);
     }
-    else
+    promise.set_exception(error);
+}
+
+void ResourceManager::failtextureload(const std::string &key, TexturePromise &promise, std::exception_ptr error)
+{
     {
-        material->baseColorTexture = m_defaultWhiteTexture;
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_pendingTextures.erase(key);
     }
+    promise.set_exception(error);
+}
 
-    if (!textureNames.metallic.empty())
+std::shared_ptr<Mesh> ResourceManager::createmesh(const std::string &name, const Vertex *vertices,
+                                                  size_t vertexCount, const uint32_t *indices, size_t indexCount,
+                                                  std::vector<MeshLod> lods)
+{
+    QTR_PROFILE_SCOPE("ResourceManager::createmesh");
+    auto mesh = std::make_shared<Mesh>();
+    mesh->name = name;
+    mesh->vertexCount = static_cast<uint32_t>(vertexCount);
+    mesh->indexCount = static_cast<uint32_t>(indexCount);
+    mesh->lods = std::move(lods);
+
+    // 包围体在顶点仍在内存（或映射中）时顺带计算，供场景做视锥剔除
+    computemeshbounds(vertices, vertexCount, mesh->bounds, mesh->boundingSphere);
+
+    // 在几何池中子分配顶点/索引区间，上传写入各自偏移处（顶点与索引上传进入同一批次）
+    // 索引相对于网格自身的首个顶点，顶点数不超过 16 位范围时索引缓冲减半
+    const vk::IndexType indexType =
+        vertexCount <= kMaxShortIndexVertexCount ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+    // 顶点编码为能表示源数据的最小格式（包围体已用规范格式的位置计算）
+    VertexFormat vertexFormat = VertexFormat::Standard;
+    if (getCompactVertexFormats())
     {
-        material->metallicTexture = loadanduploadtexture(textureNames.metallic, false);
+        vertexFormat = VertexLayouts::select(vertices, vertexCount);
     }
-    else
+    GeometryPool::allocate(m_geometryPool, *mesh, mesh->vertexCount, mesh->indexCount, indexType, vertexFormat);
+
+    // 几何池按全部 LOD 的索引分配；Mesh::indexCount 对外表示完整网格（LOD 0）
+    if (!mesh->lods.empty())
     {
-        material->metallicTexture = m_defaultWhiteTexture;
+        mesh->indexCount = mesh->lods[0].indexCount;
     }
 
-    if (!textureNames.roughness.empty())
+    if (vertexCount > 0 && vertexFormat != VertexFormat::Standard)
     {
-        material->roughnessTexture = loadanduploadtexture(textureNames.roughness, false);
+        const uint32_t stride = VertexLayouts::getInfo(vertexFormat).stride;
+        std::vector<std::byte> packed = VertexLayouts::encode(vertexFormat, vertices, vertexCount);
+        vkcore::UploadTicket ticket = m_uploadQueue->uploadBuffer(mesh->vertexBuffer, packed.data(), packed.size(),
+                                                                  vk::DeviceSize(mesh->vertexOffset) * stride);
+        mesh->uploadTicket = std::max(mesh->uploadTicket, ticket);
     }
-    else
+    else if (vertexCount > 0)
     {
-        material->roughnessTexture = m_defaultWhiteTexture;
+        vkcore::UploadTicket ticket =
+            m_uploadQueue->uploadBuffer(mesh->vertexBuffer, vertices, vertexCount * sizeof(Vertex),
+                                        vk::DeviceSize(mesh->vertexOffset) * sizeof(Vertex));
+        mesh->uploadTicket = std::max(mesh->uploadTicket, ticket);
     }
 
-    if (!textureNames.normal.empty())
+    if (indexCount > 0 && indexType == vk::IndexType::eUint16)
     {
-        material->normalTexture = loadanduploadtexture(textureNames.normal, false);
+        std::vector<uint16_t> shortIndices(indices, indices + indexCount);
+        vkcore::UploadTicket ticket =
+            m_uploadQueue->uploadBuffer(mesh->indexBuffer, shortIndices.data(), indexCount * sizeof(uint16_t),
+                                        vk::DeviceSize(mesh->firstIndex) * sizeof(uint16_t));
+        mesh->uploadTicket = std::max(mesh->uploadTicket, ticket);
     }
-    else
+    else if (indexCount > 0)
     {
-        material->normalTexture = m_defaultNormalTexture;
+        vkcore::UploadTicket ticket =
+            m_uploadQueue->uploadBuffer(mesh->indexBuffer, indices, indexCount * sizeof(uint32_t),
+                                        vk::DeviceSize(mesh->firstIndex) * sizeof(uint32_t));
+        mesh->uploadTicket = std::max(mesh->uploadTicket, ticket);
     }
 
-    if (!textureNames.occlusion.empty())
+    // meshlet 只覆盖完整网格（LOD 0），顶点索引相对于网格自身的首个顶点，几何池整理后无需重建
+    if (mesh->indexCount > 0 && getMeshletGeneration())
     {
-        material->occlusionTexture = loadanduploadtexture(textureNames.occlusion, false);
+        MeshletData meshletData = MeshletBuilder::build(vertices, vertexCount, indices, mesh->indexCount);
+        std::vector<uint32_t> words =
+            MeshletBuilder::pack(meshletData, mesh->meshlets.vertexWordOffset, mesh->meshlets.triangleWordOffset);
+
+        vkcore::BufferDesc desc{};
+        desc.size = words.size() * sizeof(uint32_t);
+        desc.usageFlags = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst;
+        desc.memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+        desc.category = vkcore::MemoryCategory::Mesh;
+        mesh->meshlets.buffer = std::make_shared<vkcore::Buffer>(name + "Meshlets", *m_device, m_allocator, desc);
+        mesh->meshlets.count = static_cast<uint32_t>(meshletData.meshlets.size());
+
+        vkcore::UploadTicket ticket = m_uploadQueue->uploadBuffer(mesh->meshlets.buffer, words.data(), desc.size, 0);
+        mesh->uploadTicket = std::max(mesh->uploadTicket, ticket);
     }
-    else
+
+    return mesh;
+}
+
+std::shared_ptr<Texture> ResourceManager::createtexture(const std::string &name, const void *pixels, int width,
+                                                        int height, vk::Format format, bool generateMips)
+{
+    auto texture = std::make_shared<Texture>();
+    texture->name = name;
+
+    // 创建图像
+    texture->image = createimagefromdata(pixels, width, height, format, &texture->uploadTicket, generateMips);
+
+    // 创建采样器
+    texture->sampler = gettexturesampler();
+
+    if (m_bindless)
     {
-        material->occlusionTexture = m_defaultWhiteTexture;
+        BindlessRegistry::registerTexture(m_bindless, *texture);
     }
 
-    if (!textureNames.emissive.empty())
+    return texture;
+}
+
+std::shared_ptr<Texture> ResourceManager::createhdrtexture(const std::string &name, const unsigned char *bytes,
+                                                           size_t size)
+{
+    QTR_PROFILE_SCOPE("ResourceManager::createhdrtexture");
+    vk::Format format = getHdrTextureFormat();
+    vk::FormatFeatureFlags features = m_device->getPhysicalDevice().getFormatProperties(format).optimalTilingFeatures;
+    if (!(features & vk::FormatFeatureFlagBits::eSampledImage))
     {
-        material->emissiveTexture = loadanduploadtexture(textureNames.emissive, false);
+        format = vk::Format::eR16G16B16A16Sfloat;
     }
-    else
+
+    TextureData hdr = TextureLoader::loadHDRFromMemory(bytes, size);
+    const size_t pixelCount = static_cast<size_t>(hdr.width) * static_cast<size_t>(hdr.height);
+    const uint32_t pixelSize = TextureContainer::getFormatBlockInfo(format).blockBytes;
+    std::vector<std::byte> converted;
+    try
     {
-        material->emissiveTexture = m_defaultWhiteTexture;
+        converted.resize(pixelCount * pixelSize);
+        const auto *source = reinterpret_cast<const float *>(hdr.pixels);
+        // 8K 环境贴图有数千万像素：按行分块并行转换（解码调度器上的任务内也可以嵌套）
+        if (m_decodePool && pixelCount > kHdrConvertPixels)
+        {
+            const size_t width = static_cast<size_t>(hdr.width);
+            const uint32_t rows = static_cast<uint32_t>(hdr.height);
+            const uint32_t rowsPerChunk = std::max(1u, kHdrConvertPixels / static_cast<uint32_t>(hdr.width));
+            m_decodePool->parallelFor(rows, rowsPerChunk, [&](uint32_t first, uint32_t last) {
+                HdrConverter::convert(source + first * width * 4, (last - first) * width, format,
+                                      converted.data() + first * width * pixelSize);
+            });
+        }
+        else
+        {
+            HdrConverter::convert(source, pixelCount, format, converted.data());
+        }
     }
-
-    // 加载着色器
-    if (!shaderName.empty())
+    catch (...)
     {
-        material->vertexShader = m_shaderManager->getShaderModule(shaderName + ".vert");
-        material->fragmentShader = m_shaderManager->getShaderModule(shaderName + ".frag");
+        hdr.free();
+        throw;
     }
 
-    // 分配描述符集
-    material->descriptorSet = m_descAllocator->allocate(m_materialLayout);
+    // 浮点像素比转换结果大 2~4 倍，上传前先释放
+    const int width = hdr.width;
+    const int height = hdr.height;
+    hdr.free();
 
-    // 创建材质参数Uniform Buffer
-    createMaterialUniformBuffer(material);
+    return createtexture(name, converted.data(), width, height, format, true);
+}
 
-    // 更新描述符集 - 绑定纹理和采样器
-    updateMaterialDescriptorSet(material);
+std::shared_ptr<EnvironmentMap> ResourceManager::loadcachedenvironment(const std::filesystem::path &filepath,
+                                                                       const std::filesystem::path &cachePath,
+                                                                       const EnvironmentPrefilter::Settings &settings)
+{
+    QTR_PROFILE_SCOPE("ResourceManager::loadcachedenvironment");
+    std::error_code ec;
+    if (!std::filesystem::exists(cachePath, ec))
+    {
+        return nullptr;
+    }
 
-    return material;
+    std::unique_ptr<vkcore::MappedFile> file;
+    std::optional<EnvironmentPrefilter::CacheView> view;
+    try
+    {
+        file = std::make_unique<vkcore::MappedFile>(cachePath);
+        view = EnvironmentPrefilter::openCache(*file, filepath, settings);
+    }
+    catch (...)
+    {
+        // 缓存文件不可读：当作未命中，重新预过滤并覆盖它
+        return nullptr;
+    }
+
+    if (!view)
+    {
+        return nullptr;
+    }
+
+    // 全部面与 mip 从映射内存直接拷入暂存区，不解码源图也不执行计算
+    file->prefault();
+    auto specular = EnvironmentPrefilter::createCubemap("EnvironmentSpecular", *m_device, m_allocator,
+                                                        settings.specularSize, settings.specularMipCount);
+    auto irradiance = EnvironmentPrefilter::createCubemap("EnvironmentIrradiance", *m_device, m_allocator,
+                                                          settings.irradianceSize, 1);
+    const vkcore::UploadTicket specularTicket = m_uploadQueue->uploadImage(
+        specular, view->specular, view->specularBytes,
+        EnvironmentPrefilter::getCopyRegions(settings.specularSize, settings.specularMipCount),
+        EnvironmentPrefilter::kPixelBytes);
+    const vkcore::UploadTicket irradianceTicket = m_uploadQueue->uploadImage(
+        irradiance, view->irradiance, view->irradianceBytes,
+        EnvironmentPrefilter::getCopyRegions(settings.irradianceSize, 1), EnvironmentPrefilter::kPixelBytes);
+
+    auto environment = std::make_shared<EnvironmentMap>();
+    environment->name = filepath.string();
+    environment->specular = createenvironmenttexture(environment->name + "_specular", specular, specularTicket);
+    environment->irradiance =
+        createenvironmenttexture(environment->name + "_irradiance", irradiance, irradianceTicket);
+    environment->specularMipCount = settings.specularMipCount;
+    return environment;
 }
 
-std::shared_ptr<Texture> ResourceManager::loadanduploadtexture(const std::filesystem::path &filepath, bool srgb)
+std::shared_ptr<EnvironmentMap> ResourceManager::prefilterenvironment(const std::filesystem::path &filepath,
+                                                                      const std::filesystem::path &cachePath,
+                                                                      const EnvironmentPrefilter::Settings &settings)
 {
-    // 加载纹理数据
-    TextureData textureData = TextureLoader::loadFromFile(filepath);
+    QTR_PROFILE_SCOPE("ResourceManager::prefilterenvironment");
+    const std::string sourceKey = filepath.string() + "_linear"; // 与 loadTexture(filepath) 的缓存键一致
+    bool sourceCached = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        sourceCached = m_textureCache.count(sourceKey) > 0;
+
+        // 计算管线在第一次未命中时才创建：缓存全部命中时不需要着色器
+        if (!m_environmentPrefilter)
+        {
+            auto shader = m_shaderManager->getShaderModule("environment_prefilter.comp");
+            if (!shader)
+            {
+                throw std::runtime_error("ResourceManager: environment_prefilter.comp is not loaded");
+            }
+            m_environmentPrefilter = std::make_unique<EnvironmentPrefilter>(*m_device, m_allocator, *m_layoutCache,
+                                                                            *m_samplerCache, std::move(shader));
+        }
+    }
+
+    // 源图走普通纹理路径（HDR 格式转换与 mip 生成），预过滤前等待上传完成
+    std::shared_ptr<Texture> source = loadTexture(filepath);
+    waitForUploads();
+
+    std::vector<std::byte> cacheData;
+    EnvironmentPrefilter::Result result;
+    try
+    {
+        result = m_environmentPrefilter->run(*m_cmdManager, *source->image, source->sampler, settings,
+                                             cachePath.empty() ? nullptr : &cacheData);
+    }
+    catch (...)
+    {
+        if (!sourceCached)
+        {
+            unloadTexture(sourceKey);
+        }
+        throw;
+    }
 
-    if (!textureData.isValid())
+    // 8K 源图只为预过滤而加载：不是调用者先前加载的就立即释放（run() 返回时 GPU 已不再使用它）
+    if (!sourceCached)
     {
-        throw std::runtime_error("Failed to load texture: " + filepath.string());
+        source.reset();
+        unloadTexture(sourceKey);
     }
 
-    // 确定格式
-    vk::Format format = vk::Format::eR8G8B8A8Unorm;
-    if (srgb)
+    // 写出缓存，下次加载跳过源图解码与预过滤（失败只影响下次加载速度）
+    if (!cachePath.empty() && !EnvironmentPrefilter::writeCache(cachePath, filepath, settings, cacheData))
     {
-        format = vk::Format::eR8G8B8A8Srgb;
+        QTR_LOG_WARN("ResourceManager", "Failed to write environment cache: " << cachePath.string());
     }
 
-    // 创建纹理
-    auto texture =
-        registerTexture(filepath.string(), textureData.pixels, textureData.width, textureData.height, format);
+    auto environment = std::make_shared<EnvironmentMap>();
+    environment->name = filepath.string();
+    environment->specular = createenvironmenttexture(environment->name + "_specular", result.specular, 0);
+    environment->irradiance = createenvironmenttexture(environment->name + "_irradiance", result.irradiance, 0);
+    environment->specularMipCount = settings.specularMipCount;
+    return environment;
+}
+
+std::shared_ptr<Texture> ResourceManager::createenvironmenttexture(const std::string &name,
+                                                                   std::shared_ptr<vkcore::Image> image,
+                                                                   vkcore::UploadTicket ticket)
+{
+    auto texture = std::make_shared<Texture>();
+    texture->name = name;
+    texture->image = std::move(image);
+    texture->sampler = getorsampler(vk::Filter::eLinear, vk::SamplerAddressMode::eClampToEdge);
+    texture->uploadTicket = ticket;
+    return texture;
+}
+
+std::shared_ptr<Texture> ResourceManager::createcontainertexture(const std::string &name,
+                                                                 const TextureContainerData &container, bool srgb,
+                                                                 const std::shared_ptr<vkcore::MappedFile> &file)
+{
+    auto texture = std::make_shared<Texture>();
+    texture->name = name;
 
-    // 释放CPU内存
-    textureData.free();
+    // 颜色空间由请求决定（与 RGBA8 路径一致）；没有 sRGB 变体的格式（BC4/BC5/BC6H）保持原样
+    vk::Format format = TextureContainer::withColorSpace(container.format, srgb);
+    if (m_textureStreamer && file && TextureStreamer::isStreamable(container))
+    {
+        m_textureStreamer->track(texture, file, container, format);
+    }
+    else
+    {
+        texture->image = createimagefromcontainer(container, format, &texture->uploadTicket);
+    }
+    texture->sampler = gettexturesampler();
+    if (m_bindless)
+    {
+        BindlessRegistry::registerTexture(m_bindless, *texture);
+    }
 
     return texture;
 }
 
-MeshData ResourceManager::mergeMeshData(const std::vector<MeshData> &meshDataList, const std::string &baseName)
+MeshData ResourceManager::mergeMeshData(const std::vector<MeshData> &meshDataList, const std::string &baseName,
+                                        std::vector<Submesh> *submeshes)
 {
     MeshData mergedMesh;
     mergedMesh.name = baseName;
@@ -849,6 +2051,17 @@ MeshData ResourceManager::mergeMeshData(const std::vector<MeshData> &meshDataLis
 
     for (const auto &meshData : meshDataList)
     {
+        if (submeshes)
+        {
+            Submesh submesh;
+            submesh.name = meshData.name;
+            submesh.firstIndex = static_cast<uint32_t>(mergedMesh.indices.size());
+            submesh.indexCount = static_cast<uint32_t>(meshData.indices.size());
+            submesh.firstVertex = vertexOffset;
+            submesh.vertexCount = static_cast<uint32_t>(meshData.vertices.size());
+            submeshes->push_back(std::move(submesh));
+        }
+
         // 复制顶点数据
         mergedMesh.vertices.insert(mergedMesh.vertices.end(), meshData.vertices.begin(), meshData.vertices.end());
 
@@ -861,65 +2074,14 @@ MeshData ResourceManager::mergeMeshData(const std::vector<MeshData> &meshDataLis
         vertexOffset += static_cast<uint32_t>(meshData.vertices.size());
 
         // 可选：输出合并信息
-        std::cout << "Merged mesh: " << meshData.name << " (" << meshData.vertices.size() << " vertices, "
-                  << meshData.indices.size() << " indices)" << std::endl;
+        QTR_LOG_DEBUG("ResourceManager", "Merged mesh: " << meshData.name << " (" << meshData.vertices.size()
+                                         << " vertices, " << meshData.indices.size() << " indices)");
     }
 
-    std::cout << "Total merged: " << mergedMesh.vertices.size() << " vertices, " << mergedMesh.indices.size()
-              << " indices" << std::endl;
+    QTR_LOG_DEBUG("ResourceManager", "Total merged: " << mergedMesh.vertices.size() << " vertices, "
+                                     << mergedMesh.indices.size() << " indices");
 
     return mergedMesh;
 }
 
-std::shared_ptr<Mesh> ResourceManager::loadanduploadmesh(const std::filesystem::path &filepath)
-{
-    // 从文件加载模型数据到内存
-    std::vector<MeshData> meshDataList = ModelLoader::loadModel(filepath);
-
-    if (meshDataList.empty())
-    {
-        throw std::runtime_error("No meshes found in file: " + filepath.string());
-    }
-
-    // 合并所有网格为单一网格（优化方案）
-    MeshData mergedMeshData = mergeMeshData(meshDataList, filepath.stem().string());
-
-    if (!mergedMeshData.isValid())
-    {
-        throw std::runtime_error("Invalid mesh data loaded from file: " + filepath.string());
-    }
-
-    // 将内存数据上传到GPU，创建GPU资源（不通过 registerMesh 避免双重加锁）
-    std::string name = filepath.string();
-
-    // 检查是否已存在（不需要锁，因为调用者已经有锁了）
-    auto it = m_meshCache.find(name);
-    if (it != m_meshCache.end())
-    {
-        return it->second;
-    }
-
-    // 创建缓冲区
-    auto vertexBuffer =
-        createbufferfromdata(mergedMeshData.vertices.data(), mergedMeshData.vertices.size() * sizeof(Vertex),
-                             vk::BufferUsageFlagBits::eVertexBuffer);
-
-    auto indexBuffer =
-        createbufferfromdata(mergedMeshData.indices.data(), mergedMeshData.indices.size() * sizeof(uint32_t),
-                             vk::BufferUsageFlagBits::eIndexBuffer);
-
-    // 创建 Mesh 对象
-    auto mesh = std::make_shared<Mesh>();
-    mesh->name = name;
-    mesh->vertexBuffer = vertexBuffer;
-    mesh->indexBuffer = indexBuffer;
-    mesh->vertexCount = static_cast<uint32_t>(mergedMeshData.vertices.size());
-    mesh->indexCount = static_cast<uint32_t>(mergedMeshData.indices.size());
-
-    // 添加到缓存
-    m_meshCache[name] = mesh;
-
-    return mesh;
-}
-
 } // namespace rendercore
\ No newline at end of file
@@ -1,5 +1,8 @@
 // RenderCore/ResourceManager/private/ResourceManagerUtils.cpp
 #include "ResourceManagerUtils.hpp"
+#include "MeshOptimizer.hpp"
+#include "ObjParser.hpp"
+#include "VulkanCore/public/MappedFile.hpp"
 
 // ============================================================================
 // stb_image 库集成
@@ -27,6 +30,56 @@
 namespace rendercore
 {
 
+namespace
+{
+
+constexpr float kStlCreaseAngle = 0.5235988f; ///< STL 焊接的折痕角（30°），更尖锐的棱保持平直着色
+
+/**
+ * @brief 只读内存流缓冲区，让基于 std::istream 的解析器直接读取已加载到内存的文件内容
+ */
+class memorystreambuf : public std::streambuf
+{
+  public:
+    memorystreambuf(const char *data, size_t size)
+    {
+        char *begin = const_cast<char *>(data);
+        setg(begin, begin, begin + size);
+    }
+
+  protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+    {
+        if (!(which & std::ios_base::in))
+        {
+            return pos_type(off_type(-1));
+        }
+
+        char *target = nullptr;
+        if (dir == std::ios_base::beg)
+            target = eback() + off;
+        else if (dir == std::ios_base::cur)
+            target = gptr() + off;
+        else
+            target = egptr() + off;
+
+        if (target < eback() || target > egptr())
+        {
+            return pos_type(off_type(-1));
+        }
+
+        setg(eback(), target, egptr());
+        return pos_type(target - eback());
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+    {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+};
+
+} // namespace
+
 // ============================================================================
 // MaterialLoader 实现
 // ============================================================================
@@ -250,139 +303,11 @@ std::vector<MeshData> ModelLoader::loadOBJ(const std::filesystem::path &filePath
         throw std::runtime_error("OBJ file not found: " + filePath.string());
     }
 
-    std::vector<MeshData> meshes;
-    std::vector<Vertex> vertices;
-    std::vector<uint32_t> indices;
-
-    // 临时存储
-    std::vector<glm::vec3> positions;
-    std::vector<glm::vec3> normals;
-    std::vector<glm::vec2> texCoords;
-
-    std::ifstream file(filePath);
-    if (!file.is_open())
-    {
-        throw std::runtime_error("Failed to open OBJ file: " + filePath.string());
-    }
-
-    std::string line;
-    std::string currentMeshName = "default";
-    bool hasData = false;
-
-    while (std::getline(file, line))
-    {
-        if (line.empty() || line[0] == '#')
-            continue;
-
-        std::istringstream iss(line);
-        std::string prefix;
-        iss >> prefix;
-
-        if (prefix == "v")
-        {
-            // 顶点位置
-            glm::vec3 pos;
-            iss >> pos.x >> pos.y >> pos.z;
-            positions.push_back(pos);
-            hasData = true;
-        }
-        else if (prefix == "vn")
-        {
-            // 顶点法线
-            glm::vec3 normal;
-            iss >> normal.x >> normal.y >> normal.z;
-            normals.push_back(normal);
-        }
-        else if (prefix == "vt")
-        {
-            // 纹理坐标
-            glm::vec2 uv;
-            iss >> uv.x >> uv.y;
-            if (flipUVs)
-                uv.y = 1.0f - uv.y;
-            texCoords.push_back(uv);
-        }
-        else if (prefix == "g" || prefix == "o")
-        {
-            // 组或对象名（开始新的网格）
-            if (hasData && !vertices.empty())
-            {
-                MeshData meshData;
-                meshData.name = currentMeshName;
-                meshData.vertices = std::move(vertices);
-                meshData.indices = std::move(indices);
-                meshes.push_back(std::move(meshData));
-
-                vertices.clear();
-                indices.clear();
-            }
-            iss >> currentMeshName;
-            hasData = false;
-        }
-        else if (prefix == "f")
-        {
-            // 面（三角形）
-            std::string vertexStr;
-            std::vector<uint32_t> faceIndices;
-
-            while (iss >> vertexStr)
-            {
-                // 解析格式：v/vt/vn 或 v//vn 或 v/vt 或 v
-                int posIdx = 0, uvIdx = 0, normalIdx = 0;
-                std::replace(vertexStr.begin(), vertexStr.end(), '/', ' ');
-                std::istringstream viss(vertexStr);
-
-                viss >> posIdx;
-                if (viss.peek() == ' ')
-                {
-                    viss.ignore();
-                    if (viss.peek() != ' ')
-                        viss >> uvIdx;
-                    if (viss.peek() == ' ')
-                    {
-                        viss.ignore();
-                        viss >> normalIdx;
-                    }
-                }
-
-                // OBJ 索引从 1 开始，转换为从 0 开始
-                Vertex vertex;
-                vertex.position = positions[posIdx - 1];
-                vertex.normal = normalIdx > 0 ? normals[normalIdx - 1] : glm::vec3(0, 1, 0);
-                vertex.texCoord = uvIdx > 0 ? texCoords[uvIdx - 1] : glm::vec2(0, 0);
-                vertex.color = glm::vec4(1.0f); // 默认白色
-
-                uint32_t index = static_cast<uint32_t>(vertices.size());
-                vertices.push_back(vertex);
-                faceIndices.push_back(index);
-            }
-
-            // 三角形化（如果是四边形或多边形）
-            for (size_t i = 2; i < faceIndices.size(); ++i)
-            {
-                indices.push_back(faceIndices[0]);
-                indices.push_back(faceIndices[i - 1]);
-                indices.push_back(faceIndices[i]);
-            }
-        }
-    }
-
-    // 保存最后一个网格
-    if (!vertices.empty())
-    {
-        MeshData meshData;
-        meshData.name = currentMeshName;
-        meshData.vertices = std::move(vertices);
-        meshData.indices = std::move(indices);
-        meshes.push_back(std::move(meshData));
-    }
-
-    if (meshes.empty())
-    {
-        throw std::runtime_error("No geometry found in OBJ file: " + filePath.string());
-    }
+    vkcore::MappedFile file(filePath);
 
-    return meshes;
+    ObjParser::Options options;
+    options.flipUVs = flipUVs;
+    return ObjParser::parse(file.data(), file.size(), filePath.string(), options);
 }
 
 MeshData ModelLoader::loadSTL(const std::filesystem::path &filePath)
@@ -398,6 +323,11 @@ MeshData ModelLoader::loadSTL(const std::filesystem::path &filePath)
         throw std::runtime_error("Failed to open STL file: " + filePath.string());
     }
 
+    return parseSTL(file, filePath.stem().string());
+}
+
+MeshData ModelLoader::parseSTL(std::istream &file, const std::string &name)
+{
     // 检测是二进制还是 ASCII
     char header[5];
     file.read(header, 5);
@@ -406,8 +336,6 @@ MeshData ModelLoader::loadSTL(const std::filesystem::path &filePath)
     bool isBinary = (std::string(header, 5) != "solid");
 
     MeshData meshData;
-    meshData.name = filePath.stem().string();
-
     if (isBinary)
     {
         meshData = loadSTLBinary(file);
@@ -417,11 +345,14 @@ MeshData ModelLoader::loadSTL(const std::filesystem::path &filePath)
         meshData = loadSTLAscii(file);
     }
 
-    file.close();
+    // STL 的每个角点都是独立顶点：按位置焊接，折痕角内的面法线取平均
+    MeshOptimizer::weldVertices(meshData, kStlCreaseAngle);
+
+    meshData.name = name;
     return meshData;
 }
 
-MeshData ModelLoader::loadSTLBinary(std::ifstream &file)
+MeshData ModelLoader::loadSTLBinary(std::istream &file)
 {
     MeshData meshData;
     std::vector<Vertex> vertices;
@@ -467,7 +398,7 @@ MeshData ModelLoader::loadSTLBinary(std::ifstream &file)
     return meshData;
 }
 
-MeshData ModelLoader::loadSTLAscii(std::ifstream &file)
+MeshData ModelLoader::loadSTLAscii(std::istream &file)
 {
     MeshData meshData;
     std::vector<Vertex> vertices;
@@ -533,6 +464,37 @@ std::vector<MeshData> ModelLoader::loadModel(const std::filesystem::path &filePa
     }
 }
 
+std::vector<MeshData> ModelLoader::loadModelFromMemory(const char *data, size_t size, ModelFormat format,
+                                                       const std::string &name, vkcore::WorkerPool *workers)
+{
+    switch (format)
+    {
+    case ModelFormat::OBJ: {
+        ObjParser::Options options;
+        options.workers = workers;
+        return ObjParser::parse(data, size, name, options);
+    }
+
+    case ModelFormat::STL: {
+        // STL 解析器基于流，直接包装映射内存，不做拷贝
+        memorystreambuf buffer(data, size);
+        std::istream stream(&buffer);
+
+        std::vector<MeshData> meshes;
+        meshes.push_back(parseSTL(stream, name));
+        return meshes;
+    }
+
+    case ModelFormat::FBX:
+    case ModelFormat::GLTF:
+    case ModelFormat::PLY:
+        throw std::runtime_error("Format not yet implemented. Consider using Assimp library.");
+
+    default:
+        throw std::runtime_error("Unsupported or unknown model format: " + name);
+    }
+}
+
 // ============================================================================
 // TextureLoader 实现
 // ============================================================================
@@ -564,6 +526,8 @@ TextureLoader::TextureFormat TextureLoader::detectFormat(const std::filesystem::
         return TextureFormat::DDS;
     if (ext == ".ktx")
         return TextureFormat::KTX;
+    if (ext == ".ktx2")
+        return TextureFormat::KTX2;
     if (ext == ".astc")
         return TextureFormat::ASTC;
 
@@ -595,6 +559,11 @@ TextureData TextureLoader::loadFromFile(const std::filesystem::path &filePath, i
         return loadStandard(filePath, desiredChannels, flipVertically);
 
     case TextureFormat::DDS:
+    case TextureFormat::KTX2:
+        // GPU 压缩容器不解码为像素，由 TextureContainer 解析后直接上传
+        throw std::runtime_error("GPU texture containers are not decoded to pixels, use TextureContainer: " +
+                                 filePath.string());
+
     case TextureFormat::KTX:
     case TextureFormat::ASTC:
         throw std::runtime_error("Compressed texture formats not yet implemented: " + filePath.string());
@@ -665,8 +634,8 @@ TextureData TextureLoader::createCheckerboard(int width, int height, int squareS
 
 TextureData TextureLoader::loadStandard(const std::filesystem::path &filePath, int desiredChannels, bool flipVertically)
 {
-    // 设置垂直翻转
-    stbi_set_flip_vertically_on_load(static_cast<int>(flipVertically));
+    // 设置垂直翻转（线程局部，纹理可以在多个加载线程上并行解码）
+    stbi_set_flip_vertically_on_load_thread(static_cast<int>(flipVertically));
 
     TextureData data;
 
@@ -697,8 +666,8 @@ TextureData TextureLoader::loadStandard(const std::filesystem::path &filePath, i
 
 TextureData TextureLoader::loadHDR(const std::filesystem::path &filePath, int desiredChannels, bool flipVertically)
 {
-    // 设置垂直翻转
-    stbi_set_flip_vertically_on_load(flipVertically ? 1 : 0);
+    // 设置垂直翻转（线程局部，纹理可以在多个加载线程上并行解码）
+    stbi_set_flip_vertically_on_load_thread(flipVertically ? 1 : 0);
 
     TextureData data;
 
@@ -723,19 +692,51 @@ TextureData TextureLoader::loadHDR(const std::filesystem::path &filePath, int de
         data.channels = desiredChannels;
     }
 
-    // 将 float* 转换为 unsigned char*（需要调用者知道这是浮点数据）
-    // 注意：这里只是类型转换，实际数据仍然是 float
+    // 将 float* 转换为 unsigned char*（isFloat 标明实际数据仍然是 float）
     data.pixels = reinterpret_cast<unsigned char *>(hdrPixels);
-    data.dataSize = data.width * data.height * data.channels * sizeof(float);
+    data.dataSize = static_cast<size_t>(data.width) * data.height * data.channels * sizeof(float);
+    data.isFloat = true;
 
     return data;
 }
 
+bool TextureLoader::isHDR(const unsigned char *data, size_t dataSize)
+{
+    return stbi_is_hdr_from_memory(data, static_cast<int>(dataSize)) != 0;
+}
+
+TextureData TextureLoader::loadHDRFromMemory(const unsigned char *data, size_t dataSize, bool flipVertically)
+{
+    // 设置垂直翻转（线程局部，纹理可以在多个加载线程上并行解码）
+    stbi_set_flip_vertically_on_load_thread(flipVertically ? 1 : 0);
+
+    TextureData result;
+    float *hdrPixels = stbi_loadf_from_memory(data, static_cast<int>(dataSize), &result.width, &result.height,
+                                              &result.channels, 4);
+    if (!hdrPixels)
+    {
+        std::string errorMsg = "Failed to load HDR texture from memory";
+        const char *stbiError = stbi_failure_reason();
+        if (stbiError)
+        {
+            errorMsg += " (Reason: " + std::string(stbiError) + ")";
+        }
+        throw std::runtime_error(errorMsg);
+    }
+
+    result.channels = 4;
+    result.pixels = reinterpret_cast<unsigned char *>(hdrPixels);
+    result.dataSize = static_cast<size_t>(result.width) * result.height * 4 * sizeof(float);
+    result.isFloat = true;
+
+    return result;
+}
+
 TextureData TextureLoader::loadFromMemory(const unsigned char *data, size_t dataSize, int desiredChannels,
                                           bool flipVertically)
 {
-    // 设置垂直翻转
-    stbi_set_flip_vertically_on_load(flipVertically ? 1 : 0);
+    // 设置垂直翻转（线程局部，纹理可以在多个加载线程上并行解码）
+    stbi_set_flip_vertically_on_load_thread(flipVertically ? 1 : 0);
 
     TextureData result;
 
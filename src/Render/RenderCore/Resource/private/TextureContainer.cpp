@@ -0,0 +1,592 @@
+#include "TextureContainer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @file TextureContainer.cpp
+ * @brief TextureContainer 的实现文件
+ */
+
+namespace rendercore
+{
+
+namespace
+{
+
+// ==================== KTX2 常量 ====================
+
+constexpr unsigned char kKtx2Identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+constexpr size_t kKtx2LevelIndexOffset = 80; ///< 标识符 + 头部 + 数据段索引
+constexpr size_t kKtx2LevelIndexStride = 24; ///< byteOffset / byteLength / uncompressedByteLength
+
+// ==================== DDS 常量 ====================
+
+constexpr uint32_t kDdsMagic = 0x20534444; ///< "DDS "
+constexpr uint32_t kDdsHeaderSize = 124;
+constexpr size_t kDdsDataOffset = 128;     ///< 魔数 + DDS_HEADER
+constexpr size_t kDdsDx10DataOffset = 148; ///< 魔数 + DDS_HEADER + DDS_HEADER_DXT10
+constexpr uint32_t kDdsFlagMipMapCount = 0x20000;
+constexpr uint32_t kDdsPixelFourCC = 0x4;
+constexpr uint32_t kDdsPixelRGB = 0x40;
+constexpr uint32_t kDdsCaps2Cubemap = 0x200;
+constexpr uint32_t kDdsCaps2Volume = 0x200000;
+constexpr uint32_t kDx10DimensionTexture2D = 3;
+constexpr uint32_t kDx10MiscTextureCube = 0x4;
+
+constexpr uint32_t makefourcc(char a, char b, char c, char d)
+{
+    return static_cast<uint32_t>(static_cast<unsigned char>(a)) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(b)) << 8) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(c)) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(d)) << 24);
+}
+
+/**
+ * @brief 读取小端 uint32（源地址可能未对齐）
+ */
+uint32_t readu32(const unsigned char *data)
+{
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint64_t readu64(const unsigned char *data)
+{
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief 查询格式的纹素块信息
+ * @return 格式未知时返回 false
+ */
+bool findblockinfo(vk::Format format, FormatBlockInfo &info)
+{
+    switch (format)
+    {
+    // 8 位非压缩格式
+    case vk::Format::eR8Unorm:
+    case vk::Format::eR8Snorm:
+    case vk::Format::eR8Srgb:
+        info = {1, 1, 1};
+        return true;
+    case vk::Format::eR8G8Unorm:
+    case vk::Format::eR8G8Snorm:
+    case vk::Format::eR8G8Srgb:
+        info = {1, 1, 2};
+        return true;
+    case vk::Format::eR8G8B8Unorm:
+    case vk::Format::eR8G8B8Srgb:
+        info = {1, 1, 3};
+        return true;
+    case vk::Format::eR8G8B8A8Unorm:
+    case vk::Format::eR8G8B8A8Snorm:
+    case vk::Format::eR8G8B8A8Srgb:
+    case vk::Format::eB8G8R8A8Unorm:
+    case vk::Format::eB8G8R8A8Srgb:
+        info = {1, 1, 4};
+        return true;
+
+    // 浮点非压缩格式
+    case vk::Format::eR16Sfloat:
+        info = {1, 1, 2};
+        return true;
+    case vk::Format::eR16G16Sfloat:
+    case vk::Format::eR32Sfloat:
+    case vk::Format::eB10G11R11UfloatPack32:
+    case vk::Format::eE5B9G9R9UfloatPack32:
+        info = {1, 1, 4};
+        return true;
+    case vk::Format::eR16G16B16A16Sfloat:
+    case vk::Format::eR32G32Sfloat:
+        info = {1, 1, 8};
+        return true;
+    case vk::Format::eR32G32B32A32Sfloat:
+        info = {1, 1, 16};
+        return true;
+
+    // BCn（桌面 GPU）
+    case vk::Format::eBc1RgbUnormBlock:
+    case vk::Format::eBc1RgbSrgbBlock:
+    case vk::Format::eBc1RgbaUnormBlock:
+    case vk::Format::eBc1RgbaSrgbBlock:
+    case vk::Format::eBc4UnormBlock:
+    case vk::Format::eBc4SnormBlock:
+        info = {4, 4, 8};
+        return true;
+    case vk::Format::eBc2UnormBlock:
+    case vk::Format::eBc2SrgbBlock:
+    case vk::Format::eBc3UnormBlock:
+    case vk::Format::eBc3SrgbBlock:
+    case vk::Format::eBc5UnormBlock:
+    case vk::Format::eBc5SnormBlock:
+    case vk::Format::eBc6HUfloatBlock:
+    case vk::Format::eBc6HSfloatBlock:
+    case vk::Format::eBc7UnormBlock:
+    case vk::Format::eBc7SrgbBlock:
+        info = {4, 4, 16};
+        return true;
+
+    // ETC2 / EAC（移动 GPU）
+    case vk::Format::eEtc2R8G8B8UnormBlock:
+    case vk::Format::eEtc2R8G8B8SrgbBlock:
+    case vk::Format::eEtc2R8G8B8A1UnormBlock:
+    case vk::Format::eEtc2R8G8B8A1SrgbBlock:
+    case vk::Format::eEacR11UnormBlock:
+    case vk::Format::eEacR11SnormBlock:
+        info = {4, 4, 8};
+        return true;
+    case vk::Format::eEtc2R8G8B8A8UnormBlock:
+    case vk::Format::eEtc2R8G8B8A8SrgbBlock:
+    case vk::Format::eEacR11G11UnormBlock:
+    case vk::Format::eEacR11G11SnormBlock:
+        info = {4, 4, 16};
+        return true;
+
+    // ASTC LDR（移动 GPU，所有块尺寸都是 16 字节）
+    case vk::Format::eAstc4x4UnormBlock:
+    case vk::Format::eAstc4x4SrgbBlock:
+        info = {4, 4, 16};
+        return true;
+    case vk::Format::eAstc5x4UnormBlock:
+    case vk::Format::eAstc5x4SrgbBlock:
+        info = {5, 4, 16};
+        return true;
+    case vk::Format::eAstc5x5UnormBlock:
+    case vk::Format::eAstc5x5SrgbBlock:
+        info = {5, 5, 16};
+        return true;
+    case vk::Format::eAstc6x5UnormBlock:
+    case vk::Format::eAstc6x5SrgbBlock:
+        info = {6, 5, 16};
+        return true;
+    case vk::Format::eAstc6x6UnormBlock:
+    case vk::Format::eAstc6x6SrgbBlock:
+        info = {6, 6, 16};
+        return true;
+    case vk::Format::eAstc8x5UnormBlock:
+    case vk::Format::eAstc8x5SrgbBlock:
+        info = {8, 5, 16};
+        return true;
+    case vk::Format::eAstc8x6UnormBlock:
+    case vk::Format::eAstc8x6SrgbBlock:
+        info = {8, 6, 16};
+        return true;
+    case vk::Format::eAstc8x8UnormBlock:
+    case vk::Format::eAstc8x8SrgbBlock:
+        info = {8, 8, 16};
+        return true;
+    case vk::Format::eAstc10x5UnormBlock:
+    case vk::Format::eAstc10x5SrgbBlock:
+        info = {10, 5, 16};
+        return true;
+    case vk::Format::eAstc10x6UnormBlock:
+    case vk::Format::eAstc10x6SrgbBlock:
+        info = {10, 6, 16};
+        return true;
+    case vk::Format::eAstc10x8UnormBlock:
+    case vk::Format::eAstc10x8SrgbBlock:
+        info = {10, 8, 16};
+        return true;
+    case vk::Format::eAstc10x10UnormBlock:
+    case vk::Format::eAstc10x10SrgbBlock:
+        info = {10, 10, 16};
+        return true;
+    case vk::Format::eAstc12x10UnormBlock:
+    case vk::Format::eAstc12x10SrgbBlock:
+        info = {12, 10, 16};
+        return true;
+    case vk::Format::eAstc12x12UnormBlock:
+    case vk::Format::eAstc12x12SrgbBlock:
+        info = {12, 12, 16};
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief UNORM / SRGB 变体对照表
+ */
+constexpr std::pair<vk::Format, vk::Format> kColorSpacePairs[] = {
+    {vk::Format::eR8Unorm, vk::Format::eR8Srgb},
+    {vk::Format::eR8G8Unorm, vk::Format::eR8G8Srgb},
+    {vk::Format::eR8G8B8Unorm, vk::Format::eR8G8B8Srgb},
+    {vk::Format::eR8G8B8A8Unorm, vk::Format::eR8G8B8A8Srgb},
+    {vk::Format::eB8G8R8A8Unorm, vk::Format::eB8G8R8A8Srgb},
+    {vk::Format::eBc1RgbUnormBlock, vk::Format::eBc1RgbSrgbBlock},
+    {vk::Format::eBc1RgbaUnormBlock, vk::Format::eBc1RgbaSrgbBlock},
+    {vk::Format::eBc2UnormBlock, vk::Format::eBc2SrgbBlock},
+    {vk::Format::eBc3UnormBlock, vk::Format::eBc3SrgbBlock},
+    {vk::Format::eBc7UnormBlock, vk::Format::eBc7SrgbBlock},
+    {vk::Format::eEtc2R8G8B8UnormBlock, vk::Format::eEtc2R8G8B8SrgbBlock},
+    {vk::Format::eEtc2R8G8B8A1UnormBlock, vk::Format::eEtc2R8G8B8A1SrgbBlock},
+    {vk::Format::eEtc2R8G8B8A8UnormBlock, vk::Format::eEtc2R8G8B8A8SrgbBlock},
+    {vk::Format::eAstc4x4UnormBlock, vk::Format::eAstc4x4SrgbBlock},
+    {vk::Format::eAstc5x4UnormBlock, vk::Format::eAstc5x4SrgbBlock},
+    {vk::Format::eAstc5x5UnormBlock, vk::Format::eAstc5x5SrgbBlock},
+    {vk::Format::eAstc6x5UnormBlock, vk::Format::eAstc6x5SrgbBlock},
+    {vk::Format::eAstc6x6UnormBlock, vk::Format::eAstc6x6SrgbBlock},
+    {vk::Format::eAstc8x5UnormBlock, vk::Format::eAstc8x5SrgbBlock},
+    {vk::Format::eAstc8x6UnormBlock, vk::Format::eAstc8x6SrgbBlock},
+    {vk::Format::eAstc8x8UnormBlock, vk::Format::eAstc8x8SrgbBlock},
+    {vk::Format::eAstc10x5UnormBlock, vk::Format::eAstc10x5SrgbBlock},
+    {vk::Format::eAstc10x6UnormBlock, vk::Format::eAstc10x6SrgbBlock},
+    {vk::Format::eAstc10x8UnormBlock, vk::Format::eAstc10x8SrgbBlock},
+    {vk::Format::eAstc10x10UnormBlock, vk::Format::eAstc10x10SrgbBlock},
+    {vk::Format::eAstc12x10UnormBlock, vk::Format::eAstc12x10SrgbBlock},
+    {vk::Format::eAstc12x12UnormBlock, vk::Format::eAstc12x12SrgbBlock},
+};
+
+/**
+ * @brief DXGI_FORMAT 到 vk::Format 的映射（只覆盖纹理资源中常见的格式）
+ */
+vk::Format dxgitovkformat(uint32_t dxgiFormat)
+{
+    switch (dxgiFormat)
+    {
+    case 2:
+        return vk::Format::eR32G32B32A32Sfloat;
+    case 10:
+        return vk::Format::eR16G16B16A16Sfloat;
+    case 16:
+        return vk::Format::eR32G32Sfloat;
+    case 26:
+        return vk::Format::eB10G11R11UfloatPack32;
+    case 28:
+        return vk::Format::eR8G8B8A8Unorm;
+    case 29:
+        return vk::Format::eR8G8B8A8Srgb;
+    case 31:
+        return vk::Format::eR8G8B8A8Snorm;
+    case 34:
+        return vk::Format::eR16G16Sfloat;
+    case 41:
+        return vk::Format::eR32Sfloat;
+    case 49:
+        return vk::Format::eR8G8Unorm;
+    case 54:
+        return vk::Format::eR16Sfloat;
+    case 61:
+        return vk::Format::eR8Unorm;
+    case 67:
+        return vk::Format::eE5B9G9R9UfloatPack32;
+    case 71:
+        return vk::Format::eBc1RgbaUnormBlock;
+    case 72:
+        return vk::Format::eBc1RgbaSrgbBlock;
+    case 74:
+        return vk::Format::eBc2UnormBlock;
+    case 75:
+        return vk::Format::eBc2SrgbBlock;
+    case 77:
+        return vk::Format::eBc3UnormBlock;
+    case 78:
+        return vk::Format::eBc3SrgbBlock;
+    case 80:
+        return vk::Format::eBc4UnormBlock;
+    case 81:
+        return vk::Format::eBc4SnormBlock;
+    case 83:
+        return vk::Format::eBc5UnormBlock;
+    case 84:
+        return vk::Format::eBc5SnormBlock;
+    case 87:
+        return vk::Format::eB8G8R8A8Unorm;
+    case 91:
+        return vk::Format::eB8G8R8A8Srgb;
+    case 95:
+        return vk::Format::eBc6HUfloatBlock;
+    case 96:
+        return vk::Format::eBc6HSfloatBlock;
+    case 98:
+        return vk::Format::eBc7UnormBlock;
+    case 99:
+        return vk::Format::eBc7SrgbBlock;
+    default:
+        return vk::Format::eUndefined;
+    }
+}
+
+/**
+ * @brief 校验一级 mip 完整地落在源内存内且不短于按尺寸计算的大小
+ */
+void checklevel(const TextureContainerData::Level &level, size_t fileSize, size_t expectedSize,
+                const std::string &sourceName)
+{
+    if (level.offset > fileSize || level.size > fileSize - level.offset)
+    {
+        throw std::runtime_error("Texture container is truncated: " + sourceName);
+    }
+    if (level.size < expectedSize)
+    {
+        throw std::runtime_error("Texture container mip level is smaller than its extent requires: " + sourceName);
+    }
+}
+
+} // namespace
+
+// ==================== 公共接口 ====================
+
+bool TextureContainer::isContainer(const unsigned char *data, size_t size)
+{
+    if (size >= sizeof(kKtx2Identifier) && std::memcmp(data, kKtx2Identifier, sizeof(kKtx2Identifier)) == 0)
+    {
+        return true;
+    }
+    return size >= sizeof(uint32_t) && readu32(data) == kDdsMagic;
+}
+
+TextureContainerData TextureContainer::parse(const unsigned char *data, size_t size, const std::string &sourceName)
+{
+    if (size >= sizeof(kKtx2Identifier) && std::memcmp(data, kKtx2Identifier, sizeof(kKtx2Identifier)) == 0)
+    {
+        return parseKTX2(data, size, sourceName);
+    }
+    if (size >= sizeof(uint32_t) && readu32(data) == kDdsMagic)
+    {
+        return parseDDS(data, size, sourceName);
+    }
+    throw std::runtime_error("Not a KTX2 or DDS texture container: " + sourceName);
+}
+
+FormatBlockInfo TextureContainer::getFormatBlockInfo(vk::Format format)
+{
+    FormatBlockInfo info;
+    if (!findblockinfo(format, info))
+    {
+        throw std::invalid_argument("TextureContainer: Unsupported texture format " + vk::to_string(format));
+    }
+    return info;
+}
+
+vk::Format TextureContainer::withColorSpace(vk::Format format, bool srgb)
+{
+    for (const auto &pair : kColorSpacePairs)
+    {
+        if (format == pair.first || format == pair.second)
+        {
+            return srgb ? pair.second : pair.first;
+        }
+    }
+    return format;
+}
+
+uint32_t TextureContainer::getFullMipCount(uint32_t width, uint32_t height)
+{
+    uint32_t levels = 1;
+    for (uint32_t extent = std::max(width, height); extent > 1; extent >>= 1)
+    {
+        ++levels;
+    }
+    return levels;
+}
+
+// ==================== 容器解析 ====================
+
+TextureContainerData TextureContainer::parseKTX2(const unsigned char *data, size_t size,
+                                                 const std::string &sourceName)
+{
+    if (size < kKtx2LevelIndexOffset)
+    {
+        throw std::runtime_error("KTX2 header is truncated: " + sourceName);
+    }
+
+    const uint32_t vkFormat = readu32(data + 12);
+    const uint32_t pixelWidth = readu32(data + 20);
+    const uint32_t pixelHeight = readu32(data + 24);
+    const uint32_t pixelDepth = readu32(data + 28);
+    const uint32_t layerCount = readu32(data + 32);
+    const uint32_t faceCount = readu32(data + 36);
+    const uint32_t levelCount = readu32(data + 40);
+    const uint32_t supercompressionScheme = readu32(data + 44);
+
+    if (vkFormat == 0 || supercompressionScheme != 0)
+    {
+        throw std::runtime_error("Supercompressed KTX2 (BasisLZ/UASTC/Zstd) needs a transcoder: " + sourceName);
+    }
+    if (pixelWidth == 0 || pixelDepth > 1 || layerCount > 1 || faceCount != 1)
+    {
+        throw std::runtime_error("Only single-layer 2D KTX2 textures are supported: " + sourceName);
+    }
+
+    TextureContainerData result;
+    result.format = static_cast<vk::Format>(vkFormat);
+    result.width = pixelWidth;
+    result.height = std::max(pixelHeight, 1u);
+    result.data = data;
+    result.dataSize = size;
+    // levelCount 为 0 表示文件只存 mip 0，由加载方生成完整 mip 链
+    result.requestsMipGeneration = (levelCount == 0);
+
+    FormatBlockInfo blockInfo;
+    if (!findblockinfo(result.format, blockInfo))
+    {
+        throw std::runtime_error("Unsupported KTX2 format " + vk::to_string(result.format) + ": " + sourceName);
+    }
+
+    const uint32_t storedLevels = std::max(levelCount, 1u);
+    if (storedLevels > getFullMipCount(result.width, result.height))
+    {
+        throw std::runtime_error("KTX2 level count exceeds the full mip chain: " + sourceName);
+    }
+    if (size < kKtx2LevelIndexOffset + storedLevels * kKtx2LevelIndexStride)
+    {
+        throw std::runtime_error("KTX2 level index is truncated: " + sourceName);
+    }
+
+    // 级别索引按 mip 0 在前排列（数据本身按从小到大的顺序存放在文件中）
+    result.levels.reserve(storedLevels);
+    for (uint32_t level = 0; level < storedLevels; ++level)
+    {
+        const unsigned char *entry = data + kKtx2LevelIndexOffset + level * kKtx2LevelIndexStride;
+        uint64_t byteOffset = readu64(entry);
+        uint64_t byteLength = readu64(entry + 8);
+
+        TextureContainerData::Level mip;
+        mip.width = std::max(result.width >> level, 1u);
+        mip.height = std::max(result.height >> level, 1u);
+        size_t expectedSize = blockInfo.getLevelSize(mip.width, mip.height);
+
+        mip.offset = static_cast<size_t>(std::min<uint64_t>(byteOffset, size));
+        mip.size = static_cast<size_t>(std::min<uint64_t>(byteLength, size));
+        checklevel(mip, size, expectedSize, sourceName);
+        mip.size = expectedSize;
+        result.levels.push_back(mip);
+    }
+
+    return result;
+}
+
+TextureContainerData TextureContainer::parseDDS(const unsigned char *data, size_t size, const std::string &sourceName)
+{
+    if (size < kDdsDataOffset || readu32(data + 4) != kDdsHeaderSize)
+    {
+        throw std::runtime_error("DDS header is truncated or invalid: " + sourceName);
+    }
+
+    const uint32_t flags = readu32(data + 8);
+    const uint32_t height = readu32(data + 12);
+    const uint32_t width = readu32(data + 16);
+    const uint32_t mipMapCount = readu32(data + 28);
+    const uint32_t pixelFlags = readu32(data + 80);
+    const uint32_t fourCC = readu32(data + 84);
+    const uint32_t rgbBitCount = readu32(data + 88);
+    const uint32_t redMask = readu32(data + 92);
+    const uint32_t greenMask = readu32(data + 96);
+    const uint32_t blueMask = readu32(data + 100);
+    const uint32_t caps2 = readu32(data + 112);
+
+    if (width == 0 || height == 0 || (caps2 & (kDdsCaps2Cubemap | kDdsCaps2Volume)) != 0)
+    {
+        throw std::runtime_error("Only 2D DDS textures are supported: " + sourceName);
+    }
+
+    TextureContainerData result;
+    result.width = width;
+    result.height = height;
+    result.data = data;
+    result.dataSize = size;
+
+    size_t dataOffset = kDdsDataOffset;
+    if (pixelFlags & kDdsPixelFourCC)
+    {
+        switch (fourCC)
+        {
+        case makefourcc('D', 'X', 'T', '1'):
+            result.format = vk::Format::eBc1RgbaUnormBlock;
+            break;
+        case makefourcc('D', 'X', 'T', '2'):
+        case makefourcc('D', 'X', 'T', '3'):
+            result.format = vk::Format::eBc2UnormBlock;
+            break;
+        case makefourcc('D', 'X', 'T', '4'):
+        case makefourcc('D', 'X', 'T', '5'):
+            result.format = vk::Format::eBc3UnormBlock;
+            break;
+        case makefourcc('A', 'T', 'I', '1'):
+        case makefourcc('B', 'C', '4', 'U'):
+            result.format = vk::Format::eBc4UnormBlock;
+            break;
+        case makefourcc('B', 'C', '4', 'S'):
+            result.format = vk::Format::eBc4SnormBlock;
+            break;
+        case makefourcc('A', 'T', 'I', '2'):
+        case makefourcc('B', 'C', '5', 'U'):
+            result.format = vk::Format::eBc5UnormBlock;
+            break;
+        case makefourcc('B', 'C', '5', 'S'):
+            result.format = vk::Format::eBc5SnormBlock;
+            break;
+        case makefourcc('D', 'X', '1', '0'): {
+            if (size < kDdsDx10DataOffset)
+            {
+                throw std::runtime_error("DDS DX10 header is truncated: " + sourceName);
+            }
+            const uint32_t dxgiFormat = readu32(data + 128);
+            const uint32_t resourceDimension = readu32(data + 132);
+            const uint32_t miscFlag = readu32(data + 136);
+            const uint32_t arraySize = readu32(data + 140);
+            if (resourceDimension != kDx10DimensionTexture2D || (miscFlag & kDx10MiscTextureCube) != 0 ||
+                arraySize > 1)
+            {
+                throw std::runtime_error("Only single-layer 2D DDS textures are supported: " + sourceName);
+            }
+            result.format = dxgitovkformat(dxgiFormat);
+            dataOffset = kDdsDx10DataOffset;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    else if ((pixelFlags & kDdsPixelRGB) && rgbBitCount == 32)
+    {
+        // 旧式非压缩 32 位格式：按通道掩码区分 RGBA / BGRA
+        if (redMask == 0x000000FF && greenMask == 0x0000FF00 && blueMask == 0x00FF0000)
+        {
+            result.format = vk::Format::eR8G8B8A8Unorm;
+        }
+        else if (redMask == 0x00FF0000 && greenMask == 0x0000FF00 && blueMask == 0x000000FF)
+        {
+            result.format = vk::Format::eB8G8R8A8Unorm;
+        }
+    }
+
+    FormatBlockInfo blockInfo;
+    if (result.format == vk::Format::eUndefined || !findblockinfo(result.format, blockInfo))
+    {
+        throw std::runtime_error("Unsupported DDS pixel format: " + sourceName);
+    }
+
+    const uint32_t levelCount = ((flags & kDdsFlagMipMapCount) && mipMapCount > 0) ? mipMapCount : 1;
+    if (levelCount > getFullMipCount(width, height))
+    {
+        throw std::runtime_error("DDS mip count exceeds the full mip chain: " + sourceName);
+    }
+
+    // DDS 的各级 mip 从 mip 0 开始紧密排列
+    result.levels.reserve(levelCount);
+    size_t offset = dataOffset;
+    for (uint32_t level = 0; level < levelCount; ++level)
+    {
+        TextureContainerData::Level mip;
+        mip.width = std::max(width >> level, 1u);
+        mip.height = std::max(height >> level, 1u);
+        mip.offset = offset;
+        mip.size = blockInfo.getLevelSize(mip.width, mip.height);
+        checklevel(mip, size, mip.size, sourceName);
+
+        offset += mip.size;
+        result.levels.push_back(mip);
+    }
+
+    return result;
+}
+
+} // namespace rendercore
@@ -0,0 +1,460 @@
+#include "TextureStreamer.hpp"
+#include "BindlessRegistry.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include "VulkanCore/public/MappedFile.hpp"
+#include "VulkanCore/public/Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace rendercore
+{
+
+namespace
+{
+
+TextureStreamer::Config sanitizeconfig(TextureStreamer::Config config)
+{
+    config.minResidentSize = std::max(config.minResidentSize, 1u);
+    config.framesInFlight = std::max(config.framesInFlight, 1u);
+    return config;
+}
+
+} // namespace
+
+// ==================== 静态工具 ====================
+
+bool TextureStreamer::isStreamable(const TextureContainerData &container)
+{
+    return container.levels.size() > 1 && !container.requestsMipGeneration && container.data != nullptr;
+}
+
+float TextureStreamer::computeScreenSize(const glm::vec3 &center, float radius, const glm::vec3 &eye, float fovY,
+                                         float viewportHeight)
+{
+    const float distance = glm::length(center - eye);
+    if (distance <= radius)
+    {
+        return viewportHeight;
+    }
+    // 距离 d 处的半个视口高度对应 d * tan(fovY / 2)，直径 2r 占视口高度的 r / (d * tan(fovY / 2))
+    return radius / (distance * std::tan(fovY * 0.5f)) * viewportHeight;
+}
+
+// ==================== 构造函数 ====================
+
+TextureStreamer::TextureStreamer(vkcore::Device &device, VmaAllocator allocator, vkcore::UploadQueue &uploadQueue,
+                                 std::shared_ptr<BindlessRegistry> bindless, const Config &config)
+    : m_device(device), m_allocator(allocator), m_uploadQueue(uploadQueue), m_bindless(std::move(bindless)),
+      m_config(sanitizeconfig(config))
+{
+    if (!m_bindless)
+    {
+        throw std::invalid_argument("TextureStreamer: bindless registry must not be null");
+    }
+}
+
+// ==================== 纹理注册 ====================
+
+void TextureStreamer::track(const std::shared_ptr<Texture> &texture, std::shared_ptr<const vkcore::MappedFile> file,
+                            const TextureContainerData &container, vk::Format format)
+{
+    if (!texture || !file)
+    {
+        throw std::invalid_argument("TextureStreamer::track: texture and file must not be null");
+    }
+    if (!isStreamable(container))
+    {
+        throw std::invalid_argument("TextureStreamer::track: container has no stored mip chain");
+    }
+
+    vk::FormatFeatureFlags features = m_device.getPhysicalDevice().getFormatProperties(format).optimalTilingFeatures;
+    if (!(features & vk::FormatFeatureFlagBits::eSampledImage))
+    {
+        throw std::runtime_error("Texture format " + vk::to_string(format) + " is not supported by the device");
+    }
+
+    StreamedTexture entry;
+    entry.texture = texture;
+    entry.file = std::move(file);
+    entry.container = container;
+    entry.format = format;
+    entry.blockInfo = TextureContainer::getFormatBlockInfo(format);
+
+    // 各级 mip 相对 mip 0 按块对齐时，任意连续 mip 范围打包进暂存区后都满足块对齐
+    for (const auto &level : container.levels)
+    {
+        const size_t delta = level.offset > container.levels.front().offset
+                                 ? level.offset - container.levels.front().offset
+                                 : container.levels.front().offset - level.offset;
+        if (delta % entry.blockInfo.blockBytes != 0)
+        {
+            throw std::runtime_error("Texture container mip level is not aligned to its block size");
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    const auto levelCount = static_cast<uint32_t>(container.levels.size());
+    entry.tailMip = levelCount - 1;
+    for (uint32_t mip = 0; mip < levelCount; ++mip)
+    {
+        const auto &level = container.levels[mip];
+        if (std::max(level.width, level.height) <= m_config.minResidentSize)
+        {
+            entry.tailMip = mip;
+            break;
+        }
+    }
+    entry.residentMip = entry.tailMip;
+    entry.requestedMip = entry.tailMip;
+    entry.lastUsedFrame = m_frame;
+
+    texture->image = createimage(entry, entry.tailMip, texture->uploadTicket);
+    m_textures[texture.get()] = std::move(entry);
+}
+
+bool TextureStreamer::isTracked(const Texture &texture) const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_textures.find(&texture) != m_textures.end();
+}
+
+// ==================== 精度请求 ====================
+
+void TextureStreamer::requestResolution(const Texture &texture, float screenPixels)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    auto it = m_textures.find(&texture);
+    if (it == m_textures.end())
+    {
+        return;
+    }
+    StreamedTexture &entry = it->second;
+
+    // 纹理边长越过屏幕尺寸一倍，所需 mip 就低一级
+    const auto &top = entry.container.levels.front();
+    const auto size = static_cast<float>(std::max(top.width, top.height));
+    uint32_t mip = entry.tailMip;
+    if (screenPixels >= size)
+    {
+        mip = 0;
+    }
+    else if (screenPixels > 0.0f)
+    {
+        mip = std::min(static_cast<uint32_t>(std::floor(std::log2(size / screenPixels))), entry.tailMip);
+    }
+
+    if (entry.lastUsedFrame != m_frame)
+    {
+        entry.requestedMip = mip;
+        entry.lastUsedFrame = m_frame;
+    }
+    else
+    {
+        entry.requestedMip = std::min(entry.requestedMip, mip);
+    }
+}
+
+void TextureStreamer::requestMaterial(const Material &material, float screenPixels)
+{
+    for (const auto *texture : {&material.baseColorTexture, &material.metallicTexture, &material.roughnessTexture,
+                                &material.normalTexture, &material.occlusionTexture, &material.emissiveTexture})
+    {
+        if (*texture)
+        {
+            requestResolution(**texture, screenPixels);
+        }
+    }
+}
+
+// ==================== 每帧更新 ====================
+
+std::vector<std::shared_ptr<Texture>> TextureStreamer::update()
+{
+    QTR_PROFILE_SCOPE("TextureStreamer::update");
+    std::vector<std::shared_ptr<Texture>> swapped;
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    // 替换时录制的帧都已完成后，旧图像才释放
+    m_retiredImages.erase(std::remove_if(m_retiredImages.begin(), m_retiredImages.end(),
+                                         [this](const RetiredImage &retired) {
+                                             return m_frame >= retired.frame + m_config.framesInFlight;
+                                         }),
+                          m_retiredImages.end());
+
+    Stats stats;
+    stats.budgetBytes = m_config.budgetBytes;
+
+    std::vector<StreamedTexture *> candidates;
+    candidates.reserve(m_textures.size());
+    for (auto it = m_textures.begin(); it != m_textures.end();)
+    {
+        std::shared_ptr<Texture> texture = it->second.texture.lock();
+        if (!texture)
+        {
+            // 上传中的新图像由上传队列持有到批次完成
+            it = m_textures.erase(it);
+            continue;
+        }
+
+        StreamedTexture &entry = it->second;
+        if (entry.pendingImage && completeresidency(entry, texture))
+        {
+            swapped.push_back(std::move(texture));
+        }
+
+        stats.residentBytes += levelbytes(entry, entry.residentMip);
+        stats.requestedBytes += levelbytes(entry, targetmip(entry));
+        if (entry.pendingImage)
+        {
+            ++stats.pendingCount;
+            stats.pendingBytes += levelbytes(entry, entry.pendingMip);
+        }
+        else
+        {
+            candidates.push_back(&entry);
+        }
+        ++it;
+    }
+    stats.textureCount = static_cast<uint32_t>(m_textures.size());
+
+    // 需要腾出的字节数：压力回调的请求与超出配置预算的部分取大者
+    vk::DeviceSize usage = stats.residentBytes + stats.pendingBytes;
+    vk::DeviceSize bytesToFree = m_pressureBytes;
+    if (m_config.budgetBytes > 0 && usage > m_config.budgetBytes)
+    {
+        bytesToFree = std::max(bytesToFree, usage - m_config.budgetBytes);
+    }
+    m_pressureBytes = 0;
+
+    // 淘汰按 LRU 顺序：长时间未被请求的纹理降回尾部 mip；需要腾出空间时，先把精度超过请求的纹理降到所需精度，
+    // 再把本帧未被请求的纹理逐级降低（降精度同样是新建较小的图像，旧图像在在途帧结束后才释放）
+    std::sort(candidates.begin(), candidates.end(), [](const StreamedTexture *a, const StreamedTexture *b) {
+        return a->lastUsedFrame < b->lastUsedFrame;
+    });
+    for (StreamedTexture *entry : candidates)
+    {
+        uint32_t evictMip = entry->residentMip;
+        if (entry->lastUsedFrame + m_config.evictAfterFrames < m_frame)
+        {
+            evictMip = entry->tailMip;
+        }
+        else if (bytesToFree > 0)
+        {
+            evictMip = std::max(entry->residentMip, targetmip(*entry));
+            if (evictMip == entry->residentMip && entry->lastUsedFrame < m_frame)
+            {
+                evictMip = std::min(entry->residentMip + 1, entry->tailMip);
+            }
+        }
+        if (evictMip <= entry->residentMip)
+        {
+            continue;
+        }
+
+        const vk::DeviceSize freed = levelbytes(*entry, entry->residentMip) - levelbytes(*entry, evictMip);
+        bytesToFree -= std::min(bytesToFree, freed);
+        beginresidency(*entry, evictMip);
+        ++stats.evictedCount;
+        ++stats.pendingCount;
+        stats.pendingBytes += levelbytes(*entry, evictMip);
+        usage += levelbytes(*entry, evictMip);
+    }
+
+    // 升精度：压力冷却期内或仍未腾出足够空间时暂停；新旧图像在交换前同时存在，按新图像的完整大小计入预算
+    if (m_frame >= m_pressureUntilFrame && bytesToFree == 0)
+    {
+        std::vector<StreamedTexture *> streamIn;
+        for (StreamedTexture *entry : candidates)
+        {
+            if (!entry->pendingImage && targetmip(*entry) < entry->residentMip)
+            {
+                streamIn.push_back(entry);
+            }
+        }
+
+        // 最模糊（与所需精度相差最多级）的纹理优先，其次是最近使用的
+        std::sort(streamIn.begin(), streamIn.end(), [this](const StreamedTexture *a, const StreamedTexture *b) {
+            const uint32_t deficitA = a->residentMip - targetmip(*a);
+            const uint32_t deficitB = b->residentMip - targetmip(*b);
+            return deficitA != deficitB ? deficitA > deficitB : a->lastUsedFrame > b->lastUsedFrame;
+        });
+
+        vk::DeviceSize uploadBytes = 0;
+        for (StreamedTexture *entry : streamIn)
+        {
+            const uint32_t mip = targetmip(*entry);
+            const vk::DeviceSize bytes = levelbytes(*entry, mip);
+            if (m_config.budgetBytes > 0 && usage + bytes > m_config.budgetBytes)
+            {
+                continue;
+            }
+            // 每帧至少放行一个，单个纹理大于上限时也能完成流送
+            if (uploadBytes > 0 && uploadBytes + bytes > m_config.maxUploadBytesPerFrame)
+            {
+                break;
+            }
+
+            beginresidency(*entry, mip);
+            uploadBytes += bytes;
+            usage += bytes;
+            ++stats.streamedInCount;
+            ++stats.pendingCount;
+            stats.pendingBytes += bytes;
+        }
+    }
+
+    m_stats = stats;
+    ++m_frame;
+    return swapped;
+}
+
+void TextureStreamer::handleMemoryPressure(const vkcore::MemoryPressure &pressure)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_pressureBytes = std::max(m_pressureBytes, pressure.bytesToFree);
+    m_pressureUntilFrame = m_frame + m_config.pressureCooldownFrames;
+}
+
+// ==================== 配置与统计 ====================
+
+void TextureStreamer::setConfig(const Config &config)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_config = sanitizeconfig(config);
+}
+
+TextureStreamer::Config TextureStreamer::getConfig() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_config;
+}
+
+TextureStreamer::Stats TextureStreamer::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_stats;
+}
+
+// ==================== 内部实现 ====================
+
+vk::DeviceSize TextureStreamer::levelbytes(const StreamedTexture &entry, uint32_t baseMip) const
+{
+    vk::DeviceSize bytes = 0;
+    for (size_t mip = baseMip; mip < entry.container.levels.size(); ++mip)
+    {
+        bytes += entry.container.levels[mip].size;
+    }
+    return bytes;
+}
+
+std::shared_ptr<vkcore::Image> TextureStreamer::createimage(const StreamedTexture &entry, uint32_t baseMip,
+                                                            vkcore::UploadTicket &ticket)
+{
+    const auto &levels = entry.container.levels;
+    const auto levelCount = static_cast<uint32_t>(levels.size());
+
+    vkcore::ImageDesc imageDesc = {};
+    imageDesc.imageType = vk::ImageType::e2D;
+    imageDesc.format = entry.format;
+    imageDesc.extent = vk::Extent3D{levels[baseMip].width, levels[baseMip].height, 1};
+    imageDesc.mipLevels = levelCount - baseMip;
+    imageDesc.arrayLayers = 1;
+    imageDesc.samples = vk::SampleCountFlagBits::e1;
+    imageDesc.tiling = vk::ImageTiling::eOptimal;
+    imageDesc.usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
+    imageDesc.memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+    imageDesc.category = vkcore::MemoryCategory::Texture;
+
+    auto image = std::make_shared<vkcore::Image>("texture", m_device, m_allocator, imageDesc);
+
+    // 常驻 mip 在源文件中连续存放（KTX2 从小到大，DDS 从大到小），作为一段数据拷入暂存区
+    size_t spanBegin = levels[baseMip].offset;
+    size_t spanEnd = 0;
+    for (uint32_t mip = baseMip; mip < levelCount; ++mip)
+    {
+        spanBegin = std::min(spanBegin, levels[mip].offset);
+        spanEnd = std::max(spanEnd, levels[mip].offset + levels[mip].size);
+    }
+
+    std::vector<vk::BufferImageCopy> regions;
+    regions.reserve(levelCount - baseMip);
+    for (uint32_t mip = baseMip; mip < levelCount; ++mip)
+    {
+        vk::BufferImageCopy region = {};
+        region.bufferOffset = levels[mip].offset - spanBegin;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+        region.imageSubresource.mipLevel = mip - baseMip;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = vk::Offset3D{0, 0, 0};
+        region.imageExtent = vk::Extent3D{levels[mip].width, levels[mip].height, 1};
+        regions.push_back(region);
+    }
+
+    ticket = m_uploadQueue.uploadImage(image, entry.container.data + spanBegin, spanEnd - spanBegin, regions,
+                                       entry.blockInfo.blockBytes, vk::ImageLayout::eShaderReadOnlyOptimal, false);
+    return image;
+}
+
+void TextureStreamer::beginresidency(StreamedTexture &entry, uint32_t baseMip)
+{
+    entry.pendingImage = createimage(entry, baseMip, entry.pendingTicket);
+    entry.pendingMip = baseMip;
+}
+
+bool TextureStreamer::completeresidency(StreamedTexture &entry, const std::shared_ptr<Texture> &texture)
+{
+    if (!m_uploadQueue.isComplete(entry.pendingTicket))
+    {
+        return false;
+    }
+
+    std::shared_ptr<vkcore::Image> previousImage = texture->image;
+    texture->image = entry.pendingImage;
+
+    // 在途帧仍通过旧槽位采样旧图像（UPDATE_UNUSED_WHILE_PENDING 不允许改写使用中的描述符），
+    // 所以新图像写入新槽位，旧槽位随 previous 析构归还，经过 framesInFlight 帧后才复用
+    if (texture->bindless.isValid())
+    {
+        BindlessSlot previous;
+        previous.index = texture->bindless.index;
+        previous.type = texture->bindless.type;
+        previous.registry = texture->bindless.registry;
+        texture->bindless.index = BindlessSlot::kInvalidIndex;
+        try
+        {
+            BindlessRegistry::registerTexture(m_bindless, *texture);
+        }
+        catch (const std::exception &)
+        {
+            // 纹理数组已满：保留旧图像与旧槽位，放弃这次替换
+            texture->bindless.index = previous.index;
+            previous.index = BindlessSlot::kInvalidIndex;
+            texture->image = std::move(previousImage);
+            entry.pendingImage.reset();
+            return false;
+        }
+    }
+
+    m_retiredImages.push_back({std::move(previousImage), m_frame});
+    entry.pendingImage.reset();
+    entry.residentMip = entry.pendingMip;
+    texture->uploadTicket = entry.pendingTicket;
+    return true;
+}
+
+uint32_t TextureStreamer::targetmip(const StreamedTexture &entry) const
+{
+    if (entry.lastUsedFrame + m_config.evictAfterFrames < m_frame)
+    {
+        return entry.tailMip;
+    }
+    return std::min(entry.requestedMip, entry.tailMip);
+}
+
+} // namespace rendercore
@@ -0,0 +1,95 @@
+#include "VertexLayout.hpp"
+#include "ResourceType.hpp"
+#include <iterator>
+#include <stdexcept>
+
+namespace rendercore
+{
+
+namespace
+{
+
+static_assert(StandardVertexLayout::kStride == sizeof(Vertex), "StandardVertexLayout must match Vertex");
+static_assert(StandardVertexLayout::kAttributeDescriptions[0].offset == offsetof(Vertex, color) &&
+                  StandardVertexLayout::kAttributeDescriptions[1].offset == offsetof(Vertex, position) &&
+                  StandardVertexLayout::kAttributeDescriptions[2].offset == offsetof(Vertex, normal) &&
+                  StandardVertexLayout::kAttributeDescriptions[3].offset == offsetof(Vertex, texCoord),
+              "StandardVertexLayout offsets must match Vertex");
+
+// 颜色与白色的差不超过 RGBA8 的半个量化步长时视为白色
+constexpr float kWhiteTolerance = 0.5f / 255.0f;
+
+template <typename Layout>
+constexpr VertexFormatInfo makeinfo(const char *name)
+{
+    return VertexFormatInfo{name, Layout::kStride, Layout::getInputState()};
+}
+
+constexpr VertexFormatInfo kFormatInfos[] = {
+    makeinfo<StandardVertexLayout>("Standard"),
+    makeinfo<CompactVertexLayout>("Compact"),
+    makeinfo<CompactNoColorVertexLayout>("CompactNoColor"),
+};
+static_assert(std::size(kFormatInfos) == static_cast<size_t>(VertexFormat::Count));
+
+template <typename Layout>
+std::vector<std::byte> encodeas(const Vertex *vertices, size_t count)
+{
+    std::vector<std::byte> packed(count * Layout::kStride);
+    Layout::encode(vertices, count, packed.data());
+    return packed;
+}
+
+} // namespace
+
+const VertexFormatInfo &VertexLayouts::getInfo(VertexFormat format)
+{
+    const size_t index = static_cast<size_t>(format);
+    if (index >= std::size(kFormatInfos))
+    {
+        throw std::invalid_argument("VertexLayouts::getInfo: invalid vertex format");
+    }
+    return kFormatInfos[index];
+}
+
+VertexFormat VertexLayouts::select(const Vertex *vertices, size_t count)
+{
+    bool hasColor = false;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Vertex &vertex = vertices[i];
+
+        // half 纹理坐标在 ±kMaxHalfTexCoord 之外精度不足，HDR 颜色无法放进 RGBA8
+        if (!(std::abs(vertex.texCoord.x) <= kMaxHalfTexCoord && std::abs(vertex.texCoord.y) <= kMaxHalfTexCoord))
+        {
+            return VertexFormat::Standard;
+        }
+        for (int c = 0; c < 4; ++c)
+        {
+            const float value = vertex.color[c];
+            if (!(value >= 0.0f && value <= 1.0f))
+            {
+                return VertexFormat::Standard;
+            }
+            hasColor = hasColor || value < 1.0f - kWhiteTolerance;
+        }
+    }
+    return hasColor ? VertexFormat::Compact : VertexFormat::CompactNoColor;
+}
+
+std::vector<std::byte> VertexLayouts::encode(VertexFormat format, const Vertex *vertices, size_t count)
+{
+    switch (format)
+    {
+    case VertexFormat::Standard:
+        return encodeas<StandardVertexLayout>(vertices, count);
+    case VertexFormat::Compact:
+        return encodeas<CompactVertexLayout>(vertices, count);
+    case VertexFormat::CompactNoColor:
+        return encodeas<CompactNoColorVertexLayout>(vertices, count);
+    default:
+        throw std::invalid_argument("VertexLayouts::encode: invalid vertex format");
+    }
+}
+
+} // namespace rendercore
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "ResourceType.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include "VulkanCore/public/VKResource.hpp"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <vma/vk_mem_alloc.h>
+
+namespace rendercore
+{
+
+/**
+ * @struct BindlessMaterialData
+ * @brief 材质参数 SSBO 中的一项（std430 布局，64 字节）
+ * @details 着色器以 push constant 中的材质 ID 读取 materials[materialIndex]，
+ *          纹理字段是全局纹理数组的下标（BindlessSlot::kInvalidIndex 表示没有该纹理），
+ *          采样时需要 nonuniformEXT：textures[nonuniformEXT(material.baseColorTexture)]
+ */
+struct BindlessMaterialData
+{
+    glm::vec4 baseColorFactor;
+    glm::vec3 emissiveFactor;
+    float metallicFactor;
+    float roughnessFactor;
+    float normalScale;
+    float alphaCutoff;
+    uint32_t baseColorTexture;
+    uint32_t metallicTexture;
+    uint32_t roughnessTexture;
+    uint32_t normalTexture;
+    uint32_t occlusionTexture;
+    uint32_t emissiveTexture;
+    uint32_t padding[3]; ///< 对齐到 16 字节边界
+};
+static_assert(sizeof(BindlessMaterialData) == 64, "BindlessMaterialData must match the std430 layout in shaders");
+
+/**
+ * @class BindlessRegistry
+ * @brief 全局 bindless 描述符集：一个纹理数组 + 一个材质参数 SSBO
+ * @details 整个场景只有一个材质描述符集，绘制之间不再切换材质集，只推送 4 字节的材质 ID：
+ *          - binding 0：材质参数 SSBO（BindlessMaterialData[]，主机可见、常驻映射）；
+ *          - binding 1：combined image sampler 数组（PARTIALLY_BOUND | UPDATE_AFTER_BIND |
+ *            UPDATE_UNUSED_WHILE_PENDING，可变数量），未写入的槽位不会被访问。
+ *
+ *          纹理与材质的槽位由 ResourceManager 在创建时分配（registerTexture()/registerMaterial()），
+ *          对象析构时由 BindlessSlot 归还；归还的槽位要经过 framesInFlight 次 advanceFrame() 才会复用，
+ *          保证在途帧录制的索引不会指向新资源。
+ *
+ * @note 所有接口线程安全（纹理在解码线程上创建）；描述符写入在锁内进行，与录制中的绑定互不影响
+ */
+class BindlessRegistry
+{
+  public:
+    static constexpr uint32_t kMaterialBinding = 0; ///< 材质参数 SSBO
+    static constexpr uint32_t kTextureBinding = 1;  ///< 纹理数组（可变数量的绑定必须是最后一个）
+
+    /**
+     * @struct Config
+     * @brief 容量配置（纹理容量会被限制在设备的 UPDATE_AFTER_BIND 上限内）
+     */
+    struct Config
+    {
+        uint32_t maxTextures = 16384; ///< 纹理数组长度
+        uint32_t maxMaterials = 4096; ///< 材质参数 SSBO 的项数
+        uint32_t framesInFlight = 2;  ///< 归还的槽位延迟复用的帧数
+    };
+
+    /**
+     * @struct Stats
+     * @brief 槽位使用统计
+     */
+    struct Stats
+    {
+        uint32_t textureCount{0};     ///< 已占用的纹理槽位
+        uint32_t textureCapacity{0};  ///< 纹理数组长度
+        uint32_t materialCount{0};    ///< 已占用的材质槽位
+        uint32_t materialCapacity{0}; ///< 材质参数 SSBO 的项数
+        uint32_t pendingFrees{0};     ///< 等待复用的槽位
+    };
+
+    /**
+     * @brief 返回 bindless 所需的 Vulkan 1.2 描述符索引特性（填入 Device::Config::optional_vulkan1_2_features）
+     */
+    static std::vector<std::string> getRequiredFeatures();
+
+    /**
+     * @brief 设备是否启用了 getRequiredFeatures() 中的全部特性
+     */
+    static bool isSupported(const vkcore::Device &device);
+
+    /**
+     * @brief 获取材质 ID 的 push constant 范围（offset 0，uint32，顶点与片段着色器可见）
+     * @details 使用全局集的管线布局需要包含该范围，RenderQueue 在材质切换时推送材质 ID
+     */
+    static vk::PushConstantRange getMaterialPushConstantRange();
+
+    /**
+     * @brief 构造函数，创建描述符集布局、UPDATE_AFTER_BIND 描述符池、全局集与材质参数 SSBO
+     * @param device 逻辑设备（必须满足 isSupported()）
+     * @param allocator VMA 分配器
+     * @param config 容量配置（省略时使用默认 Config）
+     * @throws std::runtime_error 如果设备不支持或创建失败
+     */
+    BindlessRegistry(vkcore::Device &device, VmaAllocator allocator);
+    BindlessRegistry(vkcore::Device &device, VmaAllocator allocator, const Config &config);
+    ~BindlessRegistry();
+
+    /** 禁用拷贝与移动（槽位持有指向本对象的弱引用） */
+    BindlessRegistry(const BindlessRegistry &) = delete;
+    BindlessRegistry &operator=(const BindlessRegistry &) = delete;
+
+    /**
+     * @brief 为纹理分配槽位并写入描述符
+     * @param registry 本对象的 shared_ptr（写入 Texture::bindless，纹理析构时归还槽位）
+     * @param texture 已创建图像与采样器的纹理（上传可以仍在进行，使用前照常等待上传票据）
+     * @throws std::invalid_argument 如果 registry 为空或纹理没有图像/采样器
+     * @throws std::runtime_error 如果纹理数组已满
+     */
+    static void registerTexture(const std::shared_ptr<BindlessRegistry> &registry, Texture &texture);
+
+    /**
+     * @brief 为材质分配参数槽位，写入参数并把 Material::descriptorSet 设为全局集
+     * @param registry 本对象的 shared_ptr（写入 Material::bindless，材质析构时归还槽位）
+     * @param material 纹理已解析的材质
+     * @throws std::invalid_argument 如果 registry 为空
+     * @throws std::runtime_error 如果材质参数 SSBO 已满
+     */
+    static void registerMaterial(const std::shared_ptr<BindlessRegistry> &registry, Material &material);
+
+    /**
+     * @brief 重新写入材质参数（材质因子或纹理修改后调用）
+     * @warning 在途帧会立即看到新参数
+     */
+    void updateMaterial(const Material &material);
+
+    /**
+     * @brief 归还槽位（由 BindlessSlot 析构函数调用）
+     */
+    void release(BindlessSlotType type, uint32_t index);
+
+    /**
+     * @brief 推进帧计数，回收已经过 framesInFlight 帧的槽位
+     * @details 每帧在等待该帧的栅栏之后调用一次
+     */
+    void advanceFrame();
+
+    /**
+     * @brief 获取全局集布局（替代 ResourceManager 的逐材质布局）
+     */
+    vk::DescriptorSetLayout getSetLayout() const
+    {
+        return m_setLayout;
+    }
+
+    /**
+     * @brief 获取全局描述符集
+     */
+    vk::DescriptorSet getSet() const
+    {
+        return m_set;
+    }
+
+    /**
+     * @brief 获取槽位使用统计
+     */
+    Stats getStats() const;
+
+  private:
+    struct SlotList
+    {
+        uint32_t capacity{0};
+        uint32_t next{0};           ///< 从未使用过的下一个槽位
+        std::vector<uint32_t> free; ///< 可以立即复用的槽位
+        uint32_t used{0};
+    };
+
+    struct PendingFree
+    {
+        BindlessSlotType type;
+        uint32_t index;
+        uint64_t frame; ///< 归还时的帧计数
+    };
+
+    static uint32_t allocateslot(SlotList &slots);
+    void writetexture(uint32_t index, const Texture &texture);
+    void writematerial(uint32_t index, const Material &material);
+
+  private:
+    vkcore::Device &m_device;
+    VmaAllocator m_allocator;
+    uint32_t m_framesInFlight;
+
+    vk::DescriptorSetLayout m_setLayout;
+    vk::DescriptorPool m_pool;
+    vk::DescriptorSet m_set;
+    std::unique_ptr<vkcore::Buffer> m_materialBuffer; ///< BindlessMaterialData[]（常驻映射）
+    BindlessMaterialData *m_materialData{nullptr};
+
+    SlotList m_textures;
+    SlotList m_materials;
+    std::vector<PendingFree> m_pendingFrees;
+    uint64_t m_frame{0};
+
+    mutable std::mutex m_mtx;
+};
+
+} // namespace rendercore
@@ -0,0 +1,148 @@
+/**
+ * @file CookedMesh.hpp
+ * @brief 烘焙网格缓存（二进制格式）
+ * @details 首次加载 OBJ/STL 后把合并好的顶点、索引与子网格表写成对齐、带版本号的二进制文件。
+ *          之后的加载直接映射该文件，顶点与索引从映射内存原样拷入上传暂存区，
+ *          不再做任何逐顶点的解析或合并工作。
+ *
+ *          文件布局（所有段按 16 字节对齐，小端）：
+ *          [CookedMeshHeader][Vertex x vertexCount][uint32_t x indexCount][CookedSubmesh x submeshCount]
+ *          [CookedLod x lodCount]
+ *          索引段依次存放完整网格与各级 LOD 的索引，LOD 表给出各级在索引段中的范围。
+ */
+
+#pragma once
+
+#include "ResourceType.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+// 前向声明
+namespace vkcore
+{
+class MappedFile;
+} // namespace vkcore
+
+namespace rendercore
+{
+
+struct MeshData;
+
+/**
+ * @struct CookedMeshHeader
+ * @brief 烘焙文件头
+ */
+struct CookedMeshHeader
+{
+    char magic[4];            ///< "QTMC"
+    uint32_t version;         ///< 格式版本（kVersion）
+    uint32_t vertexStride;    ///< sizeof(Vertex)，布局改变时旧缓存自动失效
+    uint32_t submeshCount;    ///< 子网格数量
+    uint64_t sourceHash;      ///< 源文件路径哈希（防止缓存文件名冲突）
+    uint64_t sourceSize;      ///< 源文件大小
+    int64_t sourceMtime;      ///< 源文件修改时间（file_time_type 计数）
+    uint64_t vertexCount;     ///< 顶点数量
+    uint64_t indexCount;      ///< 索引数量
+    uint64_t vertexOffset;    ///< 顶点段偏移
+    uint64_t indexOffset;     ///< 索引段偏移
+    uint64_t submeshOffset;   ///< 子网格表偏移
+    uint32_t lodCount;        ///< LOD 表项数（0 表示没有 LOD 链）
+    uint32_t lodSettingsHash; ///< 生成 LOD 时的参数哈希（MeshSimplifier::hashSettings）
+    uint64_t lodOffset;       ///< LOD 表偏移
+};
+
+/**
+ * @struct CookedSubmesh
+ * @brief 子网格表项（名称定长，整张表可以直接映射）
+ */
+struct CookedSubmesh
+{
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    uint32_t firstVertex;
+    uint32_t vertexCount;
+    char name[48]; ///< 以 '\0' 结尾，超长时截断
+};
+
+/**
+ * @struct CookedLod
+ * @brief LOD 表项
+ */
+struct CookedLod
+{
+    uint32_t firstIndex; ///< 在索引段中的起始索引
+    uint32_t indexCount; ///< 索引数量
+    float error;         ///< 以包围盒半对角线为单位的误差
+    uint32_t reserved;   ///< 保持 16 字节
+};
+
+/**
+ * @class CookedMesh
+ * @brief 烘焙网格的读写工具（无状态，线程安全）
+ *
+ * @example
+ * @code
+ * auto cookedPath = rendercore::CookedMesh::getCookedPath(cacheDir, sourcePath);
+ * vkcore::MappedFile file(cookedPath);
+ * if (auto view = rendercore::CookedMesh::open(file, sourcePath))
+ * {
+ *     upload(view->vertices, view->vertexCount, view->indices, view->indexCount);
+ * }
+ * @endcode
+ */
+class CookedMesh
+{
+  public:
+    static constexpr uint32_t kVersion = 3; ///< 修改文件布局或导入处理（焊接、优化、简化）时递增
+
+    /**
+     * @struct View
+     * @brief 映射文件内的只读视图（生命周期不超过对应的 MappedFile）
+     */
+    struct View
+    {
+        const Vertex *vertices = nullptr;
+        uint64_t vertexCount = 0;
+        const uint32_t *indices = nullptr;
+        uint64_t indexCount = 0; ///< 索引段总数（含各级 LOD）
+        std::vector<Submesh> submeshes;
+        std::vector<MeshLod> lods;
+    };
+
+    /**
+     * @brief 计算源文件对应的缓存文件路径
+     * @param cacheDirectory 缓存目录
+     * @param sourcePath 源模型路径
+     * @return <cacheDirectory>/<stem>_<路径哈希>.qtmesh
+     */
+    static std::filesystem::path getCookedPath(const std::filesystem::path &cacheDirectory,
+                                               const std::filesystem::path &sourcePath);
+
+    /**
+     * @brief 校验并打开已映射的烘焙文件
+     * @param file 烘焙文件的映射
+     * @param sourcePath 源模型路径（校验大小、修改时间与路径哈希）
+     * @param lodSettingsHash 当前 LOD 生成参数的哈希（与烘焙时不同则视为过期）
+     * @return 校验通过时返回视图，否则返回空（缓存过期或损坏，应重新烘焙）
+     */
+    static std::optional<View> open(const vkcore::MappedFile &file, const std::filesystem::path &sourcePath,
+                                    uint32_t lodSettingsHash = 0);
+
+    /**
+     * @brief 把合并后的网格写入烘焙文件（先写临时文件再重命名，读者不会看到半个文件）
+     * @param cookedPath 缓存文件路径
+     * @param sourcePath 源模型路径
+     * @param meshData 合并后的网格（索引已追加各级 LOD）
+     * @param submeshes 子网格表
+     * @param lods LOD 表（可为空）
+     * @param lodSettingsHash 生成 LOD 时的参数哈希
+     * @return 是否写入成功（失败不影响加载，只是下次仍需解析源文件）
+     */
+    static bool write(const std::filesystem::path &cookedPath, const std::filesystem::path &sourcePath,
+                      const MeshData &meshData, const std::vector<Submesh> &submeshes,
+                      const std::vector<MeshLod> &lods = {}, uint32_t lodSettingsHash = 0);
+};
+
+} // namespace rendercore
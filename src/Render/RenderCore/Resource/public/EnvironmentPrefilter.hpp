@@ -0,0 +1,217 @@
+/**
+ * @file EnvironmentPrefilter.hpp
+ * @brief 环境贴图的一次性 GPU 预过滤与磁盘缓存
+ * @details 由等距柱状投影（equirect）HDR 纹理生成基于图像的光照所需的两张立方体贴图：
+ *          - 镜面：GGX 预过滤，mip i 对应粗糙度 i / (mipCount - 1)，mip 0 为源的镜面反射；
+ *          - 辐照度：余弦卷积（已除以 pi，着色时直接乘以 albedo）。
+ *          计算在图形队列上一次提交并等待完成（environment_prefilter.comp）：equirect 先重采样为带完整 mip 链的
+ *          中间立方体，两张结果再以滤波重要性采样从中读取。结果可以在同一次提交中回读，写入缓存文件；
+ *          之后的加载映射缓存文件并原样上传全部面与 mip，不再解码 8K 源图，也不需要着色器。
+ *
+ *          缓存文件布局（小端，各段按 16 字节对齐）：
+ *          [EnvironmentCacheHeader][镜面：mip 0 的 6 面 ... mip N-1 的 6 面][辐照度的 6 面]
+ *          像素为 R16G16B16A16_SFLOAT，每面的行紧密排列（与 getCopyRegions() 的区域一致）。
+ */
+
+#pragma once
+
+#include "VulkanCore/public/Descriptor.hpp"
+#include "VulkanCore/public/Pipeline.hpp"
+#include "VulkanCore/public/VKResource.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// 前向声明
+namespace vkcore
+{
+class CommandPoolManager;
+class MappedFile;
+class SamplerCache;
+} // namespace vkcore
+
+namespace rendercore
+{
+
+/**
+ * @struct EnvironmentCacheHeader
+ * @brief 预过滤缓存的文件头
+ */
+struct EnvironmentCacheHeader
+{
+    char magic[4];             ///< "QTEV"
+    uint32_t version;          ///< 格式与滤波算法版本（EnvironmentPrefilter::kVersion）
+    uint32_t specularSize;     ///< 镜面立方体的边长
+    uint32_t specularMipCount; ///< 镜面立方体的 mip 级数
+    uint32_t irradianceSize;   ///< 辐照度立方体的边长
+    uint32_t sampleCount;      ///< 每个纹素的样本数
+    uint64_t sourceHash;       ///< 源文件路径哈希（防止缓存文件名冲突）
+    uint64_t sourceSize;       ///< 源文件大小
+    int64_t sourceMtime;       ///< 源文件修改时间（file_time_type 计数）
+    uint64_t specularOffset;   ///< 镜面段偏移
+    uint64_t specularBytes;    ///< 镜面段字节数
+    uint64_t irradianceOffset; ///< 辐照度段偏移
+    uint64_t irradianceBytes;  ///< 辐照度段字节数
+};
+
+/**
+ * @class EnvironmentPrefilter
+ * @brief 预过滤计算管线与缓存文件的读写
+ *
+ * @example
+ * @code
+ * rendercore::EnvironmentPrefilter prefilter(device, allocator, layoutCache, samplerCache,
+ *                                            shaderManager.getShaderModule("environment_prefilter.comp"));
+ * std::vector<std::byte> cacheData;
+ * auto result = prefilter.run(commands, *equirect->image, equirect->sampler, {}, &cacheData);
+ * rendercore::EnvironmentPrefilter::writeCache(cachePath, sourcePath, {}, cacheData);
+ * @endcode
+ */
+class EnvironmentPrefilter
+{
+  public:
+    static constexpr uint32_t kVersion = 1; ///< 修改文件布局或滤波算法时递增
+    static constexpr vk::Format kFormat = vk::Format::eR16G16B16A16Sfloat;
+    static constexpr uint32_t kPixelBytes = 8;
+    /** 工作组边长，需与 environment_prefilter.comp 的 local_size_x/y 一致 */
+    static constexpr uint32_t kWorkgroupSize = 8;
+
+    /**
+     * @struct Settings
+     * @brief 输出尺寸与采样质量（参与缓存校验，任一项改变时旧缓存失效）
+     */
+    struct Settings
+    {
+        uint32_t specularSize = 512;     ///< 镜面立方体边长（2 的幂）
+        uint32_t specularMipCount = 6;   ///< 镜面 mip 级数（粗糙度 0 到 1 均匀分布，不超过完整 mip 链）
+        uint32_t irradianceSize = 32;    ///< 辐照度立方体边长
+        uint32_t sampleCount = 1024;     ///< 每个纹素的样本数
+    };
+
+    /**
+     * @struct Result
+     * @brief 预过滤结果（两张图像都处于 eShaderReadOnlyOptimal）
+     */
+    struct Result
+    {
+        std::shared_ptr<vkcore::Image> specular;
+        std::shared_ptr<vkcore::Image> irradiance;
+    };
+
+    /**
+     * @struct CacheView
+     * @brief 映射的缓存文件内两个段的只读视图（生命周期不超过对应的 MappedFile）
+     */
+    struct CacheView
+    {
+        const std::byte *specular = nullptr;
+        size_t specularBytes = 0;
+        const std::byte *irradiance = nullptr;
+        size_t irradianceBytes = 0;
+    };
+
+    /**
+     * @brief 构造函数，创建计算管线
+     * @param device 逻辑设备
+     * @param allocator VMA 分配器
+     * @param layoutCache 描述符布局缓存
+     * @param samplerCache 采样器缓存（中间立方体的线性钳制采样器）
+     * @param shader environment_prefilter.comp 编译得到的计算着色器
+     * @throws std::invalid_argument 如果着色器为空
+     * @throws std::runtime_error 如果设备不支持 R16G16B16A16_SFLOAT 的存储图像或 blit
+     */
+    EnvironmentPrefilter(vkcore::Device &device, VmaAllocator allocator, vkcore::DescriptorLayoutCache &layoutCache,
+                         vkcore::SamplerCache &samplerCache, std::shared_ptr<vkcore::ShaderModule> shader);
+    ~EnvironmentPrefilter();
+
+    /** 禁用拷贝与移动 */
+    EnvironmentPrefilter(const EnvironmentPrefilter &) = delete;
+    EnvironmentPrefilter &operator=(const EnvironmentPrefilter &) = delete;
+
+    /**
+     * @brief 在图形队列上生成镜面与辐照度立方体并等待完成
+     * @param commands 图形队列族的命令池（executeOnetime）
+     * @param equirect 源纹理（已驻留并处于 eShaderReadOnlyOptimal，带完整 mip 链时重采样不混叠）
+     * @param equirectSampler 源纹理的采样器（U 方向应为重复寻址）
+     * @param settings 输出尺寸与采样质量
+     * @param[out] cacheData 不为空时在同一次提交中回读结果，按缓存文件的段顺序（镜面段后接辐照度段）写入
+     * @return Result 两张立方体贴图
+     * @throws std::invalid_argument 如果 settings 无效
+     */
+    Result run(vkcore::CommandPoolManager &commands, const vkcore::Image &equirect, vk::Sampler equirectSampler,
+               const Settings &settings, std::vector<std::byte> *cacheData = nullptr);
+
+    /**
+     * @brief 创建一张 R16G16B16A16_SFLOAT 立方体贴图（采样 + 存储 + 传输用途）
+     */
+    static std::shared_ptr<vkcore::Image> createCubemap(const std::string &name, vkcore::Device &device,
+                                                        VmaAllocator allocator, uint32_t size, uint32_t mipCount);
+
+    /**
+     * @brief 一张立方体贴图在缓存中的拷贝区域（每级 mip 一个区域覆盖 6 层，bufferOffset 从 offset 开始紧密排列）
+     */
+    static std::vector<vk::BufferImageCopy> getCopyRegions(uint32_t size, uint32_t mipCount,
+                                                           vk::DeviceSize offset = 0);
+
+    /**
+     * @brief 一张立方体贴图的全部面与 mip 的字节数
+     */
+    static size_t getCubemapBytes(uint32_t size, uint32_t mipCount);
+
+    /**
+     * @brief 检查设置
+     * @throws std::invalid_argument 如果尺寸不是 2 的幂、mip 级数越界或样本数为 0
+     */
+    static void validate(const Settings &settings);
+
+    // ==================== 磁盘缓存 ====================
+
+    /**
+     * @brief 计算源文件对应的缓存文件路径
+     * @return <cacheDirectory>/<stem>_<路径哈希>.qtenv
+     */
+    static std::filesystem::path getCachePath(const std::filesystem::path &cacheDirectory,
+                                              const std::filesystem::path &sourcePath);
+
+    /**
+     * @brief 校验并打开已映射的缓存文件
+     * @param file 缓存文件的映射
+     * @param sourcePath 源纹理路径（校验大小、修改时间与路径哈希）
+     * @param settings 当前设置（与写入时不同则视为过期）
+     * @return 校验通过时返回视图，否则返回空（缓存过期或损坏，应重新预过滤）
+     */
+    static std::optional<CacheView> openCache(const vkcore::MappedFile &file, const std::filesystem::path &sourcePath,
+                                              const Settings &settings);
+
+    /**
+     * @brief 写入缓存文件（先写临时文件再重命名，读者不会看到半个文件）
+     * @param cachePath 缓存文件路径
+     * @param sourcePath 源纹理路径
+     * @param settings 生成时的设置
+     * @param data run() 回读的数据
+     * @return 是否写入成功（失败不影响加载，只是下次仍需预过滤）
+     */
+    static bool writeCache(const std::filesystem::path &cachePath, const std::filesystem::path &sourcePath,
+                           const Settings &settings, const std::vector<std::byte> &data);
+
+  private:
+    /**
+     * @brief 为目标的一级 mip 分配并写入描述符集（视图加入 views，提交完成后销毁）
+     */
+    vk::DescriptorSet writeset(const vkcore::Image &target, uint32_t level, vk::DescriptorImageInfo equirectInfo,
+                               vk::DescriptorImageInfo environmentInfo, std::vector<vk::ImageView> &views);
+
+  private:
+    vkcore::Device &m_device;
+    VmaAllocator m_allocator;
+    vkcore::SamplerCache &m_samplerCache;
+
+    std::unique_ptr<vkcore::Pipeline> m_pipeline;
+    vk::DescriptorSetLayout m_setLayout;
+    std::unique_ptr<vkcore::DescriptorAllocator> m_descriptorAllocator; ///< 每次 run() 之后整体重置
+};
+
+} // namespace rendercore
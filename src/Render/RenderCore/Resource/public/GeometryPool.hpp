@@ -0,0 +1,163 @@
+#pragma once
+
+#include "VertexLayout.hpp"
+#include "VulkanCore/public/TLSFAllocator.hpp"
+#include "VulkanCore/public/VKResource.hpp"
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <vma/vk_mem_alloc.h>
+
+namespace rendercore
+{
+struct Mesh;
+
+/**
+ * @class GeometryPool
+ * @brief 网格顶点/索引数据的统一大缓冲池
+ * @details 顶点与索引分别从少量大块设备本地缓冲（Arena）中以 TLSF 子分配，
+ *          网格只记录所在缓冲与偏移（Mesh::vertexOffset / Mesh::firstIndex），
+ *          同一 Arena 中的网格共享顶点/索引绑定，可合并进一次多重间接绘制。
+ *          - 顶点区间以顶点为单位、索引区间以索引（uint32）为单位分配；
+ *          - 顶点格式（VertexFormat）或索引类型（16/32 位）不同的网格放在不同的 Arena 中，
+ *            每个 Arena 的顶点/索引缓冲只有一种格式，绑定缓冲即确定顶点输入布局；
+ *          - 当前 Arena 放不下时新建一个，超过 Arena 大小的网格独占一个按需大小的 Arena；
+ *          - defragment() 把碎片化的 Arena 紧凑拷贝到新缓冲并更新网格偏移；
+ *          - 设备启用 bufferDeviceAddress 时 Arena 缓冲带 eShaderDeviceAddress 用途，
+ *            顶点拉取以 Mesh::vertexBuffer->getDeviceAddress() 读取顶点（整理后地址随缓冲改变）。
+ *
+ * @note allocate()/release() 线程安全（加载流水线在解码线程上创建网格）
+ */
+class GeometryPool
+{
+  public:
+    static constexpr uint32_t kInvalidHandle = UINT32_MAX;
+
+    /**
+     * @struct Config
+     * @brief 池配置
+     */
+    struct Config
+    {
+        vk::DeviceSize vertexArenaSize = 64ull * 1024 * 1024; ///< 每个 Arena 顶点缓冲的字节数
+        vk::DeviceSize indexArenaSize = 32ull * 1024 * 1024;  ///< 每个 Arena 索引缓冲的字节数
+    };
+
+    /**
+     * @struct Stats
+     * @brief 池的使用统计（单位：字节）
+     */
+    struct Stats
+    {
+        uint32_t arenaCount{0};
+        uint32_t meshCount{0};
+        vk::DeviceSize vertexCapacity{0};
+        vk::DeviceSize vertexUsed{0};
+        vk::DeviceSize indexCapacity{0};
+        vk::DeviceSize indexUsed{0};
+    };
+
+    /**
+     * @brief 构造函数
+     * @param device 逻辑设备
+     * @param allocator VMA 分配器
+     * @param config 池配置（省略时使用默认 Config）
+     */
+    GeometryPool(vkcore::Device &device, VmaAllocator allocator);
+    GeometryPool(vkcore::Device &device, VmaAllocator allocator, const Config &config);
+    ~GeometryPool();
+
+    /** 禁用拷贝与移动（网格持有指向本对象的弱引用） */
+    GeometryPool(const GeometryPool &) = delete;
+    GeometryPool &operator=(const GeometryPool &) = delete;
+
+    /**
+     * @brief 为网格分配顶点/索引区间
+     * @param pool 本池的 shared_ptr（写入 Mesh::geometryPool，网格析构时归还区间）
+     * @param mesh 目标网格，成功后写入 vertexBuffer/indexBuffer/vertexFormat/indexType/vertexOffset/firstIndex
+     * @param vertexCount 顶点数量
+     * @param indexCount 索引数量
+     * @param indexType 索引类型（eUint16 或 eUint32；firstIndex 以该类型的元素为单位）
+     * @param vertexFormat 顶点格式（决定顶点步长，上传的数据须已按该格式编码）
+     * @throws std::invalid_argument 如果 pool 为空、索引类型或顶点格式不受支持
+     * @throws std::runtime_error 如果无法创建新的 Arena
+     */
+    static void allocate(const std::shared_ptr<GeometryPool> &pool, Mesh &mesh, uint32_t vertexCount,
+                         uint32_t indexCount, vk::IndexType indexType = vk::IndexType::eUint32,
+                         VertexFormat vertexFormat = VertexFormat::Standard);
+
+    /**
+     * @brief 归还网格占用的区间（由 Mesh 析构函数调用）
+     * @param handle Mesh::geometryHandle
+     */
+    void release(uint32_t handle);
+
+    /**
+     * @brief 紧凑整理碎片化的 Arena
+     * @param cmd 录制拷贝命令的命令缓冲（图形或传输队列），拷贝之后插入到顶点输入/着色器读取的屏障
+     * @param threshold 碎片率阈值：1 - 最大空闲块 / 空闲总量 超过该值的 Arena 才会整理
+     * @return std::vector<std::shared_ptr<vkcore::Buffer>> 被替换的旧缓冲，必须保持存活直到 cmd 执行完毕
+     * @warning 会直接改写网格的缓冲与偏移：只能在渲染线程的帧间调用，且池中网格的上传都已完成
+     */
+    std::vector<std::shared_ptr<vkcore::Buffer>> defragment(vk::CommandBuffer cmd, float threshold = 0.25f);
+
+    /**
+     * @brief 获取使用统计
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief Arena 缓冲是否可以取设备地址（设备启用了 bufferDeviceAddress）
+     */
+    bool supportsDeviceAddress() const
+    {
+        return m_deviceAddress;
+    }
+
+  private:
+    struct Arena
+    {
+        std::shared_ptr<vkcore::Buffer> vertexBuffer;
+        std::shared_ptr<vkcore::Buffer> indexBuffer;
+        vkcore::TLSFAllocator vertices; ///< 以顶点为单位
+        vkcore::TLSFAllocator indices;  ///< 以索引为单位
+        vk::IndexType indexType;
+        VertexFormat vertexFormat;
+        uint32_t vertexStride; ///< getInfo(vertexFormat).stride
+
+        Arena(uint32_t vertexCapacity, uint32_t indexCapacity, vk::IndexType type, VertexFormat format)
+            : vertices(vertexCapacity), indices(indexCapacity), indexType(type), vertexFormat(format),
+              vertexStride(VertexLayouts::getInfo(format).stride)
+        {
+        }
+    };
+
+    struct Entry
+    {
+        Mesh *mesh{nullptr}; ///< 占用该条目的网格（空闲条目为 nullptr）
+        uint32_t arena{0};
+        vkcore::TLSFAllocator::Allocation vertices;
+        vkcore::TLSFAllocator::Allocation indices;
+    };
+
+    std::unique_ptr<Arena> createarena(uint32_t vertexCapacity, uint32_t indexCapacity, uint32_t arenaIndex,
+                                       vk::IndexType indexType, VertexFormat vertexFormat);
+    static uint32_t indexsize(vk::IndexType indexType);
+    static float fragmentation(const vkcore::TLSFAllocator &allocator);
+    static void bindmesh(Mesh &mesh, const Arena &arena, const Entry &entry);
+
+  private:
+    vkcore::Device &m_device;
+    VmaAllocator m_allocator;
+    vk::DeviceSize m_vertexArenaSize; ///< 每个 Arena 顶点缓冲的字节数（容量随顶点格式而定）
+    vk::DeviceSize m_indexArenaSize;  ///< 每个 Arena 索引缓冲的字节数（容量随索引类型而定）
+    bool m_deviceAddress{false};      ///< Arena 缓冲带 eShaderDeviceAddress 用途
+
+    std::vector<std::unique_ptr<Arena>> m_arenas;
+    std::vector<Entry> m_entries;
+    std::vector<uint32_t> m_freeEntries;
+
+    mutable std::mutex m_mtx;
+};
+
+} // namespace rendercore
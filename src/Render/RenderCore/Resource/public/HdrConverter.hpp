@@ -0,0 +1,80 @@
+/**
+ * @file HdrConverter.hpp
+ * @brief HDR 浮点像素到 GPU 采样格式的转换
+ * @details stb 把 .hdr 解码为 32 位浮点 RGBA（每像素 16 字节），直接上传既浪费显存又浪费采样带宽。
+ *          加载时转换为以下格式之一：
+ *          - R16G16B16A16_SFLOAT：每像素 8 字节，保留 alpha 与负值，精度约 3 位有效数字；
+ *          - B10G11R11_UFLOAT_PACK32：每像素 4 字节，无 alpha、无符号，适合环境贴图与光照贴图。
+ *          超出目标格式范围的值钳制到最大有限值（不产生 Inf），负值与 NaN 在无符号格式中写为 0。
+ *          half 转换按编译目标选择 F16C（8 路）、SSE2（4 路）或 NEON（4 路），其余平台回退到标量实现；
+ *          F16C 需要以 -mf16c（MSVC 为 /arch:AVX2）编译才会启用。
+ *
+ *          预先压缩的 BC6H（KTX2 / DDS）不经过这里，由 TextureContainer 解析后原样上传（每像素 1 字节）。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vulkan/vulkan.hpp>
+
+namespace rendercore
+{
+
+/**
+ * @class HdrConverter
+ * @brief 浮点 RGBA 像素的批量格式转换（无状态，线程安全）
+ *
+ * @example
+ * @code
+ * rendercore::TextureData hdr = rendercore::TextureLoader::loadHDRFromMemory(bytes, size);
+ * const size_t pixelCount = size_t(hdr.width) * hdr.height;
+ * std::vector<uint16_t> halfPixels(pixelCount * 4);
+ * rendercore::HdrConverter::convert(reinterpret_cast<const float *>(hdr.pixels), pixelCount,
+ *                                   vk::Format::eR16G16B16A16Sfloat, halfPixels.data());
+ * hdr.free();
+ * @endcode
+ */
+class HdrConverter
+{
+  public:
+    /**
+     * @brief 是否为 convert() 支持的目标格式（R16G16B16A16_SFLOAT、B10G11R11_UFLOAT_PACK32、R32G32B32A32_SFLOAT）
+     */
+    static bool isSupportedFormat(vk::Format format);
+
+    /**
+     * @brief 把浮点 RGBA 像素转换为目标格式
+     * @param rgba 输入像素，每像素 4 个 float
+     * @param pixelCount 像素数量
+     * @param format 目标格式
+     * @param out (输出) 目标像素，大小为 pixelCount * 目标格式的每像素字节数
+     * @throws std::invalid_argument 如果目标格式不受支持
+     */
+    static void convert(const float *rgba, size_t pixelCount, vk::Format format, void *out);
+
+    /**
+     * @brief 批量 float -> half（就近舍入到偶数，超出范围钳制到 ±65504）
+     */
+    static void floatToHalf(const float *values, size_t count, uint16_t *out);
+
+    /**
+     * @brief 单个 float -> half（与批量版本结果一致）
+     */
+    static uint16_t floatToHalf(float value);
+
+    /**
+     * @brief 批量打包为 B10G11R11_UFLOAT（忽略 alpha）
+     * @param rgba 输入像素，每像素 4 个 float
+     * @param pixelCount 像素数量
+     * @param out (输出) 打包结果
+     */
+    static void packB10G11R11(const float *rgba, size_t pixelCount, uint32_t *out);
+
+    /**
+     * @brief 打包单个像素为 B10G11R11_UFLOAT（R 在低 11 位，B 在高 10 位）
+     */
+    static uint32_t packB10G11R11(float r, float g, float b);
+};
+
+} // namespace rendercore
@@ -0,0 +1,156 @@
+/**
+ * @file MaterialLibrary.hpp
+ * @brief 材质库（整个目录的材质 JSON 编译成的二进制表）
+ * @details 首次加载材质目录时把其中所有 .json 解析一次，写成带版本号的定长记录表与字符串表；
+ *          之后的加载直接映射该文件，逐条解码定长记录，不再打开或解析任何 JSON。
+ *
+ *          文件布局（所有段按 16 字节对齐，小端）：
+ *          [MaterialLibraryHeader][MaterialLibraryRecord x materialCount][字符串表]
+ *          字符串表由以 '\0' 结尾的字符串依次拼接而成，记录中的字符串字段是表内的字节偏移。
+ *          源文件以相对于材质目录的路径记录，目录整体移动后缓存仍然有效。
+ */
+
+#pragma once
+
+#include "ResourceManagerUtils.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// 前向声明
+namespace vkcore
+{
+class MappedFile;
+} // namespace vkcore
+
+namespace rendercore
+{
+
+/**
+ * @struct MaterialLibraryHeader
+ * @brief 材质库文件头
+ */
+struct MaterialLibraryHeader
+{
+    char magic[4];          ///< "QTML"
+    uint32_t version;       ///< 格式版本（kVersion）
+    uint32_t recordStride;  ///< sizeof(MaterialLibraryRecord)，布局改变时旧缓存自动失效
+    uint32_t materialCount; ///< 记录数量
+    uint64_t sourceHash;    ///< 材质目录路径哈希（防止缓存文件名冲突）
+    uint64_t sourceStamp;   ///< 目录内全部源文件的相对路径、大小与修改时间的哈希
+    uint64_t recordOffset;  ///< 记录表偏移
+    uint64_t stringOffset;  ///< 字符串表偏移
+    uint64_t stringSize;    ///< 字符串表字节数
+    uint64_t reserved;      ///< 保持 16 字节对齐
+};
+
+/**
+ * @struct MaterialLibraryRecord
+ * @brief 一个材质的定长记录（整张表可以直接映射）
+ */
+struct MaterialLibraryRecord
+{
+    float baseColorFactor[4];
+    float emissiveFactor[3];
+    float metallicFactor;
+    float roughnessFactor;
+    float alphaCutoff;
+    float normalScale;
+    float refractionIndex;
+    uint32_t alphaMode;   ///< AlphaMode
+    uint32_t doubleSided; ///< 0 或 1
+    uint32_t source;      ///< 源文件相对于材质目录的路径（字符串偏移）
+    uint32_t name;        ///< 材质名称（字符串偏移）
+    uint32_t shader;      ///< 着色器名称（字符串偏移）
+    uint32_t textures[6]; ///< 纹理路径：baseColor、metallic、roughness、normal、occlusion、emissive（字符串偏移）
+    uint32_t reserved;    ///< 保持 16 字节对齐
+};
+
+/**
+ * @class MaterialLibrary
+ * @brief 材质库的读写工具（无状态，线程安全）
+ *
+ * @example
+ * @code
+ * auto sources = rendercore::MaterialLibrary::listSources("assets/materials");
+ * auto libraryPath = rendercore::MaterialLibrary::getLibraryPath(cacheDir, "assets/materials");
+ * vkcore::MappedFile file(libraryPath);
+ * if (auto view = rendercore::MaterialLibrary::open(file, "assets/materials", sources))
+ * {
+ *     for (uint32_t i = 0; i < view->count; ++i)
+ *     {
+ *         rendercore::MaterialData data = view->getMaterialData(i);
+ *     }
+ * }
+ * @endcode
+ */
+class MaterialLibrary
+{
+  public:
+    static constexpr uint32_t kVersion = 1; ///< 修改文件布局或材质 JSON 的解析规则时递增
+
+    /**
+     * @struct View
+     * @brief 映射文件内的只读视图（生命周期不超过对应的 MappedFile）
+     */
+    struct View
+    {
+        const MaterialLibraryRecord *records = nullptr;
+        uint32_t count = 0;
+        const char *strings = nullptr;
+        uint64_t stringSize = 0;
+
+        /**
+         * @brief 获取字符串表中的字符串（open() 已校验所有偏移）
+         */
+        std::string_view getString(uint32_t offset) const;
+
+        /**
+         * @brief 获取第 index 个材质的源文件相对路径
+         */
+        std::string_view getSource(uint32_t index) const;
+
+        /**
+         * @brief 解码第 index 个材质（与 MaterialLoader::loadMaterialData 的结果一致）
+         */
+        MaterialData getMaterialData(uint32_t index) const;
+    };
+
+    /**
+     * @brief 列出材质目录（递归）中的所有 .json 文件
+     * @return 按路径排序的源文件列表；目录不存在时为空
+     */
+    static std::vector<std::filesystem::path> listSources(const std::filesystem::path &materialDirectory);
+
+    /**
+     * @brief 计算材质目录对应的缓存文件路径
+     * @return <cacheDirectory>/<目录名>_<路径哈希>.qtmatlib
+     */
+    static std::filesystem::path getLibraryPath(const std::filesystem::path &cacheDirectory,
+                                                const std::filesystem::path &materialDirectory);
+
+    /**
+     * @brief 校验并打开已映射的材质库
+     * @param file 材质库的映射
+     * @param materialDirectory 材质目录（校验路径哈希）
+     * @param sources listSources() 的结果（校验文件集合、大小与修改时间）
+     * @return 校验通过时返回视图，否则返回空（缓存过期或损坏，应重新编译）
+     */
+    static std::optional<View> open(const vkcore::MappedFile &file, const std::filesystem::path &materialDirectory,
+                                    const std::vector<std::filesystem::path> &sources);
+
+    /**
+     * @brief 把解析好的材质写入材质库（先写临时文件再重命名，读者不会看到半个文件）
+     * @param libraryPath 缓存文件路径
+     * @param materialDirectory 材质目录
+     * @param sources listSources() 的结果
+     * @param materials 与 sources 一一对应的材质数据
+     * @return 写入成功返回 true
+     */
+    static bool write(const std::filesystem::path &libraryPath, const std::filesystem::path &materialDirectory,
+                      const std::vector<std::filesystem::path> &sources, const std::vector<MaterialData> &materials);
+};
+
+} // namespace rendercore
@@ -0,0 +1,88 @@
+/**
+ * @file MeshOptimizer.hpp
+ * @brief 导入时的网格优化：顶点焊接、顶点缓存 / 过度绘制三角形排序与顶点拉取重排
+ * @details 依次执行：
+ *          1. 顶点缓存优化：Tipsify（Sander 等，2007）按扇形遍历三角形，使后变换顶点缓存命中最多；
+ *          2. 过度绘制优化：以 Tipsify 的非局部跳转为界把三角形序列切成簇，按簇的朝外程度
+ *             （簇质心相对网格质心的偏移在簇法线上的投影）从大到小排列，外侧的遮挡者先绘制；
+ *          3. 顶点拉取优化：按索引中首次出现的顺序重排顶点，并剔除未引用的顶点。
+ *
+ *          顶点焊接单独提供给每个角点都是独立顶点的格式（STL）。
+ */
+
+#pragma once
+
+#include "ResourceManagerUtils.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rendercore
+{
+
+/**
+ * @class MeshOptimizer
+ * @brief 网格优化工具（无状态，线程安全）
+ *
+ * @example
+ * @code
+ * std::vector<rendercore::MeshData> meshes = rendercore::ModelLoader::loadModelFromMemory(...);
+ * for (rendercore::MeshData &meshData : meshes)
+ * {
+ *     rendercore::MeshOptimizer::optimize(meshData);
+ * }
+ * @endcode
+ */
+class MeshOptimizer
+{
+  public:
+    static constexpr uint32_t kCacheSize = 16; ///< 假设的后变换顶点缓存大小（桌面 GPU 的保守估计）
+
+    /**
+     * @brief 完整的优化流程：顶点缓存 -> 过度绘制 -> 顶点拉取（就地修改）
+     */
+    static void optimize(MeshData &meshData);
+
+    /**
+     * @brief 焊接位置相同的顶点
+     * @details 位置、纹理坐标与颜色完全相同且法线夹角不超过 creaseAngle 的角点合并为一个顶点，
+     *          合并后的法线取各角点法线之和（creaseAngle 为 0 时只合并法线也相同的角点，着色不变）
+     * @param meshData 网格（就地修改顶点与索引）
+     * @param creaseAngle 折痕角（弧度），超过该角度的相邻面保持硬边
+     */
+    static void weldVertices(MeshData &meshData, float creaseAngle = 0.0f);
+
+    /**
+     * @brief 用 Tipsify 重排三角形以提高后变换顶点缓存命中率
+     * @param indices 三角形列表索引（就地修改）
+     * @param indexCount 索引数量
+     * @param vertexCount 顶点数量
+     * @param cacheSize 顶点缓存大小
+     * @return 簇的起始三角形（升序，首项为 0），供 optimizeOverdraw() 使用
+     */
+    static std::vector<uint32_t> optimizeVertexCache(uint32_t *indices, size_t indexCount, size_t vertexCount,
+                                                     uint32_t cacheSize = kCacheSize);
+
+    /**
+     * @brief 按簇的朝外程度重排簇（簇内顺序不变，顶点缓存命中率基本不受影响）
+     * @param indices 三角形列表索引（就地修改）
+     * @param indexCount 索引数量
+     * @param vertices 顶点数组
+     * @param clusters optimizeVertexCache() 返回的簇起始三角形
+     */
+    static void optimizeOverdraw(uint32_t *indices, size_t indexCount, const Vertex *vertices,
+                                 const std::vector<uint32_t> &clusters);
+
+    /**
+     * @brief 按首次使用顺序重排顶点并剔除未引用的顶点
+     */
+    static void optimizeVertexFetch(MeshData &meshData);
+
+    /**
+     * @brief 模拟 FIFO 顶点缓存，计算平均每个三角形的缓存未命中数（ACMR，理想值约为 0.5）
+     */
+    static float computeACMR(const uint32_t *indices, size_t indexCount, size_t vertexCount,
+                             uint32_t cacheSize = kCacheSize);
+};
+
+} // namespace rendercore
@@ -0,0 +1,84 @@
+/**
+ * @file MeshSimplifier.hpp
+ * @brief 网格简化与 LOD 链生成
+ * @details 基于二次误差度量（QEM）的边折叠：按位置焊接顶点后为每个焊接点累积相邻三角形平面的二次型，
+ *          开放边界额外加入垂直于三角形的约束平面，然后用最小堆按误差从小到大折叠边，直到达到目标索引数
+ *          或下一次折叠的误差超过允许值。折叠只把端点合并到另一个已有顶点上（不生成新顶点），
+ *          因此各级 LOD 可以与完整网格共享同一段顶点数据，只追加各自的索引。
+ *
+ *          误差以网格包围盒半对角线为单位，与模型尺度无关；运行时乘以物体的投影尺寸即可换算为像素误差。
+ */
+
+#pragma once
+
+#include "ResourceType.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rendercore
+{
+
+/**
+ * @struct MeshLodSettings
+ * @brief 导入时生成 LOD 链的参数
+ */
+struct MeshLodSettings
+{
+    bool enabled = false;           ///< 是否生成 LOD 链（关闭时网格只有完整的一级）
+    uint32_t maxLodCount = 5;       ///< 最大 LOD 级数（含 LOD 0）
+    float reduction = 0.5f;         ///< 每一级相对上一级保留的三角形比例
+    float maxError = 0.05f;         ///< 最粗一级允许的累计误差（以包围盒半对角线为单位）
+    uint32_t minTriangleCount = 64; ///< 三角形数低于该值时不再继续简化
+};
+
+/**
+ * @class MeshSimplifier
+ * @brief 网格简化工具（无状态，线程安全）
+ *
+ * @example
+ * @code
+ * rendercore::MeshLodSettings settings;
+ * settings.enabled = true;
+ * // meshData.indices 之后追加各级 LOD 的索引，lods[0] 为原始网格
+ * std::vector<rendercore::MeshLod> lods =
+ *     rendercore::MeshSimplifier::buildLodChain(meshData.vertices, meshData.indices, settings);
+ * @endcode
+ */
+class MeshSimplifier
+{
+  public:
+    /**
+     * @brief 简化一个三角形列表
+     * @param vertices 顶点数组
+     * @param vertexCount 顶点数量
+     * @param indices 三角形列表索引
+     * @param indexCount 索引数量（3 的倍数）
+     * @param targetIndexCount 目标索引数量
+     * @param targetError 允许的最大误差（以包围盒半对角线为单位）
+     * @param resultError 输出实际产生的最大误差（可为空）
+     * @return 简化后的索引（引用原顶点数组）；误差限制先达到时索引数可能多于目标
+     */
+    static std::vector<uint32_t> simplify(const Vertex *vertices, size_t vertexCount, const uint32_t *indices,
+                                          size_t indexCount, size_t targetIndexCount, float targetError,
+                                          float *resultError = nullptr);
+
+    /**
+     * @brief 生成 LOD 链
+     * @details 每一级从上一级简化得到，误差逐级累加；简化进展过小、三角形过少或误差额度用尽时停止
+     * @param vertices 顶点数组（各级共享）
+     * @param indices 完整网格的索引，各级 LOD 的索引依次追加在其后
+     * @param settings 生成参数
+     * @return LOD 表（范围相对于 indices 起点）；未启用或无法简化时为空
+     */
+    static std::vector<MeshLod> buildLodChain(const std::vector<Vertex> &vertices, std::vector<uint32_t> &indices,
+                                              const MeshLodSettings &settings);
+
+    /**
+     * @brief 计算参数的哈希（写入烘焙文件，参数改变时旧缓存失效）
+     * @return 未启用时返回 0
+     */
+    static uint32_t hashSettings(const MeshLodSettings &settings);
+};
+
+} // namespace rendercore
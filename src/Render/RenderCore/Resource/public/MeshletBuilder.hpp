@@ -0,0 +1,91 @@
+/**
+ * @file MeshletBuilder.hpp
+ * @brief 导入时把三角形列表切分为 meshlet（供网格着色器渲染路径逐簇剔除）
+ * @details 贪心生长：从未使用的三角形出发，每次在与当前 meshlet 共享顶点的候选三角形中选择新增顶点最少、
+ *          法线与簇平均法线最接近的一个，直到顶点或三角形数达到上限；没有相邻候选时按索引顺序取下一个种子
+ *          （索引已经过顶点缓存优化，顺序本身具有空间局部性）。
+ *
+ *          每个 meshlet 记录模型空间包围球与法线锥（轴 + 截断值），任务着色器据此在 GPU 上做视锥、
+ *          背面锥与 Hi-Z 剔除：dot(center - eye, axis) >= cutoff * |center - eye| + radius 时整簇背向摄像机。
+ */
+
+#pragma once
+
+#include "ResourceType.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace rendercore
+{
+
+/**
+ * @struct GPUMeshlet
+ * @brief meshlet 描述（std430 布局，48 字节，与 meshlet.task / meshlet.mesh 中的 Meshlet 一致）
+ */
+struct GPUMeshlet
+{
+    glm::vec4 sphere;        ///< 模型空间包围球（xyz 球心，w 半径）
+    glm::vec4 cone;          ///< 法线锥（xyz 单位轴，w 截断值；1 表示不做背面锥剔除）
+    uint32_t vertexOffset;   ///< 在 meshlet 顶点索引数组中的起始位置
+    uint32_t triangleOffset; ///< 在三角形字节数组中的起始字节（4 字节对齐）
+    uint32_t vertexCount;    ///< 顶点数量（不超过 MeshletBuilder::kMaxVertices）
+    uint32_t triangleCount;  ///< 三角形数量（不超过 MeshletBuilder::kMaxTriangles）
+};
+static_assert(sizeof(GPUMeshlet) == 48, "GPUMeshlet must match the std430 layout in meshlet.task");
+
+/**
+ * @struct MeshletData
+ * @brief 切分结果
+ */
+struct MeshletData
+{
+    std::vector<GPUMeshlet> meshlets; ///< meshlet 描述
+    std::vector<uint32_t> vertices;   ///< meshlet 局部顶点 -> 网格顶点索引
+    std::vector<uint8_t> triangles;   ///< 每个三角形 3 个局部顶点索引，各 meshlet 的起点按 4 字节对齐
+};
+
+/**
+ * @class MeshletBuilder
+ * @brief meshlet 切分工具（无状态，线程安全）
+ *
+ * @example
+ * @code
+ * rendercore::MeshletData data = rendercore::MeshletBuilder::build(
+ *     meshData.vertices.data(), meshData.vertices.size(), meshData.indices.data(), meshData.indices.size());
+ * uint32_t vertexWordOffset = 0;
+ * uint32_t triangleWordOffset = 0;
+ * std::vector<uint32_t> words = rendercore::MeshletBuilder::pack(data, vertexWordOffset, triangleWordOffset);
+ * @endcode
+ */
+class MeshletBuilder
+{
+  public:
+    static constexpr uint32_t kMaxVertices = 64;   ///< 每个 meshlet 的最大顶点数（网格着色器输出上限的常用值）
+    static constexpr uint32_t kMaxTriangles = 124; ///< 每个 meshlet 的最大三角形数（124 * 3 字节按 4 字节对齐）
+
+    /**
+     * @brief 切分三角形列表
+     * @param vertices 顶点数组
+     * @param vertexCount 顶点数量
+     * @param indices 三角形列表索引
+     * @param indexCount 索引数量（3 的倍数）
+     * @param maxVertices 每个 meshlet 的最大顶点数（3 到 254）
+     * @param maxTriangles 每个 meshlet 的最大三角形数（1 到 255）
+     * @throws std::invalid_argument 如果上限超出范围
+     */
+    static MeshletData build(const Vertex *vertices, size_t vertexCount, const uint32_t *indices, size_t indexCount,
+                             uint32_t maxVertices = kMaxVertices, uint32_t maxTriangles = kMaxTriangles);
+
+    /**
+     * @brief 打包为单个存储缓冲的内容：[GPUMeshlet 数组][顶点索引数组][三角形字节数组]
+     * @param data 切分结果
+     * @param vertexWordOffset 输出顶点索引数组的起始位置（以 uint32 为单位）
+     * @param triangleWordOffset 输出三角形数组的起始位置（以 uint32 为单位）
+     */
+    static std::vector<uint32_t> pack(const MeshletData &data, uint32_t &vertexWordOffset,
+                                      uint32_t &triangleWordOffset);
+};
+
+} // namespace rendercore
@@ -0,0 +1,75 @@
+/**
+ * @file ObjParser.hpp
+ * @brief 基于内存扫描的 Wavefront OBJ 解析器
+ * @details 直接在内存（通常是 MappedFile 的映射）上手写扫描，数值使用 std::from_chars 解析，
+ *          不做逐行拷贝也不构造 istringstream。面顶点按 (v, vt, vn) 索引三元组用开放寻址
+ *          哈希表去重，共享的角点只生成一个顶点。大文件可按行边界切块并行解析，再按原顺序合并。
+ */
+
+#pragma once
+
+#include "ResourceManagerUtils.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 前向声明
+namespace vkcore
+{
+class WorkerPool;
+} // namespace vkcore
+
+namespace rendercore
+{
+
+/**
+ * @class ObjParser
+ * @brief OBJ 解析器（无状态，线程安全）
+ *
+ * @example
+ * @code
+ * vkcore::MappedFile file(path);
+ * rendercore::ObjParser::Options options;
+ * options.workers = &workerPool; // 可选：大文件分块并行解析
+ * std::vector<rendercore::MeshData> meshes =
+ *     rendercore::ObjParser::parse(file.data(), file.size(), path.string(), options);
+ * @endcode
+ */
+class ObjParser
+{
+  public:
+    /**
+     * @struct Options
+     * @brief 解析选项
+     */
+    struct Options
+    {
+        bool flipUVs = false;                           ///< 是否翻转 V 坐标
+        vkcore::WorkerPool *workers = nullptr;          ///< 分块并行解析使用的线程池（为空时单线程）
+        size_t parallelThreshold = 16ull * 1024 * 1024; ///< 文件超过该字节数才分块并行
+    };
+
+    /**
+     * @brief 解析内存中的 OBJ 文件内容
+     * @param data 文件内容
+     * @param size 字节数
+     * @param sourceName 错误信息中使用的来源名
+     * @param options 解析选项
+     * @return 每个 g/o 分组一个 MeshData
+     * @throws std::runtime_error 如果没有几何数据或索引越界
+     * @note options.workers 可以是调用线程所在的线程池（WorkerPool::parallelFor 支持嵌套）
+     */
+    static std::vector<MeshData> parse(const char *data, size_t size, const std::string &sourceName,
+                                       const Options &options);
+
+    /**
+     * @brief 使用默认选项解析
+     */
+    static std::vector<MeshData> parse(const char *data, size_t size, const std::string &sourceName)
+    {
+        return parse(data, size, sourceName, Options{});
+    }
+};
+
+} // namespace rendercore
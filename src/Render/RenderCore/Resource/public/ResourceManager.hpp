@@ -1,8 +1,19 @@
 #pragma once
 
+#include "CookedMesh.hpp"
+#include "EnvironmentPrefilter.hpp"
+#include "MeshSimplifier.hpp"
+#include "MeshletBuilder.hpp"
 #include "ResourceManagerUtils.hpp"
 #include "ResourceType.hpp"
-#include "VulkanCore/public/Device.hpp" // 包含 vkcore::Device
+#include "TextureStreamer.hpp"
+#include "VulkanCore/public/DeferredDeletionQueue.hpp" // 包含 vkcore::DeferredDeletionQueue
+#include "VulkanCore/public/Device.hpp"                // 包含 vkcore::Device
+#include "VulkanCore/public/SamplerCache.hpp"          // 包含 vkcore::SamplerCache
+#include "VulkanCore/public/UploadQueue.hpp"           // 包含 vkcore::UploadQueue
+#include "VulkanCore/public/WorkerPool.hpp"            // 包含 vkcore::WorkerPool
+#include <array>
+#include <exception>
 #include <filesystem>
 #include <future>
 #include <mutex>
@@ -18,13 +29,16 @@ class CommandPoolManager;
 class ShaderManager;
 class DescriptorAllocator;
 class DescriptorLayoutCache;
+class MappedFile;
 } // namespace vkcore
 
 // 前向声明来自 ResourceManagerUtils.hpp 的加载器
 namespace rendercore
 {
+class BindlessRegistry;
 struct TextureData;
-struct MeshData; // 从文件加载的网格原始数据结构
+struct TextureContainerData; // KTX2/DDS 容器解析结果
+struct MeshData;             // 从文件加载的网格原始数据结构
 } // namespace rendercore
 
 namespace rendercore
@@ -41,6 +55,29 @@ namespace rendercore
  * 2. 简化的 API：移除了 createBufferFromMesh 等两步加载函数。
  * 3. 明确的注册接口：registerMesh/registerTexture
  * 现在接受 CPU 数据（顶点/像素）并自动处理上传。
+ * 4. 批量异步上传：所有上传进入 UploadQueue 的同一批次，由传输队列一次提交，
+ * 资源带有上传票据，使用前需 flushUploads() 并等待票据（CPU 或 GPU 端）。
+ * 5. 并行加载流水线：文件映射与预读、解析/解码、GPU 上传是分离的阶段，分别运行在
+ * 有界的 I/O 线程池与解码线程池上；缓存锁只在查找/插入时持有，
+ * 同一路径的并发请求共享同一个 future。
+ * 6. GPU 压缩纹理：KTX2/DDS 容器中的 BCn/ETC2/ASTC 数据与预生成 mip 链直接上传；
+ * stb 解码的纹理在图形队列上用 vkCmdBlitImage 生成完整 mip 链。
+ * 7. 烘焙网格缓存：OBJ/STL 首次加载后写出二进制缓存，之后映射缓存文件直接拷入暂存区，
+ * 跳过解析与合并。
+ * 8. 统一几何池：所有网格的顶点/索引从 GeometryPool 的大缓冲中子分配，网格只记录偏移，
+ * 共享缓冲的网格可以一次绑定、合并进多重间接绘制。
+ * 9. Bindless 材质：设备支持描述符索引时，所有纹理注册进一个全局纹理数组，
+ * 材质参数写入全局 SSBO，所有材质共享同一个描述符集，绘制间只推送材质 ID。
+ * 10. 延迟销毁：设置 DeferredDeletionQueue 后，卸载时缓存持有的引用延迟到当前帧退休后释放，
+ * 在途帧仍在使用的资源可以随时卸载，无需 waitIdle。
+ * 11. 纹理流送：bindless 模式下带预生成 mip 链的容器纹理只先上传尾部 mip，
+ * 其余 mip 由 TextureStreamer 按屏幕尺寸请求流入、按显存预算以 LRU 淘汰。
+ * 12. 紧凑顶点格式：上传时为每个网格选择能表示源数据的最小 VertexFormat（八面体法线、half 纹理坐标、
+ * RGBA8 颜色，全白时省略颜色），顶点显存与拉取带宽约为标准格式的一半。
+ * 13. Meshlet：开启后为每个网格的完整 LOD 切分 meshlet 并上传到独立的存储缓冲（Mesh::meshlets），
+ * 供 MeshletRenderer 的网格着色器路径逐簇剔除；meshlet 不写入烘焙缓存，每次加载时重新生成。
+ * 14. 环境贴图：loadEnvironmentMap 首次加载时在 GPU 上把 equirect HDR 重采样为立方体并预过滤镜面/辐照度，
+ * 结果写入磁盘缓存；之后映射缓存文件直接上传全部面与 mip，不再解码源图与执行计算。
  */
 class ResourceManager
 {
@@ -60,10 +97,15 @@ class ResourceManager
      * @param shaderManager 着色器缓存
      * @param descAllocator 描述符分配器
      * @param layoutCache 描述符布局缓存
+     * @param samplerCache 采样器缓存（纹理的采样器从中获取，生命周期必须长于所有纹理）
+     * @param loaderThreads 解码线程数量（0 表示 hardware_concurrency - 1；指定 workers 时忽略）
+     * @param workers 解析/解码阶段使用的外部任务调度器（引擎共享，生命周期须长于本对象；为空时自建线程池）
+     * @note I/O 阶段始终使用自有的少量线程：它们阻塞在磁盘上，不应占用调度器的工作线程
      */
     void initialize(vkcore::Device &device, VmaAllocator allocator, vkcore::CommandPoolManager &cmdManager,
                     vkcore::ShaderManager &shaderManager, vkcore::DescriptorAllocator &descAllocator,
-                    vkcore::DescriptorLayoutCache &layoutCache);
+                    vkcore::DescriptorLayoutCache &layoutCache, vkcore::SamplerCache &samplerCache,
+                    uint32_t loaderThreads = 0, vkcore::WorkerPool *workers = nullptr);
 
     /**
      * @brief 清理所有缓存的GPU资源
@@ -77,12 +119,15 @@ class ResourceManager
      * @details 自动处理文件加载、解析和GPU缓冲区创建/上传
      * @param filepath 文件路径 (用作缓存键)
      * @return std::shared_ptr<Mesh> GPU 就绪的网格资源
+     * @note 大型 OBJ 会借用解码线程池分块并行解析，因此不可在加载线程池的任务内调用
      */
     std::shared_ptr<Mesh> loadMesh(const std::filesystem::path &filepath);
 
     /**
      * @brief 加载或获取缓存的纹理
-     * @details 自动处理文件加载、解析和GPU图像创建/上传
+     * @details 自动处理文件加载、解析和GPU图像创建/上传。KTX2/DDS 按文件头识别，
+     * 块压缩数据原样上传（设备不支持该格式时抛出异常）；Radiance HDR 解码为浮点后转换为 HDR 纹理格式
+     * （见 setHdrTextureFormat，srgb 被忽略）；其他格式解码为 RGBA8。非容器纹理都在GPU上生成 mip 链
      * @param filepath 文件路径 (用作缓存键)
      * @param srgb 纹理是否为 sRGB 格式
      * @return std::shared_ptr<Texture> GPU 就绪的纹理资源
@@ -92,28 +137,46 @@ class ResourceManager
     /**
      * @brief 加载或获取缓存的材质 (通过 .json 文件定义)
      * @details 自动加载JSON，递归加载其纹理和着色器，
-     * 并创建和更新 DescriptorSet。
+     * 并创建和更新 DescriptorSet。依赖的纹理会并行加载。
      * @param filepath 材质定义文件 (.json) 的路径
      * @return std::shared_ptr<Material> GPU 就绪的材质资源
+     * @warning 会阻塞等待加载线程池，不可在加载线程池的任务内调用
      */
     std::shared_ptr<Material> loadMaterial(const std::filesystem::path &filepath);
 
+    /**
+     * @brief 加载材质目录（递归）中的所有 .json 材质
+     * @details 首次加载时并行解析全部 JSON，并把结果写入烘焙缓存目录下的材质库（见 MaterialLibrary）；
+     *          之后只要目录中的文件集合、大小与修改时间未变，就直接映射材质库，不再打开任何 JSON。
+     *          所有材质的纹理一次性发起加载，描述符集批量分配、一次 updateDescriptorSets 写完；
+     *          非 bindless 模式下所有材质参数共用一个 Uniform Buffer（按 uniformOffset 偏移）。
+     *          缓存键与 loadMaterial(directory / 相对路径) 一致，已缓存的材质直接复用。
+     * @param directory 材质目录
+     * @return 按路径排序的材质列表；目录不存在或为空时为空
+     * @throws std::runtime_error 如果某个材质 JSON 解析失败
+     * @warning 会阻塞等待加载线程池，不可在加载线程池的任务内调用
+     */
+    std::vector<std::shared_ptr<Material>> loadMaterialLibrary(const std::filesystem::path &directory);
+
     // ==================== 异步加载接口 (可选) ====================
 
     /**
      * @brief 异步加载网格
+     * @details 读取文件在 I/O 线程池上执行，解析与上传在解码线程池上执行；
+     * 同一路径正在加载时返回同一个 future
      * @param filepath 文件路径
-     * @return std::future<std::shared_ptr<Mesh>>
+     * @return std::shared_future<std::shared_ptr<Mesh>>
      */
-    std::future<std::shared_ptr<Mesh>> loadMeshAsync(const std::filesystem::path &filepath);
+    std::shared_future<std::shared_ptr<Mesh>> loadMeshAsync(const std::filesystem::path &filepath);
 
     /**
      * @brief 异步加载纹理
      * @param filepath 文件路径
      * @param srgb 是否为 sRGB
-     * @return std::future<std::shared_ptr<Texture>>
+     * @return std::shared_future<std::shared_ptr<Texture>>
      */
-    std::future<std::shared_ptr<Texture>> loadTextureAsync(const std::filesystem::path &filepath, bool srgb = false);
+    std::shared_future<std::shared_ptr<Texture>> loadTextureAsync(const std::filesystem::path &filepath,
+                                                                  bool srgb = false);
 
     // ==================== 资源注册接口 (程序化创建) ====================
 
@@ -179,11 +242,14 @@ class ResourceManager
 
     /**
      * @brief 卸载指定的网格资源
+     * @details 设置了延迟销毁队列时，缓存的引用在当前帧退休后才释放
      */
     bool unloadMesh(const std::string &name);
 
     /**
      * @brief 卸载指定的纹理资源
+     * @details bindless 模式下，纹理的最后一个引用释放时归还其数组槽位（延迟到在途帧结束后复用）；
+     *          设置了延迟销毁队列时，缓存的引用在当前帧退休后才释放
      */
     bool unloadTexture(const std::string &name);
 
@@ -207,11 +273,203 @@ class ResourceManager
      */
     std::vector<std::string> getMaterialNames() const;
 
+    // ==================== 上传同步接口 ====================
+
+    /**
+     * @brief 提交所有待处理的上传
+     * @return vkcore::UploadTicket 全部已记录上传完成时的票据（可交给渲染提交在GPU端等待）
+     * @note 异步加载在解码线程上记录的上传不会自行提交，渲染线程每帧调用一次；
+     *       提交持有 Device::getQueueMutex()，与其他线程在同一队列上的提交互斥
+     */
+    vkcore::UploadTicket flushUploads();
+
+    /**
+     * @brief 提交并在CPU上等待全部上传完成
+     */
+    void waitForUploads();
+
+    /**
+     * @brief 网格的顶点/索引数据是否已在GPU上就绪
+     */
+    bool isResident(const Mesh &mesh) const;
+
+    /**
+     * @brief 纹理的像素数据是否已在GPU上就绪
+     */
+    bool isResident(const Texture &texture) const;
+
+    /**
+     * @brief 获取上传队列（用于获取时间线信号量或直接提交自定义上传）
+     */
+    vkcore::UploadQueue *getUploadQueue() const
+    {
+        return m_uploadQueue.get();
+    }
+
+    // ==================== 几何池接口 ====================
+
+    /**
+     * @brief 获取统一几何池（所有网格的顶点/索引缓冲来源）
+     */
+    GeometryPool *getGeometryPool() const
+    {
+        return m_geometryPool.get();
+    }
+
+    /**
+     * @brief 整理几何池碎片
+     * @details 先等待在途上传结束，再把碎片化的 Arena 紧凑拷贝到新缓冲并更新网格偏移
+     * @param cmd 录制拷贝与屏障的命令缓冲
+     * @param threshold 碎片率阈值（见 GeometryPool::defragment）
+     * @return std::vector<std::shared_ptr<vkcore::Buffer>> 旧缓冲，必须保持存活直到 cmd 执行完毕
+     * @warning 只能在渲染线程的帧间、没有异步加载在途时调用；此前录制的绘制仍使用旧偏移
+     */
+    std::vector<std::shared_ptr<vkcore::Buffer>> defragmentGeometry(vk::CommandBuffer cmd, float threshold = 0.25f);
+
+    // ==================== Bindless 接口 ====================
+
+    /**
+     * @brief 获取 bindless 注册表（设备不支持描述符索引时为 nullptr，此时使用逐材质描述符集）
+     * @details 渲染循环需要每帧调用 BindlessRegistry::advanceFrame()，使归还的槽位在 GPU 用完后复用
+     */
+    BindlessRegistry *getBindlessRegistry() const
+    {
+        return m_bindless.get();
+    }
+
+    // ==================== 纹理流送接口 ====================
+
+    /**
+     * @brief 获取纹理流送器（未启用 bindless 时为 nullptr，此时所有纹理完整常驻）
+     * @details 场景每帧通过 requestMaterial()/requestResolution() 报告所需精度，
+     *          MemoryMonitor 的压力回调应转发给 handleMemoryPressure()
+     */
+    TextureStreamer *getTextureStreamer() const
+    {
+        return m_textureStreamer.get();
+    }
+
+    /**
+     * @brief 推进纹理流送一帧，并为图像被替换的纹理重新写入引用它们的材质参数
+     * @warning 在渲染线程的帧间调用（与 BindlessRegistry::advanceFrame() 同一时机）；
+     *          新的流送上传随下一次 flushUploads() 提交
+     */
+    void updateTextureStreaming();
+
+    // ==================== 延迟销毁接口 ====================
+
+    /**
+     * @brief 设置卸载资源使用的延迟销毁队列
+     * @param queue 延迟销毁队列（由调用者持有并关联帧时间线，为空时卸载立即释放缓存的引用）
+     */
+    void setDeletionQueue(vkcore::DeferredDeletionQueue *queue)
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_deletionQueue = queue;
+    }
+
+    // ==================== 烘焙缓存接口 ====================
+
+    /**
+     * @brief 设置烘焙网格缓存目录
+     * @details 默认位于系统临时目录下的 QTRender/MeshCache；缓存按源文件路径、大小和修改时间失效
+     * @param directory 缓存目录（空路径禁用烘焙缓存）
+     */
+    void setMeshCacheDirectory(const std::filesystem::path &directory);
+
+    /**
+     * @brief 获取烘焙网格缓存目录（为空表示已禁用）
+     */
+    std::filesystem::path getMeshCacheDirectory() const;
+
+    // ==================== 网格 LOD 接口 ====================
+
+    /**
+     * @brief 设置导入网格时生成 LOD 链的参数
+     * @details 只影响之后开始加载的网格；LOD 索引追加在完整网格的索引之后并一起写入烘焙缓存，
+     *          参数哈希记录在缓存中，参数改变后旧缓存自动失效
+     */
+    void setMeshLodSettings(const MeshLodSettings &settings);
+
+    MeshLodSettings getMeshLodSettings() const;
+
+    // ==================== 顶点格式接口 ====================
+
+    /**
+     * @brief 设置是否为网格选择紧凑顶点格式（默认开启）
+     * @details 开启时按 VertexLayouts::select() 为每个网格选择格式，关闭时全部使用 VertexFormat::Standard；
+     *          只影响之后创建的网格，烘焙缓存始终保存标准格式。管线的顶点输入须与 Mesh::vertexFormat 一致
+     */
+    void setCompactVertexFormats(bool enabled);
+
+    bool getCompactVertexFormats() const;
+
+    // ==================== 网格 meshlet 接口 ====================
+
+    /**
+     * @brief 设置是否为网格生成 meshlet（默认关闭）
+     * @details 只影响之后创建的网格；只有设备启用了 VK_EXT_mesh_shader 时才值得开启（见 MeshletRenderer::isSupported）
+     */
+    void setMeshletGeneration(bool enabled);
+
+    bool getMeshletGeneration() const;
+
+    // ==================== HDR 纹理接口 ====================
+
+    /**
+     * @brief 设置 Radiance HDR（.hdr）纹理上传使用的格式（默认 R16G16B16A16_SFLOAT）
+     * @param format R16G16B16A16_SFLOAT（8 字节/像素）、B10G11R11_UFLOAT_PACK32（4 字节/像素，无 alpha 与负值）
+     *               或 R32G32B32A32_SFLOAT（16 字节/像素，不转换）
+     * @details 只影响之后开始加载的纹理；设备不支持采样所选格式时退回 R16G16B16A16_SFLOAT。
+     *          显存更紧张时应离线压缩为 BC6H 并以 KTX2/DDS 加载（1 字节/像素）
+     * @throws std::invalid_argument 如果格式不受 HdrConverter 支持
+     */
+    void setHdrTextureFormat(vk::Format format);
+
+    vk::Format getHdrTextureFormat() const;
+
+    // ==================== 环境贴图接口 ====================
+
+    /**
+     * @brief 加载等距柱状投影（equirect）HDR 环境贴图，返回预过滤的镜面与辐照度立方体（带缓存）
+     * @details 缓存目录中有匹配的预过滤结果时映射并原样上传，不读源图；否则以 loadTexture() 加载源图、
+     *          在图形队列上执行 EnvironmentPrefilter（需要 environment_prefilter.comp）并写入缓存。
+     *          同步执行，预过滤完成前阻塞；源图若由本次调用加载，完成后从纹理缓存中卸载
+     * @param filepath 源文件路径（.hdr 或 loadTexture() 支持的其他格式）
+     * @return 环境贴图（纹理带有上传票据，使用前需 flushUploads() 并等待）
+     * @throws std::runtime_error 如果缓存未命中且着色器未加载，或源图无法加载
+     */
+    std::shared_ptr<EnvironmentMap> loadEnvironmentMap(const std::filesystem::path &filepath);
+
+    /**
+     * @brief 卸载指定的环境贴图（名称为 loadEnvironmentMap() 的路径）
+     */
+    bool unloadEnvironmentMap(const std::string &name);
+
+    /**
+     * @brief 设置预过滤的尺寸与采样质量
+     * @details 只影响之后加载的环境贴图；设置记录在缓存中，改变后旧缓存自动失效
+     * @throws std::invalid_argument 如果设置无效（见 EnvironmentPrefilter::validate）
+     */
+    void setEnvironmentPrefilterSettings(const EnvironmentPrefilter::Settings &settings);
+
+    EnvironmentPrefilter::Settings getEnvironmentPrefilterSettings() const;
+
+    /**
+     * @brief 设置预过滤环境贴图的缓存目录
+     * @details 默认位于系统临时目录下的 QTRender/EnvironmentCache；缓存按源文件路径、大小和修改时间失效
+     * @param directory 缓存目录（空路径禁用缓存，每次加载都重新预过滤）
+     */
+    void setEnvironmentCacheDirectory(const std::filesystem::path &directory);
+
+    std::filesystem::path getEnvironmentCacheDirectory() const;
+
     // ==================== 描述符布局访问接口 ====================
 
     /**
      * @brief 获取材质描述符集布局
-     * @details 用于在管线创建时添加到PipelineBuilder中
+     * @details 用于在管线创建时添加到PipelineBuilder中；bindless 模式下返回全局集布局，
+     *          管线布局还需包含 BindlessRegistry::getMaterialPushConstantRange()
      * @return vk::DescriptorSetLayout 材质描述符集布局句柄
      */
     vk::DescriptorSetLayout getMaterialLayout() const;
@@ -232,15 +490,39 @@ class ResourceManager
     void buildmateriallayout();
 
     /**
-     * @brief (私有) 创建并上传一个 vkcore::Buffer
+     * @brief (私有) 创建一个 vkcore::Buffer 并把数据放入上传批次
+     * @param ticket 输出上传完成的票据（可为空）
      */
     std::shared_ptr<vkcore::Buffer> createbufferfromdata(const void *data, vk::DeviceSize size,
-                                                         vk::BufferUsageFlags usage);
+                                                         vk::BufferUsageFlags usage,
+                                                         vkcore::UploadTicket *ticket = nullptr);
+
+    /**
+     * @brief (私有) 创建一个 vkcore::Image 并把像素放入上传批次
+     * @param ticket 输出上传完成的票据（可为空）
+     * @param generateMips 是否在GPU上生成完整 mip 链（格式不支持线性 blit 时只有 mip 0）
+     */
+    std::shared_ptr<vkcore::Image> createimagefromdata(const void *data, int width, int height, vk::Format format,
+                                                       vkcore::UploadTicket *ticket = nullptr,
+                                                       bool generateMips = false);
+
+    /**
+     * @brief (私有) 从 KTX2/DDS 容器创建 vkcore::Image，所有 mip 在一次上传中拷贝
+     * @param format 实际使用的格式（已按 sRGB 请求调整）
+     * @throws std::runtime_error 如果设备不支持该格式的采样
+     */
+    std::shared_ptr<vkcore::Image> createimagefromcontainer(const TextureContainerData &container, vk::Format format,
+                                                            vkcore::UploadTicket *ticket = nullptr);
 
     /**
-     * @brief (私有) 创建并上传一个 vkcore::Image
+     * @brief (私有) 格式是否支持用线性过滤的 blit 生成 mip
      */
-    std::shared_ptr<vkcore::Image> createimagefromdata(const void *data, int width, int height, vk::Format format);
+    bool supportsmipgeneration(vk::Format format) const;
+
+    /**
+     * @brief (私有) 纹理使用的采样器（三线性 + 各向异性，覆盖全部 mip；所有纹理共享）
+     */
+    vk::Sampler gettexturesampler();
 
     /**
      * @brief (私有) 创建所有默认纹理 (1x1 白色, 1x1 法线)
@@ -248,7 +530,8 @@ class ResourceManager
     void createdefaulttextures();
 
     /**
-     * @brief (私有) 为材质创建Uniform Buffer
+     * @brief (私有) 为材质分配参数槽位：从共享的持久映射页中按槽位子分配，页满时开新页
+     * @note 页由使用它的材质共同持有，槽位不回收（与批量加载共用一个缓冲的材质相同）
      */
     void createMaterialUniformBuffer(std::shared_ptr<Material> material);
 
@@ -258,7 +541,7 @@ class ResourceManager
     void updateMaterialDescriptorSet(std::shared_ptr<Material> material);
 
     /**
-     * @brief (私有) 获取或创建缓存的采样器
+     * @brief (私有) 从采样器缓存获取采样器（各向异性按设备上限钳制）
      */
     vk::Sampler getorsampler(vk::Filter filter, vk::SamplerAddressMode addressMode);
 
@@ -270,19 +553,145 @@ class ResourceManager
                                             const TexturePaths &textureNames, const std::string &shaderName);
 
     /**
-     * @brief (私有) 实际的纹理加载和上传逻辑
+     * @brief (私有) 批量构建材质（loadMaterialLibrary 使用）
+     * @details 先为所有材质发起纹理加载再统一取结果；描述符集一次分配、一次写入，参数共用一个 Uniform Buffer
+     */
+    std::vector<std::shared_ptr<Material>> buildmaterials(const std::vector<std::string> &names,
+                                                          const std::vector<MaterialData> &materials);
+
+    /**
+     * @brief (私有) 为材质的六个纹理槽位发起异步加载（空路径对应无效 future）
+     */
+    std::array<std::shared_future<std::shared_ptr<Texture>>, 6> requestmaterialtextures(const TexturePaths &paths);
+
+    /**
+     * @brief (私有) 取回纹理加载结果（缺失的槽位使用默认纹理），并据此填写特性位
+     */
+    void resolvematerial(Material &material,
+                         const std::array<std::shared_future<std::shared_ptr<Texture>>, 6> &textures);
+
+    /**
+     * @brief (私有) 填写材质描述符集的写入信息（binding 0 为参数，1-6 为纹理）
+     * @param bufferInfo (输出) Uniform Buffer 描述
+     * @param imageInfos (输出) 六个纹理描述
+     * @param writes (输出) 追加 7 个写入，引用 bufferInfo 与 imageInfos，提交前二者必须保持有效
+     */
+    void appendmaterialwrites(const Material &material, vk::DescriptorBufferInfo &bufferInfo,
+                              std::array<vk::DescriptorImageInfo, 6> &imageInfos,
+                              std::vector<vk::WriteDescriptorSet> &writes) const;
+
+    using MeshPromise = std::promise<std::shared_ptr<Mesh>>;
+    using TexturePromise = std::promise<std::shared_ptr<Texture>>;
+
+    /**
+     * @brief (私有) 查找缓存/在途加载，必要时启动网格加载流水线
+     * @param async true 时各阶段投递到线程池，false 时在调用线程上依次执行
+     */
+    std::shared_future<std::shared_ptr<Mesh>> requestmesh(const std::filesystem::path &filepath, bool async);
+
+    /**
+     * @brief (私有) 查找缓存/在途加载，必要时启动纹理加载流水线
+     */
+    std::shared_future<std::shared_ptr<Texture>> requesttexture(const std::filesystem::path &filepath, bool srgb,
+                                                                bool async);
+
+    /**
+     * @brief (私有) 尝试从烘焙缓存加载网格：映射缓存文件并直接上传，完成后发布到缓存
+     * @return 缓存文件有效并已处理（成功或失败都已交给 promise）时返回 true；
+     * 缓存不存在或已过期时返回 false，调用方应回退到解析源文件
+     */
+    bool loadcookedmesh(const std::string &key, const std::filesystem::path &filepath,
+                        const std::filesystem::path &cookedPath, const MeshLodSettings &lodSettings,
+                        MeshPromise &promise);
+
+    /**
+     * @brief (私有) 网格流水线的解析与上传阶段，完成后发布到缓存
+     * @param cookedPath 解析完成后写出的烘焙缓存路径（为空时不写）
+     * @param lodSettings 请求开始时的 LOD 生成参数
+     */
+    void decodeanduploadmesh(const std::string &key, const std::filesystem::path &filepath,
+                             const vkcore::MappedFile &file, vkcore::WorkerPool *parseWorkers,
+                             const std::filesystem::path &cookedPath, const MeshLodSettings &lodSettings,
+                             MeshPromise &promise);
+
+    /**
+     * @brief (私有) 纹理流水线的解码与上传阶段，完成后发布到缓存
+     */
+    void decodeanduploadtexture(const std::string &key, const std::filesystem::path &filepath, bool srgb,
+                                const std::shared_ptr<vkcore::MappedFile> &file, TexturePromise &promise);
+
+    /**
+     * @brief (私有) 加载成功：插入缓存、移除在途记录并唤醒所有等待者
+     */
+    void publishmesh(const std::string &key, const std::shared_ptr<Mesh> &mesh, MeshPromise &promise);
+
+    /**
+     * @brief (私有) 加载失败：移除在途记录并把异常交给所有等待者
+     */
+    void failmeshload(const std::string &key, MeshPromise &promise, std::exception_ptr error);
+
+    /**
+     * @brief (私有) 加载失败：移除在途记录并把异常交给所有等待者
+     */
+    void failtextureload(const std::string &key, TexturePromise &promise, std::exception_ptr error);
+
+    /**
+     * @brief (私有) 在几何池中为网格分配区间并放入上传批次（不访问缓存，无需持有锁）
+     * @details 同时计算模型空间包围盒与包围球（registerMesh、源文件与烘焙缓存三条路径共用），
+     *          顶点按选定的 VertexFormat 编码后上传
+     * @param indices 完整网格的索引，有 LOD 时之后依次是各级 LOD 的索引（indexCount 为总数）
+     * @param lods LOD 表（可为空）
+     */
+    std::shared_ptr<Mesh> createmesh(const std::string &name, const Vertex *vertices, size_t vertexCount,
+                                     const uint32_t *indices, size_t indexCount, std::vector<MeshLod> lods = {});
+
+    /**
+     * @brief (私有) 创建纹理的图像与采样器并放入上传批次（不访问缓存，无需持有锁）
+     */
+    std::shared_ptr<Texture> createtexture(const std::string &name, const void *pixels, int width, int height,
+                                           vk::Format format, bool generateMips = false);
+
+    /**
+     * @brief (私有) 解码 Radiance HDR 并转换为 HDR 纹理格式后创建纹理（不访问缓存，无需持有锁）
+     * @details 像素较多时按行分块在解码调度器上并行转换
+     */
+    std::shared_ptr<Texture> createhdrtexture(const std::string &name, const unsigned char *bytes, size_t size);
+
+    /**
+     * @brief (私有) 从缓存文件创建环境贴图并放入上传批次
+     * @return 缓存缺失、过期或不可读时返回空
      */
-    std::shared_ptr<Texture> loadanduploadtexture(const std::filesystem::path &filepath, bool srgb);
+    std::shared_ptr<EnvironmentMap> loadcachedenvironment(const std::filesystem::path &filepath,
+                                                          const std::filesystem::path &cachePath,
+                                                          const EnvironmentPrefilter::Settings &settings);
 
     /**
-     * @brief (私有) 实际的网格加载和上传逻辑
+     * @brief (私有) 加载源图并在 GPU 上预过滤，cachePath 非空时写入缓存（调用者持有 m_environmentMtx）
      */
-    std::shared_ptr<Mesh> loadanduploadmesh(const std::filesystem::path &filepath);
+    std::shared_ptr<EnvironmentMap> prefilterenvironment(const std::filesystem::path &filepath,
+                                                         const std::filesystem::path &cachePath,
+                                                         const EnvironmentPrefilter::Settings &settings);
+
+    /**
+     * @brief (私有) 把环境立方体包装为纹理（线性钳制采样器，不注册 bindless）
+     */
+    std::shared_ptr<Texture> createenvironmenttexture(const std::string &name, std::shared_ptr<vkcore::Image> image,
+                                                      vkcore::UploadTicket ticket);
+
+    /**
+     * @brief (私有) 从 KTX2/DDS 容器创建纹理并放入上传批次（不访问缓存，无需持有锁）
+     * @param file 容器所在的文件映射（非空且容器可流送时交给 TextureStreamer，只上传尾部 mip）
+     */
+    std::shared_ptr<Texture> createcontainertexture(const std::string &name, const TextureContainerData &container,
+                                                    bool srgb,
+                                                    const std::shared_ptr<vkcore::MappedFile> &file = nullptr);
 
     /**
      * @brief (私有) 合并多个网格数据为单一网格
+     * @param submeshes 输出每个源网格在合并结果中的范围（可为空）
      */
-    MeshData mergeMeshData(const std::vector<MeshData> &meshDataList, const std::string &baseName);
+    MeshData mergeMeshData(const std::vector<MeshData> &meshDataList, const std::string &baseName,
+                           std::vector<Submesh> *submeshes = nullptr);
 
   private:
     // ==================== 私有成员 (m_ prefix, all_lowercase) ====================
@@ -295,23 +704,74 @@ class ResourceManager
     vkcore::ShaderManager *m_shaderManager = nullptr;
     vkcore::DescriptorAllocator *m_descAllocator = nullptr;
     vkcore::DescriptorLayoutCache *m_layoutCache = nullptr;
+    vkcore::SamplerCache *m_samplerCache = nullptr;
+
+    // 批量上传队列（暂存环形缓冲区 + 传输队列）
+    std::unique_ptr<vkcore::UploadQueue> m_uploadQueue;
+
+    // 统一几何池（网格持有弱引用，析构时归还区间）
+    std::shared_ptr<GeometryPool> m_geometryPool;
+
+    // 全局 bindless 描述符集（纹理/材质持有弱引用，析构时归还槽位；不支持时为空）
+    std::shared_ptr<BindlessRegistry> m_bindless;
+
+    // 容器纹理的 mip 流送（依赖 bindless 槽位替换，不支持时为空）
+    std::unique_ptr<TextureStreamer> m_textureStreamer;
+
+    // 卸载资源的延迟销毁队列（可选，由外部持有）
+    vkcore::DeferredDeletionQueue *m_deletionQueue = nullptr;
+
+    // 加载流水线线程池（I/O 与解析/上传分离，均为有界线程数）
+    std::unique_ptr<vkcore::WorkerPool> m_ioWorkers;
+    std::unique_ptr<vkcore::WorkerPool> m_decodeWorkers;          ///< 自建的解码线程池（使用外部调度器时为空）
+    vkcore::WorkerPool *m_decodePool = nullptr;                   ///< 解码任务实际投递的调度器
+    std::unique_ptr<vkcore::WorkerPool::TaskGroup> m_decodeTasks; ///< 在途解码任务（清理时等待）
+
+    // 烘焙网格缓存目录（为空表示禁用）
+    std::filesystem::path m_meshCacheDirectory;
+
+    // 导入网格时的 LOD 生成参数
+    MeshLodSettings m_meshLodSettings;
+
+    // 是否为网格选择紧凑顶点格式
+    bool m_compactVertexFormats = true;
+
+    // 是否为网格生成 meshlet
+    bool m_meshletGeneration = false;
+
+    // Radiance HDR 纹理的上传格式
+    vk::Format m_hdrTextureFormat = vk::Format::eR16G16B16A16Sfloat;
+
+    // 环境贴图：预过滤设置、缓存目录（为空表示禁用）与首次未命中时创建的计算管线
+    EnvironmentPrefilter::Settings m_environmentSettings;
+    std::filesystem::path m_environmentCacheDirectory;
+    std::unique_ptr<EnvironmentPrefilter> m_environmentPrefilter;
+    std::mutex m_environmentMtx; ///< 串行化预过滤（共享计算管线与描述符池）；持有时可获取 m_mtx，反之不可
 
     // 资源缓存 (使用文件路径或注册名称作为键)
     std::unordered_map<std::string, std::shared_ptr<Mesh>> m_meshCache;
     std::unordered_map<std::string, std::shared_ptr<Texture>> m_textureCache;
     std::unordered_map<std::string, std::shared_ptr<Material>> m_materialCache;
+    std::unordered_map<std::string, std::shared_ptr<EnvironmentMap>> m_environmentCache;
 
-    // 采样器缓存 (使用配置哈希作为键)
-    std::unordered_map<uint64_t, vk::Sampler> m_samplerCache;
+    // 在途加载 (同一键的并发请求共享同一个 future)
+    std::unordered_map<std::string, std::shared_future<std::shared_ptr<Mesh>>> m_pendingMeshes;
+    std::unordered_map<std::string, std::shared_future<std::shared_ptr<Texture>>> m_pendingTextures;
 
     // 默认资源
     std::shared_ptr<Texture> m_defaultWhiteTexture;
     std::shared_ptr<Texture> m_defaultNormalTexture;
 
-    // 标准材质布局
+    // 标准材质布局（由 m_layoutCache 持有）
     vk::DescriptorSetLayout m_materialLayout;
 
-    // 互斥锁，保护所有缓存的线程安全
+    // 单个创建的材质共用的参数页（槽位步长满足 minUniformBufferOffsetAlignment）
+    static constexpr uint32_t kMaterialUniformsPerPage = 256;
+    std::shared_ptr<vkcore::Buffer> m_materialUniformPage;
+    vk::DeviceSize m_materialUniformStride = 0;
+    uint32_t m_materialUniformsUsed = 0;
+
+    // 互斥锁，保护所有缓存的线程安全（只在查找/插入时持有，不覆盖文件 I/O、解析与上传）
     mutable std::mutex m_mtx;
 };
 
@@ -13,6 +13,12 @@
 #include <tuple>
 #include <vector>
 
+// 前向声明
+namespace vkcore
+{
+class WorkerPool;
+} // namespace vkcore
+
 namespace rendercore
 {
 
@@ -91,6 +97,7 @@ struct TextureData
     int height{0};                  ///< 图像高度（像素）
     int channels{0};                ///< 通道数（1=灰度, 2=灰度+alpha, 3=RGB, 4=RGBA）
     size_t dataSize{0};             ///< 数据大小（字节）
+    bool isFloat{false};            ///< 像素为 32 位浮点（HDR），pixels 实际指向 float 数组
 
     /**
      * @brief 释放纹理数据（使用 stbi_image_free）
@@ -246,7 +253,7 @@ class ModelLoader
     static ModelFormat detectFormat(const std::filesystem::path &filePath);
 
     /**
-     * @brief 从 OBJ 文件加载模型数据到内存
+     * @brief 从 OBJ 文件加载模型数据到内存（内存映射 + ObjParser）
      * @param filePath OBJ 文件路径
      * @param flipUVs 是否翻转 UV 坐标（默认 false）
      * @return std::vector<MeshData> 纯内存网格数据列表
@@ -256,6 +263,7 @@ class ModelLoader
 
     /**
      * @brief 从 STL 文件加载模型数据到内存（二进制或 ASCII）
+     * @details 各面的角点按位置焊接为共享顶点，夹角不超过 30° 的相邻面平滑着色
      * @param filePath STL 文件路径
      * @return MeshData 结构体（纯内存顶点和索引数据）
      * @throws std::runtime_error 如果文件不存在或格式错误
@@ -270,16 +278,34 @@ class ModelLoader
      */
     static std::vector<MeshData> loadModel(const std::filesystem::path &filePath);
 
+    /**
+     * @brief 从内存中的文件内容解析模型（不做文件 I/O，可与读取阶段分离到不同线程）
+     * @param data 完整的文件内容（通常是 MappedFile 的映射）
+     * @param size 字节数
+     * @param format 模型格式（通常由 detectFormat 得到）
+     * @param name 网格名称与错误信息中使用的来源名
+     * @param workers 大文件分块并行解析使用的线程池（可为空，可以是调用线程所在的线程池）
+     * @return 纯内存网格数据列表
+     * @throws std::runtime_error 如果格式不支持或解析失败
+     */
+    static std::vector<MeshData> loadModelFromMemory(const char *data, size_t size, ModelFormat format,
+                                                     const std::string &name, vkcore::WorkerPool *workers = nullptr);
+
   private:
+    /**
+     * @brief 从输入流解析 STL（自动区分二进制与 ASCII）
+     */
+    static MeshData parseSTL(std::istream &stream, const std::string &name);
+
     /**
      * @brief 加载二进制 STL 文件
      */
-    static MeshData loadSTLBinary(std::ifstream &file);
+    static MeshData loadSTLBinary(std::istream &file);
 
     /**
      * @brief 加载 ASCII STL 文件
      */
-    static MeshData loadSTLAscii(std::ifstream &file);
+    static MeshData loadSTLAscii(std::istream &file);
 };
 
 // ============================================================================
@@ -311,9 +337,10 @@ class TextureLoader
         HDR, ///< HDR 图像
         PIC, ///< PIC 图像
         PNM, ///< PNM 图像
-        DDS, ///< DirectDraw Surface
-        KTX, ///< Khronos Texture
-        ASTC ///< ASTC 压缩纹理
+        DDS,  ///< DirectDraw Surface
+        KTX,  ///< Khronos Texture
+        KTX2, ///< Khronos Texture 2.0
+        ASTC  ///< ASTC 压缩纹理
     };
 
     /**
@@ -343,6 +370,22 @@ class TextureLoader
     static TextureData loadFromMemory(const unsigned char *data, size_t dataSize, int desiredChannels = 0,
                                       bool flipVertically = false);
 
+    /**
+     * @brief 判断内存中的图像是否为 Radiance HDR（.hdr）
+     */
+    static bool isHDR(const unsigned char *data, size_t dataSize);
+
+    /**
+     * @brief 从内存加载 HDR 图像为 32 位浮点 RGBA（不做色调映射）
+     * @param data 内存数据指针
+     * @param dataSize 数据大小（字节）
+     * @param flipVertically 是否垂直翻转
+     * @return TextureData 结构体（channels 为 4，isFloat 为 true）
+     * @throws std::runtime_error 如果解码失败
+     * @note loadFromMemory 对 HDR 图像会转换为 8 位 LDR，需要保留动态范围时使用本函数
+     */
+    static TextureData loadHDRFromMemory(const unsigned char *data, size_t dataSize, bool flipVertically = false);
+
     /**
      * @brief 创建纯色纹理
      * @param width 宽度
@@ -1,19 +1,25 @@
 #pragma once
 
+#include "GeometryPool.hpp"                    // 包含 rendercore::GeometryPool
 #include "VulkanCore/public/Descriptor.hpp"    // 包含 vkcore::Descriptor...
 #include "VulkanCore/public/ShaderManager.hpp" // 包含 vkcore::ShaderModule
+#include "VulkanCore/public/UploadQueue.hpp"   // 包含 vkcore::UploadTicket
 #include "VulkanCore/public/VKResource.hpp"    // 包含 vkcore::Buffer 和 vkcore::Image
+#include <algorithm>
 #include <glm/glm.hpp>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace rendercore
 {
+class BindlessRegistry;
 
 /**
  * @struct Vertex
  * @brief 顶点的标准布局
- * @details 成员按大小降序排列以优化内存对齐
+ * @details 成员按大小降序排列以优化内存对齐；导入、简化与烘焙都使用该格式，
+ *          上传到几何池时按网格的 VertexFormat 编码（见 VertexLayout.hpp）
  */
 struct Vertex
 {
@@ -23,18 +29,168 @@ struct Vertex
     glm::vec2 texCoord; // 8 bytes
 };
 
+/**
+ * @struct Submesh
+ * @brief 合并网格中一个源分组（OBJ 的 g/o）所占的顶点/索引范围
+ */
+struct Submesh
+{
+    std::string name;        ///< 源分组名称
+    uint32_t firstIndex{0};  ///< 在索引缓冲区中的起始位置
+    uint32_t indexCount{0};  ///< 索引数量
+    uint32_t firstVertex{0}; ///< 在顶点缓冲区中的起始位置（索引已按合并后的顶点编号）
+    uint32_t vertexCount{0}; ///< 顶点数量
+};
+
+/**
+ * @struct BoundingBox
+ * @brief 轴对齐包围盒（AABB）
+ */
+struct BoundingBox
+{
+    glm::vec3 min{0.0f}; ///< 最小角点
+    glm::vec3 max{0.0f}; ///< 最大角点
+
+    glm::vec3 getCenter() const
+    {
+        return (min + max) * 0.5f;
+    }
+
+    glm::vec3 getExtents() const
+    {
+        return (max - min) * 0.5f;
+    }
+};
+
+/**
+ * @struct BoundingSphere
+ * @brief 包围球
+ */
+struct BoundingSphere
+{
+    glm::vec3 center{0.0f}; ///< 球心
+    float radius{0.0f};     ///< 半径
+};
+
+/**
+ * @struct MeshLod
+ * @brief 网格的一级 LOD：简化后的三角形在索引缓冲中的范围（与完整网格共享顶点）
+ */
+struct MeshLod
+{
+    uint32_t firstIndex{0}; ///< 相对于 Mesh::firstIndex 的起始索引（几何池整理后无需修改）
+    uint32_t indexCount{0}; ///< 索引数量
+    float error{0.0f};      ///< 相对于完整网格的几何误差（以包围盒半对角线为单位）
+};
+
+/**
+ * @struct MeshMeshlets
+ * @brief 网格的 meshlet 数据（MeshletBuilder::pack() 的结果，供网格着色器渲染路径使用）
+ */
+struct MeshMeshlets
+{
+    std::shared_ptr<vkcore::Buffer> buffer; ///< 存储缓冲：[GPUMeshlet 数组][顶点索引数组][三角形字节数组]
+    uint32_t count{0};                      ///< meshlet 数量（0 表示没有生成 meshlet）
+    uint32_t vertexWordOffset{0};           ///< 顶点索引数组的起始位置（以 uint32 为单位）
+    uint32_t triangleWordOffset{0};         ///< 三角形数组的起始位置（以 uint32 为单位）
+};
+
 /**
  * @struct Mesh
  * @brief 包含顶点和索引缓冲区的网格资源
  */
 struct Mesh
 {
-    std::string name; ///< 网格名称（用于调试和资源管理）
-    std::shared_ptr<vkcore::Buffer> vertexBuffer;
-    std::shared_ptr<vkcore::Buffer> indexBuffer;
-    uint32_t vertexCount{0}; ///< 顶点数量（用于无索引绘制）
-    uint32_t indexCount{0};  ///< 索引数量
-    // (未来可以添加包围盒等)
+    std::string name;                                  ///< 网格名称（用于调试和资源管理）
+    std::shared_ptr<vkcore::Buffer> vertexBuffer;      ///< 顶点缓冲（几何池中与其他网格共享）
+    std::shared_ptr<vkcore::Buffer> indexBuffer;       ///< 索引缓冲（几何池中与其他网格共享）
+    int32_t vertexOffset{0};                           ///< 首个顶点在 vertexBuffer 中的位置（drawIndexed 的 vertexOffset）
+    uint32_t firstIndex{0};                            ///< 首个索引在 indexBuffer 中的位置（drawIndexed 的 firstIndex）
+    vk::IndexType indexType{vk::IndexType::eUint32};   ///< 索引类型（顶点数允许时为 16 位）
+    VertexFormat vertexFormat{VertexFormat::Standard}; ///< 顶点在 vertexBuffer 中的编码格式（决定顶点输入布局）
+    uint32_t vertexCount{0};                           ///< 顶点数量（用于无索引绘制）
+    uint32_t indexCount{0};                            ///< 索引数量（LOD 0，即完整网格）
+    vkcore::UploadTicket uploadTicket{0};              ///< 顶点/索引上传完成的票据（0 表示已驻留）
+    std::vector<Submesh> submeshes;                    ///< 子网格表（范围相对于 firstIndex/vertexOffset）
+    std::vector<MeshLod> lods;                         ///< LOD 链，lods[0] 为完整网格（为空表示没有生成 LOD）
+    BoundingBox bounds;                                ///< 模型空间包围盒（创建时由顶点计算）
+    BoundingSphere boundingSphere;                     ///< 模型空间包围球（以包围盒中心为球心）
+    MeshMeshlets meshlets;                             ///< LOD 0 的 meshlet（顶点索引相对于 vertexOffset）
+
+    std::weak_ptr<GeometryPool> geometryPool;              ///< 子分配来源（为空表示独立缓冲）
+    uint32_t geometryHandle{GeometryPool::kInvalidHandle}; ///< 在几何池中的条目
+
+    Mesh() = default;
+    ~Mesh();
+
+    /** 禁用拷贝（析构时归还几何池区间） */
+    Mesh(const Mesh &) = delete;
+    Mesh &operator=(const Mesh &) = delete;
+
+    /**
+     * @brief 获取 LOD 级数（没有 LOD 链时为 1）
+     */
+    uint32_t getLodCount() const
+    {
+        return lods.empty() ? 1u : static_cast<uint32_t>(lods.size());
+    }
+
+    /**
+     * @brief 获取一级 LOD 在索引缓冲中的绝对范围（级数越界时取最粗的一级）
+     */
+    void getLodRange(uint32_t lod, uint32_t &first, uint32_t &count) const
+    {
+        if (lods.empty())
+        {
+            first = firstIndex;
+            count = indexCount;
+            return;
+        }
+        const MeshLod &level = lods[std::min<size_t>(lod, lods.size() - 1)];
+        first = firstIndex + level.firstIndex;
+        count = level.indexCount;
+    }
+};
+
+/**
+ * @enum BindlessSlotType
+ * @brief bindless 槽位所在的数组
+ */
+enum class BindlessSlotType : uint8_t
+{
+    Texture,  ///< 全局纹理数组（combined image sampler）
+    Material, ///< 材质参数 SSBO
+};
+
+/**
+ * @struct BindlessSlot
+ * @brief BindlessRegistry 中的一个槽位，析构时归还（延迟到 GPU 不再使用后才复用）
+ * @details 拷贝得到的是空槽位：Material 常以值的形式作为参数模板传入 registerMaterial()，副本不能重复归还
+ */
+struct BindlessSlot
+{
+    static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+    uint32_t index{kInvalidIndex};                    ///< 数组下标（着色器中的纹理索引 / 材质 ID）
+    BindlessSlotType type{BindlessSlotType::Texture}; ///< 所在的数组
+    std::weak_ptr<BindlessRegistry> registry;         ///< 分配来源
+
+    BindlessSlot() = default;
+    ~BindlessSlot();
+
+    /** 拷贝不转移所有权 */
+    BindlessSlot(const BindlessSlot &) noexcept
+    {
+    }
+    BindlessSlot &operator=(const BindlessSlot &) noexcept
+    {
+        return *this;
+    }
+
+    bool isValid() const
+    {
+        return index != kInvalidIndex;
+    }
 };
 
 /**
@@ -46,7 +202,22 @@ struct Texture
 {
     std::string name; ///< 纹理名称（用于调试和资源管理）
     std::shared_ptr<vkcore::Image> image;
-    vk::UniqueSampler sampler; ///< RAII 管理的采样器（自动销毁）
+    vk::Sampler sampler;                  ///< 采样器（归 vkcore::SamplerCache 所有，多个纹理共享）
+    vkcore::UploadTicket uploadTicket{0}; ///< 像素上传完成的票据（0 表示已驻留）
+    BindlessSlot bindless;                ///< 全局纹理数组中的槽位（未启用 bindless 时无效）
+};
+
+/**
+ * @struct EnvironmentMap
+ * @brief 基于图像的光照使用的预过滤环境立方体贴图
+ * @details 两张纹理都是 R16G16B16A16_SFLOAT 立方体贴图，不注册进 bindless 纹理数组（数组只容纳 2D 纹理）
+ */
+struct EnvironmentMap
+{
+    std::string name;                    ///< 源文件路径
+    std::shared_ptr<Texture> specular;   ///< GGX 预过滤镜面，mip i 对应粗糙度 i / (specularMipCount - 1)
+    std::shared_ptr<Texture> irradiance; ///< 余弦卷积辐照度（已除以 pi）
+    uint32_t specularMipCount = 0;       ///< 镜面的 mip 级数（着色器按粗糙度选取 LOD）
 };
 
 /**
@@ -82,6 +253,7 @@ struct Material
     // 渲染状态
     AlphaMode alphaMode{AlphaMode::Opaque}; ///< Alpha 混合模式
     bool doubleSided{false};                ///< 是否双面渲染
+    uint32_t features{0};                   ///< MaterialFeature 位掩码（ResourceManager 创建材质时填写）
 
     // 纹理 (由 ResourceManager 管理) - 支持分离的金属度/粗糙度纹理
     std::shared_ptr<Texture> baseColorTexture;
@@ -97,10 +269,35 @@ struct Material
 
     // GPU资源
     std::shared_ptr<vkcore::Buffer> uniformBuffer; ///< 材质参数Uniform Buffer
+    vk::DeviceSize uniformOffset{0};               ///< 参数在 uniformBuffer 中的偏移（材质共用参数页或批量缓冲）
 
     // Vulkan 描述符集 (Material 的核心 "实例")
     // 当一个 Material 被创建时，它应该被分配一个描述符集
+    // 启用 bindless 时 descriptorSet 为全局集，材质通过 push constant 中的 bindless.index 寻址参数
     vk::DescriptorSet descriptorSet;
+    BindlessSlot bindless; ///< 材质参数 SSBO 中的槽位（未启用 bindless 时无效）
 };
 
+/**
+ * @enum MaterialFeature
+ * @brief 材质特性位
+ * @details 位掩码作为特化常量 MATERIAL_FEATURES（constant_id = kMaterialFeaturesConstantId）传给着色器，
+ *          每种组合编译为一个管线排列，未使用的纹理采样与分支在编译期被消除。
+ *          各位与 assets/shaders/material_features.glsl 保持一致。
+ */
+enum MaterialFeature : uint32_t
+{
+    MaterialFeatureBaseColorTexture = 1u << 0, ///< 采样基础色纹理
+    MaterialFeatureMetallicTexture = 1u << 1,  ///< 采样金属度纹理
+    MaterialFeatureRoughnessTexture = 1u << 2, ///< 采样粗糙度纹理
+    MaterialFeatureNormalTexture = 1u << 3,    ///< 采样法线纹理（否则使用几何法线）
+    MaterialFeatureOcclusionTexture = 1u << 4, ///< 采样 AO 纹理
+    MaterialFeatureEmissiveTexture = 1u << 5,  ///< 采样自发光纹理
+    MaterialFeatureAlphaMask = 1u << 6,        ///< Alpha 测试（discard）
+    MaterialFeatureDoubleSided = 1u << 7,      ///< 双面（背面翻转法线）
+};
+
+/// 材质特性位掩码的特化常量 id
+constexpr uint32_t kMaterialFeaturesConstantId = 0;
+
 } // namespace rendercore
\ No newline at end of file
@@ -0,0 +1,135 @@
+/**
+ * @file TextureContainer.hpp
+ * @brief GPU 纹理容器（KTX2 / DDS）解析
+ * @details 直接解析内存（通常是 MappedFile 的映射）中的容器头与 mip 索引，不解码像素：
+ *          BC1-7、ETC2、ASTC 等块压缩数据与预生成的 mip 链原样拷入暂存区上传，
+ *          显存占用与采样带宽只有 RGBA8 的 1/4 ~ 1/8。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace rendercore
+{
+
+/**
+ * @struct FormatBlockInfo
+ * @brief 格式的纹素块尺寸（非压缩格式为 1x1 块）
+ */
+struct FormatBlockInfo
+{
+    uint32_t blockWidth = 1;  ///< 块宽度（纹素）
+    uint32_t blockHeight = 1; ///< 块高度（纹素）
+    uint32_t blockBytes = 4;  ///< 每块字节数
+
+    /**
+     * @brief 计算 width x height 的一级 mip 的字节数
+     */
+    size_t getLevelSize(uint32_t width, uint32_t height) const
+    {
+        size_t blocksX = (width + blockWidth - 1) / blockWidth;
+        size_t blocksY = (height + blockHeight - 1) / blockHeight;
+        return blocksX * blocksY * blockBytes;
+    }
+
+    /**
+     * @brief 是否为块压缩格式
+     */
+    bool isCompressed() const
+    {
+        return blockWidth > 1 || blockHeight > 1;
+    }
+};
+
+/**
+ * @struct TextureContainerData
+ * @brief 容器解析结果（只引用源内存，不拥有像素数据）
+ */
+struct TextureContainerData
+{
+    /**
+     * @struct Level
+     * @brief 一级 mip 在源内存中的位置
+     */
+    struct Level
+    {
+        size_t offset = 0; ///< 相对于 data 起始的字节偏移
+        size_t size = 0;   ///< 字节数
+        uint32_t width = 1;
+        uint32_t height = 1;
+    };
+
+    vk::Format format = vk::Format::eUndefined;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<Level> levels;           ///< 从 mip 0（最大）开始
+    const unsigned char *data = nullptr; ///< 源内存（生命周期由调用者保证）
+    size_t dataSize = 0;                 ///< 源内存字节数
+    bool requestsMipGeneration = false;  ///< KTX2 levelCount 为 0：文件只含 mip 0，要求运行时生成
+};
+
+/**
+ * @class TextureContainer
+ * @brief KTX2 与 DDS 容器解析（无状态，线程安全）
+ *
+ * @example
+ * @code
+ * vkcore::MappedFile file("assets/car/albedo.ktx2");
+ * auto bytes = reinterpret_cast<const unsigned char *>(file.data());
+ * if (rendercore::TextureContainer::isContainer(bytes, file.size()))
+ * {
+ *     rendercore::TextureContainerData texture = rendercore::TextureContainer::parse(bytes, file.size(), "albedo");
+ *     // texture.levels[i] 可直接作为 vk::BufferImageCopy 的 bufferOffset/imageExtent
+ * }
+ * @endcode
+ *
+ * @note 只支持单层、单面的 2D 纹理；KTX2 的 BasisLZ/Zstd 超压缩需要转码器，当前会抛出异常
+ */
+class TextureContainer
+{
+  public:
+    /**
+     * @brief 根据文件头魔数判断是否为 KTX2 或 DDS 容器
+     */
+    static bool isContainer(const unsigned char *data, size_t size);
+
+    /**
+     * @brief 解析容器头与 mip 索引
+     * @param data 文件内容
+     * @param size 字节数
+     * @param sourceName 错误信息中使用的来源名
+     * @return TextureContainerData 各级 mip 的位置与格式
+     * @throws std::runtime_error 如果容器损坏、越界或使用了不支持的特性
+     */
+    static TextureContainerData parse(const unsigned char *data, size_t size, const std::string &sourceName);
+
+    /**
+     * @brief 获取格式的纹素块信息
+     * @throws std::invalid_argument 如果格式未知
+     */
+    static FormatBlockInfo getFormatBlockInfo(vk::Format format);
+
+    /**
+     * @brief 在同一格式的 UNORM 与 SRGB 变体之间切换
+     * @param format 源格式
+     * @param srgb 目标是否为 sRGB
+     * @return 对应变体；格式没有 sRGB 变体（如 BC4/BC5/BC6H）时原样返回
+     */
+    static vk::Format withColorSpace(vk::Format format, bool srgb);
+
+    /**
+     * @brief 完整 mip 链的级数（floor(log2(max(w, h))) + 1）
+     */
+    static uint32_t getFullMipCount(uint32_t width, uint32_t height);
+
+  private:
+    static TextureContainerData parseKTX2(const unsigned char *data, size_t size, const std::string &sourceName);
+    static TextureContainerData parseDDS(const unsigned char *data, size_t size, const std::string &sourceName);
+};
+
+} // namespace rendercore
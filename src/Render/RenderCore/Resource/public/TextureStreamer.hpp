@@ -0,0 +1,239 @@
+/**
+ * @file TextureStreamer.hpp
+ * @brief 纹理 mip 流送：按屏幕尺寸请求常驻精度，按显存预算以 LRU 淘汰 mip
+ * @details 只流送带预生成 mip 链的 KTX2/DDS 容器纹理：源文件保持映射，任意 mip 都可以随时重新拷入暂存区。
+ *          加载时只上传不超过 Config::minResidentSize 的尾部 mip；场景每帧按物体的屏幕尺寸报告所需精度，
+ *          update() 在预算内为欠精度的纹理创建包含更多 mip 的新图像，上传完成后替换 Texture::image
+ *          并改写 bindless 槽位；长时间未被请求或预算不足（含 MemoryMonitor 的压力回调）时按最近使用时间
+ *          从最久未用的纹理开始降回较少的 mip。
+ *
+ *          没有稀疏绑定时图像的 mip 数不能原地改变，所以每次升降精度都是“新建图像 + 上传常驻 mip + 交换”：
+ *          常驻范围 [residentMip, levelCount)，图像尺寸取 residentMip 一级的尺寸，归一化纹理坐标与采样器无需改变。
+ */
+
+#pragma once
+
+#include "ResourceType.hpp"
+#include "TextureContainer.hpp"
+#include "VulkanCore/public/MemoryMonitor.hpp"
+#include "VulkanCore/public/UploadQueue.hpp"
+#include <glm/glm.hpp>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vma/vk_mem_alloc.h>
+
+namespace vkcore
+{
+class Device;
+class MappedFile;
+} // namespace vkcore
+
+namespace rendercore
+{
+class BindlessRegistry;
+
+/**
+ * @class TextureStreamer
+ * @brief 容器纹理的 mip 常驻管理器（由 ResourceManager 在 bindless 模式下创建）
+ *
+ * @example
+ * @code
+ * rendercore::TextureStreamer *streamer = resourceManager.getTextureStreamer();
+ * monitor.addPressureCallback([streamer](const vkcore::MemoryPressure &pressure) {
+ *     streamer->handleMemoryPressure(pressure);
+ * });
+ *
+ * // 每帧：按可见物体的屏幕尺寸报告所需精度
+ * for (size_t i = 0; i < objects.size(); ++i)
+ * {
+ *     float pixels = rendercore::TextureStreamer::computeScreenSize(center[i], radius[i], cameraPosition, fovY,
+ *                                                                   viewportHeight);
+ *     streamer->requestMaterial(*objects[i].material, pixels);
+ * }
+ * resourceManager.updateTextureStreaming(); // 提交流送上传并替换已完成的纹理
+ * @endcode
+ *
+ * @note track() 可在解码线程上调用，其余接口在渲染线程上调用；所有接口线程安全
+ */
+class TextureStreamer
+{
+  public:
+    /**
+     * @struct Config
+     * @brief 流送策略配置
+     */
+    struct Config
+    {
+        vk::DeviceSize budgetBytes = 0;                      ///< 流送纹理的显存预算（0 表示只受压力回调约束）
+        vk::DeviceSize maxUploadBytesPerFrame = 32ull << 20; ///< 每帧流送上传的字节上限
+        uint32_t minResidentSize = 64;                       ///< 始终常驻的尾部 mip 的最大边长
+        uint32_t evictAfterFrames = 300;                     ///< 连续多少帧未被请求后降回尾部 mip
+        uint32_t pressureCooldownFrames = 120;               ///< 压力回调后多少帧内不再升精度
+        uint32_t framesInFlight = 2;                         ///< 被替换的图像延迟释放的帧数
+    };
+
+    /**
+     * @struct Stats
+     * @brief 流送统计（最近一次 update() 的结果）
+     */
+    struct Stats
+    {
+        uint32_t textureCount{0};         ///< 受流送管理的纹理数量
+        uint32_t pendingCount{0};         ///< 正在上传新 mip 范围的纹理数量
+        uint32_t streamedInCount{0};      ///< 本帧开始升精度的纹理数量
+        uint32_t evictedCount{0};         ///< 本帧开始降精度的纹理数量
+        vk::DeviceSize residentBytes{0};  ///< 常驻 mip 的字节数
+        vk::DeviceSize pendingBytes{0};   ///< 上传中的新图像字节数
+        vk::DeviceSize requestedBytes{0}; ///< 满足全部请求所需的字节数
+        vk::DeviceSize budgetBytes{0};    ///< 配置的预算（0 表示不限）
+    };
+
+    /**
+     * @brief 容器是否可以流送（至少两级预存 mip，且不依赖运行时生成 mip）
+     */
+    static bool isStreamable(const TextureContainerData &container);
+
+    /**
+     * @brief 估算包围球在屏幕上的直径（像素）
+     * @param center 世界空间球心
+     * @param radius 世界空间半径
+     * @param eye 摄像机位置
+     * @param fovY 垂直视场角（弧度）
+     * @param viewportHeight 视口高度（像素）
+     * @return 投影直径；摄像机位于球内时返回 viewportHeight
+     */
+    static float computeScreenSize(const glm::vec3 &center, float radius, const glm::vec3 &eye, float fovY,
+                                   float viewportHeight);
+
+    /**
+     * @brief 构造函数
+     * @param device 逻辑设备
+     * @param allocator VMA 分配器
+     * @param uploadQueue 流送上传使用的上传队列（由 ResourceManager 持有）
+     * @param bindless 全局 bindless 集（替换图像后改写纹理槽位）
+     * @param config 流送策略
+     * @throws std::invalid_argument 如果 bindless 为空
+     */
+    TextureStreamer(vkcore::Device &device, VmaAllocator allocator, vkcore::UploadQueue &uploadQueue,
+                    std::shared_ptr<BindlessRegistry> bindless, const Config &config);
+
+    /** 禁用拷贝与移动 */
+    TextureStreamer(const TextureStreamer &) = delete;
+    TextureStreamer &operator=(const TextureStreamer &) = delete;
+
+    // ==================== 纹理注册 ====================
+
+    /**
+     * @brief 开始流送一个纹理：创建只含尾部 mip 的图像并放入上传批次
+     * @details 设置 texture.image 与 texture.uploadTicket；bindless 槽位仍由调用者注册
+     * @param texture 新建的纹理（尚未发布，流送器只持有弱引用）
+     * @param file 容器所在的文件映射（流送器持有，保证之后可以重新读取任意 mip）
+     * @param container 解析结果（必须满足 isStreamable()，data 指向 file 的映射）
+     * @param format 实际使用的格式（已按 sRGB 请求调整）
+     * @throws std::runtime_error 如果设备不支持该格式的采样或 mip 未按块对齐
+     */
+    void track(const std::shared_ptr<Texture> &texture, std::shared_ptr<const vkcore::MappedFile> file,
+               const TextureContainerData &container, vk::Format format);
+
+    /**
+     * @brief 纹理是否受流送管理
+     */
+    bool isTracked(const Texture &texture) const;
+
+    // ==================== 精度请求 ====================
+
+    /**
+     * @brief 报告纹理在本帧的屏幕覆盖尺寸
+     * @details 所需 mip 为 floor(log2(纹理边长 / screenPixels))；同一帧内多次报告取最高精度，未受管理的纹理被忽略
+     * @param screenPixels 使用该纹理的物体在屏幕上的直径（像素）
+     */
+    void requestResolution(const Texture &texture, float screenPixels);
+
+    /**
+     * @brief 对材质引用的全部纹理调用 requestResolution()
+     */
+    void requestMaterial(const Material &material, float screenPixels);
+
+    // ==================== 每帧更新 ====================
+
+    /**
+     * @brief 推进一帧：替换上传完成的纹理，按预算选择升/降精度的纹理并放入上传批次
+     * @return 本帧替换了图像（因而 bindless 槽位已改变）的纹理，引用它们的材质需要重新写入参数
+     * @warning 在渲染线程的帧间调用；替换后的旧图像在 framesInFlight 次 update() 后才释放
+     */
+    std::vector<std::shared_ptr<Texture>> update();
+
+    /**
+     * @brief 处理 MemoryMonitor 的压力回调：下一次 update() 按 LRU 淘汰 bytesToFree 字节的 mip，并暂停升精度
+     */
+    void handleMemoryPressure(const vkcore::MemoryPressure &pressure);
+
+    // ==================== 配置与统计 ====================
+
+    void setConfig(const Config &config);
+
+    Config getConfig() const;
+
+    Stats getStats() const;
+
+  private:
+    /**
+     * @struct StreamedTexture
+     * @brief 一个受流送管理的纹理
+     */
+    struct StreamedTexture
+    {
+        std::weak_ptr<Texture> texture;
+        std::shared_ptr<const vkcore::MappedFile> file; ///< 保持 container.data 有效
+        TextureContainerData container;
+        vk::Format format{vk::Format::eUndefined};
+        FormatBlockInfo blockInfo;
+
+        uint32_t tailMip{0};      ///< 始终常驻的最高 mip（不超过 minResidentSize 的第一级）
+        uint32_t residentMip{0};  ///< 当前图像的 mip 0 对应的源 mip
+        uint32_t requestedMip{0}; ///< 最近一次被请求的帧所需的 mip
+        uint64_t lastUsedFrame{0};
+
+        std::shared_ptr<vkcore::Image> pendingImage; ///< 上传中的新图像
+        uint32_t pendingMip{0};
+        vkcore::UploadTicket pendingTicket{0};
+    };
+
+    /**
+     * @struct RetiredImage
+     * @brief 被替换、等待在途帧结束的旧图像
+     */
+    struct RetiredImage
+    {
+        std::shared_ptr<vkcore::Image> image;
+        uint64_t frame; ///< 替换时的帧计数
+    };
+
+    vk::DeviceSize levelbytes(const StreamedTexture &entry, uint32_t baseMip) const;
+    std::shared_ptr<vkcore::Image> createimage(const StreamedTexture &entry, uint32_t baseMip,
+                                               vkcore::UploadTicket &ticket);
+    void beginresidency(StreamedTexture &entry, uint32_t baseMip);
+    bool completeresidency(StreamedTexture &entry, const std::shared_ptr<Texture> &texture);
+    uint32_t targetmip(const StreamedTexture &entry) const;
+
+  private:
+    vkcore::Device &m_device;
+    VmaAllocator m_allocator;
+    vkcore::UploadQueue &m_uploadQueue;
+    std::shared_ptr<BindlessRegistry> m_bindless;
+    Config m_config;
+
+    std::unordered_map<const Texture *, StreamedTexture> m_textures;
+    std::vector<RetiredImage> m_retiredImages;
+    uint64_t m_frame{1};
+
+    vk::DeviceSize m_pressureBytes{0}; ///< 下一次 update() 需要淘汰的字节数
+    uint64_t m_pressureUntilFrame{0};  ///< 在此帧之前不升精度
+    Stats m_stats;
+
+    mutable std::mutex m_mtx;
+};
+
+} // namespace rendercore
@@ -0,0 +1,321 @@
+/**
+ * @file VertexLayout.hpp
+ * @brief 编译期顶点布局：以属性类型列表声明 GPU 顶点格式，生成顶点输入状态与编码函数
+ * @details 每个属性类型描述一种编码（着色器 location、Vulkan 格式、字节数与从 Vertex 的编码方式），
+ *          VertexLayout<Attributes...> 按声明顺序紧密排列属性，步长、偏移与
+ *          vk::PipelineVertexInputStateCreateInfo 都在编译期确定；省略某个属性即不在列表中声明它。
+ *
+ *          Vertex 仍是导入、简化、优化与烘焙文件使用的规范格式，只在上传到几何池时编码为网格的 VertexFormat：
+ *          - Standard：与 Vertex 的内存布局完全一致（48 字节），源数据超出紧凑编码的范围时使用；
+ *          - Compact：float3 位置 + 八面体 snorm16 法线 + half2 纹理坐标 + RGBA8 颜色（24 字节）；
+ *          - CompactNoColor：省略颜色（20 字节），着色器中颜色视为白色。
+ *
+ *          紧凑格式的法线以八面体映射存放在 R16G16_SNORM 中，顶点着色器需要用 octdecode() 恢复：
+ *          n = vec3(e, 1 - |e.x| - |e.y|); if (n.z < 0) n.xy = (1 - |n.yx|) * sign(n.xy); n = normalize(n)
+ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <glm/glm.hpp>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace rendercore
+{
+struct Vertex;
+
+/**
+ * @enum VertexFormat
+ * @brief 网格在几何池中的顶点格式（同一 Arena 中的网格格式相同）
+ */
+enum class VertexFormat : uint8_t
+{
+    Standard,       ///< StandardVertexLayout（48 字节，与 Vertex 一致）
+    Compact,        ///< CompactVertexLayout（24 字节）
+    CompactNoColor, ///< CompactNoColorVertexLayout（20 字节）
+    Count,
+};
+
+// ==================== 属性编码 ====================
+
+/**
+ * @brief 把单位向量编码为八面体映射上的二维坐标（[-1, 1]²）
+ * @details 零向量编码为 (0, 0)，解码为 +Z
+ */
+inline glm::vec2 octencode(const glm::vec3 &normal)
+{
+    const float sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (sum <= 0.0f)
+    {
+        return glm::vec2(0.0f);
+    }
+    glm::vec2 encoded = glm::vec2(normal.x, normal.y) / sum;
+    if (normal.z < 0.0f)
+    {
+        const glm::vec2 folded = glm::vec2(1.0f) - glm::abs(glm::vec2(encoded.y, encoded.x));
+        encoded = glm::vec2(encoded.x >= 0.0f ? folded.x : -folded.x, encoded.y >= 0.0f ? folded.y : -folded.y);
+    }
+    return encoded;
+}
+
+/**
+ * @brief 八面体坐标解码为单位向量（与着色器中的 octdecode() 一致）
+ */
+inline glm::vec3 octdecode(const glm::vec2 &encoded)
+{
+    glm::vec3 normal(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+    if (normal.z < 0.0f)
+    {
+        const glm::vec2 folded = glm::vec2(1.0f) - glm::abs(glm::vec2(normal.y, normal.x));
+        normal.x = normal.x >= 0.0f ? folded.x : -folded.x;
+        normal.y = normal.y >= 0.0f ? folded.y : -folded.y;
+    }
+    return glm::normalize(normal);
+}
+
+/**
+ * @brief 属性编码的公共实现：把 value 的字节写入目标位置（目标不要求对齐）
+ */
+template <typename T>
+inline void storeattribute(std::byte *dst, const T &value)
+{
+    std::memcpy(dst, &value, sizeof(T));
+}
+
+/** 位置：R32G32B32_SFLOAT */
+struct PositionFloat3
+{
+    static constexpr uint32_t kLocation = 0;
+    static constexpr vk::Format kFormat = vk::Format::eR32G32B32Sfloat;
+    static constexpr uint32_t kSize = 12;
+
+    template <typename V>
+    static void encode(const V &vertex, std::byte *dst)
+    {
+        storeattribute(dst, vertex.position);
+    }
+};
+
+/** 法线：R32G32B32_SFLOAT */
+struct NormalFloat3
+{
+    static constexpr uint32_t kLocation = 1;
+    static constexpr vk::Format kFormat = vk::Format::eR32G32B32Sfloat;
+    static constexpr uint32_t kSize = 12;
+
+    template <typename V>
+    static void encode(const V &vertex, std::byte *dst)
+    {
+        storeattribute(dst, vertex.normal);
+    }
+};
+
+/** 法线：八面体映射，R16G16_SNORM（角度误差不超过约 0.04°） */
+struct NormalOct16
+{
+    static constexpr uint32_t kLocation = 1;
+    static constexpr vk::Format kFormat = vk::Format::eR16G16Snorm;
+    static constexpr uint32_t kSize = 4;
+
+    template <typename V>
+    static void encode(const V &vertex, std::byte *dst)
+    {
+        storeattribute(dst, glm::packSnorm2x16(octencode(vertex.normal)));
+    }
+};
+
+/** 纹理坐标：R32G32_SFLOAT */
+struct TexCoordFloat2
+{
+    static constexpr uint32_t kLocation = 2;
+    static constexpr vk::Format kFormat = vk::Format::eR32G32Sfloat;
+    static constexpr uint32_t kSize = 8;
+
+    template <typename V>
+    static void encode(const V &vertex, std::byte *dst)
+    {
+        storeattribute(dst, vertex.texCoord);
+    }
+};
+
+/** 纹理坐标：R16G16_SFLOAT（|uv| 不超过 2 时误差不大于 1/2048） */
+struct TexCoordHalf2
+{
+    static constexpr uint32_t kLocation = 2;
+    static constexpr vk::Format kFormat = vk::Format::eR16G16Sfloat;
+    static constexpr uint32_t kSize = 4;
+
+    template <typename V>
+    static void encode(const V &vertex, std::byte *dst)
+    {
+        storeattribute(dst, glm::packHalf2x16(vertex.texCoord));
+    }
+};
+
+/** 颜色：R32G32B32A32_SFLOAT */
+struct ColorFloat4
+{
+    static constexpr uint32_t kLocation = 3;
+    static constexpr vk::Format kFormat = vk::Format::eR32G32B32A32Sfloat;
+    static constexpr uint32_t kSize = 16;
+
+    template <typename V>
+    static void encode(const V &vertex, std::byte *dst)
+    {
+        storeattribute(dst, vertex.color);
+    }
+};
+
+/** 颜色：R8G8B8A8_UNORM（分量须在 [0, 1] 内） */
+struct ColorUnorm8
+{
+    static constexpr uint32_t kLocation = 3;
+    static constexpr vk::Format kFormat = vk::Format::eR8G8B8A8Unorm;
+    static constexpr uint32_t kSize = 4;
+
+    template <typename V>
+    static void encode(const V &vertex, std::byte *dst)
+    {
+        storeattribute(dst, glm::packUnorm4x8(vertex.color));
+    }
+};
+
+// ==================== 布局 ====================
+
+/**
+ * @brief 按声明顺序累加偏移，生成属性描述
+ */
+template <typename... Attributes>
+constexpr std::array<vk::VertexInputAttributeDescription, sizeof...(Attributes)> makevertexattributes(uint32_t binding)
+{
+    std::array<vk::VertexInputAttributeDescription, sizeof...(Attributes)> attributes{};
+    uint32_t index = 0;
+    uint32_t offset = 0;
+    ((attributes[index++] =
+          vk::VertexInputAttributeDescription(Attributes::kLocation, binding, Attributes::kFormat, offset),
+      offset += Attributes::kSize),
+     ...);
+    return attributes;
+}
+
+/**
+ * @struct VertexLayout
+ * @brief 由属性类型列表组成的交错顶点布局（单一绑定 0，属性按声明顺序紧密排列）
+ * @tparam Attributes 属性编码类型（需提供 kLocation、kFormat、kSize 与 encode()）
+ * @note 各属性的 location 在所有布局中一致：位置 0、法线 1、纹理坐标 2、颜色 3，省略的属性不占用 location
+ *
+ * @example
+ * @code
+ * using Layout = rendercore::CompactVertexLayout;
+ * static_assert(Layout::kStride == 24);
+ * builder.setVertexInput(Layout::getInputState());
+ *
+ * std::vector<std::byte> packed(vertices.size() * Layout::kStride);
+ * Layout::encode(vertices.data(), vertices.size(), packed.data());
+ * @endcode
+ */
+template <typename... Attributes>
+struct VertexLayout
+{
+    static constexpr uint32_t kBinding = 0;
+    static constexpr uint32_t kAttributeCount = sizeof...(Attributes);
+    static constexpr uint32_t kStride = (Attributes::kSize + ... + 0);
+
+    static_assert(kAttributeCount > 0, "VertexLayout: at least one attribute is required");
+    static_assert(kStride % 4 == 0, "VertexLayout: stride must be a multiple of 4 bytes");
+
+    static constexpr vk::VertexInputBindingDescription kBindingDescription{kBinding, kStride,
+                                                                           vk::VertexInputRate::eVertex};
+
+    static constexpr std::array<vk::VertexInputAttributeDescription, kAttributeCount> kAttributeDescriptions =
+        makevertexattributes<Attributes...>(kBinding);
+
+    /**
+     * @brief 获取顶点输入状态（指向静态数组，可直接传给 PipelineBuilder::setVertexInput）
+     */
+    static constexpr vk::PipelineVertexInputStateCreateInfo getInputState()
+    {
+        return vk::PipelineVertexInputStateCreateInfo({}, 1, &kBindingDescription, kAttributeCount,
+                                                      kAttributeDescriptions.data());
+    }
+
+    /**
+     * @brief 编码一个顶点
+     * @param vertex 源顶点（需提供 position/normal/texCoord/color 中被声明的成员）
+     * @param dst 目标地址（kStride 字节，不要求对齐）
+     */
+    template <typename V>
+    static void encode(const V &vertex, std::byte *dst)
+    {
+        uint32_t offset = 0;
+        ((Attributes::encode(vertex, dst + offset), offset += Attributes::kSize), ...);
+    }
+
+    /**
+     * @brief 编码顶点数组
+     * @param dst 目标地址（count * kStride 字节）
+     */
+    template <typename V>
+    static void encode(const V *vertices, size_t count, std::byte *dst)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            encode(vertices[i], dst + i * kStride);
+        }
+    }
+};
+
+using StandardVertexLayout = VertexLayout<ColorFloat4, PositionFloat3, NormalFloat3, TexCoordFloat2>;
+using CompactVertexLayout = VertexLayout<PositionFloat3, NormalOct16, TexCoordHalf2, ColorUnorm8>;
+using CompactNoColorVertexLayout = VertexLayout<PositionFloat3, NormalOct16, TexCoordHalf2>;
+
+// ==================== 运行时选择 ====================
+
+/**
+ * @struct VertexFormatInfo
+ * @brief 一种 VertexFormat 的运行时描述
+ */
+struct VertexFormatInfo
+{
+    const char *name;                                  ///< 格式名称（用于日志与统计）
+    uint32_t stride;                                   ///< 单个顶点的字节数
+    vk::PipelineVertexInputStateCreateInfo inputState; ///< 顶点输入状态（指向静态数组）
+};
+
+/**
+ * @class VertexLayouts
+ * @brief VertexFormat 与编译期布局之间的运行时分派（无状态，线程安全）
+ */
+class VertexLayouts
+{
+  public:
+    static constexpr float kMaxHalfTexCoord = 2.0f; ///< 使用 half 纹理坐标时允许的最大 |uv|
+
+    /**
+     * @brief 获取格式描述
+     * @throws std::invalid_argument 如果 format 无效
+     */
+    static const VertexFormatInfo &getInfo(VertexFormat format);
+
+    /**
+     * @brief 选择能无损（在各属性的编码精度内）表示源数据的最小格式
+     * @details 颜色全为白色时省略颜色；颜色超出 [0, 1] 或纹理坐标超出 ±kMaxHalfTexCoord 时退回 Standard
+     * @param vertices 规范格式顶点
+     * @param count 顶点数量
+     */
+    static VertexFormat select(const Vertex *vertices, size_t count);
+
+    /**
+     * @brief 把规范格式顶点编码为目标格式
+     * @return 编码后的字节（count * getInfo(format).stride）
+     * @throws std::invalid_argument 如果 format 无效
+     */
+    static std::vector<std::byte> encode(VertexFormat format, const Vertex *vertices, size_t count);
+};
+
+} // namespace rendercore
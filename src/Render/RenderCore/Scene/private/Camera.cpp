@@ -15,9 +15,10 @@ Camera::~Camera()
 {
 }
 
-glm::mat4 Camera::getViewMatrix() const
+const glm::mat4 &Camera::getViewMatrix() const
 {
-    return glm::lookAt(m_position, m_position + m_front, m_up);
+    updatecache();
+    return m_viewMatrix;
 }
 
 const glm::mat4 &Camera::getProjectionMatrix() const
@@ -25,11 +26,33 @@ const glm::mat4 &Camera::getProjectionMatrix() const
     return m_projectionMatrix;
 }
 
+const glm::mat4 &Camera::getViewProjectionMatrix() const
+{
+    updatecache();
+    return m_viewProjectionMatrix;
+}
+
+const Frustum &Camera::getFrustum() const
+{
+    updatecache();
+    return m_frustum;
+}
+
 const glm::vec3 &Camera::getPosition() const
 {
     return m_position;
 }
 
+float Camera::getNearPlane() const
+{
+    return m_zNear;
+}
+
+float Camera::getFarPlane() const
+{
+    return m_zFar;
+}
+
 const glm::vec3 &Camera::getFront() const
 {
     return m_front;
@@ -41,11 +64,13 @@ void Camera::setPerspective(float fovY, float aspectRatio, float zNear, float zF
     m_aspect = aspectRatio;
     m_zNear = zNear;
     m_zFar = zFar;
+    m_viewProjectionDirty = true;
 }
 
 void Camera::setPosition(const glm::vec3 &position)
 {
     m_position = position;
+    m_viewDirty = true;
 }
 
 void Camera::setRotation(float yaw, float pitch)
@@ -70,6 +95,7 @@ void Camera::processKeyboard(CameraMovement direction, float deltaTime)
         m_position += m_up * velocity;
     if (direction == CameraMovement::DOWN)
         m_position -= m_up * velocity;
+    m_viewDirty = true;
 }
 
 void Camera::processMouseMovement(float xoffset, float yoffset, bool constrainPitch)
@@ -116,6 +142,23 @@ void Camera::updateCameraVectors()
     m_front = glm::normalize(front);
     m_right = glm::normalize(glm::cross(m_front, m_worldUp));
     m_up = glm::normalize(glm::cross(m_right, m_front));
+    m_viewDirty = true;
+}
+
+void Camera::updatecache() const
+{
+    if (m_viewDirty)
+    {
+        m_viewMatrix = glm::lookAt(m_position, m_position + m_front, m_up);
+        m_viewDirty = false;
+        m_viewProjectionDirty = true;
+    }
+    if (m_viewProjectionDirty)
+    {
+        m_viewProjectionMatrix = m_projectionMatrix * m_viewMatrix;
+        m_frustum = Frustum(m_viewProjectionMatrix);
+        m_viewProjectionDirty = false;
+    }
 }
 
 } // namespace rendercore
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include "Frustum.hpp"
+#include "VulkanCore/public/Profiler.hpp"
+#include "VulkanCore/public/WorkerPool.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define QTRENDER_CULL_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define QTRENDER_CULL_SSE 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define QTRENDER_CULL_NEON 1
+#endif
+
+namespace rendercore
+{
+
+namespace
+{
+
+/**
+ * @brief 剔除所需的平面数据（法线绝对值预先算好，用于求包围盒在法线上的投影半径）
+ */
+struct CullPlanes
+{
+    float nx[Frustum::PlaneCount];
+    float ny[Frustum::PlaneCount];
+    float nz[Frustum::PlaneCount];
+    float d[Frustum::PlaneCount];
+    float ax[Frustum::PlaneCount];
+    float ay[Frustum::PlaneCount];
+    float az[Frustum::PlaneCount];
+};
+
+/**
+ * @brief 标量剔除 [begin, end)，用于无 SIMD 的平台与 SIMD 宽度之外的尾部
+ */
+size_t cullscalar(const CullPlanes &planes, const CullingBounds &bounds, size_t begin, size_t end, uint32_t *out)
+{
+    size_t visibleCount = 0;
+    for (size_t i = begin; i < end; ++i)
+    {
+        bool visible = true;
+        for (uint32_t p = 0; p < Frustum::PlaneCount && visible; ++p)
+        {
+            float distance = planes.nx[p] * bounds.centerX[i] + planes.ny[p] * bounds.centerY[i] +
+                             planes.nz[p] * bounds.centerZ[i] + planes.d[p];
+            float radius = planes.ax[p] * bounds.extentX[i] + planes.ay[p] * bounds.extentY[i] +
+                           planes.az[p] * bounds.extentZ[i];
+            visible = distance + radius >= 0.0f;
+        }
+        if (visible)
+        {
+            out[visibleCount++] = static_cast<uint32_t>(i);
+        }
+    }
+    return visibleCount;
+}
+
+/**
+ * @brief 把位掩码中的置位展开为索引
+ */
+size_t emitmask(uint32_t mask, size_t base, uint32_t *out)
+{
+    size_t visibleCount = 0;
+    while (mask != 0)
+    {
+        out[visibleCount++] = static_cast<uint32_t>(base + std::countr_zero(mask));
+        mask &= mask - 1;
+    }
+    return visibleCount;
+}
+
+/**
+ * @brief 由视锥平面生成剔除用的平面数据
+ */
+CullPlanes makecullplanes(const glm::vec4 (&frustumPlanes)[Frustum::PlaneCount])
+{
+    CullPlanes planes;
+    for (uint32_t p = 0; p < Frustum::PlaneCount; ++p)
+    {
+        planes.nx[p] = frustumPlanes[p].x;
+        planes.ny[p] = frustumPlanes[p].y;
+        planes.nz[p] = frustumPlanes[p].z;
+        planes.d[p] = frustumPlanes[p].w;
+        planes.ax[p] = std::fabs(frustumPlanes[p].x);
+        planes.ay[p] = std::fabs(frustumPlanes[p].y);
+        planes.az[p] = std::fabs(frustumPlanes[p].z);
+    }
+    return planes;
+}
+
+/**
+ * @brief 剔除 [begin, end)，可见索引按升序写入 out
+ */
+size_t cullrange(const CullPlanes &planes, const CullingBounds &bounds, size_t begin, size_t end, uint32_t *out)
+{
+    size_t visibleCount = 0;
+    size_t i = begin;
+
+#if defined(QTRENDER_CULL_AVX)
+    for (; i + 8 <= end; i += 8)
+    {
+        const __m256 cx = _mm256_loadu_ps(bounds.centerX.data() + i);
+        const __m256 cy = _mm256_loadu_ps(bounds.centerY.data() + i);
+        const __m256 cz = _mm256_loadu_ps(bounds.centerZ.data() + i);
+        const __m256 ex = _mm256_loadu_ps(bounds.extentX.data() + i);
+        const __m256 ey = _mm256_loadu_ps(bounds.extentY.data() + i);
+        const __m256 ez = _mm256_loadu_ps(bounds.extentZ.data() + i);
+
+        __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (uint32_t p = 0; p < Frustum::PlaneCount; ++p)
+        {
+            __m256 distance = _mm256_mul_ps(_mm256_set1_ps(planes.nx[p]), cx);
+            distance = _mm256_add_ps(distance, _mm256_set1_ps(planes.d[p]));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.ny[p]), cy));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.nz[p]), cz));
+            __m256 radius = _mm256_mul_ps(_mm256_set1_ps(planes.ax[p]), ex);
+            radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_set1_ps(planes.ay[p]), ey));
+            radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_set1_ps(planes.az[p]), ez));
+            __m256 inside = _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GE_OQ);
+            visible = _mm256_and_ps(visible, inside);
+        }
+        visibleCount += emitmask(static_cast<uint32_t>(_mm256_movemask_ps(visible)), i, out + visibleCount);
+    }
+#elif defined(QTRENDER_CULL_SSE)
+    for (; i + 4 <= end; i += 4)
+    {
+        const __m128 cx = _mm_loadu_ps(bounds.centerX.data() + i);
+        const __m128 cy = _mm_loadu_ps(bounds.centerY.data() + i);
+        const __m128 cz = _mm_loadu_ps(bounds.centerZ.data() + i);
+        const __m128 ex = _mm_loadu_ps(bounds.extentX.data() + i);
+        const __m128 ey = _mm_loadu_ps(bounds.extentY.data() + i);
+        const __m128 ez = _mm_loadu_ps(bounds.extentZ.data() + i);
+
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (uint32_t p = 0; p < Frustum::PlaneCount; ++p)
+        {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.nx[p]), cx), _mm_set1_ps(planes.d[p]));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.ny[p]), cy));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.nz[p]), cz));
+            __m128 radius = _mm_mul_ps(_mm_set1_ps(planes.ax[p]), ex);
+            radius = _mm_add_ps(radius, _mm_mul_ps(_mm_set1_ps(planes.ay[p]), ey));
+            radius = _mm_add_ps(radius, _mm_mul_ps(_mm_set1_ps(planes.az[p]), ez));
+            visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+        visibleCount += emitmask(static_cast<uint32_t>(_mm_movemask_ps(visible)), i, out + visibleCount);
+    }
+#elif defined(QTRENDER_CULL_NEON)
+    for (; i + 4 <= end; i += 4)
+    {
+        const float32x4_t cx = vld1q_f32(bounds.centerX.data() + i);
+        const float32x4_t cy = vld1q_f32(bounds.centerY.data() + i);
+        const float32x4_t cz = vld1q_f32(bounds.centerZ.data() + i);
+        const float32x4_t ex = vld1q_f32(bounds.extentX.data() + i);
+        const float32x4_t ey = vld1q_f32(bounds.extentY.data() + i);
+        const float32x4_t ez = vld1q_f32(bounds.extentZ.data() + i);
+
+        uint32x4_t visible = vdupq_n_u32(0xFFFFFFFFu);
+        for (uint32_t p = 0; p < Frustum::PlaneCount; ++p)
+        {
+            float32x4_t distance = vmlaq_n_f32(vdupq_n_f32(planes.d[p]), cx, planes.nx[p]);
+            distance = vmlaq_n_f32(distance, cy, planes.ny[p]);
+            distance = vmlaq_n_f32(distance, cz, planes.nz[p]);
+            float32x4_t radius = vmulq_n_f32(ex, planes.ax[p]);
+            radius = vmlaq_n_f32(radius, ey, planes.ay[p]);
+            radius = vmlaq_n_f32(radius, ez, planes.az[p]);
+            visible = vandq_u32(visible, vcgeq_f32(vaddq_f32(distance, radius), vdupq_n_f32(0.0f)));
+        }
+        uint32_t mask = (vgetq_lane_u32(visible, 0) & 1u) | (vgetq_lane_u32(visible, 1) & 2u) |
+                        (vgetq_lane_u32(visible, 2) & 4u) | (vgetq_lane_u32(visible, 3) & 8u);
+        visibleCount += emitmask(mask, i, out + visibleCount);
+    }
+#endif
+
+    visibleCount += cullscalar(planes, bounds, i, end, out + visibleCount);
+    return visibleCount;
+}
+
+} // namespace
+
+Frustum::Frustum(const glm::mat4 &viewProjection, DepthRange depthRange)
+{
+    // glm 为列主序：第 i 行为 (m[0][i], m[1][i], m[2][i], m[3][i])
+    auto row = [&viewProjection](int i) {
+        return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    };
+
+    const glm::vec4 row0 = row(0);
+    const glm::vec4 row1 = row(1);
+    const glm::vec4 row2 = row(2);
+    const glm::vec4 row3 = row(3);
+
+    m_planes[Left] = row3 + row0;
+    m_planes[Right] = row3 - row0;
+    m_planes[Bottom] = row3 + row1;
+    m_planes[Top] = row3 - row1;
+    // 近平面：[-1, 1] 时 z >= -w，[0, 1] 时 z >= 0
+    m_planes[Near] = depthRange == DepthRange::ZeroToOne ? row2 : row3 + row2;
+    m_planes[Far] = row3 - row2;
+
+    for (glm::vec4 &plane : m_planes)
+    {
+        float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f)
+        {
+            plane /= length;
+        }
+    }
+}
+
+const glm::vec4 &Frustum::getPlane(Plane plane) const
+{
+    return m_planes[plane];
+}
+
+bool Frustum::intersects(const glm::vec3 &center, const glm::vec3 &extents) const
+{
+    for (const glm::vec4 &plane : m_planes)
+    {
+        glm::vec3 normal(plane);
+        float distance = glm::dot(normal, center) + plane.w;
+        float radius = glm::dot(glm::abs(normal), extents);
+        if (distance + radius < 0.0f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t Frustum::cull(const CullingBounds &bounds, std::vector<uint32_t> &visibleIndices) const
+{
+    const size_t count = bounds.size();
+    visibleIndices.resize(count);
+
+    const size_t visibleCount = cullrange(makecullplanes(m_planes), bounds, 0, count, visibleIndices.data());
+    visibleIndices.resize(visibleCount);
+    return visibleCount;
+}
+
+size_t Frustum::cull(const CullingBounds &bounds, std::vector<uint32_t> &visibleIndices,
+                     vkcore::WorkerPool *workers) const
+{
+    const size_t count = bounds.size();
+    if (!workers || count < 2 * kParallelCullChunk)
+    {
+        return cull(bounds, visibleIndices);
+    }
+
+    QTR_PROFILE_SCOPE("Frustum::cull(parallel)");
+    visibleIndices.resize(count);
+    uint32_t *out = visibleIndices.data();
+    const CullPlanes planes = makecullplanes(m_planes);
+
+    // 每块把可见索引写到自己区间的开头，之后按块顺序前移拼接，结果仍为升序
+    const uint32_t chunkCount = static_cast<uint32_t>((count + kParallelCullChunk - 1) / kParallelCullChunk);
+    std::vector<size_t> chunkVisible(chunkCount);
+    workers->parallelFor(chunkCount, [&](uint32_t chunk) {
+        const size_t begin = static_cast<size_t>(chunk) * kParallelCullChunk;
+        const size_t end = std::min(begin + kParallelCullChunk, count);
+        chunkVisible[chunk] = cullrange(planes, bounds, begin, end, out + begin);
+    });
+
+    size_t visibleCount = chunkVisible[0];
+    for (uint32_t chunk = 1; chunk < chunkCount; ++chunk)
+    {
+        const uint32_t *source = out + static_cast<size_t>(chunk) * kParallelCullChunk;
+        std::copy(source, source + chunkVisible[chunk], out + visibleCount);
+        visibleCount += chunkVisible[chunk];
+    }
+    visibleIndices.resize(visibleCount);
+    return visibleCount;
+}
+
+} // namespace rendercore
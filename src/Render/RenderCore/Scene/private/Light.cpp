@@ -21,6 +21,7 @@ DirectionalLight::DirectionalLight(const std::string &name) : Light(LightType::D
 void DirectionalLight::setDirection(const glm::vec3 &direction)
 {
     m_direction = glm::normalize(direction);
+    markdirty();
 }
 
 // ==================== PointLight实现 ====================
@@ -50,6 +51,13 @@ void PointLight::setAttenuation(float constant, float linear, float quadratic)
     m_constant = std::max(constant, 0.0f);
     m_linear = std::max(linear, 0.0f);
     m_quadratic = std::max(quadratic, 0.0f);
+    markdirty();
+}
+
+void PointLight::setRange(float range)
+{
+    m_range = std::max(range, 0.0f);
+    markdirty();
 }
 
 // ==================== SpotLight实现 ====================
@@ -61,6 +69,7 @@ SpotLight::SpotLight(const std::string &name) : Light(LightType::Spot, name)
 void SpotLight::setDirection(const glm::vec3 &direction)
 {
     m_direction = glm::normalize(direction);
+    markdirty();
 }
 
 float SpotLight::calculateAttenuation(const glm::vec3 &worldPos) const
@@ -97,6 +106,7 @@ void SpotLight::setCutoff(float innerCutoffDegrees, float outerCutoffDegrees)
     {
         std::swap(m_innerCutoff, m_outerCutoff);
     }
+    markdirty();
 }
 
 void SpotLight::setAttenuation(float constant, float linear, float quadratic)
@@ -104,6 +114,13 @@ void SpotLight::setAttenuation(float constant, float linear, float quadratic)
     m_constant = std::max(constant, 0.0f);
     m_linear = std::max(linear, 0.0f);
     m_quadratic = std::max(quadratic, 0.0f);
+    markdirty();
+}
+
+void SpotLight::setRange(float range)
+{
+    m_range = std::max(range, 0.0f);
+    markdirty();
 }
 
 // ==================== 创建标准光照 ====================
@@ -130,6 +147,7 @@ std::shared_ptr<PointLight> LightFactory::createPointLight(const glm::vec3 &posi
     // 根据范围计算衰减参数
     glm::vec3 attenuation = calculateAttenuationFromRange(range);
     light->setAttenuation(attenuation.x, attenuation.y, attenuation.z);
+    light->setRange(range);
 
     return light;
 }
@@ -148,6 +166,7 @@ std::shared_ptr<SpotLight> LightFactory::createSpotLight(const glm::vec3 &positi
     // 根据范围计算衰减参数
     glm::vec3 attenuation = calculateAttenuationFromRange(range);
     light->setAttenuation(attenuation.x, attenuation.y, attenuation.z);
+    light->setRange(range);
 
     return light;
 }
@@ -2,8 +2,10 @@
 #include "Camera.hpp"                       // Camera现在在同一模块中
 #include "Light.hpp"                        // 包含Light类
 #include "Resource/public/ResourceType.hpp" // 包含Mesh和Material的具体定义
+#include "VulkanCore/public/Log.hpp"
+#include "VulkanCore/public/Profiler.hpp"
 #include <algorithm>
-#include <iostream>
+#include <cmath>
 
 
 namespace rendercore
@@ -13,6 +15,7 @@ Scene::Scene()
 {
     // 创建根节点
     m_rootNode = std::make_shared<SceneNode>("RootNode");
+    m_storage = std::make_unique<SceneStorage>(*m_rootNode);
 }
 
 Scene::~Scene() = default;
@@ -32,64 +35,152 @@ std::shared_ptr<Camera> Scene::getCamera() const
     return m_activeCamera;
 }
 
-std::vector<RenderObject> Scene::getRenderObjects()
+std::span<const RenderObject> Scene::getRenderObjects()
 {
-    std::vector<RenderObject> renderList;
+    QTR_PROFILE_SCOPE("Scene::getRenderObjects");
+    m_storage->update();
+    return m_storage->getRenderObjects();
+}
 
-    if (m_rootNode)
+std::span<const RenderObject> Scene::getVisibleRenderObjects()
+{
+    if (!m_activeCamera)
     {
-        traversescene(m_rootNode, renderList);
+        return getRenderObjects();
     }
 
-    return renderList;
+    return getVisibleRenderObjects(m_activeCamera->getFrustum());
 }
 
-void Scene::traversescene(std::shared_ptr<SceneNode> node, std::vector<RenderObject> &renderList)
+std::span<const RenderObject> Scene::getVisibleRenderObjects(const Frustum &frustum)
 {
-    if (!node)
+    QTR_PROFILE_SCOPE("Scene::getVisibleRenderObjects");
+    m_storage->update();
+
+    // 先在 SoA 包围盒上批量剔除，只提取可见对象
+    frustum.cull(m_storage->getWorldBounds(), m_visibleIndices, m_workers);
+
+    std::span<const RenderObject> renderObjects = m_storage->getRenderObjects();
+    m_visibleRenderObjects.resize(m_visibleIndices.size());
+    for (size_t i = 0; i < m_visibleIndices.size(); ++i)
+    {
+        m_visibleRenderObjects[i] = renderObjects[m_visibleIndices[i]];
+    }
+
+    selectlods();
+    return m_visibleRenderObjects;
+}
+
+void Scene::setLodSelection(const LodSelectionSettings &settings)
+{
+    m_lodSelection = settings;
+}
+
+void Scene::setWorkerPool(vkcore::WorkerPool *workers)
+{
+    m_workers = workers;
+    m_storage->setWorkerPool(workers);
+}
+
+void Scene::selectlods()
+{
+    QTR_PROFILE_SCOPE("Scene::selectlods");
+    if (!m_lodSelection.enabled || !m_activeCamera)
     {
         return;
     }
 
-    // 如果节点有可渲染组件且可见，添加到渲染列表
-    if (node->hasRenderable())
+    // 渲染对象下标随列表重建而改变，上一帧的选择不再对应同一个对象
+    const size_t objectCount = m_storage->getRenderObjects().size();
+    if (m_lodLevelsVersion != m_storage->getRenderObjectsVersion() || m_lodLevels.size() != objectCount)
     {
-        const Renderable &renderable = node->getRenderable();
-        if (renderable.visible && renderable.mesh && renderable.material)
-        {
-            RenderObject renderObject;
-            renderObject.renderable = renderable;
-            renderObject.worldMatrix = node->getWorldMatrix();
-            renderList.push_back(renderObject);
-        }
+        m_lodLevels.assign(objectCount, 0);
+        m_lodLevelsVersion = m_storage->getRenderObjectsVersion();
     }
 
-    // 递归遍历所有子节点
-    for (const auto &child : node->getChildren())
+    const CullingBounds &bounds = m_storage->getWorldBounds();
+    const glm::vec3 &eye = m_activeCamera->getPosition();
+    // 投影半径（像素）= 半径 * P[1][1] / 距离 * 视口高度 / 2
+    const float pixelScale =
+        std::abs(m_activeCamera->getProjectionMatrix()[1][1]) * 0.5f * m_lodSelection.viewportHeight;
+    const float threshold = m_lodSelection.pixelError;
+    const float coarserThreshold = threshold * (1.0f - m_lodSelection.hysteresis);
+    const float keepThreshold = threshold * (1.0f + m_lodSelection.hysteresis);
+
+    for (size_t i = 0; i < m_visibleIndices.size(); ++i)
     {
-        traversescene(child, renderList);
+        RenderObject &object = m_visibleRenderObjects[i];
+        const uint32_t index = m_visibleIndices[i];
+        if (!object.mesh || object.mesh->lods.size() < 2)
+        {
+            object.lod = 0;
+            continue;
+        }
+
+        const glm::vec3 center(bounds.centerX[index], bounds.centerY[index], bounds.centerZ[index]);
+        const float radius =
+            glm::length(glm::vec3(bounds.extentX[index], bounds.extentY[index], bounds.extentZ[index]));
+        const float distance = glm::length(center - eye);
+
+        uint32_t lod = 0;
+        if (distance > radius)
+        {
+            // 每单位误差对应的屏幕像素数
+            const float errorToPixels = radius * pixelScale / distance;
+            const std::vector<MeshLod> &lods = object.mesh->lods;
+            const uint32_t current = std::min<uint32_t>(m_lodLevels[index], static_cast<uint32_t>(lods.size() - 1));
+
+            for (uint32_t level = 1; level < lods.size(); ++level)
+            {
+                const float pixels = lods[level].error * errorToPixels;
+                if (pixels <= (level <= current ? keepThreshold : coarserThreshold))
+                {
+                    lod = level;
+                }
+                else
+                {
+                    break;
+                }
+            }
+        }
+
+        m_lodLevels[index] = static_cast<uint8_t>(lod);
+        object.lod = lod;
     }
 }
 
+std::span<const glm::mat4> Scene::getWorldMatrices()
+{
+    m_storage->update();
+    return m_storage->getWorldMatrices();
+}
+
+const SceneStorage &Scene::getStorage()
+{
+    m_storage->update();
+    return *m_storage;
+}
+
 // ==================== 光照管理接口实现 ====================
 
 uint32_t Scene::addLight(std::shared_ptr<Light> light)
 {
     if (!light)
     {
-        std::cerr << "Warning: Attempted to add null light to scene" << std::endl;
+        QTR_LOG_WARN("Scene", "Attempted to add null light to scene");
         return 0;
     }
 
     uint32_t lightId = m_nextLightId++;
     m_lights[lightId] = light;
+    ++m_lightsVersion;
 
-    std::cout << "Added "
-              << (light->getType() == LightType::Directional ? "Directional"
-                  : light->getType() == LightType::Point     ? "Point"
-                  : light->getType() == LightType::Spot      ? "Spot"
-                                                             : "Unknown")
-              << " light '" << light->getName() << "' with ID " << lightId << std::endl;
+    QTR_LOG_DEBUG("Scene", "Added "
+                           << (light->getType() == LightType::Directional ? "Directional"
+                               : light->getType() == LightType::Point     ? "Point"
+                               : light->getType() == LightType::Spot      ? "Spot"
+                                                                          : "Unknown")
+                           << " light '" << light->getName() << "' with ID " << lightId);
 
     return lightId;
 }
@@ -99,12 +190,13 @@ bool Scene::removeLight(uint32_t lightId)
     auto it = m_lights.find(lightId);
     if (it != m_lights.end())
     {
-        std::cout << "Removed light '" << it->second->getName() << "' with ID " << lightId << std::endl;
+        QTR_LOG_DEBUG("Scene", "Removed light '" << it->second->getName() << "' with ID " << lightId);
         m_lights.erase(it);
+        ++m_lightsVersion;
         return true;
     }
 
-    std::cerr << "Warning: Light with ID " << lightId << " not found" << std::endl;
+    QTR_LOG_WARN("Scene", "Light with ID " << lightId << " not found");
     return false;
 }
 
@@ -173,8 +265,9 @@ size_t Scene::getActiveLightCount() const
 
 void Scene::clearLights()
 {
-    std::cout << "Cleared " << m_lights.size() << " lights from scene" << std::endl;
+    QTR_LOG_DEBUG("Scene", "Cleared " << m_lights.size() << " lights from scene");
     m_lights.clear();
+    ++m_lightsVersion;
 }
 
 } // namespace rendercore
\ No newline at end of file
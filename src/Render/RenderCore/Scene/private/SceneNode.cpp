@@ -1,4 +1,5 @@
 #include "SceneNode.hpp"
+#include "SceneStorage.hpp"
 #include <algorithm>
 #include <iostream>
 
@@ -33,8 +34,19 @@ void SceneNode::addChild(std::shared_ptr<SceneNode> child)
         oldParent->removeChild(child);
     }
 
+    // 仍绑定在其他场景的根上时先解除（普通子节点已在 removeChild 中解除）
+    if (child->m_storage)
+    {
+        child->m_storage->marktopologydirty();
+        SceneStorage::unbindsubtree(*child);
+    }
+
     // 添加为子节点
     m_children.push_back(child);
+    if (SceneStorage *storage = findstorage())
+    {
+        storage->marktopologydirty();
+    }
     child->setparent(weak_from_this());
 
     // 子节点的世界矩阵需要重新计算
@@ -51,6 +63,13 @@ void SceneNode::removeChild(std::shared_ptr<SceneNode> child)
     auto it = std::find(m_children.begin(), m_children.end(), child);
     if (it != m_children.end())
     {
+        // 移出场景的子树立即解除绑定，之后不会再访问它在稠密数组中的旧位置
+        if (child->m_storage)
+        {
+            child->m_storage->marktopologydirty();
+            SceneStorage::unbindsubtree(*child);
+        }
+
         (*it)->setparent(std::weak_ptr<SceneNode>{});
         m_children.erase(it);
 
@@ -96,35 +115,49 @@ const glm::vec3 &SceneNode::getScale() const
 void SceneNode::setTransform(const Transform &transform)
 {
     m_transform = transform;
-    invalidateworldmatrix();
+    ontransformchanged();
 }
 
 void SceneNode::setPosition(const glm::vec3 &position)
 {
     m_transform.position = position;
-    invalidateworldmatrix();
+    ontransformchanged();
 }
 
 void SceneNode::setRotation(const glm::quat &rotation)
 {
     m_transform.rotation = rotation;
-    invalidateworldmatrix();
+    ontransformchanged();
 }
 
 void SceneNode::setScale(const glm::vec3 &scale)
 {
     m_transform.scale = scale;
-    invalidateworldmatrix();
+    ontransformchanged();
 }
 
 void SceneNode::translate(const glm::vec3 &delta)
 {
     m_transform.position += delta;
-    invalidateworldmatrix();
+    ontransformchanged();
 }
 
 glm::mat4 SceneNode::getWorldMatrix()
 {
+    // 刚加入场景、尚未排布的节点：先让场景完成排布（会绑定本节点）
+    if (!m_storage)
+    {
+        if (SceneStorage *storage = findstorage())
+        {
+            storage->update();
+        }
+    }
+
+    if (m_storage)
+    {
+        return m_storage->getworldmatrix(*this);
+    }
+
     // 如果世界矩阵没有脏，直接返回缓存的结果
     if (!m_worldMatrixDirty)
     {
@@ -157,9 +190,23 @@ void SceneNode::setRenderable(const Renderable &renderable)
 {
     m_renderable = renderable;
     m_hasRenderable = true;
+    if (m_storage)
+    {
+        m_storage->markrenderobjectsdirty();
+    }
 }
 
 Renderable &SceneNode::getRenderable()
+{
+    // 调用者可能修改 mesh/material/visible，场景的渲染对象列表需要重建
+    if (m_storage)
+    {
+        m_storage->markrenderobjectsdirty();
+    }
+    return m_renderable;
+}
+
+const Renderable &SceneNode::getRenderable() const
 {
     return m_renderable;
 }
@@ -184,6 +231,13 @@ void SceneNode::setparent(std::weak_ptr<SceneNode> parent)
 
 void SceneNode::invalidateworldmatrix()
 {
+    // 属于场景：整棵子树在稠密数组中是连续区间，记录一次即可
+    if (m_storage)
+    {
+        m_storage->marksubtreedirty(m_storageIndex);
+        return;
+    }
+
     // 标记自身为脏
     m_worldMatrixDirty = true;
 
@@ -194,4 +248,32 @@ void SceneNode::invalidateworldmatrix()
     }
 }
 
+void SceneNode::ontransformchanged()
+{
+    if (m_storage)
+    {
+        m_storage->setlocaltransform(m_storageIndex, m_transform);
+        return;
+    }
+
+    invalidateworldmatrix();
+}
+
+SceneStorage *SceneNode::findstorage() const
+{
+    if (m_storage)
+    {
+        return m_storage;
+    }
+
+    for (auto parent = m_parent.lock(); parent; parent = parent->m_parent.lock())
+    {
+        if (parent->m_storage)
+        {
+            return parent->m_storage;
+        }
+    }
+    return nullptr;
+}
+
 } // namespace rendercore
\ No newline at end of file
@@ -0,0 +1,413 @@
+#include "SceneStorage.hpp"
+#include "SceneNode.hpp"
+#include "TransformKernels.hpp"
+#include "Resource/public/ResourceType.hpp" // 包含 Mesh 的包围盒定义
+#include "VulkanCore/public/Profiler.hpp"
+#include "VulkanCore/public/WorkerPool.hpp"
+#include <algorithm>
+
+namespace rendercore
+{
+
+namespace
+{
+
+constexpr uint32_t kParallelNodeThreshold = 4096; ///< 脏节点达到该数量才并行更新
+constexpr uint32_t kSegmentsPerThread = 4;        ///< 每个参与线程期望分到的子树数
+constexpr uint32_t kMinSegmentSize = 256;         ///< 不再展开的子树大小
+constexpr uint32_t kMaxSplitDepth = 4;            ///< 最多向下展开的层数
+constexpr uint32_t kComposeGrain = 1024;          ///< 并行组合局部矩阵时每块的节点数
+
+} // namespace
+
+SceneStorage::SceneStorage(SceneNode &root) : m_root(&root)
+{
+}
+
+SceneStorage::~SceneStorage()
+{
+    // 节点可能比场景活得更久（外部仍持有 shared_ptr），解除绑定后它们退回独立计算
+    unbindsubtree(*m_root);
+}
+
+// ==================== 同步 ====================
+
+void SceneStorage::update()
+{
+    QTR_PROFILE_SCOPE("SceneStorage::update");
+    if (!m_topologyDirty && m_dirtyRanges.empty() && !m_renderObjectsDirty)
+    {
+        return;
+    }
+
+    if (m_topologyDirty)
+    {
+        rebuildlayout();
+    }
+
+    if (!m_dirtyRanges.empty())
+    {
+        updateworldmatrices();
+    }
+
+    if (m_renderObjectsDirty)
+    {
+        rebuildrenderobjects();
+    }
+
+    ++m_version;
+}
+
+void SceneStorage::rebuildlayout()
+{
+    QTR_PROFILE_SCOPE("SceneStorage::rebuildlayout");
+    // 已移出场景的节点在移除时就已解除绑定，这里不会再访问旧的 m_nodes
+    m_nodes.clear();
+    m_parentIndices.clear();
+
+    // 显式栈的先序遍历，避免深层级时递归爆栈
+    std::vector<std::pair<SceneNode *, uint32_t>> stack;
+    stack.emplace_back(m_root, kInvalidIndex);
+    while (!stack.empty())
+    {
+        auto [node, parentIndex] = stack.back();
+        stack.pop_back();
+
+        uint32_t index = static_cast<uint32_t>(m_nodes.size());
+        node->m_storage = this;
+        node->m_storageIndex = index;
+        m_nodes.push_back(node);
+        m_parentIndices.push_back(parentIndex);
+
+        // 逆序压栈，使子节点按原顺序出栈
+        const auto &children = node->m_children;
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
+        {
+            stack.emplace_back(it->get(), index);
+        }
+    }
+
+    const size_t nodeCount = m_nodes.size();
+    m_localTransforms.resize(nodeCount);
+    for (size_t i = 0; i < nodeCount; ++i)
+    {
+        m_localTransforms[i] = m_nodes[i]->m_transform;
+    }
+
+    // 先序中子节点总在父节点之后，逆序传播即可得到每棵子树的区间末尾
+    m_subtreeEnds.resize(nodeCount);
+    for (size_t i = 0; i < nodeCount; ++i)
+    {
+        m_subtreeEnds[i] = static_cast<uint32_t>(i + 1);
+    }
+    for (size_t i = nodeCount; i-- > 1;)
+    {
+        uint32_t parentIndex = m_parentIndices[i];
+        m_subtreeEnds[parentIndex] = std::max(m_subtreeEnds[parentIndex], m_subtreeEnds[i]);
+    }
+
+    m_worldMatrices.resize(nodeCount);
+    m_dirtyRoots.assign(nodeCount, 0);
+    m_dirtyRanges.clear();
+    m_dirtyRanges.emplace_back(0u, static_cast<uint32_t>(nodeCount));
+
+    m_topologyDirty = false;
+    m_renderObjectsDirty = true;
+}
+
+void SceneStorage::updateworldmatrices()
+{
+    QTR_PROFILE_SCOPE("SceneStorage::updateworldmatrices");
+    for (const auto &range : m_dirtyRanges)
+    {
+        if (range.first < m_dirtyRoots.size())
+        {
+            m_dirtyRoots[range.first] = 0;
+        }
+    }
+
+    // 合并重叠区间（嵌套的子树区间会被祖先区间吸收），之后每个节点最多计算一次
+    std::sort(m_dirtyRanges.begin(), m_dirtyRanges.end());
+
+    size_t mergedCount = 0;
+    uint32_t dirtyNodes = 0;
+    size_t rangeIndex = 0;
+    while (rangeIndex < m_dirtyRanges.size())
+    {
+        uint32_t begin = m_dirtyRanges[rangeIndex].first;
+        uint32_t end = m_dirtyRanges[rangeIndex].second;
+        ++rangeIndex;
+        while (rangeIndex < m_dirtyRanges.size() && m_dirtyRanges[rangeIndex].first <= end)
+        {
+            end = std::max(end, m_dirtyRanges[rangeIndex].second);
+            ++rangeIndex;
+        }
+        m_dirtyRanges[mergedCount++] = {begin, end};
+        dirtyNodes += end - begin;
+    }
+    m_dirtyRanges.resize(mergedCount);
+
+    // 第一阶段：局部矩阵与层次无关，批量组合后原地写入世界矩阵数组；第二阶段按先序乘上父节点的世界矩阵
+    if (m_workers && dirtyNodes >= kParallelNodeThreshold)
+    {
+        for (const auto &[begin, end] : m_dirtyRanges)
+        {
+            m_workers->parallelFor(end - begin, kComposeGrain, [this, begin](uint32_t first, uint32_t last) {
+                composenodes(begin + first, begin + last);
+            });
+        }
+        updatenodesparallel(dirtyNodes);
+    }
+    else
+    {
+        for (const auto &[begin, end] : m_dirtyRanges)
+        {
+            composenodes(begin, end);
+            propagatenodes(begin, end);
+        }
+    }
+
+    m_dirtyRanges.clear();
+}
+
+void SceneStorage::composenodes(uint32_t begin, uint32_t end)
+{
+    TransformKernels::composeLocal(m_localTransforms.data() + begin, end - begin, m_worldMatrices.data() + begin);
+}
+
+void SceneStorage::propagatenodes(uint32_t begin, uint32_t end)
+{
+    // 区间内已是局部矩阵；父节点要么在区间外（已是最新），要么在区间内且更靠前（刚刚算过），根节点保持局部矩阵
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        uint32_t parentIndex = m_parentIndices[i];
+        if (parentIndex != kInvalidIndex)
+        {
+            TransformKernels::multiplyAffine(m_worldMatrices[parentIndex], m_worldMatrices[i], m_worldMatrices[i]);
+        }
+    }
+
+    // 渲染对象列表待重建时会重新计算全部包围盒
+    if (!m_renderObjectsDirty)
+    {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            if (m_renderObjectIndices[i] != kInvalidIndex)
+            {
+                updateworldbounds(m_renderObjectIndices[i]);
+            }
+        }
+    }
+}
+
+void SceneStorage::updatenodesparallel(uint32_t dirtyNodes)
+{
+    QTR_PROFILE_SCOPE("SceneStorage::updatenodesparallel");
+    // 合并区间内父节点在区间外的节点各自领起一棵完整子树：沿子树末尾跳跃即可依次找到它们，彼此互不依赖
+    m_segments.clear();
+    for (const auto &[begin, end] : m_dirtyRanges)
+    {
+        for (uint32_t root = begin; root < end; root = m_subtreeEnds[root])
+        {
+            m_segments.emplace_back(root, m_subtreeEnds[root]);
+        }
+    }
+
+    // 子树太少时（例如从根节点开始整棵树都脏）逐层展开大子树：串行算出子树根（局部矩阵已组合），它的各个子节点子树成为独立任务
+    const uint32_t targetSegments = (m_workers->getThreadCount() + 1) * kSegmentsPerThread;
+    const uint32_t splitSize = std::max(kMinSegmentSize, dirtyNodes / targetSegments);
+    bool split = true;
+    for (uint32_t depth = 0; split && depth < kMaxSplitDepth && m_segments.size() < targetSegments; ++depth)
+    {
+        split = false;
+        m_splitSegments.swap(m_segments);
+        m_segments.clear();
+        for (const auto &[begin, end] : m_splitSegments)
+        {
+            if (end - begin <= splitSize)
+            {
+                m_segments.emplace_back(begin, end);
+                continue;
+            }
+            split = true;
+            propagatenodes(begin, begin + 1);
+            for (uint32_t child = begin + 1; child < end; child = m_subtreeEnds[child])
+            {
+                m_segments.emplace_back(child, m_subtreeEnds[child]);
+            }
+        }
+    }
+
+    // 每个子树只写自己区间内的世界矩阵与对应渲染对象的包围盒
+    const uint32_t segmentCount = static_cast<uint32_t>(m_segments.size());
+    const uint32_t grainSize = std::max(1u, segmentCount / targetSegments);
+    m_workers->parallelFor(segmentCount, grainSize, [this](uint32_t first, uint32_t last) {
+        for (uint32_t segment = first; segment < last; ++segment)
+        {
+            propagatenodes(m_segments[segment].first, m_segments[segment].second);
+        }
+    });
+}
+
+void SceneStorage::rebuildrenderobjects()
+{
+    QTR_PROFILE_SCOPE("SceneStorage::rebuildrenderobjects");
+    m_renderObjects.clear();
+    m_localCenters.clear();
+    m_localExtents.clear();
+    m_renderObjectIndices.assign(m_nodes.size(), kInvalidIndex);
+
+    for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        const SceneNode *node = m_nodes[i];
+        if (!node->m_hasRenderable)
+        {
+            continue;
+        }
+
+        const Renderable &renderable = node->m_renderable;
+        if (renderable.visible && renderable.mesh && renderable.material)
+        {
+            RenderObject renderObject;
+            renderObject.mesh = renderable.mesh.get();
+            renderObject.material = renderable.material.get();
+            renderObject.transformIndex = static_cast<uint32_t>(i);
+
+            m_renderObjectIndices[i] = static_cast<uint32_t>(m_renderObjects.size());
+            m_renderObjects.push_back(renderObject);
+            m_localCenters.push_back(renderable.mesh->bounds.getCenter());
+            m_localExtents.push_back(renderable.mesh->bounds.getExtents());
+        }
+    }
+
+    m_worldBounds.resize(m_renderObjects.size());
+    for (uint32_t i = 0; i < m_renderObjects.size(); ++i)
+    {
+        updateworldbounds(i);
+    }
+
+    m_renderObjectsDirty = false;
+    ++m_renderObjectsVersion;
+}
+
+void SceneStorage::updateworldbounds(uint32_t renderObjectIndex)
+{
+    // 变换后的 AABB：中心按点变换，半尺寸取 |M| 的线性部分作用于原半尺寸（Arvo）
+    const glm::mat4 &world = m_worldMatrices[m_renderObjects[renderObjectIndex].transformIndex];
+    const glm::vec3 &center = m_localCenters[renderObjectIndex];
+    const glm::vec3 &extents = m_localExtents[renderObjectIndex];
+
+    glm::vec3 worldCenter = glm::vec3(world * glm::vec4(center, 1.0f));
+    glm::vec3 worldExtents = glm::abs(glm::vec3(world[0])) * extents.x + glm::abs(glm::vec3(world[1])) * extents.y +
+                             glm::abs(glm::vec3(world[2])) * extents.z;
+    m_worldBounds.set(renderObjectIndex, worldCenter, worldExtents);
+}
+
+void SceneStorage::setWorkerPool(vkcore::WorkerPool *workers)
+{
+    m_workers = workers;
+}
+
+// ==================== 访问器 ====================
+
+size_t SceneStorage::getNodeCount() const
+{
+    return m_nodes.size();
+}
+
+std::span<const Transform> SceneStorage::getLocalTransforms() const
+{
+    return m_localTransforms;
+}
+
+std::span<const uint32_t> SceneStorage::getParentIndices() const
+{
+    return m_parentIndices;
+}
+
+std::span<const glm::mat4> SceneStorage::getWorldMatrices() const
+{
+    return m_worldMatrices;
+}
+
+std::span<const RenderObject> SceneStorage::getRenderObjects() const
+{
+    return m_renderObjects;
+}
+
+const CullingBounds &SceneStorage::getWorldBounds() const
+{
+    return m_worldBounds;
+}
+
+uint64_t SceneStorage::getVersion() const
+{
+    return m_version;
+}
+
+uint64_t SceneStorage::getRenderObjectsVersion() const
+{
+    return m_renderObjectsVersion;
+}
+
+// ==================== SceneNode 回调 ====================
+
+void SceneStorage::setlocaltransform(uint32_t index, const Transform &transform)
+{
+    // 层次结构待重建时索引可能已过期，重建时会从节点重新拷贝
+    if (m_topologyDirty)
+    {
+        return;
+    }
+
+    m_localTransforms[index] = transform;
+    marksubtreedirty(index);
+}
+
+void SceneStorage::marksubtreedirty(uint32_t index)
+{
+    if (m_topologyDirty || m_dirtyRoots[index])
+    {
+        return;
+    }
+
+    m_dirtyRoots[index] = 1;
+    m_dirtyRanges.emplace_back(index, m_subtreeEnds[index]);
+}
+
+void SceneStorage::marktopologydirty()
+{
+    m_topologyDirty = true;
+}
+
+void SceneStorage::markrenderobjectsdirty()
+{
+    m_renderObjectsDirty = true;
+}
+
+const glm::mat4 &SceneStorage::getworldmatrix(const SceneNode &node)
+{
+    update();
+    return m_worldMatrices[node.m_storageIndex];
+}
+
+void SceneStorage::unbindsubtree(SceneNode &node)
+{
+    std::vector<SceneNode *> stack{&node};
+    while (!stack.empty())
+    {
+        SceneNode *current = stack.back();
+        stack.pop_back();
+
+        current->m_storage = nullptr;
+        current->m_storageIndex = kInvalidIndex;
+        current->m_worldMatrixDirty = true;
+
+        for (const auto &child : current->m_children)
+        {
+            stack.push_back(child.get());
+        }
+    }
+}
+
+} // namespace rendercore
@@ -0,0 +1,210 @@
+#include "TransformKernels.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define QTRENDER_TRANSFORM_SSE 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define QTRENDER_TRANSFORM_NEON 1
+#endif
+
+namespace rendercore
+{
+
+namespace
+{
+
+#if defined(QTRENDER_TRANSFORM_SSE) || defined(QTRENDER_TRANSFORM_NEON)
+
+// 4 路浮点的最小封装：内核只写一份，SSE2 与 NEON 各自提供以下操作
+#if defined(QTRENDER_TRANSFORM_SSE)
+using Vec4 = __m128;
+
+inline Vec4 set4(float a, float b, float c, float d)
+{
+    return _mm_setr_ps(a, b, c, d);
+}
+
+inline Vec4 splat4(float value)
+{
+    return _mm_set1_ps(value);
+}
+
+inline Vec4 add4(Vec4 a, Vec4 b)
+{
+    return _mm_add_ps(a, b);
+}
+
+inline Vec4 sub4(Vec4 a, Vec4 b)
+{
+    return _mm_sub_ps(a, b);
+}
+
+inline Vec4 mul4(Vec4 a, Vec4 b)
+{
+    return _mm_mul_ps(a, b);
+}
+
+inline Vec4 load4(const float *source)
+{
+    return _mm_loadu_ps(source);
+}
+
+inline void store4(float *destination, Vec4 value)
+{
+    _mm_storeu_ps(destination, value);
+}
+
+inline void transpose4(Vec4 &a, Vec4 &b, Vec4 &c, Vec4 &d)
+{
+    _MM_TRANSPOSE4_PS(a, b, c, d);
+}
+#else
+using Vec4 = float32x4_t;
+
+inline Vec4 set4(float a, float b, float c, float d)
+{
+    const float values[4] = {a, b, c, d};
+    return vld1q_f32(values);
+}
+
+inline Vec4 splat4(float value)
+{
+    return vdupq_n_f32(value);
+}
+
+inline Vec4 add4(Vec4 a, Vec4 b)
+{
+    return vaddq_f32(a, b);
+}
+
+inline Vec4 sub4(Vec4 a, Vec4 b)
+{
+    return vsubq_f32(a, b);
+}
+
+inline Vec4 mul4(Vec4 a, Vec4 b)
+{
+    return vmulq_f32(a, b);
+}
+
+inline Vec4 load4(const float *source)
+{
+    return vld1q_f32(source);
+}
+
+inline void store4(float *destination, Vec4 value)
+{
+    vst1q_f32(destination, value);
+}
+
+inline void transpose4(Vec4 &a, Vec4 &b, Vec4 &c, Vec4 &d)
+{
+    const float32x4x2_t ab = vtrnq_f32(a, b); // a0 b0 a2 b2 | a1 b1 a3 b3
+    const float32x4x2_t cd = vtrnq_f32(c, d);
+    a = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+    b = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+    c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+    d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+}
+#endif
+
+/**
+ * @brief 把 4 个节点的同一列（各分量为跨节点的向量）转置后写回各自的矩阵
+ */
+inline void storecolumn(glm::mat4 *out, int column, Vec4 x, Vec4 y, Vec4 z, Vec4 w)
+{
+    transpose4(x, y, z, w);
+    store4(&out[0][column][0], x);
+    store4(&out[1][column][0], y);
+    store4(&out[2][column][0], z);
+    store4(&out[3][column][0], w);
+}
+
+/**
+ * @brief 一次组合 4 个变换：分量先收集为跨节点的向量，展开四元数（与 glm::mat3_cast 相同的公式）后按列缩放
+ */
+void compose4(const Transform *t, glm::mat4 *out)
+{
+    const Vec4 qx = set4(t[0].rotation.x, t[1].rotation.x, t[2].rotation.x, t[3].rotation.x);
+    const Vec4 qy = set4(t[0].rotation.y, t[1].rotation.y, t[2].rotation.y, t[3].rotation.y);
+    const Vec4 qz = set4(t[0].rotation.z, t[1].rotation.z, t[2].rotation.z, t[3].rotation.z);
+    const Vec4 qw = set4(t[0].rotation.w, t[1].rotation.w, t[2].rotation.w, t[3].rotation.w);
+
+    const Vec4 two = splat4(2.0f);
+    const Vec4 one = splat4(1.0f);
+    const Vec4 x2 = mul4(qx, two);
+    const Vec4 y2 = mul4(qy, two);
+    const Vec4 z2 = mul4(qz, two);
+    const Vec4 xx = mul4(qx, x2);
+    const Vec4 yy = mul4(qy, y2);
+    const Vec4 zz = mul4(qz, z2);
+    const Vec4 xy = mul4(qx, y2);
+    const Vec4 xz = mul4(qx, z2);
+    const Vec4 yz = mul4(qy, z2);
+    const Vec4 wx = mul4(qw, x2);
+    const Vec4 wy = mul4(qw, y2);
+    const Vec4 wz = mul4(qw, z2);
+
+    const Vec4 sx = set4(t[0].scale.x, t[1].scale.x, t[2].scale.x, t[3].scale.x);
+    const Vec4 sy = set4(t[0].scale.y, t[1].scale.y, t[2].scale.y, t[3].scale.y);
+    const Vec4 sz = set4(t[0].scale.z, t[1].scale.z, t[2].scale.z, t[3].scale.z);
+    const Vec4 zero = splat4(0.0f);
+
+    storecolumn(out, 0, mul4(sub4(one, add4(yy, zz)), sx), mul4(add4(xy, wz), sx), mul4(sub4(xz, wy), sx), zero);
+    storecolumn(out, 1, mul4(sub4(xy, wz), sy), mul4(sub4(one, add4(xx, zz)), sy), mul4(add4(yz, wx), sy), zero);
+    storecolumn(out, 2, mul4(add4(xz, wy), sz), mul4(sub4(yz, wx), sz), mul4(sub4(one, add4(xx, yy)), sz), zero);
+    storecolumn(out, 3, set4(t[0].position.x, t[1].position.x, t[2].position.x, t[3].position.x),
+                set4(t[0].position.y, t[1].position.y, t[2].position.y, t[3].position.y),
+                set4(t[0].position.z, t[1].position.z, t[2].position.z, t[3].position.z), one);
+}
+
+#endif
+
+} // namespace
+
+void TransformKernels::composeLocal(const Transform *transforms, size_t count, glm::mat4 *out)
+{
+    size_t i = 0;
+#if defined(QTRENDER_TRANSFORM_SSE) || defined(QTRENDER_TRANSFORM_NEON)
+    for (; i + 4 <= count; i += 4)
+    {
+        compose4(transforms + i, out + i);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        out[i] = composeLocal(transforms[i]);
+    }
+}
+
+glm::mat4 TransformKernels::composeLocal(const Transform &transform)
+{
+    return transform.getLocalMatrix();
+}
+
+void TransformKernels::multiplyAffine(const glm::mat4 &parent, const glm::mat4 &local, glm::mat4 &out)
+{
+#if defined(QTRENDER_TRANSFORM_SSE) || defined(QTRENDER_TRANSFORM_NEON)
+    // 结果第 j 列 = parent 前三列按 local 第 j 列加权（local 前三列 w 为 0，第四列 w 为 1，只需再加 parent 第四列）
+    const Vec4 p0 = load4(&parent[0][0]);
+    const Vec4 p1 = load4(&parent[1][0]);
+    const Vec4 p2 = load4(&parent[2][0]);
+    const Vec4 p3 = load4(&parent[3][0]);
+    for (int column = 0; column < 4; ++column)
+    {
+        // 先读完 local 的第 column 列再写 out 的同一列，因此 out 可以与 local 相同
+        const glm::vec4 &l = local[column];
+        Vec4 result = add4(add4(mul4(p0, splat4(l.x)), mul4(p1, splat4(l.y))), mul4(p2, splat4(l.z)));
+        if (column == 3)
+        {
+            result = add4(result, p3);
+        }
+        store4(&out[column][0], result);
+    }
+#else
+    out = parent * local;
+#endif
+}
+
+} // namespace rendercore
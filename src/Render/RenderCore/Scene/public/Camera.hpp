@@ -1,4 +1,5 @@
 #pragma once
+#include "Frustum.hpp"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -9,6 +10,9 @@ namespace rendercore
  * @brief 管理视图和投影矩阵的摄像机类
  * @details 提供摄像机位置、朝向、投影参数的管理，
  * 并生成用于渲染的 View 和 Projection 矩阵。
+ * 视图矩阵、视图-投影矩阵与视锥在首次查询时计算并缓存，只在位置、朝向或投影参数变化后重新计算。
+ *
+ * @note 缓存在 const 查询中惰性更新，同一相机不要在多个线程上同时查询
  */
 class Camera
 {
@@ -28,14 +32,28 @@ class Camera
 
     ~Camera();
 
-    glm::mat4 getViewMatrix() const;
+    const glm::mat4 &getViewMatrix() const;
 
     const glm::mat4 &getProjectionMatrix() const;
 
+    /**
+     * @brief 获取 projection * view
+     */
+    const glm::mat4 &getViewProjectionMatrix() const;
+
+    /**
+     * @brief 获取由视图-投影矩阵提取的视锥
+     */
+    const Frustum &getFrustum() const;
+
     const glm::vec3 &getPosition() const;
 
     const glm::vec3 &getFront() const;
 
+    float getNearPlane() const;
+
+    float getFarPlane() const;
+
     void setPerspective(float fovY, float aspectRatio, float zNear, float zFar);
 
     void setPosition(const glm::vec3 &position);
@@ -53,6 +71,11 @@ class Camera
   private:
     void updateCameraVectors();
 
+    /**
+     * @brief (私有) 按脏标记重算视图矩阵、视图-投影矩阵与视锥
+     */
+    void updatecache() const;
+
   private:
     glm::vec3 m_position;
     glm::vec3 m_front;
@@ -71,6 +94,13 @@ class Camera
     float m_aspect;
     float m_zNear;
     float m_zFar;
+
+    // 派生数据缓存（由 updatecache() 惰性更新）
+    mutable glm::mat4 m_viewMatrix{1.0f};           ///< 视图矩阵
+    mutable glm::mat4 m_viewProjectionMatrix{1.0f}; ///< projection * view
+    mutable Frustum m_frustum;                      ///< 视锥
+    mutable bool m_viewDirty{true};                 ///< 位置或朝向已变化
+    mutable bool m_viewProjectionDirty{true};       ///< 视图或投影已变化
 };
 
 } // namespace rendercore
\ No newline at end of file
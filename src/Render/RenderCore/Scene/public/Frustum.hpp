@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace vkcore
+{
+class WorkerPool;
+} // namespace vkcore
+
+namespace rendercore
+{
+/**
+ * @struct CullingBounds
+ * @brief 以 SoA 布局存放的世界空间 AABB（中心 + 半尺寸），供 SIMD 批量剔除
+ * @details 每个分量一个连续数组，一次加载即可取出 4/8 个包围盒的同一分量
+ */
+struct CullingBounds
+{
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> extentX;
+    std::vector<float> extentY;
+    std::vector<float> extentZ;
+
+    size_t size() const
+    {
+        return centerX.size();
+    }
+
+    void resize(size_t count)
+    {
+        centerX.resize(count);
+        centerY.resize(count);
+        centerZ.resize(count);
+        extentX.resize(count);
+        extentY.resize(count);
+        extentZ.resize(count);
+    }
+
+    void set(size_t index, const glm::vec3 &center, const glm::vec3 &extents)
+    {
+        centerX[index] = center.x;
+        centerY[index] = center.y;
+        centerZ[index] = center.z;
+        extentX[index] = extents.x;
+        extentY[index] = extents.y;
+        extentZ[index] = extents.z;
+    }
+};
+
+/**
+ * @class Frustum
+ * @brief 由视图-投影矩阵提取的 6 个裁剪平面，以及 AABB 的批量剔除
+ * @details 批量剔除按编译目标选择 AVX（8 路）、SSE2（4 路）或 NEON（4 路），其余平台回退到标量实现。
+ *          AVX 需要以 -mavx / /arch:AVX 编译才会启用。
+ *
+ * @example
+ * @code
+ * rendercore::Frustum frustum(camera.getViewProjectionMatrix()); // 或直接使用 camera.getFrustum()
+ * std::vector<uint32_t> visible;
+ * frustum.cull(bounds, visible); // visible 中为可见包围盒的索引（升序）
+ * @endcode
+ */
+class Frustum
+{
+  public:
+    enum Plane : uint32_t
+    {
+        Left = 0,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        PlaneCount
+    };
+
+    /**
+     * @brief 投影矩阵的 NDC 深度范围（决定近平面的提取方式）
+     */
+    enum class DepthRange : uint8_t
+    {
+        NegativeOneToOne, ///< glm::perspective / glm::ortho 默认（_NO）
+        ZeroToOne         ///< glm::perspectiveRH_ZO / glm::orthoRH_ZO 等（_ZO，Vulkan 深度范围）
+    };
+
+    Frustum() = default;
+
+    /**
+     * @brief 从视图-投影矩阵提取平面（Gribb-Hartmann）
+     * @param viewProjection projection * view
+     * @param depthRange 投影的深度范围：[-1, 1] 时近平面为 row3 + row2，[0, 1] 时为 row2；
+     *                   两者不一致时近平面错位（[0, 1] 投影按 [-1, 1] 提取会保留近平面之前的物体）
+     */
+    explicit Frustum(const glm::mat4 &viewProjection, DepthRange depthRange = DepthRange::NegativeOneToOne);
+
+    /**
+     * @brief 获取平面 (n, d)，满足 dot(n, p) + d >= 0 的点位于内侧（n 已归一化）
+     */
+    const glm::vec4 &getPlane(Plane plane) const;
+
+    /**
+     * @brief 判断单个 AABB 是否与视锥相交（或位于其内部）
+     */
+    bool intersects(const glm::vec3 &center, const glm::vec3 &extents) const;
+
+    /**
+     * @brief 批量剔除 AABB
+     * @param bounds 世界空间包围盒
+     * @param visibleIndices (输出) 可见包围盒的索引，按升序排列
+     * @return 可见数量
+     */
+    size_t cull(const CullingBounds &bounds, std::vector<uint32_t> &visibleIndices) const;
+
+    /**
+     * @brief 批量剔除 AABB，包围盒较多时按块分发到任务调度器
+     * @param bounds 世界空间包围盒
+     * @param visibleIndices (输出) 可见包围盒的索引，按升序排列（与串行版本完全相同）
+     * @param workers 任务调度器（为空或包围盒少于两块时退回串行版本）
+     * @return 可见数量
+     */
+    size_t cull(const CullingBounds &bounds, std::vector<uint32_t> &visibleIndices, vkcore::WorkerPool *workers) const;
+
+    static constexpr size_t kParallelCullChunk = 4096; ///< 并行剔除每块的包围盒数量（SIMD 宽度的倍数）
+
+  private:
+    glm::vec4 m_planes[PlaneCount]{};
+};
+} // namespace rendercore
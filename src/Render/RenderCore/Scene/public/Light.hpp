@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <memory>
 #include <string>
@@ -59,6 +60,7 @@ class Light
     void setName(const std::string &name)
     {
         m_name = name;
+        markdirty();
     }
 
     /**
@@ -75,6 +77,7 @@ class Light
     void setColor(const glm::vec3 &color)
     {
         m_color = color;
+        markdirty();
     }
 
     /**
@@ -91,6 +94,7 @@ class Light
     void setIntensity(float intensity)
     {
         m_intensity = intensity;
+        markdirty();
     }
 
     /**
@@ -107,6 +111,7 @@ class Light
     void setEnabled(bool enabled)
     {
         m_enabled = enabled;
+        markdirty();
     }
 
     /**
@@ -123,6 +128,15 @@ class Light
     void setCastShadows(bool castShadows)
     {
         m_castShadows = castShadows;
+        markdirty();
+    }
+
+    /**
+     * @brief 获取数据版本（任何属性修改后递增，供渲染端判断是否需要重新打包上传）
+     */
+    uint64_t getVersion() const
+    {
+        return m_version;
     }
 
     // ==================== 虚函数接口 ====================
@@ -151,6 +165,15 @@ class Light
         return 1.0f;
     }
 
+  protected:
+    /**
+     * @brief 标记属性已修改（派生类的所有 setter 都需要调用）
+     */
+    void markdirty()
+    {
+        ++m_version;
+    }
+
   protected:
     LightType m_type;
     std::string m_name;
@@ -158,6 +181,7 @@ class Light
     float m_intensity{1.0f};             ///< 光照强度
     bool m_enabled{true};                ///< 是否启用
     bool m_castShadows{true};            ///< 是否投射阴影
+    uint64_t m_version{1};               ///< 数据版本
 };
 
 /**
@@ -221,6 +245,7 @@ class PointLight : public Light
     void setPosition(const glm::vec3 &position)
     {
         m_position = position;
+        markdirty();
     }
 
     /**
@@ -241,11 +266,25 @@ class PointLight : public Light
         return glm::vec3(m_constant, m_linear, m_quadratic);
     }
 
+    /**
+     * @brief 获取影响范围（分簇光照按该半径把光源分配到簇，着色时在范围边缘平滑衰减到 0）
+     */
+    float getRange() const
+    {
+        return m_range;
+    }
+
+    /**
+     * @brief 设置影响范围
+     */
+    void setRange(float range);
+
   private:
     glm::vec3 m_position{0.0f, 0.0f, 0.0f}; ///< 光源位置
     float m_constant{1.0f};                 ///< 常数衰减项
     float m_linear{0.09f};                  ///< 线性衰减项
     float m_quadratic{0.032f};              ///< 二次衰减项
+    float m_range{10.0f};                   ///< 影响范围
 };
 
 /**
@@ -273,6 +312,7 @@ class SpotLight : public Light
     void setPosition(const glm::vec3 &position)
     {
         m_position = position;
+        markdirty();
     }
 
     /**
@@ -327,6 +367,19 @@ class SpotLight : public Light
         return glm::vec3(m_constant, m_linear, m_quadratic);
     }
 
+    /**
+     * @brief 获取影响范围（分簇光照按该半径把光源分配到簇，着色时在范围边缘平滑衰减到 0）
+     */
+    float getRange() const
+    {
+        return m_range;
+    }
+
+    /**
+     * @brief 设置影响范围
+     */
+    void setRange(float range);
+
   private:
     glm::vec3 m_position{0.0f, 0.0f, 0.0f};   ///< 光源位置
     glm::vec3 m_direction{0.0f, -1.0f, 0.0f}; ///< 光照方向
@@ -337,6 +390,7 @@ class SpotLight : public Light
     float m_constant{1.0f};
     float m_linear{0.09f};
     float m_quadratic{0.032f};
+    float m_range{15.0f}; ///< 影响范围
 };
 
 /**
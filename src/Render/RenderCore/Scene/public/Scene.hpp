@@ -1,33 +1,41 @@
 #pragma once
 
 #include "Camera.hpp"
+#include "Frustum.hpp"
 #include "Light.hpp"
 #include "SceneNode.hpp"
+#include "SceneStorage.hpp"
 #include <memory>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
 namespace rendercore
 {
-/**
- * @struct RenderObject
- * @brief 包含渲染所需的所有信息的扁平结构
- * @details 由 Scene 遍历场景图后生成，供渲染器使用
- */
-struct RenderObject
-{
-    Renderable renderable; // 包含 Mesh 和 Material 的引用
-    glm::mat4 worldMatrix; // 最终的世界变换矩阵
-    // (未来可以添加：包围盒、与此对象相关的灯光列表等)
-};
-
 /**
  * @class Scene
  * @brief 场景的根对象，管理场景图和相机
+ * @details 场景图的变换与渲染对象由 SceneStorage 以稠密数组维护，
+ *          每帧调用 getRenderObjects() 只同步发生变化的部分
  */
 class Scene
 {
   public:
+    /**
+     * @struct LodSelectionSettings
+     * @brief 按投影尺寸选择网格 LOD 的参数
+     * @details 各级 LOD 的误差（以包围半径为单位）乘以物体投影半径得到屏幕误差，选择误差不超过 pixelError
+     *          的最粗一级；切换到更粗一级要求误差低于阈值的 (1 - hysteresis)，当前一级在误差不超过阈值的
+     *          (1 + hysteresis) 时保持不变，避免物体在临界距离附近逐帧来回切换
+     */
+    struct LodSelectionSettings
+    {
+        bool enabled = true;            ///< 关闭时所有对象使用 LOD 0
+        float viewportHeight = 1080.0f; ///< 视口高度（像素）
+        float pixelError = 1.0f;        ///< 允许的屏幕误差（像素）
+        float hysteresis = 0.25f;       ///< 切换阈值的相对滞回带宽
+    };
+
     Scene();
     ~Scene();
 
@@ -52,10 +60,54 @@ class Scene
     std::shared_ptr<Camera> getCamera() const;
 
     /**
-     * @brief 遍历场景图，收集所有可见的 Renderable 对象
-     * @return std::vector<RenderObject> 供渲染器使用的扁平对象列表 (渲染队列)
+     * @brief 同步场景数据并获取所有可见的渲染对象
+     * @return std::span<const RenderObject> 供渲染器使用的扁平对象列表 (渲染队列)
+     * @note 返回的 span 在下一次修改场景图并调用本函数（或 getWorldMatrices）之前有效
+     */
+    std::span<const RenderObject> getRenderObjects();
+
+    /**
+     * @brief 同步场景数据，用活动相机的视锥剔除后获取可见的渲染对象
+     * @return std::span<const RenderObject> 视锥内的渲染对象（没有活动相机时返回全部）
+     * @note 返回的 span 在下一次调用本函数之前有效
+     */
+    std::span<const RenderObject> getVisibleRenderObjects();
+
+    /**
+     * @brief 同步场景数据，用指定视锥剔除后获取可见的渲染对象
+     * @details 同时按活动相机的投影尺寸为每个可见对象选择 RenderObject::lod（阴影等其他视图沿用主相机的选择）
+     * @param frustum 世界空间视锥（例如阴影相机或反射相机）
+     * @return std::span<const RenderObject> 视锥内的渲染对象，保持 getRenderObjects() 中的相对顺序
+     */
+    std::span<const RenderObject> getVisibleRenderObjects(const Frustum &frustum);
+
+    /**
+     * @brief 设置 LOD 选择参数（视口尺寸改变时应更新 viewportHeight）
+     */
+    void setLodSelection(const LodSelectionSettings &settings);
+
+    const LodSelectionSettings &getLodSelection() const
+    {
+        return m_lodSelection;
+    }
+
+    /**
+     * @brief 设置任务调度器：大量节点变化时并行更新世界矩阵，包围盒较多时并行视锥剔除
+     * @param workers 任务调度器（生命周期须长于本对象；为空时全部串行）
+     */
+    void setWorkerPool(vkcore::WorkerPool *workers);
+
+    /**
+     * @brief 同步场景数据并获取所有节点的世界矩阵
+     * @return std::span<const glm::mat4> 以 RenderObject::transformIndex 索引
+     */
+    std::span<const glm::mat4> getWorldMatrices();
+
+    /**
+     * @brief 同步场景数据并获取底层稠密存储
+     * @return const SceneStorage& 渲染对象、世界矩阵、世界包围盒与版本号（供 GPU 驱动渲染上传）
      */
-    std::vector<RenderObject> getRenderObjects();
+    const SceneStorage &getStorage();
 
     // ==================== 光照管理接口 ====================
 
@@ -110,20 +162,47 @@ class Scene
      */
     void clearLights();
 
+    /**
+     * @brief 获取光照映射（遍历时不复制共享指针，供渲染端每帧检查光照版本）
+     */
+    const std::unordered_map<uint32_t, std::shared_ptr<Light>> &getLights() const
+    {
+        return m_lights;
+    }
+
+    /**
+     * @brief 获取光照列表版本（添加、移除或清空光照时递增；单个光照的属性变化见 Light::getVersion）
+     */
+    uint64_t getLightsVersion() const
+    {
+        return m_lightsVersion;
+    }
+
   private:
     /**
-     * @brief (私有) 递归遍历场景图以收集渲染对象
-     * @param node 当前遍历的节点
-     * @param renderList (输出) 收集到的渲染对象列表
+     * @brief 为可见对象选择 LOD（写入 m_visibleRenderObjects，并记录到 m_lodLevels 供下一帧滞回）
      */
-    void traversescene(std::shared_ptr<SceneNode> node, std::vector<RenderObject> &renderList);
+    void selectlods();
 
   private:
     std::shared_ptr<SceneNode> m_rootNode;
+    std::unique_ptr<SceneStorage> m_storage; ///< 声明在根节点之后：先于节点析构，以便解除节点绑定
+
+    vkcore::WorkerPool *m_workers = nullptr; ///< 变换更新与剔除使用的任务调度器（可为空）
+
+    // 视锥剔除结果（帧间复用容量）
+    std::vector<uint32_t> m_visibleIndices;
+    std::vector<RenderObject> m_visibleRenderObjects;
     std::shared_ptr<Camera> m_activeCamera;
 
+    // LOD 选择（m_lodLevels 以渲染对象下标索引，渲染对象列表重建时清零）
+    LodSelectionSettings m_lodSelection;
+    std::vector<uint8_t> m_lodLevels;
+    uint64_t m_lodLevelsVersion{0};
+
     // 光照管理
     std::unordered_map<uint32_t, std::shared_ptr<Light>> m_lights; ///< 光照ID到光照对象的映射
     uint32_t m_nextLightId{1};                                     ///< 下一个可用的光照ID
+    uint64_t m_lightsVersion{1};                                   ///< 光照列表版本
 };
 } // namespace rendercore
\ No newline at end of file
@@ -2,18 +2,22 @@
 
 #include "Renderable.hpp"
 #include "Transform.hpp"
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace rendercore
 {
-class Scene; // 前向声明
+class Scene;        // 前向声明
+class SceneStorage; // 前向声明
 
 /**
  * @class SceneNode
  * @brief 场景图中的一个节点，包含变换、子节点和组件
- * @details 遵循代码规范，公共函数 camelCase，私有成员 m_lowercase
+ * @details 遵循代码规范，公共函数 camelCase，私有成员 m_lowercase。
+ *          挂到 Scene 下后，变换与世界矩阵由 SceneStorage 的稠密数组维护，
+ *          修改变换只记录脏子树区间，不再递归通知子节点；未挂到场景的节点仍独立计算
  */
 class SceneNode : public std::enable_shared_from_this<SceneNode>
 {
@@ -63,7 +67,8 @@ class SceneNode : public std::enable_shared_from_this<SceneNode>
 
     /**
      * @brief 获取此节点的最终世界变换矩阵 (只读)
-     * @details 递归地与其父节点的世界矩阵相乘，并缓存结果
+     * @details 属于场景时从 SceneStorage 读取（必要时先同步脏区间）；
+     *          否则递归地与其父节点的世界矩阵相乘，并缓存结果
      */
     glm::mat4 getWorldMatrix();
 
@@ -126,9 +131,15 @@ class SceneNode : public std::enable_shared_from_this<SceneNode>
 
     /**
      * @brief 获取此节点的可渲染组件 (可修改)
+     * @details 返回可修改引用时会标记场景的渲染对象列表为脏；只读访问请使用 const 重载
      */
     Renderable &getRenderable();
 
+    /**
+     * @brief 获取此节点的可渲染组件 (只读)
+     */
+    const Renderable &getRenderable() const;
+
     /**
      * @brief 检查此节点是否有可渲染组件
      */
@@ -140,16 +151,29 @@ class SceneNode : public std::enable_shared_from_this<SceneNode>
     const std::string &getName() const;
 
   private:
+    friend class SceneStorage;
+
     /**
      * @brief (私有) 设置父节点，由 addChild 自动调用
      */
     void setparent(std::weak_ptr<SceneNode> parent);
 
     /**
-     * @brief (私有) 标记世界矩阵为脏，并递归通知所有子节点
+     * @brief (私有) 标记世界矩阵为脏
+     * @details 属于场景时只记录一个脏子树区间；否则递归通知所有子节点
      */
     void invalidateworldmatrix();
 
+    /**
+     * @brief (私有) 局部变换已修改：同步到 SceneStorage 并标记世界矩阵为脏
+     */
+    void ontransformchanged();
+
+    /**
+     * @brief (私有) 沿父链查找所属的 SceneStorage（用于刚加入场景、尚未完成排布的节点）
+     */
+    SceneStorage *findstorage() const;
+
   private:
     std::string m_name;
     Transform m_transform;
@@ -163,5 +187,9 @@ class SceneNode : public std::enable_shared_from_this<SceneNode>
     // 缓存
     bool m_worldMatrixDirty{true};
     glm::mat4 m_cachedWorldMatrix{1.0f};
+
+    // 场景存储绑定（由 SceneStorage 维护）
+    SceneStorage *m_storage{nullptr};
+    uint32_t m_storageIndex{UINT32_MAX};
 };
 } // namespace rendercore
\ No newline at end of file
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "Frustum.hpp"
+#include "Transform.hpp"
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+// 前向声明，避免包含依赖问题
+namespace vkcore
+{
+class WorkerPool;
+} // namespace vkcore
+
+namespace rendercore
+{
+struct Mesh;
+struct Material;
+class SceneNode;
+} // namespace rendercore
+
+namespace rendercore
+{
+/**
+ * @struct RenderObject
+ * @brief 包含渲染所需的所有信息的扁平结构
+ * @details 由 SceneStorage 在渲染组件或层次结构变化时重建，帧间持久存在。
+ *          mesh/material 是非拥有句柄，由对应 SceneNode 的 Renderable 保持存活；
+ *          世界矩阵通过 transformIndex 从 Scene::getWorldMatrices() 中读取，
+ *          第 i 个渲染对象的世界空间包围盒是 SceneStorage::getWorldBounds() 的第 i 项
+ */
+struct RenderObject
+{
+    Mesh *mesh{nullptr};         ///< 网格句柄（非拥有）
+    Material *material{nullptr}; ///< 材质句柄（非拥有）
+    uint32_t transformIndex{0};  ///< 节点在稠密数组中的索引
+    uint32_t lod{0};             ///< 绘制使用的 LOD 级别（由 Scene 在可见性提取时按屏幕尺寸选择）
+    // (未来可以添加：与此对象相关的灯光列表等)
+};
+
+/**
+ * @class SceneStorage
+ * @brief 场景图的稠密 SoA 存储，位于 SceneNode API 之后
+ * @details 节点按先序（父节点总在子节点之前，且每棵子树占据连续区间）排列在稠密数组中：
+ *          - 局部变换、父索引、子树区间末尾、世界矩阵各占一个数组；
+ *          - 修改变换只记录脏子树区间，update() 合并区间后先批量组合局部矩阵（TransformKernels），
+ *            再线性扫描乘上父节点的世界矩阵；
+ *          - 层次结构变化只标记脏，下一次 update() 以 O(N) 重新排布；
+ *          - 渲染对象列表只在渲染组件或层次结构变化时重建；
+ *          - 渲染对象的世界空间 AABB 以 SoA 布局维护，随世界矩阵一起增量更新，供 Frustum 批量剔除；
+ *          - 设置任务调度器后，脏节点较多时按互不相交的子树并行重算。
+ *
+ * @note 非线程安全，与 Scene 保持同一线程访问（并行更新只发生在 update() 内部）
+ */
+class SceneStorage
+{
+  public:
+    static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+    /**
+     * @brief 构造函数
+     * @param root 场景根节点（生命周期必须长于 SceneStorage）
+     */
+    explicit SceneStorage(SceneNode &root);
+    ~SceneStorage();
+
+    /** 禁用拷贝与移动（节点持有指向本对象的指针） */
+    SceneStorage(const SceneStorage &) = delete;
+    SceneStorage &operator=(const SceneStorage &) = delete;
+
+    /**
+     * @brief 使稠密数据与场景图同步（重新排布、重算脏区间的世界矩阵、重建渲染对象列表）
+     * @details 没有任何修改时几乎没有开销
+     */
+    void update();
+
+    /**
+     * @brief 设置任务调度器（为空时串行更新）
+     */
+    void setWorkerPool(vkcore::WorkerPool *workers);
+
+    /**
+     * @brief 获取节点数量（包括根节点）
+     */
+    size_t getNodeCount() const;
+
+    /**
+     * @brief 获取先序排列的局部变换
+     */
+    std::span<const Transform> getLocalTransforms() const;
+
+    /**
+     * @brief 获取父节点索引（根节点为 kInvalidIndex）
+     */
+    std::span<const uint32_t> getParentIndices() const;
+
+    /**
+     * @brief 获取世界矩阵（调用 update() 之后有效）
+     */
+    std::span<const glm::mat4> getWorldMatrices() const;
+
+    /**
+     * @brief 获取渲染对象列表（调用 update() 之后有效）
+     */
+    std::span<const RenderObject> getRenderObjects() const;
+
+    /**
+     * @brief 获取渲染对象的世界空间包围盒（与 getRenderObjects() 一一对应，调用 update() 之后有效）
+     */
+    const CullingBounds &getWorldBounds() const;
+
+    /**
+     * @brief 获取数据版本号，每次 update() 实际修改了世界矩阵或渲染对象列表时递增
+     * @details 供 GPU 侧的持久对象缓冲判断是否需要重新上传
+     */
+    uint64_t getVersion() const;
+
+    /**
+     * @brief 获取渲染对象列表的版本号，只在列表重建时递增（只修改变换时不变）
+     */
+    uint64_t getRenderObjectsVersion() const;
+
+  private:
+    friend class SceneNode;
+
+    // --- 供 SceneNode 调用 ---
+
+    /**
+     * @brief (私有) 写入节点的局部变换并标记其子树为脏
+     */
+    void setlocaltransform(uint32_t index, const Transform &transform);
+
+    /**
+     * @brief (私有) 标记以 index 为根的子树的世界矩阵为脏
+     */
+    void marksubtreedirty(uint32_t index);
+
+    /**
+     * @brief (私有) 标记层次结构已变化
+     */
+    void marktopologydirty();
+
+    /**
+     * @brief (私有) 标记渲染对象列表需要重建
+     */
+    void markrenderobjectsdirty();
+
+    /**
+     * @brief (私有) 获取节点的世界矩阵（必要时先同步）
+     */
+    const glm::mat4 &getworldmatrix(const SceneNode &node);
+
+    /**
+     * @brief (私有) 解除以 node 为根的子树与存储的绑定
+     */
+    static void unbindsubtree(SceneNode &node);
+
+    // --- 内部实现 ---
+
+    void rebuildlayout();
+    void updateworldmatrices();
+    void composenodes(uint32_t begin, uint32_t end);
+    void propagatenodes(uint32_t begin, uint32_t end);
+    void updatenodesparallel(uint32_t dirtyNodes);
+    void rebuildrenderobjects();
+    void updateworldbounds(uint32_t renderObjectIndex);
+
+  private:
+    SceneNode *m_root;
+
+    // 稠密数组，按先序排列
+    std::vector<SceneNode *> m_nodes;            ///< 稠密索引 -> 节点（只在重建渲染对象时访问）
+    std::vector<Transform> m_localTransforms;    ///< 局部变换
+    std::vector<uint32_t> m_parentIndices;       ///< 父节点索引
+    std::vector<uint32_t> m_subtreeEnds;         ///< 子树区间 [i, m_subtreeEnds[i]) 的末尾
+    std::vector<glm::mat4> m_worldMatrices;      ///< 世界矩阵
+    std::vector<uint8_t> m_dirtyRoots;           ///< 该节点的子树区间是否已在 m_dirtyRanges 中
+    std::vector<uint32_t> m_renderObjectIndices; ///< 稠密索引 -> 渲染对象索引（无则为 kInvalidIndex）
+
+    // 渲染对象数组
+    std::vector<RenderObject> m_renderObjects; ///< 渲染对象列表
+    std::vector<glm::vec3> m_localCenters;     ///< 模型空间包围盒中心
+    std::vector<glm::vec3> m_localExtents;     ///< 模型空间包围盒半尺寸
+    CullingBounds m_worldBounds;               ///< 世界空间包围盒
+
+    std::vector<std::pair<uint32_t, uint32_t>> m_dirtyRanges; ///< 待重算的子树区间 [begin, end)
+
+    // 并行更新
+    vkcore::WorkerPool *m_workers{nullptr};                     ///< 任务调度器（可为空）
+    std::vector<std::pair<uint32_t, uint32_t>> m_segments;      ///< 互不依赖的子树区间（帧间复用容量）
+    std::vector<std::pair<uint32_t, uint32_t>> m_splitSegments; ///< 逐层展开时的暂存
+
+    bool m_topologyDirty{true};
+    bool m_renderObjectsDirty{true};
+    uint64_t m_version{0};              ///< 数据版本号
+    uint64_t m_renderObjectsVersion{0}; ///< 渲染对象列表版本号
+};
+} // namespace rendercore
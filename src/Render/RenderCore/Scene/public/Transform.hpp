@@ -19,14 +19,18 @@ struct Transform
 
     /**
      * @brief 计算此变换的局部模型矩阵
-     * @return glm::mat4 4x4 模型矩阵
+     * @return glm::mat4 4x4 模型矩阵 T * R * S
+     * @details 直接由旋转矩阵按列缩放并写入平移，省去三个中间矩阵与两次矩阵乘法；
+     *          批量计算见 TransformKernels::composeLocal
      */
     glm::mat4 getLocalMatrix() const
     {
-        glm::mat4 trans = glm::translate(glm::mat4(1.0f), position);
-        glm::mat4 rot = glm::mat4_cast(rotation);
-        glm::mat4 sc = glm::scale(glm::mat4(1.0f), scale);
-        return trans * rot * sc;
+        glm::mat4 matrix = glm::mat4_cast(rotation);
+        matrix[0] *= scale.x;
+        matrix[1] *= scale.y;
+        matrix[2] *= scale.z;
+        matrix[3] = glm::vec4(position, 1.0f);
+        return matrix;
     }
 };
 } // namespace rendercore
\ No newline at end of file
@@ -0,0 +1,57 @@
+/**
+ * @file TransformKernels.hpp
+ * @brief 批量 TRS 组合与仿射矩阵乘法
+ * @details 场景的局部与世界矩阵都是仿射矩阵（最后一行恒为 0 0 0 1），只需计算上面的 3x4 部分：
+ *          TRS 直接由四元数展开并按列缩放，不经过 translate/mat4_cast/scale 三个中间矩阵；
+ *          父子相乘只做 3x4 * 3x4。按编译目标选择 SSE2 或 NEON（每次 4 个变换），其余平台回退到标量实现。
+ */
+
+#pragma once
+
+#include "Transform.hpp"
+#include <cstddef>
+#include <glm/glm.hpp>
+
+namespace rendercore
+{
+
+/**
+ * @class TransformKernels
+ * @brief 场景变换的批量计算内核
+ *
+ * @example
+ * @code
+ * // 先批量组合局部矩阵，再按先序原地乘上父节点的世界矩阵
+ * rendercore::TransformKernels::composeLocal(transforms.data(), count, worlds.data());
+ * for (size_t i = 1; i < count; ++i)
+ * {
+ *     rendercore::TransformKernels::multiplyAffine(worlds[parents[i]], worlds[i], worlds[i]);
+ * }
+ * @endcode
+ */
+class TransformKernels
+{
+  public:
+    /**
+     * @brief 把 count 个变换组合为局部矩阵 T * R * S
+     * @param transforms 输入变换
+     * @param count 数量
+     * @param out (输出) 局部矩阵，最后一行为 (0, 0, 0, 1)
+     */
+    static void composeLocal(const Transform *transforms, size_t count, glm::mat4 *out);
+
+    /**
+     * @brief 组合单个变换（与 composeLocal 结果一致）
+     */
+    static glm::mat4 composeLocal(const Transform &transform);
+
+    /**
+     * @brief 仿射矩阵相乘 out = parent * local
+     * @param parent 父矩阵（仿射，不可与 out 为同一对象）
+     * @param local 子矩阵（仿射，可以与 out 为同一对象以原地计算）
+     * @param out (输出) 乘积
+     */
+    static void multiplyAffine(const glm::mat4 &parent, const glm::mat4 &local, glm::mat4 &out);
+};
+
+} // namespace rendercore
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "Camera.hpp"
+#include "Frustum.hpp"
 #include "Light.hpp"
 #include "Scene.hpp"
 #include "SceneNode.hpp"
+#include "SceneStorage.hpp"
 #include "Transform.hpp"
 
 namespace rendercore
@@ -1,4 +1,6 @@
 #include "CommandPoolManager.hpp"
+#include "FrameTimeline.hpp"
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <stdexcept>
@@ -13,7 +15,14 @@ namespace vkcore
 {
 
 // thread_local 静态成员定义
-thread_local std::shared_ptr<ThreadCommandPool> CommandPoolManager::t_threadPool = nullptr;
+thread_local std::array<CommandPoolManager::ThreadCacheEntry, CommandPoolManager::kThreadCacheSize>
+    CommandPoolManager::t_threadCache{};
+thread_local uint32_t CommandPoolManager::t_threadCacheNext = 0;
+
+namespace
+{
+std::atomic<uint64_t> g_nextInstanceId{1}; ///< 实例序号从1开始，0 表示缓存为空
+} // namespace
 
 // ==================== CommandBufferDeleter 实现 ====================
 
@@ -21,7 +30,7 @@ void CommandBufferDeleter::operator()(vk::CommandBuffer *buffer) const
 {
     if (pool && buffer && *buffer)
     {
-        pool->recycle(*buffer, level);
+        pool->recycle(*buffer, level, owner);
         delete buffer;
     }
 }
@@ -29,15 +38,57 @@ void CommandBufferDeleter::operator()(vk::CommandBuffer *buffer) const
 // ==================== CommandPoolManager 实现 ====================
 
 CommandPoolManager::CommandPoolManager(Device &device, uint32_t queueFamilyIndex)
-    : m_device(device), m_queueFamilyIndex(queueFamilyIndex)
+    : m_device(device), m_queueFamilyIndex(queueFamilyIndex), m_instanceId(g_nextInstanceId.fetch_add(1))
 {
 }
 
+CommandPoolManager::CommandPoolManager(Device &device, uint32_t queueFamilyIndex, FrameTimeline &timeline)
+    : m_device(device), m_queueFamilyIndex(queueFamilyIndex), m_instanceId(g_nextInstanceId.fetch_add(1)),
+      m_frameRing(true), m_timeline(&timeline)
+{
+    m_retiredFrame.store(timeline.getRetiredFrame(), std::memory_order_relaxed);
+    m_retireCallbackId = timeline.addRetireCallback(
+        [this](uint64_t retiredFrame) { m_retiredFrame.store(retiredFrame, std::memory_order_release); });
+}
+
 CommandPoolManager::~CommandPoolManager()
 {
+    detachFrameTimeline();
     cleanup();
 }
 
+void CommandPoolManager::detachFrameTimeline()
+{
+    if (m_timeline)
+    {
+        m_timeline->removeRetireCallback(m_retireCallbackId);
+        m_timeline = nullptr;
+        m_retireCallbackId = 0;
+    }
+}
+
+// ==================== 线程局部缓存 ====================
+
+CommandPoolManager::ThreadCacheEntry *CommandPoolManager::findcacheentry() const
+{
+    for (ThreadCacheEntry &entry : t_threadCache)
+    {
+        if (entry.owner == m_instanceId)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+CommandPoolManager::ThreadCacheEntry &CommandPoolManager::insertcacheentry()
+{
+    ThreadCacheEntry &entry = t_threadCache[t_threadCacheNext++ % kThreadCacheSize];
+    entry = ThreadCacheEntry{};
+    entry.owner = m_instanceId;
+    return entry;
+}
+
 std::shared_ptr<ThreadCommandPool> CommandPoolManager::createthreadcommandpool()
 {
     vk::CommandPoolCreateInfo poolInfo{};
@@ -54,61 +105,164 @@ std::shared_ptr<ThreadCommandPool> CommandPoolManager::createthreadcommandpool()
     return std::make_shared<ThreadCommandPool>(commandPool);
 }
 
-std::shared_ptr<ThreadCommandPool> CommandPoolManager::getorcreatethreadpool()
+ThreadCommandPool *CommandPoolManager::getorcreatethreadpool()
 {
     // 先检查 thread_local 缓存
-    if (t_threadPool)
+    if (ThreadCacheEntry *cached = findcacheentry(); cached && cached->pool)
     {
-        return t_threadPool;
+        return cached->pool;
     }
 
     // 如果缓存为空，从 map 中查找或创建
     std::thread::id threadId = std::this_thread::get_id();
+    ThreadCommandPool *threadPool = nullptr;
 
     {
         std::lock_guard<std::mutex> lock(m_mtx);
         auto it = m_threadPools.find(threadId);
         if (it != m_threadPools.end())
         {
-            t_threadPool = it->second;
-            return t_threadPool;
+            threadPool = it->second.get();
         }
     }
 
     // 创建新的命令池
-    auto newPool = createthreadcommandpool();
+    if (!threadPool)
+    {
+        auto newPool = createthreadcommandpool();
+        threadPool = newPool.get();
+
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_threadPools[threadId] = std::move(newPool);
+    }
 
+    insertcacheentry().pool = threadPool;
+    return threadPool;
+}
+
+ThreadFrameRing *CommandPoolManager::getorcreatethreadring()
+{
+    if (ThreadCacheEntry *cached = findcacheentry(); cached && cached->ring)
+    {
+        return cached->ring;
+    }
+
+    // 每个线程只在第一次使用本管理器（或缓存被其他管理器挤出）时加锁
+    ThreadFrameRing *ring = nullptr;
     {
         std::lock_guard<std::mutex> lock(m_mtx);
-        m_threadPools[threadId] = newPool;
+        std::unique_ptr<ThreadFrameRing> &slot = m_threadRings[std::this_thread::get_id()];
+        if (!slot)
+        {
+            slot = std::make_unique<ThreadFrameRing>();
+        }
+        ring = slot.get();
     }
 
-    t_threadPool = newPool;
-    return t_threadPool;
+    insertcacheentry().ring = ring;
+    return ring;
+}
+
+FrameCommandPool &CommandPoolManager::acquireframepool(ThreadFrameRing &ring)
+{
+    if (!m_timeline)
+    {
+        throw std::runtime_error("CommandPoolManager: frame ring allocation without a frame timeline");
+    }
+
+    const uint64_t frame = m_timeline->getFrameNumber();
+    if (ring.current && ring.current->frame == frame)
+    {
+        return *ring.current;
+    }
+
+    // 帧号 0（第一次 beginFrame() 之前）的工作不在时间线上，等到第 1 帧退休时才视为完成
+    const uint64_t retiredFrame = m_retiredFrame.load(std::memory_order_acquire);
+    for (const auto &framePool : ring.pools)
+    {
+        if (std::max<uint64_t>(framePool->frame, 1) <= retiredFrame)
+        {
+            // 所属线程独占访问该池，整体重置后所有缓冲区回到初始状态
+            m_device.get().resetCommandPool(framePool->pool, vk::CommandPoolResetFlags{});
+            framePool->frame = frame;
+            framePool->primaryUsed = 0;
+            framePool->secondaryUsed = 0;
+            ring.resetCount.fetch_add(1, std::memory_order_relaxed);
+            ring.current = framePool.get();
+            return *framePool;
+        }
+    }
+
+    vk::CommandPoolCreateInfo poolInfo{};
+    poolInfo.flags = vk::CommandPoolCreateFlagBits::eTransient; // 缓冲区只存活一帧，不需要单独重置
+    poolInfo.queueFamilyIndex = m_queueFamilyIndex;
+
+    auto framePool = std::make_unique<FrameCommandPool>();
+    framePool->pool = m_device.get().createCommandPool(poolInfo);
+    framePool->frame = frame;
+    ring.current = framePool.get();
+    ring.pools.push_back(std::move(framePool));
+    ring.poolCount.fetch_add(1, std::memory_order_relaxed);
+    return *ring.current;
+}
+
+vk::CommandBuffer *CommandPoolManager::allocatefromring(vk::CommandBufferLevel level)
+{
+    ThreadFrameRing &ring = *getorcreatethreadring();
+    FrameCommandPool &framePool = acquireframepool(ring);
+
+    const bool primary = level == vk::CommandBufferLevel::ePrimary;
+    std::deque<vk::CommandBuffer> &buffers = primary ? framePool.primaryBuffers : framePool.secondaryBuffers;
+    size_t &used = primary ? framePool.primaryUsed : framePool.secondaryUsed;
+
+    // 预分配的缓冲区用完时成倍追加，稳定后每帧都不再调用 vkAllocateCommandBuffers
+    if (used == buffers.size())
+    {
+        vk::CommandBufferAllocateInfo allocInfo{};
+        allocInfo.commandPool = framePool.pool;
+        allocInfo.level = level;
+        allocInfo.commandBufferCount = std::max<uint32_t>(kRingGrowth, static_cast<uint32_t>(buffers.size()));
+
+        std::vector<vk::CommandBuffer> newBuffers = m_device.get().allocateCommandBuffers(allocInfo);
+        buffers.insert(buffers.end(), newBuffers.begin(), newBuffers.end());
+        ring.allocatedCount.fetch_add(newBuffers.size(), std::memory_order_relaxed);
+    }
+
+    return &buffers[used++];
 }
 
 vk::CommandPool CommandPoolManager::getCommandPool()
 {
-    auto pool = getorcreatethreadpool();
-    return pool->pool;
+    if (m_frameRing)
+    {
+        return acquireframepool(*getorcreatethreadring()).pool;
+    }
+    return getorcreatethreadpool()->pool;
 }
 
 vk::CommandBuffer CommandPoolManager::allocateinternal(vk::CommandBufferLevel level)
 {
-    auto threadPool = getorcreatethreadpool();
+    ThreadCommandPool *threadPool = getorcreatethreadpool();
 
     // 先尝试从对象池中获取
     auto &freeBuffers =
         (level == vk::CommandBufferLevel::ePrimary) ? threadPool->freePrimaryBuffers : threadPool->freeSecondaryBuffers;
 
-    if (!freeBuffers.empty())
+    vk::CommandBuffer reused = nullptr;
     {
-        vk::CommandBuffer buffer = freeBuffers.front();
-        freeBuffers.pop();
+        std::lock_guard<std::mutex> lock(threadPool->freeMtx);
+        if (!freeBuffers.empty())
+        {
+            reused = freeBuffers.front();
+            freeBuffers.pop();
+        }
+    }
 
-        // 重置命令缓冲区
-        buffer.reset(vk::CommandBufferResetFlags{});
-        return buffer;
+    if (reused)
+    {
+        // 重置命令缓冲区（命令池只在所属线程上使用，无需额外同步）
+        reused.reset(vk::CommandBufferResetFlags{});
+        return reused;
     }
 
     // 对象池为空，分配新的
@@ -125,36 +279,57 @@ vk::CommandBuffer CommandPoolManager::allocateinternal(vk::CommandBufferLevel le
 
 CommandBufferHandle CommandPoolManager::allocate(vk::CommandBufferLevel level)
 {
-    auto threadPool = getorcreatethreadpool();
+    if (m_frameRing)
+    {
+        return CommandBufferHandle(allocatefromring(level), CommandBufferDeleter{nullptr, level, nullptr});
+    }
+
+    ThreadCommandPool *threadPool = getorcreatethreadpool();
     threadPool->inUseCount++; // 增加使用计数
 
     vk::CommandBuffer buffer = allocateinternal(level);
     vk::CommandBuffer *bufferPtr = new vk::CommandBuffer(buffer);
-    return CommandBufferHandle(bufferPtr, CommandBufferDeleter{this, level});
+    return CommandBufferHandle(bufferPtr, CommandBufferDeleter{this, level, threadPool});
 }
 
 std::vector<CommandBufferHandle> CommandPoolManager::allocateBatch(uint32_t count, vk::CommandBufferLevel level)
 {
-    auto threadPool = getorcreatethreadpool();
-    threadPool->inUseCount += count; // 增加使用计数
-
     std::vector<CommandBufferHandle> handles;
     handles.reserve(count);
 
+    if (m_frameRing)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            handles.emplace_back(allocatefromring(level), CommandBufferDeleter{nullptr, level, nullptr});
+        }
+        return handles;
+    }
+
+    ThreadCommandPool *threadPool = getorcreatethreadpool();
+    threadPool->inUseCount += count; // 增加使用计数
+
     auto &freeBuffers =
         (level == vk::CommandBufferLevel::ePrimary) ? threadPool->freePrimaryBuffers : threadPool->freeSecondaryBuffers;
 
     // 先从对象池中获取
-    uint32_t reusedCount = 0;
-    while (reusedCount < count && !freeBuffers.empty())
+    std::vector<vk::CommandBuffer> reusedBuffers;
+    {
+        std::lock_guard<std::mutex> lock(threadPool->freeMtx);
+        while (reusedBuffers.size() < count && !freeBuffers.empty())
+        {
+            reusedBuffers.push_back(freeBuffers.front());
+            freeBuffers.pop();
+        }
+    }
+
+    uint32_t reusedCount = static_cast<uint32_t>(reusedBuffers.size());
+    for (vk::CommandBuffer buffer : reusedBuffers)
     {
-        vk::CommandBuffer buffer = freeBuffers.front();
-        freeBuffers.pop();
         buffer.reset(vk::CommandBufferResetFlags{});
 
         vk::CommandBuffer *bufferPtr = new vk::CommandBuffer(buffer);
-        handles.emplace_back(bufferPtr, CommandBufferDeleter{this, level});
-        reusedCount++;
+        handles.emplace_back(bufferPtr, CommandBufferDeleter{this, level, threadPool});
     }
 
     // 如果对象池不够，批量分配新的
@@ -171,7 +346,7 @@ std::vector<CommandBufferHandle> CommandPoolManager::allocateBatch(uint32_t coun
         for (auto buffer : newBuffers)
         {
             vk::CommandBuffer *bufferPtr = new vk::CommandBuffer(buffer);
-            handles.emplace_back(bufferPtr, CommandBufferDeleter{this, level});
+            handles.emplace_back(bufferPtr, CommandBufferDeleter{this, level, threadPool});
         }
 
         threadPool->allocatedCount += needAllocate;
@@ -180,24 +355,25 @@ std::vector<CommandBufferHandle> CommandPoolManager::allocateBatch(uint32_t coun
     return handles;
 }
 
-void CommandPoolManager::recycle(vk::CommandBuffer buffer, vk::CommandBufferLevel level)
+void CommandPoolManager::recycle(vk::CommandBuffer buffer, vk::CommandBufferLevel level, ThreadCommandPool *owner)
 {
-    // 回收到当前线程的对象池
-    if (!t_threadPool || !buffer)
+    // 回收到分配该缓冲区的线程对象池（而不是当前线程的）
+    if (!owner || !buffer)
     {
         return;
     }
 
     // 减少使用计数
-    t_threadPool->inUseCount--;
+    owner->inUseCount--;
 
+    std::lock_guard<std::mutex> lock(owner->freeMtx);
     if (level == vk::CommandBufferLevel::ePrimary)
     {
-        t_threadPool->freePrimaryBuffers.push(buffer);
+        owner->freePrimaryBuffers.push(buffer);
     }
     else
     {
-        t_threadPool->freeSecondaryBuffers.push(buffer);
+        owner->freeSecondaryBuffers.push(buffer);
     }
 }
 
@@ -220,8 +396,11 @@ void CommandPoolManager::executeOnetime(vk::Queue queue, std::function<void(vk::
     vk::SubmitInfo submitInfo{};
     submitInfo.setCommandBuffers(*cmd);
 
-    queue.submit(submitInfo, nullptr);
-    queue.waitIdle();
+    {
+        std::lock_guard<std::mutex> queueLock(m_device.getQueueMutex(queue));
+        queue.submit(submitInfo, nullptr);
+        queue.waitIdle();
+    }
 
     // cmd 析构时自动回收
 }
@@ -261,11 +440,17 @@ void CommandPoolManager::submit(vk::Queue queue, const std::vector<CommandBuffer
         submitInfo.setSignalSemaphores(signalSemaphores);
     }
 
+    std::lock_guard<std::mutex> queueLock(m_device.getQueueMutex(queue));
     queue.submit(submitInfo, fence);
 }
 
 void CommandPoolManager::resetCommandPool(std::thread::id threadId)
 {
+    if (m_frameRing)
+    {
+        throw std::runtime_error("Cannot reset command pool: frame ring pools are reset when their frame retires");
+    }
+
     std::lock_guard<std::mutex> lock(m_mtx);
     auto it = m_threadPools.find(threadId);
     if (it != m_threadPools.end())
@@ -280,6 +465,7 @@ void CommandPoolManager::resetCommandPool(std::thread::id threadId)
         }
 
         // 清空对象池
+        std::lock_guard<std::mutex> freeLock(threadPool->freeMtx);
         while (!threadPool->freePrimaryBuffers.empty())
         {
             threadPool->freePrimaryBuffers.pop();
@@ -316,7 +502,18 @@ void CommandPoolManager::cleanup()
     }
 
     m_threadPools.clear();
-    t_threadPool = nullptr;
+
+    for (auto &[threadId, ring] : m_threadRings)
+    {
+        for (const auto &framePool : ring->pools)
+        {
+            m_device.get().destroyCommandPool(framePool->pool);
+        }
+    }
+    m_threadRings.clear();
+
+    // 更换实例序号，使所有线程缓存中指向已销毁对象的项失效
+    m_instanceId = g_nextInstanceId.fetch_add(1);
 }
 
 CommandPoolManager::PoolStats CommandPoolManager::getStats() const
@@ -329,10 +526,20 @@ CommandPoolManager::PoolStats CommandPoolManager::getStats() const
     for (const auto &[threadId, threadPool] : m_threadPools)
     {
         stats.totalAllocatedBuffers += threadPool->allocatedCount;
+
+        std::lock_guard<std::mutex> freeLock(threadPool->freeMtx);
         stats.totalFreeBuffers += threadPool->freePrimaryBuffers.size();
         stats.totalFreeBuffers += threadPool->freeSecondaryBuffers.size();
     }
 
+    for (const auto &[threadId, ring] : m_threadRings)
+    {
+        stats.totalThreadPools++;
+        stats.totalAllocatedBuffers += ring->allocatedCount.load(std::memory_order_relaxed);
+        stats.totalFramePools += ring->poolCount.load(std::memory_order_relaxed);
+        stats.totalPoolResets += ring->resetCount.load(std::memory_order_relaxed);
+    }
+
     return stats;
 }
 
@@ -0,0 +1,100 @@
+#include "DeferredDeletionQueue.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @file DeferredDeletionQueue.cpp
+ * @brief DeferredDeletionQueue 类的实现文件
+ */
+
+namespace vkcore
+{
+
+DeferredDeletionQueue::DeferredDeletionQueue(FrameTimeline &timeline)
+{
+    attach(timeline);
+}
+
+DeferredDeletionQueue::~DeferredDeletionQueue()
+{
+    detach();
+    flush();
+}
+
+void DeferredDeletionQueue::attach(FrameTimeline &timeline)
+{
+    detach();
+    m_timeline = &timeline;
+    m_callbackId = timeline.addRetireCallback([this](uint64_t retiredFrame) { retire(retiredFrame); });
+}
+
+void DeferredDeletionQueue::detach()
+{
+    if (m_timeline)
+    {
+        m_timeline->removeRetireCallback(m_callbackId);
+        m_timeline = nullptr;
+        m_callbackId = 0;
+    }
+}
+
+void DeferredDeletionQueue::enqueue(uint64_t frame, Deleter deleter)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    // 绝大多数入队使用当前帧号，从尾部查找插入位置
+    auto it = std::upper_bound(m_entries.rbegin(), m_entries.rend(), frame,
+                               [](uint64_t value, const Entry &entry) { return value >= entry.frame; })
+                  .base();
+    m_entries.insert(it, Entry{frame, std::move(deleter)});
+}
+
+void DeferredDeletionQueue::enqueue(Deleter deleter)
+{
+    if (!m_timeline)
+    {
+        throw std::runtime_error("DeferredDeletionQueue::enqueue: no frame timeline attached");
+    }
+    enqueue(m_timeline->getFrameNumber(), std::move(deleter));
+}
+
+void DeferredDeletionQueue::retire(uint64_t completedFrame)
+{
+    std::deque<Entry> expired;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        while (!m_entries.empty() && m_entries.front().frame <= completedFrame)
+        {
+            expired.push_back(std::move(m_entries.front()));
+            m_entries.pop_front();
+        }
+    }
+    run(expired);
+}
+
+void DeferredDeletionQueue::flush()
+{
+    std::deque<Entry> expired;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        expired.swap(m_entries);
+    }
+    run(expired);
+}
+
+size_t DeferredDeletionQueue::getPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_entries.size();
+}
+
+void DeferredDeletionQueue::run(std::deque<Entry> &entries)
+{
+    for (auto &entry : entries)
+    {
+        entry.deleter();
+    }
+    entries.clear();
+}
+
+} // namespace vkcore
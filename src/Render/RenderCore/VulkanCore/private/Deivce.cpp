@@ -1,5 +1,7 @@
 #include "Device.hpp"
+#include <algorithm>
 #include <set>
+#include <stdexcept>
 
 /**
  * @file Device.cpp
@@ -23,6 +25,14 @@ Device::Device(vk::Instance &instance, VkSurfaceKHR &surface, const Config &conf
     createlogicaldevice();
 }
 
+Device::Device(vk::Instance &instance, const Config &config)
+    : m_instance(instance), m_surface(m_headlessSurface), m_config(config)
+{
+    selectphyscialdevice();
+    findqueuefamilies();
+    createlogicaldevice();
+}
+
 void Device::selectphyscialdevice()
 {
     std::vector<vk::PhysicalDevice> devices = m_instance.enumeratePhysicalDevices();
@@ -56,47 +66,75 @@ void Device::findqueuefamilies()
     // 获取所有队列族属性
     std::vector<vk::QueueFamilyProperties> queueFamilies = m_physicalDevice.getQueueFamilyProperties();
 
-    // 遍历队列族，查找支持图形和呈现的队列族
+    // 遍历全部队列族：图形/呈现取第一个满足条件的族，计算/传输优先寻找专用族
     uint32_t i = 0;
     for (const auto &queueFamily : queueFamilies)
     {
         // 检查是否支持图形操作
-        if (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics)
+        if (!m_queueFamilyIndices.graphicsFamily && (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics))
         {
             m_queueFamilyIndices.graphicsFamily = i;
         }
 
-        // 检查是否支持呈现操作（使用 surface）
+        // 检查是否支持呈现操作（使用 surface）；headless 设备没有表面，呈现族在下面取图形族
         VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(m_physicalDevice, i, m_surface, &presentSupport);
-        if (presentSupport)
+        if (!isHeadless())
+        {
+            vkGetPhysicalDeviceSurfaceSupportKHR(m_physicalDevice, i, m_surface, &presentSupport);
+        }
+        if (!m_queueFamilyIndices.presentFamily && presentSupport)
         {
             m_queueFamilyIndices.presentFamily = i;
         }
 
-        // 如果两个队列族都找到了，提前退出
-        if (m_queueFamilyIndices.isComplete())
+        // 专用计算族：支持计算但不支持图形（可与图形队列并行执行）
+        if (!m_queueFamilyIndices.computeFamily && (queueFamily.queueFlags & vk::QueueFlagBits::eCompute) &&
+            !(queueFamily.queueFlags & vk::QueueFlagBits::eGraphics))
+        {
+            m_queueFamilyIndices.computeFamily = i;
+        }
+
+        // 专用传输族：只支持传输（通常对应独立的 DMA 引擎）
+        if (!m_queueFamilyIndices.transferFamily && (queueFamily.queueFlags & vk::QueueFlagBits::eTransfer) &&
+            !(queueFamily.queueFlags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute)))
         {
-            break;
+            m_queueFamilyIndices.transferFamily = i;
         }
 
         i++;
     }
 
+    // OffscreenSwapChain 的“呈现”只是回读拷贝与时间线信号，不需要呈现能力
+    if (isHeadless())
+    {
+        m_queueFamilyIndices.presentFamily = m_queueFamilyIndices.graphicsFamily;
+    }
+
     // 验证是否找到了所需的队列族
     if (!m_queueFamilyIndices.isComplete())
     {
         throw std::runtime_error("Failed to find required queue families!");
     }
+
+    // 没有专用族时回退：图形/计算族隐式支持传输操作
+    if (!m_queueFamilyIndices.computeFamily)
+    {
+        m_queueFamilyIndices.computeFamily = m_queueFamilyIndices.graphicsFamily;
+    }
+    if (!m_queueFamilyIndices.transferFamily)
+    {
+        m_queueFamilyIndices.transferFamily = m_queueFamilyIndices.computeFamily;
+    }
 }
 
 void Device::createlogicaldevice()
 {
     // 准备队列创建信息
     std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
-    // 使用 set 去重：如果图形和呈现是同一个队列族，只创建一次
-    std::set<uint32_t> uniqueQueueFamilies = {m_queueFamilyIndices.graphicsFamily.value(),
-                                              m_queueFamilyIndices.presentFamily.value()};
+    // 使用 set 去重：多个用途共享同一个队列族时只创建一次
+    std::set<uint32_t> uniqueQueueFamilies = {
+        m_queueFamilyIndices.graphicsFamily.value(), m_queueFamilyIndices.presentFamily.value(),
+        m_queueFamilyIndices.computeFamily.value(), m_queueFamilyIndices.transferFamily.value()};
 
     float queuePriority = 1.0f;
     for (uint32_t queueFamily : uniqueQueueFamilies)
@@ -108,6 +146,51 @@ void Device::createlogicaldevice()
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
+    // 可选特性：设备支持时并入必需列表一起启用，之后可通过 isFeatureEnabled 查询
+    for (const auto &feature : m_config.optional_features)
+    {
+        if (checkspeficfeaturesupport(m_physicalDevice, feature))
+        {
+            m_config.vulkan1_0_features.push_back(feature);
+        }
+    }
+    // 可选 Vulkan 1.2 特性同理（bindless 所需的描述符索引特性）
+    for (const auto &feature : m_config.optional_vulkan1_2_features)
+    {
+        if (checkspeficfeaturesupport(m_physicalDevice, feature))
+        {
+            m_config.vulkan1_2_features.push_back(feature);
+        }
+    }
+
+    // 可选扩展：同样在设备支持时并入必需扩展列表，之后可通过 isExtensionEnabled 查询
+    for (const auto &extension : m_config.optional_extensions)
+    {
+        if (!isExtensionEnabled(extension) && checkoptionalextensionsupport(m_physicalDevice, extension))
+        {
+            m_config.deviceExtensions.push_back(extension);
+        }
+    }
+    // 管线库扩展依赖 VK_KHR_pipeline_library，并需要在 pNext 链中启用 graphicsPipelineLibrary 特性
+    const bool graphicsPipelineLibrary = isExtensionEnabled(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+    if (graphicsPipelineLibrary && !isExtensionEnabled(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME))
+    {
+        m_config.deviceExtensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+    }
+    // present wait 按 present id 等待，两者必须同时启用
+    const bool presentWait = isExtensionEnabled(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    if (presentWait && !isExtensionEnabled(VK_KHR_PRESENT_ID_EXTENSION_NAME))
+    {
+        m_config.deviceExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+    }
+    const bool presentId = isExtensionEnabled(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+    // 模块标识扩展：以标识创建管线需要 VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT（pipelineCreationCacheControl）
+    const bool shaderModuleIdentifier = isExtensionEnabled(VK_EXT_SHADER_MODULE_IDENTIFIER_EXTENSION_NAME);
+    if (shaderModuleIdentifier && !isFeatureEnabled("pipelineCreationCacheControl"))
+    {
+        m_config.vulkan1_3_features.push_back("pipelineCreationCacheControl");
+    }
+
     // 准备设备特性
     vk::PhysicalDeviceFeatures deviceFeatures{};
 
@@ -132,6 +215,18 @@ void Device::createlogicaldevice()
             deviceFeatures.drawIndirectFirstInstance = VK_TRUE;
         else if (feature == "depthClamp")
             deviceFeatures.depthClamp = VK_TRUE;
+        else if (feature == "textureCompressionBC")
+            deviceFeatures.textureCompressionBC = VK_TRUE;
+        else if (feature == "textureCompressionASTC_LDR")
+            deviceFeatures.textureCompressionASTC_LDR = VK_TRUE;
+        else if (feature == "textureCompressionETC2")
+            deviceFeatures.textureCompressionETC2 = VK_TRUE;
+        else if (feature == "pipelineStatisticsQuery")
+            deviceFeatures.pipelineStatisticsQuery = VK_TRUE;
+        else if (feature == "sparseBinding")
+            deviceFeatures.sparseBinding = VK_TRUE;
+        else if (feature == "sparseResidencyImage2D")
+            deviceFeatures.sparseResidencyImage2D = VK_TRUE;
     }
 
     // 准备 Vulkan 1.3 和 1.2 特性结构
@@ -147,6 +242,8 @@ void Device::createlogicaldevice()
             features13.synchronization2 = VK_TRUE;
         else if (feature == "maintenance4")
             features13.maintenance4 = VK_TRUE;
+        else if (feature == "pipelineCreationCacheControl")
+            features13.pipelineCreationCacheControl = VK_TRUE;
     }
 
     // 根据 config 启用 Vulkan 1.2 特性
@@ -158,10 +255,91 @@ void Device::createlogicaldevice()
             features12.descriptorIndexing = VK_TRUE;
         else if (feature == "timelineSemaphore")
             features12.timelineSemaphore = VK_TRUE;
-    }
+        else if (feature == "drawIndirectCount")
+            features12.drawIndirectCount = VK_TRUE;
+        else if (feature == "runtimeDescriptorArray")
+            features12.runtimeDescriptorArray = VK_TRUE;
+        else if (feature == "descriptorBindingPartiallyBound")
+            features12.descriptorBindingPartiallyBound = VK_TRUE;
+        else if (feature == "descriptorBindingVariableDescriptorCount")
+            features12.descriptorBindingVariableDescriptorCount = VK_TRUE;
+        else if (feature == "descriptorBindingSampledImageUpdateAfterBind")
+            features12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        else if (feature == "descriptorBindingStorageBufferUpdateAfterBind")
+            features12.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        else if (feature == "descriptorBindingUpdateUnusedWhilePending")
+            features12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        else if (feature == "shaderSampledImageArrayNonUniformIndexing")
+            features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+        else if (feature == "hostQueryReset")
+            features12.hostQueryReset = VK_TRUE;
+    }
+
+    vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeatures{};
+    graphicsPipelineLibraryFeatures.graphicsPipelineLibrary = VK_TRUE;
+
+    // 网格着色器扩展同时启用任务与网格着色阶段
+    const bool meshShader = isExtensionEnabled(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+    vk::PhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures{};
+    meshShaderFeatures.taskShader = VK_TRUE;
+    meshShaderFeatures.meshShader = VK_TRUE;
+
+    // 可变速率着色：逐管线速率与着色速率附件（图元速率需要在顶点着色器中写 PrimitiveShadingRate，不启用）
+    const bool fragmentShadingRate = isExtensionEnabled(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME);
+    vk::PhysicalDeviceFragmentShadingRateFeaturesKHR fragmentShadingRateFeatures{};
+    fragmentShadingRateFeatures.pipelineFragmentShadingRate = VK_TRUE;
+    fragmentShadingRateFeatures.attachmentFragmentShadingRate = VK_TRUE;
+
+    vk::PhysicalDeviceShaderModuleIdentifierFeaturesEXT shaderModuleIdentifierFeatures{};
+    shaderModuleIdentifierFeatures.shaderModuleIdentifier = VK_TRUE;
+
+    // 动态渲染局部读取：合并的渲染实例内以输入附件读取同一像素的颜色附件
+    const bool localRead = isExtensionEnabled(VK_KHR_DYNAMIC_RENDERING_LOCAL_READ_EXTENSION_NAME);
+    vk::PhysicalDeviceDynamicRenderingLocalReadFeaturesKHR localReadFeatures{};
+    localReadFeatures.dynamicRenderingLocalRead = VK_TRUE;
+
+    vk::PhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.presentId = VK_TRUE;
+    vk::PhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.presentWait = VK_TRUE;
 
     // 构建 pNext 链
     void *pNext = nullptr;
+    if (graphicsPipelineLibrary)
+    {
+        graphicsPipelineLibraryFeatures.pNext = pNext;
+        pNext = &graphicsPipelineLibraryFeatures;
+    }
+    if (meshShader)
+    {
+        meshShaderFeatures.pNext = pNext;
+        pNext = &meshShaderFeatures;
+    }
+    if (fragmentShadingRate)
+    {
+        fragmentShadingRateFeatures.pNext = pNext;
+        pNext = &fragmentShadingRateFeatures;
+    }
+    if (shaderModuleIdentifier)
+    {
+        shaderModuleIdentifierFeatures.pNext = pNext;
+        pNext = &shaderModuleIdentifierFeatures;
+    }
+    if (localRead)
+    {
+        localReadFeatures.pNext = pNext;
+        pNext = &localReadFeatures;
+    }
+    if (presentId)
+    {
+        presentIdFeatures.pNext = pNext;
+        pNext = &presentIdFeatures;
+    }
+    if (presentWait)
+    {
+        presentWaitFeatures.pNext = pNext;
+        pNext = &presentWaitFeatures;
+    }
     if (!m_config.vulkan1_2_features.empty())
     {
         features12.pNext = pNext;
@@ -197,6 +375,31 @@ void Device::createlogicaldevice()
     // 如果队列族不同，则分别从各自的队列族获取
     m_graphicsQueue = m_device.getQueue(m_queueFamilyIndices.graphicsFamily.value(), 0);
     m_presentQueue = m_device.getQueue(m_queueFamilyIndices.presentFamily.value(), 0);
+    m_computeQueue = m_device.getQueue(m_queueFamilyIndices.computeFamily.value(), 0);
+    m_transferQueue = m_device.getQueue(m_queueFamilyIndices.transferFamily.value(), 0);
+
+    // 同一个队列句柄只登记一次，共用同一个提交互斥量
+    size_t queueCount = 0;
+    for (vk::Queue queue : {m_graphicsQueue, m_presentQueue, m_computeQueue, m_transferQueue})
+    {
+        if (std::find(m_uniqueQueues.begin(), m_uniqueQueues.begin() + queueCount, queue) ==
+            m_uniqueQueues.begin() + queueCount)
+        {
+            m_uniqueQueues[queueCount++] = queue;
+        }
+    }
+}
+
+std::mutex &Device::getQueueMutex(vk::Queue queue) const
+{
+    for (size_t i = 0; i < m_uniqueQueues.size(); ++i)
+    {
+        if (queue && m_uniqueQueues[i] == queue)
+        {
+            return m_queueMutexes[i];
+        }
+    }
+    throw std::invalid_argument("Device::getQueueMutex: queue does not belong to this device");
 }
 
 bool Device::checkdeviceextensionsupport(vk::PhysicalDevice &device)
@@ -308,6 +511,13 @@ bool Device::checkspeficfeaturesupport(vk::PhysicalDevice &device, std::string f
         return features13.get<vk::PhysicalDeviceVulkan13Features>().maintenance4 == VK_TRUE;
     }
 
+    if (feature == "pipelineCreationCacheControl")
+    {
+
+        auto features13 = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan13Features>();
+        return features13.get<vk::PhysicalDeviceVulkan13Features>().pipelineCreationCacheControl == VK_TRUE;
+    }
+
     // Vulkan 1.2 特性检查
     if (feature == "bufferDeviceAddress")
     {
@@ -328,6 +538,64 @@ bool Device::checkspeficfeaturesupport(vk::PhysicalDevice &device, std::string f
         return features12.get<vk::PhysicalDeviceVulkan12Features>().timelineSemaphore == VK_TRUE;
     }
 
+    if (feature == "drawIndirectCount")
+    {
+        auto features12 = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        return features12.get<vk::PhysicalDeviceVulkan12Features>().drawIndirectCount == VK_TRUE;
+    }
+
+    if (feature == "runtimeDescriptorArray")
+    {
+        auto features12 = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        return features12.get<vk::PhysicalDeviceVulkan12Features>().runtimeDescriptorArray == VK_TRUE;
+    }
+
+    if (feature == "descriptorBindingPartiallyBound")
+    {
+        auto features12 = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        return features12.get<vk::PhysicalDeviceVulkan12Features>().descriptorBindingPartiallyBound == VK_TRUE;
+    }
+
+    if (feature == "descriptorBindingVariableDescriptorCount")
+    {
+        auto features12 = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        return features12.get<vk::PhysicalDeviceVulkan12Features>().descriptorBindingVariableDescriptorCount == VK_TRUE;
+    }
+
+    if (feature == "descriptorBindingSampledImageUpdateAfterBind")
+    {
+        auto features12 = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        return features12.get<vk::PhysicalDeviceVulkan12Features>().descriptorBindingSampledImageUpdateAfterBind ==
+               VK_TRUE;
+    }
+
+    if (feature == "descriptorBindingStorageBufferUpdateAfterBind")
+    {
+        auto features12 = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        return features12.get<vk::PhysicalDeviceVulkan12Features>().descriptorBindingStorageBufferUpdateAfterBind ==
+               VK_TRUE;
+    }
+
+    if (feature == "descriptorBindingUpdateUnusedWhilePending")
+    {
+        auto features12 = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        return features12.get<vk::PhysicalDeviceVulkan12Features>().descriptorBindingUpdateUnusedWhilePending ==
+               VK_TRUE;
+    }
+
+    if (feature == "shaderSampledImageArrayNonUniformIndexing")
+    {
+        auto features12 = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        return features12.get<vk::PhysicalDeviceVulkan12Features>().shaderSampledImageArrayNonUniformIndexing ==
+               VK_TRUE;
+    }
+
+    if (feature == "hostQueryReset")
+    {
+        auto features12 = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        return features12.get<vk::PhysicalDeviceVulkan12Features>().hostQueryReset == VK_TRUE;
+    }
+
     if (feature == "shaderFloat16")
     {
         auto features12 = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
@@ -414,6 +682,30 @@ bool Device::checkspeficfeaturesupport(vk::PhysicalDevice &device, std::string f
         return features.depthClamp == VK_TRUE;
     }
 
+    if (feature == "textureCompressionBC")
+    {
+        auto features = device.getFeatures();
+        return features.textureCompressionBC == VK_TRUE;
+    }
+
+    if (feature == "textureCompressionASTC_LDR")
+    {
+        auto features = device.getFeatures();
+        return features.textureCompressionASTC_LDR == VK_TRUE;
+    }
+
+    if (feature == "textureCompressionETC2")
+    {
+        auto features = device.getFeatures();
+        return features.textureCompressionETC2 == VK_TRUE;
+    }
+
+    if (feature == "pipelineStatisticsQuery")
+    {
+        auto features = device.getFeatures();
+        return features.pipelineStatisticsQuery == VK_TRUE;
+    }
+
     if (feature == "depthBiasClamp")
     {
         auto features = device.getFeatures();
@@ -586,6 +878,80 @@ bool Device::checkspeficfeaturesupport(vk::PhysicalDevice &device, std::string f
     return false;
 }
 
+bool Device::checkoptionalextensionsupport(vk::PhysicalDevice &device, const std::string &extension)
+{
+    std::vector<vk::ExtensionProperties> availableExtensions = device.enumerateDeviceExtensionProperties();
+    auto isAvailable = [&](const char *name) {
+        for (const vk::ExtensionProperties &ext : availableExtensions)
+        {
+            if (std::strcmp(ext.extensionName, name) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if (!isAvailable(extension.c_str()))
+    {
+        return false;
+    }
+
+    // 扩展存在但特性未实现时不能启用（部分驱动公开扩展名但 graphicsPipelineLibrary 为 VK_FALSE）
+    if (extension == VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME)
+    {
+        auto features = device.getFeatures2<vk::PhysicalDeviceFeatures2,
+                                            vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>();
+        return isAvailable(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+               features.get<vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>().graphicsPipelineLibrary ==
+                   VK_TRUE;
+    }
+    if (extension == VK_EXT_MESH_SHADER_EXTENSION_NAME)
+    {
+        auto features =
+            device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceMeshShaderFeaturesEXT>();
+        const auto &meshFeatures = features.get<vk::PhysicalDeviceMeshShaderFeaturesEXT>();
+        return meshFeatures.taskShader == VK_TRUE && meshFeatures.meshShader == VK_TRUE;
+    }
+    if (extension == VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME)
+    {
+        // 只有逐管线速率的实现（部分移动端）无法使用着色速率附件，视为不支持
+        auto features =
+            device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceFragmentShadingRateFeaturesKHR>();
+        const auto &rateFeatures = features.get<vk::PhysicalDeviceFragmentShadingRateFeaturesKHR>();
+        return rateFeatures.pipelineFragmentShadingRate == VK_TRUE &&
+               rateFeatures.attachmentFragmentShadingRate == VK_TRUE;
+    }
+    if (extension == VK_EXT_SHADER_MODULE_IDENTIFIER_EXTENSION_NAME)
+    {
+        auto features = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan13Features,
+                                            vk::PhysicalDeviceShaderModuleIdentifierFeaturesEXT>();
+        return features.get<vk::PhysicalDeviceVulkan13Features>().pipelineCreationCacheControl == VK_TRUE &&
+               features.get<vk::PhysicalDeviceShaderModuleIdentifierFeaturesEXT>().shaderModuleIdentifier == VK_TRUE;
+    }
+    if (extension == VK_KHR_DYNAMIC_RENDERING_LOCAL_READ_EXTENSION_NAME)
+    {
+        auto features = device.getFeatures2<vk::PhysicalDeviceFeatures2,
+                                            vk::PhysicalDeviceDynamicRenderingLocalReadFeaturesKHR>();
+        return features.get<vk::PhysicalDeviceDynamicRenderingLocalReadFeaturesKHR>().dynamicRenderingLocalRead ==
+               VK_TRUE;
+    }
+    if (extension == VK_KHR_PRESENT_ID_EXTENSION_NAME)
+    {
+        auto features = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDevicePresentIdFeaturesKHR>();
+        return features.get<vk::PhysicalDevicePresentIdFeaturesKHR>().presentId == VK_TRUE;
+    }
+    if (extension == VK_KHR_PRESENT_WAIT_EXTENSION_NAME)
+    {
+        auto features = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDevicePresentIdFeaturesKHR,
+                                            vk::PhysicalDevicePresentWaitFeaturesKHR>();
+        return isAvailable(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+               features.get<vk::PhysicalDevicePresentIdFeaturesKHR>().presentId == VK_TRUE &&
+               features.get<vk::PhysicalDevicePresentWaitFeaturesKHR>().presentWait == VK_TRUE;
+    }
+    return true;
+}
+
 int Device::ratedevicescore(vk::PhysicalDevice &device)
 {
     //暂时只区分离散GPU和集成GPU
@@ -608,12 +974,35 @@ Device::~Device()
     cleanup();
 }
 
+bool Device::isFeatureEnabled(const std::string &feature) const
+{
+    for (const auto *features : {&m_config.vulkan1_0_features, &m_config.vulkan1_1_features,
+                                 &m_config.vulkan1_2_features, &m_config.vulkan1_3_features})
+    {
+        if (std::find(features->begin(), features->end(), feature) != features->end())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Device::isExtensionEnabled(const std::string &extension) const
+{
+    return std::find(m_config.deviceExtensions.begin(), m_config.deviceExtensions.end(), extension) !=
+           m_config.deviceExtensions.end();
+}
+
 void Device::cleanup()
 {
     if (m_graphicsQueue)
     {
         m_graphicsQueue = nullptr;
     }
+    m_presentQueue = nullptr;
+    m_computeQueue = nullptr;
+    m_transferQueue = nullptr;
+    m_uniqueQueues.fill(nullptr);
 
     if (m_device)
     {
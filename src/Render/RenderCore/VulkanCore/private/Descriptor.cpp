@@ -6,6 +6,7 @@
  * 该文件包含 Vulkan 描述符系统的核心实现，包括：
  * - DescriptorLayoutCache：基于哈希表的布局缓存，使用自定义哈希和相等性函数
  * - DescriptorAllocator：池化分配器，支持多种描述符类型和自动扩展
+ * - FrameDescriptorAllocator：每线程、每帧的线性池，线程局部缓存使分配路径无锁
  * - DescriptorLayoutBuilder：构建器模式的简化接口实现
  * - DescriptorUpdater：描述符更新的辅助工具实现
  *
@@ -15,9 +16,41 @@
  */
 
 #include "Descriptor.hpp"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
 
 namespace vkcore
 {
+
+namespace
+{
+
+/// 线性池中每个描述符集平均预留的各类型描述符数量
+constexpr std::array<vk::DescriptorPoolSize, 8> kFramePoolRatios = {{
+    {vk::DescriptorType::eCombinedImageSampler, 4},
+    {vk::DescriptorType::eUniformBuffer, 2},
+    {vk::DescriptorType::eStorageBuffer, 2},
+    {vk::DescriptorType::eUniformBufferDynamic, 1},
+    {vk::DescriptorType::eStorageBufferDynamic, 1},
+    {vk::DescriptorType::eSampledImage, 1},
+    {vk::DescriptorType::eSampler, 1},
+    {vk::DescriptorType::eStorageImage, 1},
+}};
+
+/// FrameDescriptorAllocator 的全局 ID 计数（0 保留给空缓存）
+std::atomic<uint64_t> g_nextFrameAllocatorId{1};
+
+/// 调用线程最近使用的 FrameDescriptorAllocator 及其池
+struct FrameAllocatorCache
+{
+    uint64_t owner{0};
+    void *pools{nullptr};
+};
+thread_local FrameAllocatorCache t_frameAllocatorCache;
+
+} // namespace
 // ========================================
 // DescriptorLayoutCache 类的实现
 // ========================================
@@ -317,6 +350,160 @@ std::map<vk::DescriptorType, uint32_t> DescriptorAllocator::getDescriptorCounts(
     return counts;
 }
 
+// ========================================
+// FrameDescriptorAllocator 类的实现
+// ========================================
+
+FrameDescriptorAllocator::FrameDescriptorAllocator(Device &device, uint32_t framesInFlight, uint32_t setsPerPool)
+    : m_device(device), m_framesInFlight(framesInFlight), m_setsPerPool(setsPerPool),
+      m_id(g_nextFrameAllocatorId.fetch_add(1, std::memory_order_relaxed))
+{
+    if (framesInFlight == 0 || setsPerPool == 0)
+    {
+        throw std::invalid_argument("FrameDescriptorAllocator: framesInFlight and setsPerPool must be non-zero");
+    }
+}
+
+FrameDescriptorAllocator::~FrameDescriptorAllocator()
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    for (auto &[threadId, threadPools] : m_threads)
+    {
+        for (auto &frame : threadPools->frames)
+        {
+            for (auto pool : frame.pools)
+            {
+                m_device.get().destroyDescriptorPool(pool);
+            }
+        }
+    }
+    m_threads.clear();
+
+    // 本线程的缓存可能仍指向已销毁的池（其他线程的缓存以 ID 区分，不会误命中）
+    if (t_frameAllocatorCache.owner == m_id)
+    {
+        t_frameAllocatorCache = {};
+    }
+}
+
+void FrameDescriptorAllocator::resetPools(uint32_t frameIndex)
+{
+    if (frameIndex >= m_framesInFlight)
+    {
+        throw std::invalid_argument("FrameDescriptorAllocator::resetPools: frameIndex out of range");
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    // 只重置本帧用到的池，未用过的池已是空的
+    for (auto &[threadId, threadPools] : m_threads)
+    {
+        FramePools &frame = threadPools->frames[frameIndex];
+        const size_t usedCount = std::min(frame.current + 1, frame.pools.size());
+        for (size_t i = 0; i < usedCount; ++i)
+        {
+            m_device.get().resetDescriptorPool(frame.pools[i]);
+        }
+        frame.current = 0;
+        frame.setsInCurrent = 0;
+    }
+
+    m_frameIndex.store(frameIndex, std::memory_order_release);
+}
+
+vk::DescriptorSet FrameDescriptorAllocator::allocate(vk::DescriptorSetLayout layout)
+{
+    FramePools &frame = threadpools().frames[m_frameIndex.load(std::memory_order_acquire)];
+
+    while (true)
+    {
+        if (frame.current == frame.pools.size())
+        {
+            frame.pools.push_back(createpool());
+        }
+
+        vk::DescriptorSetAllocateInfo allocInfo(frame.pools[frame.current], 1, &layout);
+        vk::DescriptorSet set;
+
+        // 池满是常规情况，使用返回 vk::Result 的重载避免每次切换池都抛出异常
+        vk::Result result = m_device.get().allocateDescriptorSets(&allocInfo, &set);
+        if (result == vk::Result::eSuccess)
+        {
+            ++frame.setsInCurrent;
+            return set;
+        }
+        if (result != vk::Result::eErrorOutOfPoolMemory && result != vk::Result::eErrorFragmentedPool)
+        {
+            throw std::runtime_error("FrameDescriptorAllocator: failed to allocate descriptor set (" +
+                                     vk::to_string(result) + ")");
+        }
+        if (frame.setsInCurrent == 0)
+        {
+            throw std::runtime_error("FrameDescriptorAllocator: descriptor set layout exceeds pool capacity");
+        }
+
+        // 当前池已满，切换到下一个（reset 后保留的池或新建的池）
+        ++frame.current;
+        frame.setsInCurrent = 0;
+    }
+}
+
+FrameDescriptorAllocator::Stats FrameDescriptorAllocator::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    Stats stats;
+    stats.threadCount = static_cast<uint32_t>(m_threads.size());
+    for (const auto &[threadId, threadPools] : m_threads)
+    {
+        for (const auto &frame : threadPools->frames)
+        {
+            stats.poolCount += static_cast<uint32_t>(frame.pools.size());
+        }
+    }
+    return stats;
+}
+
+FrameDescriptorAllocator::ThreadPools &FrameDescriptorAllocator::threadpools()
+{
+    // 快速路径：同一线程连续使用同一个分配器时不加锁
+    if (t_frameAllocatorCache.owner == m_id)
+    {
+        return *static_cast<ThreadPools *>(t_frameAllocatorCache.pools);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    auto &threadPools = m_threads[std::this_thread::get_id()];
+    if (!threadPools)
+    {
+        threadPools = std::make_unique<ThreadPools>();
+        threadPools->frames.resize(m_framesInFlight);
+    }
+
+    t_frameAllocatorCache.owner = m_id;
+    t_frameAllocatorCache.pools = threadPools.get();
+    return *threadPools;
+}
+
+vk::DescriptorPool FrameDescriptorAllocator::createpool() const
+{
+    std::array<vk::DescriptorPoolSize, kFramePoolRatios.size()> poolSizes = kFramePoolRatios;
+    for (auto &poolSize : poolSizes)
+    {
+        poolSize.descriptorCount *= m_setsPerPool;
+    }
+
+    // 不设置 eFreeDescriptorSet：描述符集只随整个池重置，驱动可按线性方式分配
+    vk::DescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.maxSets = m_setsPerPool;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+
+    return m_device.get().createDescriptorPool(poolInfo);
+}
+
 // ========================================
 // DescriptorLayoutBuilder 类的实现
 // ========================================
@@ -0,0 +1,212 @@
+#include "FrameTimeline.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @file FrameTimeline.cpp
+ * @brief FrameTimeline 类的实现文件
+ */
+
+namespace vkcore
+{
+
+FrameTimeline::FrameTimeline(vk::Device device, uint32_t framesInFlight, uint32_t timelineCount)
+    : m_device(device), m_framesInFlight(framesInFlight)
+{
+    if (framesInFlight == 0 || timelineCount == 0)
+    {
+        throw std::invalid_argument("FrameTimeline: framesInFlight and timelineCount must be > 0");
+    }
+
+    vk::SemaphoreTypeCreateInfo timelineInfo{};
+    timelineInfo.semaphoreType = vk::SemaphoreType::eTimeline;
+    timelineInfo.initialValue = 0;
+
+    vk::SemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.pNext = &timelineInfo;
+
+    try
+    {
+        for (uint32_t i = 0; i < timelineCount; ++i)
+        {
+            m_semaphores.push_back(m_device.createSemaphore(semaphoreInfo));
+        }
+    }
+    catch (const vk::SystemError &e)
+    {
+        for (auto semaphore : m_semaphores)
+        {
+            m_device.destroySemaphore(semaphore);
+        }
+        throw std::runtime_error("FrameTimeline: Failed to create timeline semaphores: " + std::string(e.what()));
+    }
+}
+
+FrameTimeline::~FrameTimeline()
+{
+    // 当前帧可能尚未提交，等待它的时间线值会永远阻塞，因此只等待设备上已提交的工作
+    try
+    {
+        m_device.waitIdle();
+    }
+    catch (...)
+    {
+        // 析构函数中不抛出异常
+    }
+
+    for (auto semaphore : m_semaphores)
+    {
+        m_device.destroySemaphore(semaphore);
+    }
+}
+
+// ==================== 帧推进 ====================
+
+uint64_t FrameTimeline::beginFrame()
+{
+    QTR_PROFILE_SCOPE("FrameTimeline::beginFrame");
+    ++m_frameNumber;
+
+    // 第 N 帧复用第 N - framesInFlight 帧的每帧资源
+    if (m_frameNumber > m_framesInFlight)
+    {
+        if (!wait(m_frameNumber - m_framesInFlight))
+        {
+            throw std::runtime_error("FrameTimeline::beginFrame: Failed to wait for frame timeline");
+        }
+    }
+    else
+    {
+        poll();
+    }
+
+    return m_frameNumber;
+}
+
+void FrameTimeline::cancelFrame()
+{
+    if (m_frameNumber == 0)
+    {
+        return;
+    }
+
+    // 主机触发的值必须大于信号量当前值且小于所有未完成的 GPU 触发值
+    if (m_frameNumber > 1 && !wait(m_frameNumber - 1))
+    {
+        throw std::runtime_error("FrameTimeline::cancelFrame: Failed to wait for previous frame");
+    }
+
+    for (auto semaphore : m_semaphores)
+    {
+        if (m_device.getSemaphoreCounterValue(semaphore) < m_frameNumber)
+        {
+            vk::SemaphoreSignalInfo signalInfo{};
+            signalInfo.semaphore = semaphore;
+            signalInfo.value = m_frameNumber;
+            m_device.signalSemaphore(signalInfo);
+        }
+    }
+
+    retire(m_frameNumber);
+}
+
+uint64_t FrameTimeline::poll()
+{
+    uint64_t completed = UINT64_MAX;
+    for (auto semaphore : m_semaphores)
+    {
+        completed = std::min(completed, m_device.getSemaphoreCounterValue(semaphore));
+    }
+
+    retire(completed);
+    return m_retiredFrame;
+}
+
+bool FrameTimeline::wait(uint64_t frame, uint64_t timeout)
+{
+    QTR_PROFILE_SCOPE("FrameTimeline::wait");
+    if (frame <= m_retiredFrame)
+    {
+        return true;
+    }
+
+    std::vector<uint64_t> values(m_semaphores.size(), frame);
+
+    vk::SemaphoreWaitInfo waitInfo{};
+    waitInfo.semaphoreCount = static_cast<uint32_t>(m_semaphores.size());
+    waitInfo.pSemaphores = m_semaphores.data();
+    waitInfo.pValues = values.data();
+
+    if (m_device.waitSemaphores(waitInfo, timeout) != vk::Result::eSuccess)
+    {
+        return false;
+    }
+
+    // 等待期间可能有更新的帧也已完成
+    poll();
+    return true;
+}
+
+void FrameTimeline::waitIdle()
+{
+    if (!wait(m_frameNumber))
+    {
+        throw std::runtime_error("FrameTimeline::waitIdle: Failed to wait for frame timeline");
+    }
+}
+
+// ==================== 配置与查询 ====================
+
+void FrameTimeline::setFramesInFlight(uint32_t framesInFlight)
+{
+    if (framesInFlight == 0)
+    {
+        throw std::invalid_argument("FrameTimeline::setFramesInFlight: framesInFlight must be > 0");
+    }
+    m_framesInFlight = framesInFlight;
+}
+
+vk::SemaphoreSubmitInfo FrameTimeline::getSignalInfo(uint32_t timeline, vk::PipelineStageFlags2 stages) const
+{
+    vk::SemaphoreSubmitInfo signalInfo{};
+    signalInfo.semaphore = m_semaphores[timeline];
+    signalInfo.value = m_frameNumber;
+    signalInfo.stageMask = stages;
+    return signalInfo;
+}
+
+// ==================== 退休回调 ====================
+
+uint32_t FrameTimeline::addRetireCallback(RetireCallback callback)
+{
+    uint32_t id = m_nextCallbackId++;
+    m_callbacks.push_back({id, std::move(callback)});
+    return id;
+}
+
+void FrameTimeline::removeRetireCallback(uint32_t id)
+{
+    m_callbacks.erase(std::remove_if(m_callbacks.begin(), m_callbacks.end(),
+                                     [id](const CallbackEntry &entry) { return entry.id == id; }),
+                      m_callbacks.end());
+}
+
+void FrameTimeline::retire(uint64_t completed)
+{
+    if (completed <= m_retiredFrame)
+    {
+        return;
+    }
+
+    m_retiredFrame = completed;
+
+    // 回调中可能注册或注销回调，遍历副本
+    const std::vector<CallbackEntry> callbacks = m_callbacks;
+    for (const auto &entry : callbacks)
+    {
+        entry.callback(completed);
+    }
+}
+
+} // namespace vkcore
@@ -0,0 +1,58 @@
+/**
+ * @file Log.cpp
+ * @brief Log 实现
+ */
+
+#include "Log.hpp"
+#include <atomic>
+#include <iostream>
+#include <mutex>
+
+namespace vkcore
+{
+
+namespace
+{
+
+std::atomic<uint8_t> g_minLevel{0};
+std::mutex g_sinkMutex;
+Log::Sink g_sink;
+
+constexpr const char *kLevelNames[] = {"T", "D", "I", "W", "E", "-"};
+
+} // namespace
+
+void Log::setMinLevel(LogLevel level)
+{
+    g_minLevel.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+bool Log::isEnabled(LogLevel level)
+{
+    return static_cast<uint8_t>(level) >= g_minLevel.load(std::memory_order_relaxed) && level != LogLevel::Off;
+}
+
+void Log::setSink(Sink sink)
+{
+    std::lock_guard<std::mutex> lock(g_sinkMutex);
+    g_sink = std::move(sink);
+}
+
+void Log::write(LogLevel level, const char *tag, const std::string &message)
+{
+    std::lock_guard<std::mutex> lock(g_sinkMutex);
+    if (g_sink)
+    {
+        g_sink(level, tag, message);
+        return;
+    }
+
+    std::ostream &stream = level >= LogLevel::Warn ? std::cerr : std::cout;
+    stream << '[' << kLevelNames[static_cast<size_t>(level)] << "][" << tag << "] " << message << '\n';
+    if (level >= LogLevel::Warn)
+    {
+        stream.flush();
+    }
+}
+
+} // namespace vkcore
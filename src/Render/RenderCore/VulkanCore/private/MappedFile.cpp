@@ -0,0 +1,154 @@
+#include "MappedFile.hpp"
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file MappedFile.cpp
+ * @brief MappedFile 类的实现文件
+ */
+
+namespace vkcore
+{
+
+namespace
+{
+
+constexpr size_t kPrefaultStride = 4096; ///< 预读步长（一页）
+
+} // namespace
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::filesystem::path &filePath)
+{
+    HANDLE file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Failed to open file: " + filePath.string());
+    }
+    m_fileHandle = file;
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        throw std::runtime_error("Failed to query file size: " + filePath.string());
+    }
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+
+    // 空文件无法创建映射
+    if (m_size == 0)
+    {
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        throw std::runtime_error("Failed to create file mapping: " + filePath.string());
+    }
+    m_mappingHandle = mapping;
+
+    m_data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Failed to map file: " + filePath.string());
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mappingHandle)
+    {
+        CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+    }
+    if (m_fileHandle)
+    {
+        CloseHandle(static_cast<HANDLE>(m_fileHandle));
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path &filePath)
+{
+    m_fd = open(filePath.c_str(), O_RDONLY);
+    if (m_fd < 0)
+    {
+        throw std::runtime_error("Failed to open file: " + filePath.string());
+    }
+
+    struct stat fileStat{};
+    if (fstat(m_fd, &fileStat) != 0)
+    {
+        close(m_fd);
+        throw std::runtime_error("Failed to query file size: " + filePath.string());
+    }
+    m_size = static_cast<size_t>(fileStat.st_size);
+
+    // 空文件无法创建映射
+    if (m_size == 0)
+    {
+        return;
+    }
+
+    void *mapped = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (mapped == MAP_FAILED)
+    {
+        close(m_fd);
+        throw std::runtime_error("Failed to map file: " + filePath.string());
+    }
+
+    // 解析器顺序扫描，提示内核积极预读
+    madvise(mapped, m_size, MADV_SEQUENTIAL);
+    m_data = static_cast<const char *>(mapped);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+    {
+        munmap(const_cast<char *>(m_data), m_size);
+    }
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+    }
+}
+
+#endif
+
+void MappedFile::prefault() const
+{
+    // volatile 读取防止编译器把循环优化掉
+    volatile char sink = 0;
+    for (size_t offset = 0; offset < m_size; offset += kPrefaultStride)
+    {
+        sink = m_data[offset];
+    }
+    (void)sink;
+}
+
+} // namespace vkcore
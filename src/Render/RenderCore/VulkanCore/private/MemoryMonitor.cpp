@@ -0,0 +1,271 @@
+#include "MemoryMonitor.hpp"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * @file MemoryMonitor.cpp
+ * @brief MemoryMonitor 类的实现文件
+ */
+
+namespace vkcore
+{
+
+namespace
+{
+
+void writeTextFile(const std::string &path, const std::string &contents)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error("MemoryMonitor: Failed to open report file: " + path);
+    }
+    file << contents;
+    if (!file)
+    {
+        throw std::runtime_error("MemoryMonitor: Failed to write report file: " + path);
+    }
+}
+
+} // namespace
+
+const char *toString(MemoryCategory category)
+{
+    switch (category)
+    {
+    case MemoryCategory::Other:
+        return "Other";
+    case MemoryCategory::Mesh:
+        return "Mesh";
+    case MemoryCategory::Texture:
+        return "Texture";
+    case MemoryCategory::RenderTarget:
+        return "RenderTarget";
+    case MemoryCategory::RDGTransient:
+        return "RDGTransient";
+    case MemoryCategory::Staging:
+        return "Staging";
+    case MemoryCategory::Uniform:
+        return "Uniform";
+    default:
+        return "Unknown";
+    }
+}
+
+// ==================== 构造函数 ====================
+
+MemoryMonitor::MemoryMonitor(VmaAllocator allocator, float pressureThreshold) : m_allocator(allocator)
+{
+    if (!allocator)
+    {
+        throw std::invalid_argument("MemoryMonitor: allocator must not be null");
+    }
+    setPressureThreshold(pressureThreshold);
+
+    const VkPhysicalDeviceMemoryProperties *memoryProperties = nullptr;
+    vmaGetMemoryProperties(m_allocator, &memoryProperties);
+
+    m_heapBudgets.resize(memoryProperties->memoryHeapCount);
+    for (uint32_t heapIndex = 0; heapIndex < memoryProperties->memoryHeapCount; ++heapIndex)
+    {
+        const VkMemoryHeap &heap = memoryProperties->memoryHeaps[heapIndex];
+        m_heapBudgets[heapIndex].heapIndex = heapIndex;
+        m_heapBudgets[heapIndex].deviceLocal = (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        m_heapBudgets[heapIndex].heapSize = heap.size;
+    }
+}
+
+// ==================== 每帧更新 ====================
+
+void MemoryMonitor::update(uint64_t frameIndex)
+{
+    m_frameIndex = frameIndex;
+    vmaSetCurrentFrameIndex(m_allocator, static_cast<uint32_t>(frameIndex));
+
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+    vmaGetHeapBudgets(m_allocator, budgets.data());
+
+    for (MemoryHeapBudget &heapBudget : m_heapBudgets)
+    {
+        const VmaBudget &budget = budgets[heapBudget.heapIndex];
+        heapBudget.budget = budget.budget;
+        heapBudget.usage = budget.usage;
+        heapBudget.blockBytes = budget.statistics.blockBytes;
+        heapBudget.allocationBytes = budget.statistics.allocationBytes;
+        heapBudget.blockCount = budget.statistics.blockCount;
+        heapBudget.allocationCount = budget.statistics.allocationCount;
+    }
+
+    if (m_callbacks.empty())
+    {
+        return;
+    }
+
+    // 系统内存堆的压力由操作系统换页处理，只对设备本地堆派发回调
+    for (const MemoryHeapBudget &heapBudget : m_heapBudgets)
+    {
+        const auto threshold =
+            static_cast<vk::DeviceSize>(static_cast<double>(heapBudget.budget) * m_pressureThreshold);
+        if (!heapBudget.deviceLocal || heapBudget.budget == 0 || heapBudget.usage <= threshold)
+        {
+            continue;
+        }
+
+        MemoryPressure pressure{};
+        pressure.frameIndex = frameIndex;
+        pressure.heapIndex = heapBudget.heapIndex;
+        pressure.budget = heapBudget.budget;
+        pressure.usage = heapBudget.usage;
+        pressure.bytesToFree = heapBudget.usage - threshold;
+        pressure.overBudget = heapBudget.usage > heapBudget.budget;
+
+        // 回调可能注销自身，遍历副本
+        const std::vector<CallbackEntry> callbacks = m_callbacks;
+        for (const auto &entry : callbacks)
+        {
+            entry.callback(pressure);
+        }
+    }
+}
+
+void MemoryMonitor::getDeviceLocalTotals(vk::DeviceSize &budget, vk::DeviceSize &usage) const
+{
+    budget = 0;
+    usage = 0;
+    for (const MemoryHeapBudget &heapBudget : m_heapBudgets)
+    {
+        if (heapBudget.deviceLocal)
+        {
+            budget += heapBudget.budget;
+            usage += heapBudget.usage;
+        }
+    }
+}
+
+// ==================== 配置 ====================
+
+void MemoryMonitor::setPressureThreshold(float pressureThreshold)
+{
+    if (!(pressureThreshold > 0.0f && pressureThreshold <= 1.0f))
+    {
+        throw std::invalid_argument("MemoryMonitor: pressureThreshold must be in (0, 1]");
+    }
+    m_pressureThreshold = pressureThreshold;
+}
+
+// ==================== 压力回调 ====================
+
+uint32_t MemoryMonitor::addPressureCallback(PressureCallback callback)
+{
+    uint32_t id = m_nextCallbackId++;
+    m_callbacks.push_back({id, std::move(callback)});
+    return id;
+}
+
+void MemoryMonitor::removePressureCallback(uint32_t id)
+{
+    m_callbacks.erase(std::remove_if(m_callbacks.begin(), m_callbacks.end(),
+                                     [id](const CallbackEntry &entry) { return entry.id == id; }),
+                      m_callbacks.end());
+}
+
+// ==================== 分类统计 ====================
+
+MemoryMonitor::CategoryCounter &MemoryMonitor::counter(MemoryCategory category)
+{
+    static std::array<CategoryCounter, static_cast<size_t>(MemoryCategory::Count)> counters;
+    const auto index = static_cast<size_t>(category);
+    return counters[index < counters.size() ? index : static_cast<size_t>(MemoryCategory::Other)];
+}
+
+void MemoryMonitor::trackAllocation(MemoryCategory category, vk::DeviceSize bytes)
+{
+    CategoryCounter &categoryCounter = counter(category);
+    categoryCounter.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    categoryCounter.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryMonitor::trackFree(MemoryCategory category, vk::DeviceSize bytes)
+{
+    CategoryCounter &categoryCounter = counter(category);
+    categoryCounter.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    categoryCounter.count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+vk::DeviceSize MemoryMonitor::getCategoryBytes(MemoryCategory category)
+{
+    return counter(category).bytes.load(std::memory_order_relaxed);
+}
+
+uint32_t MemoryMonitor::getCategoryCount(MemoryCategory category)
+{
+    return counter(category).count.load(std::memory_order_relaxed);
+}
+
+// ==================== 报告 ====================
+
+std::string MemoryMonitor::buildJsonReport(bool detailed) const
+{
+    std::ostringstream json;
+    json << "{\n  \"frame\": " << m_frameIndex << ",\n  \"categories\": {";
+    for (size_t index = 0; index < static_cast<size_t>(MemoryCategory::Count); ++index)
+    {
+        const auto category = static_cast<MemoryCategory>(index);
+        json << (index == 0 ? "\n" : ",\n") << "    \"" << toString(category) << "\": {\"bytes\": "
+             << getCategoryBytes(category) << ", \"count\": " << getCategoryCount(category) << "}";
+    }
+
+    json << "\n  },\n  \"heaps\": [";
+    for (size_t index = 0; index < m_heapBudgets.size(); ++index)
+    {
+        const MemoryHeapBudget &heapBudget = m_heapBudgets[index];
+        json << (index == 0 ? "\n" : ",\n") << "    {\"index\": " << heapBudget.heapIndex
+             << ", \"deviceLocal\": " << (heapBudget.deviceLocal ? "true" : "false")
+             << ", \"size\": " << heapBudget.heapSize << ", \"budget\": " << heapBudget.budget
+             << ", \"usage\": " << heapBudget.usage << ", \"blockBytes\": " << heapBudget.blockBytes
+             << ", \"allocationBytes\": " << heapBudget.allocationBytes << ", \"blockCount\": " << heapBudget.blockCount
+             << ", \"allocationCount\": " << heapBudget.allocationCount << "}";
+    }
+
+    // vmaBuildStatsString 本身就是一个 JSON 对象，直接嵌入
+    char *statsString = nullptr;
+    vmaBuildStatsString(m_allocator, &statsString, detailed ? VK_TRUE : VK_FALSE);
+    json << "\n  ],\n  \"vma\": " << (statsString ? statsString : "null") << "\n}\n";
+    vmaFreeStatsString(m_allocator, statsString);
+
+    return json.str();
+}
+
+std::string MemoryMonitor::buildCsvReport() const
+{
+    std::ostringstream csv;
+    csv << "frame,kind,name,bytes,count,budget,usage\n";
+    for (size_t index = 0; index < static_cast<size_t>(MemoryCategory::Count); ++index)
+    {
+        const auto category = static_cast<MemoryCategory>(index);
+        csv << m_frameIndex << ",category," << toString(category) << "," << getCategoryBytes(category) << ","
+            << getCategoryCount(category) << ",,\n";
+    }
+    for (const MemoryHeapBudget &heapBudget : m_heapBudgets)
+    {
+        csv << m_frameIndex << ",heap," << (heapBudget.deviceLocal ? "DeviceLocal" : "Host") << heapBudget.heapIndex
+            << "," << heapBudget.allocationBytes << "," << heapBudget.allocationCount << "," << heapBudget.budget << ","
+            << heapBudget.usage << "\n";
+    }
+    return csv.str();
+}
+
+void MemoryMonitor::writeJsonReport(const std::string &path, bool detailed) const
+{
+    writeTextFile(path, buildJsonReport(detailed));
+}
+
+void MemoryMonitor::writeCsvReport(const std::string &path) const
+{
+    writeTextFile(path, buildCsvReport());
+}
+
+} // namespace vkcore
@@ -0,0 +1,398 @@
+/**
+ * @file OffscreenSwapChain.cpp
+ * @brief OffscreenSwapChain 实现
+ */
+
+#include "OffscreenSwapChain.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace vkcore
+{
+
+namespace
+{
+
+// 回读支持的颜色格式的每像素字节数（0 表示不支持）
+size_t formatbytes(vk::Format format)
+{
+    switch (format)
+    {
+    case vk::Format::eR8G8B8A8Unorm:
+    case vk::Format::eR8G8B8A8Srgb:
+    case vk::Format::eB8G8R8A8Unorm:
+    case vk::Format::eB8G8R8A8Srgb:
+    case vk::Format::eA2B10G10R10UnormPack32:
+    case vk::Format::eB10G11R11UfloatPack32:
+    case vk::Format::eR32Sfloat:
+        return 4;
+    case vk::Format::eR16G16B16A16Sfloat:
+    case vk::Format::eR32G32Sfloat:
+        return 8;
+    case vk::Format::eR32G32B32A32Sfloat:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+} // namespace
+
+OffscreenSwapChain::OffscreenSwapChain(Device &device, VmaAllocator allocator, const Config &config)
+    : m_device(device), m_allocator(allocator), m_config(config), m_pixelBytes(formatbytes(config.format))
+{
+    if (config.extent.width == 0 || config.extent.height == 0)
+    {
+        throw std::invalid_argument("OffscreenSwapChain: extent must not be zero");
+    }
+    if (config.imageCount == 0 || config.framesInFlight == 0)
+    {
+        throw std::invalid_argument("OffscreenSwapChain: imageCount and framesInFlight must be greater than 0");
+    }
+    if (m_pixelBytes == 0)
+    {
+        throw std::invalid_argument("OffscreenSwapChain: unsupported format " + vk::to_string(config.format));
+    }
+
+    vk::Device vkDevice = device.get();
+    m_timeline = std::make_unique<FrameTimeline>(vkDevice, config.framesInFlight);
+    m_timeline->beginFrame();
+
+    m_imageAvailableSemaphores.resize(config.framesInFlight);
+    for (auto &semaphore : m_imageAvailableSemaphores)
+    {
+        semaphore = vkDevice.createSemaphore({});
+    }
+
+    vk::SemaphoreTypeCreateInfo timelineInfo{};
+    timelineInfo.semaphoreType = vk::SemaphoreType::eTimeline;
+    timelineInfo.initialValue = 0;
+    vk::SemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.pNext = &timelineInfo;
+    m_readbackTimeline = vkDevice.createSemaphore(semaphoreInfo);
+
+    if (config.readback)
+    {
+        // 拷贝命令预先录制、反复提交，不需要逐个重置
+        vk::CommandPoolCreateInfo poolInfo{};
+        poolInfo.queueFamilyIndex = device.getTransferQueueFamilyIndices();
+        m_copyPool = vkDevice.createCommandPool(poolInfo);
+    }
+
+    createimages();
+}
+
+OffscreenSwapChain::~OffscreenSwapChain()
+{
+    // 拷贝命令与信号量可能仍被已提交的工作引用
+    m_device.get().waitIdle();
+    cleanup();
+}
+
+void OffscreenSwapChain::createimages()
+{
+    vk::Device vkDevice = m_device.get();
+
+    // 图形队列渲染、传输队列回读：两个族不同时并发共享，免去每帧的所有权转移
+    ImageDesc imageDesc{};
+    imageDesc.format = m_config.format;
+    imageDesc.extent = vk::Extent3D(m_config.extent.width, m_config.extent.height, 1);
+    imageDesc.usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc |
+                      vk::ImageUsageFlagBits::eSampled | m_config.extraUsage;
+    imageDesc.memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    imageDesc.category = MemoryCategory::RenderTarget;
+    const uint32_t graphicsFamily = m_device.getGraphicsQueueFamilyIndices();
+    const uint32_t transferFamily = m_device.getTransferQueueFamilyIndices();
+    if (m_config.readback && graphicsFamily != transferFamily)
+    {
+        imageDesc.queueFamilies = {graphicsFamily, transferFamily};
+    }
+
+    // 回读缓冲：随机访问标志使 VMA 选择 HOST_CACHED 内存，主机读取不经过写合并
+    BufferDesc bufferDesc{};
+    bufferDesc.size = static_cast<vk::DeviceSize>(m_config.extent.width) * m_config.extent.height * m_pixelBytes;
+    bufferDesc.usageFlags = vk::BufferUsageFlagBits::eTransferDst;
+    bufferDesc.allocationCreateFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+    bufferDesc.category = MemoryCategory::Staging;
+    bufferDesc.mapping = BufferMapping::Persistent;
+
+    std::vector<vk::CommandBuffer> commands;
+    if (m_config.readback)
+    {
+        vk::CommandBufferAllocateInfo allocInfo{};
+        allocInfo.commandPool = m_copyPool;
+        allocInfo.level = vk::CommandBufferLevel::ePrimary;
+        allocInfo.commandBufferCount = m_config.imageCount;
+        commands = vkDevice.allocateCommandBuffers(allocInfo);
+    }
+
+    m_images.resize(m_config.imageCount);
+    for (uint32_t i = 0; i < m_config.imageCount; ++i)
+    {
+        RingImage &ring = m_images[i];
+        const std::string suffix = "[" + std::to_string(i) + "]";
+        ring.image = std::make_unique<Image>("OffscreenImage" + suffix, m_device, m_allocator, imageDesc);
+        ring.renderFinished = vkDevice.createSemaphore({});
+        ring.releaseValue = 0;
+        if (m_config.readback)
+        {
+            ring.readback = std::make_unique<Buffer>("OffscreenReadback" + suffix, m_device, m_allocator, bufferDesc);
+            ring.copyCommands = commands[i];
+            recordcopy(ring);
+        }
+    }
+    m_nextImage = 0;
+}
+
+void OffscreenSwapChain::recordcopy(RingImage &ring)
+{
+    vk::CommandBuffer cmd = ring.copyCommands;
+    cmd.begin(vk::CommandBufferBeginInfo{});
+
+    vk::BufferImageCopy region{};
+    region.imageSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1);
+    region.imageExtent = vk::Extent3D(m_config.extent.width, m_config.extent.height, 1);
+    cmd.copyImageToBuffer(ring.image->get(), kPresentLayout, ring.readback->get(), region);
+
+    // 拷贝写入对主机读取可见（主机在回读时间线上等待之后读取）
+    vk::MemoryBarrier2 toHost{};
+    toHost.srcStageMask = vk::PipelineStageFlagBits2::eCopy;
+    toHost.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+    toHost.dstStageMask = vk::PipelineStageFlagBits2::eHost;
+    toHost.dstAccessMask = vk::AccessFlagBits2::eHostRead;
+    vk::DependencyInfo dependency{};
+    dependency.memoryBarrierCount = 1;
+    dependency.pMemoryBarriers = &toHost;
+    cmd.pipelineBarrier2(dependency);
+
+    cmd.end();
+}
+
+void OffscreenSwapChain::submit(vk::Queue queue, const vk::SemaphoreSubmitInfo *wait, vk::CommandBuffer commands,
+                                const vk::SemaphoreSubmitInfo &signal)
+{
+    vk::CommandBufferSubmitInfo commandInfo{};
+    commandInfo.commandBuffer = commands;
+
+    vk::SubmitInfo2 submitInfo{};
+    submitInfo.waitSemaphoreInfoCount = wait ? 1 : 0;
+    submitInfo.pWaitSemaphoreInfos = wait;
+    submitInfo.commandBufferInfoCount = commands ? 1 : 0;
+    submitInfo.pCommandBufferInfos = &commandInfo;
+    submitInfo.signalSemaphoreInfoCount = 1;
+    submitInfo.pSignalSemaphoreInfos = &signal;
+
+    try
+    {
+        std::lock_guard<std::mutex> queueLock(m_device.getQueueMutex(queue));
+        queue.submit2(submitInfo);
+    }
+    catch (const vk::SystemError &e)
+    {
+        throw std::runtime_error("OffscreenSwapChain: Failed to submit: " + std::string(e.what()));
+    }
+}
+
+vk::Result OffscreenSwapChain::acquireNextImage(uint32_t &imageIndex)
+{
+    imageIndex = m_nextImage;
+    m_nextImage = (m_nextImage + 1) % getImageCount();
+    m_acquireTime = std::chrono::steady_clock::now();
+
+    // 空批次：等这张图像上一次的回读（或消费渲染完成的空批次）结束后触发图像可用，CPU 不等待
+    const RingImage &ring = m_images[imageIndex];
+    vk::SemaphoreSubmitInfo wait{};
+    wait.semaphore = m_readbackTimeline;
+    wait.value = ring.releaseValue;
+    wait.stageMask = vk::PipelineStageFlagBits2::eAllCommands;
+
+    vk::SemaphoreSubmitInfo signal{};
+    signal.semaphore = m_imageAvailableSemaphores[m_timeline->getFrameSlot()];
+    signal.stageMask = vk::PipelineStageFlagBits2::eAllCommands;
+
+    submit(m_device.getGraphicsQueue(), ring.releaseValue != 0 ? &wait : nullptr, nullptr, signal);
+    return vk::Result::eSuccess;
+}
+
+vk::Result OffscreenSwapChain::present(vk::Semaphore renderFinishedSemaphore, uint32_t imageIndex,
+                                       std::chrono::steady_clock::time_point inputTime)
+{
+    if (imageIndex >= getImageCount())
+    {
+        throw std::invalid_argument("OffscreenSwapChain::present: imageIndex out of range");
+    }
+    if (inputTime == std::chrono::steady_clock::time_point{})
+    {
+        inputTime = m_acquireTime;
+    }
+
+    RingImage &ring = m_images[imageIndex];
+    const bool readback = m_config.readback;
+    if (readback)
+    {
+        // 背压：这张图像的缓冲上一次的内容必须先交给主机（按呈现顺序，之前的帧一并交付）
+        deliver(true, ring.releaseValue);
+    }
+
+    const uint64_t value = ++m_readbackValue;
+    vk::SemaphoreSubmitInfo wait{};
+    wait.semaphore = renderFinishedSemaphore;
+    wait.stageMask = readback ? vk::PipelineStageFlagBits2::eCopy : vk::PipelineStageFlagBits2::eAllCommands;
+
+    vk::SemaphoreSubmitInfo signal{};
+    signal.semaphore = m_readbackTimeline;
+    signal.value = value;
+    signal.stageMask = vk::PipelineStageFlagBits2::eAllCommands;
+
+    // 关闭回读时在图形队列上消费渲染完成信号量，二值信号量才能在下一次使用这张图像时再次触发
+    submit(readback ? m_device.getTransferQueue() : m_device.getGraphicsQueue(), &wait, ring.copyCommands, signal);
+    ring.releaseValue = value;
+
+    if (readback)
+    {
+        m_pending.push_back(PendingReadback{imageIndex, value, m_timeline->getFrameNumber(), inputTime});
+        deliver(false, 0);
+    }
+    return vk::Result::eSuccess;
+}
+
+uint32_t OffscreenSwapChain::pollReadbacks()
+{
+    return deliver(false, 0);
+}
+
+uint32_t OffscreenSwapChain::waitReadbacks()
+{
+    return deliver(true, m_readbackValue);
+}
+
+uint32_t OffscreenSwapChain::deliver(bool wait, uint64_t untilValue)
+{
+    vk::Device vkDevice = m_device.get();
+    uint64_t completed = vkDevice.getSemaphoreCounterValue(m_readbackTimeline);
+    uint32_t delivered = 0;
+    while (!m_pending.empty())
+    {
+        const PendingReadback pending = m_pending.front();
+        if (completed < pending.value)
+        {
+            if (!wait || pending.value > untilValue)
+            {
+                break;
+            }
+            vk::SemaphoreWaitInfo waitInfo{};
+            waitInfo.semaphoreCount = 1;
+            waitInfo.pSemaphores = &m_readbackTimeline;
+            waitInfo.pValues = &pending.value;
+            if (vkDevice.waitSemaphores(waitInfo, UINT64_MAX) != vk::Result::eSuccess)
+            {
+                throw std::runtime_error("OffscreenSwapChain: Failed to wait for readback");
+            }
+            completed = pending.value;
+        }
+
+        m_pending.pop_front();
+        Buffer &buffer = *m_images[pending.imageIndex].readback;
+        buffer.invalidate();
+        if (m_readbackCallback)
+        {
+            ReadbackFrame frame{};
+            frame.frameNumber = pending.frameNumber;
+            frame.imageIndex = pending.imageIndex;
+            frame.extent = m_config.extent;
+            frame.format = m_config.format;
+            frame.data = buffer.getMappedData();
+            frame.rowPitch = static_cast<size_t>(m_config.extent.width) * m_pixelBytes;
+            frame.size = static_cast<size_t>(buffer.getSize());
+            frame.inputTime = pending.inputTime;
+            m_readbackCallback(frame);
+        }
+        ++m_deliveredFrames;
+        ++delivered;
+    }
+    return delivered;
+}
+
+void OffscreenSwapChain::resize(vk::Extent2D extent)
+{
+    if (extent.width == 0 || extent.height == 0)
+    {
+        throw std::invalid_argument("OffscreenSwapChain::resize: extent must not be zero");
+    }
+    if (extent == m_config.extent)
+    {
+        return;
+    }
+
+    // 离屏尺寸只在批次之间改变（例如切换缩略图规格），直接排空再重建即可
+    waitReadbacks();
+    m_timeline->waitIdle();
+    if (m_readbackValue != 0)
+    {
+        vk::SemaphoreWaitInfo waitInfo{};
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_readbackTimeline;
+        waitInfo.pValues = &m_readbackValue;
+        if (m_device.get().waitSemaphores(waitInfo, UINT64_MAX) != vk::Result::eSuccess)
+        {
+            throw std::runtime_error("OffscreenSwapChain: Failed to wait for readback");
+        }
+    }
+
+    destroyimages();
+    m_config.extent = extent;
+    createimages();
+    ++m_generation;
+}
+
+void OffscreenSwapChain::destroyimages()
+{
+    vk::Device vkDevice = m_device.get();
+    std::vector<vk::CommandBuffer> commands;
+    for (RingImage &ring : m_images)
+    {
+        if (ring.copyCommands)
+        {
+            commands.push_back(ring.copyCommands);
+        }
+        if (ring.renderFinished)
+        {
+            vkDevice.destroySemaphore(ring.renderFinished);
+        }
+    }
+    if (!commands.empty())
+    {
+        vkDevice.freeCommandBuffers(m_copyPool, commands);
+    }
+    m_images.clear();
+    m_pending.clear();
+}
+
+void OffscreenSwapChain::cleanup()
+{
+    if (!m_timeline)
+    {
+        return;
+    }
+
+    vk::Device vkDevice = m_device.get();
+    destroyimages();
+    if (m_copyPool)
+    {
+        vkDevice.destroyCommandPool(m_copyPool);
+        m_copyPool = nullptr;
+    }
+    for (auto &semaphore : m_imageAvailableSemaphores)
+    {
+        vkDevice.destroySemaphore(semaphore);
+    }
+    m_imageAvailableSemaphores.clear();
+    if (m_readbackTimeline)
+    {
+        vkDevice.destroySemaphore(m_readbackTimeline);
+        m_readbackTimeline = nullptr;
+    }
+    m_timeline.reset();
+}
+
+} // namespace vkcore
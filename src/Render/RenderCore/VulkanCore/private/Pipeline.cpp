@@ -3,7 +3,7 @@
  * @author Summer
  * @brief Vulkan 管线的实现文件。
  *
- * 该文件包含 Pipeline 和 PipelineBuilder 类的实现，负责图形管线的创建和管理。
+ * 该文件包含 Pipeline、PipelineBuilder 与 ComputePipelineBuilder 类的实现，负责图形与计算管线的创建和管理。
  * 支持 Vulkan 1.3 动态渲染特性，无需预先创建 RenderPass。
  *
  * 注意：动态渲染中，LoadOp/StoreOp 在 vkCmdBeginRendering 时配置，不是在管线创建时。
@@ -12,17 +12,294 @@
  */
 
 #include "Pipeline.hpp"
+#include "Descriptor.hpp"
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
+#include <type_traits>
 
 namespace vkcore
 {
+
+namespace
+{
+
+/**
+ * @brief 把一个平凡可拷贝的值追加到状态键
+ * @note 只用于标量、枚举、Flags 与句柄；结构体逐字段追加，避免把填充字节与 pNext 写入键中
+ */
+template <typename T> void appendkey(std::vector<uint8_t> &key, const T &value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "appendkey requires a trivially copyable type");
+    const size_t offset = key.size();
+    key.resize(offset + sizeof(T));
+    std::memcpy(key.data() + offset, &value, sizeof(T));
+}
+
+void appendlayoutkey(std::vector<uint8_t> &key, std::span<const vk::DescriptorSetLayout> setLayouts,
+                     std::span<const vk::PushConstantRange> pushConstants)
+{
+    appendkey(key, static_cast<uint32_t>(setLayouts.size()));
+    for (vk::DescriptorSetLayout layout : setLayouts)
+    {
+        appendkey(key, static_cast<VkDescriptorSetLayout>(layout));
+    }
+    appendkey(key, static_cast<uint32_t>(pushConstants.size()));
+    for (const vk::PushConstantRange &range : pushConstants)
+    {
+        appendkey(key, range.stageFlags);
+        appendkey(key, range.offset);
+        appendkey(key, range.size);
+    }
+}
+
+void appendstencilkey(std::vector<uint8_t> &key, const vk::StencilOpState &state)
+{
+    appendkey(key, state.failOp);
+    appendkey(key, state.passOp);
+    appendkey(key, state.depthFailOp);
+    appendkey(key, state.compareOp);
+    appendkey(key, state.compareMask);
+    appendkey(key, state.writeMask);
+    appendkey(key, state.reference);
+}
+
+constexpr vk::GraphicsPipelineLibraryFlagsEXT kAllLibraryParts =
+    vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface |
+    vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders |
+    vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader |
+    vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface;
+
+/**
+ * @brief 着色器阶段是否属于给定的管线库部件（片段着色器属于 eFragmentShader，其余属于 ePreRasterizationShaders）
+ */
+bool isshaderinparts(vk::ShaderStageFlagBits stage, vk::GraphicsPipelineLibraryFlagsEXT parts)
+{
+    using Part = vk::GraphicsPipelineLibraryFlagBitsEXT;
+    const Part part =
+        stage == vk::ShaderStageFlagBits::eFragment ? Part::eFragmentShader : Part::ePreRasterizationShaders;
+    return static_cast<bool>(parts & part);
+}
+
+/**
+ * @struct StageSpecialization
+ * @brief 一个着色器阶段的特化信息（在管线创建期间保持存活）
+ */
+struct StageSpecialization
+{
+    std::vector<vk::SpecializationMapEntry> entries;
+    std::vector<uint32_t> data;
+    vk::SpecializationInfo info;
+
+    const vk::SpecializationInfo *get() const
+    {
+        return entries.empty() ? nullptr : &info;
+    }
+};
+
+/**
+ * @brief 收集作用于 stage 的特化常量（同一 id 出现多次时后设置的生效）
+ */
+void buildspecialization(std::span<const SpecializationConstant> constants, vk::ShaderStageFlagBits stage,
+                         StageSpecialization &specialization)
+{
+    for (const SpecializationConstant &constant : constants)
+    {
+        if (!(constant.stages & stage))
+        {
+            continue;
+        }
+        auto it = std::find_if(specialization.entries.begin(), specialization.entries.end(),
+                               [&](const vk::SpecializationMapEntry &entry) {
+                                   return entry.constantID == constant.constantId;
+                               });
+        if (it != specialization.entries.end())
+        {
+            specialization.data[it->offset / sizeof(uint32_t)] = constant.value;
+            continue;
+        }
+        const uint32_t offset = static_cast<uint32_t>(specialization.data.size() * sizeof(uint32_t));
+        specialization.entries.push_back({constant.constantId, offset, sizeof(uint32_t)});
+        specialization.data.push_back(constant.value);
+    }
+    specialization.info.mapEntryCount = static_cast<uint32_t>(specialization.entries.size());
+    specialization.info.pMapEntries = specialization.entries.data();
+    specialization.info.dataSize = specialization.data.size() * sizeof(uint32_t);
+    specialization.info.pData = specialization.data.data();
+}
+
+/**
+ * @brief 设置特化常量：同一 id 与阶段已存在时覆盖
+ */
+void setspecialization(std::vector<SpecializationConstant> &constants, const SpecializationConstant &constant)
+{
+    auto it = std::find_if(constants.begin(), constants.end(), [&](const SpecializationConstant &existing) {
+        return existing.constantId == constant.constantId && existing.stages == constant.stages;
+    });
+    if (it != constants.end())
+    {
+        it->value = constant.value;
+        return;
+    }
+    constants.push_back(constant);
+}
+
+void appendspecializationkey(std::vector<uint8_t> &key, std::span<const SpecializationConstant> constants,
+                             vk::ShaderStageFlags stages)
+{
+    uint32_t count = 0;
+    for (const SpecializationConstant &constant : constants)
+    {
+        count += (constant.stages & stages) ? 1 : 0;
+    }
+    appendkey(key, count);
+    for (const SpecializationConstant &constant : constants)
+    {
+        if (constant.stages & stages)
+        {
+            appendkey(key, constant.stages & stages);
+            appendkey(key, constant.constantId);
+            appendkey(key, constant.value);
+        }
+    }
+}
+
+/**
+ * @brief 填写一个着色器阶段：已有模块时直接使用，否则在允许时以 VK_EXT_shader_module_identifier 标识代替模块
+ * @param allowIdentifier 是否允许只提供标识（驱动报告需要编译时以 false 重试）
+ * @param specialization 特化信息（可为空）
+ * @return bool 是否使用了标识
+ */
+bool fillshaderstage(ShaderModule &shader, bool allowIdentifier, const vk::SpecializationInfo *specialization,
+                     vk::PipelineShaderStageCreateInfo &stageInfo,
+                     vk::PipelineShaderStageModuleIdentifierCreateInfoEXT &identifierInfo)
+{
+    stageInfo = vk::PipelineShaderStageCreateInfo{};
+    stageInfo.stage = shader.stage;
+    stageInfo.pName = "main"; // 入口函数名
+    stageInfo.pSpecializationInfo = specialization;
+
+    vk::ShaderModule module = shader.getModule();
+    if (!module && allowIdentifier && !shader.identifier.empty())
+    {
+        identifierInfo.identifierSize = static_cast<uint32_t>(shader.identifier.size());
+        identifierInfo.pIdentifier = shader.identifier.data();
+        stageInfo.pNext = &identifierInfo;
+        return true;
+    }
+    stageInfo.module = module ? module : shader.ensureModule();
+    return false;
+}
+
+/**
+ * @brief 合并着色器的反射结果，生成描述符集布局（经 cache 去重）与一个推送常量范围
+ */
+void derivelayout(const std::vector<std::shared_ptr<ShaderModule>> &shaders, DescriptorLayoutCache &cache,
+                  std::vector<vk::DescriptorSetLayout> &setLayouts, std::vector<vk::PushConstantRange> &pushConstants)
+{
+    std::map<std::pair<uint32_t, uint32_t>, vk::DescriptorSetLayoutBinding> merged; // (set, binding) -> 绑定
+    uint32_t setCount = 0;
+    vk::PushConstantRange pushRange{};
+    uint32_t pushEnd = 0;
+    for (const auto &shader : shaders)
+    {
+        if (!shader->reflection)
+        {
+            throw std::invalid_argument("deriveLayout: shader module has no reflection data");
+        }
+        const ShaderReflection &reflection = *shader->reflection;
+        for (const ShaderReflection::Binding &binding : reflection.bindings)
+        {
+            if (binding.count == 0)
+            {
+                throw std::invalid_argument("deriveLayout: runtime-sized descriptor array at set " +
+                                            std::to_string(binding.set) + " requires an explicit layout");
+            }
+            auto [it, inserted] = merged.try_emplace({binding.set, binding.binding});
+            vk::DescriptorSetLayoutBinding &layoutBinding = it->second;
+            if (inserted)
+            {
+                layoutBinding.binding = binding.binding;
+                layoutBinding.descriptorType = binding.type;
+                layoutBinding.descriptorCount = binding.count;
+            }
+            else if (layoutBinding.descriptorType != binding.type || layoutBinding.descriptorCount != binding.count)
+            {
+                throw std::invalid_argument("deriveLayout: conflicting declarations of set " +
+                                            std::to_string(binding.set) + " binding " +
+                                            std::to_string(binding.binding));
+            }
+            layoutBinding.stageFlags |= shader->stage;
+            setCount = std::max(setCount, binding.set + 1);
+        }
+
+        if (reflection.pushConstantSize > 0)
+        {
+            const uint32_t begin = reflection.pushConstantOffset;
+            const uint32_t end = begin + reflection.pushConstantSize;
+            pushRange.offset = pushRange.stageFlags ? std::min(pushRange.offset, begin) : begin;
+            pushEnd = std::max(pushEnd, end);
+            pushRange.stageFlags |= shader->stage;
+        }
+    }
+
+    // std::map 按 (set, binding) 排序，逐集收集即可
+    std::vector<std::vector<vk::DescriptorSetLayoutBinding>> sets(setCount);
+    for (const auto &[location, binding] : merged)
+    {
+        sets[location.first].push_back(binding);
+    }
+    setLayouts.clear();
+    for (const auto &bindings : sets)
+    {
+        setLayouts.push_back(cache.createDescriptorLayout(bindings));
+    }
+
+    pushConstants.clear();
+    if (pushRange.stageFlags)
+    {
+        pushRange.size = pushEnd - pushRange.offset;
+        pushConstants.push_back(pushRange);
+    }
+}
+
+/**
+ * @brief 创建管线布局（cache 非空时从缓存获取，布局归缓存所有）
+ */
+vk::PipelineLayout createlayout(vkcore::Device &device, PipelineLayoutCache *cache,
+                                const std::vector<vk::DescriptorSetLayout> &setLayouts,
+                                const std::vector<vk::PushConstantRange> &pushConstants)
+{
+    if (cache)
+    {
+        return cache->getOrCreate(setLayouts, pushConstants);
+    }
+
+    vk::PipelineLayoutCreateInfo layoutInfo = {};
+    layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    layoutInfo.pSetLayouts = setLayouts.data();
+    layoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstants.size());
+    layoutInfo.pPushConstantRanges = pushConstants.data();
+
+    try
+    {
+        return device.get().createPipelineLayout(layoutInfo);
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error(std::string("Failed to create pipeline layout: ") + e.what());
+    }
+}
+
+} // namespace
 // ========================================
 // Pipeline 类的实现
 // ========================================
 
 Pipeline::Pipeline(vkcore::Device &device, vk::Pipeline pipeline, vk::PipelineLayout layout,
-                   vk::PipelineBindPoint bindPoint)
-    : m_device(device), m_pipeline(pipeline), m_pipelineLayout(layout), m_bindPoint(bindPoint)
+                   vk::PipelineBindPoint bindPoint, bool ownsLayout)
+    : m_device(device), m_pipeline(pipeline), m_pipelineLayout(layout), m_bindPoint(bindPoint),
+      m_ownsLayout(ownsLayout)
 {
 }
 
@@ -34,7 +311,7 @@ Pipeline::~Pipeline()
         m_pipeline = nullptr;
     }
 
-    if (m_pipelineLayout)
+    if (m_pipelineLayout && m_ownsLayout)
     {
         m_device.get().destroyPipelineLayout(m_pipelineLayout);
         m_pipelineLayout = nullptr;
@@ -46,6 +323,67 @@ void Pipeline::bind(vk::CommandBuffer cmd)
     cmd.bindPipeline(m_bindPoint, m_pipeline);
 }
 
+// ========================================
+// PipelineLayoutCache 类的实现
+// ========================================
+
+PipelineLayoutCache::PipelineLayoutCache(vkcore::Device &device) : m_device(device)
+{
+}
+
+PipelineLayoutCache::~PipelineLayoutCache()
+{
+    cleanup();
+}
+
+vk::PipelineLayout PipelineLayoutCache::getOrCreate(std::span<const vk::DescriptorSetLayout> setLayouts,
+                                                    std::span<const vk::PushConstantRange> pushConstants)
+{
+    std::vector<uint8_t> key;
+    appendlayoutkey(key, setLayouts, pushConstants);
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    auto it = m_layouts.find(key);
+    if (it != m_layouts.end())
+    {
+        return it->second;
+    }
+
+    vk::PipelineLayoutCreateInfo layoutInfo = {};
+    layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    layoutInfo.pSetLayouts = setLayouts.data();
+    layoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstants.size());
+    layoutInfo.pPushConstantRanges = pushConstants.data();
+
+    vk::PipelineLayout layout;
+    try
+    {
+        layout = m_device.get().createPipelineLayout(layoutInfo);
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error(std::string("Failed to create pipeline layout: ") + e.what());
+    }
+    m_layouts.emplace(std::move(key), layout);
+    return layout;
+}
+
+size_t PipelineLayoutCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_layouts.size();
+}
+
+void PipelineLayoutCache::cleanup()
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    for (const auto &[key, layout] : m_layouts)
+    {
+        m_device.get().destroyPipelineLayout(layout);
+    }
+    m_layouts.clear();
+}
+
 // ========================================
 // PipelineBuilder 类的实现
 // ========================================
@@ -108,9 +446,35 @@ PipelineBuilder &PipelineBuilder::addPushConstant(const vk::PushConstantRange &r
     return *this;
 }
 
+PipelineBuilder &PipelineBuilder::deriveLayout(DescriptorLayoutCache &cache)
+{
+    derivelayout(m_shaderModules, cache, m_setLayouts, m_pushConstants);
+    return *this;
+}
+
+PipelineBuilder &PipelineBuilder::setPipelineLayoutCache(PipelineLayoutCache *cache)
+{
+    m_layoutCache = cache;
+    return *this;
+}
+
+PipelineBuilder &PipelineBuilder::setSpecializationConstant(uint32_t constantId, uint32_t value,
+                                                            vk::ShaderStageFlags stages)
+{
+    setspecialization(m_specializationConstants, {stages, constantId, value});
+    return *this;
+}
+
 PipelineBuilder &PipelineBuilder::setVertexInput(const vk::PipelineVertexInputStateCreateInfo &info)
 {
+    // 复制描述数组：调用方可以传入局部数组，clone() 出的副本也不会引用调用方的内存
+    m_vertexBindings.assign(info.pVertexBindingDescriptions,
+                            info.pVertexBindingDescriptions + info.vertexBindingDescriptionCount);
+    m_vertexAttributes.assign(info.pVertexAttributeDescriptions,
+                              info.pVertexAttributeDescriptions + info.vertexAttributeDescriptionCount);
     m_vertexInputInfo = info;
+    m_vertexInputInfo.pVertexBindingDescriptions = m_vertexBindings.empty() ? nullptr : m_vertexBindings.data();
+    m_vertexInputInfo.pVertexAttributeDescriptions = m_vertexAttributes.empty() ? nullptr : m_vertexAttributes.data();
     return *this;
 }
 
@@ -128,7 +492,14 @@ PipelineBuilder &PipelineBuilder::setRasterization(const vk::PipelineRasterizati
 
 PipelineBuilder &PipelineBuilder::setMultisampling(const vk::PipelineMultisampleStateCreateInfo &info)
 {
+    m_sampleMask.clear();
+    if (info.pSampleMask)
+    {
+        const uint32_t maskWords = (static_cast<uint32_t>(info.rasterizationSamples) + 31) / 32;
+        m_sampleMask.assign(info.pSampleMask, info.pSampleMask + maskWords);
+    }
     m_multisampleInfo = info;
+    m_multisampleInfo.pSampleMask = m_sampleMask.empty() ? nullptr : m_sampleMask.data();
     return *this;
 }
 
@@ -164,56 +535,310 @@ PipelineBuilder &PipelineBuilder::addDynamicState(vk::DynamicState state)
     return *this;
 }
 
+PipelineBuilder &PipelineBuilder::setFragmentShadingRate(vk::Extent2D fragmentSize,
+                                                         vk::FragmentShadingRateCombinerOpKHR primitiveOp,
+                                                         vk::FragmentShadingRateCombinerOpKHR attachmentOp)
+{
+    m_fragmentShadingRateEnabled = true;
+    m_fragmentShadingRateInfo = vk::PipelineFragmentShadingRateStateCreateInfoKHR{};
+    m_fragmentShadingRateInfo.fragmentSize = fragmentSize;
+    m_fragmentShadingRateInfo.combinerOps[0] = primitiveOp;
+    m_fragmentShadingRateInfo.combinerOps[1] = attachmentOp;
+    return *this;
+}
+
 vk::PipelineLayout PipelineBuilder::buildlayout()
 {
-    vk::PipelineLayoutCreateInfo layoutInfo = {};
-    layoutInfo.setLayoutCount = static_cast<uint32_t>(m_setLayouts.size());
-    layoutInfo.pSetLayouts = m_setLayouts.data();
-    layoutInfo.pushConstantRangeCount = static_cast<uint32_t>(m_pushConstants.size());
-    layoutInfo.pPushConstantRanges = m_pushConstants.data();
+    return createlayout(m_device, m_layoutCache, m_setLayouts, m_pushConstants);
+}
 
-    vk::PipelineLayout layout;
-    try
+std::vector<uint8_t> PipelineBuilder::getStateKey() const
+{
+    std::vector<uint8_t> key;
+    key.reserve(512);
+    appendkey(key, vk::PipelineBindPoint::eGraphics);
+    appendstatekey(key, kAllLibraryParts);
+    return key;
+}
+
+std::vector<uint8_t> PipelineBuilder::getLibraryKey(vk::GraphicsPipelineLibraryFlagBitsEXT part) const
+{
+    std::vector<uint8_t> key;
+    key.reserve(256);
+    appendkey(key, vk::PipelineBindPoint::eGraphics);
+    appendkey(key, part);
+    appendstatekey(key, part);
+    return key;
+}
+
+void PipelineBuilder::appendstatekey(std::vector<uint8_t> &key, vk::GraphicsPipelineLibraryFlagsEXT parts) const
+{
+    using Part = vk::GraphicsPipelineLibraryFlagBitsEXT;
+    const bool vertexInput = static_cast<bool>(parts & Part::eVertexInputInterface) && !isMeshShading();
+    const bool preRasterization = static_cast<bool>(parts & Part::ePreRasterizationShaders);
+    const bool fragmentShader = static_cast<bool>(parts & Part::eFragmentShader);
+    const bool fragmentOutput = static_cast<bool>(parts & Part::eFragmentOutputInterface);
+
+    // 着色器以 ShaderModule 对象标识（模块句柄可能延迟创建）：PipelineCache 持有模块引用，地址在缓存项存活期间不会被复用
+    uint32_t shaderCount = 0;
+    vk::ShaderStageFlags shaderStages;
+    for (const auto &shader : m_shaderModules)
     {
-        layout = m_device.get().createPipelineLayout(layoutInfo);
+        if (isshaderinparts(shader->stage, parts))
+        {
+            ++shaderCount;
+            shaderStages |= shader->stage;
+        }
     }
-    catch (const std::exception &e)
+    appendkey(key, shaderCount);
+    for (const auto &shader : m_shaderModules)
     {
-        throw std::runtime_error(std::string("Failed to create pipeline layout: ") + e.what());
+        if (isshaderinparts(shader->stage, parts))
+        {
+            appendkey(key, shader->stage);
+            appendkey(key, static_cast<const void *>(shader.get()));
+        }
+    }
+    appendspecializationkey(key, m_specializationConstants, shaderStages);
+    if (preRasterization || fragmentShader)
+    {
+        appendlayoutkey(key, m_setLayouts, m_pushConstants);
     }
 
-    return layout;
+    if (vertexInput)
+    {
+        // 顶点输入：按内容序列化描述数组（指针本身没有意义）
+        appendkey(key, m_vertexInputInfo.vertexBindingDescriptionCount);
+        for (uint32_t i = 0; i < m_vertexInputInfo.vertexBindingDescriptionCount; ++i)
+        {
+            const vk::VertexInputBindingDescription &binding = m_vertexInputInfo.pVertexBindingDescriptions[i];
+            appendkey(key, binding.binding);
+            appendkey(key, binding.stride);
+            appendkey(key, binding.inputRate);
+        }
+        appendkey(key, m_vertexInputInfo.vertexAttributeDescriptionCount);
+        for (uint32_t i = 0; i < m_vertexInputInfo.vertexAttributeDescriptionCount; ++i)
+        {
+            const vk::VertexInputAttributeDescription &attribute = m_vertexInputInfo.pVertexAttributeDescriptions[i];
+            appendkey(key, attribute.location);
+            appendkey(key, attribute.binding);
+            appendkey(key, attribute.format);
+            appendkey(key, attribute.offset);
+        }
+
+        appendkey(key, m_inputAssemblyInfo.topology);
+        appendkey(key, m_inputAssemblyInfo.primitiveRestartEnable);
+    }
+
+    if (preRasterization)
+    {
+        appendkey(key, m_rasterizationInfo.depthClampEnable);
+        appendkey(key, m_rasterizationInfo.rasterizerDiscardEnable);
+        appendkey(key, m_rasterizationInfo.polygonMode);
+        appendkey(key, m_rasterizationInfo.cullMode);
+        appendkey(key, m_rasterizationInfo.frontFace);
+        appendkey(key, m_rasterizationInfo.depthBiasEnable);
+        appendkey(key, m_rasterizationInfo.depthBiasConstantFactor);
+        appendkey(key, m_rasterizationInfo.depthBiasClamp);
+        appendkey(key, m_rasterizationInfo.depthBiasSlopeFactor);
+        appendkey(key, m_rasterizationInfo.lineWidth);
+    }
+
+    if (fragmentShader || fragmentOutput)
+    {
+        appendkey(key, m_multisampleInfo.rasterizationSamples);
+        appendkey(key, m_multisampleInfo.sampleShadingEnable);
+        appendkey(key, m_multisampleInfo.minSampleShading);
+        appendkey(key, m_multisampleInfo.alphaToCoverageEnable);
+        appendkey(key, m_multisampleInfo.alphaToOneEnable);
+        appendkey(key, static_cast<uint32_t>(m_sampleMask.size()));
+        for (vk::SampleMask mask : m_sampleMask)
+        {
+            appendkey(key, mask);
+        }
+    }
+
+    if (fragmentShader)
+    {
+        appendkey(key, m_depthStencilInfo.depthTestEnable);
+        appendkey(key, m_depthStencilInfo.depthWriteEnable);
+        appendkey(key, m_depthStencilInfo.depthCompareOp);
+        appendkey(key, m_depthStencilInfo.depthBoundsTestEnable);
+        appendkey(key, m_depthStencilInfo.stencilTestEnable);
+        appendstencilkey(key, m_depthStencilInfo.front);
+        appendstencilkey(key, m_depthStencilInfo.back);
+        appendkey(key, m_depthStencilInfo.minDepthBounds);
+        appendkey(key, m_depthStencilInfo.maxDepthBounds);
+    }
+
+    if (fragmentOutput)
+    {
+        appendkey(key, static_cast<uint32_t>(m_colorBlendAttachments.size()));
+        for (const vk::PipelineColorBlendAttachmentState &blend : m_colorBlendAttachments)
+        {
+            appendkey(key, blend.blendEnable);
+            appendkey(key, blend.srcColorBlendFactor);
+            appendkey(key, blend.dstColorBlendFactor);
+            appendkey(key, blend.colorBlendOp);
+            appendkey(key, blend.srcAlphaBlendFactor);
+            appendkey(key, blend.dstAlphaBlendFactor);
+            appendkey(key, blend.alphaBlendOp);
+            appendkey(key, blend.colorWriteMask);
+        }
+    }
+
+    // 着色速率状态属于光栅化前与片段着色器部件
+    if (preRasterization || fragmentShader)
+    {
+        appendkey(key, m_fragmentShadingRateEnabled);
+        if (m_fragmentShadingRateEnabled)
+        {
+            appendkey(key, m_fragmentShadingRateInfo.fragmentSize.width);
+            appendkey(key, m_fragmentShadingRateInfo.fragmentSize.height);
+            appendkey(key, m_fragmentShadingRateInfo.combinerOps[0]);
+            appendkey(key, m_fragmentShadingRateInfo.combinerOps[1]);
+        }
+    }
+
+    // 动态状态各部件只取与自身相关的部分，这里保守地全部计入
+    appendkey(key, static_cast<uint32_t>(m_dynamicStates.size()));
+    for (vk::DynamicState state : m_dynamicStates)
+    {
+        appendkey(key, state);
+    }
+
+    // 深度/模板格式同时影响片段着色器部件
+    if (fragmentShader || fragmentOutput)
+    {
+        appendkey(key, static_cast<uint32_t>(m_colorAttachmentFormats.size()));
+        for (vk::Format format : m_colorAttachmentFormats)
+        {
+            appendkey(key, format);
+        }
+        appendkey(key, m_depthAttachmentFormat);
+        appendkey(key, m_stencilAttachmentFormat);
+    }
+}
+
+std::unique_ptr<PipelineBuilder> PipelineBuilder::clone() const
+{
+    auto copy = std::make_unique<PipelineBuilder>(m_device);
+    copy->m_shaderModules = m_shaderModules;
+    copy->m_setLayouts = m_setLayouts;
+    copy->m_pushConstants = m_pushConstants;
+    copy->m_layoutCache = m_layoutCache;
+    copy->m_specializationConstants = m_specializationConstants;
+    copy->setVertexInput(m_vertexInputInfo);
+    copy->m_inputAssemblyInfo = m_inputAssemblyInfo;
+    copy->m_rasterizationInfo = m_rasterizationInfo;
+    copy->setMultisampling(m_multisampleInfo);
+    copy->m_depthStencilInfo = m_depthStencilInfo;
+    copy->m_colorBlendAttachments = m_colorBlendAttachments;
+    copy->m_dynamicStates = m_dynamicStates;
+    copy->m_colorAttachmentFormats = m_colorAttachmentFormats;
+    copy->m_depthAttachmentFormat = m_depthAttachmentFormat;
+    copy->m_stencilAttachmentFormat = m_stencilAttachmentFormat;
+    copy->m_fragmentShadingRateEnabled = m_fragmentShadingRateEnabled;
+    copy->m_fragmentShadingRateInfo = m_fragmentShadingRateInfo;
+    return copy;
+}
+
+std::unique_ptr<Pipeline> PipelineBuilder::build(vk::PipelineCache cache)
+{
+    return createpipeline(kAllLibraryParts, {}, {}, cache);
+}
+
+std::unique_ptr<Pipeline> PipelineBuilder::buildLibrary(vk::GraphicsPipelineLibraryFlagBitsEXT part,
+                                                        vk::PipelineCache cache)
+{
+    // 保留链接时优化信息：同一部件既可快速链接，也可之后在后台做优化链接
+    return createpipeline(part,
+                          vk::PipelineCreateFlagBits::eLibraryKHR |
+                              vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT,
+                          {}, cache);
+}
+
+bool PipelineBuilder::isMeshShading() const
+{
+    return std::any_of(m_shaderModules.begin(), m_shaderModules.end(), [](const auto &shader) {
+        return shader->stage == vk::ShaderStageFlagBits::eMeshEXT;
+    });
 }
 
-std::unique_ptr<Pipeline> PipelineBuilder::build()
+std::unique_ptr<Pipeline> PipelineBuilder::link(std::span<const vk::Pipeline> libraries, bool optimize,
+                                                vk::PipelineCache cache)
 {
+    if (libraries.empty())
+    {
+        throw std::invalid_argument("PipelineBuilder::link requires pipeline libraries");
+    }
+    vk::PipelineCreateFlags flags;
+    if (optimize)
+    {
+        flags |= vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT;
+    }
+    return createpipeline({}, flags, libraries, cache);
+}
+
+std::unique_ptr<Pipeline> PipelineBuilder::createpipeline(vk::GraphicsPipelineLibraryFlagsEXT parts,
+                                                          vk::PipelineCreateFlags flags,
+                                                          std::span<const vk::Pipeline> libraries,
+                                                          vk::PipelineCache cache)
+{
+    using Part = vk::GraphicsPipelineLibraryFlagBitsEXT;
+    // 网格着色管线自行生成图元，顶点输入与图元装配状态必须为空
+    const bool vertexInput = static_cast<bool>(parts & Part::eVertexInputInterface) && !isMeshShading();
+    const bool preRasterization = static_cast<bool>(parts & Part::ePreRasterizationShaders);
+    const bool fragmentShader = static_cast<bool>(parts & Part::eFragmentShader);
+    const bool fragmentOutput = static_cast<bool>(parts & Part::eFragmentOutputInterface);
+    const bool isLibrary = static_cast<bool>(flags & vk::PipelineCreateFlagBits::eLibraryKHR);
+
     // 0. 验证必须使用动态渲染
-    if (m_colorAttachmentFormats.empty() && m_depthAttachmentFormat == vk::Format::eUndefined &&
+    if (fragmentOutput && m_colorAttachmentFormats.empty() && m_depthAttachmentFormat == vk::Format::eUndefined &&
         m_stencilAttachmentFormat == vk::Format::eUndefined)
     {
         throw std::runtime_error("Dynamic rendering is required! Must specify at least one attachment format using "
                                  "addColorAttachment(), setDepthAttachment(), or setStencilAttachment()");
     }
 
-    // 1. 创建管线布局
-    vk::PipelineLayout layout = buildlayout();
-
-    // 2. 准备着色器阶段
-    std::vector<vk::PipelineShaderStageCreateInfo> shaderStages;
+    // 1. 准备着色器阶段（部件只包含自身阶段的着色器）
+    std::vector<ShaderModule *> stageShaders;
     for (const auto &shader : m_shaderModules)
     {
-        vk::PipelineShaderStageCreateInfo stageInfo = {};
-        stageInfo.stage = shader->stage;
-        stageInfo.module = shader->shaderModule;
-        stageInfo.pName = "main"; // 入口函数名
-        shaderStages.push_back(stageInfo);
+        if (isshaderinparts(shader->stage, parts))
+        {
+            stageShaders.push_back(shader.get());
+        }
     }
+    std::vector<vk::PipelineShaderStageCreateInfo> shaderStages(stageShaders.size());
+    std::vector<vk::PipelineShaderStageModuleIdentifierCreateInfoEXT> identifierInfos(stageShaders.size());
+    std::vector<StageSpecialization> specializations(stageShaders.size());
+    for (size_t i = 0; i < stageShaders.size(); ++i)
+    {
+        buildspecialization(m_specializationConstants, stageShaders[i]->stage, specializations[i]);
+    }
+    auto fillstages = [&](bool allowIdentifier) {
+        bool usesIdentifier = false;
+        for (size_t i = 0; i < stageShaders.size(); ++i)
+        {
+            usesIdentifier |= fillshaderstage(*stageShaders[i], allowIdentifier, specializations[i].get(),
+                                              shaderStages[i], identifierInfos[i]);
+        }
+        return usesIdentifier;
+    };
 
-    if (shaderStages.empty())
+    if (preRasterization && shaderStages.empty())
     {
         throw std::runtime_error("No shader modules provided to PipelineBuilder");
     }
 
+    // 2. 创建管线布局（顶点输入/片段输出部件不需要布局）
+    vk::PipelineLayout layout;
+    if (preRasterization || fragmentShader || !libraries.empty())
+    {
+        layout = buildlayout();
+    }
+
     // 3. 配置视口和裁剪矩形（如果使用动态状态，这里可以设置为 nullptr）
     vk::PipelineViewportStateCreateInfo viewportState = {};
     viewportState.viewportCount = 1;
@@ -242,19 +867,56 @@ std::unique_ptr<Pipeline> PipelineBuilder::build()
     renderingInfo.depthAttachmentFormat = m_depthAttachmentFormat;
     renderingInfo.stencilAttachmentFormat = m_stencilAttachmentFormat;
 
-    // 7. 创建图形管线
+    // 7. 管线库信息：部件声明自身包含的状态，链接时列出所有部件
+    vk::GraphicsPipelineLibraryCreateInfoEXT libraryInfo = {};
+    libraryInfo.flags = parts;
+    vk::PipelineLibraryCreateInfoKHR linkInfo = {};
+    linkInfo.libraryCount = static_cast<uint32_t>(libraries.size());
+    linkInfo.pLibraries = libraries.data();
+
+    // 8. 着色速率状态（光栅化前与片段着色器部件）；管线需声明可用于带着色速率附件的渲染实例
+    vk::PipelineFragmentShadingRateStateCreateInfoKHR fragmentShadingRateInfo = m_fragmentShadingRateInfo;
+    if (m_fragmentShadingRateEnabled)
+    {
+        flags |= vk::PipelineCreateFlagBits::eRenderingFragmentShadingRateAttachmentKHR;
+    }
+
+    const void *pNext = nullptr;
+    if (parts)
+    {
+        renderingInfo.pNext = pNext;
+        pNext = &renderingInfo; // 关键：链接动态渲染信息
+    }
+    if (m_fragmentShadingRateEnabled && (preRasterization || fragmentShader))
+    {
+        fragmentShadingRateInfo.pNext = pNext;
+        pNext = &fragmentShadingRateInfo;
+    }
+    if (isLibrary)
+    {
+        libraryInfo.pNext = pNext;
+        pNext = &libraryInfo;
+    }
+    if (!libraries.empty())
+    {
+        linkInfo.pNext = pNext;
+        pNext = &linkInfo;
+    }
+
+    // 9. 创建图形管线（不属于 parts 的状态置空，由其他部件提供）
     vk::GraphicsPipelineCreateInfo pipelineInfo = {};
-    pipelineInfo.pNext = &renderingInfo; // 关键：链接动态渲染信息
+    pipelineInfo.pNext = pNext;
+    pipelineInfo.flags = flags;
     pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
-    pipelineInfo.pStages = shaderStages.data();
-    pipelineInfo.pVertexInputState = &m_vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &m_inputAssemblyInfo;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &m_rasterizationInfo;
-    pipelineInfo.pMultisampleState = &m_multisampleInfo;
-    pipelineInfo.pDepthStencilState = &m_depthStencilInfo;
-    pipelineInfo.pColorBlendState = &colorBlendState;
-    pipelineInfo.pDynamicState = m_dynamicStates.empty() ? nullptr : &dynamicState;
+    pipelineInfo.pStages = shaderStages.empty() ? nullptr : shaderStages.data();
+    pipelineInfo.pVertexInputState = vertexInput ? &m_vertexInputInfo : nullptr;
+    pipelineInfo.pInputAssemblyState = vertexInput ? &m_inputAssemblyInfo : nullptr;
+    pipelineInfo.pViewportState = preRasterization ? &viewportState : nullptr;
+    pipelineInfo.pRasterizationState = preRasterization ? &m_rasterizationInfo : nullptr;
+    pipelineInfo.pMultisampleState = fragmentShader || fragmentOutput ? &m_multisampleInfo : nullptr;
+    pipelineInfo.pDepthStencilState = fragmentShader ? &m_depthStencilInfo : nullptr;
+    pipelineInfo.pColorBlendState = fragmentOutput ? &colorBlendState : nullptr;
+    pipelineInfo.pDynamicState = parts && !m_dynamicStates.empty() ? &dynamicState : nullptr;
     pipelineInfo.layout = layout;
     pipelineInfo.renderPass = nullptr; // 动态渲染不需要 RenderPass
     pipelineInfo.subpass = 0;
@@ -264,25 +926,169 @@ std::unique_ptr<Pipeline> PipelineBuilder::build()
     vk::Pipeline pipeline;
     try
     {
-        // createGraphicsPipelines 返回 ResultValue<std::vector<Pipeline>>
-        vk::ResultValue<std::vector<vk::Pipeline>> result =
-            m_device.get().createGraphicsPipelines(nullptr, pipelineInfo);
+        // 只有模块标识时要求驱动从管线缓存取得结果，未命中（ePipelineCompileRequired）再补建模块重新创建
+        if (fillstages(true))
+        {
+            pipelineInfo.flags = flags | vk::PipelineCreateFlagBits::eFailOnPipelineCompileRequired;
+            vk::ResultValue<std::vector<vk::Pipeline>> result =
+                m_device.get().createGraphicsPipelines(cache, pipelineInfo);
+            if (result.result == vk::Result::eSuccess)
+            {
+                pipeline = result.value[0];
+            }
+            else
+            {
+                fillstages(false);
+                pipelineInfo.flags = flags;
+            }
+        }
 
-        if (result.result != vk::Result::eSuccess)
+        if (!pipeline)
         {
-            throw std::runtime_error("Failed to create graphics pipeline");
+            // createGraphicsPipelines 返回 ResultValue<std::vector<Pipeline>>
+            vk::ResultValue<std::vector<vk::Pipeline>> result =
+                m_device.get().createGraphicsPipelines(cache, pipelineInfo);
+
+            if (result.result != vk::Result::eSuccess)
+            {
+                throw std::runtime_error("Failed to create graphics pipeline");
+            }
+            pipeline = result.value[0];
         }
-        pipeline = result.value[0];
     }
     catch (const std::exception &e)
     {
-        // 创建失败时清理已创建的布局
-        m_device.get().destroyPipelineLayout(layout);
+        // 创建失败时清理已创建的布局（缓存的布局仍属于缓存）
+        if (layout && !m_layoutCache)
+        {
+            m_device.get().destroyPipelineLayout(layout);
+        }
         throw std::runtime_error(std::string("Failed to create graphics pipeline: ") + e.what());
     }
 
-    // 8. 返回封装后的 Pipeline 对象
-    return std::unique_ptr<Pipeline>(new Pipeline(m_device, pipeline, layout, vk::PipelineBindPoint::eGraphics));
+    // 10. 返回封装后的 Pipeline 对象
+    return std::unique_ptr<Pipeline>(
+        new Pipeline(m_device, pipeline, layout, vk::PipelineBindPoint::eGraphics, m_layoutCache == nullptr));
+}
+
+// ========================================
+// ComputePipelineBuilder 类的实现
+// ========================================
+
+ComputePipelineBuilder::ComputePipelineBuilder(vkcore::Device &device) : m_device(device)
+{
+}
+
+ComputePipelineBuilder &ComputePipelineBuilder::setShaderModule(std::shared_ptr<ShaderModule> shaderModule)
+{
+    if (!shaderModule || shaderModule->stage != vk::ShaderStageFlagBits::eCompute)
+    {
+        throw std::invalid_argument("ComputePipelineBuilder requires a compute shader module");
+    }
+    m_shaderModule = std::move(shaderModule);
+    return *this;
+}
+
+ComputePipelineBuilder &ComputePipelineBuilder::addDescriptorSetLayout(vk::DescriptorSetLayout layout)
+{
+    m_setLayouts.push_back(layout);
+    return *this;
+}
+
+ComputePipelineBuilder &ComputePipelineBuilder::addPushConstant(const vk::PushConstantRange &range)
+{
+    m_pushConstants.push_back(range);
+    return *this;
+}
+
+ComputePipelineBuilder &ComputePipelineBuilder::deriveLayout(DescriptorLayoutCache &cache)
+{
+    if (!m_shaderModule)
+    {
+        throw std::invalid_argument("ComputePipelineBuilder::deriveLayout requires a shader module");
+    }
+    derivelayout({m_shaderModule}, cache, m_setLayouts, m_pushConstants);
+    return *this;
+}
+
+ComputePipelineBuilder &ComputePipelineBuilder::setPipelineLayoutCache(PipelineLayoutCache *cache)
+{
+    m_layoutCache = cache;
+    return *this;
+}
+
+ComputePipelineBuilder &ComputePipelineBuilder::setSpecializationConstant(uint32_t constantId, uint32_t value)
+{
+    setspecialization(m_specializationConstants, {vk::ShaderStageFlagBits::eCompute, constantId, value});
+    return *this;
+}
+
+std::vector<uint8_t> ComputePipelineBuilder::getStateKey() const
+{
+    std::vector<uint8_t> key;
+    appendkey(key, vk::PipelineBindPoint::eCompute);
+    appendkey(key, static_cast<const void *>(m_shaderModule.get()));
+    appendlayoutkey(key, m_setLayouts, m_pushConstants);
+    appendspecializationkey(key, m_specializationConstants, vk::ShaderStageFlagBits::eCompute);
+    return key;
+}
+
+std::unique_ptr<Pipeline> ComputePipelineBuilder::build(vk::PipelineCache cache)
+{
+    if (!m_shaderModule)
+    {
+        throw std::runtime_error("No shader module provided to ComputePipelineBuilder");
+    }
+
+    // 1. 创建管线布局
+    vk::PipelineLayout layout = createlayout(m_device, m_layoutCache, m_setLayouts, m_pushConstants);
+
+    // 2. 创建计算管线（只有模块标识时的处理与图形管线相同）
+    vk::ComputePipelineCreateInfo pipelineInfo = {};
+    vk::PipelineShaderStageModuleIdentifierCreateInfoEXT identifierInfo = {};
+    StageSpecialization specialization;
+    buildspecialization(m_specializationConstants, vk::ShaderStageFlagBits::eCompute, specialization);
+    pipelineInfo.layout = layout;
+
+    vk::Pipeline pipeline;
+    try
+    {
+        if (fillshaderstage(*m_shaderModule, true, specialization.get(), pipelineInfo.stage, identifierInfo))
+        {
+            pipelineInfo.flags = vk::PipelineCreateFlagBits::eFailOnPipelineCompileRequired;
+            vk::ResultValue<vk::Pipeline> result = m_device.get().createComputePipeline(cache, pipelineInfo);
+            if (result.result == vk::Result::eSuccess)
+            {
+                pipeline = result.value;
+            }
+            else
+            {
+                fillshaderstage(*m_shaderModule, false, specialization.get(), pipelineInfo.stage, identifierInfo);
+                pipelineInfo.flags = {};
+            }
+        }
+
+        if (!pipeline)
+        {
+            vk::ResultValue<vk::Pipeline> result = m_device.get().createComputePipeline(cache, pipelineInfo);
+            if (result.result != vk::Result::eSuccess)
+            {
+                throw std::runtime_error("Failed to create compute pipeline");
+            }
+            pipeline = result.value;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        if (!m_layoutCache)
+        {
+            m_device.get().destroyPipelineLayout(layout);
+        }
+        throw std::runtime_error(std::string("Failed to create compute pipeline: ") + e.what());
+    }
+
+    return std::unique_ptr<Pipeline>(
+        new Pipeline(m_device, pipeline, layout, vk::PipelineBindPoint::eCompute, m_layoutCache == nullptr));
 }
 
 } // namespace vkcore
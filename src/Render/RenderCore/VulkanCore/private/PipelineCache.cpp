@@ -0,0 +1,494 @@
+/**
+ * @file PipelineCache.cpp
+ * @brief PipelineCache 实现
+ */
+
+#include "PipelineCache.hpp"
+#include "Log.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+namespace vkcore
+{
+
+namespace
+{
+
+constexpr char kMagic[4] = {'Q', 'T', 'P', 'C'};
+constexpr uint32_t kVersion = 1;
+
+/**
+ * @struct PipelineCacheFileHeader
+ * @brief 磁盘缓存文件头（小端）
+ */
+struct PipelineCacheFileHeader
+{
+    char magic[4];                           ///< "QTPC"
+    uint32_t version;                        ///< 格式版本（kVersion）
+    uint32_t vendorID;                       ///< VkPhysicalDeviceProperties::vendorID
+    uint32_t deviceID;                       ///< VkPhysicalDeviceProperties::deviceID
+    uint32_t driverVersion;                  ///< VkPhysicalDeviceProperties::driverVersion
+    uint32_t reserved;                       ///< 对齐
+    uint8_t deviceUUID[VK_UUID_SIZE];        ///< VkPhysicalDeviceIDProperties::deviceUUID
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE]; ///< VkPhysicalDeviceProperties::pipelineCacheUUID
+    uint64_t dataSize;                       ///< 驱动缓存数据字节数
+    uint64_t dataHash;                       ///< 驱动缓存数据的 FNV-1a 哈希（检测截断/损坏）
+};
+
+uint64_t hashbytes(const uint8_t *data, size_t size)
+{
+    uint64_t hash = 1469598103934665603ull;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief 用当前物理设备填写文件头的设备标识字段
+ */
+PipelineCacheFileHeader makeheader(vk::PhysicalDevice physicalDevice)
+{
+    auto chain = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceIDProperties>();
+    const vk::PhysicalDeviceProperties &properties = chain.get<vk::PhysicalDeviceProperties2>().properties;
+    const vk::PhysicalDeviceIDProperties &idProperties = chain.get<vk::PhysicalDeviceIDProperties>();
+
+    PipelineCacheFileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.vendorID = properties.vendorID;
+    header.deviceID = properties.deviceID;
+    header.driverVersion = properties.driverVersion;
+    std::memcpy(header.deviceUUID, idProperties.deviceUUID.data(), VK_UUID_SIZE);
+    std::memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+    return header;
+}
+
+} // namespace
+
+PipelineCache::PipelineCache(Device &device, std::filesystem::path cacheFile, uint32_t compileThreadCount)
+    : m_device(device), m_cacheFile(std::move(cacheFile)), m_compileThreadCount(compileThreadCount)
+{
+    m_useLibraries = m_device.isExtensionEnabled(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+    if (m_useLibraries)
+    {
+        auto chain = m_device.getPhysicalDevice()
+                         .getProperties2<vk::PhysicalDeviceProperties2,
+                                         vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>();
+        m_fastLinking =
+            chain.get<vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>().graphicsPipelineLibraryFastLinking;
+    }
+
+    std::vector<uint8_t> initialData = loadfile();
+
+    vk::PipelineCacheCreateInfo createInfo{};
+    createInfo.initialDataSize = initialData.size();
+    createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+    try
+    {
+        m_pipelineCache = m_device.get().createPipelineCache(createInfo);
+    }
+    catch (const std::exception &e)
+    {
+        // 驱动仍可能拒绝通过了文件头校验的数据：退回空缓存
+        if (initialData.empty())
+        {
+            throw std::runtime_error(std::string("Failed to create pipeline cache: ") + e.what());
+        }
+        m_stats.loadedDataSize = 0;
+        m_stats.rejectedOnLoad = true;
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = nullptr;
+        m_pipelineCache = m_device.get().createPipelineCache(createInfo);
+    }
+}
+
+PipelineCache::~PipelineCache()
+{
+    // 先等后台编译结束，新编译的管线也能写入磁盘
+    waitIdle();
+
+    // 析构中不能抛出：保存失败只影响下次启动的编译时间
+    try
+    {
+        save();
+    }
+    catch (const std::exception &e)
+    {
+        QTR_LOG_WARN("PipelineCache", "failed to save " << m_cacheFile << ": " << e.what());
+    }
+    clear();
+    m_compileWorkers.reset();
+    if (m_pipelineCache)
+    {
+        m_device.get().destroyPipelineCache(m_pipelineCache);
+        m_pipelineCache = nullptr;
+    }
+}
+
+// ==================== 管线去重 ====================
+
+template <typename Builder>
+Pipeline *PipelineCache::getorcreate(Builder &builder, std::vector<std::shared_ptr<ShaderModule>> shaders)
+{
+    std::vector<uint8_t> key = builder.getStateKey();
+    const uint64_t hash = hashbytes(key.data(), key.size());
+
+    std::shared_future<Pipeline *> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (Entry *entry = find(m_entries, hash, key))
+        {
+            ++m_stats.hits;
+            if (Pipeline *pipeline = entry->current())
+            {
+                return pipeline;
+            }
+            pending = entry->ready;
+        }
+    }
+
+    // 相同状态正在后台编译：等待其结果（编译失败时重新抛出）
+    if (pending.valid())
+    {
+        return pending.get();
+    }
+
+    // 编译在锁外进行：驱动对 vk::PipelineCache 的访问做内部同步（未使用 EXTERNALLY_SYNCHRONIZED）
+    std::unique_ptr<Pipeline> pipeline = builder.build(m_pipelineCache);
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    // 另一个线程可能同时创建了相同状态的管线：保留先插入的那个，新建的随 unique_ptr 销毁
+    if (Entry *existing = find(m_entries, hash, key))
+    {
+        ++m_stats.hits;
+        // 期间投递的异步请求尚未完成：直接填入，后台结果会被丢弃
+        if (!existing->pipeline)
+        {
+            existing->pipeline = std::move(pipeline);
+        }
+        return existing->current();
+    }
+
+    ++m_stats.misses;
+    Entry entry;
+    entry.key = std::move(key);
+    entry.shaders = std::move(shaders);
+    entry.pipeline = std::move(pipeline);
+    Pipeline *result = entry.pipeline.get();
+    m_entries.emplace(hash, std::move(entry));
+    return result;
+}
+
+Pipeline *PipelineCache::getOrCreate(PipelineBuilder &builder)
+{
+    return getorcreate(builder, builder.m_shaderModules);
+}
+
+Pipeline *PipelineCache::getOrCreate(ComputePipelineBuilder &builder)
+{
+    return getorcreate(builder, {builder.m_shaderModule});
+}
+
+PipelineCache::Entry *PipelineCache::find(EntryMap &entries, uint64_t hash, const std::vector<uint8_t> &key)
+{
+    auto [begin, end] = entries.equal_range(hash);
+    for (auto it = begin; it != end; ++it)
+    {
+        if (it->second.key == key)
+        {
+            return &it->second;
+        }
+    }
+    return nullptr;
+}
+
+void PipelineCache::clear()
+{
+    std::unique_lock<std::mutex> lock(m_mtx);
+    // 后台任务持有缓存项的引用：等它们全部结束再销毁
+    m_idleCv.wait(lock, [this]() { return m_stats.pendingCompiles == 0; });
+    m_entries.clear();
+    m_libraries.clear();
+}
+
+PipelineCache::Stats PipelineCache::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    Stats stats = m_stats;
+    stats.pipelineCount = static_cast<uint32_t>(m_entries.size());
+    stats.libraryCount = static_cast<uint32_t>(m_libraries.size());
+    return stats;
+}
+
+// ==================== 异步编译 ====================
+
+std::shared_future<Pipeline *> PipelineCache::getOrCreateAsync(PipelineBuilder &builder)
+{
+    std::vector<uint8_t> key = builder.getStateKey();
+    const uint64_t hash = hashbytes(key.data(), key.size());
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (Entry *entry = find(m_entries, hash, key))
+    {
+        ++m_stats.hits;
+        // 同步创建的项没有 future：补一个已就绪的
+        if (!entry->ready.valid())
+        {
+            std::promise<Pipeline *> promise;
+            promise.set_value(entry->current());
+            entry->ready = promise.get_future().share();
+        }
+        return entry->ready;
+    }
+    return enqueuecompile(builder, std::move(key), hash);
+}
+
+Pipeline *PipelineCache::tryGet(PipelineBuilder &builder)
+{
+    std::vector<uint8_t> key = builder.getStateKey();
+    const uint64_t hash = hashbytes(key.data(), key.size());
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (Entry *entry = find(m_entries, hash, key))
+    {
+        // 编译中或编译失败时为空
+        Pipeline *pipeline = entry->current();
+        m_stats.hits += pipeline ? 1 : 0;
+        return pipeline;
+    }
+    enqueuecompile(builder, std::move(key), hash);
+    return nullptr;
+}
+
+void PipelineCache::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_idleCv.wait(lock, [this]() { return m_stats.pendingCompiles == 0; });
+}
+
+void PipelineCache::setWorkerPool(WorkerPool *workers)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_sharedWorkers = workers;
+}
+
+std::shared_future<Pipeline *> PipelineCache::enqueuecompile(PipelineBuilder &builder, std::vector<uint8_t> key,
+                                                             uint64_t hash)
+{
+    // 调用方持有 m_mtx：先插入占位项，之后相同状态的请求都会找到它而不会重复编译
+    ++m_stats.misses;
+    ++m_stats.pendingCompiles;
+    auto promise = std::make_shared<std::promise<Pipeline *>>();
+
+    Entry placeholder;
+    placeholder.key = std::move(key);
+    placeholder.shaders = builder.m_shaderModules;
+    placeholder.ready = promise->get_future().share();
+    Entry &entry = m_entries.emplace(hash, std::move(placeholder))->second;
+
+    if (!m_sharedWorkers && !m_compileWorkers)
+    {
+        const uint32_t threadCount =
+            m_compileThreadCount ? m_compileThreadCount : std::max(1u, std::thread::hardware_concurrency() / 4);
+        m_compileWorkers = std::make_unique<WorkerPool>(threadCount);
+    }
+
+    // 复制构建器：调用方返回后可以自由修改原构建器；缓存项的地址在 clear() 前保持不变
+    std::shared_ptr<PipelineBuilder> snapshot = builder.clone();
+    WorkerPool &workers = m_sharedWorkers ? *m_sharedWorkers : *m_compileWorkers;
+    workers.enqueue([this, &entry, snapshot, promise]() { compile(entry, *snapshot, *promise); });
+    return entry.ready;
+}
+
+void PipelineCache::compile(Entry &entry, PipelineBuilder &builder, std::promise<Pipeline *> &promise)
+{
+    // 只填入空位：同步路径可能已抢先填入，已经返回给调用方的管线绝不替换
+    auto publish = [&](std::unique_ptr<Pipeline> &slot, std::unique_ptr<Pipeline> pipeline) {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (!slot)
+        {
+            slot = std::move(pipeline);
+        }
+        return entry.current();
+    };
+
+    bool delivered = false;
+    try
+    {
+        if (m_useLibraries)
+        {
+            // 顶点输入/片段输出部件几乎在所有管线间共享，着色器部件按着色器共享，命中后只剩链接的开销
+            // 网格着色管线没有顶点输入接口，只链接其余三个部件
+            using Part = vk::GraphicsPipelineLibraryFlagBitsEXT;
+            std::vector<vk::Pipeline> libraries;
+            if (!builder.isMeshShading())
+            {
+                libraries.push_back(getorcreatelibrary(builder, Part::eVertexInputInterface)->get());
+            }
+            libraries.push_back(getorcreatelibrary(builder, Part::ePreRasterizationShaders)->get());
+            libraries.push_back(getorcreatelibrary(builder, Part::eFragmentShader)->get());
+            libraries.push_back(getorcreatelibrary(builder, Part::eFragmentOutputInterface)->get());
+
+            // 驱动不保证快速链接时直接做优化链接，否则先交付快速链接的版本再在同一线程上优化
+            promise.set_value(publish(entry.pipeline, builder.link(libraries, !m_fastLinking, m_pipelineCache)));
+            delivered = true;
+            if (m_fastLinking)
+            {
+                std::unique_ptr<Pipeline> optimized = builder.link(libraries, true, m_pipelineCache);
+                publish(entry.optimized, std::move(optimized));
+            }
+        }
+        else
+        {
+            promise.set_value(publish(entry.pipeline, builder.build(m_pipelineCache)));
+            delivered = true;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        // 已交付快速链接版本时优化失败不影响使用
+        QTR_LOG_ERROR("PipelineCache", "background pipeline compilation failed: " << e.what());
+        if (!delivered)
+        {
+            promise.set_exception(std::current_exception());
+        }
+        std::lock_guard<std::mutex> lock(m_mtx);
+        ++m_stats.failedCompiles;
+    }
+
+    // 在锁内通知：等待方被唤醒后可能立即销毁本对象
+    std::lock_guard<std::mutex> lock(m_mtx);
+    --m_stats.pendingCompiles;
+    m_idleCv.notify_all();
+}
+
+Pipeline *PipelineCache::getorcreatelibrary(PipelineBuilder &builder, vk::GraphicsPipelineLibraryFlagBitsEXT part)
+{
+    std::vector<uint8_t> key = builder.getLibraryKey(part);
+    const uint64_t hash = hashbytes(key.data(), key.size());
+
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (Entry *library = find(m_libraries, hash, key))
+        {
+            return library->pipeline.get();
+        }
+    }
+
+    std::unique_ptr<Pipeline> library = builder.buildLibrary(part, m_pipelineCache);
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (Entry *existing = find(m_libraries, hash, key))
+    {
+        return existing->pipeline.get();
+    }
+
+    Entry entry;
+    entry.key = std::move(key);
+    entry.shaders = builder.m_shaderModules;
+    entry.pipeline = std::move(library);
+    Pipeline *result = entry.pipeline.get();
+    m_libraries.emplace(hash, std::move(entry));
+    return result;
+}
+
+// ==================== 磁盘持久化 ====================
+
+std::vector<uint8_t> PipelineCache::loadfile()
+{
+    std::vector<uint8_t> data;
+    if (m_cacheFile.empty())
+    {
+        return data;
+    }
+
+    std::error_code ec;
+    const uintmax_t fileSize = std::filesystem::file_size(m_cacheFile, ec);
+    std::ifstream in(m_cacheFile, std::ios::binary);
+    if (ec || !in)
+    {
+        return data;
+    }
+
+    PipelineCacheFileHeader header{};
+    in.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+    // 换了显卡或更新了驱动时旧数据无效：驱动可能拒绝，也可能（有缺陷的驱动）直接崩溃，因此自行校验
+    const PipelineCacheFileHeader expected = makeheader(m_device.getPhysicalDevice());
+    const bool headerValid =
+        in && std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.version == kVersion &&
+        header.vendorID == expected.vendorID && header.deviceID == expected.deviceID &&
+        header.driverVersion == expected.driverVersion && header.dataSize == fileSize - sizeof(header) &&
+        std::memcmp(header.deviceUUID, expected.deviceUUID, VK_UUID_SIZE) == 0 &&
+        std::memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    if (!headerValid)
+    {
+        m_stats.rejectedOnLoad = true;
+        return data;
+    }
+
+    data.resize(header.dataSize);
+    in.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!in || hashbytes(data.data(), data.size()) != header.dataHash)
+    {
+        m_stats.rejectedOnLoad = true;
+        data.clear();
+        return data;
+    }
+
+    m_stats.loadedDataSize = data.size();
+    return data;
+}
+
+bool PipelineCache::save() const
+{
+    if (m_cacheFile.empty() || !m_pipelineCache)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> data = m_device.get().getPipelineCacheData(m_pipelineCache);
+    PipelineCacheFileHeader header = makeheader(m_device.getPhysicalDevice());
+    header.dataSize = data.size();
+    header.dataHash = hashbytes(data.data(), data.size());
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_cacheFile.parent_path(), ec);
+
+    // 临时文件名带线程标识，多个进程/线程同时保存时互不覆盖
+    std::filesystem::path tempPath = m_cacheFile;
+    tempPath += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!out)
+        {
+            out.close();
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    // 重命名是原子的：下次启动要么读到旧文件，要么读到完整的新文件
+    std::filesystem::rename(tempPath, m_cacheFile, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tempPath, ec);
+        QTR_LOG_WARN("PipelineCache", "failed to save " << m_cacheFile << ": " << ec.message());
+        return false;
+    }
+    return true;
+}
+
+} // namespace vkcore
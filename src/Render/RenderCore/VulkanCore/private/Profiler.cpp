@@ -0,0 +1,260 @@
+/**
+ * @file Profiler.cpp
+ * @brief Profiler 实现
+ */
+
+#include "Profiler.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace vkcore
+{
+
+namespace
+{
+
+// 帧标记也走环形缓冲：开始与结束相同、名称为该指针的记录导出为全局瞬时事件
+constexpr const char *kFrameMarkName = "Frame";
+
+struct RawZone
+{
+    const char *name;
+    uint64_t beginNs;
+    uint64_t endNs;
+};
+
+/**
+ * 单个线程的环形缓冲：所属线程推进 head，collect() 推进 tail。
+ * 由注册表与 thread_local 共同持有，线程退出后尚未排空的区段仍可导出
+ */
+struct ThreadRing
+{
+    std::unique_ptr<RawZone[]> zones = std::make_unique<RawZone[]>(Profiler::kZonesPerThread);
+    alignas(64) std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<const char *> threadName{nullptr};
+    uint32_t threadId = 0;
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    std::vector<ProfileZone> capture;
+    uint64_t droppedCapture = 0;
+    std::atomic<uint32_t> frameCounter{0};
+};
+
+thread_local std::shared_ptr<ThreadRing> t_ring;
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+ThreadRing &localring()
+{
+    if (!t_ring)
+    {
+        t_ring = std::make_shared<ThreadRing>();
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        t_ring->threadId = static_cast<uint32_t>(reg.rings.size());
+        reg.rings.push_back(t_ring);
+    }
+    return *t_ring;
+}
+
+// 调用者持有注册表锁
+size_t drainlocked(Registry &reg)
+{
+    size_t drained = 0;
+    for (const auto &ring : reg.rings)
+    {
+        const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (uint64_t i = tail; i < head; ++i)
+        {
+            const RawZone &zone = ring->zones[i & (Profiler::kZonesPerThread - 1)];
+            if (reg.capture.size() < Profiler::kMaxCapturedZones)
+            {
+                reg.capture.push_back(ProfileZone{zone.name, zone.beginNs, zone.endNs, ring->threadId});
+            }
+            else
+            {
+                ++reg.droppedCapture;
+            }
+        }
+        ring->tail.store(head, std::memory_order_release);
+        drained += static_cast<size_t>(head - tail);
+    }
+    return drained;
+}
+
+std::string escapejson(const char *text)
+{
+    std::string escaped;
+    for (const char *c = text; *c != '\0'; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            escaped.push_back('\\');
+        }
+        escaped.push_back(*c);
+    }
+    return escaped;
+}
+
+} // namespace
+
+std::atomic<bool> Profiler::s_enabled{false};
+
+void Profiler::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t Profiler::now()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+void Profiler::record(const char *name, uint64_t beginNs, uint64_t endNs)
+{
+    ThreadRing &ring = localring();
+    const uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= kZonesPerThread)
+    {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ring.zones[head & (kZonesPerThread - 1)] = RawZone{name, beginNs, endNs};
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const char *name)
+{
+    localring().threadName.store(name, std::memory_order_relaxed);
+}
+
+void Profiler::markFrame()
+{
+    if (isEnabled())
+    {
+        const uint64_t timestamp = now();
+        record(kFrameMarkName, timestamp, timestamp);
+    }
+    Registry &reg = registry();
+    if (reg.frameCounter.fetch_add(1, std::memory_order_relaxed) % kCollectInterval == kCollectInterval - 1)
+    {
+        collect();
+    }
+}
+
+size_t Profiler::collect()
+{
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    return drainlocked(reg);
+}
+
+std::vector<ProfileZone> Profiler::takeCapture()
+{
+    Registry &reg = registry();
+    std::vector<ProfileZone> zones;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        drainlocked(reg);
+        zones.swap(reg.capture);
+    }
+    std::sort(zones.begin(), zones.end(), [](const ProfileZone &a, const ProfileZone &b) {
+        return a.threadId != b.threadId ? a.threadId < b.threadId : a.beginNs < b.beginNs;
+    });
+    return zones;
+}
+
+void Profiler::writeChromeTrace(const std::filesystem::path &path)
+{
+    Registry &reg = registry();
+    std::vector<ProfileZone> zones;
+    std::vector<std::pair<uint32_t, const char *>> threadNames;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        drainlocked(reg);
+        zones = reg.capture;
+        for (const auto &ring : reg.rings)
+        {
+            threadNames.emplace_back(ring->threadId, ring->threadName.load(std::memory_order_relaxed));
+        }
+    }
+
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("Profiler::writeChromeTrace: cannot open " + path.string());
+    }
+
+    uint64_t origin = UINT64_MAX;
+    for (const ProfileZone &zone : zones)
+    {
+        origin = std::min(origin, zone.beginNs);
+    }
+
+    // Chrome trace 的时间单位为微秒；"X" 为完整区段，嵌套关系由时间区间推出
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    std::array<char, 128> numbers{};
+    for (const auto &[threadId, name] : threadNames)
+    {
+        if (name)
+        {
+            file << (first ? "\n" : ",\n") << "{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": "
+                 << threadId << ", \"args\": {\"name\": \"" << escapejson(name) << "\"}}";
+            first = false;
+        }
+    }
+    for (const ProfileZone &zone : zones)
+    {
+        const double ts = static_cast<double>(zone.beginNs - origin) / 1000.0;
+        if (zone.name == kFrameMarkName && zone.beginNs == zone.endNs)
+        {
+            std::snprintf(numbers.data(), numbers.size(), "%.3f", ts);
+            file << (first ? "\n" : ",\n") << "{\"ph\": \"i\", \"s\": \"g\", \"name\": \"Frame\", \"pid\": 1, \"tid\": "
+                 << zone.threadId << ", \"ts\": " << numbers.data() << '}';
+        }
+        else
+        {
+            const double dur = static_cast<double>(zone.endNs - zone.beginNs) / 1000.0;
+            std::snprintf(numbers.data(), numbers.size(), "\"ts\": %.3f, \"dur\": %.3f", ts, dur);
+            file << (first ? "\n" : ",\n") << "{\"ph\": \"X\", \"name\": \"" << escapejson(zone.name)
+                 << "\", \"pid\": 1, \"tid\": " << zone.threadId << ", " << numbers.data() << '}';
+        }
+        first = false;
+    }
+    file << "\n]}\n";
+}
+
+uint64_t Profiler::getDroppedZones()
+{
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    uint64_t dropped = reg.droppedCapture;
+    for (const auto &ring : reg.rings)
+    {
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+} // namespace vkcore
@@ -0,0 +1,153 @@
+/**
+ * @file SamplerCache.cpp
+ * @brief SamplerCache 实现
+ */
+
+#include "SamplerCache.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace vkcore
+{
+
+namespace
+{
+
+template <typename T> void appendkey(std::vector<uint8_t> &key, const T &value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "appendkey requires a trivially copyable type");
+    const size_t offset = key.size();
+    key.resize(offset + sizeof(T));
+    std::memcpy(key.data() + offset, &value, sizeof(T));
+}
+
+} // namespace
+
+SamplerCache::SamplerCache(Device &device) : m_device(device)
+{
+    const vk::PhysicalDeviceLimits limits = m_device.getPhysicalDevice().getProperties().limits;
+    m_anisotropySupported = m_device.isFeatureEnabled("samplerAnisotropy");
+    m_maxAnisotropy = limits.maxSamplerAnisotropy;
+    m_stats.maxSamplers = limits.maxSamplerAllocationCount;
+}
+
+SamplerCache::~SamplerCache()
+{
+    cleanup();
+}
+
+vk::SamplerCreateInfo SamplerCache::makeInfo(vk::Filter filter, vk::SamplerAddressMode addressMode)
+{
+    vk::SamplerCreateInfo info = {};
+    info.magFilter = filter;
+    info.minFilter = filter;
+    info.mipmapMode = vk::SamplerMipmapMode::eLinear;
+    info.addressModeU = addressMode;
+    info.addressModeV = addressMode;
+    info.addressModeW = addressMode;
+    info.mipLodBias = 0.0f;
+    info.anisotropyEnable = VK_FALSE;
+    info.maxAnisotropy = 1.0f;
+    info.compareEnable = VK_FALSE;
+    info.compareOp = vk::CompareOp::eAlways;
+    info.minLod = 0.0f;
+    info.maxLod = VK_LOD_CLAMP_NONE; // 默认的 0 会把采样钳制在 mip 0
+    info.borderColor = vk::BorderColor::eFloatOpaqueBlack;
+    info.unnormalizedCoordinates = VK_FALSE;
+    return info;
+}
+
+std::vector<uint8_t> SamplerCache::makekey(const vk::SamplerCreateInfo &info)
+{
+    // 逐字段追加，避免把填充字节写入键中；未启用的各向异性/比较参数不影响采样结果，归一化后再比较
+    std::vector<uint8_t> key;
+    key.reserve(64);
+    appendkey(key, info.flags);
+    appendkey(key, info.magFilter);
+    appendkey(key, info.minFilter);
+    appendkey(key, info.mipmapMode);
+    appendkey(key, info.addressModeU);
+    appendkey(key, info.addressModeV);
+    appendkey(key, info.addressModeW);
+    appendkey(key, info.mipLodBias);
+    appendkey(key, info.anisotropyEnable);
+    appendkey(key, info.anisotropyEnable ? info.maxAnisotropy : 1.0f);
+    appendkey(key, info.compareEnable);
+    appendkey(key, info.compareEnable ? info.compareOp : vk::CompareOp::eAlways);
+    appendkey(key, info.minLod);
+    appendkey(key, info.maxLod);
+    appendkey(key, info.borderColor);
+    appendkey(key, info.unnormalizedCoordinates);
+    return key;
+}
+
+vk::Sampler SamplerCache::getOrCreate(const vk::SamplerCreateInfo &info)
+{
+    if (info.pNext)
+    {
+        throw std::invalid_argument("SamplerCache::getOrCreate: pNext chains are not supported");
+    }
+
+    vk::SamplerCreateInfo createInfo = info;
+    if (!m_anisotropySupported)
+    {
+        createInfo.anisotropyEnable = VK_FALSE;
+    }
+    createInfo.maxAnisotropy = createInfo.anisotropyEnable ? std::clamp(createInfo.maxAnisotropy, 1.0f, m_maxAnisotropy)
+                                                           : 1.0f;
+    if (!createInfo.compareEnable)
+    {
+        createInfo.compareOp = vk::CompareOp::eAlways;
+    }
+    std::vector<uint8_t> key = makekey(createInfo);
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    ++m_stats.requests;
+    auto it = m_samplers.find(key);
+    if (it != m_samplers.end())
+    {
+        ++m_stats.hits;
+        return it->second;
+    }
+
+    if (m_stats.maxSamplers != 0 && m_samplers.size() >= m_stats.maxSamplers)
+    {
+        throw std::runtime_error("SamplerCache: maxSamplerAllocationCount (" + std::to_string(m_stats.maxSamplers) +
+                                 ") reached");
+    }
+
+    vk::Sampler sampler;
+    try
+    {
+        sampler = m_device.get().createSampler(createInfo);
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error(std::string("SamplerCache: failed to create sampler: ") + e.what());
+    }
+    m_samplers.emplace(std::move(key), sampler);
+    return sampler;
+}
+
+SamplerCache::Stats SamplerCache::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    Stats stats = m_stats;
+    stats.samplerCount = static_cast<uint32_t>(m_samplers.size());
+    return stats;
+}
+
+void SamplerCache::cleanup()
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    for (const auto &[key, sampler] : m_samplers)
+    {
+        m_device.get().destroySampler(sampler);
+    }
+    m_samplers.clear();
+}
+
+} // namespace vkcore
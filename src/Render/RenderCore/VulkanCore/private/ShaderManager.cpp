@@ -7,6 +7,7 @@
  * 主要功能包括：
  * - 基于名称的着色器缓存机制，避免重复加载
  * - 从 SPIR-V 字节码创建着色器模块
+ * - 从已挂载的着色器包惰性创建模块，并持久化 VK_EXT_shader_module_identifier 模块标识
  * - 线程安全的并发访问控制
  *
  * 注意：使用 std::shared_ptr 管理着色器模块，支持外部持有引用。
@@ -15,22 +16,98 @@
  */
 
 #include "ShaderManager.hpp"
+#include "Log.hpp"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
 
 namespace vkcore
 {
+
+namespace
+{
+
+constexpr char kIdentifierMagic[4] = {'Q', 'T', 'S', 'I'};
+constexpr uint32_t kIdentifierVersion = 1;
+
+/**
+ * @struct IdentifierCacheHeader
+ * @brief 模块标识缓存文件头（小端）
+ */
+struct IdentifierCacheHeader
+{
+    char magic[4];                       ///< "QTSI"
+    uint32_t version;                    ///< 格式版本（kIdentifierVersion）
+    uint32_t entryCount;                 ///< 条目数量
+    uint32_t reserved;                   ///< 对齐
+    uint8_t algorithmUUID[VK_UUID_SIZE]; ///< shaderModuleIdentifierAlgorithmUUID，驱动更新后标识失效
+};
+
+/**
+ * @struct IdentifierCacheEntry
+ * @brief 模块标识缓存条目
+ */
+struct IdentifierCacheEntry
+{
+    uint64_t contentHash;                                         ///< SPIR-V 内容哈希
+    uint32_t identifierSize;                                      ///< 标识字节数
+    uint32_t reserved;                                            ///< 对齐
+    uint8_t identifier[VK_MAX_SHADER_MODULE_IDENTIFIER_SIZE_EXT]; ///< 模块标识
+};
+
+} // namespace
+
 // ========================================
 // ShaderManager 类的实现
 // ========================================
 
-ShaderManager::ShaderManager(Device &device) : m_device(device)
+ShaderManager::ShaderManager(Device &device, std::filesystem::path identifierCacheFile)
+    : m_device(device), m_identifierCacheFile(std::move(identifierCacheFile))
 {
+    if (m_identifierCacheFile.empty() || !m_device.isExtensionEnabled(VK_EXT_SHADER_MODULE_IDENTIFIER_EXTENSION_NAME))
+    {
+        return;
+    }
+
+    m_getShaderModuleIdentifier = reinterpret_cast<PFN_vkGetShaderModuleIdentifierEXT>(
+        m_device.get().getProcAddr("vkGetShaderModuleIdentifierEXT"));
+    if (!m_getShaderModuleIdentifier)
+    {
+        return;
+    }
+
+    auto chain = m_device.getPhysicalDevice()
+                     .getProperties2<vk::PhysicalDeviceProperties2,
+                                     vk::PhysicalDeviceShaderModuleIdentifierPropertiesEXT>();
+    const auto &properties = chain.get<vk::PhysicalDeviceShaderModuleIdentifierPropertiesEXT>();
+    std::memcpy(m_identifierAlgorithm.data(), properties.shaderModuleIdentifierAlgorithmUUID.data(), VK_UUID_SIZE);
+    m_stats.identifiersEnabled = true;
+    loadidentifiers();
 }
 
 ShaderManager::~ShaderManager()
 {
+    // 析构中不能抛出：保存失败只影响下次启动
+    try
+    {
+        save();
+    }
+    catch (const std::exception &e)
+    {
+        QTR_LOG_WARN("ShaderManager", "failed to save " << m_identifierCacheFile << ": " << e.what());
+    }
     cleanup();
 }
 
+void ShaderManager::mountPackage(const std::filesystem::path &packagePath)
+{
+    auto package = std::make_unique<ShaderPackage>(packagePath);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_packages.push_back(std::move(package));
+}
+
 std::shared_ptr<ShaderModule> ShaderManager::getShaderModule(const std::string &name)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -42,12 +119,23 @@ std::shared_ptr<ShaderModule> ShaderManager::getShaderModule(const std::string &
         return it->second;
     }
 
+    // 惰性加载：后挂载的包优先
+    for (auto package = m_packages.rbegin(); package != m_packages.rend(); ++package)
+    {
+        if (std::optional<ShaderPackage::Entry> entry = (*package)->find(name))
+        {
+            std::shared_ptr<ShaderModule> shaderModule = createpackagemodule(*entry);
+            m_shaderModules[name] = shaderModule;
+            return shaderModule;
+        }
+    }
+
     // 未找到，返回空指针
     return nullptr;
 }
 
 std::shared_ptr<ShaderModule> ShaderManager::createShaderModule(const std::string &name,
-                                                                const std::vector<uint32_t> &code,
+                                                                std::span<const uint32_t> code,
                                                                 vk::ShaderStageFlagBits stage)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -69,11 +157,166 @@ std::shared_ptr<ShaderModule> ShaderManager::createShaderModule(const std::strin
 
     // 封装为 ShaderModule 对象并加入缓存
     auto shaderModulePtr = std::make_shared<ShaderModule>(m_device, shaderModule, stage);
+    shaderModulePtr->reflection = reflectmodule(code, {}, stage);
     m_shaderModules[name] = shaderModulePtr;
 
     return shaderModulePtr;
 }
 
+std::shared_ptr<ShaderModule> ShaderManager::createpackagemodule(const ShaderPackage::Entry &entry)
+{
+    // 热启动：已有标识时不创建模块，SPIR-V 留在映射内存中供管线缓存未命中时补建
+    if (m_getShaderModuleIdentifier)
+    {
+        auto identifier = m_identifiers.find(entry.contentHash);
+        if (identifier != m_identifiers.end())
+        {
+            ++m_stats.identifierModules;
+            auto shaderModulePtr =
+                std::make_shared<ShaderModule>(m_device, entry.stage, identifier->second, entry.code);
+            shaderModulePtr->reflection = reflectmodule(entry.code, entry.reflection, entry.stage);
+            return shaderModulePtr;
+        }
+    }
+
+    vk::ShaderModule shaderModule = createshadermodule(entry.code);
+    auto shaderModulePtr = std::make_shared<ShaderModule>(m_device, shaderModule, entry.stage);
+    shaderModulePtr->code = entry.code;
+    shaderModulePtr->reflection = reflectmodule(entry.code, entry.reflection, entry.stage);
+
+    // 冷启动：记录标识供下次启动使用
+    if (m_getShaderModuleIdentifier)
+    {
+        vk::ShaderModuleIdentifierEXT identifier{};
+        m_getShaderModuleIdentifier(m_device.get(), shaderModule,
+                                    reinterpret_cast<VkShaderModuleIdentifierEXT *>(&identifier));
+        if (identifier.identifierSize > 0 && identifier.identifierSize <= VK_MAX_SHADER_MODULE_IDENTIFIER_SIZE_EXT)
+        {
+            std::vector<uint8_t> bytes(identifier.identifier.data(),
+                                       identifier.identifier.data() + identifier.identifierSize);
+            shaderModulePtr->identifier = bytes;
+            m_identifiers[entry.contentHash] = std::move(bytes);
+            m_identifiersDirty = true;
+        }
+    }
+    return shaderModulePtr;
+}
+
+std::shared_ptr<const ShaderReflection> ShaderManager::reflectmodule(std::span<const uint32_t> code,
+                                                                     std::span<const uint8_t> packaged,
+                                                                     vk::ShaderStageFlagBits stage)
+{
+    if (std::optional<ShaderReflection> reflection = ShaderReflection::deserialize(packaged))
+    {
+        return std::make_shared<const ShaderReflection>(std::move(*reflection));
+    }
+
+    try
+    {
+        ++m_stats.reflectedModules;
+        return std::make_shared<const ShaderReflection>(ShaderReflection::reflect(code, stage));
+    }
+    catch (const std::invalid_argument &e)
+    {
+        // 反射只服务于布局推导，失败不影响模块本身
+        QTR_LOG_WARN("ShaderManager", "reflection failed: " << e.what());
+        return nullptr;
+    }
+}
+
+bool ShaderManager::save()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_stats.identifiersEnabled || !m_identifiersDirty)
+    {
+        return false;
+    }
+
+    IdentifierCacheHeader header{};
+    std::memcpy(header.magic, kIdentifierMagic, sizeof(kIdentifierMagic));
+    header.version = kIdentifierVersion;
+    header.entryCount = static_cast<uint32_t>(m_identifiers.size());
+    std::memcpy(header.algorithmUUID, m_identifierAlgorithm.data(), VK_UUID_SIZE);
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_identifierCacheFile.parent_path(), ec);
+
+    std::filesystem::path tempPath = m_identifierCacheFile;
+    tempPath += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (const auto &[contentHash, identifier] : m_identifiers)
+        {
+            IdentifierCacheEntry entry{};
+            entry.contentHash = contentHash;
+            entry.identifierSize = static_cast<uint32_t>(identifier.size());
+            std::memcpy(entry.identifier, identifier.data(), identifier.size());
+            out.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+        }
+        if (!out)
+        {
+            out.close();
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, m_identifierCacheFile, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    m_identifiersDirty = false;
+    return true;
+}
+
+void ShaderManager::loadidentifiers()
+{
+    std::ifstream in(m_identifierCacheFile, std::ios::binary);
+    if (!in)
+    {
+        return;
+    }
+
+    IdentifierCacheHeader header{};
+    in.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!in || std::memcmp(header.magic, kIdentifierMagic, sizeof(kIdentifierMagic)) != 0 ||
+        header.version != kIdentifierVersion ||
+        std::memcmp(header.algorithmUUID, m_identifierAlgorithm.data(), VK_UUID_SIZE) != 0)
+    {
+        // 驱动或算法变化：旧标识不再有效，下次保存时整体覆盖
+        m_identifiersDirty = true;
+        return;
+    }
+
+    for (uint32_t i = 0; i < header.entryCount; ++i)
+    {
+        IdentifierCacheEntry entry{};
+        in.read(reinterpret_cast<char *>(&entry), sizeof(entry));
+        if (!in || entry.identifierSize == 0 || entry.identifierSize > VK_MAX_SHADER_MODULE_IDENTIFIER_SIZE_EXT)
+        {
+            break;
+        }
+        m_identifiers[entry.contentHash].assign(entry.identifier, entry.identifier + entry.identifierSize);
+    }
+}
+
+ShaderManager::Stats ShaderManager::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.moduleCount = static_cast<uint32_t>(m_shaderModules.size());
+    stats.packageCount = static_cast<uint32_t>(m_packages.size());
+    stats.cachedIdentifiers = static_cast<uint32_t>(m_identifiers.size());
+    return stats;
+}
+
 void ShaderManager::cleanup()
 {
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -82,10 +325,10 @@ void ShaderManager::cleanup()
     m_shaderModules.clear();
 }
 
-vk::ShaderModule ShaderManager::createshadermodule(const std::vector<uint32_t> &code)
+vk::ShaderModule ShaderManager::createshadermodule(std::span<const uint32_t> code)
 {
     vk::ShaderModuleCreateInfo createInfo = {};
-    createInfo.codeSize = code.size() * sizeof(uint32_t);
+    createInfo.codeSize = code.size_bytes();
     createInfo.pCode = code.data();
 
     vk::ShaderModule shaderModule;
@@ -98,6 +341,7 @@ vk::ShaderModule ShaderManager::createshadermodule(const std::vector<uint32_t> &
         throw std::runtime_error("Failed to create shader module: " + std::string(e.what()));
     }
 
+    ++m_stats.createdModules;
     return shaderModule;
 }
-} // namespace vkcore
\ No newline at end of file
+} // namespace vkcore
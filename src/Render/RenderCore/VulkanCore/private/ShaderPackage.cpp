@@ -0,0 +1,257 @@
+/**
+ * @file ShaderPackage.cpp
+ * @brief ShaderPackage 实现
+ */
+
+#include "ShaderPackage.hpp"
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace vkcore
+{
+
+namespace
+{
+
+constexpr char kMagic[4] = {'Q', 'T', 'S', 'P'};
+constexpr uint64_t kSectionAlignment = 16;
+constexpr uint32_t kSpirvMagic = 0x07230203;
+
+static_assert(std::is_trivially_copyable_v<ShaderPackageHeader> && sizeof(ShaderPackageHeader) == 32,
+              "ShaderPackageHeader layout is part of the file format");
+static_assert(std::is_trivially_copyable_v<ShaderPackageEntry> && sizeof(ShaderPackageEntry) == 48,
+              "ShaderPackageEntry layout is part of the file format");
+
+uint64_t alignup(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief 区间 [offset, offset + size) 是否完整地落在文件内
+ */
+bool rangefits(uint64_t offset, uint64_t size, uint64_t fileSize)
+{
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+void writepadding(std::ofstream &out, uint64_t &position)
+{
+    static const char zeros[kSectionAlignment] = {};
+    uint64_t aligned = alignup(position, kSectionAlignment);
+    out.write(zeros, static_cast<std::streamsize>(aligned - position));
+    position = aligned;
+}
+
+} // namespace
+
+ShaderPackage::ShaderPackage(const std::filesystem::path &filePath)
+    : m_path(filePath), m_file(std::make_unique<MappedFile>(filePath))
+{
+    const uint64_t fileSize = m_file->size();
+    const std::string error = "ShaderPackage: invalid package " + filePath.string();
+    if (fileSize < sizeof(ShaderPackageHeader))
+    {
+        throw std::runtime_error(error);
+    }
+
+    ShaderPackageHeader header;
+    std::memcpy(&header, m_file->data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion)
+    {
+        throw std::runtime_error(error + " (magic or version mismatch)");
+    }
+    if (header.entryOffset % kSectionAlignment != 0 ||
+        !rangefits(header.entryOffset, uint64_t(header.entryCount) * sizeof(ShaderPackageEntry), fileSize) ||
+        header.stringOffset > fileSize)
+    {
+        throw std::runtime_error(error + " (truncated index)");
+    }
+
+    // 映射起始地址按页对齐，索引表可以原地访问
+    m_entries = reinterpret_cast<const ShaderPackageEntry *>(m_file->data() + header.entryOffset);
+    m_strings = m_file->data() + header.stringOffset;
+    m_entryCount = header.entryCount;
+
+    // 只校验索引表（O(模块数)），SPIR-V 本身在首次使用时才被读入
+    const uint64_t stringSize = fileSize - header.stringOffset;
+    for (uint32_t i = 0; i < m_entryCount; ++i)
+    {
+        const ShaderPackageEntry &entry = m_entries[i];
+        if (!rangefits(entry.nameOffset, entry.nameLength, stringSize) || entry.codeSize == 0 ||
+            entry.codeSize % sizeof(uint32_t) != 0 || entry.codeOffset % sizeof(uint32_t) != 0 ||
+            !rangefits(entry.codeOffset, entry.codeSize, fileSize) ||
+            !rangefits(entry.reflectionOffset, entry.reflectionSize, fileSize))
+        {
+            throw std::runtime_error(error + " (entry " + std::to_string(i) + " out of range)");
+        }
+    }
+}
+
+ShaderPackage::~ShaderPackage() = default;
+
+ShaderPackage::Entry ShaderPackage::getEntry(uint32_t index) const
+{
+    if (index >= m_entryCount)
+    {
+        throw std::out_of_range("ShaderPackage::getEntry: index out of range");
+    }
+
+    const ShaderPackageEntry &entry = m_entries[index];
+    Entry view;
+    view.name = std::string_view(m_strings + entry.nameOffset, entry.nameLength);
+    view.stage = static_cast<vk::ShaderStageFlagBits>(entry.stage);
+    view.code = std::span<const uint32_t>(reinterpret_cast<const uint32_t *>(m_file->data() + entry.codeOffset),
+                                          entry.codeSize / sizeof(uint32_t));
+    view.reflection = std::span<const uint8_t>(
+        reinterpret_cast<const uint8_t *>(m_file->data() + entry.reflectionOffset), entry.reflectionSize);
+    view.contentHash = entry.contentHash;
+    return view;
+}
+
+std::optional<ShaderPackage::Entry> ShaderPackage::find(std::string_view name) const
+{
+    auto nameof = [this](const ShaderPackageEntry &entry) {
+        return std::string_view(m_strings + entry.nameOffset, entry.nameLength);
+    };
+
+    const ShaderPackageEntry *end = m_entries + m_entryCount;
+    const ShaderPackageEntry *it =
+        std::lower_bound(m_entries, end, name,
+                         [&](const ShaderPackageEntry &entry, std::string_view key) { return nameof(entry) < key; });
+    if (it == end || nameof(*it) != name)
+    {
+        return std::nullopt;
+    }
+    return getEntry(static_cast<uint32_t>(it - m_entries));
+}
+
+uint64_t ShaderPackage::hashCode(std::span<const uint32_t> code)
+{
+    // FNV-1a 64 位
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(code.data());
+    uint64_t hash = 1469598103934665603ull;
+    for (size_t i = 0; i < code.size_bytes(); ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool ShaderPackage::write(const std::filesystem::path &filePath, std::span<const ShaderPackageSource> sources)
+{
+    // 索引表按名称排序，运行时二分查找
+    std::vector<const ShaderPackageSource *> sorted;
+    sorted.reserve(sources.size());
+    for (const ShaderPackageSource &source : sources)
+    {
+        if (source.name.empty() || source.code.empty())
+        {
+            throw std::invalid_argument("ShaderPackage::write: empty shader name or code");
+        }
+        if (source.code[0] != kSpirvMagic)
+        {
+            throw std::invalid_argument("ShaderPackage::write: " + source.name + " is not SPIR-V");
+        }
+        sorted.push_back(&source);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const ShaderPackageSource *a, const ShaderPackageSource *b) {
+        return a->name < b->name;
+    });
+    for (size_t i = 1; i < sorted.size(); ++i)
+    {
+        if (sorted[i - 1]->name == sorted[i]->name)
+        {
+            throw std::invalid_argument("ShaderPackage::write: duplicate shader name " + sorted[i]->name);
+        }
+    }
+
+    ShaderPackageHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.entryCount = static_cast<uint32_t>(sorted.size());
+    header.entryOffset = sizeof(ShaderPackageHeader);
+    header.stringOffset = header.entryOffset + sorted.size() * sizeof(ShaderPackageEntry);
+
+    // 先确定各段偏移，再顺序写出
+    std::vector<ShaderPackageEntry> entries(sorted.size());
+    uint64_t stringSize = 0;
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        entries[i].nameOffset = static_cast<uint32_t>(stringSize);
+        entries[i].nameLength = static_cast<uint32_t>(sorted[i]->name.size());
+        stringSize += sorted[i]->name.size() + 1;
+    }
+    uint64_t position = alignup(header.stringOffset + stringSize, kSectionAlignment);
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        const ShaderPackageSource &source = *sorted[i];
+        ShaderPackageEntry &entry = entries[i];
+        entry.stage = static_cast<uint32_t>(source.stage);
+        entry.codeSize = static_cast<uint32_t>(source.code.size_bytes());
+        entry.codeOffset = position;
+        position = alignup(position + entry.codeSize, kSectionAlignment);
+        entry.reflectionSize = static_cast<uint32_t>(source.reflection.size());
+        entry.reflectionOffset = position;
+        position = alignup(position + entry.reflectionSize, kSectionAlignment);
+        entry.contentHash = hashCode(source.code);
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(filePath.parent_path(), ec);
+
+    std::filesystem::path tempPath = filePath;
+    tempPath += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+
+        position = 0;
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(entries.data()),
+                  static_cast<std::streamsize>(entries.size() * sizeof(ShaderPackageEntry)));
+        for (const ShaderPackageSource *source : sorted)
+        {
+            out.write(source->name.c_str(), static_cast<std::streamsize>(source->name.size() + 1));
+        }
+        position = header.stringOffset + stringSize;
+        writepadding(out, position);
+
+        for (size_t i = 0; i < sorted.size(); ++i)
+        {
+            out.write(reinterpret_cast<const char *>(sorted[i]->code.data()), entries[i].codeSize);
+            position += entries[i].codeSize;
+            writepadding(out, position);
+            out.write(reinterpret_cast<const char *>(sorted[i]->reflection.data()), entries[i].reflectionSize);
+            position += entries[i].reflectionSize;
+            writepadding(out, position);
+        }
+
+        if (!out)
+        {
+            out.close();
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, filePath, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace vkcore
@@ -0,0 +1,565 @@
+/**
+ * @file ShaderReflection.cpp
+ * @brief ShaderReflection 实现
+ */
+
+#include "ShaderReflection.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace vkcore
+{
+
+namespace
+{
+
+// SPIR-V 常量（SPIR-V 1.6 规范，只列出反射需要的部分）
+constexpr uint32_t kSpirvMagic = 0x07230203;
+constexpr size_t kHeaderWords = 5;
+constexpr uint32_t kMaxIdBound = 1u << 22; ///< 防止损坏的头部导致巨量分配
+constexpr uint32_t kMaxTypeDepth = 32;     ///< 类型嵌套深度上限（防止循环引用）
+
+constexpr uint32_t kOpTypeBool = 20;
+constexpr uint32_t kOpTypeInt = 21;
+constexpr uint32_t kOpTypeFloat = 22;
+constexpr uint32_t kOpTypeVector = 23;
+constexpr uint32_t kOpTypeMatrix = 24;
+constexpr uint32_t kOpTypeImage = 25;
+constexpr uint32_t kOpTypeSampler = 26;
+constexpr uint32_t kOpTypeSampledImage = 27;
+constexpr uint32_t kOpTypeArray = 28;
+constexpr uint32_t kOpTypeRuntimeArray = 29;
+constexpr uint32_t kOpTypeStruct = 30;
+constexpr uint32_t kOpTypePointer = 32;
+constexpr uint32_t kOpConstant = 43;
+constexpr uint32_t kOpSpecConstantTrue = 48;
+constexpr uint32_t kOpSpecConstantFalse = 49;
+constexpr uint32_t kOpSpecConstant = 50;
+constexpr uint32_t kOpVariable = 59;
+constexpr uint32_t kOpDecorate = 71;
+constexpr uint32_t kOpMemberDecorate = 72;
+constexpr uint32_t kOpTypeAccelerationStructureKHR = 5341;
+
+constexpr uint32_t kDecorationSpecId = 1;
+constexpr uint32_t kDecorationBufferBlock = 3;
+constexpr uint32_t kDecorationArrayStride = 6;
+constexpr uint32_t kDecorationMatrixStride = 7;
+constexpr uint32_t kDecorationBinding = 33;
+constexpr uint32_t kDecorationDescriptorSet = 34;
+constexpr uint32_t kDecorationOffset = 35;
+
+constexpr uint32_t kStorageUniformConstant = 0;
+constexpr uint32_t kStorageUniform = 2;
+constexpr uint32_t kStoragePushConstant = 9;
+constexpr uint32_t kStorageStorageBuffer = 12;
+
+constexpr uint32_t kDimBuffer = 5;
+constexpr uint32_t kDimSubpassData = 6;
+
+constexpr char kSerializedMagic[4] = {'Q', 'T', 'S', 'R'};
+constexpr uint32_t kSerializedVersion = 1;
+
+/**
+ * @struct IdInfo
+ * @brief 一个 SPIR-V id 的定义指令与装饰
+ */
+struct IdInfo
+{
+    std::span<const uint32_t> instruction; ///< 定义该 id 的指令（含首字）
+    uint32_t set{0};
+    uint32_t binding{0};
+    uint32_t specId{0};
+    uint32_t arrayStride{0};
+    bool hasSet{false};
+    bool hasBinding{false};
+    bool hasSpecId{false};
+    bool bufferBlock{false};
+    std::vector<uint32_t> memberOffsets;
+    std::vector<uint32_t> memberMatrixStrides;
+
+    uint32_t opcode() const
+    {
+        return instruction.empty() ? 0 : (instruction[0] & 0xffff);
+    }
+};
+
+/**
+ * @class SpirvModule
+ * @brief 一次扫描建立 id 表，之后按需解析类型
+ */
+class SpirvModule
+{
+  public:
+    explicit SpirvModule(std::span<const uint32_t> code)
+    {
+        if (code.size() < kHeaderWords || code[0] != kSpirvMagic)
+        {
+            throw std::invalid_argument("ShaderReflection: not a SPIR-V module");
+        }
+        const uint32_t bound = code[3];
+        if (bound == 0 || bound > kMaxIdBound)
+        {
+            throw std::invalid_argument("ShaderReflection: invalid id bound");
+        }
+        m_ids.resize(bound);
+
+        size_t position = kHeaderWords;
+        while (position < code.size())
+        {
+            const uint32_t wordCount = code[position] >> 16;
+            const uint32_t opcode = code[position] & 0xffff;
+            if (wordCount == 0 || position + wordCount > code.size())
+            {
+                throw std::invalid_argument("ShaderReflection: truncated instruction");
+            }
+            parseinstruction(opcode, code.subspan(position, wordCount));
+            position += wordCount;
+        }
+    }
+
+    const IdInfo &get(uint32_t id) const
+    {
+        if (id >= m_ids.size())
+        {
+            throw std::invalid_argument("ShaderReflection: id out of range");
+        }
+        return m_ids[id];
+    }
+
+    const std::vector<uint32_t> &getVariables() const
+    {
+        return m_variables;
+    }
+
+    const std::vector<uint32_t> &getSpecConstants() const
+    {
+        return m_specConstants;
+    }
+
+    /**
+     * @brief 读取指令的第 index 个字（越界视为损坏）
+     */
+    static uint32_t word(std::span<const uint32_t> instruction, size_t index)
+    {
+        if (index >= instruction.size())
+        {
+            throw std::invalid_argument("ShaderReflection: malformed instruction");
+        }
+        return instruction[index];
+    }
+
+    /**
+     * @brief 常量的值（数组长度；特化常量取默认值）
+     */
+    uint32_t constantvalue(uint32_t id) const
+    {
+        const IdInfo &info = get(id);
+        if (info.opcode() != kOpConstant && info.opcode() != kOpSpecConstant)
+        {
+            throw std::invalid_argument("ShaderReflection: array length is not a constant");
+        }
+        return word(info.instruction, 3);
+    }
+
+    /**
+     * @brief 类型的字节数（按 Offset / ArrayStride / MatrixStride 装饰计算，与块布局一致）
+     */
+    uint32_t typesize(uint32_t typeId, uint32_t matrixStride = 0, uint32_t depth = 0) const
+    {
+        if (depth > kMaxTypeDepth)
+        {
+            throw std::invalid_argument("ShaderReflection: type nesting too deep");
+        }
+        const IdInfo &info = get(typeId);
+        const std::span<const uint32_t> instruction = info.instruction;
+        switch (info.opcode())
+        {
+        case kOpTypeBool:
+            return 4;
+        case kOpTypeInt:
+        case kOpTypeFloat:
+            return word(instruction, 2) / 8;
+        case kOpTypeVector:
+            return word(instruction, 3) * typesize(word(instruction, 2), 0, depth + 1);
+        case kOpTypeMatrix: {
+            const uint32_t columnSize = typesize(word(instruction, 2), 0, depth + 1);
+            return word(instruction, 3) * std::max(matrixStride, columnSize);
+        }
+        case kOpTypeArray: {
+            const uint32_t length = constantvalue(word(instruction, 3));
+            const uint32_t stride =
+                info.arrayStride != 0 ? info.arrayStride : typesize(word(instruction, 2), matrixStride, depth + 1);
+            return length * stride;
+        }
+        case kOpTypeStruct: {
+            uint32_t size = 0;
+            for (size_t member = 2; member < instruction.size(); ++member)
+            {
+                const size_t index = member - 2;
+                const uint32_t offset = index < info.memberOffsets.size() ? info.memberOffsets[index] : 0;
+                const uint32_t stride = index < info.memberMatrixStrides.size() ? info.memberMatrixStrides[index] : 0;
+                size = std::max(size, offset + typesize(instruction[member], stride, depth + 1));
+            }
+            return size;
+        }
+        default:
+            return 0; // 运行时数组等没有固定大小
+        }
+    }
+
+  private:
+    IdInfo &at(uint32_t id)
+    {
+        if (id >= m_ids.size())
+        {
+            throw std::invalid_argument("ShaderReflection: id out of range");
+        }
+        return m_ids[id];
+    }
+
+    static void setmember(std::vector<uint32_t> &values, uint32_t member, uint32_t value)
+    {
+        if (member >= values.size())
+        {
+            values.resize(static_cast<size_t>(member) + 1, 0);
+        }
+        values[member] = value;
+    }
+
+    void parseinstruction(uint32_t opcode, std::span<const uint32_t> instruction)
+    {
+        switch (opcode)
+        {
+        case kOpDecorate: {
+            IdInfo &info = at(word(instruction, 1));
+            const uint32_t decoration = word(instruction, 2);
+            if (decoration == kDecorationDescriptorSet)
+            {
+                info.set = word(instruction, 3);
+                info.hasSet = true;
+            }
+            else if (decoration == kDecorationBinding)
+            {
+                info.binding = word(instruction, 3);
+                info.hasBinding = true;
+            }
+            else if (decoration == kDecorationSpecId)
+            {
+                info.specId = word(instruction, 3);
+                info.hasSpecId = true;
+            }
+            else if (decoration == kDecorationArrayStride)
+            {
+                info.arrayStride = word(instruction, 3);
+            }
+            else if (decoration == kDecorationBufferBlock)
+            {
+                info.bufferBlock = true;
+            }
+            break;
+        }
+        case kOpMemberDecorate: {
+            IdInfo &info = at(word(instruction, 1));
+            const uint32_t member = word(instruction, 2);
+            const uint32_t decoration = word(instruction, 3);
+            if (member > kMaxIdBound)
+            {
+                throw std::invalid_argument("ShaderReflection: member index out of range");
+            }
+            if (decoration == kDecorationOffset)
+            {
+                setmember(info.memberOffsets, member, word(instruction, 4));
+            }
+            else if (decoration == kDecorationMatrixStride)
+            {
+                setmember(info.memberMatrixStrides, member, word(instruction, 4));
+            }
+            break;
+        }
+        case kOpTypeBool:
+        case kOpTypeInt:
+        case kOpTypeFloat:
+        case kOpTypeVector:
+        case kOpTypeMatrix:
+        case kOpTypeImage:
+        case kOpTypeSampler:
+        case kOpTypeSampledImage:
+        case kOpTypeArray:
+        case kOpTypeRuntimeArray:
+        case kOpTypeStruct:
+        case kOpTypePointer:
+        case kOpTypeAccelerationStructureKHR:
+            at(word(instruction, 1)).instruction = instruction;
+            break;
+        case kOpConstant:
+            at(word(instruction, 2)).instruction = instruction;
+            break;
+        case kOpSpecConstantTrue:
+        case kOpSpecConstantFalse:
+        case kOpSpecConstant:
+            at(word(instruction, 2)).instruction = instruction;
+            m_specConstants.push_back(word(instruction, 2));
+            break;
+        case kOpVariable:
+            at(word(instruction, 2)).instruction = instruction;
+            m_variables.push_back(word(instruction, 2));
+            break;
+        default:
+            break;
+        }
+    }
+
+  private:
+    std::vector<IdInfo> m_ids;
+    std::vector<uint32_t> m_variables;     ///< 所有 OpVariable 的 id
+    std::vector<uint32_t> m_specConstants; ///< 所有特化常量的 id
+};
+
+/**
+ * @brief 由资源变量的类型推导描述符类型
+ * @return 不是描述符资源时返回空
+ */
+std::optional<vk::DescriptorType> descriptortype(const SpirvModule &module, uint32_t typeId, uint32_t storageClass)
+{
+    const IdInfo &info = module.get(typeId);
+    const std::span<const uint32_t> instruction = info.instruction;
+    switch (info.opcode())
+    {
+    case kOpTypeSampler:
+        return vk::DescriptorType::eSampler;
+    case kOpTypeSampledImage:
+        return vk::DescriptorType::eCombinedImageSampler;
+    case kOpTypeImage: {
+        const uint32_t dim = SpirvModule::word(instruction, 3);
+        const bool storage = SpirvModule::word(instruction, 7) == 2;
+        if (dim == kDimBuffer)
+        {
+            return storage ? vk::DescriptorType::eStorageTexelBuffer : vk::DescriptorType::eUniformTexelBuffer;
+        }
+        if (dim == kDimSubpassData)
+        {
+            return vk::DescriptorType::eInputAttachment;
+        }
+        return storage ? vk::DescriptorType::eStorageImage : vk::DescriptorType::eSampledImage;
+    }
+    case kOpTypeStruct:
+        if (storageClass == kStorageStorageBuffer || info.bufferBlock)
+        {
+            return vk::DescriptorType::eStorageBuffer;
+        }
+        if (storageClass == kStorageUniform)
+        {
+            return vk::DescriptorType::eUniformBuffer;
+        }
+        return std::nullopt;
+    case kOpTypeAccelerationStructureKHR:
+        return vk::DescriptorType::eAccelerationStructureKHR;
+    default:
+        return std::nullopt;
+    }
+}
+
+void appendword(std::vector<uint8_t> &data, uint32_t value)
+{
+    const size_t offset = data.size();
+    data.resize(offset + sizeof(uint32_t));
+    std::memcpy(data.data() + offset, &value, sizeof(uint32_t));
+}
+
+bool readword(std::span<const uint8_t> data, size_t &offset, uint32_t &value)
+{
+    if (data.size() < sizeof(uint32_t) || offset > data.size() - sizeof(uint32_t))
+    {
+        return false;
+    }
+    std::memcpy(&value, data.data() + offset, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    return true;
+}
+
+} // namespace
+
+ShaderReflection ShaderReflection::reflect(std::span<const uint32_t> code, vk::ShaderStageFlagBits stage)
+{
+    const SpirvModule module(code);
+
+    ShaderReflection reflection;
+    reflection.stage = stage;
+
+    uint32_t pushBegin = std::numeric_limits<uint32_t>::max();
+    uint32_t pushEnd = 0;
+    for (uint32_t variableId : module.getVariables())
+    {
+        const IdInfo &variable = module.get(variableId);
+        const uint32_t storageClass = SpirvModule::word(variable.instruction, 3);
+
+        // 变量的类型总是指针，指向实际的资源类型
+        const IdInfo &pointer = module.get(SpirvModule::word(variable.instruction, 1));
+        if (pointer.opcode() != kOpTypePointer)
+        {
+            continue;
+        }
+        uint32_t typeId = SpirvModule::word(pointer.instruction, 3);
+
+        if (storageClass == kStoragePushConstant)
+        {
+            // 推送常量块：范围从第一个成员的偏移到最后一个成员的末尾
+            const IdInfo &block = module.get(typeId);
+            const uint32_t size = module.typesize(typeId);
+            uint32_t begin = 0;
+            if (!block.memberOffsets.empty())
+            {
+                begin = *std::min_element(block.memberOffsets.begin(), block.memberOffsets.end());
+            }
+            pushBegin = std::min(pushBegin, begin);
+            pushEnd = std::max(pushEnd, size);
+            continue;
+        }
+        if (storageClass != kStorageUniformConstant && storageClass != kStorageUniform &&
+            storageClass != kStorageStorageBuffer)
+        {
+            continue;
+        }
+        if (!variable.hasBinding)
+        {
+            continue;
+        }
+
+        // 展开描述符数组
+        Binding binding;
+        binding.set = variable.hasSet ? variable.set : 0;
+        binding.binding = variable.binding;
+        for (uint32_t depth = 0;; ++depth)
+        {
+            const IdInfo &type = module.get(typeId);
+            if (depth > kMaxTypeDepth)
+            {
+                throw std::invalid_argument("ShaderReflection: type nesting too deep");
+            }
+            if (type.opcode() == kOpTypeArray)
+            {
+                binding.count *= module.constantvalue(SpirvModule::word(type.instruction, 3));
+                typeId = SpirvModule::word(type.instruction, 2);
+            }
+            else if (type.opcode() == kOpTypeRuntimeArray)
+            {
+                binding.count = 0;
+                typeId = SpirvModule::word(type.instruction, 2);
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        if (std::optional<vk::DescriptorType> type = descriptortype(module, typeId, storageClass))
+        {
+            binding.type = *type;
+            reflection.bindings.push_back(binding);
+        }
+    }
+
+    if (pushEnd > 0)
+    {
+        // VkPushConstantRange 的偏移与大小都必须是 4 的倍数
+        reflection.pushConstantOffset = pushBegin & ~3u;
+        reflection.pushConstantSize = ((pushEnd + 3u) & ~3u) - reflection.pushConstantOffset;
+    }
+
+    for (uint32_t constantId : module.getSpecConstants())
+    {
+        const IdInfo &constant = module.get(constantId);
+        if (!constant.hasSpecId)
+        {
+            continue;
+        }
+        SpecializationConstant specialization;
+        specialization.id = constant.specId;
+        specialization.size = module.typesize(SpirvModule::word(constant.instruction, 1));
+        reflection.specializationConstants.push_back(specialization);
+    }
+
+    std::sort(reflection.bindings.begin(), reflection.bindings.end(), [](const Binding &a, const Binding &b) {
+        return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+    });
+    std::sort(reflection.specializationConstants.begin(), reflection.specializationConstants.end(),
+              [](const SpecializationConstant &a, const SpecializationConstant &b) { return a.id < b.id; });
+    return reflection;
+}
+
+std::vector<uint8_t> ShaderReflection::serialize() const
+{
+    std::vector<uint8_t> data(kSerializedMagic, kSerializedMagic + sizeof(kSerializedMagic));
+    appendword(data, kSerializedVersion);
+    appendword(data, static_cast<uint32_t>(stage));
+    appendword(data, pushConstantOffset);
+    appendword(data, pushConstantSize);
+    appendword(data, static_cast<uint32_t>(bindings.size()));
+    for (const Binding &binding : bindings)
+    {
+        appendword(data, binding.set);
+        appendword(data, binding.binding);
+        appendword(data, static_cast<uint32_t>(binding.type));
+        appendword(data, binding.count);
+    }
+    appendword(data, static_cast<uint32_t>(specializationConstants.size()));
+    for (const SpecializationConstant &constant : specializationConstants)
+    {
+        appendword(data, constant.id);
+        appendword(data, constant.size);
+    }
+    return data;
+}
+
+std::optional<ShaderReflection> ShaderReflection::deserialize(std::span<const uint8_t> data)
+{
+    if (data.size() < sizeof(kSerializedMagic) || std::memcmp(data.data(), kSerializedMagic, sizeof(kSerializedMagic)))
+    {
+        return std::nullopt;
+    }
+
+    size_t offset = sizeof(kSerializedMagic);
+    uint32_t version = 0;
+    uint32_t stage = 0;
+    uint32_t bindingCount = 0;
+    ShaderReflection reflection;
+    if (!readword(data, offset, version) || version != kSerializedVersion || !readword(data, offset, stage) ||
+        !readword(data, offset, reflection.pushConstantOffset) ||
+        !readword(data, offset, reflection.pushConstantSize) || !readword(data, offset, bindingCount) ||
+        bindingCount > data.size() / (4 * sizeof(uint32_t)))
+    {
+        return std::nullopt;
+    }
+    reflection.stage = static_cast<vk::ShaderStageFlagBits>(stage);
+
+    reflection.bindings.resize(bindingCount);
+    for (Binding &binding : reflection.bindings)
+    {
+        uint32_t type = 0;
+        if (!readword(data, offset, binding.set) || !readword(data, offset, binding.binding) ||
+            !readword(data, offset, type) || !readword(data, offset, binding.count))
+        {
+            return std::nullopt;
+        }
+        binding.type = static_cast<vk::DescriptorType>(type);
+    }
+
+    uint32_t constantCount = 0;
+    if (!readword(data, offset, constantCount) || constantCount > data.size() / (2 * sizeof(uint32_t)))
+    {
+        return std::nullopt;
+    }
+    reflection.specializationConstants.resize(constantCount);
+    for (SpecializationConstant &constant : reflection.specializationConstants)
+    {
+        if (!readword(data, offset, constant.id) || !readword(data, offset, constant.size))
+        {
+            return std::nullopt;
+        }
+    }
+    return reflection;
+}
+
+} // namespace vkcore
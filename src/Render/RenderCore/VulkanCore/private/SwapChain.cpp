@@ -9,31 +9,90 @@
  */
 
 #include "SwapChain.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <stdexcept>
 
 namespace vkcore
 {
-SwapChain::SwapChain(vk::SurfaceKHR surface, Device &device, VmaAllocator allocator)
-    : m_surface(surface), m_device(device), m_allocator(allocator)
+
+namespace
+{
+
+// 阻塞等待上屏的超时：窗口被遮挡时呈现可能一直不上屏，超时后放弃这一帧的等待
+constexpr uint64_t kPresentWaitTimeoutNs = 100'000'000;
+
+// 延迟滑动平均的权重
+constexpr double kLatencySmoothing = 0.1;
+
+} // namespace
+
+SwapChain::SwapChain(vk::SurfaceKHR surface, Device &device, VmaAllocator allocator, uint32_t framesInFlight,
+                     const PresentPolicy &policy)
+    : m_device(device), m_surface(surface), m_allocator(allocator), m_policy(policy)
 {
+    // present wait 依赖 present id：呈现时附带 ID，之后按 ID 等待上屏
+    if (device.isExtensionEnabled(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+        device.isExtensionEnabled(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+    {
+        m_waitForPresent =
+            reinterpret_cast<PFN_vkWaitForPresentKHR>(device.get().getProcAddr("vkWaitForPresentKHR"));
+    }
+
+    // 时间线从第 1 帧开始，第一次等待发生在第 framesInFlight + 1 帧
+    m_ownedTimeline = std::make_unique<FrameTimeline>(device.get(), framesInFlight);
+    m_timeline = m_ownedTimeline.get();
+    m_retiredQueue = std::make_unique<DeferredDeletionQueue>(*m_timeline);
+    m_timeline->beginFrame();
+    init();
+}
+
+SwapChain::SwapChain(vk::SurfaceKHR surface, Device &device, VmaAllocator allocator, FrameTimeline &timeline,
+                     const PresentPolicy &policy)
+    : m_timeline(&timeline), m_device(device), m_surface(surface), m_allocator(allocator), m_policy(policy)
+{
+    if (device.isExtensionEnabled(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+        device.isExtensionEnabled(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+    {
+        m_waitForPresent =
+            reinterpret_cast<PFN_vkWaitForPresentKHR>(device.get().getProcAddr("vkWaitForPresentKHR"));
+    }
+
+    // 图像使用记录以 0 表示未使用，帧号必须从 1 开始
+    m_retiredQueue = std::make_unique<DeferredDeletionQueue>(*m_timeline);
+    if (m_timeline->getFrameNumber() == 0)
+    {
+        m_timeline->beginFrame();
+    }
     init();
 }
 
 SwapChain::~SwapChain()
 {
+    // 信号量可能仍被已提交的帧引用
+    m_device.get().waitIdle();
     cleanup();
 }
 
 vk::Result SwapChain::acquireNextImage(uint32_t &imageIndex)
 {
-    // 1. 等待当前帧的栅栏（确保这一帧的命令缓冲区不再使用）
-    [[maybe_unused]] vk::Result waitResult =
-        m_device.get().waitForFences(1, &m_FlightFences[m_currentFrameIndex], VK_TRUE, UINT64_MAX);
+    QTR_PROFILE_SCOPE("SwapChain::acquireNextImage");
+    // 1. 执行到期的重建请求；此时本帧尚未获取图像，旧交换链上没有未呈现的图像
+    if (m_recreatePending && std::chrono::steady_clock::now() >= m_recreateDue && !recreate())
+    {
+        return vk::Result::eErrorOutOfDateKHR;
+    }
+
+    // 2. 限制排队帧数：在录制本帧之前等待较早的帧上屏，输入采样因此更接近上屏时刻
+    throttle();
+    m_acquireTime = std::chrono::steady_clock::now();
 
-    // 2. 获取下一个图像索引（使用 per-frame 的 imageAvailable 信号量）
+    // 3. 获取下一个图像索引（使用 per-frame 的 imageAvailable 信号量）
+    //    当前帧索引的上一次使用已在 advanceToNextFrame() 中等待完成
     vk::Result result = m_device.get().acquireNextImageKHR(
-        m_swapchain, UINT64_MAX, m_imageAvailableSemaphores[m_currentFrameIndex], nullptr, &imageIndex);
+        m_swapchain, UINT64_MAX, m_imageAvailableSemaphores[m_timeline->getFrameSlot()], nullptr, &imageIndex);
 
-    // 如果交换链过期，需要重建
+    // 如果交换链过期，立即重建（获取失败时信号量未被触发，可以直接复用）
     if (result == vk::Result::eErrorOutOfDateKHR)
     {
         recreate();
@@ -44,24 +103,22 @@ vk::Result SwapChain::acquireNextImage(uint32_t &imageIndex)
         throw std::runtime_error("Failed to acquire swap chain image!");
     }
 
-    // 3. 如果这个图像还在被使用，等待它完成
-    if (m_imagesInFlight[imageIndex])
+    // 4. 如果这个图像还在被之前的帧使用，等待那一帧完成
+    if (m_imagesInFlight[imageIndex] != 0 && !m_timeline->wait(m_imagesInFlight[imageIndex]))
     {
-        [[maybe_unused]] vk::Result imageWaitResult =
-            m_device.get().waitForFences(1, &m_imagesInFlight[imageIndex], VK_TRUE, UINT64_MAX);
+        throw std::runtime_error("Failed to wait for swap chain image!");
     }
 
-    // 4. 标记这个图像现在由当前帧使用
-    m_imagesInFlight[imageIndex] = m_FlightFences[m_currentFrameIndex];
-
-    // 5. 重置当前帧的栅栏
-    [[maybe_unused]] vk::Result resetResult = m_device.get().resetFences(1, &m_FlightFences[m_currentFrameIndex]);
+    // 5. 标记这个图像现在由当前帧使用
+    m_imagesInFlight[imageIndex] = m_timeline->getFrameNumber();
 
     return result;
 }
 
-vk::Result SwapChain::present(vk::Semaphore renderFinishedSemaphore, uint32_t imageIndex)
+vk::Result SwapChain::present(vk::Semaphore renderFinishedSemaphore, uint32_t imageIndex,
+                              std::chrono::steady_clock::time_point inputTime)
 {
+    QTR_PROFILE_SCOPE("SwapChain::present");
     vk::PresentInfoKHR presentInfo = {};
     presentInfo.waitSemaphoreCount = 1;
     presentInfo.pWaitSemaphores = &renderFinishedSemaphore;
@@ -69,22 +126,213 @@ vk::Result SwapChain::present(vk::Semaphore renderFinishedSemaphore, uint32_t im
     presentInfo.pSwapchains = &m_swapchain;
     presentInfo.pImageIndices = &imageIndex;
 
-    vk::Result result = m_device.getPresentQueue().presentKHR(presentInfo);
+    // 帧号在时间线上单调递增，直接作为呈现 ID
+    const uint64_t presentId = m_timeline->getFrameNumber();
+    vk::PresentIdKHR presentIdInfo{};
+    presentIdInfo.swapchainCount = 1;
+    presentIdInfo.pPresentIds = &presentId;
+    if (m_waitForPresent)
+    {
+        presentInfo.pNext = &presentIdInfo;
+    }
+
+    // 指针重载返回结果码而不抛出，过期与次优一样走下面的重建路径
+    vk::Result result;
+    {
+        const vk::Queue presentQueue = m_device.getPresentQueue();
+        std::lock_guard<std::mutex> queueLock(m_device.getQueueMutex(presentQueue));
+        result = presentQueue.presentKHR(&presentInfo);
+    }
+    finishpresent(result, presentId, inputTime);
+    return result;
+}
+
+void SwapChain::presentAll(std::span<const SwapChainPresent> presents, std::span<vk::Result> results)
+{
+    QTR_PROFILE_SCOPE("SwapChain::presentAll");
+    if (presents.empty())
+    {
+        return;
+    }
+    if (!results.empty() && results.size() < presents.size())
+    {
+        throw std::invalid_argument("SwapChain::presentAll: results is smaller than presents");
+    }
 
-    if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR)
+    std::vector<vk::Semaphore> waitSemaphores;
+    std::vector<vk::SwapchainKHR> swapchains;
+    std::vector<uint32_t> imageIndices;
+    std::vector<uint64_t> presentIds;
+    std::vector<vk::Result> presentResults(presents.size(), vk::Result::eSuccess);
+    waitSemaphores.reserve(presents.size());
+    swapchains.reserve(presents.size());
+    imageIndices.reserve(presents.size());
+    presentIds.reserve(presents.size());
+    for (const SwapChainPresent &present : presents)
+    {
+        if (!present.swapchain)
+        {
+            throw std::invalid_argument("SwapChain::presentAll: swapchain is null");
+        }
+        waitSemaphores.push_back(present.renderFinishedSemaphore);
+        swapchains.push_back(present.swapchain->m_swapchain);
+        imageIndices.push_back(present.imageIndex);
+        presentIds.push_back(present.swapchain->m_timeline->getFrameNumber());
+    }
+
+    vk::PresentInfoKHR presentInfo = {};
+    presentInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+    presentInfo.pWaitSemaphores = waitSemaphores.data();
+    presentInfo.swapchainCount = static_cast<uint32_t>(swapchains.size());
+    presentInfo.pSwapchains = swapchains.data();
+    presentInfo.pImageIndices = imageIndices.data();
+    presentInfo.pResults = presentResults.data();
+
+    // present wait 由设备扩展决定，同一设备上的交换链要么都支持要么都不支持
+    SwapChain &first = *presents.front().swapchain;
+    vk::PresentIdKHR presentIdInfo{};
+    presentIdInfo.swapchainCount = static_cast<uint32_t>(presentIds.size());
+    presentIdInfo.pPresentIds = presentIds.data();
+    if (first.m_waitForPresent)
+    {
+        presentInfo.pNext = &presentIdInfo;
+    }
+
+    // 整体结果只反映最严重的一项，逐个交换链的结果写在 pResults 中
+    const vk::Queue presentQueue = first.m_device.getPresentQueue();
+    vk::Result result;
+    {
+        std::lock_guard<std::mutex> queueLock(first.m_device.getQueueMutex(presentQueue));
+        result = presentQueue.presentKHR(&presentInfo);
+    }
+    if (result != vk::Result::eSuccess && result != vk::Result::eSuboptimalKHR &&
+        result != vk::Result::eErrorOutOfDateKHR)
+    {
+        throw std::runtime_error("Failed to present swap chain images!");
+    }
+
+    for (size_t i = 0; i < presents.size(); ++i)
+    {
+        presents[i].swapchain->finishpresent(presentResults[i], presentIds[i], presents[i].inputTime);
+        if (!results.empty())
+        {
+            results[i] = presentResults[i];
+        }
+    }
+}
+
+void SwapChain::finishpresent(vk::Result result, uint64_t presentId, std::chrono::steady_clock::time_point inputTime)
+{
+    if (inputTime == std::chrono::steady_clock::time_point{})
+    {
+        inputTime = m_acquireTime;
+    }
+    if (m_waitForPresent && (result == vk::Result::eSuccess || result == vk::Result::eSuboptimalKHR))
+    {
+        m_pendingPresents.push_back(PendingPresent{presentId, inputTime});
+    }
+    else if (!m_waitForPresent)
+    {
+        recordlatency(inputTime, false);
+    }
+
+    if (result == vk::Result::eErrorOutOfDateKHR)
     {
         recreate();
     }
+    else if (result == vk::Result::eSuboptimalKHR)
+    {
+        // 次优的交换链仍可呈现，拖动窗口时等尺寸稳定后再重建
+        requestRecreate();
+    }
     else if (result != vk::Result::eSuccess)
     {
         throw std::runtime_error("Failed to present swap chain image!");
     }
+}
 
-    return result;
+void SwapChain::advanceToNextFrame()
+{
+    if (!m_ownedTimeline)
+    {
+        throw std::runtime_error("SwapChain::advanceToNextFrame: the frame timeline is shared, advance it directly");
+    }
+    m_timeline->beginFrame();
+}
+
+void SwapChain::setPresentPolicy(const PresentPolicy &policy)
+{
+    const bool swapchainChanged = policy.modes != m_policy.modes || policy.imageCount != m_policy.imageCount;
+    m_policy = policy;
+    if (swapchainChanged)
+    {
+        m_recreatePending = true;
+        m_recreateDue = std::chrono::steady_clock::now();
+    }
+}
+
+void SwapChain::throttle()
+{
+    QTR_PROFILE_SCOPE("SwapChain::throttle");
+    if (!m_waitForPresent)
+    {
+        return;
+    }
+
+    // 本帧呈现后，排队（已呈现未上屏）的帧数不超过 maxQueuedFrames：
+    // 呈现 ID 不大于 frame - maxQueuedFrames 的帧必须已经上屏；更新的帧只做非阻塞查询
+    const uint64_t frame = m_timeline->getFrameNumber();
+    const uint64_t maxQueued = m_policy.maxQueuedFrames;
+    while (!m_pendingPresents.empty())
+    {
+        const PendingPresent pending = m_pendingPresents.front();
+        const bool mustWait = maxQueued != 0 && pending.presentId + maxQueued <= frame;
+        const VkResult result = m_waitForPresent(m_device.get(), m_swapchain, pending.presentId,
+                                                 mustWait ? kPresentWaitTimeoutNs : 0);
+        if (result == VK_TIMEOUT && !mustWait)
+        {
+            break;
+        }
+
+        m_pendingPresents.pop_front();
+        if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR)
+        {
+            recordlatency(pending.inputTime, true);
+        }
+        else if (result != VK_TIMEOUT)
+        {
+            // 交换链过期或表面丢失：剩余的 ID 都不会再上屏，由获取图像的结果触发重建
+            m_pendingPresents.clear();
+        }
+    }
+}
+
+void SwapChain::recordlatency(std::chrono::steady_clock::time_point inputTime, bool displayTimed)
+{
+    const double ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inputTime).count();
+    m_latency.lastMs = ms;
+    m_latency.averageMs =
+        m_latency.samples == 0 ? ms : m_latency.averageMs + (ms - m_latency.averageMs) * kLatencySmoothing;
+    m_latency.maxMs = std::max(m_latency.maxMs, ms);
+    m_latency.displayTimed = displayTimed;
+    ++m_latency.samples;
+}
+
+void SwapChain::requestRecreate()
+{
+    m_recreatePending = true;
+    m_recreateDue = std::chrono::steady_clock::now() + m_recreateDebounce;
 }
 
 void SwapChain::cleanup()
 {
+    // 先释放重建时替换下的旧交换链（调用者已保证设备空闲）
+    if (m_retiredQueue)
+    {
+        m_retiredQueue->flush();
+    }
+
     // 销毁同步对象
     // 清理 per-frame imageAvailable 信号量
     for (size_t i = 0; i < m_imageAvailableSemaphores.size(); i++)
@@ -104,18 +352,8 @@ void SwapChain::cleanup()
         }
     }
 
-    // 清理所有栅栏（数量 = MAX_FRAMES_IN_FLIGHT）
-    for (size_t i = 0; i < m_FlightFences.size(); i++)
-    {
-        if (m_FlightFences[i])
-        {
-            m_device.get().destroyFence(m_FlightFences[i]);
-        }
-    }
-
     m_imageAvailableSemaphores.clear();
     m_renderFinishedSemaphores.clear();
-    m_FlightFences.clear();
     m_imagesInFlight.clear();
 
     // 销毁 ImageView（Image 由交换链管理，不需要销毁）
@@ -139,12 +377,15 @@ void SwapChain::cleanup()
 
 void SwapChain::init()
 {
-    createswapchain();
+    if (!createswapchain(nullptr))
+    {
+        throw std::runtime_error("Failed to create swap chain: surface extent is zero!");
+    }
     createimages();
     createsyncobjects();
 }
 
-void SwapChain::createswapchain()
+bool SwapChain::createswapchain(vk::SwapchainKHR oldSwapchain)
 {
     // 查询表面能力
     vk::SurfaceCapabilitiesKHR capabilities = m_device.getPhysicalDevice().getSurfaceCapabilitiesKHR(m_surface);
@@ -161,21 +402,17 @@ void SwapChain::createswapchain()
         }
     }
 
-    // 选择呈现模式（优先 Mailbox > Immediate > FIFO）
+    // 按呈现策略的偏好选择呈现模式（默认 Mailbox > Immediate > FIFO）
     // Mailbox: 三缓冲，低延迟；Immediate: 立即呈现，可能撕裂；FIFO: 垂直同步，保证支持
     std::vector<vk::PresentModeKHR> presentModes = m_device.getPhysicalDevice().getSurfacePresentModesKHR(m_surface);
     vk::PresentModeKHR selectedPresentMode = vk::PresentModeKHR::eFifo;
-    for (const auto &mode : presentModes)
+    for (vk::PresentModeKHR mode : m_policy.modes)
     {
-        if (mode == vk::PresentModeKHR::eMailbox)
+        if (std::find(presentModes.begin(), presentModes.end(), mode) != presentModes.end())
         {
             selectedPresentMode = mode;
             break;
         }
-        else if (mode == vk::PresentModeKHR::eImmediate)
-        {
-            selectedPresentMode = mode;
-        }
     }
 
     // 确定交换链范围（图像尺寸）
@@ -190,9 +427,14 @@ void SwapChain::createswapchain()
         extent.height =
             std::max(capabilities.minImageExtent.height, std::min(capabilities.maxImageExtent.height, 600u));
     }
+    if (extent.width == 0 || extent.height == 0)
+    {
+        return false;
+    }
 
-    // 确定图像数量（建议 minImageCount + 1，实现三缓冲）
-    uint32_t imageCount = capabilities.minImageCount + 1;
+    // 确定图像数量（默认 minImageCount + 1，实现三缓冲；策略指定时钳制到表面支持的范围）
+    uint32_t imageCount = m_policy.imageCount != 0 ? std::max(m_policy.imageCount, capabilities.minImageCount)
+                                                   : capabilities.minImageCount + 1;
     if ((capabilities.maxImageCount > 0) && (imageCount > capabilities.maxImageCount))
     {
         imageCount = capabilities.maxImageCount;
@@ -227,13 +469,15 @@ void SwapChain::createswapchain()
         .setCompositeAlpha(vk::CompositeAlphaFlagBitsKHR::eOpaque)
         .setPresentMode(selectedPresentMode)
         .setClipped(VK_TRUE)
-        .setOldSwapchain(nullptr);
+        .setOldSwapchain(oldSwapchain);
 
     m_swapchain = m_device.get().createSwapchainKHR(createInfo);
 
     // 存储格式和尺寸供其他函数使用
     m_swapchainFormat = selectedFormat.format;
     m_swapchainExtent = extent;
+    m_presentMode = selectedPresentMode;
+    return true;
 }
 void SwapChain::createimages()
 {
@@ -262,50 +506,108 @@ void SwapChain::createimages()
 
 void SwapChain::createsyncobjects()
 {
-    // imageAvailable 信号量：per-frame (MAX_FRAMES_IN_FLIGHT)
+    // imageAvailable 信号量：per-frame (framesInFlight)
     // renderFinished 信号量：per-image (swapchain image count)
-    // 栅栏：per-frame (MAX_FRAMES_IN_FLIGHT)
+    // 帧完成由时间线信号量跟踪，不再需要栅栏
 
-    size_t imageCount = m_images.size();
-
-    m_imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    m_renderFinishedSemaphores.resize(imageCount);
-    m_imagesInFlight.resize(imageCount, nullptr); // 初始化为 nullptr
-    m_FlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+    uint32_t framesInFlight = m_timeline->getFramesInFlight();
+    m_imageAvailableSemaphores.resize(framesInFlight);
 
     vk::SemaphoreCreateInfo semaphoreInfo;
 
     // Per-frame imageAvailable 信号量
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    for (size_t i = 0; i < framesInFlight; i++)
     {
         m_imageAvailableSemaphores[i] = m_device.get().createSemaphore(semaphoreInfo);
     }
 
+    createimagesemaphores();
+}
+
+void SwapChain::createimagesemaphores()
+{
+    size_t imageCount = m_images.size();
+    m_renderFinishedSemaphores.resize(imageCount);
+    m_imagesInFlight.assign(imageCount, 0);
+
+    vk::SemaphoreCreateInfo semaphoreInfo;
+
     // Per-image renderFinished 信号量
     for (size_t i = 0; i < imageCount; i++)
     {
         m_renderFinishedSemaphores[i] = m_device.get().createSemaphore(semaphoreInfo);
     }
+}
+
+void SwapChain::setFramesInFlight(uint32_t framesInFlight)
+{
+    if (framesInFlight == 0)
+    {
+        throw std::invalid_argument("SwapChain::setFramesInFlight: framesInFlight must be > 0");
+    }
+    // 共享时间线时其他交换链可能已经调整过时间线，以本交换链的信号量数量为准
+    if (framesInFlight == m_imageAvailableSemaphores.size())
+    {
+        return;
+    }
 
-    // 栅栏初始状态为已信号（signaled），避免第一帧等待死锁
-    vk::FenceCreateInfo fenceInfo;
-    fenceInfo.setFlags(vk::FenceCreateFlagBits::eSignaled);
+    // 等待空闲后每帧信号量不再被引用，可以按新的数量重建
+    m_device.get().waitIdle();
+    m_timeline->setFramesInFlight(framesInFlight);
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    for (auto semaphore : m_imageAvailableSemaphores)
+    {
+        m_device.get().destroySemaphore(semaphore);
+    }
+    m_imageAvailableSemaphores.resize(framesInFlight);
+
+    vk::SemaphoreCreateInfo semaphoreInfo;
+    for (auto &semaphore : m_imageAvailableSemaphores)
     {
-        m_FlightFences[i] = m_device.get().createFence(fenceInfo);
+        semaphore = m_device.get().createSemaphore(semaphoreInfo);
     }
 }
 
-void SwapChain::recreate()
+bool SwapChain::recreate()
 {
-    // 等待所有 GPU 操作完成
-    m_device.get().waitIdle();
-
-    // 销毁旧交换链及相关资源
-    cleanup();
+    QTR_PROFILE_SCOPE("SwapChain::recreate");
+    vk::SwapchainKHR oldSwapchain = m_swapchain;
+    std::vector<vk::ImageView> oldImageViews = std::move(m_imageViews);
+    std::vector<vk::Semaphore> oldSemaphores = std::move(m_renderFinishedSemaphores);
+    m_imageViews.clear();
+    m_renderFinishedSemaphores.clear();
 
-    // 重新初始化（会重新查询表面能力，自动获取新尺寸）
-    init();
+    // 重新查询表面能力获取新尺寸；尺寸为 0 时保留旧交换链，等窗口恢复后重试
+    if (!createswapchain(oldSwapchain))
+    {
+        m_imageViews = std::move(oldImageViews);
+        m_renderFinishedSemaphores = std::move(oldSemaphores);
+        m_recreatePending = true;
+        m_recreateDue = std::chrono::steady_clock::now();
+        return false;
+    }
+    createimages();
+    createimagesemaphores();
+    m_pendingPresents.clear(); // 呈现 ID 属于旧交换链，不能在新交换链上等待
+
+    // 旧资源延迟销毁：已提交的帧仍在渲染旧图像，呈现引擎还可能在读取它们、等待旧的渲染完成信号量。
+    // 呈现操作没有可等待的栅栏，退休帧号在当前帧之后再留出 framesInFlight 帧的余量
+    vk::Device device = m_device.get();
+    m_retiredQueue->enqueue(m_timeline->getFrameNumber() + m_timeline->getFramesInFlight(),
+                            [device, oldSwapchain, oldImageViews, oldSemaphores]() {
+                                for (vk::Semaphore semaphore : oldSemaphores)
+                                {
+                                    device.destroySemaphore(semaphore);
+                                }
+                                for (vk::ImageView imageView : oldImageViews)
+                                {
+                                    device.destroyImageView(imageView);
+                                }
+                                device.destroySwapchainKHR(oldSwapchain);
+                            });
+
+    m_recreatePending = false;
+    ++m_generation;
+    return true;
 }
 } // namespace vkcore
@@ -0,0 +1,287 @@
+/**
+ * @file TLSFAllocator.cpp
+ * @brief TLSFAllocator 实现
+ */
+
+#include "TLSFAllocator.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace vkcore
+{
+
+TLSFAllocator::TLSFAllocator(uint32_t capacity) : m_capacity(capacity)
+{
+    if (capacity == 0)
+    {
+        throw std::invalid_argument("TLSFAllocator: capacity must be greater than 0");
+    }
+    reset();
+}
+
+void TLSFAllocator::reset()
+{
+    m_blocks.clear();
+    m_unusedBlocks.clear();
+    m_usedSize = 0;
+    m_allocationCount = 0;
+
+    m_firstLevelBitmap = 0;
+    for (uint32_t fl = 0; fl < kFirstLevelCount; ++fl)
+    {
+        m_secondLevelBitmaps[fl] = 0;
+        for (uint32_t sl = 0; sl < kSecondLevelCount; ++sl)
+        {
+            m_freeHeads[fl][sl] = kInvalidBlock;
+        }
+    }
+
+    uint32_t index = newblock();
+    m_blocks[index].offset = 0;
+    m_blocks[index].size = m_capacity;
+    insertfreeblock(index);
+}
+
+// ==================== 分配与释放 ====================
+
+TLSFAllocator::Allocation TLSFAllocator::allocate(uint32_t size)
+{
+    if (size == 0 || size > getFreeSize())
+    {
+        return {};
+    }
+
+    uint32_t index = findfreeblock(size);
+    if (index == kInvalidBlock)
+    {
+        return {};
+    }
+    removefreeblock(index);
+
+    // 剩余部分拆成新的空闲块放回桶中
+    if (m_blocks[index].size > size)
+    {
+        uint32_t remainder = newblock();
+        Block &block = m_blocks[index];
+        Block &rest = m_blocks[remainder];
+        rest.offset = block.offset + size;
+        rest.size = block.size - size;
+        rest.prevPhysical = index;
+        rest.nextPhysical = block.nextPhysical;
+        if (block.nextPhysical != kInvalidBlock)
+        {
+            m_blocks[block.nextPhysical].prevPhysical = remainder;
+        }
+        block.nextPhysical = remainder;
+        block.size = size;
+        insertfreeblock(remainder);
+    }
+
+    Block &block = m_blocks[index];
+    block.free = false;
+    m_usedSize += size;
+    ++m_allocationCount;
+
+    Allocation allocation;
+    allocation.offset = block.offset;
+    allocation.size = size;
+    allocation.block = index;
+    return allocation;
+}
+
+void TLSFAllocator::free(const Allocation &allocation)
+{
+    if (!allocation.isValid() || allocation.block >= m_blocks.size() || m_blocks[allocation.block].free)
+    {
+        throw std::invalid_argument("TLSFAllocator::free: Invalid or already freed allocation");
+    }
+
+    uint32_t index = allocation.block;
+    m_usedSize -= m_blocks[index].size;
+    --m_allocationCount;
+
+    // 与物理相邻的空闲块合并
+    uint32_t prev = m_blocks[index].prevPhysical;
+    if (prev != kInvalidBlock && m_blocks[prev].free)
+    {
+        removefreeblock(prev);
+        m_blocks[prev].size += m_blocks[index].size;
+        m_blocks[prev].nextPhysical = m_blocks[index].nextPhysical;
+        if (m_blocks[index].nextPhysical != kInvalidBlock)
+        {
+            m_blocks[m_blocks[index].nextPhysical].prevPhysical = prev;
+        }
+        recycleblock(index);
+        index = prev;
+    }
+
+    uint32_t next = m_blocks[index].nextPhysical;
+    if (next != kInvalidBlock && m_blocks[next].free)
+    {
+        removefreeblock(next);
+        m_blocks[index].size += m_blocks[next].size;
+        m_blocks[index].nextPhysical = m_blocks[next].nextPhysical;
+        if (m_blocks[next].nextPhysical != kInvalidBlock)
+        {
+            m_blocks[m_blocks[next].nextPhysical].prevPhysical = index;
+        }
+        recycleblock(next);
+    }
+
+    insertfreeblock(index);
+}
+
+uint32_t TLSFAllocator::getLargestFreeBlock() const
+{
+    if (m_firstLevelBitmap == 0)
+    {
+        return 0;
+    }
+
+    // 最高的非空桶里的块一定最大，但同一桶内大小不同，需要遍历该桶
+    uint32_t fl = 31 - static_cast<uint32_t>(std::countl_zero(m_firstLevelBitmap));
+    uint32_t sl = 31 - static_cast<uint32_t>(std::countl_zero(m_secondLevelBitmaps[fl]));
+    uint32_t largest = 0;
+    for (uint32_t index = m_freeHeads[fl][sl]; index != kInvalidBlock; index = m_blocks[index].nextFree)
+    {
+        largest = std::max(largest, m_blocks[index].size);
+    }
+    return largest;
+}
+
+// ==================== 内部实现 ====================
+
+void TLSFAllocator::mapping(uint32_t size, uint32_t &firstLevel, uint32_t &secondLevel)
+{
+    // 小于 kSecondLevelCount 的大小全部落在第 0 级，按大小线性分桶
+    if (size < kSecondLevelCount)
+    {
+        firstLevel = 0;
+        secondLevel = size;
+        return;
+    }
+
+    uint32_t log2 = 31 - static_cast<uint32_t>(std::countl_zero(size));
+    firstLevel = log2 - kSecondLevelBits + 1;
+    secondLevel = (size >> (log2 - kSecondLevelBits)) - kSecondLevelCount;
+}
+
+uint32_t TLSFAllocator::findfreeblock(uint32_t size) const
+{
+    // 向上取整到下一个桶的起点，使桶内任意块都能容纳请求（good fit，O(1)）
+    uint32_t searchSize = size;
+    if (size >= kSecondLevelCount)
+    {
+        uint32_t log2 = 31 - static_cast<uint32_t>(std::countl_zero(size));
+        uint32_t round = (1u << (log2 - kSecondLevelBits)) - 1;
+        searchSize = size > UINT32_MAX - round ? UINT32_MAX : size + round;
+    }
+
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    mapping(searchSize, fl, sl);
+
+    uint32_t secondLevelMap = m_secondLevelBitmaps[fl] & (~0u << sl);
+    if (secondLevelMap == 0)
+    {
+        uint32_t firstLevelMap = fl + 1 < kFirstLevelCount ? m_firstLevelBitmap & (~0u << (fl + 1)) : 0;
+        if (firstLevelMap != 0)
+        {
+            fl = static_cast<uint32_t>(std::countr_zero(firstLevelMap));
+            secondLevelMap = m_secondLevelBitmaps[fl];
+        }
+    }
+
+    if (secondLevelMap != 0)
+    {
+        sl = static_cast<uint32_t>(std::countr_zero(secondLevelMap));
+        return m_freeHeads[fl][sl];
+    }
+
+    // 更大的桶都为空：请求所在的桶里仍可能有恰好够大的块（例如整块空闲时申请接近容量的大小）
+    mapping(size, fl, sl);
+    for (uint32_t index = m_freeHeads[fl][sl]; index != kInvalidBlock; index = m_blocks[index].nextFree)
+    {
+        if (m_blocks[index].size >= size)
+        {
+            return index;
+        }
+    }
+    return kInvalidBlock;
+}
+
+void TLSFAllocator::insertfreeblock(uint32_t index)
+{
+    Block &block = m_blocks[index];
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    mapping(block.size, fl, sl);
+
+    block.free = true;
+    block.prevFree = kInvalidBlock;
+    block.nextFree = m_freeHeads[fl][sl];
+    if (block.nextFree != kInvalidBlock)
+    {
+        m_blocks[block.nextFree].prevFree = index;
+    }
+    m_freeHeads[fl][sl] = index;
+
+    m_firstLevelBitmap |= 1u << fl;
+    m_secondLevelBitmaps[fl] |= 1u << sl;
+}
+
+void TLSFAllocator::removefreeblock(uint32_t index)
+{
+    Block &block = m_blocks[index];
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    mapping(block.size, fl, sl);
+
+    if (block.prevFree != kInvalidBlock)
+    {
+        m_blocks[block.prevFree].nextFree = block.nextFree;
+    }
+    else
+    {
+        m_freeHeads[fl][sl] = block.nextFree;
+    }
+    if (block.nextFree != kInvalidBlock)
+    {
+        m_blocks[block.nextFree].prevFree = block.prevFree;
+    }
+
+    if (m_freeHeads[fl][sl] == kInvalidBlock)
+    {
+        m_secondLevelBitmaps[fl] &= ~(1u << sl);
+        if (m_secondLevelBitmaps[fl] == 0)
+        {
+            m_firstLevelBitmap &= ~(1u << fl);
+        }
+    }
+
+    block.free = false;
+    block.prevFree = kInvalidBlock;
+    block.nextFree = kInvalidBlock;
+}
+
+uint32_t TLSFAllocator::newblock()
+{
+    if (!m_unusedBlocks.empty())
+    {
+        uint32_t index = m_unusedBlocks.back();
+        m_unusedBlocks.pop_back();
+        m_blocks[index] = Block{};
+        return index;
+    }
+    m_blocks.emplace_back();
+    return static_cast<uint32_t>(m_blocks.size() - 1);
+}
+
+void TLSFAllocator::recycleblock(uint32_t index)
+{
+    m_blocks[index] = Block{};
+    m_unusedBlocks.push_back(index);
+}
+
+} // namespace vkcore
@@ -0,0 +1,124 @@
+#include "TransientBufferRing.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @file TransientBufferRing.cpp
+ * @brief TransientBufferRing 类的实现文件
+ */
+
+namespace vkcore
+{
+
+namespace
+{
+
+constexpr vk::DeviceSize kMinAlignment = 16; ///< std140/std430 中 vec4 的对齐
+
+vk::DeviceSize alignup(vk::DeviceSize value, vk::DeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+TransientBufferRing::TransientBufferRing(Device &device, VmaAllocator allocator, vk::DeviceSize bytesPerFrame,
+                                         uint32_t framesInFlight, vk::BufferUsageFlags usage)
+    : m_framesInFlight(framesInFlight)
+{
+    if (bytesPerFrame == 0 || framesInFlight == 0)
+    {
+        throw std::invalid_argument("TransientBufferRing: bytesPerFrame and framesInFlight must be non-zero");
+    }
+
+    // 动态偏移必须同时满足所有用途的对齐限制
+    const vk::PhysicalDeviceLimits limits = device.getPhysicalDevice().getProperties().limits;
+    m_alignment = kMinAlignment;
+    if (usage & vk::BufferUsageFlagBits::eUniformBuffer)
+    {
+        m_alignment = std::max(m_alignment, limits.minUniformBufferOffsetAlignment);
+    }
+    if (usage & vk::BufferUsageFlagBits::eStorageBuffer)
+    {
+        m_alignment = std::max(m_alignment, limits.minStorageBufferOffsetAlignment);
+    }
+
+    m_frameSize = alignup(bytesPerFrame, m_alignment);
+    if (m_frameSize * framesInFlight > UINT32_MAX)
+    {
+        throw std::invalid_argument("TransientBufferRing: total size exceeds the 32-bit dynamic offset range");
+    }
+
+    BufferDesc desc{};
+    desc.size = m_frameSize * framesInFlight;
+    desc.usageFlags = usage;
+    desc.memoryUsage = VMA_MEMORY_USAGE_AUTO;
+    desc.allocationCreateFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+    desc.category = MemoryCategory::Uniform;
+    m_buffer = std::make_unique<Buffer>("TransientBufferRing", device, allocator, desc);
+    m_mapped = static_cast<uint8_t *>(m_buffer->map());
+    if (!m_mapped)
+    {
+        throw std::runtime_error("TransientBufferRing: failed to map ring buffer");
+    }
+}
+
+TransientBufferRing::~TransientBufferRing()
+{
+    if (m_buffer && m_mapped)
+    {
+        m_buffer->ummap();
+    }
+}
+
+void TransientBufferRing::beginFrame(uint32_t frameIndex)
+{
+    if (frameIndex >= m_framesInFlight)
+    {
+        throw std::invalid_argument("TransientBufferRing::beginFrame: frameIndex out of range");
+    }
+
+    m_peakUsed = std::max(m_peakUsed, std::min(m_head.load(std::memory_order_relaxed), m_frameSize));
+    m_frameIndex = frameIndex;
+    m_head.store(0, std::memory_order_relaxed);
+}
+
+TransientBufferRing::Allocation TransientBufferRing::allocate(vk::DeviceSize size)
+{
+    const vk::DeviceSize offset = m_head.fetch_add(alignup(std::max<vk::DeviceSize>(size, 1), m_alignment),
+                                                   std::memory_order_relaxed);
+    if (offset + size > m_frameSize)
+    {
+        throw std::runtime_error("TransientBufferRing: frame region exhausted (" + std::to_string(m_frameSize) +
+                                 " bytes per frame)");
+    }
+
+    const vk::DeviceSize bufferOffset = m_frameIndex * m_frameSize + offset;
+
+    Allocation allocation;
+    allocation.data = m_mapped + bufferOffset;
+    allocation.offset = static_cast<uint32_t>(bufferOffset);
+    allocation.size = size;
+    return allocation;
+}
+
+void TransientBufferRing::flush()
+{
+    const vk::DeviceSize used = std::min(m_head.load(std::memory_order_relaxed), m_frameSize);
+    if (used > 0)
+    {
+        m_buffer->flush(used, m_frameIndex * m_frameSize);
+    }
+}
+
+TransientBufferRing::Stats TransientBufferRing::getStats() const
+{
+    Stats stats;
+    stats.frameCapacity = m_frameSize;
+    stats.frameUsed = std::min(m_head.load(std::memory_order_relaxed), m_frameSize);
+    stats.peakUsed = std::max(m_peakUsed, stats.frameUsed);
+    return stats;
+}
+
+} // namespace vkcore
@@ -0,0 +1,753 @@
+#include "UploadQueue.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+/**
+ * @file UploadQueue.cpp
+ * @brief UploadQueue 类的实现文件
+ */
+
+namespace vkcore
+{
+
+namespace
+{
+
+constexpr vk::DeviceSize kCopyAlignment = 16; ///< 暂存偏移的基础对齐（覆盖 optimalBufferCopyOffsetAlignment 常见值）
+
+vk::DeviceSize alignup(vk::DeviceSize value, vk::DeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+vk::ImageSubresourceRange fullcolorrange(const Image &image)
+{
+    vk::ImageSubresourceRange range{};
+    range.aspectMask = vk::ImageAspectFlagBits::eColor;
+    range.baseMipLevel = 0;
+    range.levelCount = image.getMipLevels();
+    range.baseArrayLayer = 0;
+    range.layerCount = image.getArrayLayers();
+    return range;
+}
+
+/**
+ * @brief 从 mip 0 逐级 blit 生成其余 mip，并把整个图像转换到最终布局
+ * @details 进入时全部 mip 处于 eTransferDstOptimal 且 mip 0 已写入；只能在支持图形操作的队列上录制
+ */
+void recordmipchain(vk::CommandBuffer cmd, const Image &image, vk::ImageLayout finalLayout)
+{
+    const uint32_t mipLevels = image.getMipLevels();
+    const uint32_t layerCount = image.getArrayLayers();
+    int32_t mipWidth = static_cast<int32_t>(image.getExtent().width);
+    int32_t mipHeight = static_cast<int32_t>(image.getExtent().height);
+
+    vk::ImageMemoryBarrier2 barrier{};
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image.get();
+    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = layerCount;
+
+    vk::DependencyInfo dependencyInfo{};
+    dependencyInfo.imageMemoryBarrierCount = 1;
+    dependencyInfo.pImageMemoryBarriers = &barrier;
+
+    for (uint32_t level = 1; level < mipLevels; ++level)
+    {
+        // 上一级（拷贝或 blit 写入）转换为 blit 源
+        barrier.srcStageMask = vk::PipelineStageFlagBits2::eCopy | vk::PipelineStageFlagBits2::eBlit;
+        barrier.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+        barrier.dstStageMask = vk::PipelineStageFlagBits2::eBlit;
+        barrier.dstAccessMask = vk::AccessFlagBits2::eTransferRead;
+        barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+        barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
+        barrier.subresourceRange.baseMipLevel = level - 1;
+        cmd.pipelineBarrier2(dependencyInfo);
+
+        int32_t nextWidth = std::max(mipWidth / 2, 1);
+        int32_t nextHeight = std::max(mipHeight / 2, 1);
+
+        vk::ImageBlit blit{};
+        blit.srcSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level - 1, 0, layerCount);
+        blit.srcOffsets[1] = vk::Offset3D{mipWidth, mipHeight, 1};
+        blit.dstSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level, 0, layerCount);
+        blit.dstOffsets[1] = vk::Offset3D{nextWidth, nextHeight, 1};
+        cmd.blitImage(image.get(), vk::ImageLayout::eTransferSrcOptimal, image.get(),
+                      vk::ImageLayout::eTransferDstOptimal, blit, vk::Filter::eLinear);
+
+        mipWidth = nextWidth;
+        mipHeight = nextHeight;
+    }
+
+    // 前 N-1 级处于 blit 源布局，最后一级处于传输目标布局，分别转换到最终布局
+    // （最终布局在信号量触发前完成，使用者等待票据即可）
+    std::vector<vk::ImageMemoryBarrier2> toFinal;
+    if (mipLevels > 1)
+    {
+        barrier.srcStageMask = vk::PipelineStageFlagBits2::eBlit;
+        barrier.srcAccessMask = vk::AccessFlagBits2::eNone; // 读之后的布局转换只需执行依赖
+        barrier.dstStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+        barrier.dstAccessMask = vk::AccessFlagBits2::eNone;
+        barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
+        barrier.newLayout = finalLayout;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = mipLevels - 1;
+        toFinal.push_back(barrier);
+    }
+
+    barrier.srcStageMask = vk::PipelineStageFlagBits2::eCopy | vk::PipelineStageFlagBits2::eBlit;
+    barrier.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+    barrier.dstStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+    barrier.dstAccessMask = vk::AccessFlagBits2::eNone;
+    barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+    barrier.newLayout = finalLayout;
+    barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+    barrier.subresourceRange.levelCount = 1;
+    toFinal.push_back(barrier);
+
+    dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(toFinal.size());
+    dependencyInfo.pImageMemoryBarriers = toFinal.data();
+    cmd.pipelineBarrier2(dependencyInfo);
+}
+
+} // namespace
+
+UploadQueue::UploadQueue(Device &device, VmaAllocator allocator, vk::DeviceSize stagingSize,
+                         vk::DeviceSize flushThreshold)
+    : m_device(device), m_allocator(allocator), m_transferFamily(device.getTransferQueueFamilyIndices()),
+      m_graphicsFamily(device.getGraphicsQueueFamilyIndices()), m_stagingSize(stagingSize),
+      m_flushThreshold(flushThreshold), m_ownerThread(std::this_thread::get_id())
+{
+    if (stagingSize == 0)
+    {
+        throw std::invalid_argument("UploadQueue: stagingSize must be > 0");
+    }
+
+    m_transferCommands = std::make_unique<CommandPoolManager>(device, m_transferFamily);
+    if (needsownershiptransfer())
+    {
+        m_graphicsCommands = std::make_unique<CommandPoolManager>(device, m_graphicsFamily);
+    }
+
+    // 时间线信号量：每个批次触发一个单调递增的值，CPU 与 GPU 都可以按值等待
+    vk::SemaphoreTypeCreateInfo timelineInfo{};
+    timelineInfo.semaphoreType = vk::SemaphoreType::eTimeline;
+    timelineInfo.initialValue = 0;
+
+    vk::SemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.pNext = &timelineInfo;
+    m_timeline = m_device.get().createSemaphore(semaphoreInfo);
+
+    // 需要所有权转移时票据只由图形队列的获取提交触发；传输提交触发独立的时间线，
+    // 否则两个队列交错触发同一信号量，下一批次的传输可能先于上一批次的获取触发更大的值
+    if (needsownershiptransfer())
+    {
+        m_transferTimeline = m_device.get().createSemaphore(semaphoreInfo);
+    }
+
+    // 常驻映射的暂存环形缓冲区，CPU 只顺序写入
+    BufferDesc stagingDesc{};
+    stagingDesc.size = stagingSize;
+    stagingDesc.usageFlags = vk::BufferUsageFlagBits::eTransferSrc;
+    stagingDesc.memoryUsage = VMA_MEMORY_USAGE_AUTO;
+    stagingDesc.allocationCreateFlags =
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    stagingDesc.category = MemoryCategory::Staging;
+
+    m_staging = std::make_unique<Buffer>("UploadQueue staging ring", device, allocator, stagingDesc);
+    m_stagingData = static_cast<uint8_t *>(m_staging->map());
+    if (!m_stagingData)
+    {
+        throw std::runtime_error("UploadQueue: Failed to map staging ring");
+    }
+}
+
+UploadQueue::~UploadQueue()
+{
+    try
+    {
+        waitvalue(m_submittedTicket);
+    }
+    catch (const std::exception &)
+    {
+        // 设备丢失时无法等待，仍然继续释放
+    }
+
+    // 命令缓冲区句柄必须先于其命令池管理器销毁
+    m_pending.reset();
+    m_inFlight.clear();
+
+    m_staging.reset();
+    m_stagingData = nullptr;
+
+    if (m_timeline)
+    {
+        m_device.get().destroySemaphore(m_timeline);
+        m_timeline = nullptr;
+    }
+    if (m_transferTimeline)
+    {
+        m_device.get().destroySemaphore(m_transferTimeline);
+        m_transferTimeline = nullptr;
+    }
+
+    m_graphicsCommands.reset();
+    m_transferCommands.reset();
+}
+
+void UploadQueue::setOwnerThread(std::thread::id owner)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_ownerThread = owner;
+}
+
+// ==================== 上传接口 ====================
+
+UploadTicket UploadQueue::uploadBuffer(const std::shared_ptr<Buffer> &dst, const void *data, vk::DeviceSize size,
+                                       vk::DeviceSize dstOffset)
+{
+    QTR_PROFILE_SCOPE("UploadQueue::uploadBuffer");
+    if (!dst || !data || size == 0)
+    {
+        throw std::invalid_argument("UploadQueue::uploadBuffer: Invalid destination or data");
+    }
+    if (dstOffset + size > dst->getSize())
+    {
+        throw std::invalid_argument("UploadQueue::uploadBuffer: Write range exceeds buffer size");
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    retirecompleted();
+
+    vk::Buffer srcBuffer;
+    vk::DeviceSize srcOffset = 0;
+    stagedata(data, size, kCopyAlignment, srcBuffer, srcOffset);
+
+    Batch &batch = openbatch();
+    vk::BufferCopy region{};
+    region.srcOffset = srcOffset;
+    region.dstOffset = dstOffset;
+    region.size = size;
+    batch.bufferCopies.push_back({dst, srcBuffer, region});
+    batch.ringEnd = m_ringHead;
+    batch.pendingBytes += size;
+
+    m_stats.uploadCount++;
+    m_stats.uploadedBytes += size;
+
+    UploadTicket ticket = batch.ticket;
+    flushifneeded(batch);
+    return ticket;
+}
+
+UploadTicket UploadQueue::uploadImage(const std::shared_ptr<Image> &dst, const void *data, vk::DeviceSize size,
+                                      const std::vector<vk::BufferImageCopy> &regions, uint32_t texelBlockSize,
+                                      vk::ImageLayout finalLayout, bool generateMips)
+{
+    QTR_PROFILE_SCOPE("UploadQueue::uploadImage");
+    if (!dst || !data || size == 0 || regions.empty() || texelBlockSize == 0)
+    {
+        throw std::invalid_argument("UploadQueue::uploadImage: Invalid destination, data or regions");
+    }
+    if (generateMips && dst->getMipLevels() > 1 && !(dst->getUsage() & vk::ImageUsageFlagBits::eTransferSrc))
+    {
+        throw std::invalid_argument("UploadQueue::uploadImage: Mip generation requires eTransferSrc usage");
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    retirecompleted();
+
+    // 同一批次内图像只能出现一次（入口的 Undefined 布局转换会丢弃之前的拷贝）
+    if (m_pending)
+    {
+        for (const auto &pendingCopy : m_pending->imageCopies)
+        {
+            if (pendingCopy.dst == dst)
+            {
+                submitbatch();
+                break;
+            }
+        }
+    }
+
+    vk::Buffer srcBuffer;
+    vk::DeviceSize srcOffset = 0;
+    stagedata(data, size, std::lcm(kCopyAlignment, static_cast<vk::DeviceSize>(texelBlockSize)), srcBuffer,
+              srcOffset);
+
+    Batch &batch = openbatch();
+    PendingImageCopy imageCopy{dst, srcBuffer, regions, finalLayout, generateMips && dst->getMipLevels() > 1};
+    for (auto &region : imageCopy.regions)
+    {
+        region.bufferOffset += srcOffset;
+    }
+    batch.imageCopies.push_back(std::move(imageCopy));
+    batch.ringEnd = m_ringHead;
+    batch.pendingBytes += size;
+
+    // CPU 侧布局跟踪：使用者在等待票据之后看到的布局
+    dst->setCurrentLayout(finalLayout);
+
+    m_stats.uploadCount++;
+    m_stats.uploadedBytes += size;
+
+    UploadTicket ticket = batch.ticket;
+    flushifneeded(batch);
+    return ticket;
+}
+
+UploadTicket UploadQueue::flush()
+{
+    QTR_PROFILE_SCOPE("UploadQueue::flush");
+    std::lock_guard<std::mutex> lock(m_mtx);
+    retirecompleted();
+
+    if (m_pending)
+    {
+        submitbatch();
+    }
+    return m_submittedTicket;
+}
+
+// ==================== 完成查询 ====================
+
+bool UploadQueue::isComplete(UploadTicket ticket) const
+{
+    if (ticket == 0)
+    {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (ticket > m_submittedTicket)
+        {
+            return false;
+        }
+    }
+
+    return m_device.get().getSemaphoreCounterValue(m_timeline) >= ticket;
+}
+
+void UploadQueue::wait(UploadTicket ticket)
+{
+    QTR_PROFILE_SCOPE("UploadQueue::wait");
+    if (ticket == 0)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (ticket > m_submittedTicket)
+        {
+            if (!m_pending || ticket > m_pending->ticket)
+            {
+                throw std::invalid_argument("UploadQueue::wait: Unknown upload ticket");
+            }
+            submitbatch();
+        }
+    }
+
+    // 等待期间不持有锁，其他线程可以继续记录上传
+    waitvalue(ticket);
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    retirecompleted();
+}
+
+void UploadQueue::waitIdle()
+{
+    wait(flush());
+}
+
+UploadTicket UploadQueue::getSubmittedTicket() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_submittedTicket;
+}
+
+UploadQueue::Stats UploadQueue::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_stats;
+}
+
+// ==================== 私有辅助函数 ====================
+
+void UploadQueue::stagedata(const void *data, vk::DeviceSize size, vk::DeviceSize alignment, vk::Buffer &srcBuffer,
+                            vk::DeviceSize &srcOffset)
+{
+    // 超过环形缓冲区容量：使用随批次释放的独立暂存缓冲区
+    if (size > m_stagingSize)
+    {
+        BufferDesc stagingDesc{};
+        stagingDesc.size = size;
+        stagingDesc.usageFlags = vk::BufferUsageFlagBits::eTransferSrc;
+        stagingDesc.memoryUsage = VMA_MEMORY_USAGE_AUTO;
+        stagingDesc.allocationCreateFlags =
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        stagingDesc.category = MemoryCategory::Staging;
+
+        auto staging = std::make_unique<Buffer>("UploadQueue dedicated staging", m_device, m_allocator, stagingDesc);
+        void *mapped = staging->map();
+        if (!mapped)
+        {
+            throw std::runtime_error("UploadQueue: Failed to map dedicated staging buffer");
+        }
+        std::memcpy(mapped, data, size);
+        staging->flush(size, 0);
+
+        srcBuffer = staging->get();
+        srcOffset = 0;
+        openbatch().dedicatedStagings.push_back(std::move(staging));
+        m_stats.dedicatedStagings++;
+        return;
+    }
+
+    while (true)
+    {
+        // 按物理位置对齐；一段数据不跨越缓冲区末尾，放不下时从下一圈的开头写入
+        vk::DeviceSize physical = m_ringHead % m_stagingSize;
+        vk::DeviceSize alignedPhysical = alignup(physical, alignment);
+        vk::DeviceSize offset = m_ringHead - physical + alignedPhysical;
+        if (alignedPhysical + size > m_stagingSize)
+        {
+            offset = m_ringHead - physical + m_stagingSize;
+        }
+
+        if (offset + size - m_ringTail <= m_stagingSize)
+        {
+            vk::DeviceSize physicalOffset = offset % m_stagingSize;
+            std::memcpy(m_stagingData + physicalOffset, data, size);
+            m_staging->flush(size, physicalOffset);
+
+            srcBuffer = m_staging->get();
+            srcOffset = physicalOffset;
+            m_ringHead = offset + size;
+            return;
+        }
+
+        // 环形缓冲区已满：先提交正在累积的批次，再等待最早的在途批次释放空间
+        if (m_pending)
+        {
+            submitbatch();
+        }
+
+        if (m_inFlight.empty())
+        {
+            // 暂存区已全部空闲但对齐/回绕导致放不下：从新一圈的开头重新开始
+            m_ringHead = (m_ringHead / m_stagingSize + 1) * m_stagingSize;
+            m_ringTail = m_ringHead;
+            continue;
+        }
+
+        m_stats.stallCount++;
+        waitvalue(m_inFlight.front().ticket);
+        retirecompleted();
+    }
+}
+
+UploadQueue::Batch &UploadQueue::openbatch()
+{
+    if (!m_pending)
+    {
+        // 提前分配时间线值，上传在记录时就能拿到票据
+        m_pending = std::make_unique<Batch>();
+        m_pending->ticket = m_nextValue++;
+        m_pending->transferValue = needsownershiptransfer() ? m_nextTransferValue++ : m_pending->ticket;
+        m_pending->ringEnd = m_ringHead;
+    }
+    return *m_pending;
+}
+
+void UploadQueue::submitbatch()
+{
+    QTR_PROFILE_SCOPE("UploadQueue::submitbatch");
+    Batch &batch = *m_pending;
+    const bool transferOwnership = needsownershiptransfer();
+
+    batch.transferCmd = m_transferCommands->allocate(vk::CommandBufferLevel::ePrimary);
+    vk::CommandBuffer cmd = *batch.transferCmd;
+
+    vk::CommandBufferBeginInfo beginInfo{};
+    beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+    cmd.begin(beginInfo);
+
+    // 1. 所有图像一次性转换到传输目标布局
+    std::vector<vk::ImageMemoryBarrier2> toTransferDst;
+    toTransferDst.reserve(batch.imageCopies.size());
+    for (const auto &imageCopy : batch.imageCopies)
+    {
+        vk::ImageMemoryBarrier2 barrier{};
+        barrier.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+        barrier.srcAccessMask = vk::AccessFlagBits2::eNone;
+        barrier.dstStageMask = vk::PipelineStageFlagBits2::eCopy;
+        barrier.dstAccessMask = vk::AccessFlagBits2::eTransferWrite;
+        barrier.oldLayout = vk::ImageLayout::eUndefined;
+        barrier.newLayout = vk::ImageLayout::eTransferDstOptimal;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = imageCopy.dst->get();
+        barrier.subresourceRange = fullcolorrange(*imageCopy.dst);
+        toTransferDst.push_back(barrier);
+    }
+
+    if (!toTransferDst.empty())
+    {
+        vk::DependencyInfo dependencyInfo{};
+        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(toTransferDst.size());
+        dependencyInfo.pImageMemoryBarriers = toTransferDst.data();
+        cmd.pipelineBarrier2(dependencyInfo);
+    }
+
+    // 2. 录制全部拷贝
+    for (const auto &bufferCopy : batch.bufferCopies)
+    {
+        cmd.copyBuffer(bufferCopy.src, bufferCopy.dst->get(), bufferCopy.region);
+    }
+    for (const auto &imageCopy : batch.imageCopies)
+    {
+        cmd.copyBufferToImage(imageCopy.src, imageCopy.dst->get(), vk::ImageLayout::eTransferDstOptimal,
+                              imageCopy.regions);
+    }
+
+    // 3. 转换到最终布局；跨队列族时拆分为传输队列上的释放与图形队列上的获取
+    //    （缓冲区在同一队列族内不需要屏障，时间线信号量的触发/等待已包含完整的内存依赖）
+    std::vector<vk::BufferMemoryBarrier2> bufferReleases;
+    std::vector<vk::BufferMemoryBarrier2> bufferAcquires;
+    std::vector<vk::ImageMemoryBarrier2> imageReleases;
+    std::vector<vk::ImageMemoryBarrier2> imageAcquires;
+
+    if (transferOwnership)
+    {
+        for (const auto &bufferCopy : batch.bufferCopies)
+        {
+            vk::BufferMemoryBarrier2 release{};
+            release.srcStageMask = vk::PipelineStageFlagBits2::eCopy;
+            release.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+            release.srcQueueFamilyIndex = m_transferFamily;
+            release.dstQueueFamilyIndex = m_graphicsFamily;
+            release.buffer = bufferCopy.dst->get();
+            release.offset = bufferCopy.region.dstOffset;
+            release.size = bufferCopy.region.size;
+            bufferReleases.push_back(release);
+
+            vk::BufferMemoryBarrier2 acquire = release;
+            acquire.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+            acquire.srcAccessMask = vk::AccessFlagBits2::eNone;
+            acquire.dstStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+            acquire.dstAccessMask = vk::AccessFlagBits2::eMemoryRead;
+            bufferAcquires.push_back(acquire);
+        }
+    }
+
+    for (const auto &imageCopy : batch.imageCopies)
+    {
+        // 同一队列族（即图形族）时直接在本命令缓冲区内生成 mip 并完成布局转换
+        if (imageCopy.generateMips && !transferOwnership)
+        {
+            recordmipchain(cmd, *imageCopy.dst, imageCopy.finalLayout);
+            continue;
+        }
+
+        // 跨队列族生成 mip：所有权转移时保持传输目标布局，blit 在图形队列获取之后录制
+        const vk::ImageLayout releaseLayout =
+            imageCopy.generateMips ? vk::ImageLayout::eTransferDstOptimal : imageCopy.finalLayout;
+
+        vk::ImageMemoryBarrier2 release{};
+        release.srcStageMask = vk::PipelineStageFlagBits2::eCopy;
+        release.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+        release.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+        release.newLayout = releaseLayout;
+        release.srcQueueFamilyIndex = transferOwnership ? m_transferFamily : VK_QUEUE_FAMILY_IGNORED;
+        release.dstQueueFamilyIndex = transferOwnership ? m_graphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+        release.image = imageCopy.dst->get();
+        release.subresourceRange = fullcolorrange(*imageCopy.dst);
+
+        if (transferOwnership)
+        {
+            vk::ImageMemoryBarrier2 acquire = release;
+            acquire.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+            acquire.srcAccessMask = vk::AccessFlagBits2::eNone;
+            if (imageCopy.generateMips)
+            {
+                acquire.dstStageMask = vk::PipelineStageFlagBits2::eBlit;
+                acquire.dstAccessMask = vk::AccessFlagBits2::eTransferRead | vk::AccessFlagBits2::eTransferWrite;
+            }
+            else
+            {
+                acquire.dstStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+                acquire.dstAccessMask = vk::AccessFlagBits2::eMemoryRead;
+            }
+            imageAcquires.push_back(acquire);
+        }
+        else
+        {
+            // 布局转换必须在信号量触发之前完成
+            release.dstStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+        }
+        imageReleases.push_back(release);
+    }
+
+    if (!bufferReleases.empty() || !imageReleases.empty())
+    {
+        vk::DependencyInfo dependencyInfo{};
+        dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferReleases.size());
+        dependencyInfo.pBufferMemoryBarriers = bufferReleases.data();
+        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(imageReleases.size());
+        dependencyInfo.pImageMemoryBarriers = imageReleases.data();
+        cmd.pipelineBarrier2(dependencyInfo);
+    }
+
+    cmd.end();
+
+    // 传输队列提交：完成时传输时间线（无所有权转移时即票据时间线）达到 transferValue
+    vk::CommandBufferSubmitInfo transferCmdInfo{};
+    transferCmdInfo.commandBuffer = cmd;
+
+    vk::SemaphoreSubmitInfo transferSignal{};
+    transferSignal.semaphore = transferOwnership ? m_transferTimeline : m_timeline;
+    transferSignal.value = batch.transferValue;
+    transferSignal.stageMask = vk::PipelineStageFlagBits2::eAllCommands;
+
+    vk::SubmitInfo2 transferSubmit{};
+    transferSubmit.commandBufferInfoCount = 1;
+    transferSubmit.pCommandBufferInfos = &transferCmdInfo;
+    transferSubmit.signalSemaphoreInfoCount = 1;
+    transferSubmit.pSignalSemaphoreInfos = &transferSignal;
+
+    try
+    {
+        // 上传可能在解码线程上触发提交，与其他线程对同一队列的提交互斥
+        const vk::Queue transferQueue = m_device.getTransferQueue();
+        std::lock_guard<std::mutex> queueLock(m_device.getQueueMutex(transferQueue));
+        transferQueue.submit2(transferSubmit);
+    }
+    catch (const vk::SystemError &e)
+    {
+        throw std::runtime_error("UploadQueue: Failed to submit transfer batch: " + std::string(e.what()));
+    }
+
+    // 图形队列获取所有权：等待传输完成后触发批次票据
+    if (transferOwnership)
+    {
+        batch.acquireCmd = m_graphicsCommands->allocate(vk::CommandBufferLevel::ePrimary);
+        vk::CommandBuffer acquireCmd = *batch.acquireCmd;
+        acquireCmd.begin(beginInfo);
+
+        if (!bufferAcquires.empty() || !imageAcquires.empty())
+        {
+            vk::DependencyInfo dependencyInfo{};
+            dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferAcquires.size());
+            dependencyInfo.pBufferMemoryBarriers = bufferAcquires.data();
+            dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(imageAcquires.size());
+            dependencyInfo.pImageMemoryBarriers = imageAcquires.data();
+            acquireCmd.pipelineBarrier2(dependencyInfo);
+        }
+
+        // 传输队列不支持 blit，mip 链在获取所有权之后于图形队列上生成
+        for (const auto &imageCopy : batch.imageCopies)
+        {
+            if (imageCopy.generateMips)
+            {
+                recordmipchain(acquireCmd, *imageCopy.dst, imageCopy.finalLayout);
+            }
+        }
+
+        acquireCmd.end();
+
+        vk::CommandBufferSubmitInfo acquireCmdInfo{};
+        acquireCmdInfo.commandBuffer = acquireCmd;
+
+        vk::SemaphoreSubmitInfo acquireWait{};
+        acquireWait.semaphore = m_transferTimeline;
+        acquireWait.value = batch.transferValue;
+        acquireWait.stageMask = vk::PipelineStageFlagBits2::eAllCommands;
+
+        vk::SemaphoreSubmitInfo acquireSignal{};
+        acquireSignal.semaphore = m_timeline;
+        acquireSignal.value = batch.ticket;
+        acquireSignal.stageMask = vk::PipelineStageFlagBits2::eAllCommands;
+
+        vk::SubmitInfo2 acquireSubmit{};
+        acquireSubmit.waitSemaphoreInfoCount = 1;
+        acquireSubmit.pWaitSemaphoreInfos = &acquireWait;
+        acquireSubmit.commandBufferInfoCount = 1;
+        acquireSubmit.pCommandBufferInfos = &acquireCmdInfo;
+        acquireSubmit.signalSemaphoreInfoCount = 1;
+        acquireSubmit.pSignalSemaphoreInfos = &acquireSignal;
+
+        try
+        {
+            const vk::Queue graphicsQueue = m_device.getGraphicsQueue();
+            std::lock_guard<std::mutex> queueLock(m_device.getQueueMutex(graphicsQueue));
+            graphicsQueue.submit2(acquireSubmit);
+        }
+        catch (const vk::SystemError &e)
+        {
+            throw std::runtime_error("UploadQueue: Failed to submit ownership acquire: " + std::string(e.what()));
+        }
+    }
+
+    m_submittedTicket = batch.ticket;
+    m_stats.submittedBatches++;
+
+    m_inFlight.push_back(std::move(batch));
+    m_pending.reset();
+}
+
+void UploadQueue::retirecompleted()
+{
+    if (!m_inFlight.empty())
+    {
+        uint64_t completed = m_device.get().getSemaphoreCounterValue(m_timeline);
+        while (!m_inFlight.empty() && m_inFlight.front().ticket <= completed)
+        {
+            m_ringTail = m_inFlight.front().ringEnd;
+            m_inFlight.pop_front();
+        }
+    }
+
+    // 没有任何批次引用暂存区时整个环形缓冲区空闲
+    if (m_inFlight.empty() && !m_pending)
+    {
+        m_ringTail = m_ringHead;
+    }
+}
+
+void UploadQueue::flushifneeded(const Batch &batch)
+{
+    // 解码线程上的上传不提交：隐藏在上传调用中的队列提交会与所有者线程的提交竞争
+    if (m_flushThreshold > 0 && batch.pendingBytes >= m_flushThreshold &&
+        std::this_thread::get_id() == m_ownerThread)
+    {
+        submitbatch();
+    }
+}
+
+void UploadQueue::waitvalue(UploadTicket value) const
+{
+    if (value == 0)
+    {
+        return;
+    }
+
+    vk::SemaphoreWaitInfo waitInfo{};
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &m_timeline;
+    waitInfo.pValues = &value;
+
+    if (m_device.get().waitSemaphores(waitInfo, UINT64_MAX) != vk::Result::eSuccess)
+    {
+        throw std::runtime_error("UploadQueue: Failed to wait for upload timeline");
+    }
+}
+
+} // namespace vkcore
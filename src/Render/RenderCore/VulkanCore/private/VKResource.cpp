@@ -1,8 +1,59 @@
 #include "VKResource.hpp"
+#include <algorithm>
+#include <vector>
 
 namespace vkcore
 {
 
+namespace
+{
+
+VkBufferCreateInfo makebuffercreateinfo(const BufferDesc &desc)
+{
+    VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bufferInfo.size = desc.size;
+    bufferInfo.usage = static_cast<VkBufferUsageFlags>(desc.usageFlags);
+    return bufferInfo;
+}
+
+VkImageCreateInfo makeimagecreateinfo(const ImageDesc &desc)
+{
+    VkImageCreateInfo imageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+    imageInfo.imageType = static_cast<VkImageType>(desc.imageType);
+    imageInfo.format = static_cast<VkFormat>(desc.format);
+    imageInfo.extent = {desc.extent.width, desc.extent.height, desc.extent.depth};
+    imageInfo.mipLevels = desc.mipLevels;
+    imageInfo.arrayLayers = desc.arrayLayers;
+    imageInfo.samples = static_cast<VkSampleCountFlagBits>(desc.samples);
+    imageInfo.tiling = static_cast<VkImageTiling>(desc.tiling);
+    imageInfo.usage = static_cast<VkImageUsageFlags>(desc.usage);
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (desc.queueFamilies.size() > 1)
+    {
+        // 多个队列族直接访问（例如图形队列渲染、传输队列回读），省去所有权转移屏障
+        imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        imageInfo.queueFamilyIndexCount = static_cast<uint32_t>(desc.queueFamilies.size());
+        imageInfo.pQueueFamilyIndices = desc.queueFamilies.data();
+    }
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (desc.sparseResidency)
+    {
+        imageInfo.flags |= VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
+    }
+    if (desc.cubeCompatible)
+    {
+        imageInfo.flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+    }
+    return imageInfo;
+}
+
+uint64_t sparsetilekey(uint32_t x, uint32_t y)
+{
+    return (static_cast<uint64_t>(y) << 32) | x;
+}
+
+} // namespace
+
 GpuResource::GpuResource(std::string name, vk::Device device) : m_name(name), m_device(device)
 {
 }
@@ -10,13 +61,26 @@ GpuResource::GpuResource(std::string name, vk::Device device) : m_name(name), m_
 Buffer::Buffer(std::string name, Device &device, VmaAllocator allocator, const BufferDesc &desc)
     : GpuResource(name, device.get()), m_allocator(allocator), m_size(desc.size), m_usage(desc.usageFlags)
 {
-    VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-    bufferInfo.size = desc.size;
-    bufferInfo.usage = static_cast<VkBufferUsageFlags>(desc.usageFlags);
+    VkBufferCreateInfo bufferInfo = makebuffercreateinfo(desc);
 
     VmaAllocationCreateInfo allocInfo = {};
     allocInfo.usage = desc.memoryUsage;
     allocInfo.flags = desc.allocationCreateFlags;
+    if (desc.mapping != BufferMapping::None)
+    {
+        constexpr VmaAllocationCreateFlags kHostAccess = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+                                                         VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+        allocInfo.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        if (!(allocInfo.flags & kHostAccess))
+        {
+            allocInfo.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+        }
+        // 未设置 ALLOW_TRANSFER_INSTEAD：VMA 保证选到主机可见内存，优先 DEVICE_LOCAL | HOST_VISIBLE（ReBAR）
+        if (desc.mapping == BufferMapping::DeviceLocal)
+        {
+            allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        }
+    }
 
     //使用临时的VkBuffer句柄接受结果
     VkBuffer rawBuffer = VK_NULL_HANDLE;
@@ -33,7 +97,42 @@ Buffer::Buffer(std::string name, Device &device, VmaAllocator allocator, const B
     if (allocInfo.flags & VMA_ALLOCATION_CREATE_MAPPED_BIT)
     {
         m_mappedData = allocationDetails.pMappedData;
+        m_persistentlyMapped = m_mappedData != nullptr;
+    }
+    VkMemoryPropertyFlags memoryProperties = 0;
+    vmaGetAllocationMemoryProperties(m_allocator, m_allocation, &memoryProperties);
+    m_memoryProperties = vk::MemoryPropertyFlags(memoryProperties);
+
+    m_category = desc.category;
+    m_trackedBytes = allocationDetails.size;
+    MemoryMonitor::trackAllocation(m_category, m_trackedBytes);
+}
+
+Buffer::Buffer(std::string name, Device &device, VmaAllocator allocator, const BufferDesc &desc,
+               VmaAllocation aliasAllocation, vk::DeviceSize aliasOffset)
+    : GpuResource(name, device.get()), m_allocator(allocator), m_allocation(aliasAllocation), m_ownsAllocation(false),
+      m_size(desc.size), m_usage(desc.usageFlags)
+{
+    VkBufferCreateInfo bufferInfo = makebuffercreateinfo(desc);
+
+    VkBuffer rawBuffer = VK_NULL_HANDLE;
+    VkResult result = vkCreateBuffer(m_device, &bufferInfo, nullptr, &rawBuffer);
+    if (result != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create aliased buffer: " + std::to_string(result));
+    }
+
+    result = vmaBindBufferMemory2(m_allocator, m_allocation, aliasOffset, rawBuffer, nullptr);
+    if (result != VK_SUCCESS)
+    {
+        vkDestroyBuffer(m_device, rawBuffer, nullptr);
+        throw std::runtime_error("Failed to bind aliased buffer memory: " + std::to_string(result));
     }
+
+    m_buffer = vk::Buffer(rawBuffer);
+    VkMemoryPropertyFlags memoryProperties = 0;
+    vmaGetAllocationMemoryProperties(m_allocator, m_allocation, &memoryProperties);
+    m_memoryProperties = vk::MemoryPropertyFlags(memoryProperties);
 }
 
 Buffer::~Buffer()
@@ -41,10 +140,20 @@ Buffer::~Buffer()
     release();
 }
 
+vk::MemoryRequirements Buffer::getMemoryRequirements(Device &device, const BufferDesc &desc)
+{
+    VkBufferCreateInfo bufferInfo = makebuffercreateinfo(desc);
+    vk::DeviceBufferMemoryRequirements requirementsInfo{};
+    requirementsInfo.pCreateInfo = reinterpret_cast<const vk::BufferCreateInfo *>(&bufferInfo);
+    return device.get().getBufferMemoryRequirements(requirementsInfo).memoryRequirements;
+}
+
 vk::DeviceAddress Buffer::getDeviceAddress() const
 {
     if (!m_buffer)
         throw std::runtime_error("Buffer is not created.");
+    if (!(m_usage & vk::BufferUsageFlagBits::eShaderDeviceAddress))
+        throw std::runtime_error("Buffer '" + getName() + "' was not created with eShaderDeviceAddress usage.");
 
     vk::BufferDeviceAddressInfo addressInfo = {};
     addressInfo.buffer = m_buffer;
@@ -67,7 +176,7 @@ void *Buffer::map()
 
 void Buffer::ummap()
 {
-    if (m_mappedData)
+    if (m_mappedData && !m_persistentlyMapped)
     {
         vmaUnmapMemory(m_allocator, m_allocation);
         m_mappedData = nullptr;
@@ -81,12 +190,21 @@ void Buffer::write(const void *data, vk::DeviceSize size, vk::DeviceSize offset)
     if (offset + size > m_size)
         throw std::runtime_error("Write range exceeds buffer size.");
 
+    // 调用前已经映射（持久映射或调用方 map() 过）时保持映射，只有本次临时映射的才解除
+    const bool wasMapped = m_mappedData != nullptr;
     void *mapped = map();
     if (!mapped)
         throw std::runtime_error("Failed to map buffer memory.");
 
     std::memcpy(static_cast<uint8_t *>(mapped) + offset, data, size);
-    ummap();
+    if (!(m_memoryProperties & vk::MemoryPropertyFlagBits::eHostCoherent))
+    {
+        vmaFlushAllocation(m_allocator, m_allocation, offset, size);
+    }
+    if (!wasMapped)
+    {
+        ummap();
+    }
 }
 
 void Buffer::flush(vk::DeviceSize size, vk::DeviceSize offset)
@@ -99,11 +217,31 @@ void Buffer::flush(vk::DeviceSize size, vk::DeviceSize offset)
     vmaFlushAllocation(m_allocator, m_allocation, offset, size);
 }
 
+void Buffer::invalidate(vk::DeviceSize size, vk::DeviceSize offset)
+{
+    if (!m_buffer)
+        throw std::runtime_error("Buffer is not created.");
+    if (offset + size > m_size && size != VK_WHOLE_SIZE)
+        throw std::runtime_error("Invalidate range exceeds buffer size.");
+
+    vmaInvalidateAllocation(m_allocator, m_allocation, offset, size);
+}
+
 void Buffer::release()
 {
     if (m_buffer)
     {
-        vmaDestroyBuffer(m_allocator, static_cast<VkBuffer>(m_buffer), m_allocation);
+        if (m_ownsAllocation)
+        {
+            ummap(); // 由 map() 建立的映射须在释放前解除，持久映射由 VMA 随分配一起释放
+            vmaDestroyBuffer(m_allocator, static_cast<VkBuffer>(m_buffer), m_allocation);
+            MemoryMonitor::trackFree(m_category, m_trackedBytes);
+            m_trackedBytes = 0;
+        }
+        else
+        {
+            m_device.destroyBuffer(m_buffer);
+        }
         m_buffer = nullptr;
         m_allocation = nullptr;
         m_mappedData = nullptr;
@@ -116,17 +254,14 @@ Image::Image(std::string name, Device &device, VmaAllocator allocator, const Ima
       m_mipLevels(desc.mipLevels), m_arrayLayers(desc.arrayLayers), m_usage(desc.usage),
       m_currentLayout(vk::ImageLayout::eUndefined)
 {
-    VkImageCreateInfo imageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
-    imageInfo.imageType = static_cast<VkImageType>(desc.imageType);
-    imageInfo.format = static_cast<VkFormat>(desc.format);
-    imageInfo.extent = {desc.extent.width, desc.extent.height, desc.extent.depth};
-    imageInfo.mipLevels = desc.mipLevels;
-    imageInfo.arrayLayers = desc.arrayLayers;
-    imageInfo.samples = static_cast<VkSampleCountFlagBits>(desc.samples);
-    imageInfo.tiling = static_cast<VkImageTiling>(desc.tiling);
-    imageInfo.usage = static_cast<VkImageUsageFlags>(desc.usage);
-    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (desc.sparseResidency)
+    {
+        createsparse(desc);
+        createdefaultview(desc);
+        return;
+    }
+
+    VkImageCreateInfo imageInfo = makeimagecreateinfo(desc);
 
     VmaAllocationCreateInfo allocInfo = {};
     allocInfo.usage = desc.memoryUsage;
@@ -142,11 +277,257 @@ Image::Image(std::string name, Device &device, VmaAllocator allocator, const Ima
     }
 
     m_image = vk::Image(rawImage);
+    m_category = desc.category;
+    m_trackedBytes = allocationDetails.size;
+    MemoryMonitor::trackAllocation(m_category, m_trackedBytes);
+    createdefaultview(desc);
+}
+
+Image::Image(std::string name, Device &device, VmaAllocator allocator, const ImageDesc &desc,
+             VmaAllocation aliasAllocation, vk::DeviceSize aliasOffset)
+    : GpuResource(name, device.get()), m_allocator(allocator), m_allocation(aliasAllocation), m_ownsAllocation(false),
+      m_format(desc.format), m_extent(desc.extent), m_mipLevels(desc.mipLevels), m_arrayLayers(desc.arrayLayers),
+      m_usage(desc.usage), m_currentLayout(vk::ImageLayout::eUndefined)
+{
+    VkImageCreateInfo imageInfo = makeimagecreateinfo(desc);
 
+    VkImage rawImage = VK_NULL_HANDLE;
+    VkResult result = vkCreateImage(m_device, &imageInfo, nullptr, &rawImage);
+    if (result != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create aliased image: " + std::to_string(result));
+    }
+
+    result = vmaBindImageMemory2(m_allocator, m_allocation, aliasOffset, rawImage, nullptr);
+    if (result != VK_SUCCESS)
+    {
+        vkDestroyImage(m_device, rawImage, nullptr);
+        throw std::runtime_error("Failed to bind aliased image memory: " + std::to_string(result));
+    }
+
+    m_image = vk::Image(rawImage);
+    createdefaultview(desc);
+}
+
+vk::MemoryRequirements Image::getMemoryRequirements(Device &device, const ImageDesc &desc)
+{
+    VkImageCreateInfo imageInfo = makeimagecreateinfo(desc);
+    vk::DeviceImageMemoryRequirements requirementsInfo{};
+    requirementsInfo.pCreateInfo = reinterpret_cast<const vk::ImageCreateInfo *>(&imageInfo);
+    return device.get().getImageMemoryRequirements(requirementsInfo).memoryRequirements;
+}
+
+void Image::createsparse(const ImageDesc &desc)
+{
+    if (desc.imageType != vk::ImageType::e2D || desc.mipLevels != 1 || desc.arrayLayers != 1)
+    {
+        throw std::runtime_error("Image: sparse residency supports single-level 2D images only");
+    }
+
+    VkImageCreateInfo imageInfo = makeimagecreateinfo(desc);
+    VkImage rawImage = VK_NULL_HANDLE;
+    VkResult result = vkCreateImage(m_device, &imageInfo, nullptr, &rawImage);
+    if (result != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create sparse image: " + std::to_string(result));
+    }
+    const vk::Image image(rawImage);
+
+    // 稀疏 Image 的 alignment 即每个图块的字节数，memoryTypeBits 约束图块内存的类型
+    const vk::MemoryRequirements memory = m_device.getImageMemoryRequirements(image);
+    const std::vector<vk::SparseImageMemoryRequirements> sparse = m_device.getImageSparseMemoryRequirements(image);
+    auto color = std::find_if(sparse.begin(), sparse.end(), [](const vk::SparseImageMemoryRequirements &req) {
+        return static_cast<bool>(req.formatProperties.aspectMask & vk::ImageAspectFlagBits::eColor);
+    });
+    const bool needsMetadata = std::any_of(sparse.begin(), sparse.end(), [](const auto &req) {
+        return static_cast<bool>(req.formatProperties.aspectMask & vk::ImageAspectFlagBits::eMetadata);
+    });
+    // mip 0 落在 mip 尾部时只能整体绑定，不能按图块驻留
+    if (color == sparse.end() || needsMetadata || color->imageMipTailFirstLod == 0)
+    {
+        m_device.destroyImage(image);
+        throw std::runtime_error("Image: format does not support tiled sparse residency");
+    }
+
+    m_image = image;
+    m_ownsAllocation = false;
+    m_sparse = true;
+    m_category = desc.category;
+    m_sparseMemory = memory;
+    m_sparseTileExtent = color->formatProperties.imageGranularity;
+}
+
+bool Image::isSparseResidencySupported(Device &device, const ImageDesc &desc)
+{
+    if (desc.imageType != vk::ImageType::e2D || desc.mipLevels != 1 || desc.arrayLayers != 1)
+    {
+        return false;
+    }
+    if (!device.isFeatureEnabled("sparseBinding") || !device.isFeatureEnabled("sparseResidencyImage2D"))
+    {
+        return false;
+    }
+
+    const vk::PhysicalDevice physicalDevice = device.getPhysicalDevice();
+    const auto families = physicalDevice.getQueueFamilyProperties();
+    const uint32_t graphicsFamily = device.getGraphicsQueueFamilyIndices();
+    if (graphicsFamily >= families.size() ||
+        !(families[graphicsFamily].queueFlags & vk::QueueFlagBits::eSparseBinding))
+    {
+        return false;
+    }
+
+    const auto properties = physicalDevice.getSparseImageFormatProperties(desc.format, desc.imageType, desc.samples,
+                                                                          desc.usage, desc.tiling);
+    const bool hasColor = std::any_of(properties.begin(), properties.end(), [](const auto &property) {
+        return static_cast<bool>(property.aspectMask & vk::ImageAspectFlagBits::eColor);
+    });
+    const bool needsMetadata = std::any_of(properties.begin(), properties.end(), [](const auto &property) {
+        return static_cast<bool>(property.aspectMask & vk::ImageAspectFlagBits::eMetadata);
+    });
+    return hasColor && !needsMetadata;
+}
+
+void Image::bindSparseTiles(Device &device, std::span<const vk::Offset2D> tiles, bool resident)
+{
+    if (!m_sparse)
+    {
+        throw std::runtime_error("Image::bindSparseTiles: image was not created with sparse residency");
+    }
+
+    const uint32_t tileWidth = m_sparseTileExtent.width;
+    const uint32_t tileHeight = m_sparseTileExtent.height;
+    const uint32_t tilesX = (m_extent.width + tileWidth - 1) / tileWidth;
+    const uint32_t tilesY = (m_extent.height + tileHeight - 1) / tileHeight;
+
+    // 只处理状态需要改变的图块（同一批内重复的坐标只算一次）
+    std::vector<vk::Offset2D> changed;
+    std::vector<uint64_t> keys;
+    changed.reserve(tiles.size());
+    keys.reserve(tiles.size());
+    for (const vk::Offset2D &tile : tiles)
+    {
+        if (tile.x < 0 || tile.y < 0 || static_cast<uint32_t>(tile.x) >= tilesX ||
+            static_cast<uint32_t>(tile.y) >= tilesY)
+        {
+            throw std::runtime_error("Image::bindSparseTiles: tile out of range");
+        }
+        const uint64_t key = sparsetilekey(static_cast<uint32_t>(tile.x), static_cast<uint32_t>(tile.y));
+        if (m_sparseTiles.contains(key) == resident || std::find(keys.begin(), keys.end(), key) != keys.end())
+        {
+            continue;
+        }
+        changed.push_back(tile);
+        keys.push_back(key);
+    }
+    if (changed.empty())
+    {
+        return;
+    }
+
+    std::vector<VmaAllocation> allocations(changed.size(), nullptr);
+    std::vector<VmaAllocationInfo> allocationInfos(changed.size());
+    if (resident)
+    {
+        VkMemoryRequirements requirements{};
+        requirements.size = m_sparseMemory.alignment;
+        requirements.alignment = m_sparseMemory.alignment;
+        requirements.memoryTypeBits = m_sparseMemory.memoryTypeBits;
+        VmaAllocationCreateInfo allocInfo = {};
+        allocInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        VkResult result = vmaAllocateMemoryPages(m_allocator, &requirements, &allocInfo, allocations.size(),
+                                                 allocations.data(), allocationInfos.data());
+        if (result != VK_SUCCESS)
+        {
+            throw std::runtime_error("Image::bindSparseTiles: failed to allocate tile memory: " +
+                                     std::to_string(result));
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            allocations[i] = m_sparseTiles.at(keys[i]);
+        }
+    }
+
+    // 边缘图块的范围截到图像边界（Vulkan 允许不是图块整数倍的尾部范围）
+    std::vector<vk::SparseImageMemoryBind> binds(changed.size());
+    for (size_t i = 0; i < changed.size(); ++i)
+    {
+        const uint32_t x = static_cast<uint32_t>(changed[i].x) * tileWidth;
+        const uint32_t y = static_cast<uint32_t>(changed[i].y) * tileHeight;
+        vk::SparseImageMemoryBind &bind = binds[i];
+        bind.subresource = vk::ImageSubresource(vk::ImageAspectFlagBits::eColor, 0, 0);
+        bind.offset = vk::Offset3D(static_cast<int32_t>(x), static_cast<int32_t>(y), 0);
+        bind.extent =
+            vk::Extent3D(std::min(tileWidth, m_extent.width - x), std::min(tileHeight, m_extent.height - y), 1);
+        if (resident)
+        {
+            bind.memory = allocationInfos[i].deviceMemory;
+            bind.memoryOffset = allocationInfos[i].offset;
+        }
+    }
+
+    vk::SparseImageMemoryBindInfo imageBind(m_image, binds);
+    vk::BindSparseInfo bindInfo{};
+    bindInfo.imageBindCount = 1;
+    bindInfo.pImageBinds = &imageBind;
+
+    // isSparseResidencySupported() 要求图形队列族支持稀疏绑定
+    const vk::Queue queue = device.getGraphicsQueue();
+    const vk::Fence fence = m_device.createFence({});
+    vk::Result result;
+    {
+        std::lock_guard<std::mutex> queueLock(device.getQueueMutex(queue));
+        result = queue.bindSparse(1, &bindInfo, fence);
+    }
+    if (result == vk::Result::eSuccess)
+    {
+        result = m_device.waitForFences(fence, VK_TRUE, UINT64_MAX);
+    }
+    m_device.destroyFence(fence);
+    if (result != vk::Result::eSuccess)
+    {
+        if (resident)
+        {
+            vmaFreeMemoryPages(m_allocator, allocations.size(), allocations.data());
+        }
+        throw std::runtime_error("Image::bindSparseTiles: vkQueueBindSparse failed: " + vk::to_string(result));
+    }
+
+    const vk::DeviceSize bytes = m_sparseMemory.alignment * allocations.size();
+    if (resident)
+    {
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            m_sparseTiles.emplace(keys[i], allocations[i]);
+        }
+        m_trackedBytes += bytes;
+        MemoryMonitor::trackAllocation(m_category, bytes);
+    }
+    else
+    {
+        for (uint64_t key : keys)
+        {
+            m_sparseTiles.erase(key);
+        }
+        vmaFreeMemoryPages(m_allocator, allocations.size(), allocations.data());
+        m_trackedBytes -= bytes;
+        MemoryMonitor::trackFree(m_category, bytes);
+    }
+}
+
+void Image::createdefaultview(const ImageDesc &desc)
+{
     // 创建默认的 ImageView
     vk::ImageViewCreateInfo viewInfo = {};
     viewInfo.image = m_image;
     viewInfo.viewType = (desc.arrayLayers == 1) ? vk::ImageViewType::e2D : vk::ImageViewType::e2DArray;
+    if (desc.cubeCompatible)
+    {
+        viewInfo.viewType = (desc.arrayLayers == 6) ? vk::ImageViewType::eCube : vk::ImageViewType::eCubeArray;
+    }
     viewInfo.format = desc.format;
 
     // 根据格式判断 AspectMask
@@ -189,7 +570,29 @@ void Image::release()
     }
     if (m_image)
     {
-        vmaDestroyImage(m_allocator, static_cast<VkImage>(m_image), m_allocation);
+        if (m_sparse)
+        {
+            // 调用者保证 GPU 已不再访问：先销毁 Image，再释放绑定到它的图块内存
+            m_device.destroyImage(m_image);
+            for (const auto &[key, allocation] : m_sparseTiles)
+            {
+                vmaFreeMemory(m_allocator, allocation);
+            }
+            m_sparseTiles.clear();
+            MemoryMonitor::trackFree(m_category, m_trackedBytes);
+            m_trackedBytes = 0;
+            m_sparse = false;
+        }
+        else if (m_ownsAllocation)
+        {
+            vmaDestroyImage(m_allocator, static_cast<VkImage>(m_image), m_allocation);
+            MemoryMonitor::trackFree(m_category, m_trackedBytes);
+            m_trackedBytes = 0;
+        }
+        else
+        {
+            m_device.destroyImage(m_image);
+        }
         m_image = nullptr;
         m_allocation = nullptr;
         m_format = vk::Format::eUndefined;
@@ -6,7 +6,8 @@ VmaAllocator VmaManager::s_Allocator = nullptr;
 VmaVulkanFunctions VmaManager::s_VulkanFunctions = {};
 bool VmaManager::s_Initialized = false;
 
-void VmaManager::Initialize(vk::Instance instance, vk::PhysicalDevice physicalDevice, vk::Device device)
+void VmaManager::Initialize(vk::Instance instance, vk::PhysicalDevice physicalDevice, vk::Device device,
+                            VmaAllocatorCreateFlags flags)
 {
     if (s_Initialized)
         return;
@@ -19,6 +20,7 @@ void VmaManager::Initialize(vk::Instance instance, vk::PhysicalDevice physicalDe
     allocatorInfo.physicalDevice = physicalDevice;
     allocatorInfo.device = device;
     allocatorInfo.pVulkanFunctions = &s_VulkanFunctions;
+    allocatorInfo.flags = flags;
 
     VkResult result = vmaCreateAllocator(&allocatorInfo, &s_Allocator);
     if (result != VK_SUCCESS)
@@ -0,0 +1,546 @@
+#include "WorkerPool.hpp"
+#include "Log.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/**
+ * @file WorkerPool.cpp
+ * @brief WorkerPool 类的实现文件
+ */
+
+namespace vkcore
+{
+
+namespace
+{
+
+constexpr int64_t kInitialDequeCapacity = 256;               ///< 双端队列初始容量（2 的幂，满时翻倍）
+constexpr uint32_t kHelpSpinCount = 64;                      ///< 帮助等待时找不到任务后先让出的次数
+constexpr auto kHelpSleep = std::chrono::microseconds(100); ///< 之后每次阻塞等待的上限
+
+thread_local const WorkerPool *t_pool = nullptr;
+thread_local uint32_t t_workerIndex = WorkerPool::kInvalidWorker;
+
+/**
+ * @brief 把当前线程绑定到一个逻辑核心（不支持的平台上忽略）
+ */
+void pincurrentthread(uint32_t cpu)
+{
+#ifdef _WIN32
+    // 只处理第一个处理器组（64 个逻辑核心以内）
+    if (cpu < 64)
+    {
+        SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+    }
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+} // namespace
+
+// ==================== 任务与双端队列 ====================
+
+struct WorkerPool::Task
+{
+    std::function<void()> func;
+    TaskGroup *group = nullptr;
+};
+
+/**
+ * Chase-Lev 工作窃取双端队列（Lê 等人的 C11 内存序版本）：
+ * 所属线程在底部 push/pop，其他线程在顶部 steal。扩容后旧环保留到析构，窃取者可能仍在读取
+ */
+class WorkerPool::TaskDeque
+{
+  public:
+    TaskDeque()
+    {
+        m_rings.push_back(std::make_unique<Ring>(kInitialDequeCapacity));
+        m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
+    }
+
+    void push(Task *task)
+    {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_acquire);
+        Ring *ring = m_ring.load(std::memory_order_relaxed);
+        if (bottom - top > ring->mask)
+        {
+            ring = grow(ring, top, bottom);
+        }
+        ring->slot(bottom).store(task, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    Task *pop()
+    {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        Ring *ring = m_ring.load(std::memory_order_relaxed);
+        // bottom 的写入与 top 的读取不能重排（即论文中的 seq_cst 栅栏），这里用 seq_cst 操作表达
+        m_bottom.store(bottom, std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_seq_cst);
+
+        if (top > bottom)
+        {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Task *task = ring->slot(bottom).load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+            // 最后一个元素：与窃取者竞争
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                task = nullptr;
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    Task *steal()
+    {
+        int64_t top = m_top.load(std::memory_order_seq_cst);
+        const int64_t bottom = m_bottom.load(std::memory_order_seq_cst);
+        if (top >= bottom)
+        {
+            return nullptr;
+        }
+
+        Ring *ring = m_ring.load(std::memory_order_acquire);
+        Task *task = ring->slot(top).load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return nullptr; // 被其他窃取者或所属线程抢先
+        }
+        return task;
+    }
+
+  private:
+    struct Ring
+    {
+        explicit Ring(int64_t capacity)
+            : mask(capacity - 1), slots(std::make_unique<std::atomic<Task *>[]>(static_cast<size_t>(capacity)))
+        {
+        }
+
+        std::atomic<Task *> &slot(int64_t index)
+        {
+            return slots[static_cast<size_t>(index & mask)];
+        }
+
+        int64_t mask;
+        std::unique_ptr<std::atomic<Task *>[]> slots;
+    };
+
+    Ring *grow(Ring *ring, int64_t top, int64_t bottom)
+    {
+        auto grown = std::make_unique<Ring>((ring->mask + 1) * 2);
+        for (int64_t i = top; i < bottom; ++i)
+        {
+            grown->slot(i).store(ring->slot(i).load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        m_rings.push_back(std::move(grown));
+        m_ring.store(m_rings.back().get(), std::memory_order_release);
+        return m_rings.back().get();
+    }
+
+  private:
+    alignas(64) std::atomic<int64_t> m_top{0};
+    alignas(64) std::atomic<int64_t> m_bottom{0};
+    std::atomic<Ring *> m_ring{nullptr};
+    std::vector<std::unique_ptr<Ring>> m_rings; ///< 只由所属线程修改
+};
+
+struct WorkerPool::Worker
+{
+    TaskDeque deque;
+    std::thread thread;
+    std::string name; ///< 分析器线程名（需要在线程生命周期内保持有效）
+};
+
+// ==================== TaskGroup ====================
+
+WorkerPool::TaskGroup::~TaskGroup()
+{
+    waitidle();
+}
+
+void WorkerPool::TaskGroup::run(std::function<void()> task)
+{
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    m_pool.submit(std::move(task), this);
+}
+
+void WorkerPool::TaskGroup::then(std::function<void()> continuation)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (m_pending.load(std::memory_order_acquire) != 0)
+        {
+            m_continuations.push_back(std::move(continuation));
+            return;
+        }
+    }
+    m_pool.enqueue(std::move(continuation));
+}
+
+void WorkerPool::TaskGroup::wait()
+{
+    waitidle();
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        error = std::exchange(m_error, nullptr);
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void WorkerPool::TaskGroup::finishone(std::exception_ptr error)
+{
+    WorkerPool &pool = m_pool; // 计数归零并解锁后本组可能已被销毁
+    std::vector<std::function<void()>> continuations;
+    {
+        // 计数在锁内归零：等待者随后获取一次锁，就能确认最后一个任务已不再访问本组
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (error && !m_error)
+        {
+            m_error = std::move(error);
+        }
+        if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            continuations.swap(m_continuations);
+            m_cv.notify_all();
+        }
+    }
+
+    for (auto &continuation : continuations)
+    {
+        pool.enqueue(std::move(continuation));
+    }
+}
+
+void WorkerPool::TaskGroup::waitidle()
+{
+    const uint32_t workerIndex = m_pool.getWorkerIndex();
+    if (workerIndex != kInvalidWorker)
+    {
+        m_pool.helpuntilidle(*this, workerIndex);
+    }
+
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_cv.wait(lock, [this]() { return m_pending.load(std::memory_order_acquire) == 0; });
+}
+
+// ==================== WorkerPool ====================
+
+WorkerPool::WorkerPool(uint32_t threadCount, bool pinThreads) : m_pinned(pinThreads)
+{
+    const uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    if (threadCount == 0)
+    {
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+    m_threadCount = threadCount;
+
+    // 先创建全部队列，线程启动后立即可能互相窃取
+    m_workers.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+        m_workers.back()->name = "Worker " + std::to_string(i);
+    }
+
+    for (uint32_t i = 0; i < threadCount; ++i)
+    {
+        m_workers[i]->thread = std::thread([this, i, hardwareThreads]() {
+            if (m_pinned)
+            {
+                pincurrentthread((i + 1) % hardwareThreads);
+            }
+            workerloop(i);
+        });
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMtx);
+        m_stopping = true;
+    }
+    m_sleepCv.notify_all();
+
+    for (auto &worker : m_workers)
+    {
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+    }
+}
+
+uint32_t WorkerPool::getWorkerIndex() const
+{
+    return t_pool == this ? t_workerIndex : kInvalidWorker;
+}
+
+void WorkerPool::enqueue(std::function<void()> task)
+{
+    submit(std::move(task), nullptr);
+}
+
+void WorkerPool::submit(std::function<void()> func, TaskGroup *group)
+{
+    Task *task = new Task{std::move(func), group};
+
+    // 计数先于入队递增：休眠线程看到计数为 0 时，投递者必然随后看到它在休眠并唤醒它
+    m_queuedTasks.fetch_add(1, std::memory_order_seq_cst);
+
+    const uint32_t workerIndex = getWorkerIndex();
+    if (workerIndex != kInvalidWorker)
+    {
+        m_workers[workerIndex]->deque.push(task);
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(m_injectMtx);
+        m_injected.push_back(task);
+        m_injectedCount.fetch_add(1, std::memory_order_release);
+    }
+
+    if (m_sleepers.load(std::memory_order_seq_cst) > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMtx);
+        m_sleepCv.notify_one();
+    }
+}
+
+WorkerPool::Task *WorkerPool::findtask(uint32_t workerIndex)
+{
+    Task *task = nullptr;
+
+    // 1. 自己的队列（后进先出）
+    if (workerIndex != kInvalidWorker)
+    {
+        task = m_workers[workerIndex]->deque.pop();
+    }
+
+    // 2. 注入队列（先进先出）
+    if (!task && m_injectedCount.load(std::memory_order_acquire) > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_injectMtx);
+        if (!m_injected.empty())
+        {
+            task = m_injected.front();
+            m_injected.pop_front();
+            m_injectedCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    // 3. 从下一个线程开始依次窃取，避免所有空闲线程挤在同一个受害者上
+    if (!task)
+    {
+        const uint32_t start = workerIndex != kInvalidWorker ? workerIndex + 1 : 0;
+        for (uint32_t offset = 0; offset < m_threadCount && !task; ++offset)
+        {
+            const uint32_t victim = (start + offset) % m_threadCount;
+            if (victim != workerIndex)
+            {
+                task = m_workers[victim]->deque.steal();
+            }
+        }
+        if (task)
+        {
+            m_stealCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (task)
+    {
+        m_queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+void WorkerPool::runtask(Task *task)
+{
+    std::exception_ptr error;
+    {
+        QTR_PROFILE_SCOPE("WorkerPool::task");
+        try
+        {
+            task->func();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+    }
+
+    TaskGroup *group = task->group;
+    delete task;
+
+    if (group)
+    {
+        group->finishone(std::move(error));
+    }
+    else if (error)
+    {
+        try
+        {
+            std::rethrow_exception(error);
+        }
+        catch (const std::exception &e)
+        {
+            QTR_LOG_ERROR("WorkerPool", "Unhandled exception in task: " << e.what());
+        }
+        catch (...)
+        {
+            QTR_LOG_ERROR("WorkerPool", "Unhandled non-standard exception in task");
+        }
+    }
+}
+
+void WorkerPool::helpuntilidle(TaskGroup &group, uint32_t workerIndex)
+{
+    uint32_t idleSpins = 0;
+    while (!group.isIdle())
+    {
+        if (Task *task = findtask(workerIndex))
+        {
+            runtask(task);
+            idleSpins = 0;
+            continue;
+        }
+
+        // 组内剩余任务正在其他线程上执行：先让出，之后短暂阻塞，期间可能有新任务可帮忙
+        if (++idleSpins < kHelpSpinCount)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(group.m_mtx);
+        group.m_cv.wait_for(lock, kHelpSleep, [&group]() { return group.isIdle(); });
+    }
+}
+
+void WorkerPool::parallelFor(uint32_t count, const std::function<void(uint32_t)> &func)
+{
+    parallelFor(count, 1, [&func](uint32_t begin, uint32_t end) {
+        for (uint32_t index = begin; index < end; ++index)
+        {
+            func(index);
+        }
+    });
+}
+
+void WorkerPool::parallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)> &func)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    grainSize = std::max(grainSize, 1u);
+    const uint32_t chunkCount = (count - 1) / grainSize + 1;
+    if (chunkCount == 1)
+    {
+        func(0, count);
+        return;
+    }
+
+    // 所有参与者从同一个原子游标领取块；辅助任务开始时块可能已被领完，此时直接返回
+    std::atomic<uint32_t> nextChunk{0};
+    auto drain = [&]() {
+        for (uint32_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed); chunk < chunkCount;
+             chunk = nextChunk.fetch_add(1, std::memory_order_relaxed))
+        {
+            const uint32_t begin = chunk * grainSize;
+            func(begin, std::min(begin + grainSize, count));
+        }
+    };
+
+    // 调用线程也参与执行，因此最多需要 chunkCount - 1 个辅助任务
+    TaskGroup group(*this);
+    const uint32_t helperCount = std::min(m_threadCount, chunkCount - 1);
+    for (uint32_t i = 0; i < helperCount; ++i)
+    {
+        group.run(drain);
+    }
+
+    std::exception_ptr callerError;
+    try
+    {
+        drain();
+    }
+    catch (...)
+    {
+        callerError = std::current_exception();
+        nextChunk.store(chunkCount, std::memory_order_relaxed); // 剩余的块不再执行
+    }
+
+    // 辅助任务引用了本栈帧上的对象，必须等它们全部退出
+    group.waitidle();
+    if (callerError)
+    {
+        std::rethrow_exception(callerError);
+    }
+    group.wait();
+}
+
+void WorkerPool::workerloop(uint32_t workerIndex)
+{
+    t_pool = this;
+    t_workerIndex = workerIndex;
+    QTR_PROFILE_THREAD(m_workers[workerIndex]->name.c_str());
+
+    while (true)
+    {
+        if (Task *task = findtask(workerIndex))
+        {
+            runtask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMtx);
+        if (m_stopping && m_queuedTasks.load(std::memory_order_seq_cst) == 0)
+        {
+            return;
+        }
+
+        m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+        m_sleepCv.wait(lock, [this]() { return m_stopping || m_queuedTasks.load(std::memory_order_seq_cst) > 0; });
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace vkcore
@@ -1,7 +1,18 @@
+/**
+ * @file CommandPoolManager.hpp
+ * @brief 按线程划分的命令池与命令缓冲区分配
+ * @details 两种模式：
+ *          - 逐缓冲区回收：句柄析构时缓冲区回到所属线程的空闲队列，下次分配时单独重置
+ *          - 帧环：每个（线程, 在途帧）一个命令池，该帧在帧时间线上退休后用 vkResetCommandPool 整体重置，
+ *            分配只是在预先分配的缓冲区上顺序取用，不加锁也不逐个重置
+ */
+
 #pragma once
 
 #include "Device.hpp"
+#include <array>
 #include <atomic>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -15,15 +26,66 @@ namespace vkcore
 
 // 前置声明
 class CommandPoolManager;
+class FrameTimeline;
+
+/**
+ * @struct ThreadCommandPool
+ * @brief 每个线程的命令池及其缓冲区池
+ */
+struct ThreadCommandPool
+{
+    vk::CommandPool pool;                               ///< Vulkan 命令池
+    std::queue<vk::CommandBuffer> freePrimaryBuffers;   ///< 空闲的主命令缓冲区
+    std::queue<vk::CommandBuffer> freeSecondaryBuffers; ///< 空闲的次级命令缓冲区
+    std::mutex freeMtx;                                 ///< 保护空闲队列（句柄可能在其他线程析构）
+    std::atomic<size_t> allocatedCount{0};              ///< 已分配的总数（统计用）
+    std::atomic<size_t> inUseCount{0}; ///< 正在使用中的命令缓冲区数量（防止悬空引用）
+
+    ThreadCommandPool(vk::CommandPool p) : pool(p)
+    {
+    }
+};
+
+/**
+ * @struct FrameCommandPool
+ * @brief 帧环模式下某个线程在某一帧使用的命令池
+ * @details 只由所属线程访问；缓冲区存放在 deque 中，增长时已有元素的地址不变，句柄直接指向元素
+ */
+struct FrameCommandPool
+{
+    vk::CommandPool pool;                           ///< Vulkan 命令池（不带 eResetCommandBuffer）
+    uint64_t frame = 0;                             ///< 最近一次使用该池的帧号
+    std::deque<vk::CommandBuffer> primaryBuffers;   ///< 已分配的主命令缓冲区
+    std::deque<vk::CommandBuffer> secondaryBuffers; ///< 已分配的次级命令缓冲区
+    size_t primaryUsed = 0;                         ///< 本帧已取用的主命令缓冲区数量
+    size_t secondaryUsed = 0;                       ///< 本帧已取用的次级命令缓冲区数量
+};
+
+/**
+ * @struct ThreadFrameRing
+ * @brief 帧环模式下一个线程的所有帧命令池
+ * @details 池的数量随在途帧数自适应（通常为在途帧数 + 1）：切换到新帧时复用任意一个已退休的池，没有则新建
+ */
+struct ThreadFrameRing
+{
+    std::vector<std::unique_ptr<FrameCommandPool>> pools; ///< 只由所属线程增删
+    FrameCommandPool *current = nullptr;                  ///< 当前帧使用的池
+    std::atomic<size_t> poolCount{0};                     ///< 池数量（统计用）
+    std::atomic<size_t> allocatedCount{0};                ///< 已分配的缓冲区总数（统计用）
+    std::atomic<size_t> resetCount{0};                    ///< 整池重置次数（统计用）
+};
 
 /**
  * @struct CommandBufferDeleter
  * @brief 自定义删除器，用于 unique_ptr，自动回收命令缓冲区到对象池
+ * @details 记录分配时所属的线程命令池，句柄可以在任意线程析构，
+ *          缓冲区总是回到分配它的那个命令池。帧环模式下 pool 为空，析构不做任何事（缓冲区随帧整体回收）
  */
 struct CommandBufferDeleter
 {
     CommandPoolManager *pool = nullptr;
     vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary;
+    ThreadCommandPool *owner = nullptr; ///< 分配该缓冲区的线程命令池
 
     void operator()(vk::CommandBuffer *buffer) const;
 };
@@ -34,26 +96,19 @@ struct CommandBufferDeleter
  */
 using CommandBufferHandle = std::unique_ptr<vk::CommandBuffer, CommandBufferDeleter>;
 
-/**
- * @struct ThreadCommandPool
- * @brief 每个线程的命令池及其缓冲区池
- */
-struct ThreadCommandPool
-{
-    vk::CommandPool pool;                               ///< Vulkan 命令池
-    std::queue<vk::CommandBuffer> freePrimaryBuffers;   ///< 空闲的主命令缓冲区
-    std::queue<vk::CommandBuffer> freeSecondaryBuffers; ///< 空闲的次级命令缓冲区
-    std::atomic<size_t> allocatedCount{0};              ///< 已分配的总数（统计用）
-    std::atomic<size_t> inUseCount{0}; ///< 正在使用中的命令缓冲区数量（防止悬空引用）
-
-    ThreadCommandPool(vk::CommandPool p) : pool(p)
-    {
-    }
-};
-
 /**
  * @class CommandPoolManager
  * @brief 管理每个线程的命令池，提供线程安全的命令缓冲区分配与复用
+ *
+ * @example
+ * @code
+ * // 帧环模式：每帧录制的命令缓冲区
+ * vkcore::CommandPoolManager frameCommands(device, device.getGraphicsQueueFamilyIndices(),
+ *                                          swapchain.getFrameTimeline());
+ *
+ * // 每帧（任意录制线程）
+ * vkcore::CommandBufferHandle cmd = frameCommands.allocate(); // 已处于初始状态，直接 begin()
+ * @endcode
  */
 class CommandPoolManager
 {
@@ -64,6 +119,17 @@ class CommandPoolManager
      * @param queueFamilyIndex 命令池关联的队列族索引
      */
     CommandPoolManager(Device &device, uint32_t queueFamilyIndex);
+
+    /**
+     * @brief 构造函数（帧环模式）
+     * @param device Device 引用（不拥有，需确保生命周期）
+     * @param queueFamilyIndex 命令池关联的队列族索引
+     * @param timeline 帧时间线：分配使用其当前帧号，帧退休后该帧的命令池在所属线程下次分配时整体重置
+     * @warning 分配的缓冲区只在本帧有效：必须在本帧提交，且提交位于触发本帧时间线值的那次提交之前（或就是它）；
+     *          句柄析构不回收缓冲区，也不能对其单独 reset()。时间线必须比本对象活得久，或先调用 detachFrameTimeline()
+     */
+    CommandPoolManager(Device &device, uint32_t queueFamilyIndex, FrameTimeline &timeline);
+
     ~CommandPoolManager();
 
     /** 禁用拷贝与移动 */
@@ -117,16 +183,30 @@ class CommandPoolManager
 
     /**
      * @brief 获取当前线程的命令池，若不存在则创建
-     * @return vk::CommandPool 当前线程的命令池句柄
+     * @return vk::CommandPool 当前线程的命令池句柄（帧环模式下为当前帧的命令池，随该帧整体重置）
      */
     vk::CommandPool getCommandPool();
 
     /**
      * @brief 重置指定线程的命令池（会清空所有缓冲区池）
      * @param threadId 线程ID，默认为当前线程
+     * @throws std::runtime_error 帧环模式（命令池随帧退休自动重置）
      */
     void resetCommandPool(std::thread::id threadId = std::this_thread::get_id());
 
+    /**
+     * @brief 是否为帧环模式
+     */
+    bool isFrameRing() const
+    {
+        return m_frameRing;
+    }
+
+    /**
+     * @brief 解除与帧时间线的关联（帧环模式下之后的分配会抛出异常，已分配的命令池保留到 cleanup()）
+     */
+    void detachFrameTimeline();
+
     /**
      * @brief 清理所有命令池资源
      */
@@ -140,9 +220,11 @@ class CommandPoolManager
      */
     struct PoolStats
     {
-        size_t totalThreadPools;      ///< 线程命令池总数
+        size_t totalThreadPools;      ///< 线程命令池总数（帧环模式下为线程数）
         size_t totalAllocatedBuffers; ///< 已分配的命令缓冲区总数
-        size_t totalFreeBuffers;      ///< 空闲命令缓冲区总数
+        size_t totalFreeBuffers;      ///< 空闲命令缓冲区总数（仅逐缓冲区回收模式）
+        size_t totalFramePools;       ///< 帧命令池总数（仅帧环模式）
+        size_t totalPoolResets;       ///< 帧命令池整体重置次数（仅帧环模式）
     };
 
     /**
@@ -150,6 +232,14 @@ class CommandPoolManager
      */
     PoolStats getStats() const;
 
+    /**
+     * @brief 获取命令池关联的队列族索引
+     */
+    uint32_t getQueueFamilyIndex() const
+    {
+        return m_queueFamilyIndex;
+    }
+
   private:
     /**
      * @brief 为当前线程创建命令池
@@ -160,7 +250,23 @@ class CommandPoolManager
     /**
      * @brief 获取或创建当前线程的命令池
      */
-    std::shared_ptr<ThreadCommandPool> getorcreatethreadpool();
+    ThreadCommandPool *getorcreatethreadpool();
+
+    /**
+     * @brief 获取或创建当前线程的帧环（帧环模式）
+     */
+    ThreadFrameRing *getorcreatethreadring();
+
+    /**
+     * @brief 取得当前线程在当前帧的命令池：切换到新帧时复用一个已退休的池（整体重置），没有则新建
+     */
+    FrameCommandPool &acquireframepool(ThreadFrameRing &ring);
+
+    /**
+     * @brief 帧环模式的分配：在当前帧的命令池上顺序取用，用完时批量追加分配
+     * @return 指向 deque 元素的指针（地址在命令池销毁前保持不变）
+     */
+    vk::CommandBuffer *allocatefromring(vk::CommandBufferLevel level);
 
     /**
      * @brief 内部实现：从对象池或新分配获取命令缓冲区
@@ -171,19 +277,55 @@ class CommandPoolManager
      * @brief 回收命令缓冲区到对象池（由 CommandBufferDeleter 调用）
      * @param buffer 要回收的命令缓冲区
      * @param level 命令缓冲区级别
+     * @param owner 分配该缓冲区的线程命令池
+     */
+    void recycle(vk::CommandBuffer buffer, vk::CommandBufferLevel level, ThreadCommandPool *owner);
+
+    /**
+     * @struct ThreadCacheEntry
+     * @brief 线程局部缓存的一项（对象由管理器的映射表持有，缓存只保存指针）
+     */
+    struct ThreadCacheEntry
+    {
+        uint64_t owner = 0; ///< 所属管理器的实例序号（0 表示空）
+        ThreadCommandPool *pool = nullptr;
+        ThreadFrameRing *ring = nullptr;
+    };
+
+    /**
+     * @brief 查找当前线程缓存中属于本管理器的项，没有时返回空
      */
-    void recycle(vk::CommandBuffer buffer, vk::CommandBufferLevel level);
+    ThreadCacheEntry *findcacheentry() const;
+
+    /**
+     * @brief 把本管理器的线程对象写入当前线程缓存（替换最早写入的一项）
+     */
+    ThreadCacheEntry &insertcacheentry();
 
   private:
+    static constexpr size_t kThreadCacheSize = 4; ///< 每个线程缓存的管理器数量
+    static constexpr uint32_t kRingGrowth = 4;    ///< 帧命令池每次至少追加分配的缓冲区数量
+
     Device &m_device;            ///< Device 引用
     uint32_t m_queueFamilyIndex; ///< 队列族索引
+    uint64_t m_instanceId;       ///< 实例序号（区分线程局部缓存属于哪个管理器，cleanup() 后更换）
     mutable std::mutex m_mtx;    ///< 保护共享数据的互斥锁
     std::unordered_map<std::thread::id, std::shared_ptr<ThreadCommandPool>> m_threadPools; ///< 线程ID到命令池的映射
 
+    // 帧环模式
+    bool m_frameRing = false;                ///< 构造时确定
+    FrameTimeline *m_timeline = nullptr;     ///< 由外部持有
+    uint32_t m_retireCallbackId = 0;         ///< 在 m_timeline 上注册的退休回调
+    std::atomic<uint64_t> m_retiredFrame{0}; ///< 最新退休的帧号（退休回调写入，任意录制线程读取）
+    std::unordered_map<std::thread::id, std::unique_ptr<ThreadFrameRing>> m_threadRings; ///< 线程ID到帧环的映射
+
     /**
-     * @brief 线程局部缓存，避免每次查找 map
+     * @brief 线程局部缓存，避免每次加锁查找 map
+     * @details 同一线程通常交替使用多个管理器（例如图形与异步计算各一个，并行录制时每个工作线程都是如此），
+     *          因此每个线程缓存最多 kThreadCacheSize 个管理器，按实例序号匹配
      */
-    static thread_local std::shared_ptr<ThreadCommandPool> t_threadPool;
+    static thread_local std::array<ThreadCacheEntry, kThreadCacheSize> t_threadCache;
+    static thread_local uint32_t t_threadCacheNext;
 
     friend struct CommandBufferDeleter;
 };
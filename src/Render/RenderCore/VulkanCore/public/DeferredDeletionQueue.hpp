@@ -0,0 +1,148 @@
+/**
+ * @file DeferredDeletionQueue.hpp
+ * @brief 按帧号延迟销毁 GPU 资源
+ * @details 资源（vkcore::Buffer / Image 或任意销毁操作）入队时记录当前帧号，
+ *          在该帧于 FrameTimeline 上退休后才真正销毁。在途帧仍可能引用的资源因此可以随时释放，
+ *          流式加载/卸载关卡时不再需要 waitIdle。
+ */
+
+#pragma once
+
+#include "FrameTimeline.hpp"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace vkcore
+{
+
+/**
+ * @class DeferredDeletionQueue
+ * @brief 帧号索引的延迟销毁队列
+ *
+ * @example
+ * @code
+ * vkcore::DeferredDeletionQueue deletionQueue;
+ * deletionQueue.attach(swapchain.getFrameTimeline()); // 帧退休时自动销毁
+ *
+ * // 任意线程：本帧的命令可能仍引用 buffer，延迟到本帧退休后销毁
+ * deletionQueue.destroy(std::move(buffer));
+ * deletionQueue.enqueue([device, sampler]() { device.destroySampler(sampler); });
+ * @endcode
+ *
+ * @note enqueue()/destroy() 是线程安全的；销毁操作在帧退休回调（即调用 FrameTimeline 的线程）上执行。
+ *       同一帧内入队的操作按入队顺序执行
+ * @warning 共享资源只延迟释放入队的这一份引用，其他持有者仍决定资源的最终销毁时机
+ */
+class DeferredDeletionQueue
+{
+  public:
+    using Deleter = std::function<void()>;
+
+    /**
+     * @brief 构造函数（未关联时间线，需要显式传入帧号或调用 attach()）
+     */
+    DeferredDeletionQueue() = default;
+
+    /**
+     * @brief 构造函数，并关联帧时间线
+     */
+    explicit DeferredDeletionQueue(FrameTimeline &timeline);
+
+    /**
+     * @brief 析构函数，执行所有未执行的销毁操作
+     * @warning 调用者需保证此时设备上没有引用这些资源的在途工作
+     */
+    ~DeferredDeletionQueue();
+
+    /** 禁用拷贝与移动 */
+    DeferredDeletionQueue(const DeferredDeletionQueue &) = delete;
+    DeferredDeletionQueue &operator=(const DeferredDeletionQueue &) = delete;
+
+    /**
+     * @brief 关联帧时间线：入队时使用其当前帧号，帧退休时自动执行到期的销毁
+     * @warning 时间线必须比本队列活得久，或在时间线销毁前调用 detach()
+     */
+    void attach(FrameTimeline &timeline);
+
+    /**
+     * @brief 解除与帧时间线的关联（已入队的操作保留，之后需手动 retire()/flush()）
+     */
+    void detach();
+
+    /**
+     * @brief 入队一个销毁操作，在 frame 退休后执行
+     * @param frame 最后可能引用该资源的帧号
+     */
+    void enqueue(uint64_t frame, Deleter deleter);
+
+    /**
+     * @brief 入队一个销毁操作，在关联时间线的当前帧退休后执行
+     * @throws std::runtime_error 如果未关联时间线
+     */
+    void enqueue(Deleter deleter);
+
+    /**
+     * @brief 延迟销毁独占资源（在关联时间线的当前帧退休后）
+     */
+    template <typename T> void destroy(std::unique_ptr<T> resource)
+    {
+        if (resource)
+        {
+            std::shared_ptr<T> holder = std::move(resource);
+            enqueue([holder]() mutable { holder.reset(); });
+        }
+    }
+
+    /**
+     * @brief 延迟释放共享资源的一份引用（在关联时间线的当前帧退休后）
+     */
+    template <typename T> void destroy(std::shared_ptr<T> resource)
+    {
+        if (resource)
+        {
+            enqueue([resource]() mutable { resource.reset(); });
+        }
+    }
+
+    /**
+     * @brief 执行所有帧号不大于 completedFrame 的销毁操作
+     */
+    void retire(uint64_t completedFrame);
+
+    /**
+     * @brief 立即执行所有销毁操作（设备空闲后调用）
+     */
+    void flush();
+
+    /**
+     * @brief 获取等待执行的销毁操作数量
+     */
+    size_t getPendingCount() const;
+
+  private:
+    /**
+     * @struct Entry
+     * @brief 一个待执行的销毁操作
+     */
+    struct Entry
+    {
+        uint64_t frame;
+        Deleter deleter;
+    };
+
+    mutable std::mutex m_mtx;
+    std::deque<Entry> m_entries; ///< 按帧号非递减排列
+
+    FrameTimeline *m_timeline = nullptr;
+    uint32_t m_callbackId = 0;
+
+    /**
+     * @brief 执行一批已出队的销毁操作（不持有锁，销毁操作中可以再次入队）
+     */
+    static void run(std::deque<Entry> &entries);
+};
+
+} // namespace vkcore
@@ -6,6 +6,7 @@
  * 该文件定义了 Vulkan 描述符系统的核心组件，包括：
  * - DescriptorLayoutCache：描述符集布局的缓存管理，避免重复创建相同布局
  * - DescriptorAllocator：描述符集的池化分配器，支持自动扩展和重用
+ * - FrameDescriptorAllocator：帧作用域的线性分配器，每线程独占池，分配路径无锁
  * - DescriptorLayoutBuilder：描述符集布局的构建器模式辅助类
  * - DescriptorUpdater：描述符集更新的辅助类，简化缓冲区和图像描述符的写入
  *
@@ -17,8 +18,11 @@
 #pragma once
 
 #include "Device.hpp"
+#include <atomic>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 #include <vulkan/vulkan.hpp>
@@ -250,6 +254,136 @@ class DescriptorAllocator
     mutable std::mutex m_mtx;
 };
 
+/**
+ * @class FrameDescriptorAllocator
+ * @brief 帧作用域的线性描述符集分配器。
+ *
+ * 每个在途帧、每个线程各自持有一组描述符池，分配只是从当前池中继续取（池满时切换到下一个），
+ * 不释放单个描述符集；该帧的栅栏 signal 之后调用 resetPools() 一次性重置该帧所有线程的池。
+ * 池不带 FREE_DESCRIPTOR_SET 标志，驱动可以按线性方式管理其内存。
+ *
+ * 适合每帧重建的临时描述符集（逐 Pass、逐绘制）；长期存在的描述符集仍使用 DescriptorAllocator。
+ *
+ * 使用示例：
+ * @code
+ * vkcore::FrameDescriptorAllocator frameDescriptors(device, framesInFlight);
+ * // 渲染线程：等待第 frameIndex 帧的栅栏后
+ * frameDescriptors.resetPools(frameIndex);
+ * // 任意录制线程：
+ * vk::DescriptorSet set = frameDescriptors.allocate(passLayout);
+ * @endcode
+ *
+ * 线程安全：allocate() 只访问调用线程自己的池，除每个线程首次分配时的注册外不加锁；
+ * resetPools() 必须在没有线程为该帧分配时调用（通常在渲染线程的帧开头）。
+ */
+class FrameDescriptorAllocator
+{
+  public:
+    /**
+     * @struct Stats
+     * @brief 分配器统计。
+     */
+    struct Stats
+    {
+        uint32_t threadCount{0}; ///< 分配过描述符集的线程数量
+        uint32_t poolCount{0};   ///< 所有线程、所有帧持有的池数量
+    };
+
+    /**
+     * @brief 构造函数。
+     * @param device 逻辑设备引用
+     * @param framesInFlight 在途帧数量（每帧独占一组池）
+     * @param setsPerPool 每个池可分配的描述符集数量（各类型描述符容量按比例放大）
+     * @throws std::invalid_argument 如果 framesInFlight 或 setsPerPool 为 0
+     */
+    FrameDescriptorAllocator(Device &device, uint32_t framesInFlight, uint32_t setsPerPool = 256);
+
+    /**
+     * @brief 析构函数，销毁所有线程的描述符池（调用方需保证 GPU 不再使用其中的描述符集）。
+     */
+    ~FrameDescriptorAllocator();
+
+    /** 禁用拷贝与移动 */
+    FrameDescriptorAllocator(const FrameDescriptorAllocator &) = delete;
+    FrameDescriptorAllocator &operator=(const FrameDescriptorAllocator &) = delete;
+
+    /**
+     * @brief 重置第 frameIndex 帧所有线程的描述符池，并把它设为当前帧。
+     *
+     * 先前为该帧分配的描述符集全部失效，池本身保留供该帧下次复用。
+     *
+     * @param frameIndex 在途帧索引（调用方保证该帧之前的 GPU 工作已完成）
+     * @throws std::invalid_argument 如果 frameIndex 越界
+     */
+    void resetPools(uint32_t frameIndex);
+
+    /**
+     * @brief 为当前帧分配一个描述符集（在下次 resetPools() 该帧之前有效）。
+     * @param layout 描述符集布局
+     * @return vk::DescriptorSet 描述符集句柄
+     * @throws std::runtime_error 如果空池也放不下该布局或分配失败
+     */
+    vk::DescriptorSet allocate(vk::DescriptorSetLayout layout);
+
+    /**
+     * @brief 获取统计。
+     */
+    Stats getStats() const;
+
+  private:
+    /**
+     * @struct FramePools
+     * @brief 一个线程在一个在途帧中使用的池。
+     */
+    struct FramePools
+    {
+        std::vector<vk::DescriptorPool> pools; ///< 按使用顺序排列，reset 后从头复用
+        size_t current{0};                     ///< 当前分配的池
+        uint32_t setsInCurrent{0};             ///< 当前池中已分配的描述符集数量
+    };
+
+    /**
+     * @struct ThreadPools
+     * @brief 一个线程在所有在途帧中的池。
+     */
+    struct ThreadPools
+    {
+        std::vector<FramePools> frames;
+    };
+
+    /**
+     * @brief 返回调用线程的池（线程局部缓存命中时不加锁）。
+     */
+    ThreadPools &threadpools();
+
+    /**
+     * @brief 创建一个线性描述符池。
+     */
+    vk::DescriptorPool createpool() const;
+
+  private:
+    /// 逻辑设备引用
+    Device &m_device;
+
+    /// 在途帧数量
+    uint32_t m_framesInFlight;
+
+    /// 每个池的描述符集数量
+    uint32_t m_setsPerPool;
+
+    /// 当前帧索引（resetPools() 写入，allocate() 读取）
+    std::atomic<uint32_t> m_frameIndex{0};
+
+    /// 全局唯一 ID（线程局部缓存以此识别分配器，避免地址复用造成误命中）
+    uint64_t m_id;
+
+    /// 各线程的池（只在注册与重置时访问容器本身）
+    std::unordered_map<std::thread::id, std::unique_ptr<ThreadPools>> m_threads;
+
+    /// 互斥锁，保护线程注册、重置与统计
+    mutable std::mutex m_mtx;
+};
+
 /**
  * @class DescriptorLayoutBuilder
  * @brief 描述符集布局构建器类，使用构建器模式简化布局创建。
@@ -6,6 +6,8 @@
  * 注意：该类不拥有 vk::Instance，仅持有引用，实例生命周期应先于 Device。
  */
 #pragma once
+#include <array>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
@@ -21,7 +23,7 @@ namespace vkcore
  * 主要职责：
  * - 查找并选择合适的物理设备（PhysicalDevice）
  * - 创建逻辑设备（vk::Device）
- * - 获取图形与呈现用队列（vk::Queue）
+ * - 获取图形、呈现、异步计算与传输用队列（vk::Queue）
  * - 提供对实例与物理设备的访问接口
  */
 class Device
@@ -29,17 +31,21 @@ class Device
   public:
     /**
      * @struct Config
-     * @brief 设备创建的配置信息（目前仅包含需要启用的设备扩展列表）。
+     * @brief 设备创建的配置信息（需要启用的设备扩展与各版本特性）。
      *
      * @property deviceExtensions 所需启用的设备扩展名称数组（以 const char* 表示）。
+     * @property optional_extensions 可选设备扩展：支持时启用，不参与设备筛选，之后可通过 isExtensionEnabled 查询
      */
     struct Config
     {
         std::vector<std::string> deviceExtensions;
+        std::vector<std::string> optional_extensions; ///< 可选设备扩展（例如 VK_EXT_graphics_pipeline_library）
         std::vector<std::string> vulkan1_3_features;
         std::vector<std::string> vulkan1_2_features;
         std::vector<std::string> vulkan1_1_features;
         std::vector<std::string> vulkan1_0_features;
+        std::vector<std::string> optional_features;           ///< 可选的 Vulkan 1.0 特性：支持时启用，不参与设备筛选
+        std::vector<std::string> optional_vulkan1_2_features; ///< 可选的 Vulkan 1.2 特性（例如 bindless 所需的描述符索引特性）
     };
 
     /**
@@ -50,11 +56,15 @@ class Device
      *
      * @property graphicsFamily 图形队列族索引
      * @property presentFamily  呈现队列族索引
+     * @property computeFamily  计算队列族索引（优先选择不支持图形的专用族，否则回退为图形族）
+     * @property transferFamily 传输队列族索引（优先选择仅支持传输的专用族，否则回退为计算族）
      */
     struct QueueFamilyIndices
     {
         std::optional<uint32_t> graphicsFamily;
         std::optional<uint32_t> presentFamily;
+        std::optional<uint32_t> computeFamily;
+        std::optional<uint32_t> transferFamily;
 
         bool isComplete() const
         {
@@ -73,6 +83,17 @@ class Device
      * 构造完成后将调用 init() 执行设备选择与创建流程。
      */
     Device(vk::Instance &instance, VkSurfaceKHR &surface, const Config &config = {});
+
+    /**
+     * @brief 构造无表面（headless）设备
+     *
+     * @constructor
+     * @param instance Vulkan 实例引用（不需要启用表面相关的实例扩展）
+     * @param config 设备配置（不应包含 VK_KHR_swapchain）
+     *
+     * 不查询呈现支持，呈现队列与图形队列相同；配合 OffscreenSwapChain 做离屏渲染与回读。
+     */
+    Device(vk::Instance &instance, const Config &config);
     ~Device();
 
     /** 禁用拷贝与移动语义 */
@@ -144,6 +165,88 @@ class Device
         return m_queueFamilyIndices.presentFamily.value();
     }
 
+    /**
+     * @brief 返回计算队列句柄。
+     * @return vk::Queue 计算队列（无专用计算族时与图形队列相同）。
+     */
+    inline vk::Queue getComputeQueue() const
+    {
+        return m_computeQueue;
+    }
+
+    /**
+     * @brief 返回传输队列句柄。
+     * @return vk::Queue 传输队列（无专用传输族时与计算队列相同）。
+     */
+    inline vk::Queue getTransferQueue() const
+    {
+        return m_transferQueue;
+    }
+
+    /**
+     * @brief 返回计算队列族索引信息。
+     * @return uint32_t 计算队列族索引。
+     */
+    inline uint32_t getComputeQueueFamilyIndices() const
+    {
+        return m_queueFamilyIndices.computeFamily.value();
+    }
+
+    /**
+     * @brief 返回传输队列族索引信息。
+     * @return uint32_t 传输队列族索引。
+     */
+    inline uint32_t getTransferQueueFamilyIndices() const
+    {
+        return m_queueFamilyIndices.transferFamily.value();
+    }
+
+    /**
+     * @brief 是否存在独立于图形族的计算队列族（可与图形工作并行执行的异步计算）。
+     */
+    inline bool hasDedicatedComputeQueue() const
+    {
+        return m_queueFamilyIndices.computeFamily != m_queueFamilyIndices.graphicsFamily;
+    }
+
+    /**
+     * @brief 是否存在独立于图形/计算族的传输队列族（通常对应 DMA 引擎）。
+     */
+    inline bool hasDedicatedTransferQueue() const
+    {
+        return m_queueFamilyIndices.transferFamily != m_queueFamilyIndices.graphicsFamily &&
+               m_queueFamilyIndices.transferFamily != m_queueFamilyIndices.computeFamily;
+    }
+
+    /**
+     * @brief 获取队列的提交互斥量
+     * @details Vulkan 要求同一 vk::Queue 上的 vkQueueSubmit(2)、vkQueuePresentKHR、vkQueueBindSparse 与
+     *          vkQueueWaitIdle 外部同步。没有专用队列族时多个 getter 返回同一个队列，它们也共用同一个互斥量；
+     *          任何线程向队列提交前都持有它（持有期间不要等待其他线程的提交）
+     * @throws std::invalid_argument 如果 queue 不是本设备的队列
+     */
+    std::mutex &getQueueMutex(vk::Queue queue) const;
+
+    /**
+     * @brief 查询特性是否已在逻辑设备上启用（必需特性或设备支持的可选特性）。
+     * @param feature 特性名称（与 Config 中使用的名称一致）
+     */
+    bool isFeatureEnabled(const std::string &feature) const;
+
+    /**
+     * @brief 查询设备扩展是否已在逻辑设备上启用（必需扩展或设备支持的可选扩展）。
+     * @param extension 扩展名称（例如 VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME）
+     */
+    bool isExtensionEnabled(const std::string &extension) const;
+
+    /**
+     * @brief 是否为无表面设备（headless 构造函数创建）。
+     */
+    inline bool isHeadless() const
+    {
+        return m_surface == VK_NULL_HANDLE;
+    }
+
     /**
      * @brief 释放由 Device 创建的资源（如逻辑设备），并进行必要的清理。
      *
@@ -166,9 +269,14 @@ class Device
      */
     vk::Instance &m_instance;
 
+    /**
+     * @brief headless 构造时 m_surface 引用的空表面句柄。
+     */
+    VkSurfaceKHR m_headlessSurface = VK_NULL_HANDLE;
+
     /**
      * @brief Vulkan 表面句柄，用于呈现相关操作（如交换链创建）。
-     * 注意：类不拥有表面，仅持有引用，表面生命周期应先于 Device。
+     * 注意：类不拥有表面，仅持有引用，表面生命周期应先于 Device；headless 设备引用 m_headlessSurface。
      */
     VkSurfaceKHR &m_surface;
 
@@ -189,6 +297,26 @@ class Device
      */
     vk::Queue m_presentQueue;
 
+    /**
+     * @brief 计算队列句柄：用于提交异步计算命令。
+     *
+     * 设备没有专用计算族时与图形队列相同。
+     */
+    vk::Queue m_computeQueue;
+
+    /**
+     * @brief 传输队列句柄：用于提交上传/拷贝命令。
+     *
+     * 设备没有专用传输族时与计算队列相同。
+     */
+    vk::Queue m_transferQueue;
+
+    /**
+     * @brief 不同的队列句柄（最多图形/呈现/计算/传输四个）与各自的提交互斥量，下标一一对应。
+     */
+    std::array<vk::Queue, 4> m_uniqueQueues{};
+    mutable std::array<std::mutex, 4> m_queueMutexes;
+
     /**
      * @brief 设备配置信息，用于检查物理设备特性
      */
@@ -208,7 +336,7 @@ class Device
     void selectphyscialdevice();
 
     /**
-     * @brief 查询并记录所选物理设备的队列族索引（图形/呈现）。
+     * @brief 查询并记录所选物理设备的队列族索引（图形/呈现/计算/传输）。
      *
      * 设置 QueueFamilyIndices 中的值以便创建逻辑设备时使用。
      */
@@ -242,6 +370,14 @@ class Device
      */
     bool checkspeficfeaturesupport(vk::PhysicalDevice &device, std::string feature);
 
+    /**
+     * @brief 检查物理设备是否支持可选扩展（含扩展依赖的特性，例如 graphicsPipelineLibrary）
+     * @param device 要检查的物理设备
+     * @param extension 扩展名称
+     * @return true 如果扩展可以启用
+     */
+    bool checkoptionalextensionsupport(vk::PhysicalDevice &device, const std::string &extension);
+
     /**
      * @brief 评价物理设备的适用性，返回评分值
      * @param device 要检查的物理设备
@@ -0,0 +1,199 @@
+/**
+ * @file FrameTimeline.hpp
+ * @brief 基于时间线信号量的帧节奏控制
+ * @details 每条队列持有一个单调递增的时间线信号量，第 N 帧的最后一次提交在各时间线上触发值 N。
+ *          开始第 N 帧前，CPU 只需等待各时间线达到 N - framesInFlight，取代每帧一个栅栏的等待/重置；
+ *          在途帧数可在运行时调整（2 为低延迟，3 为高吞吐）。帧退休（各时间线都已越过该帧）时
+ *          按注册顺序调用回调，上传、延迟销毁、查询读回等按帧回收的系统以此为准。
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkcore
+{
+
+/**
+ * @class FrameTimeline
+ * @brief 每队列一条时间线信号量的帧调度器
+ *
+ * @example
+ * @code
+ * vkcore::FrameTimeline timeline(device.get(), 2, 2); // 2 帧在途，图形 + 计算两条时间线
+ * timeline.addRetireCallback([&](uint64_t frame) { deletionQueue.retire(frame); });
+ *
+ * // 每帧
+ * uint64_t frame = timeline.beginFrame(); // 等待 frame - 2 完成
+ * vk::SemaphoreSubmitInfo signal = timeline.getSignalInfo(0);
+ * // ... 在该帧图形队列的最后一次提交中触发 signal ...
+ * @endcode
+ *
+ * @warning 每一帧都必须在每条时间线上触发恰好一次（没有工作的队列也要触发，或调用 cancelFrame()），
+ *          否则之后的 beginFrame() 会永远等待；除 getFrameNumber() 外本类不是线程安全的
+ */
+class FrameTimeline
+{
+  public:
+    /**
+     * @typedef RetireCallback
+     * @brief 帧退休回调，参数为最新退休的帧号（不大于它的帧都已退休）
+     */
+    using RetireCallback = std::function<void(uint64_t retiredFrame)>;
+
+    /**
+     * @brief 构造函数，创建时间线信号量（初始值 0）
+     * @param device 逻辑设备（需要启用 timelineSemaphore）
+     * @param framesInFlight 同时在途的帧数
+     * @param timelineCount 时间线数量（每条参与帧的队列一条）
+     * @throws std::invalid_argument 如果 framesInFlight 或 timelineCount 为 0
+     */
+    FrameTimeline(vk::Device device, uint32_t framesInFlight, uint32_t timelineCount = 1);
+
+    /**
+     * @brief 析构函数，等待所有已开始的帧完成后销毁信号量
+     */
+    ~FrameTimeline();
+
+    /** 禁用拷贝与移动 */
+    FrameTimeline(const FrameTimeline &) = delete;
+    FrameTimeline &operator=(const FrameTimeline &) = delete;
+
+    // ==================== 帧推进 ====================
+
+    /**
+     * @brief 开始新的一帧
+     * @details 帧号加一，CPU 等待帧号 - framesInFlight 的帧在所有时间线上完成，然后派发退休回调
+     * @return uint64_t 新帧的帧号（也是该帧需要触发的时间线值，从 1 开始）
+     */
+    uint64_t beginFrame();
+
+    /**
+     * @brief 当前帧没有提交任何工作（例如交换链过期）时在主机端触发其时间线值
+     * @details 先等待上一帧完成（主机触发的值不能小于尚未完成的 GPU 触发值），再逐条时间线触发当前帧号
+     */
+    void cancelFrame();
+
+    /**
+     * @brief 非阻塞地查询完成进度并派发退休回调
+     * @return uint64_t 最新退休的帧号
+     */
+    uint64_t poll();
+
+    /**
+     * @brief 在 CPU 上等待指定帧在所有时间线上完成
+     * @param frame 帧号
+     * @param timeout 超时（纳秒）
+     * @return 是否在超时前完成
+     */
+    bool wait(uint64_t frame, uint64_t timeout = UINT64_MAX);
+
+    /**
+     * @brief 等待所有已开始的帧完成
+     */
+    void waitIdle();
+
+    // ==================== 配置 ====================
+
+    /**
+     * @brief 调整在途帧数（下一次 beginFrame() 起生效；减小时该次等待会更深）
+     * @throws std::invalid_argument 如果 framesInFlight 为 0
+     */
+    void setFramesInFlight(uint32_t framesInFlight);
+
+    /**
+     * @brief 获取在途帧数
+     */
+    uint32_t getFramesInFlight() const
+    {
+        return m_framesInFlight;
+    }
+
+    // ==================== 查询 ====================
+
+    /**
+     * @brief 获取当前帧号（beginFrame() 之前为 0，可在任意线程上调用）
+     */
+    uint64_t getFrameNumber() const
+    {
+        return m_frameNumber;
+    }
+
+    /**
+     * @brief 获取当前帧的槽位（帧号 % framesInFlight），用于索引每帧资源
+     */
+    uint32_t getFrameSlot() const
+    {
+        return static_cast<uint32_t>(m_frameNumber % m_framesInFlight);
+    }
+
+    /**
+     * @brief 获取最新退休的帧号（上一次 poll() 的结果，不查询设备）
+     */
+    uint64_t getRetiredFrame() const
+    {
+        return m_retiredFrame;
+    }
+
+    /**
+     * @brief 获取时间线信号量
+     * @param timeline 时间线索引
+     */
+    vk::Semaphore getSemaphore(uint32_t timeline) const
+    {
+        return m_semaphores[timeline];
+    }
+
+    /**
+     * @brief 获取当前帧在指定时间线上的触发信息（用于 vkQueueSubmit2）
+     * @param timeline 时间线索引
+     * @param stages 触发阶段
+     */
+    vk::SemaphoreSubmitInfo getSignalInfo(
+        uint32_t timeline, vk::PipelineStageFlags2 stages = vk::PipelineStageFlagBits2::eAllCommands) const;
+
+    // ==================== 退休回调 ====================
+
+    /**
+     * @brief 注册帧退休回调
+     * @return uint32_t 回调 ID（用于 removeRetireCallback）
+     */
+    uint32_t addRetireCallback(RetireCallback callback);
+
+    /**
+     * @brief 注销帧退休回调
+     */
+    void removeRetireCallback(uint32_t id);
+
+  private:
+    /**
+     * @struct CallbackEntry
+     * @brief 已注册的退休回调
+     */
+    struct CallbackEntry
+    {
+        uint32_t id;
+        RetireCallback callback;
+    };
+
+    vk::Device m_device;
+    uint32_t m_framesInFlight;
+    std::vector<vk::Semaphore> m_semaphores; ///< 每条时间线一个
+
+    std::atomic<uint64_t> m_frameNumber{0}; ///< 当前帧号（其他线程可读，例如延迟销毁入队）
+    uint64_t m_retiredFrame = 0;            ///< 最新退休的帧号
+
+    std::vector<CallbackEntry> m_callbacks;
+    uint32_t m_nextCallbackId = 1;
+
+    /**
+     * @brief 派发退休回调（completed 大于已记录的退休帧号时）
+     */
+    void retire(uint64_t completed);
+};
+
+} // namespace vkcore
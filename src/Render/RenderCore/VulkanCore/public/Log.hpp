@@ -0,0 +1,89 @@
+/**
+ * @file Log.hpp
+ * @brief 分级日志，低于编译期级别的日志连同参数求值一起被编译掉
+ * @details QTR_LOG_INFO("RenderGraph", "Pass数量: " << count) 这样使用，第二个参数是流式拼接表达式。
+ *          编译期级别 QTR_LOG_LEVEL（0=Trace … 5=Off）默认 Debug 构建为 1、其余为 2，
+ *          可通过 CMake 缓存变量 QTRENDER_LOG_LEVEL 覆盖；运行期还可用 Log::setMinLevel() 进一步收紧。
+ *          约定：每帧都会执行的路径只用 Trace，编译/重建等偶发路径用 Debug，启动与关闭用 Info。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <sstream>
+#include <string>
+
+#ifndef QTR_LOG_LEVEL
+#ifdef NDEBUG
+#define QTR_LOG_LEVEL 2
+#else
+#define QTR_LOG_LEVEL 1
+#endif
+#endif
+
+namespace vkcore
+{
+
+/**
+ * @enum LogLevel
+ * @brief 日志级别（数值与 QTR_LOG_LEVEL 对应）
+ */
+enum class LogLevel : uint8_t
+{
+    Trace = 0, ///< 每帧路径的细节
+    Debug = 1, ///< 编译、重建等偶发路径
+    Info = 2,  ///< 启动、关闭与配置
+    Warn = 3,  ///< 可恢复的问题
+    Error = 4, ///< 操作失败
+    Off = 5    ///< 关闭
+};
+
+/**
+ * @class Log
+ * @brief 日志输出（线程安全，一条日志一行）
+ */
+class Log
+{
+  public:
+    using Sink = std::function<void(LogLevel level, const char *tag, const std::string &message)>;
+
+    /**
+     * @brief 运行期最低级别（只能在编译期级别之上进一步过滤）
+     */
+    static void setMinLevel(LogLevel level);
+
+    static bool isEnabled(LogLevel level);
+
+    /**
+     * @brief 替换输出目标（为空时恢复默认：Warn 及以上写 stderr，其余写 stdout）
+     */
+    static void setSink(Sink sink);
+
+    /**
+     * @brief 输出一条日志（通常通过 QTR_LOG_* 宏调用）
+     */
+    static void write(LogLevel level, const char *tag, const std::string &message);
+};
+
+} // namespace vkcore
+
+#define QTR_LOG(level, tag, message)                                                                                   \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if constexpr (static_cast<int>(level) >= QTR_LOG_LEVEL)                                                        \
+        {                                                                                                              \
+            if (::vkcore::Log::isEnabled(level))                                                                       \
+            {                                                                                                          \
+                std::ostringstream qtrLogStream;                                                                       \
+                qtrLogStream << message;                                                                               \
+                ::vkcore::Log::write(level, tag, qtrLogStream.str());                                                  \
+            }                                                                                                          \
+        }                                                                                                              \
+    } while (false)
+
+#define QTR_LOG_TRACE(tag, message) QTR_LOG(::vkcore::LogLevel::Trace, tag, message)
+#define QTR_LOG_DEBUG(tag, message) QTR_LOG(::vkcore::LogLevel::Debug, tag, message)
+#define QTR_LOG_INFO(tag, message) QTR_LOG(::vkcore::LogLevel::Info, tag, message)
+#define QTR_LOG_WARN(tag, message) QTR_LOG(::vkcore::LogLevel::Warn, tag, message)
+#define QTR_LOG_ERROR(tag, message) QTR_LOG(::vkcore::LogLevel::Error, tag, message)
@@ -0,0 +1,84 @@
+/**
+ * @file MappedFile.hpp
+ * @brief 只读内存映射文件
+ * @details 把整个文件映射到进程地址空间，解析器直接在映射内存上扫描，
+ *          省去 ifstream 的逐行拷贝与一次完整的读入缓冲区分配。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace vkcore
+{
+
+/**
+ * @class MappedFile
+ * @brief RAII 只读文件映射（Windows: CreateFileMapping，POSIX: mmap）
+ *
+ * @example
+ * @code
+ * vkcore::MappedFile file("assets/car/car.obj");
+ * file.prefault(); // 可选：在 I/O 线程上把页面读入页缓存
+ * parse(file.data(), file.size());
+ * @endcode
+ *
+ * @note 映射在对象析构前保持有效；空文件映射成功但 data() 为 nullptr
+ */
+class MappedFile
+{
+  public:
+    /**
+     * @brief 构造函数，打开并映射文件
+     * @param filePath 文件路径
+     * @throws std::runtime_error 如果文件不存在或映射失败
+     */
+    explicit MappedFile(const std::filesystem::path &filePath);
+
+    /**
+     * @brief 析构函数，解除映射并关闭文件
+     */
+    ~MappedFile();
+
+    /** 禁用拷贝与移动 */
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&) = delete;
+    MappedFile &operator=(MappedFile &&) = delete;
+
+    /**
+     * @brief 获取映射内存起始地址
+     */
+    const char *data() const
+    {
+        return m_data;
+    }
+
+    /**
+     * @brief 获取文件大小（字节）
+     */
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    /**
+     * @brief 逐页读取一次映射内存，把文件内容读入页缓存
+     * @details 用于把磁盘 I/O 留在 I/O 线程，后续解析不再因缺页阻塞在磁盘上
+     */
+    void prefault() const;
+
+  private:
+    const char *m_data = nullptr;
+    size_t m_size = 0;
+
+#ifdef _WIN32
+    void *m_fileHandle = nullptr;    ///< HANDLE
+    void *m_mappingHandle = nullptr; ///< HANDLE
+#else
+    int m_fd = -1;
+#endif
+};
+
+} // namespace vkcore
@@ -0,0 +1,246 @@
+/**
+ * @file MemoryMonitor.hpp
+ * @brief 显存预算跟踪、分类统计与内存报告
+ * @details 每帧通过 vmaGetHeapBudgets 读取各内存堆的预算与用量（分配器需以
+ *          VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT 创建并启用 VK_EXT_memory_budget，否则预算只是 VMA 的估计值）。
+ *          Buffer/Image 按描述符中的 MemoryCategory 把自身分配的字节数计入进程级分类统计，
+ *          设备本地堆的用量超过预算阈值时派发压力回调，供纹理流送与各类缓存淘汰资源。
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <vma/vk_mem_alloc.h>
+#include <vulkan/vulkan.hpp>
+
+namespace vkcore
+{
+
+/**
+ * @enum MemoryCategory
+ * @brief 分配的用途分类（只用于统计，不影响分配策略）
+ */
+enum class MemoryCategory : uint8_t
+{
+    Other,        ///< 未分类
+    Mesh,         ///< 顶点/索引缓冲区
+    Texture,      ///< 采样纹理
+    RenderTarget, ///< 持久渲染目标（深度缓冲、交换链外的离屏目标）
+    RDGTransient, ///< 渲染图瞬态资源（别名堆与每帧资源）
+    Staging,      ///< 上传暂存缓冲区
+    Uniform,      ///< 常量/每帧动态数据
+    Count
+};
+
+/**
+ * @brief 获取分类名称（用于报告）
+ */
+const char *toString(MemoryCategory category);
+
+/**
+ * @struct MemoryHeapBudget
+ * @brief 单个内存堆的预算与用量（最近一次 update() 的结果）
+ */
+struct MemoryHeapBudget
+{
+    uint32_t heapIndex = 0;
+    bool deviceLocal = false;           ///< 是否为设备本地堆
+    vk::DeviceSize heapSize = 0;        ///< 堆的物理大小
+    vk::DeviceSize budget = 0;          ///< 操作系统允许本进程使用的字节数
+    vk::DeviceSize usage = 0;           ///< 本进程当前使用的字节数（含其他 API 与驱动内部分配）
+    vk::DeviceSize blockBytes = 0;      ///< VMA 持有的内存块字节数
+    vk::DeviceSize allocationBytes = 0; ///< VMA 内存块中实际分配出的字节数
+    uint32_t blockCount = 0;            ///< VMA 内存块数量
+    uint32_t allocationCount = 0;       ///< VMA 分配数量
+};
+
+/**
+ * @struct MemoryPressure
+ * @brief 压力回调的参数
+ */
+struct MemoryPressure
+{
+    uint64_t frameIndex = 0;        ///< 触发时的帧号
+    uint32_t heapIndex = 0;         ///< 超过阈值的设备本地堆
+    vk::DeviceSize budget = 0;      ///< 堆预算
+    vk::DeviceSize usage = 0;       ///< 堆用量
+    vk::DeviceSize bytesToFree = 0; ///< 回到阈值以下需要释放的字节数
+    bool overBudget = false;        ///< 用量是否已超过预算本身（继续分配很可能失败或被换出到系统内存）
+};
+
+/**
+ * @class MemoryMonitor
+ * @brief VMA 显存预算监视器
+ *
+ * @example
+ * @code
+ * vkcore::MemoryMonitor monitor(allocator); // 默认阈值为预算的 90%
+ * monitor.addPressureCallback([&](const vkcore::MemoryPressure &pressure) {
+ *     transientAllocator.trim(); // 淘汰本帧未使用的瞬态堆
+ *     // ... 纹理流送按 pressure.bytesToFree 降低常驻 Mip ...
+ * });
+ *
+ * // 每帧
+ * monitor.update(frameNumber);
+ *
+ * // 调试
+ * monitor.writeJsonReport("memory.json");
+ * @endcode
+ *
+ * @note 分类统计是进程级的原子计数，可在任意线程上更新；监视器本身只在主线程上使用
+ */
+class MemoryMonitor
+{
+  public:
+    /**
+     * @typedef PressureCallback
+     * @brief 内存压力回调（用量超过阈值的每一帧、每个堆调用一次，消费者应逐帧增量释放）
+     */
+    using PressureCallback = std::function<void(const MemoryPressure &pressure)>;
+
+    /**
+     * @brief 构造函数
+     * @param allocator VMA 分配器
+     * @param pressureThreshold 触发压力回调的用量/预算比例
+     * @throws std::invalid_argument 如果 allocator 为空或阈值不在 (0, 1] 内
+     */
+    explicit MemoryMonitor(VmaAllocator allocator, float pressureThreshold = 0.9f);
+
+    /** 禁用拷贝与移动 */
+    MemoryMonitor(const MemoryMonitor &) = delete;
+    MemoryMonitor &operator=(const MemoryMonitor &) = delete;
+
+    // ==================== 每帧更新 ====================
+
+    /**
+     * @brief 刷新各堆的预算并派发压力回调
+     * @param frameIndex 当前帧号（同时传给 vmaSetCurrentFrameIndex，使 VMA 按帧刷新预算缓存）
+     */
+    void update(uint64_t frameIndex);
+
+    /**
+     * @brief 获取最近一次 update() 的各堆预算
+     */
+    const std::vector<MemoryHeapBudget> &getHeapBudgets() const
+    {
+        return m_heapBudgets;
+    }
+
+    /**
+     * @brief 获取所有设备本地堆的预算与用量之和
+     */
+    void getDeviceLocalTotals(vk::DeviceSize &budget, vk::DeviceSize &usage) const;
+
+    // ==================== 配置 ====================
+
+    /**
+     * @brief 设置压力阈值
+     * @throws std::invalid_argument 如果阈值不在 (0, 1] 内
+     */
+    void setPressureThreshold(float pressureThreshold);
+
+    float getPressureThreshold() const
+    {
+        return m_pressureThreshold;
+    }
+
+    // ==================== 压力回调 ====================
+
+    /**
+     * @brief 注册压力回调
+     * @return uint32_t 回调 ID（用于 removePressureCallback）
+     */
+    uint32_t addPressureCallback(PressureCallback callback);
+
+    /**
+     * @brief 注销压力回调
+     */
+    void removePressureCallback(uint32_t id);
+
+    // ==================== 分类统计 ====================
+
+    /**
+     * @brief 记录一次分配（由 Buffer/Image 与自行调用 vmaAllocateMemory 的系统调用）
+     */
+    static void trackAllocation(MemoryCategory category, vk::DeviceSize bytes);
+
+    /**
+     * @brief 记录一次释放（字节数必须与对应的 trackAllocation 相同）
+     */
+    static void trackFree(MemoryCategory category, vk::DeviceSize bytes);
+
+    /**
+     * @brief 获取分类当前的字节数
+     */
+    static vk::DeviceSize getCategoryBytes(MemoryCategory category);
+
+    /**
+     * @brief 获取分类当前的分配数量
+     */
+    static uint32_t getCategoryCount(MemoryCategory category);
+
+    // ==================== 报告 ====================
+
+    /**
+     * @brief 生成 JSON 报告：分类统计、各堆预算，以及 vmaBuildStatsString 的完整统计
+     * @param detailed 是否包含 VMA 的逐分配明细（可能很大）
+     */
+    std::string buildJsonReport(bool detailed = false) const;
+
+    /**
+     * @brief 生成 CSV 报告（每个分类、每个堆一行，便于在表格中对比多次采样）
+     */
+    std::string buildCsvReport() const;
+
+    /**
+     * @brief 把 JSON 报告写入文件
+     * @throws std::runtime_error 如果文件无法写入
+     */
+    void writeJsonReport(const std::string &path, bool detailed = false) const;
+
+    /**
+     * @brief 把 CSV 报告写入文件
+     * @throws std::runtime_error 如果文件无法写入
+     */
+    void writeCsvReport(const std::string &path) const;
+
+  private:
+    /**
+     * @struct CallbackEntry
+     * @brief 已注册的压力回调
+     */
+    struct CallbackEntry
+    {
+        uint32_t id;
+        PressureCallback callback;
+    };
+
+    /**
+     * @struct CategoryCounter
+     * @brief 一个分类的原子计数
+     */
+    struct CategoryCounter
+    {
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint32_t> count{0};
+    };
+
+    VmaAllocator m_allocator;
+    float m_pressureThreshold;
+    uint64_t m_frameIndex = 0;
+
+    std::vector<MemoryHeapBudget> m_heapBudgets;
+    std::vector<CallbackEntry> m_callbacks;
+    uint32_t m_nextCallbackId = 1;
+
+    /**
+     * @brief 进程级分类计数
+     */
+    static CategoryCounter &counter(MemoryCategory category);
+};
+
+} // namespace vkcore
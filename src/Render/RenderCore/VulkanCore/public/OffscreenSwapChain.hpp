@@ -0,0 +1,320 @@
+/**
+ * @file OffscreenSwapChain.hpp
+ * @brief 无表面的“虚拟交换链”：N 张离屏图像轮转，呈现即异步回读到主机内存
+ * @details 与 SwapChain 相同的获取/呈现约定，渲染代码可以不区分窗口与离屏：
+ *          - acquireNextImage() 按轮转顺序返回下一张图像，并在图形队列上提交一个空批次：
+ *            等待这张图像上一次的回读拷贝完成后触发本帧的图像可用信号量（CPU 不等待）；
+ *          - 渲染提交等待 getImageAvailableSemaphore(frameIndex)，触发 getRenderFinishedSemaphore(imageIndex)
+ *            与 getFrameSignalInfo()，并把图像转换到 kPresentLayout（对应窗口路径的 ePresentSrcKHR）；
+ *          - present() 在传输队列上提交预先录制的拷贝命令，等待渲染完成后把图像拷贝到这张图像专属的
+ *            持久映射主机缓冲（HOST_CACHED），完成时推进回读时间线；
+ *          - pollReadbacks() 非阻塞地按呈现顺序把已完成的帧交给回读回调，回调返回后缓冲才会被复用；
+ *            主机处理落后 imageCount 帧时 present() 阻塞等待最早的一帧（背压）。
+ *          图像以 CONCURRENT 方式在图形族与传输族之间共享，没有所有权转移；
+ *          关闭回读时 present() 只在图形队列上消费渲染完成信号量，用于只测吞吐的基准。
+ * @note 与 SwapChain 一样只应在渲染线程上使用；传输队列由调用者保证不被其他线程同时提交
+ */
+
+#pragma once
+
+#include "Device.hpp"
+#include "FrameTimeline.hpp"
+#include "VKResource.hpp"
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkcore
+{
+
+/**
+ * @struct ReadbackFrame
+ * @brief 一帧回读结果（data 只在回调期间有效）
+ */
+struct ReadbackFrame
+{
+    uint64_t frameNumber;                            ///< 渲染该图像的帧号
+    uint32_t imageIndex;                             ///< 图像索引
+    vk::Extent2D extent;                             ///< 图像尺寸
+    vk::Format format;                               ///< 像素格式
+    const void *data;                                ///< 像素数据（行紧密排列）
+    size_t rowPitch;                                 ///< 每行字节数
+    size_t size;                                     ///< 总字节数
+    std::chrono::steady_clock::time_point inputTime; ///< present() 传入的输入时刻
+};
+
+/**
+ * @class OffscreenSwapChain
+ * @brief 离屏渲染的图像环与异步回读
+ * @warning 不支持拷贝和移动
+ *
+ * @example
+ * @code
+ * vkcore::Device device(instance, deviceConfig); // headless 构造，不需要表面
+ * vkcore::OffscreenSwapChain::Config config;
+ * config.extent = {512, 512};
+ * vkcore::OffscreenSwapChain target(device, allocator, config);
+ * target.setReadbackCallback([](const vkcore::ReadbackFrame &frame) { writeThumbnail(frame); });
+ *
+ * for (const auto &job : jobs)
+ * {
+ *     uint32_t imageIndex = 0;
+ *     target.acquireNextImage(imageIndex);
+ *     // ... 以 RDGBuilder::getOffscreenAttachment(target, imageIndex) 导入并渲染（图末尾自动转换到
+ *     //     OffscreenSwapChain::kPresentLayout），提交时等待/触发对应信号量 ...
+ *     target.present(target.getRenderFinishedSemaphore(imageIndex), imageIndex);
+ *     target.advanceToNextFrame();
+ * }
+ * target.waitReadbacks();
+ * @endcode
+ */
+class OffscreenSwapChain
+{
+  public:
+    /// @brief 默认的在途帧数（与 SwapChain 相同）
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+
+    /// @brief present() 要求图像所处的布局（回读拷贝的源布局）
+    static constexpr vk::ImageLayout kPresentLayout = vk::ImageLayout::eTransferSrcOptimal;
+
+    using ReadbackCallback = std::function<void(const ReadbackFrame &frame)>;
+
+    /**
+     * @struct Config
+     * @brief 图像环配置
+     */
+    struct Config
+    {
+        vk::Extent2D extent{1280, 720};                        ///< 图像尺寸
+        vk::Format format = vk::Format::eR8G8B8A8Unorm;        ///< 像素格式（需为未压缩的颜色格式）
+        uint32_t imageCount = 3;                               ///< 图像数量（至少 framesInFlight + 1 时 CPU 不阻塞）
+        uint32_t framesInFlight = MAX_FRAMES_IN_FLIGHT;        ///< 在途帧数
+        bool readback = true;                                  ///< 是否回读到主机
+        vk::ImageUsageFlags extraUsage = vk::ImageUsageFlags(); ///< 附加用途（默认颜色附件 + 传输源 + 采样）
+    };
+
+    /**
+     * @brief 构造函数
+     * @param device 逻辑设备（通常为 headless 设备，也可与窗口共用同一设备）
+     * @param allocator VMA 分配器
+     * @param config 图像环配置
+     * @throws std::invalid_argument 如果尺寸、图像数、在途帧数为 0 或格式不受支持
+     */
+    OffscreenSwapChain(Device &device, VmaAllocator allocator, const Config &config = {});
+
+    /**
+     * @brief 析构函数，等待在途工作与回读后释放资源（未交付的回读直接丢弃）
+     */
+    ~OffscreenSwapChain();
+
+    /** 禁用拷贝和移动 */
+    OffscreenSwapChain(const OffscreenSwapChain &) = delete;
+    OffscreenSwapChain &operator=(const OffscreenSwapChain &) = delete;
+
+    /**
+     * @brief 获取下一张图像
+     * @param[out] imageIndex 图像索引（按轮转顺序）
+     * @return vk::Result 总是 eSuccess（与 SwapChain 的返回约定一致）
+     * @throws std::runtime_error 如果提交失败
+     */
+    vk::Result acquireNextImage(uint32_t &imageIndex);
+
+    /**
+     * @brief “呈现”一张图像：提交回读拷贝（或关闭回读时的空批次）
+     * @param renderFinishedSemaphore 渲染完成信号量
+     * @param imageIndex 图像索引
+     * @param inputTime 本帧的输入时刻（写入 ReadbackFrame::inputTime，默认取 acquireNextImage() 的时刻）
+     * @return vk::Result 总是 eSuccess
+     * @throws std::runtime_error 如果提交失败
+     */
+    vk::Result present(vk::Semaphore renderFinishedSemaphore, uint32_t imageIndex,
+                       std::chrono::steady_clock::time_point inputTime = {});
+
+    /**
+     * @brief 设置回读回调（在 pollReadbacks()/waitReadbacks()/present() 的调用线程上执行）
+     */
+    void setReadbackCallback(ReadbackCallback callback)
+    {
+        m_readbackCallback = std::move(callback);
+    }
+
+    /**
+     * @brief 交付所有已完成的回读（不阻塞）
+     * @return 本次交付的帧数
+     */
+    uint32_t pollReadbacks();
+
+    /**
+     * @brief 等待并交付所有已提交的回读
+     * @return 本次交付的帧数
+     */
+    uint32_t waitReadbacks();
+
+    /**
+     * @brief 改变图像尺寸
+     * @details 等待在途帧与回读全部完成（未交付的回读先交付）后重建图像与回读缓冲，代数加一
+     * @throws std::invalid_argument 如果尺寸为 0
+     */
+    void resize(vk::Extent2D extent);
+
+    /**
+     * @brief 获取图像资源（供 RDGBuilder::registerExternalTexture 导入）
+     */
+    inline Image &getImageResource(uint32_t index) const
+    {
+        return *m_images[index].image;
+    }
+
+    inline vk::Image getImage(uint32_t index) const
+    {
+        return m_images[index].image->get();
+    }
+
+    inline vk::ImageView getImageView(uint32_t index) const
+    {
+        return m_images[index].image->getView();
+    }
+
+    inline vk::Format getSwapchainFormat() const
+    {
+        return m_config.format;
+    }
+
+    inline vk::Extent2D getSwapchainExtent() const
+    {
+        return m_config.extent;
+    }
+
+    inline uint32_t getImageCount() const
+    {
+        return static_cast<uint32_t>(m_images.size());
+    }
+
+    /**
+     * @brief 获取指定帧索引的图像可用信号量
+     */
+    inline vk::Semaphore getImageAvailableSemaphore(uint32_t index) const
+    {
+        return m_imageAvailableSemaphores[index];
+    }
+
+    /**
+     * @brief 获取指定图像的渲染完成信号量
+     */
+    inline vk::Semaphore getRenderFinishedSemaphore(uint32_t index) const
+    {
+        return m_images[index].renderFinished;
+    }
+
+    inline FrameTimeline &getFrameTimeline()
+    {
+        return *m_timeline;
+    }
+
+    /**
+     * @brief 获取当前帧的时间线触发信息，该帧图形队列上的最后一次提交必须触发它
+     */
+    inline vk::SemaphoreSubmitInfo getFrameSignalInfo() const
+    {
+        return m_timeline->getSignalInfo(0);
+    }
+
+    inline uint32_t getCurrentFrameIndex() const
+    {
+        return m_timeline->getFrameSlot();
+    }
+
+    inline uint32_t getFramesInFlight() const
+    {
+        return m_timeline->getFramesInFlight();
+    }
+
+    /**
+     * @brief 获取代数（每次 resize() 加一，与 SwapChain::getGeneration 含义相同）
+     */
+    inline uint64_t getGeneration() const
+    {
+        return m_generation;
+    }
+
+    /**
+     * @brief 已交付的回读帧数
+     */
+    inline uint64_t getDeliveredFrames() const
+    {
+        return m_deliveredFrames;
+    }
+
+    /**
+     * @brief 推进到下一帧（等待复用同一帧索引的那一帧完成）
+     */
+    inline void advanceToNextFrame()
+    {
+        m_timeline->beginFrame();
+    }
+
+    /**
+     * @brief 释放所有资源
+     * @warning 调用者需保证设备上没有引用这些资源的在途工作
+     */
+    void cleanup();
+
+  private:
+    /**
+     * @struct RingImage
+     * @brief 图像环中的一项
+     */
+    struct RingImage
+    {
+        std::unique_ptr<Image> image;          ///< 离屏颜色图像
+        std::unique_ptr<Buffer> readback;      ///< 持久映射的回读缓冲（关闭回读时为空）
+        vk::CommandBuffer copyCommands;        ///< 预先录制的拷贝命令（关闭回读时为空）
+        vk::Semaphore renderFinished;          ///< 渲染完成信号量（二值）
+        uint64_t releaseValue = 0;             ///< 上一次使用在回读时间线上完成的值（0 表示未使用）
+    };
+
+    /**
+     * @struct PendingReadback
+     * @brief 已提交、尚未交付的回读
+     */
+    struct PendingReadback
+    {
+        uint32_t imageIndex;
+        uint64_t value; ///< 完成时回读时间线的值
+        uint64_t frameNumber;
+        std::chrono::steady_clock::time_point inputTime;
+    };
+
+    void createimages();
+    void destroyimages();
+    void recordcopy(RingImage &ring);
+    uint32_t deliver(bool wait, uint64_t untilValue);
+    void submit(vk::Queue queue, const vk::SemaphoreSubmitInfo *wait, vk::CommandBuffer commands,
+                const vk::SemaphoreSubmitInfo &signal);
+
+  private:
+    Device &m_device;
+    VmaAllocator m_allocator;
+    Config m_config;
+    size_t m_pixelBytes = 0;
+
+    std::unique_ptr<FrameTimeline> m_timeline;             ///< 图形队列的帧时间线
+    std::vector<vk::Semaphore> m_imageAvailableSemaphores; ///< 图像可用信号量（每帧一个）
+    std::vector<RingImage> m_images;
+    vk::CommandPool m_copyPool;                            ///< 传输族命令池（拷贝命令随图像重建）
+
+    vk::Semaphore m_readbackTimeline; ///< 回读完成时间线（关闭回读时由图形队列推进）
+    uint64_t m_readbackValue = 0;     ///< 最近一次提交的回读值
+    std::deque<PendingReadback> m_pending;
+    ReadbackCallback m_readbackCallback;
+
+    uint32_t m_nextImage = 0;
+    uint64_t m_generation = 0;
+    uint64_t m_deliveredFrames = 0;
+    std::chrono::steady_clock::time_point m_acquireTime;
+};
+
+} // namespace vkcore
@@ -22,11 +22,30 @@
 #pragma once
 #include "Device.hpp"
 #include "ShaderManager.hpp"
+#include <map>
+#include <mutex>
+#include <span>
 
 namespace vkcore
 {
 // 前置声明
 class PipelineBuilder;
+class ComputePipelineBuilder;
+class PipelineCache;
+class DescriptorLayoutCache;
+
+/**
+ * @struct SpecializationConstant
+ * @brief 一个 32 位特化常量（int/uint/float 按位存放，bool 为 VkBool32）
+ */
+struct SpecializationConstant
+{
+    vk::ShaderStageFlags stages; ///< 作用的着色器阶段
+    uint32_t constantId{0};      ///< GLSL layout(constant_id = N)
+    uint32_t value{0};           ///< 常量值
+
+    bool operator==(const SpecializationConstant &) const = default;
+};
 
 /**
  * @class Pipeline
@@ -36,7 +55,7 @@ class Pipeline
 {
   public:
     /**
-     * @brief 析构函数，自动销毁管线和管线布局
+     * @brief 析构函数，自动销毁管线和管线布局（布局来自 PipelineLayoutCache 时只销毁管线）
      */
     ~Pipeline();
 
@@ -66,6 +85,15 @@ class Pipeline
         return m_pipelineLayout;
     }
 
+    /**
+     * @brief 获取管线绑定点
+     * @return vk::PipelineBindPoint 图形或计算
+     */
+    vk::PipelineBindPoint getBindPoint() const
+    {
+        return m_bindPoint;
+    }
+
     /**
      * @brief 将管线绑定到命令缓冲区
      * @param cmd 要绑定的命令缓冲区
@@ -76,16 +104,84 @@ class Pipeline
     /**
      * @brief 私有构造函数，仅限 PipelineBuilder 调用
      */
-    Pipeline(vkcore::Device &device, vk::Pipeline pipeline, vk::PipelineLayout layout, vk::PipelineBindPoint bindPoint);
+    Pipeline(vkcore::Device &device, vk::Pipeline pipeline, vk::PipelineLayout layout, vk::PipelineBindPoint bindPoint,
+             bool ownsLayout = true);
 
   private:
     vkcore::Device &m_device;            ///< 逻辑设备引用
     vk::Pipeline m_pipeline;             ///< Vulkan 管线句柄
     vk::PipelineLayout m_pipelineLayout; ///< Vulkan 管线布局句柄
     vk::PipelineBindPoint m_bindPoint;   ///< 管线绑定点 (图形或计算)
+    bool m_ownsLayout;                   ///< 是否由本对象销毁布局（缓存的布局由 PipelineLayoutCache 销毁）
 
     // 允许 PipelineBuilder 访问私有构造函数
     friend class PipelineBuilder;
+    friend class ComputePipelineBuilder;
+};
+
+/**
+ * @class PipelineLayoutCache
+ * @brief 管线布局缓存：描述符集布局与推送常量范围完全相同的管线共享同一个 vk::PipelineLayout
+ *
+ * 与 DescriptorLayoutCache 配合使用时，布局一致的管线得到相同的句柄，描述符集可以跨管线保持绑定，
+ * PipelineCache 的状态键也随之去重。缓存必须比所有用它构建的 Pipeline 活得更久。
+ *
+ * @example
+ * @code
+ * vkcore::PipelineLayoutCache layoutCache(device);
+ * auto pipeline = vkcore::PipelineBuilder(device)
+ *                     .addShaderModule(vert)
+ *                     .addShaderModule(frag)
+ *                     .deriveLayout(descriptorLayoutCache) // 由反射推导集布局与推送常量
+ *                     .setPipelineLayoutCache(&layoutCache)
+ *                     .addColorAttachment(format, blend)
+ *                     .build();
+ * @endcode
+ *
+ * 线程安全：所有公共方法均使用互斥锁保护。
+ */
+class PipelineLayoutCache
+{
+  public:
+    /**
+     * @brief 构造函数
+     * @param device 逻辑设备引用
+     */
+    explicit PipelineLayoutCache(vkcore::Device &device);
+
+    /**
+     * @brief 析构函数，自动调用 cleanup()
+     */
+    ~PipelineLayoutCache();
+
+    /** 禁用拷贝与移动 */
+    PipelineLayoutCache(const PipelineLayoutCache &) = delete;
+    PipelineLayoutCache &operator=(const PipelineLayoutCache &) = delete;
+
+    /**
+     * @brief 创建或获取管线布局
+     * @param setLayouts 描述符集布局（按集索引排列）
+     * @param pushConstants 推送常量范围
+     * @return vk::PipelineLayout 缓存持有的布局句柄（调用方不得销毁）
+     * @throws std::runtime_error 如果布局创建失败
+     */
+    vk::PipelineLayout getOrCreate(std::span<const vk::DescriptorSetLayout> setLayouts,
+                                   std::span<const vk::PushConstantRange> pushConstants);
+
+    /**
+     * @brief 获取缓存的布局数量
+     */
+    size_t size() const;
+
+    /**
+     * @brief 销毁所有缓存的布局（调用前必须先销毁使用它们的管线）
+     */
+    void cleanup();
+
+  private:
+    vkcore::Device &m_device;
+    std::map<std::vector<uint8_t>, vk::PipelineLayout> m_layouts; ///< 布局键（集布局句柄 + 推送常量）-> 布局
+    mutable std::mutex m_mtx;
 };
 
 /**
@@ -97,6 +193,9 @@ class Pipeline
  *
  * @note 动态渲染的 LoadOp/StoreOp 在录制命令时通过 vkCmdBeginRendering 配置，
  *       而不是在管线创建时配置。这使得同一个管线可以用于不同的渲染通道。
+ *
+ * 网格着色管线（VK_EXT_mesh_shader）：添加 eTaskEXT（可选）与 eMeshEXT 阶段的着色器模块代替顶点着色器，
+ * 顶点输入与图元装配状态随之被忽略，绘制使用 vkCmdDrawMeshTasksEXT。
  */
 class PipelineBuilder
 {
@@ -135,9 +234,44 @@ class PipelineBuilder
      */
     PipelineBuilder &addPushConstant(const vk::PushConstantRange &range);
 
+    /**
+     * @brief 由着色器反射推导描述符集布局与推送常量（替换之前添加的布局与推送常量）
+     *
+     * 合并所有着色器模块的反射结果：同一 (set, binding) 的 stageFlags 取并集，集布局经 cache 去重，
+     * 中间未使用的集为空布局；推送常量合并为一个覆盖所有阶段的范围（vkCmdPushConstants 需使用相同的 stageFlags）。
+     * 必须在添加完所有着色器模块之后调用。
+     *
+     * @param cache 描述符集布局缓存
+     * @return PipelineBuilder& 自身引用
+     * @throws std::invalid_argument 如果某个模块没有反射数据、同一绑定的类型或数量不一致，
+     *         或包含运行时大小的数组（需要绑定标志，请用 addDescriptorSetLayout() 显式提供）
+     */
+    PipelineBuilder &deriveLayout(DescriptorLayoutCache &cache);
+
+    /**
+     * @brief 设置一个特化常量（同一 id 与阶段再次设置时覆盖）
+     *
+     * 特化常量参与状态键：不同取值是不同的管线，经 PipelineCache 各自编译并缓存。
+     * 驱动在编译时把常量折叠进着色器，据此判断的分支与纹理采样被整体消除。
+     *
+     * @param constantId GLSL layout(constant_id = N)
+     * @param value 常量值（32 位）
+     * @param stages 作用的着色器阶段（着色器未声明该 id 时被忽略）
+     * @return PipelineBuilder& 自身引用
+     */
+    PipelineBuilder &setSpecializationConstant(uint32_t constantId, uint32_t value,
+                                               vk::ShaderStageFlags stages = vk::ShaderStageFlagBits::eAllGraphics);
+
+    /**
+     * @brief 使用管线布局缓存（为空时每个管线创建并持有自己的布局）
+     * @param cache 管线布局缓存（生命周期必须长于构建出的管线）
+     * @return PipelineBuilder& 自身引用
+     */
+    PipelineBuilder &setPipelineLayoutCache(PipelineLayoutCache *cache);
+
     /**
      * @brief 设置顶点输入状态
-     * @param info 顶点输入状态创建信息
+     * @param info 顶点输入状态创建信息（绑定/属性描述数组会被复制，调用方无需保持其存活）
      * @return PipelineBuilder& 自身引用
      */
     PipelineBuilder &setVertexInput(const vk::PipelineVertexInputStateCreateInfo &info);
@@ -158,7 +292,7 @@ class PipelineBuilder
 
     /**
      * @brief 设置多重采样状态
-     * @param info 多重采样状态创建信息
+     * @param info 多重采样状态创建信息（pSampleMask 指向的掩码会被复制）
      * @return PipelineBuilder& 自身引用
      */
     PipelineBuilder &setMultisampling(const vk::PipelineMultisampleStateCreateInfo &info);
@@ -201,6 +335,23 @@ class PipelineBuilder
      */
     PipelineBuilder &addDynamicState(vk::DynamicState state);
 
+    /**
+     * @brief 启用可变速率着色（VK_KHR_fragment_shading_rate）
+     * @details 最终速率 = attachmentOp(primitiveOp(管线速率, 图元速率), 附件速率)。
+     *          默认的 1x1 管线速率配合 eKeep / eReplace 即完全由着色速率附件决定。
+     *          启用后管线以 eRenderingFragmentShadingRateAttachmentKHR 创建，可以在带着色速率附件的渲染实例中使用
+     *          （没有附件时附件速率视为 1x1）
+     * @param fragmentSize 管线速率（每个片段覆盖的像素数，各轴为 1、2 或 4）
+     * @param primitiveOp 管线速率与图元速率的合并方式
+     * @param attachmentOp 上一步结果与附件速率的合并方式
+     * @return PipelineBuilder& 自身引用
+     * @note 需要设备启用 VK_KHR_fragment_shading_rate
+     */
+    PipelineBuilder &setFragmentShadingRate(
+        vk::Extent2D fragmentSize = {1, 1},
+        vk::FragmentShadingRateCombinerOpKHR primitiveOp = vk::FragmentShadingRateCombinerOpKHR::eKeep,
+        vk::FragmentShadingRateCombinerOpKHR attachmentOp = vk::FragmentShadingRateCombinerOpKHR::eReplace);
+
     // ==================== 构建 ====================
 
     /**
@@ -208,21 +359,96 @@ class PipelineBuilder
      *
      * 创建支持 Vulkan 1.3 动态渲染的图形管线。必须至少指定一个附件格式。
      *
+     * @param cache 驱动管线缓存（可为空；通常由 PipelineCache::getOrCreate() 传入）
      * @return std::unique_ptr<Pipeline> 返回一个 RAII 封装的 Pipeline 对象
      * @throws std::runtime_error 如果未指定任何附件格式（不支持传统 RenderPass）
      * @throws std::runtime_error 如果管线创建失败
      *
      * @note 不支持传统的 RenderPass 渲染方式，必须使用动态渲染
      */
-    std::unique_ptr<Pipeline> build();
+    std::unique_ptr<Pipeline> build(vk::PipelineCache cache = nullptr);
+
+    /**
+     * @brief 序列化完整的构建器状态
+     * @details 包含着色器模块、布局、所有固定功能状态（含顶点输入描述数组）与附件格式，
+     *          两个构建器的状态键相同当且仅当它们会创建等价的管线
+     * @return std::vector<uint8_t> 状态键（用于 PipelineCache 去重）
+     */
+    std::vector<uint8_t> getStateKey() const;
+
+    /**
+     * @brief 复制构建器，用于把构建交给其他线程（例如 PipelineCache 的异步编译）
+     * @details 顶点输入与采样掩码数组属于构建器自身，副本不引用原构建器的任何内存；
+     *          各状态结构的 pNext 链按指针复制
+     * @return std::unique_ptr<PipelineBuilder> 状态完全相同的新构建器
+     */
+    std::unique_ptr<PipelineBuilder> clone() const;
+
+    /**
+     * @brief 是否为网格着色管线（包含 eMeshEXT 阶段的着色器）
+     * @details 网格着色管线没有顶点输入接口：不创建该部件，链接时只需其余三个部件
+     */
+    bool isMeshShading() const;
+
+    // ==================== 管线库 (VK_EXT_graphics_pipeline_library) ====================
+
+    /**
+     * @brief 构建一个图形管线库部件
+     * @details 部件只包含该阶段相关的状态：
+     *          - eVertexInputInterface：顶点输入与图元装配
+     *          - ePreRasterizationShaders：片段以外的着色器、管线布局与光栅化状态
+     *          - eFragmentShader：片段着色器、管线布局、深度/模板与多重采样状态
+     *          - eFragmentOutputInterface：颜色混合、多重采样与附件格式
+     *
+     *          部件总是以 eRetainLinkTimeOptimizationInfoEXT 创建，可用于快速链接或链接时优化
+     * @param part 部件类型（单个标志位）
+     * @param cache 驱动管线缓存（可为空）
+     * @return std::unique_ptr<Pipeline> 部件管线（不能直接绑定，只能传给 link()）
+     * @throws std::runtime_error 如果部件缺少必需的状态或创建失败
+     * @note 需要设备启用 VK_EXT_graphics_pipeline_library
+     */
+    std::unique_ptr<Pipeline> buildLibrary(vk::GraphicsPipelineLibraryFlagBitsEXT part,
+                                           vk::PipelineCache cache = nullptr);
+
+    /**
+     * @brief 把四个部件（网格着色管线为三个）链接为可绑定的完整管线
+     * @param libraries 各部件的管线句柄（顺序任意，可来自不同的构建器，但状态必须与本构建器一致）
+     * @param optimize true 时进行链接时优化（较慢，生成的代码与完整编译相当），false 时快速链接
+     * @param cache 驱动管线缓存（可为空）
+     * @return std::unique_ptr<Pipeline> 链接后的管线（持有按本构建器创建的管线布局）
+     * @throws std::runtime_error 如果链接失败
+     */
+    std::unique_ptr<Pipeline> link(std::span<const vk::Pipeline> libraries, bool optimize,
+                                   vk::PipelineCache cache = nullptr);
+
+    /**
+     * @brief 序列化单个部件相关的状态（getStateKey() 的子集，用于部件去重）
+     * @param part 部件类型（单个标志位）
+     */
+    std::vector<uint8_t> getLibraryKey(vk::GraphicsPipelineLibraryFlagBitsEXT part) const;
 
   private:
     /**
-     * @brief 内部函数：创建管线布局
+     * @brief 内部函数：创建管线布局（设置了布局缓存时从缓存获取）
      * @return vk::PipelineLayout 创建的布局句柄
      */
     vk::PipelineLayout buildlayout();
 
+    /**
+     * @brief 内部函数：按部件集合创建图形管线（完整管线、部件或链接）
+     * @param parts 包含的部件（完整管线为全部四个，链接为空）
+     * @param flags 管线创建标志（部件含 eLibraryKHR）
+     * @param libraries 链接的部件（仅链接时非空）
+     * @param cache 驱动管线缓存
+     */
+    std::unique_ptr<Pipeline> createpipeline(vk::GraphicsPipelineLibraryFlagsEXT parts, vk::PipelineCreateFlags flags,
+                                             std::span<const vk::Pipeline> libraries, vk::PipelineCache cache);
+
+    /**
+     * @brief 内部函数：把 parts 相关的状态追加到键
+     */
+    void appendstatekey(std::vector<uint8_t> &key, vk::GraphicsPipelineLibraryFlagsEXT parts) const;
+
   private:
     vkcore::Device &m_device;
 
@@ -230,11 +456,16 @@ class PipelineBuilder
     std::vector<std::shared_ptr<ShaderModule>> m_shaderModules;
     std::vector<vk::DescriptorSetLayout> m_setLayouts;
     std::vector<vk::PushConstantRange> m_pushConstants;
+    PipelineLayoutCache *m_layoutCache = nullptr;
+    std::vector<SpecializationConstant> m_specializationConstants;
 
     vk::PipelineVertexInputStateCreateInfo m_vertexInputInfo;
+    std::vector<vk::VertexInputBindingDescription> m_vertexBindings;     ///< m_vertexInputInfo 指向的绑定描述
+    std::vector<vk::VertexInputAttributeDescription> m_vertexAttributes; ///< m_vertexInputInfo 指向的属性描述
     vk::PipelineInputAssemblyStateCreateInfo m_inputAssemblyInfo;
     vk::PipelineRasterizationStateCreateInfo m_rasterizationInfo;
     vk::PipelineMultisampleStateCreateInfo m_multisampleInfo;
+    std::vector<vk::SampleMask> m_sampleMask; ///< m_multisampleInfo.pSampleMask 指向的掩码
     vk::PipelineDepthStencilStateCreateInfo m_depthStencilInfo;
     std::vector<vk::PipelineColorBlendAttachmentState> m_colorBlendAttachments;
     std::vector<vk::DynamicState> m_dynamicStates;
@@ -243,6 +474,113 @@ class PipelineBuilder
     std::vector<vk::Format> m_colorAttachmentFormats;
     vk::Format m_depthAttachmentFormat = vk::Format::eUndefined;
     vk::Format m_stencilAttachmentFormat = vk::Format::eUndefined;
+
+    // --- 可变速率着色 (VK_KHR_fragment_shading_rate) ---
+    bool m_fragmentShadingRateEnabled = false;
+    vk::PipelineFragmentShadingRateStateCreateInfoKHR m_fragmentShadingRateInfo;
+
+    // 允许 PipelineCache 持有着色器模块的引用
+    friend class PipelineCache;
+class DescriptorLayoutCache;
+};
+
+/**
+ * @class ComputePipelineBuilder
+ * @brief Vulkan 计算管线构建器
+ *
+ * @example
+ * @code
+ * auto cullPipeline = vkcore::ComputePipelineBuilder(device)
+ *                         .setShaderModule(cullShader)
+ *                         .addDescriptorSetLayout(cullSetLayout)
+ *                         .build();
+ * cullPipeline->bind(cmd);
+ * cmd.dispatch(groupCount, 1, 1);
+ * @endcode
+ */
+class ComputePipelineBuilder
+{
+  public:
+    /**
+     * @brief 构造函数
+     * @param device 逻辑设备引用
+     */
+    ComputePipelineBuilder(vkcore::Device &device);
+    ~ComputePipelineBuilder() = default;
+
+    /** 禁用拷贝与移动 */
+    ComputePipelineBuilder(const ComputePipelineBuilder &) = delete;
+    ComputePipelineBuilder &operator=(const ComputePipelineBuilder &) = delete;
+
+    // ==================== 管线配置 (链式调用) ====================
+
+    /**
+     * @brief 设置计算着色器
+     * @param shaderModule 阶段必须为 eCompute 的着色器模块
+     * @return ComputePipelineBuilder& 自身引用
+     * @throws std::invalid_argument 如果着色器为空或阶段不是 eCompute
+     */
+    ComputePipelineBuilder &setShaderModule(std::shared_ptr<ShaderModule> shaderModule);
+
+    /**
+     * @brief 添加一个描述符集布局
+     * @param layout 描述符集布局句柄
+     * @return ComputePipelineBuilder& 自身引用
+     */
+    ComputePipelineBuilder &addDescriptorSetLayout(vk::DescriptorSetLayout layout);
+
+    /**
+     * @brief 添加一个推送常量范围
+     * @param range 推送常量范围
+     * @return ComputePipelineBuilder& 自身引用
+     */
+    ComputePipelineBuilder &addPushConstant(const vk::PushConstantRange &range);
+
+    /**
+     * @brief 由计算着色器的反射推导描述符集布局与推送常量（见 PipelineBuilder::deriveLayout()）
+     * @param cache 描述符集布局缓存
+     * @return ComputePipelineBuilder& 自身引用
+     * @throws std::invalid_argument 如果未设置着色器或反射结果无法表示为布局
+     */
+    ComputePipelineBuilder &deriveLayout(DescriptorLayoutCache &cache);
+
+    /**
+     * @brief 使用管线布局缓存（见 PipelineBuilder::setPipelineLayoutCache()）
+     */
+    ComputePipelineBuilder &setPipelineLayoutCache(PipelineLayoutCache *cache);
+
+    /**
+     * @brief 设置一个特化常量（见 PipelineBuilder::setSpecializationConstant()）
+     */
+    ComputePipelineBuilder &setSpecializationConstant(uint32_t constantId, uint32_t value);
+
+    // ==================== 构建 ====================
+
+    /**
+     * @brief 构建计算管线
+     * @param cache 驱动管线缓存（可为空）
+     * @return std::unique_ptr<Pipeline> 绑定点为 eCompute 的 Pipeline
+     * @throws std::runtime_error 如果未设置着色器或管线创建失败
+     */
+    std::unique_ptr<Pipeline> build(vk::PipelineCache cache = nullptr);
+
+    /**
+     * @brief 序列化完整的构建器状态（见 PipelineBuilder::getStateKey()）
+     */
+    std::vector<uint8_t> getStateKey() const;
+
+  private:
+    vkcore::Device &m_device;
+
+    std::shared_ptr<ShaderModule> m_shaderModule;
+    std::vector<vk::DescriptorSetLayout> m_setLayouts;
+    std::vector<vk::PushConstantRange> m_pushConstants;
+    PipelineLayoutCache *m_layoutCache = nullptr;
+    std::vector<SpecializationConstant> m_specializationConstants;
+
+    // 允许 PipelineCache 持有着色器模块的引用
+    friend class PipelineCache;
+class DescriptorLayoutCache;
 };
 
 } // namespace vkcore
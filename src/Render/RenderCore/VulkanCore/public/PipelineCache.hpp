@@ -0,0 +1,206 @@
+/**
+ * @file PipelineCache.hpp
+ * @brief 管线状态对象缓存与持久化的驱动管线缓存
+ * @details 两层缓存：
+ *          - 管线对象层：按构建器的完整状态键去重，相同状态直接返回已创建的 Pipeline；
+ *          - 驱动层：所有管线都通过同一个 vk::PipelineCache 创建，其数据在析构（或 save()）时写入磁盘，
+ *            下次启动时加载，驱动可以跳过着色器编译。
+ *
+ *          磁盘文件布局：[PipelineCacheFileHeader][驱动缓存数据]，
+ *          文件头记录 vendorID、deviceID、驱动版本与 pipelineCacheUUID，任一不匹配即丢弃旧数据。
+ *
+ *          首次出现的管线可以交给后台编译线程（getOrCreateAsync() / tryGet()），渲染线程在就绪前使用回退管线或跳过绘制；
+ *          设备启用 VK_EXT_graphics_pipeline_library 时，后台按部件创建并去重管线库，
+ *          先快速链接出可用管线，再做链接时优化，优化版本就绪后替换返回值。
+ */
+
+#pragma once
+
+#include "Pipeline.hpp"
+#include "WorkerPool.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace vkcore
+{
+
+/**
+ * @class PipelineCache
+ * @brief 管线去重缓存 + 磁盘持久化的 vk::PipelineCache
+ *
+ * @example
+ * @code
+ * vkcore::PipelineCache pipelineCache(device, cacheDir / "pipelines.bin");
+ * vkcore::PipelineBuilder builder(device);
+ * builder.addShaderModule(vert).addShaderModule(frag).addColorAttachment(format, blend);
+ * vkcore::Pipeline *pipeline = pipelineCache.getOrCreate(builder); // 相同状态返回同一个对象
+ *
+ * // 渲染线程上不阻塞：未就绪时投递后台编译并返回 nullptr
+ * vkcore::Pipeline *material = pipelineCache.tryGet(materialBuilder);
+ * (material ? material : fallbackPipeline)->bind(cmd);
+ * @endcode
+ *
+ * @note 所有接口线程安全；创建在锁外进行，多个线程可以并行编译不同的管线
+ */
+class PipelineCache
+{
+  public:
+    /**
+     * @struct Stats
+     * @brief 缓存统计
+     */
+    struct Stats
+    {
+        uint32_t pipelineCount{0};   ///< 缓存的管线数量
+        uint64_t hits{0};            ///< 状态键命中次数
+        uint64_t misses{0};          ///< 需要新建管线的次数
+        size_t loadedDataSize{0};    ///< 启动时从磁盘加载的驱动缓存字节数（0 表示未加载）
+        bool rejectedOnLoad{false};  ///< 磁盘文件存在但与当前设备/驱动不匹配或已损坏
+        uint32_t libraryCount{0};    ///< 缓存的管线库部件数量
+        uint32_t pendingCompiles{0}; ///< 正在后台编译的管线数量
+        uint64_t failedCompiles{0};  ///< 后台编译失败的次数
+    };
+
+    /**
+     * @brief 构造函数，创建驱动管线缓存并尝试从磁盘加载
+     * @param device 逻辑设备
+     * @param cacheFile 缓存文件路径（空路径表示只在内存中缓存）
+     * @param compileThreadCount 后台编译线程数量（0 表示 hardware_concurrency / 4，至少为 1；首次异步请求时创建）
+     * @throws std::runtime_error 如果无法创建 vk::PipelineCache
+     */
+    explicit PipelineCache(Device &device, std::filesystem::path cacheFile = {}, uint32_t compileThreadCount = 0);
+
+    /**
+     * @brief 析构函数，等待后台编译结束，保存驱动缓存并销毁所有管线（调用方需保证 GPU 不再使用它们）
+     */
+    ~PipelineCache();
+
+    /** 禁用拷贝与移动 */
+    PipelineCache(const PipelineCache &) = delete;
+    PipelineCache &operator=(const PipelineCache &) = delete;
+
+    /**
+     * @brief 获取驱动管线缓存句柄（可直接传给 PipelineBuilder::build()）
+     */
+    vk::PipelineCache get() const
+    {
+        return m_pipelineCache;
+    }
+
+    /**
+     * @brief 返回与构建器状态相同的已缓存管线，没有时创建
+     * @param builder 已配置好的图形管线构建器
+     * @return Pipeline* 缓存持有的管线（在 clear() 或析构前有效）
+     * @throws std::runtime_error 如果管线创建失败
+     */
+    Pipeline *getOrCreate(PipelineBuilder &builder);
+
+    /**
+     * @brief 返回与构建器状态相同的已缓存计算管线，没有时创建
+     */
+    Pipeline *getOrCreate(ComputePipelineBuilder &builder);
+
+    /**
+     * @brief 在后台编译线程上创建管线，立即返回
+     * @details 构建器状态在调用时被复制，调用返回后即可修改或销毁构建器；
+     *          相同状态的重复请求共享同一个 future，已缓存的管线返回已就绪的 future
+     * @param builder 已配置好的图形管线构建器
+     * @return std::shared_future<Pipeline *> 首个可用管线（快速链接版本或完整编译版本），编译失败时保存异常
+     */
+    std::shared_future<Pipeline *> getOrCreateAsync(PipelineBuilder &builder);
+
+    /**
+     * @brief 非阻塞查询：管线已就绪时返回它，否则投递后台编译并返回 nullptr
+     * @details 适合每帧在渲染线程上调用；链接时优化的版本就绪后返回优化版本（快速链接版本保留到 clear()），
+     *          编译失败的状态始终返回 nullptr（失败只在 Stats::failedCompiles 中计数一次）
+     * @param builder 已配置好的图形管线构建器
+     * @return Pipeline* 可绑定的管线，或 nullptr（调用方应使用回退管线或跳过绘制）
+     */
+    Pipeline *tryGet(PipelineBuilder &builder);
+
+    /**
+     * @brief 阻塞直到所有后台编译完成
+     */
+    void waitIdle();
+
+    /**
+     * @brief 把之后的后台编译投递到外部（引擎共享的）任务调度器，而不是首次异步请求时自建线程池
+     * @param workers 外部调度器（生命周期须长于本对象；为空时恢复自建线程池）
+     * @note 已投递到自建线程池的编译不受影响，waitIdle() 与析构同时等待两者
+     */
+    void setWorkerPool(WorkerPool *workers);
+
+    /**
+     * @brief 后台编译是否使用 VK_EXT_graphics_pipeline_library 的部件与链接
+     */
+    bool usesPipelineLibraries() const
+    {
+        return m_useLibraries;
+    }
+
+    /**
+     * @brief 把驱动缓存数据写入磁盘（先写临时文件再原子重命名）
+     * @return bool 是否成功（未设置缓存文件时返回 false）
+     */
+    bool save() const;
+
+    /**
+     * @brief 等待后台编译结束后销毁所有缓存的管线与部件（驱动缓存数据保留），调用方需保证 GPU 不再使用它们
+     */
+    void clear();
+
+    /**
+     * @brief 获取统计
+     */
+    Stats getStats() const;
+
+  private:
+    struct Entry
+    {
+        std::vector<uint8_t> key;                           ///< 完整状态键（哈希冲突时逐字节比较）
+        std::vector<std::shared_ptr<ShaderModule>> shaders; ///< 持有着色器模块，保证键中的句柄不被复用
+        std::unique_ptr<Pipeline> pipeline;                 ///< 完整编译或快速链接的管线（后台编译中为空）
+        std::unique_ptr<Pipeline> optimized;                ///< 链接时优化的管线（就绪后优先返回）
+        std::shared_future<Pipeline *> ready;               ///< 异步请求的结果（同步创建的项在首次异步请求时补上）
+
+        Pipeline *current() const
+        {
+            return optimized ? optimized.get() : pipeline.get();
+        }
+    };
+    using EntryMap = std::unordered_multimap<uint64_t, Entry>;
+
+    template <typename Builder>
+    Pipeline *getorcreate(Builder &builder, std::vector<std::shared_ptr<ShaderModule>> shaders);
+    Pipeline *getorcreatelibrary(PipelineBuilder &builder, vk::GraphicsPipelineLibraryFlagBitsEXT part);
+    std::shared_future<Pipeline *> enqueuecompile(PipelineBuilder &builder, std::vector<uint8_t> key, uint64_t hash);
+    void compile(Entry &entry, PipelineBuilder &builder, std::promise<Pipeline *> &promise);
+    static Entry *find(EntryMap &entries, uint64_t hash, const std::vector<uint8_t> &key);
+    std::vector<uint8_t> loadfile();
+
+  private:
+    Device &m_device;
+    std::filesystem::path m_cacheFile;
+    vk::PipelineCache m_pipelineCache;
+
+    EntryMap m_entries;   ///< 状态键哈希 -> 缓存项
+    EntryMap m_libraries; ///< 部件状态键哈希 -> 管线库部件
+    Stats m_stats;
+    mutable std::mutex m_mtx;
+
+    // --- 后台编译 ---
+    bool m_useLibraries{false}; ///< 设备启用了 VK_EXT_graphics_pipeline_library
+    bool m_fastLinking{false};  ///< graphicsPipelineLibraryFastLinking：快速链接足够快，可先链接再优化
+    uint32_t m_compileThreadCount{0};
+    std::unique_ptr<WorkerPool> m_compileWorkers; ///< 后台编译线程（首次异步请求时创建）
+    WorkerPool *m_sharedWorkers = nullptr;        ///< 外部调度器（设置后取代 m_compileWorkers）
+    std::condition_variable m_idleCv;             ///< pendingCompiles 归零通知
+};
+
+} // namespace vkcore
@@ -0,0 +1,209 @@
+/**
+ * @file Profiler.hpp
+ * @brief CPU 热路径插桩：作用域区段、每线程无锁环形缓冲与 Chrome trace / Tracy 导出
+ * @details - QTR_PROFILE_SCOPE("name") 在作用域结束时把一条 {名称, 开始, 结束} 记录写入本线程的环形缓冲，
+ *            只有一次原子存储，没有锁和堆分配；名称必须是静态存储期的字符串（字面量或 __func__）；
+ *          - 环形缓冲为单生产者/单消费者：所属线程写入，Profiler::collect() 在任意线程上排空，
+ *            缓冲满时丢弃新区段并计数（getDroppedZones()），绝不阻塞热路径；
+ *          - QTR_PROFILE_FRAME() 标记帧边界，并每隔若干帧自动排空一次，长时间捕获也不会丢区段；
+ *          - writeChromeTrace() 写出 chrome://tracing / Perfetto 可打开的 JSON；
+ *            定义 QTR_USE_TRACY（CMake 选项 QTRENDER_WITH_TRACY）时所有宏同时转发给 Tracy。
+ *          QTR_PROFILING 为 0 时（默认 Release 构建，且未启用 Tracy）所有宏展开为空，
+ *          可通过 CMake 选项 QTRENDER_ENABLE_PROFILING 在 Release 构建中强制打开。
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#ifndef QTR_PROFILING
+#if defined(QTR_USE_TRACY) || !defined(NDEBUG)
+#define QTR_PROFILING 1
+#else
+#define QTR_PROFILING 0
+#endif
+#endif
+
+#if QTR_PROFILING && defined(QTR_USE_TRACY)
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace vkcore
+{
+
+/**
+ * @struct ProfileZone
+ * @brief 一条已完成的区段记录（时间为 steady_clock 纳秒）
+ */
+struct ProfileZone
+{
+    const char *name;  ///< 区段名（静态存储期）
+    uint64_t beginNs;  ///< 开始时刻
+    uint64_t endNs;    ///< 结束时刻
+    uint32_t threadId; ///< 线程序号（按首次记录的顺序从 0 编号）
+};
+
+/**
+ * @class Profiler
+ * @brief 区段记录的全局入口（全部为静态函数）
+ *
+ * @example
+ * @code
+ * vkcore::Profiler::setEnabled(true);
+ * {
+ *     QTR_PROFILE_SCOPE("Scene::update");
+ *     scene.update();
+ * }
+ * QTR_PROFILE_FRAME();
+ * vkcore::Profiler::writeChromeTrace("frame.trace.json");
+ * @endcode
+ */
+class Profiler
+{
+  public:
+    /// @brief 每个线程环形缓冲的容量（区段数，2 的幂）
+    static constexpr uint32_t kZonesPerThread = 1u << 16;
+
+    /// @brief 累计捕获的区段上限（超过后 collect() 丢弃并计数）
+    static constexpr size_t kMaxCapturedZones = size_t(1) << 22;
+
+    /**
+     * @brief 开关区段记录（默认关闭；关闭时区段只读一次原子标志）
+     */
+    static void setEnabled(bool enabled);
+
+    static bool isEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 当前时刻（steady_clock 纳秒）
+     */
+    static uint64_t now();
+
+    /**
+     * @brief 把一条区段写入调用线程的环形缓冲（缓冲满时丢弃）
+     */
+    static void record(const char *name, uint64_t beginNs, uint64_t endNs);
+
+    /**
+     * @brief 为调用线程命名（导出为 Chrome trace 的 thread_name 元数据）
+     * @param name 线程名（静态存储期）
+     */
+    static void setThreadName(const char *name);
+
+    /**
+     * @brief 标记一帧结束；每 kCollectInterval 帧排空一次所有环形缓冲
+     */
+    static void markFrame();
+
+    /**
+     * @brief 排空所有线程的环形缓冲，追加到累计捕获中
+     * @return 本次排空的区段数
+     */
+    static size_t collect();
+
+    /**
+     * @brief 排空后取走累计捕获的区段（按线程、时间排列），并清空累计捕获
+     */
+    static std::vector<ProfileZone> takeCapture();
+
+    /**
+     * @brief 排空后把累计捕获写成 Chrome trace JSON（不清空累计捕获）
+     * @throws std::runtime_error 如果文件无法写入
+     */
+    static void writeChromeTrace(const std::filesystem::path &path);
+
+    /**
+     * @brief 因环形缓冲满或超过累计上限而丢弃的区段数
+     */
+    static uint64_t getDroppedZones();
+
+  private:
+    static constexpr uint32_t kCollectInterval = 32;
+
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+ * @class ProfileScope
+ * @brief QTR_PROFILE_SCOPE 的 RAII 实现（记录关闭时不取时间戳）
+ */
+class ProfileScope
+{
+  public:
+    explicit ProfileScope(const char *name) : m_name(name), m_begin(Profiler::isEnabled() ? Profiler::now() : 0)
+    {
+    }
+
+    ~ProfileScope()
+    {
+        if (m_begin != 0)
+        {
+            Profiler::record(m_name, m_begin, Profiler::now());
+        }
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+  private:
+    const char *m_name;
+    uint64_t m_begin;
+};
+
+} // namespace vkcore
+
+// ==================== 宏 ====================
+
+#define QTR_PROFILE_CONCAT_INNER(a, b) a##b
+#define QTR_PROFILE_CONCAT(a, b) QTR_PROFILE_CONCAT_INNER(a, b)
+
+#if QTR_PROFILING
+#if defined(QTR_USE_TRACY)
+#define QTR_TRACY_ZONE(name) ZoneScopedN(name)
+#define QTR_TRACY_FUNCTION() ZoneScoped
+#define QTR_TRACY_FRAME() FrameMark
+#define QTR_TRACY_THREAD(name) tracy::SetThreadName(name)
+#else
+#define QTR_TRACY_ZONE(name) ((void)0)
+#define QTR_TRACY_FUNCTION() ((void)0)
+#define QTR_TRACY_FRAME() ((void)0)
+#define QTR_TRACY_THREAD(name) ((void)0)
+#endif
+
+/// @brief 以字面量命名的作用域区段
+#define QTR_PROFILE_SCOPE(name)                                                                                        \
+    QTR_TRACY_ZONE(name);                                                                                              \
+    ::vkcore::ProfileScope QTR_PROFILE_CONCAT(qtrProfileScope, __LINE__)(name)
+
+/// @brief 以函数名命名的作用域区段
+#define QTR_PROFILE_FUNCTION()                                                                                         \
+    QTR_TRACY_FUNCTION();                                                                                              \
+    ::vkcore::ProfileScope QTR_PROFILE_CONCAT(qtrProfileScope, __LINE__)(__func__)
+
+/// @brief 标记帧边界
+#define QTR_PROFILE_FRAME()                                                                                            \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        QTR_TRACY_FRAME();                                                                                             \
+        ::vkcore::Profiler::markFrame();                                                                               \
+    } while (false)
+
+/// @brief 为当前线程命名
+#define QTR_PROFILE_THREAD(name)                                                                                       \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        QTR_TRACY_THREAD(name);                                                                                        \
+        ::vkcore::Profiler::setThreadName(name);                                                                       \
+    } while (false)
+#else
+#define QTR_PROFILE_SCOPE(name) ((void)0)
+#define QTR_PROFILE_FUNCTION() ((void)0)
+#define QTR_PROFILE_FRAME() ((void)0)
+#define QTR_PROFILE_THREAD(name) ((void)0)
+#endif
@@ -0,0 +1,109 @@
+/**
+ * @file SamplerCache.hpp
+ * @brief 采样器去重缓存
+ * @details 以完整的 vk::SamplerCreateInfo（过滤、mip 模式、寻址、LOD 偏移与范围、各向异性、比较、边框颜色）为键，
+ *          内容相同的请求返回同一个 vk::Sampler。纹理、渲染图与各渲染特性共享一个实例，
+ *          采样器数量只取决于不同配置的数量，远低于 maxSamplerAllocationCount。
+ *          句柄在缓存销毁前保持不变，可以直接用作描述符集布局中的不可变采样器（pImmutableSamplers）。
+ */
+
+#pragma once
+
+#include "Device.hpp"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkcore
+{
+
+/**
+ * @class SamplerCache
+ * @brief 按创建参数去重的采样器缓存（采样器归缓存所有，调用方不得销毁）
+ *
+ * @example
+ * @code
+ * vkcore::SamplerCache samplerCache(device);
+ * vk::SamplerCreateInfo info = vkcore::SamplerCache::makeInfo(vk::Filter::eLinear, vk::SamplerAddressMode::eRepeat);
+ * info.anisotropyEnable = VK_TRUE;
+ * info.maxAnisotropy = 16.0f; // 超过设备上限时自动钳制
+ * vk::Sampler sampler = samplerCache.getOrCreate(info);
+ * @endcode
+ *
+ * 线程安全：所有公共方法均使用互斥锁保护。
+ */
+class SamplerCache
+{
+  public:
+    /**
+     * @struct Stats
+     * @brief 缓存统计
+     */
+    struct Stats
+    {
+        uint32_t samplerCount{0}; ///< 缓存的采样器数量
+        uint32_t maxSamplers{0};  ///< 设备的 maxSamplerAllocationCount
+        uint64_t requests{0};     ///< getOrCreate() 调用次数
+        uint64_t hits{0};         ///< 命中已有采样器的次数
+    };
+
+    /**
+     * @brief 构造函数
+     * @param device 逻辑设备引用
+     */
+    explicit SamplerCache(Device &device);
+
+    /**
+     * @brief 析构函数，自动调用 cleanup()
+     */
+    ~SamplerCache();
+
+    /** 禁用拷贝与移动 */
+    SamplerCache(const SamplerCache &) = delete;
+    SamplerCache &operator=(const SamplerCache &) = delete;
+
+    /**
+     * @brief 获取或创建采样器
+     *
+     * 设备未启用 samplerAnisotropy 时关闭各向异性，maxAnisotropy 钳制到设备上限，
+     * 之后再查找缓存（钳制前后等价的请求共享同一个采样器）。
+     *
+     * @param info 采样器创建信息（pNext 必须为空）
+     * @return vk::Sampler 缓存持有的采样器
+     * @throws std::invalid_argument 如果 info.pNext 非空（扩展结构无法作为键比较）
+     * @throws std::runtime_error 如果采样器数量达到设备上限或创建失败
+     */
+    vk::Sampler getOrCreate(const vk::SamplerCreateInfo &info);
+
+    /**
+     * @brief 常用配置：同一过滤与寻址模式，线性 mip，完整 LOD 范围，无各向异性与比较
+     * @param filter 放大与缩小过滤
+     * @param addressMode 三个方向的寻址模式
+     */
+    static vk::SamplerCreateInfo makeInfo(vk::Filter filter, vk::SamplerAddressMode addressMode);
+
+    /**
+     * @brief 获取统计
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief 销毁所有采样器（调用前必须确保它们不再被任何描述符或命令使用）
+     */
+    void cleanup();
+
+  private:
+    static std::vector<uint8_t> makekey(const vk::SamplerCreateInfo &info);
+
+  private:
+    Device &m_device;
+    std::map<std::vector<uint8_t>, vk::Sampler> m_samplers; ///< 创建参数键 -> 采样器
+    bool m_anisotropySupported{false};
+    float m_maxAnisotropy{1.0f};
+    Stats m_stats;
+    mutable std::mutex m_mtx;
+};
+
+} // namespace vkcore
@@ -16,10 +16,16 @@
 #pragma once
 
 #include "Device.hpp"
+#include "ShaderPackage.hpp"
+#include "ShaderReflection.hpp"
+#include <array>
+#include <filesystem>
 #include <memory>
 #include <mutex>
+#include <span>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <vulkan/vulkan.hpp>
 
 namespace vkcore
@@ -30,12 +36,18 @@ namespace vkcore
  *
  * 该结构体封装了 vk::ShaderModule 及其相关信息（设备、着色器阶段），
  * 在析构时自动销毁着色器模块资源。支持移动语义但禁用拷贝。
+ *
+ * 设备启用 VK_EXT_shader_module_identifier 且着色器来自着色器包时，热启动可以只持有模块标识（identifier），
+ * 不创建 vk::ShaderModule：管线以标识创建，驱动管线缓存未命中时才由 ensureModule() 从映射的 SPIR-V 补建模块。
  */
 struct ShaderModule
 {
-    vk::Device device;             ///< Vulkan 逻辑设备句柄
-    vk::ShaderModule shaderModule; ///< 着色器模块句柄
-    vk::ShaderStageFlagBits stage; ///< 着色器阶段标志（顶点、片段等）
+    vk::Device device;                                  ///< Vulkan 逻辑设备句柄
+    vk::ShaderModule shaderModule;                      ///< 着色器模块句柄（只有标识时为空，读取请使用 getModule()）
+    vk::ShaderStageFlagBits stage;                      ///< 着色器阶段标志（顶点、片段等）
+    std::vector<uint8_t> identifier;                    ///< VK_EXT_shader_module_identifier 模块标识（为空表示不可用）
+    std::span<const uint32_t> code;                     ///< 延迟创建模块所需的 SPIR-V（指向着色器包映射，生命周期同 ShaderManager）
+    std::shared_ptr<const ShaderReflection> reflection; ///< 反射结果（ShaderManager 创建时填充，可为空）
 
     /**
      * @brief 构造函数，创建着色器模块封装。
@@ -48,6 +60,18 @@ struct ShaderModule
     {
     }
 
+    /**
+     * @brief 构造只有模块标识的封装，vk::ShaderModule 在需要时才创建。
+     * @param dev 逻辑设备对象引用
+     * @param st 着色器阶段标志
+     * @param id 模块标识
+     * @param spirv 创建模块所需的 SPIR-V（调用方保证其生命周期长于本对象）
+     */
+    ShaderModule(Device &dev, vk::ShaderStageFlagBits st, std::vector<uint8_t> id, std::span<const uint32_t> spirv)
+        : device(dev.get()), stage(st), identifier(std::move(id)), code(spirv)
+    {
+    }
+
     /**
      * @brief 析构函数，自动销毁着色器模块。
      */
@@ -69,7 +93,8 @@ struct ShaderModule
      * @param other 被移动的对象
      */
     ShaderModule(ShaderModule &&other) noexcept
-        : device(other.device), shaderModule(other.shaderModule), stage(other.stage)
+        : device(other.device), shaderModule(other.shaderModule), stage(other.stage),
+          identifier(std::move(other.identifier)), code(other.code), reflection(std::move(other.reflection))
     {
         other.shaderModule = nullptr;
         other.device = nullptr;
@@ -91,10 +116,46 @@ struct ShaderModule
             device = other.device;
             shaderModule = other.shaderModule;
             stage = other.stage;
+            identifier = std::move(other.identifier);
+            code = other.code;
+            reflection = std::move(other.reflection);
             other.shaderModule = nullptr;
         }
         return *this;
     }
+
+    /**
+     * @brief 获取当前的模块句柄（线程安全，只有标识时返回空句柄）。
+     */
+    vk::ShaderModule getModule() const
+    {
+        std::lock_guard<std::mutex> lock(m_moduleMutex);
+        return shaderModule;
+    }
+
+    /**
+     * @brief 返回模块句柄，只有标识时从 code 创建（线程安全，后台编译线程可能同时调用）。
+     * @throws std::runtime_error 如果没有模块也没有可用的 SPIR-V，或创建失败
+     */
+    vk::ShaderModule ensureModule()
+    {
+        std::lock_guard<std::mutex> lock(m_moduleMutex);
+        if (!shaderModule)
+        {
+            if (code.empty())
+            {
+                throw std::runtime_error("ShaderModule: no SPIR-V available to create the module");
+            }
+            vk::ShaderModuleCreateInfo createInfo{};
+            createInfo.codeSize = code.size_bytes();
+            createInfo.pCode = code.data();
+            shaderModule = device.createShaderModule(createInfo);
+        }
+        return shaderModule;
+    }
+
+  private:
+    mutable std::mutex m_moduleMutex; ///< 保护 shaderModule 的延迟创建（移动时不转移）
 };
 
 /**
@@ -102,24 +163,54 @@ struct ShaderModule
  * @brief 着色器模块管理器类，负责着色器的加载、缓存和生命周期管理。
  *
  * 该类使用名称作为键缓存已加载的着色器模块，避免重复加载相同的着色器。
- * 支持两种使用模式：
+ * 支持三种使用模式：
  * 1. 获取已缓存的着色器模块（仅传入名称）
  * 2. 创建并缓存新的着色器模块（传入名称、代码、阶段）
+ * 3. 挂载着色器包（ShaderPackage），getShaderModule() 首次按名称请求时才从映射内存创建模块
+ *
+ * 设备启用 VK_EXT_shader_module_identifier 且指定了标识缓存文件时，包内模块首次创建后记录其模块标识，
+ * 之后的启动直接返回只有标识的 ShaderModule，完全跳过 vkCreateShaderModule。
+ *
+ * 每个模块创建时反射一次（ShaderReflection），结果挂在 ShaderModule::reflection 上供 PipelineBuilder 推导布局；
+ * 着色器包中预先存放了反射数据时直接反序列化，不再扫描 SPIR-V。
  *
  * 线程安全：所有公共方法均使用互斥锁保护。
  * 生命周期：禁用拷贝和移动，确保单一所有权。
+ *
+ * @example
+ * @code
+ * vkcore::ShaderManager shaderManager(device, cacheDir / "ShaderIdentifiers.bin");
+ * shaderManager.mountPackage("assets/shaders/spv/shaders.qtsp");
+ * auto vert = shaderManager.getShaderModule("mesh.vert"); // 惰性创建
+ * @endcode
  */
 class ShaderManager
 {
   public:
+    /**
+     * @struct Stats
+     * @brief 加载统计
+     */
+    struct Stats
+    {
+        uint32_t moduleCount{0};        ///< 缓存的模块数量
+        uint32_t packageCount{0};       ///< 已挂载的着色器包数量
+        uint64_t createdModules{0};     ///< 调用 vkCreateShaderModule 的次数
+        uint64_t identifierModules{0};  ///< 以模块标识代替模块创建的次数
+        uint64_t reflectedModules{0};   ///< 运行时扫描 SPIR-V 反射的次数（包内反射数据命中时不计）
+        uint32_t cachedIdentifiers{0};  ///< 标识缓存中的条目数量
+        bool identifiersEnabled{false}; ///< 是否使用 VK_EXT_shader_module_identifier
+    };
+
     /**
      * @brief 构造函数。
      * @param device 逻辑设备引用
+     * @param identifierCacheFile 模块标识缓存文件（空路径或设备未启用 VK_EXT_shader_module_identifier 时不使用）
      */
-    ShaderManager(Device &device);
+    explicit ShaderManager(Device &device, std::filesystem::path identifierCacheFile = {});
 
     /**
-     * @brief 析构函数，自动调用 cleanup() 清理所有着色器模块。
+     * @brief 析构函数，保存模块标识缓存并调用 cleanup() 清理所有着色器模块。
      */
     ~ShaderManager();
 
@@ -130,13 +221,25 @@ class ShaderManager
     ShaderManager &operator=(ShaderManager &&) = delete;
 
     /**
-     * @brief 获取已缓存的着色器模块。
+     * @brief 挂载着色器包，之后挂载的包中的同名模块优先。
+     *
+     * 只映射文件并校验索引表，不创建任何模块。包在 ShaderManager 析构前保持映射
+     * （cleanup() 不会卸载，已返回的模块可能仍引用包内的 SPIR-V）。
+     *
+     * @param packagePath 着色器包路径
+     * @throws std::runtime_error 如果包不存在或已损坏
+     */
+    void mountPackage(const std::filesystem::path &packagePath);
+
+    /**
+     * @brief 获取着色器模块。
      *
-     * 根据名称查找已缓存的着色器模块，如果不存在则返回 nullptr。
-     * 适用于只需要获取已加载着色器的场景。
+     * 根据名称查找已缓存的着色器模块；未缓存时在已挂载的着色器包中查找并创建（阶段取自包内记录）。
+     * 都没有找到时返回 nullptr。
      *
      * @param name 着色器名称
      * @return std::shared_ptr<ShaderModule> 着色器模块的智能指针，未找到时为 nullptr
+     * @throws std::runtime_error 如果包内模块创建失败
      */
     std::shared_ptr<ShaderModule> getShaderModule(const std::string &name);
 
@@ -147,14 +250,25 @@ class ShaderManager
      * 适用于首次加载或确保着色器存在的场景。
      *
      * @param name 着色器名称（用于缓存键和调试）
-     * @param code SPIR-V 字节码
+     * @param code SPIR-V 字节码（只在调用期间读取）
      * @param stage 着色器阶段标志（顶点、片段、计算等）
      * @return std::shared_ptr<ShaderModule> 着色器模块的智能指针
      * @throws std::runtime_error 如果创建失败
      */
-    std::shared_ptr<ShaderModule> createShaderModule(const std::string &name, const std::vector<uint32_t> &code,
+    std::shared_ptr<ShaderModule> createShaderModule(const std::string &name, std::span<const uint32_t> code,
                                                      vk::ShaderStageFlagBits stage);
 
+    /**
+     * @brief 把模块标识缓存写入磁盘（先写临时文件再原子重命名）
+     * @return bool 是否成功（未使用标识或没有新条目时返回 false）
+     */
+    bool save();
+
+    /**
+     * @brief 获取加载统计
+     */
+    Stats getStats() const;
+
     /**
      * @brief 清理所有缓存的着色器模块。
      *
@@ -173,7 +287,24 @@ class ShaderManager
      * @return vk::ShaderModule 着色器模块句柄
      * @throws std::runtime_error 如果创建失败
      */
-    vk::ShaderModule createshadermodule(const std::vector<uint32_t> &code);
+    vk::ShaderModule createshadermodule(std::span<const uint32_t> code);
+
+    /**
+     * @brief 从着色器包的一项创建模块（有缓存的标识时只创建标识封装）
+     */
+    std::shared_ptr<ShaderModule> createpackagemodule(const ShaderPackage::Entry &entry);
+
+    /**
+     * @brief 反射模块（优先使用包内预存的反射数据，反射失败时返回空并打印警告）
+     */
+    std::shared_ptr<const ShaderReflection> reflectmodule(std::span<const uint32_t> code,
+                                                          std::span<const uint8_t> packaged,
+                                                          vk::ShaderStageFlagBits stage);
+
+    /**
+     * @brief 读取并校验模块标识缓存文件（算法 UUID 不匹配时丢弃）
+     */
+    void loadidentifiers();
 
   private:
     /// 逻辑设备引用
@@ -182,6 +313,18 @@ class ShaderManager
     /// 已加载的着色器模块缓存（名称 -> 模块）
     std::unordered_map<std::string, std::shared_ptr<ShaderModule>> m_shaderModules;
 
+    /// 已挂载的着色器包（按挂载顺序，查找时从后往前）
+    std::vector<std::unique_ptr<ShaderPackage>> m_packages;
+
+    /// 模块标识缓存（SPIR-V 内容哈希 -> 标识）
+    std::unordered_map<uint64_t, std::vector<uint8_t>> m_identifiers;
+    std::filesystem::path m_identifierCacheFile;
+    std::array<uint8_t, VK_UUID_SIZE> m_identifierAlgorithm{}; ///< shaderModuleIdentifierAlgorithmUUID
+    PFN_vkGetShaderModuleIdentifierEXT m_getShaderModuleIdentifier{nullptr};
+    bool m_identifiersDirty{false};
+
+    Stats m_stats;
+
     /// 互斥锁，保护线程安全
     mutable std::mutex m_mutex;
 };
@@ -0,0 +1,165 @@
+/**
+ * @file ShaderPackage.hpp
+ * @brief 着色器包：多个 SPIR-V 模块及其反射数据打包成一个带索引的二进制文件
+ * @details 运行时只映射整个文件并校验索引表，着色器代码按需从映射内存直接交给驱动，
+ *          不再逐个打开文件、也不再把字节码拷贝到堆上。
+ *
+ *          文件布局（所有段按 16 字节对齐，小端）：
+ *          [ShaderPackageHeader][ShaderPackageEntry x entryCount（按名称字节序排序）][名称字符串表]
+ *          [各模块的 SPIR-V 与反射数据]
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vulkan/vulkan.hpp>
+
+namespace vkcore
+{
+
+class MappedFile;
+
+/**
+ * @struct ShaderPackageHeader
+ * @brief 着色器包文件头
+ */
+struct ShaderPackageHeader
+{
+    char magic[4];         ///< "QTSP"
+    uint32_t version;      ///< 格式版本（ShaderPackage::kVersion）
+    uint32_t entryCount;   ///< 模块数量
+    uint32_t reserved;     ///< 对齐
+    uint64_t entryOffset;  ///< 索引表偏移
+    uint64_t stringOffset; ///< 名称字符串表偏移
+};
+
+/**
+ * @struct ShaderPackageEntry
+ * @brief 索引表项
+ */
+struct ShaderPackageEntry
+{
+    uint32_t nameOffset;       ///< 名称在字符串表中的偏移
+    uint32_t nameLength;       ///< 名称字节数（不含 '\0'）
+    uint32_t stage;            ///< VkShaderStageFlagBits
+    uint32_t codeSize;         ///< SPIR-V 字节数（4 的倍数）
+    uint64_t codeOffset;       ///< SPIR-V 在文件中的偏移
+    uint64_t reflectionOffset; ///< 反射数据在文件中的偏移
+    uint32_t reflectionSize;   ///< 反射数据字节数（0 表示没有）
+    uint32_t reserved;         ///< 对齐
+    uint64_t contentHash;      ///< SPIR-V 的 FNV-1a 哈希（打包时计算，运行时作为模块标识缓存的键）
+};
+
+/**
+ * @struct ShaderPackageSource
+ * @brief 打包时的一个输入模块
+ */
+struct ShaderPackageSource
+{
+    std::string name;                    ///< 查找用的名称（例如 "mesh.vert"）
+    vk::ShaderStageFlagBits stage;       ///< 着色器阶段
+    std::span<const uint32_t> code;      ///< SPIR-V 字节码
+    std::span<const uint8_t> reflection; ///< 反射数据（可为空）
+};
+
+/**
+ * @class ShaderPackage
+ * @brief 只读的着色器包（映射在对象析构前保持有效）
+ *
+ * @example
+ * @code
+ * vkcore::ShaderPackage package("assets/shaders/spv/shaders.qtsp");
+ * if (auto entry = package.find("mesh.vert"))
+ * {
+ *     createModule(entry->code); // 直接指向映射内存
+ * }
+ * @endcode
+ *
+ * @note 所有 const 接口线程安全
+ */
+class ShaderPackage
+{
+  public:
+    static constexpr uint32_t kVersion = 1; ///< 修改文件布局时递增
+
+    /**
+     * @struct Entry
+     * @brief 包内一个模块的只读视图（生命周期不超过 ShaderPackage）
+     */
+    struct Entry
+    {
+        std::string_view name;
+        vk::ShaderStageFlagBits stage{vk::ShaderStageFlagBits::eVertex};
+        std::span<const uint32_t> code;
+        std::span<const uint8_t> reflection;
+        uint64_t contentHash{0};
+    };
+
+    /**
+     * @brief 构造函数，映射文件并校验文件头与索引表
+     * @param filePath 着色器包路径
+     * @throws std::runtime_error 如果文件不存在、版本不匹配或索引表越界
+     */
+    explicit ShaderPackage(const std::filesystem::path &filePath);
+    ~ShaderPackage();
+
+    /** 禁用拷贝与移动 */
+    ShaderPackage(const ShaderPackage &) = delete;
+    ShaderPackage &operator=(const ShaderPackage &) = delete;
+
+    /**
+     * @brief 按名称查找模块（索引表按名称排序，二分查找）
+     * @return 找到时返回视图，否则返回空
+     */
+    std::optional<Entry> find(std::string_view name) const;
+
+    /**
+     * @brief 获取模块数量
+     */
+    uint32_t getEntryCount() const
+    {
+        return m_entryCount;
+    }
+
+    /**
+     * @brief 按索引获取模块（按名称排序）
+     */
+    Entry getEntry(uint32_t index) const;
+
+    /**
+     * @brief 获取包文件路径
+     */
+    const std::filesystem::path &getPath() const
+    {
+        return m_path;
+    }
+
+    /**
+     * @brief 把多个模块写入着色器包（先写临时文件再重命名，读者不会看到半个文件）
+     * @param filePath 着色器包路径
+     * @param sources 输入模块（名称不能重复）
+     * @return bool 是否成功
+     * @throws std::invalid_argument 如果名称重复或为空、字节码为空
+     */
+    static bool write(const std::filesystem::path &filePath, std::span<const ShaderPackageSource> sources);
+
+    /**
+     * @brief 计算 SPIR-V 的内容哈希（与 ShaderPackageEntry::contentHash 相同）
+     */
+    static uint64_t hashCode(std::span<const uint32_t> code);
+
+  private:
+    std::filesystem::path m_path;
+    std::unique_ptr<MappedFile> m_file;
+    const ShaderPackageEntry *m_entries = nullptr;
+    const char *m_strings = nullptr;
+    uint32_t m_entryCount = 0;
+};
+
+} // namespace vkcore
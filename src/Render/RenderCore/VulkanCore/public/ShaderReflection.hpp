@@ -0,0 +1,88 @@
+/**
+ * @file ShaderReflection.hpp
+ * @brief SPIR-V 反射：描述符绑定、推送常量与特化常量
+ * @details 直接扫描 SPIR-V 指令流（不依赖外部反射库），只提取创建管线布局所需的信息。
+ *          ShaderManager 在创建模块时反射一次并随 ShaderModule 缓存；着色器包可以预先存放序列化的结果，
+ *          运行时直接反序列化。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace vkcore
+{
+
+/**
+ * @struct ShaderReflection
+ * @brief 单个着色器模块的反射结果
+ *
+ * @example
+ * @code
+ * auto reflection = vkcore::ShaderReflection::reflect(code, vk::ShaderStageFlagBits::eFragment);
+ * for (const auto &binding : reflection.bindings)
+ * {
+ *     // binding.set / binding.binding / binding.type / binding.count
+ * }
+ * @endcode
+ */
+struct ShaderReflection
+{
+    /**
+     * @struct Binding
+     * @brief 一个描述符绑定
+     */
+    struct Binding
+    {
+        uint32_t set{0};                                             ///< 描述符集索引
+        uint32_t binding{0};                                         ///< 绑定索引
+        vk::DescriptorType type{vk::DescriptorType::eUniformBuffer}; ///< 描述符类型
+        uint32_t count{1};                                           ///< 数组元素数（0 表示运行时大小的数组）
+
+        bool operator==(const Binding &) const = default;
+    };
+
+    /**
+     * @struct SpecializationConstant
+     * @brief 一个特化常量
+     */
+    struct SpecializationConstant
+    {
+        uint32_t id{0};   ///< constant_id
+        uint32_t size{4}; ///< 字节数（bool 按 VkBool32 计为 4）
+
+        bool operator==(const SpecializationConstant &) const = default;
+    };
+
+    vk::ShaderStageFlagBits stage{vk::ShaderStageFlagBits::eVertex};
+    std::vector<Binding> bindings;                               ///< 按 (set, binding) 排序
+    uint32_t pushConstantOffset{0};                              ///< 推送常量块的起始偏移
+    uint32_t pushConstantSize{0};                                ///< 推送常量块的字节数（0 表示没有）
+    std::vector<SpecializationConstant> specializationConstants; ///< 按 id 排序
+
+    /**
+     * @brief 反射 SPIR-V 字节码
+     * @param code SPIR-V 字节码
+     * @param stage 着色器阶段
+     * @return ShaderReflection 反射结果
+     * @throws std::invalid_argument 如果字节码不是合法的 SPIR-V
+     */
+    static ShaderReflection reflect(std::span<const uint32_t> code, vk::ShaderStageFlagBits stage);
+
+    /**
+     * @brief 序列化为紧凑的二进制（存入着色器包）
+     */
+    std::vector<uint8_t> serialize() const;
+
+    /**
+     * @brief 从 serialize() 的结果恢复
+     * @return 数据完整且版本一致时返回结果，否则返回空（调用方应重新反射）
+     */
+    static std::optional<ShaderReflection> deserialize(std::span<const uint8_t> data);
+};
+
+} // namespace vkcore
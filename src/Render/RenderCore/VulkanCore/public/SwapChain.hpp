@@ -1,7 +1,12 @@
 #pragma once
+#include "DeferredDeletionQueue.hpp"
 #include "Device.hpp"
+#include "FrameTimeline.hpp"
 #include "VKResource.hpp"
+#include <chrono>
+#include <deque>
 #include <memory>
+#include <span>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
@@ -9,13 +14,76 @@
  * @file SwapChain.hpp
  * @brief Vulkan 交换链的 RAII 封装，管理表面图像呈现
  * @details 该类封装了 Vulkan 交换链的创建、图像获取、呈现以及帧同步逻辑。
- *          使用双缓冲机制（MAX_FRAMES_IN_FLIGHT），自动处理图像可用信号量和飞行中栅栏。
- *          支持交换链过期时的自动重建。
+ *          在途帧数在运行时配置（默认 MAX_FRAMES_IN_FLIGHT），帧节奏由图形队列上的一条时间线信号量
+ *          （FrameTimeline）控制，取代每帧一个的飞行中栅栏。
+ *          支持交换链过期时的自动重建：新交换链以旧交换链为 oldSwapchain 创建，旧交换链、图像视图与
+ *          渲染完成信号量交给延迟销毁队列，在引用它们的帧退休后释放，重建过程不等待设备空闲。
+ *          呈现策略（呈现模式偏好、图像数量、排队帧数上限）可在运行时切换；设备启用 VK_KHR_present_wait
+ *          时按呈现 ID 等待上屏，限制排队帧数并测量输入到上屏的延迟。
+ *          多个交换链（多视口）可以共享调用方的一条帧时间线，并以 presentAll() 在一次 vkQueuePresentKHR 中呈现。
  */
 
 namespace vkcore
 {
 
+/**
+ * @struct PresentPolicy
+ * @brief 交换链呈现策略
+ * @details 默认值保持吞吐优先的 Mailbox > Immediate > FIFO 且不限制排队；
+ *          maxQueuedFrames 需要设备启用 VK_KHR_present_id 与 VK_KHR_present_wait，否则被忽略
+ */
+struct PresentPolicy
+{
+    /// 呈现模式偏好，选择第一个表面支持的模式；都不支持时使用 FIFO（规范保证支持）
+    std::vector<vk::PresentModeKHR> modes{vk::PresentModeKHR::eMailbox, vk::PresentModeKHR::eImmediate,
+                                          vk::PresentModeKHR::eFifo};
+    uint32_t imageCount{0};      ///< 期望的交换链图像数量（0 为 minImageCount + 1），钳制到表面支持的范围
+    uint32_t maxQueuedFrames{0}; ///< 已呈现但尚未上屏的帧数上限（0 不限制），在获取下一张图像前等待
+
+    /**
+     * @brief 低延迟垂直同步：FIFO 不撕裂，最少的图像，呈现队列中最多一帧
+     */
+    static PresentPolicy lowLatencyFifo()
+    {
+        return PresentPolicy{{vk::PresentModeKHR::eFifo}, 2, 1};
+    }
+
+    /**
+     * @brief 省电：FIFO 把帧率限制在刷新率，排队不超过两帧，CPU/GPU 在帧间可以空闲
+     */
+    static PresentPolicy powerSaving()
+    {
+        return PresentPolicy{{vk::PresentModeKHR::eFifo}, 0, 2};
+    }
+};
+
+/**
+ * @struct PresentLatencyStats
+ * @brief 输入到呈现的延迟统计
+ */
+struct PresentLatencyStats
+{
+    double lastMs{0.0};       ///< 最近一帧的延迟（毫秒）
+    double averageMs{0.0};    ///< 指数滑动平均（毫秒）
+    double maxMs{0.0};        ///< 最大延迟（毫秒）
+    uint64_t samples{0};      ///< 样本数
+    bool displayTimed{false}; ///< true：测到上屏时刻（present wait）；false：只测到 vkQueuePresentKHR 调用时刻
+};
+
+class SwapChain;
+
+/**
+ * @struct SwapChainPresent
+ * @brief SwapChain::presentAll() 中的一个交换链
+ */
+struct SwapChainPresent
+{
+    SwapChain *swapchain{nullptr};                     ///< 要呈现的交换链
+    vk::Semaphore renderFinishedSemaphore;             ///< 渲染完成信号量
+    uint32_t imageIndex{0};                            ///< 要呈现的图像索引
+    std::chrono::steady_clock::time_point inputTime{}; ///< 本帧采样输入的时刻（默认取获取图像的时刻）
+};
+
 /**
  * @class SwapChain
  * @brief Vulkan 交换链管理类，提供表面图像获取和呈现功能
@@ -24,17 +92,36 @@ namespace vkcore
 class SwapChain
 {
   public:
-    /// @brief 飞行中的最大帧数（双缓冲）
+    /// @brief 默认的在途帧数（双缓冲）
     static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
 
+    /// @brief 默认的重建防抖间隔：连续缩放时最后一次请求之后至少间隔这么久才重建
+    static constexpr std::chrono::milliseconds DEFAULT_RECREATE_DEBOUNCE{50};
+
     /**
      * @brief 构造函数，创建交换链及相关资源
      * @param surface Vulkan 表面句柄
      * @param device 逻辑设备引用
      * @param allocator VMA 分配器（用于未来可能的资源分配）
+     * @param framesInFlight 在途帧数（2 偏向低延迟，3 偏向吞吐）
+     * @param policy 呈现策略
+     * @throws std::runtime_error 如果交换链创建失败
+     */
+    SwapChain(vk::SurfaceKHR surface, Device &device, VmaAllocator allocator,
+              uint32_t framesInFlight = MAX_FRAMES_IN_FLIGHT, const PresentPolicy &policy = {});
+
+    /**
+     * @brief 构造函数，使用调用方的帧时间线（多个交换链由同一个帧循环驱动时共享）
+     * @param surface Vulkan 表面句柄
+     * @param device 逻辑设备引用
+     * @param allocator VMA 分配器
+     * @param timeline 共享的帧时间线（生命周期须长于本对象），尚未开始任何帧时在此开始第一帧
+     * @param policy 呈现策略
+     * @note 帧由时间线的所有者推进，不能调用 advanceToNextFrame()
      * @throws std::runtime_error 如果交换链创建失败
      */
-    SwapChain(vk::SurfaceKHR surface, Device &device, VmaAllocator allocator);
+    SwapChain(vk::SurfaceKHR surface, Device &device, VmaAllocator allocator, FrameTimeline &timeline,
+              const PresentPolicy &policy = {});
 
     /**
      * @brief 析构函数，自动清理交换链及同步对象
@@ -50,13 +137,15 @@ class SwapChain
      * @param[out] imageIndex 输出参数，返回可用图像的索引
      * @return vk::Result 操作结果
      * @retval eSuccess 成功获取图像
-     * @retval eErrorOutOfDateKHR 交换链过期，已自动重建
+     * @retval eErrorOutOfDateKHR 交换链过期（已尝试重建），或表面尺寸为 0（窗口最小化）；本帧应跳过
      * @retval eSuboptimalKHR 交换链次优但可用
      * @details 该函数会：
-     *          1. 等待当前帧的栅栏
-     *          2. 从交换链获取下一个图像索引
-     *          3. 重置栅栏以供下次使用
-     *          4. 如果交换链过期则自动重建
+     *          1. 如果有到期的重建请求（requestRecreate() 之后经过了防抖间隔），先重建交换链
+     *          2. 按 PresentPolicy::maxQueuedFrames 等待较早的帧上屏，并记录已上屏帧的延迟
+     *          3. 从交换链获取下一个图像索引
+     *          4. 如果该图像仍被之前的帧使用，等待那一帧的时间线值
+     *          5. 如果交换链过期则立即重建（当前帧不前进，下次调用重试）
+     * @note 复用每帧资源所需的等待在 advanceToNextFrame() 中完成
      * @throws std::runtime_error 如果获取图像失败
      */
     vk::Result acquireNextImage(uint32_t &imageIndex);
@@ -65,14 +154,26 @@ class SwapChain
      * @brief 将渲染完成的图像呈现到表面
      * @param renderFinishedSemaphore 渲染完成信号量，确保渲染已完成
      * @param imageIndex 要呈现的图像索引
+     * @param inputTime 本帧采样输入的时刻（用于延迟统计，默认取 acquireNextImage() 的时刻）
      * @return vk::Result 操作结果
      * @retval eSuccess 成功呈现图像
      * @retval eErrorOutOfDateKHR 交换链过期，已自动重建
-     * @retval eSuboptimalKHR 交换链次优但已呈现
-     * @details 该函数会等待渲染完成信号量，然后将图像提交到呈现队列
+     * @retval eSuboptimalKHR 交换链次优但已呈现，已请求（防抖后的）重建
+     * @details 该函数会等待渲染完成信号量，然后将图像提交到呈现队列；启用 present wait 时以当前帧号作为呈现 ID
      * @throws std::runtime_error 如果呈现失败
      */
-    vk::Result present(vk::Semaphore renderFinishedSemaphore, uint32_t imageIndex);
+    vk::Result present(vk::Semaphore renderFinishedSemaphore, uint32_t imageIndex,
+                       std::chrono::steady_clock::time_point inputTime = {});
+
+    /**
+     * @brief 在一次 vkQueuePresentKHR 中呈现多个交换链（同一设备，通常共享一条帧时间线）
+     * @param presents 各交换链的呈现参数（为空时什么也不做）
+     * @param results (输出，可选) 各交换链的结果，大小须不小于 presents；每个交换链按 present() 的规则处理
+     *        过期与次优
+     * @throws std::invalid_argument 如果某项的交换链为空或 results 过小
+     * @throws std::runtime_error 如果呈现失败（过期与次优之外的错误）
+     */
+    static void presentAll(std::span<const SwapChainPresent> presents, std::span<vk::Result> results = {});
 
     /**
      * @brief 获取指定索引的交换链图像句柄
@@ -115,7 +216,7 @@ class SwapChain
 
     /**
      * @brief 获取指定帧索引的图像可用信号量
-     * @param index 帧索引（0 到 MAX_FRAMES_IN_FLIGHT-1）
+     * @param index 帧索引（0 到 getFramesInFlight()-1）
      * @return vk::Semaphore 图像可用信号量，用于同步图像获取
      */
     inline vk::Semaphore getImageAvailableSemaphore(uint32_t index) const
@@ -124,28 +225,25 @@ class SwapChain
     }
 
     /**
-     * @brief 获取指定帧索引的飞行中栅栏
-     * @param index 帧索引（0 到 MAX_FRAMES_IN_FLIGHT-1）
-     * @return vk::Fence 飞行中栅栏，用于 CPU-GPU 同步
+     * @brief 获取帧时间线（注册帧退休回调、CPU 等待某一帧）
      */
-    inline vk::Fence getFlightFence(uint32_t index) const
+    inline FrameTimeline &getFrameTimeline()
     {
-        return m_FlightFences[index];
+        return *m_timeline;
     }
 
     /**
-     * @brief 获取飞行中栅栏（别名，与getFlightFence相同）
-     * @param index 帧索引（0 到 MAX_FRAMES_IN_FLIGHT-1）
-     * @return vk::Fence 飞行中栅栏
+     * @brief 获取当前帧的时间线触发信息，该帧图形队列上的最后一次提交必须触发它
+     * @return vk::SemaphoreSubmitInfo 用于 vkQueueSubmit2 的触发信息
      */
-    inline vk::Fence getInFlightFence(uint32_t index) const
+    inline vk::SemaphoreSubmitInfo getFrameSignalInfo() const
     {
-        return m_FlightFences[index];
+        return m_timeline->getSignalInfo(0);
     }
 
     /**
      * @brief 获取渲染完成信号量
-     * @param index 帧索引（0 到 MAX_FRAMES_IN_FLIGHT-1）
+     * @param index 图像索引（0 到 getImageCount()-1）
      * @return vk::Semaphore 渲染完成信号量
      */
     inline vk::Semaphore getRenderFinishedSemaphore(uint32_t index) const
@@ -155,37 +253,139 @@ class SwapChain
 
     /**
      * @brief 获取当前帧索引
-     * @return uint32_t 当前帧索引（0 或 1）
+     * @return uint32_t 当前帧索引（0 到 getFramesInFlight()-1）
      */
     inline uint32_t getCurrentFrameIndex() const
     {
-        return m_currentFrameIndex;
+        return m_timeline->getFrameSlot();
     }
 
     /**
-     * @brief 推进到下一帧
-     * @details 将帧索引递增并循环（0 -> 1 -> 0）
+     * @brief 获取在途帧数
      */
-    inline void advanceToNextFrame()
+    inline uint32_t getFramesInFlight() const
     {
-        m_currentFrameIndex = (m_currentFrameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+        return m_timeline->getFramesInFlight();
     }
 
+    /**
+     * @brief 调整在途帧数
+     * @details 等待设备空闲后重建每帧的图像可用信号量；调用者的每帧资源需按新的数量重新分配。
+     *          共享时间线时同时调整时间线，共享它的其他交换链也需要以同样的数量调用
+     * @throws std::invalid_argument 如果 framesInFlight 为 0
+     */
+    void setFramesInFlight(uint32_t framesInFlight);
+
+    /**
+     * @brief 请求重建交换链（窗口缩放时调用）
+     * @details 重建推迟到最后一次请求之后的防抖间隔结束，在下一次 acquireNextImage() 中执行；
+     *          交换链过期时不受防抖限制，立即重建
+     */
+    void requestRecreate();
+
+    /**
+     * @brief 是否有尚未执行的重建请求（只在 acquireNextImage() 中执行，跳过获取图像的调用者需要检查）
+     */
+    inline bool isRecreatePending() const
+    {
+        return m_recreatePending;
+    }
+
+    /**
+     * @brief 设置重建防抖间隔（0 表示下一次获取图像时立即重建）
+     */
+    inline void setRecreateDebounce(std::chrono::milliseconds debounce)
+    {
+        m_recreateDebounce = debounce;
+    }
+
+    /**
+     * @brief 切换呈现策略
+     * @details 排队帧数上限立即生效；呈现模式或图像数量变化时在下一次获取图像时重建交换链（不防抖）
+     */
+    void setPresentPolicy(const PresentPolicy &policy);
+
+    /**
+     * @brief 获取当前的呈现策略
+     */
+    inline const PresentPolicy &getPresentPolicy() const
+    {
+        return m_policy;
+    }
+
+    /**
+     * @brief 获取交换链实际使用的呈现模式
+     */
+    inline vk::PresentModeKHR getPresentMode() const
+    {
+        return m_presentMode;
+    }
+
+    /**
+     * @brief 获取交换链图像数量
+     */
+    inline uint32_t getImageCount() const
+    {
+        return static_cast<uint32_t>(m_images.size());
+    }
+
+    /**
+     * @brief 是否可以按呈现 ID 等待上屏（设备启用了 VK_KHR_present_id 与 VK_KHR_present_wait）
+     */
+    inline bool supportsPresentWait() const
+    {
+        return m_waitForPresent != nullptr;
+    }
+
+    /**
+     * @brief 获取输入到呈现的延迟统计
+     */
+    inline PresentLatencyStats getLatencyStats() const
+    {
+        return m_latency;
+    }
+
+    /**
+     * @brief 获取交换链代数（每次重建加一）
+     * @details 依赖交换链的资源（尺寸相关的附件、按格式创建的管线）比较代数，在下次使用时按需重建
+     */
+    inline uint64_t getGeneration() const
+    {
+        return m_generation;
+    }
+
+    /**
+     * @brief 是否使用调用方共享的帧时间线
+     */
+    inline bool isTimelineShared() const
+    {
+        return !m_ownedTimeline;
+    }
+
+    /**
+     * @brief 推进到下一帧
+     * @details 开始时间线上的下一帧，并在 CPU 上等待复用同一帧索引的那一帧（framesInFlight 帧之前）完成
+     * @throws std::runtime_error 如果时间线是共享的（由其所有者推进）
+     */
+    void advanceToNextFrame();
+
     /**
      * @brief 清理交换链及相关资源
-     * @details 销毁同步对象、图像视图和交换链本身
+     * @details 销毁同步对象、图像视图和交换链本身，以及所有尚未释放的旧交换链
+     * @warning 调用者需保证设备上没有引用这些资源的在途工作
      */
     void cleanup();
 
   private:
-    uint32_t m_currentFrameIndex = 0; ///< 当前渲染帧索引（0 或 1）
+    std::unique_ptr<FrameTimeline> m_ownedTimeline;        ///< 自有的帧时间线（共享调用方的时间线时为空）
+    FrameTimeline *m_timeline = nullptr;                   ///< 图形队列的帧时间线（跨交换链重建保留）
+    std::unique_ptr<DeferredDeletionQueue> m_retiredQueue; ///< 重建替换下的旧交换链资源（关联 m_timeline）
 
     std::vector<vk::Image> m_images;                       ///< 交换链图像句柄（由交换链拥有）
     std::vector<vk::ImageView> m_imageViews;               ///< 图像视图（由本类创建和销毁）
-    std::vector<vk::Semaphore> m_imageAvailableSemaphores; ///< 图像可用信号量（每个交换链图像一个）
+    std::vector<vk::Semaphore> m_imageAvailableSemaphores; ///< 图像可用信号量（每帧一个）
     std::vector<vk::Semaphore> m_renderFinishedSemaphores; ///< 渲染完成信号量（每个交换链图像一个）
-    std::vector<vk::Fence> m_FlightFences;                 ///< 飞行中栅栏（每帧一个，MAX_FRAMES_IN_FLIGHT）
-    std::vector<vk::Fence> m_imagesInFlight; ///< 跟踪每个图像是否正在使用（初始为 nullptr）
+    std::vector<uint64_t> m_imagesInFlight;                ///< 每个图像最近一次被使用的帧号（0 表示未使用）
 
     Device &m_device;             ///< 逻辑设备引用
     vk::SwapchainKHR m_swapchain; ///< 交换链句柄
@@ -194,6 +394,28 @@ class SwapChain
 
     vk::Format m_swapchainFormat = vk::Format::eUndefined; ///< 交换链图像格式
     vk::Extent2D m_swapchainExtent = {0, 0};               ///< 交换链图像尺寸
+    uint64_t m_generation = 0;                             ///< 重建次数
+
+    /**
+     * @struct PendingPresent
+     * @brief 已呈现、尚未确认上屏的一帧
+     */
+    struct PendingPresent
+    {
+        uint64_t presentId;
+        std::chrono::steady_clock::time_point inputTime;
+    };
+
+    PresentPolicy m_policy;                                       ///< 呈现策略
+    vk::PresentModeKHR m_presentMode = vk::PresentModeKHR::eFifo; ///< 实际使用的呈现模式
+    PFN_vkWaitForPresentKHR m_waitForPresent = nullptr;           ///< 未启用 present wait 时为空
+    std::deque<PendingPresent> m_pendingPresents;                 ///< 按呈现 ID 递增排列（仅当前交换链）
+    std::chrono::steady_clock::time_point m_acquireTime;          ///< 本帧 acquireNextImage() 的时刻
+    PresentLatencyStats m_latency;
+
+    bool m_recreatePending = false;                                          ///< 有未执行的重建请求
+    std::chrono::steady_clock::time_point m_recreateDue;                     ///< 重建请求的到期时间
+    std::chrono::milliseconds m_recreateDebounce{DEFAULT_RECREATE_DEBOUNCE}; ///< 重建防抖间隔
 
   private:
     /**
@@ -205,8 +427,10 @@ class SwapChain
     /**
      * @brief 创建交换链
      * @details 查询表面能力、选择格式和呈现模式、创建交换链
+     * @param oldSwapchain 被替换的交换链（可为空），驱动可以复用其资源并平滑过渡
+     * @return 表面尺寸为 0（窗口最小化）时不创建并返回 false
      */
-    void createswapchain();
+    bool createswapchain(vk::SwapchainKHR oldSwapchain);
 
     /**
      * @brief 创建图像视图
@@ -216,16 +440,39 @@ class SwapChain
 
     /**
      * @brief 创建同步对象
-     * @details 创建信号量和栅栏用于帧同步
+     * @details 创建每帧的图像可用信号量，以及 createimagesemaphores() 的每图像对象
      */
     void createsyncobjects();
 
+    /**
+     * @brief 创建每个交换链图像的渲染完成信号量，并重置图像的使用记录
+     */
+    void createimagesemaphores();
+
+    /**
+     * @brief 按排队帧数上限等待较早的呈现上屏，并统计已上屏帧的延迟
+     */
+    void throttle();
+
+    /**
+     * @brief 处理一次呈现的结果：记录延迟或待上屏的呈现 ID，过期时重建、次优时请求重建
+     * @throws std::runtime_error 如果结果是过期与次优之外的错误
+     */
+    void finishpresent(vk::Result result, uint64_t presentId, std::chrono::steady_clock::time_point inputTime);
+
+    /**
+     * @brief 记录一帧的输入到呈现延迟
+     */
+    void recordlatency(std::chrono::steady_clock::time_point inputTime, bool displayTimed);
+
     /**
      * @brief 重建交换链
-     * @details 等待设备空闲，清理旧资源，重新初始化
+     * @details 以当前交换链为 oldSwapchain 创建新交换链，旧交换链、图像视图与渲染完成信号量
+     *          延迟到当前帧之后 framesInFlight 帧退休时销毁；每帧的图像可用信号量保留复用
+     * @return 表面尺寸为 0 时保留旧交换链与重建请求并返回 false
      * @note 用于窗口大小改变或交换链过期时
      */
-    void recreate();
+    bool recreate();
 };
 
 } // namespace vkcore
@@ -0,0 +1,142 @@
+/**
+ * @file TLSFAllocator.hpp
+ * @brief 两级分离适配（TLSF）区间分配器
+ * @details 在一段 [0, capacity) 的抽象区间上做 O(1) 的分配与释放，本身不持有任何 GPU 内存，
+ *          用于在大块缓冲区（顶点/索引池等）中子分配。单位由调用方决定（字节、顶点、索引……）。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace vkcore
+{
+
+/**
+ * @class TLSFAllocator
+ * @brief O(1) 区间分配器（Two-Level Segregated Fit）
+ * @details 空闲块按大小分入 32 个一级桶（2 的幂）× 16 个二级桶（线性细分），两级位图定位非空桶；
+ *          释放时与物理相邻的空闲块立即合并，碎片只取决于分配模式而非时间。
+ *
+ * @example
+ * @code
+ * vkcore::TLSFAllocator allocator(1u << 20); // 1M 个顶点
+ * auto allocation = allocator.allocate(vertexCount);
+ * if (allocation.isValid())
+ * {
+ *     uploadVertices(allocation.offset);
+ *     allocator.free(allocation);
+ * }
+ * @endcode
+ *
+ * @note 非线程安全，由调用方加锁
+ */
+class TLSFAllocator
+{
+  public:
+    static constexpr uint32_t kInvalidBlock = UINT32_MAX;
+
+    /**
+     * @struct Allocation
+     * @brief 一次分配的结果
+     */
+    struct Allocation
+    {
+        uint32_t offset{0};            ///< 区间起始偏移
+        uint32_t size{0};              ///< 区间大小
+        uint32_t block{kInvalidBlock}; ///< 内部块索引（释放时使用）
+
+        bool isValid() const
+        {
+            return block != kInvalidBlock;
+        }
+    };
+
+    /**
+     * @brief 构造函数
+     * @param capacity 可分配区间的总大小
+     */
+    explicit TLSFAllocator(uint32_t capacity);
+
+    /**
+     * @brief 分配一段区间
+     * @param size 区间大小（必须大于 0）
+     * @return Allocation 分配结果，空间不足时 isValid() 为 false
+     */
+    Allocation allocate(uint32_t size);
+
+    /**
+     * @brief 释放一段区间
+     * @param allocation allocate() 返回的有效分配
+     */
+    void free(const Allocation &allocation);
+
+    /**
+     * @brief 释放全部分配，恢复为一整块空闲区间
+     */
+    void reset();
+
+    uint32_t getCapacity() const
+    {
+        return m_capacity;
+    }
+
+    uint32_t getUsedSize() const
+    {
+        return m_usedSize;
+    }
+
+    uint32_t getFreeSize() const
+    {
+        return m_capacity - m_usedSize;
+    }
+
+    uint32_t getAllocationCount() const
+    {
+        return m_allocationCount;
+    }
+
+    /**
+     * @brief 获取最大的空闲块大小（衡量碎片：空闲总量远大于它时说明需要整理）
+     */
+    uint32_t getLargestFreeBlock() const;
+
+  private:
+    static constexpr uint32_t kSecondLevelBits = 4;
+    static constexpr uint32_t kSecondLevelCount = 1u << kSecondLevelBits;
+    static constexpr uint32_t kFirstLevelCount = 32;
+
+    struct Block
+    {
+        uint32_t offset{0};
+        uint32_t size{0};
+        uint32_t prevPhysical{kInvalidBlock}; ///< 物理上相邻的前一块
+        uint32_t nextPhysical{kInvalidBlock}; ///< 物理上相邻的后一块
+        uint32_t prevFree{kInvalidBlock};     ///< 同一桶空闲链表中的前一块
+        uint32_t nextFree{kInvalidBlock};     ///< 同一桶空闲链表中的后一块
+        bool free{false};
+    };
+
+    static void mapping(uint32_t size, uint32_t &firstLevel, uint32_t &secondLevel);
+
+    uint32_t newblock();
+    void recycleblock(uint32_t index);
+    void insertfreeblock(uint32_t index);
+    void removefreeblock(uint32_t index);
+    uint32_t findfreeblock(uint32_t size) const;
+
+  private:
+    uint32_t m_capacity;
+    uint32_t m_usedSize{0};
+    uint32_t m_allocationCount{0};
+
+    std::vector<Block> m_blocks;
+    std::vector<uint32_t> m_unusedBlocks; ///< 可复用的块索引
+
+    uint32_t m_firstLevelBitmap{0};
+    uint32_t m_secondLevelBitmaps[kFirstLevelCount]{};
+    uint32_t m_freeHeads[kFirstLevelCount][kSecondLevelCount];
+};
+
+} // namespace vkcore
@@ -0,0 +1,156 @@
+/**
+ * @file TransientBufferRing.hpp
+ * @brief 每帧临时常量的常驻映射环形缓冲
+ * @details 一个主机可见缓冲按在途帧均分为若干区域，每帧的逐 Pass / 逐绘制常量以原子指针递增的方式
+ *          从当前帧区域中分配，返回映射地址与缓冲内偏移；描述符集只写一次（offset 0、固定 range），
+ *          绘制时以 dynamic offset 选择数据，替代大量小缓冲的创建与逐次描述符更新。
+ */
+
+#pragma once
+
+#include "Device.hpp"
+#include "VKResource.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vma/vk_mem_alloc.h>
+
+namespace vkcore
+{
+
+/**
+ * @class TransientBufferRing
+ * @brief 按帧复用的动态偏移 UBO/SSBO 分配器
+ *
+ * @example
+ * @code
+ * vkcore::TransientBufferRing ring(device, allocator, 4 * 1024 * 1024, framesInFlight);
+ * // 描述符集创建时写入一次：binding 类型为 eUniformBufferDynamic，range 为单次读取的结构大小
+ * vk::DescriptorBufferInfo info = ring.getDescriptorInfo(sizeof(DrawConstants));
+ *
+ * ring.beginFrame(frameIndex); // 该帧栅栏 signal 之后
+ * auto constants = ring.push(drawConstants);
+ * cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout, 0, set, constants.offset);
+ * ring.flush(); // 提交前
+ * @endcode
+ *
+ * @note allocate()/push() 可在多个录制线程上并发调用（只有一次原子加）；
+ *       beginFrame()/flush() 须在没有并发分配时调用
+ */
+class TransientBufferRing
+{
+  public:
+    /**
+     * @struct Allocation
+     * @brief 一次分配的结果（在该帧下次 beginFrame() 之前有效）
+     */
+    struct Allocation
+    {
+        void *data{nullptr};    ///< 映射地址，直接写入
+        uint32_t offset{0};     ///< 缓冲内的字节偏移（bindDescriptorSets 的 dynamic offset）
+        vk::DeviceSize size{0}; ///< 请求的字节数
+    };
+
+    /**
+     * @struct Stats
+     * @brief 使用统计（单位：字节）
+     */
+    struct Stats
+    {
+        vk::DeviceSize frameCapacity{0}; ///< 每帧区域大小
+        vk::DeviceSize frameUsed{0};     ///< 当前帧已分配
+        vk::DeviceSize peakUsed{0};      ///< 历史单帧峰值
+    };
+
+    /**
+     * @brief 构造函数，创建并常驻映射环形缓冲
+     * @param device 逻辑设备
+     * @param allocator VMA 分配器
+     * @param bytesPerFrame 每帧区域大小（向上对齐到偏移对齐要求）
+     * @param framesInFlight 在途帧数量
+     * @param usage 缓冲用途（决定偏移对齐取 UBO 还是 SSBO 的设备限制）
+     * @throws std::invalid_argument 如果参数为 0 或总大小超出 32 位 dynamic offset 的范围
+     * @throws std::runtime_error 如果无法映射缓冲
+     */
+    TransientBufferRing(Device &device, VmaAllocator allocator, vk::DeviceSize bytesPerFrame, uint32_t framesInFlight,
+                        vk::BufferUsageFlags usage = vk::BufferUsageFlagBits::eUniformBuffer |
+                                                     vk::BufferUsageFlagBits::eStorageBuffer);
+    ~TransientBufferRing();
+
+    /** 禁用拷贝与移动 */
+    TransientBufferRing(const TransientBufferRing &) = delete;
+    TransientBufferRing &operator=(const TransientBufferRing &) = delete;
+
+    /**
+     * @brief 切换到第 frameIndex 帧的区域并清空（调用方保证该帧之前的 GPU 工作已完成）
+     * @throws std::invalid_argument 如果 frameIndex 越界
+     */
+    void beginFrame(uint32_t frameIndex);
+
+    /**
+     * @brief 从当前帧区域分配 size 字节（起始偏移满足设备的动态偏移对齐）
+     * @throws std::runtime_error 如果当前帧区域已满
+     */
+    Allocation allocate(vk::DeviceSize size);
+
+    /**
+     * @brief 分配并拷贝一个值
+     */
+    template <typename T> Allocation push(const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "TransientBufferRing::push requires a trivially copyable type");
+        Allocation allocation = allocate(sizeof(T));
+        std::memcpy(allocation.data, &value, sizeof(T));
+        return allocation;
+    }
+
+    /**
+     * @brief 刷新当前帧已写入的范围（非一致内存需要；一致内存时为空操作）
+     */
+    void flush();
+
+    /**
+     * @brief 获取缓冲句柄
+     */
+    vk::Buffer getBuffer() const
+    {
+        return m_buffer->get();
+    }
+
+    /**
+     * @brief 获取写入动态描述符的缓冲信息（offset 为 0，实际位置由 dynamic offset 给出）
+     * @param range 着色器单次读取的字节数
+     */
+    vk::DescriptorBufferInfo getDescriptorInfo(vk::DeviceSize range) const
+    {
+        return vk::DescriptorBufferInfo(m_buffer->get(), 0, range);
+    }
+
+    /**
+     * @brief 获取分配偏移的对齐
+     */
+    vk::DeviceSize getAlignment() const
+    {
+        return m_alignment;
+    }
+
+    /**
+     * @brief 获取使用统计
+     */
+    Stats getStats() const;
+
+  private:
+    std::unique_ptr<Buffer> m_buffer;
+    uint8_t *m_mapped{nullptr};
+    vk::DeviceSize m_alignment{0};
+    vk::DeviceSize m_frameSize{0};
+    uint32_t m_framesInFlight{0};
+
+    uint32_t m_frameIndex{0};
+    std::atomic<vk::DeviceSize> m_head{0}; ///< 当前帧区域内的下一个偏移（可能超过 m_frameSize）
+    vk::DeviceSize m_peakUsed{0};
+};
+
+} // namespace vkcore
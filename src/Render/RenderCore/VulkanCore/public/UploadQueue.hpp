@@ -0,0 +1,288 @@
+/**
+ * @file UploadQueue.hpp
+ * @brief 批量异步上传队列
+ * @details 所有 CPU -> GPU 的数据拷贝先写入一块常驻映射的暂存环形缓冲区，
+ *          在 flush() 时合并为传输队列上的一次提交，用时间线信号量标记完成。
+ *          调用者拿到的票据（时间线值）可用于 CPU 查询/等待，或在渲染提交中由GPU等待，
+ *          无需每个资源一次 executeOnetime + waitIdle。
+ */
+
+#pragma once
+
+#include "CommandPoolManager.hpp"
+#include "Device.hpp"
+#include "VKResource.hpp"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <vma/vk_mem_alloc.h>
+
+namespace vkcore
+{
+
+/**
+ * @typedef UploadTicket
+ * @brief 上传完成时时间线信号量将达到的值（0 表示无需等待）
+ */
+using UploadTicket = uint64_t;
+
+/**
+ * @class UploadQueue
+ * @brief 暂存环形缓冲区 + 传输队列批量提交 + 时间线信号量完成通知
+ *
+ * @example
+ * @code
+ * vkcore::UploadQueue uploads(device, allocator);
+ *
+ * auto vertexBuffer = std::make_shared<vkcore::Buffer>("vb", device, allocator, vertexDesc);
+ * vkcore::UploadTicket ticket = uploads.uploadBuffer(vertexBuffer, vertices.data(), vertexBytes);
+ * // ... 更多上传，全部进入同一批次 ...
+ * uploads.flush(); // 一次提交
+ *
+ * // 渲染提交等待 GPU 端完成（或 uploads.wait(ticket) 在 CPU 上阻塞）
+ * syncInfo.addTimelineWait(uploads.getTimelineSemaphore(), ticket, vk::PipelineStageFlagBits::eVertexInput);
+ * @endcode
+ *
+ * @note 传输族与图形族不同时，资源的队列族所有权在批次内释放，并由一次图形队列上的小提交获取，
+ *       票据对应获取完成的值，因此等待票据后资源可以直接在图形队列上使用
+ * @note 提交（flush()、暂存环已满或同一批次内重复上传同一图像时）持有 Device::getQueueMutex()，
+ *       与其他线程在同一队列上的提交互斥；按阈值的自动提交只在所有者线程上发生
+ */
+class UploadQueue
+{
+  public:
+    /**
+     * @brief 构造函数
+     * @param device Device 引用（需要启用 timelineSemaphore 与 synchronization2）
+     * @param allocator VMA 分配器
+     * @param stagingSize 暂存环形缓冲区大小（字节），超过该大小的单次上传使用独立暂存缓冲区
+     * @param flushThreshold 待提交数据达到该字节数时自动 flush（0 表示只手动 flush）；
+     *        自动 flush 只在所有者线程（构造线程，见 setOwnerThread()）上的上传中发生，其他线程的上传只累积到批次
+     */
+    UploadQueue(Device &device, VmaAllocator allocator, vk::DeviceSize stagingSize = 64ull * 1024 * 1024,
+                vk::DeviceSize flushThreshold = 0);
+
+    /**
+     * @brief 析构函数，等待所有已提交的上传完成后释放资源
+     * @note 未 flush 的上传会被丢弃
+     */
+    ~UploadQueue();
+
+    /** 禁用拷贝与移动 */
+    UploadQueue(const UploadQueue &) = delete;
+    UploadQueue &operator=(const UploadQueue &) = delete;
+    UploadQueue(UploadQueue &&) = delete;
+    UploadQueue &operator=(UploadQueue &&) = delete;
+
+    /**
+     * @brief 指定所有者线程（负责 flush() 的线程，通常是渲染线程；默认是构造线程）
+     * @details 按 flushThreshold 自动提交只在所有者线程上发生
+     */
+    void setOwnerThread(std::thread::id owner);
+
+    // ==================== 上传接口 ====================
+
+    /**
+     * @brief 把数据上传到缓冲区
+     * @param dst 目标缓冲区（需包含 eTransferDst 用途），批次完成前由上传队列持有引用
+     * @param data 源数据（函数返回后即可释放）
+     * @param size 字节数
+     * @param dstOffset 目标缓冲区内的偏移
+     * @return UploadTicket 该上传完成时的时间线值
+     */
+    UploadTicket uploadBuffer(const std::shared_ptr<Buffer> &dst, const void *data, vk::DeviceSize size,
+                              vk::DeviceSize dstOffset = 0);
+
+    /**
+     * @brief 把数据上传到图像（可一次上传多个 mip/层）
+     * @param dst 目标图像（需包含 eTransferDst 用途，当前内容会被丢弃），批次完成前由上传队列持有引用
+     * @param data 源数据（函数返回后即可释放）
+     * @param size 源数据总字节数
+     * @param regions 拷贝区域，bufferOffset 相对于 data 起始
+     * @param texelBlockSize 每个纹素块的字节数（暂存偏移需按其对齐）
+     * @param finalLayout 上传完成后的布局
+     * @param generateMips 为 true 时 regions 只需覆盖 mip 0，其余 mip 在图形队列上逐级 vkCmdBlitImage 生成
+     * @return UploadTicket 该上传完成时的时间线值
+     * @note 生成 mip 要求图像带有 eTransferSrc 用途，且格式支持 eBlitSrc/eBlitDst/eSampledImageFilterLinear
+     *       （调用者负责检查格式特性）；压缩格式不能作为 blit 目标，应上传预生成的 mip 链
+     */
+    UploadTicket uploadImage(const std::shared_ptr<Image> &dst, const void *data, vk::DeviceSize size,
+                             const std::vector<vk::BufferImageCopy> &regions, uint32_t texelBlockSize,
+                             vk::ImageLayout finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                             bool generateMips = false);
+
+    /**
+     * @brief 提交所有待处理的上传（一次传输队列提交）
+     * @return UploadTicket 本批次完成时的时间线值（没有待处理上传时返回最近一次提交的票据）
+     */
+    UploadTicket flush();
+
+    // ==================== 完成查询 ====================
+
+    /**
+     * @brief 票据对应的上传是否已在GPU上完成
+     */
+    bool isComplete(UploadTicket ticket) const;
+
+    /**
+     * @brief 在CPU上阻塞等待票据完成（票据尚未提交时会先 flush）
+     */
+    void wait(UploadTicket ticket);
+
+    /**
+     * @brief flush 并等待全部上传完成
+     */
+    void waitIdle();
+
+    /**
+     * @brief 获取时间线信号量（供渲染提交在GPU端等待）
+     */
+    vk::Semaphore getTimelineSemaphore() const
+    {
+        return m_timeline;
+    }
+
+    /**
+     * @brief 获取最近一次提交的票据
+     */
+    UploadTicket getSubmittedTicket() const;
+
+    // ==================== 统计 ====================
+
+    /**
+     * @struct Stats
+     * @brief 上传统计信息
+     */
+    struct Stats
+    {
+        uint64_t submittedBatches = 0;  ///< 已提交的批次数
+        uint64_t uploadCount = 0;       ///< 已记录的上传次数
+        uint64_t uploadedBytes = 0;     ///< 已上传的字节数
+        uint64_t stallCount = 0;        ///< 因环形缓冲区已满而等待GPU的次数
+        uint64_t dedicatedStagings = 0; ///< 超出环形缓冲区大小而使用独立暂存缓冲区的次数
+    };
+
+    /**
+     * @brief 获取统计信息（调试用）
+     */
+    Stats getStats() const;
+
+  private:
+    /**
+     * @struct PendingBufferCopy
+     * @brief 待录制的缓冲区拷贝
+     */
+    struct PendingBufferCopy
+    {
+        std::shared_ptr<Buffer> dst;
+        vk::Buffer src;
+        vk::BufferCopy region;
+    };
+
+    /**
+     * @struct PendingImageCopy
+     * @brief 待录制的图像拷贝（含布局转换）
+     */
+    struct PendingImageCopy
+    {
+        std::shared_ptr<Image> dst;
+        vk::Buffer src;
+        std::vector<vk::BufferImageCopy> regions;
+        vk::ImageLayout finalLayout;
+        bool generateMips = false; ///< 拷贝 mip 0 后在图形队列上 blit 生成其余 mip
+    };
+
+    /**
+     * @struct Batch
+     * @brief 一次提交涉及的全部数据（待提交或在途）
+     */
+    struct Batch
+    {
+        UploadTicket transferValue = 0; ///< 传输提交触发的值（有所有权转移时在 m_transferTimeline 上）
+        UploadTicket ticket = 0;        ///< 批次完成（含所有权获取）时 m_timeline 的值
+        vk::DeviceSize ringEnd = 0;     ///< 批次写入之后的环形缓冲区头部（虚拟偏移）
+        vk::DeviceSize pendingBytes = 0;
+
+        std::vector<PendingBufferCopy> bufferCopies;
+        std::vector<PendingImageCopy> imageCopies;
+        std::vector<std::unique_ptr<Buffer>> dedicatedStagings; ///< 超大上传的独立暂存缓冲区
+
+        CommandBufferHandle transferCmd;
+        CommandBufferHandle acquireCmd;
+    };
+
+    /**
+     * @brief (私有) 在暂存区分配并写入数据，返回所在缓冲区与偏移
+     */
+    void stagedata(const void *data, vk::DeviceSize size, vk::DeviceSize alignment, vk::Buffer &srcBuffer,
+                   vk::DeviceSize &srcOffset);
+
+    /**
+     * @brief (私有) 确保当前有打开的批次
+     */
+    Batch &openbatch();
+
+    /**
+     * @brief (私有) 录制并提交当前批次
+     */
+    void submitbatch();
+
+    /**
+     * @brief (私有) 回收已完成的在途批次（释放命令缓冲区、暂存空间与资源引用）
+     */
+    void retirecompleted();
+
+    /**
+     * @brief (私有) 批次达到自动提交阈值且调用者是所有者线程时提交
+     */
+    void flushifneeded(const Batch &batch);
+
+    /**
+     * @brief (私有) 在CPU上等待时间线值
+     */
+    void waitvalue(UploadTicket value) const;
+
+    /**
+     * @brief (私有) 是否需要队列族所有权转移（传输族与图形族不同）
+     */
+    bool needsownershiptransfer() const
+    {
+        return m_transferFamily != m_graphicsFamily;
+    }
+
+  private:
+    Device &m_device;
+    VmaAllocator m_allocator;
+    uint32_t m_transferFamily;
+    uint32_t m_graphicsFamily;
+
+    std::unique_ptr<CommandPoolManager> m_transferCommands; ///< 传输队列族命令池
+    std::unique_ptr<CommandPoolManager> m_graphicsCommands; ///< 图形队列族命令池（仅所有权获取使用）
+
+    vk::Semaphore m_timeline;     ///< 上传完成时间线（票据；有所有权转移时只由图形队列触发）
+    UploadTicket m_nextValue = 1; ///< 下一个可分配的时间线值
+
+    vk::Semaphore m_transferTimeline;     ///< 传输提交完成时间线（仅所有权转移时创建，获取提交等待它）
+    UploadTicket m_nextTransferValue = 1; ///< 下一个可分配的传输时间线值
+
+    // 暂存环形缓冲区（虚拟偏移单调递增，对容量取模得到实际位置）
+    std::unique_ptr<Buffer> m_staging;
+    uint8_t *m_stagingData = nullptr;
+    vk::DeviceSize m_stagingSize;
+    vk::DeviceSize m_flushThreshold;
+    std::thread::id m_ownerThread; ///< 只有它的上传会触发按阈值的自动提交
+    vk::DeviceSize m_ringHead = 0; ///< 下一次写入位置
+    vk::DeviceSize m_ringTail = 0; ///< 最早仍在使用的位置
+
+    std::unique_ptr<Batch> m_pending; ///< 正在累积的批次
+    std::deque<Batch> m_inFlight;     ///< 已提交、尚未回收的批次（按提交顺序）
+    UploadTicket m_submittedTicket = 0;
+
+    Stats m_stats;
+    mutable std::mutex m_mtx; ///< 保护以上全部状态（上传可以来自任意线程）
+};
+
+} // namespace vkcore
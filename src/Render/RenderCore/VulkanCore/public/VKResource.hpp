@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Device.hpp"
+#include "MemoryMonitor.hpp"
+#include <span>
+#include <unordered_map>
 #include <vma/vk_mem_alloc.h>
 #include <vulkan/vulkan.hpp>
 
@@ -51,9 +54,23 @@ class GpuResource
     vk::Device m_device; ///< Device 句柄
 };
 
+/**
+ * @enum BufferMapping
+ * @brief Buffer 的主机映射方式
+ */
+enum class BufferMapping : uint8_t
+{
+    None,        ///< 按 memoryUsage/allocationCreateFlags 分配，需要时 map()，write() 每次映射后解除
+    Persistent,  ///< 创建时映射（VMA_ALLOCATION_CREATE_MAPPED_BIT），指针在整个生命周期内有效
+    DeviceLocal, ///< 持久映射并优先放在主机可见的显存（ReBAR/SAM），无需暂存拷贝；没有时退回主机内存
+};
+
 /**
  * @struct BufferDesc
  * @brief Buffer 创建描述符，用于指定 Buffer 的属性和内存分配策略
+ * @details mapping 为 Persistent/DeviceLocal 时自动加上 MAPPED_BIT，未指定 HOST_ACCESS_* 标志时按顺序写入处理；
+ *          DeviceLocal 另把 memoryUsage 改为 VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE。
+ *          每帧常量、实例变换等 CPU 每帧重写、GPU 读取一次到数次的数据适合 DeviceLocal
  */
 struct BufferDesc
 {
@@ -61,6 +78,8 @@ struct BufferDesc
     vk::BufferUsageFlags usageFlags = vk::BufferUsageFlags(); ///< 缓冲区用途（如 TransferSrc、VertexBuffer 等）
     VmaMemoryUsage memoryUsage = VMA_MEMORY_USAGE_AUTO; ///< 内存使用类型（AUTO 会自动选择最优位置）
     VmaAllocationCreateFlags allocationCreateFlags = 0; ///< 分配标志（如 HOST_ACCESS_SEQUENTIAL_WRITE）
+    MemoryCategory category = MemoryCategory::Other;    ///< 内存统计分类（见 MemoryMonitor）
+    BufferMapping mapping = BufferMapping::None;        ///< 主机映射方式
 };
 
 /**
@@ -78,6 +97,10 @@ struct ImageDesc
     vk::ImageTiling tiling = vk::ImageTiling::eOptimal;            ///< 图像布局（Optimal 表示 GPU 优化）
     vk::ImageUsageFlags usage = vk::ImageUsageFlags();  ///< 图像用途（如 ColorAttachment、Sampled 等）
     VmaMemoryUsage memoryUsage = VMA_MEMORY_USAGE_AUTO; ///< 内存使用类型（AUTO 会自动选择最优位置）
+    MemoryCategory category = MemoryCategory::Other;    ///< 内存统计分类（见 MemoryMonitor）
+    std::vector<uint32_t> queueFamilies; ///< 并发访问的队列族（互不相同，两个及以上时使用 CONCURRENT 共享）
+    bool sparseResidency = false; ///< 稀疏驻留：创建时不分配内存，由 Image::bindSparseTiles() 按图块绑定
+    bool cubeCompatible = false;  ///< 立方体贴图：arrayLayers 为 6 的倍数，默认视图为 eCube（多于 6 层时为 eCubeArray）
 };
 
 /**
@@ -97,6 +120,19 @@ class Buffer : public GpuResource
      */
     Buffer(std::string name, Device &device, VmaAllocator allocator, const BufferDesc &desc);
 
+    /**
+     * @brief 别名构造函数，在已有的 VMA 分配上创建 Buffer（不拥有内存）
+     * @param device Vulkan 逻辑设备
+     * @param allocator VMA 分配器
+     * @param desc Buffer 描述符（memoryUsage 与 allocationCreateFlags 被忽略）
+     * @param aliasAllocation 承载该 Buffer 的 VMA 分配（生命周期必须长于 Buffer）
+     * @param aliasOffset 在分配内的字节偏移（需满足内存对齐要求）
+     * @throws std::runtime_error 如果创建或绑定失败
+     * @details 用于瞬态资源的内存别名，多个生命周期不重叠的资源共享同一块内存
+     */
+    Buffer(std::string name, Device &device, VmaAllocator allocator, const BufferDesc &desc,
+           VmaAllocation aliasAllocation, vk::DeviceSize aliasOffset);
+
     /**
      * @brief 析构函数，自动释放 Buffer 和内存
      */
@@ -138,32 +174,67 @@ class Buffer : public GpuResource
     /**
      * @brief 获取 Buffer 的设备地址
      * @return vk::DeviceAddress GPU 端可访问的设备地址
-     * @details 用于 GPU 端的缓冲区访问（如光线追踪、间接绘制等）
-     * @note 需要 Buffer 创建时包含 eShaderDeviceAddress 用途标志
+     * @details 用于 GPU 端的缓冲区访问（如顶点拉取、光线追踪、间接绘制等）
+     * @note 需要设备启用 bufferDeviceAddress，且 VMA 分配器以 VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT 创建
+     * @throws std::runtime_error 如果 Buffer 未创建或用途标志不含 eShaderDeviceAddress
      */
     vk::DeviceAddress getDeviceAddress() const;
 
     /**
      * @brief 映射 Buffer 内存到 CPU 地址空间
-     * @return void* 映射后的 CPU 可访问指针
-     * @throws std::runtime_error 如果映射失败或 Buffer 不支持映射
-     * @note 必须调用 unmap() 解除映射
+     * @return void* 映射后的 CPU 可访问指针（映射失败时为 nullptr）
+     * @throws std::runtime_error 如果 Buffer 未创建
+     * @note 持久映射的 Buffer 直接返回创建时的指针；其他 Buffer 需要调用 ummap() 解除映射（析构时也会解除）
      */
     void *map();
 
     /**
      * @brief 解除 Buffer 内存映射
-     * @note 必须在 map() 之后调用
+     * @note 持久映射的 Buffer 上为空操作
      */
     void ummap();
 
+    /**
+     * @brief 获取持久映射的指针
+     * @return void* BufferMapping::Persistent/DeviceLocal 创建时的指针，其他 Buffer 为当前的 map() 结果或 nullptr
+     */
+    void *getMappedData() const
+    {
+        return m_mappedData;
+    }
+
+    /**
+     * @brief 是否在整个生命周期内保持映射
+     */
+    bool isPersistentlyMapped() const
+    {
+        return m_persistentlyMapped;
+    }
+
+    /**
+     * @brief 所在内存是否为设备本地（主机可见时即 ReBAR/SAM 显存）
+     */
+    bool isDeviceLocal() const
+    {
+        return static_cast<bool>(m_memoryProperties & vk::MemoryPropertyFlagBits::eDeviceLocal);
+    }
+
+    /**
+     * @brief 所在内存是否主机可见
+     */
+    bool isHostVisible() const
+    {
+        return static_cast<bool>(m_memoryProperties & vk::MemoryPropertyFlagBits::eHostVisible);
+    }
+
     /**
      * @brief 写入数据到 Buffer
      * @param data 源数据指针
      * @param size 写入的字节数
      * @param offset Buffer 内的偏移量（字节）
      * @throws std::runtime_error 如果写入失败
-     * @details 内部会自动 map/unmap，适用于一次性写入操作
+     * @details 持久映射时直接拷贝到映射指针（无 map/unmap 开销），否则临时 map/unmap；
+     *          非 HOST_COHERENT 内存在拷贝后自动 flush 写入范围
      */
     void write(const void *data, vk::DeviceSize size, vk::DeviceSize offset = 0);
 
@@ -175,14 +246,44 @@ class Buffer : public GpuResource
      */
     void flush(vk::DeviceSize size = VK_WHOLE_SIZE, vk::DeviceSize offset = 0);
 
+    /**
+     * @brief 使内存缓存失效（确保 GPU 写入对 CPU 可见）
+     * @param size 失效的字节数（VK_WHOLE_SIZE 表示全部）
+     * @param offset 失效的起始偏移量（字节）
+     * @details 回读非相干内存（例如 HOST_CACHED）之前调用；相干内存上 VMA 直接返回
+     */
+    void invalidate(vk::DeviceSize size = VK_WHOLE_SIZE, vk::DeviceSize offset = 0);
+
+    /**
+     * @brief 查询按描述符创建的 Buffer 的内存需求（无需实际创建 Buffer）
+     * @param device Vulkan 逻辑设备
+     * @param desc Buffer 描述符
+     * @return vk::MemoryRequirements 大小、对齐与可用内存类型
+     */
+    static vk::MemoryRequirements getMemoryRequirements(Device &device, const BufferDesc &desc);
+
+    /**
+     * @brief 是否为别名 Buffer（不拥有内存分配）
+     */
+    bool isAliased() const
+    {
+        return !m_ownsAllocation;
+    }
+
   private:
     VmaAllocator m_allocator = nullptr;   ///< VMA 分配器
     VmaAllocation m_allocation = nullptr; ///< VMA 分配句柄
+    bool m_ownsAllocation = true;         ///< 是否拥有 m_allocation（别名资源为 false）
+
+    MemoryCategory m_category = MemoryCategory::Other; ///< 内存统计分类
+    vk::DeviceSize m_trackedBytes = 0;                 ///< 计入分类统计的字节数（别名资源为 0）
 
     vk::Buffer m_buffer = nullptr;                         ///< Vulkan Buffer 句柄
     vk::DeviceSize m_size = 0;                             ///< Buffer 大小（字节）
     vk::BufferUsageFlags m_usage = vk::BufferUsageFlags(); ///< Buffer 使用标志
     void *m_mappedData = nullptr;                          ///< 已映射的 CPU 指针（nullptr 表示未映射）
+    bool m_persistentlyMapped = false;                     ///< 由 VMA 在创建时映射（不能 vmaUnmapMemory）
+    vk::MemoryPropertyFlags m_memoryProperties;            ///< 分配所在内存类型的属性
 
   private:
     /**
@@ -209,6 +310,20 @@ class Image : public GpuResource
      */
     Image(std::string name, Device &device, VmaAllocator allocator, const ImageDesc &desc);
 
+    /**
+     * @brief 别名构造函数，在已有的 VMA 分配上创建 Image 和 ImageView（不拥有内存）
+     * @param device Vulkan 逻辑设备
+     * @param allocator VMA 分配器
+     * @param desc Image 描述符（memoryUsage 被忽略）
+     * @param aliasAllocation 承载该 Image 的 VMA 分配（生命周期必须长于 Image）
+     * @param aliasOffset 在分配内的字节偏移（需满足内存对齐要求）
+     * @throws std::runtime_error 如果创建或绑定失败
+     * @details 用于瞬态资源的内存别名，别名 Image 的内容在首次使用前未定义，
+     *          首次布局转换必须从 eUndefined 开始
+     */
+    Image(std::string name, Device &device, VmaAllocator allocator, const ImageDesc &desc,
+          VmaAllocation aliasAllocation, vk::DeviceSize aliasOffset);
+
     /**
      * @brief 析构函数，自动释放 Image、ImageView 和内存
      */
@@ -305,9 +420,85 @@ class Image : public GpuResource
         m_currentLayout = layout;
     }
 
+    /**
+     * @brief 查询按描述符创建的 Image 的内存需求（无需实际创建 Image）
+     * @param device Vulkan 逻辑设备
+     * @param desc Image 描述符
+     * @return vk::MemoryRequirements 大小、对齐与可用内存类型
+     */
+    static vk::MemoryRequirements getMemoryRequirements(Device &device, const ImageDesc &desc);
+
+    /**
+     * @brief 是否为别名 Image（不拥有内存分配）
+     */
+    bool isAliased() const
+    {
+        return !m_ownsAllocation && !m_sparse;
+    }
+
+    // ==================== 稀疏驻留 ====================
+
+    /**
+     * @brief 设备能否按描述符创建稀疏驻留的 Image（ImageDesc::sparseResidency）
+     * @details 要求启用 sparseBinding 与 sparseResidencyImage2D 特性、图形队列族支持稀疏绑定，
+     *          且格式的稀疏图块不需要元数据；只支持单层、单级的 2D 图像（desc.sparseResidency 不参与判断）
+     */
+    static bool isSparseResidencySupported(Device &device, const ImageDesc &desc);
+
+    /**
+     * @brief 是否以稀疏驻留创建
+     */
+    bool isSparse() const
+    {
+        return m_sparse;
+    }
+
+    /**
+     * @brief 获取稀疏图块的尺寸（纹素，非稀疏 Image 为 0）
+     */
+    vk::Extent3D getSparseTileExtent() const
+    {
+        return m_sparseTileExtent;
+    }
+
+    /**
+     * @brief 获取每个稀疏图块占用的内存字节数（非稀疏 Image 为 0）
+     */
+    vk::DeviceSize getSparseTileSize() const
+    {
+        return m_sparseMemory.alignment;
+    }
+
+    /**
+     * @brief 获取当前已绑定内存的稀疏图块数量
+     */
+    uint32_t getResidentTileCount() const
+    {
+        return static_cast<uint32_t>(m_sparseTiles.size());
+    }
+
+    /**
+     * @brief 绑定或解绑一组稀疏图块的内存（vkQueueBindSparse，阻塞到绑定完成）
+     * @param device 创建该 Image 的设备（在它的图形队列上绑定，提交时持有该队列的提交互斥量）
+     * @param tiles 图块坐标（以图块为单位），已处于目标状态的图块被忽略
+     * @param resident true 为图块分配并绑定内存，false 解绑并释放图块的内存
+     * @throws std::runtime_error 如果不是稀疏 Image、坐标越界、内存分配或绑定失败
+     * @warning 新绑定的图块内容未定义；解绑前调用者需保证 GPU 不再访问这些图块
+     */
+    void bindSparseTiles(Device &device, std::span<const vk::Offset2D> tiles, bool resident);
+
   private:
     VmaAllocator m_allocator = nullptr;   ///< VMA 分配器
     VmaAllocation m_allocation = nullptr; ///< VMA 分配句柄
+    bool m_ownsAllocation = true;         ///< 是否拥有 m_allocation（别名资源为 false）
+
+    bool m_sparse = false;                                     ///< 稀疏驻留（内存按图块绑定，m_allocation 为空）
+    vk::Extent3D m_sparseTileExtent = {0, 0, 0};               ///< 稀疏图块尺寸（纹素）
+    vk::MemoryRequirements m_sparseMemory;                     ///< 图块内存需求（alignment 即图块字节数）
+    std::unordered_map<uint64_t, VmaAllocation> m_sparseTiles; ///< 已绑定的图块（键为 y << 32 | x）
+
+    MemoryCategory m_category = MemoryCategory::Other; ///< 内存统计分类
+    vk::DeviceSize m_trackedBytes = 0;                 ///< 计入分类统计的字节数（别名资源为 0）
 
     vk::Image m_image = nullptr;         ///< Vulkan Image 句柄
     vk::ImageView m_imageView = nullptr; ///< 默认 ImageView 句柄
@@ -320,6 +511,16 @@ class Image : public GpuResource
     vk::ImageLayout m_currentLayout = vk::ImageLayout::eUndefined; ///< 当前图像布局（手动跟踪）
 
   private:
+    /**
+     * @brief 创建覆盖所有 mip 级别和数组层的默认 ImageView
+     */
+    void createdefaultview(const ImageDesc &desc);
+
+    /**
+     * @brief 创建不绑定内存的稀疏 Image 并查询图块尺寸
+     */
+    void createsparse(const ImageDesc &desc);
+
     /**
      * @brief 释放 Image、ImageView 和内存资源
      * @details 由析构函数调用
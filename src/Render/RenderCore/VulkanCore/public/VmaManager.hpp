@@ -10,7 +10,13 @@ namespace vkcore
 class VmaManager
 {
   public:
-    static void Initialize(vk::Instance instance, vk::PhysicalDevice physicalDevice, vk::Device device);
+    /**
+     * @brief 创建全局 VMA 分配器
+     * @param flags 分配器创建标志；设备启用了 VK_EXT_memory_budget 时应传入
+     *              VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT，MemoryMonitor 才能读到操作系统给出的真实预算
+     */
+    static void Initialize(vk::Instance instance, vk::PhysicalDevice physicalDevice, vk::Device device,
+                           VmaAllocatorCreateFlags flags = 0);
     static void cleanup();
 
     static VmaAllocator getAllocator();
@@ -0,0 +1,252 @@
+/**
+ * @file WorkerPool.hpp
+ * @brief 工作窃取任务调度器
+ * @details 工作线程在构造时创建并常驻整个生命周期，编号固定为 0 .. threadCount - 1，因此每个线程的
+ *          thread_local 资源（例如 CommandPoolManager 的线程命令池）只会创建一次，数量等于线程数；
+ *          可选地把工作线程绑定到固定的逻辑核心上。
+ *
+ *          每个工作线程持有一个 Chase-Lev 双端队列：工作线程投递的任务压入自己的队列底部并以后进先出
+ *          取回（缓存局部性好），空闲线程从其他队列顶部窃取；非工作线程投递的任务进入全局注入队列。
+ *          任务之间的依赖以 TaskGroup 表达：等待任务组时工作线程会继续执行其他任务而不是阻塞，
+ *          因此 parallelFor 可以在任务内部嵌套；任务组清空后可自动投递后续任务（continuation）。
+ *
+ *          引擎内的并行工作（渲染图并行录制、场景变换更新与剔除、资源解码、管线编译）共用同一个实例。
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vkcore
+{
+
+/**
+ * @class WorkerPool
+ * @brief 常驻工作线程的工作窃取调度器，提供任务投递、任务组与带粒度的 parallelFor
+ *
+ * @example
+ * @code
+ * vkcore::WorkerPool workers(0, true); // hardware_concurrency - 1 个工作线程，绑定核心
+ *
+ * // 每 64 个元素一块，调用线程也参与执行；可以在任务内部嵌套
+ * workers.parallelFor(count, 64, [&](uint32_t begin, uint32_t end) {
+ *     for (uint32_t i = begin; i < end; ++i) { ... }
+ * });
+ *
+ * // 依赖：A、B 都完成后再执行 C
+ * vkcore::WorkerPool::TaskGroup group(workers);
+ * group.run([&]() { decodeA(); });
+ * group.run([&]() { decodeB(); });
+ * group.then([&]() { link(); });
+ * group.wait(); // 只等待 A、B，C 作为独立任务投递
+ * @endcode
+ */
+class WorkerPool
+{
+  private:
+    struct Task;
+    class TaskDeque;
+    struct Worker;
+
+  public:
+    static constexpr uint32_t kInvalidWorker = UINT32_MAX; ///< 当前线程不是本池的工作线程
+
+    /**
+     * @class TaskGroup
+     * @brief 一组任务的完成计数（可在任意线程上投递与等待）
+     * @details 析构时等待组内任务完成（不重新抛出异常），因此任务可以安全引用组所在栈帧上的对象
+     */
+    class TaskGroup
+    {
+      public:
+        explicit TaskGroup(WorkerPool &pool) : m_pool(pool)
+        {
+        }
+
+        ~TaskGroup();
+
+        /** 禁用拷贝与移动（任务持有指向组的指针） */
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        /**
+         * @brief 向组内投递一个任务
+         */
+        void run(std::function<void()> task);
+
+        /**
+         * @brief 组内当前所有任务完成后投递 continuation（组已空闲时立即投递）
+         * @details continuation 不属于本组，wait() 不会等待它；需要等待时在 continuation 中向另一个组投递
+         */
+        void then(std::function<void()> continuation);
+
+        /**
+         * @brief 等待组内所有任务完成
+         * @details 工作线程等待时继续执行其他任务；其他线程阻塞等待，不会在调用线程上执行长任务
+         * @throws 组内任务抛出的第一个异常（重新抛出后清除）
+         */
+        void wait();
+
+        /**
+         * @brief 组内任务是否已全部完成
+         */
+        bool isIdle() const
+        {
+            return m_pending.load(std::memory_order_acquire) == 0;
+        }
+
+      private:
+        friend class WorkerPool;
+
+        /**
+         * @brief (私有) 组内一个任务结束
+         */
+        void finishone(std::exception_ptr error);
+
+        /**
+         * @brief (私有) 等待计数归零，不抛出异常
+         */
+        void waitidle();
+
+      private:
+        WorkerPool &m_pool;
+        std::atomic<uint32_t> m_pending{0};                 ///< 未完成的任务数
+        std::mutex m_mtx;                                   ///< 保护下列成员，计数归零也在锁内发生
+        std::condition_variable m_cv;                       ///< 计数归零通知
+        std::vector<std::function<void()>> m_continuations; ///< 计数归零后投递的任务
+        std::exception_ptr m_error;                         ///< 组内任务抛出的第一个异常
+    };
+
+    /**
+     * @brief 构造函数
+     * @param threadCount 工作线程数量（0 表示 hardware_concurrency - 1，至少为 1）
+     * @param pinThreads 是否把第 i 个工作线程绑定到逻辑核心 (i + 1) % 核心数（核心 0 留给主线程）
+     */
+    explicit WorkerPool(uint32_t threadCount = 0, bool pinThreads = false);
+
+    /**
+     * @brief 析构函数，执行完所有已投递的任务（包括它们派生的任务）后退出所有工作线程
+     */
+    ~WorkerPool();
+
+    /** 禁用拷贝与移动 */
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+    WorkerPool(WorkerPool &&) = delete;
+    WorkerPool &operator=(WorkerPool &&) = delete;
+
+    /**
+     * @brief 投递一个异步任务（不等待完成）
+     * @param task 任务函数，抛出的异常会被记录到日志后丢弃
+     */
+    void enqueue(std::function<void()> task);
+
+    /**
+     * @brief 并行执行 func(0) ... func(count - 1)，阻塞直到全部完成
+     * @param count 任务数量
+     * @param func 任务函数，参数为任务索引
+     * @details 等价于粒度为 1 的 parallelFor：每个索引单独领取，适合耗时不均的任务（例如逐Pass录制）
+     */
+    void parallelFor(uint32_t count, const std::function<void(uint32_t)> &func);
+
+    /**
+     * @brief 把 [0, count) 按 grainSize 切块并行执行，阻塞直到全部完成
+     * @param count 元素数量
+     * @param grainSize 每块的元素数（0 视为 1），块越大调度开销越小、负载越不均衡
+     * @param func 块函数，参数为块的区间 [begin, end)
+     * @details 调用线程也参与执行，各参与者从同一个原子游标领取块；可以在任务内部嵌套调用。
+     *          任务中抛出的第一个异常会在全部块结束后重新抛出
+     */
+    void parallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)> &func);
+
+    /**
+     * @brief 获取工作线程数量
+     */
+    uint32_t getThreadCount() const
+    {
+        return m_threadCount;
+    }
+
+    /**
+     * @brief 获取当前线程在本池中的编号
+     * @return uint32_t 0 .. getThreadCount() - 1，不是本池的工作线程时为 kInvalidWorker
+     */
+    uint32_t getWorkerIndex() const;
+
+    /**
+     * @brief 当前线程是否是本池的工作线程
+     */
+    bool isWorkerThread() const
+    {
+        return getWorkerIndex() != kInvalidWorker;
+    }
+
+    /**
+     * @brief 工作线程是否绑定了核心
+     */
+    bool isPinned() const
+    {
+        return m_pinned;
+    }
+
+    /**
+     * @brief 获取累计窃取次数（粗略衡量负载不均衡程度）
+     */
+    uint64_t getStealCount() const
+    {
+        return m_stealCount.load(std::memory_order_relaxed);
+    }
+
+  private:
+    /**
+     * @brief 投递任务：工作线程压入自己的队列，其他线程进入注入队列
+     */
+    void submit(std::function<void()> func, TaskGroup *group);
+
+    /**
+     * @brief 依次尝试自己的队列、注入队列与其他线程的队列
+     * @param workerIndex 当前工作线程编号（kInvalidWorker 表示只查注入队列与其他队列）
+     */
+    Task *findtask(uint32_t workerIndex);
+
+    /**
+     * @brief 执行并释放任务，通知所属任务组
+     */
+    void runtask(Task *task);
+
+    /**
+     * @brief 工作线程在等待任务组时继续执行其他任务
+     */
+    void helpuntilidle(TaskGroup &group, uint32_t workerIndex);
+
+    /**
+     * @brief 工作线程主循环
+     */
+    void workerloop(uint32_t workerIndex);
+
+  private:
+    std::vector<std::unique_ptr<Worker>> m_workers; ///< 工作线程及其双端队列
+    uint32_t m_threadCount = 0;                     ///< 工作线程数量
+    bool m_pinned = false;                          ///< 是否绑定核心
+
+    std::deque<Task *> m_injected;            ///< 非工作线程投递的任务
+    std::mutex m_injectMtx;                   ///< 保护注入队列
+    std::atomic<uint32_t> m_injectedCount{0}; ///< 注入队列长度（无锁快速判空）
+
+    std::atomic<uint32_t> m_queuedTasks{0}; ///< 已投递未开始的任务总数（先于入队递增）
+    std::atomic<uint32_t> m_sleepers{0};    ///< 休眠中的工作线程数（在 m_sleepMtx 内修改）
+    std::atomic<uint64_t> m_stealCount{0};  ///< 累计窃取次数
+    std::mutex m_sleepMtx;                  ///< 休眠与唤醒
+    std::condition_variable m_sleepCv;      ///< 任务到达通知
+    bool m_stopping = false;                ///< 析构标志（在 m_sleepMtx 内修改）
+};
+
+} // namespace vkcore
@@ -1,13 +1,24 @@
 #pragma once
 
 #include "CommandPoolManager.hpp"
+#include "DeferredDeletionQueue.hpp"
 #include "Descriptor.hpp"
 #include "Device.hpp"
+#include "FrameTimeline.hpp"
+#include "Log.hpp"
+#include "MemoryMonitor.hpp"
 #include "Pipeline.hpp"
+#include "PipelineCache.hpp"
+#include "Profiler.hpp"
+#include "SamplerCache.hpp"
 #include "ShaderManager.hpp"
+#include "ShaderPackage.hpp"
+#include "ShaderReflection.hpp"
 #include "SwapChain.hpp"
+#include "TransientBufferRing.hpp"
 #include "VKResource.hpp"
 #include "VmaManager.hpp"
+#include "WorkerPool.hpp"
 
 namespace vkcore
 {
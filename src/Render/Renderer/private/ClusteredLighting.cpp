@@ -0,0 +1,346 @@
+/**
+ * @file ClusteredLighting.cpp
+ * @brief ClusteredLighting 实现
+ */
+
+#include "ClusteredLighting.hpp"
+#include "RenderGraph/public/RDGResourceAccessor.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace renderer
+{
+
+namespace
+{
+
+// 描述符绑定，需与 cluster_lights.comp / clustered_lighting.glsl 一致
+constexpr uint32_t kParamsBinding = 0;
+constexpr uint32_t kLightsBinding = 1;
+constexpr uint32_t kClusterCountsBinding = 2;
+constexpr uint32_t kClusterLightsBinding = 3;
+
+// SoA 光源缓冲的四段数组
+constexpr uint32_t kPositionRangeSegment = 0;
+constexpr uint32_t kColorTypeSegment = 1;
+constexpr uint32_t kDirectionSpotSegment = 2;
+constexpr uint32_t kAttenuationSegment = 3;
+constexpr uint32_t kSegmentCount = 4;
+
+constexpr vk::ShaderStageFlags kLightingStages = vk::ShaderStageFlagBits::eCompute | vk::ShaderStageFlagBits::eFragment;
+
+/**
+ * @brief 创建持久映射的缓冲（优先放在主机可见的显存中，GPU 直接读取，无需暂存拷贝）
+ */
+std::unique_ptr<vkcore::Buffer> createmappedbuffer(const std::string &name, vkcore::Device &device,
+                                                   VmaAllocator allocator, vk::DeviceSize size,
+                                                   vk::BufferUsageFlags usage)
+{
+    vkcore::BufferDesc desc{};
+    desc.size = size;
+    desc.usageFlags = usage;
+    desc.mapping = vkcore::BufferMapping::DeviceLocal;
+
+    auto buffer = std::make_unique<vkcore::Buffer>(name, device, allocator, desc);
+    if (!buffer->getMappedData())
+    {
+        throw std::runtime_error("ClusteredLighting: failed to map buffer " + name);
+    }
+    return buffer;
+}
+
+bool isclustered(const rendercore::Light &light)
+{
+    return light.getType() == rendercore::LightType::Point || light.getType() == rendercore::LightType::Spot;
+}
+
+} // namespace
+
+ClusteredLightingView ClusteredLightingView::fromCamera(const rendercore::Camera &camera, uint32_t width,
+                                                        uint32_t height)
+{
+    ClusteredLightingView view;
+    view.view = camera.getViewMatrix();
+    view.projection = camera.getProjectionMatrix();
+    view.zNear = camera.getNearPlane();
+    view.zFar = camera.getFarPlane();
+    view.width = std::max(width, 1u);
+    view.height = std::max(height, 1u);
+    return view;
+}
+
+ClusteredLighting::ClusteredLighting(vkcore::Device &device, VmaAllocator allocator,
+                                     vkcore::DescriptorLayoutCache &layoutCache,
+                                     std::shared_ptr<vkcore::ShaderModule> clusterShader, uint32_t framesInFlight,
+                                     uint32_t initialCapacity)
+    : m_device(device), m_allocator(allocator), m_capacity(initialCapacity)
+{
+    if (framesInFlight == 0)
+    {
+        throw std::invalid_argument("ClusteredLighting: framesInFlight must be greater than 0");
+    }
+    if (initialCapacity == 0)
+    {
+        throw std::invalid_argument("ClusteredLighting: initialCapacity must be greater than 0");
+    }
+
+    m_setLayout = vkcore::DescriptorLayoutBuilder::begin(&layoutCache)
+                      .addBinding(kParamsBinding, vk::DescriptorType::eUniformBuffer, kLightingStages)
+                      .addBinding(kLightsBinding, vk::DescriptorType::eStorageBuffer, kLightingStages)
+                      .addBinding(kClusterCountsBinding, vk::DescriptorType::eStorageBuffer, kLightingStages)
+                      .addBinding(kClusterLightsBinding, vk::DescriptorType::eStorageBuffer, kLightingStages)
+                      .build();
+
+    m_pipeline = vkcore::ComputePipelineBuilder(device)
+                     .setShaderModule(std::move(clusterShader))
+                     .addDescriptorSetLayout(m_setLayout)
+                     .build();
+
+    m_descriptorAllocator = std::make_unique<vkcore::DescriptorAllocator>(device, &layoutCache);
+
+    m_packed.assign(size_t(m_capacity) * kSegmentCount, glm::vec4(0.0f));
+
+    m_frames.resize(framesInFlight);
+    for (uint32_t i = 0; i < framesInFlight; ++i)
+    {
+        FrameResources &frame = m_frames[i];
+        frame.paramsBuffer = createmappedbuffer("ClusterParams" + std::to_string(i), device, allocator,
+                                                sizeof(GPUClusterParams), vk::BufferUsageFlagBits::eUniformBuffer);
+        frame.descriptorSet = m_descriptorAllocator->allocate(m_setLayout);
+    }
+}
+
+ClusteredLighting::~ClusteredLighting() = default;
+
+// ==================== 光源打包 ====================
+
+void ClusteredLighting::update(const rendercore::Scene &scene, uint32_t frameIndex)
+{
+    if (frameIndex >= m_frames.size())
+    {
+        throw std::invalid_argument("ClusteredLighting::update: frameIndex out of range");
+    }
+
+    if (lightschanged(scene))
+    {
+        packlights(scene);
+    }
+
+    FrameResources &frame = m_frames[frameIndex];
+    if (frame.lightsVersion != m_lightsVersion)
+    {
+        uploadlights(frame);
+    }
+}
+
+bool ClusteredLighting::lightschanged(const rendercore::Scene &scene) const
+{
+    if (m_lightsVersion == 0 || m_scene != &scene || scene.getLightsVersion() != m_sceneLightsVersion)
+    {
+        return true;
+    }
+
+    // 列表未变化时映射的遍历顺序不变，逐个比较版本（不调用虚函数）
+    const auto &lights = scene.getLights();
+    if (lights.size() != m_lightVersions.size())
+    {
+        return true;
+    }
+    size_t i = 0;
+    for (const auto &[id, light] : lights)
+    {
+        if (m_lightVersions[i].first != light.get() || m_lightVersions[i].second != light->getVersion())
+        {
+            return true;
+        }
+        ++i;
+    }
+    return false;
+}
+
+void ClusteredLighting::packlights(const rendercore::Scene &scene)
+{
+    const auto &lights = scene.getLights();
+
+    m_lightVersions.clear();
+    m_lightVersions.reserve(lights.size());
+    uint32_t directionalCount = 0;
+    uint32_t localCount = 0;
+    for (const auto &[id, light] : lights)
+    {
+        m_lightVersions.emplace_back(light.get(), light->getVersion());
+        if (!light->isEnabled())
+        {
+            continue;
+        }
+        if (light->getType() == rendercore::LightType::Directional)
+        {
+            ++directionalCount;
+        }
+        else if (isclustered(*light))
+        {
+            ++localCount;
+        }
+    }
+
+    const uint32_t required = directionalCount + localCount;
+    if (required > m_capacity)
+    {
+        m_capacity = std::max(required, m_capacity * 2);
+    }
+    m_packed.assign(size_t(m_capacity) * kSegmentCount, glm::vec4(0.0f));
+
+    glm::vec4 *positionRange = m_packed.data() + size_t(kPositionRangeSegment) * m_capacity;
+    glm::vec4 *colorType = m_packed.data() + size_t(kColorTypeSegment) * m_capacity;
+    glm::vec4 *directionSpot = m_packed.data() + size_t(kDirectionSpotSegment) * m_capacity;
+    glm::vec4 *attenuation = m_packed.data() + size_t(kAttenuationSegment) * m_capacity;
+
+    // 平行光在前（着色时全部遍历），点光源与聚光灯在后（由簇索引引用）
+    uint32_t nextDirectional = 0;
+    uint32_t nextLocal = directionalCount;
+    for (const auto &[id, light] : lights)
+    {
+        if (!light->isEnabled())
+        {
+            continue;
+        }
+
+        const glm::vec3 radiance = light->getColor() * light->getIntensity();
+        if (light->getType() == rendercore::LightType::Directional)
+        {
+            const uint32_t slot = nextDirectional++;
+            colorType[slot] = glm::vec4(radiance, static_cast<float>(GPULightType::Directional));
+            directionSpot[slot] = glm::vec4(light->getDirection(), 0.0f);
+        }
+        else if (light->getType() == rendercore::LightType::Point)
+        {
+            const auto &point = static_cast<const rendercore::PointLight &>(*light);
+            const uint32_t slot = nextLocal++;
+            positionRange[slot] = glm::vec4(point.getWorldPosition(), point.getRange());
+            colorType[slot] = glm::vec4(radiance, static_cast<float>(GPULightType::Point));
+            attenuation[slot] = glm::vec4(point.getAttenuation(), 0.0f);
+        }
+        else if (light->getType() == rendercore::LightType::Spot)
+        {
+            const auto &spot = static_cast<const rendercore::SpotLight &>(*light);
+            const uint32_t slot = nextLocal++;
+            positionRange[slot] = glm::vec4(spot.getWorldPosition(), spot.getRange());
+            colorType[slot] = glm::vec4(radiance, static_cast<float>(GPULightType::Spot));
+            directionSpot[slot] = glm::vec4(spot.getDirection(), spot.getOuterCutoff());
+            attenuation[slot] = glm::vec4(spot.getAttenuation(), spot.getInnerCutoff());
+        }
+        // 区域光尚未支持
+    }
+
+    m_directionalCount = directionalCount;
+    m_localCount = localCount;
+    m_scene = &scene;
+    m_sceneLightsVersion = scene.getLightsVersion();
+    ++m_lightsVersion;
+}
+
+void ClusteredLighting::uploadlights(FrameResources &frame)
+{
+    const vk::DeviceSize requiredSize = m_packed.size() * sizeof(glm::vec4);
+    if (!frame.lightBuffer || frame.lightBuffer->getSize() != requiredSize)
+    {
+        // 段的起始位置由容量决定，容量变化时缓冲大小必须一致地重建
+        frame.lightBuffer = createmappedbuffer("ClusterLights", m_device, m_allocator, requiredSize,
+                                               vk::BufferUsageFlagBits::eStorageBuffer);
+    }
+
+    std::memcpy(frame.lightBuffer->getMappedData(), m_packed.data(), requiredSize);
+    frame.lightBuffer->flush(requiredSize, 0);
+    frame.lightsVersion = m_lightsVersion;
+}
+
+// ==================== 渲染图 ====================
+
+ClusteredLightingOutputs ClusteredLighting::addPasses(rendercore::RDGBuilder &builder, uint32_t frameIndex,
+                                                      const ClusteredLightingView &view)
+{
+    if (frameIndex >= m_frames.size())
+    {
+        throw std::invalid_argument("ClusteredLighting::addPasses: frameIndex out of range");
+    }
+    FrameResources &frame = m_frames[frameIndex];
+    if (!frame.lightBuffer)
+    {
+        throw std::runtime_error("ClusteredLighting::addPasses: update() must be called for this frame first");
+    }
+
+    // 每帧参数：该帧槽位的上一次 GPU 工作已完成，可以直接覆盖
+    GPUClusterParams params{};
+    params.view = view.view;
+    params.inverseProjection = glm::inverse(view.projection);
+    params.gridSize = glm::uvec4(kGridX, kGridY, kGridZ, kMaxLightsPerCluster);
+    params.screenSize = glm::vec2(static_cast<float>(view.width), static_cast<float>(view.height));
+    params.zNear = view.zNear;
+    params.zFar = view.zFar;
+    params.directionalCount = m_directionalCount;
+    params.localCount = m_localCount;
+    params.lightCapacity = m_capacity;
+    params.padding = 0;
+    std::memcpy(frame.paramsBuffer->getMappedData(), &params, sizeof(params));
+    frame.paramsBuffer->flush(sizeof(params), 0);
+
+    ClusteredLightingOutputs outputs;
+    outputs.frameIndex = frameIndex;
+    outputs.lights = builder.registerExternalBuffer(frame.lightBuffer.get(), "ClusterLights");
+    outputs.clusterCounts = builder.createBuffer(rendercore::RDGBufferDesc(
+        "ClusterCounts", kClusterCount * sizeof(uint32_t), vk::BufferUsageFlagBits::eStorageBuffer));
+    outputs.clusterLights = builder.createBuffer(rendercore::RDGBufferDesc(
+        "ClusterLightIndices", vk::DeviceSize(kClusterCount) * kMaxLightsPerCluster * sizeof(uint32_t),
+        vk::BufferUsageFlagBits::eStorageBuffer));
+
+    // 每个工作组处理一个簇：描述符集在这里写入，着色 Pass 直接绑定同一集合
+    builder
+        .addPass("ClusterLights",
+                 [this, outputs](vk::CommandBuffer cmd, const rendercore::RDGResourceAccessor &res) {
+                     FrameResources &frame = m_frames[outputs.frameIndex];
+
+                     vk::DescriptorBufferInfo paramsInfo(frame.paramsBuffer->get(), 0, sizeof(GPUClusterParams));
+                     vk::DescriptorBufferInfo lightsInfo(res.getBuffer(outputs.lights), 0, VK_WHOLE_SIZE);
+                     vk::DescriptorBufferInfo countsInfo(res.getBuffer(outputs.clusterCounts), 0, VK_WHOLE_SIZE);
+                     vk::DescriptorBufferInfo indicesInfo(res.getBuffer(outputs.clusterLights), 0, VK_WHOLE_SIZE);
+                     vkcore::DescriptorUpdater::begin(m_device, frame.descriptorSet)
+                         .writeBuffer(kParamsBinding, vk::DescriptorType::eUniformBuffer, paramsInfo)
+                         .writeBuffer(kLightsBinding, vk::DescriptorType::eStorageBuffer, lightsInfo)
+                         .writeBuffer(kClusterCountsBinding, vk::DescriptorType::eStorageBuffer, countsInfo)
+                         .writeBuffer(kClusterLightsBinding, vk::DescriptorType::eStorageBuffer, indicesInfo)
+                         .update();
+
+                     m_pipeline->bind(cmd);
+                     cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipeline->getLayout(), 0,
+                                            frame.descriptorSet, nullptr);
+                     cmd.dispatch(kGridX, kGridY, kGridZ);
+                 })
+        .readBuffer(outputs.lights, vk::PipelineStageFlagBits::eComputeShader, vk::AccessFlagBits::eShaderRead)
+        .writeBuffer(outputs.clusterCounts, vk::PipelineStageFlagBits::eComputeShader,
+                     vk::AccessFlagBits::eShaderWrite)
+        .writeBuffer(outputs.clusterLights, vk::PipelineStageFlagBits::eComputeShader,
+                     vk::AccessFlagBits::eShaderWrite);
+
+    return outputs;
+}
+
+void ClusteredLighting::readLightBuffers(rendercore::RDGPass &pass, const ClusteredLightingOutputs &outputs) const
+{
+    pass.readBuffer(outputs.lights, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead)
+        .readBuffer(outputs.clusterCounts, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead)
+        .readBuffer(outputs.clusterLights, vk::PipelineStageFlagBits::eFragmentShader,
+                    vk::AccessFlagBits::eShaderRead);
+}
+
+vk::DescriptorSet ClusteredLighting::getDescriptorSet(const ClusteredLightingOutputs &outputs) const
+{
+    if (outputs.frameIndex >= m_frames.size())
+    {
+        throw std::invalid_argument("ClusteredLighting::getDescriptorSet: frameIndex out of range");
+    }
+    return m_frames[outputs.frameIndex].descriptorSet;
+}
+
+} // namespace renderer
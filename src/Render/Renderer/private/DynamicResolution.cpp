@@ -0,0 +1,105 @@
+/**
+ * @file DynamicResolution.cpp
+ * @brief DynamicResolution 实现
+ */
+
+#include "DynamicResolution.hpp"
+#include "RenderGraph/public/RDGProfiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace renderer
+{
+
+DynamicResolution::DynamicResolution() : DynamicResolution(Config{})
+{
+}
+
+DynamicResolution::DynamicResolution(const Config &config) : m_config(config)
+{
+    if (!(config.minScale > 0.0f && config.minScale <= config.maxScale && config.maxScale <= 1.0f))
+    {
+        throw std::invalid_argument("DynamicResolution: scale range must satisfy 0 < minScale <= maxScale <= 1");
+    }
+    if (!(config.step > 0.0f) || !(config.targetMs > 0.0))
+    {
+        throw std::invalid_argument("DynamicResolution: step and targetMs must be greater than 0");
+    }
+    if (!(config.upscaleThreshold < config.downscaleThreshold))
+    {
+        throw std::invalid_argument("DynamicResolution: upscaleThreshold must be below downscaleThreshold");
+    }
+    if (!(config.smoothing > 0.0 && config.smoothing <= 1.0))
+    {
+        throw std::invalid_argument("DynamicResolution: smoothing must be in (0, 1]");
+    }
+    reset();
+}
+
+void DynamicResolution::reset()
+{
+    m_scale = m_config.maxScale;
+    m_averageMs = 0.0;
+    m_samples = 0;
+    m_cooldown = 0;
+}
+
+float DynamicResolution::quantize(float scale) const
+{
+    // 向下取整到步长：降低时保证满足预算，提高时不越过目标
+    const float steps = std::floor(scale / m_config.step + 1e-4f);
+    return std::clamp(steps * m_config.step, m_config.minScale, m_config.maxScale);
+}
+
+float DynamicResolution::update(double gpuMs)
+{
+    if (!(gpuMs > 0.0))
+    {
+        return m_scale;
+    }
+
+    m_averageMs = m_samples == 0 ? gpuMs : m_averageMs + (gpuMs - m_averageMs) * m_config.smoothing;
+    ++m_samples;
+    if (m_cooldown > 0)
+    {
+        --m_cooldown;
+        return m_scale;
+    }
+
+    float scale = m_scale;
+    if (m_averageMs > m_config.targetMs * m_config.downscaleThreshold)
+    {
+        // GPU 耗时近似与像素数（缩放的平方）成正比，一次降到预计满足预算的缩放，至少降一个步长
+        const float predicted = m_scale * static_cast<float>(std::sqrt(m_config.targetMs / m_averageMs));
+        scale = std::min(quantize(predicted), quantize(m_scale - m_config.step));
+    }
+    else if (m_averageMs < m_config.targetMs * m_config.upscaleThreshold)
+    {
+        // 提高时保守：每次只升一个步长，避免一次越过预算
+        scale = quantize(m_scale + m_config.step);
+    }
+
+    if (scale != m_scale)
+    {
+        // 按模型预测新缩放下的耗时作为平均值的起点，旧缩放下的滞后样本不会立刻触发反向调整
+        const double ratio = static_cast<double>(scale) / m_scale;
+        m_averageMs *= ratio * ratio;
+        m_scale = scale;
+        m_cooldown = m_config.cooldownFrames;
+    }
+    return m_scale;
+}
+
+float DynamicResolution::update(const rendercore::RDGProfiler &profiler)
+{
+    const rendercore::RDGFrameTiming &frame = profiler.getLatestFrame();
+    if (frame.passes.empty() || frame.frameIndex == m_lastProfilerFrame)
+    {
+        return m_scale;
+    }
+    m_lastProfilerFrame = frame.frameIndex;
+    return update(frame.gpuMs);
+}
+
+} // namespace renderer
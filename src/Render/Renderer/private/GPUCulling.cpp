@@ -0,0 +1,354 @@
+/**
+ * @file GPUCulling.cpp
+ * @brief GPUCulling 实现
+ */
+
+#include "GPUCulling.hpp"
+#include "RenderGraph/public/RDGResourceAccessor.hpp"
+#include "Resource/public/ResourceType.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace renderer
+{
+
+namespace
+{
+
+// 描述符绑定，需与 gpu_cull.comp 一致
+constexpr uint32_t kObjectsBinding = 0;
+constexpr uint32_t kParamsBinding = 1;
+constexpr uint32_t kCommandsBinding = 2;
+constexpr uint32_t kCountsBinding = 3;
+constexpr uint32_t kHiZBinding = 4;
+
+constexpr vk::DeviceSize kCommandStride = sizeof(vk::DrawIndexedIndirectCommand);
+
+/**
+ * @brief 创建持久映射的缓冲（优先放在主机可见的显存中，GPU 直接读取，无需暂存拷贝）
+ */
+std::unique_ptr<vkcore::Buffer> createmappedbuffer(const std::string &name, vkcore::Device &device,
+                                                   VmaAllocator allocator, vk::DeviceSize size,
+                                                   vk::BufferUsageFlags usage)
+{
+    vkcore::BufferDesc desc{};
+    desc.size = size;
+    desc.usageFlags = usage;
+    desc.mapping = vkcore::BufferMapping::DeviceLocal;
+
+    auto buffer = std::make_unique<vkcore::Buffer>(name, device, allocator, desc);
+    if (!buffer->getMappedData())
+    {
+        throw std::runtime_error("GPUCulling: failed to map buffer " + name);
+    }
+    return buffer;
+}
+
+} // namespace
+
+GPUCulling::GPUCulling(vkcore::Device &device, VmaAllocator allocator, vkcore::DescriptorLayoutCache &layoutCache,
+                       std::shared_ptr<vkcore::ShaderModule> cullShader, uint32_t framesInFlight)
+    : m_device(device), m_allocator(allocator)
+{
+    if (framesInFlight == 0)
+    {
+        throw std::invalid_argument("GPUCulling: framesInFlight must be greater than 0");
+    }
+
+    constexpr vk::ShaderStageFlags kComputeStage = vk::ShaderStageFlagBits::eCompute;
+    m_setLayout = vkcore::DescriptorLayoutBuilder::begin(&layoutCache)
+                      .addBinding(kObjectsBinding, vk::DescriptorType::eStorageBuffer, kComputeStage)
+                      .addBinding(kParamsBinding, vk::DescriptorType::eUniformBuffer, kComputeStage)
+                      .addBinding(kCommandsBinding, vk::DescriptorType::eStorageBuffer, kComputeStage)
+                      .addBinding(kCountsBinding, vk::DescriptorType::eStorageBuffer, kComputeStage)
+                      .addBinding(kHiZBinding, vk::DescriptorType::eCombinedImageSampler, kComputeStage)
+                      .build();
+
+    m_pipeline = vkcore::ComputePipelineBuilder(device)
+                     .setShaderModule(std::move(cullShader))
+                     .addDescriptorSetLayout(m_setLayout)
+                     .build();
+
+    m_descriptorAllocator = std::make_unique<vkcore::DescriptorAllocator>(device, &layoutCache);
+
+    // 占位 Hi-Z：只为满足描述符有效性，遮挡剔除关闭时着色器不会采样
+    vkcore::ImageDesc hiZDesc{};
+    hiZDesc.format = vk::Format::eR32Sfloat;
+    hiZDesc.extent = vk::Extent3D{1, 1, 1};
+    hiZDesc.usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+    m_dummyHiZ = std::make_unique<vkcore::Image>("GPUCullDummyHiZ", device, allocator, hiZDesc);
+
+    m_frames.resize(framesInFlight);
+    for (uint32_t i = 0; i < framesInFlight; ++i)
+    {
+        FrameResources &frame = m_frames[i];
+        frame.paramsBuffer = createmappedbuffer("GPUCullParams" + std::to_string(i), device, allocator,
+                                                sizeof(GPUCullParams), vk::BufferUsageFlagBits::eUniformBuffer);
+        frame.descriptorSet = m_descriptorAllocator->allocate(m_setLayout);
+    }
+}
+
+GPUCulling::~GPUCulling() = default;
+
+// ==================== 场景同步 ====================
+
+void GPUCulling::update(rendercore::Scene &scene, uint32_t frameIndex)
+{
+    if (frameIndex >= m_frames.size())
+    {
+        throw std::invalid_argument("GPUCulling::update: frameIndex out of range");
+    }
+
+    rebuildobjects(scene);
+
+    FrameResources &frame = m_frames[frameIndex];
+    if (frame.objectsVersion != m_objectsVersion)
+    {
+        uploadobjects(frame);
+    }
+}
+
+void GPUCulling::rebuildbatches(const rendercore::SceneStorage &storage)
+{
+    std::span<const rendercore::RenderObject> renderObjects = storage.getRenderObjects();
+
+    // 按顶点/索引缓冲分组：同一批次的所有网格可以用一次 drawIndexedIndirectCount 绘制
+    m_objectOrder.resize(renderObjects.size());
+    for (uint32_t i = 0; i < m_objectOrder.size(); ++i)
+    {
+        m_objectOrder[i] = i;
+    }
+    std::stable_sort(m_objectOrder.begin(), m_objectOrder.end(), [&renderObjects](uint32_t a, uint32_t b) {
+        const rendercore::Mesh *meshA = renderObjects[a].mesh;
+        const rendercore::Mesh *meshB = renderObjects[b].mesh;
+        if (meshA->vertexBuffer != meshB->vertexBuffer)
+        {
+            return std::less<vkcore::Buffer *>()(meshA->vertexBuffer.get(), meshB->vertexBuffer.get());
+        }
+        return std::less<vkcore::Buffer *>()(meshA->indexBuffer.get(), meshB->indexBuffer.get());
+    });
+
+    m_batches.clear();
+    m_materials.clear();
+    std::unordered_map<rendercore::Material *, uint32_t> materialIndices;
+
+    m_objects.resize(renderObjects.size());
+    for (uint32_t slot = 0; slot < m_objectOrder.size(); ++slot)
+    {
+        const rendercore::RenderObject &renderObject = renderObjects[m_objectOrder[slot]];
+        const rendercore::Mesh *mesh = renderObject.mesh;
+        if (m_batches.empty() || m_batches.back().vertexBuffer != mesh->vertexBuffer.get() ||
+            m_batches.back().indexBuffer != mesh->indexBuffer.get())
+        {
+            GPUDrawBatch batch;
+            batch.vertexBuffer = mesh->vertexBuffer.get();
+            batch.indexBuffer = mesh->indexBuffer.get();
+            batch.indexType = mesh->indexType;
+            batch.vertexFormat = mesh->vertexFormat;
+            batch.firstObject = slot;
+            m_batches.push_back(batch);
+        }
+        GPUDrawBatch &batch = m_batches.back();
+        ++batch.objectCount;
+
+        auto [it, inserted] =
+            materialIndices.try_emplace(renderObject.material, static_cast<uint32_t>(m_materials.size()));
+        if (inserted)
+        {
+            m_materials.push_back(renderObject.material);
+        }
+
+        GPUObjectData &object = m_objects[slot];
+        // bindless 材质直接使用全局材质 SSBO 的下标，着色器可按 materialIndex 读取参数
+        const bool bindless = renderObject.material && renderObject.material->bindless.isValid();
+        object.materialIndex = bindless ? renderObject.material->bindless.index : it->second;
+        object.batchIndex = static_cast<uint32_t>(m_batches.size() - 1);
+        object.commandOffset = batch.firstObject;
+        object.indexCount = mesh->indexCount;
+        object.firstIndex = mesh->firstIndex;
+        object.vertexOffset = mesh->vertexOffset;
+        object.padding[0] = 0;
+        object.padding[1] = 0;
+    }
+}
+
+void GPUCulling::rebuildobjects(rendercore::Scene &scene)
+{
+    const rendercore::SceneStorage &storage = scene.getStorage();
+    const bool sceneChanged = m_scene != &scene;
+    if (!sceneChanged && storage.getVersion() == m_sceneVersion)
+    {
+        return;
+    }
+
+    if (sceneChanged || storage.getRenderObjectsVersion() != m_renderObjectsVersion)
+    {
+        rebuildbatches(storage);
+    }
+
+    // 只有变换变化时批次布局不变，只刷新矩阵与包围盒
+    std::span<const rendercore::RenderObject> renderObjects = storage.getRenderObjects();
+    std::span<const glm::mat4> worldMatrices = storage.getWorldMatrices();
+    const rendercore::CullingBounds &bounds = storage.getWorldBounds();
+    for (uint32_t slot = 0; slot < m_objectOrder.size(); ++slot)
+    {
+        const uint32_t index = m_objectOrder[slot];
+        GPUObjectData &object = m_objects[slot];
+        object.world = worldMatrices[renderObjects[index].transformIndex];
+        object.boundsCenter = glm::vec4(bounds.centerX[index], bounds.centerY[index], bounds.centerZ[index], 0.0f);
+        object.boundsExtents = glm::vec4(bounds.extentX[index], bounds.extentY[index], bounds.extentZ[index], 0.0f);
+    }
+
+    m_scene = &scene;
+    m_sceneVersion = storage.getVersion();
+    m_renderObjectsVersion = storage.getRenderObjectsVersion();
+    ++m_objectsVersion;
+}
+
+void GPUCulling::uploadobjects(FrameResources &frame)
+{
+    const vk::DeviceSize requiredSize = std::max<vk::DeviceSize>(m_objects.size(), 1) * sizeof(GPUObjectData);
+    if (!frame.objectBuffer || frame.objectBuffer->getSize() < requiredSize)
+    {
+        // 预留 50% 余量，避免对象逐个增加时每帧重建
+        frame.objectBuffer = createmappedbuffer("GPUCullObjects", m_device, m_allocator, requiredSize * 3 / 2,
+                                                vk::BufferUsageFlagBits::eStorageBuffer);
+    }
+
+    if (!m_objects.empty())
+    {
+        const vk::DeviceSize size = m_objects.size() * sizeof(GPUObjectData);
+        std::memcpy(frame.objectBuffer->getMappedData(), m_objects.data(), size);
+        frame.objectBuffer->flush(size, 0);
+    }
+    frame.objectsVersion = m_objectsVersion;
+}
+
+// ==================== 渲染图 ====================
+
+GPUCullOutputs GPUCulling::addPasses(rendercore::RDGBuilder &builder, uint32_t frameIndex, const GPUCullView &view)
+{
+    if (frameIndex >= m_frames.size())
+    {
+        throw std::invalid_argument("GPUCulling::addPasses: frameIndex out of range");
+    }
+    FrameResources &frame = m_frames[frameIndex];
+    if (!frame.objectBuffer)
+    {
+        throw std::runtime_error("GPUCulling::addPasses: update() must be called for this frame first");
+    }
+
+    const uint32_t objectCount = static_cast<uint32_t>(m_objects.size());
+    const uint32_t batchCount = static_cast<uint32_t>(m_batches.size());
+    const bool useOcclusion = view.hiZ.isValid() && view.hiZMipCount > 0;
+
+    // 每帧参数：该帧槽位的上一次 GPU 工作已完成，可以直接覆盖
+    GPUCullParams params{};
+    params.viewProjection = view.viewProjection;
+    params.hiZViewProjection = view.hiZViewProjection.value_or(view.viewProjection);
+    rendercore::Frustum frustum(view.viewProjection);
+    for (uint32_t p = 0; p < rendercore::Frustum::PlaneCount; ++p)
+    {
+        params.frustumPlanes[p] = frustum.getPlane(static_cast<rendercore::Frustum::Plane>(p));
+    }
+    params.hiZSize = glm::vec2(static_cast<float>(view.hiZWidth), static_cast<float>(view.hiZHeight));
+    params.hiZMipCount = view.hiZMipCount;
+    params.objectCount = objectCount;
+    params.flags = GPUCullFrustum | (useOcclusion ? GPUCullOcclusion : 0u);
+    std::memcpy(frame.paramsBuffer->getMappedData(), &params, sizeof(params));
+    frame.paramsBuffer->flush(sizeof(params), 0);
+
+    GPUCullOutputs outputs;
+    outputs.objects = builder.registerExternalBuffer(frame.objectBuffer.get(), "GPUCullObjects");
+    outputs.commands = builder.createBuffer(rendercore::RDGBufferDesc(
+        "GPUCullCommands", std::max(objectCount, 1u) * kCommandStride,
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer));
+    outputs.counts = builder.createBuffer(rendercore::RDGBufferDesc(
+        "GPUCullCounts", std::max(batchCount, 1u) * sizeof(uint32_t),
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer |
+            vk::BufferUsageFlagBits::eTransferDst));
+    const rendercore::RDGTextureHandle hiZ =
+        useOcclusion ? view.hiZ : builder.registerExternalTexture(m_dummyHiZ.get(), "GPUCullDummyHiZ");
+
+    // 1. 清零每批次计数
+    builder
+        .addPass("GPUCullReset",
+                 [counts = outputs.counts](vk::CommandBuffer cmd, const rendercore::RDGResourceAccessor &res) {
+                     cmd.fillBuffer(res.getBuffer(counts), 0, VK_WHOLE_SIZE, 0);
+                 })
+        .writeBuffer(outputs.counts, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite);
+
+    // 2. 剔除并写出间接命令（计数以原子加分配批次内的命令槽位，因此同时声明读与写）
+    builder
+        .addPass("GPUCull",
+                 [this, frameIndex, outputs, hiZ, objectCount](vk::CommandBuffer cmd,
+                                                             const rendercore::RDGResourceAccessor &res) {
+                     FrameResources &frame = m_frames[frameIndex];
+
+                     vk::DescriptorBufferInfo objectsInfo(res.getBuffer(outputs.objects), 0, VK_WHOLE_SIZE);
+                     vk::DescriptorBufferInfo paramsInfo(frame.paramsBuffer->get(), 0, sizeof(GPUCullParams));
+                     vk::DescriptorBufferInfo commandsInfo(res.getBuffer(outputs.commands), 0, VK_WHOLE_SIZE);
+                     vk::DescriptorBufferInfo countsInfo(res.getBuffer(outputs.counts), 0, VK_WHOLE_SIZE);
+                     vk::DescriptorImageInfo hiZInfo(res.getSampler(rendercore::RDGSamplerType::NearestClamp),
+                                                     res.getTextureView(hiZ),
+                                                     vk::ImageLayout::eShaderReadOnlyOptimal);
+                     vkcore::DescriptorUpdater::begin(m_device, frame.descriptorSet)
+                         .writeBuffer(kObjectsBinding, vk::DescriptorType::eStorageBuffer, objectsInfo)
+                         .writeBuffer(kParamsBinding, vk::DescriptorType::eUniformBuffer, paramsInfo)
+                         .writeBuffer(kCommandsBinding, vk::DescriptorType::eStorageBuffer, commandsInfo)
+                         .writeBuffer(kCountsBinding, vk::DescriptorType::eStorageBuffer, countsInfo)
+                         .writeImage(kHiZBinding, vk::DescriptorType::eCombinedImageSampler, hiZInfo)
+                         .update();
+
+                     if (objectCount == 0)
+                     {
+                         return;
+                     }
+
+                     m_pipeline->bind(cmd);
+                     cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipeline->getLayout(), 0,
+                                            frame.descriptorSet, nullptr);
+                     cmd.dispatch((objectCount + kWorkgroupSize - 1) / kWorkgroupSize, 1, 1);
+                 })
+        .readBuffer(outputs.objects, vk::PipelineStageFlagBits::eComputeShader, vk::AccessFlagBits::eShaderRead)
+        .readTexture(hiZ, vk::PipelineStageFlagBits::eComputeShader, vk::AccessFlagBits::eShaderRead)
+        .readBuffer(outputs.counts, vk::PipelineStageFlagBits::eComputeShader, vk::AccessFlagBits::eShaderRead)
+        .writeBuffer(outputs.counts, vk::PipelineStageFlagBits::eComputeShader, vk::AccessFlagBits::eShaderWrite)
+        .writeBuffer(outputs.commands, vk::PipelineStageFlagBits::eComputeShader, vk::AccessFlagBits::eShaderWrite);
+
+    return outputs;
+}
+
+void GPUCulling::readDrawBuffers(rendercore::RDGPass &pass, const GPUCullOutputs &outputs) const
+{
+    pass.readBuffer(outputs.commands, vk::PipelineStageFlagBits::eDrawIndirect,
+                    vk::AccessFlagBits::eIndirectCommandRead)
+        .readBuffer(outputs.counts, vk::PipelineStageFlagBits::eDrawIndirect, vk::AccessFlagBits::eIndirectCommandRead)
+        .readBuffer(outputs.objects, vk::PipelineStageFlagBits::eVertexShader, vk::AccessFlagBits::eShaderRead);
+}
+
+void GPUCulling::recordDraws(vk::CommandBuffer cmd, const rendercore::RDGResourceAccessor &resources,
+                             const GPUCullOutputs &outputs) const
+{
+    const vk::Buffer commands = resources.getBuffer(outputs.commands);
+    const vk::Buffer counts = resources.getBuffer(outputs.counts);
+
+    for (uint32_t batchIndex = 0; batchIndex < m_batches.size(); ++batchIndex)
+    {
+        const GPUDrawBatch &batch = m_batches[batchIndex];
+
+        vk::Buffer vertexBuffer = batch.vertexBuffer->get();
+        vk::DeviceSize vertexOffset = 0;
+        cmd.bindVertexBuffers(0, 1, &vertexBuffer, &vertexOffset);
+        cmd.bindIndexBuffer(batch.indexBuffer->get(), 0, batch.indexType);
+        cmd.drawIndexedIndirectCount(commands, batch.firstObject * kCommandStride, counts,
+                                     batchIndex * sizeof(uint32_t), batch.objectCount,
+                                     static_cast<uint32_t>(kCommandStride));
+    }
+}
+
+} // namespace renderer
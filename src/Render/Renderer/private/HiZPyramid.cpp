@@ -0,0 +1,340 @@
+/**
+ * @file HiZPyramid.cpp
+ * @brief HiZPyramid 实现
+ */
+
+#include "HiZPyramid.hpp"
+#include "RenderGraph/public/RDGResourceAccessor.hpp"
+#include "VulkanCore/public/DeferredDeletionQueue.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace renderer
+{
+
+namespace
+{
+
+// 描述符绑定，需与 hiz_pyramid.comp 一致
+constexpr uint32_t kDepthBinding = 0;
+constexpr uint32_t kPyramidBinding = 1;
+constexpr uint32_t kCounterBinding = 2;
+
+constexpr uint32_t kMaxBaseSize = 1u << (HiZPyramid::kMaxMipCount - 1);
+
+/**
+ * @brief 创建主机顺序写入、常驻映射的缓冲
+ */
+std::unique_ptr<vkcore::Buffer> createmappedbuffer(const std::string &name, vkcore::Device &device,
+                                                   VmaAllocator allocator, vk::DeviceSize size,
+                                                   vk::BufferUsageFlags usage)
+{
+    vkcore::BufferDesc desc{};
+    desc.size = size;
+    desc.usageFlags = usage;
+    desc.memoryUsage = VMA_MEMORY_USAGE_AUTO;
+    desc.allocationCreateFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+
+    auto buffer = std::make_unique<vkcore::Buffer>(name, device, allocator, desc);
+    if (!buffer->map())
+    {
+        throw std::runtime_error("HiZPyramid: failed to map buffer " + name);
+    }
+    return buffer;
+}
+
+} // namespace
+
+HiZPyramid::HiZPyramid(vkcore::Device &device, VmaAllocator allocator, vkcore::DescriptorLayoutCache &layoutCache,
+                       std::shared_ptr<vkcore::ShaderModule> pyramidShader, uint32_t framesInFlight)
+    : m_device(device), m_allocator(allocator)
+{
+    if (framesInFlight == 0)
+    {
+        throw std::invalid_argument("HiZPyramid: framesInFlight must be greater than 0");
+    }
+
+    const vk::FormatFeatureFlags required =
+        vk::FormatFeatureFlagBits::eStorageImage | vk::FormatFeatureFlagBits::eSampledImage;
+    if ((device.getPhysicalDevice().getFormatProperties(kFormat).optimalTilingFeatures & required) != required)
+    {
+        throw std::runtime_error("HiZPyramid: R32G32_SFLOAT storage images are not supported");
+    }
+
+    constexpr vk::ShaderStageFlags kComputeStage = vk::ShaderStageFlagBits::eCompute;
+    m_setLayout = vkcore::DescriptorLayoutBuilder::begin(&layoutCache)
+                      .addBinding(kDepthBinding, vk::DescriptorType::eCombinedImageSampler, kComputeStage)
+                      .addBinding(kPyramidBinding, vk::DescriptorType::eStorageImage, kComputeStage, kMaxMipCount)
+                      .addBinding(kCounterBinding, vk::DescriptorType::eStorageBuffer, kComputeStage)
+                      .build();
+
+    m_pipeline = vkcore::ComputePipelineBuilder(device)
+                     .setShaderModule(std::move(pyramidShader))
+                     .addDescriptorSetLayout(m_setLayout)
+                     .addPushConstant(vk::PushConstantRange(kComputeStage, 0, sizeof(GPUHiZPushConstants)))
+                     .build();
+
+    m_descriptorAllocator = std::make_unique<vkcore::DescriptorAllocator>(device, &layoutCache);
+    m_descriptorSets.resize(framesInFlight);
+    for (vk::DescriptorSet &set : m_descriptorSets)
+    {
+        set = m_descriptorAllocator->allocate(m_setLayout);
+    }
+}
+
+HiZPyramid::~HiZPyramid()
+{
+    // 析构时调用方已保证没有在途帧，直接销毁
+    m_deletionQueue = nullptr;
+    for (Pyramid &pyramid : m_pyramids)
+    {
+        releasepyramid(pyramid);
+    }
+    for (Pyramid &pyramid : m_retired)
+    {
+        releasepyramid(pyramid);
+    }
+}
+
+// ==================== 尺寸 ====================
+
+glm::uvec2 HiZPyramid::getBaseSize(uint32_t width, uint32_t height)
+{
+    // 向下取整：每个第 0 级纹素覆盖 [1, 2) 个深度纹素，之后每级恰好 2x2 归约
+    return glm::uvec2(std::min(std::bit_floor(std::max(width, 1u)), kMaxBaseSize),
+                      std::min(std::bit_floor(std::max(height, 1u)), kMaxBaseSize));
+}
+
+uint32_t HiZPyramid::getMipCount(glm::uvec2 baseSize)
+{
+    return static_cast<uint32_t>(std::bit_width(std::max(baseSize.x, baseSize.y)));
+}
+
+// ==================== 金字塔资源 ====================
+
+void HiZPyramid::createpyramids(glm::uvec2 baseSize)
+{
+    // 旧的金字塔可能已被本帧的渲染图导入，延迟到 endFrame() 释放
+    for (Pyramid &pyramid : m_pyramids)
+    {
+        m_retired.push_back(std::move(pyramid));
+    }
+    m_pyramids.clear();
+
+    m_baseSize = baseSize;
+    m_mipCount = getMipCount(baseSize);
+    m_historyValid = false;
+
+    const uint32_t count = static_cast<uint32_t>(m_descriptorSets.size()) + 1;
+    m_pyramids.resize(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Pyramid &pyramid = m_pyramids[i];
+
+        vkcore::ImageDesc desc{};
+        desc.format = kFormat;
+        desc.extent = vk::Extent3D{baseSize.x, baseSize.y, 1};
+        desc.mipLevels = m_mipCount;
+        desc.usage = vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled;
+        desc.category = vkcore::MemoryCategory::RenderTarget;
+        pyramid.image = std::make_unique<vkcore::Image>("HiZPyramid" + std::to_string(i), m_device, m_allocator, desc);
+
+        pyramid.mipViews.resize(m_mipCount);
+        for (uint32_t level = 0; level < m_mipCount; ++level)
+        {
+            vk::ImageViewCreateInfo viewInfo{};
+            viewInfo.image = pyramid.image->get();
+            viewInfo.viewType = vk::ImageViewType::e2D;
+            viewInfo.format = kFormat;
+            viewInfo.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, level, 1, 0, 1);
+            pyramid.mipViews[level] = m_device.get().createImageView(viewInfo);
+        }
+
+        // 计数从 0 开始，之后每次分发结束时由着色器复位
+        pyramid.counterBuffer = createmappedbuffer("HiZCounter" + std::to_string(i), m_device, m_allocator,
+                                                   sizeof(uint32_t), vk::BufferUsageFlagBits::eStorageBuffer);
+        std::memset(pyramid.counterBuffer->map(), 0, sizeof(uint32_t));
+        pyramid.counterBuffer->flush(sizeof(uint32_t), 0);
+    }
+}
+
+void HiZPyramid::releasepyramid(Pyramid &pyramid)
+{
+    if (pyramid.counterBuffer)
+    {
+        pyramid.counterBuffer->ummap();
+    }
+
+    vk::Device device = m_device.get();
+    if (m_deletionQueue)
+    {
+        std::shared_ptr<vkcore::Image> image = std::move(pyramid.image);
+        std::shared_ptr<vkcore::Buffer> counter = std::move(pyramid.counterBuffer);
+        m_deletionQueue->enqueue([device, views = std::move(pyramid.mipViews), image, counter]() mutable {
+            for (vk::ImageView view : views)
+            {
+                device.destroyImageView(view);
+            }
+            image.reset();
+            counter.reset();
+        });
+    }
+    else
+    {
+        for (vk::ImageView view : pyramid.mipViews)
+        {
+            device.destroyImageView(view);
+        }
+        pyramid.image.reset();
+        pyramid.counterBuffer.reset();
+    }
+    pyramid.mipViews.clear();
+    pyramid.handle = rendercore::kInvalidTextureHandle;
+}
+
+rendercore::RDGTextureHandle HiZPyramid::importpyramid(rendercore::RDGBuilder &builder, Pyramid &pyramid,
+                                                       const char *name)
+{
+    // 同一帧内只导入一次，多个使用者共享同一句柄
+    if (!pyramid.handle.isValid())
+    {
+        pyramid.handle = builder.registerExternalTexture(pyramid.image.get(), name, pyramid.layout);
+    }
+    return pyramid.handle;
+}
+
+HiZPyramidView HiZPyramid::makeview(const Pyramid &pyramid) const
+{
+    HiZPyramidView view;
+    view.texture = pyramid.handle;
+    view.width = m_baseSize.x;
+    view.height = m_baseSize.y;
+    view.mipCount = m_mipCount;
+    view.viewProjection = pyramid.viewProjection;
+    return view;
+}
+
+// ==================== 渲染图 ====================
+
+HiZPyramidView HiZPyramid::importHistory(rendercore::RDGBuilder &builder)
+{
+    if (!m_historyValid || m_pyramids.empty())
+    {
+        return {};
+    }
+    Pyramid &pyramid = m_pyramids[m_history];
+    importpyramid(builder, pyramid, "HiZPyramidHistory");
+    return makeview(pyramid);
+}
+
+HiZPyramidView HiZPyramid::addBuildPass(rendercore::RDGBuilder &builder, uint32_t frameIndex,
+                                        rendercore::RDGTextureHandle depth, uint32_t width, uint32_t height,
+                                        const glm::mat4 &viewProjection)
+{
+    if (frameIndex >= m_descriptorSets.size())
+    {
+        throw std::invalid_argument("HiZPyramid::addBuildPass: frameIndex out of range");
+    }
+    if (!depth.isValid() || width == 0 || height == 0)
+    {
+        throw std::invalid_argument("HiZPyramid::addBuildPass: invalid depth buffer");
+    }
+    if (m_built)
+    {
+        throw std::runtime_error("HiZPyramid::addBuildPass: endFrame() must be called once per graph");
+    }
+
+    const glm::uvec2 baseSize = getBaseSize(width, height);
+    if (baseSize != m_baseSize || m_pyramids.empty())
+    {
+        createpyramids(baseSize);
+    }
+
+    // 写入环中历史之后的下一份：它最后一次被读取是在 framesInFlight 帧之前，那一帧的 GPU 工作已经完成
+    m_current = (m_history + 1) % static_cast<uint32_t>(m_pyramids.size());
+    Pyramid &pyramid = m_pyramids[m_current];
+    pyramid.viewProjection = viewProjection;
+    pyramid.layout = vk::ImageLayout::eUndefined; // 全部 mip 都会被覆盖，旧内容可以丢弃
+    const rendercore::RDGTextureHandle texture = importpyramid(builder, pyramid, "HiZPyramid");
+    const rendercore::RDGBufferHandle counter =
+        builder.registerExternalBuffer(pyramid.counterBuffer.get(), "HiZCounter");
+    m_built = true;
+
+    GPUHiZPushConstants push{};
+    push.depthSize = glm::uvec2(width, height);
+    push.baseSize = baseSize;
+    push.mipCount = m_mipCount;
+    const glm::uvec2 groups = (baseSize + glm::uvec2(kTileSize - 1)) / kTileSize;
+    push.workgroupCount = groups.x * groups.y;
+
+    builder
+        .addPass("HiZPyramid",
+                 [this, frameIndex, depth, counter, push, groups, slot = m_current](
+                     vk::CommandBuffer cmd, const rendercore::RDGResourceAccessor &res) {
+                     const Pyramid &pyramid = m_pyramids[slot];
+
+                     // 存储图像数组固定为 kMaxMipCount 项，超出 mip 级数的项指向最后一级（着色器不会写入）
+                     std::array<vk::DescriptorImageInfo, kMaxMipCount> mipInfos;
+                     for (uint32_t level = 0; level < kMaxMipCount; ++level)
+                     {
+                         const size_t view = std::min<size_t>(level, pyramid.mipViews.size() - 1);
+                         mipInfos[level] =
+                             vk::DescriptorImageInfo(nullptr, pyramid.mipViews[view], vk::ImageLayout::eGeneral);
+                     }
+                     vk::DescriptorImageInfo depthInfo(res.getSampler(rendercore::RDGSamplerType::NearestClamp),
+                                                       res.getTextureView(depth),
+                                                       vk::ImageLayout::eShaderReadOnlyOptimal);
+                     vk::DescriptorBufferInfo counterInfo(res.getBuffer(counter), 0, VK_WHOLE_SIZE);
+
+                     const vk::DescriptorSet set = m_descriptorSets[frameIndex];
+                     vkcore::DescriptorUpdater::begin(m_device, set)
+                         .writeImage(kDepthBinding, vk::DescriptorType::eCombinedImageSampler, depthInfo)
+                         .writeImage(kPyramidBinding, vk::DescriptorType::eStorageImage, mipInfos[0], kMaxMipCount)
+                         .writeBuffer(kCounterBinding, vk::DescriptorType::eStorageBuffer, counterInfo)
+                         .update();
+
+                     m_pipeline->bind(cmd);
+                     cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipeline->getLayout(), 0, set,
+                                            nullptr);
+                     cmd.pushConstants(m_pipeline->getLayout(), vk::ShaderStageFlagBits::eCompute, 0, sizeof(push),
+                                       &push);
+                     cmd.dispatch(groups.x, groups.y, 1);
+                 })
+        .readTexture(depth, vk::PipelineStageFlagBits::eComputeShader, vk::AccessFlagBits::eShaderRead)
+        .writeStorageTexture(texture, vk::PipelineStageFlagBits::eComputeShader,
+                             vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite)
+        .writeStorageBuffer(counter, vk::PipelineStageFlagBits::eComputeShader,
+                            vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+
+    return makeview(pyramid);
+}
+
+void HiZPyramid::endFrame(const rendercore::RDGBuilder &builder)
+{
+    for (Pyramid &pyramid : m_pyramids)
+    {
+        if (pyramid.handle.isValid())
+        {
+            pyramid.layout = builder.getFinalLayout(pyramid.handle);
+            pyramid.handle = rendercore::kInvalidTextureHandle;
+        }
+    }
+    for (Pyramid &pyramid : m_retired)
+    {
+        releasepyramid(pyramid);
+    }
+    m_retired.clear();
+
+    if (m_built)
+    {
+        m_history = m_current;
+        m_historyValid = true;
+        m_built = false;
+    }
+}
+
+} // namespace renderer
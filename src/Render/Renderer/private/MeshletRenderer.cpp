@@ -0,0 +1,352 @@
+/**
+ * @file MeshletRenderer.cpp
+ * @brief MeshletRenderer 实现
+ */
+
+#include "MeshletRenderer.hpp"
+#include "RenderGraph/public/RDGResourceAccessor.hpp"
+#include "Resource/public/ResourceType.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace renderer
+{
+
+namespace
+{
+
+// 描述符绑定，需与 meshlet.task / meshlet.mesh 一致
+// set 0：每帧
+constexpr uint32_t kObjectsBinding = 0;
+constexpr uint32_t kParamsBinding = 1;
+constexpr uint32_t kHiZBinding = 2;
+// set 1：每网格
+constexpr uint32_t kMeshletsBinding = 0;
+constexpr uint32_t kVerticesBinding = 1;
+
+constexpr vk::ShaderStageFlags kTaskMeshStages = vk::ShaderStageFlagBits::eTaskEXT | vk::ShaderStageFlagBits::eMeshEXT;
+
+// 三个轴向缩放的相对差不超过该值时视为等比缩放
+constexpr float kUniformScaleTolerance = 1e-3f;
+
+/**
+ * @brief 创建持久映射的缓冲（优先放在主机可见的显存中，GPU 直接读取，无需暂存拷贝）
+ */
+std::unique_ptr<vkcore::Buffer> createmappedbuffer(const std::string &name, vkcore::Device &device,
+                                                   VmaAllocator allocator, vk::DeviceSize size,
+                                                   vk::BufferUsageFlags usage)
+{
+    vkcore::BufferDesc desc{};
+    desc.size = size;
+    desc.usageFlags = usage;
+    desc.mapping = vkcore::BufferMapping::DeviceLocal;
+
+    auto buffer = std::make_unique<vkcore::Buffer>(name, device, allocator, desc);
+    if (!buffer->getMappedData())
+    {
+        throw std::runtime_error("MeshletRenderer: failed to map buffer " + name);
+    }
+    return buffer;
+}
+
+} // namespace
+
+bool MeshletRenderer::isSupported(const vkcore::Device &device)
+{
+    return device.isExtensionEnabled(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+}
+
+vk::PushConstantRange MeshletRenderer::getPushConstantRange()
+{
+    return vk::PushConstantRange(kTaskMeshStages, 0, sizeof(GPUMeshletPushConstants));
+}
+
+MeshletRenderer::MeshletRenderer(vkcore::Device &device, VmaAllocator allocator,
+                                 vkcore::DescriptorLayoutCache &layoutCache, uint32_t framesInFlight)
+    : m_device(device), m_allocator(allocator)
+{
+    if (framesInFlight == 0)
+    {
+        throw std::invalid_argument("MeshletRenderer: framesInFlight must be greater than 0");
+    }
+    if (!isSupported(device))
+    {
+        throw std::runtime_error("MeshletRenderer: VK_EXT_mesh_shader is not enabled on this device");
+    }
+
+    // 扩展命令不由加载器导出，从设备获取
+    m_drawMeshTasks = reinterpret_cast<PFN_vkCmdDrawMeshTasksEXT>(device.get().getProcAddr("vkCmdDrawMeshTasksEXT"));
+    if (!m_drawMeshTasks)
+    {
+        throw std::runtime_error("MeshletRenderer: failed to load vkCmdDrawMeshTasksEXT");
+    }
+
+    m_frameSetLayout = vkcore::DescriptorLayoutBuilder::begin(&layoutCache)
+                           .addBinding(kObjectsBinding, vk::DescriptorType::eStorageBuffer, kTaskMeshStages)
+                           .addBinding(kParamsBinding, vk::DescriptorType::eUniformBuffer, kTaskMeshStages)
+                           .addBinding(kHiZBinding, vk::DescriptorType::eCombinedImageSampler,
+                                       vk::ShaderStageFlagBits::eTaskEXT)
+                           .build();
+    m_meshSetLayout = vkcore::DescriptorLayoutBuilder::begin(&layoutCache)
+                          .addBinding(kMeshletsBinding, vk::DescriptorType::eStorageBuffer, kTaskMeshStages)
+                          .addBinding(kVerticesBinding, vk::DescriptorType::eStorageBuffer,
+                                      vk::ShaderStageFlagBits::eMeshEXT)
+                          .build();
+
+    m_frameDescriptorAllocator = std::make_unique<vkcore::DescriptorAllocator>(device, &layoutCache);
+
+    // 占位 Hi-Z：只为满足描述符有效性，遮挡剔除关闭时着色器不会采样
+    vkcore::ImageDesc hiZDesc{};
+    hiZDesc.format = vk::Format::eR32Sfloat;
+    hiZDesc.extent = vk::Extent3D{1, 1, 1};
+    hiZDesc.usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+    m_dummyHiZ = std::make_unique<vkcore::Image>("MeshletDummyHiZ", device, allocator, hiZDesc);
+
+    m_frames.resize(framesInFlight);
+    for (uint32_t i = 0; i < framesInFlight; ++i)
+    {
+        FrameResources &frame = m_frames[i];
+        frame.paramsBuffer = createmappedbuffer("MeshletParams" + std::to_string(i), device, allocator,
+                                                sizeof(GPUMeshletParams), vk::BufferUsageFlagBits::eUniformBuffer);
+        frame.descriptorAllocator = std::make_unique<vkcore::DescriptorAllocator>(device, &layoutCache);
+        frame.frameSet = m_frameDescriptorAllocator->allocate(m_frameSetLayout);
+    }
+}
+
+MeshletRenderer::~MeshletRenderer() = default;
+
+// ==================== 场景同步 ====================
+
+void MeshletRenderer::update(rendercore::Scene &scene, uint32_t frameIndex)
+{
+    if (frameIndex >= m_frames.size())
+    {
+        throw std::invalid_argument("MeshletRenderer::update: frameIndex out of range");
+    }
+
+    rebuildobjects(scene);
+
+    FrameResources &frame = m_frames[frameIndex];
+    if (frame.objectsVersion != m_objectsVersion)
+    {
+        uploadobjects(frame);
+    }
+    if (frame.meshesVersion != m_meshesVersion)
+    {
+        rebuildmeshsets(frame);
+    }
+}
+
+void MeshletRenderer::rebuilddraws(const rendercore::SceneStorage &storage)
+{
+    std::span<const rendercore::RenderObject> renderObjects = storage.getRenderObjects();
+
+    m_draws.clear();
+    m_meshes.clear();
+    std::unordered_map<const rendercore::Mesh *, uint32_t> meshSlots;
+    for (uint32_t index = 0; index < renderObjects.size(); ++index)
+    {
+        const rendercore::Mesh *mesh = renderObjects[index].mesh;
+        if (!mesh || mesh->meshlets.count == 0 || !mesh->meshlets.buffer)
+        {
+            continue; // 没有 meshlet 的网格由顶点路径绘制
+        }
+        auto [it, inserted] = meshSlots.try_emplace(mesh, static_cast<uint32_t>(m_meshes.size()));
+        if (inserted)
+        {
+            m_meshes.push_back(mesh);
+        }
+        m_draws.push_back(MeshletDraw{mesh, index, it->second});
+    }
+
+    // 同一网格的绘制相邻，录制时减少描述符集切换
+    std::stable_sort(m_draws.begin(), m_draws.end(),
+                     [](const MeshletDraw &a, const MeshletDraw &b) { return a.meshSlot < b.meshSlot; });
+    ++m_meshesVersion;
+}
+
+void MeshletRenderer::rebuildobjects(rendercore::Scene &scene)
+{
+    const rendercore::SceneStorage &storage = scene.getStorage();
+    const bool sceneChanged = m_scene != &scene;
+    if (!sceneChanged && storage.getVersion() == m_sceneVersion)
+    {
+        return;
+    }
+
+    if (sceneChanged || storage.getRenderObjectsVersion() != m_renderObjectsVersion)
+    {
+        rebuilddraws(storage);
+    }
+
+    // 只有变换变化时绘制列表不变，只刷新矩阵
+    std::span<const rendercore::RenderObject> renderObjects = storage.getRenderObjects();
+    std::span<const glm::mat4> worldMatrices = storage.getWorldMatrices();
+    m_objects.resize(m_draws.size());
+    for (uint32_t drawIndex = 0; drawIndex < m_draws.size(); ++drawIndex)
+    {
+        const rendercore::RenderObject &renderObject = renderObjects[m_draws[drawIndex].renderObjectIndex];
+        GPUMeshletObject &object = m_objects[drawIndex];
+
+        const glm::mat4 &world = worldMatrices[renderObject.transformIndex];
+        const float scaleX = glm::length(glm::vec3(world[0]));
+        const float scaleY = glm::length(glm::vec3(world[1]));
+        const float scaleZ = glm::length(glm::vec3(world[2]));
+        object.world = world;
+        object.maxScale = std::max({scaleX, scaleY, scaleZ});
+        const bool uniformScale = std::abs(scaleX - scaleY) <= kUniformScaleTolerance * object.maxScale &&
+                                  std::abs(scaleX - scaleZ) <= kUniformScaleTolerance * object.maxScale;
+        object.flags = uniformScale ? GPUMeshletObjectConeCull : 0u;
+        // bindless 材质直接使用全局材质 SSBO 的下标，片段着色器可按 materialIndex 读取参数
+        const bool bindless = renderObject.material && renderObject.material->bindless.isValid();
+        object.materialIndex = bindless ? renderObject.material->bindless.index : UINT32_MAX;
+        object.padding = 0;
+    }
+
+    m_scene = &scene;
+    m_sceneVersion = storage.getVersion();
+    m_renderObjectsVersion = storage.getRenderObjectsVersion();
+    ++m_objectsVersion;
+}
+
+void MeshletRenderer::uploadobjects(FrameResources &frame)
+{
+    const vk::DeviceSize requiredSize = std::max<vk::DeviceSize>(m_objects.size(), 1) * sizeof(GPUMeshletObject);
+    if (!frame.objectBuffer || frame.objectBuffer->getSize() < requiredSize)
+    {
+        // 预留 50% 余量，避免对象逐个增加时每帧重建
+        frame.objectBuffer = createmappedbuffer("MeshletObjects", m_device, m_allocator, requiredSize * 3 / 2,
+                                                vk::BufferUsageFlagBits::eStorageBuffer);
+    }
+
+    if (!m_objects.empty())
+    {
+        const vk::DeviceSize size = m_objects.size() * sizeof(GPUMeshletObject);
+        std::memcpy(frame.objectBuffer->getMappedData(), m_objects.data(), size);
+        frame.objectBuffer->flush(size, 0);
+    }
+    frame.objectsVersion = m_objectsVersion;
+}
+
+void MeshletRenderer::rebuildmeshsets(FrameResources &frame)
+{
+    // 该帧之前的 GPU 工作已完成，旧集合可以整体丢弃
+    frame.descriptorAllocator->resetPools();
+    frame.meshSets.clear();
+    if (!m_meshes.empty())
+    {
+        frame.meshSets = frame.descriptorAllocator->allocate(static_cast<uint32_t>(m_meshes.size()), m_meshSetLayout);
+    }
+
+    for (size_t i = 0; i < m_meshes.size(); ++i)
+    {
+        const rendercore::Mesh *mesh = m_meshes[i];
+        vk::DescriptorBufferInfo meshletsInfo(mesh->meshlets.buffer->get(), 0, VK_WHOLE_SIZE);
+        vk::DescriptorBufferInfo verticesInfo(mesh->vertexBuffer->get(), 0, VK_WHOLE_SIZE);
+        vkcore::DescriptorUpdater::begin(m_device, frame.meshSets[i])
+            .writeBuffer(kMeshletsBinding, vk::DescriptorType::eStorageBuffer, meshletsInfo)
+            .writeBuffer(kVerticesBinding, vk::DescriptorType::eStorageBuffer, verticesInfo)
+            .update();
+    }
+    frame.meshesVersion = m_meshesVersion;
+}
+
+// ==================== 渲染图 ====================
+
+MeshletInputs MeshletRenderer::addInputs(rendercore::RDGBuilder &builder, uint32_t frameIndex,
+                                         const MeshletView &view)
+{
+    if (frameIndex >= m_frames.size())
+    {
+        throw std::invalid_argument("MeshletRenderer::addInputs: frameIndex out of range");
+    }
+    FrameResources &frame = m_frames[frameIndex];
+    if (!frame.objectBuffer)
+    {
+        throw std::runtime_error("MeshletRenderer::addInputs: update() must be called for this frame first");
+    }
+
+    const bool useOcclusion = view.hiZ.isValid() && view.hiZMipCount > 0;
+
+    // 每帧参数：该帧槽位的上一次 GPU 工作已完成，可以直接覆盖
+    GPUMeshletParams params{};
+    params.viewProjection = view.viewProjection;
+    params.hiZViewProjection = view.hiZViewProjection.value_or(view.viewProjection);
+    rendercore::Frustum frustum(view.viewProjection);
+    for (uint32_t p = 0; p < rendercore::Frustum::PlaneCount; ++p)
+    {
+        params.frustumPlanes[p] = frustum.getPlane(static_cast<rendercore::Frustum::Plane>(p));
+    }
+    params.cameraPosition = glm::vec4(view.cameraPosition, 0.0f);
+    params.hiZSize = glm::vec2(static_cast<float>(view.hiZWidth), static_cast<float>(view.hiZHeight));
+    params.hiZMipCount = view.hiZMipCount;
+    params.flags = GPUMeshletCullFrustum | GPUMeshletCullCone | (useOcclusion ? GPUMeshletCullOcclusion : 0u);
+    std::memcpy(frame.paramsBuffer->getMappedData(), &params, sizeof(params));
+    frame.paramsBuffer->flush(sizeof(params), 0);
+
+    MeshletInputs inputs;
+    inputs.frameIndex = frameIndex;
+    inputs.objects = builder.registerExternalBuffer(frame.objectBuffer.get(), "MeshletObjects");
+    inputs.hiZ = useOcclusion ? view.hiZ : builder.registerExternalTexture(m_dummyHiZ.get(), "MeshletDummyHiZ");
+    return inputs;
+}
+
+void MeshletRenderer::readDrawInputs(rendercore::RDGPass &pass, const MeshletInputs &inputs) const
+{
+    pass.readBuffer(inputs.objects,
+                    vk::PipelineStageFlagBits::eTaskShaderEXT | vk::PipelineStageFlagBits::eMeshShaderEXT,
+                    vk::AccessFlagBits::eShaderRead)
+        .readTexture(inputs.hiZ, vk::PipelineStageFlagBits::eTaskShaderEXT, vk::AccessFlagBits::eShaderRead);
+}
+
+void MeshletRenderer::recordDraws(vk::CommandBuffer cmd, const rendercore::RDGResourceAccessor &resources,
+                                  const MeshletInputs &inputs, vk::PipelineLayout pipelineLayout)
+{
+    FrameResources &frame = m_frames[inputs.frameIndex];
+
+    vk::DescriptorBufferInfo objectsInfo(resources.getBuffer(inputs.objects), 0, VK_WHOLE_SIZE);
+    vk::DescriptorBufferInfo paramsInfo(frame.paramsBuffer->get(), 0, sizeof(GPUMeshletParams));
+    vk::DescriptorImageInfo hiZInfo(resources.getSampler(rendercore::RDGSamplerType::NearestClamp),
+                                    resources.getTextureView(inputs.hiZ), vk::ImageLayout::eShaderReadOnlyOptimal);
+    vkcore::DescriptorUpdater::begin(m_device, frame.frameSet)
+        .writeBuffer(kObjectsBinding, vk::DescriptorType::eStorageBuffer, objectsInfo)
+        .writeBuffer(kParamsBinding, vk::DescriptorType::eUniformBuffer, paramsInfo)
+        .writeImage(kHiZBinding, vk::DescriptorType::eCombinedImageSampler, hiZInfo)
+        .update();
+
+    if (m_draws.empty())
+    {
+        return;
+    }
+
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout, 0, frame.frameSet, nullptr);
+    uint32_t boundMeshSlot = UINT32_MAX;
+    for (uint32_t drawIndex = 0; drawIndex < m_draws.size(); ++drawIndex)
+    {
+        const MeshletDraw &draw = m_draws[drawIndex];
+        if (draw.meshSlot != boundMeshSlot)
+        {
+            cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout, 1,
+                                   frame.meshSets[draw.meshSlot], nullptr);
+            boundMeshSlot = draw.meshSlot;
+        }
+
+        const rendercore::Mesh &mesh = *draw.mesh;
+        GPUMeshletPushConstants constants{};
+        constants.objectIndex = drawIndex;
+        constants.meshletCount = mesh.meshlets.count;
+        constants.vertexOffset = mesh.vertexOffset;
+        constants.vertexFormat = static_cast<uint32_t>(mesh.vertexFormat);
+        constants.vertexWordOffset = mesh.meshlets.vertexWordOffset;
+        constants.triangleWordOffset = mesh.meshlets.triangleWordOffset;
+        cmd.pushConstants(pipelineLayout, kTaskMeshStages, 0, sizeof(constants), &constants);
+
+        m_drawMeshTasks(cmd, (mesh.meshlets.count + kTaskGroupSize - 1) / kTaskGroupSize, 1, 1);
+    }
+}
+
+} // namespace renderer
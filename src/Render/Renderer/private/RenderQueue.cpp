@@ -0,0 +1,409 @@
+/**
+ * @file RenderQueue.cpp
+ * @brief RenderQueue 实现
+ */
+
+#include "RenderQueue.hpp"
+#include "Resource/public/BindlessRegistry.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace renderer
+{
+
+namespace
+{
+
+constexpr uint32_t kInstancesBinding = 0;
+constexpr uint32_t kVertexPullingOffset = 8; ///< 材质 ID（4 字节）之后按设备地址的 8 字节对齐
+
+// 排序键各字段的位宽（见 RenderQueue 类注释）
+constexpr uint32_t kDepthBits = 20;
+constexpr uint32_t kMeshBits = 16; ///< 网格 ID 与 LOD 级别
+constexpr uint32_t kLodBits = 3;
+constexpr uint32_t kMaterialBits = 16;
+constexpr uint32_t kPipelineBits = 11;
+constexpr uint64_t kTranslucentBit = 1ull << 63;
+
+constexpr uint64_t fieldmask(uint32_t bits)
+{
+    return (1ull << bits) - 1;
+}
+
+/**
+ * @brief 把非负深度量化为 kDepthBits 位的单调整数
+ * @details 非负 IEEE 浮点数的位模式与数值同序，取高位即可，无需知道远平面
+ */
+uint64_t quantizedepth(float depth)
+{
+    const uint32_t bits = std::bit_cast<uint32_t>(std::max(depth, 0.0f));
+    return (bits >> (31 - kDepthBits)) & fieldmask(kDepthBits);
+}
+
+/**
+ * @brief 为首次出现的指针分配密集 ID（超过字段位宽时饱和）
+ */
+template <typename T>
+uint64_t denseid(std::unordered_map<const T *, uint32_t> &ids, const T *pointer, uint32_t bits)
+{
+    auto it = ids.try_emplace(pointer, static_cast<uint32_t>(ids.size())).first;
+    return std::min<uint64_t>(it->second, fieldmask(bits));
+}
+
+} // namespace
+
+RenderQueue::RenderQueue(vkcore::Device &device, VmaAllocator allocator, vkcore::DescriptorLayoutCache &layoutCache,
+                         uint32_t framesInFlight)
+    : m_device(device), m_allocator(allocator), m_deviceAddress(supportsVertexPulling(device))
+{
+    if (framesInFlight == 0)
+    {
+        throw std::invalid_argument("RenderQueue: framesInFlight must be greater than 0");
+    }
+
+    m_setLayout = vkcore::DescriptorLayoutBuilder::begin(&layoutCache)
+                      .addBinding(kInstancesBinding, vk::DescriptorType::eStorageBuffer,
+                                  vk::ShaderStageFlagBits::eVertex)
+                      .build();
+    m_descriptorAllocator = std::make_unique<vkcore::DescriptorAllocator>(device, &layoutCache);
+
+    m_frames.resize(framesInFlight);
+    for (FrameResources &frame : m_frames)
+    {
+        frame.descriptorSet = m_descriptorAllocator->allocate(m_setLayout);
+    }
+}
+
+RenderQueue::~RenderQueue() = default;
+
+// ==================== 顶点拉取 ====================
+
+bool RenderQueue::supportsVertexPulling(const vkcore::Device &device)
+{
+    return device.isFeatureEnabled("bufferDeviceAddress");
+}
+
+vk::PushConstantRange RenderQueue::getVertexPullingPushConstantRange()
+{
+    return vk::PushConstantRange(vk::ShaderStageFlagBits::eVertex, kVertexPullingOffset,
+                                 sizeof(VertexPullingConstants));
+}
+
+void RenderQueue::setVertexPulling(bool enabled)
+{
+    if (enabled && !m_deviceAddress)
+    {
+        throw std::runtime_error("RenderQueue::setVertexPulling: bufferDeviceAddress is not enabled on the device");
+    }
+    m_vertexPulling = enabled;
+}
+
+// ==================== 排序与合批 ====================
+
+void RenderQueue::build(std::span<const rendercore::RenderObject> objects, std::span<const glm::mat4> worldMatrices,
+                        const glm::vec3 &viewPosition, const glm::vec3 &viewForward, uint32_t frameIndex)
+{
+    if (frameIndex >= m_frames.size())
+    {
+        throw std::invalid_argument("RenderQueue::build: frameIndex out of range");
+    }
+
+    m_items.clear();
+    m_pipelineStates.clear();
+    m_items.reserve(objects.size());
+
+    std::unordered_map<const rendercore::Material *, uint32_t> materialIds;
+    std::unordered_map<const rendercore::Mesh *, uint32_t> meshIds;
+    for (uint32_t i = 0; i < objects.size(); ++i)
+    {
+        const rendercore::RenderObject &object = objects[i];
+        if (!object.mesh || !object.material || !object.mesh->vertexBuffer || !object.mesh->indexBuffer ||
+            object.mesh->indexCount == 0)
+        {
+            continue;
+        }
+
+        const glm::vec3 position(worldMatrices[object.transformIndex][3]);
+        const uint64_t depth = quantizedepth(glm::dot(position - viewPosition, viewForward));
+        const uint32_t pipeline = pipelineindex(*object.material, *object.mesh);
+        const uint64_t pipelineId = std::min<uint64_t>(pipeline, fieldmask(kPipelineBits));
+        const uint64_t materialId = denseid(materialIds, object.material, kMaterialBits);
+        const uint64_t meshId = (denseid(meshIds, object.mesh, kMeshBits - kLodBits) << kLodBits) |
+                                std::min<uint64_t>(object.lod, fieldmask(kLodBits));
+
+        uint64_t key = 0;
+        if (object.material->alphaMode == rendercore::AlphaMode::Blend)
+        {
+            // 由远到近：深度取反后放在最高的有效字段
+            const uint64_t farToNear = fieldmask(kDepthBits) - depth;
+            key = kTranslucentBit | (farToNear << (kPipelineBits + kMaterialBits + kMeshBits)) |
+                  (pipelineId << (kMaterialBits + kMeshBits)) | (materialId << kMeshBits) | meshId;
+        }
+        else
+        {
+            key = (pipelineId << (kMaterialBits + kMeshBits + kDepthBits)) |
+                  (materialId << (kMeshBits + kDepthBits)) | (meshId << kDepthBits) | depth;
+        }
+
+        m_items.push_back(SortItem{key, i, pipeline});
+    }
+
+    // 键相同时按输入顺序，保证帧间稳定
+    std::sort(m_items.begin(), m_items.end(), [](const SortItem &a, const SortItem &b) {
+        return a.key != b.key ? a.key < b.key : a.objectIndex < b.objectIndex;
+    });
+
+    buildbatches(objects);
+    uploadinstances(m_frames[frameIndex], objects, worldMatrices);
+    m_stats.objectCount = static_cast<uint32_t>(objects.size());
+}
+
+uint32_t RenderQueue::pipelineindex(const rendercore::Material &material, const rendercore::Mesh &mesh)
+{
+    RenderPipelineState state;
+    state.vertexShader = material.vertexShader.get();
+    state.fragmentShader = material.fragmentShader.get();
+    state.alphaMode = material.alphaMode;
+    state.doubleSided = material.doubleSided;
+    state.vertexFormat = mesh.vertexFormat;
+    state.materialFeatures = material.features;
+    if (m_vertexPulling && (mesh.vertexBuffer->getUsage() & vk::BufferUsageFlagBits::eShaderDeviceAddress))
+    {
+        // 格式由着色器按推送常量解码，不同格式的网格合并为同一个状态
+        state.vertexPulling = true;
+        state.vertexFormat = rendercore::VertexFormat::Count;
+    }
+
+    // 一帧中的管线状态通常只有个位数，线性查找比哈希更快
+    auto it = std::find(m_pipelineStates.begin(), m_pipelineStates.end(), state);
+    if (it != m_pipelineStates.end())
+    {
+        return static_cast<uint32_t>(it - m_pipelineStates.begin());
+    }
+    m_pipelineStates.push_back(state);
+    return static_cast<uint32_t>(m_pipelineStates.size() - 1);
+}
+
+void RenderQueue::buildbatches(std::span<const rendercore::RenderObject> objects)
+{
+    m_batches.clear();
+    m_stats = RenderQueueStats{};
+
+    vk::DescriptorSet boundSet;
+    const vkcore::Buffer *boundVertexBuffer = nullptr;
+    const vkcore::Buffer *boundIndexBuffer = nullptr;
+    for (uint32_t slot = 0; slot < m_items.size(); ++slot)
+    {
+        const SortItem &item = m_items[slot];
+        const rendercore::RenderObject &object = objects[item.objectIndex];
+
+        if (!m_batches.empty())
+        {
+            RenderDrawBatch &last = m_batches.back();
+            if (last.pipelineIndex == item.pipelineIndex && last.material == object.material &&
+                last.mesh == object.mesh && last.lod == object.lod)
+            {
+                ++last.instanceCount;
+                continue;
+            }
+        }
+
+        // 与 recordDraws() 的绑定逻辑一致，统计假设所有管线布局兼容
+        if (m_batches.empty() || m_batches.back().pipelineIndex != item.pipelineIndex)
+        {
+            ++m_stats.pipelineBinds;
+        }
+        if (object.material->descriptorSet && object.material->descriptorSet != boundSet)
+        {
+            ++m_stats.descriptorBinds;
+            boundSet = object.material->descriptorSet;
+        }
+        const vkcore::Buffer *vertexBuffer = object.mesh->vertexBuffer.get();
+        const vkcore::Buffer *indexBuffer = object.mesh->indexBuffer.get();
+        m_stats.bufferBinds += (vertexBuffer != boundVertexBuffer ? 1 : 0) + (indexBuffer != boundIndexBuffer ? 1 : 0);
+        boundVertexBuffer = vertexBuffer;
+        boundIndexBuffer = indexBuffer;
+
+        RenderDrawBatch batch;
+        batch.sortKey = item.key;
+        batch.mesh = object.mesh;
+        batch.material = object.material;
+        batch.pipelineIndex = item.pipelineIndex;
+        batch.lod = object.lod;
+        batch.firstInstance = slot;
+        batch.instanceCount = 1;
+        m_batches.push_back(batch);
+    }
+
+    m_stats.drawCount = static_cast<uint32_t>(m_batches.size());
+}
+
+void RenderQueue::uploadinstances(FrameResources &frame, std::span<const rendercore::RenderObject> objects,
+                                  std::span<const glm::mat4> worldMatrices)
+{
+    const vk::DeviceSize requiredSize = std::max<vk::DeviceSize>(m_items.size(), 1) * sizeof(RenderInstanceData);
+    if (!frame.instanceBuffer || frame.instanceBuffer->getSize() < requiredSize)
+    {
+        // 预留 50% 余量，避免对象逐个增加时每帧重建；实例变换每帧重写，放在主机可见的显存中（ReBAR）
+        vkcore::BufferDesc desc{};
+        desc.size = requiredSize * 3 / 2;
+        desc.usageFlags = vk::BufferUsageFlagBits::eStorageBuffer;
+        if (m_deviceAddress)
+        {
+            desc.usageFlags |= vk::BufferUsageFlagBits::eShaderDeviceAddress;
+        }
+        desc.mapping = vkcore::BufferMapping::DeviceLocal;
+        frame.instanceBuffer = std::make_unique<vkcore::Buffer>("RenderQueueInstances", m_device, m_allocator, desc);
+        if (!frame.instanceBuffer->getMappedData())
+        {
+            throw std::runtime_error("RenderQueue: failed to map instance buffer");
+        }
+        frame.instanceAddress = m_deviceAddress ? frame.instanceBuffer->getDeviceAddress() : 0;
+
+        vk::DescriptorBufferInfo instancesInfo(frame.instanceBuffer->get(), 0, VK_WHOLE_SIZE);
+        vkcore::DescriptorUpdater::begin(m_device, frame.descriptorSet)
+            .writeBuffer(kInstancesBinding, vk::DescriptorType::eStorageBuffer, instancesInfo)
+            .update();
+    }
+
+    if (m_items.empty())
+    {
+        return;
+    }
+
+    // 顺序写入映射内存（写合并友好），不读回
+    auto *instances = static_cast<RenderInstanceData *>(frame.instanceBuffer->getMappedData());
+    for (uint32_t slot = 0; slot < m_items.size(); ++slot)
+    {
+        instances[slot].world = worldMatrices[objects[m_items[slot].objectIndex].transformIndex];
+    }
+    frame.instanceBuffer->flush(m_items.size() * sizeof(RenderInstanceData), 0);
+}
+
+// ==================== 录制 ====================
+
+uint32_t RenderQueue::recordDraws(vk::CommandBuffer cmd, uint32_t frameIndex, uint32_t instanceSet,
+                                  uint32_t materialSet, const PipelineResolver &resolver) const
+{
+    if (frameIndex >= m_frames.size())
+    {
+        throw std::invalid_argument("RenderQueue::recordDraws: frameIndex out of range");
+    }
+    const FrameResources &frame = m_frames[frameIndex];
+
+    uint32_t boundPipelineIndex = UINT32_MAX;
+    vk::PipelineLayout boundLayout;
+    const rendercore::Material *boundMaterial = nullptr;
+    vk::DescriptorSet boundSet;
+    bool instanceSetBound = false;
+    const vkcore::Buffer *boundVertexBuffer = nullptr;
+    const vkcore::Buffer *boundIndexBuffer = nullptr;
+    const vk::PushConstantRange materialRange = rendercore::BindlessRegistry::getMaterialPushConstantRange();
+    const vk::PushConstantRange pullingRange = getVertexPullingPushConstantRange();
+    bool pulling = false;
+    bool pipelineMissing = false;
+    uint32_t skippedDraws = 0;
+
+    for (const RenderDrawBatch &batch : m_batches)
+    {
+        if (batch.pipelineIndex != boundPipelineIndex)
+        {
+            // 同一管线状态的批次相邻（不透明部分按管线排序），每次切换只查询一次
+            boundPipelineIndex = batch.pipelineIndex;
+            vkcore::Pipeline *pipeline = resolver(m_pipelineStates[batch.pipelineIndex]);
+            pipelineMissing = pipeline == nullptr;
+            if (pipelineMissing)
+            {
+                ++skippedDraws;
+                continue;
+            }
+            pipeline->bind(cmd);
+
+            // 布局不兼容时之前绑定的描述符集与推送常量失效，需要重新绑定实例集与材质集
+            if (pipeline->getLayout() != boundLayout)
+            {
+                boundLayout = pipeline->getLayout();
+                instanceSetBound = false;
+                boundMaterial = nullptr;
+                boundSet = nullptr;
+                boundVertexBuffer = nullptr;
+            }
+
+            // 顶点拉取经推送常量读取实例，布局中不一定有实例集；切换路径时重新提供顶点来源
+            const bool statePulling = m_pipelineStates[batch.pipelineIndex].vertexPulling;
+            if (statePulling != pulling)
+            {
+                pulling = statePulling;
+                boundVertexBuffer = nullptr;
+            }
+            if (!pulling && !instanceSetBound)
+            {
+                cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, boundLayout, instanceSet,
+                                       frame.descriptorSet, nullptr);
+                instanceSetBound = true;
+            }
+        }
+        else if (pipelineMissing)
+        {
+            ++skippedDraws;
+            continue;
+        }
+
+        if (batch.material != boundMaterial)
+        {
+            // bindless 材质共享全局集：集只绑定一次，材质之间只推送材质 ID
+            if (batch.material->descriptorSet && batch.material->descriptorSet != boundSet)
+            {
+                cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, boundLayout, materialSet,
+                                       batch.material->descriptorSet, nullptr);
+                boundSet = batch.material->descriptorSet;
+            }
+            if (batch.material->bindless.isValid())
+            {
+                const uint32_t materialIndex = batch.material->bindless.index;
+                cmd.pushConstants(boundLayout, materialRange.stageFlags, materialRange.offset, materialRange.size,
+                                  &materialIndex);
+            }
+            boundMaterial = batch.material;
+        }
+
+        const rendercore::Mesh &mesh = *batch.mesh;
+        if (mesh.vertexBuffer.get() != boundVertexBuffer)
+        {
+            if (pulling)
+            {
+                // 同一 Arena 的网格共享顶点地址，gl_VertexIndex 已包含 drawIndexed 的 vertexOffset
+                VertexPullingConstants constants;
+                constants.vertices = mesh.vertexBuffer->getDeviceAddress();
+                constants.instances = frame.instanceAddress;
+                constants.vertexFormat = static_cast<uint32_t>(mesh.vertexFormat);
+                cmd.pushConstants(boundLayout, pullingRange.stageFlags, pullingRange.offset, pullingRange.size,
+                                  &constants);
+            }
+            else
+            {
+                vk::Buffer vertexBuffer = mesh.vertexBuffer->get();
+                vk::DeviceSize vertexOffset = 0;
+                cmd.bindVertexBuffers(0, 1, &vertexBuffer, &vertexOffset);
+            }
+            boundVertexBuffer = mesh.vertexBuffer.get();
+        }
+        if (mesh.indexBuffer.get() != boundIndexBuffer)
+        {
+            cmd.bindIndexBuffer(mesh.indexBuffer->get(), 0, mesh.indexType);
+            boundIndexBuffer = mesh.indexBuffer.get();
+        }
+
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        mesh.getLodRange(batch.lod, firstIndex, indexCount);
+        cmd.drawIndexed(indexCount, batch.instanceCount, firstIndex, mesh.vertexOffset, batch.firstInstance);
+    }
+    return skippedDraws;
+}
+
+} // namespace renderer
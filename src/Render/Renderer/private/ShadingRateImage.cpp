@@ -0,0 +1,276 @@
+/**
+ * @file ShadingRateImage.cpp
+ * @brief ShadingRateImage 实现
+ */
+
+#include "ShadingRateImage.hpp"
+#include "RenderGraph/public/RDGResourceAccessor.hpp"
+#include "VulkanCore/public/DeferredDeletionQueue.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <string>
+
+namespace renderer
+{
+
+namespace
+{
+
+// 描述符绑定，需与 shading_rate.comp 一致
+constexpr uint32_t kColorBinding = 0;
+constexpr uint32_t kDepthBinding = 1;
+constexpr uint32_t kRateBinding = 2;
+
+constexpr uint32_t kMaxRateLog2 = 2; ///< 附件编码支持的最大片段尺寸为 4x4
+
+uint32_t divup(uint32_t value, uint32_t divisor)
+{
+    return (value + divisor - 1) / divisor;
+}
+
+} // namespace
+
+bool ShadingRateImage::isSupported(const vkcore::Device &device)
+{
+    return device.isExtensionEnabled(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME);
+}
+
+ShadingRateImage::ShadingRateImage(vkcore::Device &device, VmaAllocator allocator,
+                                   vkcore::DescriptorLayoutCache &layoutCache,
+                                   std::shared_ptr<vkcore::ShaderModule> rateShader, uint32_t framesInFlight)
+    : m_device(device), m_allocator(allocator)
+{
+    if (framesInFlight == 0)
+    {
+        throw std::invalid_argument("ShadingRateImage: framesInFlight must be greater than 0");
+    }
+    if (!isSupported(device))
+    {
+        throw std::runtime_error("ShadingRateImage: VK_KHR_fragment_shading_rate is not enabled on this device");
+    }
+
+    const vk::FormatFeatureFlags required =
+        vk::FormatFeatureFlagBits::eStorageImage | vk::FormatFeatureFlagBits::eFragmentShadingRateAttachmentKHR;
+    if ((device.getPhysicalDevice().getFormatProperties(kFormat).optimalTilingFeatures & required) != required)
+    {
+        throw std::runtime_error("ShadingRateImage: R8_UINT shading rate attachments are not supported");
+    }
+
+    // 纹素尺寸取首选值并钳制到设备范围（范围两端都是 2 的幂）；最大片段尺寸取两轴中较小的一个
+    auto properties = device.getPhysicalDevice()
+                          .getProperties2<vk::PhysicalDeviceProperties2,
+                                          vk::PhysicalDeviceFragmentShadingRatePropertiesKHR>()
+                          .get<vk::PhysicalDeviceFragmentShadingRatePropertiesKHR>();
+    const vk::Extent2D minTexel = properties.minFragmentShadingRateAttachmentTexelSize;
+    const vk::Extent2D maxTexel = properties.maxFragmentShadingRateAttachmentTexelSize;
+    m_texelSize.width = std::clamp(kPreferredTexelSize, std::max(minTexel.width, 1u), std::max(maxTexel.width, 1u));
+    m_texelSize.height =
+        std::clamp(kPreferredTexelSize, std::max(minTexel.height, 1u), std::max(maxTexel.height, 1u));
+    const uint32_t maxFragment = std::min(properties.maxFragmentSize.width, properties.maxFragmentSize.height);
+    m_maxRateLog2 = std::min(static_cast<uint32_t>(std::bit_width(std::max(maxFragment, 1u))) - 1, kMaxRateLog2);
+
+    constexpr vk::ShaderStageFlags kComputeStage = vk::ShaderStageFlagBits::eCompute;
+    m_setLayout = vkcore::DescriptorLayoutBuilder::begin(&layoutCache)
+                      .addBinding(kColorBinding, vk::DescriptorType::eCombinedImageSampler, kComputeStage)
+                      .addBinding(kDepthBinding, vk::DescriptorType::eCombinedImageSampler, kComputeStage)
+                      .addBinding(kRateBinding, vk::DescriptorType::eStorageImage, kComputeStage)
+                      .build();
+
+    m_pipeline = vkcore::ComputePipelineBuilder(device)
+                     .setShaderModule(std::move(rateShader))
+                     .addDescriptorSetLayout(m_setLayout)
+                     .addPushConstant(vk::PushConstantRange(kComputeStage, 0, sizeof(GPUShadingRatePushConstants)))
+                     .build();
+
+    m_descriptorAllocator = std::make_unique<vkcore::DescriptorAllocator>(device, &layoutCache);
+    m_descriptorSets.resize(framesInFlight);
+    for (vk::DescriptorSet &set : m_descriptorSets)
+    {
+        set = m_descriptorAllocator->allocate(m_setLayout);
+    }
+}
+
+ShadingRateImage::~ShadingRateImage()
+{
+    // 析构时调用方已保证没有在途帧，直接销毁
+    m_deletionQueue = nullptr;
+    for (RateTarget &target : m_targets)
+    {
+        releasetarget(target);
+    }
+    for (RateTarget &target : m_retired)
+    {
+        releasetarget(target);
+    }
+}
+
+// ==================== 图像资源 ====================
+
+void ShadingRateImage::createtargets(vk::Extent2D size)
+{
+    // 旧的图像可能已被本帧的渲染图导入，延迟到 endFrame() 释放
+    for (RateTarget &target : m_targets)
+    {
+        m_retired.push_back(std::move(target));
+    }
+    m_targets.clear();
+
+    m_size = size;
+    m_historyValid = false;
+
+    const uint32_t count = static_cast<uint32_t>(m_descriptorSets.size()) + 1;
+    m_targets.resize(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        vkcore::ImageDesc desc{};
+        desc.format = kFormat;
+        desc.extent = vk::Extent3D{size.width, size.height, 1};
+        desc.usage = vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eFragmentShadingRateAttachmentKHR;
+        desc.category = vkcore::MemoryCategory::RenderTarget;
+        m_targets[i].image =
+            std::make_unique<vkcore::Image>("ShadingRate" + std::to_string(i), m_device, m_allocator, desc);
+    }
+}
+
+void ShadingRateImage::releasetarget(RateTarget &target)
+{
+    if (m_deletionQueue && target.image)
+    {
+        std::shared_ptr<vkcore::Image> image = std::move(target.image);
+        m_deletionQueue->enqueue([image]() mutable { image.reset(); });
+    }
+    target.image.reset();
+    target.handle = rendercore::kInvalidTextureHandle;
+}
+
+rendercore::RDGTextureHandle ShadingRateImage::importtarget(rendercore::RDGBuilder &builder, RateTarget &target,
+                                                            const char *name)
+{
+    // 同一帧内只导入一次，多个使用者共享同一句柄
+    if (!target.handle.isValid())
+    {
+        target.handle = builder.registerExternalTexture(target.image.get(), name, target.layout);
+    }
+    return target.handle;
+}
+
+// ==================== 渲染图 ====================
+
+ShadingRateView ShadingRateImage::importHistory(rendercore::RDGBuilder &builder, vk::Extent2D renderExtent)
+{
+    // 附件必须覆盖整个渲染区域
+    if (!m_historyValid || m_targets.empty() || divup(renderExtent.width, m_texelSize.width) > m_size.width ||
+        divup(renderExtent.height, m_texelSize.height) > m_size.height)
+    {
+        return {};
+    }
+
+    ShadingRateView view;
+    view.texture = importtarget(builder, m_targets[m_history], "ShadingRateHistory");
+    view.texelSize = m_texelSize;
+    return view;
+}
+
+void ShadingRateImage::addGeneratePass(rendercore::RDGBuilder &builder, uint32_t frameIndex,
+                                       rendercore::RDGTextureHandle color, rendercore::RDGTextureHandle depth,
+                                       vk::Extent2D extent, const glm::mat4 &viewProjection)
+{
+    if (frameIndex >= m_descriptorSets.size())
+    {
+        throw std::invalid_argument("ShadingRateImage::addGeneratePass: frameIndex out of range");
+    }
+    if (!color.isValid() || !depth.isValid() || extent.width == 0 || extent.height == 0)
+    {
+        throw std::invalid_argument("ShadingRateImage::addGeneratePass: invalid color or depth");
+    }
+    if (m_built)
+    {
+        throw std::runtime_error("ShadingRateImage::addGeneratePass: endFrame() must be called once per graph");
+    }
+
+    // 只增不减：动态分辨率缩小时沿用更大的图像，超出有效区域的纹素写为 1x1
+    const vk::Extent2D required{divup(extent.width, m_texelSize.width), divup(extent.height, m_texelSize.height)};
+    if (m_targets.empty() || required.width > m_size.width || required.height > m_size.height)
+    {
+        createtargets(vk::Extent2D{std::max(required.width, m_size.width), std::max(required.height, m_size.height)});
+    }
+
+    // 写入环中历史之后的下一份：它最后一次被读取是在 framesInFlight 帧之前，那一帧的 GPU 工作已经完成
+    m_current = (m_history + 1) % static_cast<uint32_t>(m_targets.size());
+    RateTarget &target = m_targets[m_current];
+    target.layout = vk::ImageLayout::eUndefined; // 每个纹素都会被覆盖，旧内容可以丢弃
+    const rendercore::RDGTextureHandle texture = importtarget(builder, target, "ShadingRate");
+    m_built = true;
+
+    GPUShadingRatePushConstants push{};
+    push.reprojection = m_previousViewProjection * glm::inverse(viewProjection);
+    push.colorSize = glm::uvec2(extent.width, extent.height);
+    push.texelSize = glm::uvec2(m_texelSize.width, m_texelSize.height);
+    push.flatContrast = m_settings.flatContrast;
+    push.detailContrast = m_settings.detailContrast;
+    push.motionPixels2x2 = m_settings.motionPixels2x2;
+    push.motionPixels4x4 = m_settings.motionPixels4x4;
+    push.maxRateLog2 = m_maxRateLog2;
+    push.motionEnabled = m_motionValid ? 1u : 0u;
+    m_previousViewProjection = viewProjection;
+    m_motionValid = true;
+
+    const vk::Extent2D groups = m_size;
+    builder
+        .addPass("ShadingRate",
+                 [this, frameIndex, color, depth, push, groups, slot = m_current](
+                     vk::CommandBuffer cmd, const rendercore::RDGResourceAccessor &res) {
+                     const vk::Sampler sampler = res.getSampler(rendercore::RDGSamplerType::NearestClamp);
+                     vk::DescriptorImageInfo colorInfo(sampler, res.getTextureView(color),
+                                                       vk::ImageLayout::eShaderReadOnlyOptimal);
+                     vk::DescriptorImageInfo depthInfo(sampler, res.getTextureView(depth),
+                                                       vk::ImageLayout::eShaderReadOnlyOptimal);
+                     vk::DescriptorImageInfo rateInfo(nullptr, m_targets[slot].image->getView(),
+                                                      vk::ImageLayout::eGeneral);
+
+                     const vk::DescriptorSet set = m_descriptorSets[frameIndex];
+                     vkcore::DescriptorUpdater::begin(m_device, set)
+                         .writeImage(kColorBinding, vk::DescriptorType::eCombinedImageSampler, colorInfo)
+                         .writeImage(kDepthBinding, vk::DescriptorType::eCombinedImageSampler, depthInfo)
+                         .writeImage(kRateBinding, vk::DescriptorType::eStorageImage, rateInfo)
+                         .update();
+
+                     m_pipeline->bind(cmd);
+                     cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipeline->getLayout(), 0, set,
+                                            nullptr);
+                     cmd.pushConstants(m_pipeline->getLayout(), vk::ShaderStageFlagBits::eCompute, 0, sizeof(push),
+                                       &push);
+                     cmd.dispatch(groups.width, groups.height, 1);
+                 })
+        .readTexture(color, vk::PipelineStageFlagBits::eComputeShader, vk::AccessFlagBits::eShaderRead)
+        .readTexture(depth, vk::PipelineStageFlagBits::eComputeShader, vk::AccessFlagBits::eShaderRead)
+        .writeStorageTexture(texture, vk::PipelineStageFlagBits::eComputeShader, vk::AccessFlagBits::eShaderWrite);
+}
+
+void ShadingRateImage::endFrame(const rendercore::RDGBuilder &builder)
+{
+    for (RateTarget &target : m_targets)
+    {
+        if (target.handle.isValid())
+        {
+            target.layout = builder.getFinalLayout(target.handle);
+            target.handle = rendercore::kInvalidTextureHandle;
+        }
+    }
+    for (RateTarget &target : m_retired)
+    {
+        releasetarget(target);
+    }
+    m_retired.clear();
+
+    if (m_built)
+    {
+        m_history = m_current;
+        m_historyValid = true;
+        m_built = false;
+    }
+}
+
+} // namespace renderer
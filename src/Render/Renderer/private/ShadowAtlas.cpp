@@ -0,0 +1,1036 @@
+/**
+ * @file ShadowAtlas.cpp
+ * @brief ShadowAtlas 实现
+ */
+
+#include "ShadowAtlas.hpp"
+#include "RenderGraph/public/RDGResourceAccessor.hpp"
+#include "Resource/public/VertexLayout.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <glm/gtc/matrix_transform.hpp>
+#include <stdexcept>
+
+namespace renderer
+{
+
+namespace
+{
+
+// 描述符绑定，需与 shadow_atlas.glsl 一致
+constexpr uint32_t kAtlasBinding = 0;
+constexpr uint32_t kViewsBinding = 1;
+constexpr uint32_t kLightsBinding = 2;
+
+constexpr vk::ShaderStageFlags kShadowStages = vk::ShaderStageFlagBits::eFragment;
+
+// 耗时估计的初始单价（calibrate() 按实测修正比例）
+constexpr float kTileCostMs = 0.02f;       ///< 每个图块的固定开销（清除、视口与状态切换）
+constexpr float kTriangleCostMs = 2.0e-6f; ///< 每个三角形
+
+// 平行光总是最先分配与调度（局部光源的重要性不超过 1）
+constexpr float kDirectionalImportance = 2.0f;
+
+// 从未绘制的图块没有可用内容，调度时优先于只是过时的图块
+constexpr float kUnrenderedPriority = 1.0e6f;
+
+inline void hashcombine(uint64_t &seed, uint64_t value)
+{
+    seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+bool ispoweroftwo(uint32_t value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+uint32_t tilekey(uint32_t x, uint32_t y)
+{
+    return x | (y << 16);
+}
+
+/**
+ * @brief 与方向不平行的 up 向量（lookAt 用）
+ */
+glm::vec3 chooseup(const glm::vec3 &direction)
+{
+    return std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+}
+
+glm::vec3 safenormalize(const glm::vec3 &direction)
+{
+    const float length = glm::length(direction);
+    return length > 1e-6f ? direction / length : glm::vec3(0.0f, -1.0f, 0.0f);
+}
+
+/**
+ * @brief 创建持久映射的缓冲（优先放在主机可见的显存中，GPU 直接读取，无需暂存拷贝）
+ */
+std::unique_ptr<vkcore::Buffer> createmappedbuffer(const std::string &name, vkcore::Device &device,
+                                                   VmaAllocator allocator, vk::DeviceSize size,
+                                                   vk::BufferUsageFlags usage)
+{
+    vkcore::BufferDesc desc{};
+    desc.size = size;
+    desc.usageFlags = usage;
+    desc.mapping = vkcore::BufferMapping::DeviceLocal;
+
+    auto buffer = std::make_unique<vkcore::Buffer>(name, device, allocator, desc);
+    if (!buffer->getMappedData())
+    {
+        throw std::runtime_error("ShadowAtlas: failed to map buffer " + name);
+    }
+    return buffer;
+}
+
+} // namespace
+
+// ==================== ShadowAtlasAllocator ====================
+
+ShadowAtlasAllocator::ShadowAtlasAllocator(uint32_t atlasSize, uint32_t minTileSize)
+    : m_atlasSize(atlasSize), m_minTileSize(minTileSize)
+{
+    if (!ispoweroftwo(atlasSize) || !ispoweroftwo(minTileSize) || minTileSize > atlasSize)
+    {
+        throw std::invalid_argument("ShadowAtlasAllocator: sizes must be powers of two with minTileSize <= atlasSize");
+    }
+    if (atlasSize / minTileSize > 0xFFFF)
+    {
+        throw std::invalid_argument("ShadowAtlasAllocator: too many tiles per axis");
+    }
+
+    m_freeLists.resize(levelof(minTileSize) + 1);
+    reset();
+}
+
+uint32_t ShadowAtlasAllocator::levelof(uint32_t size) const
+{
+    return static_cast<uint32_t>(std::countr_zero(m_atlasSize) - std::countr_zero(size));
+}
+
+uint32_t ShadowAtlasAllocator::levelsize(uint32_t level) const
+{
+    return m_atlasSize >> level;
+}
+
+bool ShadowAtlasAllocator::isfree(uint32_t level, uint32_t key) const
+{
+    const auto &list = m_freeLists[level];
+    return std::find(list.begin(), list.end(), key) != list.end();
+}
+
+void ShadowAtlasAllocator::takefree(uint32_t level, uint32_t key)
+{
+    auto &list = m_freeLists[level];
+    auto it = std::find(list.begin(), list.end(), key);
+    if (it != list.end())
+    {
+        *it = list.back();
+        list.pop_back();
+    }
+}
+
+bool ShadowAtlasAllocator::allocate(uint32_t size, ShadowAtlasRect &rect)
+{
+    size = std::clamp(std::bit_ceil(std::clamp(size, 1u, m_atlasSize)), m_minTileSize, m_atlasSize);
+    const uint32_t level = levelof(size);
+
+    // 找到最近的有空闲图块的一级（同级或更粗）
+    int32_t source = static_cast<int32_t>(level);
+    while (source >= 0 && m_freeLists[source].empty())
+    {
+        --source;
+    }
+    if (source < 0)
+    {
+        return false;
+    }
+
+    uint32_t key = m_freeLists[source].back();
+    m_freeLists[source].pop_back();
+
+    // 逐级拆分：继续拆分左上的子图块，其余三个放入子级的空闲列表
+    for (uint32_t current = static_cast<uint32_t>(source); current < level; ++current)
+    {
+        const uint32_t x = (key & 0xFFFF) * 2;
+        const uint32_t y = (key >> 16) * 2;
+        m_freeLists[current + 1].push_back(tilekey(x + 1, y + 1));
+        m_freeLists[current + 1].push_back(tilekey(x, y + 1));
+        m_freeLists[current + 1].push_back(tilekey(x + 1, y));
+        key = tilekey(x, y);
+    }
+
+    rect.x = (key & 0xFFFF) * size;
+    rect.y = (key >> 16) * size;
+    rect.size = size;
+    return true;
+}
+
+void ShadowAtlasAllocator::free(const ShadowAtlasRect &rect)
+{
+    if (!rect.isValid())
+    {
+        return;
+    }
+
+    uint32_t level = levelof(rect.size);
+    uint32_t x = rect.x / rect.size;
+    uint32_t y = rect.y / rect.size;
+
+    // 三个兄弟图块都空闲时合并回父图块，逐级向上
+    while (level > 0)
+    {
+        uint32_t siblings[3];
+        uint32_t siblingCount = 0;
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            const uint32_t sx = (x & ~1u) + (i & 1u);
+            const uint32_t sy = (y & ~1u) + (i >> 1);
+            if (sx != x || sy != y)
+            {
+                siblings[siblingCount++] = tilekey(sx, sy);
+            }
+        }
+        if (!isfree(level, siblings[0]) || !isfree(level, siblings[1]) || !isfree(level, siblings[2]))
+        {
+            break;
+        }
+        for (uint32_t sibling : siblings)
+        {
+            takefree(level, sibling);
+        }
+        x >>= 1;
+        y >>= 1;
+        --level;
+    }
+    m_freeLists[level].push_back(tilekey(x, y));
+}
+
+void ShadowAtlasAllocator::reset()
+{
+    for (auto &list : m_freeLists)
+    {
+        list.clear();
+    }
+    m_freeLists[0].push_back(tilekey(0, 0));
+}
+
+uint64_t ShadowAtlasAllocator::getFreeTexels() const
+{
+    uint64_t texels = 0;
+    for (uint32_t level = 0; level < m_freeLists.size(); ++level)
+    {
+        const uint64_t size = levelsize(level);
+        texels += m_freeLists[level].size() * size * size;
+    }
+    return texels;
+}
+
+// ==================== ShadowAtlas ====================
+
+ShadowAtlas::ShadowAtlas(vkcore::Device &device, VmaAllocator allocator, vkcore::DescriptorLayoutCache &layoutCache,
+                         std::shared_ptr<vkcore::ShaderModule> depthShader, uint32_t framesInFlight,
+                         const ShadowAtlasSettings &settings)
+    : m_device(device), m_allocator(allocator), m_settings(settings),
+      m_tileAllocator(settings.atlasSize, settings.minTileSize)
+{
+    if (framesInFlight == 0)
+    {
+        throw std::invalid_argument("ShadowAtlas: framesInFlight must be greater than 0");
+    }
+    if (settings.cascadeCount == 0 || settings.cascadeCount > kMaxCascades)
+    {
+        throw std::invalid_argument("ShadowAtlas: cascadeCount must be in [1, kMaxCascades]");
+    }
+    m_settings.maxLocalTileSize =
+        std::clamp(std::bit_floor(std::max(settings.maxLocalTileSize, 1u)), settings.minTileSize, settings.atlasSize);
+    m_settings.cascadeTileSize =
+        std::clamp(std::bit_floor(std::max(settings.cascadeTileSize, 1u)), settings.minTileSize, settings.atlasSize);
+
+    vkcore::ImageDesc atlasDesc{};
+    atlasDesc.format = settings.depthFormat;
+    atlasDesc.extent = vk::Extent3D{settings.atlasSize, settings.atlasSize, 1};
+    atlasDesc.usage = vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled;
+    atlasDesc.category = vkcore::MemoryCategory::RenderTarget;
+    m_atlas = std::make_unique<vkcore::Image>("ShadowAtlas", device, allocator, atlasDesc);
+
+    // 线性过滤的比较采样即 2x2 硬件 PCF；着色器把坐标夹取在图块内，不依赖寻址模式
+    vk::SamplerCreateInfo samplerInfo{};
+    samplerInfo.magFilter = vk::Filter::eLinear;
+    samplerInfo.minFilter = vk::Filter::eLinear;
+    samplerInfo.mipmapMode = vk::SamplerMipmapMode::eNearest;
+    samplerInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+    samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+    samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+    samplerInfo.compareEnable = VK_TRUE;
+    samplerInfo.compareOp = vk::CompareOp::eLessOrEqual;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = 0.0f;
+    samplerInfo.borderColor = vk::BorderColor::eFloatOpaqueWhite;
+    m_compareSampler = device.get().createSampler(samplerInfo);
+
+    m_setLayout = vkcore::DescriptorLayoutBuilder::begin(&layoutCache)
+                      .addBinding(kAtlasBinding, vk::DescriptorType::eCombinedImageSampler, kShadowStages)
+                      .addBinding(kViewsBinding, vk::DescriptorType::eStorageBuffer, kShadowStages)
+                      .addBinding(kLightsBinding, vk::DescriptorType::eStorageBuffer, kShadowStages)
+                      .build();
+
+    // 只写深度：每种顶点格式一条只有顶点着色器的管线，视口、裁剪与深度偏移为动态状态
+    vk::PipelineRasterizationStateCreateInfo rasterization{};
+    rasterization.polygonMode = vk::PolygonMode::eFill;
+    rasterization.cullMode = vk::CullModeFlagBits::eBack;
+    rasterization.frontFace = vk::FrontFace::eCounterClockwise;
+    rasterization.depthBiasEnable = VK_TRUE;
+    rasterization.lineWidth = 1.0f;
+    for (size_t i = 0; i < m_pipelines.size(); ++i)
+    {
+        const auto format = static_cast<rendercore::VertexFormat>(i);
+        m_pipelines[i] = vkcore::PipelineBuilder(device)
+                             .addShaderModule(depthShader)
+                             .addPushConstant(vk::PushConstantRange(vk::ShaderStageFlagBits::eVertex, 0,
+                                                                    sizeof(glm::mat4)))
+                             .setVertexInput(rendercore::VertexLayouts::getInfo(format).inputState)
+                             .setRasterization(rasterization)
+                             .setDepthAttachment(settings.depthFormat)
+                             .addDynamicState(vk::DynamicState::eViewport)
+                             .addDynamicState(vk::DynamicState::eScissor)
+                             .addDynamicState(vk::DynamicState::eDepthBias)
+                             .build();
+    }
+
+    m_descriptorAllocator = std::make_unique<vkcore::DescriptorAllocator>(device, &layoutCache);
+
+    m_frames.resize(framesInFlight);
+    vk::DescriptorImageInfo atlasInfo(m_compareSampler, m_atlas->getView(), vk::ImageLayout::eShaderReadOnlyOptimal);
+    for (FrameResources &frame : m_frames)
+    {
+        frame.descriptorSet = m_descriptorAllocator->allocate(m_setLayout);
+        vkcore::DescriptorUpdater::begin(device, frame.descriptorSet)
+            .writeImage(kAtlasBinding, vk::DescriptorType::eCombinedImageSampler, atlasInfo)
+            .update();
+    }
+}
+
+ShadowAtlas::~ShadowAtlas()
+{
+    if (m_compareSampler)
+    {
+        m_device.get().destroySampler(m_compareSampler);
+    }
+}
+
+// ==================== 更新 ====================
+
+void ShadowAtlas::update(rendercore::Scene &scene, const rendercore::Camera &camera, uint32_t frameIndex)
+{
+    if (frameIndex >= m_frames.size())
+    {
+        throw std::invalid_argument("ShadowAtlas::update: frameIndex out of range");
+    }
+
+    const rendercore::SceneStorage &storage = scene.getStorage();
+    m_stats = {};
+
+    collectlights(scene, camera);
+    allocatetiles();
+    for (auto &[light, shadow] : m_shadows)
+    {
+        computeviews(*light, shadow, camera);
+    }
+
+    FrameResources &frame = m_frames[frameIndex];
+    schedule(storage, frame);
+
+    if (m_dataDirty)
+    {
+        packgpudata();
+    }
+    if (frame.dataVersion != m_dataVersion)
+    {
+        uploadgpudata(frame);
+    }
+}
+
+void ShadowAtlas::collectlights(const rendercore::Scene &scene, const rendercore::Camera &camera)
+{
+    for (auto &[light, shadow] : m_shadows)
+    {
+        shadow.seen = false;
+    }
+
+    const glm::vec3 eye = camera.getPosition();
+    for (const auto &[id, light] : scene.getLights())
+    {
+        if (!light->isEnabled() || !light->isCastShadows())
+        {
+            continue;
+        }
+
+        const rendercore::LightType type = light->getType();
+        float range = 0.0f;
+        if (type == rendercore::LightType::Point)
+        {
+            range = static_cast<const rendercore::PointLight &>(*light).getRange();
+        }
+        else if (type == rendercore::LightType::Spot)
+        {
+            range = static_cast<const rendercore::SpotLight &>(*light).getRange();
+        }
+        else if (type != rendercore::LightType::Directional)
+        {
+            continue; // 区域光尚未支持
+        }
+
+        auto [it, inserted] = m_shadows.try_emplace(light.get());
+        LightShadow &shadow = it->second;
+        if (inserted)
+        {
+            m_dataDirty = true;
+        }
+        else if (shadow.type != type)
+        {
+            releasetiles(shadow);
+        }
+
+        shadow.type = type;
+        shadow.position = light->getWorldPosition();
+        shadow.seen = true;
+        if (type == rendercore::LightType::Directional)
+        {
+            shadow.importance = kDirectionalImportance;
+        }
+        else
+        {
+            // 影响范围相对距离的比值近似投影尺寸：摄像机位于范围内时为 1，随距离反比下降
+            const float distance = glm::length(shadow.position - eye);
+            shadow.importance = range / std::max(distance, std::max(range, 1e-3f));
+        }
+    }
+
+    // 不再投射阴影的光源归还图块
+    for (auto it = m_shadows.begin(); it != m_shadows.end();)
+    {
+        if (!it->second.seen)
+        {
+            releasetiles(it->second);
+            it = m_shadows.erase(it);
+            m_dataDirty = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+uint32_t ShadowAtlas::viewcount(rendercore::LightType type) const
+{
+    if (type == rendercore::LightType::Directional)
+    {
+        return m_settings.cascadeCount;
+    }
+    return type == rendercore::LightType::Point ? kPointLightFaces : 1u;
+}
+
+uint32_t ShadowAtlas::desiredtilesize(const LightShadow &shadow) const
+{
+    if (shadow.type == rendercore::LightType::Directional)
+    {
+        return m_settings.cascadeTileSize;
+    }
+
+    // 点光源的六个面各取一半边长，总纹素数与同等重要性的聚光灯相当
+    const float scale = shadow.type == rendercore::LightType::Point ? 0.5f : 1.0f;
+    const float target =
+        std::max(static_cast<float>(m_settings.maxLocalTileSize) * shadow.importance * scale, 1.0f);
+
+    // 当前尺寸在目标的 [0.75, 2.5) 倍带内时保持不变，避免在临界距离附近反复重新分配（重新分配意味着重绘）
+    const float current = static_cast<float>(shadow.tileSize);
+    if (shadow.tileSize != 0 && target >= current * 0.75f && target < current * 2.5f)
+    {
+        return shadow.tileSize;
+    }
+    return std::clamp(std::bit_floor(static_cast<uint32_t>(target)), m_settings.minTileSize,
+                      m_settings.maxLocalTileSize);
+}
+
+void ShadowAtlas::allocatetiles()
+{
+    // 重要性由高到低：图集紧张时先满足主要光源
+    std::vector<std::pair<LightShadow *, uint32_t>> order;
+    order.reserve(m_shadows.size());
+    for (auto &[light, shadow] : m_shadows)
+    {
+        const uint32_t desired = desiredtilesize(shadow);
+        // 先统一释放尺寸需要变化的图块，释放的区域可以被本帧分配的其他光源复用
+        if (shadow.tileSize != 0 && shadow.tileSize != desired)
+        {
+            releasetiles(shadow);
+        }
+        order.emplace_back(&shadow, desired);
+    }
+    std::sort(order.begin(), order.end(),
+              [](const auto &a, const auto &b) { return a.first->importance > b.first->importance; });
+
+    for (auto &[shadow, desired] : order)
+    {
+        if (shadow->tiles.empty())
+        {
+            allocatelight(*shadow, desired);
+        }
+    }
+}
+
+bool ShadowAtlas::allocatelight(LightShadow &shadow, uint32_t tileSize)
+{
+    const uint32_t count = viewcount(shadow.type);
+
+    // 放不下时逐级减半，直到最小图块
+    for (uint32_t size = tileSize; size >= m_settings.minTileSize; size /= 2)
+    {
+        std::vector<ShadowTile> tiles(count);
+        uint32_t allocated = 0;
+        while (allocated < count && m_tileAllocator.allocate(size, tiles[allocated].rect))
+        {
+            ++allocated;
+        }
+        if (allocated == count)
+        {
+            shadow.tiles = std::move(tiles);
+            shadow.tileSize = size;
+            m_dataDirty = true;
+            return true;
+        }
+        for (uint32_t i = 0; i < allocated; ++i)
+        {
+            m_tileAllocator.free(tiles[i].rect);
+        }
+    }
+    return false;
+}
+
+void ShadowAtlas::releasetiles(LightShadow &shadow)
+{
+    for (const ShadowTile &tile : shadow.tiles)
+    {
+        m_tileAllocator.free(tile.rect);
+    }
+    shadow.tiles.clear();
+    shadow.tileSize = 0;
+    m_dataDirty = true;
+}
+
+// ==================== 视图计算 ====================
+
+void ShadowAtlas::computeviews(const rendercore::Light &light, LightShadow &shadow, const rendercore::Camera &camera)
+{
+    if (shadow.tiles.empty())
+    {
+        return;
+    }
+
+    if (shadow.type == rendercore::LightType::Directional)
+    {
+        computecascades(light.getDirection(), shadow, camera);
+    }
+    else if (shadow.type == rendercore::LightType::Spot)
+    {
+        const auto &spot = static_cast<const rendercore::SpotLight &>(light);
+        ShadowTile &tile = shadow.tiles[0];
+        const float range = std::max(spot.getRange(), 0.1f);
+        const glm::vec3 direction = safenormalize(spot.getDirection());
+
+        // 外锥角加一个纹素的余量，锥体边缘的 PCF 采样不越出图块
+        const float halfAngle = std::acos(std::clamp(spot.getOuterCutoff(), 0.0f, 1.0f));
+        const float fovY = std::min(2.0f * halfAngle + 2.0f / static_cast<float>(tile.rect.size), glm::radians(170.0f));
+        const glm::mat4 view = glm::lookAt(shadow.position, shadow.position + direction, chooseup(direction));
+        const glm::mat4 projection = glm::perspectiveRH_ZO(fovY, 1.0f, std::max(range * 0.01f, 0.05f), range);
+
+        tile.viewProjection = projection * view;
+        tile.texelSize = 2.0f * std::tan(fovY * 0.5f) / static_cast<float>(tile.rect.size);
+        tile.importance = shadow.importance;
+    }
+    else if (shadow.type == rendercore::LightType::Point)
+    {
+        const auto &point = static_cast<const rendercore::PointLight &>(light);
+        const float range = std::max(point.getRange(), 0.1f);
+        static const glm::vec3 kFaceDirections[kPointLightFaces] = {
+            {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
+            {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}};
+
+        for (uint32_t face = 0; face < kPointLightFaces; ++face)
+        {
+            ShadowTile &tile = shadow.tiles[face];
+            // 视场略大于 90°：立方体面边缘的 PCF 采样不越出图块
+            const float fov = 2.0f * std::atan(1.0f + 2.0f / static_cast<float>(tile.rect.size));
+            const glm::vec3 direction = kFaceDirections[face];
+            const glm::mat4 view = glm::lookAt(shadow.position, shadow.position + direction, chooseup(direction));
+            const glm::mat4 projection = glm::perspectiveRH_ZO(fov, 1.0f, std::max(range * 0.01f, 0.05f), range);
+
+            tile.viewProjection = projection * view;
+            tile.texelSize = 2.0f * std::tan(fov * 0.5f) / static_cast<float>(tile.rect.size);
+            tile.importance = shadow.importance;
+        }
+    }
+}
+
+void ShadowAtlas::computecascades(const glm::vec3 &lightDirection, LightShadow &shadow,
+                                  const rendercore::Camera &camera)
+{
+    const float zNear = camera.getNearPlane();
+    const float zFar = camera.getFarPlane();
+    const float distance = std::max(std::min(m_settings.shadowDistance, zFar), zNear * 2.0f);
+
+    // 摄像机视锥在近/远平面上的角点（glm::perspective 的 NDC 深度范围为 [-1, 1]）
+    const glm::mat4 inverseViewProjection = glm::inverse(camera.getViewProjectionMatrix());
+    glm::vec3 nearCorners[4];
+    glm::vec3 farCorners[4];
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        const glm::vec2 ndc((i & 1u) ? 1.0f : -1.0f, (i & 2u) ? 1.0f : -1.0f);
+        const glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndc, -1.0f, 1.0f);
+        const glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndc, 1.0f, 1.0f);
+        nearCorners[i] = glm::vec3(nearPoint) / nearPoint.w;
+        farCorners[i] = glm::vec3(farPoint) / farPoint.w;
+    }
+
+    const glm::vec3 direction = safenormalize(lightDirection);
+    const glm::mat4 lightRotation = glm::lookAt(glm::vec3(0.0f), direction, chooseup(direction));
+    const float lambda = std::clamp(m_settings.cascadeSplitLambda, 0.0f, 1.0f);
+    const uint32_t cascadeCount = static_cast<uint32_t>(shadow.tiles.size());
+
+    float splitNear = zNear;
+    for (uint32_t cascade = 0; cascade < cascadeCount; ++cascade)
+    {
+        const float t = static_cast<float>(cascade + 1) / static_cast<float>(cascadeCount);
+        const float logSplit = zNear * std::pow(distance / zNear, t);
+        const float uniformSplit = zNear + (distance - zNear) * t;
+        const float splitFar = lambda * logSplit + (1.0f - lambda) * uniformSplit;
+
+        // 切片角点：视锥棱线上的视图深度是线性变化的，按深度比例插值近/远角点
+        const float a = (splitNear - zNear) / (zFar - zNear);
+        const float b = (splitFar - zNear) / (zFar - zNear);
+        glm::vec3 corners[8];
+        glm::vec3 center(0.0f);
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            corners[i] = glm::mix(nearCorners[i], farCorners[i], a);
+            corners[i + 4] = glm::mix(nearCorners[i], farCorners[i], b);
+            center += corners[i] + corners[i + 4];
+        }
+        center /= 8.0f;
+
+        // 以包围球定尺寸：投影大小与摄像机朝向无关，半径取整到 1/16 以消除浮点抖动
+        float radius = 0.0f;
+        for (const glm::vec3 &corner : corners)
+        {
+            radius = std::max(radius, glm::length(corner - center));
+        }
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        // 光源空间中把中心对齐到纹素网格（深度方向对齐到 1/4 半径），摄像机移动时矩阵只按整纹素跳变
+        ShadowTile &tile = shadow.tiles[cascade];
+        const float texelSize = 2.0f * radius / static_cast<float>(tile.rect.size);
+        const float depthStep = radius * 0.25f;
+        glm::vec3 lightCenter = glm::vec3(lightRotation * glm::vec4(center, 1.0f));
+        lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+        lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+        lightCenter.z = std::floor(lightCenter.z / depthStep) * depthStep;
+
+        // 光源视图看向 -Z：切片位于 [z - r, z + r]，朝光源一侧再延伸以包含视锥外的投射体
+        const float nearDistance = -(lightCenter.z + radius + depthStep + m_settings.directionalCasterDistance);
+        const float farDistance = -(lightCenter.z - radius - depthStep);
+        const glm::mat4 projection =
+            glm::orthoRH_ZO(lightCenter.x - radius, lightCenter.x + radius, lightCenter.y - radius,
+                            lightCenter.y + radius, nearDistance, farDistance);
+
+        tile.viewProjection = projection * lightRotation;
+        tile.texelSize = texelSize;
+        tile.importance = shadow.importance / static_cast<float>(cascade + 1);
+        splitNear = splitFar;
+    }
+}
+
+// ==================== 缓存失效与调度 ====================
+
+void ShadowAtlas::refreshcasters(ShadowTile &tile, const rendercore::SceneStorage &storage)
+{
+    // 矩阵与场景数据都未变化时沿用上一次收集的投射体
+    if (tile.casterStorageVersion == storage.getVersion() && tile.casterViewProjection == tile.viewProjection)
+    {
+        return;
+    }
+
+    // 图块矩阵均由 _ZO 投影构造（computecascades / 聚光灯 / 点光源），近平面按 [0, 1] 深度范围提取
+    rendercore::Frustum frustum(tile.viewProjection, rendercore::Frustum::DepthRange::ZeroToOne);
+    frustum.cull(storage.getWorldBounds(), tile.casters);
+
+    // 投射体的网格、LOD 与世界矩阵决定图块内容：任何一个移动或增删都会改变哈希
+    const auto objects = storage.getRenderObjects();
+    const auto worlds = storage.getWorldMatrices();
+    uint64_t hash = tile.casters.size();
+    hashcombine(hash, m_settings.casterLod);
+    for (uint32_t index : tile.casters)
+    {
+        const rendercore::RenderObject &object = objects[index];
+        hashcombine(hash, index);
+        hashcombine(hash, reinterpret_cast<uintptr_t>(object.mesh));
+        const glm::mat4 &world = worlds[object.transformIndex];
+        for (int column = 0; column < 4; ++column)
+        {
+            for (int row = 0; row < 4; ++row)
+            {
+                hashcombine(hash, std::bit_cast<uint32_t>(world[column][row]));
+            }
+        }
+    }
+
+    tile.casterHash = hash;
+    tile.casterViewProjection = tile.viewProjection;
+    tile.casterStorageVersion = storage.getVersion();
+}
+
+float ShadowAtlas::estimatecost(const ShadowTile &tile, std::span<const rendercore::RenderObject> objects) const
+{
+    uint64_t triangles = 0;
+    for (uint32_t index : tile.casters)
+    {
+        const rendercore::Mesh *mesh = objects[index].mesh;
+        if (mesh)
+        {
+            uint32_t first = 0;
+            uint32_t count = 0;
+            mesh->getLodRange(m_settings.casterLod, first, count);
+            triangles += count / 3;
+        }
+    }
+    return m_costScale * (kTileCostMs + static_cast<float>(triangles) * kTriangleCostMs);
+}
+
+void ShadowAtlas::schedule(const rendercore::SceneStorage &storage, FrameResources &frame)
+{
+    frame.tileDraws.clear();
+    frame.casterDraws.clear();
+
+    struct Candidate
+    {
+        ShadowTile *tile;
+        float priority;
+    };
+    std::vector<Candidate> dirty;
+
+    for (auto &[light, shadow] : m_shadows)
+    {
+        ++m_stats.shadowedLights;
+        if (shadow.tiles.empty())
+        {
+            ++m_stats.unallocatedLights;
+            continue;
+        }
+        for (ShadowTile &tile : shadow.tiles)
+        {
+            ++m_stats.tiles;
+            refreshcasters(tile, storage);
+            if (tile.rendered && tile.renderedViewProjection == tile.viewProjection &&
+                tile.renderedCasterHash == tile.casterHash)
+            {
+                tile.staleFrames = 0;
+                ++m_stats.cachedTiles;
+                continue;
+            }
+            // 过时越久优先级越高，保证低重要性的图块不会一直被推迟
+            const float priority = (tile.rendered ? 0.0f : kUnrenderedPriority) +
+                                   tile.importance * static_cast<float>(tile.staleFrames + 1);
+            dirty.push_back({&tile, priority});
+        }
+    }
+    std::sort(dirty.begin(), dirty.end(),
+              [](const Candidate &a, const Candidate &b) { return a.priority > b.priority; });
+
+    const auto objects = storage.getRenderObjects();
+    const auto worlds = storage.getWorldMatrices();
+    float spent = 0.0f;
+    for (const Candidate &candidate : dirty)
+    {
+        ShadowTile &tile = *candidate.tile;
+        const float cost = estimatecost(tile, objects);
+        // 至少更新一个图块，再大的图块也不会被永远推迟
+        if (!frame.tileDraws.empty() && spent + cost > m_settings.updateBudgetMs)
+        {
+            ++tile.staleFrames;
+            ++m_stats.deferredTiles;
+            continue;
+        }
+        spent += cost;
+
+        TileDraw draw;
+        draw.rect = tile.rect;
+        draw.firstCaster = static_cast<uint32_t>(frame.casterDraws.size());
+        for (uint32_t index : tile.casters)
+        {
+            const rendercore::RenderObject &object = objects[index];
+            if (!object.mesh || !object.mesh->vertexBuffer || !object.mesh->indexBuffer)
+            {
+                continue;
+            }
+            CasterDraw caster;
+            caster.vertexBuffer = object.mesh->vertexBuffer.get();
+            caster.indexBuffer = object.mesh->indexBuffer.get();
+            caster.indexType = object.mesh->indexType;
+            caster.vertexFormat = object.mesh->vertexFormat;
+            caster.vertexOffset = object.mesh->vertexOffset;
+            object.mesh->getLodRange(m_settings.casterLod, caster.firstIndex, caster.indexCount);
+            caster.mvp = tile.viewProjection * worlds[object.transformIndex];
+            frame.casterDraws.push_back(caster);
+        }
+        draw.casterCount = static_cast<uint32_t>(frame.casterDraws.size()) - draw.firstCaster;
+        frame.tileDraws.push_back(draw);
+
+        tile.rendered = true;
+        tile.renderedViewProjection = tile.viewProjection;
+        tile.renderedTexelSize = tile.texelSize;
+        tile.renderedCasterHash = tile.casterHash;
+        tile.staleFrames = 0;
+        m_dataDirty = true;
+        ++m_stats.updatedTiles;
+    }
+
+    m_stats.casterDraws = static_cast<uint32_t>(frame.casterDraws.size());
+    m_stats.estimatedMs = spent;
+    if (!frame.tileDraws.empty())
+    {
+        m_estimatedAverageMs = m_estimatedAverageMs > 0.0 ? m_estimatedAverageMs * 0.9 + spent * 0.1 : spent;
+    }
+}
+
+void ShadowAtlas::invalidate()
+{
+    for (auto &[light, shadow] : m_shadows)
+    {
+        for (ShadowTile &tile : shadow.tiles)
+        {
+            tile.rendered = false;
+            tile.casterStorageVersion = 0;
+        }
+    }
+    m_dataDirty = true;
+}
+
+void ShadowAtlas::calibrate(double measuredMs)
+{
+    if (measuredMs <= 0.0 || m_estimatedAverageMs <= 0.0)
+    {
+        return;
+    }
+    // 估计值已包含 m_costScale：按实测与估计之比逐步修正，避免单次测量抖动
+    const double ratio = std::clamp(measuredMs / m_estimatedAverageMs, 0.25, 4.0);
+    m_costScale = std::clamp(static_cast<float>(m_costScale * (0.9 + 0.1 * ratio)), 0.05f, 20.0f);
+}
+
+// ==================== GPU 数据 ====================
+
+void ShadowAtlas::packgpudata()
+{
+    m_views.clear();
+    m_lights.clear();
+
+    const float atlasScale = 1.0f / static_cast<float>(m_settings.atlasSize);
+    for (auto &[light, shadow] : m_shadows)
+    {
+        shadow.shadowIndex = static_cast<int32_t>(m_lights.size());
+
+        GPUShadowLight gpuLight{};
+        gpuLight.firstView = static_cast<uint32_t>(m_views.size());
+        gpuLight.viewCount = static_cast<uint32_t>(shadow.tiles.size());
+        if (shadow.type == rendercore::LightType::Directional)
+        {
+            gpuLight.type = static_cast<uint32_t>(GPULightType::Directional);
+        }
+        else if (shadow.type == rendercore::LightType::Point)
+        {
+            gpuLight.type = static_cast<uint32_t>(GPULightType::Point);
+        }
+        else
+        {
+            gpuLight.type = static_cast<uint32_t>(GPULightType::Spot);
+        }
+        gpuLight.position = glm::vec4(shadow.position, 1.0f);
+        m_lights.push_back(gpuLight);
+
+        // 着色使用图块内容对应的矩阵：推迟重绘的图块仍然给出与其内容一致的结果
+        const float perspective = shadow.type == rendercore::LightType::Directional ? 0.0f : 1.0f;
+        for (const ShadowTile &tile : shadow.tiles)
+        {
+            GPUShadowView view{};
+            view.viewProjection = tile.renderedViewProjection;
+            view.atlasRect = glm::vec4(static_cast<float>(tile.rect.x), static_cast<float>(tile.rect.y),
+                                       static_cast<float>(tile.rect.size), static_cast<float>(tile.rect.size)) *
+                             atlasScale;
+            view.params = glm::vec4(tile.rendered ? 1.0f : 0.0f, tile.renderedTexelSize, perspective,
+                                    m_settings.normalOffset);
+            m_views.push_back(view);
+        }
+    }
+
+    m_dataDirty = false;
+    ++m_dataVersion;
+}
+
+void ShadowAtlas::uploadgpudata(FrameResources &frame)
+{
+    const vk::DeviceSize viewBytes = std::max<size_t>(m_views.size(), 1) * sizeof(GPUShadowView);
+    const vk::DeviceSize lightBytes = std::max<size_t>(m_lights.size(), 1) * sizeof(GPUShadowLight);
+
+    // 容量不足时按两倍重建，光源逐个增加时不必每帧重建
+    bool rebind = false;
+    if (!frame.viewBuffer || frame.viewBuffer->getSize() < viewBytes)
+    {
+        const vk::DeviceSize capacity = frame.viewBuffer ? std::max(viewBytes, frame.viewBuffer->getSize() * 2)
+                                                         : viewBytes;
+        frame.viewBuffer = createmappedbuffer("ShadowViews", m_device, m_allocator, capacity,
+                                              vk::BufferUsageFlagBits::eStorageBuffer);
+        rebind = true;
+    }
+    if (!frame.lightBuffer || frame.lightBuffer->getSize() < lightBytes)
+    {
+        const vk::DeviceSize capacity = frame.lightBuffer ? std::max(lightBytes, frame.lightBuffer->getSize() * 2)
+                                                          : lightBytes;
+        frame.lightBuffer = createmappedbuffer("ShadowLights", m_device, m_allocator, capacity,
+                                               vk::BufferUsageFlagBits::eStorageBuffer);
+        rebind = true;
+    }
+
+    if (!m_views.empty())
+    {
+        std::memcpy(frame.viewBuffer->getMappedData(), m_views.data(), m_views.size() * sizeof(GPUShadowView));
+    }
+    if (!m_lights.empty())
+    {
+        std::memcpy(frame.lightBuffer->getMappedData(), m_lights.data(), m_lights.size() * sizeof(GPUShadowLight));
+    }
+    frame.viewBuffer->flush(viewBytes, 0);
+    frame.lightBuffer->flush(lightBytes, 0);
+
+    if (rebind)
+    {
+        vk::DescriptorBufferInfo viewsInfo(frame.viewBuffer->get(), 0, VK_WHOLE_SIZE);
+        vk::DescriptorBufferInfo lightsInfo(frame.lightBuffer->get(), 0, VK_WHOLE_SIZE);
+        vkcore::DescriptorUpdater::begin(m_device, frame.descriptorSet)
+            .writeBuffer(kViewsBinding, vk::DescriptorType::eStorageBuffer, viewsInfo)
+            .writeBuffer(kLightsBinding, vk::DescriptorType::eStorageBuffer, lightsInfo)
+            .update();
+    }
+    frame.dataVersion = m_dataVersion;
+}
+
+int32_t ShadowAtlas::getShadowIndex(const rendercore::Light *light) const
+{
+    auto it = m_shadows.find(light);
+    return it != m_shadows.end() ? it->second.shadowIndex : kNoShadow;
+}
+
+// ==================== 渲染图 ====================
+
+ShadowAtlasOutputs ShadowAtlas::addPasses(rendercore::RDGBuilder &builder, uint32_t frameIndex)
+{
+    if (frameIndex >= m_frames.size())
+    {
+        throw std::invalid_argument("ShadowAtlas::addPasses: frameIndex out of range");
+    }
+    FrameResources &frame = m_frames[frameIndex];
+    if (!frame.viewBuffer)
+    {
+        throw std::runtime_error("ShadowAtlas::addPasses: update() must be called for this frame first");
+    }
+
+    ShadowAtlasOutputs outputs;
+    outputs.frameIndex = frameIndex;
+    // 之前的帧在片段着色器中采样图集（readShadows）：重绘图块前的屏障需要等待在途帧的采样
+    outputs.atlas = builder.registerExternalTexture(m_atlas.get(), "ShadowAtlas", m_atlasLayout,
+                                                    vk::PipelineStageFlagBits::eFragmentShader);
+    outputs.views = builder.registerExternalBuffer(frame.viewBuffer.get(), "ShadowViews");
+    outputs.lights = builder.registerExternalBuffer(frame.lightBuffer.get(), "ShadowLights");
+    if (frame.tileDraws.empty())
+    {
+        return outputs;
+    }
+
+    // 以 eLoad 打开图集：未调度图块的缓存内容保持不变，调度的图块在 Pass 内逐个清除后重绘
+    builder
+        .addPass("ShadowAtlas",
+                 [this, frameIndex](vk::CommandBuffer cmd, const rendercore::RDGResourceAccessor &) {
+                     const FrameResources &frame = m_frames[frameIndex];
+                     cmd.setDepthBias(m_settings.depthBiasConstant, 0.0f, m_settings.depthBiasSlope);
+
+                     vkcore::Pipeline *boundPipeline = nullptr;
+                     vk::Buffer boundVertexBuffer;
+                     vk::Buffer boundIndexBuffer;
+                     vk::IndexType boundIndexType = vk::IndexType::eUint32;
+                     for (const TileDraw &tile : frame.tileDraws)
+                     {
+                         const vk::Rect2D area(
+                             vk::Offset2D(static_cast<int32_t>(tile.rect.x), static_cast<int32_t>(tile.rect.y)),
+                             vk::Extent2D(tile.rect.size, tile.rect.size));
+                         const vk::Viewport viewport(static_cast<float>(tile.rect.x), static_cast<float>(tile.rect.y),
+                                                     static_cast<float>(tile.rect.size),
+                                                     static_cast<float>(tile.rect.size), 0.0f, 1.0f);
+                         cmd.setViewport(0, viewport);
+                         cmd.setScissor(0, area);
+
+                         const vk::ClearAttachment clear(vk::ImageAspectFlagBits::eDepth, 0,
+                                                         vk::ClearDepthStencilValue(1.0f, 0));
+                         cmd.clearAttachments(clear, vk::ClearRect(area, 0, 1));
+
+                         for (uint32_t i = 0; i < tile.casterCount; ++i)
+                         {
+                             const CasterDraw &caster = frame.casterDraws[tile.firstCaster + i];
+                             vkcore::Pipeline *pipeline = m_pipelines[static_cast<size_t>(caster.vertexFormat)].get();
+                             if (pipeline != boundPipeline)
+                             {
+                                 pipeline->bind(cmd);
+                                 boundPipeline = pipeline;
+                             }
+                             if (caster.vertexBuffer->get() != boundVertexBuffer)
+                             {
+                                 boundVertexBuffer = caster.vertexBuffer->get();
+                                 cmd.bindVertexBuffers(0, boundVertexBuffer, vk::DeviceSize(0));
+                             }
+                             if (caster.indexBuffer->get() != boundIndexBuffer || caster.indexType != boundIndexType)
+                             {
+                                 boundIndexBuffer = caster.indexBuffer->get();
+                                 boundIndexType = caster.indexType;
+                                 cmd.bindIndexBuffer(boundIndexBuffer, 0, boundIndexType);
+                             }
+                             cmd.pushConstants(pipeline->getLayout(), vk::ShaderStageFlagBits::eVertex, 0,
+                                               sizeof(glm::mat4), &caster.mvp);
+                             cmd.drawIndexed(caster.indexCount, 1, caster.firstIndex, caster.vertexOffset, 0);
+                         }
+                     }
+                 })
+        .writeDepthAttachment(outputs.atlas, vk::AttachmentLoadOp::eLoad, vk::AttachmentStoreOp::eStore);
+    m_atlasLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+
+    return outputs;
+}
+
+void ShadowAtlas::readShadows(rendercore::RDGPass &pass, const ShadowAtlasOutputs &outputs)
+{
+    pass.readTexture(outputs.atlas, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead)
+        .readBuffer(outputs.views, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead)
+        .readBuffer(outputs.lights, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead);
+    m_atlasLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+}
+
+vk::DescriptorSet ShadowAtlas::getDescriptorSet(const ShadowAtlasOutputs &outputs) const
+{
+    if (outputs.frameIndex >= m_frames.size())
+    {
+        throw std::invalid_argument("ShadowAtlas::getDescriptorSet: frameIndex out of range");
+    }
+    return m_frames[outputs.frameIndex].descriptorSet;
+}
+
+} // namespace renderer
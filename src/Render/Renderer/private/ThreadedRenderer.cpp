@@ -0,0 +1,283 @@
+/**
+ * @file ThreadedRenderer.cpp
+ * @brief ThreadedRenderer 与 RenderFrameMailbox 实现
+ */
+
+#include "ThreadedRenderer.hpp"
+#include "VulkanCore/public/Log.hpp"
+#include "VulkanCore/public/Profiler.hpp"
+#include <future>
+#include <stdexcept>
+
+namespace renderer
+{
+
+namespace
+{
+
+// FNV-1a（64 位），视图内容键只需要相等性判断
+constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+uint64_t hashbytes(uint64_t hash, const void *data, size_t size)
+{
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * kFnvPrime;
+    }
+    return hash;
+}
+
+template <typename T> uint64_t hashvalue(uint64_t hash, const T &value)
+{
+    return hashbytes(hash, &value, sizeof(T));
+}
+
+} // namespace
+
+// ==================== RenderFrameData ====================
+
+void RenderFrameData::extract(rendercore::Scene &scene)
+{
+    QTR_PROFILE_SCOPE("RenderFrameData::extract");
+    // 两次查询都会先同步场景存储，第二次不再重算；各自的 span 在下一次查询前拷贝出来
+    const std::span<const rendercore::RenderObject> visible = scene.getVisibleRenderObjects();
+    objects.assign(visible.begin(), visible.end());
+    const std::span<const glm::mat4> matrices = scene.getWorldMatrices();
+    worldMatrices.assign(matrices.begin(), matrices.end());
+
+    if (const std::shared_ptr<rendercore::Camera> camera = scene.getCamera())
+    {
+        view = camera->getViewMatrix();
+        projection = camera->getProjectionMatrix();
+        viewPosition = camera->getPosition();
+        viewForward = camera->getFront();
+    }
+    views.clear();
+}
+
+void RenderFrameData::extractViews(rendercore::Scene &scene, std::span<const RenderViewSource> sources,
+                                   vkcore::WorkerPool *workers)
+{
+    QTR_PROFILE_SCOPE("RenderFrameData::extractViews");
+    const rendercore::SceneStorage &storage = scene.getStorage();
+    const std::span<const rendercore::RenderObject> all = storage.getRenderObjects();
+    objects.assign(all.begin(), all.end());
+    const std::span<const glm::mat4> matrices = storage.getWorldMatrices();
+    worldMatrices.assign(matrices.begin(), matrices.end());
+
+    // 场景部分的内容键对所有视图相同：存储版本覆盖变换与对象列表，光照逐个累加版本
+    uint64_t sceneHash = hashvalue(kFnvOffset, storage.getVersion());
+    sceneHash = hashvalue(sceneHash, scene.getLightsVersion());
+    for (const auto &[id, light] : scene.getLights())
+    {
+        sceneHash = hashvalue(sceneHash, id);
+        sceneHash = hashvalue(sceneHash, light->getVersion());
+    }
+
+    // 视图对象在帧间复用，visibleObjects 的容量因此保留
+    views.resize(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        const RenderViewSource &source = sources[i];
+        if (!source.camera)
+        {
+            throw std::invalid_argument("RenderFrameData::extractViews: view camera is null");
+        }
+
+        RenderViewData &viewData = views[i];
+        viewData.viewId = source.viewId;
+        viewData.view = source.camera->getViewMatrix();
+        viewData.projection = source.camera->getProjectionMatrix();
+        viewData.viewPosition = source.camera->getPosition();
+        viewData.viewForward = source.camera->getFront();
+        source.camera->getFrustum().cull(storage.getWorldBounds(), viewData.visibleObjects, workers);
+
+        uint64_t key = hashvalue(sceneHash, viewData.view);
+        key = hashvalue(key, viewData.projection);
+        viewData.contentKey = key == 0 ? 1 : key;
+    }
+
+    if (!views.empty())
+    {
+        view = views.front().view;
+        projection = views.front().projection;
+        viewPosition = views.front().viewPosition;
+        viewForward = views.front().viewForward;
+    }
+}
+
+// ==================== RenderFrameMailbox ====================
+
+void RenderFrameMailbox::publish()
+{
+    // acq_rel：释放本槽的写入，同时获取消费者归还的旧前台槽
+    m_back = m_middle.exchange(static_cast<uint8_t>(m_back | kFreshBit), std::memory_order_acq_rel) & kIndexMask;
+    notify();
+}
+
+const RenderFrameData *RenderFrameMailbox::acquire()
+{
+    if (!(m_middle.load(std::memory_order_relaxed) & kFreshBit))
+    {
+        return nullptr;
+    }
+    m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & kIndexMask;
+    return &m_slots[m_front];
+}
+
+void RenderFrameMailbox::notify()
+{
+    m_sequence.fetch_add(1, std::memory_order_release);
+    m_sequence.notify_one();
+}
+
+// ==================== ThreadedRenderer ====================
+
+ThreadedRenderer::ThreadedRenderer(std::unique_ptr<Backend> backend) : m_backend(std::move(backend))
+{
+    if (!m_backend)
+    {
+        throw std::invalid_argument("ThreadedRenderer: backend is null");
+    }
+}
+
+ThreadedRenderer::~ThreadedRenderer()
+{
+    cleanup();
+}
+
+bool ThreadedRenderer::initialize()
+{
+    if (m_thread.joinable())
+    {
+        return true;
+    }
+
+    std::promise<bool> initialized;
+    std::future<bool> result = initialized.get_future();
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread([this, &initialized]() {
+        QTR_PROFILE_THREAD("Render");
+        bool ok = false;
+        try
+        {
+            ok = m_backend->initialize();
+        }
+        catch (const std::exception &e)
+        {
+            QTR_LOG_ERROR("Renderer", "渲染线程初始化失败: " << e.what());
+        }
+        initialized.set_value(ok);
+        if (ok)
+        {
+            renderloop();
+        }
+        m_backend->cleanup();
+    });
+
+    if (!result.get())
+    {
+        m_running.store(false, std::memory_order_release);
+        m_thread.join();
+        return false;
+    }
+    return true;
+}
+
+void ThreadedRenderer::render()
+{
+    if (!m_running.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    // 渲染线程正在录制上一帧，这里写入的是它不会读取的后台槽
+    RenderFrameData &frame = m_mailbox.beginWrite();
+    frame.inputTime = std::chrono::steady_clock::now();
+    if (m_extractor)
+    {
+        m_extractor(frame);
+    }
+    frame.frameNumber = ++m_submittedFrames;
+    m_mailbox.publish();
+}
+
+void ThreadedRenderer::cleanup()
+{
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+    m_running.store(false, std::memory_order_release);
+    m_mailbox.notify();
+    m_thread.join();
+}
+
+void ThreadedRenderer::requestResize(uint32_t width, uint32_t height)
+{
+    requestResize(0, width, height);
+}
+
+void ThreadedRenderer::requestResize(uint32_t view, uint32_t width, uint32_t height)
+{
+    if (view >= kMaxViews)
+    {
+        throw std::invalid_argument("ThreadedRenderer::requestResize: view index out of range");
+    }
+    m_pendingResizes[view].store((static_cast<uint64_t>(width) << 32) | height, std::memory_order_release);
+    m_mailbox.notify();
+}
+
+void ThreadedRenderer::renderloop()
+{
+    while (m_running.load(std::memory_order_acquire))
+    {
+        // 先记下序号再检查邮箱：此后的 publish()/notify() 都会让 wait() 立即返回，不会丢失唤醒
+        const uint64_t seen = m_mailbox.getSequence();
+
+        std::array<uint64_t, kMaxViews> resizes{};
+        bool resized = false;
+        for (uint32_t view = 0; view < kMaxViews; ++view)
+        {
+            resizes[view] = m_pendingResizes[view].exchange(0, std::memory_order_acq_rel);
+            resized |= resizes[view] != 0;
+        }
+        const RenderFrameData *frame = m_mailbox.acquire();
+        if (!resized && !frame)
+        {
+            m_mailbox.wait(seen);
+            continue;
+        }
+
+        try
+        {
+            for (uint32_t view = 0; view < kMaxViews; ++view)
+            {
+                if (resizes[view])
+                {
+                    m_backend->resizeView(view, static_cast<uint32_t>(resizes[view] >> 32),
+                                          static_cast<uint32_t>(resizes[view] & 0xFFFFFFFFu));
+                }
+            }
+            if (frame)
+            {
+                QTR_PROFILE_SCOPE("ThreadedRenderer::renderFrame");
+                m_backend->renderFrame(*frame);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            QTR_LOG_ERROR("Renderer", "渲染失败: " << e.what());
+        }
+        if (frame)
+        {
+            m_lastRenderedFrame.store(frame->frameNumber, std::memory_order_release);
+            m_renderedFrames.fetch_add(1, std::memory_order_relaxed);
+            QTR_PROFILE_FRAME();
+        }
+    }
+}
+
+} // namespace renderer
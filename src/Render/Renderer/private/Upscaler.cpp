@@ -0,0 +1,179 @@
+/**
+ * @file Upscaler.cpp
+ * @brief Upscaler 实现
+ */
+
+#include "Upscaler.hpp"
+#include "RenderGraph/public/RDGResourceAccessor.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace renderer
+{
+
+namespace
+{
+
+// 描述符绑定，需与 upscale.frag / rcas.frag 一致
+constexpr uint32_t kInputBinding = 0;
+
+// upscale.frag 的 layout(constant_id = 0) UPSCALE_MODE
+constexpr uint32_t kModeConstantId = 0;
+
+constexpr vk::ShaderStageFlags kPushStages = vk::ShaderStageFlagBits::eFragment;
+
+} // namespace
+
+Upscaler::Upscaler(vkcore::Device &device, vkcore::DescriptorLayoutCache &layoutCache,
+                   std::shared_ptr<vkcore::ShaderModule> fullscreenShader,
+                   std::shared_ptr<vkcore::ShaderModule> upscaleShader,
+                   std::shared_ptr<vkcore::ShaderModule> sharpenShader, uint32_t framesInFlight)
+    : m_device(device), m_fullscreenShader(std::move(fullscreenShader)), m_upscaleShader(std::move(upscaleShader)),
+      m_sharpenShader(std::move(sharpenShader))
+{
+    if (!m_fullscreenShader || !m_upscaleShader)
+    {
+        throw std::invalid_argument("Upscaler: fullscreen and upscale shaders are required");
+    }
+    if (framesInFlight == 0)
+    {
+        throw std::invalid_argument("Upscaler: framesInFlight must be greater than 0");
+    }
+
+    m_setLayout = vkcore::DescriptorLayoutBuilder::begin(&layoutCache)
+                      .addBinding(kInputBinding, vk::DescriptorType::eCombinedImageSampler,
+                                  vk::ShaderStageFlagBits::eFragment)
+                      .build();
+
+    m_descriptorAllocator = std::make_unique<vkcore::DescriptorAllocator>(device, &layoutCache);
+    m_upscaleSets.resize(framesInFlight);
+    m_sharpenSets.resize(framesInFlight);
+    for (uint32_t i = 0; i < framesInFlight; ++i)
+    {
+        m_upscaleSets[i] = m_descriptorAllocator->allocate(m_setLayout);
+        m_sharpenSets[i] = m_descriptorAllocator->allocate(m_setLayout);
+    }
+}
+
+Upscaler::~Upscaler() = default;
+
+vkcore::Pipeline &Upscaler::getpipeline(Stage stage, vk::Format format)
+{
+    auto it = m_pipelines.find({stage, format});
+    if (it != m_pipelines.end())
+    {
+        return *it->second;
+    }
+
+    // 全屏三角形：无顶点输入、不剔除、不测试深度，视口与裁剪随输出尺寸变化
+    vk::PipelineRasterizationStateCreateInfo rasterization{};
+    rasterization.polygonMode = vk::PolygonMode::eFill;
+    rasterization.cullMode = vk::CullModeFlagBits::eNone;
+    rasterization.frontFace = vk::FrontFace::eCounterClockwise;
+    rasterization.lineWidth = 1.0f;
+
+    vk::PipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.depthTestEnable = VK_FALSE;
+    depthStencil.depthWriteEnable = VK_FALSE;
+
+    vk::PipelineColorBlendAttachmentState blend{};
+    blend.colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+                           vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+
+    vkcore::PipelineBuilder builder(m_device);
+    builder.addShaderModule(m_fullscreenShader)
+        .addShaderModule(stage == Stage::Sharpen ? m_sharpenShader : m_upscaleShader)
+        .setRasterization(rasterization)
+        .setDepthStencil(depthStencil)
+        .addColorAttachment(format, blend)
+        .addDynamicState(vk::DynamicState::eViewport)
+        .addDynamicState(vk::DynamicState::eScissor)
+        .addDescriptorSetLayout(m_setLayout)
+        .addPushConstant(vk::PushConstantRange(kPushStages, 0, sizeof(UpscalePushConstants)));
+    if (stage != Stage::Sharpen)
+    {
+        builder.setSpecializationConstant(kModeConstantId, static_cast<uint32_t>(stage),
+                                          vk::ShaderStageFlagBits::eFragment);
+    }
+
+    auto pipeline = builder.build();
+    vkcore::Pipeline &result = *pipeline;
+    m_pipelines.emplace(std::make_pair(stage, format), std::move(pipeline));
+    return result;
+}
+
+void Upscaler::addfullscreenpass(rendercore::RDGBuilder &builder, const char *name, Stage stage, vk::Format format,
+                                 vk::DescriptorSet set, rendercore::RDGTextureHandle input,
+                                 rendercore::RDGTextureHandle output, const UpscalePushConstants &push)
+{
+    vkcore::Pipeline *pipeline = &getpipeline(stage, format);
+    builder
+        .addPass(name,
+                 [this, pipeline, set, input, push](vk::CommandBuffer cmd, const rendercore::RDGResourceAccessor &res) {
+                     vk::DescriptorImageInfo inputInfo(res.getSampler(rendercore::RDGSamplerType::LinearClamp),
+                                                       res.getTextureView(input),
+                                                       vk::ImageLayout::eShaderReadOnlyOptimal);
+                     vkcore::DescriptorUpdater::begin(m_device, set)
+                         .writeImage(kInputBinding, vk::DescriptorType::eCombinedImageSampler, inputInfo)
+                         .update();
+
+                     const vk::Viewport viewport(0.0f, 0.0f, push.outputSize.x, push.outputSize.y, 0.0f, 1.0f);
+                     const vk::Rect2D scissor({0, 0}, {static_cast<uint32_t>(push.outputSize.x),
+                                                       static_cast<uint32_t>(push.outputSize.y)});
+                     pipeline->bind(cmd);
+                     cmd.setViewport(0, viewport);
+                     cmd.setScissor(0, scissor);
+                     cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline->getLayout(), 0, set, nullptr);
+                     cmd.pushConstants(pipeline->getLayout(), kPushStages, 0, sizeof(push), &push);
+                     cmd.draw(3, 1, 0, 0);
+                 })
+        .readTexture(input, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead)
+        .writeColorAttachment(output, vk::AttachmentLoadOp::eDontCare); // 全屏覆盖，旧内容无需加载
+}
+
+void Upscaler::addPasses(rendercore::RDGBuilder &builder, uint32_t frameIndex, rendercore::RDGTextureHandle input,
+                         vk::Extent2D inputExtent, rendercore::RDGTextureHandle output, vk::Extent2D outputExtent,
+                         vk::Format outputFormat, UpscaleMode mode, float sharpness)
+{
+    if (frameIndex >= m_upscaleSets.size())
+    {
+        throw std::invalid_argument("Upscaler::addPasses: frameIndex out of range");
+    }
+    if (!input.isValid() || !output.isValid())
+    {
+        throw std::invalid_argument("Upscaler::addPasses: invalid texture handle");
+    }
+    if (inputExtent.width == 0 || inputExtent.height == 0 || outputExtent.width == 0 || outputExtent.height == 0)
+    {
+        throw std::invalid_argument("Upscaler::addPasses: extent must not be zero");
+    }
+
+    UpscalePushConstants push{};
+    push.inputSize = glm::vec2(inputExtent.width, inputExtent.height);
+    push.outputSize = glm::vec2(outputExtent.width, outputExtent.height);
+    push.sharpness = std::clamp(sharpness, 0.0f, 1.0f);
+
+    const bool sharpen = mode == UpscaleMode::EdgeAdaptive && m_sharpenShader && push.sharpness > 0.0f;
+    if (!sharpen)
+    {
+        const Stage stage = mode == UpscaleMode::EdgeAdaptive ? Stage::EdgeAdaptive : Stage::Bilinear;
+        addfullscreenpass(builder, "Upscale", stage, outputFormat, m_upscaleSets[frameIndex], input, output, push);
+        return;
+    }
+
+    // 放大到输出分辨率的中间纹理，再锐化写入输出；锐化的输入与输出同尺寸
+    rendercore::RDGTextureDesc desc("UpscaleIntermediate", kIntermediateFormat, outputExtent.width,
+                                    outputExtent.height,
+                                    vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled);
+    const rendercore::RDGTextureHandle intermediate = builder.createTexture(desc);
+    addfullscreenpass(builder, "UpscaleEASU", Stage::EdgeAdaptive, kIntermediateFormat, m_upscaleSets[frameIndex],
+                      input, intermediate, push);
+
+    UpscalePushConstants sharpenPush = push;
+    sharpenPush.inputSize = push.outputSize;
+    addfullscreenpass(builder, "UpscaleRCAS", Stage::Sharpen, outputFormat, m_sharpenSets[frameIndex], intermediate,
+                      output, sharpenPush);
+}
+
+} // namespace renderer
@@ -0,0 +1,263 @@
+/**
+ * @file ViewportSet.cpp
+ * @brief ViewportSet 实现
+ */
+
+#include "ViewportSet.hpp"
+#include "RenderGraph/public/RDGSyncInfo.hpp"
+#include "VulkanCore/public/Profiler.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace renderer
+{
+
+ViewportSet::ViewportSet(vkcore::Device &device, VmaAllocator allocator, uint32_t framesInFlight)
+    : m_device(device), m_allocator(allocator)
+{
+    // 时间线从第 1 帧开始（交换链以帧号 0 表示图像未被使用）
+    m_timeline = std::make_unique<vkcore::FrameTimeline>(device.get(), framesInFlight);
+    m_timeline->beginFrame();
+}
+
+ViewportSet::~ViewportSet()
+{
+    // 交换链析构时等待设备空闲，之后时间线不再被引用
+    m_views.clear();
+    m_timeline.reset();
+}
+
+// ==================== 视口管理 ====================
+
+uint32_t ViewportSet::addView(vk::SurfaceKHR surface, const vkcore::PresentPolicy &policy)
+{
+    // 设备按第一个表面选择了呈现队列，其他窗口的表面也必须能由它呈现
+    if (!m_device.getPhysicalDevice().getSurfaceSupportKHR(m_device.getPresentQueueFamilyIndices(), surface))
+    {
+        throw std::runtime_error("ViewportSet::addView: the present queue does not support this surface");
+    }
+
+    auto swapchain = std::make_unique<vkcore::SwapChain>(surface, m_device, m_allocator, *m_timeline, policy);
+
+    auto slot = std::find_if(m_views.begin(), m_views.end(), [](const View &view) { return !view.swapchain; });
+    if (slot == m_views.end())
+    {
+        slot = m_views.emplace(m_views.end());
+    }
+    *slot = View{};
+    slot->swapchain = std::move(swapchain);
+    return static_cast<uint32_t>(slot - m_views.begin());
+}
+
+void ViewportSet::removeView(uint32_t view)
+{
+    View &target = getview(view, "removeView");
+    if (target.acquired)
+    {
+        throw std::runtime_error("ViewportSet::removeView: the view has an acquired image in this frame");
+    }
+    // 交换链析构时等待设备空闲（在途帧与呈现引擎都不再引用它的图像与信号量）
+    target = View{};
+}
+
+vkcore::SwapChain &ViewportSet::getSwapChain(uint32_t view)
+{
+    return *getview(view, "getSwapChain").swapchain;
+}
+
+void ViewportSet::requestResize(uint32_t view)
+{
+    View &target = getview(view, "requestResize");
+    target.swapchain->requestRecreate();
+    target.presentedKey = 0;
+}
+
+void ViewportSet::invalidate(uint32_t view)
+{
+    getview(view, "invalidate").presentedKey = 0;
+}
+
+void ViewportSet::invalidateAll()
+{
+    for (View &view : m_views)
+    {
+        view.presentedKey = 0;
+    }
+}
+
+// ==================== 帧循环 ====================
+
+bool ViewportSet::acquire(uint32_t view, uint64_t contentKey, uint32_t &imageIndex)
+{
+    QTR_PROFILE_SCOPE("ViewportSet::acquire");
+    View &target = getview(view, "acquire");
+    if (target.acquired)
+    {
+        throw std::runtime_error("ViewportSet::acquire: the view was already acquired in this frame");
+    }
+
+    // 内容与交换链都没变时窗口里已经是正确的画面；挂起的重建只在获取图像时执行，不能跳过
+    vkcore::SwapChain &swapchain = *target.swapchain;
+    if (contentKey != 0 && contentKey == target.presentedKey &&
+        swapchain.getGeneration() == target.presentedGeneration && !swapchain.isRecreatePending())
+    {
+        ++m_stats.skippedViews;
+        return false;
+    }
+
+    const vk::Result result = swapchain.acquireNextImage(imageIndex);
+    if (result == vk::Result::eErrorOutOfDateKHR)
+    {
+        // 已重建（或窗口最小化），代数变化使下一帧不会跳过
+        return false;
+    }
+    if (result != vk::Result::eSuccess && result != vk::Result::eSuboptimalKHR)
+    {
+        throw std::runtime_error("ViewportSet::acquire: failed to acquire swap chain image");
+    }
+
+    target.acquired = true;
+    target.imageIndex = imageIndex;
+    target.pendingKey = contentKey;
+    m_acquired.push_back(view);
+    return true;
+}
+
+void ViewportSet::submitAndPresent(std::span<const vk::CommandBufferSubmitInfo> commandBuffers,
+                                   std::chrono::steady_clock::time_point inputTime, vk::PipelineStageFlags2 waitStage)
+{
+    QTR_PROFILE_SCOPE("ViewportSet::submitAndPresent");
+    if (m_acquired.empty() && commandBuffers.empty())
+    {
+        return;
+    }
+
+    // 1. 一次提交：等待各视口的图像可用，触发各视口的渲染完成与本帧的时间线值
+    const uint32_t frameSlot = m_timeline->getFrameSlot();
+    std::vector<vk::SemaphoreSubmitInfo> waitInfos;
+    std::vector<vk::SemaphoreSubmitInfo> signalInfos;
+    waitInfos.reserve(m_acquired.size());
+    signalInfos.reserve(m_acquired.size() + 1);
+    for (uint32_t id : m_acquired)
+    {
+        const View &view = m_views[id];
+
+        vk::SemaphoreSubmitInfo waitInfo{};
+        waitInfo.semaphore = view.swapchain->getImageAvailableSemaphore(frameSlot);
+        waitInfo.stageMask = waitStage;
+        waitInfos.push_back(waitInfo);
+
+        vk::SemaphoreSubmitInfo signalInfo{};
+        signalInfo.semaphore = view.swapchain->getRenderFinishedSemaphore(view.imageIndex);
+        signalInfo.stageMask = vk::PipelineStageFlagBits2::eAllCommands;
+        signalInfos.push_back(signalInfo);
+    }
+    signalInfos.push_back(m_timeline->getSignalInfo(0));
+
+    vk::SubmitInfo2 submitInfo{};
+    submitInfo.waitSemaphoreInfoCount = static_cast<uint32_t>(waitInfos.size());
+    submitInfo.pWaitSemaphoreInfos = waitInfos.data();
+    submitInfo.commandBufferInfoCount = static_cast<uint32_t>(commandBuffers.size());
+    submitInfo.pCommandBufferInfos = commandBuffers.data();
+    submitInfo.signalSemaphoreInfoCount = static_cast<uint32_t>(signalInfos.size());
+    submitInfo.pSignalSemaphoreInfos = signalInfos.data();
+    {
+        const vk::Queue graphicsQueue = m_device.getGraphicsQueue();
+        std::lock_guard<std::mutex> queueLock(m_device.getQueueMutex(graphicsQueue));
+        graphicsQueue.submit2(submitInfo);
+    }
+
+    presentacquired(inputTime);
+}
+
+void ViewportSet::appendSubmitSync(rendercore::RDGSyncInfo &syncInfo, vk::PipelineStageFlags waitStage) const
+{
+    // 与 submitAndPresent() 的提交相同：渲染图的第一个图形批次等待图像可用，最后一个批次触发渲染完成与时间线
+    const uint32_t frameSlot = m_timeline->getFrameSlot();
+    for (uint32_t id : m_acquired)
+    {
+        const View &view = m_views[id];
+        syncInfo.addWaitSemaphore(view.swapchain->getImageAvailableSemaphore(frameSlot), waitStage);
+        syncInfo.addSignalSemaphore(view.swapchain->getRenderFinishedSemaphore(view.imageIndex));
+    }
+
+    const vk::SemaphoreSubmitInfo timelineSignal = m_timeline->getSignalInfo(0);
+    syncInfo.addTimelineSignal(timelineSignal.semaphore, timelineSignal.value);
+}
+
+void ViewportSet::present(std::chrono::steady_clock::time_point inputTime)
+{
+    QTR_PROFILE_SCOPE("ViewportSet::present");
+    if (m_acquired.empty())
+    {
+        throw std::runtime_error("ViewportSet::present: no view was acquired in this frame");
+    }
+    presentacquired(inputTime);
+}
+
+void ViewportSet::presentacquired(std::chrono::steady_clock::time_point inputTime)
+{
+    // 2. 一次呈现调用覆盖所有视口；过期与次优由各交换链自行处理
+    std::vector<vkcore::SwapChainPresent> presents;
+    presents.reserve(m_acquired.size());
+    for (uint32_t id : m_acquired)
+    {
+        View &view = m_views[id];
+        vkcore::SwapChain &swapchain = *view.swapchain;
+        presents.push_back(vkcore::SwapChainPresent{&swapchain, swapchain.getRenderFinishedSemaphore(view.imageIndex),
+                                                    view.imageIndex, inputTime});
+    }
+
+    std::vector<vk::Result> results(presents.size(), vk::Result::eSuccess);
+    vkcore::SwapChain::presentAll(presents, results);
+    for (size_t i = 0; i < m_acquired.size(); ++i)
+    {
+        View &view = m_views[m_acquired[i]];
+        const bool presented = results[i] == vk::Result::eSuccess || results[i] == vk::Result::eSuboptimalKHR;
+        view.presentedKey = presented ? view.pendingKey : 0;
+        view.presentedGeneration = view.swapchain->getGeneration();
+        view.acquired = false;
+    }
+
+    m_stats.renderedViews += m_acquired.size();
+    ++m_stats.frames;
+    m_acquired.clear();
+
+    // 3. 每帧只推进一次时间线：等待 framesInFlight 帧之前的那一帧完成
+    m_timeline->beginFrame();
+}
+
+void ViewportSet::setFramesInFlight(uint32_t framesInFlight)
+{
+    if (framesInFlight == 0)
+    {
+        throw std::invalid_argument("ViewportSet::setFramesInFlight: framesInFlight must be > 0");
+    }
+    if (!m_acquired.empty())
+    {
+        throw std::runtime_error("ViewportSet::setFramesInFlight: cannot change frames in flight mid-frame");
+    }
+
+    m_device.get().waitIdle();
+    m_timeline->setFramesInFlight(framesInFlight);
+    for (View &view : m_views)
+    {
+        if (view.swapchain)
+        {
+            view.swapchain->setFramesInFlight(framesInFlight);
+        }
+    }
+}
+
+ViewportSet::View &ViewportSet::getview(uint32_t view, const char *caller)
+{
+    if (!hasView(view))
+    {
+        throw std::invalid_argument(std::string("ViewportSet::") + caller + ": view " + std::to_string(view) +
+                                    " does not exist");
+    }
+    return m_views[view];
+}
+
+} // namespace renderer
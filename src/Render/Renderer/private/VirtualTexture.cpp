@@ -0,0 +1,866 @@
+/**
+ * @file VirtualTexture.cpp
+ * @brief VirtualTexture 实现
+ */
+
+#include "VirtualTexture.hpp"
+#include "RenderGraph/public/RDGResourceAccessor.hpp"
+#include "Resource/public/ResourceManager.hpp"
+#include "Resource/public/ResourceManagerUtils.hpp"
+#include "VulkanCore/public/DeferredDeletionQueue.hpp"
+#include "VulkanCore/public/Device.hpp"
+#include "VulkanCore/public/FrameTimeline.hpp"
+#include "VulkanCore/public/Log.hpp"
+#include "VulkanCore/public/Profiler.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace renderer
+{
+
+namespace
+{
+
+// 描述符绑定，需与 virtual_texture.glsl 一致
+constexpr uint32_t kPageTableBinding = 0;
+constexpr uint32_t kAtlasBinding = 1;
+constexpr uint32_t kParamsBinding = 2;
+
+constexpr vk::ShaderStageFlags kVirtualTextureStages =
+    vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute;
+constexpr uint32_t kTexelBytes = 4; ///< RGBA8
+
+uint32_t divup(uint32_t value, uint32_t divisor)
+{
+    return (value + divisor - 1) / divisor;
+}
+
+vkcore::UploadQueue &uploadqueueof(rendercore::ResourceManager &resources)
+{
+    vkcore::UploadQueue *queue = resources.getUploadQueue();
+    if (!queue)
+    {
+        throw std::runtime_error("VirtualTexture: the resource manager has no upload queue");
+    }
+    return *queue;
+}
+
+} // namespace
+
+VirtualTexture::PageProvider VirtualTexture::createTileDirectoryProvider(std::filesystem::path directory,
+                                                                         uint32_t pageSize, std::string extension)
+{
+    return [directory = std::move(directory), pageSize, extension = std::move(extension)](
+               const VirtualPageId &page, std::span<std::byte> texels) {
+        const std::filesystem::path path = directory / std::to_string(page.mip) /
+                                           (std::to_string(page.x) + "_" + std::to_string(page.y) + extension);
+        std::error_code error;
+        if (!std::filesystem::exists(path, error))
+        {
+            return false;
+        }
+
+        rendercore::TextureData data = rendercore::TextureLoader::loadFromFile(path, 4);
+        const size_t bytes = static_cast<size_t>(pageSize) * pageSize * kTexelBytes;
+        const bool valid = data.isValid() && !data.isFloat && data.width == static_cast<int>(pageSize) &&
+                           data.height == static_cast<int>(pageSize) && texels.size() >= bytes;
+        if (valid)
+        {
+            std::memcpy(texels.data(), data.pixels, bytes);
+        }
+        data.free();
+        return valid;
+    };
+}
+
+VirtualTexture::VirtualTexture(vkcore::Device &device, VmaAllocator allocator,
+                               vkcore::DescriptorLayoutCache &layoutCache, rendercore::ResourceManager &resources,
+                               vkcore::FrameTimeline &timeline, PageProvider provider,
+                               const VirtualTextureSettings &settings, vkcore::WorkerPool *workers)
+    : m_device(device), m_allocator(allocator), m_uploads(uploadqueueof(resources)), m_timeline(timeline),
+      m_workers(workers), m_provider(std::move(provider)), m_settings(settings)
+{
+    if (!m_provider)
+    {
+        throw std::invalid_argument("VirtualTexture: provider must not be empty");
+    }
+    // 页数为 2 的幂时每级页表的尺寸与图像 mip 链的尺寸一致
+    if (!std::has_single_bit(settings.pageCountX) || !std::has_single_bit(settings.pageCountY) ||
+        settings.pageCountX > kMaxPageCount || settings.pageCountY > kMaxPageCount)
+    {
+        throw std::invalid_argument("VirtualTexture: page counts must be powers of two not above kMaxPageCount");
+    }
+    if (settings.pageSize == 0 || settings.pageBorder * 2 >= settings.pageSize)
+    {
+        throw std::invalid_argument("VirtualTexture: pageBorder must leave a payload inside each page");
+    }
+    const uint32_t atlasSize = settings.atlasPages * settings.pageSize;
+    if (settings.atlasPages == 0 || settings.atlasPages > kMaxAtlasPages ||
+        atlasSize > device.getPhysicalDevice().getProperties().limits.maxImageDimension2D)
+    {
+        throw std::invalid_argument("VirtualTexture: atlasPages is out of range for this device");
+    }
+    if (settings.format != vk::Format::eR8G8B8A8Unorm && settings.format != vk::Format::eR8G8B8A8Srgb)
+    {
+        throw std::invalid_argument("VirtualTexture: page format must be RGBA8 (UNORM or SRGB)");
+    }
+    if (settings.feedbackScale == 0 || settings.maxUploadsPerFrame == 0 || settings.maxPendingDecodes == 0)
+    {
+        throw std::invalid_argument("VirtualTexture: feedbackScale and per-frame limits must be greater than 0");
+    }
+
+    // 最粗一级只有一页
+    m_mipCount = static_cast<uint32_t>(std::bit_width(std::max(settings.pageCountX, settings.pageCountY) - 1)) + 1;
+    m_pageBytes = static_cast<vk::DeviceSize>(settings.pageSize) * settings.pageSize * kTexelBytes;
+
+    size_t pageTotal = 0;
+    m_mipOffsets.resize(m_mipCount);
+    for (uint32_t mip = 0; mip < m_mipCount; ++mip)
+    {
+        m_mipOffsets[mip] = pageTotal;
+        pageTotal += static_cast<size_t>(pagesat(mip, false)) * pagesat(mip, true);
+    }
+    m_pages.resize(pageTotal);
+    m_tableMirror.assign(pageTotal, kInvalidEntry);
+    m_dirty.resize(m_mipCount);
+
+    // 页表：每级页一个 mip，每个纹素为 slotX | slotY << 12 | mip << 24
+    vkcore::ImageDesc tableDesc{};
+    tableDesc.format = kPageTableFormat;
+    tableDesc.extent = vk::Extent3D{settings.pageCountX, settings.pageCountY, 1};
+    tableDesc.mipLevels = m_mipCount;
+    tableDesc.usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+    tableDesc.category = vkcore::MemoryCategory::Texture;
+    m_pageTable = std::make_unique<vkcore::Image>("VirtualPageTable", device, allocator, tableDesc);
+
+    // 图集：支持时以稀疏 Image 创建，图块必须整除页尺寸，使每个槽位独立绑定内存
+    vkcore::ImageDesc atlasDesc{};
+    atlasDesc.format = settings.format;
+    atlasDesc.extent = vk::Extent3D{atlasSize, atlasSize, 1};
+    atlasDesc.usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+    atlasDesc.category = vkcore::MemoryCategory::Texture;
+    if (vkcore::Image::isSparseResidencySupported(device, atlasDesc))
+    {
+        atlasDesc.sparseResidency = true;
+        try
+        {
+            m_atlas = std::make_unique<vkcore::Image>("VirtualPageAtlas", device, allocator, atlasDesc);
+        }
+        catch (const std::runtime_error &error)
+        {
+            QTR_LOG_WARN("VirtualTexture", "稀疏图集创建失败，改为整张分配：" << error.what());
+        }
+        if (m_atlas && (settings.pageSize % m_atlas->getSparseTileExtent().width != 0 ||
+                        settings.pageSize % m_atlas->getSparseTileExtent().height != 0))
+        {
+            m_atlas.reset();
+        }
+    }
+    if (!m_atlas)
+    {
+        atlasDesc.sparseResidency = false;
+        m_atlas = std::make_unique<vkcore::Image>("VirtualPageAtlas", device, allocator, atlasDesc);
+        m_stats.atlasBytes = vkcore::Image::getMemoryRequirements(device, atlasDesc).size;
+    }
+    m_stats.sparse = m_atlas->isSparse();
+
+    m_slots.resize(static_cast<size_t>(settings.atlasPages) * settings.atlasPages);
+    m_freeSlots.reserve(m_slots.size());
+    for (uint32_t i = static_cast<uint32_t>(m_slots.size()); i-- > 0;)
+    {
+        m_slots[i].bound = !m_atlas->isSparse();
+        m_freeSlots.push_back(i);
+    }
+
+    // 页暂存区：UploadQueue 经传输队列写入显存，传输 Pass 再拷入图集（UploadQueue::uploadImage 会丢弃整张图集）
+    const uint32_t stagingCount = settings.maxUploadsPerFrame * (timeline.getFramesInFlight() + 1);
+    vkcore::BufferDesc stagingDesc{};
+    stagingDesc.size = m_pageBytes * stagingCount;
+    stagingDesc.usageFlags = vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eTransferSrc;
+    stagingDesc.memoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    stagingDesc.category = vkcore::MemoryCategory::Staging;
+    m_pageStaging = std::make_shared<vkcore::Buffer>("VirtualPageStaging", device, allocator, stagingDesc);
+    m_stagingRelease.assign(stagingCount, 0);
+
+    m_params.pageCount = glm::uvec2(settings.pageCountX, settings.pageCountY);
+    m_params.atlasTexel = glm::vec2(1.0f / static_cast<float>(atlasSize));
+    m_params.pageSize = settings.pageSize;
+    m_params.pageBorder = settings.pageBorder;
+    m_params.maxMip = m_mipCount - 1;
+    m_params.feedbackLodBias = -std::log2(static_cast<float>(settings.feedbackScale));
+
+    vkcore::BufferDesc paramsDesc{};
+    paramsDesc.size = sizeof(GPUVirtualTextureParams);
+    paramsDesc.usageFlags = vk::BufferUsageFlagBits::eUniformBuffer;
+    paramsDesc.category = vkcore::MemoryCategory::Uniform;
+    paramsDesc.mapping = vkcore::BufferMapping::DeviceLocal;
+    m_paramsBuffer = std::make_unique<vkcore::Buffer>("VirtualTextureParams", device, allocator, paramsDesc);
+    m_paramsBuffer->write(&m_params, sizeof(m_params));
+
+    // 页表只用 texelFetch 读取；图集在页内双线性过滤，边框保证不采样到相邻槽位
+    vk::SamplerCreateInfo samplerInfo{};
+    samplerInfo.magFilter = vk::Filter::eNearest;
+    samplerInfo.minFilter = vk::Filter::eNearest;
+    samplerInfo.mipmapMode = vk::SamplerMipmapMode::eNearest;
+    samplerInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+    samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+    samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+    samplerInfo.maxLod = static_cast<float>(m_mipCount);
+    m_tableSampler = device.get().createSampler(samplerInfo);
+    samplerInfo.magFilter = vk::Filter::eLinear;
+    samplerInfo.minFilter = vk::Filter::eLinear;
+    samplerInfo.maxLod = 0.0f;
+    m_atlasSampler = device.get().createSampler(samplerInfo);
+
+    m_setLayout = vkcore::DescriptorLayoutBuilder::begin(&layoutCache)
+                      .addBinding(kPageTableBinding, vk::DescriptorType::eCombinedImageSampler, kVirtualTextureStages)
+                      .addBinding(kAtlasBinding, vk::DescriptorType::eCombinedImageSampler, kVirtualTextureStages)
+                      .addBinding(kParamsBinding, vk::DescriptorType::eUniformBuffer, kVirtualTextureStages)
+                      .build();
+    m_descriptorAllocator = std::make_unique<vkcore::DescriptorAllocator>(device, &layoutCache);
+    m_descriptorSet = m_descriptorAllocator->allocate(m_setLayout);
+
+    vk::DescriptorImageInfo tableInfo(m_tableSampler, m_pageTable->getView(), vk::ImageLayout::eShaderReadOnlyOptimal);
+    vk::DescriptorImageInfo atlasInfo(m_atlasSampler, m_atlas->getView(), vk::ImageLayout::eShaderReadOnlyOptimal);
+    vk::DescriptorBufferInfo paramsInfo(m_paramsBuffer->get(), 0, sizeof(GPUVirtualTextureParams));
+    vkcore::DescriptorUpdater::begin(device, m_descriptorSet)
+        .writeImage(kPageTableBinding, vk::DescriptorType::eCombinedImageSampler, tableInfo)
+        .writeImage(kAtlasBinding, vk::DescriptorType::eCombinedImageSampler, atlasInfo)
+        .writeBuffer(kParamsBinding, vk::DescriptorType::eUniformBuffer, paramsInfo)
+        .update();
+
+    if (m_workers)
+    {
+        m_decodeTasks = std::make_unique<vkcore::WorkerPool::TaskGroup>(*m_workers);
+    }
+    ensureframes();
+
+    // 最粗一级的页覆盖整个纹理，它驻留后任何位置都有可采样的内容
+    std::vector<uint32_t> requests;
+    requestpage(packPage(VirtualPageId{0, 0, m_mipCount - 1}), 0, requests);
+    dispatchdecodes(requests);
+}
+
+VirtualTexture::~VirtualTexture()
+{
+    // 先等待解码任务：它们写入 m_decoded，并调用 m_provider
+    m_decodeTasks.reset();
+
+    // 析构时调用方已保证没有在途帧，直接销毁
+    m_deletionQueue = nullptr;
+    for (FrameResources &frame : m_frames)
+    {
+        releasebuffer(frame.tableStaging);
+        releasebuffer(frame.readback);
+    }
+    m_device.get().destroySampler(m_tableSampler);
+    m_device.get().destroySampler(m_atlasSampler);
+}
+
+// ==================== 帧循环 ====================
+
+void VirtualTexture::update()
+{
+    QTR_PROFILE_SCOPE("VirtualTexture::update");
+    ensureframes();
+    m_stats.uploadedPages = 0;
+    m_stats.evictedPages = 0;
+
+    // 1. 本槽位的反馈写于 framesInFlight 帧之前，beginFrame() 已等待那一帧完成
+    std::vector<uint32_t> requests;
+    FrameResources &frame = m_frames[m_timeline.getFrameSlot()];
+    if (frame.feedbackFrame != 0 && frame.feedbackFrame <= m_timeline.getRetiredFrame())
+    {
+        readfeedback(frame, requests);
+    }
+    frame.feedbackFrame = 0;
+    dispatchdecodes(requests);
+
+    // 2. 收集工作线程解码完成的页
+    {
+        std::lock_guard<std::mutex> lock(m_decodedMutex);
+        m_decoding -= static_cast<uint32_t>(m_decoded.size());
+        for (std::unique_ptr<DecodedPage> &decoded : m_decoded)
+        {
+            m_backlog.push_back(std::move(decoded));
+        }
+        m_decoded.clear();
+    }
+
+    // 3. 在每帧预算内分配槽位（必要时淘汰）并提交上传，其余留到下一帧
+    std::vector<std::unique_ptr<DecodedPage>> remaining;
+    std::vector<vk::Offset2D> newTiles;
+    for (std::unique_ptr<DecodedPage> &decoded : m_backlog)
+    {
+        if (!decoded->valid)
+        {
+            pageentry(unpackPage(decoded->page)).state = PageState::Missing;
+            ++m_stats.missingPages;
+            continue;
+        }
+        if (m_stats.uploadedPages >= m_settings.maxUploadsPerFrame || !uploadpage(*decoded, newTiles))
+        {
+            remaining.push_back(std::move(decoded));
+        }
+    }
+    m_backlog = std::move(remaining);
+
+    // 4. 稀疏图集：新用到的槽位先绑定内存，之后 addPasses() 才把页拷入
+    if (!newTiles.empty())
+    {
+        m_atlas->bindSparseTiles(m_device, newTiles, true);
+    }
+    if (m_stats.uploadedPages > 0)
+    {
+        m_uploads.flush();
+    }
+
+    uint32_t resident = 0;
+    for (const AtlasSlot &slot : m_slots)
+    {
+        resident += slot.page != kInvalidPage && pageentry(unpackPage(slot.page)).state == PageState::Resident;
+    }
+    m_stats.residentPages = resident;
+    m_stats.pendingDecodes = m_decoding + static_cast<uint32_t>(m_backlog.size());
+    m_stats.pendingUploads = static_cast<uint32_t>(m_pendingUploads.size());
+    if (m_atlas->isSparse())
+    {
+        m_stats.atlasBytes = m_atlas->getSparseTileSize() * m_atlas->getResidentTileCount();
+    }
+}
+
+VirtualTextureOutputs VirtualTexture::addPasses(rendercore::RDGBuilder &builder)
+{
+    QTR_PROFILE_SCOPE("VirtualTexture::addPasses");
+    ensureframes();
+    const uint32_t frameSlot = m_timeline.getFrameSlot();
+    const uint64_t frameNumber = m_timeline.getFrameNumber();
+    FrameResources &frame = m_frames[frameSlot];
+    frame.atlasCopies.clear();
+    frame.tableCopies.clear();
+
+    // 之前的帧在片段着色器中采样两张图像（readVirtualTexture），作为导入前的访问阶段声明：
+    // 本帧的上传拷贝（布局转换 + 写入）排在在途帧的采样之后，不会覆盖它们仍在读取的页表与槽位
+    VirtualTextureOutputs outputs;
+    outputs.pageTable = builder.registerExternalTexture(m_pageTable.get(), "VirtualPageTable", m_pageTableLayout,
+                                                        vk::PipelineStageFlagBits::eFragmentShader);
+    outputs.atlas = builder.registerExternalTexture(m_atlas.get(), "VirtualPageAtlas", m_atlasLayout,
+                                                    vk::PipelineStageFlagBits::eFragmentShader);
+
+    // 1. 上传完成的页：暂存区 -> 图集，同一个 Pass 内更新页表，之后的采样看到的映射与图集内容一致
+    std::vector<PendingUpload> remaining;
+    for (const PendingUpload &upload : m_pendingUploads)
+    {
+        if (!m_uploads.isComplete(upload.ticket))
+        {
+            remaining.push_back(upload);
+            continue;
+        }
+
+        vk::BufferImageCopy region{};
+        region.bufferOffset = upload.staging * m_pageBytes;
+        region.imageSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1);
+        const uint32_t slotX = upload.slot % m_settings.atlasPages;
+        const uint32_t slotY = upload.slot / m_settings.atlasPages;
+        region.imageOffset = vk::Offset3D(static_cast<int32_t>(slotX * m_settings.pageSize),
+                                          static_cast<int32_t>(slotY * m_settings.pageSize), 0);
+        region.imageExtent = vk::Extent3D{m_settings.pageSize, m_settings.pageSize, 1};
+        frame.atlasCopies.push_back(region);
+
+        // 本帧的拷贝退休后暂存位置才能复用
+        m_stagingRelease[upload.staging] = frameNumber;
+        const VirtualPageId page = unpackPage(upload.page);
+        pageentry(page).state = PageState::Resident;
+        mappage(page, upload.slot);
+    }
+    m_pendingUploads = std::move(remaining);
+
+    // 2. 改变的页表区域：从 CPU 镜像写入本帧的暂存区，再按区域拷贝到对应的 mip
+    auto *staging = static_cast<uint32_t *>(frame.tableStaging->getMappedData());
+    for (uint32_t mip = 0; mip < m_mipCount; ++mip)
+    {
+        MipRect &rect = m_dirty[mip];
+        if (rect.isEmpty())
+        {
+            continue;
+        }
+        const uint32_t width = pagesat(mip, false);
+        for (uint32_t y = rect.y0; y < rect.y1; ++y)
+        {
+            const size_t offset = m_mipOffsets[mip] + static_cast<size_t>(y) * width + rect.x0;
+            std::memcpy(staging + offset, m_tableMirror.data() + offset, (rect.x1 - rect.x0) * sizeof(uint32_t));
+        }
+
+        vk::BufferImageCopy region{};
+        region.bufferOffset = (m_mipOffsets[mip] + static_cast<size_t>(rect.y0) * width + rect.x0) * sizeof(uint32_t);
+        region.bufferRowLength = width;
+        region.imageSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, mip, 0, 1);
+        region.imageOffset = vk::Offset3D(static_cast<int32_t>(rect.x0), static_cast<int32_t>(rect.y0), 0);
+        region.imageExtent = vk::Extent3D{rect.x1 - rect.x0, rect.y1 - rect.y0, 1};
+        frame.tableCopies.push_back(region);
+        rect = MipRect{};
+    }
+    if (frame.atlasCopies.empty() && frame.tableCopies.empty())
+    {
+        return outputs;
+    }
+    frame.tableStaging->flush();
+
+    const rendercore::RDGBufferHandle pageStaging =
+        builder.registerExternalBuffer(m_pageStaging.get(), "VirtualPageStaging");
+    const rendercore::RDGBufferHandle tableStaging =
+        builder.registerExternalBuffer(frame.tableStaging.get(), "VirtualPageTableStaging");
+    builder
+        .addPass("VirtualTextureUpload",
+                 [this, frameSlot](vk::CommandBuffer cmd) {
+                     const FrameResources &frame = m_frames[frameSlot];
+                     if (!frame.atlasCopies.empty())
+                     {
+                         cmd.copyBufferToImage(m_pageStaging->get(), m_atlas->get(),
+                                               vk::ImageLayout::eTransferDstOptimal, frame.atlasCopies);
+                     }
+                     if (!frame.tableCopies.empty())
+                     {
+                         cmd.copyBufferToImage(frame.tableStaging->get(), m_pageTable->get(),
+                                               vk::ImageLayout::eTransferDstOptimal, frame.tableCopies);
+                     }
+                 })
+        .readBuffer(pageStaging, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferRead)
+        .readBuffer(tableStaging, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferRead)
+        .writeTexture(outputs.atlas, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite)
+        .writeTexture(outputs.pageTable, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite);
+    m_atlasLayout = vk::ImageLayout::eTransferDstOptimal;
+    m_pageTableLayout = vk::ImageLayout::eTransferDstOptimal;
+
+    return outputs;
+}
+
+void VirtualTexture::addFeedbackPass(rendercore::RDGBuilder &builder, vk::Extent2D renderExtent, FeedbackCallback draw)
+{
+    if (renderExtent.width == 0 || renderExtent.height == 0 || !draw)
+    {
+        throw std::invalid_argument("VirtualTexture::addFeedbackPass: empty extent or draw callback");
+    }
+    const uint64_t frameNumber = m_timeline.getFrameNumber();
+    if (m_feedbackBuilt == frameNumber)
+    {
+        throw std::runtime_error("VirtualTexture::addFeedbackPass: the feedback pass was already added this frame");
+    }
+    m_feedbackBuilt = frameNumber;
+    ensureframes();
+
+    const uint32_t frameSlot = m_timeline.getFrameSlot();
+    FrameResources &frame = m_frames[frameSlot];
+    const vk::Extent2D extent{divup(renderExtent.width, m_settings.feedbackScale),
+                              divup(renderExtent.height, m_settings.feedbackScale)};
+    const vk::DeviceSize bytes = static_cast<vk::DeviceSize>(extent.width) * extent.height * sizeof(uint32_t);
+    if (!frame.readback || frame.readback->getSize() < bytes)
+    {
+        // 随机访问标志使 VMA 选择 HOST_CACHED 内存，主机读取不经过写合并
+        releasebuffer(frame.readback);
+        vkcore::BufferDesc desc{};
+        desc.size = bytes;
+        desc.usageFlags = vk::BufferUsageFlagBits::eTransferDst;
+        desc.allocationCreateFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+        desc.category = vkcore::MemoryCategory::Staging;
+        desc.mapping = vkcore::BufferMapping::Persistent;
+        frame.readback = std::make_unique<vkcore::Buffer>("VirtualTextureReadback" + std::to_string(frameSlot),
+                                                          m_device, m_allocator, desc);
+    }
+    frame.feedbackExtent = extent;
+    frame.feedbackFrame = frameNumber;
+    frame.feedbackDraw = std::move(draw);
+
+    const rendercore::RDGTextureHandle feedback =
+        builder.createTexture2D("VirtualTextureFeedback", kFeedbackFormat, extent.width, extent.height,
+                                vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc);
+    const rendercore::RDGTextureHandle depth =
+        builder.createDepthBuffer("VirtualTextureFeedbackDepth", extent.width, extent.height, kFeedbackDepthFormat);
+    const vk::ClearColorValue clear(std::array<uint32_t, 4>{kInvalidPage, 0, 0, 0});
+    builder
+        .addPass("VirtualTextureFeedback",
+                 [this, frameSlot](vk::CommandBuffer cmd) {
+                     const FrameResources &frame = m_frames[frameSlot];
+                     frame.feedbackDraw(cmd, frame.feedbackExtent);
+                 })
+        .writeColorAttachment(feedback, vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore, clear)
+        .writeDepthAttachment(depth, vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare);
+
+    const rendercore::RDGBufferHandle readback =
+        builder.registerExternalBuffer(frame.readback.get(), "VirtualTextureReadback");
+    builder
+        .addPass("VirtualTextureReadback",
+                 [this, frameSlot, feedback](vk::CommandBuffer cmd, const rendercore::RDGResourceAccessor &res) {
+                     const FrameResources &frame = m_frames[frameSlot];
+                     vk::BufferImageCopy region{};
+                     region.imageSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1);
+                     region.imageExtent = vk::Extent3D{frame.feedbackExtent.width, frame.feedbackExtent.height, 1};
+                     cmd.copyImageToBuffer(res.getTexture(feedback)->get(), vk::ImageLayout::eTransferSrcOptimal,
+                                           frame.readback->get(), region);
+
+                     // 帧退休后主机直接读取映射，拷贝结果需要对主机可见
+                     const vk::MemoryBarrier toHost(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eHostRead);
+                     cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {},
+                                         toHost, nullptr, nullptr);
+                 })
+        .readTexture(feedback, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferRead)
+        .writeBuffer(readback, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite);
+}
+
+void VirtualTexture::readVirtualTexture(rendercore::RDGPass &pass, const VirtualTextureOutputs &outputs)
+{
+    pass.readTexture(outputs.pageTable, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead)
+        .readTexture(outputs.atlas, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead);
+    m_pageTableLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    m_atlasLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+}
+
+// ==================== 页与页表 ====================
+
+uint32_t VirtualTexture::pagesat(uint32_t mip, bool vertical) const
+{
+    const uint32_t count = vertical ? m_settings.pageCountY : m_settings.pageCountX;
+    return std::max(count >> mip, 1u);
+}
+
+VirtualTexture::PageEntry &VirtualTexture::pageentry(const VirtualPageId &page)
+{
+    return m_pages[m_mipOffsets[page.mip] + static_cast<size_t>(page.y) * pagesat(page.mip, false) + page.x];
+}
+
+uint32_t &VirtualTexture::tableentry(uint32_t mip, uint32_t x, uint32_t y)
+{
+    return m_tableMirror[m_mipOffsets[mip] + static_cast<size_t>(y) * pagesat(mip, false) + x];
+}
+
+void VirtualTexture::mappage(const VirtualPageId &page, uint32_t slot)
+{
+    const uint32_t value =
+        (slot % m_settings.atlasPages) | ((slot / m_settings.atlasPages) << 12) | (page.mip << 24);
+
+    // 页及其所有后代中，映射到更粗的页（或没有映射）的纹素改为指向这一页；已有更精细页驻留的保持不变
+    for (uint32_t mip = page.mip + 1; mip-- > 0;)
+    {
+        const uint32_t shift = page.mip - mip;
+        const uint32_t x0 = page.x << shift;
+        const uint32_t y0 = page.y << shift;
+        const uint32_t x1 = std::min((page.x + 1) << shift, pagesat(mip, false));
+        const uint32_t y1 = std::min((page.y + 1) << shift, pagesat(mip, true));
+        for (uint32_t y = y0; y < y1; ++y)
+        {
+            for (uint32_t x = x0; x < x1; ++x)
+            {
+                uint32_t &entry = tableentry(mip, x, y);
+                if (entry == kInvalidEntry || (entry >> 24) >= page.mip)
+                {
+                    entry = value;
+                }
+            }
+        }
+        markdirty(mip, x0, y0, x1, y1);
+    }
+}
+
+void VirtualTexture::unmappage(const VirtualPageId &page, uint32_t slot)
+{
+    const uint32_t value =
+        (slot % m_settings.atlasPages) | ((slot / m_settings.atlasPages) << 12) | (page.mip << 24);
+
+    // 父页的条目就是覆盖这一页的最精细祖先；最粗一级锁定不淘汰，不会走到没有父页的分支
+    const uint32_t fallback =
+        page.mip + 1 < m_mipCount ? tableentry(page.mip + 1, page.x >> 1, page.y >> 1) : kInvalidEntry;
+    for (uint32_t mip = page.mip + 1; mip-- > 0;)
+    {
+        const uint32_t shift = page.mip - mip;
+        const uint32_t x0 = page.x << shift;
+        const uint32_t y0 = page.y << shift;
+        const uint32_t x1 = std::min((page.x + 1) << shift, pagesat(mip, false));
+        const uint32_t y1 = std::min((page.y + 1) << shift, pagesat(mip, true));
+        for (uint32_t y = y0; y < y1; ++y)
+        {
+            for (uint32_t x = x0; x < x1; ++x)
+            {
+                uint32_t &entry = tableentry(mip, x, y);
+                if (entry == value)
+                {
+                    entry = fallback;
+                }
+            }
+        }
+        markdirty(mip, x0, y0, x1, y1);
+    }
+}
+
+void VirtualTexture::markdirty(uint32_t mip, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1)
+{
+    MipRect &rect = m_dirty[mip];
+    rect.x0 = std::min(rect.x0, x0);
+    rect.y0 = std::min(rect.y0, y0);
+    rect.x1 = std::max(rect.x1, x1);
+    rect.y1 = std::max(rect.y1, y1);
+}
+
+// ==================== 流送 ====================
+
+void VirtualTexture::readfeedback(FrameResources &frame, std::vector<uint32_t> &requests)
+{
+    QTR_PROFILE_SCOPE("VirtualTexture::readfeedback");
+    frame.readback->invalidate();
+    const auto *texels = static_cast<const uint32_t *>(frame.readback->getMappedData());
+    std::vector<uint32_t> ids(texels, texels + static_cast<size_t>(frame.feedbackExtent.width) *
+                                                   frame.feedbackExtent.height);
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    if (!ids.empty() && ids.back() == kInvalidPage)
+    {
+        ids.pop_back();
+    }
+    m_stats.requestedPages = static_cast<uint32_t>(ids.size());
+
+    const uint64_t frameNumber = m_timeline.getFrameNumber();
+    for (uint32_t id : ids)
+    {
+        requestpage(id, frameNumber, requests);
+    }
+}
+
+void VirtualTexture::requestpage(uint32_t packed, uint64_t frameNumber, std::vector<uint32_t> &requests)
+{
+    VirtualPageId page = unpackPage(packed);
+    if (page.mip >= m_mipCount || page.x >= pagesat(page.mip, false) || page.y >= pagesat(page.mip, true))
+    {
+        return; // 着色器与设置不一致时忽略越界的 ID
+    }
+
+    // 连同祖先一起请求和刷新使用时间：页驻留前页表回退到祖先，祖先必须先于它驻留、晚于它淘汰
+    while (true)
+    {
+        PageEntry &entry = pageentry(page);
+        if (entry.state == PageState::Resident || entry.state == PageState::Uploading)
+        {
+            AtlasSlot &slot = m_slots[entry.slot];
+            if (slot.lastUsed == frameNumber && frameNumber != 0)
+            {
+                return; // 本帧已经刷新过这一页（以及它的祖先）
+            }
+            slot.lastUsed = frameNumber;
+        }
+        else if (entry.state == PageState::NonResident)
+        {
+            entry.state = PageState::Decoding;
+            requests.push_back(packPage(page));
+        }
+
+        if (page.mip + 1 >= m_mipCount)
+        {
+            return;
+        }
+        page = VirtualPageId{page.x >> 1, page.y >> 1, page.mip + 1};
+    }
+}
+
+void VirtualTexture::dispatchdecodes(std::vector<uint32_t> &requests)
+{
+    // 粗的页先解码：覆盖范围大，也是更精细的页驻留前的回退
+    std::stable_sort(requests.begin(), requests.end(),
+                     [](uint32_t a, uint32_t b) { return unpackPage(a).mip > unpackPage(b).mip; });
+
+    const uint32_t limit = m_workers ? m_settings.maxPendingDecodes : m_settings.maxUploadsPerFrame;
+    const uint32_t inFlight = m_decoding + static_cast<uint32_t>(m_backlog.size());
+    const size_t budget = std::min<size_t>(requests.size(), limit > inFlight ? limit - inFlight : 0);
+    for (size_t i = 0; i < budget; ++i)
+    {
+        auto decoded = std::make_unique<DecodedPage>();
+        decoded->page = requests[i];
+        if (!m_workers)
+        {
+            decodepage(*decoded);
+            m_backlog.push_back(std::move(decoded));
+            continue;
+        }
+
+        ++m_decoding;
+        m_decodeTasks->run([this, raw = decoded.release()]() {
+            std::unique_ptr<DecodedPage> page(raw);
+            decodepage(*page);
+            std::lock_guard<std::mutex> lock(m_decodedMutex);
+            m_decoded.push_back(std::move(page));
+        });
+    }
+
+    // 超出预算的请求退回未驻留，下一次反馈仍请求时再调度
+    for (size_t i = budget; i < requests.size(); ++i)
+    {
+        pageentry(unpackPage(requests[i])).state = PageState::NonResident;
+    }
+}
+
+void VirtualTexture::decodepage(DecodedPage &decoded) const
+{
+    decoded.texels.resize(static_cast<size_t>(m_pageBytes));
+    try
+    {
+        decoded.valid = m_provider(unpackPage(decoded.page), decoded.texels);
+    }
+    catch (const std::exception &error)
+    {
+        QTR_LOG_WARN("VirtualTexture", "页解码失败：" << error.what());
+        decoded.valid = false;
+    }
+    if (!decoded.valid)
+    {
+        decoded.texels.clear();
+        decoded.texels.shrink_to_fit();
+    }
+}
+
+bool VirtualTexture::uploadpage(DecodedPage &decoded, std::vector<vk::Offset2D> &newTiles)
+{
+    uint32_t staging = 0;
+    uint32_t slot = 0;
+    if (!allocatestaging(staging) || !allocateslot(slot))
+    {
+        return false;
+    }
+
+    const VirtualPageId page = unpackPage(decoded.page);
+    AtlasSlot &atlasSlot = m_slots[slot];
+    atlasSlot.page = decoded.page;
+    atlasSlot.lastUsed = m_timeline.getFrameNumber();
+    atlasSlot.locked = page.mip + 1 == m_mipCount;
+    if (!atlasSlot.bound)
+    {
+        // 稀疏图块整除页尺寸，槽位覆盖整数个图块
+        const uint32_t tilesX = m_settings.pageSize / m_atlas->getSparseTileExtent().width;
+        const uint32_t tilesY = m_settings.pageSize / m_atlas->getSparseTileExtent().height;
+        const uint32_t originX = slot % m_settings.atlasPages * tilesX;
+        const uint32_t originY = slot / m_settings.atlasPages * tilesY;
+        for (uint32_t y = 0; y < tilesY; ++y)
+        {
+            for (uint32_t x = 0; x < tilesX; ++x)
+            {
+                newTiles.emplace_back(static_cast<int32_t>(originX + x), static_cast<int32_t>(originY + y));
+            }
+        }
+        atlasSlot.bound = true;
+    }
+
+    PageEntry &entry = pageentry(page);
+    entry.state = PageState::Uploading;
+    entry.slot = slot;
+
+    m_stagingRelease[staging] = UINT64_MAX;
+    const vkcore::UploadTicket ticket =
+        m_uploads.uploadBuffer(m_pageStaging, decoded.texels.data(), m_pageBytes, staging * m_pageBytes);
+    m_pendingUploads.push_back(PendingUpload{decoded.page, slot, staging, ticket});
+    ++m_stats.uploadedPages;
+    return true;
+}
+
+bool VirtualTexture::allocateslot(uint32_t &slot)
+{
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        return true;
+    }
+
+    // LRU：淘汰最久未被请求的已驻留页；最近一次读回的反馈仍在请求的页（lastUsed 为本帧）不淘汰
+    const uint64_t frameNumber = m_timeline.getFrameNumber();
+    uint32_t victim = UINT32_MAX;
+    uint64_t oldest = frameNumber;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_slots.size()); ++i)
+    {
+        const AtlasSlot &candidate = m_slots[i];
+        if (candidate.locked || candidate.page == kInvalidPage || candidate.lastUsed >= oldest ||
+            pageentry(unpackPage(candidate.page)).state != PageState::Resident)
+        {
+            continue;
+        }
+        victim = i;
+        oldest = candidate.lastUsed;
+    }
+    if (victim == UINT32_MAX)
+    {
+        return false;
+    }
+
+    // 页表改为指向祖先。页表只有一张，在队列内按顺序覆盖：之前提交的帧在覆盖前完成采样（导入声明的片段着色器阶段
+    // 使上传 Pass 的屏障等待它们），之后的帧只看到新映射，不存在按旧映射采样已换出槽位的帧
+    AtlasSlot &evicted = m_slots[victim];
+    const VirtualPageId page = unpackPage(evicted.page);
+    unmappage(page, victim);
+    pageentry(page).state = PageState::NonResident;
+    evicted.page = kInvalidPage;
+    ++m_stats.evictedPages;
+    slot = victim;
+    return true;
+}
+
+bool VirtualTexture::allocatestaging(uint32_t &staging)
+{
+    const uint64_t retired = m_timeline.getRetiredFrame();
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_stagingRelease.size()); ++i)
+    {
+        if (m_stagingRelease[i] <= retired)
+        {
+            staging = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ==================== 资源 ====================
+
+void VirtualTexture::ensureframes()
+{
+    const uint32_t count = m_timeline.getFramesInFlight();
+    if (m_frames.size() == count)
+    {
+        return;
+    }
+
+    // 在途帧数改变（调用方已等待设备空闲）：重建每帧资源，未读的反馈直接丢弃
+    for (FrameResources &frame : m_frames)
+    {
+        releasebuffer(frame.tableStaging);
+        releasebuffer(frame.readback);
+    }
+    m_frames.clear();
+    m_frames.resize(count);
+
+    vkcore::BufferDesc desc{};
+    desc.size = m_tableMirror.size() * sizeof(uint32_t);
+    desc.usageFlags = vk::BufferUsageFlagBits::eTransferSrc;
+    desc.category = vkcore::MemoryCategory::Staging;
+    desc.mapping = vkcore::BufferMapping::Persistent;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        m_frames[i].tableStaging = std::make_unique<vkcore::Buffer>("VirtualPageTableStaging" + std::to_string(i),
+                                                                    m_device, m_allocator, desc);
+    }
+
+    // 新的暂存区只包含之后写入的区域，整张页表重新上传一次
+    for (uint32_t mip = 0; mip < m_mipCount; ++mip)
+    {
+        markdirty(mip, 0, 0, pagesat(mip, false), pagesat(mip, true));
+    }
+}
+
+void VirtualTexture::releasebuffer(std::unique_ptr<vkcore::Buffer> &buffer)
+{
+    if (m_deletionQueue && buffer)
+    {
+        std::shared_ptr<vkcore::Buffer> retired = std::move(buffer);
+        m_deletionQueue->enqueue([retired]() mutable { retired.reset(); });
+    }
+    buffer.reset();
+}
+
+} // namespace renderer
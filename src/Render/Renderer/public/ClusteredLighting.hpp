@@ -0,0 +1,238 @@
+/**
+ * @file ClusteredLighting.hpp
+ * @brief 分簇前向着色（Clustered Forward+）的光源打包与分簇剔除
+ * @details 场景中的光源打包为 SoA 布局的存储缓冲（位置/范围、颜色/类型、方向/外锥角、衰减/内锥角各占一段连续数组），
+ *          只有光照列表或某个 Light 的版本变化时才重新打包上传。每帧一个计算 Pass 把点光源与聚光灯分配到
+ *          以摄像机参数划分的 3D 视锥体素（froxel）网格中：屏幕按 kGridX x kGridY 分块，深度在近远平面之间按
+ *          指数划分为 kGridZ 片，每个簇写出至多 kMaxLightsPerCluster 个光源索引。
+ *          片段着色器包含 clustered_lighting.glsl，按片段所在的簇只遍历该簇的光源；平行光不参与分簇，始终全部遍历。
+ */
+
+#pragma once
+
+#include "RenderGraph/public/RDGBuilder.hpp"
+#include "Scene/public/Camera.hpp"
+#include "Scene/public/Scene.hpp"
+#include "VulkanCore/public/Descriptor.hpp"
+#include "VulkanCore/public/Pipeline.hpp"
+#include "VulkanCore/public/VKResource.hpp"
+#include <glm/glm.hpp>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace rendercore
+{
+class RDGResourceAccessor;
+} // namespace rendercore
+
+namespace renderer
+{
+
+/**
+ * @brief 打包后的光源类型（存放在 colorType.w 中）
+ */
+enum class GPULightType : uint32_t
+{
+    Directional = 0,
+    Point = 1,
+    Spot = 2
+};
+
+/**
+ * @struct GPUClusterParams
+ * @brief 分簇计算与片段着色共享的每帧参数（std140 uniform，与 cluster_lights.comp / clustered_lighting.glsl 一致）
+ */
+struct GPUClusterParams
+{
+    glm::mat4 view;              ///< 视图矩阵
+    glm::mat4 inverseProjection; ///< 投影矩阵的逆
+    glm::uvec4 gridSize;         ///< xyz 为簇网格尺寸，w 为每簇最大光源数
+    glm::vec2 screenSize;        ///< 渲染目标尺寸（像素）
+    float zNear;                 ///< 近平面距离
+    float zFar;                  ///< 远平面距离
+    uint32_t directionalCount;   ///< 平行光数量（位于光源数组开头）
+    uint32_t localCount;         ///< 点光源与聚光灯数量（紧随平行光之后）
+    uint32_t lightCapacity;      ///< 光源缓冲每段数组的容量
+    uint32_t padding;            ///< 对齐到 16 字节
+};
+
+/**
+ * @struct ClusteredLightingView
+ * @brief 一次分簇使用的视图
+ */
+struct ClusteredLightingView
+{
+    glm::mat4 view{1.0f};       ///< 视图矩阵
+    glm::mat4 projection{1.0f}; ///< 投影矩阵
+    float zNear{0.1f};          ///< 近平面距离
+    float zFar{100.0f};         ///< 远平面距离
+    uint32_t width{1};          ///< 渲染目标宽度
+    uint32_t height{1};         ///< 渲染目标高度
+
+    /**
+     * @brief 由摄像机与渲染目标尺寸构造
+     */
+    static ClusteredLightingView fromCamera(const rendercore::Camera &camera, uint32_t width, uint32_t height);
+};
+
+/**
+ * @struct ClusteredLightingOutputs
+ * @brief 分簇 Pass 产生的 RDG 资源
+ */
+struct ClusteredLightingOutputs
+{
+    rendercore::RDGBufferHandle lights = rendercore::kInvalidBufferHandle;        ///< SoA 光源缓冲
+    rendercore::RDGBufferHandle clusterCounts = rendercore::kInvalidBufferHandle; ///< 每簇光源数量
+    rendercore::RDGBufferHandle clusterLights = rendercore::kInvalidBufferHandle; ///< 每簇光源索引（定长槽位）
+    uint32_t frameIndex{0};                                                       ///< 在途帧索引
+};
+
+/**
+ * @class ClusteredLighting
+ * @brief 分簇光照的帧间状态
+ * @details 每个在途帧持有一份映射的光源缓冲、参数缓冲与描述符集（计算与片段阶段共用同一布局），
+ *          簇计数与索引缓冲是 RDG 瞬态资源。片段着色器的管线布局需在 clustered_lighting.glsl 约定的集合位置
+ *          包含 getSetLayout()，并在绘制时绑定 getDescriptorSet()。
+ *
+ * - 单个簇的光源超过 kMaxLightsPerCluster 时多出的光源被丢弃（着色结果偏暗而不是越界）；
+ * - 聚光灯以其影响范围的包围球参与分簇；
+ * - 光源数超过构造时的容量时重建光源缓冲（容量翻倍）。
+ *
+ * @example
+ * @code
+ * clusteredLighting.update(scene, frameIndex);
+ * auto lighting = clusteredLighting.addPasses(builder, frameIndex,
+ *                                             renderer::ClusteredLightingView::fromCamera(*camera, width, height));
+ * auto &draw = builder.addPass("ForwardPass", [&](vk::CommandBuffer cmd, const rendercore::RDGResourceAccessor &res) {
+ *     pipeline->bind(cmd);
+ *     vk::DescriptorSet lightingSet = clusteredLighting.getDescriptorSet(lighting);
+ *     cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline->getLayout(), 1, lightingSet, nullptr);
+ *     // 绘制...
+ * });
+ * draw.writeColorAttachment(backBuffer);
+ * clusteredLighting.readLightBuffers(draw, lighting);
+ * @endcode
+ */
+class ClusteredLighting
+{
+  public:
+    static constexpr uint32_t kGridX = 16;                ///< 屏幕水平方向的簇数
+    static constexpr uint32_t kGridY = 9;                 ///< 屏幕垂直方向的簇数
+    static constexpr uint32_t kGridZ = 24;                ///< 深度方向的簇数（指数划分）
+    static constexpr uint32_t kMaxLightsPerCluster = 128; ///< 每个簇的最大光源数
+    static constexpr uint32_t kWorkgroupSize = 64;        ///< 需与 cluster_lights.comp 的 local_size_x 一致
+    static constexpr uint32_t kClusterCount = kGridX * kGridY * kGridZ;
+
+    /**
+     * @brief 构造函数
+     * @param device 逻辑设备
+     * @param allocator VMA 分配器
+     * @param layoutCache 描述符布局缓存
+     * @param clusterShader cluster_lights.comp 编译得到的计算着色器
+     * @param framesInFlight 在途帧数量
+     * @param initialCapacity 光源缓冲的初始容量
+     * @throws std::invalid_argument 如果 framesInFlight 或 initialCapacity 为 0
+     */
+    ClusteredLighting(vkcore::Device &device, VmaAllocator allocator, vkcore::DescriptorLayoutCache &layoutCache,
+                      std::shared_ptr<vkcore::ShaderModule> clusterShader, uint32_t framesInFlight,
+                      uint32_t initialCapacity = 256);
+    ~ClusteredLighting();
+
+    /** 禁用拷贝与移动 */
+    ClusteredLighting(const ClusteredLighting &) = delete;
+    ClusteredLighting &operator=(const ClusteredLighting &) = delete;
+
+    /**
+     * @brief 同步场景光源到第 frameIndex 帧的光源缓冲
+     * @param scene 场景
+     * @param frameIndex 在途帧索引（调用方保证该帧之前的 GPU 工作已完成）
+     * @details 光照列表版本与所有光源的版本都未变化时不重新打包；该帧缓冲已是最新时不上传
+     */
+    void update(const rendercore::Scene &scene, uint32_t frameIndex);
+
+    /**
+     * @brief 向渲染图添加分簇计算 Pass
+     * @param builder 当前帧的渲染图构建器
+     * @param frameIndex 在途帧索引（与 update() 相同）
+     * @param view 分簇视图
+     * @return ClusteredLightingOutputs 供着色 Pass 读取的资源句柄
+     */
+    ClusteredLightingOutputs addPasses(rendercore::RDGBuilder &builder, uint32_t frameIndex,
+                                       const ClusteredLightingView &view);
+
+    /**
+     * @brief 为着色 Pass 声明对光源与簇缓冲的读取（片段着色器阶段）
+     */
+    void readLightBuffers(rendercore::RDGPass &pass, const ClusteredLightingOutputs &outputs) const;
+
+    /**
+     * @brief 获取该帧的光照描述符集（在分簇 Pass 执行时写入，着色 Pass 中绑定）
+     */
+    vk::DescriptorSet getDescriptorSet(const ClusteredLightingOutputs &outputs) const;
+
+    /**
+     * @brief 获取光照描述符集布局（计算与片段阶段可见）
+     */
+    vk::DescriptorSetLayout getSetLayout() const
+    {
+        return m_setLayout;
+    }
+
+    /**
+     * @brief 获取打包的平行光数量
+     */
+    uint32_t getDirectionalLightCount() const
+    {
+        return m_directionalCount;
+    }
+
+    /**
+     * @brief 获取打包的点光源与聚光灯数量
+     */
+    uint32_t getLocalLightCount() const
+    {
+        return m_localCount;
+    }
+
+  private:
+    /**
+     * @struct FrameResources
+     * @brief 每个在途帧独占的缓冲与描述符集
+     */
+    struct FrameResources
+    {
+        std::unique_ptr<vkcore::Buffer> lightBuffer;  ///< SoA 光源缓冲（主机可见、常驻映射）
+        std::unique_ptr<vkcore::Buffer> paramsBuffer; ///< 每帧参数
+        vk::DescriptorSet descriptorSet;              ///< 计算与片段阶段共用
+        uint64_t lightsVersion{0};                    ///< 光源缓冲中数据的版本（0 表示从未写入）
+    };
+
+    bool lightschanged(const rendercore::Scene &scene) const;
+    void packlights(const rendercore::Scene &scene);
+    void uploadlights(FrameResources &frame);
+
+  private:
+    vkcore::Device &m_device;
+    VmaAllocator m_allocator;
+
+    std::unique_ptr<vkcore::Pipeline> m_pipeline;
+    vk::DescriptorSetLayout m_setLayout;
+    std::unique_ptr<vkcore::DescriptorAllocator> m_descriptorAllocator;
+
+    std::vector<FrameResources> m_frames;
+
+    // CPU 侧 SoA 镜像（每段 m_capacity 个 vec4）
+    std::vector<glm::vec4> m_packed;
+    uint32_t m_capacity{0};
+    uint32_t m_directionalCount{0};
+    uint32_t m_localCount{0};
+
+    // 变化检测：上次打包时的光照列表版本与每个光源的版本
+    const rendercore::Scene *m_scene{nullptr};
+    uint64_t m_sceneLightsVersion{0};
+    std::vector<std::pair<const rendercore::Light *, uint64_t>> m_lightVersions;
+    uint64_t m_lightsVersion{0}; ///< CPU 侧镜像版本
+};
+
+} // namespace renderer
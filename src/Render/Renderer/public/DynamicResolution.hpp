@@ -0,0 +1,124 @@
+/**
+ * @file DynamicResolution.hpp
+ * @brief 由 GPU 帧时间驱动的动态分辨率控制器
+ * @details 每帧读取 RDGProfiler 最新读回的整帧 GPU 耗时，与目标预算比较后调整渲染缩放：
+ *          超出预算时按“耗时与像素数成正比”的模型一次降到预计满足预算的缩放，
+ *          明显低于预算时每次只提高一个步长。两个阈值之间不调整，每次调整后冷却若干帧
+ *          （计时滞后 framesInFlight 帧，冷却期间读到的仍是旧缩放下的耗时），缩放因此不会来回抖动。
+ *          缩放量化到固定步长，RDGExtentClass::Scaled 纹理只有少数几种尺寸，跨帧瞬态分配器可以复用。
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace rendercore
+{
+class RDGProfiler;
+} // namespace rendercore
+
+namespace renderer
+{
+
+/**
+ * @class DynamicResolution
+ * @brief 渲染缩放控制器（不持有 GPU 资源）
+ *
+ * @example
+ * @code
+ * renderer::DynamicResolution resolution; // 默认 60 Hz 预算
+ *
+ * // 每帧构建渲染图之前
+ * builder.setRenderScale(resolution.update(profiler));
+ * rendercore::RDGTextureDesc colorDesc("SceneColor", format, outputWidth, outputHeight, usage);
+ * colorDesc.extentClass = rendercore::RDGExtentClass::Scaled;
+ * auto sceneColor = builder.createTexture(colorDesc);
+ * // ... 以 builder.getScaledExtent(output) 为视口绘制场景，最后由 Upscaler 放大到交换链 ...
+ * @endcode
+ */
+class DynamicResolution
+{
+  public:
+    /**
+     * @struct Config
+     * @brief 预算与滞回参数
+     */
+    struct Config
+    {
+        double targetMs = 15.5;          ///< GPU 帧时间预算（60 Hz 的 16.7 ms 留出合成与呈现的余量）
+        float minScale = 0.5f;           ///< 最小缩放（各轴）
+        float maxScale = 1.0f;           ///< 最大缩放（各轴）
+        float step = 0.05f;              ///< 缩放量化步长
+        double downscaleThreshold = 1.0; ///< 平均耗时超过 targetMs * 该值时降低分辨率
+        double upscaleThreshold = 0.8;   ///< 平均耗时低于 targetMs * 该值时提高分辨率
+        uint32_t cooldownFrames = 8;     ///< 每次调整后至少等待的新计时帧数（应大于 framesInFlight）
+        double smoothing = 0.25;         ///< 帧时间指数滑动平均的权重
+    };
+
+    /**
+     * @brief 构造函数（使用默认 Config）
+     */
+    DynamicResolution();
+
+    /**
+     * @brief 构造函数
+     * @param config 预算与滞回参数
+     * @throws std::invalid_argument 如果缩放范围、步长、阈值或平滑权重无效
+     */
+    explicit DynamicResolution(const Config &config);
+
+    /**
+     * @brief 以一帧新的 GPU 耗时更新缩放
+     * @param gpuMs 整帧 GPU 耗时（毫秒）
+     * @return 更新后的缩放
+     */
+    float update(double gpuMs);
+
+    /**
+     * @brief 读取 RDGProfiler 最新读回的帧并更新缩放（同一帧的结果只计入一次）
+     * @return 更新后的缩放（尚无新结果时保持不变）
+     */
+    float update(const rendercore::RDGProfiler &profiler);
+
+    /**
+     * @brief 获取当前缩放
+     */
+    float getScale() const
+    {
+        return m_scale;
+    }
+
+    /**
+     * @brief 获取平滑后的 GPU 帧时间（毫秒，尚无样本时为 0）
+     */
+    double getAverageGpuMs() const
+    {
+        return m_averageMs;
+    }
+
+    /**
+     * @brief 获取配置
+     */
+    const Config &getConfig() const
+    {
+        return m_config;
+    }
+
+    /**
+     * @brief 重置到最大缩放并清空统计（切换场景、改变目标帧率时）
+     */
+    void reset();
+
+  private:
+    float quantize(float scale) const;
+
+  private:
+    Config m_config;
+    float m_scale{1.0f};
+    double m_averageMs{0.0};
+    uint64_t m_samples{0};
+    uint32_t m_cooldown{0};
+    uint64_t m_lastProfilerFrame{0}; ///< 最近计入的 RDGFrameTiming::frameIndex
+};
+
+} // namespace renderer
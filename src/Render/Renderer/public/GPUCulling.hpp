@@ -0,0 +1,270 @@
+/**
+ * @file GPUCulling.hpp
+ * @brief GPU 驱动的剔除与间接绘制
+ * @details 每个渲染对象的数据（世界矩阵、包围盒、材质索引）常驻在持久 SSBO 中，
+ *          计算 Pass 在 GPU 上执行视锥与 Hi-Z 遮挡剔除，直接写出 VkDrawIndexedIndirectCommand 与计数缓冲，
+ *          绘制 Pass 以 vkCmdDrawIndexedIndirectCount 消费，CPU 端每帧的开销与对象数量无关。
+ */
+
+#pragma once
+
+#include "RenderGraph/public/RDGBuilder.hpp"
+#include "Scene/public/Scene.hpp"
+#include "VulkanCore/public/Descriptor.hpp"
+#include "VulkanCore/public/Pipeline.hpp"
+#include "VulkanCore/public/VKResource.hpp"
+#include <glm/glm.hpp>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace rendercore
+{
+class RDGResourceAccessor;
+struct Mesh;
+struct Material;
+} // namespace rendercore
+
+namespace renderer
+{
+
+/**
+ * @struct GPUObjectData
+ * @brief 持久对象缓冲中的一项（std430 布局，128 字节）
+ * @details 与 gpu_cull.comp / 顶点着色器中的 ObjectData 一一对应；
+ *          间接命令的 firstInstance 为对象索引，顶点着色器以 objects[gl_InstanceIndex] 取世界矩阵
+ */
+struct GPUObjectData
+{
+    glm::mat4 world;         ///< 世界矩阵
+    glm::vec4 boundsCenter;  ///< 世界空间包围盒中心（w 未使用）
+    glm::vec4 boundsExtents; ///< 世界空间包围盒半尺寸（w 未使用）
+    uint32_t materialIndex;  ///< 材质索引（bindless 材质为全局材质 ID，否则对应 GPUCulling::getMaterials()）
+    uint32_t batchIndex;     ///< 所属批次，即计数缓冲中的槽位
+    uint32_t commandOffset;  ///< 批次在命令缓冲中的起始命令索引
+    uint32_t indexCount;     ///< 索引数量
+    uint32_t firstIndex;     ///< 起始索引
+    int32_t vertexOffset;    ///< 顶点偏移
+    uint32_t padding[2];     ///< 对齐到 16 字节
+};
+static_assert(sizeof(GPUObjectData) == 128, "GPUObjectData must match the std430 layout in gpu_cull.comp");
+
+/**
+ * @struct GPUCullParams
+ * @brief 剔除计算着色器的每帧参数（std140 uniform）
+ */
+struct GPUCullParams
+{
+    glm::mat4 viewProjection;    ///< projection * view
+    glm::mat4 hiZViewProjection; ///< 生成 Hi-Z 时的 projection * view（遮挡测试按它投影）
+    glm::vec4 frustumPlanes[6];  ///< 世界空间视锥平面，顺序同 rendercore::Frustum::Plane
+    glm::vec2 hiZSize;           ///< Hi-Z 第 0 级尺寸（像素）
+    uint32_t hiZMipCount;        ///< Hi-Z mip 级数
+    uint32_t objectCount;        ///< 对象数量
+    uint32_t flags;              ///< GPUCullFlags 的组合
+    uint32_t padding[3];         ///< 对齐到 16 字节
+};
+
+/**
+ * @brief GPUCullParams::flags 的取值
+ */
+enum GPUCullFlags : uint32_t
+{
+    GPUCullFrustum = 1u << 0,  ///< 视锥剔除
+    GPUCullOcclusion = 1u << 1 ///< Hi-Z 遮挡剔除
+};
+
+/**
+ * @struct GPUDrawBatch
+ * @brief 共享同一对顶点/索引缓冲的一组对象
+ * @details 几何池中同一 Arena 的网格共享缓冲与顶点格式，不同网格通过命令中的 firstIndex/vertexOffset 区分；
+ *          对象缓冲按批次连续排列，批次 i 的命令占据 [firstObject, firstObject + objectCount)，
+ *          可见数量写在计数缓冲的第 i 个 uint32 中
+ */
+struct GPUDrawBatch
+{
+    vkcore::Buffer *vertexBuffer{nullptr};                                     ///< 顶点缓冲（非拥有）
+    vkcore::Buffer *indexBuffer{nullptr};                                      ///< 索引缓冲（非拥有）
+    vk::IndexType indexType{vk::IndexType::eUint32};                           ///< 索引类型（同一 Arena 的网格相同）
+    rendercore::VertexFormat vertexFormat{rendercore::VertexFormat::Standard}; ///< 顶点格式（同一 Arena 的网格相同）
+    uint32_t firstObject{0};                                                   ///< 批次在对象缓冲 / 命令缓冲中的起始索引
+    uint32_t objectCount{0};                                                   ///< 批次内对象数量（即最大绘制数量）
+};
+
+/**
+ * @struct GPUCullView
+ * @brief 一次剔除使用的视图
+ */
+struct GPUCullView
+{
+    glm::mat4 viewProjection{1.0f};                                       ///< projection * view
+    rendercore::RDGTextureHandle hiZ = rendercore::kInvalidTextureHandle; ///< Hi-Z 金字塔（无效时不做遮挡剔除）
+    uint32_t hiZWidth{0};                                                 ///< Hi-Z 第 0 级宽度
+    uint32_t hiZHeight{0};                                                ///< Hi-Z 第 0 级高度
+    uint32_t hiZMipCount{0};                                              ///< Hi-Z mip 级数
+    std::optional<glm::mat4> hiZViewProjection;                           ///< 生成 Hi-Z 时的矩阵（空则同 viewProjection）
+};
+
+/**
+ * @struct GPUCullOutputs
+ * @brief 剔除 Pass 产生的 RDG 资源
+ */
+struct GPUCullOutputs
+{
+    rendercore::RDGBufferHandle objects = rendercore::kInvalidBufferHandle;  ///< 对象缓冲（顶点着色器读取）
+    rendercore::RDGBufferHandle commands = rendercore::kInvalidBufferHandle; ///< 间接绘制命令
+    rendercore::RDGBufferHandle counts = rendercore::kInvalidBufferHandle;   ///< 每批次可见数量
+};
+
+/**
+ * @class GPUCulling
+ * @brief GPU 剔除与间接绘制的帧间状态
+ * @details 每个在途帧持有一份映射的对象缓冲与参数缓冲，只有场景数据版本变化时才重写对象缓冲；
+ *          剔除 Pass 在 RDG 中依次执行清零计数与一次 64 线程一组的计算分发。
+ *          需要启用 drawIndirectCount（Vulkan 1.2）与 drawIndirectFirstInstance、multiDrawIndirect 特性。
+ *
+ * Hi-Z 约定：每个纹素存放其覆盖区域内的最远深度（深度测试为 LESS），采样器为最近点夹取。
+ * 使用上一帧的金字塔（两阶段遮挡剔除的第一阶段，见 HiZPyramid）时把 GPUCullView::hiZViewProjection
+ * 设为生成它的矩阵，包围盒按该矩阵重投影到金字塔上。
+ *
+ * @example
+ * @code
+ * gpuCulling.update(scene, frameIndex);
+ * auto culled = gpuCulling.addPasses(builder, frameIndex, {proj * view});
+ * auto &draw = builder.addPass("ForwardPass", [&](vk::CommandBuffer cmd, const rendercore::RDGResourceAccessor &res) {
+ *     pipeline->bind(cmd);
+ *     // 绑定包含 res.getBuffer(culled.objects) 的描述符集
+ *     gpuCulling.recordDraws(cmd, res, culled);
+ * });
+ * draw.writeColorAttachment(backBuffer);
+ * gpuCulling.readDrawBuffers(draw, culled);
+ * @endcode
+ */
+class GPUCulling
+{
+  public:
+    /** 每个工作组的线程数，需与 gpu_cull.comp 的 local_size_x 一致 */
+    static constexpr uint32_t kWorkgroupSize = 64;
+
+    /**
+     * @brief 构造函数
+     * @param device 逻辑设备
+     * @param allocator VMA 分配器
+     * @param layoutCache 描述符布局缓存
+     * @param cullShader gpu_cull.comp 编译得到的计算着色器
+     * @param framesInFlight 在途帧数量
+     * @throws std::invalid_argument 如果 framesInFlight 为 0
+     */
+    GPUCulling(vkcore::Device &device, VmaAllocator allocator, vkcore::DescriptorLayoutCache &layoutCache,
+               std::shared_ptr<vkcore::ShaderModule> cullShader, uint32_t framesInFlight);
+    ~GPUCulling();
+
+    /** 禁用拷贝与移动 */
+    GPUCulling(const GPUCulling &) = delete;
+    GPUCulling &operator=(const GPUCulling &) = delete;
+
+    /**
+     * @brief 同步场景数据到第 frameIndex 帧的对象缓冲
+     * @param scene 场景
+     * @param frameIndex 在途帧索引（调用方保证该帧之前的 GPU 工作已完成）
+     * @details 场景版本未变化且该帧缓冲已是最新时不做任何事
+     */
+    void update(rendercore::Scene &scene, uint32_t frameIndex);
+
+    /**
+     * @brief 使缓存的批次失效（几何池整理后网格的缓冲与偏移已改变），下次 update() 全部重建
+     */
+    void invalidateGeometry()
+    {
+        m_scene = nullptr;
+    }
+
+    /**
+     * @brief 向渲染图添加清零计数与剔除计算 Pass
+     * @param builder 当前帧的渲染图构建器
+     * @param frameIndex 在途帧索引（与 update() 相同）
+     * @param view 剔除视图
+     * @return GPUCullOutputs 供绘制 Pass 读取的资源句柄
+     */
+    GPUCullOutputs addPasses(rendercore::RDGBuilder &builder, uint32_t frameIndex, const GPUCullView &view);
+
+    /**
+     * @brief 为绘制 Pass 声明对间接命令、计数与对象缓冲的读取
+     * @param pass 绘制 Pass
+     * @param outputs addPasses() 的返回值
+     */
+    void readDrawBuffers(rendercore::RDGPass &pass, const GPUCullOutputs &outputs) const;
+
+    /**
+     * @brief 录制所有批次的间接绘制（需已绑定图形管线与描述符集）
+     * @param cmd 命令缓冲
+     * @param resources 绘制 Pass 的资源访问器
+     * @param outputs addPasses() 的返回值
+     */
+    void recordDraws(vk::CommandBuffer cmd, const rendercore::RDGResourceAccessor &resources,
+                     const GPUCullOutputs &outputs) const;
+
+    /**
+     * @brief 获取批次列表（update() 之后有效）
+     */
+    const std::vector<GPUDrawBatch> &getBatches() const
+    {
+        return m_batches;
+    }
+
+    /**
+     * @brief 获取材质表，非 bindless 材质的 GPUObjectData::materialIndex 即其中的索引（update() 之后有效）
+     */
+    const std::vector<rendercore::Material *> &getMaterials() const
+    {
+        return m_materials;
+    }
+
+    /**
+     * @brief 获取对象数量
+     */
+    uint32_t getObjectCount() const
+    {
+        return static_cast<uint32_t>(m_objects.size());
+    }
+
+  private:
+    /**
+     * @struct FrameResources
+     * @brief 每个在途帧独占的缓冲与描述符集
+     */
+    struct FrameResources
+    {
+        std::unique_ptr<vkcore::Buffer> objectBuffer; ///< 持久对象缓冲（主机可见、常驻映射）
+        std::unique_ptr<vkcore::Buffer> paramsBuffer; ///< 剔除参数
+        vk::DescriptorSet descriptorSet;              ///< 剔除着色器的描述符集
+        uint64_t objectsVersion{0};                   ///< 对象缓冲中数据的版本（0 表示从未写入）
+    };
+
+    void rebuildbatches(const rendercore::SceneStorage &storage);
+    void rebuildobjects(rendercore::Scene &scene);
+    void uploadobjects(FrameResources &frame);
+
+  private:
+    vkcore::Device &m_device;
+    VmaAllocator m_allocator;
+
+    std::unique_ptr<vkcore::Pipeline> m_pipeline;
+    vk::DescriptorSetLayout m_setLayout;
+    std::unique_ptr<vkcore::DescriptorAllocator> m_descriptorAllocator;
+    std::unique_ptr<vkcore::Image> m_dummyHiZ; ///< 未提供 Hi-Z 时绑定的 1x1 占位纹理
+
+    std::vector<FrameResources> m_frames;
+
+    // CPU 侧镜像（场景版本变化时重建）
+    std::vector<GPUObjectData> m_objects;
+    std::vector<uint32_t> m_objectOrder; ///< 对象缓冲索引 -> 渲染对象索引（按批次排列）
+    std::vector<GPUDrawBatch> m_batches;
+    std::vector<rendercore::Material *> m_materials;
+    const rendercore::Scene *m_scene{nullptr}; ///< 上次同步的场景（切换场景时全部重建）
+    uint64_t m_sceneVersion{0};                ///< 上次同步的场景数据版本
+    uint64_t m_renderObjectsVersion{0};        ///< 上次同步的渲染对象列表版本
+    uint64_t m_objectsVersion{0};              ///< CPU 侧镜像版本
+};
+
+} // namespace renderer
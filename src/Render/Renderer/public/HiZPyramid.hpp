@@ -0,0 +1,226 @@
+/**
+ * @file HiZPyramid.hpp
+ * @brief 单次计算分发生成的 Hi-Z（最小/最大深度）金字塔
+ * @details 金字塔第 0 级取深度缓冲尺寸向下取整到 2 的幂，之后每级精确减半，每个第 0 级纹素保守地覆盖
+ *          其在深度缓冲上的全部纹素。整条 mip 链在一次分发中生成（SPD 风格）：
+ *          每个 256 线程的工作组处理第 0 级的 64x64 区域并在共享内存中归约出第 1~6 级，
+ *          最后一个完成的工作组（全局原子计数选出）再从第 6 级归约出其余各级，
+ *          中间不需要任何 Pass 间屏障。
+ *
+ *          金字塔以环形方式保存 framesInFlight + 1 份：上一帧的金字塔在本帧仍可读取（两阶段遮挡剔除的第一阶段按
+ *          上一帧的视图-投影矩阵重投影），且不会在仍有在途帧读取时被覆盖。
+ */
+
+#pragma once
+
+#include "RenderGraph/public/RDGBuilder.hpp"
+#include "VulkanCore/public/Descriptor.hpp"
+#include "VulkanCore/public/Pipeline.hpp"
+#include "VulkanCore/public/VKResource.hpp"
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace vkcore
+{
+class DeferredDeletionQueue;
+} // namespace vkcore
+
+namespace rendercore
+{
+class RDGResourceAccessor;
+} // namespace rendercore
+
+namespace renderer
+{
+
+/**
+ * @struct HiZPyramidView
+ * @brief 一份金字塔在当前渲染图中的句柄与元数据
+ * @details 纹理格式为 R32G32_SFLOAT：r 为覆盖区域内的最远深度，g 为最近深度（深度测试为 LESS），
+ *          与 GPUCulling / MeshletRenderer 的 Hi-Z 约定一致，可以直接填入其视图
+ */
+struct HiZPyramidView
+{
+    rendercore::RDGTextureHandle texture = rendercore::kInvalidTextureHandle; ///< 金字塔纹理（全部 mip）
+    uint32_t width{0};                                                        ///< 第 0 级宽度
+    uint32_t height{0};                                                       ///< 第 0 级高度
+    uint32_t mipCount{0};                                                     ///< mip 级数
+    glm::mat4 viewProjection{1.0f};                                           ///< 生成时的 projection * view
+
+    /**
+     * @brief 检查视图是否可用
+     */
+    bool isValid() const
+    {
+        return texture.isValid() && mipCount > 0;
+    }
+};
+
+/**
+ * @struct GPUHiZPushConstants
+ * @brief 金字塔生成着色器的推送常量
+ */
+struct GPUHiZPushConstants
+{
+    glm::uvec2 depthSize;    ///< 深度缓冲尺寸
+    glm::uvec2 baseSize;     ///< 金字塔第 0 级尺寸
+    uint32_t mipCount;       ///< mip 级数
+    uint32_t workgroupCount; ///< 分发的工作组总数（最后完成的工作组生成剩余各级）
+};
+
+/**
+ * @class HiZPyramid
+ * @brief Hi-Z 金字塔的生成与跨帧保存
+ * @details 深度缓冲必须是只有深度分量的格式（D16 / D32），以便直接采样。
+ *          每份金字塔附带一个原子计数缓冲，着色器在最后一个工作组结束时把它复位为 0。
+ *          RDG 不跟踪外部纹理的最终布局，因此每帧执行渲染图后需要调用 endFrame() 记录各金字塔的布局。
+ *
+ * @example
+ * @code
+ * // 第一阶段：以上一帧的金字塔剔除（包围盒按上一帧的矩阵重投影）
+ * renderer::GPUCullView cullView{proj * view};
+ * renderer::HiZPyramidView history = hiZPyramid.importHistory(builder);
+ * if (history.isValid())
+ * {
+ *     cullView.hiZ = history.texture;
+ *     cullView.hiZWidth = history.width;
+ *     cullView.hiZHeight = history.height;
+ *     cullView.hiZMipCount = history.mipCount;
+ *     cullView.hiZViewProjection = history.viewProjection;
+ * }
+ * // ... 剔除并绘制深度 ...
+ * renderer::HiZPyramidView current = hiZPyramid.addBuildPass(builder, frameIndex, depth, width, height, proj * view);
+ * // 第二阶段：以本帧的金字塔重新测试第一阶段剔除掉的对象 ...
+ * builder.execute(&syncInfo);
+ * hiZPyramid.endFrame(builder);
+ * @endcode
+ */
+class HiZPyramid
+{
+  public:
+    /** 最大 mip 级数（第 0 级不超过 4096） */
+    static constexpr uint32_t kMaxMipCount = 13;
+    /** 每个工作组覆盖的第 0 级区域边长，需与 hiz_pyramid.comp 一致 */
+    static constexpr uint32_t kTileSize = 64;
+    /** 每个工作组的线程数，需与 hiz_pyramid.comp 的 local_size_x 一致 */
+    static constexpr uint32_t kWorkgroupSize = 256;
+    /** 金字塔格式 */
+    static constexpr vk::Format kFormat = vk::Format::eR32G32Sfloat;
+
+    /**
+     * @brief 构造函数
+     * @param device 逻辑设备
+     * @param allocator VMA 分配器
+     * @param layoutCache 描述符布局缓存
+     * @param pyramidShader hiz_pyramid.comp 编译得到的计算着色器
+     * @param framesInFlight 在途帧数量
+     * @throws std::invalid_argument 如果 framesInFlight 为 0
+     * @throws std::runtime_error 如果设备不支持 R32G32_SFLOAT 存储图像
+     */
+    HiZPyramid(vkcore::Device &device, VmaAllocator allocator, vkcore::DescriptorLayoutCache &layoutCache,
+               std::shared_ptr<vkcore::ShaderModule> pyramidShader, uint32_t framesInFlight);
+    ~HiZPyramid();
+
+    /** 禁用拷贝与移动 */
+    HiZPyramid(const HiZPyramid &) = delete;
+    HiZPyramid &operator=(const HiZPyramid &) = delete;
+
+    /**
+     * @brief 设置延迟销毁队列（可选）
+     * @details 设置后，深度缓冲尺寸变化时旧的金字塔延迟到当前帧退休后销毁；
+     *          未设置时立即销毁，调用方需保证此时没有在途帧引用它们
+     */
+    void setDeletionQueue(vkcore::DeferredDeletionQueue *queue)
+    {
+        m_deletionQueue = queue;
+    }
+
+    /**
+     * @brief 把上一帧生成的金字塔导入到渲染图
+     * @param builder 当前帧的渲染图构建器
+     * @return HiZPyramidView 上一帧的金字塔；没有（首帧、尺寸变化或 invalidateHistory() 之后）时无效
+     */
+    HiZPyramidView importHistory(rendercore::RDGBuilder &builder);
+
+    /**
+     * @brief 添加由深度缓冲生成本帧金字塔的计算 Pass
+     * @param builder 当前帧的渲染图构建器
+     * @param frameIndex 在途帧索引
+     * @param depth 深度缓冲（在此之前的 Pass 中写入）
+     * @param width 深度缓冲宽度
+     * @param height 深度缓冲高度
+     * @param viewProjection 深度缓冲对应的 projection * view
+     * @return HiZPyramidView 本帧的金字塔（之后的 Pass 以 readTexture 读取）
+     * @throws std::invalid_argument 如果 frameIndex 越界、句柄无效或尺寸为 0
+     * @throws std::runtime_error 如果同一帧内调用了两次，或上一帧没有调用 endFrame()
+     */
+    HiZPyramidView addBuildPass(rendercore::RDGBuilder &builder, uint32_t frameIndex,
+                                rendercore::RDGTextureHandle depth, uint32_t width, uint32_t height,
+                                const glm::mat4 &viewProjection);
+
+    /**
+     * @brief 渲染图执行后记录本帧导入的金字塔的最终布局，本帧生成的金字塔成为下一帧的历史
+     * @param builder 已执行的渲染图构建器
+     */
+    void endFrame(const rendercore::RDGBuilder &builder);
+
+    /**
+     * @brief 丢弃历史金字塔（摄像机跳变、切换场景时），下一帧 importHistory() 返回无效视图
+     */
+    void invalidateHistory()
+    {
+        m_historyValid = false;
+    }
+
+    /**
+     * @brief 由深度缓冲尺寸计算金字塔第 0 级尺寸（各轴向下取整到 2 的幂，且不超过 4096）
+     */
+    static glm::uvec2 getBaseSize(uint32_t width, uint32_t height);
+
+    /**
+     * @brief 由第 0 级尺寸计算 mip 级数
+     */
+    static uint32_t getMipCount(glm::uvec2 baseSize);
+
+  private:
+    /**
+     * @struct Pyramid
+     * @brief 环中的一份金字塔
+     */
+    struct Pyramid
+    {
+        std::unique_ptr<vkcore::Image> image;          ///< 全部 mip 的纹理
+        std::vector<vk::ImageView> mipViews;           ///< 每级一个存储图像视图
+        std::unique_ptr<vkcore::Buffer> counterBuffer; ///< 工作组完成计数（着色器用完后复位为 0）
+        vk::ImageLayout layout{vk::ImageLayout::eUndefined};
+        glm::mat4 viewProjection{1.0f};
+        rendercore::RDGTextureHandle handle = rendercore::kInvalidTextureHandle; ///< 本帧导入的句柄
+    };
+
+    void createpyramids(glm::uvec2 baseSize);
+    void releasepyramid(Pyramid &pyramid);
+    rendercore::RDGTextureHandle importpyramid(rendercore::RDGBuilder &builder, Pyramid &pyramid, const char *name);
+    HiZPyramidView makeview(const Pyramid &pyramid) const;
+
+  private:
+    vkcore::Device &m_device;
+    VmaAllocator m_allocator;
+    vkcore::DeferredDeletionQueue *m_deletionQueue{nullptr};
+
+    std::unique_ptr<vkcore::Pipeline> m_pipeline;
+    vk::DescriptorSetLayout m_setLayout;
+    std::unique_ptr<vkcore::DescriptorAllocator> m_descriptorAllocator;
+    std::vector<vk::DescriptorSet> m_descriptorSets; ///< 每个在途帧一个
+
+    std::vector<Pyramid> m_pyramids; ///< 环形保存 framesInFlight + 1 份
+    std::vector<Pyramid> m_retired;  ///< 尺寸变化时替换下的金字塔（本帧的渲染图可能仍引用，endFrame() 时释放）
+    glm::uvec2 m_baseSize{0};
+    uint32_t m_mipCount{0};
+    uint32_t m_history{0};      ///< 上一帧生成的金字塔在环中的位置
+    uint32_t m_current{0};      ///< 本帧生成的金字塔在环中的位置
+    bool m_historyValid{false}; ///< m_history 是否包含与当前尺寸一致的有效内容
+    bool m_built{false};        ///< 本帧是否已添加生成 Pass（endFrame() 时复位）
+};
+
+} // namespace renderer
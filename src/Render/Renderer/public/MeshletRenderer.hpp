@@ -0,0 +1,295 @@
+/**
+ * @file MeshletRenderer.hpp
+ * @brief 网格着色器渲染路径：任务着色器逐 meshlet 剔除，网格着色器从存储缓冲拉取顶点
+ * @details 只处理带有 meshlet 的网格（ResourceManager::setMeshletGeneration 开启后创建的网格），
+ *          每个对象一次 vkCmdDrawMeshTasksEXT，任务着色器的每个线程负责一个 meshlet，依次做视锥（包围球）、
+ *          背面锥与 Hi-Z 遮挡剔除，只为可见的 meshlet 发射网格着色器工作组。
+ *          没有 meshlet 的网格以及不支持 VK_EXT_mesh_shader 的设备继续走 RenderQueue / GPUCulling 的顶点路径。
+ */
+
+#pragma once
+
+#include "RenderGraph/public/RDGBuilder.hpp"
+#include "Scene/public/Scene.hpp"
+#include "VulkanCore/public/Descriptor.hpp"
+#include "VulkanCore/public/VKResource.hpp"
+#include <glm/glm.hpp>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace rendercore
+{
+class RDGResourceAccessor;
+struct Mesh;
+} // namespace rendercore
+
+namespace renderer
+{
+
+/**
+ * @struct GPUMeshletObject
+ * @brief 对象缓冲中的一项（std430 布局，80 字节，与 meshlet.task / meshlet.mesh 中的 ObjectData 一致）
+ */
+struct GPUMeshletObject
+{
+    glm::mat4 world;        ///< 世界矩阵
+    uint32_t materialIndex; ///< 材质索引（bindless 材质为全局材质 ID，否则为 UINT32_MAX）
+    float maxScale;         ///< 世界矩阵的最大轴向缩放（用于缩放包围球半径）
+    uint32_t flags;         ///< GPUMeshletObjectFlags 的组合
+    uint32_t padding;       ///< 对齐到 16 字节
+};
+static_assert(sizeof(GPUMeshletObject) == 80, "GPUMeshletObject must match the std430 layout in meshlet.task");
+
+/**
+ * @brief GPUMeshletObject::flags 的取值
+ */
+enum GPUMeshletObjectFlags : uint32_t
+{
+    GPUMeshletObjectConeCull = 1u << 0 ///< 世界矩阵为等比缩放，法线锥可以直接变换到世界空间
+};
+
+/**
+ * @struct GPUMeshletParams
+ * @brief 任务着色器的每帧参数（std140 uniform）
+ */
+struct GPUMeshletParams
+{
+    glm::mat4 viewProjection;    ///< projection * view
+    glm::mat4 hiZViewProjection; ///< 生成 Hi-Z 时的 projection * view（遮挡测试按它投影）
+    glm::vec4 frustumPlanes[6];  ///< 世界空间视锥平面，顺序同 rendercore::Frustum::Plane
+    glm::vec4 cameraPosition;    ///< 世界空间摄像机位置（w 未使用）
+    glm::vec2 hiZSize;           ///< Hi-Z 第 0 级尺寸（像素）
+    uint32_t hiZMipCount;        ///< Hi-Z mip 级数
+    uint32_t flags;              ///< GPUMeshletCullFlags 的组合
+};
+
+/**
+ * @brief GPUMeshletParams::flags 的取值
+ */
+enum GPUMeshletCullFlags : uint32_t
+{
+    GPUMeshletCullFrustum = 1u << 0,  ///< 视锥剔除
+    GPUMeshletCullCone = 1u << 1,     ///< 背面锥剔除
+    GPUMeshletCullOcclusion = 1u << 2 ///< Hi-Z 遮挡剔除
+};
+
+/**
+ * @struct GPUMeshletPushConstants
+ * @brief 每次绘制的推送常量（任务与网格着色器共享）
+ */
+struct GPUMeshletPushConstants
+{
+    uint32_t objectIndex;        ///< 对象缓冲中的索引
+    uint32_t meshletCount;       ///< meshlet 数量
+    int32_t vertexOffset;        ///< 网格首个顶点在顶点缓冲中的位置
+    uint32_t vertexFormat;       ///< rendercore::VertexFormat
+    uint32_t vertexWordOffset;   ///< meshlet 缓冲中顶点索引数组的起始位置（uint32 为单位）
+    uint32_t triangleWordOffset; ///< meshlet 缓冲中三角形数组的起始位置（uint32 为单位）
+};
+
+/**
+ * @struct MeshletView
+ * @brief 一次绘制使用的视图
+ */
+struct MeshletView
+{
+    glm::mat4 viewProjection{1.0f};                                       ///< projection * view
+    glm::vec3 cameraPosition{0.0f};                                       ///< 世界空间摄像机位置
+    rendercore::RDGTextureHandle hiZ = rendercore::kInvalidTextureHandle; ///< Hi-Z 金字塔（无效时不做遮挡剔除）
+    uint32_t hiZWidth{0};                                                 ///< Hi-Z 第 0 级宽度
+    uint32_t hiZHeight{0};                                                ///< Hi-Z 第 0 级高度
+    uint32_t hiZMipCount{0};                                              ///< Hi-Z mip 级数
+    std::optional<glm::mat4> hiZViewProjection;                           ///< 生成 Hi-Z 时的矩阵（空则同 viewProjection）
+};
+
+/**
+ * @struct MeshletInputs
+ * @brief 绘制 Pass 读取的 RDG 资源
+ */
+struct MeshletInputs
+{
+    rendercore::RDGBufferHandle objects = rendercore::kInvalidBufferHandle; ///< 对象缓冲
+    rendercore::RDGTextureHandle hiZ = rendercore::kInvalidTextureHandle;   ///< Hi-Z（或占位纹理）
+    uint32_t frameIndex{0};                                                 ///< 在途帧索引
+};
+
+/**
+ * @class MeshletRenderer
+ * @brief 网格着色器渲染路径的帧间状态
+ * @details 管线布局约定：set 0 为 getFrameSetLayout()（对象、参数与 Hi-Z），set 1 为 getMeshSetLayout()
+ *          （meshlet 缓冲与顶点缓冲），推送常量为 getPushConstantRange()，材质等应用自己的集合从 set 2 开始。
+ *          每个在途帧持有一份映射的对象缓冲与独立的描述符分配器，每网格的描述符集在 update() 中按帧重建，
+ *          因此网格卸载或几何池整理后不会残留指向旧缓冲的描述符。
+ *
+ *          meshlet 只覆盖完整网格，RenderObject::lod 在该路径上不生效（逐簇剔除已承担了远处对象的减负）。
+ *          Hi-Z 约定与 GPUCulling 相同：每个纹素存放最远深度（深度测试为 LESS），采样器为最近点夹取，
+ *          使用上一帧的金字塔时同样需要设置 MeshletView::hiZViewProjection。
+ *
+ * @example
+ * @code
+ * if (renderer::MeshletRenderer::isSupported(device))
+ * {
+ *     meshletRenderer.update(scene, frameIndex);
+ *     auto inputs = meshletRenderer.addInputs(builder, frameIndex, {proj * view, cameraPosition});
+ *     auto &draw = builder.addPass("Meshlets", [&](vk::CommandBuffer cmd, const rendercore::RDGResourceAccessor &res) {
+ *         meshletPipeline->bind(cmd);
+ *         meshletRenderer.recordDraws(cmd, res, inputs, meshletPipeline->getLayout());
+ *     });
+ *     draw.writeColorAttachment(backBuffer);
+ *     meshletRenderer.readDrawInputs(draw, inputs);
+ * }
+ * @endcode
+ */
+class MeshletRenderer
+{
+  public:
+    /** 每个任务着色器工作组处理的 meshlet 数，需与 meshlet.task 的 local_size_x 一致 */
+    static constexpr uint32_t kTaskGroupSize = 32;
+
+    /**
+     * @brief 设备是否启用了 VK_EXT_mesh_shader（需在 Device::Config::optional_extensions 中请求）
+     */
+    static bool isSupported(const vkcore::Device &device);
+
+    /**
+     * @brief 构造函数
+     * @param device 逻辑设备（须已启用 VK_EXT_mesh_shader）
+     * @param allocator VMA 分配器
+     * @param layoutCache 描述符布局缓存
+     * @param framesInFlight 在途帧数量
+     * @throws std::invalid_argument 如果 framesInFlight 为 0
+     * @throws std::runtime_error 如果设备未启用 VK_EXT_mesh_shader
+     */
+    MeshletRenderer(vkcore::Device &device, VmaAllocator allocator, vkcore::DescriptorLayoutCache &layoutCache,
+                    uint32_t framesInFlight);
+    ~MeshletRenderer();
+
+    /** 禁用拷贝与移动 */
+    MeshletRenderer(const MeshletRenderer &) = delete;
+    MeshletRenderer &operator=(const MeshletRenderer &) = delete;
+
+    /**
+     * @brief 同步场景中带 meshlet 的渲染对象到第 frameIndex 帧
+     * @param scene 场景
+     * @param frameIndex 在途帧索引（调用方保证该帧之前的 GPU 工作已完成）
+     */
+    void update(rendercore::Scene &scene, uint32_t frameIndex);
+
+    /**
+     * @brief 使缓存的绘制列表失效（几何池整理后网格的缓冲与偏移已改变），下次 update() 全部重建
+     */
+    void invalidateGeometry()
+    {
+        m_scene = nullptr;
+    }
+
+    /**
+     * @brief 写入每帧参数并向渲染图注册对象缓冲与 Hi-Z
+     * @param builder 当前帧的渲染图构建器
+     * @param frameIndex 在途帧索引（与 update() 相同）
+     * @param view 绘制视图
+     * @return MeshletInputs 供绘制 Pass 读取的资源句柄
+     */
+    MeshletInputs addInputs(rendercore::RDGBuilder &builder, uint32_t frameIndex, const MeshletView &view);
+
+    /**
+     * @brief 为绘制 Pass 声明对对象缓冲与 Hi-Z 的读取
+     */
+    void readDrawInputs(rendercore::RDGPass &pass, const MeshletInputs &inputs) const;
+
+    /**
+     * @brief 录制所有带 meshlet 对象的网格任务绘制（需已绑定网格着色管线）
+     * @param cmd 命令缓冲
+     * @param resources 绘制 Pass 的资源访问器
+     * @param inputs addInputs() 的返回值
+     * @param pipelineLayout 网格着色管线的布局（遵循类说明中的集合约定）
+     */
+    void recordDraws(vk::CommandBuffer cmd, const rendercore::RDGResourceAccessor &resources,
+                     const MeshletInputs &inputs, vk::PipelineLayout pipelineLayout);
+
+    /**
+     * @brief 获取 set 0 的布局（对象缓冲、参数与 Hi-Z）
+     */
+    vk::DescriptorSetLayout getFrameSetLayout() const
+    {
+        return m_frameSetLayout;
+    }
+
+    /**
+     * @brief 获取 set 1 的布局（meshlet 缓冲与顶点缓冲）
+     */
+    vk::DescriptorSetLayout getMeshSetLayout() const
+    {
+        return m_meshSetLayout;
+    }
+
+    /**
+     * @brief 获取推送常量范围（任务与网格着色器阶段）
+     */
+    static vk::PushConstantRange getPushConstantRange();
+
+    /**
+     * @brief 获取绘制数量（update() 之后有效）
+     */
+    uint32_t getDrawCount() const
+    {
+        return static_cast<uint32_t>(m_draws.size());
+    }
+
+  private:
+    /**
+     * @struct MeshletDraw
+     * @brief 一个带 meshlet 的渲染对象
+     */
+    struct MeshletDraw
+    {
+        const rendercore::Mesh *mesh{nullptr}; ///< 网格（非拥有）
+        uint32_t renderObjectIndex{0};         ///< 渲染对象索引
+        uint32_t meshSlot{0};                  ///< 在 m_meshes 中的索引（同一网格共享描述符集）
+    };
+
+    /**
+     * @struct FrameResources
+     * @brief 每个在途帧独占的缓冲与描述符
+     */
+    struct FrameResources
+    {
+        std::unique_ptr<vkcore::Buffer> objectBuffer;                     ///< 对象缓冲（主机可见、常驻映射）
+        std::unique_ptr<vkcore::Buffer> paramsBuffer;                     ///< 每帧参数
+        std::unique_ptr<vkcore::DescriptorAllocator> descriptorAllocator; ///< 每网格集合的分配器（重建时整体重置）
+        vk::DescriptorSet frameSet;                                       ///< set 0
+        std::vector<vk::DescriptorSet> meshSets;                          ///< set 1，与 m_meshes 一一对应
+        uint64_t objectsVersion{0};                                       ///< 对象缓冲中数据的版本（0 表示从未写入）
+        uint64_t meshesVersion{0};                                        ///< meshSets 对应的网格列表版本
+    };
+
+    void rebuilddraws(const rendercore::SceneStorage &storage);
+    void rebuildobjects(rendercore::Scene &scene);
+    void uploadobjects(FrameResources &frame);
+    void rebuildmeshsets(FrameResources &frame);
+
+  private:
+    vkcore::Device &m_device;
+    VmaAllocator m_allocator;
+    PFN_vkCmdDrawMeshTasksEXT m_drawMeshTasks{nullptr};
+
+    vk::DescriptorSetLayout m_frameSetLayout;
+    vk::DescriptorSetLayout m_meshSetLayout;
+    std::unique_ptr<vkcore::DescriptorAllocator> m_frameDescriptorAllocator;
+    std::unique_ptr<vkcore::Image> m_dummyHiZ; ///< 未提供 Hi-Z 时绑定的 1x1 占位纹理
+
+    std::vector<FrameResources> m_frames;
+
+    // CPU 侧镜像（场景版本变化时重建）
+    std::vector<GPUMeshletObject> m_objects;
+    std::vector<MeshletDraw> m_draws;               ///< 与 m_objects 一一对应
+    std::vector<const rendercore::Mesh *> m_meshes; ///< 去重后的网格
+    const rendercore::Scene *m_scene{nullptr};      ///< 上次同步的场景（切换场景时全部重建）
+    uint64_t m_sceneVersion{0};                     ///< 上次同步的场景数据版本
+    uint64_t m_renderObjectsVersion{0};             ///< 上次同步的渲染对象列表版本
+    uint64_t m_objectsVersion{0};                   ///< CPU 侧对象镜像版本
+    uint64_t m_meshesVersion{0};                    ///< 网格列表版本
+};
+
+} // namespace renderer
@@ -0,0 +1,289 @@
+/**
+ * @file RenderQueue.hpp
+ * @brief CPU 渲染队列：排序键排序与自动实例化
+ * @details 把可见渲染对象按 64 位排序键（管线、材质描述符集、网格、深度）排序，
+ *          相邻且管线/材质/网格相同的对象合并为一次实例化绘制，实例数据（世界矩阵）写入每帧的实例缓冲；
+ *          录制时只在管线、材质描述符集或顶点/索引缓冲变化时重新绑定；
+ *          bindless 材质共享同一个全局集，材质切换只推送材质 ID（BindlessRegistry::getMaterialPushConstantRange()）。
+ *          顶点拉取模式下管线没有顶点输入，顶点与实例数据经推送常量中的设备地址读取（assets/shaders/vertex_pulling.glsl）。
+ */
+
+#pragma once
+
+#include "Resource/public/ResourceType.hpp"
+#include "Scene/public/SceneStorage.hpp"
+#include "VulkanCore/public/Descriptor.hpp"
+#include "VulkanCore/public/Pipeline.hpp"
+#include "VulkanCore/public/VKResource.hpp"
+#include <functional>
+#include <glm/glm.hpp>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace renderer
+{
+
+/**
+ * @struct RenderInstanceData
+ * @brief 实例缓冲中的一项（std430 布局，64 字节）
+ * @details 顶点着色器以 instances[gl_InstanceIndex] 读取，批次的 firstInstance 即其在缓冲中的起始位置
+ */
+struct RenderInstanceData
+{
+    glm::mat4 world; ///< 世界矩阵
+};
+static_assert(sizeof(RenderInstanceData) == 64, "RenderInstanceData must match the std430 layout in shaders");
+
+/**
+ * @struct VertexPullingConstants
+ * @brief 顶点拉取的推送常量（位于材质 ID 之后，见 RenderQueue::getVertexPullingPushConstantRange()）
+ * @details 与 assets/shaders/vertex_pulling.glsl 中的 VertexPullingConstants 块一致
+ */
+struct VertexPullingConstants
+{
+    vk::DeviceAddress vertices{0};  ///< 网格所在几何池 Arena 的顶点缓冲地址（着色器以 gl_VertexIndex 索引）
+    vk::DeviceAddress instances{0}; ///< 本帧实例缓冲地址（着色器以 gl_InstanceIndex 索引 RenderInstanceData）
+    uint32_t vertexFormat{0};       ///< rendercore::VertexFormat（着色器按格式解码）
+    uint32_t padding{0};
+};
+static_assert(sizeof(VertexPullingConstants) == 24, "VertexPullingConstants must match vertex_pulling.glsl");
+
+/**
+ * @struct RenderPipelineState
+ * @brief 决定图形管线的材质与网格状态（同一状态的对象共享一个管线）
+ */
+struct RenderPipelineState
+{
+    vkcore::ShaderModule *vertexShader{nullptr};                               ///< 顶点着色器（非拥有）
+    vkcore::ShaderModule *fragmentShader{nullptr};                             ///< 片段着色器（非拥有）
+    rendercore::AlphaMode alphaMode{rendercore::AlphaMode::Opaque};            ///< 混合模式
+    bool doubleSided{false};                                                   ///< 是否关闭背面剔除
+    rendercore::VertexFormat vertexFormat{rendercore::VertexFormat::Standard}; ///< 网格顶点格式（决定顶点输入）
+    uint32_t materialFeatures{0};                                              ///< MaterialFeature 位掩码（着色器排列）
+    bool vertexPulling{false};                                                 ///< 顶点拉取（无顶点输入，vertexFormat 为 Count）
+
+    bool operator==(const RenderPipelineState &) const = default;
+};
+
+/**
+ * @brief 把管线状态中的材质排列写入构建器（片段与顶点阶段的 MATERIAL_FEATURES 特化常量）
+ * @details 排列参与状态键，同一着色器的不同排列经 PipelineCache 分别编译与缓存；
+ *          resolver 在配置好固定功能状态后调用即可
+ */
+inline void applyMaterialPermutation(vkcore::PipelineBuilder &builder, const RenderPipelineState &state)
+{
+    builder.setSpecializationConstant(rendercore::kMaterialFeaturesConstantId, state.materialFeatures,
+                                      vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment);
+}
+
+/**
+ * @struct RenderDrawBatch
+ * @brief 一次实例化绘制
+ */
+struct RenderDrawBatch
+{
+    uint64_t sortKey{0};                           ///< 批次首个对象的排序键
+    const rendercore::Mesh *mesh{nullptr};         ///< 网格（非拥有）
+    const rendercore::Material *material{nullptr}; ///< 材质（非拥有）
+    uint32_t pipelineIndex{0};                     ///< RenderQueue::getPipelineStates() 中的索引
+    uint32_t lod{0};                               ///< 网格 LOD 级别（RenderObject::lod）
+    uint32_t firstInstance{0};                     ///< 实例缓冲中的起始索引
+    uint32_t instanceCount{0};                     ///< 实例数量
+};
+
+/**
+ * @struct RenderQueueStats
+ * @brief 一次 build() 的统计（录制时实际发生的绑定次数）
+ */
+struct RenderQueueStats
+{
+    uint32_t objectCount{0};     ///< 输入对象数量
+    uint32_t drawCount{0};       ///< 实例化绘制数量
+    uint32_t pipelineBinds{0};   ///< 管线绑定次数
+    uint32_t descriptorBinds{0}; ///< 材质描述符集绑定次数
+    uint32_t bufferBinds{0};     ///< 顶点/索引缓冲绑定次数
+};
+
+/**
+ * @class RenderQueue
+ * @brief 排序、合批并录制实例化绘制的渲染队列
+ * @details 排序键布局（高位优先）：
+ *          - 不透明/Mask：[63] 0 | [62:52] 管线 | [51:36] 材质 | [35:20] 网格 | [19:0] 深度（由近到远）
+ *          - 半透明：     [63] 1 | [62:43] 深度（由远到近）| [42:32] 管线 | [31:16] 材质 | [15:0] 网格
+ *
+ *          不透明对象按状态聚拢以减少切换，同一批次内由近到远提高 Early-Z 效率；
+ *          半透明对象严格由远到近，只有深度相邻的相同对象才会合并（实例按顺序光栅化，顺序仍然正确）。
+ *          网格字段的低 3 位是 LOD 级别，同一网格的不同 LOD 相邻但分属不同批次。
+ *          合批比较的是真实的管线状态/材质/网格/LOD 而非键中截断后的 ID，ID 溢出只影响排序质量。
+ *
+ * @example
+ * @code
+ * renderQueue.build(scene.getVisibleRenderObjects(), scene.getWorldMatrices(), camera->getPosition(),
+ *                   camera->getFront(), frameIndex);
+ * renderQueue.recordDraws(cmd, frameIndex, 1, 0, [&](const RenderPipelineState &state) {
+ *     vkcore::PipelineBuilder &builder = builderFor(state);
+ *     renderer::applyMaterialPermutation(builder, state);
+ *     vkcore::Pipeline *pipeline = pipelineCache.tryGet(builder); // 未就绪时投递后台编译
+ *     return pipeline ? pipeline : fallbackPipeline;
+ * });
+ * @endcode
+ *
+ * @note 非线程安全；管线布局中实例集与材质集的位置由 recordDraws() 的参数指定
+ */
+class RenderQueue
+{
+  public:
+    /**
+     * @brief 根据管线状态返回（必要时创建）图形管线
+     * @details 每次管线切换调用一次，返回的管线在录制的命令缓冲执行完毕前必须保持有效；
+     *          管线仍在后台编译时可以返回回退管线（布局须兼容），或返回 nullptr 跳过使用该状态的批次；
+     *          顶点输入取 rendercore::VertexLayouts::getInfo(state.vertexFormat).inputState；
+     *          state.vertexPulling 为 true 时不设置顶点输入，布局须包含 getVertexPullingPushConstantRange()
+     */
+    using PipelineResolver = std::function<vkcore::Pipeline *(const RenderPipelineState &)>;
+
+    /**
+     * @brief 构造函数
+     * @param device 逻辑设备
+     * @param allocator VMA 分配器
+     * @param layoutCache 描述符布局缓存（实例集布局从中创建）
+     * @param framesInFlight 在途帧数量（每帧独占一个实例缓冲）
+     */
+    RenderQueue(vkcore::Device &device, VmaAllocator allocator, vkcore::DescriptorLayoutCache &layoutCache,
+                uint32_t framesInFlight);
+    ~RenderQueue();
+
+    /** 禁用拷贝与移动 */
+    RenderQueue(const RenderQueue &) = delete;
+    RenderQueue &operator=(const RenderQueue &) = delete;
+
+    /**
+     * @brief 设备是否支持顶点拉取（启用了 bufferDeviceAddress）
+     */
+    static bool supportsVertexPulling(const vkcore::Device &device);
+
+    /**
+     * @brief 获取顶点拉取的 push constant 范围（offset 8，VertexPullingConstants，顶点着色器可见）
+     * @details 紧跟材质 ID 之后（中间 4 字节对齐填充），两者可以同时出现在一个管线布局中
+     */
+    static vk::PushConstantRange getVertexPullingPushConstantRange();
+
+    /**
+     * @brief 启用或关闭顶点拉取（下一次 build() 起生效）
+     * @details 启用后几何池网格（顶点缓冲带 eShaderDeviceAddress）的管线状态不再区分顶点格式，
+     *          不同格式、不同 Arena 的网格共享同一条管线，切换 Arena 只推送新的顶点地址；
+     *          独立缓冲的网格仍走顶点输入路径
+     * @throws std::runtime_error 如果启用时设备不支持（supportsVertexPulling() 为 false）
+     */
+    void setVertexPulling(bool enabled);
+
+    /**
+     * @brief 是否启用了顶点拉取
+     */
+    bool isVertexPulling() const
+    {
+        return m_vertexPulling;
+    }
+
+    /**
+     * @brief 排序并合批，把实例数据写入第 frameIndex 帧的实例缓冲
+     * @param objects 可见渲染对象（通常为 Scene::getVisibleRenderObjects()）
+     * @param worldMatrices 以 RenderObject::transformIndex 索引的世界矩阵
+     * @param viewPosition 视点的世界空间位置
+     * @param viewForward 视线方向（单位向量）
+     * @param frameIndex 在途帧索引（调用方保证该帧之前的 GPU 工作已完成）
+     */
+    void build(std::span<const rendercore::RenderObject> objects, std::span<const glm::mat4> worldMatrices,
+               const glm::vec3 &viewPosition, const glm::vec3 &viewForward, uint32_t frameIndex);
+
+    /**
+     * @brief 录制所有批次
+     * @param cmd 命令缓冲（已开始渲染，已设置视口等动态状态）
+     * @param frameIndex 在途帧索引（与 build() 相同）
+     * @param instanceSet 实例集在管线布局中的 set 编号
+     * @param materialSet 材质描述符集在管线布局中的 set 编号（bindless 模式下为全局集）
+     * @param resolver 管线查询回调
+     * @return uint32_t 因 resolver 返回空管线而跳过的批次数
+     */
+    uint32_t recordDraws(vk::CommandBuffer cmd, uint32_t frameIndex, uint32_t instanceSet, uint32_t materialSet,
+                         const PipelineResolver &resolver) const;
+
+    /**
+     * @brief 获取实例集布局（binding 0：只读 StorageBuffer，顶点着色器可见）
+     */
+    vk::DescriptorSetLayout getInstanceSetLayout() const
+    {
+        return m_setLayout;
+    }
+
+    /**
+     * @brief 获取批次列表（build() 之后有效）
+     */
+    const std::vector<RenderDrawBatch> &getBatches() const
+    {
+        return m_batches;
+    }
+
+    /**
+     * @brief 获取本次 build() 中出现的管线状态，RenderDrawBatch::pipelineIndex 即其中的索引
+     */
+    const std::vector<RenderPipelineState> &getPipelineStates() const
+    {
+        return m_pipelineStates;
+    }
+
+    /**
+     * @brief 获取最近一次 build() 的统计
+     */
+    const RenderQueueStats &getStats() const
+    {
+        return m_stats;
+    }
+
+  private:
+    /**
+     * @struct FrameResources
+     * @brief 每个在途帧独占的实例缓冲与描述符集
+     */
+    struct FrameResources
+    {
+        std::unique_ptr<vkcore::Buffer> instanceBuffer; ///< 实例缓冲（主机可见、常驻映射）
+        vk::DescriptorSet descriptorSet;                ///< 实例集
+        vk::DeviceAddress instanceAddress{0};           ///< 实例缓冲的设备地址（设备不支持时为 0）
+    };
+
+    /**
+     * @struct SortItem
+     * @brief 排序用的紧凑条目
+     */
+    struct SortItem
+    {
+        uint64_t key;
+        uint32_t objectIndex;
+        uint32_t pipelineIndex;
+    };
+
+    uint32_t pipelineindex(const rendercore::Material &material, const rendercore::Mesh &mesh);
+    void buildbatches(std::span<const rendercore::RenderObject> objects);
+    void uploadinstances(FrameResources &frame, std::span<const rendercore::RenderObject> objects,
+                         std::span<const glm::mat4> worldMatrices);
+
+  private:
+    vkcore::Device &m_device;
+    VmaAllocator m_allocator;
+    bool m_deviceAddress{false}; ///< 设备启用了 bufferDeviceAddress（实例缓冲可取地址）
+    bool m_vertexPulling{false};
+
+    vk::DescriptorSetLayout m_setLayout;
+    std::unique_ptr<vkcore::DescriptorAllocator> m_descriptorAllocator;
+    std::vector<FrameResources> m_frames;
+
+    // 每次 build() 重建（帧间复用容量）
+    std::vector<SortItem> m_items;
+    std::vector<RenderDrawBatch> m_batches;
+    std::vector<RenderPipelineState> m_pipelineStates;
+    RenderQueueStats m_stats;
+};
+
+} // namespace renderer
@@ -0,0 +1,249 @@
+/**
+ * @file ShadingRateImage.hpp
+ * @brief 由内容与相机运动驱动的可变速率着色（VK_KHR_fragment_shading_rate）
+ * @details 每帧在场景颜色完成后添加一个计算 Pass：按着色速率纹素统计上一帧画面的感知亮度标准差，
+ *          并用深度把每个像素重投影到再上一帧，得到相机运动造成的屏幕位移。
+ *          平坦区域（低对比度）与快速运动区域（运动模糊、人眼跟不上）以 2x2 或 4x4 着色，细节区域保持 1x1。
+ *          生成的图像在下一帧作为主 Pass 的着色速率附件（RDGPass::setShadingRateAttachment）。
+ *
+ *          图像以环形方式保存 framesInFlight + 1 份（与 HiZPyramid 相同）：上一帧的结果在本帧读取，
+ *          且不会在仍有在途帧读取时被覆盖。图像按出现过的最大尺寸分配，动态分辨率缩小时不必重建。
+ */
+
+#pragma once
+
+#include "RenderGraph/public/RDGBuilder.hpp"
+#include "VulkanCore/public/Descriptor.hpp"
+#include "VulkanCore/public/Pipeline.hpp"
+#include "VulkanCore/public/VKResource.hpp"
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace vkcore
+{
+class DeferredDeletionQueue;
+} // namespace vkcore
+
+namespace renderer
+{
+
+/**
+ * @struct ShadingRateView
+ * @brief 一份着色速率图像在当前渲染图中的句柄与元数据
+ */
+struct ShadingRateView
+{
+    rendercore::RDGTextureHandle texture = rendercore::kInvalidTextureHandle; ///< 着色速率图像（R8_UINT）
+    vk::Extent2D texelSize{0, 0};                                             ///< 每个纹素覆盖的像素数
+
+    /**
+     * @brief 检查视图是否可用
+     */
+    bool isValid() const
+    {
+        return texture.isValid();
+    }
+};
+
+/**
+ * @struct ShadingRateSettings
+ * @brief 速率选择阈值
+ * @details 对比度为纹素内感知亮度（Reinhard 压缩后，范围 [0, 1)）的标准差；运动为纹素内的平均位移（像素/帧）。
+ *          内容与运动各自给出一个速率，取较粗的那个
+ */
+struct ShadingRateSettings
+{
+    float flatContrast{0.01f};    ///< 对比度低于此值时使用 4x4
+    float detailContrast{0.04f};  ///< 对比度低于此值时使用 2x2
+    float motionPixels2x2{4.0f};  ///< 运动超过此值时至少使用 2x2
+    float motionPixels4x4{16.0f}; ///< 运动超过此值时使用 4x4
+};
+
+/**
+ * @struct GPUShadingRatePushConstants
+ * @brief 着色速率生成着色器的推送常量
+ */
+struct GPUShadingRatePushConstants
+{
+    glm::mat4 reprojection; ///< 当前帧 NDC -> 上一帧裁剪空间
+    glm::uvec2 colorSize;   ///< 颜色/深度的有效尺寸
+    glm::uvec2 texelSize;   ///< 纹素尺寸
+    float flatContrast;     ///< ShadingRateSettings::flatContrast
+    float detailContrast;   ///< ShadingRateSettings::detailContrast
+    float motionPixels2x2;  ///< ShadingRateSettings::motionPixels2x2
+    float motionPixels4x4;  ///< ShadingRateSettings::motionPixels4x4
+    uint32_t maxRateLog2;   ///< 设备支持的最大片段尺寸（log2，各轴相同，不超过 2）
+    uint32_t motionEnabled; ///< 是否有上一帧的矩阵
+};
+
+/**
+ * @class ShadingRateImage
+ * @brief 着色速率图像的生成与跨帧保存
+ * @details 颜色纹理可以是任意可采样的格式（通常为 HDR 场景颜色），深度缓冲必须是只有深度分量的格式。
+ *          绘制到带附件的 Pass 的管线需要以 PipelineBuilder::setFragmentShadingRate() 创建。
+ *          RDG 不跟踪外部纹理的最终布局，因此每帧执行渲染图后需要调用 endFrame()。
+ *
+ * @example
+ * @code
+ * renderer::ShadingRateView rate = shadingRate.importHistory(builder, scaled);
+ * auto &pass = builder.addPass("Scene", drawScene)
+ *                  .writeColorAttachment(sceneColor)
+ *                  .writeDepthAttachment(depth);
+ * if (rate.isValid())
+ * {
+ *     pass.setShadingRateAttachment(rate.texture, rate.texelSize);
+ * }
+ * // ... 后处理之前，为下一帧生成着色速率 ...
+ * shadingRate.addGeneratePass(builder, frameIndex, sceneColor, depth, scaled, proj * view);
+ * builder.execute(&syncInfo);
+ * shadingRate.endFrame(builder);
+ * @endcode
+ */
+class ShadingRateImage
+{
+  public:
+    /** 着色速率图像格式 */
+    static constexpr vk::Format kFormat = vk::Format::eR8Uint;
+    /** 首选的纹素尺寸（按设备范围钳制） */
+    static constexpr uint32_t kPreferredTexelSize = 16;
+    /** 每个工作组的线程数，需与 shading_rate.comp 的 local_size_x 一致 */
+    static constexpr uint32_t kWorkgroupSize = 64;
+
+    /**
+     * @brief 设备是否启用了 VK_KHR_fragment_shading_rate（需在 Device::Config::optional_extensions 中请求）
+     */
+    static bool isSupported(const vkcore::Device &device);
+
+    /**
+     * @brief 构造函数
+     * @param device 逻辑设备（须已启用 VK_KHR_fragment_shading_rate）
+     * @param allocator VMA 分配器
+     * @param layoutCache 描述符布局缓存
+     * @param rateShader shading_rate.comp 编译得到的计算着色器
+     * @param framesInFlight 在途帧数量
+     * @throws std::invalid_argument 如果 framesInFlight 为 0
+     * @throws std::runtime_error 如果设备未启用扩展，或 R8_UINT 不支持存储图像与着色速率附件
+     */
+    ShadingRateImage(vkcore::Device &device, VmaAllocator allocator, vkcore::DescriptorLayoutCache &layoutCache,
+                     std::shared_ptr<vkcore::ShaderModule> rateShader, uint32_t framesInFlight);
+    ~ShadingRateImage();
+
+    /** 禁用拷贝与移动 */
+    ShadingRateImage(const ShadingRateImage &) = delete;
+    ShadingRateImage &operator=(const ShadingRateImage &) = delete;
+
+    /**
+     * @brief 设置延迟销毁队列（可选）
+     * @details 设置后，图像需要增大时旧图像延迟到当前帧退休后销毁；
+     *          未设置时立即销毁，调用方需保证此时没有在途帧引用它们
+     */
+    void setDeletionQueue(vkcore::DeferredDeletionQueue *queue)
+    {
+        m_deletionQueue = queue;
+    }
+
+    /**
+     * @brief 设置速率选择阈值
+     */
+    void setSettings(const ShadingRateSettings &settings)
+    {
+        m_settings = settings;
+    }
+
+    /**
+     * @brief 获取速率选择阈值
+     */
+    const ShadingRateSettings &getSettings() const
+    {
+        return m_settings;
+    }
+
+    /**
+     * @brief 获取纹素尺寸（构造时按设备范围确定）
+     */
+    vk::Extent2D getTexelSize() const
+    {
+        return m_texelSize;
+    }
+
+    /**
+     * @brief 把上一帧生成的着色速率图像导入到渲染图
+     * @param builder 当前帧的渲染图构建器
+     * @param renderExtent 本帧使用该附件的渲染区域尺寸
+     * @return ShadingRateView 上一帧的结果；没有（首帧、invalidateHistory() 之后）或图像不能覆盖渲染区域时无效
+     */
+    ShadingRateView importHistory(rendercore::RDGBuilder &builder, vk::Extent2D renderExtent);
+
+    /**
+     * @brief 添加由本帧颜色与深度生成着色速率图像的计算 Pass（结果供下一帧使用）
+     * @param builder 当前帧的渲染图构建器
+     * @param frameIndex 在途帧索引
+     * @param color 场景颜色（在此之前的 Pass 中写入）
+     * @param depth 与颜色对应的深度缓冲
+     * @param extent 颜色与深度的有效尺寸（动态分辨率下为 RDGBuilder::getScaledExtent()）
+     * @param viewProjection 本帧的 projection * view（与上一次调用的矩阵一起计算相机运动）
+     * @throws std::invalid_argument 如果 frameIndex 越界、句柄无效或尺寸为 0
+     * @throws std::runtime_error 如果同一帧内调用了两次，或上一帧没有调用 endFrame()
+     */
+    void addGeneratePass(rendercore::RDGBuilder &builder, uint32_t frameIndex, rendercore::RDGTextureHandle color,
+                         rendercore::RDGTextureHandle depth, vk::Extent2D extent, const glm::mat4 &viewProjection);
+
+    /**
+     * @brief 渲染图执行后记录本帧导入的图像的最终布局，本帧生成的图像成为下一帧的历史
+     * @param builder 已执行的渲染图构建器
+     */
+    void endFrame(const rendercore::RDGBuilder &builder);
+
+    /**
+     * @brief 丢弃历史（摄像机跳变、切换场景时），下一帧 importHistory() 返回无效视图，相机运动重新开始累计
+     */
+    void invalidateHistory()
+    {
+        m_historyValid = false;
+        m_motionValid = false;
+    }
+
+  private:
+    /**
+     * @struct RateTarget
+     * @brief 环中的一份着色速率图像
+     */
+    struct RateTarget
+    {
+        std::unique_ptr<vkcore::Image> image;
+        vk::ImageLayout layout{vk::ImageLayout::eUndefined};
+        rendercore::RDGTextureHandle handle = rendercore::kInvalidTextureHandle; ///< 本帧导入的句柄
+    };
+
+    void createtargets(vk::Extent2D size);
+    void releasetarget(RateTarget &target);
+    rendercore::RDGTextureHandle importtarget(rendercore::RDGBuilder &builder, RateTarget &target, const char *name);
+
+  private:
+    vkcore::Device &m_device;
+    VmaAllocator m_allocator;
+    vkcore::DeferredDeletionQueue *m_deletionQueue{nullptr};
+
+    std::unique_ptr<vkcore::Pipeline> m_pipeline;
+    vk::DescriptorSetLayout m_setLayout;
+    std::unique_ptr<vkcore::DescriptorAllocator> m_descriptorAllocator;
+    std::vector<vk::DescriptorSet> m_descriptorSets; ///< 每个在途帧一个
+
+    vk::Extent2D m_texelSize{kPreferredTexelSize, kPreferredTexelSize};
+    uint32_t m_maxRateLog2{0};
+    ShadingRateSettings m_settings;
+
+    std::vector<RateTarget> m_targets; ///< 环形保存 framesInFlight + 1 份
+    std::vector<RateTarget> m_retired; ///< 增大时替换下的图像（本帧的渲染图可能仍引用，endFrame() 时释放）
+    vk::Extent2D m_size{0, 0};         ///< 图像尺寸（纹素）
+    uint32_t m_history{0};             ///< 上一帧生成的图像在环中的位置
+    uint32_t m_current{0};             ///< 本帧生成的图像在环中的位置
+    bool m_historyValid{false};        ///< m_history 是否包含有效内容
+    bool m_built{false};               ///< 本帧是否已添加生成 Pass（endFrame() 时复位）
+
+    glm::mat4 m_previousViewProjection{1.0f}; ///< 上一次 addGeneratePass() 的矩阵
+    bool m_motionValid{false};                ///< m_previousViewProjection 是否可用于重投影
+};
+
+} // namespace renderer
@@ -0,0 +1,429 @@
+/**
+ * @file ShadowAtlas.hpp
+ * @brief 带缓存与逐光源更新调度的阴影图集
+ * @details 所有投射阴影的光源共享一张深度图集，图块以四叉树（buddy）分配器按 2 的幂尺寸动态分配，
+ *          尺寸由光源的重要性（影响范围相对摄像机距离的投影大小）决定：
+ *          - 平行光使用级联阴影（CSM），每级的投影以包围球定尺寸并把中心对齐到纹素网格，
+ *            摄像机平移/旋转时矩阵只按整纹素跳变，静止时完全不变，因此级联也可以缓存；
+ *          - 聚光灯一个透视图块，点光源六个立方体面图块。
+ *
+ *          每个图块记录绘制时的视图-投影矩阵与视锥内投射体（网格、LOD、世界矩阵）的哈希，
+ *          只有光源或视锥内的投射体移动时才需要重绘；需要重绘的图块按优先级排序，
+ *          每帧只更新估计耗时不超过时间预算的部分，其余沿用上一次的内容（着色使用图块绘制时的矩阵，结果仍然正确）。
+ */
+
+#pragma once
+
+#include "ClusteredLighting.hpp"
+#include "RenderGraph/public/RDGBuilder.hpp"
+#include "Resource/public/ResourceType.hpp"
+#include "Scene/public/Camera.hpp"
+#include "Scene/public/Scene.hpp"
+#include "VulkanCore/public/Descriptor.hpp"
+#include "VulkanCore/public/Pipeline.hpp"
+#include "VulkanCore/public/VKResource.hpp"
+#include <array>
+#include <glm/glm.hpp>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace rendercore
+{
+class RDGResourceAccessor;
+} // namespace rendercore
+
+namespace renderer
+{
+
+/**
+ * @struct ShadowAtlasRect
+ * @brief 图集中的一个正方形图块（像素）
+ */
+struct ShadowAtlasRect
+{
+    uint32_t x{0};    ///< 左上角 x
+    uint32_t y{0};    ///< 左上角 y
+    uint32_t size{0}; ///< 边长（0 表示未分配）
+
+    bool isValid() const
+    {
+        return size != 0;
+    }
+};
+
+/**
+ * @class ShadowAtlasAllocator
+ * @brief 正方形图集的四叉树（buddy）分配器
+ * @details 图块边长为 2 的幂，介于 minTileSize 与 atlasSize 之间；每一级维护空闲列表，
+ *          分配时从最近的较粗一级逐级拆分，释放时四个兄弟图块都空闲则合并回父图块
+ */
+class ShadowAtlasAllocator
+{
+  public:
+    /**
+     * @brief 构造函数
+     * @param atlasSize 图集边长（2 的幂）
+     * @param minTileSize 最小图块边长（2 的幂，不大于 atlasSize）
+     * @throws std::invalid_argument 如果尺寸不是 2 的幂或 minTileSize 大于 atlasSize
+     */
+    ShadowAtlasAllocator(uint32_t atlasSize, uint32_t minTileSize);
+
+    /**
+     * @brief 分配一个图块
+     * @param size 请求的边长（向上取整到 2 的幂并夹取到 [minTileSize, atlasSize]）
+     * @param rect (输出) 分配到的图块
+     * @return 是否成功（图集中没有足够大的空闲区域时失败）
+     */
+    bool allocate(uint32_t size, ShadowAtlasRect &rect);
+
+    /**
+     * @brief 释放 allocate() 返回的图块（无效图块被忽略）
+     */
+    void free(const ShadowAtlasRect &rect);
+
+    /**
+     * @brief 释放所有图块
+     */
+    void reset();
+
+    /**
+     * @brief 获取空闲纹素数
+     */
+    uint64_t getFreeTexels() const;
+
+    uint32_t getAtlasSize() const
+    {
+        return m_atlasSize;
+    }
+
+    uint32_t getMinTileSize() const
+    {
+        return m_minTileSize;
+    }
+
+  private:
+    uint32_t levelof(uint32_t size) const;
+    uint32_t levelsize(uint32_t level) const;
+    bool isfree(uint32_t level, uint32_t key) const;
+    void takefree(uint32_t level, uint32_t key);
+
+  private:
+    uint32_t m_atlasSize;
+    uint32_t m_minTileSize;
+    std::vector<std::vector<uint32_t>> m_freeLists; ///< 每一级的空闲图块（键为 x | y << 16，以该级图块为单位）
+};
+
+/**
+ * @struct ShadowAtlasSettings
+ * @brief 阴影图集的配置
+ */
+struct ShadowAtlasSettings
+{
+    uint32_t atlasSize = 4096;                       ///< 图集边长（2 的幂）
+    uint32_t minTileSize = 128;                      ///< 最小图块边长
+    uint32_t maxLocalTileSize = 1024;                ///< 聚光灯/点光源单个图块的最大边长
+    uint32_t cascadeTileSize = 1024;                 ///< 平行光每级级联的图块边长
+    uint32_t cascadeCount = 4;                       ///< 级联数量（1..kMaxCascades）
+    float cascadeSplitLambda = 0.75f;                ///< 级联划分中对数划分的权重（其余为均匀划分）
+    float shadowDistance = 100.0f;                   ///< 平行光阴影的最远距离（不超过摄像机远平面）
+    float directionalCasterDistance = 100.0f;        ///< 级联投影向光源方向延伸的距离（覆盖视锥外的投射体）
+    float updateBudgetMs = 1.0f;                     ///< 每帧图块重绘的 GPU 时间预算（至少更新一个图块）
+    float depthBiasConstant = 1.25f;                 ///< 光栅化深度偏移常数项
+    float depthBiasSlope = 1.75f;                    ///< 光栅化深度偏移斜率项
+    float normalOffset = 1.5f;                       ///< 着色时沿法线偏移的纹素数
+    uint32_t casterLod = 0;                          ///< 投射体使用的 LOD 级别（越界时取最粗一级）
+    vk::Format depthFormat = vk::Format::eD32Sfloat; ///< 图集深度格式
+};
+
+/**
+ * @struct GPUShadowView
+ * @brief 一个图块的着色参数（std430，与 shadow_atlas.glsl 一致）
+ */
+struct GPUShadowView
+{
+    glm::mat4 viewProjection; ///< 图块内容绘制时使用的视图-投影矩阵（深度范围 [0, 1]）
+    glm::vec4 atlasRect;      ///< xy 为图块在图集中的 UV 偏移，zw 为 UV 尺寸
+    glm::vec4 params;         ///< x 为内容是否有效，y 为纹素的世界尺寸（透视时为单位距离处），z 为是否透视，w 为法线偏移纹素数
+};
+static_assert(sizeof(GPUShadowView) == 96, "GPUShadowView must match the std430 layout in shadow_atlas.glsl");
+
+/**
+ * @struct GPUShadowLight
+ * @brief 一个投射阴影的光源（std430，与 shadow_atlas.glsl 一致）
+ * @details 平行光的视图为由近到远的级联，点光源为 +X、-X、+Y、-Y、+Z、-Z 六个面
+ */
+struct GPUShadowLight
+{
+    uint32_t firstView; ///< 首个视图在视图数组中的索引
+    uint32_t viewCount; ///< 视图数量（0 表示图集已满、该光源没有阴影）
+    uint32_t type;      ///< GPULightType
+    uint32_t padding;   ///< 对齐到 16 字节
+    glm::vec4 position; ///< 点光源的世界空间位置（选择立方体面）
+};
+static_assert(sizeof(GPUShadowLight) == 32, "GPUShadowLight must match the std430 layout in shadow_atlas.glsl");
+
+/**
+ * @struct ShadowAtlasOutputs
+ * @brief 阴影 Pass 产生的 RDG 资源
+ */
+struct ShadowAtlasOutputs
+{
+    rendercore::RDGTextureHandle atlas = rendercore::kInvalidTextureHandle; ///< 阴影图集
+    rendercore::RDGBufferHandle views = rendercore::kInvalidBufferHandle;   ///< GPUShadowView 数组
+    rendercore::RDGBufferHandle lights = rendercore::kInvalidBufferHandle;  ///< GPUShadowLight 数组
+    uint32_t frameIndex{0};                                                 ///< 在途帧索引
+};
+
+/**
+ * @struct ShadowAtlasStats
+ * @brief 最近一次 update() 的统计
+ */
+struct ShadowAtlasStats
+{
+    uint32_t shadowedLights{0};    ///< 投射阴影的光源数
+    uint32_t unallocatedLights{0}; ///< 因图集已满没有分配到图块的光源数
+    uint32_t tiles{0};             ///< 已分配的图块数
+    uint32_t cachedTiles{0};       ///< 内容仍然有效、无需重绘的图块数
+    uint32_t updatedTiles{0};      ///< 本帧重绘的图块数
+    uint32_t deferredTiles{0};     ///< 需要重绘但超出预算、推迟到后续帧的图块数
+    uint32_t casterDraws{0};       ///< 本帧的投射体绘制数
+    float estimatedMs{0.0f};       ///< 本帧重绘的估计 GPU 耗时
+};
+
+/**
+ * @class ShadowAtlas
+ * @brief 阴影图集的帧间状态：图块分配、缓存失效检测、更新调度与阴影绘制
+ * @details 图集是持久的外部纹理，阴影 Pass 以 eLoad 打开，只清除并重绘本帧调度的图块；
+ *          每个在途帧持有一份映射的视图/光源缓冲与描述符集（绑定 0 为比较采样的图集，1 为视图，2 为光源）。
+ *          深度管线按顶点格式各建一条，只读取位置属性，推送常量为 mat4 的 MVP。
+ *
+ * - 图集已满时降低新光源的图块尺寸，仍然放不下的光源本帧没有阴影（下一帧重试）；
+ * - 估计耗时 = 每图块固定开销 + 三角形数 x 单价，calibrate() 用实际测得的时间修正比例；
+ * - 几何池整理等改变网格缓冲的操作之后需要调用 invalidate()。
+ *
+ * @example
+ * @code
+ * shadowAtlas.update(scene, *camera, frameIndex);
+ * auto shadows = shadowAtlas.addPasses(builder, frameIndex);
+ * auto &draw = builder.addPass("ForwardPass", [&](vk::CommandBuffer cmd, const rendercore::RDGResourceAccessor &res) {
+ *     vk::DescriptorSet shadowSet = shadowAtlas.getDescriptorSet(shadows);
+ *     cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline->getLayout(), 2, shadowSet, nullptr);
+ *     // 推送或上传 shadowAtlas.getShadowIndex(light)，绘制...
+ * });
+ * shadowAtlas.readShadows(draw, shadows);
+ * // 帧结束后：shadowAtlas.calibrate(profiler.getAverageTime("ShadowAtlas"));
+ * @endcode
+ */
+class ShadowAtlas
+{
+  public:
+    static constexpr uint32_t kMaxCascades = 4;     ///< 最大级联数
+    static constexpr uint32_t kPointLightFaces = 6; ///< 点光源的立方体面数
+    static constexpr int32_t kNoShadow = -1;        ///< getShadowIndex() 对没有阴影的光源的返回值
+
+    /**
+     * @brief 构造函数
+     * @param device 逻辑设备
+     * @param allocator VMA 分配器
+     * @param layoutCache 描述符布局缓存
+     * @param depthShader shadow_depth.vert 编译得到的顶点着色器
+     * @param framesInFlight 在途帧数量
+     * @param settings 图集配置
+     * @throws std::invalid_argument 如果 framesInFlight 为 0、级联数量越界或图集尺寸无效
+     */
+    ShadowAtlas(vkcore::Device &device, VmaAllocator allocator, vkcore::DescriptorLayoutCache &layoutCache,
+                std::shared_ptr<vkcore::ShaderModule> depthShader, uint32_t framesInFlight,
+                const ShadowAtlasSettings &settings = {});
+    ~ShadowAtlas();
+
+    /** 禁用拷贝与移动 */
+    ShadowAtlas(const ShadowAtlas &) = delete;
+    ShadowAtlas &operator=(const ShadowAtlas &) = delete;
+
+    /**
+     * @brief 分配图块、检测缓存失效并调度第 frameIndex 帧要重绘的图块
+     * @param scene 场景（光源与投射体）
+     * @param camera 主摄像机（光源重要性与级联划分）
+     * @param frameIndex 在途帧索引（调用方保证该帧之前的 GPU 工作已完成）
+     */
+    void update(rendercore::Scene &scene, const rendercore::Camera &camera, uint32_t frameIndex);
+
+    /**
+     * @brief 向渲染图添加阴影 Pass（本帧没有要重绘的图块时只导入资源）
+     * @param builder 当前帧的渲染图构建器
+     * @param frameIndex 在途帧索引（与 update() 相同）
+     * @return ShadowAtlasOutputs 供着色 Pass 读取的资源句柄
+     */
+    ShadowAtlasOutputs addPasses(rendercore::RDGBuilder &builder, uint32_t frameIndex);
+
+    /**
+     * @brief 为着色 Pass 声明对图集与阴影缓冲的读取（片段着色器阶段）
+     * @note 每帧最多一个着色 Pass 调用（图集在帧末的布局据此记录）
+     */
+    void readShadows(rendercore::RDGPass &pass, const ShadowAtlasOutputs &outputs);
+
+    /**
+     * @brief 获取该帧的阴影描述符集
+     */
+    vk::DescriptorSet getDescriptorSet(const ShadowAtlasOutputs &outputs) const;
+
+    /**
+     * @brief 获取阴影描述符集布局（片段阶段可见）
+     */
+    vk::DescriptorSetLayout getSetLayout() const
+    {
+        return m_setLayout;
+    }
+
+    /**
+     * @brief 获取光源在 GPUShadowLight 数组中的索引（update() 之后有效）
+     * @return 索引，光源不投射阴影时返回 kNoShadow
+     */
+    int32_t getShadowIndex(const rendercore::Light *light) const;
+
+    /**
+     * @brief 丢弃所有图块的缓存内容，下一次 update() 起逐步重绘
+     */
+    void invalidate();
+
+    /**
+     * @brief 用实际测得的阴影 Pass 耗时修正耗时估计
+     * @param measuredMs 阴影 Pass 的平均 GPU 耗时（例如 RDGProfiler::getAverageTime("ShadowAtlas")，为 0 时忽略）
+     */
+    void calibrate(double measuredMs);
+
+    const ShadowAtlasStats &getStats() const
+    {
+        return m_stats;
+    }
+
+    const ShadowAtlasSettings &getSettings() const
+    {
+        return m_settings;
+    }
+
+  private:
+    /**
+     * @struct ShadowTile
+     * @brief 一个已分配的图块及其缓存状态
+     */
+    struct ShadowTile
+    {
+        ShadowAtlasRect rect;                   ///< 图集中的位置
+        glm::mat4 viewProjection{1.0f};         ///< 本帧需要的视图-投影矩阵
+        glm::mat4 renderedViewProjection{1.0f}; ///< 图块内容对应的视图-投影矩阵
+        float texelSize{0.0f};                  ///< 本帧矩阵的纹素世界尺寸
+        float renderedTexelSize{0.0f};          ///< 图块内容对应的纹素世界尺寸
+        float importance{0.0f};                 ///< 调度优先级的权重
+        uint64_t casterHash{0};                 ///< 本帧视锥内投射体的哈希
+        uint64_t renderedCasterHash{0};         ///< 图块内容对应的投射体哈希
+        glm::mat4 casterViewProjection{1.0f};   ///< casters 收集时使用的视图-投影矩阵
+        uint64_t casterStorageVersion{0};       ///< casters 对应的场景存储版本（0 表示需要重新收集）
+        uint32_t staleFrames{0};                ///< 需要重绘但被推迟的帧数
+        bool rendered{false};                   ///< 图块内容是否有效
+        std::vector<uint32_t> casters;          ///< 视锥内的渲染对象索引
+    };
+
+    /**
+     * @struct LightShadow
+     * @brief 一个投射阴影的光源
+     */
+    struct LightShadow
+    {
+        rendercore::LightType type{rendercore::LightType::Directional};
+        float importance{0.0f};         ///< 重要性（平行光最高）
+        uint32_t tileSize{0};           ///< 当前图块边长（0 表示未分配）
+        int32_t shadowIndex{kNoShadow}; ///< 在 GPUShadowLight 数组中的索引
+        glm::vec3 position{0.0f};       ///< 点光源位置
+        bool seen{false};               ///< 本帧是否仍在场景中
+        std::vector<ShadowTile> tiles;  ///< 级联、立方体面或单个图块
+    };
+
+    /**
+     * @struct TileDraw
+     * @brief 本帧要重绘的一个图块
+     */
+    struct TileDraw
+    {
+        ShadowAtlasRect rect;
+        uint32_t firstCaster{0};
+        uint32_t casterCount{0};
+    };
+
+    /**
+     * @struct CasterDraw
+     * @brief 一次投射体绘制
+     */
+    struct CasterDraw
+    {
+        vkcore::Buffer *vertexBuffer{nullptr};
+        vkcore::Buffer *indexBuffer{nullptr};
+        vk::IndexType indexType{vk::IndexType::eUint32};
+        rendercore::VertexFormat vertexFormat{rendercore::VertexFormat::Standard};
+        uint32_t firstIndex{0};
+        uint32_t indexCount{0};
+        int32_t vertexOffset{0};
+        glm::mat4 mvp{1.0f};
+    };
+
+    /**
+     * @struct FrameResources
+     * @brief 每个在途帧独占的缓冲、描述符集与绘制列表
+     */
+    struct FrameResources
+    {
+        std::unique_ptr<vkcore::Buffer> viewBuffer;  ///< GPUShadowView 数组（主机可见、常驻映射）
+        std::unique_ptr<vkcore::Buffer> lightBuffer; ///< GPUShadowLight 数组（主机可见、常驻映射）
+        vk::DescriptorSet descriptorSet;             ///< 着色阶段的描述符集
+        uint64_t dataVersion{0};                     ///< 缓冲中数据的版本（0 表示从未写入）
+        std::vector<TileDraw> tileDraws;             ///< 本帧重绘的图块
+        std::vector<CasterDraw> casterDraws;         ///< 本帧的投射体绘制
+    };
+
+    void collectlights(const rendercore::Scene &scene, const rendercore::Camera &camera);
+    void allocatetiles();
+    bool allocatelight(LightShadow &shadow, uint32_t tileSize);
+    uint32_t desiredtilesize(const LightShadow &shadow) const;
+    uint32_t viewcount(rendercore::LightType type) const;
+    void computeviews(const rendercore::Light &light, LightShadow &shadow, const rendercore::Camera &camera);
+    void computecascades(const glm::vec3 &lightDirection, LightShadow &shadow, const rendercore::Camera &camera);
+    void refreshcasters(ShadowTile &tile, const rendercore::SceneStorage &storage);
+    float estimatecost(const ShadowTile &tile, std::span<const rendercore::RenderObject> objects) const;
+    void schedule(const rendercore::SceneStorage &storage, FrameResources &frame);
+    void packgpudata();
+    void uploadgpudata(FrameResources &frame);
+    void releasetiles(LightShadow &shadow);
+
+  private:
+    vkcore::Device &m_device;
+    VmaAllocator m_allocator;
+    ShadowAtlasSettings m_settings;
+
+    std::unique_ptr<vkcore::Image> m_atlas;
+    vk::ImageLayout m_atlasLayout{vk::ImageLayout::eUndefined}; ///< 图集在上一帧末的布局
+    vk::Sampler m_compareSampler;                               ///< 硬件 PCF 比较采样器
+    std::array<std::unique_ptr<vkcore::Pipeline>, static_cast<size_t>(rendercore::VertexFormat::Count)> m_pipelines;
+
+    vk::DescriptorSetLayout m_setLayout;
+    std::unique_ptr<vkcore::DescriptorAllocator> m_descriptorAllocator;
+    std::vector<FrameResources> m_frames;
+
+    ShadowAtlasAllocator m_tileAllocator;
+    std::unordered_map<const rendercore::Light *, LightShadow> m_shadows;
+
+    // CPU 侧着色数据镜像（图块分配或内容变化时重建）
+    std::vector<GPUShadowView> m_views;
+    std::vector<GPUShadowLight> m_lights;
+    uint64_t m_dataVersion{1};
+    bool m_dataDirty{true};
+
+    // 耗时估计（calibrate() 按实测与估计的平均值之比修正 m_costScale）
+    float m_costScale{1.0f};
+    double m_estimatedAverageMs{0.0};
+
+    ShadowAtlasStats m_stats;
+};
+
+} // namespace renderer
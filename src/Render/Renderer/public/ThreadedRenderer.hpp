@@ -0,0 +1,333 @@
+/**
+ * @file ThreadedRenderer.hpp
+ * @brief 独立渲染线程与 CPU/GPU 帧流水线
+ * @details 主线程（Qt GUI 线程）只做场景更新与提取，把第 N+1 帧的渲染列表写入无锁邮箱；
+ *          渲染线程取出最新的一帧录制并提交第 N 帧，GPU 同时执行第 N-1 帧（由交换链的在途帧数保证）。
+ *          Qt 事件处理、窗口缩放都不再阻塞帧循环：缩放请求只记录尺寸，由渲染线程在帧间应用。
+ */
+
+#pragma once
+
+#include "Renderer.hpp"
+#include "Scene/public/Scene.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <glm/glm.hpp>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace renderer
+{
+
+/**
+ * @struct RenderViewSource
+ * @brief RenderFrameData::extractViews() 的一个视图
+ */
+struct RenderViewSource
+{
+    uint32_t viewId{0};                         ///< 视口 ID（原样写入 RenderViewData::viewId）
+    const rendercore::Camera *camera{nullptr}; ///< 视图相机（不可为空）
+};
+
+/**
+ * @struct RenderViewData
+ * @brief 多视口提取中一个视图的相机与剔除结果
+ */
+struct RenderViewData
+{
+    uint32_t viewId{0};                       ///< 视口 ID
+    glm::mat4 view{1.0f};                     ///< 相机视图矩阵
+    glm::mat4 projection{1.0f};               ///< 相机投影矩阵
+    glm::vec3 viewPosition{0.0f};             ///< 视点的世界空间位置
+    glm::vec3 viewForward{0.0f, 0.0f, -1.0f}; ///< 视线方向
+    std::vector<uint32_t> visibleObjects;     ///< 视锥内的对象，以 RenderFrameData::objects 索引（升序）
+    uint64_t contentKey{0};                   ///< 相机、场景数据与光照的哈希（不为 0），与上一帧相同时视图可以跳过
+};
+
+/**
+ * @struct RenderFrameData
+ * @brief 主线程从 Scene 提取的一帧渲染数据（提交后渲染线程只读）
+ * @warning objects 中的 mesh/material 是非拥有指针：从场景中移除的网格与材质，须等
+ *          ThreadedRenderer::getLastRenderedFrame() 不小于移除时已提交的帧号、且 GPU 完成该帧后再释放
+ */
+struct RenderFrameData
+{
+    uint64_t frameNumber{0};                         ///< 提取序号（从 1 开始递增）
+    std::chrono::steady_clock::time_point inputTime; ///< 提取开始的时刻（输入到呈现延迟的起点）
+    std::vector<rendercore::RenderObject> objects;   ///< 可见渲染对象
+    std::vector<glm::mat4> worldMatrices;            ///< 以 RenderObject::transformIndex 索引的世界矩阵
+    glm::mat4 view{1.0f};                            ///< 相机视图矩阵
+    glm::mat4 projection{1.0f};                      ///< 相机投影矩阵
+    glm::vec3 viewPosition{0.0f};                    ///< 视点的世界空间位置
+    glm::vec3 viewForward{0.0f, 0.0f, -1.0f};        ///< 视线方向
+    std::vector<RenderViewData> views;               ///< 多视口提取的各视图（extract() 时为空）
+
+    /**
+     * @brief 从场景提取可见对象、世界矩阵与相机（复用已有容量，稳态下不分配内存）
+     * @note 在拥有 Scene 的线程上调用；场景没有相机时保留上一次的相机参数
+     */
+    void extract(rendercore::Scene &scene);
+
+    /**
+     * @brief 为多个视口提取一帧：渲染对象与世界矩阵只同步、拷贝一次，各视图只保存剔除得到的下标
+     * @details objects 为场景的全部渲染对象（LOD 保持存储中的值），每个视图以自己的视锥剔除世界包围盒；
+     *          view/projection 等单相机字段取第一个视图，只读这些字段的后端因此不需要修改
+     * @param scene 场景
+     * @param sources 各视图的相机
+     * @param workers 任务调度器（包围盒较多时并行剔除，可为空）
+     * @throws std::invalid_argument 如果某个视图的相机为空
+     * @note 在拥有 Scene 的线程上调用
+     */
+    void extractViews(rendercore::Scene &scene, std::span<const RenderViewSource> sources,
+                      vkcore::WorkerPool *workers = nullptr);
+};
+
+/**
+ * @class RenderFrameMailbox
+ * @brief 单生产者/单消费者的无锁帧邮箱（最新值语义）
+ * @details 三个槽位轮换：生产者独占后台槽写入，publish() 与中间槽原子交换；
+ *          消费者独占前台槽读取，acquire() 在中间槽有新数据时与之交换。
+ *          双方都不等待对方，生产者跑得快时旧帧被直接覆盖，消费者总是拿到最新提交的一帧。
+ *
+ * @example
+ * @code
+ * // 生产者（主线程）
+ * mailbox.beginWrite().extract(scene);
+ * mailbox.publish();
+ *
+ * // 消费者（渲染线程）
+ * if (const RenderFrameData *frame = mailbox.acquire())
+ * {
+ *     render(*frame);
+ * }
+ * @endcode
+ */
+class RenderFrameMailbox
+{
+  public:
+    RenderFrameMailbox() = default;
+
+    /** 禁用拷贝与移动 */
+    RenderFrameMailbox(const RenderFrameMailbox &) = delete;
+    RenderFrameMailbox &operator=(const RenderFrameMailbox &) = delete;
+
+    /**
+     * @brief 获取生产者的写入槽（仅生产者线程调用，内容为三帧之前的旧数据）
+     */
+    RenderFrameData &beginWrite()
+    {
+        return m_slots[m_back];
+    }
+
+    /**
+     * @brief 提交写入槽并唤醒等待中的消费者（仅生产者线程调用）
+     */
+    void publish();
+
+    /**
+     * @brief 取出最新提交的一帧（仅消费者线程调用）
+     * @return 有新数据时返回前台槽，否则返回 nullptr；返回的数据在下一次 acquire() 之前保持有效
+     */
+    const RenderFrameData *acquire();
+
+    /**
+     * @brief 阻塞直到 publish() 或 notify() 的次数超过 seen
+     * @param seen 调用方上次观察到的 getSequence()
+     */
+    void wait(uint64_t seen) const
+    {
+        m_sequence.wait(seen, std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 唤醒等待中的消费者而不提交数据（用于停止线程）
+     */
+    void notify();
+
+    /**
+     * @brief 获取 publish()/notify() 的累计次数
+     */
+    uint64_t getSequence() const
+    {
+        return m_sequence.load(std::memory_order_acquire);
+    }
+
+  private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFreshBit = 0x4; ///< 中间槽包含消费者尚未取走的数据
+
+    std::array<RenderFrameData, 3> m_slots;
+    uint8_t m_back{0};                ///< 生产者独占
+    uint8_t m_front{1};               ///< 消费者独占
+    std::atomic<uint8_t> m_middle{2}; ///< 槽位索引 | kFreshBit
+    std::atomic<uint64_t> m_sequence{0};
+};
+
+/**
+ * @class ThreadedRenderer
+ * @brief 在独立渲染线程上驱动 Backend 的 IRenderer 实现
+ * @details render() 在主线程上调用：执行场景提取回调并把结果提交到邮箱，立即返回；
+ *          渲染线程等待新帧，应用挂起的缩放请求后调用 Backend::renderFrame()。
+ *          Backend 的所有方法都在渲染线程上执行，Vulkan 队列提交与呈现因此只来自一个线程。
+ *
+ * @example
+ * @code
+ * auto threaded = std::make_unique<renderer::ThreadedRenderer>(std::make_unique<MyBackend>());
+ * threaded->setSceneExtractor([&scene](renderer::RenderFrameData &frame) { frame.extract(scene); });
+ * threaded->initialize();                           // 在渲染线程上初始化 Backend，等待结果
+ * QObject::connect(timer, &QTimer::timeout, [&] { threaded->render(); });
+ * QObject::connect(window, &QWindow::widthChanged, [&] { threaded->requestResize(w, h); });
+ * @endcode
+ */
+class ThreadedRenderer : public IRenderer
+{
+  public:
+    /**
+     * @class Backend
+     * @brief 渲染线程上的帧后端（录制、提交与呈现）
+     */
+    class Backend
+    {
+      public:
+        virtual ~Backend() = default;
+
+        /**
+         * @brief 创建 Vulkan 资源（渲染线程）
+         * @return 是否成功
+         */
+        virtual bool initialize() = 0;
+
+        /**
+         * @brief 录制、提交并呈现一帧（渲染线程）
+         * @param frame 主线程提取的帧数据，在返回前保持有效
+         */
+        virtual void renderFrame(const RenderFrameData &frame) = 0;
+
+        /**
+         * @brief 应用窗口缩放（渲染线程，在两帧之间调用）
+         * @param width 新的宽度（像素）
+         * @param height 新的高度（像素）
+         */
+        virtual void resize(uint32_t width, uint32_t height) = 0;
+
+        /**
+         * @brief 应用某个视口的窗口缩放（渲染线程，在两帧之间调用）
+         * @details 默认把视口 0 转发给 resize()，多视口后端重写本函数
+         * @param view 视口 ID（小于 ThreadedRenderer::kMaxViews）
+         * @param width 新的宽度（像素）
+         * @param height 新的高度（像素）
+         */
+        virtual void resizeView(uint32_t view, uint32_t width, uint32_t height)
+        {
+            if (view == 0)
+            {
+                resize(width, height);
+            }
+        }
+
+        /**
+         * @brief 销毁 Vulkan 资源（渲染线程，线程退出前调用）
+         */
+        virtual void cleanup() = 0;
+    };
+
+    /**
+     * @brief 场景提取回调（主线程），把本帧数据写入 frame
+     */
+    using SceneExtractor = std::function<void(RenderFrameData &frame)>;
+
+    /// @brief 可以单独请求缩放的视口数量上限
+    static constexpr uint32_t kMaxViews = 8;
+
+    /**
+     * @brief 构造函数
+     * @param backend 帧后端（不可为空）
+     * @throws std::invalid_argument 如果 backend 为空
+     */
+    explicit ThreadedRenderer(std::unique_ptr<Backend> backend);
+
+    /**
+     * @brief 析构函数，自动调用 cleanup()
+     */
+    ~ThreadedRenderer() override;
+
+    /** 禁用拷贝与移动 */
+    ThreadedRenderer(const ThreadedRenderer &) = delete;
+    ThreadedRenderer &operator=(const ThreadedRenderer &) = delete;
+
+    /**
+     * @brief 设置场景提取回调（在 initialize() 之前或主线程上调用）
+     * @details 未设置时 render() 提交只带帧号的空帧，适合不依赖 Scene 的示例
+     */
+    void setSceneExtractor(SceneExtractor extractor)
+    {
+        m_extractor = std::move(extractor);
+    }
+
+    /**
+     * @brief 启动渲染线程并在其上初始化 Backend
+     * @return Backend::initialize() 的结果；失败时线程已退出
+     */
+    bool initialize() override;
+
+    /**
+     * @brief 提取并提交下一帧（主线程，不等待渲染线程）
+     */
+    void render() override;
+
+    /**
+     * @brief 停止渲染线程（等待当前帧结束，在渲染线程上调用 Backend::cleanup()）
+     */
+    void cleanup() override;
+
+    /**
+     * @brief 获取渲染线程已完成的帧数
+     */
+    uint64_t getFrameCount() const override
+    {
+        return m_renderedFrames.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 请求缩放（任意线程），渲染线程在下一帧之前调用 Backend::resize()；多次请求只应用最后一次
+     */
+    void requestResize(uint32_t width, uint32_t height);
+
+    /**
+     * @brief 请求某个视口的缩放（任意线程），渲染线程在下一帧之前调用 Backend::resizeView()
+     * @throws std::invalid_argument 如果 view 不小于 kMaxViews
+     */
+    void requestResize(uint32_t view, uint32_t width, uint32_t height);
+
+    /**
+     * @brief 获取渲染线程最近一次交给 Backend 的 RenderFrameData::frameNumber（0 表示尚未渲染）
+     */
+    uint64_t getLastRenderedFrame() const
+    {
+        return m_lastRenderedFrame.load(std::memory_order_acquire);
+    }
+
+  private:
+    void renderloop();
+
+  private:
+    std::unique_ptr<Backend> m_backend;
+    SceneExtractor m_extractor;
+    RenderFrameMailbox m_mailbox;
+    std::thread m_thread;
+
+    uint64_t m_submittedFrames{0};                ///< 主线程提交的帧号
+    std::atomic<bool> m_running{false};           ///< 渲染线程运行中（cleanup() 清除）
+    std::atomic<uint64_t> m_renderedFrames{0};    ///< 已完成的帧数
+    std::atomic<uint64_t> m_lastRenderedFrame{0}; ///< 最近渲染的 frameNumber
+
+    /// 各视口挂起的缩放：(width << 32) | height，0 表示没有
+    std::array<std::atomic<uint64_t>, kMaxViews> m_pendingResizes{};
+};
+
+} // namespace renderer
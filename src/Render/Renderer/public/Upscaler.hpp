@@ -0,0 +1,137 @@
+/**
+ * @file Upscaler.hpp
+ * @brief 动态分辨率的最终放大 Pass
+ * @details 把按渲染缩放绘制的场景颜色放大到输出分辨率，直接写入导入的交换链图像：
+ *          - Bilinear：一次全屏三角形的双线性采样；
+ *          - EdgeAdaptive：FSR1 风格的两步——边缘自适应的 12 点 Lanczos2 放大（EASU 风格，核沿边缘方向拉伸，
+ *            结果钳制到最近 2x2 纹素的范围以抑制振铃），再做一次对比度自适应锐化（RCAS 风格）。
+ *          放大以片段着色器实现：交换链的 sRGB 格式通常不支持存储图像，颜色附件写入还能由硬件完成 sRGB 编码。
+ *          EdgeAdaptive 的中间结果是输出分辨率的 RGBA16F 瞬态纹理。
+ */
+
+#pragma once
+
+#include "RenderGraph/public/RDGBuilder.hpp"
+#include "VulkanCore/public/Descriptor.hpp"
+#include "VulkanCore/public/Pipeline.hpp"
+#include <glm/glm.hpp>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace renderer
+{
+
+/**
+ * @enum UpscaleMode
+ * @brief 放大算法
+ */
+enum class UpscaleMode : uint32_t
+{
+    Bilinear = 0,     ///< 双线性
+    EdgeAdaptive = 1, ///< 边缘自适应 Lanczos2 + 对比度自适应锐化
+};
+
+/**
+ * @struct UpscalePushConstants
+ * @brief 放大与锐化着色器的推送常量
+ */
+struct UpscalePushConstants
+{
+    glm::vec2 inputSize;  ///< 输入纹理尺寸（像素）
+    glm::vec2 outputSize; ///< 输出尺寸（像素）
+    float sharpness;      ///< 锐化强度 [0, 1]（仅 RCAS）
+};
+
+/**
+ * @class Upscaler
+ * @brief 放大 Pass 的管线与描述符（跨帧持久）
+ * @details 管线按（算法, 输出格式）懒创建并保留到析构，交换链重建改变格式时无需等待在途帧。
+ *
+ * @example
+ * @code
+ * const vk::Extent2D output = swapchain.getSwapchainExtent();
+ * builder.setRenderScale(resolution.update(profiler));
+ * const vk::Extent2D scaled = builder.getScaledExtent(output);
+ * // ... 以 scaled 为视口把场景绘制到 Scaled 类别的 sceneColor ...
+ * rendercore::RDGTextureHandle backbuffer = builder.getSwapChainAttachment(swapchain, imageIndex);
+ * upscaler.addPasses(builder, frameIndex, sceneColor, scaled, backbuffer, output,
+ *                    swapchain.getSwapchainFormat(), renderer::UpscaleMode::EdgeAdaptive, 0.5f);
+ * @endcode
+ */
+class Upscaler
+{
+  public:
+    /** EdgeAdaptive 中间纹理格式 */
+    static constexpr vk::Format kIntermediateFormat = vk::Format::eR16G16B16A16Sfloat;
+
+    /**
+     * @brief 构造函数
+     * @param device 逻辑设备
+     * @param layoutCache 描述符布局缓存
+     * @param fullscreenShader fullscreen.vert 编译得到的顶点着色器
+     * @param upscaleShader upscale.frag 编译得到的片段着色器（特化常量 0 选择算法）
+     * @param sharpenShader rcas.frag 编译得到的片段着色器（可为空，此时 EdgeAdaptive 不锐化）
+     * @param framesInFlight 在途帧数量
+     * @throws std::invalid_argument 如果必需的着色器为空或 framesInFlight 为 0
+     */
+    Upscaler(vkcore::Device &device, vkcore::DescriptorLayoutCache &layoutCache,
+             std::shared_ptr<vkcore::ShaderModule> fullscreenShader,
+             std::shared_ptr<vkcore::ShaderModule> upscaleShader, std::shared_ptr<vkcore::ShaderModule> sharpenShader,
+             uint32_t framesInFlight);
+    ~Upscaler();
+
+    /** 禁用拷贝与移动 */
+    Upscaler(const Upscaler &) = delete;
+    Upscaler &operator=(const Upscaler &) = delete;
+
+    /**
+     * @brief 添加放大（及锐化）Pass
+     * @param builder 当前帧的渲染图构建器
+     * @param frameIndex 在途帧索引
+     * @param input 按渲染缩放绘制的颜色纹理（之前的 Pass 中写入）
+     * @param inputExtent 输入纹理的实际尺寸（RDGBuilder::getScaledExtent()）
+     * @param output 输出纹理（通常为 getSwapChainAttachment() 导入的交换链图像），整幅覆盖
+     * @param outputExtent 输出尺寸
+     * @param outputFormat 输出格式
+     * @param mode 放大算法
+     * @param sharpness 锐化强度 [0, 1]（仅 EdgeAdaptive，0 或没有锐化着色器时跳过锐化 Pass）
+     * @throws std::invalid_argument 如果 frameIndex 越界、句柄无效或尺寸为 0
+     */
+    void addPasses(rendercore::RDGBuilder &builder, uint32_t frameIndex, rendercore::RDGTextureHandle input,
+                   vk::Extent2D inputExtent, rendercore::RDGTextureHandle output, vk::Extent2D outputExtent,
+                   vk::Format outputFormat, UpscaleMode mode, float sharpness = 0.0f);
+
+  private:
+    /**
+     * @enum Stage
+     * @brief 管线种类
+     */
+    enum class Stage : uint32_t
+    {
+        Bilinear = 0,
+        EdgeAdaptive = 1,
+        Sharpen = 2,
+    };
+
+    vkcore::Pipeline &getpipeline(Stage stage, vk::Format format);
+    void addfullscreenpass(rendercore::RDGBuilder &builder, const char *name, Stage stage, vk::Format format,
+                           vk::DescriptorSet set, rendercore::RDGTextureHandle input,
+                           rendercore::RDGTextureHandle output, const UpscalePushConstants &push);
+
+  private:
+    vkcore::Device &m_device;
+    std::shared_ptr<vkcore::ShaderModule> m_fullscreenShader;
+    std::shared_ptr<vkcore::ShaderModule> m_upscaleShader;
+    std::shared_ptr<vkcore::ShaderModule> m_sharpenShader;
+
+    vk::DescriptorSetLayout m_setLayout;
+    std::unique_ptr<vkcore::DescriptorAllocator> m_descriptorAllocator;
+    std::vector<vk::DescriptorSet> m_upscaleSets; ///< 每个在途帧一个（放大 Pass）
+    std::vector<vk::DescriptorSet> m_sharpenSets; ///< 每个在途帧一个（锐化 Pass）
+
+    std::map<std::pair<Stage, vk::Format>, std::unique_ptr<vkcore::Pipeline>> m_pipelines;
+};
+
+} // namespace renderer
@@ -0,0 +1,261 @@
+/**
+ * @file ViewportSet.hpp
+ * @brief 共享一个 Device 的多视口帧循环
+ * @details 多个嵌入的窗口（例如透视视图加三个正交视图）各有一个交换链，但共用设备、资源管理器、管线缓存与
+ *          一条帧时间线：每帧各视口分别获取图像，所有视口的命令缓冲区在一次 vkQueueSubmit2 中提交，
+ *          再以一次 vkQueuePresentKHR 呈现全部交换链。每帧只推进一次时间线，每帧资源（命令池环、
+ *          延迟销毁、上传）按同一个帧号回收，不随视口数量增加。
+ *
+ *          视口的内容键（相机与场景内容的哈希，见 RenderViewData::contentKey）与上一次呈现时相同、
+ *          交换链也没有重建时跳过该视口：不获取图像、不录制、不呈现，窗口保留上一次呈现的画面。
+ *          只有相机在动的视口才有 CPU 与 GPU 开销。
+ */
+
+#pragma once
+
+#include "VulkanCore/public/SwapChain.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace rendercore
+{
+struct RDGSyncInfo;
+} // namespace rendercore
+
+namespace renderer
+{
+
+/**
+ * @struct ViewportStats
+ * @brief 多视口的累计统计
+ */
+struct ViewportStats
+{
+    uint64_t frames{0};        ///< 提交过工作的帧数
+    uint64_t renderedViews{0}; ///< 录制并呈现的视口次数
+    uint64_t skippedViews{0};  ///< 内容未变而跳过的视口次数
+};
+
+/**
+ * @class ViewportSet
+ * @brief 一组共享帧时间线的交换链
+ * @warning 除 addView() 的表面支持检查外，所有方法都在同一个线程（渲染线程）上调用
+ *
+ * @example
+ * @code
+ * renderer::ViewportSet viewports(device, allocator);
+ * const uint32_t perspective = viewports.addView(perspectiveSurface);
+ * const uint32_t top = viewports.addView(topSurface);
+ * vkcore::CommandPoolManager frameCommands(device, graphicsFamily, viewports.getFrameTimeline());
+ *
+ * // 每帧
+ * vkcore::CommandBufferHandle cmd = frameCommands.allocate();
+ * for (const renderer::RenderViewData &view : frame.views)
+ * {
+ *     uint32_t imageIndex;
+ *     if (viewports.acquire(view.viewId, view.contentKey, imageIndex))
+ *     {
+ *         recordView(*cmd, viewports.getSwapChain(view.viewId), imageIndex, frame, view);
+ *     }
+ * }
+ * viewports.submitAndPresent(commandBufferInfos, frame.inputTime); // 没有视口获取图像时不提交
+ * @endcode
+ */
+class ViewportSet
+{
+  public:
+    /**
+     * @brief 构造函数，创建共享的帧时间线（尚无视口）
+     * @param device 逻辑设备（需要启用 timelineSemaphore）
+     * @param allocator VMA 分配器
+     * @param framesInFlight 在途帧数
+     * @throws std::invalid_argument 如果 framesInFlight 为 0
+     */
+    ViewportSet(vkcore::Device &device, VmaAllocator allocator,
+                uint32_t framesInFlight = vkcore::SwapChain::MAX_FRAMES_IN_FLIGHT);
+
+    /**
+     * @brief 析构函数，等待所有帧完成后销毁交换链
+     */
+    ~ViewportSet();
+
+    /** 禁用拷贝与移动 */
+    ViewportSet(const ViewportSet &) = delete;
+    ViewportSet &operator=(const ViewportSet &) = delete;
+
+    // ==================== 视口管理 ====================
+
+    /**
+     * @brief 为表面创建交换链并加入视口集合
+     * @param surface 视口窗口的表面
+     * @param policy 呈现策略
+     * @return uint32_t 视口 ID（移除的 ID 会被之后添加的视口复用）
+     * @throws std::runtime_error 如果设备的呈现队列不支持该表面或交换链创建失败
+     */
+    uint32_t addView(vk::SurfaceKHR surface, const vkcore::PresentPolicy &policy = {});
+
+    /**
+     * @brief 移除视口（等待所有在途帧完成后销毁其交换链，表面由调用者销毁）
+     * @throws std::invalid_argument 如果视口不存在
+     * @throws std::runtime_error 如果本帧已获取了该视口的图像
+     */
+    void removeView(uint32_t view);
+
+    /**
+     * @brief 视口是否存在
+     */
+    bool hasView(uint32_t view) const
+    {
+        return view < m_views.size() && m_views[view].swapchain != nullptr;
+    }
+
+    /**
+     * @brief 获取视口 ID 的上界（遍历时用 hasView() 跳过已移除的 ID）
+     */
+    uint32_t getViewCapacity() const
+    {
+        return static_cast<uint32_t>(m_views.size());
+    }
+
+    /**
+     * @brief 获取视口的交换链
+     * @throws std::invalid_argument 如果视口不存在
+     */
+    vkcore::SwapChain &getSwapChain(uint32_t view);
+
+    /**
+     * @brief 窗口缩放：请求（防抖后的）交换链重建，重建完成前后都不跳过该视口
+     * @throws std::invalid_argument 如果视口不存在
+     */
+    void requestResize(uint32_t view);
+
+    /**
+     * @brief 强制视口在下一帧重新渲染（渲染设置、后处理参数等不在内容键中的状态改变时）
+     * @throws std::invalid_argument 如果视口不存在
+     */
+    void invalidate(uint32_t view);
+
+    /**
+     * @brief 强制所有视口在下一帧重新渲染
+     */
+    void invalidateAll();
+
+    // ==================== 帧循环 ====================
+
+    /**
+     * @brief 获取视口本帧要渲染的交换链图像
+     * @param view 视口 ID
+     * @param contentKey 视口内容的哈希（0 表示未知，总是渲染）
+     * @param[out] imageIndex 获取到的图像索引
+     * @return 需要录制该视口时返回 true；内容未变、交换链过期或窗口最小化时返回 false（本帧跳过该视口）
+     * @throws std::invalid_argument 如果视口不存在
+     * @throws std::runtime_error 如果本帧已获取过该视口的图像，或获取图像失败
+     */
+    bool acquire(uint32_t view, uint64_t contentKey, uint32_t &imageIndex);
+
+    /**
+     * @brief 在一次提交中执行本帧的命令缓冲区，以一次呈现调用呈现所有获取了图像的视口，然后推进到下一帧
+     * @details 提交等待各视口的图像可用信号量，触发各视口的渲染完成信号量与帧时间线；
+     *          没有视口获取图像且没有命令缓冲区时什么也不做，本帧不消耗帧号（与交换链过期时跳帧相同）
+     * @param commandBuffers 本帧的命令缓冲区（按顺序执行）
+     * @param inputTime 本帧采样输入的时刻（延迟统计，默认取各视口获取图像的时刻）
+     * @param waitStage 图像可用信号量的等待阶段（首次写入交换链图像的阶段）
+     * @throws std::runtime_error 如果提交或呈现失败
+     */
+    void submitAndPresent(std::span<const vk::CommandBufferSubmitInfo> commandBuffers,
+                          std::chrono::steady_clock::time_point inputTime = {},
+                          vk::PipelineStageFlags2 waitStage = vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+
+    /**
+     * @brief 渲染图路径：把本帧的提交同步加入 syncInfo（等待各视口的图像可用，触发各视口的渲染完成与帧时间线）
+     * @details 与 present() 成对使用以代替 submitAndPresent()：渲染图直接写入 getSwapChainAttachment() 导入的
+     *          交换链图像并在图末尾转换到呈现布局，execute(&syncInfo) 的最后一个批次触发本帧的时间线值
+     * @param syncInfo 本帧渲染图的同步信息
+     * @param waitStage 图像可用信号量的等待阶段（首次写入交换链图像的阶段）
+     * @warning 只在本帧有视口获取了图像时使用；渲染图必须在图形队列上执行（异步计算只用于中间的批次）
+     */
+    void appendSubmitSync(rendercore::RDGSyncInfo &syncInfo,
+                          vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eColorAttachmentOutput) const;
+
+    /**
+     * @brief 渲染图路径：带 appendSubmitSync() 同步的渲染图执行之后，以一次呈现调用呈现所有获取了图像的视口，
+     *        然后推进到下一帧
+     * @param inputTime 本帧采样输入的时刻（延迟统计，默认取各视口获取图像的时刻）
+     * @throws std::runtime_error 如果本帧没有视口获取图像，或呈现失败
+     */
+    void present(std::chrono::steady_clock::time_point inputTime = {});
+
+    /**
+     * @brief 本帧已获取图像的视口数量
+     */
+    uint32_t getAcquiredCount() const
+    {
+        return static_cast<uint32_t>(m_acquired.size());
+    }
+
+    /**
+     * @brief 调整在途帧数（等待设备空闲，所有视口的每帧信号量按新数量重建）
+     * @throws std::invalid_argument 如果 framesInFlight 为 0
+     * @throws std::runtime_error 如果本帧已获取了图像
+     */
+    void setFramesInFlight(uint32_t framesInFlight);
+
+    /**
+     * @brief 获取共享的帧时间线（命令池环、延迟销毁队列等按帧回收的系统关联到它）
+     */
+    vkcore::FrameTimeline &getFrameTimeline()
+    {
+        return *m_timeline;
+    }
+
+    /**
+     * @brief 获取当前帧的槽位（索引每帧资源）
+     */
+    uint32_t getFrameSlot() const
+    {
+        return m_timeline->getFrameSlot();
+    }
+
+    /**
+     * @brief 获取累计统计
+     */
+    const ViewportStats &getStats() const
+    {
+        return m_stats;
+    }
+
+  private:
+    /**
+     * @struct View
+     * @brief 一个视口的交换链与跳帧状态
+     */
+    struct View
+    {
+        std::unique_ptr<vkcore::SwapChain> swapchain;
+        uint64_t presentedKey{0};        ///< 上一次呈现的内容键（0 表示没有有效画面）
+        uint64_t presentedGeneration{0}; ///< 上一次呈现时的交换链代数
+        uint64_t pendingKey{0};          ///< 本帧获取图像时的内容键
+        uint32_t imageIndex{0};          ///< 本帧获取的图像
+        bool acquired{false};            ///< 本帧已获取图像
+    };
+
+    View &getview(uint32_t view, const char *caller);
+
+    /**
+     * @brief 呈现本帧获取了图像的视口（渲染完成信号量已由本帧的提交触发），然后推进到下一帧
+     */
+    void presentacquired(std::chrono::steady_clock::time_point inputTime);
+
+  private:
+    vkcore::Device &m_device;
+    VmaAllocator m_allocator;
+    std::unique_ptr<vkcore::FrameTimeline> m_timeline; ///< 先于交换链创建、后于交换链销毁
+    std::vector<View> m_views;
+    std::vector<uint32_t> m_acquired; ///< 本帧获取了图像的视口，按获取顺序
+    ViewportStats m_stats;
+};
+
+} // namespace renderer
@@ -0,0 +1,468 @@
+/**
+ * @file VirtualTexture.hpp
+ * @brief 反馈驱动的稀疏虚拟纹理（页表 + 物理页缓存图集）
+ * @details 地形、厂房地面贴花等总量达数十 GB 的纹理按固定尺寸的页切分（每页含边框，图集内双线性过滤不越界），
+ *          只有当前画面实际用到的页驻留在一张 RGBA8 图集中。每帧：
+ *          1. addFeedbackPass() 以 1/feedbackScale 分辨率绘制可见几何，每个像素输出所需页的 ID（R32_UINT），
+ *             结果拷贝到主机可见的回读缓冲；
+ *          2. framesInFlight 帧后 update() 读回反馈，去重后为缺失的页（连同它们的祖先页）在线程池上解码，
+ *             解码完成的页经 UploadQueue 批量上传到显存中的暂存区，按 LRU 淘汰最久未被请求的页腾出图集槽位；
+ *          3. addPasses() 把上传完成的页从暂存区拷贝进图集，并把改变了的页表区域拷贝到页表纹理。
+ *
+ *          页表每个 mip 对应一级页（mip m 的一页覆盖 mip 0 的 2^m x 2^m 页），每个纹素记录“覆盖该页的最精细
+ *          已驻留页”在图集中的槽位与它的 mip，着色器总能采样到某个已驻留的祖先，模糊但不出现空洞。
+ *          最粗一级只有一页，驻留后锁定不淘汰。显存占用由屏幕分辨率决定的工作集决定，与纹理总量无关。
+ *
+ *          设备支持稀疏驻留（sparseResidencyImage2D）且稀疏图块能整除页尺寸时图集以稀疏 Image 创建，
+ *          槽位第一次使用时才绑定内存，图集内存随实际驻留的页增长；否则一次分配整张图集。
+ */
+
+#pragma once
+
+#include "RenderGraph/public/RDGBuilder.hpp"
+#include "VulkanCore/public/Descriptor.hpp"
+#include "VulkanCore/public/UploadQueue.hpp"
+#include "VulkanCore/public/VKResource.hpp"
+#include "VulkanCore/public/WorkerPool.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <glm/glm.hpp>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace vkcore
+{
+class DeferredDeletionQueue;
+class FrameTimeline;
+} // namespace vkcore
+
+namespace rendercore
+{
+class ResourceManager;
+} // namespace rendercore
+
+namespace renderer
+{
+
+/**
+ * @struct VirtualPageId
+ * @brief 虚拟纹理中的一页
+ */
+struct VirtualPageId
+{
+    uint32_t x{0};   ///< 该 mip 内的页列
+    uint32_t y{0};   ///< 该 mip 内的页行
+    uint32_t mip{0}; ///< 页所在的 mip（0 为最精细）
+};
+
+/**
+ * @struct VirtualTextureSettings
+ * @brief 虚拟纹理的尺寸与流送策略
+ */
+struct VirtualTextureSettings
+{
+    uint32_t pageCountX = 128;                     ///< mip 0 横向页数（不超过 kMaxPageCount）
+    uint32_t pageCountY = 128;                     ///< mip 0 纵向页数（不超过 kMaxPageCount）
+    uint32_t pageSize = 128;                       ///< 页边长（纹素，含边框）
+    uint32_t pageBorder = 4;                       ///< 页每侧的边框宽度（纹素）
+    uint32_t atlasPages = 32;                      ///< 图集每边的槽位数（图集边长为 atlasPages * pageSize）
+    vk::Format format = vk::Format::eR8G8B8A8Srgb; ///< 页格式（RGBA8 Unorm 或 sRGB）
+    uint32_t feedbackScale = 8;                    ///< 反馈缓冲相对渲染分辨率的缩小倍数
+    uint32_t maxUploadsPerFrame = 16;              ///< 每帧最多上传的页数
+    uint32_t maxPendingDecodes = 64;               ///< 同时在解码的页数上限
+};
+
+/**
+ * @struct GPUVirtualTextureParams
+ * @brief virtual_texture.glsl 的 uniform 缓冲布局（std140）
+ */
+struct GPUVirtualTextureParams
+{
+    glm::uvec2 pageCount;  ///< mip 0 的页数
+    glm::vec2 atlasTexel;  ///< 图集纹素尺寸的倒数
+    uint32_t pageSize;     ///< 页边长（含边框）
+    uint32_t pageBorder;   ///< 页边框宽度
+    uint32_t maxMip;       ///< 最粗一级页的 mip
+    float feedbackLodBias; ///< 反馈 Pass 的 LOD 偏移（-log2(feedbackScale)，补偿低分辨率下偏大的导数）
+};
+
+/**
+ * @struct VirtualTextureOutputs
+ * @brief 一帧渲染图中虚拟纹理的句柄
+ */
+struct VirtualTextureOutputs
+{
+    rendercore::RDGTextureHandle pageTable = rendercore::kInvalidTextureHandle; ///< 页表（R32_UINT，每级页一个 mip）
+    rendercore::RDGTextureHandle atlas = rendercore::kInvalidTextureHandle;     ///< 物理页缓存图集
+};
+
+/**
+ * @struct VirtualTextureStats
+ * @brief 虚拟纹理统计（最近一次 update() 的结果）
+ */
+struct VirtualTextureStats
+{
+    uint32_t requestedPages{0};   ///< 最近一次读回的反馈中不同页的数量
+    uint32_t residentPages{0};    ///< 已驻留的页数
+    uint32_t pendingDecodes{0};   ///< 正在解码的页数
+    uint32_t pendingUploads{0};   ///< 已提交上传、尚未拷入图集的页数
+    uint32_t uploadedPages{0};    ///< 本帧提交上传的页数
+    uint32_t evictedPages{0};     ///< 本帧淘汰的页数
+    uint32_t missingPages{0};     ///< 页提供者无法给出的页数（以祖先页代替）
+    vk::DeviceSize atlasBytes{0}; ///< 图集实际占用的显存（稀疏图集只计已绑定的图块）
+    bool sparse{false};           ///< 图集是否为稀疏驻留
+};
+
+/**
+ * @class VirtualTexture
+ * @brief 页表、页缓存图集与反馈驱动的页流送
+ * @details 着色器通过 virtual_texture.glsl 访问：描述符集绑定 0 为页表，1 为图集，2 为 GPUVirtualTextureParams。
+ *          采样的 Pass 需要调用 readVirtualTexture() 声明读取；反馈 Pass 的管线片段着色器为
+ *          virtual_texture_feedback.frag，颜色附件格式为 kFeedbackFormat，深度附件格式为 kFeedbackDepthFormat。
+ *          页提供者在工作线程上并发调用，写入 pageSize x pageSize 的 RGBA8 纹素（含边框，行优先）。
+ * @warning update()、addFeedbackPass()、addPasses() 在渲染线程上、帧时间线 beginFrame() 之后调用
+ *
+ * @example
+ * @code
+ * renderer::VirtualTexture terrain(device, allocator, layoutCache, resourceManager, frameTimeline,
+ *                                  renderer::VirtualTexture::createTileDirectoryProvider("assets/terrain_vt", 128),
+ *                                  settings, &workers);
+ *
+ * // 每帧
+ * terrain.update();
+ * renderer::VirtualTextureOutputs vt = terrain.addPasses(builder);
+ * terrain.addFeedbackPass(builder, renderExtent, [&](vk::CommandBuffer cmd, vk::Extent2D extent) {
+ *     drawTerrain(cmd, feedbackPipeline, extent); // 绑定 terrain.getDescriptorSet()
+ * });
+ * auto &scene = builder.addPass("Scene", drawScene).writeColorAttachment(sceneColor);
+ * terrain.readVirtualTexture(scene, vt);
+ * @endcode
+ */
+class VirtualTexture
+{
+  public:
+    /**
+     * @brief 页提供者：解码一页的纹素，返回 false 表示该页不存在（着色器以祖先页代替）
+     */
+    using PageProvider = std::function<bool(const VirtualPageId &page, std::span<std::byte> texels)>;
+
+    /**
+     * @brief 反馈绘制回调：在反馈 Pass 内以反馈管线绘制可见几何
+     * @param cmd 命令缓冲（动态渲染已开始）
+     * @param extent 反馈缓冲的尺寸（视口与裁剪矩形需按它设置）
+     */
+    using FeedbackCallback = std::function<void(vk::CommandBuffer cmd, vk::Extent2D extent)>;
+
+    /** 反馈缓冲格式 */
+    static constexpr vk::Format kFeedbackFormat = vk::Format::eR32Uint;
+    /** 反馈 Pass 的深度格式 */
+    static constexpr vk::Format kFeedbackDepthFormat = vk::Format::eD32Sfloat;
+    /** 页表格式 */
+    static constexpr vk::Format kPageTableFormat = vk::Format::eR32Uint;
+    /** 反馈中没有请求页的像素（清除值） */
+    static constexpr uint32_t kInvalidPage = 0xFFFFFFFFu;
+    /** 页表中没有任何祖先驻留的纹素 */
+    static constexpr uint32_t kInvalidEntry = 0xFFFFFFFFu;
+    /** 每个方向的最大页数（页 ID 中坐标占 14 位） */
+    static constexpr uint32_t kMaxPageCount = 1u << 14;
+    /** 图集每边的最大槽位数（页表条目中槽位坐标占 12 位） */
+    static constexpr uint32_t kMaxAtlasPages = 1u << 12;
+
+    /**
+     * @brief 打包页 ID（与 virtual_texture.glsl 的 vtFeedback() 一致）
+     */
+    static uint32_t packPage(const VirtualPageId &page)
+    {
+        return page.x | (page.y << 14) | (page.mip << 28);
+    }
+
+    /**
+     * @brief 解包页 ID
+     */
+    static VirtualPageId unpackPage(uint32_t packed)
+    {
+        return VirtualPageId{packed & 0x3FFFu, (packed >> 14) & 0x3FFFu, packed >> 28};
+    }
+
+    /**
+     * @brief 从预切分的页文件目录读取页的提供者
+     * @details 页文件为 directory/<mip>/<x>_<y><extension>，由 TextureLoader 解码为 RGBA8，
+     *          尺寸必须为 pageSize x pageSize（含边框）；文件不存在或尺寸不符时该页视为不存在
+     * @param directory 页文件根目录
+     * @param pageSize 页边长（与 VirtualTextureSettings::pageSize 一致）
+     * @param extension 页文件扩展名（TextureLoader 支持的格式）
+     */
+    static PageProvider createTileDirectoryProvider(std::filesystem::path directory, uint32_t pageSize,
+                                                    std::string extension = ".png");
+
+    /**
+     * @brief 构造函数，创建页表、图集、暂存区与描述符集，并请求最粗一级的页
+     * @param device 逻辑设备
+     * @param allocator VMA 分配器
+     * @param layoutCache 描述符布局缓存
+     * @param resources 资源管理器（页数据经它的上传队列批量上传）
+     * @param timeline 帧时间线（暂存区与回读缓冲按帧号回收）
+     * @param provider 页提供者
+     * @param settings 尺寸与流送策略
+     * @param workers 解码页使用的线程池（为空时在 update() 中同步解码，每帧不超过 maxUploadsPerFrame 页）
+     * @throws std::invalid_argument 如果设置越界（页数、边框、图集槽位、格式）或 provider 为空
+     * @throws std::runtime_error 如果资源管理器没有上传队列
+     */
+    VirtualTexture(vkcore::Device &device, VmaAllocator allocator, vkcore::DescriptorLayoutCache &layoutCache,
+                   rendercore::ResourceManager &resources, vkcore::FrameTimeline &timeline, PageProvider provider,
+                   const VirtualTextureSettings &settings = {}, vkcore::WorkerPool *workers = nullptr);
+
+    /**
+     * @brief 析构函数，等待在途解码完成（调用方保证没有在途帧引用图集与页表）
+     */
+    ~VirtualTexture();
+
+    /** 禁用拷贝与移动 */
+    VirtualTexture(const VirtualTexture &) = delete;
+    VirtualTexture &operator=(const VirtualTexture &) = delete;
+
+    /**
+     * @brief 设置延迟销毁队列（可选）
+     * @details 设置后，反馈分辨率增大时旧的回读缓冲延迟到当前帧退休后销毁；
+     *          未设置时立即销毁，调用方需保证此时没有在途帧引用它们
+     */
+    void setDeletionQueue(vkcore::DeferredDeletionQueue *queue)
+    {
+        m_deletionQueue = queue;
+    }
+
+    // ==================== 帧循环 ====================
+
+    /**
+     * @brief 读回已完成帧的反馈，调度解码与上传，按 LRU 淘汰页
+     * @details 新的上传随本函数末尾的 UploadQueue::flush() 提交；上传完成的页在之后的 addPasses() 中拷入图集
+     */
+    void update();
+
+    /**
+     * @brief 导入页表与图集，并添加把上传完成的页与改变的页表区域拷入纹理的传输 Pass
+     * @param builder 当前帧的渲染图构建器
+     * @return VirtualTextureOutputs 本帧的句柄（采样的 Pass 用 readVirtualTexture() 声明读取）
+     */
+    VirtualTextureOutputs addPasses(rendercore::RDGBuilder &builder);
+
+    /**
+     * @brief 添加低分辨率反馈 Pass 与回读拷贝
+     * @param builder 当前帧的渲染图构建器
+     * @param renderExtent 主画面的渲染尺寸（反馈缓冲为它的 1/feedbackScale）
+     * @param draw 绘制回调（在渲染图执行时调用）
+     * @throws std::invalid_argument 如果尺寸为 0 或回调为空
+     * @throws std::runtime_error 如果同一帧内调用了两次
+     */
+    void addFeedbackPass(rendercore::RDGBuilder &builder, vk::Extent2D renderExtent, FeedbackCallback draw);
+
+    /**
+     * @brief 声明 Pass 在片段着色器中读取页表与图集
+     */
+    void readVirtualTexture(rendercore::RDGPass &pass, const VirtualTextureOutputs &outputs);
+
+    // ==================== 着色器接口 ====================
+
+    /**
+     * @brief 获取描述符集布局（绑定 0 页表，1 图集，2 参数）
+     */
+    vk::DescriptorSetLayout getSetLayout() const
+    {
+        return m_setLayout;
+    }
+
+    /**
+     * @brief 获取描述符集（页表与图集在整个生命周期内不变，所有帧共用）
+     */
+    vk::DescriptorSet getDescriptorSet() const
+    {
+        return m_descriptorSet;
+    }
+
+    /**
+     * @brief 获取着色器参数
+     */
+    const GPUVirtualTextureParams &getParams() const
+    {
+        return m_params;
+    }
+
+    /**
+     * @brief 图集是否为稀疏驻留
+     */
+    bool isSparse() const
+    {
+        return m_atlas->isSparse();
+    }
+
+    /**
+     * @brief 获取最近一次 update() 的统计
+     */
+    const VirtualTextureStats &getStats() const
+    {
+        return m_stats;
+    }
+
+  private:
+    /**
+     * @enum PageState
+     * @brief 一页的驻留状态
+     */
+    enum class PageState : uint8_t
+    {
+        NonResident, ///< 未驻留
+        Decoding,    ///< 在线程池上解码
+        Uploading,   ///< 已分配槽位，等待上传完成后拷入图集
+        Resident,    ///< 已驻留在图集中
+        Missing,     ///< 提供者没有该页
+    };
+
+    /**
+     * @struct PageEntry
+     * @brief 一页的状态与所在槽位
+     */
+    struct PageEntry
+    {
+        PageState state{PageState::NonResident};
+        uint32_t slot{0}; ///< 所在的图集槽位（Uploading/Resident）
+    };
+
+    /**
+     * @struct AtlasSlot
+     * @brief 图集中的一个槽位
+     */
+    struct AtlasSlot
+    {
+        uint32_t page{kInvalidPage}; ///< 占用该槽位的页（打包的 ID）
+        uint64_t lastUsed{0};        ///< 最近一次被反馈请求的帧号
+        bool locked{false};          ///< 最粗一级的页，不淘汰
+        bool bound{false};           ///< 稀疏图集中已绑定内存（非稀疏图集始终为 true）
+    };
+
+    /**
+     * @struct DecodedPage
+     * @brief 解码完成、等待上传的页
+     */
+    struct DecodedPage
+    {
+        uint32_t page{kInvalidPage};
+        std::vector<std::byte> texels;
+        bool valid{false}; ///< 提供者是否给出了该页
+    };
+
+    /**
+     * @struct PendingUpload
+     * @brief 已提交上传、等待拷入图集的页
+     */
+    struct PendingUpload
+    {
+        uint32_t page{kInvalidPage};
+        uint32_t slot{0};
+        uint32_t staging{0}; ///< 暂存区中的位置
+        vkcore::UploadTicket ticket{0};
+    };
+
+    /**
+     * @struct MipRect
+     * @brief 一级页表中需要重新上传的区域（[x0, x1) x [y0, y1)）
+     */
+    struct MipRect
+    {
+        uint32_t x0{UINT32_MAX};
+        uint32_t y0{UINT32_MAX};
+        uint32_t x1{0};
+        uint32_t y1{0};
+
+        bool isEmpty() const
+        {
+            return x0 >= x1 || y0 >= y1;
+        }
+    };
+
+    /**
+     * @struct FrameResources
+     * @brief 每个在途帧的页表暂存区、反馈回读与拷贝列表
+     */
+    struct FrameResources
+    {
+        std::unique_ptr<vkcore::Buffer> tableStaging; ///< 页表的镜像（持久映射，只写入改变的区域）
+        std::unique_ptr<vkcore::Buffer> readback;     ///< 反馈回读缓冲
+        vk::Extent2D feedbackExtent{0, 0};            ///< 回读缓冲中反馈的尺寸
+        uint64_t feedbackFrame{0};                    ///< 写入回读缓冲的帧号（0 表示没有待读的反馈）
+        std::vector<vk::BufferImageCopy> atlasCopies; ///< 本帧暂存区 -> 图集的拷贝
+        std::vector<vk::BufferImageCopy> tableCopies; ///< 本帧页表暂存区 -> 页表的拷贝
+        FeedbackCallback feedbackDraw;                ///< 本帧的反馈绘制回调
+    };
+
+    // 页与页表
+    uint32_t pagesat(uint32_t mip, bool vertical) const;
+    PageEntry &pageentry(const VirtualPageId &page);
+    uint32_t &tableentry(uint32_t mip, uint32_t x, uint32_t y);
+    void mappage(const VirtualPageId &page, uint32_t slot);
+    void unmappage(const VirtualPageId &page, uint32_t slot);
+    void markdirty(uint32_t mip, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1);
+
+    // 流送
+    void readfeedback(FrameResources &frame, std::vector<uint32_t> &requests);
+    void requestpage(uint32_t packed, uint64_t frameNumber, std::vector<uint32_t> &requests);
+    void dispatchdecodes(std::vector<uint32_t> &requests);
+    void decodepage(DecodedPage &decoded) const;
+    bool uploadpage(DecodedPage &decoded, std::vector<vk::Offset2D> &newTiles);
+    bool allocateslot(uint32_t &slot);
+    bool allocatestaging(uint32_t &staging);
+
+    void ensureframes();
+    void releasebuffer(std::unique_ptr<vkcore::Buffer> &buffer);
+
+  private:
+    vkcore::Device &m_device;
+    VmaAllocator m_allocator;
+    vkcore::UploadQueue &m_uploads;
+    vkcore::FrameTimeline &m_timeline;
+    vkcore::WorkerPool *m_workers;
+    vkcore::DeferredDeletionQueue *m_deletionQueue{nullptr};
+    PageProvider m_provider;
+    VirtualTextureSettings m_settings;
+    GPUVirtualTextureParams m_params{};
+
+    uint32_t m_mipCount{1};
+    vk::DeviceSize m_pageBytes{0};
+    std::vector<size_t> m_mipOffsets;    ///< 每级页在 m_pages / m_tableMirror 中的起始位置
+    std::vector<PageEntry> m_pages;      ///< 所有页的状态
+    std::vector<uint32_t> m_tableMirror; ///< 页表的 CPU 镜像（各级依次排列）
+    std::vector<MipRect> m_dirty;        ///< 每级页表自上次拷贝以来改变的区域
+    std::vector<AtlasSlot> m_slots;      ///< 图集槽位
+    std::vector<uint32_t> m_freeSlots;   ///< 从未使用的槽位（逆序存放，槽位 0 最先使用）
+
+    std::unique_ptr<vkcore::Image> m_atlas;
+    std::unique_ptr<vkcore::Image> m_pageTable;
+    vk::ImageLayout m_atlasLayout{vk::ImageLayout::eUndefined};
+    vk::ImageLayout m_pageTableLayout{vk::ImageLayout::eUndefined};
+
+    std::shared_ptr<vkcore::Buffer> m_pageStaging; ///< 页上传的显存暂存区（UploadQueue 写入，传输 Pass 读取）
+    std::vector<uint64_t> m_stagingRelease;        ///< 暂存区各位置可以复用的帧号（UINT64_MAX 表示使用中）
+    std::vector<PendingUpload> m_pendingUploads;
+
+    std::unique_ptr<vkcore::WorkerPool::TaskGroup> m_decodeTasks;
+    std::mutex m_decodedMutex;
+    std::vector<std::unique_ptr<DecodedPage>> m_decoded; ///< 工作线程解码完成的页（受 m_decodedMutex 保护）
+    std::vector<std::unique_ptr<DecodedPage>> m_backlog; ///< 解码完成但本帧没有上传预算的页
+    uint32_t m_decoding{0};                              ///< 在线程池上解码的页数
+
+    vk::Sampler m_tableSampler;
+    vk::Sampler m_atlasSampler;
+    vk::DescriptorSetLayout m_setLayout;
+    std::unique_ptr<vkcore::DescriptorAllocator> m_descriptorAllocator;
+    vk::DescriptorSet m_descriptorSet;
+    std::unique_ptr<vkcore::Buffer> m_paramsBuffer;
+
+    std::vector<FrameResources> m_frames;
+    uint64_t m_feedbackBuilt{0}; ///< 最近一次添加反馈 Pass 的帧号
+    VirtualTextureStats m_stats;
+};
+
+} // namespace renderer
@@ -1,20 +1,51 @@
+#include "Render/RenderCore/RenderGraph/public/RDGBuilder.hpp"
+#include "Render/RenderCore/RenderGraph/public/RDGProfiler.hpp"
+#include "Render/RenderCore/RenderGraph/public/RDGSyncInfo.hpp"
+#include "Render/RenderCore/Resource/public/BindlessRegistry.hpp"
 #include "Render/RenderCore/Resource/public/ResourceManager.hpp"
+#include "Render/RenderCore/Resource/public/VertexLayout.hpp"
+#include "Render/RenderCore/Scene/public/Camera.hpp"
+#include "Render/RenderCore/Scene/public/Light.hpp"
+#include "Render/RenderCore/Scene/public/Scene.hpp"
+#include "Render/RenderCore/Scene/public/SceneNode.hpp"
 #include "Render/RenderCore/VulkanCore/public/CommandPoolManager.hpp"
+#include "Render/RenderCore/VulkanCore/public/DeferredDeletionQueue.hpp"
 #include "Render/RenderCore/VulkanCore/public/Descriptor.hpp"
 #include "Render/RenderCore/VulkanCore/public/Device.hpp"
+#include "Render/RenderCore/VulkanCore/public/FrameTimeline.hpp"
+#include "Render/RenderCore/VulkanCore/public/Log.hpp"
+#include "Render/RenderCore/VulkanCore/public/MemoryMonitor.hpp"
 #include "Render/RenderCore/VulkanCore/public/Pipeline.hpp"
+#include "Render/RenderCore/VulkanCore/public/PipelineCache.hpp"
+#include "Render/RenderCore/VulkanCore/public/Profiler.hpp"
+#include "Render/RenderCore/VulkanCore/public/SamplerCache.hpp"
 #include "Render/RenderCore/VulkanCore/public/ShaderManager.hpp"
+#include "Render/RenderCore/VulkanCore/public/ShaderPackage.hpp"
 #include "Render/RenderCore/VulkanCore/public/SwapChain.hpp"
+#include "Render/RenderCore/VulkanCore/public/TransientBufferRing.hpp"
 #include "Render/RenderCore/VulkanCore/public/VKResource.hpp"
+#include "Render/RenderCore/VulkanCore/public/WorkerPool.hpp"
+#include "Render/Renderer/public/DynamicResolution.hpp"
+#include "Render/Renderer/public/ShadowAtlas.hpp"
+#include "Render/Renderer/public/ThreadedRenderer.hpp"
+#include "Render/Renderer/public/Upscaler.hpp"
+#include "Render/Renderer/public/ViewportSet.hpp"
 #include "UI/MainWindow.hpp"
 #include "UI/VulkanContainer.hpp"
 #include "UI/VulkanWindow.hpp"
 #include <QApplication>
 #include <QTimer>
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <fstream>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <vma/vk_mem_alloc.h>
 
 /**
@@ -41,105 +72,409 @@ std::vector<uint32_t> loadSPIRV(const std::string &filename)
 }
 
 /**
- * @brief 渲染器类 - 封装完整的渲染循环
+ * @brief 示例使用的着色器（包内名称与阶段，源文件为 <名称>.spv）
  */
-class MeshRenderer
+constexpr std::array<std::pair<const char *, vk::ShaderStageFlagBits>, 6> kPackagedShaders = {{
+    {"shadowed_mesh.vert", vk::ShaderStageFlagBits::eVertex},
+    {"shadowed_mesh.frag", vk::ShaderStageFlagBits::eFragment},
+    {"shadow_depth.vert", vk::ShaderStageFlagBits::eVertex}, // 阴影图集的深度 Pass（ShadowAtlas）
+    {"fullscreen.vert", vk::ShaderStageFlagBits::eVertex}, // 动态分辨率的放大 Pass（Upscaler）
+    {"upscale.frag", vk::ShaderStageFlagBits::eFragment},
+    {"rcas.frag", vk::ShaderStageFlagBits::eFragment},
+}};
+
+/**
+ * @brief 着色器包是否需要重新打包（包不存在或任一 .spv 比包新）
+ */
+bool isShaderPackageStale(const std::filesystem::path &shaderDirectory, const std::filesystem::path &packagePath)
+{
+    std::error_code ec;
+    const auto packageTime = std::filesystem::last_write_time(packagePath, ec);
+    if (ec)
+    {
+        return true;
+    }
+    for (const auto &[name, stage] : kPackagedShaders)
+    {
+        const auto sourceTime = std::filesystem::last_write_time(shaderDirectory / (std::string(name) + ".spv"), ec);
+        if (!ec && sourceTime > packageTime)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 把示例着色器的 .spv 打包成一个着色器包（同时存入反射结果，运行时不再扫描 SPIR-V）
+ */
+void packShaders(const std::filesystem::path &shaderDirectory, const std::filesystem::path &packagePath)
+{
+    std::vector<std::vector<uint32_t>> codes;
+    std::vector<std::vector<uint8_t>> reflections;
+    std::vector<vkcore::ShaderPackageSource> sources;
+    codes.reserve(kPackagedShaders.size());
+    reflections.reserve(kPackagedShaders.size());
+    for (const auto &[name, stage] : kPackagedShaders)
+    {
+        codes.push_back(loadSPIRV((shaderDirectory / (std::string(name) + ".spv")).string()));
+        reflections.push_back(vkcore::ShaderReflection::reflect(codes.back(), stage).serialize());
+        sources.push_back({name, stage, codes.back(), reflections.back()});
+    }
+    if (!vkcore::ShaderPackage::write(packagePath, sources))
+    {
+        throw std::runtime_error("无法写入着色器包: " + packagePath.string());
+    }
+}
+
+/**
+ * @struct ViewConstants
+ * @brief 每视口常量（set 1 binding 0 的 dynamic UBO，每帧经 TransientBufferRing 写入）
+ */
+struct ViewConstants
+{
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+    glm::vec4 viewPosition{0.0f}; ///< xyz 为视点的世界空间位置
+    glm::vec2 viewportSize{0.0f}; ///< 场景的渲染尺寸（按动态分辨率缩放后的像素数）
+    uint32_t frameNumber = 0;     ///< 帧时间线上的帧号
+    uint32_t viewId = 0;
+};
+
+/**
+ * @struct MeshPushConstants
+ * @brief 一次网格绘制的推送常量（顶点与片段阶段，与 shadowed_mesh.vert/.frag 一致）
+ */
+struct MeshPushConstants
+{
+    glm::mat4 model{1.0f};                                  ///< 世界矩阵（只含旋转与平移）
+    glm::vec4 lightDirection{0.0f, 1.0f, 0.0f, 0.0f};       ///< xyz 为指向光源的世界空间单位向量
+    glm::vec4 lightColor{1.0f};                             ///< rgb 为颜色 × 强度，a 为环境光比例
+    int32_t shadowIndex = renderer::ShadowAtlas::kNoShadow; ///< ShadowAtlas::getShadowIndex()，没有阴影时为 kNoShadow
+};
+
+/**
+ * @brief 渲染器后端 - 封装完整的帧录制、提交与呈现（所有方法在 ThreadedRenderer 的渲染线程上执行）
+ */
+class MeshRenderer : public renderer::ThreadedRenderer::Backend
 {
   public:
-    MeshRenderer(vkcore::Device &device, vk::SurfaceKHR surface, VulkanWindow *window)
-        : m_device(device), m_surface(surface), m_window(window)
+    /**
+     * @param device 逻辑设备
+     * @param surfaces 各视口窗口的表面（视口 i 对应 ThreadedRenderer::requestResize(i, ...)）
+     */
+    MeshRenderer(vkcore::Device &device, std::vector<vk::SurfaceKHR> surfaces)
+        : m_device(device), m_surfaces(std::move(surfaces))
     {
-        initVulkanResources(surface);
     }
 
-    ~MeshRenderer()
+    ~MeshRenderer() override
     {
         cleanup();
     }
 
-    void renderFrame()
+    bool initialize() override
     {
-        if (!m_initialized)
+        initVulkanResources();
+        return m_initialized;
+    }
+
+    void resize(uint32_t width, uint32_t height) override
+    {
+        resizeView(0, width, height);
+    }
+
+    void resizeView(uint32_t view, uint32_t width, uint32_t height) override
+    {
+        // 最小化时尺寸为 0，等恢复后的下一次请求；尺寸未变（例如只移动了窗口）时不重建
+        if (!m_initialized || view >= m_views.size() || width == 0 || height == 0)
+            return;
+        const vk::Extent2D extent = m_viewports->getSwapChain(m_views[view].id).getSwapchainExtent();
+        if (extent.width == width && extent.height == height)
             return;
 
-        try
-        {
-            uint32_t currentFrame = m_swapchain->getCurrentFrameIndex();
+        // 拖动窗口时连续收到缩放，交换链在尺寸稳定一段时间后才重建
+        m_viewports->requestResize(m_views[view].id);
+    }
 
-            // 1. 获取下一个交换链图像（内部会等待 fence 并重置）
-            uint32_t imageIndex;
-            vk::Result result = m_swapchain->acquireNextImage(imageIndex);
+    void renderFrame(const renderer::RenderFrameData &frame) override
+    {
+        QTR_PROFILE_SCOPE("MeshRenderer::renderFrame");
+        if (!m_initialized)
+            return;
 
-            if (result == vk::Result::eErrorOutOfDateKHR)
+        {
+            beginFrameResources();
+
+            // 1. 逐个视口获取交换链图像（内容未变的视口跳过；复用本帧资源所需的等待已在上一帧提交后完成）
+            //    所有视口的 Pass 放进同一张渲染图，命令缓冲区从本帧的命令池中分配（该池在上一次使用的帧退休后已整体重置）
+            //    渲染缩放由计时查询最新读回的整帧 GPU 耗时决定，所有视口共用
+            const float renderScale = m_profiler ? m_resolution.update(*m_profiler) : 1.0f;
+            const uint32_t frameSlot = m_viewports->getFrameTimeline().getFrameSlot();
+            std::optional<rendercore::RDGBuilder> builder;
+            renderer::ShadowAtlasOutputs shadows;
+            for (uint32_t viewIndex = 0; viewIndex < m_views.size(); ++viewIndex)
             {
-                recreateSwapchain();
+                ViewState &view = m_views[viewIndex];
+                uint32_t imageIndex;
+                const bool acquired = m_viewports->acquire(view.id, getContentKey(frame, view.id), imageIndex);
+
+                // 交换链可能已在获取时重建（或窗口最小化），依赖它的状态按需更新
+                updateSwapchainDependents(view);
+                if (!acquired)
+                    continue;
+
+                if (!builder)
+                {
+                    // 本帧新建的瞬态资源（深度缓冲）在构建器析构时交给延迟销毁队列，本帧退休后才销毁
+                    builder.emplace(m_device, *m_frameCommands, m_allocator, nullptr, nullptr, m_samplerCache.get());
+                    builder->setDeletionQueue(m_deletionQueue.get());
+                    builder->setProfiler(m_profiler.get());
+                    builder->setRenderScale(renderScale);
+
+                    // 阴影图集只在渲染图确定执行时更新（update() 把本帧调度的图块记为已绘制），
+                    // 级联按第一个获取了图像的视口划分，所有视口共用同一张图集
+                    updateScene(frame, view);
+                    m_shadowAtlas->update(*m_scene, *m_camera, frameSlot);
+                    shadows = m_shadowAtlas->addPasses(*builder, frameSlot);
+                    updateMeshDraws();
+                }
+                const vk::Extent2D renderExtent =
+                    builder->getScaledExtent(m_viewports->getSwapChain(view.id).getSwapchainExtent());
+                addViewPasses(*builder, viewIndex, imageIndex, renderExtent,
+                              pushViewConstants(frame, view, renderExtent), shadows);
+            }
+
+            // 所有视口都跳过时不执行渲染图，本帧不消耗帧号（下次进入时重新开始同一槽位）
+            if (!builder)
                 return;
+            m_frameConstants->flush();
+
+            // 2. 渲染图一次执行覆盖所有获取了图像的视口：等待图像可用，触发渲染完成与帧时间线；
+            //    构建器在本帧内析构（瞬态资源按本帧帧号入队），然后一次呈现并前进到下一帧
+            //   （等待 framesInFlight 帧之前的那一帧完成）
+            rendercore::RDGSyncInfo syncInfo;
+            m_viewports->appendSubmitSync(syncInfo);
+            builder->execute(&syncInfo);
+            builder.reset();
+            m_viewports->present(frame.inputTime);
+
+            // 以实测的阴影 Pass 耗时修正图块重绘的耗时估计，使每帧的重绘量收敛到 updateBudgetMs 以内
+            //（本帧没有重绘图块、或读回尚未就绪时为 0，calibrate() 忽略）
+            if (m_profiler)
+            {
+                m_shadowAtlas->calibrate(m_profiler->getAverageTime("ShadowAtlas"));
             }
-            else if (result != vk::Result::eSuccess && result != vk::Result::eSuboptimalKHR)
+
+            m_frameCount++;
+            m_memoryMonitor->update(m_frameCount);
+
+            // 纹理流送：替换上传完成的纹理；新的流送上传与解码线程上记录的异步加载上传随本次 flush 提交
+            //（上传队列不在解码线程上自动提交，渲染线程是唯一每帧提交它的线程）
+            if (m_resourceManager->getTextureStreamer())
             {
-                throw std::runtime_error("获取交换链图像失败");
+                m_resourceManager->updateTextureStreaming();
             }
+            m_resourceManager->flushUploads();
+        }
+    }
 
-            // 2. 使用当前帧对应的命令缓冲区
-            auto &cmd = m_commandBuffers[currentFrame];
+    uint64_t getFrameCount() const
+    {
+        return m_frameCount;
+    }
 
-            // 重置命令缓冲区（fence 已在 acquireNextImage 中等待）
-            cmd->reset();
+  private:
+    /**
+     * @struct ViewState
+     * @brief 一个视口的交换链依赖状态
+     */
+    struct ViewState
+    {
+        uint32_t id = 0;                  ///< ViewportSet 中的视口 ID
+        uint64_t swapchainGeneration = 0; ///< 依赖状态对应的交换链代数
+    };
+
+    /**
+     * @brief 视口本帧的内容键（未设置多视口场景提取时为 0，每帧都渲染）
+     */
+    static uint64_t getContentKey(const renderer::RenderFrameData &frame, uint32_t viewId)
+    {
+        for (const renderer::RenderViewData &view : frame.views)
+        {
+            if (view.viewId == viewId)
+                return view.contentKey;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief 视口本帧的相机（未设置多视口场景提取时使用单相机字段）
+     */
+    static const renderer::RenderViewData *findView(const renderer::RenderFrameData &frame, uint32_t viewId)
+    {
+        for (const renderer::RenderViewData &view : frame.views)
+        {
+            if (view.viewId == viewId)
+                return &view;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief 主线程是否提取了单相机字段（没有设置场景提取时投影保持为单位矩阵）
+     */
+    static bool hasFrameCamera(const renderer::RenderFrameData &frame)
+    {
+        return frame.projection != glm::mat4(1.0f);
+    }
 
-            vk::CommandBufferBeginInfo beginInfo{};
-            beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
-            cmd->begin(beginInfo);
-            recordCommandBuffer(*cmd, imageIndex);
-            cmd->end();
+    /**
+     * @brief 推进示例场景：汽车绕自身中心匀速旋转，阴影相机跟随第一个获取了图像的视口
+     * @details 转台的旋转改变投射体的世界矩阵，ShadowAtlas 据此判定级联图块失效并在预算内重绘；
+     *          主线程提取了相机时阴影相机取该视口的视点与视线，否则保持示例自带的相机
+     */
+    void updateScene(const renderer::RenderFrameData &frame, const ViewState &view)
+    {
+        const float seconds = std::chrono::duration<float>(frame.inputTime - m_sceneStartTime).count();
+        const glm::quat rotation = glm::angleAxis(seconds * kTurntableSpeed, glm::vec3(0.0f, 1.0f, 0.0f));
+        m_carNode->setRotation(rotation);
+        m_carNode->setPosition(m_carPivot - rotation * m_carPivot);
 
-            // 3. 提交命令缓冲区
-            // 等待 per-frame 的 imageAvailable 信号量
-            // 发出 per-image 的 renderFinished 信号量
-            vk::Semaphore waitSemaphores[] = {m_swapchain->getImageAvailableSemaphore(currentFrame)};
-            vk::Semaphore signalSemaphores[] = {m_swapchain->getRenderFinishedSemaphore(imageIndex)};
-            vk::PipelineStageFlags waitStages[] = {vk::PipelineStageFlagBits::eColorAttachmentOutput};
+        const renderer::RenderViewData *camera = findView(frame, view.id);
+        if (camera || hasFrameCamera(frame))
+        {
+            const glm::vec3 forward = glm::normalize(camera ? camera->viewForward : frame.viewForward);
+            m_camera->setPosition(camera ? camera->viewPosition : frame.viewPosition);
+            m_camera->setRotation(glm::degrees(std::atan2(forward.z, forward.x)),
+                                  glm::degrees(std::asin(glm::clamp(forward.y, -1.0f, 1.0f))));
+        }
 
-            vk::SubmitInfo submitInfo{};
-            submitInfo.waitSemaphoreCount = 1;
-            submitInfo.pWaitSemaphores = waitSemaphores;
-            submitInfo.pWaitDstStageMask = waitStages;
-            submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers = &(*cmd);
-            submitInfo.signalSemaphoreCount = 1;
-            submitInfo.pSignalSemaphores = signalSemaphores;
+        const vk::Extent2D extent = m_viewports->getSwapChain(view.id).getSwapchainExtent();
+        m_camera->updateAspectRatio(static_cast<float>(extent.width) / static_cast<float>(extent.height));
+    }
 
-            m_device.getGraphicsQueue().submit(submitInfo, m_swapchain->getInFlightFence(currentFrame));
+    /**
+     * @brief 填写本帧汽车与地面的推送常量（ShadowAtlas::update() 之后调用，此时阴影索引有效）
+     */
+    void updateMeshDraws()
+    {
+        MeshPushConstants draw;
+        draw.lightDirection = glm::vec4(-glm::normalize(m_sun->getDirection()), 0.0f);
+        draw.lightColor = glm::vec4(m_sun->getColor() * m_sun->getIntensity(), kAmbient);
+        draw.shadowIndex = m_shadowAtlas->getShadowIndex(m_sun.get());
+
+        draw.model = m_carNode->getWorldMatrix();
+        m_carDraw = draw;
+        draw.model = m_groundNode->getWorldMatrix();
+        m_groundDraw = draw;
+    }
 
-            // 4. 呈现图像（等待 per-image 的 renderFinished 信号）
-            result = m_swapchain->present(m_swapchain->getRenderFinishedSemaphore(imageIndex), imageIndex);
+    /**
+     * @brief 帧开头切换到本帧槽位的常量环区域与描述符池
+     * @details ViewportSet 前进到本帧时已等待该槽位上一次使用的帧退休，两者在这里直接整体复用；
+     *          在途帧数变化时等待时间线空闲后按新的槽位数重建
+     */
+    void beginFrameResources()
+    {
+        vkcore::FrameTimeline &timeline = m_viewports->getFrameTimeline();
+        if (timeline.getFramesInFlight() != m_frameResourceCount)
+        {
+            timeline.waitIdle();
+            createFrameResources(timeline.getFramesInFlight());
+        }
 
-            if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR)
-            {
-                recreateSwapchain();
-            }
-            else if (result != vk::Result::eSuccess)
-            {
-                throw std::runtime_error("呈现图像失败");
-            }
+        const uint32_t frameSlot = timeline.getFrameSlot();
+        m_frameConstants->beginFrame(frameSlot);
+        m_frameDescriptors->resetPools(frameSlot);
+        m_frameTextureSet = nullptr;
+    }
 
-            // 5. 前进到下一帧
-            m_swapchain->advanceToNextFrame();
+    /**
+     * @brief 把视口本帧的常量写入帧环，返回其 dynamic offset
+     */
+    uint32_t pushViewConstants(const renderer::RenderFrameData &frame, const ViewState &view,
+                               vk::Extent2D renderExtent)
+    {
+        const renderer::RenderViewData *camera = findView(frame, view.id);
 
-            m_frameCount++;
+        ViewConstants constants;
+        if (camera || hasFrameCamera(frame))
+        {
+            constants.view = camera ? camera->view : frame.view;
+            constants.projection = camera ? camera->projection : frame.projection;
+            constants.viewPosition = glm::vec4(camera ? camera->viewPosition : frame.viewPosition, 1.0f);
         }
-        catch (const std::exception &e)
+        else
         {
-            std::cerr << "渲染失败: " << e.what() << std::endl;
+            // 示例自带的相机：深度范围 [0, 1]，并翻转 Y 以匹配 Vulkan 的裁剪空间
+            constants.view = m_camera->getViewMatrix();
+            constants.projection = glm::perspectiveRH_ZO(
+                glm::radians(kCameraFovY), static_cast<float>(renderExtent.width) / renderExtent.height,
+                m_camera->getNearPlane(), m_camera->getFarPlane());
+            constants.projection[1][1] *= -1.0f;
+            constants.viewPosition = glm::vec4(m_camera->getPosition(), 1.0f);
         }
+        constants.viewportSize =
+            glm::vec2(static_cast<float>(renderExtent.width), static_cast<float>(renderExtent.height));
+        constants.frameNumber = static_cast<uint32_t>(m_viewports->getFrameTimeline().getFrameNumber());
+        constants.viewId = view.id;
+        return m_frameConstants->push(constants).offset;
     }
 
-    uint64_t getFrameCount() const
+    /**
+     * @brief 本帧的纹理描述符集（第一个视口录制时从帧描述符分配器取一次，写入当前的默认纹理）
+     * @details 流送替换纹理后下一帧自然引用新的图像视图，不需要更新已被在途帧使用的描述符集
+     */
+    vk::DescriptorSet getFrameTextureSet()
     {
-        return m_frameCount;
+        if (m_frameTextureSet)
+            return m_frameTextureSet;
+
+        auto defaultTexture = m_resourceManager->getDefaultWhiteTexture();
+        vk::DescriptorImageInfo imageInfo = {};
+        imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+        imageInfo.imageView = defaultTexture->image->getView();
+        imageInfo.sampler = defaultTexture->sampler;
+
+        m_frameTextureSet = m_frameDescriptors->allocate(m_textureSetLayout);
+        vkcore::DescriptorUpdater::begin(m_device, m_frameTextureSet)
+            .writeImage(0, vk::DescriptorType::eCombinedImageSampler, imageInfo)
+            .update();
+        return m_frameTextureSet;
     }
 
-  private:
-    void initVulkanResources(vk::SurfaceKHR surface)
+    /**
+     * @brief 按在途帧数创建常量环、帧描述符分配器、计时查询池、放大 Pass 与阴影图集（视口常量集只写一次：offset 0、固定 range）
+     * @details 放大 Pass 的描述符集按（槽位, 视口）各一个，同一帧的多个视口不会改写彼此已录制的集合；
+     *          阴影图集的集合布局来自布局缓存，重建后句柄不变，网格管线无需重建
+     */
+    void createFrameResources(uint32_t framesInFlight)
+    {
+        m_frameConstants = std::make_unique<vkcore::TransientBufferRing>(
+            m_device, m_allocator, kFrameConstantBytes, framesInFlight, vk::BufferUsageFlagBits::eUniformBuffer);
+        m_frameDescriptors = std::make_unique<vkcore::FrameDescriptorAllocator>(m_device, framesInFlight, 16);
+        m_upscaler = std::make_unique<renderer::Upscaler>(
+            m_device, *m_descriptorLayoutCache, m_fullscreenShader, m_upscaleShader, m_sharpenShader,
+            framesInFlight * static_cast<uint32_t>(m_views.size()));
+        m_shadowAtlas = std::make_unique<renderer::ShadowAtlas>(m_device, m_allocator, *m_descriptorLayoutCache,
+                                                                m_shadowDepthShader, framesInFlight);
+        m_frameResourceCount = framesInFlight;
+
+        // 计时查询池在主机端重置：设备不支持 hostQueryReset 时不计时，渲染缩放保持为 1
+        m_profiler.reset();
+        if (m_device.isFeatureEnabled("hostQueryReset"))
+        {
+            m_profiler = std::make_unique<rendercore::RDGProfiler>(m_device, framesInFlight);
+        }
+
+        vkcore::DescriptorUpdater::begin(m_device, m_viewSet)
+            .writeBuffer(0, vk::DescriptorType::eUniformBufferDynamic,
+                         m_frameConstants->getDescriptorInfo(sizeof(ViewConstants)))
+            .update();
+    }
+
+    void initVulkanResources()
     {
         // 1. 创建 VMA 分配器
         VmaAllocatorCreateInfo allocatorInfo = {};
@@ -147,52 +482,110 @@ class MeshRenderer
         allocatorInfo.physicalDevice = static_cast<VkPhysicalDevice>(m_device.getPhysicalDevice());
         allocatorInfo.device = static_cast<VkDevice>(m_device.get());
         allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_3;
+        if (m_device.isExtensionEnabled(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+        {
+            allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT; // 读取操作系统给出的真实显存预算
+        }
+        if (m_device.isFeatureEnabled("bufferDeviceAddress"))
+        {
+            allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT; // 分配时附带 DEVICE_ADDRESS 标志
+        }
 
         if (vmaCreateAllocator(&allocatorInfo, &m_allocator) != VK_SUCCESS)
         {
             throw std::runtime_error("创建 VMA 分配器失败");
         }
 
-        // 2. 创建交换链
-        m_swapchain = std::make_unique<vkcore::SwapChain>(surface, m_device, m_allocator);
-        std::cout << "交换链创建成功:" << std::endl;
-        std::cout << "  格式: " << vk::to_string(m_swapchain->getSwapchainFormat()) << std::endl;
-        std::cout << "  尺寸: " << m_swapchain->getSwapchainExtent().width << "x"
-                  << m_swapchain->getSwapchainExtent().height << std::endl;
+        // 显存预算监视：接近预算时报警（小显存设备上提前发现 OOM 风险）
+        m_memoryMonitor = std::make_unique<vkcore::MemoryMonitor>(m_allocator);
+        m_memoryMonitor->addPressureCallback([this](const vkcore::MemoryPressure &pressure) {
+            if (pressure.frameIndex >= m_nextPressureReportFrame)
+            {
+                QTR_LOG_WARN("Memory", "显存压力: 堆 " << pressure.heapIndex << " 用量 " << pressure.usage / (1024 * 1024)
+                                       << " MB / 预算 " << pressure.budget / (1024 * 1024) << " MB"
+                                       << (pressure.overBudget ? "（已超出预算）" : ""));
+                m_nextPressureReportFrame = pressure.frameIndex + 600;
+            }
+        });
+
+        // 2. 创建各视口的交换链（共用一条帧时间线，每帧一次提交、一次呈现）
+        m_viewports = std::make_unique<renderer::ViewportSet>(m_device, m_allocator);
+        for (vk::SurfaceKHR surface : m_surfaces)
+        {
+            ViewState view;
+            view.id = m_viewports->addView(surface);
+            m_views.push_back(view);
+
+            const vkcore::SwapChain &swapchain = m_viewports->getSwapChain(view.id);
+            std::cout << "视口 " << view.id << " 交换链创建成功:" << std::endl;
+            std::cout << "  格式: " << vk::to_string(swapchain.getSwapchainFormat()) << std::endl;
+            std::cout << "  尺寸: " << swapchain.getSwapchainExtent().width << "x"
+                      << swapchain.getSwapchainExtent().height << std::endl;
+            std::cout << "  呈现模式: " << vk::to_string(swapchain.getPresentMode()) << "（"
+                      << swapchain.getImageCount() << " 张图像，present wait "
+                      << (swapchain.supportsPresentWait() ? "可用" : "不可用") << "）" << std::endl;
+        }
 
         // 3. 创建命令池管理器
         uint32_t graphicsQueueFamilyIndex = m_device.getGraphicsQueueFamilyIndices();
         m_commandPoolManager = std::make_unique<vkcore::CommandPoolManager>(m_device, graphicsQueueFamilyIndex);
 
-        // 分配每帧的命令缓冲区
-        for (int i = 0; i < 2; i++)
-        {
-            m_commandBuffers[i] = m_commandPoolManager->allocate();
-        }
+        // 每帧录制的命令缓冲区使用帧环模式，随视口共享的帧时间线按帧整体回收
+        m_frameCommands = std::make_unique<vkcore::CommandPoolManager>(m_device, graphicsQueueFamilyIndex,
+                                                                       m_viewports->getFrameTimeline());
+
+        // 延迟销毁队列同样关联帧时间线：渲染图的瞬态资源与卸载的资源在最后引用它们的帧退休后销毁
+        m_deletionQueue = std::make_unique<vkcore::DeferredDeletionQueue>(m_viewports->getFrameTimeline());
 
-        // 4. 创建着色器管理器并加载着色器
-        m_shaderManager = std::make_unique<vkcore::ShaderManager>(m_device);
+        // 4. 创建着色器管理器并加载着色器（模块标识缓存在临时目录，支持时第二次启动起跳过模块创建）
+        std::error_code ec;
+        std::filesystem::path tempDirectory = std::filesystem::temp_directory_path(ec);
+        m_shaderManager = std::make_unique<vkcore::ShaderManager>(
+            m_device, ec ? std::filesystem::path() : tempDirectory / "QTRender" / "ShaderIdentifiers.bin");
         loadShaders();
 
-        // 5. 创建 Descriptor
+        // 5. 创建 Descriptor 与每帧常量环（按视口共享帧时间线的在途帧数分槽）
         createDescriptors();
+        createFrameResources(m_viewports->getFrameTimeline().getFramesInFlight());
+
+        // 6. 创建 ResourceManager 并加载模型（解码与管线编译共用一个绑定核心的任务调度器）
+        m_workers = std::make_unique<vkcore::WorkerPool>(0, true);
 
-        // 6. 创建 ResourceManager 并加载模型
         std::cout << "创建 ResourceManager..." << std::endl;
         m_resourceManager = std::make_unique<rendercore::ResourceManager>();
 
         std::cout << "初始化 ResourceManager..." << std::endl;
         m_resourceManager->initialize(m_device, m_allocator, *m_commandPoolManager, *m_shaderManager,
-                                      *m_descriptorAllocator, *m_descriptorLayoutCache);
+                                      *m_descriptorAllocator, *m_descriptorLayoutCache, *m_samplerCache, 0,
+                                      m_workers.get());
+        m_resourceManager->setDeletionQueue(m_deletionQueue.get());
         std::cout << "ResourceManager 初始化完成" << std::endl;
 
+        // shadowed_mesh.vert 以浮点读取全部四个属性，示例网格保持标准顶点格式
+        m_resourceManager->setCompactVertexFormats(false);
+
+        // 显存压力时纹理流送按 LRU 降低常驻 mip
+        if (rendercore::TextureStreamer *textureStreamer = m_resourceManager->getTextureStreamer())
+        {
+            m_memoryMonitor->addPressureCallback([textureStreamer](const vkcore::MemoryPressure &pressure) {
+                textureStreamer->handleMemoryPressure(pressure);
+            });
+        }
+
         loadMesh();
 
-        // 7. 更新 Descriptor Set，使用默认纹理
-        updateDescriptorSet();
+        // 初始化阶段的上传合并为一次传输提交，首帧前在CPU上等待完成
+        m_resourceManager->waitForUploads();
 
-        // 8. 创建图形管线
+        // 7. 创建图形管线（驱动缓存持久化在临时目录，第二次启动起跳过着色器编译）
+        m_pipelineCache = std::make_unique<vkcore::PipelineCache>(
+            m_device, ec ? std::filesystem::path() : tempDirectory / "QTRender" / "PipelineCache.bin");
+        m_pipelineCache->setWorkerPool(m_workers.get());
         createPipeline();
+        for (ViewState &view : m_views)
+        {
+            view.swapchainGeneration = m_viewports->getSwapChain(view.id).getGeneration();
+        }
 
         m_initialized = true;
         std::cout << "Vulkan 渲染资源初始化完成\n" << std::endl;
@@ -204,16 +597,39 @@ class MeshRenderer
 
         try
         {
-            // 使用网格着色器
-            auto fragCode = loadSPIRV("E:/Github_repo/QTRender/assets/shaders/spv/mesh.frag.spv");
-            auto vertCode = loadSPIRV("E:/Github_repo/QTRender/assets/shaders/spv/mesh.vert.spv");
+            // 着色器包：.spv 比包新（或包不存在）时重新打包，之后只映射包文件、按名称惰性创建模块
+            const std::filesystem::path shaderDirectory = "E:/Github_repo/QTRender/assets/shaders/spv";
+            const std::filesystem::path packagePath = shaderDirectory / "shaders.qtsp";
+            if (isShaderPackageStale(shaderDirectory, packagePath))
+            {
+                packShaders(shaderDirectory, packagePath);
+            }
+            m_shaderManager->mountPackage(packagePath);
 
-            m_vertShader = m_shaderManager->createShaderModule("mesh.vert", vertCode, vk::ShaderStageFlagBits::eVertex);
-            m_fragShader =
-                m_shaderManager->createShaderModule("mesh.frag", fragCode, vk::ShaderStageFlagBits::eFragment);
+            // 带阴影的网格着色器与阴影图集的深度 Pass
+            m_vertShader = m_shaderManager->getShaderModule("shadowed_mesh.vert");
+            m_fragShader = m_shaderManager->getShaderModule("shadowed_mesh.frag");
+            m_shadowDepthShader = m_shaderManager->getShaderModule("shadow_depth.vert");
+            if (!m_vertShader || !m_fragShader || !m_shadowDepthShader)
+            {
+                throw std::runtime_error("着色器包中缺少 shadowed_mesh.vert / shadowed_mesh.frag / shadow_depth.vert: " +
+                                         packagePath.string());
+            }
 
-            std::cout << "✓ 顶点着色器: mesh.vert.spv" << std::endl;
-            std::cout << "✓ 片段着色器: mesh.frag.spv" << std::endl;
+            // 放大 Pass：全屏三角形 + 放大/锐化片段着色器
+            m_fullscreenShader = m_shaderManager->getShaderModule("fullscreen.vert");
+            m_upscaleShader = m_shaderManager->getShaderModule("upscale.frag");
+            m_sharpenShader = m_shaderManager->getShaderModule("rcas.frag");
+            if (!m_fullscreenShader || !m_upscaleShader)
+            {
+                throw std::runtime_error("着色器包中缺少 fullscreen.vert / upscale.frag: " + packagePath.string());
+            }
+
+            std::cout << "✓ 着色器包: " << packagePath.string() << std::endl;
+            std::cout << "✓ 顶点着色器: shadowed_mesh.vert" << std::endl;
+            std::cout << "✓ 片段着色器: shadowed_mesh.frag" << std::endl;
+            std::cout << "✓ 阴影着色器: shadow_depth.vert" << std::endl;
+            std::cout << "✓ 放大着色器: fullscreen.vert / upscale.frag / rcas.frag" << std::endl;
         }
         catch (const std::exception &e)
         {
@@ -237,6 +653,8 @@ class MeshRenderer
             std::cout << "✓ 网格模型加载成功: " << carPath.string() << std::endl;
             std::cout << "  顶点数: " << m_mesh->vertexCount << std::endl;
             std::cout << "  索引数: " << m_mesh->indexCount << std::endl;
+
+            createScene();
         }
         catch (const std::exception &e)
         {
@@ -247,42 +665,76 @@ class MeshRenderer
         std::cout << "===================\n" << std::endl;
     }
 
-    void updateDescriptorSet()
+    /**
+     * @brief 创建渲染线程上的示例场景：转台上的汽车、承接阴影的地面、投射阴影的太阳光与示例相机
+     * @details 地面与相机按汽车包围盒摆放；ShadowAtlas 从这个场景收集光源与投射体
+     */
+    void createScene()
     {
-        std::cout << "\n=== 更新 Descriptor Set ===" << std::endl;
-
-        // 使用 ResourceManager 的默认白色纹理
-        auto defaultTexture = m_resourceManager->getDefaultWhiteTexture();
-
-        // 使用 DescriptorUpdater 更新 Descriptor Set
-        vk::DescriptorImageInfo imageInfo = {};
-        imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-        imageInfo.imageView = defaultTexture->image->getView();
-        imageInfo.sampler = *defaultTexture->sampler;
-
-        vkcore::DescriptorUpdater::begin(m_device, m_descriptorSet)
-            .writeImage(0, vk::DescriptorType::eCombinedImageSampler, imageInfo)
-            .update();
-
-        std::cout << "✓ Descriptor Set 更新完成" << std::endl;
-        std::cout << "===================\n" << std::endl;
+        const glm::vec3 center = (m_mesh->bounds.min + m_mesh->bounds.max) * 0.5f;
+        const float radius = std::max(glm::length(m_mesh->bounds.max - m_mesh->bounds.min) * 0.5f, 1e-3f);
+        m_carPivot = glm::vec3(center.x, 0.0f, center.z);
+
+        // 地面：汽车底部的正方形（法线向上，逆时针为正面）
+        const float extent = radius * 4.0f;
+        const float groundY = m_mesh->bounds.min.y;
+        const glm::vec4 groundColor(0.6f, 0.6f, 0.6f, 1.0f);
+        const glm::vec3 up(0.0f, 1.0f, 0.0f);
+        const std::vector<rendercore::Vertex> groundVertices = {
+            {groundColor, glm::vec3(center.x - extent, groundY, center.z - extent), up, glm::vec2(0.0f, 0.0f)},
+            {groundColor, glm::vec3(center.x - extent, groundY, center.z + extent), up, glm::vec2(0.0f, 1.0f)},
+            {groundColor, glm::vec3(center.x + extent, groundY, center.z + extent), up, glm::vec2(1.0f, 1.0f)},
+            {groundColor, glm::vec3(center.x + extent, groundY, center.z - extent), up, glm::vec2(1.0f, 0.0f)},
+        };
+        m_groundMesh = m_resourceManager->registerMesh("SampleGround", groundVertices, {0, 1, 2, 0, 2, 3});
+
+        // 场景只需要材质非空（示例的着色参数由推送常量给出）
+        m_sceneMaterial = std::make_shared<rendercore::Material>();
+        m_sceneMaterial->name = "SampleSurface";
+
+        m_scene = std::make_unique<rendercore::Scene>();
+        m_carNode = std::make_shared<rendercore::SceneNode>("Car");
+        m_carNode->setRenderable(rendercore::Renderable{m_mesh, m_sceneMaterial, true});
+        m_scene->getRootNode()->addChild(m_carNode);
+        m_groundNode = std::make_shared<rendercore::SceneNode>("Ground");
+        m_groundNode->setRenderable(rendercore::Renderable{m_groundMesh, m_sceneMaterial, true});
+        m_scene->getRootNode()->addChild(m_groundNode);
+
+        m_sun = rendercore::LightFactory::createSunLight(glm::vec3(0.4f, -1.0f, 0.3f));
+        m_scene->addLight(m_sun);
+
+        // 相机从斜上方看向汽车中心，远平面覆盖整块地面（级联阴影只到 shadowDistance）
+        const glm::vec3 eye = center + glm::vec3(0.0f, radius * 0.8f, radius * 2.5f);
+        const glm::vec3 forward = glm::normalize(center - eye);
+        m_camera = std::make_shared<rendercore::Camera>(eye, up, glm::degrees(std::atan2(forward.z, forward.x)),
+                                                        glm::degrees(std::asin(forward.y)));
+        m_camera->setPerspective(kCameraFovY, 16.0f / 9.0f, radius * 0.05f, radius * 10.0f);
+        m_scene->setCamera(m_camera);
+        m_sceneStartTime = std::chrono::steady_clock::now();
     }
 
     void createDescriptors()
     {
         std::cout << "\n=== 创建 Descriptor ===" << std::endl;
 
-        // 1. 创建 Descriptor 分配器和布局缓存
+        // 1. 创建 Descriptor 分配器、布局缓存与采样器缓存
         m_descriptorAllocator = std::make_unique<vkcore::DescriptorAllocator>(m_device);
         m_descriptorLayoutCache = std::make_unique<vkcore::DescriptorLayoutCache>(m_device);
+        m_samplerCache = std::make_unique<vkcore::SamplerCache>(m_device);
 
         // 2. 使用 DescriptorLayoutBuilder 创建 Descriptor Set Layout
-        auto layout = vkcore::DescriptorLayoutBuilder::begin(m_descriptorLayoutCache.get())
-                          .addBinding(0, vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eFragment)
-                          .build();
+        //    set 0：纹理（每帧从帧描述符分配器取），set 1：视口常量（dynamic UBO，只分配一次）
+        m_textureSetLayout =
+            vkcore::DescriptorLayoutBuilder::begin(m_descriptorLayoutCache.get())
+                .addBinding(0, vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eFragment)
+                .build();
+        m_viewSetLayout = vkcore::DescriptorLayoutBuilder::begin(m_descriptorLayoutCache.get())
+                              .addBinding(0, vk::DescriptorType::eUniformBufferDynamic,
+                                          vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment)
+                              .build();
 
-        // 3. 分配 Descriptor Set
-        m_descriptorSet = m_descriptorAllocator->allocate(layout);
+        // 3. 分配视口常量的 Descriptor Set
+        m_viewSet = m_descriptorAllocator->allocate(m_viewSetLayout);
 
         std::cout << "✓ Descriptor Set 创建成功" << std::endl;
         std::cout << "===================\n" << std::endl;
@@ -290,43 +742,10 @@ class MeshRenderer
 
     void createPipeline()
     {
-        // 创建顶点输入描述符
-        vk::VertexInputBindingDescription bindingDescription = {};
-        bindingDescription.binding = 0;
-        bindingDescription.stride = sizeof(rendercore::Vertex);
-        bindingDescription.inputRate = vk::VertexInputRate::eVertex;
-
-        std::array<vk::VertexInputAttributeDescription, 4> attributeDescriptions = {};
-
-        // Position (vec3)
-        attributeDescriptions[0].binding = 0;
-        attributeDescriptions[0].location = 0;
-        attributeDescriptions[0].format = vk::Format::eR32G32B32Sfloat;
-        attributeDescriptions[0].offset = offsetof(rendercore::Vertex, position);
-
-        // Normal (vec3)
-        attributeDescriptions[1].binding = 0;
-        attributeDescriptions[1].location = 1;
-        attributeDescriptions[1].format = vk::Format::eR32G32B32Sfloat;
-        attributeDescriptions[1].offset = offsetof(rendercore::Vertex, normal);
-
-        // TexCoord (vec2)
-        attributeDescriptions[2].binding = 0;
-        attributeDescriptions[2].location = 2;
-        attributeDescriptions[2].format = vk::Format::eR32G32Sfloat;
-        attributeDescriptions[2].offset = offsetof(rendercore::Vertex, texCoord);
-
-        // Color (vec4)
-        attributeDescriptions[3].binding = 0;
-        attributeDescriptions[3].location = 3;
-        attributeDescriptions[3].format = vk::Format::eR32G32B32A32Sfloat;
-        attributeDescriptions[3].offset = offsetof(rendercore::Vertex, color);
-
-        vk::PipelineVertexInputStateCreateInfo vertexInputInfo = {};
-        vertexInputInfo.vertexBindingDescriptionCount = 1;
-        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-        vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+        // 顶点输入由编译期布局生成（与 Mesh::vertexFormat 一致）
+        const vk::PipelineVertexInputStateCreateInfo vertexInputInfo =
+            rendercore::VertexLayouts::getInfo(m_mesh ? m_mesh->vertexFormat : rendercore::VertexFormat::Standard)
+                .inputState;
 
         vk::PipelineColorBlendAttachmentState colorBlendAttachment = {};
         colorBlendAttachment.colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
@@ -343,141 +762,150 @@ class MeshRenderer
         rasterizationState.depthBiasEnable = VK_FALSE;
         rasterizationState.lineWidth = 1.0f;
 
-        // 重新创建 Descriptor Set Layout 以获取句柄
-        auto descriptorSetLayout =
-            vkcore::DescriptorLayoutBuilder::begin(m_descriptorLayoutCache.get())
-                .addBinding(0, vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eFragment)
-                .build();
-
-        m_pipeline = vkcore::PipelineBuilder(m_device)
-                         .addShaderModule(m_vertShader)
-                         .addShaderModule(m_fragShader)
-                         .setVertexInput(vertexInputInfo)
-                         .setRasterization(rasterizationState)
-                         .addColorAttachment(m_swapchain->getSwapchainFormat(), colorBlendAttachment)
-                         .addDynamicState(vk::DynamicState::eViewport)
-                         .addDynamicState(vk::DynamicState::eScissor)
-                         .addDescriptorSetLayout(descriptorSetLayout)
-                         .build();
+        // 深度测试（深度缓冲为渲染图中每帧的瞬态纹理）
+        vk::PipelineDepthStencilStateCreateInfo depthStencilState = {};
+        depthStencilState.depthTestEnable = VK_TRUE;
+        depthStencilState.depthWriteEnable = VK_TRUE;
+        depthStencilState.depthCompareOp = vk::CompareOp::eLessOrEqual;
+
+        // 场景绘制到固定格式的缩放颜色纹理，管线与交换链格式无关，所有视口共用
+        vkcore::PipelineBuilder builder(m_device);
+        builder.addShaderModule(m_vertShader)
+            .addShaderModule(m_fragShader)
+            .setVertexInput(vertexInputInfo)
+            .setRasterization(rasterizationState)
+            .addColorAttachment(kSceneColorFormat, colorBlendAttachment)
+            .setDepthStencil(depthStencilState)
+            .setDepthAttachment(kDepthFormat)
+            .addDynamicState(vk::DynamicState::eViewport)
+            .addDynamicState(vk::DynamicState::eScissor)
+            .addDescriptorSetLayout(m_textureSetLayout)
+            .addDescriptorSetLayout(m_viewSetLayout)
+            .addDescriptorSetLayout(m_shadowAtlas->getSetLayout())
+            .addPushConstant(vk::PushConstantRange(
+                vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, sizeof(MeshPushConstants)));
+        m_pipeline = m_pipelineCache->getOrCreate(builder);
 
         std::cout << "图形管线创建成功" << std::endl;
     }
 
-    void recordCommandBuffer(vk::CommandBuffer cmd, uint32_t imageIndex)
-    {
-        // 1. 图像布局转换：Undefined -> ColorAttachment
-        vk::ImageMemoryBarrier barrier = {};
-        barrier.oldLayout = vk::ImageLayout::eUndefined;
-        barrier.newLayout = vk::ImageLayout::eColorAttachmentOptimal;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = m_swapchain->getImage(imageIndex);
-        barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
-        barrier.srcAccessMask = vk::AccessFlagBits::eNone;
-        barrier.dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-
-        cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eColorAttachmentOutput,
-                            vk::DependencyFlags{}, nullptr, nullptr, barrier);
-
-        // 2. 开始动态渲染
-        vk::RenderingAttachmentInfo colorAttachment = {};
-        colorAttachment.imageView = m_swapchain->getImageView(imageIndex);
-        colorAttachment.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
-        colorAttachment.loadOp = vk::AttachmentLoadOp::eClear;
-        colorAttachment.storeOp = vk::AttachmentStoreOp::eStore;
-        colorAttachment.clearValue.color = vk::ClearColorValue(std::array<float, 4>{0.1f, 0.1f, 0.1f, 1.0f});
-
-        vk::RenderingInfo renderingInfo = {};
-        renderingInfo.renderArea.offset = vk::Offset2D{0, 0};
-        renderingInfo.renderArea.extent = m_swapchain->getSwapchainExtent();
-        renderingInfo.layerCount = 1;
-        renderingInfo.colorAttachmentCount = 1;
-        renderingInfo.pColorAttachments = &colorAttachment;
-
-        cmd.beginRendering(renderingInfo);
-
-        // 3. 绑定管线
-        m_pipeline->bind(cmd);
-
-        // 4. 绑定 Descriptor Set（纹理）
-        cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline->getLayout(), 0, 1, &m_descriptorSet, 0,
-                               nullptr);
-
-        // 5. 设置视口和裁剪矩形
+    /**
+     * @brief 把一个视口的 Pass 加入本帧渲染图：网格按渲染缩放绘制到瞬态的场景颜色，再由放大 Pass 写入交换链图像
+     * @details 场景颜色与深度是 RDGExtentClass::Scaled 纹理，尺寸随本帧的渲染缩放变化；
+     *          交换链图像的布局转换（含图末尾到呈现布局）由渲染图完成
+     * @param viewIndex m_views 中的下标（选择放大 Pass 的描述符集）
+     * @param renderExtent 场景的渲染尺寸（builder.getScaledExtent(交换链尺寸)）
+     * @param shadows 本帧阴影 Pass 的输出（网格 Pass 在片段阶段采样图集）
+     */
+    void addViewPasses(rendercore::RDGBuilder &builder, uint32_t viewIndex, uint32_t imageIndex,
+                       vk::Extent2D renderExtent, uint32_t viewConstantsOffset,
+                       const renderer::ShadowAtlasOutputs &shadows)
+    {
+        vkcore::SwapChain &swapchain = m_viewports->getSwapChain(m_views[viewIndex].id);
+        const vk::Extent2D outputExtent = swapchain.getSwapchainExtent();
+        const rendercore::RDGTextureHandle backbuffer = builder.getSwapChainAttachment(swapchain, imageIndex);
+
+        rendercore::RDGTextureDesc colorDesc("SceneColor", kSceneColorFormat, outputExtent.width, outputExtent.height,
+                                             vk::ImageUsageFlagBits::eColorAttachment |
+                                                 vk::ImageUsageFlagBits::eSampled);
+        colorDesc.extentClass = rendercore::RDGExtentClass::Scaled;
+        const rendercore::RDGTextureHandle sceneColor = builder.createTexture(colorDesc);
+
+        rendercore::RDGTextureDesc depthDesc("SceneDepth", kDepthFormat, outputExtent.width, outputExtent.height,
+                                             vk::ImageUsageFlagBits::eDepthStencilAttachment);
+        depthDesc.extentClass = rendercore::RDGExtentClass::Scaled;
+        const rendercore::RDGTextureHandle depth = builder.createTexture(depthDesc);
+
+        // 回调只捕获句柄与标量（内联存储，不分配）；描述符集在录制前取好
+        vkcore::Pipeline *pipeline = m_pipeline;
+        const vk::DescriptorSet textureSet = getFrameTextureSet();
+        const vk::DescriptorSet shadowSet = m_shadowAtlas->getDescriptorSet(shadows);
+        rendercore::RDGPass &meshPass =
+            builder
+                .addPass("MeshPass",
+                         [this, pipeline, textureSet, shadowSet, renderExtent,
+                          viewConstantsOffset](vk::CommandBuffer cmd) {
+                             recordMesh(cmd, *pipeline, textureSet, shadowSet, renderExtent, viewConstantsOffset);
+                         })
+                .writeColorAttachment(sceneColor, vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore,
+                                      vk::ClearColorValue(std::array<float, 4>{0.1f, 0.1f, 0.1f, 1.0f}))
+                .writeDepthAttachment(depth, vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare);
+
+        // 每个视口的网格 Pass 都以相同的方式读取图集，图集在帧末的布局记录不受视口数影响
+        m_shadowAtlas->readShadows(meshPass, shadows);
+
+        // 未缩放时双线性采样恰好落在纹素中心，等同于复制；缩放时做边缘自适应放大与锐化
+        const bool scaled = renderExtent != outputExtent;
+        const uint32_t upscaleSlot =
+            m_viewports->getFrameTimeline().getFrameSlot() * static_cast<uint32_t>(m_views.size()) + viewIndex;
+        m_upscaler->addPasses(builder, upscaleSlot, sceneColor, renderExtent, backbuffer, outputExtent,
+                              swapchain.getSwapchainFormat(),
+                              scaled ? renderer::UpscaleMode::EdgeAdaptive : renderer::UpscaleMode::Bilinear,
+                              kUpscaleSharpness);
+    }
+
+    void recordMesh(vk::CommandBuffer cmd, vkcore::Pipeline &pipeline, vk::DescriptorSet textureSet,
+                    vk::DescriptorSet shadowSet, vk::Extent2D extent, uint32_t viewConstantsOffset) const
+    {
+        QTR_PROFILE_SCOPE("MeshRenderer::recordMesh");
+
+        // 1. 绑定管线
+        pipeline.bind(cmd);
+
+        // 2. 绑定 Descriptor Set（本帧的纹理集 + 以 dynamic offset 选择本视口常量的视口集 + 本帧槽位的阴影集）
+        const std::array<vk::DescriptorSet, 3> sets = {textureSet, m_viewSet, shadowSet};
+        cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline.getLayout(), 0,
+                               static_cast<uint32_t>(sets.size()), sets.data(), 1, &viewConstantsOffset);
+
+        // 3. 设置视口和裁剪矩形
         vk::Viewport viewport = {};
         viewport.x = 0.0f;
         viewport.y = 0.0f;
-        viewport.width = static_cast<float>(m_swapchain->getSwapchainExtent().width);
-        viewport.height = static_cast<float>(m_swapchain->getSwapchainExtent().height);
+        viewport.width = static_cast<float>(extent.width);
+        viewport.height = static_cast<float>(extent.height);
         viewport.minDepth = 0.0f;
         viewport.maxDepth = 1.0f;
         cmd.setViewport(0, 1, &viewport);
 
         vk::Rect2D scissor = {};
         scissor.offset = vk::Offset2D{0, 0};
-        scissor.extent = m_swapchain->getSwapchainExtent();
+        scissor.extent = extent;
         cmd.setScissor(0, 1, &scissor);
 
-        // 6. 绑定顶点和索引缓冲区
-        vk::Buffer vertexBuffers[] = {m_mesh->vertexBuffer->get()};
-        vk::DeviceSize offsets[] = {0};
-        cmd.bindVertexBuffers(0, 1, vertexBuffers, offsets);
-        cmd.bindIndexBuffer(m_mesh->indexBuffer->get(), 0, vk::IndexType::eUint32);
-
-        // 7. 绘制网格
-        cmd.drawIndexed(m_mesh->indexCount, 1, 0, 0, 0);
-
-        cmd.endRendering();
-
-        // 7. 图像布局转换：ColorAttachment -> PresentSrc
-        barrier.oldLayout = vk::ImageLayout::eColorAttachmentOptimal;
-        barrier.newLayout = vk::ImageLayout::ePresentSrcKHR;
-        barrier.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-        barrier.dstAccessMask = vk::AccessFlagBits::eNone;
-
-        cmd.pipelineBarrier(vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eBottomOfPipe,
-                            vk::DependencyFlags{}, nullptr, nullptr, barrier);
+        // 4. 绘制汽车与地面（推送常量在 ShadowAtlas::update() 之后填写）
+        recordDraw(cmd, pipeline, *m_mesh, m_carDraw);
+        recordDraw(cmd, pipeline, *m_groundMesh, m_groundDraw);
     }
 
-    void recreateSwapchain()
+    static void recordDraw(vk::CommandBuffer cmd, const vkcore::Pipeline &pipeline, const rendercore::Mesh &mesh,
+                           const MeshPushConstants &draw)
     {
-        std::cout << "重建交换链..." << std::endl;
-
-        // 等待设备空闲
-        m_device.get().waitIdle();
-
-        // 清理旧的交换链相关资源
-        m_pipeline.reset();
-
-        // 释放命令缓冲区
-        for (auto &cmd : m_commandBuffers)
-        {
-            cmd.reset();
-        }
-
-        m_swapchain->cleanup();
+        cmd.pushConstants(pipeline.getLayout(), vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,
+                          0, sizeof(MeshPushConstants), &draw);
 
-        // 重新创建交换链
-        m_swapchain = std::make_unique<vkcore::SwapChain>(m_surface, m_device, m_allocator);
-
-        // 重新分配命令缓冲区
-        for (int i = 0; i < 2; i++)
-        {
-            m_commandBuffers[i] = m_commandPoolManager->allocate();
-        }
+        // 绑定顶点和索引缓冲区，绘制网格（顶点/索引位于共享的几何池缓冲中）
+        vk::Buffer vertexBuffers[] = {mesh.vertexBuffer->get()};
+        vk::DeviceSize offsets[] = {0};
+        cmd.bindVertexBuffers(0, 1, vertexBuffers, offsets);
+        cmd.bindIndexBuffer(mesh.indexBuffer->get(), 0, mesh.indexType);
+        cmd.drawIndexed(mesh.indexCount, 1, mesh.firstIndex, mesh.vertexOffset, 0);
+    }
 
-        // 重新创建管线
-        createPipeline();
+    void updateSwapchainDependents(ViewState &view)
+    {
+        // 交换链在获取/呈现时已自行重建（不等待设备空闲）；每帧的视口、裁剪与附件尺寸本来就按当前尺寸录制，
+        // 放大 Pass 的管线按输出格式懒创建，格式变化时也无需在这里重建任何状态
+        const vkcore::SwapChain &swapchain = m_viewports->getSwapChain(view.id);
+        if (view.swapchainGeneration == swapchain.getGeneration())
+            return;
+        view.swapchainGeneration = swapchain.getGeneration();
 
-        std::cout << "交换链重建完成: " << m_swapchain->getSwapchainExtent().width << "x"
-                  << m_swapchain->getSwapchainExtent().height << std::endl;
+        QTR_LOG_INFO("SwapChain", "视口 " << view.id << " 交换链重建完成: " << swapchain.getSwapchainExtent().width
+                                  << "x" << swapchain.getSwapchainExtent().height);
     }
 
-    void cleanup()
+  public:
+    void cleanup() override
     {
         if (!m_initialized)
             return;
@@ -487,34 +915,53 @@ class MeshRenderer
         // 等待设备空闲
         m_device.get().waitIdle();
 
-        // 按照创建的相反顺序清理资源
-        m_pipeline.reset();
-
-        // 清理 Descriptor 资源
+        // 按照创建的相反顺序清理资源（析构时保存驱动管线缓存）
+        m_pipeline = nullptr;
+        m_pipelineCache.reset();
+
+        // 清理阴影图集、放大 Pass、计时查询池、Descriptor 资源与每帧常量环
+        m_shadowAtlas.reset();
+        m_upscaler.reset();
+        m_profiler.reset();
+        m_frameDescriptors.reset();
+        m_frameConstants.reset();
+        m_frameResourceCount = 0;
         m_descriptorAllocator.reset();
         m_descriptorLayoutCache.reset();
 
-        // 清理网格和 ResourceManager
+        // 清理网格和 ResourceManager（随后销毁延迟销毁队列并执行其中剩余的操作，设备已空闲）
+        m_scene.reset();
+        m_carNode.reset();
+        m_groundNode.reset();
+        m_sun.reset();
+        m_camera.reset();
+        m_sceneMaterial.reset();
+        m_groundMesh.reset();
         m_mesh.reset();
         m_resourceManager.reset();
+        m_deletionQueue.reset();
+        m_samplerCache.reset(); // 纹理只引用缓存中的采样器
+
+        // 使用调度器的对象都已等待各自的任务
+        m_workers.reset();
 
         m_shaderManager->cleanup();
         m_vertShader.reset();
         m_fragShader.reset();
+        m_shadowDepthShader.reset();
+        m_fullscreenShader.reset();
+        m_upscaleShader.reset();
+        m_sharpenShader.reset();
 
-        // 先释放命令缓冲区
-        for (auto &cmd : m_commandBuffers)
-        {
-            cmd.reset();
-        }
-
-        // 再销毁命令池
+        // 销毁命令池（帧环管理器先于交换链的帧时间线销毁）
+        m_frameCommands.reset();
         m_commandPoolManager.reset();
 
-        // 最后清理交换链
-        m_swapchain->cleanup();
-        m_swapchain.reset();
+        // 最后清理各视口的交换链与共享的帧时间线
+        m_viewports.reset();
+        m_views.clear();
 
+        m_memoryMonitor.reset();
         if (m_allocator != VK_NULL_HANDLE)
         {
             vmaDestroyAllocator(m_allocator);
@@ -527,27 +974,69 @@ class MeshRenderer
 
   private:
     vkcore::Device &m_device;
-    vk::SurfaceKHR m_surface;
-    VulkanWindow *m_window;
+    std::vector<vk::SurfaceKHR> m_surfaces; ///< 各视口的表面（由调用方销毁）
 
     VmaAllocator m_allocator = VK_NULL_HANDLE;
-    std::unique_ptr<vkcore::SwapChain> m_swapchain;
+    std::unique_ptr<vkcore::MemoryMonitor> m_memoryMonitor;
+    uint64_t m_nextPressureReportFrame = 0; ///< 压力日志限频
+    std::unique_ptr<renderer::ViewportSet> m_viewports; ///< 各视口的交换链（共享帧时间线）
+    std::vector<ViewState> m_views;                     ///< 与 m_surfaces 一一对应
     std::unique_ptr<vkcore::CommandPoolManager> m_commandPoolManager;
     std::unique_ptr<vkcore::ShaderManager> m_shaderManager;
     std::shared_ptr<vkcore::ShaderModule> m_vertShader;
     std::shared_ptr<vkcore::ShaderModule> m_fragShader;
-    std::unique_ptr<vkcore::Pipeline> m_pipeline;
+    std::shared_ptr<vkcore::ShaderModule> m_shadowDepthShader;
+    std::shared_ptr<vkcore::ShaderModule> m_fullscreenShader;
+    std::shared_ptr<vkcore::ShaderModule> m_upscaleShader;
+    std::shared_ptr<vkcore::ShaderModule> m_sharpenShader;
+    std::unique_ptr<vkcore::PipelineCache> m_pipelineCache;
+    vkcore::Pipeline *m_pipeline = nullptr; ///< 网格管线（由 m_pipelineCache 持有）
 
     // ResourceManager 和网格资源
     std::unique_ptr<rendercore::ResourceManager> m_resourceManager;
     std::shared_ptr<rendercore::Mesh> m_mesh;
+    std::shared_ptr<rendercore::Mesh> m_groundMesh;
+
+    // 渲染线程上的示例场景（ShadowAtlas 的光源与投射体来源）
+    static constexpr float kCameraFovY = 45.0f;    ///< 与 rendercore::Camera 的默认视场一致（度）
+    static constexpr float kTurntableSpeed = 0.5f; ///< 汽车的旋转角速度（弧度/秒）
+    static constexpr float kAmbient = 0.15f;       ///< 环境光比例
+    std::unique_ptr<rendercore::Scene> m_scene;
+    std::shared_ptr<rendercore::Material> m_sceneMaterial;
+    std::shared_ptr<rendercore::SceneNode> m_carNode;
+    std::shared_ptr<rendercore::SceneNode> m_groundNode;
+    std::shared_ptr<rendercore::DirectionalLight> m_sun;
+    std::shared_ptr<rendercore::Camera> m_camera;
+    glm::vec3 m_carPivot{0.0f};                             ///< 转台中心（汽车包围盒中心在地面上的投影）
+    std::chrono::steady_clock::time_point m_sceneStartTime; ///< 转台角度的时间起点
+    MeshPushConstants m_carDraw;                            ///< 本帧汽车的推送常量
+    MeshPushConstants m_groundDraw;                         ///< 本帧地面的推送常量
 
     // Descriptor 资源
     std::unique_ptr<vkcore::DescriptorAllocator> m_descriptorAllocator;
     std::unique_ptr<vkcore::DescriptorLayoutCache> m_descriptorLayoutCache;
-    vk::DescriptorSet m_descriptorSet;
-
-    std::array<vkcore::CommandBufferHandle, 2> m_commandBuffers; ///< 每帧的命令缓冲区
+    std::unique_ptr<vkcore::SamplerCache> m_samplerCache;
+    vk::DescriptorSetLayout m_textureSetLayout; ///< 由 m_descriptorLayoutCache 持有
+    vk::DescriptorSetLayout m_viewSetLayout;    ///< 由 m_descriptorLayoutCache 持有
+    vk::DescriptorSet m_viewSet;                ///< 视口常量（dynamic UBO，指向 m_frameConstants）
+
+    // 每帧资源：按帧时间线的槽位复用，帧开头整体重置
+    static constexpr vk::DeviceSize kFrameConstantBytes = 64 * 1024;
+    static constexpr vk::Format kDepthFormat = vk::Format::eD32Sfloat;
+    static constexpr vk::Format kSceneColorFormat = vk::Format::eR16G16B16A16Sfloat; ///< 线性颜色，放大时写入交换链
+    static constexpr float kUpscaleSharpness = 0.25f;
+    std::unique_ptr<vkcore::TransientBufferRing> m_frameConstants;        ///< 逐视口/逐绘制常量
+    std::unique_ptr<vkcore::FrameDescriptorAllocator> m_frameDescriptors; ///< 逐帧描述符集
+    uint32_t m_frameResourceCount = 0;                                    ///< 每帧资源的槽位数（在途帧数）
+    vk::DescriptorSet m_frameTextureSet;                                  ///< 本帧的纹理集（惰性分配）
+    std::unique_ptr<rendercore::RDGProfiler> m_profiler;                  ///< 逐Pass GPU 计时（驱动动态分辨率）
+    renderer::DynamicResolution m_resolution;                             ///< 由 GPU 帧时间决定渲染缩放
+    std::unique_ptr<renderer::Upscaler> m_upscaler;                       ///< 缩放后的场景颜色放大到交换链
+    std::unique_ptr<renderer::ShadowAtlas> m_shadowAtlas;                 ///< 太阳光的级联阴影（缓存图块，按预算重绘）
+
+    std::unique_ptr<vkcore::CommandPoolManager> m_frameCommands;    ///< 每帧的命令缓冲区（帧环模式）
+    std::unique_ptr<vkcore::DeferredDeletionQueue> m_deletionQueue; ///< 关联帧时间线，先于 m_viewports 销毁
+    std::unique_ptr<vkcore::WorkerPool> m_workers;                  ///< 引擎共享的任务调度器
 
     bool m_initialized = false;
     uint64_t m_frameCount = 0;
@@ -557,6 +1046,11 @@ int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
 
+    // QTRENDER_TRACE=<路径>：记录 CPU 区段，退出时写出 Chrome trace（需要 QTR_PROFILING 构建）
+    const char *tracePath = std::getenv("QTRENDER_TRACE");
+    vkcore::Profiler::setEnabled(tracePath != nullptr);
+    QTR_PROFILE_THREAD("Main");
+
     // 创建主窗口
     MainWindow mainWindow;
 
@@ -589,34 +1083,53 @@ int main(int argc, char *argv[])
     vk::Instance vkInstance = vulkanInstance->vkInstance();
     vkcore::Device::Config deviceConfig;
     deviceConfig.deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
-    deviceConfig.vulkan1_3_features = {"dynamicRendering"};
+    deviceConfig.vulkan1_3_features = {"dynamicRendering", "synchronization2"}; // RDG 使用 pipelineBarrier2/submit2
+    deviceConfig.vulkan1_2_features = {"timelineSemaphore"}; // UploadQueue 使用时间线信号量标记上传完成
     deviceConfig.vulkan1_0_features = {"samplerAnisotropy"}; // 启用各向异性过滤
+    deviceConfig.optional_features = {"textureCompressionBC", "textureCompressionASTC_LDR",
+                                      "textureCompressionETC2"}; // KTX2/DDS 压缩纹理（桌面 BCn，移动 ASTC/ETC2）
+    deviceConfig.optional_features.push_back("pipelineStatisticsQuery"); // RDGProfiler 的逐Pass管线统计
+    deviceConfig.optional_features.push_back("sparseBinding"); // VirtualTexture 的稀疏页缓存图集（与下一项一起）
+    deviceConfig.optional_features.push_back("sparseResidencyImage2D");
+    deviceConfig.optional_extensions = {VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME}; // 后台编译管线时快速链接部件
+    deviceConfig.optional_extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME); // MemoryMonitor 的真实显存预算
+    deviceConfig.optional_extensions.push_back(VK_EXT_MESH_SHADER_EXTENSION_NAME); // meshlet 渲染路径
+    deviceConfig.optional_extensions.push_back(VK_EXT_SHADER_MODULE_IDENTIFIER_EXTENSION_NAME); // 热启动跳过模块创建
+    deviceConfig.optional_extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME); // 限制排队帧数、测量上屏延迟
+    deviceConfig.optional_extensions.push_back(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME); // 可变速率着色（ShadingRateImage）
+    deviceConfig.optional_extensions.push_back(VK_KHR_DYNAMIC_RENDERING_LOCAL_READ_EXTENSION_NAME); // RDG 合并Pass局部读取
+    deviceConfig.optional_vulkan1_2_features = rendercore::BindlessRegistry::getRequiredFeatures(); // bindless 材质
+    deviceConfig.optional_vulkan1_2_features.push_back("hostQueryReset"); // RDGProfiler 在主机端重置查询池
+    deviceConfig.optional_vulkan1_2_features.push_back("bufferDeviceAddress"); // 顶点拉取：着色器经指针读取几何池
     vkcore::Device device(vkInstance, surface, deviceConfig);
     std::cout << "使用设备: " << device.getPhysicalDevice().getProperties().deviceName << std::endl;
 
-    // 创建渲染器
-    std::unique_ptr<MeshRenderer> renderer;
-    try
-    {
-        renderer = std::make_unique<MeshRenderer>(device, surface, vulkanWindow);
-        std::cout << "渲染器初始化成功\n" << std::endl;
-    }
-    catch (const std::exception &e)
+    // 创建渲染器：MeshRenderer 在独立渲染线程上初始化、录制与呈现，主线程只负责事件与帧提交
+    //（多个嵌入视口时传入每个窗口的表面，窗口 i 的缩放以 requestResize(i, ...) 转发）
+    auto frameRenderer = std::make_unique<renderer::ThreadedRenderer>(
+        std::make_unique<MeshRenderer>(device, std::vector<vk::SurfaceKHR>{surface}));
+    if (!frameRenderer->initialize())
     {
-        std::cerr << "渲染器初始化失败: " << e.what() << std::endl;
+        std::cerr << "渲染器初始化失败" << std::endl;
+        frameRenderer.reset();
         device.cleanup();
         delete vulkanInstance;
         return -1;
     }
-
-    // 设置渲染循环定时器（60 FPS）
+    std::cout << "渲染器初始化成功\n" << std::endl;
+
+    // 窗口缩放只记录目标尺寸，交换链由渲染线程在两帧之间重建
+    auto requestResize = [&frameRenderer, vulkanWindow]() {
+        const qreal ratio = vulkanWindow->devicePixelRatio();
+        frameRenderer->requestResize(static_cast<uint32_t>(vulkanWindow->width() * ratio),
+                                     static_cast<uint32_t>(vulkanWindow->height() * ratio));
+    };
+    QObject::connect(vulkanWindow, &QWindow::widthChanged, requestResize);
+    QObject::connect(vulkanWindow, &QWindow::heightChanged, requestResize);
+
+    // 设置帧提交定时器（60 FPS）：只提交新帧，不等待渲染线程
     QTimer *renderTimer = new QTimer(&app);
-    QObject::connect(renderTimer, &QTimer::timeout, [&renderer]() {
-        if (renderer)
-        {
-            renderer->renderFrame();
-        }
-    });
+    QObject::connect(renderTimer, &QTimer::timeout, [&frameRenderer]() { frameRenderer->render(); });
 
     // 启动渲染循环
     renderTimer->start(16); // ~60 FPS (1000ms / 60 ≈ 16ms)
@@ -629,10 +1142,17 @@ int main(int argc, char *argv[])
     // 清理资源
     renderTimer->stop();
     delete renderTimer;
-    renderer.reset(); // 会调用析构函数清理 Vulkan 资源
+    frameRenderer.reset(); // 停止渲染线程，在其上清理 Vulkan 资源
     device.cleanup();
     delete vulkanInstance;
 
+    if (tracePath)
+    {
+        vkcore::Profiler::writeChromeTrace(tracePath);
+        std::cout << "CPU trace: " << tracePath << "（丢弃区段 " << vkcore::Profiler::getDroppedZones() << "）"
+                  << std::endl;
+    }
+
     std::cout << "\n程序正常退出" << std::endl;
     return result;
 }
\ No newline at end of file